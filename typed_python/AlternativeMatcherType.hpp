@@ -94,8 +94,8 @@ public:
         return m_alternative->hash(left);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
-        return m_alternative->deepBytecount(instance, alreadyVisited, outSlabs);
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
+        return m_alternative->deepBytecount(instance, context, outSlabs);
     }
 
     void deepcopyConcrete(
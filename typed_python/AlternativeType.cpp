@@ -44,7 +44,7 @@ bool Alternative::isBinaryCompatibleWithConcrete(Type* other) {
 }
 
 int64_t Alternative::refcount(instance_ptr i) const {
-    if (m_all_alternatives_empty) {
+    if (m_is_inline) {
         return 0;
     }
     return ((layout**)i)[0]->refcount;
@@ -56,6 +56,8 @@ bool Alternative::_updateAfterForwardTypesChanged() {
 
     bool is_default_constructible = false;
     bool all_alternatives_empty = true;
+    bool is_inline = true;
+    size_t max_subtype_bytecount = 0;
     int default_construction_ix = 0;
 
     for (auto& subtype_pair: m_subtypes) {
@@ -63,6 +65,12 @@ bool Alternative::_updateAfterForwardTypesChanged() {
             all_alternatives_empty = false;
         }
 
+        if (!subtype_pair.second->isPOD() || subtype_pair.second->bytecount() > MAX_INLINE_BYTES) {
+            is_inline = false;
+        }
+
+        max_subtype_bytecount = std::max(max_subtype_bytecount, subtype_pair.second->bytecount());
+
         if (m_arg_positions.find(subtype_pair.first) != m_arg_positions.end()) {
             throw std::runtime_error("Can't create an alternative with " +
                     subtype_pair.first + " defined twice.");
@@ -78,32 +86,34 @@ bool Alternative::_updateAfterForwardTypesChanged() {
         }
     }
 
-    size_t size = (all_alternatives_empty ? 1 : sizeof(void*));
+    size_t size = (is_inline ? 1 + max_subtype_bytecount : sizeof(void*));
 
     bool anyChanged = (
         size != m_size ||
         m_default_construction_ix != default_construction_ix ||
         m_all_alternatives_empty != all_alternatives_empty ||
+        m_is_inline != is_inline ||
         m_is_default_constructible != is_default_constructible
     );
 
     m_size = size;
     m_default_construction_ix = default_construction_ix;
     m_all_alternatives_empty = all_alternatives_empty;
+    m_is_inline = is_inline;
     m_is_default_constructible = is_default_constructible;
 
     return anyChanged;
 }
 
 bool Alternative::cmp(instance_ptr left, instance_ptr right, int pyComparisonOp, bool suppressExceptions) {
-    if (m_all_alternatives_empty) {
+    if (m_is_inline) {
         if (*(uint8_t*)left < *(uint8_t*)right) {
             return cmpResultToBoolForPyOrdering(pyComparisonOp, -1);
         }
         if (*(uint8_t*)left > *(uint8_t*)right) {
             return cmpResultToBoolForPyOrdering(pyComparisonOp, 1);
         }
-        return cmpResultToBoolForPyOrdering(pyComparisonOp, 0);
+        return m_subtypes[which(left)].second->cmp(eltPtr(left), eltPtr(right), pyComparisonOp, suppressExceptions);
     }
 
     layout& record_l = **(layout**)left;
@@ -177,8 +187,8 @@ typed_python_hash_type Alternative::hash(instance_ptr left) {
 }
 
 instance_ptr Alternative::eltPtr(instance_ptr self) const {
-    if (m_all_alternatives_empty) {
-        return self;
+    if (m_is_inline) {
+        return self + 1;
     }
 
     layout& record = **(layout**)self;
@@ -187,7 +197,7 @@ instance_ptr Alternative::eltPtr(instance_ptr self) const {
 }
 
 int64_t Alternative::which(instance_ptr self) const {
-    if (m_all_alternatives_empty) {
+    if (m_is_inline) {
         return *(uint8_t*)self;
     }
 
@@ -197,7 +207,7 @@ int64_t Alternative::which(instance_ptr self) const {
 }
 
 void Alternative::destroy(instance_ptr self) {
-    if (m_all_alternatives_empty) {
+    if (m_is_inline) {
         return;
     }
 
@@ -210,8 +220,8 @@ void Alternative::destroy(instance_ptr self) {
 }
 
 void Alternative::copy_constructor(instance_ptr self, instance_ptr other) {
-    if (m_all_alternatives_empty) {
-        *(uint8_t*)self = *(uint8_t*)other;
+    if (m_is_inline) {
+        memcpy(self, other, m_size);
         return;
     }
 
@@ -223,6 +233,11 @@ void Alternative::copy_constructor(instance_ptr self, instance_ptr other) {
 }
 
 void Alternative::assign(instance_ptr self, instance_ptr other) {
+    if (m_is_inline) {
+        memcpy(self, other, m_size);
+        return;
+    }
+
     layout* old = (*(layout**)self);
 
     (*(layout**)self) = (*(layout**)other);
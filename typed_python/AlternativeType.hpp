@@ -74,13 +74,29 @@ PyDoc_STRVAR(Alternative_doc,
     "\n"
     "    addXAndY = Expression.Add(lhs=Expression.Variable(name='x'), rhs=Expression.Variable(name='y'))\n"
     "    assert addXAndY.evaluate({'x': 10, 'y': 20}) == 30\n\n"
+    "Alternatives whose subtypes are all POD and at most 15 bytes are stored\n"
+    "inline, as a one-byte index followed by the subtype's data, rather than as\n"
+    "a pointer to a refcounted heap allocation.\n"
 );
 
+/*****
+An Alternative instance is normally a pointer to a refcounted 'layout' holding the
+index of the subtype and then the subtype's data.
+
+If every subtype is POD and no bigger than MAX_INLINE_BYTES, the instance is stored
+inline instead: one byte holding the index, followed directly by the subtype's data,
+padded out to the largest subtype. Such alternatives are themselves POD, so
+constructing one never allocates. Alternatives whose subtypes are all empty are the
+special case of this where the instance is just the index byte.
+*****/
 class Alternative : public Type {
 public:
+    // the largest subtype we'll store inline, so inline instances fit in 16 bytes
+    static const size_t MAX_INLINE_BYTES = 15;
+
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
 
         int64_t which;
         uint8_t data[];
@@ -94,6 +110,8 @@ public:
                 const std::map<std::string, Function*>& methods
                 ) :
             Type(TypeCategory::catAlternative),
+            m_all_alternatives_empty(false),
+            m_is_inline(false),
             m_default_construction_ix(0),
             m_default_construction_type(nullptr),
             m_subtypes(subtypes),
@@ -190,18 +208,23 @@ public:
         m_subtypes[which(self)].second->serialize(eltPtr(self), buffer, which(self));
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
-        if (m_all_alternatives_empty) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
+        if (m_is_inline) {
             return 0;
         }
 
         instance_ptr* p = *(instance_ptr**)instance;
 
-        if (alreadyVisited.find(p) != alreadyVisited.end()) {
+        if (context.deferLayout(this, p, ((layout_ptr)p)->refcount)) {
             return 0;
         }
 
-        alreadyVisited.insert(p);
+        if (context.visited.contains(p)) {
+            return 0;
+        }
+
+        context.visited.insert(p);
+        context.noteRefcount(((layout_ptr)p)->refcount);
 
         if (outSlabs && Slab::slabForAlloc(p)) {
             outSlabs->insert(Slab::slabForAlloc(p));
@@ -210,7 +233,7 @@ public:
 
         return
             bytesRequiredForAllocation(m_subtypes[which(instance)].second->bytecount() + sizeof(layout)) +
-            m_subtypes[which(instance)].second->deepBytecount(eltPtr(instance), alreadyVisited, outSlabs);
+            m_subtypes[which(instance)].second->deepBytecount(eltPtr(instance), context, outSlabs);
     }
 
     void deepcopyConcrete(
@@ -218,8 +241,8 @@ public:
         instance_ptr src,
         DeepcopyContext& context
     ) {
-        if (m_all_alternatives_empty) {
-            ((uint8_t*)dest)[0] = ((uint8_t*)src)[0];
+        if (m_is_inline) {
+            memcpy(dest, src, m_size);
             return;
         }
 
@@ -228,14 +251,21 @@ public:
 
         size_t typeIx = srcRecordPtr->which;
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcRecordPtr);
+        instance_ptr destPtr;
+        bool isNew;
 
-        if (it == context.alreadyAllocated.end()) {
-            destRecordPtr = (layout*)context.slab->allocate(
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcRecordPtr, [&]() {
+            layout* newRecord = (layout*)context.slab->allocate(
                 sizeof(layout) + m_subtypes[typeIx].second->bytecount(),
                 this
             );
-            destRecordPtr->refcount = 0;
+            newRecord->refcount = 0;
+            return (instance_ptr)newRecord;
+        });
+
+        destRecordPtr = (layout_ptr)destPtr;
+
+        if (isNew) {
             destRecordPtr->which = srcRecordPtr->which;
 
             m_subtypes[typeIx].second->deepcopy(
@@ -243,10 +273,6 @@ public:
                 srcRecordPtr->data,
                 context
             );
-
-            context.alreadyAllocated[(instance_ptr)srcRecordPtr] = (instance_ptr)destRecordPtr;
-        } else {
-            destRecordPtr = (layout_ptr)it->second;
         }
 
         destRecordPtr->refcount++;
@@ -265,10 +291,10 @@ public:
             throw std::runtime_error("Corrupt data (Alternative field number was out of bounds)");
         }
 
-        if (m_all_alternatives_empty) {
+        if (m_is_inline) {
+            memset(self, 0, m_size);
             *(uint8_t*)self = which;
-            //still need to consume whatever is in this message
-            m_subtypes[which].second->deserialize(self, buffer, fieldAndWire.second);
+            m_subtypes[which].second->deserialize(self + 1, buffer, fieldAndWire.second);
             return;
         }
 
@@ -282,7 +308,12 @@ public:
         record.refcount = 1;
         record.which = which;
 
-        m_subtypes[which].second->deserialize(record.data, buffer, fieldAndWire.second);
+        try {
+            m_subtypes[which].second->deserialize(record.data, buffer, fieldAndWire.second);
+        } catch(...) {
+            tp_free(&record);
+            throw;
+        }
     }
 
     void repr(instance_ptr self, ReprAccumulator& stream, bool isStr);
@@ -319,13 +350,18 @@ public:
     }
 
     bool isPODConcrete() {
-        return m_all_alternatives_empty;
+        return m_is_inline;
     }
 
     bool all_alternatives_empty() const {
         return m_all_alternatives_empty;
     }
 
+    // are instances stored inline, rather than as a pointer to a layout?
+    bool is_inline() const {
+        return m_is_inline;
+    }
+
     Type* pickConcreteSubclassConcrete(instance_ptr data);
 
     const std::map<std::string, Function*>& getMethods() const {
@@ -340,6 +376,8 @@ private:
 
     bool m_all_alternatives_empty;
 
+    bool m_is_inline;
+
     int m_default_construction_ix;
 
     Type* m_default_construction_type;
@@ -0,0 +1,611 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "ArrowInterop.hpp"
+#include "Unicode.hpp"
+
+namespace ArrowInterop {
+
+namespace {
+
+typedef Type::TypeCategory TypeCategory;
+
+// arrow wants a non-null data buffer even for an empty array
+uint8_t emptyBuffer[8];
+
+bool bitSet(const uint8_t* bits, int64_t i) {
+    return (bits[i >> 3] >> (i & 7)) & 1;
+}
+
+void setBit(uint8_t* bits, int64_t i) {
+    bits[i >> 3] |= 1 << (i & 7);
+}
+
+// the arrow format of a column of 'eltType' if it's a primitive, or nullptr
+const char* primitiveFormat(Type* eltType) {
+    switch (eltType->getTypeCategory()) {
+        case TypeCategory::catBool: return "b";
+        case TypeCategory::catInt8: return "c";
+        case TypeCategory::catUInt8: return "C";
+        case TypeCategory::catInt16: return "s";
+        case TypeCategory::catUInt16: return "S";
+        case TypeCategory::catInt32: return "i";
+        case TypeCategory::catUInt32: return "I";
+        case TypeCategory::catInt64: return "l";
+        case TypeCategory::catUInt64: return "L";
+        case TypeCategory::catFloat32: return "f";
+        case TypeCategory::catFloat64: return "g";
+        default: return nullptr;
+    }
+}
+
+// if 'eltType' is OneOf(None, T), the index of T in it, or -1
+int nullableValueIndex(Type* eltType) {
+    if (!eltType->isOneOf()) {
+        return -1;
+    }
+
+    const std::vector<Type*>& types = ((OneOfType*)eltType)->getTypes();
+
+    if (types.size() != 2 || types[0]->isNone() == types[1]->isNone()) {
+        return -1;
+    }
+
+    return types[0]->isNone() ? 1 : 0;
+}
+
+/********* export *********/
+
+struct SchemaData {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema*> children;
+};
+
+void releaseSchema(ArrowSchema* schema) {
+    SchemaData* data = (SchemaData*)schema->private_data;
+
+    for (ArrowSchema* child: data->children) {
+        if (child->release) {
+            child->release(child);
+        }
+        delete child;
+    }
+
+    delete data;
+    schema->release = nullptr;
+}
+
+struct ArrayData {
+    std::vector<const void*> buffers;
+    std::vector<void*> ownedBuffers;
+    std::vector<ArrowArray*> children;
+
+    // the python object whose storage we point into, if any
+    PyObject* owner = nullptr;
+
+    uint8_t* allocate(size_t bytecount) {
+        void* res = calloc(bytecount ? bytecount : 1, 1);
+
+        if (!res) {
+            throw std::bad_alloc();
+        }
+
+        ownedBuffers.push_back(res);
+        return (uint8_t*)res;
+    }
+};
+
+void releaseArray(ArrowArray* array) {
+    ArrayData* data = (ArrayData*)array->private_data;
+
+    for (ArrowArray* child: data->children) {
+        if (child->release) {
+            child->release(child);
+        }
+        delete child;
+    }
+
+    for (void* buffer: data->ownedBuffers) {
+        free(buffer);
+    }
+
+    if (data->owner) {
+        // consumers may release the array on any thread
+        PyGILState_STATE gilState = PyGILState_Ensure();
+        decref(data->owner);
+        PyGILState_Release(gilState);
+    }
+
+    delete data;
+    array->release = nullptr;
+}
+
+// 'count' values of 'type', the i'th at 'base + i * stride'. Where 'present'
+// is given, only the rows whose bit is set hold a value, because the rest
+// belong to a None further up.
+struct Column {
+    Type* type;
+    instance_ptr base;
+    size_t stride;
+    int64_t count;
+    const uint8_t* present;
+
+    instance_ptr row(int64_t i) const {
+        return base + i * stride;
+    }
+
+    bool isPresent(int64_t i) const {
+        return !present || bitSet(present, i);
+    }
+};
+
+size_t utf8Bytecount(StringType* strT, instance_ptr s) {
+    int64_t count = strT->count(s);
+
+    if (!count) {
+        return 0;
+    }
+
+    switch (strT->bytes_per_codepoint(s)) {
+        case 1: return countUtf8BytesRequiredFor((uint8_t*)strT->eltPtr(s, 0), count);
+        case 2: return countUtf8BytesRequiredFor((uint16_t*)strT->eltPtr(s, 0), count);
+        default: return countUtf8BytesRequiredFor((uint32_t*)strT->eltPtr(s, 0), count);
+    }
+}
+
+void writeUtf8(StringType* strT, instance_ptr s, uint8_t* out) {
+    int64_t count = strT->count(s);
+
+    if (!count) {
+        return;
+    }
+
+    switch (strT->bytes_per_codepoint(s)) {
+        case 1: encodeUtf8((uint8_t*)strT->eltPtr(s, 0), count, out); break;
+        case 2: encodeUtf8((uint16_t*)strT->eltPtr(s, 0), count, out); break;
+        default: encodeUtf8((uint32_t*)strT->eltPtr(s, 0), count, out); break;
+    }
+}
+
+// fill the offsets and data buffers of a utf8 or binary column
+template<class offset_type, class size_fun, class write_fun>
+void fillVarwidth(const Column& col, ArrayData* data, size_t totalBytes, const size_fun& sizeOf, const write_fun& write) {
+    offset_type* offsets = (offset_type*)data->allocate((col.count + 1) * sizeof(offset_type));
+    uint8_t* out = data->allocate(totalBytes);
+
+    offset_type pos = 0;
+
+    for (int64_t i = 0; i < col.count; i++) {
+        offsets[i] = pos;
+
+        if (col.isPresent(i)) {
+            write(col.row(i), out + pos);
+            pos += sizeOf(col.row(i));
+        }
+    }
+
+    offsets[col.count] = pos;
+
+    data->buffers.push_back(offsets);
+    data->buffers.push_back(out);
+}
+
+void exportColumn(const Column& col, PyObject* owner, const std::string& name, ArrowSchema* schema, ArrowArray* array) {
+    SchemaData* schemaData = new SchemaData();
+    ArrayData* data = new ArrayData();
+
+    schemaData->name = name;
+
+    int64_t flags = 0;
+    int64_t nullCount = 0;
+
+    // the values themselves, which for OneOf(None, T) are the T's
+    Column values = col;
+
+    int valueIx = nullableValueIndex(col.type);
+
+    if (valueIx >= 0) {
+        OneOfType* oneOf = (OneOfType*)col.type;
+
+        uint8_t* valid = data->allocate((col.count + 7) / 8);
+
+        for (int64_t i = 0; i < col.count; i++) {
+            if (col.isPresent(i) && oneOf->whichIndex(col.row(i)) == (size_t)valueIx) {
+                setBit(valid, i);
+            } else {
+                nullCount++;
+            }
+        }
+
+        flags |= ARROW_FLAG_NULLABLE;
+
+        // the value lives at the same offset in every row
+        values.type = oneOf->getTypes()[valueIx];
+        values.base = oneOf->eltPtr(col.base);
+        values.present = valid;
+
+        data->buffers.push_back(valid);
+    } else {
+        data->buffers.push_back(nullptr);
+    }
+
+    Type* t = values.type;
+
+    if (t->getTypeCategory() == TypeCategory::catBool) {
+        uint8_t* bits = data->allocate((col.count + 7) / 8);
+
+        for (int64_t i = 0; i < col.count; i++) {
+            if (values.isPresent(i) && *(bool*)values.row(i)) {
+                setBit(bits, i);
+            }
+        }
+
+        schemaData->format = "b";
+        data->buffers.push_back(bits);
+    } else if (primitiveFormat(t)) {
+        size_t bytesPer = t->bytecount();
+
+        schemaData->format = primitiveFormat(t);
+
+        if (!col.count) {
+            data->buffers.push_back(emptyBuffer);
+        } else if (values.stride == bytesPer && !values.present && owner) {
+            // our storage is already exactly arrow's
+            data->buffers.push_back(values.base);
+            data->owner = incref(owner);
+        } else {
+            uint8_t* out = data->allocate(bytesPer * col.count);
+
+            for (int64_t i = 0; i < col.count; i++) {
+                if (values.isPresent(i)) {
+                    memcpy(out + i * bytesPer, values.row(i), bytesPer);
+                }
+            }
+
+            data->buffers.push_back(out);
+        }
+    } else if (t->getTypeCategory() == TypeCategory::catString || t->getTypeCategory() == TypeCategory::catBytes) {
+        bool isStr = t->getTypeCategory() == TypeCategory::catString;
+
+        StringType* strT = StringType::Make();
+        BytesType* bytesT = BytesType::Make();
+
+        auto sizeOf = [&](instance_ptr v) -> size_t {
+            return isStr ? utf8Bytecount(strT, v) : bytesT->count(v);
+        };
+
+        auto write = [&](instance_ptr v, uint8_t* out) {
+            if (isStr) {
+                writeUtf8(strT, v, out);
+            } else if (bytesT->count(v)) {
+                memcpy(out, bytesT->eltPtr(v, 0), bytesT->count(v));
+            }
+        };
+
+        size_t totalBytes = 0;
+
+        for (int64_t i = 0; i < col.count; i++) {
+            if (values.isPresent(i)) {
+                totalBytes += sizeOf(values.row(i));
+            }
+        }
+
+        if (totalBytes <= INT32_MAX) {
+            schemaData->format = isStr ? "u" : "z";
+            fillVarwidth<int32_t>(values, data, totalBytes, sizeOf, write);
+        } else {
+            schemaData->format = isStr ? "U" : "Z";
+            fillVarwidth<int64_t>(values, data, totalBytes, sizeOf, write);
+        }
+    } else if (t->isNamedTuple()) {
+        NamedTuple* tupT = (NamedTuple*)t;
+
+        schemaData->format = "+s";
+
+        for (long k = 0; k < tupT->getTypes().size(); k++) {
+            ArrowSchema* childSchema = new ArrowSchema();
+            ArrowArray* childArray = new ArrowArray();
+
+            schemaData->children.push_back(childSchema);
+            data->children.push_back(childArray);
+
+            exportColumn(
+                Column{
+                    tupT->getTypes()[k],
+                    values.base + tupT->getOffsets()[k],
+                    values.stride,
+                    values.count,
+                    values.present
+                },
+                owner,
+                tupT->getNames()[k],
+                childSchema,
+                childArray
+            );
+        }
+    } else {
+        throw std::logic_error("Can't export a column of " + t->name() + " to arrow");
+    }
+
+    schema->format = schemaData->format.c_str();
+    schema->name = schemaData->name.c_str();
+    schema->metadata = nullptr;
+    schema->flags = flags;
+    schema->n_children = schemaData->children.size();
+    schema->children = schemaData->children.data();
+    schema->dictionary = nullptr;
+    schema->release = releaseSchema;
+    schema->private_data = schemaData;
+
+    array->length = col.count;
+    array->null_count = nullCount;
+    array->offset = 0;
+    array->n_buffers = data->buffers.size();
+    array->n_children = data->children.size();
+    array->buffers = data->buffers.data();
+    array->children = data->children.data();
+    array->dictionary = nullptr;
+    array->release = releaseArray;
+    array->private_data = data;
+}
+
+/********* import *********/
+
+// how to read one arrow column into values of 'type'. Checking all of
+// this up front means we only fail on a row for an unexpected null.
+struct ColumnReader {
+    Type* type;
+
+    // if 'type' is OneOf(None, T), the index of T, and T. Otherwise -1 and 'type'.
+    int valueIx;
+    Type* valueType;
+
+    const ArrowArray* array;
+
+    // for str and bytes, whether the offsets are 64 bit
+    bool largeOffsets;
+
+    // for a NamedTuple, a reader for each field, in field order
+    std::vector<ColumnReader> fields;
+
+    bool isValid(int64_t i) const {
+        const uint8_t* validity = (const uint8_t*)array->buffers[0];
+
+        return !validity || array->null_count == 0 || bitSet(validity, array->offset + i);
+    }
+
+    // where the arrow data for row i is, in units of 'T'
+    template<class T>
+    T at(int buffer, int64_t i) const {
+        return ((const T*)array->buffers[buffer])[array->offset + i];
+    }
+};
+
+void expectBuffers(const ArrowSchema* schema, const ArrowArray* array, int64_t count, const std::string& path) {
+    if (array->n_buffers != count || array->n_children != (schema->n_children)) {
+        throw std::runtime_error("Arrow column " + path + " is malformed");
+    }
+}
+
+ColumnReader makeReader(Type* eltType, const ArrowSchema* schema, const ArrowArray* array, const std::string& path) {
+    ColumnReader reader;
+
+    reader.type = eltType;
+    reader.valueIx = nullableValueIndex(eltType);
+    reader.valueType = reader.valueIx >= 0 ? ((OneOfType*)eltType)->getTypes()[reader.valueIx] : eltType;
+    reader.array = array;
+    reader.largeOffsets = false;
+
+    std::string format = schema->format;
+    Type* t = reader.valueType;
+
+    auto mismatch = [&]() {
+        return std::runtime_error(
+            "Can't read arrow column " + path + " of format '" + format + "' as " + eltType->name()
+        );
+    };
+
+    if (schema->dictionary || array->length < 0) {
+        throw mismatch();
+    }
+
+    if (primitiveFormat(t)) {
+        if (format != primitiveFormat(t)) {
+            throw mismatch();
+        }
+        expectBuffers(schema, array, 2, path);
+    } else if (t->getTypeCategory() == TypeCategory::catString) {
+        if (format != "u" && format != "U") {
+            throw mismatch();
+        }
+        reader.largeOffsets = format == "U";
+        expectBuffers(schema, array, 3, path);
+    } else if (t->getTypeCategory() == TypeCategory::catBytes) {
+        if (format != "z" && format != "Z") {
+            throw mismatch();
+        }
+        reader.largeOffsets = format == "Z";
+        expectBuffers(schema, array, 3, path);
+    } else if (t->isNamedTuple()) {
+        if (format != "+s") {
+            throw mismatch();
+        }
+        expectBuffers(schema, array, 1, path);
+
+        NamedTuple* tupT = (NamedTuple*)t;
+
+        for (long k = 0; k < tupT->getTypes().size(); k++) {
+            const std::string& name = tupT->getNames()[k];
+
+            int64_t childIx = 0;
+            while (childIx < schema->n_children && (!schema->children[childIx]->name || name != schema->children[childIx]->name)) {
+                childIx++;
+            }
+
+            if (childIx == schema->n_children) {
+                throw std::runtime_error("Arrow column " + path + " has no field '" + name + "'");
+            }
+
+            reader.fields.push_back(
+                makeReader(
+                    tupT->getTypes()[k],
+                    schema->children[childIx],
+                    array->children[childIx],
+                    path + "." + name
+                )
+            );
+        }
+    } else {
+        throw std::runtime_error("Can't read an arrow column into " + eltType->name());
+    }
+
+    return reader;
+}
+
+void readValue(const ColumnReader& reader, int64_t i, instance_ptr dest);
+
+// construct the non-null value in row i
+void readPresentValue(const ColumnReader& reader, int64_t i, instance_ptr dest) {
+    Type* t = reader.valueType;
+
+    switch (t->getTypeCategory()) {
+        case TypeCategory::catBool:
+            *(bool*)dest = bitSet((const uint8_t*)reader.array->buffers[1], reader.array->offset + i);
+            return;
+        case TypeCategory::catString:
+        case TypeCategory::catBytes: {
+            int64_t start = reader.largeOffsets ? reader.at<int64_t>(1, i) : reader.at<int32_t>(1, i);
+            int64_t stop = reader.largeOffsets ? reader.at<int64_t>(1, i + 1) : reader.at<int32_t>(1, i + 1);
+
+            const uint8_t* bytes = (const uint8_t*)reader.array->buffers[2] + start;
+
+            if (stop == start) {
+                *(void**)dest = nullptr;
+            } else if (t->getTypeCategory() == TypeCategory::catString) {
+                *(StringType::layout**)dest = StringType::createFromUtf8Bytes(bytes, stop - start);
+            } else {
+                *(BytesType::layout**)dest = BytesType::createFromPtr((const char*)bytes, stop - start);
+            }
+            return;
+        }
+        case TypeCategory::catNamedTuple:
+            // a struct's children are indexed from its own offset
+            ((NamedTuple*)t)->constructor(dest, [&](instance_ptr field, int64_t k) {
+                readValue(reader.fields[k], reader.array->offset + i, field);
+            });
+            return;
+        default: {
+            size_t bytesPer = t->bytecount();
+            memcpy(dest, (const uint8_t*)reader.array->buffers[1] + (reader.array->offset + i) * bytesPer, bytesPer);
+            return;
+        }
+    }
+}
+
+void readValue(const ColumnReader& reader, int64_t i, instance_ptr dest) {
+    if (reader.valueIx < 0) {
+        if (!reader.isValid(i)) {
+            throw std::runtime_error(
+                "Can't read a null from arrow into " + reader.type->name()
+                + ". Use OneOf(None, " + reader.type->name() + ") to allow nulls."
+            );
+        }
+
+        readPresentValue(reader, i, dest);
+        return;
+    }
+
+    OneOfType* oneOf = (OneOfType*)reader.type;
+
+    if (reader.isValid(i)) {
+        readPresentValue(reader, i, oneOf->eltPtr(dest));
+        oneOf->setWhichIndex(dest, reader.valueIx);
+    } else {
+        oneOf->setWhichIndex(dest, 1 - reader.valueIx);
+    }
+}
+
+} // end anonymous namespace
+
+bool isSupported(Type* eltType) {
+    int valueIx = nullableValueIndex(eltType);
+
+    if (valueIx >= 0) {
+        Type* valueType = ((OneOfType*)eltType)->getTypes()[valueIx];
+
+        return nullableValueIndex(valueType) < 0 && isSupported(valueType);
+    }
+
+    if (eltType->isNamedTuple()) {
+        for (Type* fieldType: ((NamedTuple*)eltType)->getTypes()) {
+            if (!isSupported(fieldType)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return primitiveFormat(eltType)
+        || eltType->getTypeCategory() == TypeCategory::catString
+        || eltType->getTypeCategory() == TypeCategory::catBytes;
+}
+
+void exportColumn(
+    Type* eltType,
+    instance_ptr elts,
+    int64_t count,
+    PyObject* owner,
+    ArrowSchema* schema,
+    ArrowArray* array
+) {
+    exportColumn(Column{eltType, elts, eltType->bytecount(), count, nullptr}, owner, "", schema, array);
+}
+
+void importColumn(
+    Type* eltType,
+    const ArrowSchema* schema,
+    const ArrowArray* array,
+    instance_ptr elts
+) {
+    ColumnReader reader = makeReader(eltType, schema, array, "<root>");
+
+    int64_t count = array->length;
+    size_t bytesPer = eltType->bytecount();
+
+    bool hasNulls = array->buffers[0] && array->null_count != 0;
+
+    if (primitiveFormat(eltType) && !eltType->isBool() && !hasNulls) {
+        if (count) {
+            memcpy(elts, (const uint8_t*)array->buffers[1] + array->offset * bytesPer, count * bytesPer);
+        }
+        return;
+    }
+
+    for (int64_t i = 0; i < count; i++) {
+        try {
+            readValue(reader, i, elts + i * bytesPer);
+        } catch(...) {
+            for (int64_t k = i - 1; k >= 0; k--) {
+                eltType->destroy(elts + k * bytesPer);
+            }
+            throw;
+        }
+    }
+}
+
+} // end namespace ArrowInterop
@@ -0,0 +1,111 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include <cstdint>
+
+/*********
+Moving the elements of a TupleOf or ListOf to and from Apache Arrow, using the
+Arrow C data interface (https://arrow.apache.org/docs/format/CDataInterface.html).
+That's just the pair of structs below, so we don't link against Arrow.
+
+    int, float - the matching primitive array. When the elements are the
+        whole column (not fields of a NamedTuple row) the array points
+        straight at our storage and holds a reference to the list. As with
+        a buffer export, that's only good until a ListOf is next resized.
+    bool - a primitive array, but Arrow packs bools into bits, so we copy.
+    str, bytes - utf8 / binary arrays of offsets and data, or large_utf8 /
+        large_binary once the data passes 2GB. We build these.
+    OneOf(None, T) - T's array with a validity bitmap.
+    NamedTuple - a struct array with a child per field, gathered out of
+        our rows. On import, children are matched to fields by name.
+
+Importing always copies, since a ListOf owns its storage, but a column of
+ints or floats with no nulls is a single memcpy.
+*********/
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace ArrowInterop {
+
+// can we move a column of 'eltType' to and from arrow?
+bool isSupported(Type* eltType);
+
+// fill 'schema' and 'array' with the 'count' elements at 'elts', which live
+// in the python object 'owner'. The caller must eventually call the
+// 'release' of both.
+void exportColumn(
+    Type* eltType,
+    instance_ptr elts,
+    int64_t count,
+    PyObject* owner,
+    ArrowSchema* schema,
+    ArrowArray* array
+);
+
+// construct 'array->length' elements of type 'eltType' at 'elts' out of an
+// arrow array. Throws, having constructed nothing, if 'schema' doesn't
+// describe a column of 'eltType' or holds a null that 'eltType' can't.
+void importColumn(
+    Type* eltType,
+    const ArrowSchema* schema,
+    const ArrowArray* array,
+    instance_ptr elts
+);
+
+} // end namespace ArrowInterop
@@ -0,0 +1,325 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*********
+Case conversion and character-class checks over ASCII bytes, 16 at a time.
+
+The transforms ('toLower', 'toUpper', 'swapCase') only touch the bytes
+'A'-'Z' and 'a'-'z' and copy every other byte through unchanged, which
+is exactly what bytes.lower() and friends do, and what str.lower() does
+for a string that's entirely ASCII.
+
+The class checks ('all<Alpha>' etc) report whether every byte is an ASCII
+member of the class. A byte >= 0x80 is never a member (except of
+'Latin1Space'), so 'true' is definitive for any input, but callers
+looking at latin-1 text have to fall back to the unicode tables on
+'false' unless 'isAscii' holds.
+
+'findFirst' and 'findLast' locate the nearest byte in (or out of) a
+class, which is what splitting on whitespace spends its time doing.
+*********/
+
+namespace AsciiOps {
+
+#if defined(__SSE2__)
+
+// bytes are compared as signed, so anything >= 0x80 is negative and
+// falls outside every range we check.
+inline __m128i inRange(__m128i v, char lo, char hi) {
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+        _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1))
+    );
+}
+
+inline __m128i load(const uint8_t* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+#endif
+
+// each character class has a scalar 'test' and, with SSE2, a 'mask' that
+// sets every byte of a block that's in the class.
+class Upper {
+public:
+    static bool test(uint8_t c) { return c >= 'A' && c <= 'Z'; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) { return inRange(v, 'A', 'Z'); }
+#endif
+};
+
+class Lower {
+public:
+    static bool test(uint8_t c) { return c >= 'a' && c <= 'z'; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) { return inRange(v, 'a', 'z'); }
+#endif
+};
+
+class Alpha {
+public:
+    static bool test(uint8_t c) { return Upper::test(c) || Lower::test(c); }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) { return _mm_or_si128(Upper::mask(v), Lower::mask(v)); }
+#endif
+};
+
+class Digit {
+public:
+    static bool test(uint8_t c) { return c >= '0' && c <= '9'; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) { return inRange(v, '0', '9'); }
+#endif
+};
+
+class Alnum {
+public:
+    static bool test(uint8_t c) { return Alpha::test(c) || Digit::test(c); }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) { return _mm_or_si128(Alpha::mask(v), Digit::mask(v)); }
+#endif
+};
+
+class Space {
+public:
+    static bool test(uint8_t c) { return (c >= '\t' && c <= '\r') || (c >= 0x1C && c <= 0x1F) || c == ' '; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) {
+        return _mm_or_si128(
+            _mm_or_si128(inRange(v, '\t', '\r'), inRange(v, 0x1C, 0x1F)),
+            _mm_cmpeq_epi8(v, _mm_set1_epi8(' '))
+        );
+    }
+#endif
+};
+
+// the whitespace bytes.split() and bytes.strip() use, which unlike str's
+// doesn't include 0x1C-0x1F
+class BytesSpace {
+public:
+    static bool test(uint8_t c) { return (c >= '\t' && c <= '\r') || c == ' '; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) {
+        return _mm_or_si128(inRange(v, '\t', '\r'), _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    }
+#endif
+};
+
+// str's whitespace among the codepoints up to 0xFF, which adds NEL and NBSP
+// to the ASCII ones.
+class Latin1Space {
+public:
+    static bool test(uint8_t c) { return Space::test(c) || c == 0x85 || c == 0xA0; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) {
+        return _mm_or_si128(
+            Space::mask(v),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)0x85)), _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xA0)))
+        );
+    }
+#endif
+};
+
+class Printable {
+public:
+    static bool test(uint8_t c) { return c >= ' ' && c <= '~'; }
+#if defined(__SSE2__)
+    static __m128i mask(__m128i v) { return inRange(v, ' ', '~'); }
+#endif
+};
+
+inline bool isAscii(const uint8_t* p, int64_t n) {
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+
+    for (; i + 16 <= n; i += 16) {
+        acc = _mm_or_si128(acc, load(p + i));
+    }
+
+    if (_mm_movemask_epi8(acc)) {
+        return false;
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (p[i] & 0x80) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// is every byte in 'n' bytes at 'p' in character class 'C'?
+template<class C>
+inline bool all(const uint8_t* p, int64_t n) {
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        if (_mm_movemask_epi8(C::mask(load(p + i))) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (!C::test(p[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<class C>
+inline bool any(const uint8_t* p, int64_t n) {
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        if (_mm_movemask_epi8(C::mask(load(p + i)))) {
+            return true;
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (C::test(p[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// the offset of the first of the 'n' bytes at 'p' that is (or, if not
+// 'isMember', isn't) in class 'C', or 'n' if there isn't one.
+template<class C, bool isMember = true>
+inline int64_t findFirst(const uint8_t* p, int64_t n) {
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        int mask = _mm_movemask_epi8(C::mask(load(p + i)));
+
+        if (!isMember) {
+            mask ^= 0xFFFF;
+        }
+
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (C::test(p[i]) == isMember) {
+            return i;
+        }
+    }
+
+    return n;
+}
+
+// the offset of the last of the 'n' bytes at 'p' that is (or isn't) in
+// class 'C', or -1 if there isn't one.
+template<class C, bool isMember = true>
+inline int64_t findLast(const uint8_t* p, int64_t n) {
+    int64_t i = n;
+
+#if defined(__SSE2__)
+    for (; i >= 16; i -= 16) {
+        int mask = _mm_movemask_epi8(C::mask(load(p + i - 16)));
+
+        if (!isMember) {
+            mask ^= 0xFFFF;
+        }
+
+        if (mask) {
+            return i - 16 + 31 - __builtin_clz(mask);
+        }
+    }
+#endif
+
+    while (i > 0) {
+        i--;
+        if (C::test(p[i]) == isMember) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// tells StringSearch::splitWhitespace where the bytes of class 'C' are
+template<class C>
+class SpaceScanner {
+public:
+    SpaceScanner(const uint8_t* data, int64_t len) : m_data(data), m_len(len) {}
+
+    int64_t firstSpace(int64_t i) const { return i + findFirst<C>(m_data + i, m_len - i); }
+    int64_t firstNonSpace(int64_t i) const { return i + findFirst<C, false>(m_data + i, m_len - i); }
+    int64_t lastSpace(int64_t i) const { return findLast<C>(m_data, i); }
+    int64_t lastNonSpace(int64_t i) const { return findLast<C, false>(m_data, i); }
+
+private:
+    const uint8_t* m_data;
+    int64_t m_len;
+};
+
+// copy 'n' bytes from 'src' to 'dst', flipping the case of the letters in class 'C'
+template<class C>
+inline void flipCase(const uint8_t* src, uint8_t* dst, int64_t n) {
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = load(src + i);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(v, _mm_and_si128(C::mask(v), caseBit)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        dst[i] = C::test(src[i]) ? src[i] ^ 0x20 : src[i];
+    }
+}
+
+inline void toLower(const uint8_t* src, uint8_t* dst, int64_t n) {
+    flipCase<Upper>(src, dst, n);
+}
+
+inline void toUpper(const uint8_t* src, uint8_t* dst, int64_t n) {
+    flipCase<Lower>(src, dst, n);
+}
+
+inline void swapCase(const uint8_t* src, uint8_t* dst, int64_t n) {
+    flipCase<Alpha>(src, dst, n);
+}
+
+} // end namespace AsciiOps
@@ -101,8 +101,8 @@ public:
         return m_first_arg->hash(left);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
-        return m_first_arg->deepBytecount(instance, alreadyVisited, outSlabs);
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
+        return m_first_arg->deepBytecount(instance, context, outSlabs);
     }
 
     void deepcopyConcrete(
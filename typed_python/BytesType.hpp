@@ -23,7 +23,7 @@ class BytesType : public Type {
 public:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         typed_python_hash_type hash_cache;
         int32_t bytecount;
         uint8_t data[];
@@ -72,37 +72,47 @@ public:
             return;
         }
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcLayout);
-        if (it == context.alreadyAllocated.end()) {
-            destLayout = (layout_ptr)context.slab->allocate(sizeof(layout) + srcLayout->bytecount, this);
-            destLayout->refcount = 0;
+        instance_ptr destPtr;
+        bool isNew;
+
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcLayout, [&]() {
+            layout_ptr newLayout = (layout_ptr)context.slab->allocate(sizeof(layout) + srcLayout->bytecount, this);
+            newLayout->refcount = 0;
+            return (instance_ptr)newLayout;
+        });
+
+        destLayout = (layout_ptr)destPtr;
+
+        if (isNew) {
             destLayout->hash_cache = srcLayout->hash_cache;
             destLayout->bytecount = srcLayout->bytecount;
             memcpy(destLayout->data, srcLayout->data, srcLayout->bytecount);
-
-            context.alreadyAllocated[(instance_ptr)srcLayout] = (instance_ptr)destLayout;
-        } else {
-            destLayout = (layout_ptr)it->second;
         }
 
         destLayout->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         layout* l = *(layout**)instance;
 
         if (!l) {
             return 0;
         }
 
+        if (context.deferLayout(this, l, l->refcount)) {
+            return 0;
+        }
+
         if (l->refcount != 1) {
-            if (alreadyVisited.find((void*)l) != alreadyVisited.end()) {
+            if (context.visited.contains((void*)l)) {
                 return 0;
             }
 
-            alreadyVisited.insert((void*)l);
+            context.visited.insert((void*)l);
         }
 
+        context.noteRefcount(l->refcount);
+
         if (outSlabs && Slab::slabForAlloc(l)) {
             outSlabs->insert(Slab::slabForAlloc(l));
             return 0;
@@ -203,4 +213,15 @@ public:
     static layout* replace(layout* l, layout* old, layout* the_new, int64_t count);
     static layout* translate(layout* l, layout* table, layout* to_delete);
     static layout* maketrans(layout* from, layout* to);
+
+    // search for 'sub' in l[start:end], with python's slice semantics for 'start' and 'end'.
+    static int64_t find(layout* l, layout* sub, int64_t start, int64_t end);
+    static int64_t rfind(layout* l, layout* sub, int64_t start, int64_t end);
+    static int64_t count(layout* l, layout* sub, int64_t start, int64_t end);
+
+    // the same, over 'len' bytes of memory we don't own, such as a buffer exported
+    // by another python object.
+    static int64_t find(const uint8_t* data, int64_t len, layout* sub, int64_t start, int64_t end);
+    static int64_t rfind(const uint8_t* data, int64_t len, layout* sub, int64_t start, int64_t end);
+    static int64_t count(const uint8_t* data, int64_t len, layout* sub, int64_t start, int64_t end);
 };
@@ -205,7 +205,7 @@ void Class::constructor(instance_ptr self, bool allowEmpty) {
         throw std::runtime_error(m_name + " is not default-constructible");
     }
 
-    initializeInstance(self, (layout*)tp_malloc(sizeof(layout) + m_heldClass->bytecount()), 0);
+    initializeInstance(self, allocateLayout(), 0);
 
     layout& l = *instanceToLayout(self);
     l.refcount = 1;
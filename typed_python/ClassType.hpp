@@ -38,7 +38,7 @@ class Class : public Type {
 public:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         vtable_ptr vtable;
         unsigned char data[];
     };
@@ -90,6 +90,14 @@ public:
         return layoutPtr;
     }
 
+    // allocate (but don't initialize) the layout of a new instance, attributing
+    // the memory to this Class if allocations are being sampled.
+    layout* allocateLayout() const {
+        TpAllocationTypeScope allocatingA((Type*)this);
+
+        return (layout*)tp_malloc(sizeof(layout) + m_heldClass->bytecount());
+    }
+
     // get the actual realized class contained in the instance of 'data'
     static Class* actualTypeForLayout(instance_ptr data) {
         return vtableFor(data)->mType->getClassType();
@@ -211,20 +219,26 @@ public:
         //layout_ptr& destRecordPtr = *(layout**)dest;
         layout_ptr srcRecordPtr = instanceToLayout(src);
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcRecordPtr);
+        // we could have a pointer to a subclass of 'this', in which case
+        // the layout could be larger and have more fields than
+        // mHeldClass would indicate.
+        HeldClass* actualHeldClassType = srcRecordPtr->vtable->mType;
 
-        if (it == context.alreadyAllocated.end()) {
-            // we could have a pointer to a subclass of 'this', in which case
-            // the layout could be larger and have more fields than
-            // mHeldClass would indicate.
-            HeldClass* actualHeldClassType = srcRecordPtr->vtable->mType;
+        instance_ptr destPtr;
+        bool isNew;
 
-            layout_ptr destRecordPtr = (layout_ptr)context.slab->allocate(
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcRecordPtr, [&]() {
+            layout_ptr newRecord = (layout_ptr)context.slab->allocate(
                 sizeof(layout) + actualHeldClassType->bytecount(),
                 this
             );
+            newRecord->refcount = 0;
+            return (instance_ptr)newRecord;
+        });
+
+        layout_ptr destRecordPtr = (layout_ptr)destPtr;
 
-            destRecordPtr->refcount = 0;
+        if (isNew) {
             destRecordPtr->vtable = srcRecordPtr->vtable;
 
             actualHeldClassType->deepcopy(
@@ -232,27 +246,26 @@ public:
                 srcRecordPtr->data,
                 context
             );
-
-            context.alreadyAllocated[(instance_ptr)srcRecordPtr] = (instance_ptr)destRecordPtr;
         }
 
-        ((layout_ptr)context.alreadyAllocated[(instance_ptr)srcRecordPtr])->refcount++;
+        destRecordPtr->refcount++;
 
         initializeInstance(
             dest,
-            (layout_ptr)context.alreadyAllocated[(instance_ptr)srcRecordPtr],
+            destRecordPtr,
             instanceToDispatchTableIndex(src)
         );
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         layout_ptr p = instanceToLayout(instance);
 
-        if (alreadyVisited.find((void*)p) != alreadyVisited.end()) {
+        if (context.visited.contains((void*)p)) {
             return 0;
         }
 
-        alreadyVisited.insert((void*)p);
+        context.visited.insert((void*)p);
+        context.noteRefcount(p->refcount);
 
         if (outSlabs && Slab::slabForAlloc(p)) {
             outSlabs->insert(Slab::slabForAlloc(p));
@@ -261,7 +274,7 @@ public:
 
         HeldClass* actualHeldClassType = p->vtable->mType;
 
-        return actualHeldClassType->deepBytecount(p->data, alreadyVisited, outSlabs) +
+        return actualHeldClassType->deepBytecount(p->data, context, outSlabs) +
             bytesRequiredForAllocation(sizeof(layout) + actualHeldClassType->bytecount());
     }
 
@@ -270,82 +283,110 @@ public:
         if (isFinal() || asIfFinal) {
             int64_t id = -1;
             bool hasMemo = false;
+            bool hasBody = false;
 
-            buffer.consumeCompoundMessage(inWireType, [&](size_t fieldNumber, size_t wireType) {
-                if (fieldNumber == 0) {
-                    assertWireTypesEqual(wireType, WireType::VARINT);
-                    id = buffer.readUnsignedVarint();
+            try {
+                buffer.consumeCompoundMessage(inWireType, [&](size_t fieldNumber, size_t wireType) {
+                    if (fieldNumber == 0) {
+                        assertWireTypesEqual(wireType, WireType::VARINT);
 
-                    void* ptr = buffer.lookupCachedPointer(id);
+                        if (id != -1) {
+                            throw std::runtime_error("Corrupt Class instance: multiple memos");
+                        }
 
-                    if (ptr) {
-                        hasMemo = true;
-                        copy_constructor(self, (instance_ptr)&ptr);
-                    }
-                }
-                if (fieldNumber == 1) {
-                    if (id == -1 || hasMemo) {
-                        throw std::runtime_error("Corrupt Class instance");
-                    }
-
-                    initializeInstance(
-                        self,
-                        (layout*)tp_malloc(
-                            sizeof(layout) + m_heldClass->bytecount()
-                        ),
-                        0
-                    );
+                        id = buffer.readUnsignedVarint();
 
-                    layout& record = *instanceToLayout(self);
-                    record.refcount = 2;
-                    record.vtable = m_heldClass->getVTable();
+                        void* ptr = buffer.lookupCachedPointer(id);
 
-                    buffer.addCachedPointer(id, instanceToLayout(self), this);
+                        if (ptr) {
+                            hasMemo = true;
+                            copy_constructor(self, (instance_ptr)&ptr);
+                        }
+                    }
+                    if (fieldNumber == 1) {
+                        if (id == -1 || hasMemo || hasBody) {
+                            throw std::runtime_error("Corrupt Class instance");
+                        }
 
-                    m_heldClass->deserialize(record.data, buffer, wireType);
-                }
-            });
-        } else {
-            Type* actualType = nullptr;
-            bool hasBody = false;
+                        initializeInstance(self, allocateLayout(), 0);
 
-            buffer.consumeCompoundMessage(inWireType, [&](size_t fieldNumber, size_t subWireType) {
-                if (fieldNumber == 0) {
-                    if (actualType) {
-                        throw std::runtime_error("Corrupt non-final class instance: multiple type definitions");
-                    }
+                        layout& record = *instanceToLayout(self);
+                        record.refcount = 2;
+                        record.vtable = m_heldClass->getVTable();
 
-                    actualType = buffer.getContext().deserializeNativeType(buffer, subWireType);
-                    if (!actualType || actualType->getTypeCategory() != Type::TypeCategory::catClass) {
-                        throw std::runtime_error("Deserialized class type was not a class!");
-                    }
-                } else if (fieldNumber == 1) {
-                    if (hasBody) {
-                        throw std::runtime_error("Corrupt non-final class instance: multiple bodies");
-                    }
-                    if (!actualType) {
-                        throw std::runtime_error("Corrupt non-final class instance: body before type");
-                    }
+                        try {
+                            buffer.addCachedPointer(id, instanceToLayout(self), this);
+                        } catch(...) {
+                            tp_free(&record);
+                            throw;
+                        }
 
-                    //recursively call into the serializer for the actual known type
-                    ((Class*)actualType)->deserialize(self, buffer, subWireType, true);
-                    hasBody = true;
+                        // the held class marks its members uninitialized before
+                        // it can fail, so from here on 'self' is safe to destroy.
+                        hasBody = true;
 
-                    // set the dispatch index of the new object
-                    int index = ((Class*)actualType)->getHeldClass()->getMroIndex(this->getHeldClass());
-                    if (index < 0) {
-                        throw std::runtime_error("Corrupt non-final class instance: realized class is not a subclass");
+                        m_heldClass->deserialize(record.data, buffer, wireType);
                     }
+                });
 
-                    initializeInstance(self, instanceToLayout(self), index);
+                if (!hasMemo && !hasBody) {
+                    throw std::runtime_error("Corrupt Class instance: no memo or body");
+                }
+            } catch(...) {
+                // the memo has its own reference to anything we built
+                if (hasMemo || hasBody) {
+                    destroy(self);
+                }
+                throw;
+            }
+        } else {
+            Type* actualType = nullptr;
+            bool hasBody = false;
 
-                    if (instanceToDispatchTableIndex(self) != index) {
-                        throw std::runtime_error("failed to set instance index");
+            try {
+                buffer.consumeCompoundMessage(inWireType, [&](size_t fieldNumber, size_t subWireType) {
+                    if (fieldNumber == 0) {
+                        if (actualType) {
+                            throw std::runtime_error("Corrupt non-final class instance: multiple type definitions");
+                        }
+
+                        actualType = buffer.getContext().deserializeNativeType(buffer, subWireType);
+                        if (!actualType || actualType->getTypeCategory() != Type::TypeCategory::catClass) {
+                            throw std::runtime_error("Deserialized class type was not a class!");
+                        }
+                    } else if (fieldNumber == 1) {
+                        if (hasBody) {
+                            throw std::runtime_error("Corrupt non-final class instance: multiple bodies");
+                        }
+                        if (!actualType) {
+                            throw std::runtime_error("Corrupt non-final class instance: body before type");
+                        }
+
+                        //recursively call into the serializer for the actual known type
+                        ((Class*)actualType)->deserialize(self, buffer, subWireType, true);
+                        hasBody = true;
+
+                        // set the dispatch index of the new object
+                        int index = ((Class*)actualType)->getHeldClass()->getMroIndex(this->getHeldClass());
+                        if (index < 0) {
+                            throw std::runtime_error("Corrupt non-final class instance: realized class is not a subclass");
+                        }
+
+                        initializeInstance(self, instanceToLayout(self), index);
+
+                        if (instanceToDispatchTableIndex(self) != index) {
+                            throw std::runtime_error("failed to set instance index");
+                        }
+                    } else {
+                        throw std::runtime_error("Corrupt non-final class instance: invalid field number");
                     }
-                } else {
-                    throw std::runtime_error("Corrupt non-final class instance: invalid field number");
+                });
+            } catch(...) {
+                if (hasBody) {
+                    destroy(self);
                 }
-            });
+                throw;
+            }
 
             if (!hasBody) {
                 throw std::runtime_error("Corrupt non-final class instance: body not initialized");
@@ -392,7 +433,7 @@ public:
     // 'initializer(instance_ptr memberData, int memberIx)' for each member
     template<class sub_constructor>
     void constructor(instance_ptr self, const sub_constructor& initializer) const {
-        initializeInstance(self, (layout*)tp_malloc(sizeof(layout) + m_heldClass->bytecount()), 0);
+        initializeInstance(self, allocateLayout(), 0);
 
         layout& l = *instanceToLayout(self);
         l.refcount = 1;
@@ -409,7 +450,7 @@ public:
     // 'initializer(instance_ptr data)'
     template<class sub_constructor>
     void constructorInitializingHeld(instance_ptr self, const sub_constructor& initializer) const {
-        initializeInstance(self, (layout*)tp_malloc(sizeof(layout) + m_heldClass->bytecount()), 0);
+        initializeInstance(self, allocateLayout(), 0);
 
         layout& l = *instanceToLayout(self);
         l.refcount = 1;
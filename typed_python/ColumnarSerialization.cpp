@@ -0,0 +1,421 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "ColumnarSerialization.hpp"
+#include "Varint.hpp"
+#include <unordered_map>
+
+namespace ColumnarSerialization {
+
+namespace {
+
+typedef SerializationPlan::Kind Kind;
+
+const uint64_t MODE_PLAIN = 0;
+const uint64_t MODE_DICTIONARY = 1;
+
+void writeVarint(std::vector<uint8_t>& out, uint64_t v) {
+    uint8_t bytes[Varint::MAX_BYTES];
+    out.insert(out.end(), bytes, bytes + Varint::encode(v, bytes));
+}
+
+size_t varintLength(uint64_t v) {
+    return Varint::encodedLength(v);
+}
+
+uint64_t zigzag(uint64_t delta) {
+    return (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+}
+
+uint64_t unzigzag(uint64_t z) {
+    return (z >> 1) ^ (0 - (z & 1));
+}
+
+// bounds-checked reads out of one encoded column
+class ColumnReader {
+public:
+    ColumnReader(const uint8_t* data, size_t bytecount) :
+        m_data(data),
+        m_end(data + bytecount)
+    {
+    }
+
+    uint64_t varint() {
+        uint64_t res;
+        m_data = Varint::decodeChecked(m_data, m_end, res);
+
+        if (!m_data) {
+            throw std::runtime_error("Corrupt columnar data (bad varint)");
+        }
+
+        return res;
+    }
+
+    void varints(uint64_t* out, size_t count) {
+        m_data = Varint::decodeMany(m_data, m_end, out, count);
+
+        if (!m_data) {
+            throw std::runtime_error("Corrupt columnar data (bad varint)");
+        }
+    }
+
+    const uint8_t* bytes(size_t n) {
+        if (remaining() < n) {
+            throw std::runtime_error("Corrupt columnar data (truncated value)");
+        }
+
+        const uint8_t* res = m_data;
+        m_data += n;
+        return res;
+    }
+
+    size_t remaining() const {
+        return m_end - m_data;
+    }
+
+    void finish() const {
+        if (m_data != m_end) {
+            throw std::runtime_error("Corrupt columnar data (trailing bytes)");
+        }
+    }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+};
+
+/********* ints *********/
+
+// values are widened to 64 bits (sign-extending the signed kinds) so that
+// every width shares one encoder, and the differences wrap, so that no
+// pair of values can overflow.
+template<class T>
+void encodeInts(instance_ptr rows, size_t stride, size_t count, std::vector<uint8_t>& out) {
+    // size for the worst case up front and encode straight into it
+    size_t start = out.size();
+    out.resize(start + count * Varint::MAX_BYTES);
+
+    uint8_t* p = out.data() + start;
+    uint64_t prev = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        T v;
+        memcpy(&v, rows + i * stride, sizeof(T));
+
+        uint64_t cur = (uint64_t)v;
+        p += Varint::encode(zigzag(cur - prev), p);
+        prev = cur;
+    }
+
+    out.resize(p - out.data());
+}
+
+template<class T>
+void decodeInts(ColumnReader& reader, instance_ptr rows, size_t stride, size_t count) {
+    // decode the varints a chunk at a time, and then undo the deltas
+    const size_t CHUNK = 256;
+    uint64_t deltas[CHUNK];
+
+    uint64_t prev = 0;
+
+    for (size_t i = 0; i < count; i += CHUNK) {
+        size_t n = std::min(CHUNK, count - i);
+
+        reader.varints(deltas, n);
+
+        for (size_t k = 0; k < n; k++) {
+            prev += unzigzag(deltas[k]);
+
+            T v = (T)prev;
+            memcpy(rows + (i + k) * stride, &v, sizeof(T));
+        }
+    }
+}
+
+/********* bools and floats *********/
+
+void encodeRaw(instance_ptr rows, size_t stride, size_t count, size_t width, std::vector<uint8_t>& out) {
+    size_t start = out.size();
+    out.resize(start + count * width);
+
+    for (size_t i = 0; i < count; i++) {
+        memcpy(&out[start + i * width], rows + i * stride, width);
+    }
+}
+
+void decodeRaw(ColumnReader& reader, instance_ptr rows, size_t stride, size_t count, size_t width) {
+    const uint8_t* data = reader.bytes(count * width);
+
+    for (size_t i = 0; i < count; i++) {
+        memcpy(rows + i * stride, data + i * width, width);
+    }
+}
+
+void decodeBools(ColumnReader& reader, instance_ptr rows, size_t stride, size_t count) {
+    const uint8_t* data = reader.bytes(count);
+
+    // don't trust the stream to hold valid bools
+    for (size_t i = 0; i < count; i++) {
+        *(bool*)(rows + i * stride) = data[i] != 0;
+    }
+}
+
+/********* str and bytes *********/
+
+std::string valueBytes(StringType* t, instance_ptr p) {
+    return t->toUtf8String(p);
+}
+
+std::string valueBytes(BytesType* t, instance_ptr p) {
+    BytesType::layout* l = *(BytesType::layout**)p;
+
+    if (!l) {
+        return std::string();
+    }
+
+    return std::string((const char*)l->data, l->bytecount);
+}
+
+StringType::layout* createValue(StringType* t, const uint8_t* data, size_t len, bool internStrings) {
+    StringType::layout* res = StringType::createFromUtf8Bytes(data, len);
+
+    if (internStrings) {
+        res = StringType::intern(res);
+    }
+
+    return res;
+}
+
+BytesType::layout* createValue(BytesType* t, const uint8_t* data, size_t len, bool internStrings) {
+    if (!len) {
+        return nullptr;
+    }
+
+    return BytesType::createFromPtr((const char*)data, len);
+}
+
+template<class concrete_type>
+void encodeStrings(concrete_type* t, instance_ptr rows, size_t stride, size_t count, std::vector<uint8_t>& out) {
+    // keys of an unordered_map stay put as it grows, so 'dictionary' can
+    // point into it.
+    std::unordered_map<std::string, uint64_t> index;
+    std::vector<const std::string*> dictionary;
+    std::vector<uint64_t> rowIndices(count);
+
+    size_t plainBytes = 0;
+    size_t dictionaryBytes = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        std::string value = valueBytes(t, rows + i * stride);
+
+        size_t len = value.size();
+        plainBytes += varintLength(len) + len;
+
+        auto it = index.emplace(std::move(value), dictionary.size());
+
+        if (it.second) {
+            dictionary.push_back(&it.first->first);
+            dictionaryBytes += varintLength(len) + len;
+        }
+
+        rowIndices[i] = it.first->second;
+        dictionaryBytes += varintLength(rowIndices[i]);
+    }
+
+    dictionaryBytes += varintLength(dictionary.size());
+
+    if (dictionaryBytes * 2 <= plainBytes) {
+        writeVarint(out, MODE_DICTIONARY);
+        writeVarint(out, dictionary.size());
+
+        for (auto valuePtr: dictionary) {
+            writeVarint(out, valuePtr->size());
+            out.insert(out.end(), valuePtr->begin(), valuePtr->end());
+        }
+
+        for (auto ix: rowIndices) {
+            writeVarint(out, ix);
+        }
+    } else {
+        writeVarint(out, MODE_PLAIN);
+
+        for (size_t i = 0; i < count; i++) {
+            std::string value = valueBytes(t, rows + i * stride);
+
+            writeVarint(out, value.size());
+            out.insert(out.end(), value.begin(), value.end());
+        }
+    }
+}
+
+template<class concrete_type>
+void decodeStrings(
+    concrete_type* t,
+    ColumnReader& reader,
+    instance_ptr rows,
+    size_t stride,
+    size_t count,
+    bool internStrings
+) {
+    typedef typename concrete_type::layout layout;
+
+    uint64_t mode = reader.varint();
+
+    if (mode == MODE_PLAIN) {
+        for (size_t i = 0; i < count; i++) {
+            size_t len = reader.varint();
+            *(layout**)(rows + i * stride) = createValue(t, reader.bytes(len), len, internStrings);
+        }
+        return;
+    }
+
+    if (mode != MODE_DICTIONARY) {
+        throw std::runtime_error("Corrupt columnar data (unknown string column mode)");
+    }
+
+    size_t dictionarySize = reader.varint();
+
+    // every entry takes at least a byte, which bounds the allocation below
+    if (dictionarySize > reader.remaining()) {
+        throw std::runtime_error("Corrupt columnar data (dictionary too large)");
+    }
+
+    std::vector<layout*> dictionary;
+    dictionary.reserve(dictionarySize);
+
+    try {
+        for (size_t i = 0; i < dictionarySize; i++) {
+            size_t len = reader.varint();
+            dictionary.push_back(createValue(t, reader.bytes(len), len, internStrings));
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            uint64_t ix = reader.varint();
+
+            if (ix >= dictionarySize) {
+                throw std::runtime_error("Corrupt columnar data (dictionary index out of range)");
+            }
+
+            layout* value = dictionary[ix];
+            if (value) {
+                value->refcount++;
+            }
+
+            *(layout**)(rows + i * stride) = value;
+        }
+    } catch(...) {
+        for (auto& entry: dictionary) {
+            concrete_type::destroyStatic((instance_ptr)&entry);
+        }
+        throw;
+    }
+
+    for (auto& entry: dictionary) {
+        concrete_type::destroyStatic((instance_ptr)&entry);
+    }
+}
+
+} // end anonymous namespace
+
+const SerializationPlan* planFor(Type* eltType) {
+    if (eltType->getTypeCategory() != Type::TypeCategory::catNamedTuple &&
+            eltType->getTypeCategory() != Type::TypeCategory::catTuple) {
+        return nullptr;
+    }
+
+    const SerializationPlan& plan = ((CompositeType*)eltType)->getSerializationPlan();
+
+    if (!plan.size()) {
+        return nullptr;
+    }
+
+    for (size_t k = 0; k < plan.size(); k++) {
+        if (plan[k].kind == Kind::Other) {
+            return nullptr;
+        }
+    }
+
+    return &plan;
+}
+
+void encodeColumn(
+    const SerializationPlan::Field& field,
+    instance_ptr rows,
+    size_t stride,
+    size_t count,
+    std::vector<uint8_t>& out
+) {
+    rows += field.offset;
+
+    switch (field.kind) {
+        case Kind::Bool: encodeRaw(rows, stride, count, sizeof(bool), out); return;
+        case Kind::Int8: encodeInts<int8_t>(rows, stride, count, out); return;
+        case Kind::Int16: encodeInts<int16_t>(rows, stride, count, out); return;
+        case Kind::Int32: encodeInts<int32_t>(rows, stride, count, out); return;
+        case Kind::Int64: encodeInts<int64_t>(rows, stride, count, out); return;
+        case Kind::UInt8: encodeInts<uint8_t>(rows, stride, count, out); return;
+        case Kind::UInt16: encodeInts<uint16_t>(rows, stride, count, out); return;
+        case Kind::UInt32: encodeInts<uint32_t>(rows, stride, count, out); return;
+        case Kind::UInt64: encodeInts<uint64_t>(rows, stride, count, out); return;
+        case Kind::Float32: encodeRaw(rows, stride, count, sizeof(float), out); return;
+        case Kind::Float64: encodeRaw(rows, stride, count, sizeof(double), out); return;
+        case Kind::String: encodeStrings((StringType*)field.type, rows, stride, count, out); return;
+        case Kind::Bytes: encodeStrings((BytesType*)field.type, rows, stride, count, out); return;
+        case Kind::Other:
+            throw std::runtime_error("Can't serialize " + field.type->name() + " as a column");
+    }
+}
+
+void decodeColumn(
+    const SerializationPlan::Field& field,
+    const uint8_t* data,
+    size_t bytecount,
+    instance_ptr rows,
+    size_t stride,
+    size_t count,
+    bool internStrings
+) {
+    ColumnReader reader(data, bytecount);
+
+    rows += field.offset;
+
+    switch (field.kind) {
+        case Kind::Bool: decodeBools(reader, rows, stride, count); break;
+        case Kind::Int8: decodeInts<int8_t>(reader, rows, stride, count); break;
+        case Kind::Int16: decodeInts<int16_t>(reader, rows, stride, count); break;
+        case Kind::Int32: decodeInts<int32_t>(reader, rows, stride, count); break;
+        case Kind::Int64: decodeInts<int64_t>(reader, rows, stride, count); break;
+        case Kind::UInt8: decodeInts<uint8_t>(reader, rows, stride, count); break;
+        case Kind::UInt16: decodeInts<uint16_t>(reader, rows, stride, count); break;
+        case Kind::UInt32: decodeInts<uint32_t>(reader, rows, stride, count); break;
+        case Kind::UInt64: decodeInts<uint64_t>(reader, rows, stride, count); break;
+        case Kind::Float32: decodeRaw(reader, rows, stride, count, sizeof(float)); break;
+        case Kind::Float64: decodeRaw(reader, rows, stride, count, sizeof(double)); break;
+        case Kind::String:
+            decodeStrings((StringType*)field.type, reader, rows, stride, count, internStrings);
+            break;
+        case Kind::Bytes:
+            decodeStrings((BytesType*)field.type, reader, rows, stride, count, internStrings);
+            break;
+        case Kind::Other:
+            throw std::runtime_error("Can't deserialize " + field.type->name() + " from a column");
+    }
+
+    reader.finish();
+}
+
+} // end namespace ColumnarSerialization
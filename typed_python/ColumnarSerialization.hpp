@@ -0,0 +1,72 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "SerializationPlan.hpp"
+#include <vector>
+
+/*********
+The column encodings 'SerializationContext.withColumnarLists' uses for a
+ListOf or TupleOf of NamedTuples or Tuples.
+
+Each field of the element is written as one block holding that field for
+every row:
+
+    ints (any width, signed or not) - the zigzag varint of each row's
+        difference from the previous row, so sorted ids and timestamps
+        take a byte or two apiece.
+    bool, float32, float64 - the raw values, packed.
+    str, bytes - a varint mode. Mode 0 is each value as a varint length
+        and its bytes (utf8 for str). Mode 1 is a dictionary of the distinct
+        values, in the same form, followed by each row's varint index into
+        it. We use the dictionary whenever it's at most half as long as
+        the column.
+
+The list body is the row count under field number 3, followed by each
+column as a BYTES message whose field number is the column's index.
+TupleOrListOfType owns that framing; this only encodes and decodes one
+column at a time, against a block of rows 'stride' bytes apart.
+*********/
+
+namespace ColumnarSerialization {
+
+// the element's plan, if every field of 'eltType' is one of the leaf kinds
+// we can write as a column, or nullptr
+const SerializationPlan* planFor(Type* eltType);
+
+void encodeColumn(
+    const SerializationPlan::Field& field,
+    instance_ptr rows,
+    size_t stride,
+    size_t count,
+    std::vector<uint8_t>& out
+);
+
+// fill 'field' in each of 'count' rows from one encoded column. The rows
+// must already hold valid values of the field (all-zero bytes, in practice,
+// which every leaf kind accepts), which this overwrites without destroying.
+void decodeColumn(
+    const SerializationPlan::Field& field,
+    const uint8_t* data,
+    size_t bytecount,
+    instance_ptr rows,
+    size_t stride,
+    size_t count,
+    bool internStrings
+);
+
+} // end namespace ColumnarSerialization
@@ -53,11 +53,9 @@ bool CompositeType::_updateAfterForwardTypesChanged() {
         }
     }
 
-    m_serialize_typecodes.clear();
-    m_serialize_typecodes_to_position.clear();
+    m_serialization_plan.clear();
     for (int i = 0; i < m_types.size(); i++) {
-        m_serialize_typecodes.push_back(i);
-        m_serialize_typecodes_to_position[i] = i;
+        m_serialization_plan.addField(m_types[i], m_byte_offsets[i], i);
     }
 
     bool anyChanged = (
@@ -76,6 +74,26 @@ bool CompositeType::cmp(instance_ptr left, instance_ptr right, int pyComparisonO
         return !cmp(left, right, Py_EQ, suppressExceptions);
     }
 
+    if (hasBitwiseEquality()) {
+        size_t offset = firstDifferingByte(left, right, m_size);
+
+        if (offset == m_size) {
+            return cmpResultToBoolForPyOrdering(pyComparisonOp, 0);
+        }
+
+        if (pyComparisonOp == Py_EQ) {
+            return false;
+        }
+
+        // compare the field holding the first byte that differs
+        long k = std::upper_bound(m_byte_offsets.begin(), m_byte_offsets.end(), offset) - m_byte_offsets.begin() - 1;
+
+        return cmpResultToBoolForPyOrdering(
+            pyComparisonOp,
+            m_types[k]->cmp(left + m_byte_offsets[k], right + m_byte_offsets[k], Py_LT, suppressExceptions) ? -1 : 1
+        );
+    }
+
     if (pyComparisonOp == Py_EQ) {
         for (long k = 0; k < m_types.size(); k++) {
             if (m_types[k]->cmp(left + m_byte_offsets[k], right + m_byte_offsets[k], Py_NE, suppressExceptions)) {
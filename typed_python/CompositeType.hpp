@@ -18,6 +18,7 @@
 
 #include "Type.hpp"
 #include "ReprAccumulator.hpp"
+#include "SerializationPlan.hpp"
 #include <unordered_map>
 
 class CompositeType : public Type {
@@ -98,11 +99,11 @@ public:
         }
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         size_t res = 0;
 
         for (long k = 0; k < getTypes().size(); k++) {
-            res += getTypes()[k]->deepBytecount(eltPtr(instance, k), alreadyVisited, outSlabs);
+            res += getTypes()[k]->deepBytecount(eltPtr(instance, k), context, outSlabs);
         }
 
         return res;
@@ -125,15 +126,28 @@ public:
             initialized[k] = false;
         }
 
-        buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
-            auto it = m_serialize_typecodes_to_position.find(fieldNumber);
-            if (it != m_serialize_typecodes_to_position.end()) {
-                initialized[it->second] = true;
-                getTypes()[it->second]->deserialize(eltPtr(self, it->second), buffer, subWireType);
-            } else {
-                buffer.finishReadingMessageAndDiscard(subWireType);
+        try {
+            buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
+                // field k is written with field number k
+                if (fieldNumber < m_serialization_plan.size()) {
+                    if (initialized[fieldNumber]) {
+                        throw std::runtime_error("Corrupt data: field " + format(fieldNumber) + " of " + name() + " appears twice");
+                    }
+
+                    SerializationPlan::deserializeField(m_serialization_plan[fieldNumber], self, buffer, subWireType);
+                    initialized[fieldNumber] = true;
+                } else {
+                    buffer.finishReadingMessageAndDiscard(subWireType);
+                }
+            });
+        } catch(...) {
+            for (long k = 0; k < m_types.size(); k++) {
+                if (initialized[k]) {
+                    getTypes()[k]->destroy(eltPtr(self, k));
+                }
             }
-        });
+            throw;
+        }
 
         for (long k = 0; k < m_types.size();k++) {
             if (!initialized[k]) {
@@ -162,8 +176,8 @@ public:
             buffer.writeBeginCompound(fieldNumber);
         }
 
-        for (long k = 0; k < getTypes().size();k++) {
-            getTypes()[k]->serialize(eltPtr(self,k), buffer, m_serialize_typecodes[k]);
+        for (long k = 0; k < m_serialization_plan.size(); k++) {
+            SerializationPlan::serializeField(m_serialization_plan[k], self, buffer);
         }
 
         if (getTypes().size() > 1) {
@@ -171,6 +185,15 @@ public:
         }
     }
 
+    // serialize the elements of a ListOf or TupleOf of this type without
+    // dispatching on the element type again for each one.
+    template<class buf_t>
+    void serializeMultiConcrete(instance_ptr left, size_t count, size_t stride, buf_t& buffer, size_t fieldNumber) {
+        for (long k = 0; k < count; k++) {
+            serialize(left + stride * k, buffer, fieldNumber);
+        }
+    }
+
     void repr(instance_ptr self, ReprAccumulator& stream, bool isStr);
 
     typed_python_hash_type hash(instance_ptr left);
@@ -218,6 +241,9 @@ public:
     const std::vector<Type*>& getTypes() const {
         return m_types;
     }
+    const SerializationPlan& getSerializationPlan() const {
+        return m_serialization_plan;
+    }
     const std::vector<size_t>& getOffsets() const {
         return m_byte_offsets;
     }
@@ -254,8 +280,7 @@ protected:
     std::vector<size_t> m_byte_offsets;
     std::vector<std::string> m_names;
     std::map<std::string, int> m_nameToIndex;
-    std::vector<size_t> m_serialize_typecodes; //codes to use when serializing/deserializing
-    std::unordered_map<size_t, size_t> m_serialize_typecodes_to_position; //codes to use when serializing/deserializing
+    SerializationPlan m_serialization_plan;
 };
 
 PyDoc_STRVAR(NamedTuple_doc,
@@ -51,8 +51,8 @@ public:
         return m_alternative->deepcopy(dest, src, context);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
-        return m_alternative->deepBytecount(instance, alreadyVisited, outSlabs);
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
+        return m_alternative->deepBytecount(instance, context, outSlabs);
     }
 
     void _updateTypeMemosAfterForwardResolution() {
@@ -115,9 +115,10 @@ public:
     //returns an uninitialized object of type-index 'which'
     template<class subconstructor>
     void constructor(instance_ptr self, const subconstructor& s) const {
-        if (m_alternative->all_alternatives_empty()) {
+        if (m_alternative->is_inline()) {
+            memset(self, 0, m_alternative->bytecount());
             *(uint8_t*)self = m_which;
-            s(self);
+            s(self + 1);
         } else {
             *(layout**)self = (layout*)tp_malloc(
                 sizeof(layout) +
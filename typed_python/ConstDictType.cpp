@@ -249,33 +249,74 @@ bool ConstDictType::cmp(instance_ptr left, instance_ptr right, int pyComparisonO
     }
 }
 
+// both 'lhs' and 'rhs' are sorted by key, so we can produce the (sorted) result
+// with a single merge. We count the output first so we can allocate it exactly.
 void ConstDictType::addDicts(instance_ptr lhs, instance_ptr rhs, instance_ptr output) {
-    std::vector<instance_ptr> keep;
-
     int64_t lhsCount = count(lhs);
     int64_t rhsCount = count(rhs);
 
-    for (long k = 0; k < lhsCount; k++) {
-        instance_ptr lhsVal = kvPairPtrKey(lhs, k);
+    if (!lhsCount) {
+        copy_constructor(output, rhs);
+        return;
+    }
+
+    if (!rhsCount) {
+        copy_constructor(output, lhs);
+        return;
+    }
+
+    int64_t outCount = rhsCount;
+
+    for (int64_t l = 0, r = 0; l < lhsCount; ) {
+        if (r >= rhsCount) {
+            outCount += lhsCount - l;
+            break;
+        }
 
-        if (!lookupValueByKey(rhs, lhsVal)) {
-            keep.push_back(lhsVal);
+        if (m_key->cmp(kvPairPtrKey(lhs, l), kvPairPtrKey(rhs, r), Py_LT, true)) {
+            outCount++;
+            l++;
+        } else if (m_key->cmp(kvPairPtrKey(rhs, r), kvPairPtrKey(lhs, l), Py_LT, true)) {
+            r++;
+        } else {
+            l++;
+            r++;
         }
     }
 
-    constructor(output, rhsCount + keep.size(), false);
+    constructor(output, outCount, false);
 
-    for (long k = 0; k < rhsCount; k++) {
-        m_key->copy_constructor(kvPairPtrKey(output,k), kvPairPtrKey(rhs, k));
-        m_value->copy_constructor(kvPairPtrValue(output,k), kvPairPtrValue(rhs, k));
+    int64_t written = 0;
+    int64_t l = 0;
+    int64_t r = 0;
+
+    auto emit = [&](instance_ptr source, int64_t ix) {
+        m_key->copy_constructor(kvPairPtrKey(output, written), kvPairPtrKey(source, ix));
+        m_value->copy_constructor(kvPairPtrValue(output, written), kvPairPtrValue(source, ix));
+        written++;
+    };
+
+    while (l < lhsCount && r < rhsCount) {
+        if (m_key->cmp(kvPairPtrKey(lhs, l), kvPairPtrKey(rhs, r), Py_LT, true)) {
+            emit(lhs, l++);
+        } else {
+            // on equal keys, the right-hand side wins
+            if (!m_key->cmp(kvPairPtrKey(rhs, r), kvPairPtrKey(lhs, l), Py_LT, true)) {
+                l++;
+            }
+            emit(rhs, r++);
+        }
+    }
+
+    while (l < lhsCount) {
+        emit(lhs, l++);
     }
-    for (long k = 0; k < keep.size(); k++) {
-        m_key->copy_constructor(kvPairPtrKey(output,k + rhsCount), keep[k]);
-        m_value->copy_constructor(kvPairPtrValue(output,k + rhsCount), keep[k] + m_bytes_per_key);
+
+    while (r < rhsCount) {
+        emit(rhs, r++);
     }
-    incKvPairCount(output, keep.size() + rhsCount);
 
-    sortKvPairs(output);
+    incKvPairCount(output, written);
 }
 
 void ConstDictType::subtractTupleOfKeysFromDict(instance_ptr lhs, instance_ptr rhs, instance_ptr output) {
@@ -284,20 +325,29 @@ void ConstDictType::subtractTupleOfKeysFromDict(instance_ptr lhs, instance_ptr r
     int64_t lhsCount = count(lhs);
     int64_t rhsCount = tupleType->count(rhs);
 
-    std::set<int> remove;
+    // a flag per lhs entry is cheaper than a std::set of indices, and lets
+    // us write the output in a single linear pass.
+    std::vector<uint8_t> remove(lhsCount, 0);
+    int64_t removeCount = 0;
 
     for (long k = 0; k < rhsCount; k++) {
         int64_t index = lookupIndexByKey(lhs, tupleType->eltPtr(rhs, k));
-        if (index != -1) {
-            remove.insert(index);
+        if (index != -1 && !remove[index]) {
+            remove[index] = 1;
+            removeCount++;
         }
     }
 
-    constructor(output, lhsCount - remove.size(), false);
+    if (!removeCount) {
+        copy_constructor(output, lhs);
+        return;
+    }
+
+    constructor(output, lhsCount - removeCount, false);
 
     long written = 0;
     for (long k = 0; k < lhsCount; k++) {
-        if (remove.find(k) == remove.end()) {
+        if (!remove[k]) {
             m_key->copy_constructor(kvPairPtrKey(output,written), kvPairPtrKey(lhs, k));
             m_value->copy_constructor(kvPairPtrValue(output,written), kvPairPtrValue(lhs, k));
 
@@ -30,7 +30,7 @@ class ConstDictType : public Type {
 public:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         typed_python_hash_type hash_cache;
         int32_t count; //the actual number of items in the tree (in total)
         int32_t subpointers; //if 0, then all values are inline as pairs of (key,value)
@@ -143,7 +143,7 @@ public:
             return;
         }
 
-        auto doDeepcopy = [&]() {
+        auto allocate = [&]() {
             int bytecount;
             if (srcRecordPtr->subpointers) {
                 bytecount = sizeof(layout) + srcRecordPtr->subpointers * m_bytes_per_key_subtree_pair;
@@ -151,11 +151,14 @@ public:
                 bytecount = sizeof(layout) + srcRecordPtr->count * m_bytes_per_key_value_pair;
             }
 
-            destRecordPtr = (layout_ptr)context.slab->allocate(bytecount, this);
+            layout_ptr newRecord = (layout_ptr)context.slab->allocate(bytecount, this);
+            newRecord->refcount = 0;
+            return (instance_ptr)newRecord;
+        };
 
+        auto fill = [&]() {
             destRecordPtr->count = srcRecordPtr->count;
             destRecordPtr->subpointers = srcRecordPtr->subpointers;
-            destRecordPtr->refcount = 0;
             destRecordPtr->hash_cache = srcRecordPtr->hash_cache;
 
             if (srcRecordPtr->subpointers) {
@@ -188,40 +191,53 @@ public:
         };
 
         if (srcRecordPtr->refcount == 1) {
-            doDeepcopy();
+            destRecordPtr = (layout_ptr)allocate();
+            fill();
         } else {
-            auto it = context.alreadyAllocated.find((instance_ptr)srcRecordPtr);
-            if (it == context.alreadyAllocated.end()) {
-                doDeepcopy();
-                context.alreadyAllocated[(instance_ptr)srcRecordPtr] = (instance_ptr)destRecordPtr;
-            } else {
-                destRecordPtr = (layout_ptr)it->second;
+            instance_ptr destPtr;
+            bool isNew;
+
+            std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcRecordPtr, allocate);
+
+            destRecordPtr = (layout_ptr)destPtr;
+
+            if (isNew) {
+                fill();
             }
         }
 
         destRecordPtr->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         layout* l = *(layout**)instance;
 
         if (!l) {
             return 0;
         }
 
+        if (context.deferLayout(this, l, l->refcount)) {
+            return 0;
+        }
+
         if (l->refcount != 1) {
-            if (alreadyVisited.find((void*)l) != alreadyVisited.end()) {
+            if (context.visited.contains((void*)l)) {
                 return 0;
             }
         }
 
-        alreadyVisited.insert((void*)l);
+        context.visited.insert((void*)l);
+        context.noteRefcount(l->refcount);
 
         if (outSlabs && Slab::slabForAlloc(l)) {
             outSlabs->insert(Slab::slabForAlloc(l));
             return 0;
         }
 
+        if (context.shouldUseCache(this)) {
+            return context.cachedBytecount(this, l, outSlabs);
+        }
+
         size_t res = bytesRequiredForAllocation(
             sizeof(layout)
             + l->subpointers * m_bytes_per_key_subtree_pair
@@ -230,13 +246,13 @@ public:
 
         if (l->subpointers) {
             for (long k = 0; k < l->subpointers; k++) {
-                res += m_key->deepBytecount(kdPairPtrKey(instance, k), alreadyVisited, outSlabs);
-                res += deepBytecount(kdPairPtrDict(instance, k), alreadyVisited, outSlabs);
+                res += m_key->deepBytecount(kdPairPtrKey(instance, k), context, outSlabs);
+                res += deepBytecount(kdPairPtrDict(instance, k), context, outSlabs);
             }
         } else {
             for (long k = 0; k < l->count; k++) {
-                res += m_key->deepBytecount(kvPairPtrKey(instance, k), alreadyVisited, outSlabs);
-                res += m_value->deepBytecount(kvPairPtrValue(instance, k), alreadyVisited, outSlabs);
+                res += m_key->deepBytecount(kvPairPtrKey(instance, k), context, outSlabs);
+                res += m_value->deepBytecount(kvPairPtrValue(instance, k), context, outSlabs);
             }
         }
 
@@ -245,32 +261,62 @@ public:
 
     template<class buf_t>
     void deserialize(instance_ptr self, buf_t& buffer, size_t wireType) {
-        int32_t ct = -1;
+        int64_t ct = -1;
+        bool hasPendingKey = false;
 
-        size_t valuesRead = buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
-            [&](size_t fieldNumber, size_t subWireType) {
-                if (fieldNumber == 0) {
-                    if (subWireType != WireType::VARINT) {
-                        throw std::runtime_error("Corrupt ConstDict");
-                    }
-                    ct = buffer.readUnsignedVarint();
-                    constructor(self, ct, false);
-                } else {
-                    size_t keyIx = (fieldNumber - 1) / 2;
-                    bool isKey = fieldNumber % 2;
-                    if (isKey) {
-                        m_key->deserialize(kvPairPtrKey(self, keyIx), buffer, subWireType);
+        try {
+            size_t valuesRead = buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
+                [&](size_t fieldNumber, size_t subWireType) {
+                    if (fieldNumber == 0) {
+                        if (subWireType != WireType::VARINT) {
+                            throw std::runtime_error("Corrupt ConstDict");
+                        }
+                        size_t count = buffer.readUnsignedVarint();
+
+                        if (count > std::numeric_limits<int32_t>::max()) {
+                            throw std::runtime_error("Corrupt ConstDict: too many entries");
+                        }
+
+                        buffer.chargeAllocation(count, m_bytes_per_key_value_pair);
+
+                        ct = count;
+                        constructor(self, ct, false);
                     } else {
-                        m_value->deserialize(kvPairPtrValue(self, keyIx), buffer, subWireType);
+                        size_t keyIx = (fieldNumber - 1) / 2;
+                        bool isKey = fieldNumber % 2;
+
+                        if ((int64_t)keyIx >= ct) {
+                            throw std::runtime_error("Corrupt ConstDict: more entries than its count");
+                        }
+
+                        if (isKey) {
+                            m_key->deserialize(kvPairPtrKey(self, keyIx), buffer, subWireType);
+                            hasPendingKey = true;
+                        } else {
+                            m_value->deserialize(kvPairPtrValue(self, keyIx), buffer, subWireType);
+                            hasPendingKey = false;
+
+                            // count each pair as we finish it, so that if we fail
+                            // we destroy exactly the ones we built
+                            incKvPairCount(self);
+                        }
                     }
+            });
+
+            if (ct == -1 || (valuesRead - 1) / 2 != ct) {
+                throw std::runtime_error("Corrupt ConstDict.");
+            }
+        } catch(...) {
+            if (ct > 0) {
+                if (hasPendingKey) {
+                    m_key->destroy(kvPairPtrKey(self, (*(layout**)self)->count));
                 }
-        });
 
-        if (ct == -1 || (valuesRead - 1) / 2 != ct) {
-            throw std::runtime_error("Corrupt ConstDict.");
-        }
+                destroy(self);
+            }
 
-        incKvPairCount(self, ct);
+            throw;
+        }
     }
 
     void repr(instance_ptr self, ReprAccumulator& stream, bool isStr);
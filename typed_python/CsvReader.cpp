@@ -0,0 +1,653 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "CsvReader.hpp"
+#include "NumberParsing.hpp"
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+namespace CsvReader {
+
+namespace {
+
+typedef Type::TypeCategory TypeCategory;
+
+// if 't' is OneOf(None, T), T. Otherwise nullptr.
+Type* nullableValueType(Type* t) {
+    if (!t->isOneOf()) {
+        return nullptr;
+    }
+
+    const std::vector<Type*>& types = ((OneOfType*)t)->getTypes();
+
+    if (types.size() != 2 || types[0]->isNone() == types[1]->isNone()) {
+        return nullptr;
+    }
+
+    return types[0]->isNone() ? types[1] : types[0];
+}
+
+bool isCellType(Type* t) {
+    switch (t->getTypeCategory()) {
+        case TypeCategory::catBool:
+        case TypeCategory::catInt8:
+        case TypeCategory::catInt16:
+        case TypeCategory::catInt32:
+        case TypeCategory::catInt64:
+        case TypeCategory::catUInt8:
+        case TypeCategory::catUInt16:
+        case TypeCategory::catUInt32:
+        case TypeCategory::catUInt64:
+        case TypeCategory::catFloat32:
+        case TypeCategory::catFloat64:
+        case TypeCategory::catString:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// splits records into fields
+class Tokenizer {
+public:
+    Tokenizer(const uint8_t* begin, const uint8_t* end, uint8_t delimiter) :
+        m_p(begin),
+        m_end(end),
+        m_delimiter(delimiter)
+    {
+    }
+
+    // skip blank lines, returning false if there are no more records
+    bool startRecord() {
+        while (m_p < m_end && (*m_p == '\n' || (*m_p == '\r' && m_p + 1 < m_end && m_p[1] == '\n'))) {
+            m_p += *m_p == '\r' ? 2 : 1;
+        }
+
+        return m_p < m_end;
+    }
+
+    // read the next field of the current record, returning true if it was the
+    // last one. 'field' is valid until the next call.
+    bool nextField(const uint8_t*& field, size_t& length) {
+        if (m_p < m_end && *m_p == '"') {
+            m_p++;
+
+            const uint8_t* start = m_p;
+            bool escaped = false;
+
+            while (true) {
+                const uint8_t* quote = (const uint8_t*)memchr(m_p, '"', m_end - m_p);
+
+                if (!quote) {
+                    throw std::runtime_error("unterminated quoted field");
+                }
+
+                if (quote + 1 < m_end && quote[1] == '"') {
+                    escaped = true;
+                    m_p = quote + 2;
+                    continue;
+                }
+
+                m_p = quote + 1;
+
+                if (!escaped) {
+                    field = start;
+                    length = quote - start;
+                } else {
+                    m_scratch.clear();
+
+                    for (const uint8_t* c = start; c < quote; c++) {
+                        m_scratch.push_back(*c);
+
+                        // skip the second quote of each ""
+                        if (*c == '"') {
+                            c++;
+                        }
+                    }
+
+                    field = (const uint8_t*)m_scratch.data();
+                    length = m_scratch.size();
+                }
+                break;
+            }
+
+            if (m_p < m_end && *m_p != m_delimiter && *m_p != '\n' && *m_p != '\r') {
+                throw std::runtime_error("unexpected character after a quoted field");
+            }
+        } else {
+            const uint8_t* start = m_p;
+
+            while (m_p < m_end && *m_p != m_delimiter && *m_p != '\n') {
+                m_p++;
+            }
+
+            const uint8_t* stop = m_p;
+
+            if (stop > start && stop[-1] == '\r' && (m_p == m_end || *m_p == '\n')) {
+                stop--;
+            }
+
+            field = start;
+            length = stop - start;
+        }
+
+        if (m_p == m_end) {
+            return true;
+        }
+
+        if (*m_p == m_delimiter) {
+            m_p++;
+            return false;
+        }
+
+        if (*m_p == '\r') {
+            m_p++;
+        }
+        if (m_p < m_end && *m_p == '\n') {
+            m_p++;
+        }
+
+        return true;
+    }
+
+    const uint8_t* position() const {
+        return m_p;
+    }
+
+private:
+    const uint8_t* m_p;
+    const uint8_t* m_end;
+    uint8_t m_delimiter;
+
+    // the unescaped text of the last quoted field that had "" in it
+    std::string m_scratch;
+};
+
+// the values of one column that one thread has parsed so far
+class ColumnBuffer {
+public:
+    explicit ColumnBuffer(Type* t) :
+        m_type(t),
+        m_bytesPer(t->bytecount()),
+        m_count(0)
+    {
+    }
+
+    ~ColumnBuffer() {
+        for (size_t k = 0; k < m_count; k++) {
+            m_type->destroy(&m_data[k * m_bytesPer]);
+        }
+    }
+
+    // room for one more value. Construct it, then call 'commit'.
+    instance_ptr next() {
+        if ((m_count + 1) * m_bytesPer > m_data.size()) {
+            m_data.resize(std::max<size_t>(m_data.size() * 2, 64 * m_bytesPer));
+        }
+
+        return &m_data[m_count * m_bytesPer];
+    }
+
+    void commit() {
+        m_count++;
+    }
+
+    size_t count() const {
+        return m_count;
+    }
+
+    // move our values, bitwise, to 'out', which takes over their references
+    void moveTo(instance_ptr out) {
+        if (m_count) {
+            memcpy(out, &m_data[0], m_count * m_bytesPer);
+        }
+        m_count = 0;
+    }
+
+private:
+    Type* m_type;
+    size_t m_bytesPer;
+    size_t m_count;
+    std::vector<uint8_t> m_data;
+};
+
+// each thread's strings for one column, so repeated values are looked up in
+// the shared intern table, which takes a lock, only once per thread.
+class StringCache {
+public:
+    explicit StringCache(bool intern) : m_intern(intern) {
+    }
+
+    ~StringCache() {
+        for (auto& valueAndLayout: m_strings) {
+            StringType::Make()->destroy((instance_ptr)&valueAndLayout.second);
+        }
+    }
+
+    // an increffed string holding the utf8 in 'data'
+    StringType::layout* get(const uint8_t* data, size_t length) {
+        if (!m_intern) {
+            return StringType::createFromUtf8Bytes(data, length);
+        }
+
+        std::string key((const char*)data, length);
+
+        auto it = m_strings.find(key);
+
+        if (it == m_strings.end()) {
+            StringType::layout* interned = StringType::intern(StringType::createFromUtf8Bytes(data, length));
+
+            it = m_strings.insert(std::make_pair(key, interned)).first;
+
+            if (m_strings.size() >= MAX_INTERNED_PER_CHUNK) {
+                m_intern = false;
+            }
+        }
+
+        StringType::layout* res;
+        StringType::Make()->copy_constructor((instance_ptr)&res, (instance_ptr)&it->second);
+        return res;
+    }
+
+private:
+    bool m_intern;
+
+    // we hold a reference to each of these
+    std::unordered_map<std::string, StringType::layout*> m_strings;
+};
+
+bool fieldEquals(const uint8_t* field, size_t length, const char* text) {
+    return length == strlen(text) && memcmp(field, text, length) == 0;
+}
+
+// construct a 't' at 'out' from the text of one cell
+void parseCell(Type* t, const uint8_t* field, size_t length, instance_ptr out, StringCache& strings) {
+    if (Type* valueType = nullableValueType(t)) {
+        OneOfType* oneOf = (OneOfType*)t;
+        size_t valueIx = oneOf->getTypes()[0] == valueType ? 0 : 1;
+
+        if (!length) {
+            oneOf->setWhichIndex(out, 1 - valueIx);
+            return;
+        }
+
+        parseCell(valueType, field, length, oneOf->eltPtr(out), strings);
+        oneOf->setWhichIndex(out, valueIx);
+        return;
+    }
+
+    TypeCategory cat = t->getTypeCategory();
+
+    if (cat == TypeCategory::catString) {
+        *(StringType::layout**)out = strings.get(field, length);
+        return;
+    }
+
+    if (cat == TypeCategory::catBool) {
+        if (fieldEquals(field, length, "true") || fieldEquals(field, length, "True")
+                || fieldEquals(field, length, "TRUE") || fieldEquals(field, length, "1")) {
+            *(bool*)out = true;
+            return;
+        }
+        if (fieldEquals(field, length, "false") || fieldEquals(field, length, "False")
+                || fieldEquals(field, length, "FALSE") || fieldEquals(field, length, "0")) {
+            *(bool*)out = false;
+            return;
+        }
+        throw std::runtime_error("can't parse '" + std::string((const char*)field, length) + "' as a bool");
+    }
+
+    if (cat == TypeCategory::catFloat32 || cat == TypeCategory::catFloat64) {
+        double value;
+
+        if (!NumberParsing::parseFloat(field, length, value)) {
+            throw std::runtime_error("can't parse '" + std::string((const char*)field, length) + "' as a float");
+        }
+
+        if (cat == TypeCategory::catFloat32) {
+            *(float*)out = value;
+        } else {
+            *(double*)out = value;
+        }
+        return;
+    }
+
+    int64_t value;
+
+    if (!NumberParsing::parseInt(field, length, value)) {
+        throw std::runtime_error("can't parse '" + std::string((const char*)field, length) + "' as an int");
+    }
+
+    auto checkRange = [&](int64_t lo, int64_t hi) {
+        if (value < lo || value > hi) {
+            throw std::runtime_error(std::string((const char*)field, length) + " is out of range for " + t->name());
+        }
+    };
+
+    switch (cat) {
+        case TypeCategory::catInt8: checkRange(INT8_MIN, INT8_MAX); *(int8_t*)out = value; return;
+        case TypeCategory::catInt16: checkRange(INT16_MIN, INT16_MAX); *(int16_t*)out = value; return;
+        case TypeCategory::catInt32: checkRange(INT32_MIN, INT32_MAX); *(int32_t*)out = value; return;
+        case TypeCategory::catUInt8: checkRange(0, UINT8_MAX); *(uint8_t*)out = value; return;
+        case TypeCategory::catUInt16: checkRange(0, UINT16_MAX); *(uint16_t*)out = value; return;
+        case TypeCategory::catUInt32: checkRange(0, UINT32_MAX); *(uint32_t*)out = value; return;
+        case TypeCategory::catUInt64: *(uint64_t*)out = value; return;
+        default: *(int64_t*)out = value; return;
+    }
+}
+
+// parses the records of one chunk into a ColumnBuffer per field
+class ChunkParser {
+public:
+    ChunkParser(NamedTuple* rowType, const std::vector<int>& fieldOfColumn, const Options& options) :
+        m_rowType(rowType),
+        m_fieldOfColumn(fieldOfColumn),
+        m_options(options)
+    {
+        for (Type* fieldType: rowType->getTypes()) {
+            m_columns.push_back(std::unique_ptr<ColumnBuffer>(new ColumnBuffer(fieldType)));
+            m_strings.push_back(std::unique_ptr<StringCache>(new StringCache(options.internStrings)));
+        }
+    }
+
+    void parse(const uint8_t* data, size_t begin, size_t end) {
+        Tokenizer tokenizer(data + begin, data + end, m_options.delimiter);
+
+        while (tokenizer.startRecord()) {
+            const uint8_t* recordStart = tokenizer.position();
+            size_t column = 0;
+
+            try {
+                while (true) {
+                    const uint8_t* field;
+                    size_t length;
+
+                    bool last = tokenizer.nextField(field, length);
+
+                    if (column >= m_fieldOfColumn.size()) {
+                        throw std::runtime_error("the record has more than " + std::to_string(m_fieldOfColumn.size()) + " fields");
+                    }
+
+                    int k = m_fieldOfColumn[column];
+
+                    if (k >= 0) {
+                        ColumnBuffer& buffer = *m_columns[k];
+
+                        try {
+                            parseCell(m_rowType->getTypes()[k], field, length, buffer.next(), *m_strings[k]);
+                        } catch(std::runtime_error& e) {
+                            throw std::runtime_error(std::string(e.what()) + " in column '" + m_rowType->getNames()[k] + "'");
+                        }
+
+                        buffer.commit();
+                    }
+
+                    column++;
+
+                    if (last) {
+                        break;
+                    }
+                }
+
+                if (column < m_fieldOfColumn.size()) {
+                    throw std::runtime_error(
+                        "the record has " + std::to_string(column) + " fields, not "
+                        + std::to_string(m_fieldOfColumn.size())
+                    );
+                }
+            } catch(std::runtime_error& e) {
+                throw std::runtime_error(
+                    "Invalid csv in the record at byte " + std::to_string(recordStart - data) + ": " + e.what()
+                );
+            }
+        }
+    }
+
+    ColumnBuffer& column(size_t k) {
+        return *m_columns[k];
+    }
+
+private:
+    NamedTuple* m_rowType;
+    const std::vector<int>& m_fieldOfColumn;
+    const Options& m_options;
+
+    std::vector<std::unique_ptr<ColumnBuffer>> m_columns;
+    std::vector<std::unique_ptr<StringCache>> m_strings;
+};
+
+// run 'f(t)' for each t in [0, threadCount), on threads of its own if there's more than one
+template<class func_type>
+void runInParallel(int64_t threadCount, const func_type& f) {
+    if (threadCount == 1) {
+        f(0);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::vector<std::thread> threads;
+
+    for (int64_t t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread([&, t]() {
+            try {
+                f(t);
+            } catch(...) {
+                errors[t] = std::current_exception();
+            }
+        }));
+    }
+
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (auto& error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// the first record boundary at or after 'pos', given whether an odd number of
+// quotes precede 'pos'.
+size_t nextRecordStart(const uint8_t* data, size_t pos, size_t end, bool inQuotes) {
+    for (; pos < end; pos++) {
+        if (data[pos] == '"') {
+            inQuotes = !inQuotes;
+        } else if (data[pos] == '\n' && !inQuotes) {
+            return pos + 1;
+        }
+    }
+
+    return end;
+}
+
+// map the columns of the header record to fields of 'rowType', returning
+// where the records after it start.
+size_t readHeader(
+    NamedTuple* rowType,
+    const uint8_t* data,
+    size_t bytecount,
+    const Options& options,
+    std::vector<int>& fieldOfColumn
+) {
+    Tokenizer tokenizer(data, data + bytecount, options.delimiter);
+
+    std::vector<bool> found(rowType->getTypes().size());
+
+    if (tokenizer.startRecord()) {
+        while (true) {
+            const uint8_t* field;
+            size_t length;
+
+            bool last = tokenizer.nextField(field, length);
+
+            auto it = rowType->getNameToIndex().find(std::string((const char*)field, length));
+
+            if (it == rowType->getNameToIndex().end()) {
+                fieldOfColumn.push_back(-1);
+            } else {
+                if (found[it->second]) {
+                    throw std::runtime_error("Invalid csv: the header has column '" + it->first + "' twice");
+                }
+                found[it->second] = true;
+                fieldOfColumn.push_back(it->second);
+            }
+
+            if (last) {
+                break;
+            }
+        }
+    }
+
+    for (long k = 0; k < found.size(); k++) {
+        if (!found[k]) {
+            throw std::runtime_error("Invalid csv: the header has no column '" + rowType->getNames()[k] + "'");
+        }
+    }
+
+    return tokenizer.position() - data;
+}
+
+} // end anonymous namespace
+
+void readColumns(
+    Type* rowType,
+    const uint8_t* data,
+    size_t bytecount,
+    const Options& options,
+    std::vector<Instance>& outColumns
+) {
+    if (!rowType->isNamedTuple()) {
+        throw std::runtime_error("readCsv needs a NamedTuple row type, not " + rowType->name());
+    }
+
+    NamedTuple* tupT = (NamedTuple*)rowType;
+
+    for (long k = 0; k < tupT->getTypes().size(); k++) {
+        Type* t = tupT->getTypes()[k];
+        Type* valueType = nullableValueType(t);
+
+        if (!isCellType(valueType ? valueType : t)) {
+            throw std::runtime_error(
+                "Can't read csv column '" + tupT->getNames()[k] + "' as " + t->name()
+            );
+        }
+    }
+
+    // skip a UTF-8 byte order mark
+    size_t bodyStart = 0;
+
+    if (bytecount >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        bodyStart = 3;
+    }
+
+    std::vector<int> fieldOfColumn;
+
+    if (options.header) {
+        bodyStart += readHeader(tupT, data + bodyStart, bytecount - bodyStart, options, fieldOfColumn);
+    } else {
+        for (long k = 0; k < tupT->getTypes().size(); k++) {
+            fieldOfColumn.push_back(k);
+        }
+    }
+
+    size_t bodySize = bytecount - bodyStart;
+
+    // give each thread at least a megabyte. Parsing shares interned strings
+    // between threads, which needs atomic refcounts.
+    int64_t threadCount = std::max<int64_t>(1, std::min<int64_t>(options.threadCount, bodySize >> 20));
+
+    if (refcounts_are_thread_confined) {
+        threadCount = 1;
+    }
+
+    std::vector<size_t> nominalStart(threadCount + 1);
+    for (int64_t t = 0; t <= threadCount; t++) {
+        nominalStart[t] = bodyStart + bodySize * t / threadCount;
+    }
+
+    // whether an odd number of quotes precede each nominal start
+    std::vector<size_t> quoteCounts(threadCount);
+
+    runInParallel(threadCount, [&](int64_t t) {
+        size_t count = 0;
+
+        for (size_t pos = nominalStart[t]; pos < nominalStart[t + 1]; pos++) {
+            count += data[pos] == '"';
+        }
+
+        quoteCounts[t] = count;
+    });
+
+    std::vector<bool> startsInQuotes(threadCount + 1);
+    for (int64_t t = 0; t < threadCount; t++) {
+        startsInQuotes[t + 1] = startsInQuotes[t] ^ (quoteCounts[t] & 1);
+    }
+
+    std::vector<size_t> chunkStart(threadCount + 1);
+    chunkStart[0] = bodyStart;
+    chunkStart[threadCount] = bytecount;
+
+    for (int64_t t = 1; t < threadCount; t++) {
+        chunkStart[t] = std::max(
+            chunkStart[t - 1],
+            nextRecordStart(data, nominalStart[t], bytecount, startsInQuotes[t])
+        );
+    }
+
+    std::vector<std::unique_ptr<ChunkParser>> parsers;
+    for (int64_t t = 0; t < threadCount; t++) {
+        parsers.push_back(std::unique_ptr<ChunkParser>(new ChunkParser(tupT, fieldOfColumn, options)));
+    }
+
+    runInParallel(threadCount, [&](int64_t t) {
+        parsers[t]->parse(data, chunkStart[t], chunkStart[t + 1]);
+    });
+
+    for (long k = 0; k < tupT->getTypes().size(); k++) {
+        ListOfType* listT = ListOfType::Make(tupT->getTypes()[k]);
+        size_t bytesPer = tupT->getTypes()[k]->bytecount();
+
+        size_t total = 0;
+        for (auto& parser: parsers) {
+            total += parser->column(k).count();
+        }
+
+        outColumns.push_back(Instance(listT, [&](instance_ptr list) {
+            listT->constructor(list);
+
+            if (!total) {
+                return;
+            }
+
+            listT->reserve(list, total);
+
+            size_t offset = 0;
+            for (auto& parser: parsers) {
+                size_t count = parser->column(k).count();
+                parser->column(k).moveTo(listT->eltPtr(list, 0) + offset * bytesPer);
+                offset += count;
+            }
+
+            listT->setSizeUnsafe(list, total);
+        }));
+    }
+}
+
+} // end namespace CsvReader
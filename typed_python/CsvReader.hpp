@@ -0,0 +1,86 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include "Instance.hpp"
+#include <vector>
+
+/*********
+Parsing RFC 4180 csv straight into one typed column per field of a
+NamedTuple row type.
+
+Fields may be quoted, with "" standing for a quote, and quoted fields may
+hold delimiters and newlines. Records end in \n or \r\n; blank lines are
+skipped. Cells convert to their field's type:
+
+    ints, floats    the same syntax int() and float() accept
+    bool            true/false, True/False, TRUE/FALSE or 1/0
+    str             the cell's UTF-8
+    OneOf(None, T)  None for an empty cell, otherwise T
+
+We split the input into one chunk per thread, so each thread parses its
+chunk into column buffers of its own, and then concatenate the buffers.
+A chunk has to start on a record boundary, which we can't find by looking
+for a newline, because quoted fields may hold them. So a first parallel
+pass counts the quotes in each chunk: a newline is a boundary exactly
+when an even number of quotes precede it in the file.
+
+String columns go through a small per-thread cache in front of the
+process-wide intern table (see StringType::intern), so repeated values
+share a layout. A column stops interning in a chunk once it has seen
+MAX_INTERNED_PER_CHUNK distinct values, so that id-like columns don't
+fill the table.
+*********/
+
+namespace CsvReader {
+
+class Options {
+public:
+    Options() :
+        delimiter(','),
+        header(true),
+        internStrings(true),
+        threadCount(1)
+    {
+    }
+
+    uint8_t delimiter;
+
+    // if true, the first record names the columns, which we match to the
+    // fields of the row type by name, skipping columns we don't have a field
+    // for. Otherwise the columns are the fields, in order.
+    bool header;
+
+    bool internStrings;
+
+    int64_t threadCount;
+};
+
+const size_t MAX_INTERNED_PER_CHUNK = 4096;
+
+// parse the csv in 'data' into a ListOf per field of 'rowType', which must
+// be a NamedTuple, appending them to 'outColumns' in field order.
+void readColumns(
+    Type* rowType,
+    const uint8_t* data,
+    size_t bytecount,
+    const Options& options,
+    std::vector<Instance>& outColumns
+);
+
+} // end namespace CsvReader
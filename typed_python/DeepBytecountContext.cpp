@@ -0,0 +1,99 @@
+/******************************************************************************
+   Copyright 2017-2020 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "DeepBytecountContext.hpp"
+
+bool DeepBytecountContext::shouldUseCache(Type* t) {
+    // while computing an entry we fold exclusively-held layouts into it
+    // rather than giving them entries of their own.
+    return cache && !deferredLayouts && cache->isCacheable(t);
+}
+
+size_t DeepBytecountContext::cachedBytecount(Type* t, void* layout, std::set<Slab*>* outSlabs) {
+    // entries never move once they're in the cache, so we can hold this
+    // while the walk below adds more of them.
+    DeepBytecountCache::Entry& entry = cache->entryFor(t, layout);
+
+    size_t res = entry.ownedBytes;
+
+    for (auto& typeAndLayout: entry.deferredLayouts) {
+        void* deferred = typeAndLayout.second;
+
+        res += typeAndLayout.first->deepBytecount((instance_ptr)&deferred, *this, outSlabs);
+    }
+
+    return res;
+}
+
+bool DeepBytecountCache::isCacheable(Type* t) {
+    auto it = mIsCacheable.find(t);
+
+    if (it != mIsCacheable.end()) {
+        return it->second;
+    }
+
+    bool res = (t->isTupleOf() || t->isConstDict()) && t->isDeeplyImmutable();
+
+    mIsCacheable[t] = res;
+
+    return res;
+}
+
+DeepBytecountCache::Entry& DeepBytecountCache::entryFor(Type* t, void* layout) {
+    auto it = mEntries.find(layout);
+
+    if (it != mEntries.end()) {
+        return it->second;
+    }
+
+    Entry entry;
+
+    DeepBytecountContext entryContext;
+    entryContext.cacheEntryRoot = layout;
+    entryContext.deferredLayouts = &entry.deferredLayouts;
+
+    entry.ownedBytes = t->deepBytecount((instance_ptr)&layout, entryContext, nullptr);
+
+    // hold a reference so that nobody can free the layout and reuse its address
+    entry.type = t;
+    t->copy_constructor((instance_ptr)&entry.layout, (instance_ptr)&layout);
+
+    return mEntries[layout] = entry;
+}
+
+void DeepBytecountCache::prune() {
+    for (auto it = mEntries.begin(); it != mEntries.end();) {
+        if (*(Refcount*)it->second.layout == 1) {
+            release(it->second);
+            it = mEntries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DeepBytecountCache::clear() {
+    for (auto& layoutAndEntry: mEntries) {
+        release(layoutAndEntry.second);
+    }
+
+    mEntries.clear();
+}
+
+void DeepBytecountCache::release(Entry& entry) {
+    entry.type->destroy((instance_ptr)&entry.layout);
+}
@@ -0,0 +1,145 @@
+/******************************************************************************
+   Copyright 2017-2020 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <set>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include "PointerSet.hpp"
+#include "Slab.hpp"
+#include "Refcount.hpp"
+
+class Type;
+class DeepBytecountCache;
+
+// state for a single call to Type::deepBytecount.
+class DeepBytecountContext {
+public:
+    DeepBytecountContext(DeepBytecountCache* inCache = nullptr) :
+        cache(inCache),
+        cacheEntryRoot(nullptr),
+        deferredLayouts(nullptr),
+        refcountsToFreeze(nullptr)
+    {
+    }
+
+    // called by each refcounted layout the first time we walk it.
+    void noteRefcount(Refcount& refcount) {
+        if (refcountsToFreeze) {
+            refcountsToFreeze->push_back(&refcount);
+        }
+    }
+
+    // called by refcounted immutable layouts before they count themselves. If we're
+    // computing a cache entry, the entry only includes the layouts that the entry's
+    // root holds exclusively. Layouts that something else can reach, or that live in a
+    // slab, get recorded in the entry and counted by the outer walk instead, so that
+    // they're still counted only once. Returns true if we deferred 'layout'.
+    bool deferLayout(Type* t, void* layout, int64_t refcount) {
+        if (!deferredLayouts || layout == cacheEntryRoot) {
+            return false;
+        }
+
+        if (refcount == 1 && !Slab::slabForAlloc(layout)) {
+            return false;
+        }
+
+        deferredLayouts->push_back(std::make_pair(t, layout));
+        return true;
+    }
+
+    // should we count the layout 'layout' of type 't' through the cache?
+    bool shouldUseCache(Type* t);
+
+    // count a layout that passed 'shouldUseCache', computing its cache entry if needed.
+    size_t cachedBytecount(Type* t, void* layout, std::set<Slab*>* outSlabs);
+
+    PointerSet visited;
+
+    // if not null, the cache of immutable layout sizes we're allowed to use
+    DeepBytecountCache* cache;
+
+    // if we're computing a cache entry, the layout it's for and where to put
+    // the layouts we defer to the outer walk
+    void* cacheEntryRoot;
+    std::vector<std::pair<Type*, void*> >* deferredLayouts;
+
+    // if not null, we're walking the graph for 'freeze', and this collects the
+    // refcount of every layout we reach.
+    std::vector<Refcount*>* refcountsToFreeze;
+};
+
+// a process-wide cache of the deep bytecount of immutable layouts (TupleOf and ConstDict
+// instances holding only immutable data), for callers who measure the same large,
+// mostly-static structures over and over.
+//
+// Each entry holds a reference to its layout, so the pointer can't be reused while
+// the entry exists, and since the layout is immutable its size can't change. An entry
+// records the bytes the layout holds exclusively, plus the layouts inside it that were
+// shared or in a slab when we computed it, which we walk as usual every time. If a
+// layout that was exclusive to an entry becomes reachable from elsewhere afterwards,
+// we may count it twice. Entries that nobody else holds are dropped by 'prune'.
+//
+// Callers must hold 'mutex' for the duration of their walk.
+class DeepBytecountCache {
+public:
+    class Entry {
+    public:
+        Entry() : type(nullptr), layout(nullptr), ownedBytes(0)
+        {
+        }
+
+        Type* type;
+        void* layout;
+        size_t ownedBytes;
+        std::vector<std::pair<Type*, void*> > deferredLayouts;
+    };
+
+    static DeepBytecountCache& singleton() {
+        static DeepBytecountCache* cache = new DeepBytecountCache();
+        return *cache;
+    }
+
+    std::mutex& mutex() {
+        return mMutex;
+    }
+
+    bool isCacheable(Type* t);
+
+    // return the entry for 'layout', computing it if we don't have one
+    Entry& entryFor(Type* t, void* layout);
+
+    // release the entries whose layouts only we hold
+    void prune();
+
+    // release all entries
+    void clear();
+
+    size_t size() const {
+        return mEntries.size();
+    }
+
+private:
+    void release(Entry& entry);
+
+    std::mutex mMutex;
+
+    std::unordered_map<void*, Entry> mEntries;
+
+    std::unordered_map<Type*, bool> mIsCacheable;
+};
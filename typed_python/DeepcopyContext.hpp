@@ -1,11 +1,64 @@
 #pragma once
 
 #include <unordered_map>
+#include <mutex>
 #include "Slab.hpp"
 
+// the memo shared by all the threads of a parallel deepcopy. It's sharded by
+// source pointer so that threads copying unrelated data rarely contend.
+class ParallelDeepcopyMemo {
+public:
+    static const size_t SHARD_COUNT = 64;
+
+    template<class allocator_type>
+    std::pair<instance_ptr, bool> lookupOrAllocate(instance_ptr src, const allocator_type& allocate) {
+        Shard& shard = shardFor(src);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.memo.find(src);
+        if (it != shard.memo.end()) {
+            return std::make_pair(it->second, false);
+        }
+
+        instance_ptr res = allocate();
+        shard.memo[src] = res;
+
+        return std::make_pair(res, true);
+    }
+
+    void insert(instance_ptr src, instance_ptr dest) {
+        shardFor(src).memo[src] = dest;
+    }
+
+    // copy everything in the memo into 'out'. Only valid once the threads are done.
+    void mergeInto(std::unordered_map<instance_ptr, instance_ptr>& out) {
+        for (auto& shard: mShards) {
+            out.insert(shard.memo.begin(), shard.memo.end());
+        }
+    }
+
+private:
+    class Shard {
+    public:
+        std::mutex mutex;
+        std::unordered_map<instance_ptr, instance_ptr> memo;
+    };
+
+    Shard& shardFor(instance_ptr src) {
+        return mShards[(((size_t)src) >> 4) % SHARD_COUNT];
+    }
+
+    Shard mShards[SHARD_COUNT];
+};
+
 class DeepcopyContext {
 public:
-    DeepcopyContext(Slab* inSlab) : slab(inSlab) {
+    DeepcopyContext(Slab* inSlab) :
+        slab(inSlab),
+        threadCount(1),
+        sharedMemo(nullptr)
+    {
     }
 
     void memoize(PyObject* source, PyObject* dest) {
@@ -14,6 +67,27 @@ public:
         alreadyAllocated[(instance_ptr)source] = (instance_ptr)dest;
     }
 
+    // return the copy of the layout at 'src' if we've made one. Otherwise, call 'allocate'
+    // to make it and memoize it. Returns the copy and whether it's new, in which case the
+    // caller must fill it in. In a parallel copy, other threads can see the new layout as
+    // soon as it's memoized, so 'allocate' must initialize its refcount.
+    template<class allocator_type>
+    std::pair<instance_ptr, bool> lookupOrAllocate(instance_ptr src, const allocator_type& allocate) {
+        if (sharedMemo) {
+            return sharedMemo->lookupOrAllocate(src, allocate);
+        }
+
+        auto it = alreadyAllocated.find(src);
+        if (it != alreadyAllocated.end()) {
+            return std::make_pair(it->second, false);
+        }
+
+        instance_ptr res = allocate();
+        alreadyAllocated[src] = res;
+
+        return std::make_pair(res, true);
+    }
+
     std::unordered_map<instance_ptr, instance_ptr> alreadyAllocated;
 
     std::vector<PyObjectHolder> pyObjectsToKeepAlive;
@@ -23,4 +97,12 @@ public:
     std::unordered_map<Type*, PyObject*> tpTypeMap;
 
     std::unordered_map<PyObject*, PyObject*> pyTypeMap;
+
+    // how many threads a large ListOf or TupleOf may use to copy its elements.
+    // Only non-free-store slabs support this.
+    int threadCount;
+
+    // if we're one of the threads of a parallel copy, the memo we share with the others.
+    // In that case 'alreadyAllocated' is unused.
+    ParallelDeepcopyMemo* sharedMemo;
 };
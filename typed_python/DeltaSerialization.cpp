@@ -0,0 +1,409 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "DeltaSerialization.hpp"
+
+namespace DeltaSerialization {
+
+namespace {
+
+typedef Type::TypeCategory TypeCategory;
+
+enum Node {
+    SAME = 0,
+    FULL = 1,
+    PARTS = 2,
+    ONEOF = 3,
+    LIST = 4,
+    DICT = 5
+};
+
+// do 'left' and 'right' hold the same value, as far as we can tell without walking them?
+bool unchanged(Type* t, instance_ptr left, instance_ptr right) {
+    if (left == right) {
+        return true;
+    }
+
+    if (t->isPOD()) {
+        return memcmp(left, right, t->bytecount()) == 0;
+    }
+
+    switch (t->getTypeCategory()) {
+        case TypeCategory::catString:
+        case TypeCategory::catBytes:
+            return *(void**)left == *(void**)right || t->cmp(left, right, Py_EQ, false);
+        case TypeCategory::catTupleOf:
+        case TypeCategory::catConstDict:
+            return *(void**)left == *(void**)right;
+        case TypeCategory::catTuple:
+        case TypeCategory::catNamedTuple: {
+            CompositeType* tupT = (CompositeType*)t;
+
+            for (long k = 0; k < tupT->getTypes().size(); k++) {
+                if (!unchanged(tupT->getTypes()[k], tupT->eltPtr(left, k), tupT->eltPtr(right, k))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TypeCategory::catOneOf: {
+            OneOfType* oneOfT = (OneOfType*)t;
+            size_t which = oneOfT->whichIndex(left);
+
+            return which == oneOfT->whichIndex(right)
+                && unchanged(oneOfT->getTypes()[which], oneOfT->eltPtr(left), oneOfT->eltPtr(right));
+        }
+        default:
+            return false;
+    }
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("Corrupt delta, or applied to the wrong previous value");
+}
+
+class Writer {
+public:
+    explicit Writer(SerializationBuffer& buffer) : m_buffer(buffer) {
+    }
+
+    // 'previous' is nullptr if there's nothing to compare against
+    void write(Type* t, instance_ptr previous, instance_ptr current) {
+        if (previous && unchanged(t, previous, current)) {
+            m_buffer.writeUnsignedVarint(SAME);
+            return;
+        }
+
+        if (previous) {
+            switch (t->getTypeCategory()) {
+                case TypeCategory::catTuple:
+                case TypeCategory::catNamedTuple: {
+                    CompositeType* tupT = (CompositeType*)t;
+
+                    m_buffer.writeUnsignedVarint(PARTS);
+
+                    for (long k = 0; k < tupT->getTypes().size(); k++) {
+                        write(tupT->getTypes()[k], tupT->eltPtr(previous, k), tupT->eltPtr(current, k));
+                    }
+                    return;
+                }
+                case TypeCategory::catOneOf: {
+                    OneOfType* oneOfT = (OneOfType*)t;
+                    size_t which = oneOfT->whichIndex(current);
+
+                    if (which == oneOfT->whichIndex(previous)) {
+                        m_buffer.writeUnsignedVarint(ONEOF);
+                        write(oneOfT->getTypes()[which], oneOfT->eltPtr(previous), oneOfT->eltPtr(current));
+                        return;
+                    }
+                    break;
+                }
+                case TypeCategory::catListOf:
+                case TypeCategory::catTupleOf:
+                    writeList((TupleOrListOfType*)t, previous, current);
+                    return;
+                case TypeCategory::catConstDict:
+                    writeDict((ConstDictType*)t, previous, current);
+                    return;
+                default:
+                    break;
+            }
+        }
+
+        m_buffer.writeUnsignedVarint(FULL);
+        t->serialize(current, m_buffer, 0);
+    }
+
+private:
+    void writeList(TupleOrListOfType* t, instance_ptr previous, instance_ptr current) {
+        Type* eltT = t->getEltType();
+
+        int64_t oldCount = t->count(previous);
+        int64_t newCount = t->count(current);
+
+        auto isUnchanged = [&](int64_t i) {
+            return i < oldCount && unchanged(eltT, t->eltPtr(previous, i), t->eltPtr(current, i));
+        };
+
+        m_buffer.writeUnsignedVarint(LIST);
+        m_buffer.writeUnsignedVarint(newCount);
+
+        int64_t i = 0;
+
+        while (i < newCount) {
+            int64_t same = 0;
+            while (i + same < newCount && isUnchanged(i + same)) {
+                same++;
+            }
+
+            int64_t changed = 0;
+            while (i + same + changed < newCount && !isUnchanged(i + same + changed)) {
+                changed++;
+            }
+
+            m_buffer.writeUnsignedVarint(same);
+            m_buffer.writeUnsignedVarint(changed);
+
+            for (int64_t j = i + same; j < i + same + changed; j++) {
+                write(eltT, j < oldCount ? t->eltPtr(previous, j) : nullptr, t->eltPtr(current, j));
+            }
+
+            i += same + changed;
+        }
+    }
+
+    void writeDict(ConstDictType* t, instance_ptr previous, instance_ptr current) {
+        Type* keyT = t->keyType();
+        Type* valueT = t->valueType();
+
+        int64_t oldCount = t->count(previous);
+        int64_t newCount = t->count(current);
+
+        // is the item at 'i' the item at 'prevIx' in 'previous', unchanged?
+        auto isUnchanged = [&](int64_t i, int64_t prevIx) {
+            return prevIx >= 0 && prevIx < oldCount
+                && keyT->cmp(t->kvPairPtrKey(previous, prevIx), t->kvPairPtrKey(current, i), Py_EQ, false)
+                && unchanged(valueT, t->kvPairPtrValue(previous, prevIx), t->kvPairPtrValue(current, i));
+        };
+
+        m_buffer.writeUnsignedVarint(DICT);
+        m_buffer.writeUnsignedVarint(newCount);
+
+        int64_t i = 0;
+
+        while (i < newCount) {
+            // unchanged items that are also consecutive in 'previous'
+            int64_t prevStart = t->lookupIndexByKey(previous, t->kvPairPtrKey(current, i));
+            int64_t same = 0;
+
+            while (i + same < newCount && isUnchanged(i + same, prevStart + same)) {
+                same++;
+            }
+
+            // and then changed or new items, with their index in 'previous', or -1
+            std::vector<int64_t> changedPrevIx;
+
+            while (i + same + (int64_t)changedPrevIx.size() < newCount) {
+                int64_t j = i + same + changedPrevIx.size();
+                int64_t prevIx = t->lookupIndexByKey(previous, t->kvPairPtrKey(current, j));
+
+                if (isUnchanged(j, prevIx)) {
+                    break;
+                }
+
+                changedPrevIx.push_back(prevIx);
+            }
+
+            m_buffer.writeUnsignedVarint(same);
+            if (same) {
+                m_buffer.writeUnsignedVarint(prevStart);
+            }
+            m_buffer.writeUnsignedVarint(changedPrevIx.size());
+
+            for (long k = 0; k < changedPrevIx.size(); k++) {
+                int64_t j = i + same + k;
+                int64_t prevIx = changedPrevIx[k];
+
+                keyT->serialize(t->kvPairPtrKey(current, j), m_buffer, 0);
+                m_buffer.writeUnsignedVarint(prevIx + 1);
+                write(valueT, prevIx >= 0 ? t->kvPairPtrValue(previous, prevIx) : nullptr, t->kvPairPtrValue(current, j));
+            }
+
+            i += same + changedPrevIx.size();
+        }
+    }
+
+    SerializationBuffer& m_buffer;
+};
+
+class Reader {
+public:
+    explicit Reader(DeserializationBuffer& buffer) : m_buffer(buffer) {
+    }
+
+    void read(Type* t, instance_ptr previous, instance_ptr out) {
+        size_t node = m_buffer.readUnsignedVarint();
+
+        if (node == FULL) {
+            auto fieldAndWireType = m_buffer.readFieldNumberAndWireType();
+            t->deserialize(out, m_buffer, fieldAndWireType.second);
+            return;
+        }
+
+        if (!previous) {
+            corrupt();
+        }
+
+        TypeCategory cat = t->getTypeCategory();
+
+        if (node == SAME) {
+            t->copy_constructor(out, previous);
+            return;
+        }
+
+        if (node == PARTS && (cat == TypeCategory::catTuple || cat == TypeCategory::catNamedTuple)) {
+            CompositeType* tupT = (CompositeType*)t;
+
+            tupT->constructor(out, [&](instance_ptr field, int64_t k) {
+                read(tupT->getTypes()[k], tupT->eltPtr(previous, k), field);
+            });
+            return;
+        }
+
+        if (node == ONEOF && cat == TypeCategory::catOneOf) {
+            OneOfType* oneOfT = (OneOfType*)t;
+            size_t which = oneOfT->whichIndex(previous);
+
+            read(oneOfT->getTypes()[which], oneOfT->eltPtr(previous), oneOfT->eltPtr(out));
+            oneOfT->setWhichIndex(out, which);
+            return;
+        }
+
+        if (node == LIST && (cat == TypeCategory::catListOf || cat == TypeCategory::catTupleOf)) {
+            readList((TupleOrListOfType*)t, previous, out);
+            return;
+        }
+
+        if (node == DICT && cat == TypeCategory::catConstDict) {
+            readDict((ConstDictType*)t, previous, out);
+            return;
+        }
+
+        corrupt();
+    }
+
+private:
+    void readList(TupleOrListOfType* t, instance_ptr previous, instance_ptr out) {
+        Type* eltT = t->getEltType();
+
+        int64_t oldCount = t->count(previous);
+        int64_t newCount = m_buffer.readUnsignedVarint();
+
+        int64_t same = 0;
+        int64_t changed = 0;
+
+        t->constructor(out, newCount, [&](instance_ptr elt, int64_t k) {
+            if (!same && !changed) {
+                same = m_buffer.readUnsignedVarint();
+                changed = m_buffer.readUnsignedVarint();
+
+                if (!same && !changed) {
+                    corrupt();
+                }
+            }
+
+            if (same) {
+                if (k >= oldCount) {
+                    corrupt();
+                }
+
+                eltT->copy_constructor(elt, t->eltPtr(previous, k));
+                same--;
+            } else {
+                read(eltT, k < oldCount ? t->eltPtr(previous, k) : nullptr, elt);
+                changed--;
+            }
+        });
+
+        if (same || changed) {
+            t->destroy(out);
+            corrupt();
+        }
+    }
+
+    void readDict(ConstDictType* t, instance_ptr previous, instance_ptr out) {
+        Type* keyT = t->keyType();
+        Type* valueT = t->valueType();
+
+        int64_t oldCount = t->count(previous);
+        int64_t newCount = m_buffer.readUnsignedVarint();
+
+        int64_t same = 0;
+        int64_t prevIx = 0;
+        int64_t changed = 0;
+
+        t->constructor(out, newCount, [&](instance_ptr key, instance_ptr value) {
+            if (!same && !changed) {
+                same = m_buffer.readUnsignedVarint();
+                if (same) {
+                    prevIx = m_buffer.readUnsignedVarint();
+                }
+                changed = m_buffer.readUnsignedVarint();
+
+                if (!same && !changed) {
+                    corrupt();
+                }
+            }
+
+            if (same) {
+                if (prevIx >= oldCount) {
+                    corrupt();
+                }
+
+                keyT->copy_constructor(key, t->kvPairPtrKey(previous, prevIx));
+
+                try {
+                    valueT->copy_constructor(value, t->kvPairPtrValue(previous, prevIx));
+                } catch(...) {
+                    keyT->destroy(key);
+                    throw;
+                }
+
+                prevIx++;
+                same--;
+                return;
+            }
+
+            auto fieldAndWireType = m_buffer.readFieldNumberAndWireType();
+            keyT->deserialize(key, m_buffer, fieldAndWireType.second);
+
+            try {
+                int64_t changedPrevIx = (int64_t)m_buffer.readUnsignedVarint() - 1;
+
+                if (changedPrevIx >= oldCount) {
+                    corrupt();
+                }
+
+                read(valueT, changedPrevIx >= 0 ? t->kvPairPtrValue(previous, changedPrevIx) : nullptr, value);
+            } catch(...) {
+                keyT->destroy(key);
+                throw;
+            }
+
+            changed--;
+        });
+
+        if (same || changed) {
+            t->destroy(out);
+            corrupt();
+        }
+    }
+
+    DeserializationBuffer& m_buffer;
+};
+
+} // end anonymous namespace
+
+void serialize(Type* t, instance_ptr previous, instance_ptr current, SerializationBuffer& buffer) {
+    Writer(buffer).write(t, previous, current);
+}
+
+void deserialize(Type* t, instance_ptr previous, DeserializationBuffer& buffer, instance_ptr out) {
+    Reader(buffer).read(t, previous, out);
+}
+
+} // end namespace DeltaSerialization
@@ -0,0 +1,64 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include "SerializationBuffer.hpp"
+#include "DeserializationBuffer.hpp"
+
+/*********
+Serialize a value as the difference from a previous value of the same type,
+for sending a series of snapshots where little changes from one to the next.
+
+We walk the two values together and write a node for each part of the
+current one:
+
+    SAME     it's unchanged, so the reader copies it from its previous value
+    FULL     the part, serialized as 'serialize' would
+    PARTS    a Tuple or NamedTuple: a node for each field
+    ONEOF    a OneOf holding the same type as before: a node for the value
+    LIST     a ListOf or TupleOf: the new length, then runs of elements,
+             each run some unchanged elements and then a node for each
+             changed (or new) one
+    DICT     a ConstDict: the new size, then runs of items, each run some
+             items that are unchanged (and consecutive in the previous
+             dict) and then the key, previous index and a value node for
+             each changed or new item. Removed keys are simply not there.
+
+Anything else that changed is written FULL. A part is unchanged if it's
+POD and its bytes are the same, if it's a str or bytes with the same
+contents, if it's a TupleOf or ConstDict with the same layout, or if it's
+a Tuple, NamedTuple or OneOf whose parts are all unchanged. Comparing
+layouts is what makes a delta cheap when most of a snapshot is shared
+with the one before it, but it trusts that nothing reachable from
+an immutable container was mutated in place. ListOf, Dict and Class
+instances are mutable, so we never assume that about them: ListOfs are
+compared element by element and the others are written in full.
+
+The reader has to apply the delta to exactly the previous value the writer
+compared against.
+*********/
+
+namespace DeltaSerialization {
+
+// write the difference between the 't's at 'previous' and 'current'
+void serialize(Type* t, instance_ptr previous, instance_ptr current, SerializationBuffer& buffer);
+
+// construct a 't' at 'out' from 'previous' and the difference 'serialize' wrote
+void deserialize(Type* t, instance_ptr previous, DeserializationBuffer& buffer, instance_ptr out);
+
+} // end namespace DeltaSerialization
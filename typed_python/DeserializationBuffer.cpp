@@ -2,91 +2,519 @@
 
 #include "lz4frame.h"
 
+#include <algorithm>
+#include <pthread.h>
+
+DeserializationBuffer::DeserializationBuffer(uint8_t* ptr, size_t sz, const SerializationContext& context) :
+        m_context(context),
+        m_read_ahead(context.isCompressionEnabled() && context.compressUsingThreads()),
+        m_pushed_arena(false),
+        m_streaming(false),
+        m_scan_offset(0),
+        m_scan_pos(0),
+        m_read_head(nullptr),
+        m_read_head_offset(0),
+        m_size(0),
+        m_compressed_blocks(ptr),
+        m_compressed_block_data_remaining(sz),
+        m_pos(0),
+        m_max_depth(0),
+        m_max_allocation_bytes(0),
+        m_depth(0),
+        m_allocated_bytes(0)
+{
+    if (context.deserializeIntoSlab()) {
+        // size the arena for what we'll probably deserialize. Slabs this large are
+        // mmapped, so the pages we don't use are never touched, and anything that
+        // doesn't fit goes to the free store anyway.
+        tp_push_arena(
+            std::max<size_t>(sz * (context.isCompressionEnabled() ? 4 : 1) + 64 * 1024, 256 * 1024)
+        );
+        m_pushed_arena = true;
+    }
+}
+
+DeserializationBuffer::DeserializationBuffer(const SerializationContext& context) :
+        m_context(context),
+        m_read_ahead(false),
+        m_pushed_arena(false),
+        m_streaming(true),
+        m_scan_offset(0),
+        m_scan_pos(0),
+        m_read_head(nullptr),
+        m_read_head_offset(0),
+        m_size(0),
+        m_compressed_blocks(nullptr),
+        m_compressed_block_data_remaining(0),
+        m_pos(0),
+        m_max_depth(0),
+        m_max_allocation_bytes(0),
+        m_depth(0),
+        m_allocated_bytes(0)
+{
+    // we don't know how much we'll read, so we don't push an arena even if
+    // the context asks to deserialize into a Slab.
+}
+
+/* static */
+void DeserializationBuffer::decompressFrame(const uint8_t* data, size_t bytecount, std::vector<uint8_t>& out) {
+    LZ4F_decompressionContext_t compressionContext;
+
+    if (LZ4F_createDecompressionContext(&compressionContext, LZ4F_VERSION)) {
+        throw std::runtime_error("Failed to allocate an lz4 compression context.");
+    }
+
+    size_t bytesDecompressed = 0;
+
+    // LZ4F_decompress returns 0 once it has read the end of the frame and
+    // checked its content checksum. Until then, it's a hint of how much more
+    // input it wants.
+    size_t res = 1;
+
+    // whether the last call filled the space we gave it, in which case it
+    // may be holding more output even if it has consumed all the input.
+    bool filledOutput = false;
+
+    while (bytesDecompressed < bytecount || (res != 0 && filledOutput)) {
+        if (res == 0) {
+            LZ4F_freeDecompressionContext(compressionContext);
+
+            throw std::runtime_error("Corrupt data: compressed block continues past the end of its lz4 frame");
+        }
+
+        // inflate directly onto the end of 'out', a megabyte at a time
+        size_t existing = out.size();
+        out.resize(existing + 1024 * 1024);
+
+        size_t bytesWritten = 1024 * 1024;
+        size_t bytesRead = bytecount - bytesDecompressed;
+
+        res = LZ4F_decompress(
+            compressionContext,
+            &out[existing],
+            &bytesWritten,
+            data + bytesDecompressed,
+            &bytesRead,
+            nullptr
+        );
+
+        out.resize(existing + bytesWritten);
+        filledOutput = bytesWritten == 1024 * 1024;
+
+        if (LZ4F_isError(res)) {
+            LZ4F_freeDecompressionContext(compressionContext);
+
+            throw std::runtime_error(
+              std::string("Error decompressing data using LZ4: ")
+                + LZ4F_getErrorName(res)
+            );
+        }
+
+        bytesDecompressed += bytesRead;
+    }
+
+    LZ4F_freeDecompressionContext(compressionContext);
+
+    // without this, a block cut short would lose its last checksums
+    // without anyone noticing.
+    if (res != 0) {
+        throw std::runtime_error("Corrupt data: compressed block ends partway through its lz4 frame");
+    }
+}
+
+void DecompressionTask::decompress() {
+    try {
+        DeserializationBuffer::decompressFrame(m_data, m_size, m_output);
+    } catch(std::exception& e) {
+        m_error = e.what();
+    }
+}
+
+bool DeserializationBuffer::nextCompressedBlock(const uint8_t*& data, size_t& bytecount) {
+    if (m_compressed_block_data_remaining < sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t bytesToDecompress;
+    memcpy(&bytesToDecompress, m_compressed_blocks, sizeof(uint32_t));
+
+    if (bytesToDecompress + sizeof(uint32_t) > m_compressed_block_data_remaining) {
+        throw std::runtime_error("Corrupt data: can't decompress this large of a block");
+    }
+
+    data = m_compressed_blocks + sizeof(uint32_t);
+    bytecount = bytesToDecompress;
+
+    m_compressed_blocks += sizeof(uint32_t) + bytesToDecompress;
+    m_compressed_block_data_remaining -= sizeof(uint32_t) + bytesToDecompress;
+
+    return true;
+}
+
+void DeserializationBuffer::compactDecompressedBuffer() {
+    if (m_read_head_offset) {
+        m_decompressed_buffer.erase(
+            m_decompressed_buffer.begin(),
+            m_decompressed_buffer.begin() + m_read_head_offset
+        );
+
+        m_read_head_offset = 0;
+    }
+}
+
+void DeserializationBuffer::appendDecompressed(std::vector<uint8_t>& bytes) {
+    compactDecompressedBuffer();
+
+    if (m_decompressed_buffer.empty()) {
+        m_decompressed_buffer.swap(bytes);
+    } else {
+        m_decompressed_buffer.insert(m_decompressed_buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    m_size = m_decompressed_buffer.size();
+    m_read_head = m_decompressed_buffer.data();
+}
+
 bool DeserializationBuffer::decompress() {
+    if (m_streaming) {
+        // everything we've been fed is already in the buffer
+        return false;
+    }
+
     if (!m_context.isCompressionEnabled()) {
         if (m_compressed_block_data_remaining == 0) {
             return false;
         }
 
-        //it's all one big uncompressed block
-        m_decompressed_buffer.resize(m_compressed_block_data_remaining);
-
-        memcpy(&m_decompressed_buffer[0], m_compressed_blocks, m_compressed_block_data_remaining);
-
+        //it's all one big uncompressed block, so read it where it is
         m_size += m_compressed_block_data_remaining;
-        m_read_head = &m_decompressed_buffer[0];
+        m_read_head = m_compressed_blocks;
         m_compressed_block_data_remaining = 0;
         m_read_head_offset = 0;
 
         return true;
-    } else {
-        PyEnsureGilReleased releaseTheGil;
+    }
 
-        if (m_compressed_block_data_remaining < sizeof(uint32_t)) {
-            return false;
-        }
+    if (m_read_ahead) {
+        return decompressReadAhead();
+    }
 
-        uint32_t bytesToDecompress = *((uint32_t*)m_compressed_blocks);
+    PyEnsureGilReleased releaseTheGil;
 
-        if (bytesToDecompress + sizeof(uint32_t) > m_compressed_block_data_remaining) {
-            throw std::runtime_error("Corrupt data: can't decompress this large of a block");
+    const uint8_t* data;
+    size_t bytecount;
+
+    if (!nextCompressedBlock(data, bytecount)) {
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    decompressFrame(data, bytecount, bytes);
+    appendDecompressed(bytes);
+
+    return true;
+}
+
+void DeserializationBuffer::feed(const uint8_t* data, size_t bytecount) {
+    if (!m_streaming) {
+        throw std::runtime_error("Can't feed data to a DeserializationBuffer that was built with its data");
+    }
+
+    PyEnsureGilReleased releaseTheGil;
+
+    if (!m_context.isCompressionEnabled()) {
+        compactDecompressedBuffer();
+
+        m_decompressed_buffer.insert(m_decompressed_buffer.end(), data, data + bytecount);
+
+        m_size = m_decompressed_buffer.size();
+        m_read_head = m_decompressed_buffer.data();
+        return;
+    }
+
+    m_pending_compressed.insert(m_pending_compressed.end(), data, data + bytecount);
+
+    // inflate every block that's now complete
+    size_t consumed = 0;
+
+    while (m_pending_compressed.size() - consumed >= sizeof(uint32_t)) {
+        uint32_t blockBytes;
+        memcpy(&blockBytes, &m_pending_compressed[consumed], sizeof(uint32_t));
+
+        if (m_pending_compressed.size() - consumed - sizeof(uint32_t) < blockBytes) {
+            break;
         }
 
-        m_compressed_blocks += sizeof(uint32_t) + bytesToDecompress;
-        m_compressed_block_data_remaining -= sizeof(uint32_t) + bytesToDecompress;
+        std::vector<uint8_t> bytes;
+        decompressFrame(&m_pending_compressed[consumed + sizeof(uint32_t)], blockBytes, bytes);
+        appendDecompressed(bytes);
+
+        consumed += sizeof(uint32_t) + blockBytes;
+    }
+
+    m_pending_compressed.erase(m_pending_compressed.begin(), m_pending_compressed.begin() + consumed);
+}
+
+bool DeserializationBuffer::hasCompleteMessage() {
+    if (m_scan_pos != m_pos) {
+        // the message we were scanning got read, so start on the next one
+        m_scan_offset = 0;
+        m_scan_stack.clear();
+        m_scan_pos = m_pos;
+    }
+
+    if (m_scan_offset && m_scan_stack.empty()) {
+        // we already found the end of it
+        return true;
+    }
 
-        LZ4F_decompressionContext_t compressionContext;
+    const uint8_t* end = m_read_head + m_size;
 
-        if (LZ4F_createDecompressionContext(&compressionContext, LZ4F_VERSION)) {
-            throw std::runtime_error("Failed to allocate an lz4 compression context.");
+    while (true) {
+        const uint8_t* p = m_read_head + m_scan_offset;
+
+        // scan one header and whatever fixed-size body goes with it, and
+        // only advance once we have all of it.
+        uint64_t header;
+        const uint8_t* next = Varint::decodeChecked(p, end, header);
+
+        if (!next) {
+            // a varint that's too long is corrupt, and reading it will say so
+            return (size_t)(end - p) >= Varint::MAX_BYTES;
         }
 
-        size_t bytesDecompressed = 0;
+        size_t wireType = header & 7;
 
-        while (bytesDecompressed < bytesToDecompress) {
-            unsigned char compressionBuffer[1024*1024];
+        if (wireType == WireType::VARINT || wireType == WireType::BYTES) {
+            uint64_t value;
+            const uint8_t* afterValue = Varint::decodeChecked(next, end, value);
 
-            size_t bytesWritten = 1024 * 1024;
-            size_t bytesRead = bytesToDecompress - bytesDecompressed;
+            if (!afterValue) {
+                return (size_t)(end - next) >= Varint::MAX_BYTES;
+            }
 
-            size_t res = LZ4F_decompress(
-                compressionContext,
-                compressionBuffer,
-                &bytesWritten,
-                m_compressed_blocks - bytesToDecompress + bytesDecompressed,
-                &bytesRead,
-                nullptr
-            );
+            next = afterValue;
 
-            if (LZ4F_isError(res)) {
-                throw std::runtime_error(
-                  std::string("Error decompressing data using LZ4: ")
-                    + LZ4F_getErrorName(res)
-                );
+            if (wireType == WireType::BYTES) {
+                if ((uint64_t)(end - next) < value) {
+                    return false;
+                }
+                next += value;
             }
+        } else
+        if (wireType == WireType::BITS_32 || wireType == WireType::BITS_64) {
+            size_t width = wireType == WireType::BITS_32 ? 4 : 8;
 
-            if (m_read_head_offset) {
-                m_decompressed_buffer.erase(
-                    m_decompressed_buffer.begin(),
-                    m_decompressed_buffer.begin() + m_read_head_offset
-                );
+            if ((size_t)(end - next) < width) {
+                return false;
+            }
+            next += width;
+        }
+
+        m_scan_offset = next - m_read_head;
+
+        if (wireType == WireType::SINGLE) {
+            m_scan_stack.push_back(SCAN_SINGLE);
+            continue;
+        }
+
+        if (wireType == WireType::BEGIN_COMPOUND) {
+            m_scan_stack.push_back(SCAN_COMPOUND);
+            continue;
+        }
 
-                m_read_head_offset = 0;
+        if (wireType == WireType::END_COMPOUND) {
+            if (m_scan_stack.empty() || m_scan_stack.back() != SCAN_COMPOUND) {
+                // corrupt
+                return true;
             }
+            m_scan_stack.pop_back();
+        }
+
+        // a message just finished, which finishes any SINGLE holding it
+        while (m_scan_stack.size() && m_scan_stack.back() == SCAN_SINGLE) {
+            m_scan_stack.pop_back();
+        }
+
+        if (m_scan_stack.empty()) {
+            return true;
+        }
+    }
+}
+
+bool DeserializationBuffer::decompressReadAhead() {
+    PyEnsureGilReleased releaseTheGil;
+
+    scheduleReadAhead();
+
+    if (m_read_ahead_tasks.empty()) {
+        return false;
+    }
+
+    std::shared_ptr<DecompressionTask> task = m_read_ahead_tasks.front();
+    m_read_ahead_tasks.pop_front();
+
+    {
+        std::unique_lock<std::mutex> lock(s_decompress_thread_mutex);
+
+        while (!task->m_done) {
+            s_decompress_has_work->wait(lock);
+        }
+    }
+
+    if (task->m_error.size()) {
+        throw std::runtime_error(task->m_error);
+    }
+
+    appendDecompressed(task->m_output);
+
+    // keep the pool busy while the caller consumes this block
+    scheduleReadAhead();
+
+    return true;
+}
+
+void DeserializationBuffer::scheduleReadAhead() {
+    std::vector<std::shared_ptr<DecompressionTask> > newTasks;
+
+    while (m_read_ahead_tasks.size() + newTasks.size() < READ_AHEAD_BLOCKS) {
+        const uint8_t* data;
+        size_t bytecount;
+
+        if (!nextCompressedBlock(data, bytecount)) {
+            break;
+        }
+
+        newTasks.push_back(std::make_shared<DecompressionTask>(data, bytecount));
+    }
+
+    if (newTasks.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(s_decompress_thread_mutex);
+
+    if (!s_decompress_threads.size()) {
+        s_decompress_has_work = new std::condition_variable();
 
-            m_decompressed_buffer.insert(
-                m_decompressed_buffer.end(),
-                compressionBuffer,
-                compressionBuffer + bytesWritten
+        for (long i = 0; i < 4; i++) {
+            s_decompress_threads.push_back(
+                new std::thread(DeserializationBuffer::decompressionThread)
             );
-            m_size += bytesWritten;
-            m_read_head = &m_decompressed_buffer[0];
+        }
+    }
+
+    for (auto task: newTasks) {
+        m_read_ahead_tasks.push_back(task);
+        s_waiting_decompress_tasks.push_back(task);
+    }
+
+    s_decompress_has_work->notify_all();
+}
 
-            bytesDecompressed += bytesRead;
+void DeserializationBuffer::cancelReadAhead() {
+    if (m_read_ahead_tasks.empty()) {
+        return;
+    }
+
+    PyEnsureGilReleased releaseTheGil;
+
+    std::unique_lock<std::mutex> lock(s_decompress_thread_mutex);
+
+    for (auto task: m_read_ahead_tasks) {
+        if (!task->m_started) {
+            s_waiting_decompress_tasks.erase(
+                std::find(s_waiting_decompress_tasks.begin(), s_waiting_decompress_tasks.end(), task)
+            );
+        } else {
+            while (!task->m_done) {
+                s_decompress_has_work->wait(lock);
+            }
         }
+    }
+
+    m_read_ahead_tasks.clear();
+}
 
-        LZ4F_freeDecompressionContext(compressionContext);
+/* static */
+std::shared_ptr<DecompressionTask> DeserializationBuffer::getNextDecompressTask() {
+    std::unique_lock<std::mutex> lock(s_decompress_thread_mutex);
 
-        return true;
+    while (true) {
+        if (s_waiting_decompress_tasks.size()) {
+            std::shared_ptr<DecompressionTask> res = s_waiting_decompress_tasks.front();
+            s_waiting_decompress_tasks.pop_front();
+
+            res->m_started = true;
+            s_running_decompress_tasks++;
+
+            return res;
+        }
+
+        s_decompress_has_work->wait(lock);
     }
 }
+
+/* static */
+void DeserializationBuffer::decompressionThread() {
+    while (true) {
+        std::shared_ptr<DecompressionTask> task = getNextDecompressTask();
+
+        task->decompress();
+
+        std::unique_lock<std::mutex> lock(s_decompress_thread_mutex);
+
+        task->m_done = true;
+        s_running_decompress_tasks--;
+
+        s_decompress_has_work->notify_all();
+    }
+}
+
+/* static */
+void DeserializationBuffer::installForkHandlers() {
+    pthread_atfork(
+        DeserializationBuffer::prepareDecompressionForFork,
+        DeserializationBuffer::resumeDecompressionInParent,
+        DeserializationBuffer::resetDecompressionInChild
+    );
+}
+
+// as with compression (see SerializationBuffer::prepareCompressionForFork), we fork
+// holding the mutex once the threads have finished everything they've been given.
+/* static */
+void DeserializationBuffer::prepareDecompressionForFork() {
+    std::unique_lock<std::mutex> lock(s_decompress_thread_mutex);
+
+    while (s_waiting_decompress_tasks.size() || s_running_decompress_tasks) {
+        s_decompress_has_work->wait(lock);
+    }
+
+    lock.release();
+}
+
+/* static */
+void DeserializationBuffer::resumeDecompressionInParent() {
+    s_decompress_thread_mutex.unlock();
+}
+
+/* static */
+void DeserializationBuffer::resetDecompressionInChild() {
+    s_decompress_threads.clear();
+    s_decompress_thread_mutex.unlock();
+}
+
+// static
+std::mutex DeserializationBuffer::s_decompress_thread_mutex;
+
+// static
+std::condition_variable* DeserializationBuffer::s_decompress_has_work;
+
+// static
+std::vector<std::thread*> DeserializationBuffer::s_decompress_threads;
+
+// static
+std::deque<std::shared_ptr<DecompressionTask> > DeserializationBuffer::s_waiting_decompress_tasks;
+
+// static
+size_t DeserializationBuffer::s_running_decompress_tasks = 0;
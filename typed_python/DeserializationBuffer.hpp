@@ -18,27 +18,62 @@
 
 #include "Type.hpp"
 #include "WireType.hpp"
+#include "Varint.hpp"
 #include <stdexcept>
+#include <limits>
 #include <stdlib.h>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 class SerializationContext;
 
-
-class DeserializationBuffer {
+// a single length-prefixed lz4 frame from a compressed stream, which a
+// worker thread inflates while the reader is still consuming earlier blocks.
+class DecompressionTask {
 public:
-    DeserializationBuffer(uint8_t* ptr, size_t sz, const SerializationContext& context) :
-            m_context(context),
-            m_read_head(nullptr),
-            m_read_head_offset(0),
-            m_size(0),
-            m_compressed_blocks(ptr),
-            m_compressed_block_data_remaining(sz),
-            m_pos(0)
+    DecompressionTask(const uint8_t* data, size_t size) :
+            m_data(data),
+            m_size(size),
+            m_started(false),
+            m_done(false)
     {
     }
 
+    void decompress();
+
+    const uint8_t* m_data;
+    size_t m_size;
+
+    // both guarded by DeserializationBuffer::s_decompress_thread_mutex
+    bool m_started;
+    bool m_done;
+
+    std::vector<uint8_t> m_output;
+
+    // nonempty if decompression failed, in which case the reader throws it
+    std::string m_error;
+};
+
+
+class DeserializationBuffer {
+public:
+    DeserializationBuffer(uint8_t* ptr, size_t sz, const SerializationContext& context);
+
+    // a buffer that starts out empty and reads whatever's passed to 'feed'.
+    // See 'hasCompleteMessage'.
+    explicit DeserializationBuffer(const SerializationContext& context);
+
     ~DeserializationBuffer() {
+        cancelReadAhead();
+
+        if (m_pushed_arena) {
+            tp_pop_arena();
+        }
+
         for (auto& typeAndList: m_needs_decref) {
             typeAndList.first->check([&](auto& concreteType) {
                 for (auto ptr: typeAndList.second) {
@@ -67,11 +102,35 @@ public:
 
     //read a 'varint' (a la google protobuf encoding).
     uint64_t readUnsignedVarint() {
+        // with a whole varint's worth of bytes in hand we can decode it
+        // without checking for the end of the data on every byte
+        if (m_size >= Varint::MAX_BYTES) {
+            uint64_t res;
+            const uint8_t* next = Varint::decode(m_read_head, res);
+
+            if (!next) {
+                throw std::runtime_error("Corrupt data (varint is too long)");
+            }
+
+            size_t bytecount = next - m_read_head;
+
+            m_size -= bytecount;
+            m_read_head += bytecount;
+            m_read_head_offset += bytecount;
+            m_pos += bytecount;
+
+            return res;
+        }
+
         uint64_t accumulator = 0;
 
         uint64_t shift = 0;
 
         while (true) {
+            if (shift >= 7 * Varint::MAX_BYTES) {
+                throw std::runtime_error("Corrupt data (varint is too long)");
+            }
+
             uint64_t value = read<uint8_t>();
             accumulator += (value & 127) << shift;
             shift += 7;
@@ -196,11 +255,13 @@ public:
         }
 
         if (wireType == WireType::SINGLE) {
+            DepthGuard nesting(*this);
             readMessageAndDiscard();
             return;
         }
 
         if (wireType == WireType::BEGIN_COMPOUND) {
+            DepthGuard nesting(*this);
             while (readMessageAndDiscard() != WireType::END_COMPOUND) {
                 //do nothing
             }
@@ -314,6 +375,56 @@ public:
         });
     }
 
+    // bound what we'll build out of untrusted data: how deeply objects may
+    // nest, and how many bytes of elements the counts in the data may make
+    // us allocate. Zero means no limit.
+    void setLimits(size_t maxDepth, size_t maxAllocationBytes) {
+        m_max_depth = maxDepth;
+        m_max_allocation_bytes = maxAllocationBytes;
+    }
+
+    // account for a container of 'count' elements of 'bytesEach' bytes that
+    // the data asks us to allocate. A count that can't be allocated at all
+    // is always an error.
+    void chargeAllocation(size_t count, size_t bytesEach) {
+        if (bytesEach && count > std::numeric_limits<size_t>::max() / bytesEach) {
+            throw std::runtime_error("Corrupt data: container of " + format(count) + " elements is too large");
+        }
+
+        if (!m_max_allocation_bytes) {
+            return;
+        }
+
+        if (count * bytesEach > m_max_allocation_bytes - m_allocated_bytes) {
+            throw std::runtime_error(
+                "Deserializing would allocate more than " + format(m_max_allocation_bytes) + " bytes"
+            );
+        }
+
+        m_allocated_bytes += count * bytesEach;
+    }
+
+    // held while we deserialize one object, so we can bound how deeply they nest
+    class DepthGuard {
+    public:
+        DepthGuard(DeserializationBuffer& buffer) : m_buffer(buffer) {
+            if (m_buffer.m_max_depth && m_buffer.m_depth >= m_buffer.m_max_depth) {
+                throw std::runtime_error(
+                    "Deserialized objects nest more than " + format(m_buffer.m_max_depth) + " deep"
+                );
+            }
+
+            m_buffer.m_depth++;
+        }
+
+        ~DepthGuard() {
+            m_buffer.m_depth--;
+        }
+
+    private:
+        DeserializationBuffer& m_buffer;
+    };
+
     bool isDone() {
         return !canConsume(1);
     }
@@ -332,6 +443,33 @@ public:
         return m_pos;
     }
 
+    /********* streaming *********
+
+    A buffer built without data reads a stream that arrives in pieces:
+    'feed' each piece as it arrives, and then read messages for as long as
+    'hasCompleteMessage' says the next one is all there. Messages are
+    read with the same buffer throughout, so they can refer to objects in
+    earlier messages, exactly as 'deserializeStream' allows.
+
+    With compression, the pieces are the compressed stream, and we inflate
+    each block as soon as it's complete. Either way we hold only what hasn't
+    been read yet.
+    *********/
+
+    void feed(const uint8_t* data, size_t bytecount);
+
+    // is the next message entirely in the buffer? Picks up where the last
+    // call left off, so a large message arriving in many pieces is only
+    // scanned once. Corrupt data counts as complete, so that reading it
+    // throws.
+    bool hasCompleteMessage();
+
+    // the bytes we've been fed but haven't read yet, including any
+    // compressed bytes we haven't inflated.
+    size_t bytesBuffered() const {
+        return m_size + m_pending_compressed.size();
+    }
+
     const SerializationContext& getContext() const {
         return m_context;
     }
@@ -505,11 +643,80 @@ public:
         return *ptr;
     }
 
+    // inflate the lz4 frame of 'bytecount' bytes at 'data' onto the end of 'out'
+    static void decompressFrame(const uint8_t* data, size_t bytecount, std::vector<uint8_t>& out);
+
+    // make sure a process we fork can use the decompression threads
+    static void installForkHandlers();
+
 private:
     bool decompress();
 
+    bool decompressReadAhead();
+
+    // split the next length-prefixed block off of the compressed data, returning
+    // false if there isn't one.
+    bool nextCompressedBlock(const uint8_t*& data, size_t& bytecount);
+
+    // hand blocks to the worker pool until READ_AHEAD_BLOCKS are in flight
+    void scheduleReadAhead();
+
+    // withdraw the tasks no worker has picked up yet, and wait for the rest,
+    // since they point into our compressed data.
+    void cancelReadAhead();
+
+    // append the bytes we just decompressed to whatever's left of the buffer
+    void appendDecompressed(std::vector<uint8_t>& bytes);
+
+    // drop the bytes we've already read from the front of the buffer
+    void compactDecompressedBuffer();
+
+    static const uint8_t SCAN_SINGLE = 0;
+    static const uint8_t SCAN_COMPOUND = 1;
+
+    static const size_t READ_AHEAD_BLOCKS = 8;
+
+    static void decompressionThread();
+
+    static std::shared_ptr<DecompressionTask> getNextDecompressTask();
+
+    static void prepareDecompressionForFork();
+    static void resumeDecompressionInParent();
+    static void resetDecompressionInChild();
+
+    static std::mutex s_decompress_thread_mutex;
+    static std::condition_variable* s_decompress_has_work;
+    static std::vector<std::thread*> s_decompress_threads;
+    static std::deque<std::shared_ptr<DecompressionTask> > s_waiting_decompress_tasks;
+
+    // how many tasks the threads have started but not finished
+    static size_t s_running_decompress_tasks;
+
     const SerializationContext& m_context;
 
+    // decompress blocks on the worker pool ahead of the reader
+    bool m_read_ahead;
+
+    // whether we pushed an arena for the objects we deserialize, which
+    // we pop when we're done.
+    bool m_pushed_arena;
+
+    // the blocks we've scheduled, in stream order
+    std::deque<std::shared_ptr<DecompressionTask> > m_read_ahead_tasks;
+
+    // whether we read data passed to 'feed' rather than a fixed block
+    bool m_streaming;
+
+    // compressed bytes we've been fed that don't make up a whole block yet
+    std::vector<uint8_t> m_pending_compressed;
+
+    // where 'hasCompleteMessage' got to: how far past the read head it has
+    // scanned, the SINGLE and COMPOUND messages open at that point, and
+    // the value of 'm_pos' it was scanning from.
+    size_t m_scan_offset;
+    std::vector<uint8_t> m_scan_stack;
+    size_t m_scan_pos;
+
     std::vector<uint8_t> m_decompressed_buffer;
     uint8_t* m_read_head;
     size_t m_read_head_offset;
@@ -520,6 +727,15 @@ private:
 
     size_t m_pos;
 
+    // see 'setLimits'
+    size_t m_max_depth;
+    size_t m_max_allocation_bytes;
+
+    // how deeply nested the object we're reading is, and how many bytes of
+    // elements we've charged so far.
+    size_t m_depth;
+    size_t m_allocated_bytes;
+
     // maps indices to the pointers we've cached under that index.
     std::vector<void*> m_cachedPointers;
 
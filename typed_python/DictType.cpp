@@ -245,6 +245,12 @@ bool DictType::slotPopulated(instance_ptr self, size_t slot) const {
     return record.items_populated[slot];
 }
 
+int64_t DictType::nextPopulatedSlot(instance_ptr self, int64_t offset) const {
+    hash_table_layout& record = **(hash_table_layout**)self;
+
+    return record.nextPopulatedSlot(offset);
+}
+
 instance_ptr DictType::keyAtSlot(instance_ptr self, size_t offset) const {
     hash_table_layout& record = **(hash_table_layout**)self;
 
@@ -268,7 +274,7 @@ instance_ptr DictType::lookupValueByKey(instance_ptr self, instance_ptr key) con
 
     typed_python_hash_type keyHash = m_key->hash(key);
 
-    int32_t index = record.find(m_bytes_per_key_value_pair, keyHash, [&](instance_ptr ptr) {
+    int64_t index = record.find(m_bytes_per_key_value_pair, keyHash, [&](instance_ptr ptr) {
         return m_key->cmp(key, ptr, Py_EQ, false);
     });
 
@@ -284,7 +290,7 @@ bool DictType::deleteKey(instance_ptr self, instance_ptr key) const {
 
     typed_python_hash_type keyHash = m_key->hash(key);
 
-    int32_t index = record.remove(m_bytes_per_key_value_pair, keyHash, [&](instance_ptr ptr) {
+    int64_t index = record.remove(m_bytes_per_key_value_pair, keyHash, [&](instance_ptr ptr) {
         return m_key->cmp(key, ptr, Py_EQ, false);
     });
 
@@ -312,12 +318,53 @@ void DictType::clear(instance_ptr self) {
     record.allItemsHaveBeenRemoved();
 }
 
+void DictType::compact(instance_ptr self) {
+    hash_table_layout& record = **(hash_table_layout**)self;
+
+    record.compact(m_bytes_per_key_value_pair);
+}
+
+void DictType::insertColumns(instance_ptr self, instance_ptr keys, instance_ptr values, size_t count) {
+    hash_table_layout& record = **(hash_table_layout**)self;
+
+    record.reserveForInsertion(m_bytes_per_key_value_pair, count);
+
+    // hash everything up front, so the insertion loop below only touches the table
+    std::vector<typed_python_hash_type> hashes(count);
+
+    for (size_t k = 0; k < count; k++) {
+        hashes[k] = m_key->hash(keys + k * m_bytes_per_key);
+    }
+
+    size_t bytesPerValue = m_value->bytecount();
+
+    for (size_t k = 0; k < count; k++) {
+        instance_ptr key = keys + k * m_bytes_per_key;
+        instance_ptr value = values + k * bytesPerValue;
+
+        int64_t index = record.find(m_bytes_per_key_value_pair, hashes[k], [&](instance_ptr ptr) {
+            return m_key->cmp(key, ptr, Py_EQ, false);
+        });
+
+        if (index >= 0) {
+            m_value->assign(record.items + index * m_bytes_per_key_value_pair + m_bytes_per_key, value);
+        } else {
+            int64_t slot = record.allocateNewSlot(m_bytes_per_key_value_pair);
+
+            record.add(hashes[k], slot);
+
+            m_key->copy_constructor(record.items + slot * m_bytes_per_key_value_pair, key);
+            m_value->copy_constructor(record.items + slot * m_bytes_per_key_value_pair + m_bytes_per_key, value);
+        }
+    }
+}
+
 bool DictType::deleteKeyWithUninitializedValue(instance_ptr self, instance_ptr key) const {
     hash_table_layout& record = **(hash_table_layout**)self;
 
     typed_python_hash_type keyHash = m_key->hash(key);
 
-    int32_t index = record.remove(m_bytes_per_key_value_pair, keyHash, [&](instance_ptr ptr) {
+    int64_t index = record.remove(m_bytes_per_key_value_pair, keyHash, [&](instance_ptr ptr) {
         return m_key->cmp(key, ptr, Py_EQ, false);
     });
 
@@ -333,7 +380,7 @@ instance_ptr DictType::insertKey(instance_ptr self, instance_ptr key) const {
 
     typed_python_hash_type keyHash = m_key->hash(key);
 
-    int32_t slot = record.allocateNewSlot(m_bytes_per_key_value_pair);
+    int64_t slot = record.allocateNewSlot(m_bytes_per_key_value_pair);
 
     record.add(keyHash, slot);
 
@@ -352,12 +399,20 @@ void DictType::constructor(instance_ptr self) {
     new (&record) hash_table_layout();
 
     record.refcount += 1;
+
+    if (type_live_counters_enabled) {
+        record.startCounting(this);
+    }
 }
 
 void DictType::destroy(instance_ptr self) {
     hash_table_layout& record = **(hash_table_layout**)self;
 
     if (record.refcount.fetch_sub(1) == 1) {
+        if (record.counted_type) {
+            typeLiveCountersAdjust(record.counted_type, &record, -1);
+        }
+
         for (long k = 0; k < record.items_reserved; k++) {
             if (record.items_populated[k]) {
                 m_key->destroy(record.items + m_bytes_per_key_value_pair * k);
@@ -369,6 +424,7 @@ void DictType::destroy(instance_ptr self) {
         tp_free(record.items_populated);
         tp_free(record.hash_table_slots);
         tp_free(record.hash_table_hashes);
+        tp_free(record.hash_table_control);
         tp_free(&record);
     }
 }
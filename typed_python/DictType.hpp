@@ -73,11 +73,9 @@ public:
     void visitValues(instance_ptr self, visitor_type visitor) {
         hash_table_layout& l = **(hash_table_layout**)self;
 
-        for (long k = 0; k < l.items_reserved; k++) {
-            if (l.items_populated[k]) {
-                if (!visitor(l.items + m_bytes_per_key_value_pair * k + m_bytes_per_key)) {
-                    return;
-                }
+        for (long k = l.nextPopulatedSlot(0); k < l.items_reserved; k = l.nextPopulatedSlot(k + 1)) {
+            if (!visitor(l.items + m_bytes_per_key_value_pair * k + m_bytes_per_key)) {
+                return;
             }
         }
     }
@@ -88,11 +86,9 @@ public:
     void visitKeyValuePairs(instance_ptr self, visitor_type visitor) {
         hash_table_layout& l = **(hash_table_layout**)self;
 
-        for (long k = 0; k < l.items_reserved; k++) {
-            if (l.items_populated[k]) {
-                if (!visitor(l.items + m_bytes_per_key_value_pair * k)) {
-                    return;
-                }
+        for (long k = l.nextPopulatedSlot(0); k < l.items_reserved; k = l.nextPopulatedSlot(k + 1)) {
+            if (!visitor(l.items + m_bytes_per_key_value_pair * k)) {
+                return;
             }
         }
     }
@@ -103,14 +99,12 @@ public:
     void visitKeyValuePairsAsSeparateArgs(instance_ptr self, visitor_type visitor) {
         hash_table_layout& l = **(hash_table_layout**)self;
 
-        for (long k = 0; k < l.items_reserved; k++) {
-            if (l.items_populated[k]) {
-                if (!visitor(
-                    l.items + m_bytes_per_key_value_pair * k,
-                    l.items + m_bytes_per_key_value_pair * k + m_bytes_per_key)
-                ) {
-                    return;
-                }
+        for (long k = l.nextPopulatedSlot(0); k < l.items_reserved; k = l.nextPopulatedSlot(k + 1)) {
+            if (!visitor(
+                l.items + m_bytes_per_key_value_pair * k,
+                l.items + m_bytes_per_key_value_pair * k + m_bytes_per_key)
+            ) {
+                return;
             }
         }
     }
@@ -123,31 +117,31 @@ public:
         hash_table_layout_ptr& destRecordPtr = *(hash_table_layout**)dest;
         hash_table_layout_ptr& srcRecordPtr = *(hash_table_layout**)src;
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcRecordPtr);
+        instance_ptr destPtr;
+        bool isNew;
 
-        if (it == context.alreadyAllocated.end()) {
-            destRecordPtr = srcRecordPtr->deepcopy(
-            context,
-                this,
-                m_key,
-                m_value
-            );
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcRecordPtr, [&]() {
+            return (instance_ptr)hash_table_layout::allocateForDeepcopy(context, this);
+        });
 
-            context.alreadyAllocated[(instance_ptr)srcRecordPtr] = (instance_ptr)destRecordPtr;
-        } else {
-            destRecordPtr = (hash_table_layout_ptr)context.alreadyAllocated[(instance_ptr)srcRecordPtr];
-            destRecordPtr->refcount++;
+        destRecordPtr = (hash_table_layout_ptr)destPtr;
+
+        if (isNew) {
+            srcRecordPtr->deepcopyInto(destRecordPtr, context, m_key, m_value);
         }
+
+        destRecordPtr->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         hash_table_layout& l = **(hash_table_layout**)instance;
 
-        if (alreadyVisited.find((void*)&l) != alreadyVisited.end()) {
+        if (context.visited.contains((void*)&l)) {
             return 0;
         }
 
-        alreadyVisited.insert((void*)&l);
+        context.visited.insert((void*)&l);
+        context.noteRefcount(l.refcount);
 
         if (outSlabs && Slab::slabForAlloc(&l)) {
             outSlabs->insert(Slab::slabForAlloc(&l));
@@ -160,12 +154,12 @@ public:
         res += bytesRequiredForAllocation(l.items_reserved * m_bytes_per_key_value_pair);
 
         // count the hashtable
-        res += bytesRequiredForAllocation(sizeof(int32_t) * l.hash_table_size) * 2;
+        res += l.hashTableFootprint();
 
         if (!m_key->isPOD()) {
             for (long k = 0; k < l.items_reserved; k++) {
                 if (l.items_populated[k]) {
-                    res += m_key->deepBytecount(l.items + k * m_bytes_per_key_value_pair, alreadyVisited, outSlabs);
+                    res += m_key->deepBytecount(l.items + k * m_bytes_per_key_value_pair, context, outSlabs);
                 }
             }
         }
@@ -173,7 +167,7 @@ public:
         if (!m_value->isPOD()) {
             for (long k = 0; k < l.items_reserved; k++) {
                 if (l.items_populated[k]) {
-                    res += m_value->deepBytecount(l.items + k * m_bytes_per_key_value_pair + m_bytes_per_key, alreadyVisited, outSlabs);
+                    res += m_value->deepBytecount(l.items + k * m_bytes_per_key_value_pair + m_bytes_per_key, context, outSlabs);
                 }
             }
         }
@@ -200,12 +194,35 @@ public:
         buffer.writeUnsignedVarintObject(0, l.hash_table_count);
 
         size_t slotsWritten = 2;
-        for (long k = 0; k < l.items_reserved; k++) {
-            if (l.items_populated[k]) {
-                m_key->serialize(l.items + m_bytes_per_key_value_pair * k, buffer, 0);
-                m_value->serialize(l.items + m_bytes_per_key_value_pair * k + m_bytes_per_key, buffer, 0);
-                slotsWritten += 2;
+
+        auto writeSlots = [&](buf_t& slotBuffer, int64_t lo, int64_t hi) {
+            size_t written = 0;
+
+            for (long k = lo; k < hi; k++) {
+                if (l.items_populated[k]) {
+                    m_key->serialize(l.items + m_bytes_per_key_value_pair * k, slotBuffer, 0);
+                    m_value->serialize(l.items + m_bytes_per_key_value_pair * k + m_bytes_per_key, slotBuffer, 0);
+                    written += 2;
+                }
             }
+
+            return written;
+        };
+
+        int64_t threadCount = buffer.threadsToSerialize(l.items_reserved, {m_key, m_value});
+
+        if (threadCount > 1) {
+            std::atomic<size_t> written(0);
+
+            buffer.serializeInParallel(threadCount, l.items_reserved,
+                [&](buf_t& threadBuffer, int64_t lo, int64_t hi) {
+                    written += writeSlots(threadBuffer, lo, hi);
+                }
+            );
+
+            slotsWritten += written;
+        } else {
+            slotsWritten += writeSlots(buffer, 0, l.items_reserved);
         }
 
         buffer.writeEndCompound();
@@ -220,54 +237,93 @@ public:
         size_t count = 0;
         size_t id = 0;
         bool wasFromId = false;
-
-        size_t valuesRead = buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
-            [&](size_t fieldNumber, size_t subWireType) {
-                if (fieldNumber == 0) {
-                    assertWireTypesEqual(subWireType, WireType::VARINT);
-                    id = buffer.readUnsignedVarint();
-
-                    void* ptr = buffer.lookupCachedPointer(id);
-
-                    if (ptr) {
-                        *((hash_table_layout**)self) = (hash_table_layout*)ptr;
-                        (*(hash_table_layout**)self)->refcount++;
-                        wasFromId = true;
+        bool constructed = false;
+
+        // how many entries we've read both halves of, and whether we've
+        // read the key of the next one
+        size_t entriesRead = 0;
+        bool hasPendingKey = false;
+
+        try {
+            size_t valuesRead = buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
+                [&](size_t fieldNumber, size_t subWireType) {
+                    if (fieldNumber == 0) {
+                        assertWireTypesEqual(subWireType, WireType::VARINT);
+                        id = buffer.readUnsignedVarint();
+
+                        void* ptr = buffer.lookupCachedPointer(id);
+
+                        if (ptr) {
+                            *((hash_table_layout**)self) = (hash_table_layout*)ptr;
+                            (*(hash_table_layout**)self)->refcount++;
+                            wasFromId = true;
+                        }
+                    } else if (wasFromId) {
+                        throw std::runtime_error("Corrupt Dict: a memoized Dict has contents");
+                    } else if (fieldNumber == 1) {
+                        assertWireTypesEqual(subWireType, WireType::VARINT);
+                        count = buffer.readUnsignedVarint();
+
+                        buffer.chargeAllocation(count, m_bytes_per_key_value_pair);
+
+                        constructor(self);
+                        constructed = true;
+
+                        hash_table_layout& l = **((hash_table_layout**)self);
+                        buffer.addCachedPointer(id, &l, this);
+                        l.refcount++;
+
+                        l.prepareForDeserialization(count, m_bytes_per_key_value_pair);
+                    } else {
+                        hash_table_layout& l = **((hash_table_layout**)self);
+
+                        size_t keyIx = (fieldNumber - 2) / 2;
+                        bool isKey = fieldNumber % 2 == 0;
+
+                        if (keyIx >= count) {
+                            throw std::runtime_error("Corrupt Dict: more entries than its count");
+                        }
+
+                        if (isKey) {
+                            m_key->deserialize(l.items + m_bytes_per_key_value_pair * keyIx, buffer, subWireType);
+                            hasPendingKey = true;
+                        } else {
+                            m_value->deserialize(l.items + m_bytes_per_key_value_pair * keyIx + m_bytes_per_key, buffer, subWireType);
+                            hasPendingKey = false;
+                            entriesRead++;
+                        }
                     }
-                } else if (fieldNumber == 1) {
-                    assertWireTypesEqual(subWireType, WireType::VARINT);
-                    count = buffer.readUnsignedVarint();
-
-                    constructor(self);
-
-                    hash_table_layout& l = **((hash_table_layout**)self);
-                    buffer.addCachedPointer(id, &l, this);
-                    l.refcount++;
+            });
 
-                    l.prepareForDeserialization(count, m_bytes_per_key_value_pair);
-                } else {
-                    hash_table_layout& l = **((hash_table_layout**)self);
+            if (!wasFromId) {
+                if (!constructed || (valuesRead - 2) / 2 != count || hasPendingKey) {
+                    throw std::runtime_error("Invalid Dict found.");
+                }
 
-                    size_t keyIx = (fieldNumber - 2) / 2;
-                    bool isKey = fieldNumber % 2 == 0;
-                    if (isKey) {
-                        m_key->deserialize(l.items + m_bytes_per_key_value_pair * keyIx, buffer, subWireType);
-                    } else {
-                        m_value->deserialize(l.items + m_bytes_per_key_value_pair * keyIx + m_bytes_per_key, buffer, subWireType);
-                    }
+                hash_table_layout& l = **((hash_table_layout**)self);
+                l.buildHashTableAfterDeserialization(
+                    m_bytes_per_key_value_pair,
+                    [&](instance_ptr ptr) { return m_key->hash(ptr); }
+                    );
+            }
+        } catch(...) {
+            // drop our reference. The memo keeps its own, and destroys
+            // whatever entries we finished when the buffer goes away.
+            if (constructed) {
+                hash_table_layout& l = **((hash_table_layout**)self);
+
+                if (hasPendingKey) {
+                    m_key->destroy(l.items + m_bytes_per_key_value_pair * entriesRead);
                 }
-        });
 
-        if (!wasFromId) {
-            if ((valuesRead - 2) / 2 != count) {
-                throw std::runtime_error("Invalid Dict found.");
+                l.abandonDeserialization(entriesRead);
+            }
+
+            if (constructed || wasFromId) {
+                destroy(self);
             }
 
-            hash_table_layout& l = **((hash_table_layout**)self);
-            l.buildHashTableAfterDeserialization(
-                m_bytes_per_key_value_pair,
-                [&](instance_ptr ptr) { return m_key->hash(ptr); }
-                );
+            throw;
         }
     }
 
@@ -297,6 +353,9 @@ public:
 
     bool slotPopulated(instance_ptr self, size_t offset) const;
 
+    // the first populated slot at or after 'offset', or slotCount(self) if there isn't one.
+    int64_t nextPopulatedSlot(instance_ptr self, int64_t offset) const;
+
     instance_ptr keyAtSlot(instance_ptr self, size_t offset) const;
 
     instance_ptr valueAtSlot(instance_ptr self, size_t offset) const;
@@ -316,6 +375,13 @@ public:
 
     void clear(instance_ptr self);
 
+    // release item slots and hashtable buckets not needed by the live items
+    void compact(instance_ptr self);
+
+    // insert 'count' pairs from contiguous arrays of keys and values, sizing
+    // the table once for all of them. Later duplicates overwrite earlier ones.
+    void insertColumns(instance_ptr self, instance_ptr keys, instance_ptr values, size_t count);
+
     void copy_constructor(instance_ptr self, instance_ptr other);
 
     void assign(instance_ptr self, instance_ptr other);
@@ -324,6 +390,8 @@ public:
 
     Type* valueType() const { return m_value; }
 
+    size_t bytesPerKeyValuePair() const { return m_bytes_per_key_value_pair; }
+
 private:
     Type* m_key;
     Type* m_value;
@@ -0,0 +1,174 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FileIO.hpp"
+#include "PyGilState.hpp"
+
+namespace FileIO {
+
+int64_t readSome(int fd, uint8_t* data, int64_t count) {
+    while (true) {
+        ssize_t res = ::read(fd, data, count);
+
+        if (res >= 0) {
+            return res;
+        }
+
+        if (errno != EINTR) {
+            return -errno;
+        }
+    }
+}
+
+int64_t writeAll(int fd, const uint8_t* data, int64_t count) {
+    int64_t written = 0;
+
+    while (written < count) {
+        ssize_t res = ::write(fd, data + written, count - written);
+
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return -errno;
+        }
+
+        written += res;
+    }
+
+    return count;
+}
+
+AsyncWriter::AsyncWriter(int fd, size_t maxPendingBytes) :
+    m_fd(fd),
+    m_max_pending_bytes(maxPendingBytes),
+    m_pending_bytes(0),
+    m_closing(false),
+    m_error(0),
+    m_bytes_written(0),
+    m_thread([this]() { writeBlocks(); })
+{
+}
+
+AsyncWriter::~AsyncWriter() {
+    close();
+}
+
+void AsyncWriter::takeBlock(std::shared_ptr<SerializationBufferBlock> block, bool needsCompressing) {
+    // we may block here, and the writer thread never needs the GIL
+    PyEnsureGilReleased::finishDeferredRelease();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // always take at least one block, however big it is
+    while (!m_error && m_pending_bytes && m_pending_bytes + block->size() > m_max_pending_bytes) {
+        m_changed.wait(lock);
+    }
+
+    if (m_error) {
+        throw std::runtime_error(std::string("Error writing serialized data: ") + strerror(m_error));
+    }
+
+    m_pending_bytes += block->size();
+    m_pending.push_back(std::make_pair(block, needsCompressing));
+
+    m_changed.notify_all();
+}
+
+int AsyncWriter::close() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_closing = true;
+        m_changed.notify_all();
+    }
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    return m_error;
+}
+
+void AsyncWriter::writeBlocks() {
+    while (true) {
+        std::shared_ptr<SerializationBufferBlock> block;
+        bool needsCompressing;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (!m_pending.size() && !m_closing) {
+                m_changed.wait(lock);
+            }
+
+            if (!m_pending.size()) {
+                return;
+            }
+
+            block = m_pending.front().first;
+            needsCompressing = m_pending.front().second;
+            m_pending.pop_front();
+        }
+
+        size_t uncompressedSize = block->size();
+
+        int error = 0;
+
+        try {
+            if (needsCompressing) {
+                block->compress();
+            } else {
+                SerializationBuffer::waitForCompressionThreads(block);
+            }
+
+            int64_t res = writeAll(m_fd, block->buffer(), block->size());
+
+            if (res < 0) {
+                error = -res;
+            }
+        } catch(std::exception& e) {
+            // the only thing that throws is lz4 failing to compress
+            error = EIO;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_pending_bytes -= uncompressedSize;
+
+        if (error) {
+            // drop everything else, and make 'takeBlock' throw from now on
+            m_error = error;
+            m_pending.clear();
+            m_pending_bytes = 0;
+        } else {
+            m_bytes_written += block->size();
+        }
+
+        m_changed.notify_all();
+
+        if (error) {
+            return;
+        }
+    }
+}
+
+} // end namespace FileIO
@@ -0,0 +1,96 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "SerializationBuffer.hpp"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/*********
+Reads and writes on file descriptors, for compiled code and for streaming
+serialized data to disk.
+
+'readSome' and 'writeAll' are the system calls with EINTR and short writes
+taken care of. They return -errno rather than raising, so compiled code can
+call them without the GIL (see typed_python/lib/typed_file.py).
+
+An AsyncWriter is a SerializationBufferSink that writes each block it's
+handed to a file, in order, on its own thread, compressing it first if the
+serializing thread didn't. 'takeBlock' blocks once more than
+'maxPendingBytes' are waiting to be written, so serializing something far
+larger than memory holds no more than that (plus a block per compression
+thread) at once, and serialization and writing overlap.
+*********/
+
+namespace FileIO {
+
+// read up to 'count' bytes into 'data'. Returns how many we read (zero at the
+// end of the file) or -errno.
+int64_t readSome(int fd, uint8_t* data, int64_t count);
+
+// write all 'count' bytes of 'data'. Returns 'count' or -errno.
+int64_t writeAll(int fd, const uint8_t* data, int64_t count);
+
+class AsyncWriter : public SerializationBufferSink {
+public:
+    AsyncWriter(int fd, size_t maxPendingBytes);
+
+    // waits for the writer thread, like 'close'
+    ~AsyncWriter();
+
+    // throws if an earlier write failed
+    void takeBlock(std::shared_ptr<SerializationBufferBlock> block, bool needsCompressing) override;
+
+    // wait until everything we've been handed is written (or a write failed),
+    // and stop the writer thread. Returns 0 or the errno of the failed write.
+    // Don't hold the GIL while calling this.
+    int close();
+
+    size_t bytesWritten() const {
+        return m_bytes_written;
+    }
+
+private:
+    void writeBlocks();
+
+    int m_fd;
+
+    size_t m_max_pending_bytes;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_changed;
+
+    // blocks waiting to be written, and whether we have to compress them
+    std::deque<std::pair<std::shared_ptr<SerializationBufferBlock>, bool> > m_pending;
+
+    // the uncompressed size of everything in 'm_pending' and being written
+    size_t m_pending_bytes;
+
+    bool m_closing;
+
+    int m_error;
+
+    size_t m_bytes_written;
+
+    std::thread m_thread;
+};
+
+} // end namespace FileIO
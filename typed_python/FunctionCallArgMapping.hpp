@@ -19,6 +19,108 @@
 #include "FunctionType.hpp"
 #include "PyInstance.hpp"
 
+/*******
+The arguments of a call from python, either as the tuple and dict tp_call gets, or as the
+array and keyword names of a vectorcall (PEP 590), in which case the values of the keyword
+arguments follow the positional ones in the array. Either way the positional arguments are
+a contiguous array. This doesn't hold references to any of it.
+*******/
+
+class CallArguments {
+public:
+    // 'kwargs' may be null
+    CallArguments(PyObject* args, PyObject* kwargs) :
+        mPositional(((PyTupleObject*)args)->ob_item),
+        mPositionalCount(PyTuple_GET_SIZE(args)),
+        mKwargs(kwargs),
+        mKwnames(nullptr)
+    {
+    }
+
+    // 'kwnames' may be null
+    CallArguments(PyObject* const* args, size_t nargs, PyObject* kwnames) :
+        mPositional(args),
+        mPositionalCount(nargs),
+        mKwargs(nullptr),
+        mKwnames(kwnames)
+    {
+    }
+
+    PyObject* const* positional() const {
+        return mPositional;
+    }
+
+    size_t positionalCount() const {
+        return mPositionalCount;
+    }
+
+    PyObject* positional(size_t k) const {
+        return mPositional[k];
+    }
+
+    bool hasKeywords() const {
+        return (mKwargs && PyDict_GET_SIZE(mKwargs)) || (mKwnames && PyTuple_GET_SIZE(mKwnames));
+    }
+
+    // call 'f(name, value)' for each keyword argument
+    template<class func_type>
+    void forEachKeyword(const func_type& f) const {
+        if (mKwargs) {
+            PyObject *key, *value;
+            Py_ssize_t pos = 0;
+
+            while (PyDict_Next(mKwargs, &pos, &key, &value)) {
+                f(key, value);
+            }
+        }
+
+        if (mKwnames) {
+            for (long k = 0; k < PyTuple_GET_SIZE(mKwnames); k++) {
+                f(PyTuple_GET_ITEM(mKwnames, k), mPositional[mPositionalCount + k]);
+            }
+        }
+    }
+
+    // the positional arguments as a new tuple
+    PyObject* buildTuple() const {
+        PyObject* res = PyTuple_New(mPositionalCount);
+
+        for (size_t k = 0; k < mPositionalCount; k++) {
+            PyTuple_SetItem(res, k, incref(mPositional[k]));
+        }
+
+        return res;
+    }
+
+    // the keyword arguments as a new dict, or nullptr if there aren't any
+    PyObject* buildKwargs() const {
+        if (mKwargs) {
+            return incref(mKwargs);
+        }
+
+        if (!mKwnames) {
+            return nullptr;
+        }
+
+        PyObject* res = PyDict_New();
+
+        forEachKeyword([&](PyObject* name, PyObject* value) {
+            PyDict_SetItem(res, name, value);
+        });
+
+        return res;
+    }
+
+private:
+    PyObject* const* mPositional;
+
+    size_t mPositionalCount;
+
+    PyObject* mKwargs;
+
+    PyObject* mKwnames;
+};
+
 /*******
 Utility class for mapping arguments in a function call to args, keyword args, *args, and **kwargs
 in a python function signature.
@@ -212,27 +314,26 @@ public:
     }
 
     void pushArguments(PyObject* self, PyObject* args, PyObject* kwargs) {
+        pushArguments(self, CallArguments(args, kwargs));
+    }
+
+    void pushArguments(PyObject* self, const CallArguments& args) {
         if (self) {
             pushPositionalArg(self);
         }
 
-        for (long k = 0; k < PyTuple_Size(args); k++) {
-            pushPositionalArg(PyTuple_GetItem(args, k));
+        for (size_t k = 0; k < args.positionalCount(); k++) {
+            pushPositionalArg(args.positional(k));
         }
 
-        if (kwargs) {
-            PyObject *key, *value;
-            Py_ssize_t pos = 0;
-
-            while (PyDict_Next(kwargs, &pos, &key, &value)) {
-                if (!PyUnicode_Check(key)) {
-                    PyErr_SetString(PyExc_TypeError, "Keywords arguments must be strings.");
-                    throw PythonExceptionSet();
-                }
-
-                pushKeywordArg(PyUnicode_AsUTF8(key), value);
+        args.forEachKeyword([&](PyObject* key, PyObject* value) {
+            if (!PyUnicode_Check(key)) {
+                PyErr_SetString(PyExc_TypeError, "Keywords arguments must be strings.");
+                throw PythonExceptionSet();
             }
-        }
+
+            pushKeywordArg(PyUnicode_AsUTF8(key), value);
+        });
 
         finishedPushing();
     }
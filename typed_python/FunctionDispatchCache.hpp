@@ -0,0 +1,159 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <cstdint>
+#include <vector>
+
+/*********
+A polymorphic inline cache for calls from the interpreter into an Entrypoint.
+
+The full dispatch path tries each overload at each conversion level and then
+scans the overload's compiled specializations, which for a small function
+called in a loop costs more than the function body. When a call with only
+positional arguments matches at ConversionLevel::Signature, what it matches
+depends only on the exact types of the arguments (PyFunctionInstance checks
+that nothing in the signature depends on values), so we remember the
+overload and specialization it landed on, keyed on those exact types.
+
+A call that hits goes straight to that specialization, which still checks
+and converts each argument itself, and falls back to the full path if it
+refuses them. We keep at most MAX_ENTRIES keys; past that, a call site is
+megamorphic and we stop adding to it.
+*********/
+
+class FunctionDispatchCache {
+public:
+    static const size_t MAX_ENTRIES = 8;
+
+    class Entry {
+    public:
+        // the exact python types of the positional arguments. We hold a
+        // reference to each one, so its address can't be reused by a new type.
+        std::vector<PyTypeObject*> argTypes;
+
+        long overloadIx;
+
+        long specializationIx;
+    };
+
+    FunctionDispatchCache() :
+        mHits(0),
+        mMisses(0),
+        mCacheability(Cacheability::Unknown)
+    {
+    }
+
+    // the entry for positional arguments of exactly these types, or nullptr
+    const Entry* lookup(PyObject* const* args, size_t argCount) const {
+        for (auto& entry: mEntries) {
+            if (entry.argTypes.size() != argCount) {
+                continue;
+            }
+
+            bool matches = true;
+
+            for (size_t k = 0; k < argCount && matches; k++) {
+                matches = Py_TYPE(args[k]) == entry.argTypes[k];
+            }
+
+            if (matches) {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool isFull() const {
+        return mEntries.size() >= MAX_ENTRIES;
+    }
+
+    void insert(PyObject* const* args, size_t argCount, long overloadIx, long specializationIx) {
+        if (isFull() || lookup(args, argCount)) {
+            return;
+        }
+
+        Entry entry;
+        entry.overloadIx = overloadIx;
+        entry.specializationIx = specializationIx;
+
+        for (size_t k = 0; k < argCount; k++) {
+            PyTypeObject* argType = Py_TYPE(args[k]);
+            Py_INCREF((PyObject*)argType);
+            entry.argTypes.push_back(argType);
+        }
+
+        mEntries.push_back(entry);
+    }
+
+    // drop the entry for these argument types, if the specialization it
+    // points at turns out to refuse them.
+    void erase(const Entry* entry) {
+        for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+            if (&*it == entry) {
+                for (auto argType: it->argTypes) {
+                    Py_DECREF((PyObject*)argType);
+                }
+                mEntries.erase(it);
+                return;
+            }
+        }
+    }
+
+    size_t size() const {
+        return mEntries.size();
+    }
+
+    void recordHit() {
+        mHits++;
+    }
+
+    void recordMiss() {
+        mMisses++;
+    }
+
+    int64_t hits() const {
+        return mHits;
+    }
+
+    int64_t misses() const {
+        return mMisses;
+    }
+
+    // whether the function's signature allows caching at all, which only
+    // the function can work out, and which never changes.
+    enum class Cacheability { Unknown, Cacheable, Uncacheable };
+
+    Cacheability getCacheability() const {
+        return mCacheability;
+    }
+
+    void setCacheability(bool isCacheable) {
+        mCacheability = isCacheable ? Cacheability::Cacheable : Cacheability::Uncacheable;
+    }
+
+private:
+    std::vector<Entry> mEntries;
+
+    int64_t mHits;
+
+    int64_t mMisses;
+
+    Cacheability mCacheability;
+};
@@ -22,6 +22,7 @@
 #include "Format.hpp"
 #include "SpecialModuleNames.hpp"
 #include "PyInstance.hpp"
+#include "FunctionDispatchCache.hpp"
 
 class Function;
 
@@ -536,17 +537,61 @@ public:
         CompiledSpecialization(
                     compiled_code_entrypoint funcPtr,
                     Type* returnType,
-                    const std::vector<Type*>& argTypes
+                    const std::vector<Type*>& argTypes,
+                    int64_t hotAfterCalls = 0,
+                    PyObject* onHot = nullptr,
+                    bool releasesGilImmediately = false
                     ) :
             mFuncPtr(funcPtr),
             mReturnType(returnType),
-            mArgTypes(argTypes)
+            mArgTypes(argTypes),
+            mCallCount(0),
+            mHotAfterCalls(hotAfterCalls),
+            mOnHot(onHot ? PyObjectHolder(onHot) : PyObjectHolder()),
+            mReleasesGilImmediately(releasesGilImmediately)
         {}
 
         compiled_code_entrypoint getFuncPtr() const {
             return mFuncPtr;
         }
 
+        // a specialization compiled quickly at a low optimization level can ask to
+        // hear about it once it's been called 'hotAfterCalls' times, so that the
+        // runtime can build an optimized version and swap it in with 'replaceFuncPtr'.
+        bool canBeReplaced() const {
+            return mHotAfterCalls > 0;
+        }
+
+        // count a call. Must hold the GIL.
+        void countCall() const {
+            if (mHotAfterCalls <= 0) {
+                return;
+            }
+
+            if (++mCallCount != mHotAfterCalls || !mOnHot) {
+                return;
+            }
+
+            PyObject* res = PyObject_CallFunctionObjArgs((PyObject*)mOnHot, NULL);
+
+            if (!res) {
+                // the call itself can still go ahead
+                PyErr_WriteUnraisable((PyObject*)mOnHot);
+            } else {
+                decref(res);
+            }
+        }
+
+        int64_t getCallCount() const {
+            return mCallCount;
+        }
+
+        void replaceFuncPtr(compiled_code_entrypoint funcPtr) {
+            mFuncPtr = funcPtr;
+            mHotAfterCalls = 0;
+            mOnHot = PyObjectHolder();
+        }
+
         Type* getReturnType() const {
             return mReturnType;
         }
@@ -555,6 +600,12 @@ public:
             return mArgTypes;
         }
 
+        // true if the code was compiled 'nogil', so callers can drop the GIL
+        // as soon as they call it rather than waiting to see if it runs long.
+        bool releasesGilImmediately() const {
+            return mReleasesGilImmediately;
+        }
+
         bool operator==(const CompiledSpecialization& other) const {
             return mFuncPtr == other.mFuncPtr
                 && mReturnType == other.mReturnType
@@ -566,6 +617,12 @@ public:
         compiled_code_entrypoint mFuncPtr;
         Type* mReturnType;
         std::vector<Type*> mArgTypes;
+
+        mutable int64_t mCallCount;
+        int64_t mHotAfterCalls;
+        PyObjectHolder mOnHot;
+
+        bool mReleasesGilImmediately;
     };
 
     class Overload {
@@ -990,13 +1047,31 @@ public:
             return mCompiledSpecializations;
         }
 
-        void addCompiledSpecialization(compiled_code_entrypoint e, Type* returnType, const std::vector<Type*>& argTypes) {
-            CompiledSpecialization newSpec = CompiledSpecialization(e,returnType,argTypes);
+        void addCompiledSpecialization(
+            compiled_code_entrypoint e,
+            Type* returnType,
+            const std::vector<Type*>& argTypes,
+            int64_t hotAfterCalls = 0,
+            PyObject* onHot = nullptr,
+            bool releasesGilImmediately = false
+        ) {
+            CompiledSpecialization newSpec = CompiledSpecialization(
+                e, returnType, argTypes, hotAfterCalls, onHot, releasesGilImmediately
+            );
 
             for (auto& spec: mCompiledSpecializations) {
                 if (spec == newSpec) {
                     return;
                 }
+
+                // an optimized build of a specialization we're tiering up replaces
+                // it in place, so dispatch caches holding its index stay valid.
+                if (spec.canBeReplaced()
+                        && spec.getReturnType() == returnType
+                        && spec.getArgTypes() == argTypes) {
+                    spec.replaceFuncPtr(e);
+                    return;
+                }
             }
 
             mCompiledSpecializations.push_back(newSpec);
@@ -1658,7 +1733,7 @@ public:
         copy_constructor(dest, src);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         // we explicitly don't count functions
         return 0;
     }
@@ -1729,13 +1804,18 @@ public:
                     long whichOverload,
                     compiled_code_entrypoint entrypoint,
                     Type* returnType,
-                    const std::vector<Type*>& argTypes
+                    const std::vector<Type*>& argTypes,
+                    int64_t hotAfterCalls = 0,
+                    PyObject* onHot = nullptr,
+                    bool releasesGilImmediately = false
                     ) {
         if (whichOverload < 0 || whichOverload >= mOverloads.size()) {
             throw std::runtime_error("Invalid overload index.");
         }
 
-        mOverloads[whichOverload].addCompiledSpecialization(entrypoint, returnType, argTypes);
+        mOverloads[whichOverload].addCompiledSpecialization(
+            entrypoint, returnType, argTypes, hotAfterCalls, onHot, releasesGilImmediately
+        );
     }
 
     // a test function to force the compiled specialization table to change memory
@@ -1756,6 +1836,12 @@ public:
         return mIsNocompile;
     }
 
+    // the cache of which specialization calls from the interpreter land
+    // on. Dispatching doesn't change what the function is, so it's mutable.
+    FunctionDispatchCache& getDispatchCache() const {
+        return mDispatchCache;
+    }
+
     Function* withMethodOf(Type* methodOf) {
         bool anyDifferent = false;
         for (auto& o: mOverloads) {
@@ -1887,4 +1973,6 @@ private:
     bool mIsNocompile;
 
     std::string mRootName, mQualname, mModulename;
+
+    mutable FunctionDispatchCache mDispatchCache;
 };
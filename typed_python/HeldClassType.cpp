@@ -73,7 +73,10 @@ bool HeldClass::_updateAfterForwardTypesChanged() {
 
     size_t size = mBytesOfInitializationBits;
 
+    m_serialization_plan.clear();
+
     for (auto t: m_members) {
+        m_serialization_plan.addField(t.getType(), size, m_byte_offsets.size());
         m_byte_offsets.push_back(size);
         size += t.getType()->bytecount();
     }
@@ -82,6 +85,7 @@ bool HeldClass::_updateAfterForwardTypesChanged() {
 
     m_is_default_constructible = m_memberFunctions.find("__init__") == m_memberFunctions.end();
     m_size = size;
+    m_initial_image_built = false;
 
     return anyChanged;
 }
@@ -266,24 +270,68 @@ void HeldClass::setAttribute(instance_ptr self, int memberIndex, instance_ptr ot
     }
 }
 
+void HeldClass::buildInitialImage() {
+    std::lock_guard<std::mutex> lock(m_initial_image_mutex);
+
+    if (m_initial_image_built) {
+        return;
+    }
+
+    m_initial_image.clear();
+    m_initial_image.resize(m_size, 0);
+    m_members_to_construct.clear();
+
+    for (size_t k = 0; k < m_members.size(); k++) {
+        Type* member_t = m_members[k].getType();
+
+        bool hasDefault = memberHasDefaultValue(k);
+
+        if (!hasDefault && !wantsToDefaultConstruct(member_t) && !m_members[k].getIsNonempty()) {
+            continue;
+        }
+
+        if (member_t->isPOD()) {
+            // POD members hold no references, so the bytes of one initialized
+            // copy are good for every instance
+            if (hasDefault) {
+                member_t->copy_constructor(&m_initial_image[m_byte_offsets[k]], getMemberDefaultValue(k).data());
+            } else {
+                member_t->constructor(&m_initial_image[m_byte_offsets[k]]);
+            }
+
+            setInitializationFlag(&m_initial_image[0], k);
+        } else {
+            m_members_to_construct.push_back(std::make_pair((int)k, hasDefault));
+        }
+    }
+
+    m_initial_image_built = true;
+}
+
 void HeldClass::constructor(instance_ptr self, bool allowEmpty) {
     if (!m_is_default_constructible and !allowEmpty) {
         throw std::runtime_error(m_name + " is not default-constructible");
     }
 
-    for (size_t k = 0; k < m_members.size(); k++) {
+    if (!m_initial_image_built) {
+        buildInitialImage();
+    }
+
+    if (m_size) {
+        memcpy(self, &m_initial_image[0], m_size);
+    }
+
+    for (auto indexAndHasDefault: m_members_to_construct) {
+        int k = indexAndHasDefault.first;
         Type* member_t = m_members[k].getType();
 
-        if (memberHasDefaultValue(k)) {
+        if (indexAndHasDefault.second) {
             member_t->copy_constructor(self+m_byte_offsets[k], getMemberDefaultValue(k).data());
-            setInitializationFlag(self, k);
-        }
-        else if (wantsToDefaultConstruct(member_t) || m_members[k].getIsNonempty()) {
-            member_t->constructor(self+m_byte_offsets[k]);
-            setInitializationFlag(self, k);
         } else {
-            clearInitializationFlag(self, k);
+            member_t->constructor(self+m_byte_offsets[k]);
         }
+
+        setInitializationFlag(self, k);
     }
 }
 
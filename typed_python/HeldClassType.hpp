@@ -18,9 +18,12 @@
 
 #include "Type.hpp"
 #include "ReprAccumulator.hpp"
+#include "SerializationPlan.hpp"
 
 #include <unordered_set>
 #include <unordered_map>
+#include <atomic>
+#include <mutex>
 
 class HeldClass;
 class RefTo;
@@ -372,7 +375,8 @@ public:
             m_hasDelAttrMagicMethod(false),
             m_hasDelMagicMethod(false),
             m_hasConvertFromMagicMethod(false),
-            m_refToType(nullptr)
+            m_refToType(nullptr),
+            m_initial_image_built(false)
     {
         m_name = inName;
 
@@ -579,11 +583,11 @@ public:
         }
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         size_t res = 0;
 
         for (long k = 0; k < m_members.size(); k++) {
-            res += m_members[k].getType()->deepBytecount(eltPtr(instance, k), alreadyVisited, outSlabs);
+            res += m_members[k].getType()->deepBytecount(eltPtr(instance, k), context, outSlabs);
         }
 
         return res;
@@ -595,24 +599,37 @@ public:
             clearInitializationFlag(self, k);
         }
 
-        buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
-            if (fieldNumber < m_members.size()) {
-                getMemberType(fieldNumber)->deserialize(eltPtr(self,fieldNumber), buffer, subWireType);
-                setInitializationFlag(self, fieldNumber);
-            } else {
-                buffer.finishReadingMessageAndDiscard(subWireType);
+        try {
+            buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
+                if (fieldNumber < m_serialization_plan.size()) {
+                    if (checkInitializationFlag(self, fieldNumber)) {
+                        throw std::runtime_error("Corrupt data: field " + format(fieldNumber) + " of " + name() + " appears twice");
+                    }
+
+                    SerializationPlan::deserializeField(m_serialization_plan[fieldNumber], self, buffer, subWireType);
+                    setInitializationFlag(self, fieldNumber);
+                } else {
+                    buffer.finishReadingMessageAndDiscard(subWireType);
+                }
+            });
+        } catch(...) {
+            for (long k = 0; k < m_members.size(); k++) {
+                if (checkInitializationFlag(self, k)) {
+                    m_members[k].getType()->destroy(eltPtr(self, k));
+                    clearInitializationFlag(self, k);
+                }
             }
-        });
+            throw;
+        }
     }
 
     template<class buf_t>
     void serialize(instance_ptr self, buf_t& buffer, size_t fieldNumber) {
         buffer.writeBeginCompound(fieldNumber);
 
-        for (long k = 0; k < m_members.size();k++) {
-            bool isInitialized = checkInitializationFlag(self, k);
-            if (isInitialized) {
-                m_members[k].getType()->serialize(eltPtr(self,k),buffer, k);
+        for (long k = 0; k < m_serialization_plan.size(); k++) {
+            if (checkInitializationFlag(self, k)) {
+                SerializationPlan::serializeField(m_serialization_plan[k], self, buffer);
             }
         }
 
@@ -1082,6 +1099,9 @@ public:
 private:
     std::vector<size_t> m_byte_offsets;
 
+    // member k is serialized with field number k
+    SerializationPlan m_serialization_plan;
+
     std::vector<HeldClass*> m_bases;
 
     size_t mBytesOfInitializationBits;
@@ -1105,6 +1125,21 @@ private:
 
     std::vector<ClassDispatchTable> mClassDispatchTables;
 
+    // the bytes of a freshly default-constructed instance, with every POD member
+    // (and its initialization flag) already in place, so 'constructor' can start
+    // with one memcpy. Built the first time we construct an instance.
+    std::vector<uint8_t> m_initial_image;
+
+    // the members 'constructor' still has to construct after copying the image,
+    // as (member index, whether to copy its default value).
+    std::vector<std::pair<int, bool> > m_members_to_construct;
+
+    std::atomic<bool> m_initial_image_built;
+
+    std::mutex m_initial_image_mutex;
+
+    void buildInitialImage();
+
     //the members we
     std::vector<MemberDefinition> m_members;
 
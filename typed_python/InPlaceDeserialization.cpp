@@ -0,0 +1,467 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "ColumnarSerialization.hpp"
+#include "InPlaceDeserialization.hpp"
+
+namespace InPlaceDeserialization {
+
+namespace {
+
+typedef Type::TypeCategory TypeCategory;
+
+class Reader {
+public:
+    explicit Reader(DeserializationBuffer& buffer) : m_buffer(buffer) {
+    }
+
+    void read(Type* t, instance_ptr existing, size_t wireType) {
+        // there's nothing to reuse in a POD value, and nothing to destroy
+        // if we fail partway through it
+        if (t->isPOD()) {
+            t->deserialize(existing, m_buffer, wireType);
+            return;
+        }
+
+        switch (t->getTypeCategory()) {
+            case TypeCategory::catListOf:
+            case TypeCategory::catTupleOf:
+                readList((TupleOrListOfType*)t, existing, wireType);
+                return;
+            case TypeCategory::catDict:
+            case TypeCategory::catSet:
+                readHashTable(t, existing, wireType);
+                return;
+            case TypeCategory::catString:
+                readString((StringType*)t, existing, wireType);
+                return;
+            case TypeCategory::catBytes:
+                readBytes((BytesType*)t, existing, wireType);
+                return;
+            case TypeCategory::catTuple:
+            case TypeCategory::catNamedTuple:
+                readComposite((CompositeType*)t, existing, wireType);
+                return;
+            case TypeCategory::catOneOf:
+                readOneOf((OneOfType*)t, existing, wireType);
+                return;
+            default:
+                replace(t, existing, wireType);
+                return;
+        }
+    }
+
+private:
+    // deserialize a new 't' and assign it over 'existing'
+    void replace(Type* t, instance_ptr existing, size_t wireType) {
+        Instance fresh = Instance::createAndInitialize(t, [&](instance_ptr p) {
+            t->deserialize(p, m_buffer, wireType);
+        });
+
+        t->assign(existing, fresh.data());
+    }
+
+    // destroy the elements of 'existing' from 'count' on
+    void truncateList(TupleOrListOfType* t, instance_ptr existing, int64_t count) {
+        TupleOrListOfType::layout* l = *(TupleOrListOfType::layout**)existing;
+
+        if (count >= l->count) {
+            return;
+        }
+
+        if (!t->getEltType()->isPOD()) {
+            for (int64_t k = count; k < l->count; k++) {
+                t->getEltType()->destroy(t->eltPtr(existing, k));
+            }
+        }
+
+        l->count = count;
+    }
+
+    void readList(TupleOrListOfType* t, instance_ptr existing, size_t wireType) {
+        TupleOrListOfType::layout* l = *(TupleOrListOfType::layout**)existing;
+
+        if (!l || l->refcount != 1 || wireType == WireType::EMPTY) {
+            replace(t, existing, wireType);
+            return;
+        }
+
+        assertNonemptyCompoundWireType(wireType);
+
+        size_t id = 0;
+        if (t->isListOf()) {
+            id = m_buffer.readUnsignedVarintObject();
+
+            void* ptr = m_buffer.lookupCachedPointer(id);
+
+            if (ptr) {
+                t->destroy(existing);
+                *(TupleOrListOfType::layout**)existing = (TupleOrListOfType::layout*)ptr;
+                ((TupleOrListOfType::layout*)ptr)->refcount++;
+
+                m_buffer.finishCompoundMessage(wireType);
+                return;
+            }
+        }
+
+        auto fieldnumAndWireType = m_buffer.readFieldNumberAndWireType();
+        size_t fieldnum = fieldnumAndWireType.first;
+        size_t ct = m_buffer.readUnsignedVarint();
+
+        Type* eltT = t->getEltType();
+        size_t eltSize = eltT->bytecount();
+
+        l->hash_cache = -1;
+
+        if (t->isListOf()) {
+            m_buffer.addCachedPointer(id, l, t);
+            l->refcount++;
+        }
+
+        if (ct == 0) {
+            if (fieldnum != 0) {
+                throw std::runtime_error("Corrupt field num - empty list/tuple count should be 0");
+            }
+
+            truncateList(t, existing, 0);
+        } else if (fieldnum == 0) {
+            m_buffer.chargeAllocation(ct, eltSize);
+
+            truncateList(t, existing, ct);
+
+            if (l->reserved < (int64_t)ct) {
+                t->reserve(existing, ct);
+            }
+
+            for (int64_t k = 0; k < (int64_t)ct; k++) {
+                auto fieldAndWire = m_buffer.readFieldNumberAndWireType();
+                if (fieldAndWire.first) {
+                    throw std::runtime_error("Corrupt data (count)");
+                }
+                if (fieldAndWire.second == WireType::END_COMPOUND) {
+                    throw std::runtime_error("Corrupt data (count)");
+                }
+
+                if (k < l->count) {
+                    read(eltT, t->eltPtr(existing, k), fieldAndWire.second);
+                } else {
+                    eltT->deserialize(t->eltPtr(existing, k), m_buffer, fieldAndWire.second);
+                    l->count = k + 1;
+                }
+            }
+        } else if (fieldnum == 1 || fieldnum == 2) {
+            if (fieldnum == 1 && eltT->getTypeCategory() != TypeCategory::catInt64) {
+                throw std::runtime_error("Compressed intArray data data makes no sense for " + eltT->name());
+            }
+
+            if (fieldnum == 2 && (!eltT->isPOD() || !eltSize)) {
+                throw std::runtime_error("Compressed POD data makes no sense for " + eltT->name());
+            }
+
+            // int lists are written as a count, and POD lists as a bytecount
+            size_t eltCount = fieldnum == 1 ? ct : ct / eltSize;
+
+            if (fieldnum == 2 && eltCount * eltSize != ct) {
+                throw std::runtime_error("Invalid inline POD data - not a proper multiple");
+            }
+
+            m_buffer.chargeAllocation(eltCount, eltSize);
+
+            // the elements are POD, so any bytes are a valid value for them
+            if (l->reserved < (int64_t)eltCount) {
+                l->count = 0;
+                t->reserve(existing, eltCount);
+            }
+
+            l->count = eltCount;
+
+            if (fieldnum == 1) {
+                t->deserializeIntList((int64_t*)t->eltPtr(existing, 0), eltCount, m_buffer);
+            } else {
+                m_buffer.read_bytes(t->eltPtr(existing, 0), ct);
+            }
+        } else if (fieldnum == 3) {
+            const SerializationPlan* columns = ColumnarSerialization::planFor(eltT);
+
+            if (!columns) {
+                throw std::runtime_error("Columnar data makes no sense for " + eltT->name());
+            }
+
+            m_buffer.chargeAllocation(ct, eltSize);
+
+            // the columns are decoded into zeroed elements, which are safe to
+            // destroy however far we get through them.
+            truncateList(t, existing, 0);
+
+            if (l->reserved < (int64_t)ct) {
+                t->reserve(existing, ct);
+            }
+
+            memset(t->eltPtr(existing, 0), 0, ct * eltSize);
+            l->count = ct;
+
+            t->deserializeColumns(*columns, existing, ct, m_buffer);
+        } else {
+            throw std::runtime_error("Corrupt fieldnum for tuple/listof body");
+        }
+
+        m_buffer.finishCompoundMessage(wireType);
+    }
+
+    // Dicts and Sets, which share a layout and a wire format, except that a
+    // Dict writes a key and then a value for each entry
+    void readHashTable(Type* t, instance_ptr existing, size_t wireType) {
+        hash_table_layout* l = *(hash_table_layout**)existing;
+
+        if (!l || l->refcount != 1) {
+            replace(t, existing, wireType);
+            return;
+        }
+
+        bool isDict = t->getTypeCategory() == TypeCategory::catDict;
+
+        Type* keyT = isDict ? ((DictType*)t)->keyType() : ((SetType*)t)->keyType();
+        Type* valueT = isDict ? ((DictType*)t)->valueType() : nullptr;
+        size_t itemSize = isDict ? ((DictType*)t)->bytesPerKeyValuePair() : ((SetType*)t)->bytesPerElement();
+
+        size_t count = 0;
+        size_t id = 0;
+        size_t itemsRead = 0;
+        bool wasFromId = false;
+        bool cleared = false;
+
+        // the slot of the item we're reading, if we've read its key but haven't
+        // added it to the table yet, and whether we've read its value
+        int64_t pendingSlot = -1;
+        bool hasPendingValue = false;
+
+        auto addPendingItem = [&]() {
+            l->add(keyT->hash(l->items + itemSize * pendingSlot), pendingSlot);
+            pendingSlot = -1;
+            hasPendingValue = false;
+            itemsRead++;
+        };
+
+        try {
+            m_buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
+                [&](size_t fieldNumber, size_t subWireType) {
+                    if (fieldNumber == 0) {
+                        assertWireTypesEqual(subWireType, WireType::VARINT);
+                        id = m_buffer.readUnsignedVarint();
+
+                        void* ptr = m_buffer.lookupCachedPointer(id);
+
+                        if (ptr) {
+                            t->destroy(existing);
+                            *(hash_table_layout**)existing = (hash_table_layout*)ptr;
+                            ((hash_table_layout*)ptr)->refcount++;
+                            wasFromId = true;
+                        }
+                    } else if (wasFromId) {
+                        throw std::runtime_error("Corrupt " + t->name() + ": a memoized table has contents");
+                    } else if (fieldNumber == 1) {
+                        assertWireTypesEqual(subWireType, WireType::VARINT);
+                        count = m_buffer.readUnsignedVarint();
+
+                        m_buffer.chargeAllocation(count, itemSize);
+
+                        if (isDict) {
+                            ((DictType*)t)->clear(existing);
+                        } else {
+                            ((SetType*)t)->clear(existing);
+                        }
+                        cleared = true;
+
+                        m_buffer.addCachedPointer(id, l, t);
+                        l->refcount++;
+
+                        l->reserveForInsertion(itemSize, count);
+                    } else {
+                        if (!cleared) {
+                            throw std::runtime_error("Corrupt " + t->name() + ": entries before its count");
+                        }
+
+                        size_t itemIx = (fieldNumber - 2) / (isDict ? 2 : 1);
+                        bool isKey = !isDict || fieldNumber % 2 == 0;
+
+                        if (itemIx >= count) {
+                            throw std::runtime_error("Corrupt " + t->name() + ": more entries than its count");
+                        }
+
+                        if (isKey) {
+                            int64_t slot = l->allocateNewSlot(itemSize);
+                            keyT->deserialize(l->items + itemSize * slot, m_buffer, subWireType);
+                            pendingSlot = slot;
+
+                            if (!isDict) {
+                                addPendingItem();
+                            }
+                        } else {
+                            valueT->deserialize(
+                                l->items + itemSize * pendingSlot + keyT->bytecount(),
+                                m_buffer,
+                                subWireType
+                            );
+                            hasPendingValue = true;
+
+                            addPendingItem();
+                        }
+                    }
+            });
+
+            if (!wasFromId && (!cleared || itemsRead != count || pendingSlot != -1)) {
+                throw std::runtime_error("Invalid " + t->name() + " found.");
+            }
+        } catch(...) {
+            if (pendingSlot != -1) {
+                keyT->destroy(l->items + itemSize * pendingSlot);
+
+                if (hasPendingValue) {
+                    valueT->destroy(l->items + itemSize * pendingSlot + keyT->bytecount());
+                }
+            }
+
+            throw;
+        }
+    }
+
+    void readString(StringType* t, instance_ptr existing, size_t wireType) {
+        StringType::layout* l = *(StringType::layout**)existing;
+
+        // interned strings are shared with the intern table
+        if (!l || l->refcount != 1 || m_buffer.getContext().internStrings()) {
+            replace(t, existing, wireType);
+            return;
+        }
+
+        assertWireTypesEqual(wireType, WireType::BYTES);
+
+        int32_t ct = m_buffer.readUnsignedVarint();
+
+        m_buffer.read_bytes_fun(ct, [&](const uint8_t* bytes) {
+            if (!StringType::tryOverwriteFromUtf8Bytes(l, bytes, ct)) {
+                StringType::layout* fresh = StringType::createFromUtf8Bytes(bytes, ct);
+                t->destroy(existing);
+                *(StringType::layout**)existing = fresh;
+            }
+        });
+    }
+
+    void readBytes(BytesType* t, instance_ptr existing, size_t wireType) {
+        BytesType::layout* l = *(BytesType::layout**)existing;
+
+        if (!l || l->refcount != 1) {
+            replace(t, existing, wireType);
+            return;
+        }
+
+        if (wireType != WireType::BYTES) {
+            throw std::runtime_error("Corrupt data (expected BYTES wire type)");
+        }
+
+        size_t ct = m_buffer.readUnsignedVarint();
+
+        if (!m_buffer.canConsume(ct)) {
+            throw std::runtime_error("Corrupt data (not enough data in the stream)");
+        }
+
+        if (ct && ct <= (size_t)l->bytecount) {
+            m_buffer.read_bytes(l->data, ct);
+            l->bytecount = ct;
+            l->hash_cache = -1;
+            return;
+        }
+
+        t->destroy(existing);
+        t->constructor(existing, ct, nullptr);
+
+        if (ct) {
+            m_buffer.read_bytes(t->eltPtr(existing, 0), ct);
+        }
+    }
+
+    void readComposite(CompositeType* t, instance_ptr existing, size_t wireType) {
+        const std::vector<Type*>& types = t->getTypes();
+        std::vector<bool> seen(types.size(), false);
+
+        m_buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
+            if (fieldNumber < types.size()) {
+                if (seen[fieldNumber]) {
+                    throw std::runtime_error(
+                        "Corrupt data: field " + format(fieldNumber) + " of " + t->name() + " appears twice"
+                    );
+                }
+
+                read(types[fieldNumber], t->eltPtr(existing, fieldNumber), subWireType);
+                seen[fieldNumber] = true;
+            } else {
+                m_buffer.finishReadingMessageAndDiscard(subWireType);
+            }
+        });
+
+        // fields that are not mentioned are default-initialized
+        for (long k = 0; k < types.size(); k++) {
+            if (!seen[k]) {
+                types[k]->destroy(t->eltPtr(existing, k));
+                types[k]->constructor(t->eltPtr(existing, k));
+            }
+        }
+    }
+
+    void readOneOf(OneOfType* t, instance_ptr existing, size_t wireType) {
+        bool hitOne = false;
+
+        m_buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
+            if (hitOne) {
+                throw std::runtime_error("Corrupt OneOf had multiple fields.");
+            }
+
+            if (fieldNumber < t->getTypes().size()) {
+                Type* eltT = t->getTypes()[fieldNumber];
+
+                if (fieldNumber == t->whichIndex(existing)) {
+                    read(eltT, t->eltPtr(existing), subWireType);
+                } else {
+                    Instance fresh = Instance::createAndInitialize(eltT, [&](instance_ptr p) {
+                        eltT->deserialize(p, m_buffer, subWireType);
+                    });
+
+                    t->destroy(existing);
+                    eltT->copy_constructor(t->eltPtr(existing), fresh.data());
+                    t->setWhichIndex(existing, fieldNumber);
+                }
+
+                hitOne = true;
+            }
+        });
+
+        if (!hitOne) {
+            t->destroy(existing);
+            t->constructor(existing);
+        }
+    }
+
+    DeserializationBuffer& m_buffer;
+};
+
+} // end anonymous namespace
+
+void deserialize(Type* t, instance_ptr existing, DeserializationBuffer& buffer, size_t wireType) {
+    Reader(buffer).read(t, existing, wireType);
+}
+
+} // end namespace InPlaceDeserialization
@@ -0,0 +1,54 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include "DeserializationBuffer.hpp"
+
+/*********
+Deserialize over an existing value, reusing the storage it already has, for
+consumers that decode a stream of messages of the same type and would
+otherwise allocate a fresh copy of every container in every message.
+
+We read exactly what 'deserialize' reads, but wherever the existing value
+holds a container that nothing else refers to (its refcount is 1), we fill
+it in place rather than building a new one:
+
+    ListOf, TupleOf  we keep the element buffer, growing it if it's too small,
+                     and deserialize each element over the one that was there
+    Dict, Set        we clear the table, keeping its item and hashtable
+                     arrays, and insert the new entries into it
+    str, bytes       we overwrite the data if the new value fits in the old one
+    Tuple, NamedTuple, OneOf
+                     we deserialize each part over the part that was there, if
+                     the OneOf holds the same type as before
+
+Since nothing else can see a container whose refcount is 1 except through
+the value we're overwriting, this behaves exactly like replacing it. Anything
+else (shared containers, Class instances, python objects, ...) is deserialized
+as usual and assigned over the old part.
+
+If deserialization fails, the existing value is still a valid value of its
+type, but what it holds is unspecified.
+*********/
+
+namespace InPlaceDeserialization {
+
+// read a 't' with the given wire type out of 'buffer' into the 't' already at 'existing'
+void deserialize(Type* t, instance_ptr existing, DeserializationBuffer& buffer, size_t wireType);
+
+} // end namespace InPlaceDeserialization
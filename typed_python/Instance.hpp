@@ -63,7 +63,7 @@ class Instance {
 private:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         Type* type;
         uint8_t data[];
     };
@@ -103,7 +103,12 @@ public:
 
         t->assertForwardsResolvedSufficientlyToInstantiate();
 
-        layout* l = (layout*)tp_malloc(sizeof(layout) + t->bytecount());
+        layout* l;
+
+        {
+            TpAllocationTypeScope allocatingA(t);
+            l = (layout*)tp_malloc(sizeof(layout) + t->bytecount());
+        }
 
         try {
             initFun(l->data);
@@ -0,0 +1,1085 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "AllTypes.hpp"
+#include "JsonCodec.hpp"
+#include "NumberFormatting.hpp"
+#include "NumberParsing.hpp"
+#include "Unicode.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace JsonCodec {
+
+namespace {
+
+typedef Type::TypeCategory TypeCategory;
+
+// the width in bits of an int category, or 0 if 'cat' isn't an int
+int intBits(TypeCategory cat) {
+    switch (cat) {
+        case TypeCategory::catInt8: case TypeCategory::catUInt8: return 8;
+        case TypeCategory::catInt16: case TypeCategory::catUInt16: return 16;
+        case TypeCategory::catInt32: case TypeCategory::catUInt32: return 32;
+        case TypeCategory::catInt64: case TypeCategory::catUInt64: return 64;
+        default: return 0;
+    }
+}
+
+bool isUnsignedInt(TypeCategory cat) {
+    return cat == TypeCategory::catUInt8 || cat == TypeCategory::catUInt16
+        || cat == TypeCategory::catUInt32 || cat == TypeCategory::catUInt64;
+}
+
+bool isFloat(TypeCategory cat) {
+    return cat == TypeCategory::catFloat32 || cat == TypeCategory::catFloat64;
+}
+
+int64_t loadSigned(TypeCategory cat, instance_ptr p) {
+    switch (cat) {
+        case TypeCategory::catInt8: return *(int8_t*)p;
+        case TypeCategory::catInt16: return *(int16_t*)p;
+        case TypeCategory::catInt32: return *(int32_t*)p;
+        default: return *(int64_t*)p;
+    }
+}
+
+uint64_t loadUnsigned(TypeCategory cat, instance_ptr p) {
+    switch (cat) {
+        case TypeCategory::catUInt8: return *(uint8_t*)p;
+        case TypeCategory::catUInt16: return *(uint16_t*)p;
+        case TypeCategory::catUInt32: return *(uint32_t*)p;
+        default: return *(uint64_t*)p;
+    }
+}
+
+/********* encoding *********/
+
+class Encoder {
+public:
+    explicit Encoder(std::string& out) : m_out(out) {
+    }
+
+    void encode(Type* t, instance_ptr p) {
+        TypeCategory cat = t->getTypeCategory();
+
+        if (intBits(cat)) {
+            char buf[NumberFormatting::MAX_INT64_CHARS];
+
+            if (isUnsignedInt(cat)) {
+                m_out.append(buf, NumberFormatting::formatUInt64(loadUnsigned(cat, p), buf));
+            } else {
+                m_out.append(buf, NumberFormatting::formatInt64(loadSigned(cat, p), buf));
+            }
+            return;
+        }
+
+        switch (cat) {
+            case TypeCategory::catNone:
+                m_out.append("null");
+                return;
+            case TypeCategory::catBool:
+                m_out.append(*(bool*)p ? "true" : "false");
+                return;
+            case TypeCategory::catFloat32:
+                encodeFloat(*(float*)p);
+                return;
+            case TypeCategory::catFloat64:
+                encodeFloat(*(double*)p);
+                return;
+            case TypeCategory::catString:
+                encodeString(p);
+                return;
+            case TypeCategory::catOneOf: {
+                std::pair<Type*, instance_ptr> which = ((OneOfType*)t)->unwrap(p);
+                encode(which.first, which.second);
+                return;
+            }
+            case TypeCategory::catListOf:
+            case TypeCategory::catTupleOf: {
+                TupleOrListOfType* tupT = (TupleOrListOfType*)t;
+                int64_t count = tupT->count(p);
+
+                m_out.push_back('[');
+                for (int64_t k = 0; k < count; k++) {
+                    if (k) {
+                        m_out.push_back(',');
+                    }
+                    encode(tupT->getEltType(), tupT->eltPtr(p, k));
+                }
+                m_out.push_back(']');
+                return;
+            }
+            case TypeCategory::catSet: {
+                SetType* setT = (SetType*)t;
+                bool first = true;
+
+                m_out.push_back('[');
+                for (int64_t k = setT->nextPopulatedSlot(p, 0); k < setT->slotCount(p); k = setT->nextPopulatedSlot(p, k + 1)) {
+                    if (!first) {
+                        m_out.push_back(',');
+                    }
+                    first = false;
+                    encode(setT->keyType(), setT->keyAtSlot(p, k));
+                }
+                m_out.push_back(']');
+                return;
+            }
+            case TypeCategory::catTuple: {
+                CompositeType* tupT = (CompositeType*)t;
+
+                m_out.push_back('[');
+                for (long k = 0; k < tupT->getTypes().size(); k++) {
+                    if (k) {
+                        m_out.push_back(',');
+                    }
+                    encode(tupT->getTypes()[k], tupT->eltPtr(p, k));
+                }
+                m_out.push_back(']');
+                return;
+            }
+            case TypeCategory::catNamedTuple: {
+                CompositeType* tupT = (CompositeType*)t;
+
+                m_out.push_back('{');
+                for (long k = 0; k < tupT->getTypes().size(); k++) {
+                    if (k) {
+                        m_out.push_back(',');
+                    }
+                    encodeKey(tupT->getNames()[k]);
+                    encode(tupT->getTypes()[k], tupT->eltPtr(p, k));
+                }
+                m_out.push_back('}');
+                return;
+            }
+            case TypeCategory::catDict: {
+                DictType* dictT = (DictType*)t;
+                bool first = true;
+
+                m_out.push_back('{');
+                for (int64_t k = dictT->nextPopulatedSlot(p, 0); k < dictT->slotCount(p); k = dictT->nextPopulatedSlot(p, k + 1)) {
+                    if (!first) {
+                        m_out.push_back(',');
+                    }
+                    first = false;
+                    encodeDictKey(dictT->keyType(), dictT->keyAtSlot(p, k));
+                    m_out.push_back(':');
+                    encode(dictT->valueType(), dictT->valueAtSlot(p, k));
+                }
+                m_out.push_back('}');
+                return;
+            }
+            default:
+                throw std::runtime_error("Can't encode " + t->name() + " as json");
+        }
+    }
+
+private:
+    void encodeFloat(double f) {
+        if (std::isnan(f)) {
+            m_out.append("NaN");
+        } else if (std::isinf(f)) {
+            m_out.append(f > 0 ? "Infinity" : "-Infinity");
+        } else {
+            char buf[NumberFormatting::MAX_FLOAT64_CHARS];
+            m_out.append(buf, NumberFormatting::formatFloat64(f, buf));
+        }
+    }
+
+    void encodeKey(const std::string& name) {
+        m_out.push_back('"');
+        encodeCodepoints((const uint8_t*)name.data(), name.size(), true);
+        m_out.append("\":");
+    }
+
+    void encodeDictKey(Type* keyType, instance_ptr p) {
+        if (keyType->getTypeCategory() == TypeCategory::catString) {
+            encodeString(p);
+        } else if (intBits(keyType->getTypeCategory())) {
+            m_out.push_back('"');
+            encode(keyType, p);
+            m_out.push_back('"');
+        } else {
+            throw std::runtime_error("Can't encode a Dict with " + keyType->name() + " keys as json");
+        }
+    }
+
+    void encodeString(instance_ptr p) {
+        StringType* strT = StringType::Make();
+        int64_t count = strT->count(p);
+
+        m_out.push_back('"');
+
+        if (count) {
+            switch (strT->bytes_per_codepoint(p)) {
+                case 1: encodeCodepoints((uint8_t*)strT->eltPtr(p, 0), count, false); break;
+                case 2: encodeCodepoints((uint16_t*)strT->eltPtr(p, 0), count, false); break;
+                default: encodeCodepoints((uint32_t*)strT->eltPtr(p, 0), count, false); break;
+            }
+        }
+
+        m_out.push_back('"');
+    }
+
+    // write the escaped body of a string. 'isUtf8' means the input is
+    // already utf8 bytes rather than codepoints, so bytes >= 0x80 pass through.
+    template<class T>
+    void encodeCodepoints(const T* codepoints, int64_t count, bool isUtf8) {
+        static const char hexDigits[] = "0123456789abcdef";
+
+        for (int64_t k = 0; k < count; k++) {
+            uint32_t c = codepoints[k];
+
+            if (c == '"' || c == '\\') {
+                m_out.push_back('\\');
+                m_out.push_back(c);
+            } else if (c < 0x20 || (!isUtf8 && c >= 0xD800 && c < 0xE000)) {
+                // control characters, and lone surrogates, which have no utf8 encoding
+                switch (c) {
+                    case '\n': m_out.append("\\n"); break;
+                    case '\r': m_out.append("\\r"); break;
+                    case '\t': m_out.append("\\t"); break;
+                    case '\b': m_out.append("\\b"); break;
+                    case '\f': m_out.append("\\f"); break;
+                    default: {
+                        char buf[6] = {
+                            '\\', 'u',
+                            hexDigits[(c >> 12) & 0xF], hexDigits[(c >> 8) & 0xF],
+                            hexDigits[(c >> 4) & 0xF], hexDigits[c & 0xF]
+                        };
+                        m_out.append(buf, 6);
+                    }
+                }
+            } else if (c < 0x80 || isUtf8) {
+                m_out.push_back(c);
+            } else {
+                uint8_t buf[4];
+                encodeUtf8(&c, 1, buf);
+                m_out.append((const char*)buf, bytesForUtf8Codepoint(c));
+            }
+        }
+    }
+
+    std::string& m_out;
+};
+
+/********* decoding *********/
+
+// the first quote, backslash or control character in [p, end), or 'end'
+inline const uint8_t* findStringSpecial(const uint8_t* p, const uint8_t* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            // v <= 0x1F, unsigned
+            _mm_cmpeq_epi8(_mm_max_epu8(v, lastControl), lastControl)
+        );
+
+        int mask = _mm_movemask_epi8(special);
+
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    while (p < end && *p != '"' && *p != '\\' && *p >= 0x20) {
+        p++;
+    }
+
+    return p;
+}
+
+int hexValue(uint8_t c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// a json number, located but not yet converted
+class Number {
+public:
+    const uint8_t* start;
+    size_t length;
+
+    // no fraction or exponent, and not NaN or Infinity
+    bool integral;
+    bool negative;
+
+    // for integral numbers, the absolute value, unless it overflowed
+    uint64_t magnitude;
+    bool overflow;
+};
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t bytecount) :
+        m_start(data),
+        m_p(data),
+        m_end(data + bytecount)
+    {
+    }
+
+    void decodeDocument(Type* t, instance_ptr out) {
+        skipSpace();
+        decode(t, out);
+        skipSpace();
+
+        if (m_p != m_end) {
+            t->destroy(out);
+            fail("unexpected data after the value");
+        }
+    }
+
+    // construct a 't' at 'out' from the value at m_p
+    void decode(Type* t, instance_ptr out) {
+        TypeCategory cat = t->getTypeCategory();
+
+        if (intBits(cat)) {
+            decodeInt(cat, out);
+            return;
+        }
+
+        switch (cat) {
+            case TypeCategory::catNone:
+                expectLiteral("null");
+                return;
+            case TypeCategory::catBool:
+                if (peek() == 't') {
+                    expectLiteral("true");
+                    *(bool*)out = true;
+                } else {
+                    expectLiteral("false");
+                    *(bool*)out = false;
+                }
+                return;
+            case TypeCategory::catFloat32:
+                *(float*)out = numberToDouble(parseNumber());
+                return;
+            case TypeCategory::catFloat64:
+                *(double*)out = numberToDouble(parseNumber());
+                return;
+            case TypeCategory::catString:
+                *(StringType::layout**)out = parseString();
+                return;
+            case TypeCategory::catOneOf:
+                decodeOneOf((OneOfType*)t, out);
+                return;
+            case TypeCategory::catListOf:
+            case TypeCategory::catTupleOf:
+                decodeList((TupleOrListOfType*)t, out);
+                return;
+            case TypeCategory::catSet:
+                decodeSet((SetType*)t, out);
+                return;
+            case TypeCategory::catTuple:
+                decodeTuple((CompositeType*)t, out);
+                return;
+            case TypeCategory::catNamedTuple:
+                decodeNamedTuple((CompositeType*)t, out);
+                return;
+            case TypeCategory::catDict:
+                decodeDict((DictType*)t, out);
+                return;
+            default:
+                throw std::runtime_error("Can't decode json into " + t->name());
+        }
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) {
+        throw std::runtime_error("Invalid json at byte " + std::to_string(m_p - m_start) + ": " + message);
+    }
+
+    uint8_t peek() {
+        if (m_p == m_end) {
+            fail("unexpected end of data");
+        }
+        return *m_p;
+    }
+
+    void skipSpace() {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) {
+            m_p++;
+        }
+    }
+
+    bool take(uint8_t c) {
+        if (m_p < m_end && *m_p == c) {
+            m_p++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(uint8_t c) {
+        if (!take(c)) {
+            fail(std::string("expected '") + (char)c + "'");
+        }
+    }
+
+    void expectLiteral(const char* literal) {
+        size_t len = strlen(literal);
+
+        if (m_end - m_p < (int64_t)len || memcmp(m_p, literal, len)) {
+            fail(std::string("expected ") + literal);
+        }
+
+        m_p += len;
+    }
+
+    /********* containers *********/
+
+    // call 'onElement' with m_p at each element of an array
+    template<class func_type>
+    void parseArray(const func_type& onElement) {
+        expect('[');
+        skipSpace();
+
+        if (take(']')) {
+            return;
+        }
+
+        while (true) {
+            skipSpace();
+            onElement();
+            skipSpace();
+
+            if (take(',')) {
+                continue;
+            }
+
+            expect(']');
+            return;
+        }
+    }
+
+    // call 'onMember(key, keyLength)' with m_p at each value of an object.
+    // 'key' is the utf8 of the key, valid until the next call.
+    template<class func_type>
+    void parseObject(const func_type& onMember) {
+        expect('{');
+        skipSpace();
+
+        if (take('}')) {
+            return;
+        }
+
+        while (true) {
+            skipSpace();
+
+            const uint8_t* key;
+            size_t keyLength;
+            parseRawString(key, keyLength);
+
+            skipSpace();
+            expect(':');
+            skipSpace();
+
+            onMember(key, keyLength);
+
+            skipSpace();
+
+            if (take(',')) {
+                continue;
+            }
+
+            expect('}');
+            return;
+        }
+    }
+
+    void decodeList(TupleOrListOfType* tupT, instance_ptr out) {
+        Type* eltType = tupT->getEltType();
+        size_t reserved = 0;
+        int64_t count = 0;
+
+        tupT->constructor(out);
+
+        try {
+            parseArray([&]() {
+                if (count == (int64_t)reserved) {
+                    reserved = TupleOrListOfType::grownReservation(reserved, count + 1);
+                    tupT->reserve(out, reserved);
+                }
+
+                decode(eltType, tupT->eltPtr(out, count));
+                count++;
+                tupT->setSizeUnsafe(out, count);
+            });
+        } catch(...) {
+            tupT->destroy(out);
+            throw;
+        }
+    }
+
+    void decodeSet(SetType* setT, instance_ptr out) {
+        Type* keyType = setT->keyType();
+        std::vector<uint8_t> key(keyType->bytecount());
+
+        setT->constructor(out);
+
+        try {
+            parseArray([&]() {
+                decode(keyType, key.data());
+
+                if (!setT->lookupKey(out, key.data())) {
+                    setT->insertKey(out, key.data());
+                }
+
+                keyType->destroy(key.data());
+            });
+        } catch(...) {
+            setT->destroy(out);
+            throw;
+        }
+    }
+
+    void decodeTuple(CompositeType* tupT, instance_ptr out) {
+        size_t fieldCount = tupT->getTypes().size();
+
+        expect('[');
+
+        tupT->constructor(out, [&](instance_ptr field, int64_t k) {
+            skipSpace();
+
+            if (k) {
+                expect(',');
+                skipSpace();
+            }
+
+            decode(tupT->getTypes()[k], field);
+        });
+
+        try {
+            skipSpace();
+
+            if (!take(']')) {
+                fail("expected an array of length " + std::to_string(fieldCount));
+            }
+        } catch(...) {
+            tupT->destroy(out);
+            throw;
+        }
+    }
+
+    void decodeNamedTuple(CompositeType* tupT, instance_ptr out) {
+        const std::vector<Type*>& types = tupT->getTypes();
+        std::vector<bool> present(types.size());
+
+        auto destroyPresent = [&]() {
+            for (long k = 0; k < types.size(); k++) {
+                if (present[k]) {
+                    types[k]->destroy(tupT->eltPtr(out, k));
+                }
+            }
+        };
+
+        try {
+            parseObject([&](const uint8_t* key, size_t keyLength) {
+                auto it = tupT->getNameToIndex().find(std::string((const char*)key, keyLength));
+
+                if (it == tupT->getNameToIndex().end()) {
+                    skipValue();
+                    return;
+                }
+
+                int k = it->second;
+
+                // the last of repeated keys wins, as with python's json
+                if (present[k]) {
+                    types[k]->destroy(tupT->eltPtr(out, k));
+                    present[k] = false;
+                }
+
+                decode(types[k], tupT->eltPtr(out, k));
+                present[k] = true;
+            });
+
+            for (long k = 0; k < types.size(); k++) {
+                if (!present[k]) {
+                    if (!types[k]->is_default_constructible()) {
+                        fail("missing field '" + tupT->getNames()[k] + "' of " + tupT->name());
+                    }
+
+                    types[k]->constructor(tupT->eltPtr(out, k));
+                    present[k] = true;
+                }
+            }
+        } catch(...) {
+            destroyPresent();
+            throw;
+        }
+    }
+
+    void decodeDict(DictType* dictT, instance_ptr out) {
+        Type* keyType = dictT->keyType();
+        Type* valueType = dictT->valueType();
+        TypeCategory keyCat = keyType->getTypeCategory();
+
+        if (keyCat != TypeCategory::catString && !intBits(keyCat)) {
+            throw std::runtime_error("Can't decode json into a Dict with " + keyType->name() + " keys");
+        }
+
+        std::vector<uint8_t> key(keyType->bytecount());
+
+        dictT->constructor(out);
+
+        try {
+            parseObject([&](const uint8_t* keyBytes, size_t keyLength) {
+                if (keyCat == TypeCategory::catString) {
+                    *(StringType::layout**)key.data() = makeString(keyBytes, keyLength);
+                } else {
+                    // int keys are written as their decimal strings
+                    Decoder keyDecoder(keyBytes, keyLength);
+                    keyDecoder.decodeDocument(keyType, key.data());
+                }
+
+                try {
+                    instance_ptr existing = dictT->lookupValueByKey(out, key.data());
+
+                    if (existing) {
+                        valueType->destroy(existing);
+                        try {
+                            decode(valueType, existing);
+                        } catch(...) {
+                            dictT->deleteKeyWithUninitializedValue(out, key.data());
+                            throw;
+                        }
+                    } else {
+                        instance_ptr value = dictT->insertKey(out, key.data());
+                        try {
+                            decode(valueType, value);
+                        } catch(...) {
+                            dictT->deleteKeyWithUninitializedValue(out, key.data());
+                            throw;
+                        }
+                    }
+                } catch(...) {
+                    keyType->destroy(key.data());
+                    throw;
+                }
+
+                keyType->destroy(key.data());
+            });
+        } catch(...) {
+            dictT->destroy(out);
+            throw;
+        }
+    }
+
+    // whether a json value starting with 'c' could decode as a 't'
+    static bool couldStartWith(Type* t, uint8_t c) {
+        TypeCategory cat = t->getTypeCategory();
+
+        if (intBits(cat) || isFloat(cat)) {
+            return c == '-' || (c >= '0' && c <= '9') || c == 'N' || c == 'I';
+        }
+
+        switch (cat) {
+            case TypeCategory::catNone: return c == 'n';
+            case TypeCategory::catBool: return c == 't' || c == 'f';
+            case TypeCategory::catString: return c == '"';
+            case TypeCategory::catListOf:
+            case TypeCategory::catTupleOf:
+            case TypeCategory::catSet:
+            case TypeCategory::catTuple:
+                return c == '[';
+            case TypeCategory::catNamedTuple:
+            case TypeCategory::catDict:
+                return c == '{';
+            default:
+                return false;
+        }
+    }
+
+    void decodeOneOf(OneOfType* oneOf, instance_ptr out) {
+        const std::vector<Type*>& types = oneOf->getTypes();
+        uint8_t c = peek();
+
+        // numbers go to the first int alternative if they're integral and
+        // fit, and otherwise to the first float
+        if (c == '-' || (c >= '0' && c <= '9') || c == 'N' || c == 'I') {
+            const uint8_t* start = m_p;
+            Number n = parseNumber();
+
+            for (bool wantInt: {true, false}) {
+                for (long k = 0; k < types.size(); k++) {
+                    TypeCategory cat = types[k]->getTypeCategory();
+
+                    if (wantInt ? !intBits(cat) : !isFloat(cat)) {
+                        continue;
+                    }
+
+                    if (wantInt && (!n.integral || !intFits(cat, n))) {
+                        continue;
+                    }
+
+                    m_p = start;
+                    decode(types[k], oneOf->eltPtr(out));
+                    oneOf->setWhichIndex(out, k);
+                    return;
+                }
+            }
+
+            m_p = start;
+            fail("a number doesn't fit " + oneOf->name());
+        }
+
+        // otherwise try each alternative that could start this way, in order
+        const uint8_t* start = m_p;
+        std::string firstError;
+
+        for (long k = 0; k < types.size(); k++) {
+            if (!couldStartWith(types[k], c)) {
+                continue;
+            }
+
+            try {
+                decode(types[k], oneOf->eltPtr(out));
+                oneOf->setWhichIndex(out, k);
+                return;
+            } catch(std::runtime_error& e) {
+                if (firstError.empty()) {
+                    firstError = e.what();
+                }
+                m_p = start;
+            }
+        }
+
+        if (!firstError.empty()) {
+            throw std::runtime_error(firstError);
+        }
+
+        fail("value doesn't match any type in " + oneOf->name());
+    }
+
+    /********* strings *********/
+
+    // parse the string at m_p, setting 'out' to its utf8, which is either in
+    // place in the document or, if it has escapes, in m_scratch.
+    void parseRawString(const uint8_t*& out, size_t& outLength) {
+        expect('"');
+
+        const uint8_t* begin = m_p;
+        m_p = findStringSpecial(m_p, m_end);
+
+        if (m_p < m_end && *m_p == '"') {
+            out = begin;
+            outLength = m_p - begin;
+            m_p++;
+            return;
+        }
+
+        m_scratch.assign((const char*)begin, m_p - begin);
+
+        while (true) {
+            if (m_p == m_end) {
+                fail("unterminated string");
+            }
+
+            uint8_t c = *m_p;
+
+            if (c == '"') {
+                m_p++;
+                out = (const uint8_t*)m_scratch.data();
+                outLength = m_scratch.size();
+                return;
+            }
+
+            if (c < 0x20) {
+                fail("control character in string");
+            }
+
+            if (c == '\\') {
+                parseEscape();
+            } else {
+                const uint8_t* run = m_p;
+                m_p = findStringSpecial(m_p, m_end);
+                m_scratch.append((const char*)run, m_p - run);
+            }
+        }
+    }
+
+    uint32_t parseHex4() {
+        if (m_end - m_p < 4) {
+            fail("truncated \\u escape");
+        }
+
+        uint32_t res = 0;
+
+        for (int i = 0; i < 4; i++) {
+            int v = hexValue(m_p[i]);
+            if (v < 0) {
+                fail("invalid \\u escape");
+            }
+            res = res * 16 + v;
+        }
+
+        m_p += 4;
+        return res;
+    }
+
+    void parseEscape() {
+        m_p++;
+
+        switch (peek()) {
+            case '"': m_scratch.push_back('"'); break;
+            case '\\': m_scratch.push_back('\\'); break;
+            case '/': m_scratch.push_back('/'); break;
+            case 'b': m_scratch.push_back('\b'); break;
+            case 'f': m_scratch.push_back('\f'); break;
+            case 'n': m_scratch.push_back('\n'); break;
+            case 'r': m_scratch.push_back('\r'); break;
+            case 't': m_scratch.push_back('\t'); break;
+            case 'u': {
+                m_p++;
+                uint32_t c = parseHex4();
+
+                // a surrogate pair. Lone surrogates are kept, as python does.
+                if (c >= 0xD800 && c < 0xDC00 && m_end - m_p >= 6 && m_p[0] == '\\' && m_p[1] == 'u') {
+                    const uint8_t* save = m_p;
+                    m_p += 2;
+                    uint32_t low = parseHex4();
+
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        m_p = save;
+                    }
+                }
+
+                uint8_t buf[4];
+                encodeUtf8(&c, 1, buf);
+                m_scratch.append((const char*)buf, bytesForUtf8Codepoint(c));
+                return;
+            }
+            default:
+                fail("invalid escape");
+        }
+
+        m_p++;
+    }
+
+    StringType::layout* makeString(const uint8_t* utf8, size_t length) {
+        StringType::layout* res;
+
+        if (!StringType::tryCreateFromUtf8Bytes(utf8, length, true, res)) {
+            fail("invalid utf8 in string");
+        }
+
+        return res;
+    }
+
+    StringType::layout* parseString() {
+        const uint8_t* utf8;
+        size_t length;
+
+        parseRawString(utf8, length);
+
+        return makeString(utf8, length);
+    }
+
+    /********* numbers *********/
+
+    Number parseNumber() {
+        Number n;
+        n.start = m_p;
+        n.integral = true;
+        n.negative = take('-');
+        n.magnitude = 0;
+        n.overflow = false;
+
+        if (m_p < m_end && (*m_p == 'N' || *m_p == 'I')) {
+            expectLiteral(*m_p == 'N' ? "NaN" : "Infinity");
+            n.integral = false;
+            n.length = m_p - n.start;
+            return n;
+        }
+
+        if (m_p == m_end || !NumberParsing::isDigit(*m_p)) {
+            fail("expected a value");
+        }
+
+        if (*m_p == '0') {
+            m_p++;
+        } else {
+            while (m_p < m_end && NumberParsing::isDigit(*m_p)) {
+                uint64_t digit = *m_p - '0';
+
+                if (n.magnitude > (UINT64_MAX - digit) / 10) {
+                    n.overflow = true;
+                }
+                n.magnitude = n.magnitude * 10 + digit;
+                m_p++;
+            }
+        }
+
+        if (take('.')) {
+            n.integral = false;
+            if (m_p == m_end || !NumberParsing::isDigit(*m_p)) {
+                fail("expected digits after '.'");
+            }
+            while (m_p < m_end && NumberParsing::isDigit(*m_p)) {
+                m_p++;
+            }
+        }
+
+        if (take('e') || take('E')) {
+            n.integral = false;
+            if (!take('+')) {
+                take('-');
+            }
+            if (m_p == m_end || !NumberParsing::isDigit(*m_p)) {
+                fail("expected digits in exponent");
+            }
+            while (m_p < m_end && NumberParsing::isDigit(*m_p)) {
+                m_p++;
+            }
+        }
+
+        n.length = m_p - n.start;
+        return n;
+    }
+
+    double numberToDouble(const Number& n) {
+        if (n.integral && !n.overflow) {
+            return n.negative ? -(double)n.magnitude : (double)n.magnitude;
+        }
+
+        if (n.length >= 3 && n.start[n.length - 1] == 'N') {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        if (n.start[n.length - 1] == 'y') {
+            return n.negative ? -INFINITY : INFINITY;
+        }
+
+        // json's number syntax is a subset of python's float syntax
+        double res;
+        if (!NumberParsing::parseFloat(n.start, n.length, res)) {
+            fail("invalid number");
+        }
+        return res;
+    }
+
+    static bool intFits(TypeCategory cat, const Number& n) {
+        if (n.overflow) {
+            return false;
+        }
+
+        int bits = intBits(cat);
+
+        if (isUnsignedInt(cat)) {
+            return (!n.negative || n.magnitude == 0)
+                && (bits == 64 || n.magnitude < (uint64_t(1) << bits));
+        }
+
+        return n.magnitude <= (uint64_t(1) << (bits - 1)) - (n.negative ? 0 : 1);
+    }
+
+    void decodeInt(TypeCategory cat, instance_ptr out) {
+        const uint8_t* start = m_p;
+        Number n = parseNumber();
+
+        if (!n.integral || !intFits(cat, n)) {
+            m_p = start;
+            fail(std::string("expected an integer that fits in ") + Type::categoryToString(cat));
+        }
+
+        if (isUnsignedInt(cat)) {
+            switch (cat) {
+                case TypeCategory::catUInt8: *(uint8_t*)out = n.magnitude; break;
+                case TypeCategory::catUInt16: *(uint16_t*)out = n.magnitude; break;
+                case TypeCategory::catUInt32: *(uint32_t*)out = n.magnitude; break;
+                default: *(uint64_t*)out = n.magnitude; break;
+            }
+            return;
+        }
+
+        // negate in unsigned arithmetic, so that the most negative value works
+        int64_t v = (int64_t)(n.negative ? 0 - n.magnitude : n.magnitude);
+
+        switch (cat) {
+            case TypeCategory::catInt8: *(int8_t*)out = v; break;
+            case TypeCategory::catInt16: *(int16_t*)out = v; break;
+            case TypeCategory::catInt32: *(int32_t*)out = v; break;
+            default: *(int64_t*)out = v; break;
+        }
+    }
+
+    void skipValue() {
+        switch (peek()) {
+            case '"': {
+                const uint8_t* s;
+                size_t len;
+                parseRawString(s, len);
+                return;
+            }
+            case '[':
+                parseArray([&]() { skipValue(); });
+                return;
+            case '{':
+                parseObject([&](const uint8_t*, size_t) { skipValue(); });
+                return;
+            case 't':
+                expectLiteral("true");
+                return;
+            case 'f':
+                expectLiteral("false");
+                return;
+            case 'n':
+                expectLiteral("null");
+                return;
+            default:
+                parseNumber();
+        }
+    }
+
+    const uint8_t* m_start;
+    const uint8_t* m_p;
+    const uint8_t* m_end;
+
+    // the unescaped text of the last string that had escapes
+    std::string m_scratch;
+};
+
+} // end anonymous namespace
+
+void encode(Type* t, instance_ptr value, std::string& out) {
+    Encoder(out).encode(t, value);
+}
+
+void decode(Type* t, const uint8_t* data, size_t bytecount, instance_ptr out) {
+    Decoder(data, bytecount).decodeDocument(t, out);
+}
+
+} // end namespace JsonCodec
@@ -0,0 +1,58 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include <string>
+
+/*********
+JSON encoding and decoding of typed values, driven by their Type, so that
+decoding goes straight into our layouts without building python dicts and
+lists first. Neither direction touches python objects, so callers can
+release the GIL around them.
+
+    None                  null
+    bool                  true / false
+    ints, floats          numbers. Decoding an int checks that the number
+                          is integral and fits. nan and +/-inf are written
+                          as NaN and +/-Infinity, as python's json does.
+    str                   strings, written as UTF-8 rather than \u escapes
+    ListOf, TupleOf, Set  arrays
+    Tuple                 arrays of exactly its length
+    NamedTuple            objects. Decoding ignores unknown keys and
+                          default-constructs missing fields.
+    Dict(K, V)            objects, for str keys, or int keys written as
+                          decimal strings
+    OneOf                 whichever alternative the value holds. Decoding
+                          picks the first alternative that fits the json
+                          value, preferring ints for integral numbers.
+
+Anything else (Class, Alternative, object, ...) raises.
+
+String scanning, which is where most JSON bytes are, looks for the closing
+quote 16 bytes at a time.
+*********/
+
+namespace JsonCodec {
+
+// append the json encoding of the 't' at 'value' to 'out'
+void encode(Type* t, instance_ptr value, std::string& out);
+
+// construct a 't' at 'out' from the json document in 'data'
+void decode(Type* t, const uint8_t* data, size_t bytecount, instance_ptr out);
+
+} // end namespace JsonCodec
@@ -1,20 +1,539 @@
 #include "Memory.hpp"
 #include "Slab.hpp"
 
+#include <cmath>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 static_assert(sizeof(Slab*) <= sizeof(std::max_align_t), "Can't fit a Slab* in the max_align_t?");
 
+namespace {
+
+const size_t SIZE_CLASS_GRANULARITY = sizeof(std::max_align_t);
+
+const size_t SIZE_CLASS_COUNT = TP_MAX_SIZE_CLASS_BYTES / SIZE_CLASS_GRANULARITY;
+
+// which size class an allocation of 's' bytes falls into. Only valid for
+// 0 < s <= TP_MAX_SIZE_CLASS_BYTES
+inline size_t sizeClassFor(size_t s) {
+    return (s - 1) / SIZE_CLASS_GRANULARITY;
+}
+
+// how many bytes (not counting the header) we actually ask malloc for
+// when the user requests 's'. Small allocations get rounded up to their
+// size class so that any block in a given class's free list can satisfy
+// any request in that class.
+inline size_t capacityFor(size_t s) {
+    if (s > TP_MAX_SIZE_CLASS_BYTES) {
+        return s;
+    }
+
+    return (sizeClassFor(s) + 1) * SIZE_CLASS_GRANULARITY;
+}
+
+class ThreadLocalAllocationCache;
+
+// all the per-thread caches that are alive, so that we can sum their byte
+// counts. Threads that exit fold their counts into 'retiredBytes'.
+std::mutex& liveCachesMutex() {
+    static std::mutex* res = new std::mutex();
+    return *res;
+}
+
+std::unordered_set<ThreadLocalAllocationCache*>& liveCaches() {
+    static std::unordered_set<ThreadLocalAllocationCache*>* res =
+        new std::unordered_set<ThreadLocalAllocationCache*>();
+    return *res;
+}
+
+std::atomic<int64_t>& retiredBytes() {
+    static std::atomic<int64_t> res;
+    return res;
+}
+
+// set once the current thread's cache has been destroyed, so that late frees
+// (from other thread_local destructors) go directly back to malloc.
+thread_local bool threadCacheTornDown = false;
+
+class ThreadLocalAllocationCache {
+public:
+    ThreadLocalAllocationCache() : mBytes(0) {
+        for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+            mFreeLists[i] = nullptr;
+            mFreeCounts[i] = 0;
+        }
+
+        std::lock_guard<std::mutex> lock(liveCachesMutex());
+        liveCaches().insert(this);
+    }
+
+    ~ThreadLocalAllocationCache() {
+        for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+            while (mFreeLists[i]) {
+                uint8_t* block = mFreeLists[i];
+                mFreeLists[i] = nextOf(block);
+                ::free(block);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(liveCachesMutex());
+        retiredBytes() += mBytes.load(std::memory_order_relaxed);
+        liveCaches().erase(this);
+
+        threadCacheTornDown = true;
+    }
+
+    // pop a cached block (including its header) for size class 'cls',
+    // or nullptr if none are available.
+    uint8_t* pop(size_t cls) {
+        uint8_t* block = mFreeLists[cls];
+
+        if (block) {
+            mFreeLists[cls] = nextOf(block);
+            mFreeCounts[cls]--;
+        }
+
+        return block;
+    }
+
+    // try to hold on to 'block' (including its header). Returns false
+    // if the class's free list is already full.
+    bool push(size_t cls, uint8_t* block) {
+        if (mFreeCounts[cls] >= TP_MAX_CACHED_BLOCKS_PER_SIZE_CLASS) {
+            return false;
+        }
+
+        nextOf(block) = mFreeLists[cls];
+        mFreeLists[cls] = block;
+        mFreeCounts[cls]++;
+
+        return true;
+    }
+
+    // only this thread writes to mBytes, so relaxed load/store is enough,
+    // and we avoid a locked instruction on every allocation.
+    void addBytes(int64_t delta) {
+        mBytes.store(mBytes.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    int64_t bytes() const {
+        return mBytes.load(std::memory_order_relaxed);
+    }
+
+private:
+    // free blocks store the 'next' link in the header word.
+    static uint8_t*& nextOf(uint8_t* block) {
+        return *(uint8_t**)block;
+    }
+
+    uint8_t* mFreeLists[SIZE_CLASS_COUNT];
+
+    size_t mFreeCounts[SIZE_CLASS_COUNT];
+
+    std::atomic<int64_t> mBytes;
+};
+
+// returns the current thread's cache, or nullptr if it's already been torn down.
+inline ThreadLocalAllocationCache* threadCache() {
+    if (threadCacheTornDown) {
+        return nullptr;
+    }
+
+    static thread_local ThreadLocalAllocationCache cache;
+
+    return &cache;
+}
+
+inline void addFreeStoreBytes(int64_t delta) {
+    ThreadLocalAllocationCache* cache = threadCache();
+
+    if (cache) {
+        cache->addBytes(delta);
+    } else {
+        retiredBytes() += delta;
+    }
+}
+
+// the arenas pushed on this thread, and the top of that stack, which
+// we keep separately so that tp_malloc only has to check one pointer.
+thread_local std::vector<Slab*> arenaStack;
+thread_local Slab* currentArena = nullptr;
+
+std::atomic<bool> hugePagesEnabled(false);
+
+// the mean number of bytes between allocation samples, or zero if we're not sampling
+std::atomic<int64_t> allocationSamplingInterval(0);
+
+// while sampling is off, threads look to see if it's been turned on this often
+const int64_t SAMPLING_OFF_RECHECK_BYTES = 64 * 1024 * 1024;
+
+std::mutex& samplesMutex() {
+    static std::mutex* res = new std::mutex();
+    return *res;
+}
+
+std::unordered_map<void*, TpAllocationSample>& liveSamples() {
+    static std::unordered_map<void*, TpAllocationSample>* res =
+        new std::unordered_map<void*, TpAllocationSample>();
+    return *res;
+}
+
+thread_local uint64_t samplingRandomState = 0;
+
+// the distance to the next sample point. Exponentially distributed, so that every
+// byte is equally likely to be sampled no matter how allocations line up.
+int64_t nextSampleDistance(int64_t interval) {
+    if (!samplingRandomState) {
+        samplingRandomState = (uint64_t)&samplingRandomState ^ 0x9E3779B97F4A7C15ULL;
+    }
+
+    // xorshift64
+    samplingRandomState ^= samplingRandomState << 13;
+    samplingRandomState ^= samplingRandomState >> 7;
+    samplingRandomState ^= samplingRandomState << 17;
+
+    // uniform in (0, 1]
+    double u = ((samplingRandomState >> 11) + 1) * (1.0 / 9007199254740992.0);
+
+    return (int64_t)(-std::log(u) * interval) + 1;
+}
+
+// if each byte is sampled with probability 1/interval, an allocation of 'bytes'
+// is sampled with probability 1 - exp(-bytes / interval), so each one we see
+// stands for 1 / that many bytes.
+double estimatedBytesForSample(size_t bytes, int64_t interval) {
+    if (interval <= 0) {
+        return bytes;
+    }
+
+    return bytes / (1.0 - std::exp(-(double)bytes / interval));
+}
+
+int64_t& headerOf(void* p) {
+    return *(int64_t*)((uint8_t*)p - sizeof(std::max_align_t));
+}
+
+// if the allocation at 'p' was sampled, clear the flag in its header and return true.
+bool clearSampledFlag(void* p) {
+    int64_t& header = headerOf(p);
+
+    if (header <= 0) {
+        if (-header & TP_SAMPLED_FREE_STORE_BIT) {
+            header = -(-header & ~TP_SAMPLED_FREE_STORE_BIT);
+            return true;
+        }
+
+        return false;
+    }
+
+    if (header & TP_SAMPLED_SLAB_BIT) {
+        header &= ~TP_SAMPLED_SLAB_BIT;
+        return true;
+    }
+
+    return false;
+}
+
+void setSampledFlag(void* p) {
+    int64_t& header = headerOf(p);
+
+    if (header <= 0) {
+        header = -(-header | TP_SAMPLED_FREE_STORE_BIT);
+    } else {
+        header |= TP_SAMPLED_SLAB_BIT;
+    }
+}
+
+bool isSampled(void* p) {
+    int64_t header = headerOf(p);
+
+    if (header <= 0) {
+        return -header & TP_SAMPLED_FREE_STORE_BIT;
+    }
+
+    return header & TP_SAMPLED_SLAB_BIT;
+}
+
+// 'oldPtr' was sampled and has been reallocated to 'newPtr'. The sample follows it,
+// so that a list we sampled stays attributed to its type as it grows.
+void moveSample(void* oldPtr, void* newPtr, size_t newBytes) {
+    std::lock_guard<std::mutex> lock(samplesMutex());
+
+    auto it = liveSamples().find(oldPtr);
+
+    if (it == liveSamples().end()) {
+        return;
+    }
+
+    TpAllocationSample sample = it->second;
+    liveSamples().erase(it);
+
+    sample.bytes = newBytes;
+    sample.estimatedBytes = estimatedBytesForSample(newBytes, allocationSamplingInterval.load());
+
+    liveSamples()[newPtr] = sample;
+}
+
+inline bool isLargeAllocation(size_t s) {
+    return s >= TP_LARGE_ALLOCATION_BYTES;
+}
+
+// a large allocation of 's' bytes is a block of 's + TP_LARGE_ALLOCATION_ALIGNMENT'
+// bytes whose data starts TP_LARGE_ALLOCATION_ALIGNMENT bytes in. On linux the block
+// is its own mapping, so it starts on a page.
+#if defined(__linux__)
+
+void adviseHugePages(void* block, size_t s) {
+#ifdef MADV_HUGEPAGE
+    if (hugePagesEnabled.load(std::memory_order_relaxed)) {
+        // purely advisory, so we don't care if the kernel says no
+        madvise(block, s + TP_LARGE_ALLOCATION_ALIGNMENT, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+uint8_t* allocateLargeBlock(size_t s) {
+    void* block = mmap(
+        nullptr,
+        s + TP_LARGE_ALLOCATION_ALIGNMENT,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+
+    if (block == MAP_FAILED) {
+        return nullptr;
+    }
+
+    adviseHugePages(block, s);
+
+    return (uint8_t*)block;
+}
+
+uint8_t* reallocateLargeBlock(uint8_t* block, size_t oldS, size_t newS) {
+    void* res = mremap(
+        block,
+        oldS + TP_LARGE_ALLOCATION_ALIGNMENT,
+        newS + TP_LARGE_ALLOCATION_ALIGNMENT,
+        MREMAP_MAYMOVE
+    );
+
+    if (res == MAP_FAILED) {
+        return nullptr;
+    }
+
+    adviseHugePages(res, newS);
+
+    return (uint8_t*)res;
+}
+
+void freeLargeBlock(uint8_t* block, size_t s) {
+    munmap(block, s + TP_LARGE_ALLOCATION_ALIGNMENT);
+}
+
+#else
+
+uint8_t* allocateLargeBlock(size_t s) {
+    void* block = nullptr;
+
+    if (posix_memalign(&block, TP_LARGE_ALLOCATION_ALIGNMENT, s + TP_LARGE_ALLOCATION_ALIGNMENT)) {
+        return nullptr;
+    }
+
+    return (uint8_t*)block;
+}
+
+uint8_t* reallocateLargeBlock(uint8_t* block, size_t oldS, size_t newS) {
+    uint8_t* res = allocateLargeBlock(newS);
+
+    if (res) {
+        memcpy(res, block, std::min(oldS, newS) + TP_LARGE_ALLOCATION_ALIGNMENT);
+        free(block);
+    }
+
+    return res;
+}
+
+void freeLargeBlock(uint8_t* block, size_t s) {
+    free(block);
+}
+
+#endif
+
+} // end anonymous namespace
+
+void tp_set_huge_pages(bool enabled) {
+    hugePagesEnabled.store(enabled);
+}
+
+bool tp_huge_pages() {
+    return hugePagesEnabled.load();
+}
+
+void tp_push_arena(size_t bytes) {
+    Slab* arena = new Slab(false, bytes);
+
+    arenaStack.push_back(arena);
+    currentArena = arena;
+}
+
+bool tp_pop_arena() {
+    if (!arenaStack.size()) {
+        return false;
+    }
+
+    Slab* arena = arenaStack.back();
+    arenaStack.pop_back();
+
+    currentArena = arenaStack.size() ? arenaStack.back() : nullptr;
+
+    // objects allocated in the arena hold their own references to it.
+    arena->decref();
+
+    return true;
+}
+
+size_t tp_arena_depth() {
+    return arenaStack.size();
+}
+
+thread_local int64_t tpBytesUntilNextSample = 0;
+
+thread_local Type* tpCurrentAllocationType = nullptr;
+
+void tp_set_allocation_sampling(int64_t bytesBetweenSamples) {
+    if (bytesBetweenSamples < 0) {
+        bytesBetweenSamples = 0;
+    }
+
+    allocationSamplingInterval.store(bytesBetweenSamples);
+
+    // other threads notice within SAMPLING_OFF_RECHECK_BYTES, but this one
+    // should start right away.
+    tpBytesUntilNextSample = bytesBetweenSamples ?
+        nextSampleDistance(bytesBetweenSamples) : SAMPLING_OFF_RECHECK_BYTES;
+}
+
+int64_t tp_allocation_sampling() {
+    return allocationSamplingInterval.load();
+}
+
+bool tpTakeSample(void* ptr, size_t bytes, Type* type, void* site) {
+    int64_t interval = allocationSamplingInterval.load(std::memory_order_relaxed);
+
+    if (interval <= 0) {
+        tpBytesUntilNextSample = SAMPLING_OFF_RECHECK_BYTES;
+        return false;
+    }
+
+    tpBytesUntilNextSample = nextSampleDistance(interval);
+
+    TpAllocationSample sample;
+    sample.type = type;
+    sample.bytes = bytes;
+    sample.estimatedBytes = estimatedBytesForSample(bytes, interval);
+    sample.site = site;
+
+    std::lock_guard<std::mutex> lock(samplesMutex());
+    liveSamples()[ptr] = sample;
+
+    return true;
+}
+
+void tpForgetSample(void* ptr) {
+    std::lock_guard<std::mutex> lock(samplesMutex());
+    liveSamples().erase(ptr);
+}
+
+std::vector<TpAllocationSample> tpLiveAllocationSamples() {
+    std::lock_guard<std::mutex> lock(samplesMutex());
+
+    std::vector<TpAllocationSample> res;
+    res.reserve(liveSamples().size());
+
+    for (auto& ptrAndSample: liveSamples()) {
+        res.push_back(ptrAndSample.second);
+    }
+
+    return res;
+}
+
+size_t tpBytesAllocatedOnFreeStore() {
+    std::lock_guard<std::mutex> lock(liveCachesMutex());
+
+    int64_t total = retiredBytes();
+
+    for (auto cachePtr: liveCaches()) {
+        total += cachePtr->bytes();
+    }
+
+    return total;
+}
+
 void* tp_malloc(size_t s) {
     if (s == 0) {
         return nullptr;
     }
 
-    uint8_t* m = (uint8_t*)malloc(s + sizeof(std::max_align_t));
+    if (currentArena) {
+        void* res = currentArena->tryAllocate(s, nullptr, __builtin_return_address(0));
+
+        if (res) {
+            return res;
+        }
+    }
+
+    if (isLargeAllocation(s)) {
+        uint8_t* block = allocateLargeBlock(s);
+
+        if (!block) {
+            return nullptr;
+        }
+
+        uint8_t* res = block + TP_LARGE_ALLOCATION_ALIGNMENT;
+
+        ((int64_t*)(res - sizeof(std::max_align_t)))[0] = -(int64_t)s;
+
+        addFreeStoreBytes(s + TP_LARGE_ALLOCATION_ALIGNMENT);
+
+        if (tpCountAllocationForSampling(s)
+                && tpTakeSample(res, s, tpCurrentAllocationType, __builtin_return_address(0))) {
+            setSampledFlag(res);
+        }
+
+        return res;
+    }
+
+    uint8_t* m = nullptr;
+
+    ThreadLocalAllocationCache* cache = threadCache();
+
+    if (cache && s <= TP_MAX_SIZE_CLASS_BYTES) {
+        m = cache->pop(sizeClassFor(s));
+    }
+
+    if (!m) {
+        m = (uint8_t*)malloc(capacityFor(s) + sizeof(std::max_align_t));
+    }
 
     ((int64_t*)m)[0] = -(int64_t)s;
 
-    tpBytesAllocatedOnFreeStore() += s + sizeof(std::max_align_t);
+    addFreeStoreBytes(s + sizeof(std::max_align_t));
+
+    if (tpCountAllocationForSampling(s)
+            && tpTakeSample(m + sizeof(std::max_align_t), s, tpCurrentAllocationType, __builtin_return_address(0))) {
+        setSampledFlag(m + sizeof(std::max_align_t));
+    }
 
     return m + sizeof(std::max_align_t);
 }
@@ -24,12 +543,33 @@ void tp_free(void* p) {
         return;
     }
 
+    if (clearSampledFlag(p)) {
+        tpForgetSample(p);
+    }
+
     uint8_t* m = (uint8_t*)p - sizeof(std::max_align_t);
 
     int64_t sizeOrSlab = ((int64_t*)m)[0];
 
     if (sizeOrSlab <= 0) {
-        tpBytesAllocatedOnFreeStore() += sizeOrSlab - sizeof(std::max_align_t);
+        size_t s = -sizeOrSlab;
+
+        if (isLargeAllocation(s)) {
+            addFreeStoreBytes(sizeOrSlab - (int64_t)TP_LARGE_ALLOCATION_ALIGNMENT);
+            freeLargeBlock((uint8_t*)p - TP_LARGE_ALLOCATION_ALIGNMENT, s);
+            return;
+        }
+
+        addFreeStoreBytes(sizeOrSlab - (int64_t)sizeof(std::max_align_t));
+
+        if (s && s <= TP_MAX_SIZE_CLASS_BYTES) {
+            ThreadLocalAllocationCache* cache = threadCache();
+
+            if (cache && cache->push(sizeClassFor(s), m)) {
+                return;
+            }
+        }
+
         free(m);
         return;
     }
@@ -38,24 +578,50 @@ void tp_free(void* p) {
     slab->free(p);
 }
 
-void* tp_realloc(void* p, size_t oldSize, size_t newSize) {
-    if (!p) {
-        return tp_malloc(newSize);
-    }
-
-    if (p && !newSize) {
-        tp_free(p);
-        return nullptr;
-    }
+namespace {
 
+void* reallocateIgnoringSamples(void* p, size_t oldSize, size_t newSize) {
     uint8_t* m = (uint8_t*)p - sizeof(std::max_align_t);
 
     int64_t sizeOrSlab = ((int64_t*)m)[0];
 
     if (sizeOrSlab <= 0) {
-        tpBytesAllocatedOnFreeStore() += (int64_t)newSize - (int64_t)oldSize;
+        size_t curSize = -sizeOrSlab;
+
+        if (isLargeAllocation(curSize) && isLargeAllocation(newSize)) {
+            uint8_t* block = reallocateLargeBlock((uint8_t*)p - TP_LARGE_ALLOCATION_ALIGNMENT, curSize, newSize);
 
-        uint8_t* res = (uint8_t*)realloc(m, newSize + sizeof(std::max_align_t));
+            if (!block) {
+                return nullptr;
+            }
+
+            uint8_t* res = block + TP_LARGE_ALLOCATION_ALIGNMENT;
+
+            ((int64_t*)(res - sizeof(std::max_align_t)))[0] = -(int64_t)newSize;
+
+            addFreeStoreBytes((int64_t)newSize - (int64_t)curSize);
+
+            return res;
+        }
+
+        if (isLargeAllocation(curSize) || isLargeAllocation(newSize)) {
+            // moving between malloc and a mapping of our own
+            void* newData = tp_malloc(newSize);
+            memcpy(newData, p, std::min(newSize, curSize));
+            tp_free(p);
+
+            return newData;
+        }
+
+        addFreeStoreBytes((int64_t)newSize - (int64_t)oldSize);
+
+        // if we're staying within the block's size class, there's nothing to move
+        if (capacityFor(-sizeOrSlab) == capacityFor(newSize)) {
+            *(int64_t*)m = -(int64_t)newSize;
+            return p;
+        }
+
+        uint8_t* res = (uint8_t*)realloc(m, capacityFor(newSize) + sizeof(std::max_align_t));
 
         *(int64_t*)res = -(int64_t)newSize;
 
@@ -63,6 +629,11 @@ void* tp_realloc(void* p, size_t oldSize, size_t newSize) {
     } else {
         Slab* slab = ((Slab**)m)[0];
 
+        // arena lists that are still growing are usually the last thing allocated
+        if (!slab->isFreeStore() && slab->tryReallocate(p, oldSize, newSize)) {
+            return p;
+        }
+
         void* newData = tp_malloc(newSize);
         memcpy(newData, m + sizeof(std::max_align_t), std::min(newSize, oldSize));
         slab->free(p);
@@ -70,3 +641,41 @@ void* tp_realloc(void* p, size_t oldSize, size_t newSize) {
         return newData;
     }
 }
+
+} // end anonymous namespace
+
+void* tp_realloc(void* p, size_t oldSize, size_t newSize) {
+    if (!p) {
+        return tp_malloc(newSize);
+    }
+
+    if (p && !newSize) {
+        tp_free(p);
+        return nullptr;
+    }
+
+    bool wasSampled = clearSampledFlag(p);
+
+    void* res = reallocateIgnoringSamples(p, oldSize, newSize);
+
+    if (!res) {
+        if (wasSampled) {
+            setSampledFlag(p);
+        }
+
+        return nullptr;
+    }
+
+    if (wasSampled) {
+        moveSample(p, res, newSize);
+        setSampledFlag(res);
+    } else if (newSize > oldSize
+            && !isSampled(res)
+            && tpCountAllocationForSampling(newSize - oldSize)
+            && tpTakeSample(res, newSize, tpCurrentAllocationType, __builtin_return_address(0))) {
+        // growing counts towards the next sample like any other allocation
+        setSampledFlag(res);
+    }
+
+    return res;
+}
@@ -30,10 +30,45 @@ The word can either be the bytecount of the allocation with the top bit set,
 indicating that this is a direct allocation from malloc, or it can be a pointer
 to a Slab object which we decref when the allocation is released.
 
+Small free-store allocations are rounded up to a size class (a multiple of
+max_align_t up to TP_MAX_SIZE_CLASS_BYTES). When they are released, we keep them
+on a per-thread free list rather than returning them to malloc, so that the
+next allocation of the same class on that thread is just a pointer pop.
+Byte counts are also tracked per-thread, and only summed when somebody
+asks for tpBytesAllocatedOnFreeStore().
+
+A thread may also push an 'arena' Slab using tp_push_arena. While it's
+active, tp_malloc bump-allocates out of the arena (falling back to the free
+store once the arena is full). Each such allocation holds a reference to
+the arena, so it's released as soon as the scope exits and the last object
+allocated inside of it is gone.
+
+Large free-store allocations (TP_LARGE_ALLOCATION_BYTES and up, which in practice
+means big ListOf buffers) skip malloc. We map them directly, so their data starts
+on a TP_LARGE_ALLOCATION_ALIGNMENT boundary (the header word sits just below it),
+and growing them remaps pages rather than copying. If tp_set_huge_pages(true) has
+been called, we also ask the kernel to back them with transparent huge pages.
+
+Allocations can also be sampled, to find out what's using memory in a process
+too big to track every allocation. tp_set_allocation_sampling(N) samples, on
+average, one allocation per N bytes allocated (each byte is equally likely to
+be picked, so large allocations are almost always sampled). For each sample we
+remember its size, its Type (if the caller set one with a
+TpAllocationTypeScope, or allocated through a typed Slab) and the address
+that called tp_malloc, which for compiled code is inside the compiled function.
+Sampled allocations are flagged in their header word (TP_SAMPLED_FREE_STORE_BIT
+in the size, TP_SAMPLED_SLAB_BIT in the Slab pointer), so freeing an allocation
+only has to look at the sample table if it was sampled. Allocations that
+aren't sampled cost one thread-local subtraction.
+
 ***************/
 
 #include <cstddef>
+#include <cstdint>
 #include <atomic>
+#include <vector>
+
+class Type;
 
 extern "C" {
 
@@ -41,13 +76,109 @@ void* tp_malloc(size_t bytes);
 void* tp_realloc(void* ptr, size_t oldBytes, size_t newBytes);
 void tp_free(void* ptr);
 
+// make a new arena of 'bytes' and direct this thread's tp_malloc calls into it
+void tp_push_arena(size_t bytes);
+
+// stop allocating into the most recently pushed arena on this thread.
+// returns false if there was no arena to pop.
+bool tp_pop_arena();
+
+// how many arenas are currently pushed on this thread
+size_t tp_arena_depth();
+
+// should large allocations made from now on ask for transparent huge pages?
+void tp_set_huge_pages(bool enabled);
+
+bool tp_huge_pages();
+
+// sample one allocation per 'bytesBetweenSamples' bytes allocated, on average.
+// zero turns sampling off. Samples already taken stay until they're freed.
+void tp_set_allocation_sampling(int64_t bytesBetweenSamples);
+
+int64_t tp_allocation_sampling();
+
 }
 
-inline std::atomic<size_t>& tpBytesAllocatedOnFreeStore() {
-   static std::atomic<size_t> allocatedCount;
-   return allocatedCount;
+// set in the header word of sampled allocations. Free-store headers hold the
+// negated size, which is never this large; Slab pointers are at least 8-aligned.
+#define TP_SAMPLED_FREE_STORE_BIT ((int64_t)1 << 62)
+#define TP_SAMPLED_SLAB_BIT ((int64_t)1)
+
+// a live sampled allocation
+class TpAllocationSample {
+public:
+    // the Type we were allocating, or nullptr if we don't know
+    Type* type;
+
+    size_t bytes;
+
+    // our estimate of how many bytes of live allocations this sample stands for
+    double estimatedBytes;
+
+    // the return address of the call that allocated it
+    void* site;
+};
+
+// the sampled allocations that haven't been freed yet
+std::vector<TpAllocationSample> tpLiveAllocationSamples();
+
+// the number of bytes this thread can allocate before it takes its next sample
+extern thread_local int64_t tpBytesUntilNextSample;
+
+// the Type that allocations on this thread are attributed to, if any
+extern thread_local Type* tpCurrentAllocationType;
+
+// count an allocation of 'bytes' towards the next sample. Returns true if we
+// need to call 'tpTakeSample'.
+inline bool tpCountAllocationForSampling(size_t bytes) {
+    tpBytesUntilNextSample -= bytes;
+    return tpBytesUntilNextSample < 0;
 }
 
+// pick the next sample point, and if sampling is on, record 'ptr' as a sample.
+// Returns true if we recorded it, in which case the caller flags its header.
+bool tpTakeSample(void* ptr, size_t bytes, Type* type, void* site);
+
+// forget the sample for 'ptr', which is being freed
+void tpForgetSample(void* ptr);
+
+// attribute allocations made on this thread while this is alive to 't'.
+class TpAllocationTypeScope {
+public:
+    TpAllocationTypeScope(Type* t) : mPrior(tpCurrentAllocationType) {
+        tpCurrentAllocationType = t;
+    }
+
+    ~TpAllocationTypeScope() {
+        tpCurrentAllocationType = mPrior;
+    }
+
+private:
+    Type* mPrior;
+};
+
+// free-store allocations at least this big get their own aligned mapping
+#define TP_LARGE_ALLOCATION_BYTES (2 * 1024 * 1024)
+
+// where the data of a large allocation starts, relative to its mapping.
+// a cache line, so vector loads over it don't straddle lines.
+#define TP_LARGE_ALLOCATION_ALIGNMENT 64
+
+static_assert(
+   TP_LARGE_ALLOCATION_ALIGNMENT % sizeof(std::max_align_t) == 0,
+   "Large allocations need room for the header word"
+);
+
+// the largest allocation (not counting the header word) that we'll cache
+// in a thread-local size-class free list.
+#define TP_MAX_SIZE_CLASS_BYTES 512
+
+// the maximum number of free blocks we'll hold per size class per thread.
+#define TP_MAX_CACHED_BLOCKS_PER_SIZE_CLASS 256
+
+// total bytes currently allocated on the free store across all threads.
+size_t tpBytesAllocatedOnFreeStore();
+
 // how many bytes are required to back an allocation of size 's'
 // accounts for alignment and extra pointers.
 inline size_t bytesRequiredForAllocation(size_t s) {
@@ -55,6 +186,10 @@ inline size_t bytesRequiredForAllocation(size_t s) {
       return 0;
    }
 
+   if (s >= TP_LARGE_ALLOCATION_BYTES) {
+      return s + TP_LARGE_ALLOCATION_ALIGNMENT;
+   }
+
    if (s % sizeof(std::max_align_t)) {
       s += sizeof(std::max_align_t) - (s % sizeof(std::max_align_t));
    }
@@ -0,0 +1,256 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "NativeException.hpp"
+#include "PyInstance.hpp"
+#include <vector>
+
+namespace NativeException {
+
+namespace {
+
+struct TracebackEntry {
+    const char* funcname;
+    const char* filename;
+    int lineno;
+};
+
+// an exception type, its argument, and where it's been
+class Raised {
+public:
+    Raised() : mType(nullptr), mHasArg(false)
+    {
+    }
+
+    bool isSet() const {
+        return mType != nullptr;
+    }
+
+    PyObject* type() const {
+        return mType;
+    }
+
+    void set(PyObject* excType, Type* argType, instance_ptr arg) {
+        clear();
+
+        mType = incref(excType);
+
+        if (argType) {
+            mArg = Instance::create(argType, arg);
+            mHasArg = true;
+        }
+    }
+
+    void clear() {
+        if (mType) {
+            decref(mType);
+            mType = nullptr;
+        }
+
+        mArg = Instance();
+        mHasArg = false;
+        mTraceback.clear();
+    }
+
+    void addTraceback(const char* funcname, const char* filename, int lineno) {
+        mTraceback.push_back(TracebackEntry{funcname, filename, lineno});
+    }
+
+    void moveTo(Raised& other) {
+        other.clear();
+
+        other.mType = mType;
+        other.mArg = mArg;
+        other.mHasArg = mHasArg;
+        other.mTraceback.swap(mTraceback);
+
+        mType = nullptr;
+        clear();
+    }
+
+    // build the exception and set it in the error indicator, along with its
+    // traceback. If building it fails, that error is set instead.
+    void setError() const {
+        PyObjectStealer exc(buildException());
+
+        if (!exc) {
+            return;
+        }
+
+        PyErr_SetObject((PyObject*)exc->ob_type, exc);
+
+        for (auto& entry: mTraceback) {
+            _PyTraceback_Add(entry.funcname, entry.filename, entry.lineno);
+        }
+    }
+
+private:
+    PyObject* buildException() const {
+        if (!mHasArg) {
+            return PyObject_CallObject(mType, nullptr);
+        }
+
+        PyObjectStealer arg(PyInstance::extractPythonObject(mArg.data(), mArg.type()));
+
+        if (!arg) {
+            return nullptr;
+        }
+
+        return PyObject_CallFunctionObjArgs(mType, (PyObject*)arg, nullptr);
+    }
+
+    PyObject* mType;
+
+    Instance mArg;
+
+    bool mHasArg;
+
+    // innermost first
+    std::vector<TracebackEntry> mTraceback;
+};
+
+class ThreadState {
+public:
+    // raised, and not caught yet
+    Raised pending;
+
+    // caught by an 'except' that's still running
+    Raised handled;
+};
+
+// deliberately leaked, since a thread's destructors run without the GIL
+ThreadState& threadState() {
+    static thread_local ThreadState* state = new ThreadState();
+
+    return *state;
+}
+
+} // end anonymous namespace
+
+void raise(PyObject* excType, Type* argType, instance_ptr arg) {
+    ThreadState& state = threadState();
+
+    PyErr_Clear();
+
+    state.pending.set(excType, argType, arg);
+
+    // raised while handling another exception, it needs that one as its context,
+    // which python attaches when it sets the error
+    PyObject *handledType, *handledValue, *handledTraceback;
+    PyErr_GetExcInfo(&handledType, &handledValue, &handledTraceback);
+
+    bool isHandling = state.handled.isSet() || handledValue;
+
+    decref(handledType);
+    decref(handledValue);
+    decref(handledTraceback);
+
+    if (isHandling) {
+        materializeHandled();
+        materialize();
+    }
+}
+
+bool isPending() {
+    Raised& pending = threadState().pending;
+
+    if (!pending.isSet()) {
+        return false;
+    }
+
+    // something raised the usual way since, which supersedes us
+    if (PyErr_Occurred()) {
+        pending.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool pendingMatches(PyObject* excTypes) {
+    return isPending() && PyErr_GivenExceptionMatches(threadState().pending.type(), excTypes);
+}
+
+void addTraceback(const char* funcname, const char* filename, int lineno) {
+    threadState().pending.addTraceback(funcname, filename, lineno);
+}
+
+void catchPending() {
+    ThreadState& state = threadState();
+
+    state.pending.moveTo(state.handled);
+}
+
+bool reraiseHandled() {
+    ThreadState& state = threadState();
+
+    if (!state.handled.isSet()) {
+        return false;
+    }
+
+    PyErr_Clear();
+    state.handled.moveTo(state.pending);
+
+    return true;
+}
+
+void clearPending() {
+    threadState().pending.clear();
+}
+
+void clearHandled() {
+    threadState().handled.clear();
+}
+
+void materialize() {
+    if (!isPending()) {
+        return;
+    }
+
+    Raised& pending = threadState().pending;
+
+    pending.setError();
+    pending.clear();
+}
+
+void materializeHandled() {
+    Raised& handled = threadState().handled;
+
+    if (!handled.isSet()) {
+        return;
+    }
+
+    // keep whatever the error indicator holds now
+    PyObject *prevType, *prevValue, *prevTraceback;
+    PyErr_Fetch(&prevType, &prevValue, &prevTraceback);
+
+    handled.setError();
+    handled.clear();
+
+    PyObject *type, *value, *traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+    PyErr_NormalizeException(&type, &value, &traceback);
+
+    if (traceback) {
+        PyException_SetTraceback(value, traceback);
+    }
+
+    PyErr_SetExcInfo(type, value, traceback);
+
+    PyErr_Restore(prevType, prevValue, prevTraceback);
+}
+
+} // end namespace NativeException
@@ -0,0 +1,89 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include "Instance.hpp"
+
+/*********
+Exceptions raised by compiled code that haven't become python objects yet.
+
+Compiled code normally raises by building the exception object and setting
+the interpreter's error indicator, and catches by asking the interpreter
+whether that object matches, adding a traceback entry (a frame object) for
+every compiled function it unwinds through on the way. For code that uses
+exceptions for control flow, like a KeyError on a missed lookup, that's
+most of what the loop costs.
+
+So when compiled code raises one of the builtin exception types with at
+most one argument, we just remember the type and a copy of the typed
+argument in a slot belonging to the calling thread, and throw. Matching
+an 'except' clause compares types, a traceback entry is three pointers,
+an 'except' without 'as' keeps it as the exception being handled, and a
+bare 'raise' puts it back. We only make the exception object when someone
+needs it: 'except ... as e', a new exception raised while handling it
+(which needs it as its context), and the edge where the exception leaves
+compiled code for the interpreter, which calls 'materialize'. An exception
+raised while another is being handled gets made right away, for the same
+reason.
+
+The pending exception only counts while the interpreter's error
+indicator is clear. Anything that sets the indicator (a runtime function
+failing, say, while we unwind) supersedes it, exactly as it would have
+overwritten an exception set the usual way.
+
+A caught exception that nobody has asked for stays in the thread's slot
+as the exception being handled, rather than going into sys.exc_info(),
+until the handler finishes. Python code called from inside such a
+handler doesn't see it there.
+
+All of these need the GIL.
+*********/
+
+namespace NativeException {
+
+// raise 'excType' (a builtin exception type) with the given argument, or none
+// if 'argType' is null. Clears the error indicator.
+void raise(PyObject* excType, Type* argType, instance_ptr arg);
+
+// is there a raised exception the error indicator doesn't know about?
+bool isPending();
+
+// would 'except excTypes' catch the pending exception? 'excTypes' may be a tuple.
+bool pendingMatches(PyObject* excTypes);
+
+void addTraceback(const char* funcname, const char* filename, int lineno);
+
+// catch the pending exception, making it the one being handled
+void catchPending();
+
+// make the exception being handled pending again, for a bare 'raise' (which
+// is also how an exception leaves a try/finally). False if there isn't one.
+bool reraiseHandled();
+
+// forget the pending exception and the one being handled
+void clearPending();
+void clearHandled();
+
+// if there's a pending exception, set it in the error indicator. If building
+// it fails, that error is set instead.
+void materialize();
+
+// if there's an exception being handled, make it the interpreter's exc_info
+void materializeHandled();
+
+} // end namespace NativeException
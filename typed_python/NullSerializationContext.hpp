@@ -46,7 +46,22 @@ public:
     virtual bool isCompressionEnabled() const {
         return false;
     }
+    virtual int compressionLevel() const {
+        return 0;
+    }
     virtual bool isLineInfoSuppressed() const {
         return false;
     }
+    virtual bool internStrings() const {
+        return false;
+    }
+    virtual bool deserializeIntoSlab() const {
+        return false;
+    }
+    virtual bool serializeListsColumnar() const {
+        return false;
+    }
+    virtual int serializeThreadCount() const {
+        return 1;
+    }
 };
@@ -0,0 +1,358 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "RyuTables.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/*********
+Formatting of ints and floats as ASCII, directly into a caller's buffer,
+producing exactly what python's str() produces.
+
+'formatInt64' writes two digits per division, from a table of digit pairs,
+the way std::to_chars does.
+
+'formatFloat64' finds the shortest decimal that rounds back to the double
+with Ulf Adams' Ryu algorithm, and then lays it out the way float.__repr__
+does: positional notation for decimal exponents from -4 up to 16, and
+scientific notation outside of that.
+*********/
+
+namespace NumberFormatting {
+
+// the longest outputs: "-9223372036854775808" and "-2.2250738585072014e-308"
+const int MAX_INT64_CHARS = 20;
+const int MAX_FLOAT64_CHARS = 24;
+
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// the number of decimal digits in 'v'
+inline int decimalLength(uint64_t v) {
+    int len = 1;
+
+    while (v >= 10000) {
+        v /= 10000;
+        len += 4;
+    }
+
+    return len + (v >= 10) + (v >= 100) + (v >= 1000);
+}
+
+inline int formatUInt64(uint64_t v, char* out) {
+    int len = decimalLength(v);
+    char* p = out + len;
+
+    while (v >= 100) {
+        uint64_t q = v / 100;
+        p -= 2;
+        memcpy(p, digitPairs + 2 * (v - q * 100), 2);
+        v = q;
+    }
+
+    if (v >= 10) {
+        memcpy(p - 2, digitPairs + 2 * v, 2);
+    } else {
+        p[-1] = '0' + v;
+    }
+
+    return len;
+}
+
+inline int formatInt64(int64_t v, char* out) {
+    if (v < 0) {
+        *out = '-';
+        return 1 + formatUInt64(0 - (uint64_t)v, out + 1);
+    }
+
+    return formatUInt64(v, out);
+}
+
+/********* Ryu *********/
+
+const int DOUBLE_MANTISSA_BITS = 52;
+const int DOUBLE_BIAS = 1023;
+const int DOUBLE_POW5_INV_BITCOUNT = 125;
+const int DOUBLE_POW5_BITCOUNT = 125;
+
+// ceil(log2(5 ** e)), or 1 for e == 0
+inline int32_t pow5bits(int32_t e) {
+    return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2 ** e))
+inline uint32_t log10Pow2(int32_t e) {
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+// floor(log10(5 ** e))
+inline uint32_t log10Pow5(int32_t e) {
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+inline bool multipleOfPowerOf5(uint64_t value, uint32_t p) {
+    uint32_t count = 0;
+
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+
+    return count >= p;
+}
+
+inline bool multipleOfPowerOf2(uint64_t value, uint32_t p) {
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+// (m * mul) >> j, where 'mul' is a 128-bit {low, high} pair
+inline uint64_t mulShift64(uint64_t m, const uint64_t* mul, int32_t j) {
+    __uint128_t b0 = (__uint128_t)m * mul[0];
+    __uint128_t b2 = (__uint128_t)m * mul[1];
+
+    return (uint64_t)(((b0 >> 64) + b2) >> (j - 64));
+}
+
+// find the shortest 'digits * 10 ** exponent' that rounds to the finite,
+// nonzero double with the given bits. Of the candidates with that many
+// digits, picks the one nearest the double, breaking ties toward even.
+inline void shortestDecimal(uint64_t ieeeMantissa, uint32_t ieeeExponent, uint64_t& digits, int32_t& exponent) {
+    int32_t e2;
+    uint64_t m2;
+
+    if (ieeeExponent == 0) {
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieeeMantissa;
+    } else {
+        e2 = (int32_t)ieeeExponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (uint64_t(1) << DOUBLE_MANTISSA_BITS) | ieeeMantissa;
+    }
+
+    // the interval of reals that round to this double is closed when its
+    // mantissa is even
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    // the double is mv * 2 ** e2, and the halfway points to its neighbours
+    // are (mv + 2) and (mv - 1 - mmShift). The lower neighbour is closer
+    // at the bottom of a binade.
+    const uint64_t mv = 4 * m2;
+    const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+
+    if (e2 >= 0) {
+        const uint32_t q = log10Pow2(e2) - (e2 > 3);
+        const int32_t k = DOUBLE_POW5_INV_BITCOUNT + pow5bits(q) - 1;
+        const int32_t i = -e2 + (int32_t)q + k;
+
+        e10 = (int32_t)q;
+        vr = mulShift64(mv, doublePow5InvSplit[q], i);
+        vp = mulShift64(mv + 2, doublePow5InvSplit[q], i);
+        vm = mulShift64(mv - 1 - mmShift, doublePow5InvSplit[q], i);
+
+        if (q <= 21) {
+            // only one of mv, mv + 2 and mv - 1 - mmShift can be a multiple of 5
+            if (mv % 5 == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            } else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+            } else {
+                vp -= multipleOfPowerOf5(mv + 2, q);
+            }
+        }
+    } else {
+        const uint32_t q = log10Pow5(-e2) - (-e2 > 1);
+        const int32_t i = -e2 - (int32_t)q;
+        const int32_t k = pow5bits(i) - DOUBLE_POW5_BITCOUNT;
+        const int32_t j = (int32_t)q - k;
+
+        e10 = (int32_t)q + e2;
+        vr = mulShift64(mv, doublePow5Split[i], j);
+        vp = mulShift64(mv + 2, doublePow5Split[i], j);
+        vm = mulShift64(mv - 1 - mmShift, doublePow5Split[i], j);
+
+        if (q <= 1) {
+            // mv has at least q trailing zero bits, since it's a multiple of 4
+            vrIsTrailingZeros = true;
+
+            if (acceptBounds) {
+                vmIsTrailingZeros = mmShift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // drop digits while the interval [vm, vp] still holds a shorter decimal
+    int32_t removed = 0;
+    uint32_t lastRemovedDigit = 0;
+
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        // the rare case where we have to track exact halfway points
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+            // exactly halfway: round to even
+            lastRemovedDigit = 4;
+        }
+
+        digits = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    } else {
+        bool roundUp = false;
+
+        while (vp / 10 > vm / 10) {
+            roundUp = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        digits = vr + (vr == vm || roundUp);
+    }
+
+    exponent = e10 + removed;
+}
+
+// write repr(f) to 'out', which must have room for MAX_FLOAT64_CHARS,
+// returning the number of characters written.
+inline int formatFloat64(double f, char* out) {
+    uint64_t bits;
+    memcpy(&bits, &f, sizeof(double));
+
+    const uint64_t ieeeMantissa = bits & ((uint64_t(1) << DOUBLE_MANTISSA_BITS) - 1);
+    const uint32_t ieeeExponent = (uint32_t)((bits >> DOUBLE_MANTISSA_BITS) & 0x7FF);
+    const bool negative = bits >> 63;
+
+    if (ieeeExponent == 0x7FF) {
+        if (ieeeMantissa) {
+            memcpy(out, "nan", 3);
+            return 3;
+        }
+        if (negative) {
+            memcpy(out, "-inf", 4);
+            return 4;
+        }
+        memcpy(out, "inf", 3);
+        return 3;
+    }
+
+    char* p = out;
+
+    if (negative) {
+        *p++ = '-';
+    }
+
+    if (!ieeeExponent && !ieeeMantissa) {
+        memcpy(p, "0.0", 3);
+        return p + 3 - out;
+    }
+
+    uint64_t digits;
+    int32_t exponent;
+    shortestDecimal(ieeeMantissa, ieeeExponent, digits, exponent);
+
+    char digitChars[20];
+    int ndigits = formatUInt64(digits, digitChars);
+
+    // the position of the decimal point relative to the first digit
+    int decpt = ndigits + exponent;
+
+    if (decpt <= -4 || decpt > 16) {
+        *p++ = digitChars[0];
+
+        if (ndigits > 1) {
+            *p++ = '.';
+            memcpy(p, digitChars + 1, ndigits - 1);
+            p += ndigits - 1;
+        }
+
+        int e = decpt - 1;
+        *p++ = 'e';
+        *p++ = e < 0 ? '-' : '+';
+        if (e < 0) {
+            e = -e;
+        }
+
+        if (e >= 100) {
+            *p++ = '0' + e / 100;
+            e %= 100;
+        }
+
+        memcpy(p, digitPairs + 2 * e, 2);
+        p += 2;
+    } else if (decpt <= 0) {
+        memcpy(p, "0.", 2);
+        p += 2;
+        memset(p, '0', -decpt);
+        p += -decpt;
+        memcpy(p, digitChars, ndigits);
+        p += ndigits;
+    } else if (decpt >= ndigits) {
+        memcpy(p, digitChars, ndigits);
+        p += ndigits;
+        memset(p, '0', decpt - ndigits);
+        p += decpt - ndigits;
+        memcpy(p, ".0", 2);
+        p += 2;
+    } else {
+        memcpy(p, digitChars, decpt);
+        p += decpt;
+        *p++ = '.';
+        memcpy(p, digitChars + decpt, ndigits - decpt);
+        p += ndigits - decpt;
+    }
+
+    return p - out;
+}
+
+} // end namespace NumberFormatting
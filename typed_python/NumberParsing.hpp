@@ -0,0 +1,541 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "PowersOfFive.hpp"
+#include "UnicodeProps.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+/*********
+Parsing of int and float literals out of arrays of 1, 2 or 4 byte
+codepoints, accepting exactly the syntax python's int() and float()
+accept for ASCII digits: surrounding whitespace, an optional sign, and
+single underscores between digits.
+
+'parseFloat' splits the literal into a 64-bit decimal mantissa and a
+power of ten in one pass, and then converts it with Clinger's exact
+fast path when it applies, or the Eisel-Lemire algorithm otherwise (as
+in Daniel Lemire's fast_float). The rare literals that Eisel-Lemire
+can't round with certainty, such as those with more than 19 significant
+digits that fall near a halfway point, go to strtod.
+
+On little-endian machines, runs of ASCII digits are consumed eight at a
+time as a single 64-bit word.
+*********/
+
+namespace NumberParsing {
+
+// the most decimal digits that always fit in a uint64_t
+const int MAX_MANTISSA_DIGITS = 19;
+
+inline bool isSpace(uint32_t c) {
+    return unicodeProps(c) & Uprops_SPACE;
+}
+
+inline bool isDigit(uint32_t c) {
+    return c >= '0' && c <= '9';
+}
+
+// parse eight digits at 'p' in one go, if they're all ASCII digits
+template<class T>
+class EightDigits {
+public:
+    static bool parse(const T* p, uint32_t& value) {
+        return false;
+    }
+};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+template<>
+class EightDigits<uint8_t> {
+public:
+    static bool parse(const uint8_t* p, uint32_t& value) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+
+        // every byte is in 0x30-0x39 if its high nibble is 3, and adding 6 doesn't carry out of it
+        if (((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+                != 0x3333333333333333ULL) {
+            return false;
+        }
+
+        // combine adjacent digits into pairs, then the pairs into a single value
+        v -= 0x3030303030303030ULL;
+        v = (v * 10) + (v >> 8);
+        v = (((v & 0x000000FF000000FFULL) * 0x000F424000000064ULL)
+            + (((v >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32;
+
+        value = (uint32_t)v;
+        return true;
+    }
+};
+
+#endif
+
+// accumulates the significant digits of a decimal literal
+class Mantissa {
+public:
+    Mantissa() : value(0), digits(0), exponent(0), truncated(false) {
+    }
+
+    // the first MAX_MANTISSA_DIGITS significant digits
+    uint64_t value;
+
+    // the number of significant digits in 'value'
+    int digits;
+
+    // the literal is 'value * 10 ** exponent', give or take any truncated digits
+    int64_t exponent;
+
+    // were there nonzero digits that didn't fit in 'value'?
+    bool truncated;
+
+    void add(uint32_t digit, bool fraction) {
+        if (digits < MAX_MANTISSA_DIGITS) {
+            // leading zeros aren't significant, but they still shift the fraction
+            if (value || digit) {
+                value = value * 10 + digit;
+                digits++;
+            }
+            if (fraction) {
+                exponent--;
+            }
+        } else {
+            if (digit) {
+                truncated = true;
+            }
+            if (!fraction) {
+                exponent++;
+            }
+        }
+    }
+
+    bool canAddEight() const {
+        return digits && digits + 8 <= MAX_MANTISSA_DIGITS;
+    }
+
+    void addEight(uint32_t eight, bool fraction) {
+        value = value * 100000000 + eight;
+        digits += 8;
+        if (fraction) {
+            exponent -= 8;
+        }
+    }
+};
+
+// the parts of a float literal
+class Decimal {
+public:
+    Decimal() : negative(false), isInf(false), isNan(false) {
+    }
+
+    bool negative;
+    bool isInf;
+    bool isNan;
+    Mantissa mantissa;
+};
+
+template<class T>
+class Scanner {
+public:
+    Scanner(const T* data, int64_t count) : p(data), cur(0), end(count) {
+        while (cur < end && isSpace(p[cur])) {
+            cur++;
+        }
+        while (end > cur && isSpace(p[end - 1])) {
+            end--;
+        }
+    }
+
+    bool atEnd() const {
+        return cur == end;
+    }
+
+    bool take(uint32_t c) {
+        if (cur < end && p[cur] == c) {
+            cur++;
+            return true;
+        }
+        return false;
+    }
+
+    // consume an optional sign, returning true if it was '-'
+    bool takeSign() {
+        if (take('-')) {
+            return true;
+        }
+        take('+');
+        return false;
+    }
+
+    // if the underscore at 'cur' is between two digits, skip it. A digit run
+    // may only contain single underscores between digits.
+    bool skipUnderscore(int64_t digitsSoFar) {
+        if (digitsSoFar && cur + 1 < end && p[cur] == '_' && isDigit(p[cur + 1])) {
+            cur++;
+            return true;
+        }
+        return false;
+    }
+
+    bool atUnderscore() const {
+        return cur < end && p[cur] == '_';
+    }
+
+    // consume a run of digits into 'mantissa', returning the number of
+    // digits, or -1 if an underscore was out of place
+    int64_t digitRun(Mantissa& mantissa, bool fraction) {
+        int64_t count = 0;
+
+        while (true) {
+            uint32_t eight;
+            while (mantissa.canAddEight() && cur + 8 <= end && EightDigits<T>::parse(p + cur, eight)) {
+                mantissa.addEight(eight, fraction);
+                cur += 8;
+                count += 8;
+            }
+
+            if (cur < end && isDigit(p[cur])) {
+                mantissa.add(p[cur] - '0', fraction);
+                cur++;
+                count++;
+            } else if (!skipUnderscore(count)) {
+                return atUnderscore() ? -1 : count;
+            }
+        }
+    }
+
+    // consume a run of digits as an integer that wraps at 2**64, returning
+    // the number of digits, or -1 if an underscore was out of place
+    int64_t wrappingDigitRun(uint64_t& value) {
+        int64_t count = 0;
+
+        while (true) {
+            uint32_t eight;
+            while (cur + 8 <= end && EightDigits<T>::parse(p + cur, eight)) {
+                value = value * 100000000 + eight;
+                cur += 8;
+                count += 8;
+            }
+
+            if (cur < end && isDigit(p[cur])) {
+                value = value * 10 + (p[cur] - '0');
+                cur++;
+                count++;
+            } else if (!skipUnderscore(count)) {
+                return atUnderscore() ? -1 : count;
+            }
+        }
+    }
+
+    // does the rest of the input spell 'word', ignoring ASCII case?
+    bool restIsWord(const char* word) const {
+        int64_t len = strlen(word);
+
+        if (end - cur != len) {
+            return false;
+        }
+
+        for (int64_t i = 0; i < len; i++) {
+            uint32_t c = p[cur + i];
+            if (c >= 'A' && c <= 'Z') {
+                c += 'a' - 'A';
+            }
+            if (c != (uint8_t)word[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool parseDecimal(Decimal& out) {
+        out.negative = takeSign();
+
+        if (cur < end && !isDigit(p[cur]) && p[cur] != '.') {
+            out.isInf = restIsWord("inf") || restIsWord("infinity");
+            out.isNan = restIsWord("nan");
+            return out.isInf || out.isNan;
+        }
+
+        int64_t wholeDigits = digitRun(out.mantissa, false);
+        if (wholeDigits < 0) {
+            return false;
+        }
+
+        int64_t fractionDigits = 0;
+        if (take('.')) {
+            fractionDigits = digitRun(out.mantissa, true);
+            if (fractionDigits < 0) {
+                return false;
+            }
+        }
+
+        if (!wholeDigits && !fractionDigits) {
+            return false;
+        }
+
+        if (take('e') || take('E')) {
+            bool negativeExponent = takeSign();
+            int64_t exponent = 0;
+            int64_t exponentDigits = 0;
+
+            while (true) {
+                if (cur < end && isDigit(p[cur])) {
+                    // anything this large is already zero or infinity
+                    if (exponent < 100000000) {
+                        exponent = exponent * 10 + (p[cur] - '0');
+                    }
+                    cur++;
+                    exponentDigits++;
+                } else if (!skipUnderscore(exponentDigits)) {
+                    break;
+                }
+            }
+
+            if (!exponentDigits || atUnderscore()) {
+                return false;
+            }
+
+            out.mantissa.exponent += negativeExponent ? -exponent : exponent;
+        }
+
+        return atEnd();
+    }
+
+    bool parseInt(int64_t& out) {
+        bool negative = takeSign();
+        uint64_t value = 0;
+
+        if (wrappingDigitRun(value) <= 0 || !atEnd()) {
+            return false;
+        }
+
+        out = (int64_t)(negative ? 0 - value : value);
+        return true;
+    }
+
+    // the literal without its whitespace or underscores, as ASCII. Only
+    // valid once 'parseDecimal' has accepted it.
+    std::string cleanedLiteral(int64_t start, int64_t stop) const {
+        std::string res;
+        for (int64_t i = start; i < stop; i++) {
+            if (p[i] != '_') {
+                res.push_back((char)p[i]);
+            }
+        }
+        return res;
+    }
+
+    const T* p;
+    int64_t cur;
+    int64_t end;
+};
+
+inline void fullMultiplication(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+    __uint128_t res = (__uint128_t)a * b;
+    hi = (uint64_t)(res >> 64);
+    lo = (uint64_t)res;
+}
+
+// floor(log2(10 ** q)) + 63, for q in the range of our table
+inline int32_t binaryExponentOfPowerOfTen(int32_t q) {
+    return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+// compute the bits of the double nearest to 'w * 10 ** q', returning false
+// if we can't be sure of the rounding. This is fast_float's compute_float.
+inline bool eiselLemire(int64_t q, uint64_t w, uint64_t& bits) {
+    const int MANTISSA_BITS = 52;
+    const int MINIMUM_EXPONENT = -1023;
+    const int32_t INFINITE_POWER = 0x7FF;
+
+    if (w == 0 || q < SMALLEST_POWER_OF_FIVE) {
+        bits = 0;
+        return true;
+    }
+
+    if (q > LARGEST_POWER_OF_FIVE) {
+        bits = uint64_t(INFINITE_POWER) << MANTISSA_BITS;
+        return true;
+    }
+
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+
+    const uint64_t* power = powerOfFive128[q - SMALLEST_POWER_OF_FIVE];
+
+    uint64_t hi, lo;
+    fullMultiplication(w, power[0], hi, lo);
+
+    // we need the top 55 bits of the product to be exact. If the bits below
+    // them are all ones, a carry from the low half of the power could change them.
+    const uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFULL >> (MANTISSA_BITS + 3);
+    if ((hi & precisionMask) == precisionMask) {
+        uint64_t hi2, lo2;
+        fullMultiplication(w, power[1], hi2, lo2);
+        lo += hi2;
+        if (hi2 > lo) {
+            hi++;
+        }
+    }
+
+    if (lo == 0xFFFFFFFFFFFFFFFFULL && (q < -27 || q > 55)) {
+        return false;
+    }
+
+    int upperbit = int(hi >> 63);
+    int shift = upperbit + 64 - MANTISSA_BITS - 3;
+    uint64_t mantissa = hi >> shift;
+    int32_t power2 = binaryExponentOfPowerOfTen(int32_t(q)) + upperbit - lz - MINIMUM_EXPONENT;
+
+    if (power2 <= 0) {
+        // a subnormal, or zero
+        if (-power2 + 1 >= 64) {
+            bits = 0;
+            return true;
+        }
+
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+
+        // rounding up may have carried us into the normal range
+        power2 = (mantissa < (uint64_t(1) << MANTISSA_BITS)) ? 0 : 1;
+        bits = mantissa | (uint64_t(power2) << MANTISSA_BITS);
+        return true;
+    }
+
+    // we round up below, unless we're exactly halfway and even, which can
+    // only happen for small powers of ten.
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1) {
+        if ((mantissa << shift) == hi) {
+            mantissa &= ~uint64_t(1);
+        }
+    }
+
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+
+    if (mantissa >= (uint64_t(2) << MANTISSA_BITS)) {
+        mantissa = uint64_t(1) << MANTISSA_BITS;
+        power2++;
+    }
+
+    mantissa &= ~(uint64_t(1) << MANTISSA_BITS);
+
+    if (power2 >= INFINITE_POWER) {
+        bits = uint64_t(INFINITE_POWER) << MANTISSA_BITS;
+        return true;
+    }
+
+    bits = mantissa | (uint64_t(power2) << MANTISSA_BITS);
+    return true;
+}
+
+// convert a parsed literal to a double, returning false if only a full
+// arbitrary-precision conversion can round it correctly.
+inline bool decimalToDouble(const Decimal& d, double& out) {
+    static const double exactPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const Mantissa& m = d.mantissa;
+
+    // Clinger: both the mantissa and the power of ten are exact doubles, so
+    // a single multiply or divide rounds correctly.
+    if (!m.truncated && m.exponent >= -22 && m.exponent <= 22 && m.value <= (uint64_t(1) << 53)) {
+        double res = (double)m.value;
+
+        if (m.exponent < 0) {
+            res /= exactPowersOfTen[-m.exponent];
+        } else {
+            res *= exactPowersOfTen[m.exponent];
+        }
+
+        out = d.negative ? -res : res;
+        return true;
+    }
+
+    uint64_t bits;
+    if (!eiselLemire(m.exponent, m.value, bits)) {
+        return false;
+    }
+
+    // if we dropped digits, the true value lies between value and value + 1.
+    // If those round the same way, so does the literal.
+    if (m.truncated) {
+        uint64_t bitsAbove;
+        if (!eiselLemire(m.exponent, m.value + 1, bitsAbove) || bitsAbove != bits) {
+            return false;
+        }
+    }
+
+    if (d.negative) {
+        bits |= uint64_t(1) << 63;
+    }
+
+    memcpy(&out, &bits, sizeof(double));
+    return true;
+}
+
+template<class T>
+bool parseFloat(const T* data, int64_t count, double& out) {
+    Scanner<T> scanner(data, count);
+
+    int64_t start = scanner.cur;
+    int64_t stop = scanner.end;
+
+    Decimal d;
+    if (!scanner.parseDecimal(d)) {
+        return false;
+    }
+
+    if (d.isNan) {
+        out = std::copysign(std::numeric_limits<double>::quiet_NaN(), d.negative ? -1.0 : 1.0);
+        return true;
+    }
+
+    if (d.isInf) {
+        out = d.negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        return true;
+    }
+
+    if (!decimalToDouble(d, out)) {
+        out = strtod(scanner.cleanedLiteral(start, stop).c_str(), nullptr);
+    }
+
+    return true;
+}
+
+// parse an int literal into 'out'. Like the rest of typed_python's int64
+// arithmetic, values too large for an int64 wrap around.
+template<class T>
+bool parseInt(const T* data, int64_t count, int64_t& out) {
+    Scanner<T> scanner(data, count);
+
+    return scanner.parseInt(out);
+}
+
+} // end namespace NumberParsing
@@ -0,0 +1,126 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include <numpy/arrayobject.h>
+#include <numpy/ufuncobject.h>
+
+#include "NumpyUfunc.hpp"
+#include "PyGilState.hpp"
+#include "NativeException.hpp"
+#include "util.hpp"
+
+namespace NumpyUfunc {
+
+namespace {
+
+const char* CAPSULE_NAME = "typed_python.NumpyUfunc";
+
+// numpy holds on to pointers into this rather than copying, so the ufunc
+// keeps it alive (through a capsule in its 'obj').
+struct UfuncData {
+    compiled_code_entrypoint loop;
+    std::string name;
+    std::string doc;
+    std::vector<char> types;
+    PyUFuncGenericFunction functions[1];
+    void* data[1];
+};
+
+void innerLoop(char** args, npy_intp const* dimensions, npy_intp const* steps, void* data) {
+    UfuncData* ufunc = (UfuncData*)data;
+
+    PyGILState_STATE gilState = PyGILState_Ensure();
+
+    // if an earlier run of elements raised, leave the rest alone
+    if (!PyErr_Occurred()) {
+        int64_t count = dimensions[0];
+        void* loopArgs[3] = {&args, &count, &steps};
+
+        PyEnsureGilReleased releaseTheGIL(true);
+
+        try {
+            ufunc->loop(nullptr, (instance_ptr*)loopArgs);
+        }
+        catch(...) {
+            // exceptions coming out of compiled code are set in the interpreter, once
+            // it has made the exception object
+            PyEnsureGilAcquired getTheGil;
+            NativeException::materialize();
+        }
+    }
+
+    PyGILState_Release(gilState);
+}
+
+void destroyCapsule(PyObject* capsule) {
+    delete (UfuncData*)PyCapsule_GetPointer(capsule, CAPSULE_NAME);
+}
+
+} // end anonymous namespace
+
+PyObject* make(
+    const std::string& name,
+    const std::string& doc,
+    int nin,
+    int nout,
+    const std::vector<int>& typeNums,
+    compiled_code_entrypoint loop
+) {
+    if (nin < 1 || nout < 1 || typeNums.size() != (size_t)(nin + nout)) {
+        throw std::runtime_error("a ufunc needs at least one input and output, and a type for each");
+    }
+
+    UfuncData* data = new UfuncData();
+
+    data->loop = loop;
+    data->name = name;
+    data->doc = doc;
+    data->types.assign(typeNums.begin(), typeNums.end());
+    data->functions[0] = innerLoop;
+    data->data[0] = data;
+
+    PyObject* capsule = PyCapsule_New(data, CAPSULE_NAME, destroyCapsule);
+
+    if (!capsule) {
+        delete data;
+        throw PythonExceptionSet();
+    }
+
+    PyObject* ufunc = PyUFunc_FromFuncAndData(
+        data->functions,
+        data->data,
+        data->types.data(),
+        1,
+        nin,
+        nout,
+        PyUFunc_None,
+        data->name.c_str(),
+        data->doc.c_str(),
+        0
+    );
+
+    if (!ufunc) {
+        decref(capsule);
+        throw PythonExceptionSet();
+    }
+
+    // the ufunc releases 'obj' when it's destroyed
+    ((PyUFuncObject*)ufunc)->obj = capsule;
+
+    return ufunc;
+}
+
+} // end namespace NumpyUfunc
@@ -0,0 +1,51 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include <string>
+#include <vector>
+
+/*********
+numpy ufuncs whose inner loop is compiled code.
+
+numpy does the broadcasting, casting and buffering, and hands the inner loop
+a pointer, a stride for each argument, and a count. 'loop' is the entrypoint
+of a compiled function taking exactly those, (args, count, steps), which
+walks the elements itself (see typed_python/lib/ufunc.py), so there's one
+call into compiled code per run of elements rather than one per element.
+
+numpy releases the GIL around inner loops over numeric types. Compiled code
+expects to start out holding it, so each call takes it back and immediately
+releases it again in our usual way. If the compiled code raises, we skip the
+rest of the elements, and numpy finds the exception once the ufunc returns.
+*********/
+
+namespace NumpyUfunc {
+
+// make a ufunc with one loop, over the numpy type numbers 'typeNums' (inputs, then
+// outputs). Returns a new reference, or throws PythonExceptionSet.
+PyObject* make(
+    const std::string& name,
+    const std::string& doc,
+    int nin,
+    int nout,
+    const std::vector<int>& typeNums,
+    compiled_code_entrypoint loop
+);
+
+} // end namespace NumpyUfunc
@@ -36,8 +36,29 @@ bool OneOfType::isBinaryCompatibleWithConcrete(Type* other) {
     return true;
 }
 
+// can we use nullptr to mean 'None' in a OneOf(None, T)?
+static bool hasNullNiche(Type* t) {
+    // TupleOf, ConstDict, String and Bytes use nullptr for their empty values,
+    // so they're not on this list.
+    return (
+        t->getTypeCategory() == Type::TypeCategory::catListOf ||
+        t->getTypeCategory() == Type::TypeCategory::catDict ||
+        t->getTypeCategory() == Type::TypeCategory::catSet
+    );
+}
+
 bool OneOfType::_updateAfterForwardTypesChanged() {
-    size_t size = computeBytecount();
+    int null_niche_index = -1;
+
+    if (m_types.size() == 2) {
+        for (long k = 0; k < 2; k++) {
+            if (m_types[1 - k]->getTypeCategory() == TypeCategory::catNone && hasNullNiche(m_types[k])) {
+                null_niche_index = k;
+            }
+        }
+    }
+
+    size_t size = null_niche_index >= 0 ? sizeof(void*) : computeBytecount();
     std::string name = computeName();
 
     if (m_is_recursive_forward) {
@@ -55,11 +76,13 @@ bool OneOfType::_updateAfterForwardTypesChanged() {
 
     bool anyChanged = (
         size != m_size ||
+        null_niche_index != m_null_niche_index ||
         name != m_name ||
         is_default_constructible != m_is_default_constructible
     );
 
     m_size = size;
+    m_null_niche_index = null_niche_index;
     m_stripped_name = "";
     m_name = name;
     m_stripped_name = "";
@@ -90,22 +113,25 @@ std::string OneOfType::computeName() const {
 }
 
 void OneOfType::repr(instance_ptr self, ReprAccumulator& stream, bool isStr) {
-    m_types[*((uint8_t*)self)]->repr(self+1, stream, isStr);
+    m_types[whichIndex(self)]->repr(eltPtr(self), stream, isStr);
 }
 
 typed_python_hash_type OneOfType::hash(instance_ptr left) {
-    return m_types[*((uint8_t*)left)]->hash(left+1);
+    return m_types[whichIndex(left)]->hash(eltPtr(left));
 }
 
 bool OneOfType::cmp(instance_ptr left, instance_ptr right, int pyComparisonOp, bool suppressExceptions) {
-    if (((uint8_t*)left)[0] < ((uint8_t*)right)[0]) {
+    size_t leftWhich = whichIndex(left);
+    size_t rightWhich = whichIndex(right);
+
+    if (leftWhich < rightWhich) {
         return cmpResultToBoolForPyOrdering(pyComparisonOp, -1);
     }
-    if (((uint8_t*)left)[0] > ((uint8_t*)right)[0]) {
+    if (leftWhich > rightWhich) {
         return cmpResultToBoolForPyOrdering(pyComparisonOp, 1);
     }
 
-    return m_types[*((uint8_t*)left)]->cmp(left+1,right+1, pyComparisonOp, suppressExceptions);
+    return m_types[leftWhich]->cmp(eltPtr(left), eltPtr(right), pyComparisonOp, suppressExceptions);
 }
 
 size_t OneOfType::computeBytecount() const {
@@ -125,33 +151,33 @@ void OneOfType::constructor(instance_ptr self) {
 
     for (size_t k = 0; k < m_types.size(); k++) {
         if (m_types[k]->is_default_constructible()) {
-            *(uint8_t*)self = k;
-            m_types[k]->constructor(self+1);
+            m_types[k]->constructor(eltPtr(self));
+            setWhichIndex(self, k);
             return;
         }
     }
 }
 
 void OneOfType::destroy(instance_ptr self) {
-    uint8_t which = *(uint8_t*)(self);
-    m_types[which]->destroy(self+1);
+    m_types[whichIndex(self)]->destroy(eltPtr(self));
 }
 
 void OneOfType::copy_constructor(instance_ptr self, instance_ptr other) {
-    uint8_t which = *(uint8_t*)self = *(uint8_t*)other;
-    m_types[which]->copy_constructor(self+1, other+1);
+    size_t which = whichIndex(other);
+    m_types[which]->copy_constructor(eltPtr(self), eltPtr(other));
+    setWhichIndex(self, which);
 }
 
 void OneOfType::assign(instance_ptr self, instance_ptr other) {
-    uint8_t which = *(uint8_t*)self;
-    if (which == *(uint8_t*)other) {
-        m_types[which]->assign(self+1,other+1);
-    } else {
-        m_types[which]->destroy(self+1);
+    size_t which = whichIndex(self);
+    size_t otherWhich = whichIndex(other);
 
-        uint8_t otherWhich = *(uint8_t*)other;
-        *(uint8_t*)self = otherWhich;
-        m_types[otherWhich]->copy_constructor(self+1,other+1);
+    if (which == otherWhich) {
+        m_types[which]->assign(eltPtr(self), eltPtr(other));
+    } else {
+        m_types[which]->destroy(eltPtr(self));
+        m_types[otherWhich]->copy_constructor(eltPtr(self), eltPtr(other));
+        setWhichIndex(self, otherWhich);
     }
 }
 
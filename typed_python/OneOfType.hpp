@@ -28,7 +28,8 @@ class OneOfType : public Type {
 public:
     OneOfType(const std::vector<Type*>& types) noexcept :
                     Type(TypeCategory::catOneOf),
-                    m_types(types)
+                    m_types(types),
+                    m_null_niche_index(-1)
     {
         if (m_types.size() > 255) {
             throw std::runtime_error("OneOf types are limited to 255 alternatives in this implementation");
@@ -66,6 +67,10 @@ public:
     bool _updateAfterForwardTypesChanged();
 
     bool isPODConcrete() {
+        if (m_null_niche_index >= 0) {
+            return false;
+        }
+
         for (auto t: m_types) {
             if (!t->isPOD()) {
                 return false;
@@ -82,35 +87,41 @@ public:
         instance_ptr src,
         DeepcopyContext& context
     ) {
-        uint8_t which = *(uint8_t*)dest = *(uint8_t*)src;
-        m_types[which]->deepcopy(dest+1, src+1, context);
+        size_t which = whichIndex(src);
+        m_types[which]->deepcopy(eltPtr(dest), eltPtr(src), context);
+        setWhichIndex(dest, which);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         if (isPOD()) {
             return 0;
         }
 
-        int fieldNumber = *(uint8_t*)instance;
-
-        return m_types[fieldNumber]->deepBytecount(instance + 1, alreadyVisited, outSlabs);
+        return m_types[whichIndex(instance)]->deepBytecount(eltPtr(instance), context, outSlabs);
     }
 
     template<class buf_t>
     void deserialize(instance_ptr self, buf_t& buffer, size_t wireType) {
         bool hitOne = false;
 
-        buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
+        try {
+            buffer.consumeCompoundMessage(wireType, [&](size_t fieldNumber, size_t subWireType) {
+                if (hitOne) {
+                    throw std::runtime_error("Corrupt OneOf had multiple fields.");
+                }
+
+                if (fieldNumber < m_types.size()) {
+                    m_types[fieldNumber]->deserialize(eltPtr(self), buffer, subWireType);
+                    setWhichIndex(self, fieldNumber);
+                    hitOne = true;
+                }
+            });
+        } catch(...) {
             if (hitOne) {
-                throw std::runtime_error("Corrupt OneOf had multiple fields.");
-            }
-
-            if (fieldNumber < m_types.size()) {
-                *(uint8_t*)self = fieldNumber;
-                m_types[fieldNumber]->deserialize(self+1, buffer, subWireType);
-                hitOne = true;
+                destroy(self);
             }
-        });
+            throw;
+        }
 
         if (!hitOne) {
             constructor(self);
@@ -120,7 +131,8 @@ public:
     template<class buf_t>
     void serialize(instance_ptr self, buf_t& buffer, size_t fieldNumber) {
         buffer.writeBeginSingle(fieldNumber);
-        m_types[*((uint8_t*)self)]->serialize(self+1, buffer, *(uint8_t*)self);
+        size_t which = whichIndex(self);
+        m_types[which]->serialize(eltPtr(self), buffer, which);
     }
 
     void repr(instance_ptr self, ReprAccumulator& stream, bool isStr);
@@ -130,7 +142,40 @@ public:
     bool cmp(instance_ptr left, instance_ptr right, int pyComparisonOp, bool suppressExceptions);
 
     std::pair<Type*, instance_ptr> unwrap(instance_ptr self) {
-        return std::make_pair(m_types[*(uint8_t*)self], self+1);
+        return std::make_pair(m_types[whichIndex(self)], eltPtr(self));
+    }
+
+    // which of our types does 'self' hold?
+    size_t whichIndex(instance_ptr self) const {
+        if (m_null_niche_index >= 0) {
+            return *(void**)self ? m_null_niche_index : 1 - m_null_niche_index;
+        }
+
+        return *(uint8_t*)self;
+    }
+
+    // where the value of whichever type 'self' holds lives
+    instance_ptr eltPtr(instance_ptr self) const {
+        return m_null_niche_index >= 0 ? self : self + 1;
+    }
+
+    // mark 'self' as holding the 'which'th type. Call this after constructing the
+    // value at eltPtr(self), since storing None in a niche OneOf writes the nullptr.
+    void setWhichIndex(instance_ptr self, size_t which) const {
+        if (m_null_niche_index >= 0) {
+            if (which != (size_t)m_null_niche_index) {
+                *(void**)self = nullptr;
+            }
+        } else {
+            *(uint8_t*)self = which;
+        }
+    }
+
+    // if we're OneOf(None, T) for a T whose instances are a single pointer that's
+    // never null, we store just the T and use nullptr for None, and this is
+    // the index of T. Otherwise -1, and we store a tag byte followed by the value.
+    int nullNicheIndex() const {
+        return m_null_niche_index;
     }
 
     size_t computeBytecount() const;
@@ -155,4 +200,6 @@ public:
 
 private:
     std::vector<Type*> m_types;
+
+    int m_null_niche_index;
 };
@@ -0,0 +1,242 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "OutputSink.hpp"
+#include "NumberFormatting.hpp"
+#include "Unicode.hpp"
+#include <atomic>
+#include <errno.h>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace OutputSink {
+
+namespace {
+
+// where buffers go when they're flushed
+class Target {
+public:
+    Target() :
+        mFd(1),
+        mOwnsFd(false),
+        mRingHead(0),
+        mRingWrapped(false)
+    {
+    }
+
+    void write(const char* data, size_t bytecount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mRing.size()) {
+            writeToRing(data, bytecount);
+            return;
+        }
+
+        while (bytecount) {
+            ssize_t written = ::write(mFd, data, bytecount);
+
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // nowhere to report it, and print shouldn't throw
+                return;
+            }
+
+            data += written;
+            bytecount -= written;
+        }
+    }
+
+    void setFd(int fd, bool ownsFd) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        release();
+
+        mFd = fd;
+        mOwnsFd = ownsFd;
+    }
+
+    void setRing(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        release();
+
+        mRing.resize(std::max<size_t>(capacity, 1));
+    }
+
+    std::string ringContents() {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (!mRingWrapped) {
+            return std::string(mRing.data(), mRingHead);
+        }
+
+        return std::string(mRing.data() + mRingHead, mRing.size() - mRingHead)
+            + std::string(mRing.data(), mRingHead);
+    }
+
+private:
+    void writeToRing(const char* data, size_t bytecount) {
+        size_t capacity = mRing.size();
+
+        // only the last 'capacity' bytes can survive
+        if (bytecount >= capacity) {
+            memcpy(mRing.data(), data + bytecount - capacity, capacity);
+            mRingHead = 0;
+            mRingWrapped = true;
+            return;
+        }
+
+        size_t first = std::min(bytecount, capacity - mRingHead);
+
+        memcpy(mRing.data() + mRingHead, data, first);
+        memcpy(mRing.data(), data + first, bytecount - first);
+
+        if (mRingHead + bytecount >= capacity) {
+            mRingWrapped = true;
+        }
+
+        mRingHead = (mRingHead + bytecount) % capacity;
+    }
+
+    // drop the current target. Must hold the lock.
+    void release() {
+        if (mOwnsFd) {
+            ::close(mFd);
+        }
+
+        mFd = 1;
+        mOwnsFd = false;
+
+        mRing.clear();
+        mRing.shrink_to_fit();
+        mRingHead = 0;
+        mRingWrapped = false;
+    }
+
+    std::mutex mMutex;
+
+    int mFd;
+    bool mOwnsFd;
+
+    // if nonempty, we write here instead of to mFd
+    std::vector<char> mRing;
+    size_t mRingHead;
+    bool mRingWrapped;
+};
+
+Target& target() {
+    // never destroyed, since threads flush into it as they exit
+    static Target* t = new Target();
+
+    return *t;
+}
+
+std::atomic<size_t> bufferSize(0);
+
+class ThreadBuffer {
+public:
+    ~ThreadBuffer() {
+        flush();
+    }
+
+    void flush() {
+        if (data.size()) {
+            target().write(data.data(), data.size());
+            data.clear();
+        }
+    }
+
+    std::string data;
+};
+
+thread_local ThreadBuffer threadBuffer;
+
+template<class codepoint_type>
+void appendUtf8(const codepoint_type* codepoints, int64_t count) {
+    std::string& out = threadBuffer.data;
+
+    size_t start = out.size();
+
+    out.resize(start + countUtf8BytesRequiredFor((codepoint_type*)codepoints, count));
+
+    encodeUtf8((codepoint_type*)codepoints, count, (uint8_t*)&out[start]);
+}
+
+} // end anonymous namespace
+
+void write(const char* data, size_t bytecount) {
+    threadBuffer.data.append(data, bytecount);
+}
+
+void writeUtf8(const StringType::layout* s) {
+    if (!s) {
+        return;
+    }
+
+    if (s->bytes_per_codepoint == 1) {
+        appendUtf8((const uint8_t*)s->data, s->pointcount);
+    } else if (s->bytes_per_codepoint == 2) {
+        appendUtf8((const uint16_t*)s->data, s->pointcount);
+    } else {
+        appendUtf8((const uint32_t*)s->data, s->pointcount);
+    }
+}
+
+void writeInt64(int64_t i) {
+    char data[NumberFormatting::MAX_INT64_CHARS];
+
+    write(data, NumberFormatting::formatInt64(i, data));
+}
+
+void writeFloat64(double f) {
+    char data[NumberFormatting::MAX_FLOAT64_CHARS];
+
+    write(data, NumberFormatting::formatFloat64(f, data));
+}
+
+void endPrint(bool flush) {
+    if (flush || threadBuffer.data.size() >= bufferSize.load(std::memory_order_relaxed)) {
+        threadBuffer.flush();
+    }
+}
+
+void flushThisThread() {
+    threadBuffer.flush();
+}
+
+void setFdTarget(int fd, bool ownsFd) {
+    flushThisThread();
+    target().setFd(fd, ownsFd);
+}
+
+void setRingBufferTarget(size_t capacity) {
+    flushThisThread();
+    target().setRing(capacity);
+}
+
+std::string ringBufferContents() {
+    return target().ringContents();
+}
+
+void setBufferSize(size_t bytecount) {
+    flushThisThread();
+    bufferSize.store(bytecount);
+}
+
+} // end namespace OutputSink
@@ -0,0 +1,65 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "StringType.hpp"
+#include <string>
+
+/*********
+Where 'print' in compiled code sends its output.
+
+Compiled print formats its arguments straight into a buffer belonging to
+the calling thread (ints and floats without making a str first), and ends
+each call with 'endPrint', which writes the buffer to the target once it
+holds 'bufferSize' bytes. The default bufferSize is zero, so every print
+is written immediately, as in the interpreter. Raising it turns a print
+per iteration of a hot loop into one write per buffer.
+
+A thread's buffer is written out when it fills, when the thread calls
+'flushThisThread' (print(..., flush=True), or _types.flushCompiledPrint,
+which python also calls at exit), and when the thread exits. We don't
+flush other threads' buffers, since they write to them without a lock.
+
+The target is a file descriptor (stdout unless configured otherwise), a
+file we opened, or an in-memory ring buffer that keeps the last 'capacity'
+bytes written, for logging that a test or a monitor reads back.
+*********/
+
+namespace OutputSink {
+
+// append to the calling thread's buffer
+void write(const char* data, size_t bytecount);
+void writeUtf8(const StringType::layout* s);
+void writeInt64(int64_t i);
+void writeFloat64(double f);
+
+// finish a print, writing the buffer out if it's full or 'flush'
+void endPrint(bool flush);
+
+void flushThisThread();
+
+// send output to 'fd', which we close when the target changes if 'ownsFd'
+void setFdTarget(int fd, bool ownsFd);
+
+void setRingBufferTarget(size_t capacity);
+
+// the ring buffer's contents, oldest first. Empty if it isn't the target.
+std::string ringBufferContents();
+
+void setBufferSize(size_t bytecount);
+
+} // end namespace OutputSink
@@ -0,0 +1,100 @@
+/******************************************************************************
+   Copyright 2017-2020 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// a set of non-null pointers, using open addressing with linear probing.
+// Graph walks like deepBytecount insert every node they see into one of these,
+// and std::unordered_set spends most of that time allocating its nodes.
+class PointerSet {
+public:
+    PointerSet() : mCount(0), mSlots(INITIAL_SLOT_COUNT, nullptr)
+    {
+    }
+
+    bool contains(const void* p) const {
+        size_t mask = mSlots.size() - 1;
+
+        for (size_t slot = slotFor(p, mask);; slot = (slot + 1) & mask) {
+            if (mSlots[slot] == p) {
+                return true;
+            }
+            if (!mSlots[slot]) {
+                return false;
+            }
+        }
+    }
+
+    // add 'p' to the set. Returns true if it wasn't already there.
+    bool insert(const void* p) {
+        if ((mCount + 1) * 2 > mSlots.size()) {
+            grow();
+        }
+
+        if (!insertInto(mSlots, p)) {
+            return false;
+        }
+
+        mCount++;
+        return true;
+    }
+
+    size_t size() const {
+        return mCount;
+    }
+
+private:
+    static const size_t INITIAL_SLOT_COUNT = 64;
+
+    static size_t slotFor(const void* p, size_t mask) {
+        // allocations are aligned, so the low bits carry no information
+        return (((uint64_t)p >> 4) * 0x9E3779B97F4A7C15ULL >> 20) & mask;
+    }
+
+    static bool insertInto(std::vector<const void*>& slots, const void* p) {
+        size_t mask = slots.size() - 1;
+
+        for (size_t slot = slotFor(p, mask);; slot = (slot + 1) & mask) {
+            if (slots[slot] == p) {
+                return false;
+            }
+            if (!slots[slot]) {
+                slots[slot] = p;
+                return true;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<const void*> newSlots(mSlots.size() * 2, nullptr);
+
+        for (auto p: mSlots) {
+            if (p) {
+                insertInto(newSlots, p);
+            }
+        }
+
+        mSlots.swap(newSlots);
+    }
+
+    size_t mCount;
+
+    std::vector<const void*> mSlots;
+};
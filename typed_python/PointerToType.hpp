@@ -122,7 +122,7 @@ public:
         copy_constructor(dest, src);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         // we don't follow pointers since we can't be sure they reference valid data.
         return 0;
     }
@@ -0,0 +1,135 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "PyInstance.hpp"
+#include "PyStringInstance.hpp"
+
+/*********
+Converts exact python ints, floats, bools and strs into an int, float, bool
+or str without going through 'copyConstructFromPythonInstance', which checks
+for typed_python instances and dispatches on the target's category for every
+value.
+
+Containers build one for their element type and conversion level, which
+decides what it accepts once for the whole container, and then offer it each
+item, converting anything it declines (including ints it can't represent, so
+that the general path can produce its usual result) the usual way.
+*********/
+
+class PrimitiveConverter {
+public:
+    PrimitiveConverter(Type* target, ConversionLevel level) :
+        mTarget(target->getTypeCategory()),
+        mFromInt(false),
+        mFromFloat(false),
+        mFromBool(false),
+        mFromStr(false)
+    {
+        if (mTarget == Type::TypeCategory::catInt64
+                || mTarget == Type::TypeCategory::catFloat64
+                || mTarget == Type::TypeCategory::catBool) {
+            mFromInt = mTarget != Type::TypeCategory::catBool
+                && RegisterTypeProperties::isValidConversion(Type::TypeCategory::catInt64, mTarget, level);
+            mFromFloat = mTarget == Type::TypeCategory::catFloat64;
+            mFromBool = RegisterTypeProperties::isValidConversion(Type::TypeCategory::catBool, mTarget, level);
+        }
+
+        if (mTarget == Type::TypeCategory::catString) {
+            mFromStr = true;
+        }
+    }
+
+    bool active() const {
+        return mFromInt || mFromFloat || mFromBool || mFromStr;
+    }
+
+    // construct 'o' into the uninitialized 'tgt' and return true, or return
+    // false, having written nothing, if it's not a value we convert.
+    bool tryConstruct(instance_ptr tgt, PyObject* o) const {
+        PyTypeObject* pyType = Py_TYPE(o);
+
+        if (pyType == &PyLong_Type) {
+            if (!mFromInt) {
+                return false;
+            }
+
+            if (mTarget == Type::TypeCategory::catInt64) {
+                int overflow;
+                long long value = PyLong_AsLongLongAndOverflow(o, &overflow);
+
+                if (overflow) {
+                    return false;
+                }
+
+                *(int64_t*)tgt = value;
+                return true;
+            }
+
+            double value = PyLong_AsDouble(o);
+
+            if (value == -1.0 && PyErr_Occurred()) {
+                PyErr_Clear();
+                return false;
+            }
+
+            *(double*)tgt = value;
+            return true;
+        }
+
+        if (pyType == &PyFloat_Type) {
+            if (!mFromFloat) {
+                return false;
+            }
+
+            *(double*)tgt = PyFloat_AS_DOUBLE(o);
+            return true;
+        }
+
+        if (pyType == &PyBool_Type) {
+            if (!mFromBool) {
+                return false;
+            }
+
+            if (mTarget == Type::TypeCategory::catInt64) {
+                *(int64_t*)tgt = o == Py_True;
+            } else if (mTarget == Type::TypeCategory::catFloat64) {
+                *(double*)tgt = o == Py_True;
+            } else {
+                *(bool*)tgt = o == Py_True;
+            }
+            return true;
+        }
+
+        if (pyType == &PyUnicode_Type && mFromStr) {
+            PyStringInstance::copyConstructFromPythonInstanceConcrete(
+                StringType::Make(), tgt, o, ConversionLevel::Signature
+            );
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    Type::TypeCategory mTarget;
+
+    bool mFromInt;
+    bool mFromFloat;
+    bool mFromBool;
+    bool mFromStr;
+};
@@ -16,12 +16,21 @@
 
 #include "PyBoundMethodInstance.hpp"
 #include "PyFunctionInstance.hpp"
+#include "FunctionCallArgMapping.hpp"
 
 BoundMethod* PyBoundMethodInstance::type() {
     return (BoundMethod*)extractTypeFrom(((PyObject*)this)->ob_type);
 }
 
 PyObject* PyBoundMethodInstance::tp_call_concrete(PyObject* args, PyObject* kwargs) {
+    return callWithArguments(CallArguments(args, kwargs));
+}
+
+PyObject* PyBoundMethodInstance::tp_vectorcall_concrete(PyObject* const* args, size_t nargs, PyObject* kwnames) {
+    return callWithArguments(CallArguments(args, nargs, kwnames));
+}
+
+PyObject* PyBoundMethodInstance::callWithArguments(const CallArguments& args) {
     if (mKeepalive) {
         if (mKeepalive->ob_refcnt == 1) {
             PyErr_Format(
@@ -47,32 +56,10 @@ PyObject* PyBoundMethodInstance::tp_call_concrete(PyObject* args, PyObject* kwar
         return NULL;
     }
 
-    //if we are an entrypoint, map any untyped function arguments to typed functions
     PyObjectHolder mappedArgs;
     PyObjectHolder mappedKwargs;
 
-    if (f->isEntrypoint()) {
-        mappedArgs.steal(PyTuple_New(PyTuple_Size(args)));
-
-        for (long k = 0; k < PyTuple_Size(args); k++) {
-            PyTuple_SetItem(mappedArgs, k, PyFunctionInstance::prepareArgumentToBePassedToCompiler(PyTuple_GetItem(args, k)));
-        }
-
-        mappedKwargs.steal(PyDict_New());
-
-        if (kwargs) {
-            PyObject *key, *value;
-            Py_ssize_t pos = 0;
-
-            while (PyDict_Next(kwargs, &pos, &key, &value)) {
-                PyObjectStealer mapped(PyFunctionInstance::prepareArgumentToBePassedToCompiler(value));
-                PyDict_SetItem(mappedKwargs, key, mapped);
-            }
-        }
-    } else {
-        mappedArgs.set(args);
-        mappedKwargs.set(kwargs);
-    }
+    CallArguments mapped = PyFunctionInstance::mapEntrypointArguments(f, args, mappedArgs, mappedKwargs);
 
     PyObjectHolder objectInstance;
 
@@ -104,8 +91,7 @@ PyObject* PyBoundMethodInstance::tp_call_concrete(PyObject* args, PyObject* kwar
                 nullptr,
                 overloadIx,
                 objectInstance,
-                mappedArgs,
-                mappedKwargs,
+                mapped,
                 conversionLevel
             );
 
@@ -115,7 +101,7 @@ PyObject* PyBoundMethodInstance::tp_call_concrete(PyObject* args, PyObject* kwar
         }
     }
 
-    std::string argTupleTypeDesc = PyFunctionInstance::argTupleTypeDescription(objectInstance, args, kwargs);
+    std::string argTupleTypeDesc = PyFunctionInstance::argTupleTypeDescription(objectInstance, args);
 
     PyErr_Format(
         PyExc_TypeError, "'%s' cannot find a valid overload with arguments of type %s",
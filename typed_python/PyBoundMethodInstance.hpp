@@ -18,6 +18,8 @@
 
 #include "PyInstance.hpp"
 
+class CallArguments;
+
 class PyBoundMethodInstance : public PyInstance {
 public:
     typedef BoundMethod modeled_type;
@@ -26,6 +28,10 @@ public:
 
     PyObject* tp_call_concrete(PyObject* args, PyObject* kwargs);
 
+    PyObject* tp_vectorcall_concrete(PyObject* const* args, size_t nargs, PyObject* kwnames);
+
+    PyObject* callWithArguments(const CallArguments& args);
+
     int pyInquiryConcrete(const char* op, const char* opErrRep);
 
     static void mirrorTypeInformationIntoPyTypeConcrete(BoundMethod* methodT, PyTypeObject* pyType);
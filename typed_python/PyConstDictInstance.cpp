@@ -36,7 +36,7 @@ PyObject* PyConstDictInstance::constDictItems(PyObject *o) {
     PyInstance* w = (PyInstance*)o;
 
     if (self_type && self_type->getTypeCategory() == Type::TypeCategory::catConstDict) {
-        PyInstance* self = (PyInstance*)o->ob_type->tp_alloc(o->ob_type, 0);
+        PyInstance* self = PyInstance::allocate(o->ob_type);
 
         self->mIteratorOffset = 0;
         self->mIteratorFlag = 2;
@@ -66,7 +66,7 @@ PyObject* PyConstDictInstance::constDictKeys(PyObject *o) {
     PyInstance* w = (PyInstance*)o;
 
     if (self_type && self_type->getTypeCategory() == Type::TypeCategory::catConstDict) {
-        PyInstance* self = (PyInstance*)o->ob_type->tp_alloc(o->ob_type, 0);
+        PyInstance* self = PyInstance::allocate(o->ob_type);
 
         self->mIteratorOffset = 0;
         self->mIteratorFlag = 0;
@@ -96,7 +96,7 @@ PyObject* PyConstDictInstance::constDictValues(PyObject *o) {
     PyInstance* w = (PyInstance*)o;
 
     if (self_type && self_type->getTypeCategory() == Type::TypeCategory::catConstDict) {
-        PyInstance* self = (PyInstance*)o->ob_type->tp_alloc(o->ob_type, 0);
+        PyInstance* self = PyInstance::allocate(o->ob_type);
 
         self->mIteratorOffset = 0;
         self->mIteratorFlag = 1;
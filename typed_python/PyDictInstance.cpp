@@ -15,6 +15,7 @@
 ******************************************************************************/
 
 #include "PyDictInstance.hpp"
+#include "PrimitiveConverter.hpp"
 
 DictType* PyDictInstance::type() {
     return (DictType*)extractTypeFrom(((PyObject*)this)->ob_type);
@@ -217,6 +218,129 @@ PyObject* PyDictInstance::dictClear(PyObject* o) {
     return incref(Py_None);
 }
 
+// static
+PyDoc_STRVAR(dictCompact_doc,
+    "D.compact() -> None.  Releases any storage D holds beyond what its items need."
+    );
+PyObject* PyDictInstance::dictCompact(PyObject* o) {
+    PyDictInstance* self_w = (PyDictInstance*)o;
+
+    if (self_w->mIteratorOffset != -1) {
+        PyErr_SetString(PyExc_TypeError, "dict iterators don't allow 'compact'");
+        return NULL;
+    }
+
+    Type* self_type = extractTypeFrom(o->ob_type);
+
+    ((DictType*)self_type)->compact(self_w->dataPtr());
+
+    return incref(Py_None);
+}
+
+PyDoc_STRVAR(dictGetMany_doc,
+    "D.getMany(keys, default) -> ListOf(V) with D.get(k, default) for each k in keys.\n\n"
+    "Compiled code looks the keys up in batches, prefetching their hash table\n"
+    "entries ahead of time, which is much faster than calling 'get' in a loop\n"
+    "when the table doesn't fit in cache.\n"
+    );
+PyObject* PyDictInstance::dictGetMany(PyObject* o, PyObject* args) {
+    PyDictInstance* self_w = (PyDictInstance*)o;
+
+    if (PyTuple_Size(args) != 2) {
+        PyErr_SetString(PyExc_TypeError, "Dict.getMany takes two arguments");
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        DictType* dictT = self_w->type();
+
+        ListOfType* keyListT = ListOfType::Make(dictT->keyType());
+        ListOfType* valueListT = ListOfType::Make(dictT->valueType());
+
+        Instance keyList(keyListT, [&](instance_ptr data) {
+            copyConstructFromPythonInstance(keyListT, data, PyTuple_GetItem(args, 0), ConversionLevel::ImplicitContainers);
+        });
+
+        Instance defaultValue(dictT->valueType(), [&](instance_ptr data) {
+            copyConstructFromPythonInstance(dictT->valueType(), data, PyTuple_GetItem(args, 1), ConversionLevel::ImplicitContainers);
+        });
+
+        int64_t count = keyListT->count(keyList.data());
+
+        Instance result(valueListT, [&](instance_ptr data) {
+            valueListT->constructor(data, count, [&](instance_ptr tgt, int64_t k) {
+                instance_ptr value = dictT->lookupValueByKey(self_w->dataPtr(), keyListT->eltPtr(keyList.data(), k));
+
+                dictT->valueType()->copy_constructor(tgt, value ? value : defaultValue.data());
+            });
+        });
+
+        return PyInstance::fromInstance(result);
+    });
+}
+
+// static
+PyDoc_STRVAR(dictFromColumns_doc,
+    "Dict(K, V).fromColumns(keys, values) -> Dict(K, V)\n\n"
+    "Construct a Dict from parallel sequences of keys and values, sizing the\n"
+    "table once up front. Later duplicate keys overwrite earlier ones.\n"
+    );
+PyObject* PyDictInstance::fromColumns(PyObject* cls, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"keys", "values", NULL};
+
+    PyObject* keys;
+    PyObject* values;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO", (char**)kwlist, &keys, &values)) {
+        return nullptr;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        Type* selfType = PyInstance::unwrapTypeArgToTypePtr(cls);
+
+        if (!selfType || selfType->getTypeCategory() != Type::TypeCategory::catDict) {
+            throw std::runtime_error("Expected cls to be a Dict type");
+        }
+
+        DictType* dictT = (DictType*)selfType;
+
+        ListOfType* keyListT = ListOfType::Make(dictT->keyType());
+        ListOfType* valueListT = ListOfType::Make(dictT->valueType());
+
+        Instance keyList(keyListT, [&](instance_ptr data) {
+            copyConstructFromPythonInstance(keyListT, data, keys, ConversionLevel::ImplicitContainers);
+        });
+
+        Instance valueList(valueListT, [&](instance_ptr data) {
+            copyConstructFromPythonInstance(valueListT, data, values, ConversionLevel::ImplicitContainers);
+        });
+
+        int64_t count = keyListT->count(keyList.data());
+
+        if (valueListT->count(valueList.data()) != count) {
+            PyErr_Format(
+                PyExc_ValueError,
+                "Dict.fromColumns got %d keys but %d values",
+                (int)count,
+                (int)valueListT->count(valueList.data())
+            );
+            throw PythonExceptionSet();
+        }
+
+        Instance result(dictT, [&](instance_ptr data) {
+            dictT->constructor(data);
+            dictT->insertColumns(
+                data,
+                keyListT->eltPtr(keyList.data(), 0),
+                valueListT->eltPtr(valueList.data(), 0),
+                count
+            );
+        });
+
+        return PyInstance::fromInstance(result);
+    });
+}
+
 PyObject* PyDictInstance::tp_iter_concrete() {
     return createIteratorToSelf(mIteratorFlag, type()->size(dataPtr()));
 }
@@ -247,9 +371,7 @@ bool PyDictInstance::compare_as_iterator_to_python_concrete(PyObject* other, int
 PyObject* PyDictInstance::tp_iternext_concrete() {
     if (mIteratorOffset == 0) {
         //search forward to find the first slot
-        while (mIteratorOffset < type()->slotCount(dataPtr()) && !type()->slotPopulated(dataPtr(), mIteratorOffset)) {
-            mIteratorOffset++;
-        }
+        mIteratorOffset = type()->nextPopulatedSlot(dataPtr(), 0);
     }
 
     if (type()->size(dataPtr()) != mContainerSize) {
@@ -261,12 +383,9 @@ PyObject* PyDictInstance::tp_iternext_concrete() {
         return NULL;
     }
 
-    int32_t curSlot = mIteratorOffset;
+    int64_t curSlot = mIteratorOffset;
 
-    mIteratorOffset++;
-    while (mIteratorOffset < type()->slotCount(dataPtr()) && !type()->slotPopulated(dataPtr(), mIteratorOffset)) {
-        mIteratorOffset++;
-    }
+    mIteratorOffset = type()->nextPopulatedSlot(dataPtr(), mIteratorOffset + 1);
 
     if (mIteratorFlag == 2) {
         PyObjectStealer t1(extractPythonObject(
@@ -502,6 +621,83 @@ void PyDictInstance::constructFromPythonArgumentsConcrete(DictType* t, uint8_t*
     PyInstance::constructFromPythonArgumentsConcrete(t, data, args, kwargs);
 }
 
+// build 'dictTgt' from a python dict by converting every key and value into
+// a pair of columns, which the converters can fill without dispatching per
+// item, and then inserting the columns with the table sized once.
+static void constructFromDictOfPrimitives(
+    DictType* dictType,
+    instance_ptr dictTgt,
+    PyObject* pyDict,
+    const PrimitiveConverter& keyConverter,
+    ConversionLevel childLevelKey,
+    const PrimitiveConverter& valueConverter,
+    ConversionLevel childLevelValue
+) {
+    Type* keyType = dictType->keyType();
+    Type* valueType = dictType->valueType();
+
+    size_t keyBytes = keyType->bytecount();
+    size_t valueBytes = valueType->bytecount();
+    size_t count = PyDict_Size(pyDict);
+
+    std::vector<uint8_t> keys(count * keyBytes);
+    std::vector<uint8_t> values(count * valueBytes);
+
+    size_t keysConstructed = 0;
+    size_t valuesConstructed = 0;
+
+    auto destroyColumns = [&]() {
+        for (size_t k = 0; k < keysConstructed; k++) {
+            keyType->destroy(&keys[k * keyBytes]);
+        }
+        for (size_t k = 0; k < valuesConstructed; k++) {
+            valueType->destroy(&values[k * valueBytes]);
+        }
+    };
+
+    dictType->constructor(dictTgt);
+
+    try {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+
+        while (PyDict_Next(pyDict, &pos, &key, &value)) {
+            // converting the general way can run arbitrary python code, which
+            // could add to the dict while we're walking it
+            if (keysConstructed == count) {
+                throw std::logic_error("dict changed size during conversion to " + dictType->name());
+            }
+
+            // and could drop the dict's references to this pair
+            PyObjectHolder holdKey(key);
+            PyObjectHolder holdValue(value);
+
+            instance_ptr keyTgt = &keys[keysConstructed * keyBytes];
+            instance_ptr valueTgt = &values[valuesConstructed * valueBytes];
+
+            if (!keyConverter.tryConstruct(keyTgt, key)) {
+                PyInstance::copyConstructFromPythonInstance(keyType, keyTgt, key, childLevelKey);
+            }
+            keysConstructed++;
+
+            if (!valueConverter.tryConstruct(valueTgt, value)) {
+                PyInstance::copyConstructFromPythonInstance(valueType, valueTgt, value, childLevelValue);
+            }
+            valuesConstructed++;
+        }
+
+        if (keysConstructed) {
+            dictType->insertColumns(dictTgt, keys.data(), values.data(), keysConstructed);
+        }
+    } catch(...) {
+        destroyColumns();
+        dictType->destroy(dictTgt);
+        throw;
+    }
+
+    destroyColumns();
+}
+
 void PyDictInstance::copyConstructFromPythonInstanceConcrete(DictType* dictType, instance_ptr dictTgt, PyObject* pyRepresentation, ConversionLevel level) {
     if (level < ConversionLevel::ImplicitContainers) {
         return PyInstance::copyConstructFromPythonInstanceConcrete(dictType, dictTgt, pyRepresentation, level);
@@ -515,6 +711,18 @@ void PyDictInstance::copyConstructFromPythonInstanceConcrete(DictType* dictType,
     }
 
     if (PyDict_Check(pyRepresentation)) {
+        PrimitiveConverter keyConverter(dictType->keyType(), childLevelKey);
+        PrimitiveConverter valueConverter(dictType->valueType(), childLevelValue);
+
+        if (keyConverter.active() && valueConverter.active()) {
+            constructFromDictOfPrimitives(
+                dictType, dictTgt, pyRepresentation,
+                keyConverter, childLevelKey,
+                valueConverter, childLevelValue
+            );
+            return;
+        }
+
         dictType->constructor(dictTgt);
 
         try {
@@ -843,9 +1051,12 @@ PyObject* PyDictInstance::tp_repr_concrete() {
 }
 
 PyMethodDef* PyDictInstance::typeMethodsConcrete(Type* t) {
-    return new PyMethodDef [9] {
+    return new PyMethodDef [12] {
         {"get", (PyCFunction)PyDictInstance::dictGet, METH_VARARGS, dictGet_doc},
+        {"getMany", (PyCFunction)PyDictInstance::dictGetMany, METH_VARARGS, dictGetMany_doc},
         {"clear", (PyCFunction)PyDictInstance::dictClear, METH_NOARGS, dictClear_doc},
+        {"compact", (PyCFunction)PyDictInstance::dictCompact, METH_NOARGS, dictCompact_doc},
+        {"fromColumns", (PyCFunction)PyDictInstance::fromColumns, METH_VARARGS | METH_KEYWORDS | METH_CLASS, dictFromColumns_doc},
         {"update", (PyCFunction)PyDictInstance::dictUpdate, METH_VARARGS, dictUpdate_doc},
         {"items", (PyCFunction)PyDictInstance::dictItems, METH_NOARGS, dictItems_doc},
         {"keys", (PyCFunction)PyDictInstance::dictKeys, METH_NOARGS, dictKeys_doc},
@@ -52,10 +52,16 @@ public:
 
     static PyObject* dictGet(PyObject* o, PyObject* args);
 
+    static PyObject* dictGetMany(PyObject* o, PyObject* args);
+
     static PyObject* dictUpdate(PyObject* o, PyObject* args);
 
     static PyObject* dictClear(PyObject* o);
 
+    static PyObject* dictCompact(PyObject* o);
+
+    static PyObject* fromColumns(PyObject* cls, PyObject* args, PyObject* kwargs);
+
     static PyMethodDef* typeMethodsConcrete(Type* t);
 
     static void mirrorTypeInformationIntoPyTypeConcrete(DictType* dictT, PyTypeObject* pyType);
@@ -17,11 +17,17 @@
 #include "PyFunctionInstance.hpp"
 #include "FunctionCallArgMapping.hpp"
 #include "TypedClosureBuilder.hpp"
+#include "NativeException.hpp"
 
 Function* PyFunctionInstance::type() {
     return (Function*)extractTypeFrom(((PyObject*)this)->ob_type);
 }
 
+// static
+bool PyFunctionInstance::argumentNeedsPreparation(PyObject* o) {
+    return TypedClosureBuilder().isFunctionObject(o, true);
+}
+
 // static
 PyObject* PyFunctionInstance::prepareArgumentToBePassedToCompiler(PyObject* o) {
     TypedClosureBuilder builder;
@@ -33,37 +39,267 @@ PyObject* PyFunctionInstance::prepareArgumentToBePassedToCompiler(PyObject* o) {
     return incref(o);
 }
 
+// convert the result of a call to the overload's return type, if it has one.
+// Returns a new reference, or nullptr with the python error set.
+static PyObject* convertResultToReturnType(Type* returnType, PyObject* result) {
+    if (!returnType) {
+        return incref(result);
+    }
+
+    try {
+        return PyInstance::initializePythonRepresentation(returnType, [&](instance_ptr data) {
+            PyInstance::copyConstructFromPythonInstance(returnType, data, result, ConversionLevel::ImplicitContainers);
+        });
+    } catch (std::exception& e) {
+        PyErr_SetString(PyExc_TypeError, e.what());
+        return nullptr;
+    }
+}
+
+// could 'filter' accept some values of a python type and refuse others?
+static bool typeFilterDependsOnValues(Type* filter) {
+    if (filter->isValue()) {
+        return true;
+    }
+
+    if (filter->getTypeCategory() == Type::TypeCategory::catOneOf) {
+        for (auto t: ((OneOfType*)filter)->getTypes()) {
+            if (typeFilterDependsOnValues(t)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 // static
-std::pair<bool, PyObject*>
-PyFunctionInstance::tryToCallAnyOverload(const Function* f, instance_ptr funcClosure, PyObject* self,
-                                         PyObject* args, PyObject* kwargs) {
-    //if we are an entrypoint, map any untyped function arguments to typed functions
-    PyObjectHolder mappedArgs;
-    PyObjectHolder mappedKwargs;
+bool PyFunctionInstance::isDispatchCacheable(const Function* f) {
+    FunctionDispatchCache& cache = f->getDispatchCache();
 
-    if (f->isEntrypoint()) {
-        mappedArgs.steal(PyTuple_New(PyTuple_Size(args)));
+    if (cache.getCacheability() == FunctionDispatchCache::Cacheability::Unknown) {
+        bool isCacheable = f->isEntrypoint();
+
+        // signature functions and methods pick their return types in ways that
+        // depend on more than which overload matched
+        for (auto& overload: f->getOverloads()) {
+            if (overload.getSignatureFunction() || overload.getMethodOf()) {
+                isCacheable = false;
+            }
+
+            for (auto& arg: overload.getArgs()) {
+                if (arg.getTypeFilter() && typeFilterDependsOnValues(arg.getTypeFilter())) {
+                    isCacheable = false;
+                }
+            }
+        }
+
+        cache.setCacheability(isCacheable);
+    }
+
+    return cache.getCacheability() == FunctionDispatchCache::Cacheability::Cacheable;
+}
+
+// static
+std::pair<bool, PyObject*> PyFunctionInstance::tryToCallCachedSpecialization(
+        const Function* f,
+        instance_ptr funcClosure,
+        const CallArguments& args
+) {
+    FunctionDispatchCache& cache = f->getDispatchCache();
+
+    const FunctionDispatchCache::Entry* entry = cache.lookup(args.positional(), args.positionalCount());
+
+    if (!entry) {
+        return std::make_pair(false, nullptr);
+    }
 
-        for (long k = 0; k < PyTuple_Size(args); k++) {
-            PyTuple_SetItem(mappedArgs, k, prepareArgumentToBePassedToCompiler(PyTuple_GetItem(args, k)));
+    const Function::Overload& overload(f->getOverloads()[entry->overloadIx]);
+
+    FunctionCallArgMapping mapping(overload);
+
+    mapping.pushArguments(nullptr, args);
+
+    if (mapping.isValid()) {
+        mapping.applyTypeCoercion(ConversionLevel::Signature);
+    }
+
+    std::pair<bool, PyObject*> res(false, nullptr);
+
+    if (mapping.isValid()) {
+        res = dispatchFunctionCallToCompiledSpecialization(
+            overload,
+            f->getClosureType(),
+            funcClosure,
+            overload.getCompiledSpecializations()[entry->specializationIx],
+            mapping
+        );
+    }
+
+    if (!res.first) {
+        // the specialization refused these arguments after all, so this entry
+        // would miss every time
+        cache.erase(entry);
+        return res;
+    }
+
+    cache.recordHit();
+
+    //exceptions pass through directly
+    if (!res.second) {
+        return res;
+    }
+
+    PyObjectStealer result(res.second);
+
+    return std::make_pair(true, convertResultToReturnType(overload.getReturnType(), result));
+}
+
+// static
+void PyFunctionInstance::cacheDispatch(const Function* f, const CallArguments& args) {
+    FunctionDispatchCache& cache = f->getDispatchCache();
+
+    if (cache.isFull()) {
+        return;
+    }
+
+    // function arguments may get retyped by 'prepareArgumentToBePassedToCompiler'
+    // depending on what's in their closures, so their python type isn't enough
+    for (size_t k = 0; k < args.positionalCount(); k++) {
+        PyObject* arg = args.positional(k);
+        Type* argType = PyInstance::extractTypeFrom(arg->ob_type);
+
+        if (PyFunction_Check(arg) || (argType && argType->getTypeCategory() == Type::TypeCategory::catFunction)) {
+            return;
+        }
+    }
+
+    // the full path takes the first overload that accepts the arguments at
+    // ConversionLevel::Signature, and within it the first specialization that does.
+    // If no overload accepts them at that level, we don't cache the call.
+    for (long overloadIx = 0; overloadIx < f->getOverloads().size(); overloadIx++) {
+        const Function::Overload& overload(f->getOverloads()[overloadIx]);
+
+        FunctionCallArgMapping mapping(overload);
+
+        mapping.pushArguments(nullptr, args);
+
+        if (mapping.definitelyDoesntMatch(ConversionLevel::Signature)) {
+            continue;
         }
 
-        mappedKwargs.steal(PyDict_New());
+        mapping.applyTypeCoercion(ConversionLevel::Signature);
 
-        if (kwargs) {
-            PyObject *key, *value;
-            Py_ssize_t pos = 0;
+        if (!mapping.isValid()) {
+            continue;
+        }
+
+        const auto& specs = overload.getCompiledSpecializations();
+
+        for (long specIx = 0; specIx < specs.size(); specIx++) {
+            bool accepts = true;
+
+            for (long k = 0; k < overload.getArgs().size() && accepts; k++) {
+                Type* argType = specs[specIx].getArgTypes()[k];
+
+                if (typeFilterDependsOnValues(argType)) {
+                    // a later specialization might not be the first match for other values
+                    return;
+                }
+
+                if (overload.getArgs()[k].getIsNormalArg()) {
+                    accepts = PyInstance::pyValCouldBeOfType(
+                        argType, mapping.getSingleValueArgs()[k], ConversionLevel::Signature
+                    );
+                }
+
+                accepts = accepts && mapping.extractArgWithType(k, argType).isValid();
+            }
 
-            while (PyDict_Next(kwargs, &pos, &key, &value)) {
-                PyObjectStealer mapped(prepareArgumentToBePassedToCompiler(value));
-                PyDict_SetItem(mappedKwargs, key, mapped);
+            if (accepts) {
+                cache.insert(args.positional(), args.positionalCount(), overloadIx, specIx);
+                return;
             }
         }
-    } else {
-        mappedArgs.set(args);
-        mappedKwargs.set(kwargs);
+
+        return;
+    }
+}
+
+// static
+CallArguments PyFunctionInstance::mapEntrypointArguments(
+        const Function* f,
+        const CallArguments& args,
+        PyObjectHolder& mappedArgs,
+        PyObjectHolder& mappedKwargs
+) {
+    //if we are an entrypoint, map any untyped function arguments to typed functions.
+    //Most calls don't pass any, and can use their arguments as they are.
+    bool needsMapping = false;
+
+    if (f->isEntrypoint()) {
+        for (size_t k = 0; k < args.positionalCount() && !needsMapping; k++) {
+            needsMapping = argumentNeedsPreparation(args.positional(k));
+        }
+
+        args.forEachKeyword([&](PyObject* key, PyObject* value) {
+            needsMapping = needsMapping || argumentNeedsPreparation(value);
+        });
     }
 
+    if (!needsMapping) {
+        return args;
+    }
+
+    mappedArgs.steal(PyTuple_New(args.positionalCount()));
+
+    for (size_t k = 0; k < args.positionalCount(); k++) {
+        PyTuple_SetItem(mappedArgs, k, prepareArgumentToBePassedToCompiler(args.positional(k)));
+    }
+
+    mappedKwargs.steal(PyDict_New());
+
+    args.forEachKeyword([&](PyObject* key, PyObject* value) {
+        PyObjectStealer mapped(prepareArgumentToBePassedToCompiler(value));
+        PyDict_SetItem(mappedKwargs, key, mapped);
+    });
+
+    return CallArguments(mappedArgs, mappedKwargs);
+}
+
+// static
+std::pair<bool, PyObject*>
+PyFunctionInstance::tryToCallAnyOverload(const Function* f, instance_ptr funcClosure, PyObject* self,
+                                         PyObject* args, PyObject* kwargs) {
+    return tryToCallAnyOverload(f, funcClosure, self, CallArguments(args, kwargs));
+}
+
+// static
+std::pair<bool, PyObject*>
+PyFunctionInstance::tryToCallAnyOverload(const Function* f, instance_ptr funcClosure, PyObject* self,
+                                         const CallArguments& args) {
+    bool useDispatchCache = (
+        !self
+        && !args.hasKeywords()
+        && !native_dispatch_disabled
+        && isDispatchCacheable(f)
+    );
+
+    if (useDispatchCache) {
+        std::pair<bool, PyObject*> res = tryToCallCachedSpecialization(f, funcClosure, args);
+
+        if (res.first) {
+            return res;
+        }
+
+        f->getDispatchCache().recordMiss();
+    }
+
+    PyObjectHolder mappedArgs;
+    PyObjectHolder mappedKwargs;
+
+    CallArguments mapped = mapEntrypointArguments(f, args, mappedArgs, mappedKwargs);
+
     for (ConversionLevel conversionLevel: {
         ConversionLevel::Signature,
         ConversionLevel::Upcast,
@@ -75,16 +311,26 @@ PyFunctionInstance::tryToCallAnyOverload(const Function* f, instance_ptr funcClo
             std::pair<bool, PyObject*> res =
                 PyFunctionInstance::tryToCallOverload(
                     f, funcClosure, overloadIx, self,
-                    mappedArgs, mappedKwargs, conversionLevel
+                    mapped, conversionLevel
                 );
 
             if (res.first) {
+                if (useDispatchCache && res.second) {
+                    // failing to cache the call mustn't fail the call itself
+                    try {
+                        cacheDispatch(f, args);
+                    } catch(PythonExceptionSet& e) {
+                        PyErr_Clear();
+                    } catch(...) {
+                    }
+                }
+
                 return res;
             }
         }
     }
 
-    std::string argTupleTypeDesc = PyFunctionInstance::argTupleTypeDescription(self, args, kwargs);
+    std::string argTupleTypeDesc = PyFunctionInstance::argTupleTypeDescription(self, args);
 
     PyErr_Format(
         PyExc_TypeError, "Cannot find a valid overload of '%s' with arguments of type %s",
@@ -101,15 +347,14 @@ std::pair<bool, PyObject*> PyFunctionInstance::tryToCallOverload(
         instance_ptr functionClosure,
         long overloadIx,
         PyObject* self,
-        PyObject* args,
-        PyObject* kwargs,
+        const CallArguments& args,
         ConversionLevel conversionLevel
 ) {
     const Function::Overload& overload(f->getOverloads()[overloadIx]);
 
     FunctionCallArgMapping mapping(overload);
 
-    mapping.pushArguments(self, args, kwargs);
+    mapping.pushArguments(self, args);
 
     if (!mapping.isValid()) {
         return std::make_pair(false, nullptr);
@@ -164,31 +409,15 @@ std::pair<bool, PyObject*> PyFunctionInstance::tryToCallOverload(
         overloadIx,
         mapping,
         self,
-        args,
-        kwargs
+        args
     );
 
     if (returnTypeAndIsException.second) {
         return std::make_pair(true, nullptr);
     }
 
-    Type* returnType = returnTypeAndIsException.first;
-
     //force ourselves to convert to the returnType
-    if (returnType) {
-        try {
-            PyObject* newRes = PyInstance::initializePythonRepresentation(returnType, [&](instance_ptr data) {
-                copyConstructFromPythonInstance(returnType, data, result, ConversionLevel::ImplicitContainers);
-            });
-
-            return std::make_pair(true, newRes);
-        } catch (std::exception& e) {
-            PyErr_SetString(PyExc_TypeError, e.what());
-            return std::make_pair(true, (PyObject*)nullptr);
-        }
-    }
-
-    return std::make_pair(true, incref(result));
+    return std::make_pair(true, convertResultToReturnType(returnTypeAndIsException.first, result));
 }
 
 std::pair<Type*, bool> PyFunctionInstance::getOverloadReturnType(
@@ -232,8 +461,7 @@ std::pair<Type*, bool> PyFunctionInstance::determineReturnTypeForMatchedCall(
     long overloadIx,
     FunctionCallArgMapping& matchedArgs,
     PyObject* self,
-    PyObject* args,
-    PyObject* kwargs
+    const CallArguments& args
 ) {
     std::pair<Type*, bool> returnTypeAndIsException = getOverloadReturnType(f, overloadIx, matchedArgs);
 
@@ -289,7 +517,7 @@ std::pair<Type*, bool> PyFunctionInstance::determineReturnTypeForMatchedCall(
                 for (long matchingIx = nextOverloadIx; matchingIx < topIx && !anyMatched; matchingIx++) {
                     FunctionCallArgMapping subMapping(f->getOverloads()[matchingIx]);
 
-                    subMapping.pushArguments(self, args, kwargs);
+                    subMapping.pushArguments(self, args);
 
                     if (!subMapping.definitelyDoesntMatch(conversionLevel)) {
                         subMapping.applyTypeCoercion(conversionLevel);
@@ -455,8 +683,16 @@ std::pair<bool, PyObject*> PyFunctionInstance::dispatchFunctionCallToNative(
             throw PythonExceptionSet();
         }
 
+        // the runtime is compiling this in the background, so the caller
+        // should use the interpreter for now.
+        bool deferred = res == Py_False;
+
         decref(res);
 
+        if (deferred) {
+            return std::pair<bool, PyObject*>(false, (PyObject*)nullptr);
+        }
+
         const Function::Overload& convertedOverload(convertedF->getOverloads()[overloadIx]);
 
         for (const auto& spec: convertedOverload.getCompiledSpecializations()) {
@@ -538,15 +774,21 @@ std::pair<bool, PyObject*> PyFunctionInstance::dispatchFunctionCallToCompiledSpe
             args.push_back(i.dataPtr());
         }
 
+        specialization.countCall();
+
+        // read the pointer after counting, since the call may have swapped in a new one
         auto functionPtr = specialization.getFuncPtr();
 
-        PyEnsureGilReleased releaseTheGIL;
+        PyEnsureGilReleased releaseTheGIL(specialization.releasesGilImmediately());
 
         try {
             functionPtr(returnData, &args[0]);
         }
         catch(...) {
-            // exceptions coming out of compiled code always use the python interpreter
+            // exceptions coming out of compiled code always use the python interpreter,
+            // though it may not have made the exception object yet
+            PyEnsureGilAcquired getTheGil;
+            NativeException::materialize();
             throw PythonExceptionSet();
         }
     });
@@ -656,7 +898,15 @@ PyObject* PyFunctionInstance::tp_call_concrete(PyObject* args, PyObject* kwargs)
     return PyFunctionInstance::tryToCallAnyOverload(type(), dataPtr(), nullptr, args, kwargs).second;
 }
 
+PyObject* PyFunctionInstance::tp_vectorcall_concrete(PyObject* const* args, size_t nargs, PyObject* kwnames) {
+    return PyFunctionInstance::tryToCallAnyOverload(type(), dataPtr(), nullptr, CallArguments(args, nargs, kwnames)).second;
+}
+
 std::string PyFunctionInstance::argTupleTypeDescription(PyObject* self, PyObject* args, PyObject* kwargs) {
+    return argTupleTypeDescription(self, CallArguments(args, kwargs));
+}
+
+std::string PyFunctionInstance::argTupleTypeDescription(PyObject* self, const CallArguments& args) {
     std::ostringstream outTypes;
     outTypes << "(";
     bool first = true;
@@ -666,40 +916,53 @@ std::string PyFunctionInstance::argTupleTypeDescription(PyObject* self, PyObject
         first = false;
     }
 
-    for (long k = 0; k < PyTuple_Size(args); k++) {
+    for (size_t k = 0; k < args.positionalCount(); k++) {
         if (!first) {
             outTypes << ",";
         } else {
             first = false;
         }
-        outTypes << PyTuple_GetItem(args,k)->ob_type->tp_name;
+        outTypes << args.positional(k)->ob_type->tp_name;
     }
-    if (kwargs) {
-        PyObject *key, *value;
-        Py_ssize_t pos = 0;
 
-        while (kwargs && PyDict_Next(kwargs, &pos, &key, &value)) {
-            if (!first) {
-                outTypes << ",";
-            } else {
-                first = false;
-            }
-            outTypes << PyUnicode_AsUTF8(key) << "=" << value->ob_type->tp_name;
+    args.forEachKeyword([&](PyObject* key, PyObject* value) {
+        if (!first) {
+            outTypes << ",";
+        } else {
+            first = false;
         }
-    }
+        outTypes << PyUnicode_AsUTF8(key) << "=" << value->ob_type->tp_name;
+    });
 
     outTypes << ")";
 
     return outTypes.str();
 }
 
-void PyFunctionInstance::mirrorTypeInformationIntoPyTypeConcrete(Function* inType, PyTypeObject* pyType) {
-    PyObjectHolder overloads(createOverloadPyRepresentation(inType));
+// static
+PyObject* PyFunctionInstance::materializeOverloads(Function* f) {
+    PyTypeObject* pyType = typeObj(f);
+
+    // borrowed
+    PyObject* existing = PyDict_GetItemString(pyType->tp_dict, "overloads");
+
+    if (existing && PyTuple_Check(existing)) {
+        return incref(existing);
+    }
+
+    PyObjectStealer overloads(createOverloadPyRepresentation(f));
 
     if (!overloads) {
-        throw PythonExceptionSet();
+        return NULL;
     }
 
+    PyDict_SetItemString(pyType->tp_dict, "overloads", overloads);
+    PyType_Modified(pyType);
+
+    return incref(overloads);
+}
+
+void PyFunctionInstance::mirrorTypeInformationIntoPyTypeConcrete(Function* inType, PyTypeObject* pyType) {
     PyDict_SetItemString(
         pyType->tp_dict,
         "__name__",
@@ -718,10 +981,14 @@ void PyFunctionInstance::mirrorTypeInformationIntoPyTypeConcrete(Function* inTyp
         PyUnicode_FromString(inType->moduleName().c_str())
     );
 
+    // building the FunctionOverload objects (and the python types of every argument)
+    // is a good part of what it costs to create a Function type, and most of them
+    // never get looked at, so 'overloads' starts out as a descriptor that calls
+    // 'materializeOverloads' the first time someone asks for it.
     PyDict_SetItemString(
         pyType->tp_dict,
         "overloads",
-        overloads
+        staticPythonInstance("typed_python.internals", "lazyFunctionOverloads")
     );
 
     PyObject* closureTypeObj = PyInstance::typePtrToPyTypeRepresentation(inType->getClosureType());
@@ -19,6 +19,7 @@
 #include "PyInstance.hpp"
 
 class FunctionCallArgMapping;
+class CallArguments;
 
 class PyFunctionInstance : public PyInstance {
 public:
@@ -34,6 +35,24 @@ public:
 
     static std::pair<bool, PyObject*> tryToCallAnyOverload(const Function* f, instance_ptr functionClosure, PyObject* self, PyObject* args, PyObject* kwargs);
 
+    static std::pair<bool, PyObject*> tryToCallAnyOverload(
+        const Function* f, instance_ptr functionClosure, PyObject* self, const CallArguments& args
+    );
+
+    // can calls to 'f' use its FunctionDispatchCache at all? This is a property of
+    // its signature, and we remember the answer in the cache.
+    static bool isDispatchCacheable(const Function* f);
+
+    // try to call 'f' through the entry its dispatch cache has for these exact
+    // positional argument types. Returns <false, nullptr> on a miss.
+    static std::pair<bool, PyObject*> tryToCallCachedSpecialization(
+        const Function* f, instance_ptr functionClosure, const CallArguments& args
+    );
+
+    // after the full dispatch path handled a call with positional arguments 'args',
+    // work out which overload and specialization it used and remember them.
+    static void cacheDispatch(const Function* f, const CallArguments& args);
+
     // determine the exact return type of a specific overload. Returns <result, isException>
     static std::pair<Type*, bool> getOverloadReturnType(
         const Function* f,
@@ -49,8 +68,7 @@ public:
         long overloadIx,
         FunctionCallArgMapping& matchedArgs,
         PyObject* self,
-        PyObject* args,
-        PyObject* kwargs
+        const CallArguments& args
     );
 
     // determine the 'compiler type' of an argument 'o'. If 'o' is already the right type, just
@@ -59,13 +77,25 @@ public:
     // returns a new reference to an object.
     static PyObject* prepareArgumentToBePassedToCompiler(PyObject* o);
 
+    // would 'prepareArgumentToBePassedToCompiler' return something other than 'o'?
+    static bool argumentNeedsPreparation(PyObject* o);
+
+    // the arguments an Entrypoint 'f' should dispatch on. If any of them need
+    // 'prepareArgumentToBePassedToCompiler', this fills out 'mappedArgs' and
+    // 'mappedKwargs' with the prepared arguments and refers to them.
+    static CallArguments mapEntrypointArguments(
+        const Function* f,
+        const CallArguments& args,
+        PyObjectHolder& mappedArgs,
+        PyObjectHolder& mappedKwargs
+    );
+
     static std::pair<bool, PyObject*> tryToCallOverload(
         const Function* f,
         instance_ptr funcClosure,
         long overloadIx,
         PyObject* self,
-        PyObject* args,
-        PyObject* kwargs,
+        const CallArguments& args,
         ConversionLevel conversionLevel
     );
 
@@ -93,10 +123,18 @@ public:
 
     static PyObject* createOverloadPyRepresentation(Function* f);
 
+    // build 'f's overloads tuple if we haven't yet, and replace the lazy
+    // placeholder in its type dict with it. Returns a new reference.
+    static PyObject* materializeOverloads(Function* f);
+
     PyObject* tp_call_concrete(PyObject* args, PyObject* kwargs);
 
+    PyObject* tp_vectorcall_concrete(PyObject* const* args, size_t nargs, PyObject* kwnames);
+
     static std::string argTupleTypeDescription(PyObject* self, PyObject* args, PyObject* kwargs);
 
+    static std::string argTupleTypeDescription(PyObject* self, const CallArguments& args);
+
     static void mirrorTypeInformationIntoPyTypeConcrete(Function* inType, PyTypeObject* pyType);
 
     int pyInquiryConcrete(const char* op, const char* opErrRep);
@@ -14,62 +14,98 @@
 ******************************************************************************/
 
 #include "PyGilState.hpp"
-
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <pthread.h>
+
+/*******
+When a thread holding the GIL enters code that doesn't need it, we don't release
+the GIL right away: if it comes straight back (say, compiled code calling an
+interpreted function in a loop) the round trip through the GIL is very slow.
+Instead the thread 'defers' the release by publishing its ReleaseableThreadState
+in 'deferredThreadState', and keeps running while technically still holding
+the GIL. Then either
+
+    * the thread comes back and takes its state out of the slot, in which case
+      it never let go of the GIL, or
+    * a release thread (see gilReleaseThreadLoop) takes it out of the slot a
+      little later and releases the GIL on the thread's behalf.
+
+Whoever exchanges the slot back to nullptr owns the deferral, so neither side
+takes a lock. Only the thread holding the GIL can defer, so one slot is enough.
+
+Release threads block on a condition variable while there's nothing deferred,
+rather than polling. Deferring only touches the mutex if one of them is asleep.
+*******/
 
 class ReleaseableThreadState;
 
-// global mutex to coordinate acquirers and releasers
-// note that we hold it in a pointer with a global reference to ensure
-// that when the program is shut down we don't destroy the mutex object,
-// as our background thread is not going to get released.
-std::mutex* gilReleaseMutex = new std::mutex;
-
 // the threadstate currently released by this thread
 thread_local ReleaseableThreadState* curPyThreadState = 0;
 
-ReleaseableThreadState* waitingPyThreadState = 0;
+// the thread holding the GIL, if it has deferred releasing it
+std::atomic<ReleaseableThreadState*> deferredThreadState(nullptr);
+
+// how many release threads are running. If there are none, we release immediately.
+std::atomic<int64_t> gilReleaseThreadLoopsActive(0);
 
-// is there anybody to wake us up?
-int64_t gilReleaseThreadLoopActive = 0;
+// how many release threads are blocked waiting for somebody to defer
+std::atomic<int64_t> gilReleaseThreadLoopsSleeping(0);
 
+std::atomic<int64_t> gilReleaseThreadLoopSleepMicroseconds(50);
 
-int64_t gilReleaseThreadLoopSleepMicroseconds = 50;
+// we hold these in pointers that we never delete so that they outlive
+// the release threads, which don't get stopped when the program exits.
+std::mutex* gilReleaseWakeupMutex = new std::mutex;
+std::condition_variable* gilReleaseWakeup = new std::condition_variable;
 
 
+static void wakeGilReleaseThreads() {
+    std::lock_guard<std::mutex> lock(*gilReleaseWakeupMutex);
+    gilReleaseWakeup->notify_all();
+}
+
 void PyEnsureGilReleased::setGilReleaseThreadLoopSleepMicroseconds(int64_t ms) {
     gilReleaseThreadLoopSleepMicroseconds = ms;
+    wakeGilReleaseThreads();
 }
 
 class ReleaseableThreadState {
 public:
     // construct a releasable thread state. We must be
     // holding the GIL
-    ReleaseableThreadState() {
-        std::lock_guard<std::mutex> lock(*gilReleaseMutex);
-
-        if (!gilReleaseThreadLoopActive) {
-            // save our state immediately
-            threadState = PyEval_SaveThread();
-            isReleased = true;
-        } else {
-            threadState = PyThreadState_Get();
-            isReleased = false;
-            waitingPyThreadState = this;
+    ReleaseableThreadState(bool releaseImmediately = false) :
+        threadState(PyThreadState_Get()),
+        isReleased(false)
+    {
+        if (releaseImmediately || !gilReleaseThreadLoopsActive) {
+            release_();
+            return;
         }
-    }
 
-    // release the current thread state.
-    void release() {
-        std::lock_guard<std::mutex> lock(*gilReleaseMutex);
+        deferredThreadState = this;
 
-        if (isReleased) {
-            return;
+        // a release thread that announced it was going to sleep before we
+        // published ourselves may not have seen us.
+        if (gilReleaseThreadLoopsSleeping) {
+            wakeGilReleaseThreads();
         }
 
-        release_();
+        // the last release thread may have shut down before we published
+        // ourselves, in which case nobody is going to release us.
+        if (!gilReleaseThreadLoopsActive) {
+            ReleaseableThreadState* expected = this;
+
+            if (deferredThreadState.compare_exchange_strong(expected, nullptr)) {
+                release_();
+            }
+        }
     }
 
-    // release the lock given that it's held and we're holding the gilReleaseMutex
+    // release the GIL on behalf of the thread that owns this state. The caller
+    // must own the deferral, and may not touch us after this returns, since our
+    // owner is free to delete us as soon as 'isReleased' is set.
     void release_() {
         if (PyThreadState_Get() != threadState) {
             std::cerr << "somehow another thread got the threadstate in ReleaseableThreadState" << std::endl;
@@ -81,30 +117,21 @@ public:
         // release the GIL. we're not holding it but it should be OK to release it from
         // this thread since the other thread is promising not to touch python anymore
         threadState = PyEval_SaveThread();
-        isReleased = true;
+        isReleased.store(true, std::memory_order_release);
     }
 
-    // reacquire the current thread state. We must be holding the gilReleaseMutex
+    // reacquire the GIL. Must be called from the thread that created us.
     void acquire() {
-        {
-            std::lock_guard<std::mutex> lock(*gilReleaseMutex);
+        ReleaseableThreadState* expected = this;
 
-            if (isReleased) {
-                isReleased = false;
-            } else {
-                // we must be holding it
-                if (waitingPyThreadState != this) {
-                    std::cerr << "somehow we are not yet released, and yet not also waiting." << std::endl;
-
-                    // this is a fatal error
-                    asm("int3");
-                }
-
-                waitingPyThreadState = nullptr;
+        if (deferredThreadState.compare_exchange_strong(expected, nullptr)) {
+            // nobody released it, so we're still holding the GIL
+            return;
+        }
 
-                // reacquire our own lock. we're holding the GIL at this point.
-                return;
-            }
+        // a release thread took the deferral, and may still be releasing
+        while (!isReleased.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
         }
 
         PyEval_RestoreThread(threadState);
@@ -112,19 +139,37 @@ public:
 
     PyThreadState* threadState;
 
-    bool isReleased;
+    std::atomic<bool> isReleased;
 };
 
 
-PyEnsureGilReleased::PyEnsureGilReleased() :
+// if a thread has deferred releasing the GIL, release it for them
+static void releaseDeferredThreadState() {
+    ReleaseableThreadState* state = deferredThreadState.exchange(nullptr);
+
+    if (state) {
+        state->release_();
+    }
+}
+
+
+PyEnsureGilReleased::PyEnsureGilReleased(bool releaseImmediately) :
     m_should_reacquire(false)
 {
     if (curPyThreadState == nullptr) {
-        curPyThreadState = new ReleaseableThreadState();
+        curPyThreadState = new ReleaseableThreadState(releaseImmediately);
         m_should_reacquire = true;
     }
 }
 
+void PyEnsureGilReleased::finishDeferredRelease() {
+    ReleaseableThreadState* expected = curPyThreadState;
+
+    if (expected && deferredThreadState.compare_exchange_strong(expected, nullptr)) {
+        curPyThreadState->release_();
+    }
+}
+
 PyEnsureGilReleased::~PyEnsureGilReleased() {
     if (m_should_reacquire) {
         curPyThreadState->acquire();
@@ -160,46 +205,65 @@ void assertHoldingTheGil() {
     }
 }
 
-// watch in a loop, waking up periodically to see if a thread
-// wants to release its lock on the GIL
+// release the GIL on behalf of threads that deferred releasing it, a little
+// while after they deferred. While nobody has, we sleep until woken.
 void PyEnsureGilReleased::gilReleaseThreadLoop() {
-    {
-        std::lock_guard<std::mutex> lock(*gilReleaseMutex);
-        gilReleaseThreadLoopActive = 1;
-    }
+    gilReleaseThreadLoopsActive++;
 
     while (true) {
-        if (gilReleaseThreadLoopSleepMicroseconds <= 0) {
-            {
-                // indicate that we are not active
-                std::lock_guard<std::mutex> lock(*gilReleaseMutex);
-                gilReleaseThreadLoopActive = 0;
-
-                // if anybody is asleep, now's the time to wake them
-                if (waitingPyThreadState) {
-                    waitingPyThreadState->release_();
-                    waitingPyThreadState = 0;
-                }
-            }
+        int64_t sleepMicroseconds = gilReleaseThreadLoopSleepMicroseconds;
 
-            while (gilReleaseThreadLoopSleepMicroseconds <= 0) {
-                usleep(10000);
-            }
+        if (sleepMicroseconds <= 0) {
+            // indicate that we are not active, and if anybody is deferred,
+            // now's the time to release them
+            gilReleaseThreadLoopsActive--;
+            releaseDeferredThreadState();
 
             {
-                std::lock_guard<std::mutex> lock(*gilReleaseMutex);
-                gilReleaseThreadLoopActive = 1;
+                std::unique_lock<std::mutex> lock(*gilReleaseWakeupMutex);
+                gilReleaseWakeup->wait(lock, []() { return gilReleaseThreadLoopSleepMicroseconds > 0; });
             }
-        } else {
-            usleep(gilReleaseThreadLoopSleepMicroseconds);
 
-            {
-                std::lock_guard<std::mutex> lock(*gilReleaseMutex);
-                if (waitingPyThreadState) {
-                    waitingPyThreadState->release_();
-                    waitingPyThreadState = 0;
-                }
-            }
+            gilReleaseThreadLoopsActive++;
+            continue;
         }
+
+        if (!deferredThreadState) {
+            std::unique_lock<std::mutex> lock(*gilReleaseWakeupMutex);
+
+            // announce that we're going to sleep before checking the slot one last
+            // time, so that a thread deferring concurrently either sees us asleep
+            // and wakes us, or is seen by us here.
+            gilReleaseThreadLoopsSleeping++;
+
+            gilReleaseWakeup->wait(lock, []() {
+                return deferredThreadState || gilReleaseThreadLoopSleepMicroseconds <= 0;
+            });
+
+            gilReleaseThreadLoopsSleeping--;
+
+            continue;
+        }
+
+        usleep(sleepMicroseconds);
+
+        releaseDeferredThreadState();
     }
 }
+
+// a forked child has none of the release threads, and one of them may have been
+// holding the wakeup mutex when we forked. We forget about them, so the child
+// releases the GIL immediately until somebody starts a new loop (__init__.py
+// does that for us), and we leak the old mutex rather than unlock it.
+static void resetGilReleaseStateInChild() {
+    gilReleaseThreadLoopsActive = 0;
+    gilReleaseThreadLoopsSleeping = 0;
+    deferredThreadState = nullptr;
+
+    gilReleaseWakeupMutex = new std::mutex;
+    gilReleaseWakeup = new std::condition_variable;
+}
+
+void PyEnsureGilReleased::installForkHandlers() {
+    pthread_atfork(nullptr, nullptr, resetGilReleaseStateInChild);
+}
@@ -20,10 +20,11 @@
 
 //scoped object to ensure we're not holding the GIL. If we've
 //already released it, this is a no-op. Upon destruction, we
-//reacquire it.
+//reacquire it. Normally the release is deferred, so that short
+//calls never pay for it. 'releaseImmediately' skips the deferral.
 class PyEnsureGilReleased {
 public:
-    PyEnsureGilReleased();
+    explicit PyEnsureGilReleased(bool releaseImmediately = false);
 
     ~PyEnsureGilReleased();
 
@@ -31,6 +32,13 @@ public:
 
     static void setGilReleaseThreadLoopSleepMicroseconds(int64_t ms);
 
+    // if this thread deferred releasing the GIL, release it now. Call this
+    // before blocking, so other threads don't wait on a release thread.
+    static void finishDeferredRelease();
+
+    // make sure a process we fork doesn't wait on release threads it doesn't have
+    static void installForkHandlers();
+
 private:
     bool m_should_reacquire;
 };
@@ -51,6 +51,11 @@
 #include "PyTemporaryReferenceTracer.hpp"
 #include "PySetInstance.hpp"
 #include "_types.hpp"
+#include "FunctionCallArgMapping.hpp"
+
+#if PY_MINOR_VERSION == 8
+#define Py_TPFLAGS_HAVE_VECTORCALL _Py_TPFLAGS_HAVE_VECTORCALL
+#endif
 
 Type* PyInstance::type() {
     return extractTypeFrom(((PyObject*)this)->ob_type);
@@ -118,7 +123,40 @@ void PyInstance::tp_dealloc(PyObject* self) {
 
     wrapper->teardown();
 
-    Py_TYPE(self)->tp_free((PyObject*)self);
+    // instances of python subclasses of our types come through here too, but
+    // only instances of our own types can go on the freelist
+    PyTypeObject* typeObj = Py_TYPE(self);
+
+    if (isNativeType(typeObj)) {
+        NativeTypeWrapper* native = (NativeTypeWrapper*)typeObj;
+
+        if (native->mFreelistCount < NativeTypeWrapper::FREELIST_SIZE) {
+            native->mFreelist[native->mFreelistCount++] = self;
+            return;
+        }
+    }
+
+    typeObj->tp_free((PyObject*)self);
+}
+
+// static
+PyInstance* PyInstance::allocate(PyTypeObject* typeObj) {
+    if (isNativeType(typeObj)) {
+        NativeTypeWrapper* native = (NativeTypeWrapper*)typeObj;
+
+        if (native->mFreelistCount) {
+            PyObject* res = native->mFreelist[--native->mFreelistCount];
+
+            // leave it exactly as tp_alloc would have: zeroed, with a fresh
+            // refcount
+            memset((char*)res + sizeof(PyObject), 0, typeObj->tp_basicsize - sizeof(PyObject));
+            PyObject_Init(res, typeObj);
+
+            return (PyInstance*)res;
+        }
+    }
+
+    return (PyInstance*)typeObj->tp_alloc(typeObj, 0);
 }
 
 // static
@@ -262,6 +300,23 @@ void PyInstance::constructFromPythonArgumentsConcrete(Type* t, uint8_t* data, Py
 
 // static
 PyObject* PyInstance::extractPythonObject(instance_ptr data, Type* eltType, PyObject* createTemporaryRefOf) {
+    // the most common members and elements by far, which don't need the
+    // category dispatch or the exception translation below
+    switch (eltType->getTypeCategory()) {
+        case Type::TypeCategory::catInt64:
+            return PyLong_FromLongLong(*(int64_t*)data);
+        case Type::TypeCategory::catFloat64:
+            return PyFloat_FromDouble(*(double*)data);
+        case Type::TypeCategory::catBool:
+            return incref(*(bool*)data ? Py_True : Py_False);
+        case Type::TypeCategory::catNone:
+            return incref(Py_None);
+        case Type::TypeCategory::catString:
+            return PyStringInstance::extractPythonObjectConcrete((StringType*)eltType, data);
+        default:
+            break;
+    }
+
     return translateExceptionToPyObject([&]() {
         if (eltType->getTypeCategory() == Type::TypeCategory::catHeldClass && createTemporaryRefOf) {
             // we never return 'held class' instances directly. Instead, we
@@ -900,17 +955,29 @@ PyBufferProcs* PyInstance::bufferProcs() {
     return procs;
 }
 
+// static
+PyBufferProcs* PyInstance::bufferProcsFor(Type* t) {
+    if (t->isTupleOrListOf() && PyTupleOrListOfInstance::bufferFormatFor(((TupleOrListOfType*)t)->getEltType())) {
+        return PyTupleOrListOfInstance::bufferExportProcs();
+    }
+
+    return bufferProcs();
+}
+
 /**
     Determine if a given PyTypeObject* is one of our types.
 
     We are using pointer-equality with the tp_as_buffer function pointer
     that we set on our types. This should be safe because:
     - No other type can be pointing to it, and
-    - All of our types point to the unique instance of PyBufferProcs
+    - All of our types point to the unique instance of PyBufferProcs, or
+      (TupleOf and ListOf of register types, which export their elements)
+      to the unique instance PyTupleOrListOfInstance::bufferExportProcs
 */
 // static
 bool PyInstance::isNativeType(PyTypeObject* typeObj) {
-    return typeObj->tp_as_buffer == bufferProcs();
+    return typeObj->tp_as_buffer == bufferProcs()
+        || typeObj->tp_as_buffer == PyTupleOrListOfInstance::bufferExportProcs();
 }
 
 /**
@@ -1199,14 +1266,17 @@ PyTypeObject* PyInstance::typeObjInternal(Type* inType) {
     types[inType] = new NativeTypeWrapper { {
             PyVarObject_HEAD_INIT(NULL, 0)              // TYPE (c.f., Type Objects)
             .tp_name = (new std::string(inType->nameWithModule()))->c_str(),          // const char*
-            .tp_basicsize = sizeof(PyInstance),         // Py_ssize_t
+            .tp_basicsize = typeSupportsVectorcall(inType) ?
+                (Py_ssize_t)(sizeof(PyInstance) + sizeof(void*))
+            :   (Py_ssize_t)sizeof(PyInstance),         // Py_ssize_t
             .tp_itemsize = 0,                           // Py_ssize_t
             .tp_dealloc = PyInstance::tp_dealloc,       // destructor
 
             #if PY_MINOR_VERSION < 8
             .tp_print = 0,                              // printfunc
             #else
-            .tp_vectorcall_offset = 0,                  // printfunc  (Changed to tp_vectorcall_offset in Python 3.8)
+            .tp_vectorcall_offset = typeSupportsVectorcall(inType) ?
+                (Py_ssize_t)sizeof(PyInstance) : 0,     // printfunc  (Changed to tp_vectorcall_offset in Python 3.8)
             #endif
 
             .tp_getattr = 0,                            // getattrfunc
@@ -1221,10 +1291,14 @@ PyTypeObject* PyInstance::typeObjInternal(Type* inType) {
             .tp_str = tp_str,                           // reprfunc
             .tp_getattro = PyInstance::tp_getattro,     // getattrofunc
             .tp_setattro = PyInstance::tp_setattro,     // setattrofunc
-            .tp_as_buffer = bufferProcs(),              // PyBufferProcs*
-            .tp_flags = typeCanBeSubclassed(inType) ?
+            .tp_as_buffer = bufferProcsFor(inType),     // PyBufferProcs*
+            .tp_flags = (typeCanBeSubclassed(inType) ?
                 Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE
-            :   Py_TPFLAGS_DEFAULT,                     // unsigned long
+            :   Py_TPFLAGS_DEFAULT)
+            #if PY_MINOR_VERSION >= 8
+                | (typeSupportsVectorcall(inType) ? Py_TPFLAGS_HAVE_VECTORCALL : 0)
+            #endif
+            ,                                           // unsigned long
             .tp_doc = inType->doc(),                    // const char*
             .tp_traverse = 0,                           // traverseproc
             .tp_clear = 0,                              // inquiry
@@ -1343,6 +1417,34 @@ PyObject* PyInstance::tp_call(PyObject* o, PyObject* args, PyObject* kwargs) {
     });
 }
 
+#if PY_MINOR_VERSION >= 8
+// static
+PyObject* PyInstance::tp_vectorcall(PyObject* o, PyObject* const* args, size_t nargsf, PyObject* kwnames) {
+    return specializeForType(o, [&](auto& subtype) {
+        return subtype.tp_vectorcall_concrete(args, PyVectorcall_NARGS(nargsf), kwnames);
+    });
+}
+#endif
+
+PyObject* PyInstance::tp_vectorcall_concrete(PyObject* const* args, size_t nargs, PyObject* kwnames) {
+    CallArguments callArgs(args, nargs, kwnames);
+
+    PyObjectStealer argTuple(callArgs.buildTuple());
+    PyObjectStealer kwargs(callArgs.buildKwargs());
+
+    return tp_call((PyObject*)this, argTuple, kwargs);
+}
+
+// static
+bool PyInstance::typeSupportsVectorcall(Type* t) {
+#   if PY_MINOR_VERSION >= 8
+    return t->getTypeCategory() == Type::TypeCategory::catFunction
+        || t->getTypeCategory() == Type::TypeCategory::catBoundMethod;
+#   else
+    return false;
+#   endif
+}
+
 PyObject* PyInstance::tp_call_concrete(PyObject* args, PyObject* kwargs) {
     PyErr_Format(PyExc_TypeError, "'%s' object is not callable", type()->name().c_str());
     return nullptr;
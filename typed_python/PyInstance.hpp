@@ -22,8 +22,15 @@
 
 //extension of PyTypeObject that adds a Type* at the end.
 struct NativeTypeWrapper {
+    static const int FREELIST_SIZE = 16;
+
     PyTypeObject typeObj;
     Type* mType;
+
+    // torn-down instances of exactly this type, which PyInstance::allocate
+    // hands out again instead of going back to tp_alloc.
+    PyObject* mFreelist[FREELIST_SIZE];
+    int mFreelistCount;
 };
 
 //extension of PyTypeObject that adds a TypeCategory at the end.
@@ -89,6 +96,13 @@ public:
         mKeepalive = nullptr;
 
         new (&mContainingInstance) Instance();
+
+#       if PY_MINOR_VERSION >= 8
+        // types that support vectorcall keep the function pointer just past us
+        if (Py_TYPE(this)->tp_vectorcall_offset) {
+            *(vectorcallfunc*)((char*)this + Py_TYPE(this)->tp_vectorcall_offset) = PyInstance::tp_vectorcall;
+        }
+#       endif
     }
 
     // called when this python object is destroyed. Gives us a chance to do cleanup actions
@@ -337,8 +351,7 @@ public:
     static PyObject* initialize(Type* eltType, const init_func& f) {
         eltType->assertForwardsResolvedSufficientlyToInstantiate();
 
-        PyInstance* self =
-            (PyInstance*)typeObj(eltType)->tp_alloc(typeObj(eltType), 0);
+        PyInstance* self = allocate(typeObj(eltType));
 
         self->initializeEmpty();
 
@@ -355,8 +368,7 @@ public:
     static PyObject* initializeTemporaryRef(Type* eltType, instance_ptr data) {
         eltType->assertForwardsResolvedSufficientlyToInstantiate();
 
-        PyInstance* self =
-            (PyInstance*)typeObj(eltType)->tp_alloc(typeObj(eltType), 0);
+        PyInstance* self = allocate(typeObj(eltType));
 
         self->initializeEmpty();
         self->mTemporaryRefTo = data;
@@ -406,6 +418,11 @@ public:
 
     static void tp_dealloc(PyObject* self);
 
+    // allocate an uninitialized instance of 'typeObj', reusing one from its
+    // freelist if it's one of our types and it has one. Callers still have to
+    // call 'initializeEmpty'.
+    static PyInstance* allocate(PyTypeObject* typeObj);
+
     static bool pyValCouldBeOfType(Type* t, PyObject* pyRepresentation, ConversionLevel level);
 
     /**
@@ -592,6 +609,18 @@ public:
 
     PyObject* tp_call_concrete(PyObject* args, PyObject* kwargs);
 
+#   if PY_MINOR_VERSION >= 8
+    static PyObject* tp_vectorcall(PyObject* o, PyObject* const* args, size_t nargsf, PyObject* kwnames);
+#   endif
+
+    // types that don't call any faster with the arguments in an array just pack
+    // them into a tuple and dict for tp_call
+    PyObject* tp_vectorcall_concrete(PyObject* const* args, size_t nargs, PyObject* kwnames);
+
+    // do instances of 't' support vectorcall (PEP 590)? Their python type then
+    // has room for the vectorcallfunc after the PyInstance.
+    static bool typeSupportsVectorcall(Type* t);
+
     static PyObject* tp_getattro(PyObject *o, PyObject* attrName);
 
     PyObject* tp_getattr_concrete(PyObject* attrPyObj, const char* attrName);
@@ -632,6 +661,8 @@ public:
 
     static PyBufferProcs* bufferProcs();
 
+    static PyBufferProcs* bufferProcsFor(Type* t);
+
     static PyTypeObject* allTypesBaseType();
 
     static PyTypeObject* typeCategoryBaseType(Type::TypeCategory category);
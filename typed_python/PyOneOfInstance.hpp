@@ -29,8 +29,8 @@ public:
 
               if (pyValCouldBeOfType(subtype, pyRepresentation, levelToUse)) {
                   try {
-                      copyConstructFromPythonInstance(subtype, tgt+1, pyRepresentation, levelToUse);
-                      *(uint8_t*)tgt = k;
+                      copyConstructFromPythonInstance(subtype, oneOf->eltPtr(tgt), pyRepresentation, levelToUse);
+                      oneOf->setWhichIndex(tgt, k);
                       return true;
                   } catch(PythonExceptionSet& e) {
                       PyErr_Clear();
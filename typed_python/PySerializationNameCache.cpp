@@ -0,0 +1,159 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "PySerializationNameCache.hpp"
+
+
+PyDoc_STRVAR(PySerializationNameCache_doc,
+    "SerializationNameCache()\n\n"
+    "Remembers the names a SerializationContext gave objects, and the objects it\n"
+    "found for names, so that serializing and deserializing don't call\n"
+    "'nameForObject' and 'objectFromName' again for the same object or name.\n\n"
+    "A SerializationContext makes its own, and clears it whenever its names change."
+);
+
+PyDoc_STRVAR(PySerializationNameCache_clear_doc,
+    "SerializationNameCache.clear() -> None\n\n"
+    "Forget everything. Call this if you change the names a context knows about\n"
+    "other than with 'addNamedObject' or 'dropNamedObject'."
+);
+
+PyMethodDef PySerializationNameCacheInstance_methods[] = {
+    {"clear", (PyCFunction)PySerializationNameCache::clear, METH_VARARGS | METH_KEYWORDS, PySerializationNameCache_clear_doc},
+    {NULL}  /* Sentinel */
+};
+
+PySequenceMethods PySerializationNameCache_sequence_methods = {
+    .sq_length = (lenfunc)PySerializationNameCache::len
+};
+
+/* static */
+void PySerializationNameCache::dealloc(PySerializationNameCache *self)
+{
+    self->mCache.~shared_ptr();
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+/* static */
+PyObject* PySerializationNameCache::new_(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PySerializationNameCache* self;
+
+    self = (PySerializationNameCache*)type->tp_alloc(type, 0);
+
+    if (self != NULL) {
+        new (&self->mCache) std::shared_ptr<SerializationNameCache>(new SerializationNameCache());
+    }
+
+    return (PyObject*)self;
+}
+
+/* static */
+int PySerializationNameCache::init(PySerializationNameCache *self, PyObject *args, PyObject *kwargs)
+{
+    static const char* kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* static */
+PyObject* PySerializationNameCache::clear(PySerializationNameCache* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    self->mCache->clear();
+
+    return incref(Py_None);
+}
+
+/* static */
+Py_ssize_t PySerializationNameCache::len(PySerializationNameCache* self)
+{
+    return self->mCache->size();
+}
+
+/* static */
+std::shared_ptr<SerializationNameCache> PySerializationNameCache::cacheFor(PyObject* o) {
+    if (!PyObject_TypeCheck(o, &PyType_SerializationNameCache)) {
+        return nullptr;
+    }
+
+    return ((PySerializationNameCache*)o)->mCache;
+}
+
+
+PyTypeObject PyType_SerializationNameCache = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "SerializationNameCache",
+    .tp_basicsize = sizeof(PySerializationNameCache),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor) PySerializationNameCache::dealloc,
+    #if PY_MINOR_VERSION < 8
+    .tp_print = 0,
+    #else
+    .tp_vectorcall_offset = 0,                  // printfunc  (Changed to tp_vectorcall_offset in Python 3.8)
+    #endif
+    .tp_getattr = 0,
+    .tp_setattr = 0,
+    .tp_as_async = 0,
+    .tp_repr = 0,
+    .tp_as_number = 0,
+    .tp_as_sequence = &PySerializationNameCache_sequence_methods,
+    .tp_as_mapping = 0,
+    .tp_hash = 0,
+    .tp_call = 0,
+    .tp_str = 0,
+    .tp_getattro = 0,
+    .tp_setattro = 0,
+    .tp_as_buffer = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = PySerializationNameCache_doc,
+    .tp_traverse = 0,
+    .tp_clear = 0,
+    .tp_richcompare = 0,
+    .tp_weaklistoffset = 0,
+    .tp_iter = 0,
+    .tp_iternext = 0,
+    .tp_methods = PySerializationNameCacheInstance_methods,
+    .tp_members = 0,
+    .tp_getset = 0,
+    .tp_base = 0,
+    .tp_dict = 0,
+    .tp_descr_get = 0,
+    .tp_descr_set = 0,
+    .tp_dictoffset = 0,
+    .tp_init = (initproc) PySerializationNameCache::init,
+    .tp_alloc = 0,
+    .tp_new = PySerializationNameCache::new_,
+    .tp_free = 0,
+    .tp_is_gc = 0,
+    .tp_bases = 0,
+    .tp_mro = 0,
+    .tp_cache = 0,
+    .tp_subclasses = 0,
+    .tp_weaklist = 0,
+    .tp_del = 0,
+    .tp_version_tag = 0,
+    .tp_finalize = 0,
+};
@@ -0,0 +1,45 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "PyInstance.hpp"
+#include "SerializationNameCache.hpp"
+#include <memory>
+
+// the python face of a SerializationNameCache. SerializationContexts hold one of
+// these, and the PythonSerializationContexts built from them share its cache.
+class PySerializationNameCache {
+public:
+    PyObject_HEAD
+
+    std::shared_ptr<SerializationNameCache> mCache;
+
+    static void dealloc(PySerializationNameCache *self);
+
+    static PyObject *new_(PyTypeObject *type, PyObject *args, PyObject *kwargs);
+
+    static int init(PySerializationNameCache *self, PyObject *args, PyObject *kwargs);
+
+    static PyObject* clear(PySerializationNameCache* self, PyObject* args, PyObject* kwargs);
+
+    static Py_ssize_t len(PySerializationNameCache* self);
+
+    // the cache inside 'o', or nullptr if it isn't a SerializationNameCache
+    static std::shared_ptr<SerializationNameCache> cacheFor(PyObject* o);
+};
+
+extern PyTypeObject PyType_SerializationNameCache;
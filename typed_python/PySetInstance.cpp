@@ -16,11 +16,12 @@
 #include "PySetInstance.hpp"
 
 void PySetInstance::getDataFromNative(PySetInstance* src, std::function<void(instance_ptr)> func) {
-    for (size_t i = 0; i < src->type()->slotCount(src->dataPtr()); ++i) {
-        if (src->type()->slotPopulated(src->dataPtr(), i)) {
-            instance_ptr key = src->type()->keyAtSlot(src->dataPtr(), i);
-            func(key);
-        }
+    SetType* srcType = src->type();
+    instance_ptr srcPtr = src->dataPtr();
+
+    for (int64_t i = srcType->nextPopulatedSlot(srcPtr, 0); i < srcType->slotCount(srcPtr);
+            i = srcType->nextPopulatedSlot(srcPtr, i + 1)) {
+        func(srcType->keyAtSlot(srcPtr, i));
     }
 }
 
@@ -153,6 +154,55 @@ PyObject* PySetInstance::setClear(PyObject* o, PyObject* args) {
     Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(setCompact_doc,
+    "s.compact() -> None, and s releases any storage beyond what its elements need"
+    );
+PyObject* PySetInstance::setCompact(PyObject* o, PyObject* args) {
+    if (args && PyTuple_Size(args) != 0) {
+        PyErr_SetString(PyExc_TypeError, "Set.compact takes no arguments");
+        return NULL;
+    }
+    PySetInstance* self_w = (PySetInstance*)o;
+    self_w->type()->compact(self_w->dataPtr());
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(setFromList_doc,
+    "Set(T).fromList(elements) -> Set(T)\n\n"
+    "Construct a Set from a sequence of elements, sizing the table once up front.\n"
+    );
+PyObject* PySetInstance::fromList(PyObject* cls, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"elements", NULL};
+
+    PyObject* elements;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &elements)) {
+        return nullptr;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        Type* selfType = PyInstance::unwrapTypeArgToTypePtr(cls);
+
+        if (!selfType || selfType->getTypeCategory() != Type::TypeCategory::catSet) {
+            throw std::runtime_error("Expected cls to be a Set type");
+        }
+
+        SetType* setT = (SetType*)selfType;
+        ListOfType* listT = ListOfType::Make(setT->keyType());
+
+        Instance eltList(listT, [&](instance_ptr data) {
+            copyConstructFromPythonInstance(listT, data, elements, ConversionLevel::ImplicitContainers);
+        });
+
+        Instance result(setT, [&](instance_ptr data) {
+            setT->constructor(data);
+            setT->insertElements(data, listT->eltPtr(eltList.data(), 0), listT->count(eltList.data()));
+        });
+
+        return PyInstance::fromInstance(result);
+    });
+}
+
 void PySetInstance::copy_elements(PyObject* dst, PyObject* src) {
     PySetInstance* dst_w = (PySetInstance*)dst;
     Type* src_type = extractTypeFrom(Py_TYPE(src));
@@ -160,9 +210,7 @@ void PySetInstance::copy_elements(PyObject* dst, PyObject* src) {
     // element type, and if so, bypass the python interpreter and insert the elements directly.
     if (src_type && (src_type->getTypeCategory() == Type::TypeCategory::catSet)
         && ((SetType*)src_type)->keyType() == dst_w->type()->keyType()) {
-        getDataFromNative((PySetInstance*)src, [&](instance_ptr key) {
-            insertKey(dst_w, src, key);
-        });
+        dst_w->type()->unionInPlace(dst_w->dataPtr(), ((PySetInstance*)src)->dataPtr());
     } else if (src_type
                && (src_type->getTypeCategory() == Type::TypeCategory::catListOf
                    || src_type->getTypeCategory() == Type::TypeCategory::catTupleOf)
@@ -223,12 +271,7 @@ PyObject* PySetInstance::set_intersection(PyObject* o, PyObject* other) {
     try {
         if (src_type && (src_type->getTypeCategory() == Type::TypeCategory::catSet)
             && ((SetType*)src_type)->keyType() == self_w->type()->keyType()) {
-            getDataFromNative((PySetInstance*)other, [&](instance_ptr key) {
-                instance_ptr existingLoc = self_w->type()->lookupKey(self_w->dataPtr(), key);
-                if (existingLoc) {
-                    insertKey(new_inst, other, key);
-                }
-            });
+            self_w->type()->intersection(new_inst->dataPtr(), self_w->dataPtr(), ((PySetInstance*)other)->dataPtr());
         } else if (src_type
                    && (src_type->getTypeCategory() == Type::TypeCategory::catListOf
                        || src_type->getTypeCategory() == Type::TypeCategory::catTupleOf)
@@ -274,15 +317,8 @@ int PySetInstance::set_intersection_update(PyObject* o, PyObject* other) {
 
     try {
         if (fastpath) {
-            SetType* o_type = (SetType*)extractTypeFrom(o->ob_type);
             PySetInstance *o_w = (PySetInstance*)o;
-            PySetInstance *other_w = (PySetInstance*)other;
-            o_type->visitSetElements(o_w->dataPtr(), [&](instance_ptr item) {
-                if (!o_type->lookupKey(other_w->dataPtr(), item)) {
-                    o_type->discard(o_w->dataPtr(), item);
-                }
-                return true;
-            });
+            o_w->type()->intersectionInPlace(o_w->dataPtr(), ((PySetInstance*)other)->dataPtr());
         }
         // TODO: implement efficient algorithms for sequence objects
         // else if (PySequence_Check(other)) {
@@ -327,13 +363,7 @@ PyObject* PySetInstance::set_difference(PyObject* o, PyObject* other) {
         new_inst->mIteratorFlag = 0;
 
         try {
-            PySetInstance* other_w = (PySetInstance*)other;
-            getDataFromNative((PySetInstance*)o, [&](instance_ptr key) {
-                instance_ptr existingLoc = other_w->type()->lookupKey(other_w->dataPtr(), key);
-                if (!existingLoc) {
-                    insertKey(new_inst, other, key);
-                }
-            });
+            self_w->type()->difference(new_inst->dataPtr(), self_w->dataPtr(), ((PySetInstance*)other)->dataPtr());
         } catch (PythonExceptionSet& e) {
             decref((PyObject*)new_inst);
             return NULL;
@@ -363,8 +393,17 @@ int PySetInstance::set_difference_update(PyObject* o, PyObject* other) {
         return 0;
     }
 
+    PySetInstance* self_w = (PySetInstance*)o;
+    Type* src_type = extractTypeFrom(Py_TYPE(other));
+
     int ret = 0;
     try {
+        if (src_type && (src_type->getTypeCategory() == Type::TypeCategory::catSet)
+                && ((SetType*)src_type)->keyType() == self_w->type()->keyType()) {
+            self_w->type()->differenceInPlace(self_w->dataPtr(), ((PySetInstance*)other)->dataPtr());
+            return 0;
+        }
+
         iterateWithEarlyExit(other, [&](PyObject* item) {
             if (!try_remove(o, item)) {
                 ret = -1;
@@ -480,19 +519,7 @@ PyObject* PySetInstance::set_symmetric_difference(PyObject* o, PyObject* other)
         new_inst->mIteratorFlag = 0;
 
         try {
-            PySetInstance* other_w = (PySetInstance*)other;
-            getDataFromNative((PySetInstance*)o, [&](instance_ptr key) {
-                instance_ptr existingLoc = other_w->type()->lookupKey(other_w->dataPtr(), key);
-                if (!existingLoc) {
-                    insertKey(new_inst, other, key);
-                }
-            });
-            getDataFromNative((PySetInstance*)other, [&](instance_ptr key) {
-                instance_ptr existingLoc = self_w->type()->lookupKey(self_w->dataPtr(), key);
-                if (!existingLoc) {
-                    insertKey(new_inst, o, key);
-                }
-            });
+            self_w->type()->symmetricDifference(new_inst->dataPtr(), self_w->dataPtr(), ((PySetInstance*)other)->dataPtr());
         } catch (PythonExceptionSet& e) {
             decref((PyObject*)new_inst);
             return NULL;
@@ -524,6 +551,21 @@ int PySetInstance::set_symmetric_difference_update(PyObject* o, PyObject* other)
     }
 
     PySetInstance* self_w = (PySetInstance*)o;
+    Type* src_type = extractTypeFrom(Py_TYPE(other));
+
+    if (src_type && (src_type->getTypeCategory() == Type::TypeCategory::catSet)
+            && ((SetType*)src_type)->keyType() == self_w->type()->keyType()) {
+        try {
+            self_w->type()->symmetricDifferenceInPlace(self_w->dataPtr(), ((PySetInstance*)other)->dataPtr());
+        } catch (PythonExceptionSet& e) {
+            return -1;
+        } catch (std::exception& e) {
+            PyErr_SetString(PyExc_TypeError, e.what());
+            return -1;
+        }
+
+        return 0;
+    }
 
     PySetInstance* to_be_added = (PySetInstance*)PyInstance::tp_new(Py_TYPE(o), NULL, NULL);
     if (!to_be_added) {
@@ -709,6 +751,39 @@ PyObject* PySetInstance::setIsDisjoint(PyObject* o, PyObject* args) {
     return incref(ret ? Py_True : Py_False);
 }
 
+PyDoc_STRVAR(setContainsMany_doc,
+    "s.containsMany(elements) -> ListOf(bool) saying whether each element is in s.\n\n"
+    "Compiled code looks the elements up in batches, prefetching their hash table\n"
+    "entries ahead of time.\n"
+    );
+PyObject* PySetInstance::setContainsMany(PyObject* o, PyObject* args) {
+    PySetInstance* self_w = (PySetInstance*)o;
+
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "Set.containsMany takes one argument");
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        SetType* setT = self_w->type();
+
+        ListOfType* keyListT = ListOfType::Make(setT->keyType());
+        ListOfType* resultT = ListOfType::Make(::Bool::Make());
+
+        Instance keyList(keyListT, [&](instance_ptr data) {
+            copyConstructFromPythonInstance(keyListT, data, PyTuple_GetItem(args, 0), ConversionLevel::ImplicitContainers);
+        });
+
+        Instance result(resultT, [&](instance_ptr data) {
+            resultT->constructor(data, keyListT->count(keyList.data()), [&](instance_ptr tgt, int64_t k) {
+                *(bool*)tgt = setT->lookupKey(self_w->dataPtr(), keyListT->eltPtr(keyList.data(), k)) != nullptr;
+            });
+        });
+
+        return PyInstance::fromInstance(result);
+    });
+}
+
 PyDoc_STRVAR(setIntersection_doc,
     "s.intersection(s1) -> set of elements that are in both s and s1\n"
     "s.intersection(s1, s2, ...) -> set of elements that are in s, s1, s2, ...\n"
@@ -1004,12 +1079,7 @@ PyObject* PySetInstance::setPop(PyObject* o, PyObject* args) {
     SetType* self_type = (SetType*)extractTypeFrom(o->ob_type);
     instance_ptr self_ptr = self_w->dataPtr();
 
-    int iteratorOffset = 0;
-
-    while (iteratorOffset < self_type->slotCount(self_ptr) &&
-                !self_type->slotPopulated(self_ptr, iteratorOffset)) {
-        iteratorOffset++;
-    }
+    int64_t iteratorOffset = self_type->nextPopulatedSlot(self_ptr, 0);
 
     if (iteratorOffset == self_type->slotCount(self_ptr)) {
         PyErr_SetString(PyExc_KeyError, "pop from an empty set");
@@ -1083,10 +1153,7 @@ PyObject* PySetInstance::tp_iter_concrete() {
 PyObject* PySetInstance::tp_iternext_concrete() {
     if (mIteratorOffset == 0) {
         // search forward to find the first slot
-        while (mIteratorOffset < type()->slotCount(dataPtr())
-               && !type()->slotPopulated(dataPtr(), mIteratorOffset)) {
-            mIteratorOffset++;
-        }
+        mIteratorOffset = type()->nextPopulatedSlot(dataPtr(), 0);
     }
 
     if (type()->size(dataPtr()) != mContainerSize) {
@@ -1098,13 +1165,9 @@ PyObject* PySetInstance::tp_iternext_concrete() {
         return NULL;
     }
 
-    int32_t curSlot = mIteratorOffset;
+    int64_t curSlot = mIteratorOffset;
 
-    mIteratorOffset++;
-    while (mIteratorOffset < type()->slotCount(dataPtr())
-           && !type()->slotPopulated(dataPtr(), mIteratorOffset)) {
-        mIteratorOffset++;
-    }
+    mIteratorOffset = type()->nextPopulatedSlot(dataPtr(), mIteratorOffset + 1);
 
     return extractPythonObject(type()->keyAtSlot(dataPtr(), curSlot), type()->keyType());
 }
@@ -1403,11 +1466,13 @@ bool PySetInstance::pyValCouldBeOfTypeConcrete(modeled_type* type, PyObject* pyR
 }
 
 PyMethodDef* PySetInstance::typeMethodsConcrete(Type* t) {
-    return new PyMethodDef[18]{{"add", (PyCFunction)PySetInstance::setAdd, METH_VARARGS, setAdd_doc},
+    return new PyMethodDef[21]{{"add", (PyCFunction)PySetInstance::setAdd, METH_VARARGS, setAdd_doc},
                               {"pop", (PyCFunction)PySetInstance::setPop, METH_VARARGS, setPop_doc},
                               {"discard", (PyCFunction)PySetInstance::setDiscard, METH_VARARGS, setDiscard_doc},
                               {"remove", (PyCFunction)PySetInstance::setRemove, METH_VARARGS, setRemove_doc},
                               {"clear", (PyCFunction)PySetInstance::setClear, METH_VARARGS, setClear_doc},
+                              {"compact", (PyCFunction)PySetInstance::setCompact, METH_VARARGS, setCompact_doc},
+                              {"fromList", (PyCFunction)PySetInstance::fromList, METH_VARARGS | METH_KEYWORDS | METH_CLASS, setFromList_doc},
                               {"copy", (PyCFunction)PySetInstance::setCopy, METH_VARARGS, setCopy_doc},
                               {"union", (PyCFunction)PySetInstance::setUnion, METH_VARARGS, setUnion_doc},
                               {"update", (PyCFunction)PySetInstance::setUpdate, METH_VARARGS, setUpdate_doc},
@@ -1420,5 +1485,6 @@ PyMethodDef* PySetInstance::typeMethodsConcrete(Type* t) {
                               {"issubset", (PyCFunction)PySetInstance::setIsSubset, METH_VARARGS, setIsSubset_doc},
                               {"issuperset", (PyCFunction)PySetInstance::setIsSuperset, METH_VARARGS, setIsSuperset_doc},
                               {"isdisjoint", (PyCFunction)PySetInstance::setIsDisjoint, METH_VARARGS, setIsDisjoint_doc},
+                              {"containsMany", (PyCFunction)PySetInstance::setContainsMany, METH_VARARGS, setContainsMany_doc},
                               {NULL, NULL}};
 }
@@ -30,6 +30,8 @@ class PySetInstance : public PyInstance {
     static PyObject* setDiscard(PyObject* o, PyObject* args);
     static PyObject* setRemove(PyObject* o, PyObject* args);
     static PyObject* setClear(PyObject* o, PyObject* args);
+    static PyObject* setCompact(PyObject* o, PyObject* args);
+    static PyObject* fromList(PyObject* cls, PyObject* args, PyObject* kwargs);
     static PyObject* setCopy(PyObject* o, PyObject* args);
     static PyObject* setUnion(PyObject* o, PyObject* args);
     static PyObject* setUpdate(PyObject* o, PyObject* args);
@@ -42,6 +44,7 @@ class PySetInstance : public PyInstance {
     static PyObject* setIsSubset(PyObject* o, PyObject* args);
     static PyObject* setIsSuperset(PyObject* o, PyObject* args);
     static PyObject* setIsDisjoint(PyObject* o, PyObject* args);
+    static PyObject* setContainsMany(PyObject* o, PyObject* args);
     Py_ssize_t mp_and_sq_length_concrete();
     int sq_contains_concrete(PyObject* item);
     PyObject* tp_iter_concrete();
@@ -89,6 +89,38 @@ PyDoc_STRVAR(PySlab_slabPtr_doc,
     "Get the root address of the memory slab as an integer."
 );
 
+PyDoc_STRVAR(PySlab_createdAt_doc,
+    "Slab.createdAt() -> float\n\n"
+    "Return the time the slab was created, in seconds since the epoch."
+);
+
+PyDoc_STRVAR(PySlab_lastTouched_doc,
+    "Slab.lastTouched() -> float\n\n"
+    "Return the last time someone called 'touch' on the slab (or when it was\n"
+    "created, if nobody has), in seconds since the epoch."
+);
+
+PyDoc_STRVAR(PySlab_touch_doc,
+    "Slab.touch() -> None\n\n"
+    "Record that the slab is in use, for caches deciding which slabs are cold.\n"
+    "Reading the objects in a slab doesn't touch it by itself."
+);
+
+PyDoc_STRVAR(PySlab_adviseCold_doc,
+    "Slab.adviseCold(pageout=False) -> bool\n\n"
+    "Tell the kernel the slab's memory is cold, so it's reclaimed before other\n"
+    "memory (MADV_COLD), or with pageout=True, reclaim it now (MADV_PAGEOUT).\n"
+    "The contents are kept and fault back in on the next access. Returns False\n"
+    "if the slab is too small to have its own pages, or the kernel doesn't\n"
+    "support it."
+);
+
+PyDoc_STRVAR(PySlab_isShared_doc,
+    "Slab.isShared() -> bool\n\n"
+    "Is the slab's memory shared with the processes we fork, rather than\n"
+    "copied on write? See deepcopyContiguous(shared=True)."
+);
+
 PyMethodDef PySlabInstance_methods[] = {
     {"refcount", (PyCFunction)PySlab::refcount, METH_VARARGS | METH_KEYWORDS, PySlab_refcount_doc},
     {"bytecount", (PyCFunction)PySlab::bytecount, METH_VARARGS | METH_KEYWORDS, PySlab_bytecount_doc},
@@ -101,6 +133,11 @@ PyMethodDef PySlabInstance_methods[] = {
     {"slabPtr", (PyCFunction)PySlab::slabPtr, METH_VARARGS | METH_KEYWORDS, PySlab_slabPtr_doc},
     {"getTag", (PyCFunction)PySlab::getTag, METH_VARARGS | METH_KEYWORDS, NULL},
     {"setTag", (PyCFunction)PySlab::setTag, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"createdAt", (PyCFunction)PySlab::createdAt, METH_VARARGS | METH_KEYWORDS, PySlab_createdAt_doc},
+    {"lastTouched", (PyCFunction)PySlab::lastTouched, METH_VARARGS | METH_KEYWORDS, PySlab_lastTouched_doc},
+    {"touch", (PyCFunction)PySlab::touch, METH_VARARGS | METH_KEYWORDS, PySlab_touch_doc},
+    {"adviseCold", (PyCFunction)PySlab::adviseCold, METH_VARARGS | METH_KEYWORDS, PySlab_adviseCold_doc},
+    {"isShared", (PyCFunction)PySlab::isShared, METH_VARARGS | METH_KEYWORDS, PySlab_isShared_doc},
     {NULL}  /* Sentinel */
 };
 
@@ -126,6 +163,67 @@ PyObject* PySlab::setTag(PySlab* self, PyObject* args, PyObject* kwargs) {
     return incref(Py_None);
 }
 
+PyObject* PySlab::createdAt(PySlab* self, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(self->mSlab->createdAt());
+}
+
+PyObject* PySlab::lastTouched(PySlab* self, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(self->mSlab->lastTouched());
+}
+
+PyObject* PySlab::touch(PySlab* self, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    self->mSlab->touch();
+
+    return incref(Py_None);
+}
+
+PyObject* PySlab::adviseCold(PySlab* self, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"pageout", NULL};
+
+    int pageout = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", (char**)kwlist, &pageout)) {
+        return NULL;
+    }
+
+    bool res;
+
+    {
+        PyEnsureGilReleased releaseTheGil;
+        res = self->mSlab->adviseCold(pageout);
+    }
+
+    return incref(res ? Py_True : Py_False);
+}
+
+PyObject* PySlab::isShared(PySlab* self, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return incref(self->mSlab->isShared() ? Py_True : Py_False);
+}
+
 PyObject* PySlab::slabPtr(PySlab* self, PyObject* args, PyObject* kwargs)
 {
     static const char *kwlist[] = {NULL};
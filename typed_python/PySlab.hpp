@@ -54,6 +54,16 @@ public:
     static PyObject* getTag(PySlab* self, PyObject* args, PyObject* kwargs);
 
     static PyObject* setTag(PySlab* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* createdAt(PySlab* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* lastTouched(PySlab* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* touch(PySlab* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* adviseCold(PySlab* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* isShared(PySlab* self, PyObject* args, PyObject* kwargs);
 };
 
 extern PyTypeObject PyType_Slab;
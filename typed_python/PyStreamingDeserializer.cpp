@@ -0,0 +1,252 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "PyStreamingDeserializer.hpp"
+#include "NullSerializationContext.hpp"
+#include "PythonSerializationContext.hpp"
+
+
+PyDoc_STRVAR(PyStreamingDeserializer_doc,
+    "StreamingDeserializer(T, serializationContext=None)\n\n"
+    "Deserializes a stream of messages of type T (what 'serializeStream' writes)\n"
+    "that arrives in arbitrary pieces, such as chunks read off a socket.\n\n"
+    "Call 'feed' with each piece as it arrives. It returns a list of the values\n"
+    "whose messages the piece completed, and holds on to any partial message\n"
+    "at the end until the rest of it arrives. Messages may refer to objects in\n"
+    "earlier messages, as they can in 'deserializeStream', so the deserializer\n"
+    "keeps the lists, dicts and other objects it has decoded alive until it's\n"
+    "released.\n\n"
+    "The GIL is released while decompressing and decoding."
+);
+
+PyDoc_STRVAR(PyStreamingDeserializer_feed_doc,
+    "StreamingDeserializer.feed(data) -> list\n\n"
+    "Append 'data' (any object supporting the buffer protocol) to the stream,\n"
+    "and return the values of every message that's now complete."
+);
+
+PyDoc_STRVAR(PyStreamingDeserializer_bytesBuffered_doc,
+    "StreamingDeserializer.bytesBuffered() -> int\n\n"
+    "Return the number of bytes we've been fed but haven't decoded yet. This\n"
+    "is 0 exactly when the stream ends on a message boundary."
+);
+
+PyMethodDef PyStreamingDeserializerInstance_methods[] = {
+    {"feed", (PyCFunction)PyStreamingDeserializer::feed, METH_VARARGS | METH_KEYWORDS, PyStreamingDeserializer_feed_doc},
+    {"bytesBuffered", (PyCFunction)PyStreamingDeserializer::bytesBuffered, METH_VARARGS | METH_KEYWORDS,
+        PyStreamingDeserializer_bytesBuffered_doc},
+    {NULL}  /* Sentinel */
+};
+
+/* static */
+void PyStreamingDeserializer::dealloc(PyStreamingDeserializer *self)
+{
+    self->mBuffer.~shared_ptr();
+    self->mContext.~shared_ptr();
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+/* static */
+PyObject* PyStreamingDeserializer::new_(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyStreamingDeserializer* self;
+
+    self = (PyStreamingDeserializer*)type->tp_alloc(type, 0);
+
+    if (self != NULL) {
+        self->mType = nullptr;
+        self->mIsBroken = false;
+        new (&self->mContext) std::shared_ptr<SerializationContext>();
+        new (&self->mBuffer) std::shared_ptr<DeserializationBuffer>();
+    }
+
+    return (PyObject*)self;
+}
+
+/* static */
+int PyStreamingDeserializer::init(PyStreamingDeserializer *self, PyObject *args, PyObject *kwargs)
+{
+    static const char* kwlist[] = {"T", "serializationContext", NULL};
+
+    PyObject* typeArg;
+    PyObject* contextArg = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", (char**)kwlist, &typeArg, &contextArg)) {
+        return -1;
+    }
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(typeArg);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to StreamingDeserializer must be a type object");
+        return -1;
+    }
+
+    return translateExceptionToPyObjectReturningInt([&]() {
+        t->assertForwardsResolved();
+
+        std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+
+        if (contextArg && contextArg != Py_None) {
+            context.reset(new PythonSerializationContext(contextArg));
+        }
+
+        // drop any buffer from an earlier __init__ before the context it refers to
+        self->mBuffer.reset();
+
+        self->mType = t;
+        self->mContext = context;
+        self->mBuffer.reset(new DeserializationBuffer(*context));
+        self->mIsBroken = false;
+
+        return 0;
+    });
+}
+
+PyObject* PyStreamingDeserializer::feed(PyStreamingDeserializer* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* kwlist[] = {"data", NULL};
+
+    PyObject* data;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &data)) {
+        return NULL;
+    }
+
+    if (!self->mBuffer) {
+        PyErr_SetString(PyExc_RuntimeError, "StreamingDeserializer wasn't initialized");
+        return NULL;
+    }
+
+    if (self->mIsBroken) {
+        PyErr_SetString(PyExc_RuntimeError, "StreamingDeserializer can't continue after a corrupt message");
+        return NULL;
+    }
+
+    Py_buffer view;
+
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) == -1) {
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        DeserializationBuffer& buffer = *self->mBuffer;
+        Type* t = self->mType;
+
+        try {
+            try {
+                buffer.feed((const uint8_t*)view.buf, view.len);
+            } catch(...) {
+                PyBuffer_Release(&view);
+                throw;
+            }
+
+            PyBuffer_Release(&view);
+
+            PyObjectStealer result(PyList_New(0));
+
+            while (buffer.hasCompleteMessage()) {
+                auto fieldAndWireType = buffer.readFieldNumberAndWireType();
+
+                Instance i = Instance::createAndInitialize(t, [&](instance_ptr p) {
+                    PyEnsureGilReleased releaseTheGil;
+
+                    t->deserialize(p, buffer, fieldAndWireType.second);
+                });
+
+                PyObjectStealer value(PyInstance::extractPythonObject(i.data(), i.type()));
+
+                if (!value) {
+                    throw PythonExceptionSet();
+                }
+
+                PyList_Append(result, value);
+            }
+
+            return incref((PyObject*)result);
+        } catch(...) {
+            self->mIsBroken = true;
+            throw;
+        }
+    });
+}
+
+PyObject* PyStreamingDeserializer::bytesBuffered(PyStreamingDeserializer* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return PyLong_FromLong(self->mBuffer ? self->mBuffer->bytesBuffered() : 0);
+}
+
+
+PyTypeObject PyType_StreamingDeserializer = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "StreamingDeserializer",
+    .tp_basicsize = sizeof(PyStreamingDeserializer),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor) PyStreamingDeserializer::dealloc,
+    #if PY_MINOR_VERSION < 8
+    .tp_print = 0,
+    #else
+    .tp_vectorcall_offset = 0,                  // printfunc  (Changed to tp_vectorcall_offset in Python 3.8)
+    #endif
+    .tp_getattr = 0,
+    .tp_setattr = 0,
+    .tp_as_async = 0,
+    .tp_repr = 0,
+    .tp_as_number = 0,
+    .tp_as_sequence = 0,
+    .tp_as_mapping = 0,
+    .tp_hash = 0,
+    .tp_call = 0,
+    .tp_str = 0,
+    .tp_getattro = 0,
+    .tp_setattro = 0,
+    .tp_as_buffer = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = PyStreamingDeserializer_doc,
+    .tp_traverse = 0,
+    .tp_clear = 0,
+    .tp_richcompare = 0,
+    .tp_weaklistoffset = 0,
+    .tp_iter = 0,
+    .tp_iternext = 0,
+    .tp_methods = PyStreamingDeserializerInstance_methods,
+    .tp_members = 0,
+    .tp_getset = 0,
+    .tp_base = 0,
+    .tp_dict = 0,
+    .tp_descr_get = 0,
+    .tp_descr_set = 0,
+    .tp_dictoffset = 0,
+    .tp_init = (initproc) PyStreamingDeserializer::init,
+    .tp_alloc = 0,
+    .tp_new = PyStreamingDeserializer::new_,
+    .tp_free = 0,
+    .tp_is_gc = 0,
+    .tp_bases = 0,
+    .tp_mro = 0,
+    .tp_cache = 0,
+    .tp_subclasses = 0,
+    .tp_weaklist = 0,
+    .tp_del = 0,
+    .tp_version_tag = 0,
+    .tp_finalize = 0,
+};
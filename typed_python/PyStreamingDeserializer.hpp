@@ -0,0 +1,51 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "PyInstance.hpp"
+#include "DeserializationBuffer.hpp"
+#include <memory>
+
+// the python face of a streaming DeserializationBuffer: a stream of
+// messages of one type, fed in arbitrary pieces.
+class PyStreamingDeserializer {
+public:
+    PyObject_HEAD
+
+    Type* mType;
+
+    std::shared_ptr<SerializationContext> mContext;
+
+    // refers to 'mContext', so it has to go first
+    std::shared_ptr<DeserializationBuffer> mBuffer;
+
+    // set once a message fails to deserialize, after which we can't
+    // know where the next one starts.
+    bool mIsBroken;
+
+    static void dealloc(PyStreamingDeserializer *self);
+
+    static PyObject *new_(PyTypeObject *type, PyObject *args, PyObject *kwargs);
+
+    static int init(PyStreamingDeserializer *self, PyObject *args, PyObject *kwargs);
+
+    static PyObject* feed(PyStreamingDeserializer* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* bytesBuffered(PyStreamingDeserializer* self, PyObject* args, PyObject* kwargs);
+};
+
+extern PyTypeObject PyType_StreamingDeserializer;
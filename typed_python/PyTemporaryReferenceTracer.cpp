@@ -51,9 +51,41 @@ bool PyTemporaryReferenceTracer::isLineNewStatement(PyObject* code, int line) {
 }
 
 
+void PyTemporaryReferenceTracer::muteFrame(PyFrameObject* frame) {
+    if (frame->f_trace_lines && mutedFrames.insert(frame).second) {
+        frame->f_trace_lines = 0;
+        mutedFrameCount++;
+    }
+}
+
+void PyTemporaryReferenceTracer::unmuteFrame(PyFrameObject* frame) {
+    if (mutedFrames.erase(frame)) {
+        frame->f_trace_lines = 1;
+    }
+}
+
+void PyTemporaryReferenceTracer::unmuteAllFrames() {
+    // every frame in here is still running, or we'd have seen it return
+    for (PyFrameObject* frame: mutedFrames) {
+        frame->f_trace_lines = 1;
+    }
+
+    mutedFrames.clear();
+}
+
 int PyTemporaryReferenceTracer::globalTraceFun(PyObject* dummyObj, PyFrameObject* frame, int what, PyObject* arg) {
-    if (frame != globalTracer.mostRecentEmptyFrame &&
-        globalTracer.frameToActions.find(frame) != globalTracer.frameToActions.end()) {
+    globalTracer.eventCount++;
+
+    if (frame == globalTracer.mostRecentEmptyFrame ||
+        globalTracer.frameToActions.find(frame) == globalTracer.frameToActions.end()) {
+        if (!globalTracer.priorTraceFunc) {
+            if (what == PyTrace_RETURN) {
+                globalTracer.unmuteFrame(frame);
+            } else if (what == PyTrace_CALL || what == PyTrace_LINE) {
+                globalTracer.muteFrame(frame);
+            }
+        }
+    } else {
         // always process exception and return statements
         bool forceProcess = (
             what == PyTrace_EXCEPTION ||
@@ -106,6 +138,8 @@ int PyTemporaryReferenceTracer::globalTraceFun(PyObject* dummyObj, PyFrameObject
 
     if (globalTracer.frameToActions.size() == 0) {
         // uninstall ourself
+        globalTracer.unmuteAllFrames();
+
         PyEval_SetTrace(globalTracer.priorTraceFunc, globalTracer.priorTraceFuncArg);
         decref(globalTracer.priorTraceFuncArg);
 
@@ -122,6 +156,7 @@ void PyTemporaryReferenceTracer::installGlobalTraceHandlerIfNecessary() {
 
     // this swallows the reference we're holding on 'tracer' into the function itself
     if (tstate->c_tracefunc != globalTraceFun) {
+        globalTracer.installCount++;
         globalTracer.priorTraceFunc = tstate->c_tracefunc;
         globalTracer.priorTraceFuncArg = incref(tstate->c_traceobj);
 
@@ -139,6 +174,9 @@ void PyTemporaryReferenceTracer::traceObject(PyObject* o, PyFrameObject* f) {
         )
     );
 
+    globalTracer.tracedObjectCount++;
+    globalTracer.unmuteFrame(f);
+
     if (globalTracer.mostRecentEmptyFrame == f) {
         globalTracer.mostRecentEmptyFrame = nullptr;
     }
@@ -156,6 +194,9 @@ void PyTemporaryReferenceTracer::keepaliveForCurrentInstruction(PyObject* o, PyF
         )
     );
 
+    globalTracer.keepaliveCount++;
+    globalTracer.unmuteFrame(f);
+
     if (globalTracer.mostRecentEmptyFrame == f) {
         globalTracer.mostRecentEmptyFrame = nullptr;
     }
@@ -18,6 +18,7 @@
 
 #include "PyInstance.hpp"
 #include <unordered_map>
+#include <unordered_set>
 
 enum class TraceAction {
     ConvertTemporaryReference,
@@ -29,7 +30,12 @@ public:
     PyTemporaryReferenceTracer() :
         mostRecentEmptyFrame(nullptr),
         priorTraceFunc(nullptr),
-        priorTraceFuncArg(nullptr)
+        priorTraceFuncArg(nullptr),
+        tracedObjectCount(0),
+        keepaliveCount(0),
+        installCount(0),
+        eventCount(0),
+        mutedFrameCount(0)
     {}
 
     // perform an action on the first instruction where a
@@ -60,8 +66,30 @@ public:
 
     PyObject* priorTraceFuncArg;
 
+    // frames that hold nothing we're tracing, whose line events we've
+    // switched off (with f_trace_lines) so that while we're installed, code
+    // that doesn't touch temporary references pays for one call into
+    // 'globalTraceFun' per frame rather than one per line. We switch them
+    // back on when the frame returns or yields, when we start tracing
+    // something in it, and when we uninstall ourselves. We never do this
+    // while there's a prior trace function, which expects its line events.
+    std::unordered_set<PyFrameObject*> mutedFrames;
+
+    // counters, for _types.temporaryReferenceTracerStats
+    int64_t tracedObjectCount;
+    int64_t keepaliveCount;
+    int64_t installCount;
+    int64_t eventCount;
+    int64_t mutedFrameCount;
+
     bool isLineNewStatement(PyObject* code, int line);
 
+    void muteFrame(PyFrameObject* frame);
+
+    void unmuteFrame(PyFrameObject* frame);
+
+    void unmuteAllFrames();
+
     static PyTemporaryReferenceTracer globalTracer;
 
     static int globalTraceFun(PyObject* obj, PyFrameObject* frame, int what, PyObject* arg);
@@ -15,6 +15,9 @@
 ******************************************************************************/
 
 #include "PyTupleOrListOfInstance.hpp"
+#include "PrimitiveConverter.hpp"
+#include "PyStringInstance.hpp"
+#include "ArrowInterop.hpp"
 
 TupleOrListOfType* PyTupleOrListOfInstance::type() {
     return (TupleOrListOfType*)extractTypeFrom(((PyObject*)this)->ob_type);
@@ -184,6 +187,15 @@ PyObject* PyListOfInstance::listSetSizeUnsafe(PyObject* o, PyObject* args) {
 
 template<class dest_t, class source_t>
 void constructTupleOrListInst(TupleOrListOfType* tupT, instance_ptr tgt, size_t count, long* strides, uint8_t* source_data) {
+    // a packed array of exactly our element type is a single memcpy
+    if (std::is_same<dest_t, source_t>::value && count && strides[0] == sizeof(source_t)) {
+        tupT->constructor(tgt);
+        tupT->reserve(tgt, count);
+        memcpy(tupT->eltPtr(tgt, 0), source_data, count * sizeof(source_t));
+        tupT->setSizeUnsafe(tgt, count);
+        return;
+    }
+
     tupT->constructor(tgt, count,
         [&](uint8_t* eltPtr, int64_t k) {
             ((dest_t*)eltPtr)[0] = ((source_t*)(source_data + k * strides[0]))[0];
@@ -214,13 +226,41 @@ bool constructTupleOrListInstFromNumpy(TupleOrListOfType* tupT, instance_ptr tgt
     } else if (numpyType == NPY_UINT8) {
         constructTupleOrListInst<dest_t, uint8_t>(tupT, tgt, size, strides, data);
     } else if (numpyType == NPY_BOOL) {
-        constructTupleOrListInst<dest_t, dest_t>(tupT, tgt, size, strides, data);
+        constructTupleOrListInst<dest_t, bool>(tupT, tgt, size, strides, data);
     } else {
         return false;
     }
 
     return true;
 }
+// build 'tgt' from an exact list or tuple in one presized pass, letting
+// 'converter' take every item it can.
+static void constructFromSequenceOfPrimitives(
+    TupleOrListOfType* tupT,
+    instance_ptr tgt,
+    PyObject* seq,
+    const PrimitiveConverter& converter,
+    ConversionLevel childLevel
+) {
+    Type* eltType = tupT->getEltType();
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+
+    tupT->constructor(tgt, count, [&](uint8_t* eltPtr, int64_t k) {
+        // converting an item the general way can run arbitrary python code,
+        // which could shrink a list out from under us
+        if (k >= PySequence_Fast_GET_SIZE(seq)) {
+            throw std::logic_error("list changed size during conversion to " + tupT->name());
+        }
+
+        PyObject* item = PySequence_Fast_GET_ITEM(seq, k);
+
+        if (!converter.tryConstruct(eltPtr, item)) {
+            PyObjectHolder holdItem(item);
+            PyInstance::copyConstructFromPythonInstance(eltType, eltPtr, item, childLevel);
+        }
+    });
+}
+
 void PyTupleOrListOfInstance::copyConstructFromPythonInstanceConcrete(TupleOrListOfType* tupT, instance_ptr tgt, PyObject* pyRepresentation, ConversionLevel level) {
     if (PyArray_Check(pyRepresentation) && level >= ConversionLevel::ImplicitContainers) {
         if (!PyArray_ISBEHAVED_RO(pyRepresentation)) {
@@ -351,6 +391,15 @@ void PyTupleOrListOfInstance::copyConstructFromPythonInstanceConcrete(TupleOrLis
         return;
     }
 
+    if (PyList_CheckExact(pyRepresentation) || PyTuple_CheckExact(pyRepresentation)) {
+        PrimitiveConverter converter(tupT->getEltType(), childLevel);
+
+        if (converter.active()) {
+            constructFromSequenceOfPrimitives(tupT, tgt, pyRepresentation, converter, childLevel);
+            return;
+        }
+    }
+
     PyObjectStealer iterator(PyObject_GetIter(pyRepresentation));
 
     if (iterator) {
@@ -452,6 +501,204 @@ PyObject* PyTupleOrListOfInstance::fromBytes(PyObject* o, PyObject* args, PyObje
     return PyInstance::fromInstance(outConverted);
 }
 
+// static
+const char* PyTupleOrListOfInstance::bufferFormatFor(Type* eltType) {
+    switch (eltType->getTypeCategory()) {
+        case Type::TypeCategory::catBool: return "?";
+        case Type::TypeCategory::catInt64: return "q";
+        case Type::TypeCategory::catUInt64: return "Q";
+        case Type::TypeCategory::catInt32: return "i";
+        case Type::TypeCategory::catUInt32: return "I";
+        case Type::TypeCategory::catInt16: return "h";
+        case Type::TypeCategory::catUInt16: return "H";
+        case Type::TypeCategory::catInt8: return "b";
+        case Type::TypeCategory::catUInt8: return "B";
+        case Type::TypeCategory::catFloat64: return "d";
+        case Type::TypeCategory::catFloat32: return "f";
+        default: return nullptr;
+    }
+}
+
+// static
+PyBufferProcs* PyTupleOrListOfInstance::bufferExportProcs() {
+    static PyBufferProcs* procs = new PyBufferProcs {
+        PyTupleOrListOfInstance::bf_getbuffer,
+        PyTupleOrListOfInstance::bf_releasebuffer
+    };
+    return procs;
+}
+
+/**
+    Export our elements in place. The view holds a reference to the instance,
+    which keeps a TupleOf's elements alive for as long as the view is. A ListOf
+    exports its storage read-write, but it can't refuse to grow while views of
+    it exist (compiled code appends without asking us), so a view of a ListOf
+    is only good until the list is next resized.
+*/
+// static
+int PyTupleOrListOfInstance::bf_getbuffer(PyObject* o, Py_buffer* view, int flags) {
+    PyTupleOrListOfInstance* self = (PyTupleOrListOfInstance*)o;
+
+    // python subclasses of our types inherit this slot
+    TupleOrListOfType* tupT = (TupleOrListOfType*)PyInstance::rootNativeType(o->ob_type);
+
+    const char* format = bufferFormatFor(tupT->getEltType());
+
+    if (!format) {
+        PyErr_Format(PyExc_BufferError, "%s doesn't export a buffer", tupT->name().c_str());
+        view->obj = NULL;
+        return -1;
+    }
+
+    if ((flags & PyBUF_WRITABLE) && !tupT->isListOf()) {
+        PyErr_Format(PyExc_BufferError, "%s is immutable, so its buffer isn't writable", tupT->name().c_str());
+        view->obj = NULL;
+        return -1;
+    }
+
+    static char emptyBuffer[1];
+
+    Py_ssize_t count = tupT->count(self->dataPtr());
+    Py_ssize_t itemsize = tupT->getEltType()->bytecount();
+
+    // shape and strides, which have to outlive the call
+    Py_ssize_t* shapeAndStrides = new Py_ssize_t[2] { count, itemsize };
+
+    view->obj = incref(o);
+    view->buf = count ? (void*)tupT->eltPtr(self->dataPtr(), 0) : (void*)emptyBuffer;
+    view->len = count * itemsize;
+    view->readonly = tupT->isListOf() ? 0 : 1;
+    view->itemsize = itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? (char*)format : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? shapeAndStrides : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? shapeAndStrides + 1 : NULL;
+    view->suboffsets = NULL;
+    view->internal = shapeAndStrides;
+
+    return 0;
+}
+
+// static
+void PyTupleOrListOfInstance::bf_releasebuffer(PyObject* o, Py_buffer* view) {
+    delete[] (Py_ssize_t*)view->internal;
+}
+
+// classify a struct-module format character as bool ('?'), signed int ('i'),
+// unsigned int ('u') or float ('f'), or return 0 if it's none of those.
+static char bufferFormatKind(const char* format) {
+    if (!format) {
+        // buffers with no format are unsigned bytes
+        return 'u';
+    }
+
+    if (*format == '@' || *format == '=') {
+        format++;
+    }
+#if PY_LITTLE_ENDIAN
+    else if (*format == '<') {
+        format++;
+    }
+#else
+    else if (*format == '>' || *format == '!') {
+        format++;
+    }
+#endif
+
+    if (!format[0] || format[1]) {
+        return 0;
+    }
+
+    if (format[0] == '?') {
+        return '?';
+    }
+    if (strchr("bhilqn", format[0])) {
+        return 'i';
+    }
+    if (strchr("BHILQN", format[0])) {
+        return 'u';
+    }
+    if (strchr("efd", format[0])) {
+        return 'f';
+    }
+
+    return 0;
+}
+
+const char* TUPLE_FROM_BUFFER_DOCSTRING =
+    "Construct a TupleOf(T) by copying a contiguous buffer of T.\n\n"
+    "T must be an integer, float, or bool type, and 'buffer' may be any object\n"
+    "exporting a C-contiguous buffer of the same kind and width of value (a numpy\n"
+    "array, an array.array, a memoryview, another TupleOf(T) or ListOf(T)). The\n"
+    "elements are copied in a single memcpy."
+;
+
+// static
+PyObject* PyTupleOrListOfInstance::fromBuffer(PyObject* o, PyObject* args, PyObject* kwds) {
+    static const char *kwlist[] = {"buffer", NULL};
+
+    PyObject* bufferObj;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", (char**)kwlist, &bufferObj)) {
+        return nullptr;
+    }
+
+    Type* selfType = PyInstance::unwrapTypeArgToTypePtr(o);
+
+    if (!selfType || !selfType->isTupleOrListOf()) {
+        PyErr_Format(PyExc_TypeError, "Expected cls to be a Type");
+        return nullptr;
+    }
+
+    TupleOrListOfType* tupT = (TupleOrListOfType*)selfType;
+    Type* eltType = tupT->getEltType();
+
+    const char* format = bufferFormatFor(eltType);
+
+    if (!format) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "Can't build %s from a buffer: its elements must be an integer, float, or bool type",
+            tupT->name().c_str()
+        );
+        return nullptr;
+    }
+
+    Py_buffer view;
+
+    if (PyObject_GetBuffer(bufferObj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+        return nullptr;
+    }
+
+    if (view.itemsize != eltType->bytecount() || bufferFormatKind(view.format) != bufferFormatKind(format)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "Can't build %s from a buffer of format '%s' and itemsize %d",
+            tupT->name().c_str(),
+            view.format ? view.format : "B",
+            (int)view.itemsize
+        );
+        PyBuffer_Release(&view);
+        return nullptr;
+    }
+
+    size_t eltCount = view.len / view.itemsize;
+
+    Instance outConverted(selfType, [&](instance_ptr data) {
+        tupT->constructor(data);
+
+        if (eltCount) {
+            tupT->reserve(data, eltCount);
+            memcpy(tupT->eltPtr(data, 0), view.buf, view.len);
+            tupT->setSizeUnsafe(data, eltCount);
+        }
+    });
+
+    PyBuffer_Release(&view);
+
+    return PyInstance::fromInstance(outConverted);
+}
+
 PyDoc_STRVAR(TupleOf_toArray_doc,
     "t.toarray() -> numpy array\n"
     "\n"
@@ -666,6 +913,234 @@ PyObject* PyTupleOrListOfInstance::pointerUnsafe(PyObject* o, PyObject* args) {
     return extractPythonObject((instance_ptr)&ptr, PointerTo::Make(self_w->type()->getEltType()));
 }
 
+static void releaseArrowSchemaCapsule(PyObject* capsule) {
+    ArrowSchema* schema = (ArrowSchema*)PyCapsule_GetPointer(capsule, "arrow_schema");
+
+    if (schema->release) {
+        schema->release(schema);
+    }
+
+    free(schema);
+}
+
+static void releaseArrowArrayCapsule(PyObject* capsule) {
+    ArrowArray* array = (ArrowArray*)PyCapsule_GetPointer(capsule, "arrow_array");
+
+    if (array->release) {
+        array->release(array);
+    }
+
+    free(array);
+}
+
+PyDoc_STRVAR(tupleOrListArrowCArray_doc,
+    "x.__arrow_c_array__(requested_schema=None) -> (schema capsule, array capsule)\n"
+    "\n"
+    "Export x through the Arrow PyCapsule interface, so that pyarrow.array(x)\n"
+    "and other arrow consumers can read it. Int and float elements are shared\n"
+    "rather than copied; the array keeps x alive, but a view of a ListOf is\n"
+    "only good until the list is next resized. 'requested_schema' is ignored.\n"
+);
+PyObject* PyTupleOrListOfInstance::arrowCArray(PyObject* o, PyObject* args, PyObject* kwds) {
+    static const char *kwlist[] = {"requested_schema", NULL};
+
+    PyObject* requestedSchema = nullptr;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", (char**)kwlist, &requestedSchema)) {
+        return nullptr;
+    }
+
+    PyTupleOrListOfInstance* self_w = (PyTupleOrListOfInstance*)o;
+
+    return translateExceptionToPyObject([&]() {
+        TupleOrListOfType* tupT = self_w->type();
+        Type* eltType = tupT->getEltType();
+
+        if (!ArrowInterop::isSupported(eltType)) {
+            throw std::runtime_error("Can't export " + tupT->name() + " to arrow");
+        }
+
+        int64_t count = tupT->count(self_w->dataPtr());
+
+        ArrowSchema* schema = (ArrowSchema*)calloc(1, sizeof(ArrowSchema));
+        ArrowArray* array = (ArrowArray*)calloc(1, sizeof(ArrowArray));
+
+        // the capsules free the structs, and release them unless a consumer took them
+        PyObjectStealer schemaCapsule(PyCapsule_New(schema, "arrow_schema", releaseArrowSchemaCapsule));
+        PyObjectStealer arrayCapsule(PyCapsule_New(array, "arrow_array", releaseArrowArrayCapsule));
+
+        ArrowInterop::exportColumn(
+            eltType,
+            count ? tupT->eltPtr(self_w->dataPtr(), 0) : nullptr,
+            count,
+            o,
+            schema,
+            array
+        );
+
+        return PyTuple_Pack(2, (PyObject*)schemaCapsule, (PyObject*)arrayCapsule);
+    });
+}
+
+PyDoc_STRVAR(tupleOrListToArrow_doc,
+    "x.toArrow() -> pyarrow.Array\n"
+    "\n"
+    "Equivalent to pyarrow.array(x). See __arrow_c_array__.\n"
+);
+PyObject* PyTupleOrListOfInstance::toArrow(PyObject* o, PyObject* args) {
+    if (PyTuple_Size(args)) {
+        PyErr_SetString(PyExc_TypeError, "toArrow takes no arguments");
+        return NULL;
+    }
+
+    PyObjectStealer pyarrow(PyImport_ImportModule("pyarrow"));
+    if (!pyarrow) {
+        return NULL;
+    }
+
+    return PyObject_CallMethod(pyarrow, "array", "O", o);
+}
+
+PyDoc_STRVAR(tupleOrListFromArrow_doc,
+    "T.fromArrow(array) -> T\n"
+    "\n"
+    "Construct a TupleOf(E) or ListOf(E) from any object exporting\n"
+    "__arrow_c_array__, such as a pyarrow.Array or a pyarrow.RecordBatch.\n"
+    "E may be an int, float, bool, str or bytes type, OneOf(None, one of\n"
+    "those) for a column with nulls, or a NamedTuple of them for a struct\n"
+    "array or record batch, whose fields are matched up by name. The data is\n"
+    "copied, but a column of ints or floats with no nulls is a single memcpy.\n"
+);
+PyObject* PyTupleOrListOfInstance::fromArrow(PyObject* o, PyObject* args, PyObject* kwds) {
+    static const char *kwlist[] = {"array", NULL};
+
+    PyObject* arrowObj;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", (char**)kwlist, &arrowObj)) {
+        return nullptr;
+    }
+
+    Type* selfType = PyInstance::unwrapTypeArgToTypePtr(o);
+
+    if (!selfType || !selfType->isTupleOrListOf()) {
+        PyErr_Format(PyExc_TypeError, "Expected cls to be a Type");
+        return nullptr;
+    }
+
+    TupleOrListOfType* tupT = (TupleOrListOfType*)selfType;
+    Type* eltType = tupT->getEltType();
+
+    PyObjectStealer capsules(PyObject_CallMethod(arrowObj, "__arrow_c_array__", NULL));
+    if (!capsules) {
+        return nullptr;
+    }
+
+    if (!PyTuple_Check(capsules) || PyTuple_Size(capsules) != 2) {
+        PyErr_Format(PyExc_TypeError, "__arrow_c_array__ should return a pair of capsules");
+        return nullptr;
+    }
+
+    ArrowSchema* schema = (ArrowSchema*)PyCapsule_GetPointer(PyTuple_GetItem(capsules, 0), "arrow_schema");
+    ArrowArray* array = (ArrowArray*)PyCapsule_GetPointer(PyTuple_GetItem(capsules, 1), "arrow_array");
+
+    if (!schema || !array) {
+        return nullptr;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        // the capsules still own the arrow data, so we only read it
+        Instance result(selfType, [&](instance_ptr data) {
+            tupT->constructor(data);
+
+            if (!array->length) {
+                return;
+            }
+
+            try {
+                tupT->reserve(data, array->length);
+                ArrowInterop::importColumn(eltType, schema, array, tupT->eltPtr(data, 0));
+                tupT->setSizeUnsafe(data, array->length);
+            } catch(...) {
+                tupT->destroy(data);
+                throw;
+            }
+        });
+
+        return PyInstance::fromInstance(result);
+    });
+}
+
+PyDoc_STRVAR(tupleOrListToList_doc,
+    "x.tolist() -> list\n"
+    "\n"
+    "Returns the elements of x as a python list. For int, float, bool and str\n"
+    "elements this is much faster than list(x), which boxes each element\n"
+    "through the iterator protocol.\n"
+);
+PyObject* PyTupleOrListOfInstance::toList(PyObject* o, PyObject* args) {
+    PyTupleOrListOfInstance* self_w = (PyTupleOrListOfInstance*)o;
+
+    if (PyTuple_Size(args)) {
+        PyErr_SetString(PyExc_TypeError, "tolist takes no arguments");
+        return NULL;
+    }
+
+    TupleOrListOfType* tupT = self_w->type();
+    Type* eltType = tupT->getEltType();
+    int64_t count = tupT->count(self_w->dataPtr());
+
+    PyObject* result = PyList_New(count);
+    if (!result || !count) {
+        return result;
+    }
+
+    instance_ptr elts = tupT->eltPtr(self_w->dataPtr(), 0);
+
+    // box every element with a loop that's specialized on the element type,
+    // rather than dispatching on the type once per element
+    auto fill = [&](auto&& boxElement) -> PyObject* {
+        for (int64_t k = 0; k < count; k++) {
+            PyObject* elt = boxElement(k);
+
+            if (!elt) {
+                decref(result);
+                return NULL;
+            }
+
+            PyList_SET_ITEM(result, k, elt);
+        }
+
+        return result;
+    };
+
+    switch (eltType->getTypeCategory()) {
+        case Type::TypeCategory::catInt64:
+            return fill([&](int64_t k) { return PyLong_FromLongLong(((int64_t*)elts)[k]); });
+        case Type::TypeCategory::catFloat64:
+            return fill([&](int64_t k) { return PyFloat_FromDouble(((double*)elts)[k]); });
+        case Type::TypeCategory::catBool:
+            return fill([&](int64_t k) { return incref(((bool*)elts)[k] ? Py_True : Py_False); });
+        case Type::TypeCategory::catString:
+            return fill([&](int64_t k) {
+                return PyStringInstance::extractPythonObjectConcrete(
+                    (StringType*)eltType,
+                    elts + k * sizeof(StringType::layout*)
+                );
+            });
+        default: {
+            size_t bytesPerElt = eltType->bytecount();
+
+            return fill([&](int64_t k) {
+                return extractPythonObject(
+                    elts + k * bytesPerElt,
+                    eltType,
+                    (PyObject*)(tupT->isListOf() ? o : nullptr)
+                );
+            });
+        }
+    }
+}
+
 PyObject* PyTupleOrListOfInstance::tp_iter_concrete() {
     PyInstance* output = (PyInstance*)PyInstance::initialize(type(), [&](instance_ptr data) {
         type()->copy_constructor(data, dataPtr());
@@ -693,10 +1168,15 @@ PyObject* PyTupleOrListOfInstance::tp_iternext_concrete() {
 
 
 PyMethodDef* PyTupleOfInstance::typeMethodsConcrete(Type* t) {
-    return new PyMethodDef [6] {
+    return new PyMethodDef [11] {
         {"toArray", (PyCFunction)PyTupleOrListOfInstance::toArray, METH_VARARGS, TupleOf_toArray_doc},
+        {"toArrow", (PyCFunction)PyTupleOrListOfInstance::toArrow, METH_VARARGS, tupleOrListToArrow_doc},
+        {"fromArrow", (PyCFunction)PyTupleOrListOfInstance::fromArrow, METH_VARARGS | METH_KEYWORDS | METH_CLASS, tupleOrListFromArrow_doc},
+        {"__arrow_c_array__", (PyCFunction)PyTupleOrListOfInstance::arrowCArray, METH_VARARGS | METH_KEYWORDS, tupleOrListArrowCArray_doc},
+        {"tolist", (PyCFunction)PyTupleOrListOfInstance::toList, METH_VARARGS, tupleOrListToList_doc},
         {"toBytes", (PyCFunction)PyTupleOrListOfInstance::toBytes, METH_VARARGS, TUPLE_TO_BYTES_DOCSTRING},
         {"fromBytes", (PyCFunction)PyTupleOrListOfInstance::fromBytes, METH_VARARGS | METH_KEYWORDS | METH_CLASS, TUPLE_FROM_BYTES_DOCSTRING},
+        {"fromBuffer", (PyCFunction)PyTupleOrListOfInstance::fromBuffer, METH_VARARGS | METH_KEYWORDS | METH_CLASS, TUPLE_FROM_BUFFER_DOCSTRING},
         {"pointerUnsafe", (PyCFunction)PyTupleOrListOfInstance::pointerUnsafe, METH_VARARGS, tuplePointerUnsafe_doc},
         {NULL, NULL}
     };
@@ -858,6 +1338,24 @@ PyObject* PyListOfInstance::listReserve(PyObject* o, PyObject* args) {
     return incref(Py_None);
 }
 
+PyDoc_STRVAR(listShrinkToFit_doc,
+    "lst.shrinkToFit() -> None, and releases any space reserved beyond len(lst)\n"
+    "\n"
+    "The same as lst.reserve(0).\n"
+    );
+PyObject* PyListOfInstance::listShrinkToFit(PyObject* o, PyObject* args) {
+    if (PyTuple_Size(args) != 0) {
+        PyErr_SetString(PyExc_TypeError, "ListOf.shrinkToFit takes no arguments");
+        return NULL;
+    }
+
+    PyListOfInstance* self_w = (PyListOfInstance*)o;
+
+    self_w->type()->shrinkToFit(self_w->dataPtr());
+
+    return incref(Py_None);
+}
+
 PyDoc_STRVAR(listClear_doc,
     "lst.clear() -> None, and resize lst to 0."
     );
@@ -1138,6 +1636,15 @@ PyDoc_STRVAR(
     "NamedTuple."
 );
 
+PyDoc_STRVAR(
+    LIST_FROM_BUFFER_DOCSTRING,
+    "ListOf(T).fromBuffer(buffer) -> ListOf(T)\n\nConstruct a ListOf(T) by copying a contiguous buffer of T.\n\n"
+    "T must be an integer, float, or bool type, and 'buffer' may be any object\n"
+    "exporting a C-contiguous buffer of the same kind and width of value (a numpy\n"
+    "array, an array.array, a memoryview, another TupleOf(T) or ListOf(T)). The\n"
+    "elements are copied in a single memcpy."
+);
+
 PyDoc_STRVAR(
     LIST_FROM_BYTES_DOCSTRING,
     "ListOf(T).fromBytes(b: bytes) -> ListOf(T)\n\nConstruct a ListOf(T) from the raw bytes that would underly it.\n\n"
@@ -1147,15 +1654,21 @@ PyDoc_STRVAR(
 );
 
 PyMethodDef* PyListOfInstance::typeMethodsConcrete(Type* t) {
-    return new PyMethodDef [15] {
+    return new PyMethodDef [21] {
         {"toArray", (PyCFunction)PyTupleOrListOfInstance::toArray, METH_VARARGS, ListOf_toArray_doc},
+        {"toArrow", (PyCFunction)PyTupleOrListOfInstance::toArrow, METH_VARARGS, tupleOrListToArrow_doc},
+        {"fromArrow", (PyCFunction)PyTupleOrListOfInstance::fromArrow, METH_VARARGS | METH_KEYWORDS | METH_CLASS, tupleOrListFromArrow_doc},
+        {"__arrow_c_array__", (PyCFunction)PyTupleOrListOfInstance::arrowCArray, METH_VARARGS | METH_KEYWORDS, tupleOrListArrowCArray_doc},
+        {"tolist", (PyCFunction)PyTupleOrListOfInstance::toList, METH_VARARGS, tupleOrListToList_doc},
         {"toBytes", (PyCFunction)PyTupleOrListOfInstance::toBytes, METH_VARARGS, LIST_TO_BYTES_DOCSTRING},
         {"fromBytes", (PyCFunction)PyTupleOrListOfInstance::fromBytes, METH_VARARGS | METH_KEYWORDS | METH_CLASS, LIST_FROM_BYTES_DOCSTRING},
+        {"fromBuffer", (PyCFunction)PyTupleOrListOfInstance::fromBuffer, METH_VARARGS | METH_KEYWORDS | METH_CLASS, LIST_FROM_BUFFER_DOCSTRING},
         {"append", (PyCFunction)PyListOfInstance::listAppend, METH_VARARGS, listAppend_doc},
         {"extend", (PyCFunction)PyListOfInstance::listExtend, METH_VARARGS, listExtend_doc},
         {"clear", (PyCFunction)PyListOfInstance::listClear, METH_VARARGS, listClear_doc},
         {"reserved", (PyCFunction)PyListOfInstance::listReserved, METH_VARARGS, listReserved_doc},
         {"reserve", (PyCFunction)PyListOfInstance::listReserve, METH_VARARGS, listReserve_doc},
+        {"shrinkToFit", (PyCFunction)PyListOfInstance::listShrinkToFit, METH_VARARGS, listShrinkToFit_doc},
         {"resize", (PyCFunction)PyListOfInstance::listResize, METH_VARARGS, listResize_doc},
         {"pop", (PyCFunction)PyListOfInstance::listPop, METH_VARARGS, listPop_doc},
         {"setSizeUnsafe", (PyCFunction)PyListOfInstance::listSetSizeUnsafe, METH_VARARGS, listSetSizeUnsafe_doc},
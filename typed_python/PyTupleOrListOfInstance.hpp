@@ -46,10 +46,32 @@ public:
 
     static PyObject* toArray(PyObject* o, PyObject* args);
 
+    static PyObject* toList(PyObject* o, PyObject* args);
+
     static PyObject* toBytes(PyObject* o, PyObject* args);
 
     static PyObject* fromBytes(PyObject* o, PyObject* args, PyObject* kwds);
 
+    static PyObject* fromBuffer(PyObject* o, PyObject* args, PyObject* kwds);
+
+    static PyObject* arrowCArray(PyObject* o, PyObject* args, PyObject* kwds);
+
+    static PyObject* toArrow(PyObject* o, PyObject* args);
+
+    static PyObject* fromArrow(PyObject* o, PyObject* args, PyObject* kwds);
+
+    // the struct-module format character for a buffer of 'eltType', or nullptr
+    // if we don't export buffers of it
+    static const char* bufferFormatFor(Type* eltType);
+
+    // the PyBufferProcs of every TupleOf and ListOf whose elements we can
+    // export as a buffer. See PyInstance::isNativeType.
+    static PyBufferProcs* bufferExportProcs();
+
+    static int bf_getbuffer(PyObject* o, Py_buffer* view, int flags);
+
+    static void bf_releasebuffer(PyObject* o, Py_buffer* view);
+
     static bool pyValCouldBeOfTypeConcrete(modeled_type* type, PyObject* pyRepresentation, ConversionLevel level);
 
     static void mirrorTypeInformationIntoPyTypeConcrete(TupleOrListOfType* inType, PyTypeObject* pyType);
@@ -75,6 +97,8 @@ public:
 
     static PyObject* listReserve(PyObject* o, PyObject* args);
 
+    static PyObject* listShrinkToFit(PyObject* o, PyObject* args);
+
     static PyObject* listClear(PyObject* o, PyObject* args);
 
     static PyObject* listReserved(PyObject* o, PyObject* args);
@@ -0,0 +1,236 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "PyTypeSchemaCache.hpp"
+
+
+PyDoc_STRVAR(PyTypeSchemaCache_doc,
+    "TypeSchemaCache()\n\n"
+    "A table of types that both ends of a connection refer to by small integer\n"
+    "ids instead of by name or type hash.\n\n"
+    "Attach one to a SerializationContext with 'withTypeSchemaCache' on each side,\n"
+    "then pass the bytes the sender's 'announceTypes' returns to the receiver's\n"
+    "'acceptTypes'. Every later message between them writes each announced\n"
+    "type as a single varint. A cache describes one direction: a connection\n"
+    "that sends both ways needs one pair of caches per direction."
+);
+
+PyDoc_STRVAR(PyTypeSchemaCache_add_doc,
+    "TypeSchemaCache.add(T) -> int\n\n"
+    "Add T, if it's new, and return its id. Ids are assigned in order, so two\n"
+    "caches only agree if the same types are added to both in the same order,\n"
+    "which is what 'SerializationContext.announceTypes' and 'acceptTypes' arrange."
+);
+
+PyDoc_STRVAR(PyTypeSchemaCache_idFor_doc,
+    "TypeSchemaCache.idFor(T) -> int or None\n\n"
+    "Return the id of T, or None if it isn't in the cache."
+);
+
+PyDoc_STRVAR(PyTypeSchemaCache_typeFor_doc,
+    "TypeSchemaCache.typeFor(id) -> type\n\n"
+    "Return the type with the given id, or raise KeyError."
+);
+
+PyMethodDef PyTypeSchemaCacheInstance_methods[] = {
+    {"add", (PyCFunction)PyTypeSchemaCache::add, METH_VARARGS | METH_KEYWORDS, PyTypeSchemaCache_add_doc},
+    {"idFor", (PyCFunction)PyTypeSchemaCache::idFor, METH_VARARGS | METH_KEYWORDS, PyTypeSchemaCache_idFor_doc},
+    {"typeFor", (PyCFunction)PyTypeSchemaCache::typeFor, METH_VARARGS | METH_KEYWORDS, PyTypeSchemaCache_typeFor_doc},
+    {NULL}  /* Sentinel */
+};
+
+PySequenceMethods PyTypeSchemaCache_sequence_methods = {
+    .sq_length = (lenfunc)PyTypeSchemaCache::len
+};
+
+/* static */
+void PyTypeSchemaCache::dealloc(PyTypeSchemaCache *self)
+{
+    self->mCache.~shared_ptr();
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+/* static */
+PyObject* PyTypeSchemaCache::new_(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    PyTypeSchemaCache* self;
+
+    self = (PyTypeSchemaCache*)type->tp_alloc(type, 0);
+
+    if (self != NULL) {
+        new (&self->mCache) std::shared_ptr<TypeSchemaCache>(new TypeSchemaCache());
+    }
+
+    return (PyObject*)self;
+}
+
+/* static */
+int PyTypeSchemaCache::init(PyTypeSchemaCache *self, PyObject *args, PyObject *kwargs)
+{
+    static const char* kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+// parse the single type argument of 'add' and 'idFor'
+static Type* parseTypeArg(PyObject* args, PyObject* kwargs, const char* methodName) {
+    static const char* kwlist[] = {"T", NULL};
+
+    PyObject* typeArg;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &typeArg)) {
+        return nullptr;
+    }
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(typeArg);
+
+    if (!t) {
+        PyErr_Format(PyExc_TypeError, "TypeSchemaCache.%s expects a type object", methodName);
+        return nullptr;
+    }
+
+    return t;
+}
+
+/* static */
+PyObject* PyTypeSchemaCache::add(PyTypeSchemaCache* self, PyObject* args, PyObject* kwargs)
+{
+    Type* t = parseTypeArg(args, kwargs, "add");
+
+    if (!t) {
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        t->assertForwardsResolved();
+
+        return PyLong_FromSize_t(self->mCache->add(t));
+    });
+}
+
+/* static */
+PyObject* PyTypeSchemaCache::idFor(PyTypeSchemaCache* self, PyObject* args, PyObject* kwargs)
+{
+    Type* t = parseTypeArg(args, kwargs, "idFor");
+
+    if (!t) {
+        return NULL;
+    }
+
+    int64_t id = self->mCache->idFor(t);
+
+    if (id < 0) {
+        return incref(Py_None);
+    }
+
+    return PyLong_FromLongLong(id);
+}
+
+/* static */
+PyObject* PyTypeSchemaCache::typeFor(PyTypeSchemaCache* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* kwlist[] = {"id", NULL};
+
+    Py_ssize_t id;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n", (char**)kwlist, &id)) {
+        return NULL;
+    }
+
+    Type* t = id >= 0 ? self->mCache->typeFor(id) : nullptr;
+
+    if (!t) {
+        PyErr_Format(PyExc_KeyError, "TypeSchemaCache has no type with id %zd", id);
+        return NULL;
+    }
+
+    return incref(PyInstance::typePtrToPyTypeRepresentation(t));
+}
+
+/* static */
+Py_ssize_t PyTypeSchemaCache::len(PyTypeSchemaCache* self)
+{
+    return self->mCache->size();
+}
+
+/* static */
+std::shared_ptr<TypeSchemaCache> PyTypeSchemaCache::cacheFor(PyObject* o) {
+    if (!PyObject_TypeCheck(o, &PyType_TypeSchemaCache)) {
+        return nullptr;
+    }
+
+    return ((PyTypeSchemaCache*)o)->mCache;
+}
+
+
+PyTypeObject PyType_TypeSchemaCache = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "TypeSchemaCache",
+    .tp_basicsize = sizeof(PyTypeSchemaCache),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor) PyTypeSchemaCache::dealloc,
+    #if PY_MINOR_VERSION < 8
+    .tp_print = 0,
+    #else
+    .tp_vectorcall_offset = 0,                  // printfunc  (Changed to tp_vectorcall_offset in Python 3.8)
+    #endif
+    .tp_getattr = 0,
+    .tp_setattr = 0,
+    .tp_as_async = 0,
+    .tp_repr = 0,
+    .tp_as_number = 0,
+    .tp_as_sequence = &PyTypeSchemaCache_sequence_methods,
+    .tp_as_mapping = 0,
+    .tp_hash = 0,
+    .tp_call = 0,
+    .tp_str = 0,
+    .tp_getattro = 0,
+    .tp_setattro = 0,
+    .tp_as_buffer = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = PyTypeSchemaCache_doc,
+    .tp_traverse = 0,
+    .tp_clear = 0,
+    .tp_richcompare = 0,
+    .tp_weaklistoffset = 0,
+    .tp_iter = 0,
+    .tp_iternext = 0,
+    .tp_methods = PyTypeSchemaCacheInstance_methods,
+    .tp_members = 0,
+    .tp_getset = 0,
+    .tp_base = 0,
+    .tp_dict = 0,
+    .tp_descr_get = 0,
+    .tp_descr_set = 0,
+    .tp_dictoffset = 0,
+    .tp_init = (initproc) PyTypeSchemaCache::init,
+    .tp_alloc = 0,
+    .tp_new = PyTypeSchemaCache::new_,
+    .tp_free = 0,
+    .tp_is_gc = 0,
+    .tp_bases = 0,
+    .tp_mro = 0,
+    .tp_cache = 0,
+    .tp_subclasses = 0,
+    .tp_weaklist = 0,
+    .tp_del = 0,
+    .tp_version_tag = 0,
+    .tp_finalize = 0,
+};
@@ -0,0 +1,49 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "PyInstance.hpp"
+#include "TypeSchemaCache.hpp"
+#include <memory>
+
+// the python face of a TypeSchemaCache. SerializationContexts hold one of
+// these, and the PythonSerializationContexts built from them share its cache.
+class PyTypeSchemaCache {
+public:
+    PyObject_HEAD
+
+    std::shared_ptr<TypeSchemaCache> mCache;
+
+    static void dealloc(PyTypeSchemaCache *self);
+
+    static PyObject *new_(PyTypeObject *type, PyObject *args, PyObject *kwargs);
+
+    static int init(PyTypeSchemaCache *self, PyObject *args, PyObject *kwargs);
+
+    static PyObject* add(PyTypeSchemaCache* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* idFor(PyTypeSchemaCache* self, PyObject* args, PyObject* kwargs);
+
+    static PyObject* typeFor(PyTypeSchemaCache* self, PyObject* args, PyObject* kwargs);
+
+    static Py_ssize_t len(PyTypeSchemaCache* self);
+
+    // the cache inside 'o', or nullptr if it isn't a TypeSchemaCache
+    static std::shared_ptr<TypeSchemaCache> cacheFor(PyObject* o);
+};
+
+extern PyTypeObject PyType_TypeSchemaCache;
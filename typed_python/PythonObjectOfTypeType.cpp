@@ -394,37 +394,38 @@ void PythonObjectOfType::deepcopyConcrete(
 
 size_t PythonObjectOfType::deepBytecountConcrete(
     instance_ptr instance,
-    std::unordered_set<void*>& alreadyVisited,
+    DeepBytecountContext& context,
     std::set<Slab*>* outSlabs
 ) {
     layout_type* layoutPtr = *(layout_type**)instance;
 
-    if (alreadyVisited.find((void*)layoutPtr) != alreadyVisited.end()) {
+    if (context.visited.contains((void*)layoutPtr)) {
         return 0;
     }
 
-    alreadyVisited.insert((void*)layoutPtr);
+    context.visited.insert((void*)layoutPtr);
+    context.noteRefcount(layoutPtr->refcount);
 
     if (outSlabs && Slab::slabForAlloc(layoutPtr)) {
         outSlabs->insert(Slab::slabForAlloc(layoutPtr));
         return 0;
     }
 
-    return bytesRequiredForAllocation(sizeof(layout_type)) + deepBytecountForPyObj(layoutPtr->pyObj, alreadyVisited, outSlabs);
+    return bytesRequiredForAllocation(sizeof(layout_type)) + deepBytecountForPyObj(layoutPtr->pyObj, context, outSlabs);
 }
 
-size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
     PyEnsureGilAcquired getTheGil;
 
     if (!o) {
         throw std::runtime_error("Can't deepcopy the null pyobj.");
     }
 
-    if (alreadyVisited.find((void*)o) != alreadyVisited.end()) {
+    if (context.visited.contains((void*)o)) {
         return 0;
     }
 
-    alreadyVisited.insert((void*)o);
+    context.visited.insert((void*)o);
 
     if (PyType_Check(o) || PyModule_Check(o)) {
         return 0;
@@ -433,7 +434,7 @@ size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set
     if (Type* t = PyInstance::extractTypeFrom(o->ob_type)) {
         PyEnsureGilReleased releaseTheGil;
 
-        return t->deepBytecount(((PyInstance*)o)->dataPtr(), alreadyVisited, outSlabs);
+        return t->deepBytecount(((PyInstance*)o)->dataPtr(), context, outSlabs);
     }
 
     if (PyDict_Check(o)) {
@@ -443,8 +444,8 @@ size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set
         Py_ssize_t pos = 0;
 
         while (PyDict_Next(o, &pos, &key, &value)) {
-            res += deepBytecountForPyObj(key, alreadyVisited, outSlabs);
-            res += deepBytecountForPyObj(value, alreadyVisited, outSlabs);
+            res += deepBytecountForPyObj(key, context, outSlabs);
+            res += deepBytecountForPyObj(value, context, outSlabs);
         }
 
         return res;
@@ -453,7 +454,7 @@ size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set
     if (PyList_Check(o)) {
         size_t res = 0;
         for (long k = 0; k < PyList_Size(o); k++) {
-            res += deepBytecountForPyObj(PyList_GetItem(o, k), alreadyVisited, outSlabs);
+            res += deepBytecountForPyObj(PyList_GetItem(o, k), context, outSlabs);
         }
         return res;
     }
@@ -461,7 +462,7 @@ size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set
     if (PyTuple_Check(o)) {
         size_t res = 0;
         for (long k = 0; k < PyTuple_Size(o); k++) {
-            res += deepBytecountForPyObj(PyTuple_GetItem(o, k), alreadyVisited, outSlabs);
+            res += deepBytecountForPyObj(PyTuple_GetItem(o, k), context, outSlabs);
         }
         return res;
     }
@@ -469,7 +470,7 @@ size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set
     if (PySet_Check(o)) {
         size_t res = 0;
 
-        iterate(o, [&](PyObject* o2) { res += deepBytecountForPyObj(o2, alreadyVisited, outSlabs); });
+        iterate(o, [&](PyObject* o2) { res += deepBytecountForPyObj(o2, context, outSlabs); });
 
         return res;
     }
@@ -478,7 +479,7 @@ size_t PythonObjectOfType::deepBytecountForPyObj(PyObject* o, std::unordered_set
         PyObjectStealer dict(PyObject_GetAttrString(o, "__dict__"));
 
         if (dict) {
-            return deepBytecountForPyObj(dict, alreadyVisited, outSlabs);
+            return deepBytecountForPyObj(dict, context, outSlabs);
         }
     }
 
@@ -27,7 +27,7 @@ public:
 
     class layout_type {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         PyObject* pyObj;
     };
 
@@ -175,7 +175,7 @@ public:
         buffer.getContext().serializePythonObject(p, buffer, fieldNumber);
     }
 
-    static size_t deepBytecountForPyObj(PyObject* o, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs);
+    static size_t deepBytecountForPyObj(PyObject* o, DeepBytecountContext& context, std::set<Slab*>* outSlabs);
 
     static PyObject* deepcopyPyObject(
         PyObject* o,
@@ -188,7 +188,7 @@ public:
         DeepcopyContext& context
     );
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs);
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs);
 
     template<class buf_t>
     void deserialize(instance_ptr self, buf_t& buffer, size_t wireType) {
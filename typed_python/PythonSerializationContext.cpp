@@ -18,11 +18,13 @@
 #include "AllTypes.hpp"
 #include "PyInstance.hpp"
 #include "MutuallyRecursiveTypeGroup.hpp"
+#include "PyTypeSchemaCache.hpp"
+#include "PySerializationNameCache.hpp"
 
 void PythonSerializationContext::setFlags() {
     Class* serContext = (Class*)mContextObj.type();
 
-    auto getBool = [&](const char* name) {
+    auto getMember = [&](const char* name, Type::TypeCategory category, const char* categoryName) {
         int i = serContext->getMemberIndex(name);
 
         if (i < 0) {
@@ -37,25 +39,79 @@ void PythonSerializationContext::setFlags() {
             );
         }
 
-        if (!serContext->getMemberType(i)->isBool()) {
+        if (serContext->getMemberType(i)->getTypeCategory() != category) {
             throw std::runtime_error(
-                "Somehow this SerializationContext member " + std::string(name) + " is not a bool"
+                "Somehow this SerializationContext member " + std::string(name) + " is not " + categoryName
             );
         }
 
-        return *(bool*)serContext->eltPtr(mContextObj.data(), i);
+        return serContext->eltPtr(mContextObj.data(), i);
+    };
+
+    auto getBool = [&](const char* name) {
+        return *(bool*)getMember(name, Type::TypeCategory::catBool, "a bool");
+    };
+
+    auto getInt = [&](const char* name) {
+        return *(int64_t*)getMember(name, Type::TypeCategory::catInt64, "an int");
     };
 
     mCompressionEnabled = getBool("compressionEnabled");
+    mCompressionLevel = getInt("compressionLevel");
     mSerializeHashSequence = getBool("serializeHashSequence");
     mSerializePodListsInline = getBool("serializePodListsInline");
     mCompressUsingThreads = getBool("compressUsingThreads");
+    mInternStrings = getBool("internStrings");
+    mDeserializeIntoSlab = getBool("deserializeIntoSlab");
+    mSerializeListsColumnar = getBool("serializeListsColumnar");
+    mSerializeThreadCount = std::max<int64_t>(1, getInt("serializeThreadCount"));
     mSuppressLineInfo = !getBool("encodeLineInformationForCode");
+
+    PyObject* cache = PyObjectHandleTypeBase::getPyObj(
+        getMember("typeSchemaCache", Type::TypeCategory::catPythonObjectOfType, "an object")
+    );
+
+    mTypeSchemaCache.reset();
+
+    if (cache != Py_None) {
+        mTypeSchemaCache = PyTypeSchemaCache::cacheFor(cache);
+
+        if (!mTypeSchemaCache) {
+            throw std::runtime_error("SerializationContext.typeSchemaCache must be None or a TypeSchemaCache");
+        }
+    }
+
+    mNameCache.reset();
+
+    // the fault-injection overrides can answer differently each time, so we don't
+    // remember what they say.
+    bool namesAreOverridden = (
+        *(uint8_t*)getMember("nameForObjectOverride", Type::TypeCategory::catOneOf, "a OneOf")
+        || *(uint8_t*)getMember("objectFromNameOverride", Type::TypeCategory::catOneOf, "a OneOf")
+    );
+
+    PyObject* nameCache = PyObjectHandleTypeBase::getPyObj(
+        getMember("nameCache", Type::TypeCategory::catPythonObjectOfType, "an object")
+    );
+
+    if (nameCache != Py_None && !namesAreOverridden) {
+        mNameCache = PySerializationNameCache::cacheFor(nameCache);
+
+        if (!mNameCache) {
+            throw std::runtime_error("SerializationContext.nameCache must be None or a SerializationNameCache");
+        }
+    }
 }
 
 std::string PythonSerializationContext::getNameForPyObj(PyObject* o) const {
     PyEnsureGilAcquired acquireTheGil;
 
+    std::string name;
+
+    if (mNameCache && mNameCache->lookupName(o, name)) {
+        return name;
+    }
+
     PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
 
     PyObjectStealer nameForObject(PyObject_CallMethod(contextAsPyObj, "nameForObject", "(O)", o));
@@ -66,12 +122,38 @@ std::string PythonSerializationContext::getNameForPyObj(PyObject* o) const {
 
     if (nameForObject != Py_None) {
         if (!PyUnicode_Check(nameForObject)) {
-            decref(nameForObject);
             throw std::runtime_error("nameForObject returned something other than None or a string.");
         }
 
-        return std::string(PyUnicode_AsUTF8(nameForObject));
+        name = PyUnicode_AsUTF8(nameForObject);
+    }
+
+    // only native types live long enough that it's worth remembering they have no name
+    if (mNameCache && (name.size() || (PyType_Check(o) && PyInstance::extractTypeFrom((PyTypeObject*)o)))) {
+        mNameCache->recordName(o, name);
+    }
+
+    return name;
+}
+
+PyObject* PythonSerializationContext::getPyObjForName(const std::string& name) const {
+    PyEnsureGilAcquired acquireTheGil;
+
+    if (mNameCache) {
+        PyObject* cached = mNameCache->lookupObject(name);
+
+        if (cached) {
+            return incref(cached);
+        }
+    }
+
+    PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
+
+    PyObject* result = PyObject_CallMethod(contextAsPyObj, "objectFromName", "s", name.c_str());
+
+    if (result && result != Py_None && mNameCache) {
+        mNameCache->recordObject(name, result);
     }
 
-    return "";
+    return result;
 }
@@ -19,6 +19,9 @@
 #include "util.hpp"
 #include "Type.hpp"
 #include "SerializationContext.hpp"
+#include "TypeSchemaCache.hpp"
+#include "SerializationNameCache.hpp"
+#include <memory>
 
 // PySet_CheckExact is missing from the CPython API for some reason
 #ifndef PySet_CheckExact
@@ -83,9 +86,14 @@ public:
     PythonSerializationContext(InstanceRef inContext) :
             mContextObj(inContext),
             mCompressionEnabled(false),
+            mCompressionLevel(0),
             mSerializePodListsInline(false),
             mSerializeHashSequence(false),
-            mCompressUsingThreads(false)
+            mCompressUsingThreads(false),
+            mInternStrings(false),
+            mDeserializeIntoSlab(false),
+            mSerializeListsColumnar(false),
+            mSerializeThreadCount(1)
     {
         if (!inContext.type()->isClass() || inContext.type()->name() != "SerializationContext") {
             throw std::runtime_error("Expected a SerializationContext, not " + inContext.type()->name());
@@ -96,9 +104,14 @@ public:
 
     PythonSerializationContext(PyObject* inContextPy) :
             mCompressionEnabled(false),
+            mCompressionLevel(0),
             mSerializePodListsInline(false),
             mSerializeHashSequence(false),
-            mCompressUsingThreads(false)
+            mCompressUsingThreads(false),
+            mInternStrings(false),
+            mDeserializeIntoSlab(false),
+            mSerializeListsColumnar(false),
+            mSerializeThreadCount(1)
     {
         auto typeAndPtr = PyInstance::extractTypeAndPtrFrom(inContextPy);
 
@@ -119,6 +132,10 @@ public:
         return mCompressionEnabled;
     }
 
+    int compressionLevel() const {
+        return mCompressionLevel;
+    }
+
     bool isLineInfoSuppressed() const {
         return mSuppressLineInfo;
     }
@@ -131,6 +148,27 @@ public:
         return mSerializePodListsInline;
     }
 
+    bool internStrings() const {
+        return mInternStrings;
+    }
+
+    bool deserializeIntoSlab() const {
+        return mDeserializeIntoSlab;
+    }
+
+    bool serializeListsColumnar() const {
+        return mSerializeListsColumnar;
+    }
+
+    int serializeThreadCount() const {
+        return mSerializeThreadCount;
+    }
+
+    // the types we've agreed to write as ids, or nullptr
+    const std::shared_ptr<TypeSchemaCache>& typeSchemaCache() const {
+        return mTypeSchemaCache;
+    }
+
     // should we serialize an integer in the order of the
     // hash sequence rather than the hash itself?
     bool shouldSerializeHashSequence() const {
@@ -185,6 +223,10 @@ public:
 
     std::string getNameForPyObj(PyObject* o) const;
 
+    // what our 'objectFromName' returns for 'name': a new reference, which is
+    // Py_None if nothing has that name, or nullptr with the python error set.
+    PyObject* getPyObjForName(const std::string& name) const;
+
 private:
     template<class Factory_Fn, class SetItem_Fn>
     inline PyObject* deserializeIndexable(DeserializationBuffer& b, size_t wireType, Factory_Fn factory_fn, SetItem_Fn set_item_and_steal_ref_fn, int64_t memo) const;
@@ -222,6 +264,8 @@ private:
 
     bool mCompressionEnabled;
 
+    int mCompressionLevel;
+
     bool mSerializePodListsInline;
 
     bool mCompressUsingThreads;
@@ -229,4 +273,16 @@ private:
     bool mSuppressLineInfo;
 
     bool mSerializeHashSequence;
+
+    bool mInternStrings;
+
+    bool mDeserializeIntoSlab;
+
+    bool mSerializeListsColumnar;
+
+    int mSerializeThreadCount;
+
+    std::shared_ptr<TypeSchemaCache> mTypeSchemaCache;
+
+    std::shared_ptr<SerializationNameCache> mNameCache;
 };
@@ -22,6 +22,7 @@
 // virtual
 PyObject* PythonSerializationContext::deserializePythonObject(DeserializationBuffer& b, size_t inWireType) const {
     PyEnsureGilAcquired acquireTheGil;
+    DeserializationBuffer::DepthGuard nesting(b);
 
     PyObject* result = nullptr;
 
@@ -247,10 +248,7 @@ PyObject* PythonSerializationContext::deserializePythonObjectFromName(Deserializ
     assertWireTypesEqual(wireType, WireType::BYTES);
 
     std::string name = b.readStringObject();
-
-    PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
-
-    PyObject* result = PyObject_CallMethod(contextAsPyObj, "objectFromName", "s", name.c_str());
+    PyObject* result = getPyObjForName(name);
 
     if (!result) {
         throw PythonExceptionSet();
@@ -993,10 +991,7 @@ MutuallyRecursiveTypeGroup* PythonSerializationContext::deserializeMutuallyRecur
             // field 5 indicates that this is a mutually recursive type group
             // identified by the name of an object inside of the group.
             std::string name = b.readStringObject();
-
-            PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
-
-            PyObjectStealer namedObj(PyObject_CallMethod(contextAsPyObj, "objectFromName", "s", name.c_str()));
+            PyObjectStealer namedObj(getPyObjForName(name));
 
             if (!namedObj) {
                 throw PythonExceptionSet();
@@ -1152,6 +1147,7 @@ Type* PythonSerializationContext::deserializeNativeType(DeserializationBuffer& b
     int32_t kind = -1;
     int32_t which = -1;
     int32_t category = -1;
+    int64_t schemaId = -1;
 
     b.consumeCompoundMessage(inWireType, [&](size_t fieldNumber, size_t wireType) {
         if (fieldNumber == 0) {
@@ -1183,6 +1179,10 @@ Type* PythonSerializationContext::deserializeNativeType(DeserializationBuffer& b
         if (kind == 4 && fieldNumber == 2) {
             assertWireTypesEqual(wireType, WireType::VARINT);
             indexInGroup = b.readUnsignedVarint();
+        } else
+        if (kind == 5 && fieldNumber == 1) {
+            assertWireTypesEqual(wireType, WireType::VARINT);
+            schemaId = b.readUnsignedVarint();
         } else {
             throw std::runtime_error("Invalid nativeType: kind/fieldNumber error.");
         }
@@ -1206,10 +1206,7 @@ Type* PythonSerializationContext::deserializeNativeType(DeserializationBuffer& b
         if (which == -1) {
             throw std::runtime_error("Invalid inline named concrete alternative: no index.");
         }
-
-        PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
-
-        PyObjectStealer namedObj(PyObject_CallMethod(contextAsPyObj, "objectFromName", "s", name.c_str()));
+        PyObjectStealer namedObj(getPyObjForName(name));
 
         if (!namedObj) {
             throw PythonExceptionSet();
@@ -1242,10 +1239,7 @@ Type* PythonSerializationContext::deserializeNativeType(DeserializationBuffer& b
         if (name.size() == 0) {
             throw std::runtime_error("Invalid inline named type");
         }
-
-        PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
-
-        PyObjectStealer namedObj(PyObject_CallMethod(contextAsPyObj, "objectFromName", "s", name.c_str()));
+        PyObjectStealer namedObj(getPyObjForName(name));
 
         if (!namedObj) {
             throw PythonExceptionSet();
@@ -1314,6 +1308,29 @@ Type* PythonSerializationContext::deserializeNativeType(DeserializationBuffer& b
         );
     }
 
+    if (kind == 5) {
+        if (schemaId == -1) {
+            throw std::runtime_error("Corrupt native type: missing TypeSchemaCache id");
+        }
+
+        if (!mTypeSchemaCache) {
+            throw std::runtime_error(
+                "This message refers to a type by TypeSchemaCache id, but the SerializationContext has no TypeSchemaCache"
+            );
+        }
+
+        Type* nativeType = mTypeSchemaCache->typeFor(schemaId);
+
+        if (!nativeType) {
+            throw std::runtime_error(
+                "This message refers to TypeSchemaCache id " + format(schemaId)
+                + ", but the cache only has " + format(mTypeSchemaCache->size()) + " types"
+            );
+        }
+
+        return nativeType;
+    }
+
     throw std::runtime_error("Unreachable");
 }
 
@@ -1418,10 +1435,7 @@ Type* PythonSerializationContext::deserializeNativeTypeInner(DeserializationBuff
             } else
             if (wireType == WireType::BYTES) {
                 std::string objectName = b.readStringObject();
-
-                PyObjectStealer contextAsPyObj(PyInstance::extractPythonObject(mContextObj));
-
-                PyObjectStealer namedObj(PyObject_CallMethod(contextAsPyObj, "objectFromName", "s", objectName.c_str()));
+                PyObjectStealer namedObj(getPyObjForName(objectName));
 
                 if (!namedObj) {
                     throw PythonExceptionSet();
@@ -347,12 +347,18 @@ void PythonSerializationContext::serializeNativeType(Type* nativeType, Serializa
     b.writeBeginCompound(fieldNumber);
 
     std::string name;
+    int64_t schemaId;
 
     if (isSimpleType(nativeType)) {
         // this is an inline type
         b.writeUnsignedVarintObject(0, 0);
         b.writeUnsignedVarintObject(1, nativeType->getTypeCategory());
     } else
+    if (mTypeSchemaCache && (schemaId = mTypeSchemaCache->idFor(nativeType)) >= 0) {
+        // this is a type we and the other side have both put in our TypeSchemaCache
+        b.writeUnsignedVarintObject(0, 5);
+        b.writeUnsignedVarintObject(1, schemaId);
+    } else
     if (nativeType->getTypeCategory() == Type::TypeCategory::catConcreteAlternative &&
             (name = getNameForPyObj((PyObject*)PyInstance::typeObj(nativeType->getBaseType()))).size()) {
         // this is an inline named concrete alternative
@@ -423,24 +429,38 @@ void PythonSerializationContext::serializeMutuallyRecursiveTypeGroup(MutuallyRec
         }
 
         // check if any element of this group is named. If so, we can just write the name and
-        // then grab the group on the other side
-        for (auto& indexAndObj: group->getIndexToObject()) {
-            std::string name;
+        // then grab the group on the other side. Our name cache may already know which
+        // name that is, or that there isn't one.
+        std::string groupName;
+        bool groupNameKnown = mNameCache && mNameCache->lookupGroupName(group, groupName);
 
+        if (groupName.size()) {
+            b.writeStringObject(5, groupName);
+            b.writeEndCompound();
+            return;
+        }
+
+        for (auto& indexAndObj: group->getIndexToObject()) {
             TypeOrPyobj obj = indexAndObj.second;
 
-            name = getNameForPyObj(
-                obj.pyobj() ? obj.pyobj() : (PyObject*)PyInstance::typeObj(obj.type())
-            );
+            if (!groupNameKnown) {
+                std::string name = getNameForPyObj(
+                    obj.pyobj() ? obj.pyobj() : (PyObject*)PyInstance::typeObj(obj.type())
+                );
 
-            if (name.size()) {
-                // field '5' indicates that this is a mutually recursive type group
-                // identified by the name of an object within it. We can skip writing
-                // the rest of the group since the other side will have the same
-                // representation.
-                b.writeStringObject(5, name);
-                b.writeEndCompound();
-                return;
+                if (name.size()) {
+                    if (mNameCache) {
+                        mNameCache->recordGroupName(group, name);
+                    }
+
+                    // field '5' indicates that this is a mutually recursive type group
+                    // identified by the name of an object within it. We can skip writing
+                    // the rest of the group since the other side will have the same
+                    // representation.
+                    b.writeStringObject(5, name);
+                    b.writeEndCompound();
+                    return;
+                }
             }
 
             // see if this object is represented by a perfect factory
@@ -474,6 +494,10 @@ void PythonSerializationContext::serializeMutuallyRecursiveTypeGroup(MutuallyRec
             }
         }
 
+        if (mNameCache && !groupNameKnown) {
+            mNameCache->recordGroupName(group, "");
+        }
+
         std::map<int32_t, PyObjectHolder> indicesWrittenAsObjectAndRep;
         std::set<int32_t> indicesWrittenAsExternalObjectAndDict;
         std::set<int32_t> indicesWrittenAsInternalObjectAndDict;
@@ -114,8 +114,8 @@ public:
         m_base->visitMROConcrete(v);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
-        return m_base->deepBytecount(instance, alreadyVisited, outSlabs);
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
+        return m_base->deepBytecount(instance, context, outSlabs);
     }
 
     template<class buf_t>
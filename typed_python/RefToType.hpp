@@ -102,7 +102,7 @@ public:
         copy_constructor(dest, src);
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         // we don't walk into refs just like we don't walk into pointers
         return 0;
     }
@@ -0,0 +1,127 @@
+/******************************************************************************
+   Copyright 2017-2020 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// if true, the program has promised never to share typed_python objects between
+// threads that run concurrently, so refcounts don't need atomic read-modify-write
+// instructions. Set once, from TP_THREAD_CONFINED_REFCOUNTS, when _types is imported,
+// and never changed afterwards. Compiled code reads the same setting (through
+// _types.refcountsAreThreadConfined) so both sides agree on how to touch a refcount.
+extern bool refcounts_are_thread_confined;
+
+// 'freeze' sets the refcount of every layout in a graph to this. Increments and
+// decrements leave a refcount at or above IMMORTAL_REFCOUNT_THRESHOLD alone, so
+// readers of frozen data never write to it and it's never destroyed. The gap
+// between the two means a racing update can't bring a frozen refcount back down.
+// Compiled code reads these through _types.immortalRefcount().
+static const int64_t IMMORTAL_REFCOUNT = (int64_t)1 << 62;
+static const int64_t IMMORTAL_REFCOUNT_THRESHOLD = (int64_t)1 << 61;
+
+/*****
+The refcount at the front of every refcounted layout.
+
+This has the same size and layout as a std::atomic<int64_t>, which is what compiled
+code sees. Normally every update is an atomic read-modify-write. In thread-confined
+mode an update is a relaxed load followed by a relaxed store, which compiles to
+plain moves instead of a locked instruction.
+*****/
+class Refcount {
+public:
+    Refcount() : mValue(0)
+    {
+    }
+
+    Refcount(int64_t value) : mValue(value)
+    {
+    }
+
+    Refcount(const Refcount&) = delete;
+    Refcount& operator=(const Refcount&) = delete;
+
+    Refcount& operator=(int64_t value) {
+        mValue.store(value);
+        return *this;
+    }
+
+    operator int64_t() const {
+        return mValue.load();
+    }
+
+    int64_t load() const {
+        return mValue.load();
+    }
+
+    // add 'delta', returning the value we had before. Does nothing if we're immortal.
+    int64_t fetch_add(int64_t delta) {
+        int64_t old = mValue.load(std::memory_order_relaxed);
+
+        if (old >= IMMORTAL_REFCOUNT_THRESHOLD) {
+            return old;
+        }
+
+        if (refcounts_are_thread_confined) {
+            mValue.store(old + delta, std::memory_order_relaxed);
+            return old;
+        }
+
+        return mValue.fetch_add(delta);
+    }
+
+    bool isImmortal() const {
+        return mValue.load(std::memory_order_relaxed) >= IMMORTAL_REFCOUNT_THRESHOLD;
+    }
+
+    void makeImmortal() {
+        mValue.store(IMMORTAL_REFCOUNT);
+    }
+
+    int64_t fetch_sub(int64_t delta) {
+        return fetch_add(-delta);
+    }
+
+    int64_t operator++() {
+        return fetch_add(1) + 1;
+    }
+
+    int64_t operator--() {
+        return fetch_add(-1) - 1;
+    }
+
+    int64_t operator++(int) {
+        return fetch_add(1);
+    }
+
+    int64_t operator--(int) {
+        return fetch_add(-1);
+    }
+
+    int64_t operator+=(int64_t delta) {
+        return fetch_add(delta) + delta;
+    }
+
+    int64_t operator-=(int64_t delta) {
+        return fetch_add(-delta) - delta;
+    }
+
+private:
+    std::atomic<int64_t> mValue;
+};
+
+static_assert(sizeof(Refcount) == sizeof(int64_t), "Refcount must be layout-compatible with an int64");
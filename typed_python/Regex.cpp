@@ -0,0 +1,1429 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "Regex.hpp"
+#include "UnicodeProps.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_set>
+
+namespace Regex {
+
+// the most instructions a program may have, so that something like
+// '(a{1000}){1000}' fails to compile instead of eating all our memory
+const size_t MAX_PROGRAM_SIZE = 1 << 20;
+
+const int64_t MAX_REPEAT = 65535;
+
+const int64_t SUPPORTED_FLAGS = FLAG_IGNORECASE | FLAG_MULTILINE | FLAG_DOTALL | FLAG_VERBOSE | FLAG_ASCII | 32;
+
+enum Op : uint8_t {
+    OP_CHAR,                // the codepoint 'arg'
+    OP_CHAR_FOLD,           // a codepoint whose lowercase is 'arg'
+    OP_ANY,
+    OP_ANY_BUT_NEWLINE,
+    OP_CLASS,               // a codepoint in the program's classes[arg]
+    OP_SPLIT,               // continue at 'x' and, with lower priority, at 'y'
+    OP_JMP,                 // continue at 'x'
+    OP_LOOP,                // continue at 'x', unless we were already there at this
+                            // position (the loop body matched nothing), and then at 'y'
+    OP_SAVE,                // record the position in capture slot 'arg'
+    OP_ASSERT,              // continue only if the Assertion 'arg' holds here
+    OP_MATCH
+};
+
+enum Assertion : uint32_t {
+    AT_BEGINNING,               // \A, or '^'
+    AT_END,                     // \Z
+    AT_END_OR_FINAL_NEWLINE,    // '$'
+    AT_BEGINNING_OF_LINE,       // '^' with MULTILINE
+    AT_END_OF_LINE,             // '$' with MULTILINE
+    AT_WORD_BOUNDARY,
+    AT_NOT_WORD_BOUNDARY
+};
+
+struct Inst {
+    Op op;
+    uint32_t arg;
+    int32_t x;
+    int32_t y;
+};
+
+Inst inst(Op op, uint32_t arg = 0, int32_t x = 0, int32_t y = 0) {
+    Inst res;
+    res.op = op;
+    res.arg = arg;
+    res.x = x;
+    res.y = y;
+    return res;
+}
+
+// a run of instructions whose jumps are relative to its own start
+typedef std::vector<Inst> Fragment;
+
+void append(Fragment& out, const Fragment& f) {
+    if (out.size() + f.size() > MAX_PROGRAM_SIZE) {
+        throw std::runtime_error("pattern is too large");
+    }
+
+    int32_t base = out.size();
+
+    for (Inst i: f) {
+        if (i.op == OP_SPLIT || i.op == OP_JMP || i.op == OP_LOOP) {
+            i.x += base;
+            i.y += base;
+        }
+        out.push_back(i);
+    }
+}
+
+bool isWord(uint32_t c, bool ascii) {
+    if (ascii) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    return c == '_' || (unicodeProps(c) & (Uprops_ALPHA | Uprops_DECIMAL | Uprops_DIGIT | Uprops_NUMERIC));
+}
+
+bool isDigit(uint32_t c, bool ascii) {
+    if (ascii) {
+        return c >= '0' && c <= '9';
+    }
+
+    return unicodeProps(c) & Uprops_DECIMAL;
+}
+
+bool isSpace(uint32_t c, bool ascii) {
+    if (ascii) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    return unicodeProps(c) & Uprops_SPACE;
+}
+
+uint32_t lower(uint32_t c, bool ascii) {
+    if (ascii || c < 128) {
+        return c >= 'A' && c <= 'Z' ? c + 32 : c;
+    }
+
+    return Py_UNICODE_TOLOWER(c);
+}
+
+uint32_t upper(uint32_t c, bool ascii) {
+    if (ascii || c < 128) {
+        return c >= 'a' && c <= 'z' ? c - 32 : c;
+    }
+
+    return Py_UNICODE_TOUPPER(c);
+}
+
+enum Category {
+    CAT_DIGIT = 1,
+    CAT_NOT_DIGIT = 2,
+    CAT_WORD = 4,
+    CAT_NOT_WORD = 8,
+    CAT_SPACE = 16,
+    CAT_NOT_SPACE = 32
+};
+
+class CharClass {
+public:
+    CharClass(bool inAscii, bool inIgnoreCase) :
+        negated(false),
+        categories(0),
+        ascii(inAscii),
+        ignoreCase(inIgnoreCase)
+    {
+    }
+
+    // call once all the ranges and categories are in
+    void finish() {
+        for (uint32_t c = 0; c < 256; c++) {
+            mLow[c] = matchesSlowly(c);
+        }
+    }
+
+    bool matches(uint32_t c) const {
+        return c < 256 ? mLow[c] : matchesSlowly(c);
+    }
+
+    bool negated;
+    std::vector<std::pair<uint32_t, uint32_t> > ranges;
+    int categories;
+    bool ascii;
+    bool ignoreCase;
+
+private:
+    bool matchesSlowly(uint32_t c) const {
+        bool res = contains(c) || (ignoreCase && (contains(lower(c, ascii)) || contains(upper(c, ascii))));
+
+        return res != negated;
+    }
+
+    bool contains(uint32_t c) const {
+        for (auto& r: ranges) {
+            if (c >= r.first && c <= r.second) {
+                return true;
+            }
+        }
+
+        return ((categories & CAT_DIGIT) && isDigit(c, ascii))
+            || ((categories & CAT_NOT_DIGIT) && !isDigit(c, ascii))
+            || ((categories & CAT_WORD) && isWord(c, ascii))
+            || ((categories & CAT_NOT_WORD) && !isWord(c, ascii))
+            || ((categories & CAT_SPACE) && isSpace(c, ascii))
+            || ((categories & CAT_NOT_SPACE) && !isSpace(c, ascii));
+    }
+
+    std::bitset<256> mLow;
+};
+
+void appendUtf8(std::string& out, uint32_t c) {
+    if (c < 0x80) {
+        out += (char)c;
+    } else if (c < 0x800) {
+        out += (char)(0xC0 | (c >> 6));
+        out += (char)(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += (char)(0xE0 | (c >> 12));
+        out += (char)(0x80 | ((c >> 6) & 0x3F));
+        out += (char)(0x80 | (c & 0x3F));
+    } else {
+        out += (char)(0xF0 | (c >> 18));
+        out += (char)(0x80 | ((c >> 12) & 0x3F));
+        out += (char)(0x80 | ((c >> 6) & 0x3F));
+        out += (char)(0x80 | (c & 0x3F));
+    }
+}
+
+class Program {
+public:
+    std::vector<Inst> insts;
+    std::vector<CharClass> classes;
+    bool isBytes;
+    bool ascii;
+    int64_t groupCount;
+    std::map<std::string, int64_t> groupIndex;
+
+    // whether a match must start at the beginning of the string
+    bool anchored;
+
+    // if 'hasFirstChars', a match can only start with a codepoint c for
+    // which firstChars[c] (if c < 256) or 'firstCharsIncludeHigh' (if not).
+    // If that's exactly one codepoint, it's 'firstChar', and otherwise -1.
+    bool hasFirstChars;
+    std::bitset<256> firstChars;
+    bool firstCharsIncludeHigh;
+    int32_t firstChar;
+
+    void computeFirstChars() {
+        hasFirstChars = false;
+
+        std::vector<bool> seen(insts.size());
+        std::vector<int32_t> stack(1, 0);
+
+        std::bitset<256> chars;
+        bool high = false;
+
+        while (stack.size()) {
+            int32_t pc = stack.back();
+            stack.pop_back();
+
+            if (seen[pc]) {
+                continue;
+            }
+            seen[pc] = true;
+
+            const Inst& i = insts[pc];
+
+            switch (i.op) {
+                case OP_JMP:
+                    stack.push_back(i.x);
+                    break;
+                case OP_SPLIT:
+                case OP_LOOP:
+                    stack.push_back(i.x);
+                    stack.push_back(i.y);
+                    break;
+                case OP_SAVE:
+                case OP_ASSERT:
+                    stack.push_back(pc + 1);
+                    break;
+                case OP_CHAR:
+                    if (i.arg < 256) {
+                        chars[i.arg] = true;
+                    } else {
+                        high = true;
+                    }
+                    break;
+                case OP_CHAR_FOLD:
+                    for (uint32_t c = 0; c < 256; c++) {
+                        if (lower(c, ascii) == i.arg) {
+                            chars[c] = true;
+                        }
+                    }
+                    high = high || !ascii;
+                    break;
+                case OP_CLASS:
+                    for (uint32_t c = 0; c < 256; c++) {
+                        if (classes[i.arg].matches(c)) {
+                            chars[c] = true;
+                        }
+                    }
+                    high = high || !isBytes;
+                    break;
+                default:
+                    // OP_ANY and OP_MATCH: anything goes
+                    return;
+            }
+        }
+
+        if (chars.all()) {
+            return;
+        }
+
+        hasFirstChars = true;
+        firstChars = chars;
+        firstCharsIncludeHigh = high && !isBytes;
+        firstChar = -1;
+
+        if (chars.count() == 1 && !firstCharsIncludeHigh) {
+            for (int32_t c = 0; c < 256; c++) {
+                if (chars[c]) {
+                    firstChar = c;
+                }
+            }
+        }
+    }
+};
+
+namespace {
+
+class Parser {
+public:
+    Parser(const std::vector<uint32_t>& pattern, int64_t flags, Program& program) :
+        mPattern(pattern),
+        mPos(0),
+        mFlags(flags),
+        mProgram(program)
+    {
+    }
+
+    Fragment parse() {
+        // global flags have to come first, since they change how we parse the rest
+        while (parseGlobalFlags()) {
+        }
+
+        mProgram.ascii = mProgram.isBytes || (mFlags & FLAG_ASCII);
+
+        Fragment res = parseAlternation();
+
+        if (!atEnd()) {
+            // the only way to stop early is an unbalanced ')'
+            error("unbalanced parenthesis");
+        }
+
+        return res;
+    }
+
+private:
+    [[noreturn]] void error(const std::string& message) {
+        throw std::runtime_error(message + " at position " + std::to_string(mPos));
+    }
+
+    bool ignoreCase() const {
+        return mFlags & FLAG_IGNORECASE;
+    }
+
+    void skipVerbose() {
+        if (!(mFlags & FLAG_VERBOSE)) {
+            return;
+        }
+
+        while (mPos < mPattern.size()) {
+            uint32_t c = mPattern[mPos];
+
+            if (c == ' ' || (c >= '\t' && c <= '\r')) {
+                mPos++;
+            } else if (c == '#') {
+                while (mPos < mPattern.size() && mPattern[mPos] != '\n') {
+                    mPos++;
+                }
+            } else {
+                return;
+            }
+        }
+    }
+
+    bool atEnd() {
+        skipVerbose();
+        return mPos >= mPattern.size();
+    }
+
+    // the next codepoint, which must exist
+    uint32_t next() {
+        if (mPos >= mPattern.size()) {
+            error("unexpected end of pattern");
+        }
+        return mPattern[mPos++];
+    }
+
+    bool lookingAt(uint32_t c) const {
+        return mPos < mPattern.size() && mPattern[mPos] == c;
+    }
+
+    // consume flag letters at mPos into 'flags', returning false (and
+    // consuming nothing) if there aren't any
+    bool parseFlagLetters(int64_t& flags) {
+        size_t start = mPos;
+
+        while (mPos < mPattern.size()) {
+            uint32_t c = mPattern[mPos];
+
+            if (c == 'i') {
+                flags |= FLAG_IGNORECASE;
+            } else if (c == 'm') {
+                flags |= FLAG_MULTILINE;
+            } else if (c == 's') {
+                flags |= FLAG_DOTALL;
+            } else if (c == 'x') {
+                flags |= FLAG_VERBOSE;
+            } else if (c == 'a') {
+                flags |= FLAG_ASCII;
+            } else if (c == 'u') {
+                if (mProgram.isBytes) {
+                    error("bad inline flags: cannot use 'u' flag with a bytes pattern");
+                }
+            } else if (c == 'L') {
+                error("the 'L' flag isn't supported");
+            } else {
+                break;
+            }
+
+            mPos++;
+        }
+
+        return mPos > start;
+    }
+
+    // parse a '(?flags)' group at mPos, if there is one
+    bool parseGlobalFlags() {
+        if (!(lookingAt('(') && mPos + 1 < mPattern.size() && mPattern[mPos + 1] == '?')) {
+            return false;
+        }
+
+        size_t start = mPos;
+        int64_t flags = mFlags;
+
+        mPos += 2;
+
+        if (parseFlagLetters(flags) && lookingAt(')')) {
+            mPos++;
+            mFlags = flags;
+            return true;
+        }
+
+        mPos = start;
+        return false;
+    }
+
+    Fragment parseAlternation() {
+        std::vector<Fragment> alternatives;
+
+        alternatives.push_back(parseConcatenation());
+
+        while (!atEnd() && lookingAt('|')) {
+            mPos++;
+            alternatives.push_back(parseConcatenation());
+        }
+
+        // a|b|c is a|(b|c)
+        Fragment res = alternatives.back();
+
+        for (long k = (long)alternatives.size() - 2; k >= 0; k--) {
+            const Fragment& a = alternatives[k];
+
+            Fragment both;
+            both.push_back(inst(OP_SPLIT, 0, 1, a.size() + 2));
+            append(both, a);
+            both.push_back(inst(OP_JMP, 0, a.size() + 2 + res.size()));
+            append(both, res);
+
+            res.swap(both);
+        }
+
+        return res;
+    }
+
+    Fragment parseConcatenation() {
+        Fragment res;
+
+        while (!atEnd() && !lookingAt('|') && !lookingAt(')')) {
+            append(res, parseRepeat());
+        }
+
+        return res;
+    }
+
+    Fragment parseRepeat() {
+        bool repeatable = true;
+
+        Fragment atom = parseAtom(repeatable);
+
+        int64_t min, max;
+
+        if (atEnd() || !parseQuantifier(min, max)) {
+            return atom;
+        }
+
+        if (!repeatable) {
+            error("nothing to repeat");
+        }
+
+        bool greedy = true;
+
+        if (lookingAt('?')) {
+            greedy = false;
+            mPos++;
+        } else if (lookingAt('+')) {
+            error("possessive quantifiers aren't supported");
+        }
+
+        size_t afterQuantifier = mPos;
+        int64_t ignoredMin, ignoredMax;
+
+        if (!atEnd() && parseQuantifier(ignoredMin, ignoredMax)) {
+            error("multiple repeat");
+        }
+
+        mPos = afterQuantifier;
+
+        return repeat(atom, min, max, greedy);
+    }
+
+    // parse '*', '+', '?' or '{m,n}' at mPos, with -1 for an unbounded max.
+    // Returns false, consuming nothing, if there isn't a quantifier here.
+    bool parseQuantifier(int64_t& min, int64_t& max) {
+        uint32_t c = mPattern[mPos];
+
+        if (c == '*' || c == '+' || c == '?') {
+            mPos++;
+            min = c == '+' ? 1 : 0;
+            max = c == '?' ? 1 : -1;
+            return true;
+        }
+
+        if (c != '{') {
+            return false;
+        }
+
+        // a '{' that doesn't start a well-formed quantifier is a literal
+        size_t start = mPos++;
+
+        int64_t lo = parseDecimal();
+        int64_t hi = lo;
+
+        if (lookingAt(',')) {
+            mPos++;
+            hi = parseDecimal();
+        } else if (lo == -1) {
+            mPos = start;
+            return false;
+        }
+
+        if (!lookingAt('}')) {
+            mPos = start;
+            return false;
+        }
+
+        mPos++;
+
+        min = lo == -1 ? 0 : lo;
+        max = hi;
+
+        if (min > MAX_REPEAT || max > MAX_REPEAT) {
+            error("the repetition number is too large");
+        }
+
+        if (max != -1 && max < min) {
+            error("min repeat greater than max repeat");
+        }
+
+        return true;
+    }
+
+    // parse a run of decimal digits, or return -1 if there aren't any
+    int64_t parseDecimal() {
+        int64_t res = -1;
+
+        while (mPos < mPattern.size() && mPattern[mPos] >= '0' && mPattern[mPos] <= '9') {
+            res = std::min<int64_t>((res == -1 ? 0 : res) * 10 + (mPattern[mPos] - '0'), MAX_REPEAT + 1);
+            mPos++;
+        }
+
+        return res;
+    }
+
+    Fragment repeat(const Fragment& atom, int64_t min, int64_t max, bool greedy) {
+        int64_t n = atom.size();
+
+        if ((n + 1) * (max == -1 ? min + 1 : max) > (int64_t)MAX_PROGRAM_SIZE) {
+            error("pattern is too large");
+        }
+
+        Fragment res;
+
+        for (int64_t k = 0; k < min; k++) {
+            append(res, atom);
+        }
+
+        if (max == -1) {
+            // L: SPLIT body, out; body; LOOP L, out. Like python, we let the
+            // body match nothing once, so that '(a*)*' captures the empty string.
+            Fragment loop;
+            loop.push_back(greedy ? inst(OP_SPLIT, 0, 1, n + 2) : inst(OP_SPLIT, 0, n + 2, 1));
+            append(loop, atom);
+            loop.push_back(inst(OP_LOOP, 0, 0, n + 2));
+
+            append(res, loop);
+        } else {
+            // (atom(atom(...)?)?)?, where every SPLIT can skip straight to the end
+            int32_t total = (max - min) * (n + 1);
+
+            Fragment optional;
+
+            for (int64_t k = min; k < max; k++) {
+                int32_t here = optional.size();
+
+                optional.push_back(greedy ? inst(OP_SPLIT, 0, here + 1, total) : inst(OP_SPLIT, 0, total, here + 1));
+                append(optional, atom);
+            }
+
+            append(res, optional);
+        }
+
+        return res;
+    }
+
+    Fragment parseAtom(bool& repeatable) {
+        uint32_t c = next();
+
+        switch (c) {
+            case '(':
+                return parseGroup(repeatable);
+            case '[':
+                return parseClass();
+            case '.':
+                return Fragment(1, inst((mFlags & FLAG_DOTALL) ? OP_ANY : OP_ANY_BUT_NEWLINE));
+            case '^':
+                repeatable = false;
+                return Fragment(1, inst(OP_ASSERT, (mFlags & FLAG_MULTILINE) ? AT_BEGINNING_OF_LINE : AT_BEGINNING));
+            case '$':
+                repeatable = false;
+                return Fragment(1, inst(OP_ASSERT, (mFlags & FLAG_MULTILINE) ? AT_END_OF_LINE : AT_END_OR_FINAL_NEWLINE));
+            case '\\':
+                return parseEscape(repeatable);
+            case '*':
+            case '+':
+            case '?':
+                mPos--;
+                error("nothing to repeat");
+            case '{': {
+                int64_t min, max;
+                mPos--;
+                if (parseQuantifier(min, max)) {
+                    error("nothing to repeat");
+                }
+                mPos++;
+                return literal(c);
+            }
+            default:
+                return literal(c);
+        }
+    }
+
+    Fragment literal(uint32_t c) {
+        bool ascii = mProgram.ascii;
+
+        if (ignoreCase() && (lower(c, ascii) != c || upper(c, ascii) != c)) {
+            return Fragment(1, inst(OP_CHAR_FOLD, lower(c, ascii)));
+        }
+
+        return Fragment(1, inst(OP_CHAR, c));
+    }
+
+    Fragment category(int categories) {
+        CharClass cls(mProgram.ascii, false);
+        cls.categories = categories;
+
+        return addClass(cls);
+    }
+
+    Fragment addClass(CharClass& cls) {
+        cls.finish();
+        mProgram.classes.push_back(cls);
+
+        return Fragment(1, inst(OP_CLASS, mProgram.classes.size() - 1));
+    }
+
+    Fragment parseGroup(bool& repeatable) {
+        Fragment res;
+
+        if (!lookingAt('?')) {
+            int64_t group = ++mProgram.groupCount;
+
+            res.push_back(inst(OP_SAVE, group * 2));
+            append(res, parseAlternation());
+            res.push_back(inst(OP_SAVE, group * 2 + 1));
+        } else {
+            mPos++;
+
+            uint32_t c = next();
+
+            if (c == ':') {
+                res = parseAlternation();
+            } else if (c == 'P' && lookingAt('<')) {
+                mPos++;
+
+                std::string name = parseGroupName();
+                int64_t group = ++mProgram.groupCount;
+
+                if (mProgram.groupIndex.find(name) != mProgram.groupIndex.end()) {
+                    error("redefinition of group name '" + name + "'");
+                }
+
+                mProgram.groupIndex[name] = group;
+
+                res.push_back(inst(OP_SAVE, group * 2));
+                append(res, parseAlternation());
+                res.push_back(inst(OP_SAVE, group * 2 + 1));
+            } else if (c == 'P' && lookingAt('=')) {
+                error("backreferences aren't supported");
+            } else if (c == '=' || c == '!' || (c == '<' && (lookingAt('=') || lookingAt('!')))) {
+                error("lookaround assertions aren't supported");
+            } else if (c == '(') {
+                error("conditional groups aren't supported");
+            } else if (c == '>') {
+                error("atomic groups aren't supported");
+            } else if (c == '#') {
+                while (!lookingAt(')')) {
+                    if (mPos >= mPattern.size()) {
+                        error("missing ), unterminated comment");
+                    }
+                    mPos++;
+                }
+                repeatable = false;
+            } else {
+                // scoped flags, as in '(?i:...)' or '(?-i:...)'
+                mPos--;
+
+                int64_t flags = mFlags;
+                int64_t removed = 0;
+
+                parseFlagLetters(flags);
+
+                if (lookingAt('-')) {
+                    mPos++;
+                    if (!parseFlagLetters(removed)) {
+                        error("missing flag");
+                    }
+                }
+
+                if (lookingAt(')')) {
+                    error("global flags not at the start of the expression");
+                }
+
+                if (!lookingAt(':')) {
+                    error("unknown extension ?" + std::string(1, (char)std::min<uint32_t>(c, 127)));
+                }
+
+                if ((flags & FLAG_ASCII) != (mFlags & FLAG_ASCII) || (removed & (FLAG_ASCII | FLAG_VERBOSE))) {
+                    error("the 'a' and 'x' flags can only be set for the whole pattern");
+                }
+
+                mPos++;
+
+                int64_t outerFlags = mFlags;
+                mFlags = flags & ~removed;
+                res = parseAlternation();
+                mFlags = outerFlags;
+            }
+        }
+
+        if (!lookingAt(')')) {
+            error("missing ), unterminated subpattern");
+        }
+
+        mPos++;
+
+        return res;
+    }
+
+    std::string parseGroupName() {
+        std::string name;
+
+        while (!lookingAt('>')) {
+            uint32_t c = next();
+
+            bool ok = c == '_' || (c < 128 ? isWord(c, true) && !(name.empty() && c >= '0' && c <= '9') : !mProgram.isBytes);
+
+            if (!ok) {
+                error("bad character in group name");
+            }
+
+            appendUtf8(name, c);
+        }
+
+        mPos++;
+
+        if (name.empty()) {
+            error("missing group name");
+        }
+
+        return name;
+    }
+
+    Fragment parseEscape(bool& repeatable) {
+        uint32_t c = next();
+
+        switch (c) {
+            case 'A':
+                repeatable = false;
+                return Fragment(1, inst(OP_ASSERT, AT_BEGINNING));
+            case 'Z':
+                repeatable = false;
+                return Fragment(1, inst(OP_ASSERT, AT_END));
+            case 'b':
+                repeatable = false;
+                return Fragment(1, inst(OP_ASSERT, AT_WORD_BOUNDARY));
+            case 'B':
+                repeatable = false;
+                return Fragment(1, inst(OP_ASSERT, AT_NOT_WORD_BOUNDARY));
+            case 'd': return category(CAT_DIGIT);
+            case 'D': return category(CAT_NOT_DIGIT);
+            case 'w': return category(CAT_WORD);
+            case 'W': return category(CAT_NOT_WORD);
+            case 's': return category(CAT_SPACE);
+            case 'S': return category(CAT_NOT_SPACE);
+            default:
+                return literal(parseEscapedChar(c, false));
+        }
+    }
+
+    // the codepoint named by the escape '\c...', whose 'c' we've consumed
+    uint32_t parseEscapedChar(uint32_t c, bool inClass) {
+        switch (c) {
+            case 'n': return '\n';
+            case 't': return '\t';
+            case 'r': return '\r';
+            case 'f': return '\f';
+            case 'v': return '\v';
+            case 'a': return '\a';
+            case 'x': return parseHex(2);
+            case 'u':
+            case 'U':
+                if (mProgram.isBytes) {
+                    break;
+                }
+                return parseHex(c == 'u' ? 4 : 8);
+            case 'N':
+                error("named unicode escapes aren't supported");
+        }
+
+        if (c >= '0' && c <= '7') {
+            // up to three octal digits. Outside a class, only '\0' or
+            // three digits are octal, and anything else is a backreference
+            uint32_t value = c - '0';
+            int digits = 1;
+
+            while (digits < 3 && mPos < mPattern.size() && mPattern[mPos] >= '0' && mPattern[mPos] <= '7') {
+                value = value * 8 + (mPattern[mPos++] - '0');
+                digits++;
+            }
+
+            if (!inClass && c != '0' && digits < 3) {
+                error("backreferences aren't supported");
+            }
+
+            if (value > 0377) {
+                error("octal escape value outside of range 0-0o377");
+            }
+
+            return value;
+        }
+
+        if (c == '8' || c == '9') {
+            if (!inClass) {
+                error("backreferences aren't supported");
+            }
+        } else if (c >= 128 || !isWord(c, true)) {
+            return c;
+        }
+
+        mPos--;
+        error("bad escape \\" + std::string(1, (char)c));
+    }
+
+    uint32_t parseHex(int digits) {
+        uint32_t value = 0;
+
+        for (int k = 0; k < digits; k++) {
+            uint32_t c = mPos < mPattern.size() ? mPattern[mPos] : 0;
+
+            if (c >= '0' && c <= '9') {
+                value = value * 16 + (c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value = value * 16 + (c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value = value * 16 + (c - 'A' + 10);
+            } else {
+                error("incomplete escape");
+            }
+
+            mPos++;
+        }
+
+        if (value > 0x10FFFF) {
+            error("bad escape: codepoint out of range");
+        }
+
+        return value;
+    }
+
+    Fragment parseClass() {
+        CharClass cls(mProgram.ascii, ignoreCase());
+
+        if (lookingAt('^')) {
+            cls.negated = true;
+            mPos++;
+        }
+
+        bool first = true;
+
+        while (true) {
+            if (mPos >= mPattern.size()) {
+                error("unterminated character set");
+            }
+
+            if (lookingAt(']') && !first) {
+                mPos++;
+                break;
+            }
+
+            first = false;
+
+            uint32_t lo;
+
+            if (!parseClassItem(cls, lo)) {
+                continue;
+            }
+
+            if (lookingAt('-') && mPos + 1 < mPattern.size() && mPattern[mPos + 1] != ']') {
+                mPos++;
+
+                uint32_t hi;
+
+                if (!parseClassItem(cls, hi) || hi < lo) {
+                    error("bad character range");
+                }
+
+                cls.ranges.push_back(std::make_pair(lo, hi));
+            } else {
+                cls.ranges.push_back(std::make_pair(lo, lo));
+            }
+        }
+
+        return addClass(cls);
+    }
+
+    // parse one codepoint of a class into 'out', or add a category to 'cls'
+    // and return false
+    bool parseClassItem(CharClass& cls, uint32_t& out) {
+        uint32_t c = next();
+
+        if (c != '\\') {
+            out = c;
+            return true;
+        }
+
+        c = next();
+
+        switch (c) {
+            case 'd': cls.categories |= CAT_DIGIT; return false;
+            case 'D': cls.categories |= CAT_NOT_DIGIT; return false;
+            case 'w': cls.categories |= CAT_WORD; return false;
+            case 'W': cls.categories |= CAT_NOT_WORD; return false;
+            case 's': cls.categories |= CAT_SPACE; return false;
+            case 'S': cls.categories |= CAT_NOT_SPACE; return false;
+            case 'b': out = '\b'; return true;
+        }
+
+        out = parseEscapedChar(c, true);
+        return true;
+    }
+
+    const std::vector<uint32_t>& mPattern;
+    size_t mPos;
+    int64_t mFlags;
+    Program& mProgram;
+};
+
+struct StackEntry {
+    int32_t pc;
+
+    // if >= 0, restore capture 'slot' to 'value' rather than visiting 'pc'
+    int32_t slot;
+    int64_t value;
+};
+
+// per-thread memory for the matcher, so that matching doesn't allocate
+struct Scratch {
+    Scratch() : generation(0) {
+        counts[0] = counts[1] = 0;
+    }
+
+    // two lists of matcher threads: the pc and captures of each
+    std::vector<int32_t> pcs[2];
+    std::vector<int64_t> caps[2];
+    size_t counts[2];
+
+    // marks[pc] == generation if pc is already on the list we're building
+    std::vector<uint64_t> marks;
+    uint64_t generation;
+
+    // the captures of the thread we're following through epsilon moves
+    std::vector<int64_t> threadCaps;
+
+    std::vector<StackEntry> stack;
+};
+
+thread_local Scratch scratch;
+
+template<class T>
+class Matcher {
+public:
+    Matcher(const Program& program, const T* data, int64_t end) :
+        mProgram(program),
+        mInsts(program.insts.data()),
+        mData(data),
+        mEnd(end),
+        mSlots(2 * (program.groupCount + 1)),
+        mScratch(scratch)
+    {
+        size_t n = program.insts.size();
+
+        for (long k = 0; k < 2; k++) {
+            if (mScratch.pcs[k].size() < n) {
+                mScratch.pcs[k].resize(n);
+            }
+            if (mScratch.caps[k].size() < n * mSlots) {
+                mScratch.caps[k].resize(n * mSlots);
+            }
+        }
+
+        if (mScratch.marks.size() < n) {
+            mScratch.marks.resize(n);
+        }
+
+        if (mScratch.threadCaps.size() < mSlots) {
+            mScratch.threadCaps.resize(mSlots);
+        }
+    }
+
+    bool run(int64_t pos, int64_t mode, int64_t* spans) {
+        int64_t start = pos;
+        bool mustAdvance = mode & MODE_MUST_ADVANCE;
+
+        mode &= ~MODE_MUST_ADVANCE;
+
+        if (mode == MODE_SEARCH && mProgram.anchored) {
+            mode = MODE_MATCH;
+        }
+
+        if (mode == MODE_SEARCH && mProgram.hasFirstChars && !skipToCandidate(pos)) {
+            return false;
+        }
+
+        int cur = 0;
+        bool matched = false;
+
+        mScratch.counts[cur] = 0;
+        mScratch.generation++;
+        startThread(cur, pos);
+
+        while (true) {
+            if (!mScratch.counts[cur]) {
+                if (matched || mode != MODE_SEARCH || pos >= mEnd) {
+                    break;
+                }
+
+                // nothing's live, so skip to where a match could start
+                pos++;
+
+                if (!skipToCandidate(pos)) {
+                    break;
+                }
+
+                mScratch.generation++;
+                startThread(cur, pos);
+                continue;
+            }
+
+            int next = 1 - cur;
+            mScratch.counts[next] = 0;
+            mScratch.generation++;
+
+            uint32_t c = pos < mEnd ? (uint32_t)mData[pos] : 0;
+
+            for (size_t i = 0; i < mScratch.counts[cur]; i++) {
+                int32_t pc = mScratch.pcs[cur][i];
+                const int64_t* caps = &mScratch.caps[cur][i * mSlots];
+                const Inst& inst = mInsts[pc];
+
+                bool advance = false;
+
+                if (inst.op == OP_MATCH) {
+                    if (mode == MODE_FULLMATCH && pos != mEnd) {
+                        continue;
+                    }
+
+                    if (mustAdvance && pos == start) {
+                        continue;
+                    }
+
+                    std::copy(caps, caps + mSlots, spans);
+                    matched = true;
+
+                    // the threads after this one have lower priority than this match
+                    break;
+                }
+
+                if (pos < mEnd) {
+                    switch (inst.op) {
+                        case OP_CHAR:
+                            advance = c == inst.arg;
+                            break;
+                        case OP_CHAR_FOLD:
+                            advance = lower(c, mProgram.ascii) == inst.arg;
+                            break;
+                        case OP_ANY:
+                            advance = true;
+                            break;
+                        case OP_ANY_BUT_NEWLINE:
+                            advance = c != '\n';
+                            break;
+                        case OP_CLASS:
+                            advance = mProgram.classes[inst.arg].matches(c);
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                if (advance) {
+                    std::copy(caps, caps + mSlots, mScratch.threadCaps.begin());
+                    addThread(next, pc + 1, pos + 1);
+                }
+            }
+
+            if (pos >= mEnd) {
+                break;
+            }
+
+            if (!matched && mode == MODE_SEARCH && canStartAt(pos + 1)) {
+                startThread(next, pos + 1);
+            }
+
+            cur = next;
+            pos++;
+        }
+
+        return matched;
+    }
+
+private:
+    bool isCandidate(uint32_t c) const {
+        if (!mProgram.hasFirstChars) {
+            return true;
+        }
+
+        return c < 256 ? mProgram.firstChars[c] : mProgram.firstCharsIncludeHigh;
+    }
+
+    bool canStartAt(int64_t pos) const {
+        if (!mProgram.hasFirstChars) {
+            return true;
+        }
+
+        return pos < mEnd && isCandidate(mData[pos]);
+    }
+
+    // move 'pos' forward to the next place a match could start, returning
+    // false if there isn't one
+    bool skipToCandidate(int64_t& pos) const {
+        if (!mProgram.hasFirstChars) {
+            return pos <= mEnd;
+        }
+
+        if (sizeof(T) == 1 && mProgram.firstChar >= 0) {
+            if (pos >= mEnd) {
+                return false;
+            }
+
+            const void* found = memchr(mData + pos, mProgram.firstChar, mEnd - pos);
+
+            if (!found) {
+                return false;
+            }
+
+            pos = (const T*)found - mData;
+            return true;
+        }
+
+        while (pos < mEnd && !isCandidate(mData[pos])) {
+            pos++;
+        }
+
+        // a program with first chars can't match the empty string
+        return pos < mEnd;
+    }
+
+    void startThread(int list, int64_t pos) {
+        std::fill(mScratch.threadCaps.begin(), mScratch.threadCaps.begin() + mSlots, -1);
+        addThread(list, 0, pos);
+    }
+
+    // follow the thread at 'pc' (with captures mScratch.threadCaps) through
+    // splits, jumps, saves and assertions, adding every instruction it can
+    // reach that consumes a codepoint (or matches) to 'list', highest priority
+    // first. Leaves threadCaps as it found it.
+    void addThread(int list, int32_t pc, int64_t pos) {
+        std::vector<StackEntry>& stack = mScratch.stack;
+        int64_t* caps = mScratch.threadCaps.data();
+
+        stack.clear();
+        stack.push_back(StackEntry{pc, -1, 0});
+
+        while (stack.size()) {
+            StackEntry e = stack.back();
+            stack.pop_back();
+
+            if (e.slot >= 0) {
+                caps[e.slot] = e.value;
+                continue;
+            }
+
+            const Inst& inst = mInsts[e.pc];
+
+            // a LOOP can be reached twice: once from the end of a body that
+            // consumed something, and once from one that didn't
+            if (inst.op != OP_LOOP) {
+                if (mScratch.marks[e.pc] == mScratch.generation) {
+                    continue;
+                }
+
+                mScratch.marks[e.pc] = mScratch.generation;
+            }
+
+            switch (inst.op) {
+                case OP_JMP:
+                    stack.push_back(StackEntry{inst.x, -1, 0});
+                    break;
+                case OP_LOOP:
+                    stack.push_back(StackEntry{mScratch.marks[inst.x] == mScratch.generation ? inst.y : inst.x, -1, 0});
+                    break;
+                case OP_SPLIT:
+                    stack.push_back(StackEntry{inst.y, -1, 0});
+                    stack.push_back(StackEntry{inst.x, -1, 0});
+                    break;
+                case OP_SAVE:
+                    // restore the old value once we're done with everything after this
+                    stack.push_back(StackEntry{-1, (int32_t)inst.arg, caps[inst.arg]});
+                    caps[inst.arg] = pos;
+                    stack.push_back(StackEntry{e.pc + 1, -1, 0});
+                    break;
+                case OP_ASSERT:
+                    if (holds((Assertion)inst.arg, pos)) {
+                        stack.push_back(StackEntry{e.pc + 1, -1, 0});
+                    }
+                    break;
+                default: {
+                    size_t k = mScratch.counts[list]++;
+                    mScratch.pcs[list][k] = e.pc;
+                    std::copy(caps, caps + mSlots, mScratch.caps[list].begin() + k * mSlots);
+                }
+            }
+        }
+    }
+
+    bool holds(Assertion a, int64_t pos) const {
+        switch (a) {
+            case AT_BEGINNING:
+                return pos == 0;
+            case AT_END:
+                return pos >= mEnd;
+            case AT_END_OR_FINAL_NEWLINE:
+                return pos >= mEnd || (pos == mEnd - 1 && mData[pos] == '\n');
+            case AT_BEGINNING_OF_LINE:
+                return pos == 0 || mData[pos - 1] == '\n';
+            case AT_END_OF_LINE:
+                return pos >= mEnd || mData[pos] == '\n';
+            case AT_WORD_BOUNDARY:
+            case AT_NOT_WORD_BOUNDARY: {
+                // python's \B doesn't match an empty string
+                if (mEnd == 0) {
+                    return false;
+                }
+
+                bool before = pos > 0 && isWord(mData[pos - 1], mProgram.ascii);
+                bool after = pos < mEnd && isWord(mData[pos], mProgram.ascii);
+
+                return (before != after) == (a == AT_WORD_BOUNDARY);
+            }
+        }
+
+        return false;
+    }
+
+    const Program& mProgram;
+    const Inst* mInsts;
+    const T* mData;
+    int64_t mEnd;
+    size_t mSlots;
+    Scratch& mScratch;
+};
+
+template<class T>
+bool searchData(const Program* program, const T* data, int64_t len, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans) {
+    pos = std::max<int64_t>(0, std::min(pos, len));
+    endpos = std::max<int64_t>(0, std::min(endpos, len));
+
+    // as in python, a pos past endpos can still match the empty string, but
+    // only for 'match'
+    if (pos > endpos && (mode & ~MODE_MUST_ADVANCE) != MODE_MATCH) {
+        return false;
+    }
+
+    return Matcher<T>(*program, data, endpos).run(pos, mode, spans);
+}
+
+std::mutex registryMutex;
+
+std::map<std::tuple<std::vector<uint32_t>, int64_t, bool>, Program*> programsByPattern;
+
+std::unordered_set<int64_t> programAddresses;
+
+} // end anonymous namespace
+
+const Program* compile(const std::vector<uint32_t>& pattern, int64_t flags, bool isBytes) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    auto key = std::make_tuple(pattern, flags, isBytes);
+
+    auto it = programsByPattern.find(key);
+
+    if (it != programsByPattern.end()) {
+        return it->second;
+    }
+
+    if (flags & ~SUPPORTED_FLAGS) {
+        throw std::runtime_error("unsupported regex flags");
+    }
+
+    if (isBytes && (flags & 32)) {
+        throw std::runtime_error("cannot use UNICODE flag with a bytes pattern");
+    }
+
+    std::unique_ptr<Program> program(new Program());
+    program->isBytes = isBytes;
+    program->groupCount = 0;
+
+    Fragment body = Parser(pattern, flags, *program).parse();
+
+    program->insts.push_back(inst(OP_SAVE, 0));
+    append(program->insts, body);
+    program->insts.push_back(inst(OP_SAVE, 1));
+    program->insts.push_back(inst(OP_MATCH));
+
+    size_t firstReal = 0;
+    while (program->insts[firstReal].op == OP_SAVE) {
+        firstReal++;
+    }
+
+    program->anchored = program->insts[firstReal].op == OP_ASSERT && program->insts[firstReal].arg == AT_BEGINNING;
+
+    program->computeFirstChars();
+
+    Program* res = program.release();
+
+    programsByPattern[key] = res;
+    programAddresses.insert((int64_t)res);
+
+    return res;
+}
+
+const Program* lookup(int64_t address) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    if (programAddresses.find(address) == programAddresses.end()) {
+        return nullptr;
+    }
+
+    return (const Program*)address;
+}
+
+bool isBytes(const Program* program) {
+    return program->isBytes;
+}
+
+int64_t groupCount(const Program* program) {
+    return program->groupCount;
+}
+
+const std::map<std::string, int64_t>& groupIndex(const Program* program) {
+    return program->groupIndex;
+}
+
+bool search(const Program* program, const StringType::layout* s, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans) {
+    if (!s) {
+        return searchData(program, (const uint8_t*)nullptr, 0, pos, endpos, mode, spans);
+    }
+
+    if (s->bytes_per_codepoint == 1) {
+        return searchData(program, (const uint8_t*)s->data, s->pointcount, pos, endpos, mode, spans);
+    }
+
+    if (s->bytes_per_codepoint == 2) {
+        return searchData(program, (const uint16_t*)s->data, s->pointcount, pos, endpos, mode, spans);
+    }
+
+    return searchData(program, (const uint32_t*)s->data, s->pointcount, pos, endpos, mode, spans);
+}
+
+bool search(const Program* program, const BytesType::layout* s, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans) {
+    if (!s) {
+        return searchData(program, (const uint8_t*)nullptr, 0, pos, endpos, mode, spans);
+    }
+
+    return searchData(program, (const uint8_t*)s->data, s->bytecount, pos, endpos, mode, spans);
+}
+
+} // end namespace Regex
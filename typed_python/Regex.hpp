@@ -0,0 +1,95 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "StringType.hpp"
+#include "BytesType.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+/*********
+A regular expression engine that runs directly on str (at each of its
+codepoint widths) and bytes, without the GIL.
+
+'compile' parses the subset of python's 're' syntax that doesn't need
+backtracking: literals, '.', character classes, the \d \w \s \b \A \Z
+escapes and their negations, '^' and '$', capturing, non-capturing and
+named groups, alternation, and greedy and lazy quantifiers, plus the
+i, m, s, a and x flags (given as 're' flag values, or inline). It turns
+the pattern into a small bytecode program. Backreferences, lookaround and
+conditionals raise, since they'd need a backtracking matcher.
+
+'search' runs a program with a Pike VM: it steps every live thread of the
+program over the input one codepoint at a time, so a match costs time
+linear in the length of the input, whatever the pattern. Threads are kept
+in priority order, so the match we find (including what each group
+captured) is the one python's backtracking engine would find. When the
+pattern can only start with a few particular characters, 'search' skips
+ahead to the next of them before starting any threads.
+
+Programs are never freed, and compiling the same pattern and flags twice
+returns the same program. Compiled code refers to a program by its address.
+*********/
+
+namespace Regex {
+
+// the same values as the flags in python's 're' module
+enum {
+    FLAG_IGNORECASE = 2,
+    FLAG_MULTILINE = 8,
+    FLAG_DOTALL = 16,
+    FLAG_VERBOSE = 64,
+    FLAG_ASCII = 256
+};
+
+enum Mode {
+    MODE_MATCH = 0,
+    MODE_SEARCH = 1,
+    MODE_FULLMATCH = 2,
+
+    // or'd into a mode to reject an empty match at 'pos'. findall and sub
+    // search again from the end of an empty match this way, as python does.
+    MODE_MUST_ADVANCE = 4
+};
+
+class Program;
+
+// compile 'pattern', a sequence of codepoints (or of bytes, if 'isBytes').
+// Throws std::runtime_error saying what's wrong if we can't.
+const Program* compile(const std::vector<uint32_t>& pattern, int64_t flags, bool isBytes);
+
+// the program at 'address', or nullptr if it isn't one 'compile' returned
+const Program* lookup(int64_t address);
+
+bool isBytes(const Program* program);
+
+// the number of capturing groups
+int64_t groupCount(const Program* program);
+
+// the index of each named group
+const std::map<std::string, int64_t>& groupIndex(const Program* program);
+
+// match 'program' against s[pos:endpos] the way re's match, search or fullmatch
+// would (according to 'mode'), clamping 'pos' and 'endpos' the same way. On a
+// match, writes the start and end of each group into 'spans', starting with
+// the whole match (so 2 * (groupCount + 1) values), with -1 for groups that
+// didn't participate, and returns true.
+bool search(const Program* program, const StringType::layout* s, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans);
+bool search(const Program* program, const BytesType::layout* s, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans);
+
+} // end namespace Regex
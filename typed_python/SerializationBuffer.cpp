@@ -16,6 +16,7 @@
 
 #include "SerializationBuffer.hpp"
 #include "lz4frame.h"
+#include <pthread.h>
 
 /* static */
 Bytes SerializationBuffer::serializeSingleBoolToBytes(bool value) {
@@ -34,6 +35,7 @@ void SerializationBufferBlock::compress() {
 
     lz4Prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
     lz4Prefs.frameInfo.blockChecksumFlag = LZ4F_blockChecksumEnabled;
+    lz4Prefs.compressionLevel = m_compression_level;
 
     //replace the data we have here with a block of 4 bytes of size of compressed data and
     //then the data stream
@@ -154,6 +156,11 @@ void SerializationBuffer::waitForCompression(std::shared_ptr<SerializationBuffer
         return;
     }
 
+    waitForCompressionThreads(block);
+}
+
+// static
+void SerializationBuffer::waitForCompressionThreads(std::shared_ptr<SerializationBufferBlock> block) {
     {
         std::unique_lock<std::mutex> lock(s_compress_thread_mutex);
 
@@ -171,6 +178,125 @@ void SerializationBuffer::waitForCompression(std::shared_ptr<SerializationBuffer
     }
 }
 
+void SerializationBuffer::appendBlocks(SerializationBuffer& other) {
+    for (auto block: other.m_blocks) {
+        if (!block->size()) {
+            continue;
+        }
+
+        std::shared_ptr<SerializationBufferBlock> previous = m_blocks.back();
+
+        // 'block' becomes our top block, so we carry on writing after it
+        m_top_block = block.get();
+
+        if (!previous->size()) {
+            m_blocks.back() = block;
+            continue;
+        }
+
+        // and we're done with 'previous', exactly as if it had filled up
+        if (m_sink) {
+            m_blocks.clear();
+        } else if (m_wants_compress) {
+            markForCompression(previous);
+        }
+
+        m_blocks.push_back(block);
+
+        if (m_sink) {
+            handOff(previous);
+        }
+    }
+
+    other.m_top_block = new SerializationBufferBlock(other.m_compression_level);
+    other.m_blocks.clear();
+    other.m_blocks.push_back(std::shared_ptr<SerializationBufferBlock>(other.m_top_block));
+}
+
+int64_t SerializationBuffer::threadsToSerialize(int64_t count, const std::vector<Type*>& itemTypes) {
+    // below this, starting the threads costs more than they save
+    static const int64_t MIN_ITEMS_PER_THREAD = 1024;
+
+    int64_t threadCount = std::min<int64_t>(m_context.serializeThreadCount(), count / MIN_ITEMS_PER_THREAD);
+
+    // the threads of a 'serializeInParallel' don't start threads of their own
+    if (threadCount < 2 || m_is_parallel_part) {
+        return 1;
+    }
+
+    // deeply immutable values never go through the memo (only ListOf, Dict,
+    // Set, Class and python objects do), and never need the interpreter.
+    for (auto t: itemTypes) {
+        if (!t->isDeeplyImmutable()) {
+            return 1;
+        }
+    }
+
+    return threadCount;
+}
+
+void SerializationBuffer::serializeInParallel(
+    int64_t threadCount,
+    int64_t count,
+    const std::function<void (SerializationBuffer&, int64_t, int64_t)>& serializeRange
+) {
+    // we go in rounds of at most this many items per thread, so that if we're
+    // streaming to a sink we don't hold the whole of a huge list at once.
+    static const int64_t MAX_ITEMS_PER_THREAD = 64 * 1024;
+
+    int64_t start = 0;
+
+    while (start < count) {
+        int64_t roundCount = std::min<int64_t>(count - start, threadCount * MAX_ITEMS_PER_THREAD);
+        int64_t roundThreads = std::min<int64_t>(threadCount, roundCount);
+
+        std::vector<std::shared_ptr<SerializationBuffer> > buffers;
+        std::vector<std::exception_ptr> errors(roundThreads);
+
+        for (int64_t t = 0; t < roundThreads; t++) {
+            buffers.push_back(std::make_shared<SerializationBuffer>(m_context));
+            buffers.back()->disableCompression();
+            buffers.back()->m_is_parallel_part = true;
+        }
+
+        {
+            PyEnsureGilReleased releaseTheGil;
+
+            std::vector<std::thread> threads;
+
+            for (int64_t t = 0; t < roundThreads; t++) {
+                threads.push_back(std::thread([&, t]() {
+                    try {
+                        serializeRange(
+                            *buffers[t],
+                            start + roundCount * t / roundThreads,
+                            start + roundCount * (t + 1) / roundThreads
+                        );
+                    } catch(...) {
+                        errors[t] = std::current_exception();
+                    }
+                }));
+            }
+
+            for (auto& thread: threads) {
+                thread.join();
+            }
+        }
+
+        for (auto& error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        for (auto& buffer: buffers) {
+            appendBlocks(*buffer);
+        }
+
+        start += roundCount;
+    }
+}
+
 void SerializationBuffer::markForCompression(std::shared_ptr<SerializationBufferBlock> block) {
     if (!m_compress_using_threads) {
         return;
@@ -194,6 +320,43 @@ void SerializationBuffer::markForCompression(std::shared_ptr<SerializationBuffer
     }
 }
 
+// static
+void SerializationBuffer::installForkHandlers() {
+    pthread_atfork(
+        SerializationBuffer::prepareCompressionForFork,
+        SerializationBuffer::resumeCompressionInParent,
+        SerializationBuffer::resetCompressionInChild
+    );
+}
+
+// we fork holding s_compress_thread_mutex, once the compression threads have
+// finished everything they've been given, so that the child doesn't inherit
+// half-compressed blocks, or the mutex held by a thread it doesn't have.
+// static
+void SerializationBuffer::prepareCompressionForFork() {
+    std::unique_lock<std::mutex> lock(s_compress_thread_mutex);
+
+    while (s_waiting_compress_blocks.size() || s_working_compress_blocks.size()) {
+        s_has_work->wait(lock);
+    }
+
+    lock.release();
+}
+
+// static
+void SerializationBuffer::resumeCompressionInParent() {
+    s_compress_thread_mutex.unlock();
+}
+
+// the child has none of our threads, so the next block marked for compression
+// starts new ones. We leak the old ones' std::thread objects, since destroying
+// a joinable std::thread terminates the process.
+// static
+void SerializationBuffer::resetCompressionInChild() {
+    s_compress_threads.clear();
+    s_compress_thread_mutex.unlock();
+}
+
 // static
 std::mutex SerializationBuffer::s_compress_thread_mutex;
 
@@ -209,4 +372,8 @@ std::unordered_set<std::shared_ptr<SerializationBufferBlock> > SerializationBuff
 // static
 std::unordered_set<std::shared_ptr<SerializationBufferBlock> > SerializationBuffer::s_working_compress_blocks;
 
+// static
+thread_local SerializationBufferBlock::SpareBuffers SerializationBufferBlock::s_spare_buffers;
 
+// static
+thread_local bool SerializationBufferBlock::s_spare_buffers_destroyed = false;
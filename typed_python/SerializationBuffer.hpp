@@ -20,10 +20,13 @@
 #include <stdlib.h>
 #include <map>
 #include <set>
+#include <vector>
 #include <thread>
+#include <functional>
 #include <condition_variable>
 #include "Type.hpp"
 #include "WireType.hpp"
+#include "Varint.hpp"
 
 class Type;
 class SerializationContext;
@@ -33,17 +36,20 @@ class Bytes;
 // in parallel. blocks should be around 1 mb in size.
 class SerializationBufferBlock {
 public:
-    SerializationBufferBlock() :
+    // 'compressionLevel' is the lz4 frame compression level to use if we get
+    // compressed: zero or below is lz4's fast mode, LZ4HC_CLEVEL_MIN or above is lz4hc.
+    SerializationBufferBlock(int compressionLevel = 0) :
         m_size(0),
         m_reserved(0),
         m_buffer(nullptr),
-        m_compressed(false)
+        m_compressed(false),
+        m_compression_level(compressionLevel)
     {
     }
 
     ~SerializationBufferBlock() {
         if (m_buffer) {
-            free(m_buffer);
+            releaseBuffer(m_buffer, m_reserved);
         }
     }
 
@@ -107,6 +113,15 @@ public:
             throw std::runtime_error("Can't make reserved size smaller");
         }
 
+        if (!m_buffer) {
+            // start from a spare buffer if there's one big enough
+            m_buffer = takeSpareBuffer(new_reserved, m_reserved);
+
+            if (m_buffer) {
+                return;
+            }
+        }
+
         m_reserved = new_reserved;
         m_buffer = (uint8_t*)::realloc(m_buffer, m_reserved);
     }
@@ -114,21 +129,105 @@ public:
     void compress();
 
 private:
+    // each thread keeps the buffers of a few of the blocks it destroys, so
+    // that serializing many small messages doesn't malloc a fresh buffer
+    // and regrow it for every one of them.
+    static const size_t SPARE_BUFFER_COUNT = 4;
+    static const size_t SPARE_BUFFER_MAX_BYTES = 4 * 1024 * 1024;
+
+    class SpareBuffers {
+    public:
+        ~SpareBuffers() {
+            for (auto& bufAndSize: buffers) {
+                free(bufAndSize.first);
+            }
+            buffers.clear();
+
+            s_spare_buffers_destroyed = true;
+        }
+
+        std::vector<std::pair<uint8_t*, size_t> > buffers;
+    };
+
+    static thread_local SpareBuffers s_spare_buffers;
+
+    // set once this thread's 'SpareBuffers' is gone, since blocks can still
+    // be destroyed after that as the thread exits.
+    static thread_local bool s_spare_buffers_destroyed;
+
+    // a spare buffer of at least 'bytecount' bytes, or nullptr. Sets 'outReserved'
+    // to its actual size.
+    static uint8_t* takeSpareBuffer(size_t bytecount, size_t& outReserved) {
+        if (s_spare_buffers_destroyed) {
+            return nullptr;
+        }
+
+        auto& buffers = s_spare_buffers.buffers;
+
+        for (long k = (long)buffers.size() - 1; k >= 0; k--) {
+            if (buffers[k].second >= bytecount) {
+                uint8_t* res = buffers[k].first;
+                outReserved = buffers[k].second;
+                buffers.erase(buffers.begin() + k);
+                return res;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static void releaseBuffer(uint8_t* buffer, size_t reserved) {
+        if (s_spare_buffers_destroyed) {
+            free(buffer);
+            return;
+        }
+
+        auto& buffers = s_spare_buffers.buffers;
+
+        if (reserved <= SPARE_BUFFER_MAX_BYTES && buffers.size() < SPARE_BUFFER_COUNT) {
+            buffers.push_back(std::make_pair(buffer, reserved));
+        } else {
+            free(buffer);
+        }
+    }
+
     size_t m_size;
     size_t m_reserved;
     uint8_t* m_buffer;
     bool m_compressed;
+    int m_compression_level;
+};
+
+// takes the blocks of a SerializationBuffer in order, as they fill up, so
+// that something (say, a FileIO::AsyncWriter) can stream them somewhere
+// rather than the buffer holding all of them in memory.
+class SerializationBufferSink {
+public:
+    virtual ~SerializationBufferSink() {}
+
+    // 'block' won't be written to again. If 'needsCompressing', the sink has to
+    // call block->compress() itself. Otherwise, if the buffer compresses, the
+    // block may still be with the compression threads, and the sink has to
+    // SerializationBuffer::waitForCompressionThreads before reading it. May throw
+    // to abandon the serialization.
+    virtual void takeBlock(std::shared_ptr<SerializationBufferBlock> block, bool needsCompressing) = 0;
 };
 
 class SerializationBuffer {
 public:
-    SerializationBuffer(const SerializationContext& context) :
+    // if 'sink' is given, we hand it each block as soon as it's full (and at
+    // 'finalize') instead of keeping it, so we only ever hold the top block.
+    // 'buffer', 'copyInto' and 'size' then only see what hasn't been handed off.
+    SerializationBuffer(const SerializationContext& context, SerializationBufferSink* sink = nullptr) :
         m_context(context),
         m_wants_compress(context.isCompressionEnabled()),
         m_compress_using_threads(context.compressUsingThreads()),
-        m_is_consolidated(false)
+        m_compression_level(context.compressionLevel()),
+        m_is_consolidated(false),
+        m_is_parallel_part(false),
+        m_sink(sink)
     {
-        m_top_block = new SerializationBufferBlock();
+        m_top_block = new SerializationBufferBlock(m_compression_level);
         m_blocks.push_back(std::shared_ptr<SerializationBufferBlock>(m_top_block));
     }
 
@@ -190,11 +289,15 @@ public:
 
     //write a 'varint' (a la google protobuf encoding)
     void writeUnsignedVarint(uint64_t i) {
-        while (i >= 128) {
-            write<uint8_t>(128 + (i & 127));
-            i >>= 7;
+        if (i < 128) {
+            write<uint8_t>(i);
+            return;
         }
-        write<uint8_t>(i);
+
+        // encode it straight into the top block
+        initialize_bytes(Varint::encodedLength(i), [&](uint8_t* bytes) {
+            Varint::encode(i, bytes);
+        });
     }
 
     //write a signed 'varint' using zigzag encoding (a la google protobuf)
@@ -403,6 +506,19 @@ public:
     }
 
     void finalize() {
+        if (m_sink) {
+            if (m_top_block->size()) {
+                std::shared_ptr<SerializationBufferBlock> last = m_blocks.back();
+
+                m_top_block = new SerializationBufferBlock(m_compression_level);
+                m_blocks.clear();
+                m_blocks.push_back(std::shared_ptr<SerializationBufferBlock>(m_top_block));
+
+                handOff(last);
+            }
+            return;
+        }
+
         if (m_wants_compress) {
             markForCompression(m_blocks.back());
 
@@ -412,6 +528,39 @@ public:
         }
     }
 
+    // wait for the compression threads to finish with 'block', if it's with them.
+    // Unlike waitForCompression, this never touches the GIL, so any thread can call it.
+    static void waitForCompressionThreads(std::shared_ptr<SerializationBufferBlock> block);
+
+    // make sure a process we fork can use the compression threads
+    static void installForkHandlers();
+
+    // don't compress anything we write. For a buffer whose blocks we're going
+    // to move into another one with 'appendBlocks', which compresses them.
+    void disableCompression() {
+        m_wants_compress = false;
+    }
+
+    // move the blocks 'other' wrote (with compression disabled) onto the end of
+    // ours, as if we'd written their bytes ourselves. Leaves 'other' empty.
+    void appendBlocks(SerializationBuffer& other);
+
+    // how many threads 'serializeInParallel' should use for 'count' items
+    // made of 'itemTypes', or 1 if we should just write them ourselves.
+    int64_t threadsToSerialize(int64_t count, const std::vector<Type*>& itemTypes);
+
+    // write the items [0, count) of something, splitting them into ranges that
+    // up to 'threadCount' threads write at once, each into a buffer of its own
+    // with 'serializeRange(buffer, lo, hi)', and append the results in order.
+    // The bytes are the same as writing the items on one thread, so
+    // 'serializeRange' can't use the memo or the interpreter: the threads
+    // run with the GIL released.
+    void serializeInParallel(
+        int64_t threadCount,
+        int64_t count,
+        const std::function<void (SerializationBuffer&, int64_t, int64_t)>& serializeRange
+    );
+
     template< class T>
     void write(T i) {
         checkTopBlock();
@@ -421,10 +570,14 @@ public:
 
     void checkTopBlock() {
         if (m_top_block->oversized()) {
-            m_top_block = new SerializationBufferBlock();
+            std::shared_ptr<SerializationBufferBlock> full = m_blocks.back();
+
+            m_top_block = new SerializationBufferBlock(m_compression_level);
 
-            if (m_wants_compress) {
-                markForCompression(m_blocks.back());
+            if (m_sink) {
+                m_blocks.clear();
+            } else if (m_wants_compress) {
+                markForCompression(full);
             }
 
             m_blocks.push_back(
@@ -432,6 +585,10 @@ public:
                     m_top_block
                 )
             );
+
+            if (m_sink) {
+                handOff(full);
+            }
         }
     }
 
@@ -468,8 +625,13 @@ private:
 
     bool m_compress_using_threads;
 
+    int m_compression_level;
+
     bool m_is_consolidated;
 
+    // are we one thread's part of a 'serializeInParallel'?
+    bool m_is_parallel_part;
+
     size_t m_size;
 
     // the
@@ -487,12 +649,26 @@ private:
 
     std::unordered_map<MutuallyRecursiveTypeGroup*, int> m_group_counter;
 
+    SerializationBufferSink* m_sink;
+
+    void handOff(std::shared_ptr<SerializationBufferBlock> block) {
+        if (m_wants_compress) {
+            markForCompression(block);
+        }
+
+        m_sink->takeBlock(block, m_wants_compress && !m_compress_using_threads);
+    }
+
     static void compressionThread();
     static std::shared_ptr<SerializationBufferBlock> getNextCompressTask();
 
     void markForCompression(std::shared_ptr<SerializationBufferBlock> block);
     void waitForCompression(std::shared_ptr<SerializationBufferBlock> block);
 
+    static void prepareCompressionForFork();
+    static void resumeCompressionInParent();
+    static void resetCompressionInChild();
+
     static std::mutex s_compress_thread_mutex;
     static std::condition_variable* s_has_work;
     static std::vector<std::thread*> s_compress_threads;
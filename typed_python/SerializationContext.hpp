@@ -37,5 +37,11 @@ public:
     virtual bool compressUsingThreads() const = 0;
     virtual bool serializePodListsInline() const = 0;
     virtual bool isCompressionEnabled() const = 0;
+    virtual int compressionLevel() const = 0;
     virtual bool isLineInfoSuppressed() const = 0;
+    virtual bool internStrings() const = 0;
+    virtual bool deserializeIntoSlab() const = 0;
+    virtual bool serializeListsColumnar() const = 0;
+    // how many threads may write the elements of one large list or dict
+    virtual int serializeThreadCount() const = 0;
 };
@@ -11,7 +11,10 @@
 #   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
-from typed_python._types import serialize, deserialize, Type, Alternative, NamedTuple, Class, Dict, OneOf
+from typed_python._types import (
+    serialize, deserialize, Type, Alternative, NamedTuple, Class, Dict, OneOf, TypeSchemaCache,
+    SerializationNameCache
+)
 from typed_python import _types
 from typed_python.internals import Final, Member
 
@@ -114,17 +117,35 @@ DEFAULT_NAME_TO_OVERRIDE = {
 }
 
 
+# the range of lz4 frame compression levels that select lz4-hc, from lz4hc.h
+LZ4_HC_MIN_LEVEL = 3
+LZ4_HC_DEFAULT_LEVEL = 9
+LZ4_HC_MAX_LEVEL = 12
+
+
 class SerializationContext(Class, Final):
     """Represents a collection of types with well-specified names that we can use to serialize objects."""
     nameToObjectOverride = Member(Dict(str, object))
     objectToNameOverride = Member(Dict(int, str))
 
     compressionEnabled = Member(bool)
+    # the lz4 frame 'compressionLevel': 0 and below is the fast compressor
+    # (with acceleration 1 - level), and LZ4_HC_MIN_LEVEL and up is lz4-hc.
+    compressionLevel = Member(int)
     encodeLineInformationForCode = Member(bool)
     serializeFunctionGlobalsAsIs = Member(bool)
     serializeHashSequence = Member(bool)
     serializePodListsInline = Member(bool)
     compressUsingThreads = Member(bool)
+    internStrings = Member(bool)
+    deserializeIntoSlab = Member(bool)
+    serializeListsColumnar = Member(bool)
+    serializeThreadCount = Member(int)
+    # None, or the TypeSchemaCache of types we write as ids
+    typeSchemaCache = Member(object)
+    # the SerializationNameCache remembering what nameForObject and objectFromName
+    # said, which we share with the contexts our 'with' methods make
+    nameCache = Member(object)
 
     # these are for fault-injection and may be removed in the future
     nameForObjectOverride = Member(OneOf(None, object))
@@ -134,12 +155,19 @@ class SerializationContext(Class, Final):
         self,
         nameToObjectOverride=None,
         compressionEnabled=True,
+        compressionLevel=0,
         encodeLineInformationForCode=True,
         objectToNameOverride=None,
         serializeFunctionGlobalsAsIs=False,
         serializeHashSequence=False,
         serializePodListsInline=False,
-        compressUsingThreads=True
+        compressUsingThreads=True,
+        internStrings=False,
+        deserializeIntoSlab=False,
+        serializeListsColumnar=False,
+        serializeThreadCount=1,
+        typeSchemaCache=None,
+        nameCache=None
     ):
         self.nameForObjectOverride = None
         self.objectFromNameOverride = None
@@ -151,21 +179,30 @@ class SerializationContext(Class, Final):
             {id(v): n for n, v in self.nameToObjectOverride.items()}
         )
         self.compressionEnabled = compressionEnabled
+        self.compressionLevel = compressionLevel
         self.encodeLineInformationForCode = encodeLineInformationForCode
         self.serializeFunctionGlobalsAsIs = serializeFunctionGlobalsAsIs
         self.serializeHashSequence = serializeHashSequence
         self.serializePodListsInline = serializePodListsInline
         self.compressUsingThreads = compressUsingThreads
+        self.internStrings = internStrings
+        self.deserializeIntoSlab = deserializeIntoSlab
+        self.serializeListsColumnar = serializeListsColumnar
+        self.serializeThreadCount = serializeThreadCount
+        self.typeSchemaCache = typeSchemaCache
+        self.nameCache = nameCache if nameCache is not None else SerializationNameCache()
 
     def addNamedObject(self, name, obj):
         self.nameToObjectOverride[name] = obj
         self.objectToNameOverride[id(obj)] = name
+        self.nameCache.clear()
 
     def dropNamedObject(self, name):
         objId = id(self.nameToObjectOverride[name])
 
         del self.nameToObjectOverride[name]
         del self.objectToNameOverride[objId]
+        self.nameCache.clear()
 
     def withFunctionGlobalsAsIs(self):
         """When serializing a function, don't replace its globals dict.
@@ -186,12 +223,19 @@ class SerializationContext(Class, Final):
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
             encodeLineInformationForCode=self.encodeLineInformationForCode,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=True,
             serializeHashSequence=self.serializeHashSequence,
             serializePodListsInline=self.serializePodListsInline,
-            compressUsingThreads=self.compressUsingThreads
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
     def withoutLineInfoEncoded(self):
@@ -201,12 +245,19 @@ class SerializationContext(Class, Final):
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
             encodeLineInformationForCode=False,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
             serializeHashSequence=self.serializeHashSequence,
             serializePodListsInline=self.serializePodListsInline,
-            compressUsingThreads=self.compressUsingThreads
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
     def withoutCompression(self):
@@ -216,27 +267,83 @@ class SerializationContext(Class, Final):
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=False,
+            compressionLevel=self.compressionLevel,
             encodeLineInformationForCode=self.encodeLineInformationForCode,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
             serializeHashSequence=self.serializeHashSequence,
             serializePodListsInline=self.serializePodListsInline,
-            compressUsingThreads=self.compressUsingThreads
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
-    def withCompression(self):
-        if self.compressionEnabled:
+    def withCompression(self, codec=None, level=None):
+        """Compress serialized data, optionally picking the codec.
+
+        Args:
+            codec - None to keep the current codec, or one of
+                'lz4' - lz4's fast compressor. 'level' is its acceleration,
+                    from 1 (the default) upward, trading ratio for speed.
+                'lz4hc' - lz4's high-compression mode, for data that's
+                    written once and read many times. 'level' runs from
+                    LZ4_HC_MIN_LEVEL to LZ4_HC_MAX_LEVEL, and defaults
+                    to LZ4_HC_DEFAULT_LEVEL.
+                'none' - the same as 'withoutCompression'.
+            level - the codec-specific level described above.
+
+        Every codec writes lz4 frames, which carry their own header, so
+        deserialization doesn't need to know which one was used.
+        """
+        if codec == 'none':
+            if level is not None:
+                raise ValueError("codec 'none' doesn't take a level")
+            return self.withoutCompression()
+
+        if codec is None:
+            if level is not None:
+                raise ValueError("can't specify a compression level without a codec")
+            compressionLevel = self.compressionLevel
+        elif codec == 'lz4':
+            if level is None:
+                level = 1
+            if level < 1:
+                raise ValueError(f"lz4 acceleration must be at least 1, not {level}")
+            compressionLevel = 1 - level
+        elif codec == 'lz4hc':
+            if level is None:
+                level = LZ4_HC_DEFAULT_LEVEL
+            if level < LZ4_HC_MIN_LEVEL or level > LZ4_HC_MAX_LEVEL:
+                raise ValueError(
+                    f"lz4hc level must be between {LZ4_HC_MIN_LEVEL} and {LZ4_HC_MAX_LEVEL}, not {level}"
+                )
+            compressionLevel = level
+        else:
+            raise ValueError(f"Unknown compression codec {codec!r}. Expected 'lz4', 'lz4hc', or 'none'.")
+
+        if self.compressionEnabled and self.compressionLevel == compressionLevel:
             return self
 
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=True,
+            compressionLevel=compressionLevel,
             encodeLineInformationForCode=self.encodeLineInformationForCode,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
             serializeHashSequence=self.serializeHashSequence,
             serializePodListsInline=self.serializePodListsInline,
-            compressUsingThreads=self.compressUsingThreads
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
     def withSerializeHashSequence(self):
@@ -246,12 +353,19 @@ class SerializationContext(Class, Final):
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
             encodeLineInformationForCode=self.encodeLineInformationForCode,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
             serializeHashSequence=True,
             serializePodListsInline=self.serializePodListsInline,
-            compressUsingThreads=self.compressUsingThreads
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
     def withSerializePodListsInline(self):
@@ -261,12 +375,19 @@ class SerializationContext(Class, Final):
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
             encodeLineInformationForCode=self.encodeLineInformationForCode,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
             serializeHashSequence=self.serializeHashSequence,
             serializePodListsInline=True,
-            compressUsingThreads=self.compressUsingThreads
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
     def withoutCompressUsingThreads(self):
@@ -276,14 +397,233 @@ class SerializationContext(Class, Final):
         return SerializationContext(
             nameToObjectOverride=self.nameToObjectOverride,
             compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
+            encodeLineInformationForCode=self.encodeLineInformationForCode,
+            objectToNameOverride=self.objectToNameOverride,
+            serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
+            serializeHashSequence=self.serializeHashSequence,
+            serializePodListsInline=self.serializePodListsInline,
+            compressUsingThreads=False,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
+        )
+
+    def withStringInterning(self):
+        """Deserialize strings through the process-wide string intern table.
+
+        Equal strings then share a single allocation, which saves memory and
+        lets equality checks short-circuit, when the same values (symbols,
+        enum-like tags, dict keys) recur many times. Interned strings are
+        kept alive by the table until _types.clearStringInternTable() is called.
+        """
+        if self.internStrings:
+            return self
+
+        return SerializationContext(
+            nameToObjectOverride=self.nameToObjectOverride,
+            compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
+            encodeLineInformationForCode=self.encodeLineInformationForCode,
+            objectToNameOverride=self.objectToNameOverride,
+            serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
+            serializeHashSequence=self.serializeHashSequence,
+            serializePodListsInline=self.serializePodListsInline,
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=True,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
+        )
+
+    def withDeserializeIntoSlab(self):
+        """Deserialize each message into a single Slab.
+
+        Every typed_python allocation made while deserializing a message is
+        bump-allocated out of one Slab sized from the message, rather than
+        malloc'd object by object, and the Slab is released in one shot once
+        the last object in it is gone. Combined with 'withSerializePodListsInline'
+        and no compression, loading a POD ListOf is a single copy straight
+        from the serialized bytes into the Slab.
+
+        Objects in the Slab can still be modified: a list that grows moves
+        its data out to the free store.
+        """
+        if self.deserializeIntoSlab:
+            return self
+
+        return SerializationContext(
+            nameToObjectOverride=self.nameToObjectOverride,
+            compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
+            encodeLineInformationForCode=self.encodeLineInformationForCode,
+            objectToNameOverride=self.objectToNameOverride,
+            serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
+            serializeHashSequence=self.serializeHashSequence,
+            serializePodListsInline=self.serializePodListsInline,
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=True,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
+        )
+
+    def withColumnarLists(self):
+        """Serialize lists and tuples of simple NamedTuples and Tuples column by column.
+
+        A ListOf or TupleOf whose element is a NamedTuple or Tuple holding only
+        register types, str and bytes is written as one block per field rather
+        than one message per row: ints as zigzag varints of the difference from
+        the previous row, floats and bools as raw arrays, and str and bytes
+        through a dictionary when values repeat. Each block is homogeneous,
+        so it's small to begin with and compresses well, and reading it back
+        is a tight loop per column.
+
+        Any context can deserialize the result. Lists of other element types
+        serialize as they normally would.
+        """
+        if self.serializeListsColumnar:
+            return self
+
+        return SerializationContext(
+            nameToObjectOverride=self.nameToObjectOverride,
+            compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
             encodeLineInformationForCode=self.encodeLineInformationForCode,
             objectToNameOverride=self.objectToNameOverride,
             serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
             serializeHashSequence=self.serializeHashSequence,
             serializePodListsInline=self.serializePodListsInline,
-            compressUsingThreads=False
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=True,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
         )
 
+    def withSerializeThreads(self, threadCount):
+        """Write the elements of large lists and dicts on up to 'threadCount' threads.
+
+        A ListOf, TupleOf or Dict with many elements is split into ranges that
+        each thread writes on its own, and we join what they wrote together in
+        order, so the result is the same as serializing on one thread, and
+        any context can read it. Only elements made entirely of register
+        types, str, bytes and the immutable containers and alternatives built
+        from them qualify, since everything else can refer to objects
+        written elsewhere in the message. The threads run without the GIL.
+        """
+        if threadCount < 1:
+            raise ValueError("threadCount must be at least 1")
+
+        if threadCount == self.serializeThreadCount:
+            return self
+
+        return SerializationContext(
+            nameToObjectOverride=self.nameToObjectOverride,
+            compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
+            encodeLineInformationForCode=self.encodeLineInformationForCode,
+            objectToNameOverride=self.objectToNameOverride,
+            serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
+            serializeHashSequence=self.serializeHashSequence,
+            serializePodListsInline=self.serializePodListsInline,
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=threadCount,
+            typeSchemaCache=self.typeSchemaCache,
+            nameCache=self.nameCache
+        )
+
+    def withTypeSchemaCache(self, typeSchemaCache):
+        """Write (and read) the types in 'typeSchemaCache' as small integer ids.
+
+        Named types and types identified by their group hash normally carry
+        their name or hash in every message that mentions them, which can be
+        most of a small message. Once both ends of a connection have agreed on
+        a set of types, with 'announceTypes' on the sending side and
+        'acceptTypes' on the receiving side, each of those types takes a
+        single varint. Only contexts holding a matching cache can read the
+        result.
+        """
+        if typeSchemaCache is not None and not isinstance(typeSchemaCache, TypeSchemaCache):
+            raise TypeError("withTypeSchemaCache expects a TypeSchemaCache")
+
+        return SerializationContext(
+            nameToObjectOverride=self.nameToObjectOverride,
+            compressionEnabled=self.compressionEnabled,
+            compressionLevel=self.compressionLevel,
+            encodeLineInformationForCode=self.encodeLineInformationForCode,
+            objectToNameOverride=self.objectToNameOverride,
+            serializeFunctionGlobalsAsIs=self.serializeFunctionGlobalsAsIs,
+            serializeHashSequence=self.serializeHashSequence,
+            serializePodListsInline=self.serializePodListsInline,
+            compressUsingThreads=self.compressUsingThreads,
+            internStrings=self.internStrings,
+            deserializeIntoSlab=self.deserializeIntoSlab,
+            serializeListsColumnar=self.serializeListsColumnar,
+            serializeThreadCount=self.serializeThreadCount,
+            typeSchemaCache=typeSchemaCache,
+            nameCache=self.nameCache
+        )
+
+    def announceTypes(self, types):
+        """Add 'types' to our TypeSchemaCache, and return the handshake message for them.
+
+        The receiving side passes the message to 'acceptTypes' on its own context
+        before deserializing anything we send after it. Types already in the
+        cache are skipped, so announcing as new types turn up is cheap.
+        """
+        if self.typeSchemaCache is None:
+            raise ValueError("announceTypes needs a context with a TypeSchemaCache")
+
+        newTypes = []
+        for T in types:
+            if self.typeSchemaCache.idFor(T) is None and T not in newTypes:
+                newTypes.append(T)
+
+        # the message has to describe the types in full, so we serialize
+        # it before any of them are in the cache
+        handshake = self.serialize((len(self.typeSchemaCache), newTypes))
+
+        for T in newTypes:
+            self.typeSchemaCache.add(T)
+
+        return handshake
+
+    def acceptTypes(self, handshake):
+        """Add the types in a handshake from the other side's 'announceTypes' to our cache.
+
+        Handshakes have to be accepted in the order they were announced.
+        Returns the list of types the handshake added.
+        """
+        if self.typeSchemaCache is None:
+            raise ValueError("acceptTypes needs a context with a TypeSchemaCache")
+
+        firstId, types = self.deserialize(handshake)
+
+        if firstId != len(self.typeSchemaCache):
+            raise ValueError(
+                f"This handshake starts at TypeSchemaCache id {firstId}, but our cache has "
+                f"{len(self.typeSchemaCache)} types. Handshakes were lost or accepted out of order."
+            )
+
+        for i, T in enumerate(types):
+            if self.typeSchemaCache.add(T) != firstId + i:
+                raise ValueError(f"{T} was already in our TypeSchemaCache under a different id")
+
+        return types
+
     def nameForObject(self, t):
         ''' Return a name(string) for an input object t, or None if not found. '''
         if self.nameForObjectOverride is not None:
@@ -492,6 +832,35 @@ class SerializationContext(Class, Final):
     def deserialize(self, bytes, serializeType=object):
         return deserialize(serializeType, bytes, self)
 
+    def deserializeUntrusted(self, bytes, serializeType=object, maxDepth=1000, maxBytes=1 << 30):
+        """Deserialize data from a source we don't trust, checking it in the same pass.
+
+        See _types.deserializeUntrusted for what 'maxDepth' and 'maxBytes' bound.
+        """
+        return _types.deserializeUntrusted(serializeType, bytes, self, maxDepth=maxDepth, maxBytes=maxBytes)
+
+    def serializeDelta(self, previous, current, serializeType):
+        """Serialize 'current' as the difference from 'previous', both of type 'serializeType'.
+
+        For a series of snapshots that mostly share their contents. Unchanged parts,
+        including immutable containers (TupleOf, ConstDict, str) 'current' shares with
+        'previous', cost a byte or so. The receiver calls 'deserializeDelta' with the
+        same 'previous'. See DeltaSerialization.hpp for what counts as unchanged.
+        """
+        return _types.serializeDelta(serializeType, previous, current, self)
+
+    def deserializeDelta(self, previous, delta, serializeType):
+        """Rebuild the value that 'serializeDelta(previous, ...)' produced 'delta' from."""
+        return _types.deserializeDelta(serializeType, previous, delta, self)
+
+    def deserializeInto(self, bytes, existing, serializeType):
+        """Deserialize 'bytes' reusing the storage of 'existing', a 'serializeType'.
+
+        A ListOf, Dict or Set 'existing' is filled in place and returned. See
+        _types.deserializeInto.
+        """
+        return _types.deserializeInto(serializeType, bytes, existing, self)
+
     def factoryFor(self, inst):
         """If this object can be produced using a factory without any state, return a tuple
 
@@ -0,0 +1,139 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include "util.hpp"
+#include <string>
+#include <unordered_map>
+
+class MutuallyRecursiveTypeGroup;
+
+/*********
+What a SerializationContext's 'nameForObject' and 'objectFromName' have told
+us, so that we only call into python the first time we see each object or name.
+
+We remember
+
+    * the name of every object that had one, and the object for every name
+      that resolved, holding a reference to each object so its address can't
+      be reused by something else.
+    * for native types, which are never destroyed, that they had no name.
+    * for each MutuallyRecursiveTypeGroup, the name of the first of its members
+      with one, or that none of them had one. Groups are never destroyed either.
+
+We never remember that an arbitrary python object had no name, since that
+would keep every object we ever serialized alive.
+
+A SerializationContext and the contexts its 'with' methods make share one
+cache, along with their names. 'addNamedObject' and 'dropNamedObject' clear it.
+Callers hold the GIL, which is what keeps the cache consistent.
+*********/
+
+class SerializationNameCache {
+public:
+    ~SerializationNameCache() {
+        clear();
+    }
+
+    // if we know whether 'o' has a name, set 'outName' to it (or to "" if it
+    // has none) and return true.
+    bool lookupName(PyObject* o, std::string& outName) const {
+        auto it = mNames.find(o);
+
+        if (it == mNames.end()) {
+            return false;
+        }
+
+        outName = it->second;
+        return true;
+    }
+
+    void recordName(PyObject* o, const std::string& name) {
+        if (mNames.find(o) != mNames.end()) {
+            return;
+        }
+
+        mNames[incref(o)] = name;
+    }
+
+    // the object named 'name', as a borrowed reference, or nullptr if we don't know it
+    PyObject* lookupObject(const std::string& name) const {
+        auto it = mObjects.find(name);
+
+        if (it == mObjects.end()) {
+            return nullptr;
+        }
+
+        return it->second;
+    }
+
+    void recordObject(const std::string& name, PyObject* o) {
+        if (mObjects.find(name) != mObjects.end()) {
+            return;
+        }
+
+        mObjects[name] = incref(o);
+    }
+
+    bool lookupGroupName(MutuallyRecursiveTypeGroup* group, std::string& outName) const {
+        auto it = mGroupNames.find(group);
+
+        if (it == mGroupNames.end()) {
+            return false;
+        }
+
+        outName = it->second;
+        return true;
+    }
+
+    void recordGroupName(MutuallyRecursiveTypeGroup* group, const std::string& name) {
+        mGroupNames[group] = name;
+    }
+
+    size_t size() const {
+        return mNames.size() + mObjects.size() + mGroupNames.size();
+    }
+
+    void clear() {
+        // move everything out first, since dropping a reference can run
+        // arbitrary python code, which could come back and use us.
+        std::unordered_map<PyObject*, std::string> names;
+        std::unordered_map<std::string, PyObject*> objects;
+
+        names.swap(mNames);
+        objects.swap(mObjects);
+        mGroupNames.clear();
+
+        for (auto& objAndName: names) {
+            decref(objAndName.first);
+        }
+
+        for (auto& nameAndObj: objects) {
+            decref(nameAndObj.second);
+        }
+    }
+
+private:
+    // keys are references we hold
+    std::unordered_map<PyObject*, std::string> mNames;
+
+    // values are references we hold
+    std::unordered_map<std::string, PyObject*> mObjects;
+
+    std::unordered_map<MutuallyRecursiveTypeGroup*, std::string> mGroupNames;
+};
@@ -0,0 +1,165 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+
+class StringType;
+class BytesType;
+
+/*********
+How a NamedTuple, Tuple or HeldClass serializes its fields.
+
+The plan is built once, whenever the type's layout is computed, and records
+each field's byte offset and field number along with which of the common
+leaf types (the register types, str and bytes) it holds. Serializing an
+instance then writes those fields directly, rather than going through
+'Type::check' for every field of every message. Fields of any other type
+go through their type's regular 'serialize' and 'deserialize'.
+
+The wire format is exactly what the generic path produces.
+*********/
+
+class SerializationPlan {
+public:
+    enum class Kind {
+        Bool,
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float32,
+        Float64,
+        String,
+        Bytes,
+        Other
+    };
+
+    class Field {
+    public:
+        Field(Type* inType, size_t inOffset, size_t inFieldNumber) :
+            type(inType),
+            offset(inOffset),
+            fieldNumber(inFieldNumber),
+            kind(kindFor(inType))
+        {
+        }
+
+        Type* type;
+        size_t offset;
+        size_t fieldNumber;
+        Kind kind;
+    };
+
+    static Kind kindFor(Type* t) {
+        switch (t->getTypeCategory()) {
+            case Type::TypeCategory::catBool: return Kind::Bool;
+            case Type::TypeCategory::catInt8: return Kind::Int8;
+            case Type::TypeCategory::catInt16: return Kind::Int16;
+            case Type::TypeCategory::catInt32: return Kind::Int32;
+            case Type::TypeCategory::catInt64: return Kind::Int64;
+            case Type::TypeCategory::catUInt8: return Kind::UInt8;
+            case Type::TypeCategory::catUInt16: return Kind::UInt16;
+            case Type::TypeCategory::catUInt32: return Kind::UInt32;
+            case Type::TypeCategory::catUInt64: return Kind::UInt64;
+            case Type::TypeCategory::catFloat32: return Kind::Float32;
+            case Type::TypeCategory::catFloat64: return Kind::Float64;
+            case Type::TypeCategory::catString: return Kind::String;
+            case Type::TypeCategory::catBytes: return Kind::Bytes;
+            default: return Kind::Other;
+        }
+    }
+
+    void clear() {
+        m_fields.clear();
+    }
+
+    void addField(Type* t, size_t offset, size_t fieldNumber) {
+        m_fields.push_back(Field(t, offset, fieldNumber));
+    }
+
+    size_t size() const {
+        return m_fields.size();
+    }
+
+    const Field& operator[](size_t ix) const {
+        return m_fields[ix];
+    }
+
+    template<class buf_t>
+    static void serializeField(const Field& field, instance_ptr self, buf_t& buffer) {
+        instance_ptr p = self + field.offset;
+
+        switch (field.kind) {
+            case Kind::Bool: buffer.writeRegisterType(field.fieldNumber, *(bool*)p); return;
+            case Kind::Int8: buffer.writeRegisterType(field.fieldNumber, *(int8_t*)p); return;
+            case Kind::Int16: buffer.writeRegisterType(field.fieldNumber, *(int16_t*)p); return;
+            case Kind::Int32: buffer.writeRegisterType(field.fieldNumber, *(int32_t*)p); return;
+            case Kind::Int64: buffer.writeRegisterType(field.fieldNumber, *(int64_t*)p); return;
+            case Kind::UInt8: buffer.writeRegisterType(field.fieldNumber, *(uint8_t*)p); return;
+            case Kind::UInt16: buffer.writeRegisterType(field.fieldNumber, *(uint16_t*)p); return;
+            case Kind::UInt32: buffer.writeRegisterType(field.fieldNumber, *(uint32_t*)p); return;
+            case Kind::UInt64: buffer.writeRegisterType(field.fieldNumber, *(uint64_t*)p); return;
+            case Kind::Float32: buffer.writeRegisterType(field.fieldNumber, *(float*)p); return;
+            case Kind::Float64: buffer.writeRegisterType(field.fieldNumber, *(double*)p); return;
+            case Kind::String: serializeAs<StringType>(field, p, buffer); return;
+            case Kind::Bytes: serializeAs<BytesType>(field, p, buffer); return;
+            case Kind::Other: field.type->serialize(p, buffer, field.fieldNumber); return;
+        }
+    }
+
+    template<class buf_t>
+    static void deserializeField(const Field& field, instance_ptr self, buf_t& buffer, size_t wireType) {
+        instance_ptr p = self + field.offset;
+
+        switch (field.kind) {
+            case Kind::Bool: buffer.readRegisterType((bool*)p, wireType); return;
+            case Kind::Int8: buffer.readRegisterType((int8_t*)p, wireType); return;
+            case Kind::Int16: buffer.readRegisterType((int16_t*)p, wireType); return;
+            case Kind::Int32: buffer.readRegisterType((int32_t*)p, wireType); return;
+            case Kind::Int64: buffer.readRegisterType((int64_t*)p, wireType); return;
+            case Kind::UInt8: buffer.readRegisterType((uint8_t*)p, wireType); return;
+            case Kind::UInt16: buffer.readRegisterType((uint16_t*)p, wireType); return;
+            case Kind::UInt32: buffer.readRegisterType((uint32_t*)p, wireType); return;
+            case Kind::UInt64: buffer.readRegisterType((uint64_t*)p, wireType); return;
+            case Kind::Float32: buffer.readRegisterType((float*)p, wireType); return;
+            case Kind::Float64: buffer.readRegisterType((double*)p, wireType); return;
+            case Kind::String: deserializeAs<StringType>(field, p, buffer, wireType); return;
+            case Kind::Bytes: deserializeAs<BytesType>(field, p, buffer, wireType); return;
+            case Kind::Other: field.type->deserialize(p, buffer, wireType); return;
+        }
+    }
+
+private:
+    // call the concrete type's serializer directly. These are templates so that
+    // StringType and BytesType only need to be complete where they're used.
+    template<class concrete_type, class buf_t>
+    static void serializeAs(const Field& field, instance_ptr p, buf_t& buffer) {
+        ((concrete_type*)field.type)->serialize(p, buffer, field.fieldNumber);
+    }
+
+    template<class concrete_type, class buf_t>
+    static void deserializeAs(const Field& field, instance_ptr p, buf_t& buffer, size_t wireType) {
+        ((concrete_type*)field.type)->deserialize(p, buffer, wireType);
+    }
+
+    std::vector<Field> m_fields;
+};
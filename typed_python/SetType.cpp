@@ -20,7 +20,7 @@ SetType* SetType::Make(Type* eltype, SetType* knownType) {
 bool SetType::discard(instance_ptr self, instance_ptr key) {
     hash_table_layout& record = **(hash_table_layout**)self;
     typed_python_hash_type keyHash = m_key_type->hash(key);
-    int32_t index = record.remove(m_bytes_per_el, keyHash, [&](instance_ptr ptr) {
+    int64_t index = record.remove(m_bytes_per_el, keyHash, [&](instance_ptr ptr) {
         return m_key_type->cmp(key, ptr, Py_EQ);
     });
     if (index >= 0) {
@@ -40,10 +40,194 @@ void SetType::clear(instance_ptr self) {
     record.allItemsHaveBeenRemoved();
 }
 
+void SetType::compact(instance_ptr self) {
+    hash_table_layout& record = **(hash_table_layout**)self;
+    record.compact(m_bytes_per_el);
+}
+
+void SetType::insertElements(instance_ptr self, instance_ptr elts, size_t count) {
+    hash_table_layout& record = **(hash_table_layout**)self;
+    record.reserveForInsertion(m_bytes_per_el, count);
+
+    // hash everything up front, so the insertion loop below only touches the table
+    std::vector<typed_python_hash_type> hashes(count);
+    for (size_t k = 0; k < count; k++) {
+        hashes[k] = m_key_type->hash(elts + k * m_bytes_per_el);
+    }
+
+    for (size_t k = 0; k < count; k++) {
+        instance_ptr elt = elts + k * m_bytes_per_el;
+        int64_t index = record.find(m_bytes_per_el, hashes[k],
+                                    [&](instance_ptr ptr) { return m_key_type->cmp(elt, ptr, Py_EQ); });
+        if (index < 0) {
+            int64_t slot = record.allocateNewSlot(m_bytes_per_el);
+            record.add(hashes[k], slot);
+            m_key_type->copy_constructor(record.items + slot * m_bytes_per_el, elt);
+        }
+    }
+}
+
+int64_t SetType::findBucketWithHash(hash_table_layout& record, instance_ptr key, typed_python_hash_type hash) {
+    return record.findBucket(m_bytes_per_el, hash,
+                             [&](instance_ptr ptr) { return m_key_type->cmp(key, ptr, Py_EQ); });
+}
+
+void SetType::insertNewWithHash(hash_table_layout& record, instance_ptr key, typed_python_hash_type hash) {
+    int64_t slot = record.allocateNewSlot(m_bytes_per_el);
+    record.add(hash, slot);
+    m_key_type->copy_constructor(record.items + slot * m_bytes_per_el, key);
+}
+
+void SetType::removeBucket(hash_table_layout& record, int64_t bucket) {
+    int64_t slot = record.removeBucket(bucket);
+    m_key_type->destroy(record.items + slot * m_bytes_per_el);
+}
+
+void SetType::unionInPlace(instance_ptr self, instance_ptr other) {
+    hash_table_layout& s = **(hash_table_layout**)self;
+    hash_table_layout& o = **(hash_table_layout**)other;
+
+    if (&s == &o) {
+        return;
+    }
+
+    // size the table once, rather than growing it as we insert
+    s.reserveForInsertion(m_bytes_per_el, o.hash_table_count);
+
+    o.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        if (findBucketWithHash(s, key, hash) < 0) {
+            insertNewWithHash(s, key, hash);
+        }
+    });
+}
+
+void SetType::intersection(instance_ptr result, instance_ptr left, instance_ptr right) {
+    hash_table_layout& r = **(hash_table_layout**)result;
+    hash_table_layout* smaller = *(hash_table_layout**)left;
+    hash_table_layout* larger = *(hash_table_layout**)right;
+
+    if (smaller->hash_table_count > larger->hash_table_count) {
+        std::swap(smaller, larger);
+    }
+
+    r.reserveForInsertion(m_bytes_per_el, smaller->hash_table_count);
+
+    smaller->visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        if (findBucketWithHash(*larger, key, hash) >= 0) {
+            insertNewWithHash(r, key, hash);
+        }
+    });
+}
+
+void SetType::intersectionInPlace(instance_ptr self, instance_ptr other) {
+    hash_table_layout& s = **(hash_table_layout**)self;
+    hash_table_layout& o = **(hash_table_layout**)other;
+
+    if (&s == &o) {
+        return;
+    }
+
+    s.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        if (findBucketWithHash(o, key, hash) < 0) {
+            removeBucket(s, bucket);
+        }
+    });
+}
+
+void SetType::difference(instance_ptr result, instance_ptr left, instance_ptr right) {
+    hash_table_layout& r = **(hash_table_layout**)result;
+    hash_table_layout& l = **(hash_table_layout**)left;
+    hash_table_layout& rt = **(hash_table_layout**)right;
+
+    if (&l == &rt) {
+        return;
+    }
+
+    r.reserveForInsertion(m_bytes_per_el, l.hash_table_count);
+
+    l.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        if (findBucketWithHash(rt, key, hash) < 0) {
+            insertNewWithHash(r, key, hash);
+        }
+    });
+}
+
+void SetType::differenceInPlace(instance_ptr self, instance_ptr other) {
+    hash_table_layout& s = **(hash_table_layout**)self;
+    hash_table_layout& o = **(hash_table_layout**)other;
+
+    if (&s == &o) {
+        clear(self);
+        return;
+    }
+
+    if (o.hash_table_count < s.hash_table_count) {
+        o.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+            int64_t ourBucket = findBucketWithHash(s, key, hash);
+
+            if (ourBucket >= 0) {
+                removeBucket(s, ourBucket);
+            }
+        });
+    } else {
+        s.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+            if (findBucketWithHash(o, key, hash) >= 0) {
+                removeBucket(s, bucket);
+            }
+        });
+    }
+}
+
+void SetType::symmetricDifference(instance_ptr result, instance_ptr left, instance_ptr right) {
+    hash_table_layout& r = **(hash_table_layout**)result;
+    hash_table_layout& l = **(hash_table_layout**)left;
+    hash_table_layout& rt = **(hash_table_layout**)right;
+
+    if (&l == &rt) {
+        return;
+    }
+
+    r.reserveForInsertion(m_bytes_per_el, l.hash_table_count + rt.hash_table_count);
+
+    l.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        if (findBucketWithHash(rt, key, hash) < 0) {
+            insertNewWithHash(r, key, hash);
+        }
+    });
+
+    rt.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        if (findBucketWithHash(l, key, hash) < 0) {
+            insertNewWithHash(r, key, hash);
+        }
+    });
+}
+
+void SetType::symmetricDifferenceInPlace(instance_ptr self, instance_ptr other) {
+    hash_table_layout& s = **(hash_table_layout**)self;
+    hash_table_layout& o = **(hash_table_layout**)other;
+
+    if (&s == &o) {
+        clear(self);
+        return;
+    }
+
+    s.reserveForInsertion(m_bytes_per_el, o.hash_table_count);
+
+    o.visitBuckets(m_bytes_per_el, [&](int64_t bucket, instance_ptr key, typed_python_hash_type hash) {
+        int64_t ourBucket = findBucketWithHash(s, key, hash);
+
+        if (ourBucket >= 0) {
+            removeBucket(s, ourBucket);
+        } else {
+            insertNewWithHash(s, key, hash);
+        }
+    });
+}
+
 instance_ptr SetType::insertKey(instance_ptr self, instance_ptr key) {
     hash_table_layout& record = **(hash_table_layout**)self;
     typed_python_hash_type keyHash = m_key_type->hash(key);
-    int32_t slot = record.allocateNewSlot(m_bytes_per_el);
+    int64_t slot = record.allocateNewSlot(m_bytes_per_el);
     record.add(keyHash, slot);
     m_key_type->copy_constructor(record.items + slot * m_bytes_per_el, key);
     return record.items + slot * m_bytes_per_el;
@@ -52,7 +236,7 @@ instance_ptr SetType::insertKey(instance_ptr self, instance_ptr key) {
 instance_ptr SetType::lookupKey(instance_ptr self, instance_ptr key) const {
     hash_table_layout& record = **(hash_table_layout**)self;
     typed_python_hash_type keyHash = m_key_type->hash(key);
-    int32_t index = record.find(m_bytes_per_el, keyHash,
+    int64_t index = record.find(m_bytes_per_el, keyHash,
                                 [&](instance_ptr ptr) { return m_key_type->cmp(key, ptr, Py_EQ); });
     if (index >= 0) {
         return record.items + index * m_bytes_per_el;
@@ -91,12 +275,20 @@ void SetType::constructor(instance_ptr self) {
     hash_table_layout& record = **(hash_table_layout**)self;
     new (&record) hash_table_layout();
     record.refcount += 1;
+
+    if (type_live_counters_enabled) {
+        record.startCounting(this);
+    }
 }
 
 void SetType::destroy(instance_ptr self) {
     hash_table_layout& record = **(hash_table_layout**)self;
 
     if (record.refcount.fetch_sub(1) == 1) {
+        if (record.counted_type) {
+            typeLiveCountersAdjust(record.counted_type, &record, -1);
+        }
+
         for (long k = 0; k < record.items_reserved; k++) {
             if (record.items_populated[k]) {
                 m_key_type->destroy(record.items + m_bytes_per_el * k);
@@ -107,6 +299,7 @@ void SetType::destroy(instance_ptr self) {
         tp_free(record.items_populated);
         tp_free(record.hash_table_slots);
         tp_free(record.hash_table_hashes);
+        tp_free(record.hash_table_control);
         tp_free(&record);
     }
 }
@@ -212,6 +405,11 @@ bool SetType::slotPopulated(instance_ptr self, size_t offset) const {
     return record.items_populated[offset];
 }
 
+int64_t SetType::nextPopulatedSlot(instance_ptr self, int64_t offset) const {
+    hash_table_layout& record = **(hash_table_layout**)self;
+    return record.nextPopulatedSlot(offset);
+}
+
 instance_ptr SetType::keyAtSlot(instance_ptr self, size_t offset) const {
     hash_table_layout& record = **(hash_table_layout**)self;
     return record.items + m_bytes_per_el * offset;
@@ -55,6 +55,21 @@ class SetType : public Type {
     instance_ptr lookupKey(instance_ptr self, instance_ptr key) const;
     bool discard(instance_ptr self, instance_ptr key);
     void clear(instance_ptr self);
+    void compact(instance_ptr self);
+    // insert 'count' elements from a contiguous array, sizing the table once.
+    void insertElements(instance_ptr self, instance_ptr elts, size_t count);
+
+    // set algebra between two sets of this type. These walk the hashtable so they
+    // can reuse the hashes it stores instead of rehashing, probe the larger operand
+    // with the elements of the smaller one where the operation allows it, and size
+    // their target once up front. 'result' must be an empty set.
+    void unionInPlace(instance_ptr self, instance_ptr other);
+    void intersection(instance_ptr result, instance_ptr left, instance_ptr right);
+    void intersectionInPlace(instance_ptr self, instance_ptr other);
+    void difference(instance_ptr result, instance_ptr left, instance_ptr right);
+    void differenceInPlace(instance_ptr self, instance_ptr other);
+    void symmetricDifference(instance_ptr result, instance_ptr left, instance_ptr right);
+    void symmetricDifferenceInPlace(instance_ptr self, instance_ptr other);
     void constructor(instance_ptr self);
     void destroy(instance_ptr self);
     void copy_constructor(instance_ptr self, instance_ptr other);
@@ -66,10 +81,12 @@ class SetType : public Type {
              bool suppressExceptions = false);
     void assign(instance_ptr self, instance_ptr other);
     Type* keyType() const { return m_key_type; }
+    size_t bytesPerElement() const { return m_bytes_per_el; }
 
     // hash_table_layout accessors
     int64_t slotCount(instance_ptr self) const;
     bool slotPopulated(instance_ptr self, size_t offset) const;
+    int64_t nextPopulatedSlot(instance_ptr self, int64_t offset) const;
     instance_ptr keyAtSlot(instance_ptr self, size_t offset) const;
 
     // hand 'visitor' each set element as an instance_ptr.
@@ -78,11 +95,9 @@ class SetType : public Type {
     void visitSetElements(instance_ptr self, visitor_type visitor) {
         hash_table_layout& l = **(hash_table_layout**)self;
 
-        for (long k = 0; k < l.items_reserved; k++) {
-            if (l.items_populated[k]) {
-                if (!visitor(l.items + m_bytes_per_el * k)) {
-                    return;
-                }
+        for (long k = l.nextPopulatedSlot(0); k < l.items_reserved; k = l.nextPopulatedSlot(k + 1)) {
+            if (!visitor(l.items + m_bytes_per_el * k)) {
+                return;
             }
         }
     }
@@ -95,31 +110,31 @@ void deepcopyConcrete(
         hash_table_layout_ptr& destRecordPtr = *(hash_table_layout**)dest;
         hash_table_layout_ptr& srcRecordPtr = *(hash_table_layout**)src;
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcRecordPtr);
+        instance_ptr destPtr;
+        bool isNew;
+
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcRecordPtr, [&]() {
+            return (instance_ptr)hash_table_layout::allocateForDeepcopy(context, this);
+        });
 
-        if (it == context.alreadyAllocated.end()) {
-            destRecordPtr = srcRecordPtr->deepcopy(
-                context,
-                this,
-                m_key_type,
-                nullptr
-            );
+        destRecordPtr = (hash_table_layout_ptr)destPtr;
 
-            context.alreadyAllocated[(instance_ptr)srcRecordPtr] = (instance_ptr)destRecordPtr;
-        } else {
-            destRecordPtr = (hash_table_layout_ptr)context.alreadyAllocated[(instance_ptr)srcRecordPtr];
-            destRecordPtr->refcount++;
+        if (isNew) {
+            srcRecordPtr->deepcopyInto(destRecordPtr, context, m_key_type, nullptr);
         }
+
+        destRecordPtr->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         hash_table_layout& l = **(hash_table_layout**)instance;
 
-        if (alreadyVisited.find((void*)&l) != alreadyVisited.end()) {
+        if (context.visited.contains((void*)&l)) {
             return 0;
         }
 
-        alreadyVisited.insert((void*)&l);
+        context.visited.insert((void*)&l);
+        context.noteRefcount(l.refcount);
 
         if (outSlabs && Slab::slabForAlloc(&l)) {
             outSlabs->insert(Slab::slabForAlloc(&l));
@@ -132,12 +147,12 @@ void deepcopyConcrete(
         res += bytesRequiredForAllocation(l.items_reserved);
 
         // count the hashtable
-        res += bytesRequiredForAllocation(sizeof(int32_t) * l.hash_table_size) * 2;
+        res += l.hashTableFootprint();
 
         if (!m_key_type->isPOD()) {
             for (long k = 0; k < l.items_reserved; k++) {
                 if (l.items_populated[k]) {
-                    res += m_key_type->deepBytecount(l.items + k * m_bytes_per_el, alreadyVisited, outSlabs);
+                    res += m_key_type->deepBytecount(l.items + k * m_bytes_per_el, context, outSlabs);
                 }
             }
         }
@@ -187,49 +202,76 @@ void deepcopyConcrete(
         size_t count = 0;
         size_t id = 0;
         bool wasFromId = false;
-
-        size_t valuesRead = buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
-            [&](size_t fieldNumber, size_t subWireType) {
-                if (fieldNumber == 0) {
-                    assertWireTypesEqual(subWireType, WireType::VARINT);
-                    id = buffer.readUnsignedVarint();
-
-                    void* ptr = buffer.lookupCachedPointer(id);
-
-                    if (ptr) {
-                        *((hash_table_layout**)self) = (hash_table_layout*)ptr;
-                        (*(hash_table_layout**)self)->refcount++;
-                        wasFromId = true;
+        bool constructed = false;
+        size_t itemsRead = 0;
+
+        try {
+            size_t valuesRead = buffer.consumeCompoundMessageWithImpliedFieldNumbers(wireType,
+                [&](size_t fieldNumber, size_t subWireType) {
+                    if (fieldNumber == 0) {
+                        assertWireTypesEqual(subWireType, WireType::VARINT);
+                        id = buffer.readUnsignedVarint();
+
+                        void* ptr = buffer.lookupCachedPointer(id);
+
+                        if (ptr) {
+                            *((hash_table_layout**)self) = (hash_table_layout*)ptr;
+                            (*(hash_table_layout**)self)->refcount++;
+                            wasFromId = true;
+                        }
+                    } else if (wasFromId) {
+                        throw std::runtime_error("Corrupt Set: a memoized Set has contents");
+                    } else if (fieldNumber == 1) {
+                        assertWireTypesEqual(subWireType, WireType::VARINT);
+                        count = buffer.readUnsignedVarint();
+
+                        buffer.chargeAllocation(count, m_bytes_per_el);
+
+                        constructor(self);
+                        constructed = true;
+
+                        hash_table_layout& l = **((hash_table_layout**)self);
+                        buffer.addCachedPointer(id, &l, this);
+                        l.refcount++;
+
+                        l.prepareForDeserialization(count, m_bytes_per_el);
+                    } else {
+                        hash_table_layout& l = **((hash_table_layout**)self);
+
+                        size_t keyIx = fieldNumber - 2;
+
+                        if (keyIx >= count) {
+                            throw std::runtime_error("Corrupt Set: more items than its count");
+                        }
+
+                        m_key_type->deserialize(l.items + m_bytes_per_el * keyIx, buffer, subWireType);
+                        itemsRead++;
                     }
-                } else if (fieldNumber == 1) {
-                    assertWireTypesEqual(subWireType, WireType::VARINT);
-                    count = buffer.readUnsignedVarint();
+            });
 
-                    constructor(self);
-
-                    hash_table_layout& l = **((hash_table_layout**)self);
-                    buffer.addCachedPointer(id, &l, this);
-                    l.refcount++;
-
-                    l.prepareForDeserialization(count, m_bytes_per_el);
-                } else {
-                    hash_table_layout& l = **((hash_table_layout**)self);
-
-                    size_t keyIx = fieldNumber - 2;
-                    m_key_type->deserialize(l.items + m_bytes_per_el * keyIx, buffer, subWireType);
+            if (!wasFromId) {
+                if (!constructed || valuesRead - 2 != count) {
+                    throw std::runtime_error("Invalid Set found.");
                 }
-        });
 
-        if (!wasFromId) {
-            if (valuesRead - 2 != count) {
-                throw std::runtime_error("Invalid Set found.");
+                hash_table_layout& l = **((hash_table_layout**)self);
+                l.buildHashTableAfterDeserialization(
+                    m_bytes_per_el,
+                    [&](instance_ptr ptr) { return m_key_type->hash(ptr); }
+                );
+            }
+        } catch(...) {
+            // drop our reference. The memo keeps its own, and destroys
+            // whatever items we finished when the buffer goes away.
+            if (constructed) {
+                (*(hash_table_layout**)self)->abandonDeserialization(itemsRead);
+            }
+
+            if (constructed || wasFromId) {
+                destroy(self);
             }
 
-            hash_table_layout& l = **((hash_table_layout**)self);
-            l.buildHashTableAfterDeserialization(
-                m_bytes_per_el,
-                [&](instance_ptr ptr) { return m_key_type->hash(ptr); }
-            );
+            throw;
         }
     }
 
@@ -240,4 +282,13 @@ void deepcopyConcrete(
     Type* m_key_type;
     size_t m_bytes_per_el;
     bool subset(instance_ptr left, instance_ptr right);
+
+    // the bucket holding 'key' in 'record', or -1, given the hash 'record' stores for it
+    int64_t findBucketWithHash(hash_table_layout& record, instance_ptr key, typed_python_hash_type hash);
+
+    // insert a copy of 'key', which must not already be in 'record'
+    void insertNewWithHash(hash_table_layout& record, instance_ptr key, typed_python_hash_type hash);
+
+    // remove and destroy the element in 'bucket'
+    void removeBucket(hash_table_layout& record, int64_t bucket);
 };
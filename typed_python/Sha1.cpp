@@ -81,8 +81,8 @@ int mbedtls_sha1_starts_ret( mbedtls_sha1_context *ctx )
     return( 0 );
 }
 
-int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
-                                   const unsigned char data[64] )
+static int sha1_process_scalar( mbedtls_sha1_context *ctx,
+                                const unsigned char data[64] )
 {
     uint32_t temp, W[16], A, B, C, D, E;
 
@@ -240,6 +240,384 @@ int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
     return( 0 );
 }
 
+/*
+ *  typed_python note: hardware implementations of the compression function.
+ *  On x86 we use the SHA extensions (SHA-NI), and on aarch64 the ARMv8 crypto
+ *  extensions. Both are compiled with per-function target attributes, so the
+ *  rest of the module doesn't require them, and we only call them after checking
+ *  at runtime that the CPU supports them.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define TP_SHA1_HAVE_X86_SHA_NI
+
+__attribute__((target("sha,sse4.1")))
+static int sha1_process_x86_sha_ni( mbedtls_sha1_context *ctx,
+                                    const unsigned char data[64] )
+{
+    const __m128i MASK = _mm_set_epi64x( 0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL );
+
+    __m128i ABCD = _mm_loadu_si128( (const __m128i*) ctx->state );
+    __m128i E0 = _mm_set_epi32( ctx->state[4], 0, 0, 0 );
+    ABCD = _mm_shuffle_epi32( ABCD, 0x1B );
+
+    __m128i ABCD_SAVE = ABCD;
+    __m128i E0_SAVE = E0;
+    __m128i E1;
+
+    __m128i MSG0 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*) (data +  0) ), MASK );
+    __m128i MSG1 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*) (data + 16) ), MASK );
+    __m128i MSG2 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*) (data + 32) ), MASK );
+    __m128i MSG3 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*) (data + 48) ), MASK );
+
+    /* rounds 0-3 */
+    E0 = _mm_add_epi32( E0, MSG0 );
+    E1 = ABCD;
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E0, 0 );
+
+    /* rounds 4-7 */
+    E1 = _mm_sha1nexte_epu32( E1, MSG1 );
+    E0 = ABCD;
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E1, 0 );
+    MSG0 = _mm_sha1msg1_epu32( MSG0, MSG1 );
+
+    /* rounds 8-11 */
+    E0 = _mm_sha1nexte_epu32( E0, MSG2 );
+    E1 = ABCD;
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E0, 0 );
+    MSG1 = _mm_sha1msg1_epu32( MSG1, MSG2 );
+    MSG0 = _mm_xor_si128( MSG0, MSG2 );
+
+/* four rounds of 'func', consuming message a and advancing the schedule */
+#define TP_SHA1_ROUNDS(eIn, eOut, a, b, c, d, func)     \
+    eIn = _mm_sha1nexte_epu32( eIn, a );                \
+    eOut = ABCD;                                        \
+    b = _mm_sha1msg2_epu32( b, a );                     \
+    ABCD = _mm_sha1rnds4_epu32( ABCD, eIn, func );      \
+    c = _mm_sha1msg1_epu32( c, a );                     \
+    d = _mm_xor_si128( d, a );
+
+    /* rounds 12-15 */
+    TP_SHA1_ROUNDS( E1, E0, MSG3, MSG0, MSG2, MSG1, 0 );
+    /* rounds 16-19 */
+    TP_SHA1_ROUNDS( E0, E1, MSG0, MSG1, MSG3, MSG2, 0 );
+    /* rounds 20-23 */
+    TP_SHA1_ROUNDS( E1, E0, MSG1, MSG2, MSG0, MSG3, 1 );
+    /* rounds 24-27 */
+    TP_SHA1_ROUNDS( E0, E1, MSG2, MSG3, MSG1, MSG0, 1 );
+    /* rounds 28-31 */
+    TP_SHA1_ROUNDS( E1, E0, MSG3, MSG0, MSG2, MSG1, 1 );
+    /* rounds 32-35 */
+    TP_SHA1_ROUNDS( E0, E1, MSG0, MSG1, MSG3, MSG2, 1 );
+    /* rounds 36-39 */
+    TP_SHA1_ROUNDS( E1, E0, MSG1, MSG2, MSG0, MSG3, 1 );
+    /* rounds 40-43 */
+    TP_SHA1_ROUNDS( E0, E1, MSG2, MSG3, MSG1, MSG0, 2 );
+    /* rounds 44-47 */
+    TP_SHA1_ROUNDS( E1, E0, MSG3, MSG0, MSG2, MSG1, 2 );
+    /* rounds 48-51 */
+    TP_SHA1_ROUNDS( E0, E1, MSG0, MSG1, MSG3, MSG2, 2 );
+    /* rounds 52-55 */
+    TP_SHA1_ROUNDS( E1, E0, MSG1, MSG2, MSG0, MSG3, 2 );
+    /* rounds 56-59 */
+    TP_SHA1_ROUNDS( E0, E1, MSG2, MSG3, MSG1, MSG0, 2 );
+    /* rounds 60-63 */
+    TP_SHA1_ROUNDS( E1, E0, MSG3, MSG0, MSG2, MSG1, 3 );
+    /* rounds 64-67 */
+    TP_SHA1_ROUNDS( E0, E1, MSG0, MSG1, MSG3, MSG2, 3 );
+
+#undef TP_SHA1_ROUNDS
+
+    /* rounds 68-71 */
+    E1 = _mm_sha1nexte_epu32( E1, MSG1 );
+    E0 = ABCD;
+    MSG2 = _mm_sha1msg2_epu32( MSG2, MSG1 );
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E1, 3 );
+    MSG3 = _mm_xor_si128( MSG3, MSG1 );
+
+    /* rounds 72-75 */
+    E0 = _mm_sha1nexte_epu32( E0, MSG2 );
+    E1 = ABCD;
+    MSG3 = _mm_sha1msg2_epu32( MSG3, MSG2 );
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E0, 3 );
+
+    /* rounds 76-79 */
+    E1 = _mm_sha1nexte_epu32( E1, MSG3 );
+    E0 = ABCD;
+    ABCD = _mm_sha1rnds4_epu32( ABCD, E1, 3 );
+
+    E0 = _mm_sha1nexte_epu32( E0, E0_SAVE );
+    ABCD = _mm_add_epi32( ABCD, ABCD_SAVE );
+
+    ABCD = _mm_shuffle_epi32( ABCD, 0x1B );
+    _mm_storeu_si128( (__m128i*) ctx->state, ABCD );
+    ctx->state[4] = _mm_extract_epi32( E0, 3 );
+
+    return( 0 );
+}
+
+static bool sha1_cpu_has_x86_sha_ni()
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+        return false;
+
+    /* SSSE3 and SSE4.1 */
+    if( !( ecx & ( 1 << 9 ) ) || !( ecx & ( 1 << 19 ) ) )
+        return false;
+
+    if( __get_cpuid_max( 0, nullptr ) < 7 )
+        return false;
+
+    __cpuid_count( 7, 0, eax, ebx, ecx, edx );
+
+    /* SHA */
+    return ( ebx & ( 1 << 29 ) ) != 0;
+}
+
+#endif
+
+#if defined(__aarch64__) && defined(__GNUC__) && defined(__linux__)
+
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+
+#define TP_SHA1_HAVE_ARM_CRYPTO
+
+__attribute__((target("+crypto")))
+static int sha1_process_arm_crypto( mbedtls_sha1_context *ctx,
+                                    const unsigned char data[64] )
+{
+    uint32x4_t ABCD = vld1q_u32( ctx->state );
+    uint32_t E0 = ctx->state[4];
+
+    uint32x4_t ABCD_SAVE = ABCD;
+    uint32_t E0_SAVE = E0;
+    uint32_t E1;
+
+    uint32x4_t MSG0 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data +  0 ) ) );
+    uint32x4_t MSG1 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 16 ) ) );
+    uint32x4_t MSG2 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 32 ) ) );
+    uint32x4_t MSG3 = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 48 ) ) );
+
+    const uint32x4_t K0 = vdupq_n_u32( 0x5A827999 );
+    const uint32x4_t K1 = vdupq_n_u32( 0x6ED9EBA1 );
+    const uint32x4_t K2 = vdupq_n_u32( 0x8F1BBCDC );
+    const uint32x4_t K3 = vdupq_n_u32( 0xCA62C1D6 );
+
+    uint32x4_t TMP0 = vaddq_u32( MSG0, K0 );
+    uint32x4_t TMP1 = vaddq_u32( MSG1, K0 );
+
+    /* rounds 0-3 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1cq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG2, K0 );
+    MSG0 = vsha1su0q_u32( MSG0, MSG1, MSG2 );
+
+    /* rounds 4-7 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1cq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG3, K0 );
+    MSG0 = vsha1su1q_u32( MSG0, MSG3 );
+    MSG1 = vsha1su0q_u32( MSG1, MSG2, MSG3 );
+
+    /* rounds 8-11 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1cq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG0, K0 );
+    MSG1 = vsha1su1q_u32( MSG1, MSG0 );
+    MSG2 = vsha1su0q_u32( MSG2, MSG3, MSG0 );
+
+    /* rounds 12-15 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1cq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG1, K1 );
+    MSG2 = vsha1su1q_u32( MSG2, MSG1 );
+    MSG3 = vsha1su0q_u32( MSG3, MSG0, MSG1 );
+
+    /* rounds 16-19 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1cq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG2, K1 );
+    MSG3 = vsha1su1q_u32( MSG3, MSG2 );
+    MSG0 = vsha1su0q_u32( MSG0, MSG1, MSG2 );
+
+    /* rounds 20-23 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG3, K1 );
+    MSG0 = vsha1su1q_u32( MSG0, MSG3 );
+    MSG1 = vsha1su0q_u32( MSG1, MSG2, MSG3 );
+
+    /* rounds 24-27 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG0, K1 );
+    MSG1 = vsha1su1q_u32( MSG1, MSG0 );
+    MSG2 = vsha1su0q_u32( MSG2, MSG3, MSG0 );
+
+    /* rounds 28-31 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG1, K1 );
+    MSG2 = vsha1su1q_u32( MSG2, MSG1 );
+    MSG3 = vsha1su0q_u32( MSG3, MSG0, MSG1 );
+
+    /* rounds 32-35 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG2, K2 );
+    MSG3 = vsha1su1q_u32( MSG3, MSG2 );
+    MSG0 = vsha1su0q_u32( MSG0, MSG1, MSG2 );
+
+    /* rounds 36-39 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG3, K2 );
+    MSG0 = vsha1su1q_u32( MSG0, MSG3 );
+    MSG1 = vsha1su0q_u32( MSG1, MSG2, MSG3 );
+
+    /* rounds 40-43 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1mq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG0, K2 );
+    MSG1 = vsha1su1q_u32( MSG1, MSG0 );
+    MSG2 = vsha1su0q_u32( MSG2, MSG3, MSG0 );
+
+    /* rounds 44-47 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1mq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG1, K2 );
+    MSG2 = vsha1su1q_u32( MSG2, MSG1 );
+    MSG3 = vsha1su0q_u32( MSG3, MSG0, MSG1 );
+
+    /* rounds 48-51 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1mq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG2, K2 );
+    MSG3 = vsha1su1q_u32( MSG3, MSG2 );
+    MSG0 = vsha1su0q_u32( MSG0, MSG1, MSG2 );
+
+    /* rounds 52-55 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1mq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG3, K3 );
+    MSG0 = vsha1su1q_u32( MSG0, MSG3 );
+    MSG1 = vsha1su0q_u32( MSG1, MSG2, MSG3 );
+
+    /* rounds 56-59 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1mq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG0, K3 );
+    MSG1 = vsha1su1q_u32( MSG1, MSG0 );
+    MSG2 = vsha1su0q_u32( MSG2, MSG3, MSG0 );
+
+    /* rounds 60-63 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG1, K3 );
+    MSG2 = vsha1su1q_u32( MSG2, MSG1 );
+    MSG3 = vsha1su0q_u32( MSG3, MSG0, MSG1 );
+
+    /* rounds 64-67 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E0, TMP0 );
+    TMP0 = vaddq_u32( MSG2, K3 );
+    MSG3 = vsha1su1q_u32( MSG3, MSG2 );
+    MSG0 = vsha1su0q_u32( MSG0, MSG1, MSG2 );
+
+    /* rounds 68-71 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E1, TMP1 );
+    TMP1 = vaddq_u32( MSG3, K3 );
+    MSG0 = vsha1su1q_u32( MSG0, MSG3 );
+
+    /* rounds 72-75 */
+    E1 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E0, TMP0 );
+
+    /* rounds 76-79 */
+    E0 = vsha1h_u32( vgetq_lane_u32( ABCD, 0 ) );
+    ABCD = vsha1pq_u32( ABCD, E1, TMP1 );
+
+    E0 = E0 + E0_SAVE;
+    ABCD = vaddq_u32( ABCD_SAVE, ABCD );
+
+    vst1q_u32( ctx->state, ABCD );
+    ctx->state[4] = E0;
+
+    return( 0 );
+}
+
+static bool sha1_cpu_has_arm_crypto()
+{
+    return ( getauxval( AT_HWCAP ) & HWCAP_SHA1 ) != 0;
+}
+
+#endif
+
+typedef int (*sha1_process_fn)( mbedtls_sha1_context *, const unsigned char[64] );
+
+static sha1_process_fn sha1_pick_implementation( const char** name )
+{
+    /* TP_SHA1_NO_HW lets us check the portable implementation on hardware that has the extensions */
+    const char* noHw = getenv( "TP_SHA1_NO_HW" );
+
+    if( !noHw || !noHw[0] )
+    {
+#ifdef TP_SHA1_HAVE_X86_SHA_NI
+        if( sha1_cpu_has_x86_sha_ni() )
+        {
+            *name = "x86-sha-ni";
+            return sha1_process_x86_sha_ni;
+        }
+#endif
+
+#ifdef TP_SHA1_HAVE_ARM_CRYPTO
+        if( sha1_cpu_has_arm_crypto() )
+        {
+            *name = "armv8-crypto";
+            return sha1_process_arm_crypto;
+        }
+#endif
+    }
+
+    *name = "scalar";
+    return sha1_process_scalar;
+}
+
+/* chosen on first use rather than at static-initialization time, since other
+ * static initializers in this module may already need to hash things */
+static sha1_process_fn sha1_implementation( const char** name )
+{
+    static const char* implName = nullptr;
+    static const sha1_process_fn impl = sha1_pick_implementation( &implName );
+
+    if( name )
+        *name = implName;
+
+    return impl;
+}
+
+const char* mbedtls_sha1_implementation()
+{
+    const char* name;
+    sha1_implementation( &name );
+    return name;
+}
+
+int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
+                                   const unsigned char data[64] )
+{
+    return sha1_implementation( nullptr )( ctx, data );
+}
+
 /*
  * SHA-1 process buffer
  */
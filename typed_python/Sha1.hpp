@@ -155,3 +155,13 @@ int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
 int mbedtls_sha1_ret( const unsigned char *input,
                       size_t ilen,
                       unsigned char output[20] );
+
+/**
+ * \brief          The name of the SHA-1 compression function in use:
+ *                 "x86-sha-ni", "armv8-crypto" or "scalar".
+ *
+ *                 typed_python picks a hardware implementation at load time
+ *                 if the CPU has one, unless the TP_SHA1_NO_HW environment
+ *                 variable is set.
+ */
+const char* mbedtls_sha1_implementation();
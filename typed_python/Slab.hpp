@@ -21,6 +21,9 @@
 #include <atomic>
 #include <cstddef>
 #include <map>
+#include <chrono>
+
+#include "Memory.hpp"
 
 class Type;
 
@@ -43,6 +46,13 @@ Models a contiguous block of memory with an embedded
 typed python object graph. Objects within the graph cannot be modified, and are
 released when no references are held to the slab.
 
+A 'shared' slab keeps its data in a MAP_SHARED mapping, so processes forked after it's
+built see the same physical pages rather than copy-on-write copies of them. Refcounts
+inside the slab are then shared between those processes (they're atomic, so this is
+safe), and reading the slab from a worker never makes a private copy of its pages.
+Pointers inside the slab are absolute, and point at Type objects and at the Slab object
+itself in the creating process's heap, so only processes forked from it can use them.
+
 If you release the reference to the slab and there are still external references to
 any of the internal objects, then undefined behavior will result (probably a crash)
 so don't do that. We will attempt to warn you by throwing an exception (and leaking the
@@ -56,25 +66,46 @@ an undetected reference.
 
 class Slab {
 public:
-    Slab(bool isFreeStoreSlab, size_t slabSize) :
+    Slab(bool isFreeStoreSlab, size_t slabSize, bool isShared=false) :
         mSlabBytecount(0),
         mSlabData(nullptr),
         mAllocationPoint(nullptr),
         mIsFreeStore(isFreeStoreSlab),
+        mIsMapped(false),
+        mIsShared(isShared),
         mRefcount(1),
         mTrackAllocTypes(false),
-        mTag(nullptr)
+        mTag(nullptr),
+        mCreatedAt(now()),
+        mLastTouched(mCreatedAt)
     {
         if (!mIsFreeStore) {
-            if (slabSize > 1024 * 128 && HAVE_MMAP) {
+            if ((slabSize > 1024 * 128 || mIsShared) && HAVE_MMAP) {
                 size_t pageSize = ::getpagesize();
                 // round up to a page.
-                if (slabSize % pageSize) {
+                if (slabSize % pageSize || !slabSize) {
                     slabSize = slabSize + (pageSize - slabSize % pageSize);
                 }
 
-                mSlabData = (instance_ptr)::mmap(NULL, slabSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+                mSlabData = (instance_ptr)::mmap(
+                    NULL,
+                    slabSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_ANONYMOUS | (mIsShared ? MAP_SHARED : MAP_PRIVATE),
+                    -1,
+                    0
+                );
+
+                if (mSlabData == (instance_ptr)MAP_FAILED) {
+                    throw std::runtime_error("Failed to map " + std::to_string(slabSize) + " bytes for a Slab");
+                }
+
+                mIsMapped = true;
             } else {
+                if (mIsShared) {
+                    throw std::runtime_error("Shared slabs need mmap");
+                }
+
                 mSlabData = (instance_ptr)::malloc(slabSize);
             }
 
@@ -105,13 +136,13 @@ public:
             return nullptr;
         }
 
-        return *(Slab**)(p);
+        return (Slab*)(*(int64_t*)p & ~TP_SAMPLED_SLAB_BIT);
     }
 
     ~Slab() {
         if (!mIsFreeStore) {
             if (mSlabData) {
-                if (mSlabBytecount > 1024 * 128 && HAVE_MMAP) {
+                if (mIsMapped) {
                     ::munmap(mSlabData, mSlabBytecount);
                 } else {
                     ::free(mSlabData);
@@ -160,16 +191,67 @@ public:
         return mRefcount;
     }
 
+    // seconds since the epoch
+    static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    double createdAt() const {
+        return mCreatedAt;
+    }
+
+    // when someone last said they were using the slab (see 'touch'). Caches use
+    // this to decide what's cold.
+    double lastTouched() const {
+        return mLastTouched.load();
+    }
+
+    void touch() {
+        mLastTouched.store(now());
+    }
+
+    // is our data a mapping of whole pages we can madvise?
+    bool isMapped() const {
+        return mIsMapped;
+    }
+
+    // is our data shared with processes we fork? See the comment at the top.
+    bool isShared() const {
+        return mIsShared;
+    }
+
+    // tell the kernel our pages are cold: they're first in line to be reclaimed
+    // (MADV_COLD), or, if 'pageout', reclaim them now (MADV_PAGEOUT). The data
+    // is kept either way, and faulted back in when it's next touched. Returns
+    // false if the slab isn't mapped, or the kernel doesn't support it.
+    bool adviseCold(bool pageout) {
+        if (!isMapped()) {
+            return false;
+        }
+
+#if defined(MADV_COLD) && defined(MADV_PAGEOUT)
+        return ::madvise(mSlabData, mSlabBytecount, pageout ? MADV_PAGEOUT : MADV_COLD) == 0;
+#else
+        return false;
+#endif
+    }
+
     bool isEmpty() {
         return mSlabData == nullptr;
     }
 
+    bool isFreeStore() const {
+        return mIsFreeStore;
+    }
+
     size_t getBytecount() {
         return mSlabBytecount;
     }
 
     size_t getAllocated() {
-        return mAllocationPoint - mSlabData;
+        return mAllocationPoint.load() - mSlabData;
     }
 
     static std::atomic<int64_t>& totalBytesAllocatedInSlabs() {
@@ -185,25 +267,69 @@ public:
                 return nullptr;
             }
 
-            if (bytes % sizeof(std::max_align_t)) {
-                bytes = bytes + sizeof(std::max_align_t) - (bytes % sizeof(std::max_align_t));
-            }
+            void* res = tryAllocate(bytes, t, __builtin_return_address(0));
 
-            if (mAllocationPoint + bytes > mSlabData + mSlabBytecount) {
+            if (!res) {
                 throw std::runtime_error("Slab ran out of data.");
             }
 
-            incref();
+            return res;
+        }
+    }
 
-            void* res = mAllocationPoint + sizeof(std::max_align_t);
-            ((Slab**)mAllocationPoint)[0] = this;
+    static size_t roundedBytes(size_t bytes) {
+        if (bytes % sizeof(std::max_align_t)) {
+            return bytes + sizeof(std::max_align_t) - (bytes % sizeof(std::max_align_t));
+        }
 
-            mAllocationPoint += bytes + sizeof(std::max_align_t);
+        return bytes;
+    }
 
-            markAllocation(t, res);
+    // bump-allocate 'bytes' out of the slab, returning nullptr if there's not
+    // enough room left. Only valid on non-free-store slabs. Several threads may
+    // allocate out of the same slab at once. 'site' is the caller to blame if
+    // the allocation is sampled (see Memory.hpp).
+    void* tryAllocate(size_t bytes, Type* t, void* site = nullptr) {
+        bytes = roundedBytes(bytes);
 
-            return res;
+        instance_ptr allocationPoint = mAllocationPoint.load();
+
+        do {
+            if (allocationPoint + bytes + sizeof(std::max_align_t) > mSlabData + mSlabBytecount) {
+                return nullptr;
+            }
+        } while (!mAllocationPoint.compare_exchange_weak(
+            allocationPoint,
+            allocationPoint + bytes + sizeof(std::max_align_t)
+        ));
+
+        incref();
+
+        void* res = allocationPoint + sizeof(std::max_align_t);
+        ((Slab**)allocationPoint)[0] = this;
+
+        markAllocation(t, res);
+
+        if (tpCountAllocationForSampling(bytes)
+                && tpTakeSample(res, bytes, t ? t : tpCurrentAllocationType, site)) {
+            ((int64_t*)allocationPoint)[0] |= TP_SAMPLED_SLAB_BIT;
+        }
+
+        return res;
+    }
+
+    // resize the allocation 'data' (of 'oldBytes') in place, which we can only do
+    // if it's the most recent allocation in the slab and there's room after it.
+    // Returns false if we couldn't. Only valid on non-free-store slabs.
+    bool tryReallocate(void* data, size_t oldBytes, size_t newBytes) {
+        instance_ptr end = (instance_ptr)data + roundedBytes(oldBytes);
+        instance_ptr newEnd = (instance_ptr)data + roundedBytes(newBytes);
+
+        if (newEnd > mSlabData + mSlabBytecount) {
+            return false;
         }
+
+        return mAllocationPoint.compare_exchange_strong(end, newEnd);
     }
 
     // if mTrackAllocTypes is enabled
@@ -275,10 +401,16 @@ private:
     instance_ptr mSlabData;
 
     // the allocation point within the slab
-    instance_ptr mAllocationPoint;
+    std::atomic<instance_ptr> mAllocationPoint;
 
     bool mIsFreeStore;
 
+    // our data is an mmap of whole pages, which we munmap rather than free
+    bool mIsMapped;
+
+    // our mapping is MAP_SHARED
+    bool mIsShared;
+
     bool mTrackAllocTypes;
 
     std::mutex mAllocMutex;
@@ -288,4 +420,8 @@ private:
     std::unordered_set<void*> mAliveAllocs;
 
     PyObject* mTag;
+
+    double mCreatedAt;
+
+    std::atomic<double> mLastTouched;
 };
@@ -0,0 +1,353 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*********
+Substring search over arrays of 1, 2 or 4 byte codepoints, shared by
+StringType (at each of its codepoint widths) and BytesType.
+
+Short needles use a vectorized first/last-codepoint filter: we compare
+a block of haystack positions against the needle's first codepoint, and
+the block 'needleLen - 1' further along against its last codepoint, and
+only run a full comparison at positions where both match. Long needles,
+where a full comparison can get expensive on repetitive text, use the
+Two-Way algorithm, which is linear in the haystack size.
+
+All offsets are relative to 'hay', and -1 means 'not found'.
+
+'splitWhitespace' and 'rsplitWhitespace' hold the logic of splitting on
+runs of whitespace, leaving it to the caller to say how to find them.
+*********/
+
+namespace StringSearch {
+
+// needles longer than this go to Two-Way in 'find'
+const int64_t TWO_WAY_MIN_NEEDLE = 32;
+
+#if defined(__SSE2__)
+
+template<int width>
+class SimdLanes;
+
+template<>
+class SimdLanes<1> {
+public:
+    static __m128i splat(uint32_t c) { return _mm_set1_epi8((char)c); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+};
+
+template<>
+class SimdLanes<2> {
+public:
+    static __m128i splat(uint32_t c) { return _mm_set1_epi16((short)c); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+};
+
+template<>
+class SimdLanes<4> {
+public:
+    static __m128i splat(uint32_t c) { return _mm_set1_epi32((int)c); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+};
+
+// a movemask with one bit per byte for each of the 'LANES' positions
+// starting at 'hay' where both the first and last codepoints of the
+// needle match. Each matching position sets 'sizeof(T)' adjacent bits.
+template<class T>
+inline uint32_t candidateMask(const T* hay, int64_t needleLen, __m128i first, __m128i last) {
+    typedef SimdLanes<sizeof(T)> lanes;
+
+    __m128i blockFirst = _mm_loadu_si128((const __m128i*)hay);
+    __m128i blockLast = _mm_loadu_si128((const __m128i*)(hay + needleLen - 1));
+
+    return _mm_movemask_epi8(
+        _mm_and_si128(lanes::eq(first, blockFirst), lanes::eq(last, blockLast))
+    );
+}
+
+#endif
+
+// does 'needle' occur at 'hay', given that its first codepoint already matches?
+template<class T>
+inline bool matchesAt(const T* hay, const T* needle, int64_t needleLen) {
+    return memcmp(hay + 1, needle + 1, (needleLen - 1) * sizeof(T)) == 0;
+}
+
+// the Two-Way algorithm of Crochemore and Perrin, following the
+// structure of musl's memmem. We skip musl's bad-character shift table,
+// which would need one entry per possible codepoint.
+template<class T>
+int64_t twoWayFind(const T* hay, int64_t hayLen, const T* needle, int64_t needleLen) {
+    // these are deliberately unsigned: 'ip' starts at -1 and relies on wrapping
+    size_t l = needleLen;
+    size_t ip, jp, k, p, ms, p0, mem, mem0;
+
+    // compute the maximal suffix under '<'
+    ip = -1; jp = 0; k = p = 1;
+    while (jp + k < l) {
+        if (needle[ip + k] == needle[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (needle[ip + k] > needle[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    ms = ip;
+    p0 = p;
+
+    // and under '>'
+    ip = -1; jp = 0; k = p = 1;
+    while (jp + k < l) {
+        if (needle[ip + k] == needle[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (needle[ip + k] < needle[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    // the critical factorization is whichever suffix is longer
+    if (ip + 1 > ms + 1) {
+        ms = ip;
+    } else {
+        p = p0;
+    }
+
+    // if the needle isn't periodic, we can't remember a matched prefix
+    // across shifts, and we can shift by more than the period.
+    if (memcmp(needle, needle + p, (ms + 1) * sizeof(T))) {
+        mem0 = 0;
+        p = std::max(ms, l - ms - 1) + 1;
+    } else {
+        mem0 = l - p;
+    }
+    mem = 0;
+
+    size_t pos = 0;
+    while (pos + l <= (size_t)hayLen) {
+        // compare the right half
+        for (k = std::max(ms + 1, mem); k < l && needle[k] == hay[pos + k]; k++);
+
+        if (k < l) {
+            pos += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        // compare the left half
+        for (k = ms + 1; k > mem && needle[k - 1] == hay[pos + k - 1]; k--);
+
+        if (k <= mem) {
+            return pos;
+        }
+
+        pos += p;
+        mem = mem0;
+    }
+
+    return -1;
+}
+
+template<class T>
+int64_t find(const T* hay, int64_t hayLen, const T* needle, int64_t needleLen) {
+    if (needleLen == 0) {
+        return 0;
+    }
+
+    if (needleLen > hayLen) {
+        return -1;
+    }
+
+    if (sizeof(T) == 1 && needleLen == 1) {
+        const void* res = memchr(hay, needle[0], hayLen);
+        return res ? (const T*)res - hay : -1;
+    }
+
+    if (needleLen > TWO_WAY_MIN_NEEDLE) {
+        return twoWayFind(hay, hayLen, needle, needleLen);
+    }
+
+    int64_t lastStart = hayLen - needleLen;
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    const int64_t LANES = 16 / sizeof(T);
+
+    __m128i first = SimdLanes<sizeof(T)>::splat(needle[0]);
+    __m128i last = SimdLanes<sizeof(T)>::splat(needle[needleLen - 1]);
+
+    for (; i + LANES - 1 <= lastStart; i += LANES) {
+        uint32_t mask = candidateMask(hay + i, needleLen, first, last);
+
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+
+            if (matchesAt(hay + i + bit / sizeof(T), needle, needleLen)) {
+                return i + bit / sizeof(T);
+            }
+
+            mask &= ~(((1u << sizeof(T)) - 1) << bit);
+        }
+    }
+#endif
+
+    for (; i <= lastStart; i++) {
+        if (hay[i] == needle[0] && matchesAt(hay + i, needle, needleLen)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+template<class T>
+int64_t rfind(const T* hay, int64_t hayLen, const T* needle, int64_t needleLen) {
+    if (needleLen == 0) {
+        return hayLen;
+    }
+
+    if (needleLen > hayLen) {
+        return -1;
+    }
+
+    // the highest start position we haven't checked yet
+    int64_t i = hayLen - needleLen;
+
+#if defined(__SSE2__)
+    const int64_t LANES = 16 / sizeof(T);
+
+    __m128i first = SimdLanes<sizeof(T)>::splat(needle[0]);
+    __m128i last = SimdLanes<sizeof(T)>::splat(needle[needleLen - 1]);
+
+    for (; i - LANES + 1 >= 0; i -= LANES) {
+        int64_t blockStart = i - LANES + 1;
+        uint32_t mask = candidateMask(hay + blockStart, needleLen, first, last);
+
+        while (mask) {
+            int lane = (31 - __builtin_clz(mask)) / sizeof(T);
+
+            if (matchesAt(hay + blockStart + lane, needle, needleLen)) {
+                return blockStart + lane;
+            }
+
+            mask &= ~(((1u << sizeof(T)) - 1) << (lane * sizeof(T)));
+        }
+    }
+#endif
+
+    for (; i >= 0; i--) {
+        if (hay[i] == needle[0] && matchesAt(hay + i, needle, needleLen)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// the number of non-overlapping occurrences of a non-empty 'needle'
+template<class T>
+int64_t count(const T* hay, int64_t hayLen, const T* needle, int64_t needleLen) {
+    int64_t res = 0;
+    int64_t pos = 0;
+
+    while (true) {
+        int64_t next = find(hay + pos, hayLen - pos, needle, needleLen);
+
+        if (next < 0) {
+            return res;
+        }
+
+        res++;
+        pos += next + needleLen;
+    }
+}
+
+// the pieces that str.split() and bytes.split() make with no separator:
+// the runs of non-whitespace among the 'len' codepoints of a string, in
+// order, passed to 'emit(start, end)'. After 'max' pieces (unless it's
+// negative) the rest of the string, less its leading whitespace, is the
+// last piece. 'scanner' says where whitespace is: 'firstSpace(i)' and
+// 'firstNonSpace(i)' look in [i, len) and return 'len' if they find
+// nothing, and 'lastSpace(i)' and 'lastNonSpace(i)' look in [0, i) and
+// return -1.
+template<class scanner_t, class emit_t>
+void splitWhitespace(const scanner_t& scanner, int64_t len, int64_t max, const emit_t& emit) {
+    int64_t count = 0;
+    int64_t cur = scanner.firstNonSpace(0);
+
+    while (cur < len) {
+        if (max >= 0 && count >= max) {
+            emit(cur, len);
+            return;
+        }
+
+        int64_t end = scanner.firstSpace(cur);
+        emit(cur, end);
+        count++;
+
+        cur = scanner.firstNonSpace(end);
+    }
+}
+
+// the same for rsplit(), emitting the pieces from right to left
+template<class scanner_t, class emit_t>
+void rsplitWhitespace(const scanner_t& scanner, int64_t len, int64_t max, const emit_t& emit) {
+    int64_t count = 0;
+    int64_t cur = scanner.lastNonSpace(len) + 1;
+
+    while (cur > 0) {
+        if (max >= 0 && count >= max) {
+            emit(0, cur);
+            return;
+        }
+
+        int64_t start = scanner.lastSpace(cur) + 1;
+        emit(start, cur);
+        count++;
+
+        cur = scanner.lastNonSpace(start) + 1;
+    }
+}
+
+} // end namespace StringSearch
@@ -17,6 +17,13 @@
 #include "AllTypes.hpp"
 #include  <iostream>
 #include "UnicodeProps.hpp"
+#include "StringSearch.hpp"
+#include "AsciiOps.hpp"
+#include "Utf8.hpp"
+#include "NumberParsing.hpp"
+#include <limits>
+#include <mutex>
+#include <unordered_set>
 
 StringType::layout* StringType::upgradeCodePoints(layout* lhs, int32_t newBytesPerCodepoint) {
     if (!lhs) {
@@ -100,6 +107,74 @@ StringType::layout* StringType::concatenate(layout* lhs, layout* rhs) {
     return new_layout;
 }
 
+StringType::layout* StringType::beginBuild(int64_t maxPointcount, int32_t bytesPerCodepoint) {
+    layout* out = (layout*)tp_malloc(sizeof(layout) + maxPointcount * bytesPerCodepoint);
+    out->refcount = 1;
+    out->hash_cache = -1;
+    out->bytes_per_codepoint = bytesPerCodepoint;
+    out->pointcount = 0;
+
+    return out;
+}
+
+template<class dest_t, class src_t>
+static void widenCodepoints(dest_t* dest, const src_t* src, int64_t count) {
+    for (int64_t i = 0; i < count; i++) {
+        dest[i] = src[i];
+    }
+}
+
+void StringType::appendToBuild(layout* out, layout* piece) {
+    if (!piece) {
+        return;
+    }
+
+    uint8_t* dest = out->eltPtr(out->pointcount);
+
+    if (piece->bytes_per_codepoint == out->bytes_per_codepoint) {
+        memcpy(dest, piece->data, piece->pointcount * piece->bytes_per_codepoint);
+    } else if (out->bytes_per_codepoint == 2) {
+        widenCodepoints((uint16_t*)dest, (uint8_t*)piece->data, piece->pointcount);
+    } else if (piece->bytes_per_codepoint == 1) {
+        widenCodepoints((uint32_t*)dest, (uint8_t*)piece->data, piece->pointcount);
+    } else {
+        widenCodepoints((uint32_t*)dest, (uint16_t*)piece->data, piece->pointcount);
+    }
+
+    out->pointcount += piece->pointcount;
+}
+
+void StringType::appendAsciiToBuild(layout* out, const char* data, int64_t count) {
+    uint8_t* dest = out->eltPtr(out->pointcount);
+
+    if (out->bytes_per_codepoint == 1) {
+        memcpy(dest, data, count);
+    } else if (out->bytes_per_codepoint == 2) {
+        widenCodepoints((uint16_t*)dest, (const uint8_t*)data, count);
+    } else {
+        widenCodepoints((uint32_t*)dest, (const uint8_t*)data, count);
+    }
+
+    out->pointcount += count;
+}
+
+StringType::layout* StringType::finishBuild(layout* out, int64_t maxPointcount) {
+    if (!out->pointcount) {
+        tp_free(out);
+        return nullptr;
+    }
+
+    if (out->pointcount < maxPointcount) {
+        out = (layout*)tp_realloc(
+            out,
+            sizeof(layout) + maxPointcount * out->bytes_per_codepoint,
+            sizeof(layout) + out->pointcount * out->bytes_per_codepoint
+        );
+    }
+
+    return out;
+}
+
 // Apply a PyUnicode_* function to each point of a string
 template<class T, class pyunicode_fn>
 inline StringType::layout* unicode_generic(pyunicode_fn& operation, T* data, StringType::layout* l)
@@ -145,11 +220,55 @@ inline StringType::layout* unicode_generic(pyunicode_fn& operation, T* data, Str
     return new_layout;
 }
 
+// if 'l' is all ASCII, return a copy transformed byte-by-byte by 'f', which
+// doesn't need the unicode tables. Otherwise return nullptr.
+static StringType::layout* asciiTransform(StringType::layout* l, void (*f)(const uint8_t*, uint8_t*, int64_t)) {
+    if (l->bytes_per_codepoint != 1 || !AsciiOps::isAscii(l->data, l->pointcount)) {
+        return nullptr;
+    }
+
+    StringType::layout* new_layout = (StringType::layout*)tp_malloc(sizeof(StringType::layout) + l->pointcount);
+    new_layout->refcount = 1;
+    new_layout->hash_cache = -1;
+    new_layout->bytes_per_codepoint = 1;
+    new_layout->pointcount = l->pointcount;
+
+    f(l->data, new_layout->data, l->pointcount);
+
+    return new_layout;
+}
+
+// decide whether every codepoint of a 1-byte string is in ASCII class 'C'
+// without the unicode tables, if we can. Returns false if 'l' has non-ASCII
+// codepoints that the caller needs to look up.
+template<class C>
+static bool asciiAllOf(StringType::layout* l, bool& result) {
+    if (l->bytes_per_codepoint != 1) {
+        return false;
+    }
+
+    if (AsciiOps::all<C>(l->data, l->pointcount)) {
+        result = true;
+        return true;
+    }
+
+    if (AsciiOps::isAscii(l->data, l->pointcount)) {
+        result = false;
+        return true;
+    }
+
+    return false;
+}
+
 StringType::layout* StringType::upper(layout *l) {
     if (!l) {
         return l;
     }
 
+    if (layout* res = asciiTransform(l, AsciiOps::toUpper)) {
+        return res;
+    }
+
     if (l->bytes_per_codepoint == 1) {
         return unicode_generic(_PyUnicode_ToUpperFull, (uint8_t*)(l->data), l);
     }
@@ -167,6 +286,10 @@ StringType::layout* StringType::lower(layout *l) {
         return l;
     }
 
+    if (layout* res = asciiTransform(l, AsciiOps::toLower)) {
+        return res;
+    }
+
     if (l->bytes_per_codepoint == 1) {
         return unicode_generic(_PyUnicode_ToLowerFull, (uint8_t*)(l->data), l);
     }
@@ -184,6 +307,10 @@ StringType::layout* StringType::casefold(layout *l) {
         return l;
     }
 
+    if (layout* res = asciiTransform(l, AsciiOps::toLower)) {
+        return res;
+    }
+
     if (l->bytes_per_codepoint == 1) {
         return unicode_generic(_PyUnicode_ToFoldedFull, (uint8_t*)(l->data), l);
     }
@@ -321,6 +448,10 @@ StringType::layout* StringType::swapcase(layout *l) {
         return l;
     }
 
+    if (layout* res = asciiTransform(l, AsciiOps::swapCase)) {
+        return res;
+    }
+
     if (l->bytes_per_codepoint == 1) {
         return swapcase_generic((uint8_t*)(l->data), l);
     }
@@ -447,6 +578,58 @@ uint32_t StringType::getpoint(layout *l, uint64_t i) {
     return 0;
 }
 
+namespace {
+
+enum class SearchOp { Find, RFind, Count };
+
+template<class T>
+int64_t searchCodepointsAs(SearchOp op, StringType::layout* l, StringType::layout* sub, int64_t start, int64_t hayLen) {
+    const T* hay = (const T*)l->data + start;
+    const T* needle = (const T*)sub->data;
+
+    // the needle has to be at the haystack's width to compare codepoints directly
+    std::vector<T> widened;
+
+    if (sub->bytes_per_codepoint != sizeof(T)) {
+        widened.resize(sub->pointcount);
+
+        for (int64_t k = 0; k < sub->pointcount; k++) {
+            uint32_t c = StringType::getpoint(sub, k);
+
+            if (c > std::numeric_limits<T>::max()) {
+                // a codepoint this wide can't occur in 'l'
+                return op == SearchOp::Count ? 0 : -1;
+            }
+
+            widened[k] = c;
+        }
+
+        needle = &widened[0];
+    }
+
+    if (op == SearchOp::Find) {
+        return StringSearch::find(hay, hayLen, needle, sub->pointcount);
+    }
+    if (op == SearchOp::RFind) {
+        return StringSearch::rfind(hay, hayLen, needle, sub->pointcount);
+    }
+    return StringSearch::count(hay, hayLen, needle, sub->pointcount);
+}
+
+// search for a non-empty 'sub' in the 'hayLen' codepoints of 'l' starting at 'start'.
+// Positions are relative to 'start'.
+int64_t searchCodepoints(SearchOp op, StringType::layout* l, StringType::layout* sub, int64_t start, int64_t hayLen) {
+    if (l->bytes_per_codepoint == 1) {
+        return searchCodepointsAs<uint8_t>(op, l, sub, start, hayLen);
+    }
+    if (l->bytes_per_codepoint == 2) {
+        return searchCodepointsAs<uint16_t>(op, l, sub, start, hayLen);
+    }
+    return searchCodepointsAs<uint32_t>(op, l, sub, start, hayLen);
+}
+
+} // end anonymous namespace
+
 int64_t StringType::find(layout *l, layout *sub, int64_t start, int64_t stop) {
     if (!l || !l->pointcount) {
         if (!sub || !sub->pointcount)
@@ -474,31 +657,9 @@ int64_t StringType::find(layout *l, layout *sub, int64_t start, int64_t stop) {
     if (start < 0 || stop < 0 || start >= stop || sub->pointcount > l->pointcount || start > l->pointcount - sub->pointcount)
         return -1;
 
-    if (l->bytes_per_codepoint == 1 and sub->bytes_per_codepoint == 1 && sub->pointcount == 1) {
-        const uint8_t* lPtr = (const uint8_t*)l->data;
-        const uint8_t subChar = sub->data[0];
-
-        for (int64_t i = start; i < stop; i++) {
-            if (lPtr[i] == subChar) {
-                return i;
-            }
-        }
-        return -1;
-    }
-
-    for (int64_t i = start; i < stop; i++) {
-        bool match = true;
-        for (int64_t j = 0; j < sub->pointcount; j++) {
-            if (getpoint(l, i+j) != getpoint(sub, j)) {
-                match = false;
-                break;
-            }
-        }
-        if (match)
-            return i;
-    }
+    int64_t res = searchCodepoints(SearchOp::Find, l, sub, start, stop - start + sub->pointcount - 1);
 
-    return -1;
+    return res >= 0 ? start + res : -1;
 }
 
 int64_t StringType::rfind(layout *l, layout *sub, int64_t start, int64_t stop) {
@@ -527,32 +688,9 @@ int64_t StringType::rfind(layout *l, layout *sub, int64_t start, int64_t stop) {
     if (start < 0 || stop < 0 || start >= stop || sub->pointcount > l->pointcount || start > l->pointcount - sub->pointcount)
         return -1;
 
-    if (l->bytes_per_codepoint == 1 and sub->bytes_per_codepoint == 1 && sub->pointcount == 1) {
-        const uint8_t* lPtr = (const uint8_t*)l->data;
-        const uint8_t subChar = sub->data[0];
-
-        for (int64_t i = stop - 1; i >= start; i--) {
-            if (lPtr[i] == subChar) {
-                return i;
-            }
-        }
-        return -1;
-    }
-
-    for (int64_t i = stop - 1; i >= start; i--) {
-        bool match = true;
-        for (int64_t j = 0; j < sub->pointcount; j++) {
-            if (getpoint(l, i+j) != getpoint(sub, j)) {
-                match = false;
-                break;
-            }
-        }
-        if (match) {
-            return i;
-            }
-    }
+    int64_t res = searchCodepoints(SearchOp::RFind, l, sub, start, stop - start + sub->pointcount - 1);
 
-    return -1;
+    return res >= 0 ? start + res : -1;
 }
 
 int64_t StringType::count(layout *l, layout *sub, int64_t start, int64_t stop) {
@@ -586,33 +724,71 @@ int64_t StringType::count(layout *l, layout *sub, int64_t start, int64_t stop) {
     if (start < 0 || stop < 0 || start >= stop || sub->pointcount > l->pointcount || start > l->pointcount - sub->pointcount)
         return 0;
 
-    if (l->bytes_per_codepoint == 1 and sub->bytes_per_codepoint == 1 && sub->pointcount == 1) {
-        const uint8_t* lPtr = (const uint8_t*)l->data;
-        const uint8_t subChar = sub->data[0];
+    return searchCodepoints(SearchOp::Count, l, sub, start, stop - start + sub->pointcount - 1);
+}
 
-        for (int64_t i = start; i < stop; i++) {
-            if (lPtr[i] == subChar) {
-                count++;
-            }
-        }
-        return count;
+// how many times 'split(l, sep, max)' will split 'l', for a non-empty 'sep'
+// tells StringSearch::splitWhitespace where the whitespace is in a string
+// of 2 or 4 byte codepoints
+template<class T>
+class UnicodeSpaceScanner {
+public:
+    UnicodeSpaceScanner(const T* data, int64_t len) : m_data(data), m_len(len) {}
+
+    int64_t firstSpace(int64_t i) const {
+        while (i < m_len && !isSpace(m_data[i])) i++;
+        return i;
     }
 
-    for (int64_t i = start; i < stop; i++) {
-        bool match = true;
-        for (int64_t j = 0; j < sub->pointcount; j++) {
-            if (getpoint(l, i+j) != getpoint(sub, j)) {
-                match = false;
-                break;
-            }
-        }
-        if (match) {
-            count++;
-            i += sub->pointcount - 1;
-        }
+    int64_t firstNonSpace(int64_t i) const {
+        while (i < m_len && isSpace(m_data[i])) i++;
+        return i;
     }
 
-    return count;
+    int64_t lastSpace(int64_t i) const {
+        while (i > 0 && !isSpace(m_data[i - 1])) i--;
+        return i - 1;
+    }
+
+    int64_t lastNonSpace(int64_t i) const {
+        while (i > 0 && isSpace(m_data[i - 1])) i--;
+        return i - 1;
+    }
+
+private:
+    static bool isSpace(uint32_t c) {
+        return unicodeProps(c) & Uprops_SPACE;
+    }
+
+    const T* m_data;
+    int64_t m_len;
+};
+
+// call 'f' with the right whitespace scanner for the width of 'l'. One byte
+// codepoints get scanned 16 at a time.
+template<class func_type>
+static void splitWhitespaceAs(StringType::layout* l, const func_type& f) {
+    if (l->bytes_per_codepoint == 1) {
+        f(AsciiOps::SpaceScanner<AsciiOps::Latin1Space>(l->data, l->pointcount));
+    } else if (l->bytes_per_codepoint == 2) {
+        f(UnicodeSpaceScanner<uint16_t>((uint16_t*)l->data, l->pointcount));
+    } else {
+        f(UnicodeSpaceScanner<uint32_t>((uint32_t*)l->data, l->pointcount));
+    }
+}
+
+static void appendSubstr(ListOfType* listofstring, ListOfType::layout* outList, StringType::layout* l, int64_t start, int64_t end) {
+    if (outList->count == outList->reserved) {
+        listofstring->reserve((instance_ptr)&outList, outList->reserved * 1.5 + 1);
+    }
+
+    ((StringType::layout**)outList->data)[outList->count++] = StringType::getsubstr(l, start, end);
+}
+
+static int64_t splitCountFor(StringType::layout* l, StringType::layout* sep, int64_t max) {
+    int64_t res = StringType::count(l, sep, 0, l->pointcount);
+
+    return max >= 0 ? std::min(res, max) : res;
 }
 
 void StringType::split(ListOfType::layout* outList, layout* l, layout* sep, int64_t max) {
@@ -622,7 +798,6 @@ void StringType::split(ListOfType::layout* outList, layout* l, layout* sep, int6
     static ListOfType* listofstring = ListOfType::Make(StringType::Make());
     listofstring->resize((instance_ptr)&outList, 0, 0);
 
-    int64_t sep_bytes_per_codepoint = sep ? sep->bytes_per_codepoint : 1;
     int64_t sep_pointcount = sep ? sep->pointcount : 1;
 
     if (!l || !l->pointcount) {
@@ -631,53 +806,34 @@ void StringType::split(ListOfType::layout* outList, layout* l, layout* sep, int6
         }
         return;
     }
-    int64_t cur = 0;
-    int64_t count = 0;
 
-    listofstring->reserve((instance_ptr)&outList, 10);
+    if (sep) {
+        // count the separators up front, so that we can size the list exactly
+        // and fill it without checking for space.
+        int64_t pieces = 1 + splitCountFor(l, sep, max);
+        int64_t cur = 0;
 
-    while ((count < max || max < 0) && cur < l->pointcount) {
-        int64_t match = cur;
+        listofstring->reserve((instance_ptr)&outList, pieces);
 
-        if (sep && l->bytes_per_codepoint == 1 && sep_bytes_per_codepoint == 1 && sep_pointcount == 1) {
-            while (match < l->pointcount && l->data[match] != sep->data[0]) match++;
-        } else if (sep) {
-            match = find(l, sep, cur, l->pointcount);
-            if (match == -1) match = l->pointcount;
-        } else {
-            while (match < l->pointcount && !(uprops[getpoint(l, match)] & Uprops_SPACE)) match++;
-        }
-        if (match >= l->pointcount) break;
+        for (int64_t k = 0; k + 1 < pieces; k++) {
+            int64_t match = find(l, sep, cur, l->pointcount);
 
-        if (sep || match != cur) {
-            layout* piece = getsubstr(l, cur, match);
-            if (outList->count == outList->reserved) {
-                listofstring->reserve((instance_ptr)&outList, outList->reserved * 1.5);
-            }
-            ((layout**)outList->data)[outList->count++] = piece;
+            ((layout**)outList->data)[outList->count++] = getsubstr(l, cur, match);
 
             cur = match + sep_pointcount;
-
-            count++;
-            if (max >= 0 && count >= max)
-                break;
-        }
-        else if (!sep) {
-            cur++;
-        }
-    }
-    if (!sep) {
-        while (cur < l->pointcount && (uprops[getpoint(l, cur)] & Uprops_SPACE)) {
-            cur++;
-        }
-    }
-    if (sep || cur < l->pointcount || max == 0) {
-        layout* remainder = getsubstr(l, cur, l->pointcount);
-        if (outList->count == outList->reserved) {
-            listofstring->reserve((instance_ptr)&outList, outList->reserved + 1);
         }
-        ((layout**)outList->data)[outList->count++] = remainder;
+
+        ((layout**)outList->data)[outList->count++] = getsubstr(l, cur, l->pointcount);
+        return;
     }
+
+    listofstring->reserve((instance_ptr)&outList, 10);
+
+    splitWhitespaceAs(l, [&](auto scanner) {
+        StringSearch::splitWhitespace(scanner, l->pointcount, max, [&](int64_t start, int64_t end) {
+            appendSubstr(listofstring, outList, l, start, end);
+        });
+    });
 }
 
 void StringType::rsplit(ListOfType::layout* outList, layout* l, layout* sep, int64_t max) {
@@ -687,7 +843,6 @@ void StringType::rsplit(ListOfType::layout* outList, layout* l, layout* sep, int
     static ListOfType* listofstring = ListOfType::Make(StringType::Make());
     listofstring->resize((instance_ptr)&outList, 0, 0);
 
-    int64_t sep_bytes_per_codepoint = sep ? sep->bytes_per_codepoint : 1;
     int64_t sep_pointcount = sep ? sep->pointcount : 1;
 
     if (!l || !l->pointcount) {
@@ -696,53 +851,37 @@ void StringType::rsplit(ListOfType::layout* outList, layout* l, layout* sep, int
         }
         return;
     }
-    int64_t cur = l->pointcount - 1;
-    int64_t count = 0;
 
-    listofstring->reserve((instance_ptr)&outList, 10);
+    if (sep) {
+        // as in 'split', but we find the pieces from the right, so we fill
+        // the list from the back rather than reversing it at the end.
+        int64_t pieces = 1 + splitCountFor(l, sep, max);
 
-    while ((count < max || max < 0) && cur >= 0) {
-        int64_t match = cur;
+        listofstring->reserve((instance_ptr)&outList, pieces);
 
-        if (sep && l->bytes_per_codepoint == 1 && sep_bytes_per_codepoint == 1 && sep_pointcount == 1) {
-            while (match >= 0 && l->data[match] != sep->data[0]) match--;
-        } else if (sep) {
-            match = rfind(l, sep, 0, cur + 1);
-            if (match != -1) match += sep_pointcount - 1;
-        } else {
-            while (match >= 0 && !(uprops[getpoint(l, match)] & Uprops_SPACE)) match--;
-        }
-        if (match < 0) break;
+        int64_t end = l->pointcount;
 
-        if (sep || match != cur) {
-            layout* piece = getsubstr(l, match + 1, cur + 1);
-            if (outList->count == outList->reserved) {
-                listofstring->reserve((instance_ptr)&outList, outList->reserved * 1.5);
-            }
-            ((layout**)outList->data)[outList->count++] = piece;
+        for (int64_t k = pieces - 1; k > 0; k--) {
+            int64_t match = rfind(l, sep, 0, end);
 
-            cur = match - sep_pointcount;
+            ((layout**)outList->data)[k] = getsubstr(l, match + sep_pointcount, end);
 
-            count++;
-            if (max >= 0 && count >= max)
-                break;
-        }
-        else if (!sep) {
-            cur--;
-        }
-    }
-    if (!sep) {
-        while (cur >= 0 && (uprops[getpoint(l, cur)] & Uprops_SPACE)) {
-            cur--;
+            end = match;
         }
+
+        ((layout**)outList->data)[0] = getsubstr(l, 0, end);
+        outList->count = pieces;
+        return;
     }
-    if (sep || cur >= 0 || max == 0) {
-        layout* remainder = getsubstr(l, 0, cur + 1);
-        if (outList->count == outList->reserved) {
-            listofstring->reserve((instance_ptr)&outList, outList->reserved + 1);
-        }
-        ((layout**)outList->data)[outList->count++] = remainder;
-    }
+
+    listofstring->reserve((instance_ptr)&outList, 10);
+
+    splitWhitespaceAs(l, [&](auto scanner) {
+        StringSearch::rsplitWhitespace(scanner, l->pointcount, max, [&](int64_t start, int64_t end) {
+            appendSubstr(listofstring, outList, l, start, end);
+        });
+    });
+
     listofstring->reverse((instance_ptr)&outList);
 }
 
@@ -800,7 +939,6 @@ void StringType::splitlines(ListOfType::layout *outList, layout* in, bool keepen
         if (outList->count == outList->reserved) {
             listOfString->reserve((instance_ptr)&outList, outList->reserved + 1);
         }
-        listOfString->append((instance_ptr)&outList, (instance_ptr)&remainder);
         ((layout**)outList->data)[outList->count++] = remainder;
     }
 }
@@ -809,8 +947,11 @@ void StringType::splitlines(ListOfType::layout *outList, layout* in, bool keepen
 bool StringType::isalpha(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Alpha>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++)
-        if (!(uprops[getpoint(l, i)] & Uprops_ALPHA))
+        if (!(unicodeProps(getpoint(l, i)) & Uprops_ALPHA))
             return false;
     return true;
 }
@@ -818,8 +959,11 @@ bool StringType::isalpha(layout *l) {
 bool StringType::isalnum(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Alnum>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++) {
-        auto flags = uprops[getpoint(l, i)];
+        auto flags = unicodeProps(getpoint(l, i));
         if (!(flags & Uprops_ALPHA)
             && !(flags & Uprops_NUMERIC)
             && !(flags & Uprops_DECIMAL)
@@ -832,8 +976,11 @@ bool StringType::isalnum(layout *l) {
 bool StringType::isdecimal(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Digit>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++)
-        if (!(uprops[getpoint(l, i)] & Uprops_DECIMAL))
+        if (!(unicodeProps(getpoint(l, i)) & Uprops_DECIMAL))
             return false;
     return true;
 }
@@ -841,8 +988,11 @@ bool StringType::isdecimal(layout *l) {
 bool StringType::isdigit(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Digit>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++) {
-        auto flags = uprops[getpoint(l, i)];
+        auto flags = unicodeProps(getpoint(l, i));
         if (!(flags & Uprops_DECIMAL)
             && !(flags & Uprops_DIGIT)) // For completeness; looks to me like DECIMAL is a subset of DIGIT
             return false;
@@ -853,9 +1003,11 @@ bool StringType::isdigit(layout *l) {
 bool StringType::islower(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    if (l->bytes_per_codepoint == 1 && AsciiOps::isAscii(l->data, l->pointcount))
+        return !AsciiOps::any<AsciiOps::Upper>(l->data, l->pointcount) && AsciiOps::any<AsciiOps::Lower>(l->data, l->pointcount);
     bool found_one = false;
     for (int64_t i = 0; i < l->pointcount; i++) {
-        auto flags = uprops[getpoint(l, i)];
+        auto flags = unicodeProps(getpoint(l, i));
         if (flags & Uprops_UPPER)
             return false;
         if (flags & Uprops_TITLE)
@@ -869,8 +1021,11 @@ bool StringType::islower(layout *l) {
 bool StringType::isnumeric(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Digit>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++) {
-        auto flags = uprops[getpoint(l, i)];
+        auto flags = unicodeProps(getpoint(l, i));
         if (!(flags & Uprops_DECIMAL)
             && !(flags & Uprops_DIGIT)
             && !(flags & Uprops_NUMERIC))
@@ -882,8 +1037,11 @@ bool StringType::isnumeric(layout *l) {
 bool StringType::isprintable(layout *l) {
     if (!l || !l->pointcount)
         return true;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Printable>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++)
-        if (!(uprops[getpoint(l, i)] & Uprops_PRINTABLE))
+        if (!(unicodeProps(getpoint(l, i)) & Uprops_PRINTABLE))
             return false;
     return true;
 }
@@ -891,8 +1049,11 @@ bool StringType::isprintable(layout *l) {
 bool StringType::isspace(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    bool asciiResult;
+    if (asciiAllOf<AsciiOps::Space>(l, asciiResult))
+        return asciiResult;
     for (int64_t i = 0; i < l->pointcount; i++)
-        if (!(uprops[getpoint(l, i)] & Uprops_SPACE))
+        if (!(unicodeProps(getpoint(l, i)) & Uprops_SPACE))
             return false;
     return true;
 }
@@ -903,7 +1064,7 @@ bool StringType::istitle(layout *l) {
     bool last_cased = false;
     bool found_one = false;
     for (int64_t i = 0; i < l->pointcount; i++) {
-        auto flags = uprops[getpoint(l, i)];
+        auto flags = unicodeProps(getpoint(l, i));
         bool upper = flags & Uprops_UPPER;
         bool lower = flags & Uprops_LOWER;
         bool title = flags & Uprops_TITLE;
@@ -924,9 +1085,11 @@ bool StringType::istitle(layout *l) {
 bool StringType::isupper(layout *l) {
     if (!l || !l->pointcount)
         return false;
+    if (l->bytes_per_codepoint == 1 && AsciiOps::isAscii(l->data, l->pointcount))
+        return !AsciiOps::any<AsciiOps::Lower>(l->data, l->pointcount) && AsciiOps::any<AsciiOps::Upper>(l->data, l->pointcount);
     bool found_one = false;
     for (int64_t i = 0; i < l->pointcount; i++) {
-        auto flags = uprops[getpoint(l, i)];
+        auto flags = unicodeProps(getpoint(l, i));
         if (flags & Uprops_LOWER)
             return false;
         if (flags & Uprops_TITLE)
@@ -1070,13 +1233,13 @@ StringType::layout* StringType::getsubstr(layout* l, int64_t start, int64_t stop
 template<class elt_type>
 void stripInset_whitespace(int64_t& ioLeftPos, int64_t& ioRightPos, elt_type* data, bool fromLeft, bool fromRight) {
     if (fromLeft) {
-        while (ioLeftPos < ioRightPos && uprops[data[ioLeftPos]] & Uprops_SPACE) {
+        while (ioLeftPos < ioRightPos && unicodeProps(data[ioLeftPos]) & Uprops_SPACE) {
             ioLeftPos++;
         }
     }
 
     if (fromRight) {
-        while (ioLeftPos < ioRightPos && uprops[data[ioRightPos-1]] & Uprops_SPACE) {
+        while (ioLeftPos < ioRightPos && unicodeProps(data[ioRightPos-1]) & Uprops_SPACE) {
             ioRightPos--;
         }
     }
@@ -1118,13 +1281,13 @@ StringType::layout* StringType::strip_whitespace(layout* l, bool fromLeft, bool
 template<class elt_type>
 void stripInset(int64_t& ioLeftPos, int64_t& ioRightPos, elt_type* data, bool fromLeft, bool fromRight) {
     if (fromLeft) {
-        while (ioLeftPos < ioRightPos && uprops[data[ioLeftPos]] & Uprops_SPACE) {
+        while (ioLeftPos < ioRightPos && unicodeProps(data[ioLeftPos]) & Uprops_SPACE) {
             ioLeftPos++;
         }
     }
 
     if (fromRight) {
-        while (ioLeftPos < ioRightPos && uprops[data[ioRightPos-1]] & Uprops_SPACE) {
+        while (ioLeftPos < ioRightPos && unicodeProps(data[ioRightPos-1]) & Uprops_SPACE) {
             ioRightPos--;
         }
     }
@@ -1311,6 +1474,79 @@ StringType::layout* StringType::createFromString(std::string s) {
     return new_layout;
 }
 
+// write the string that 'Utf8::scan' found 'data' holds into 'target', which has room for it
+static void fillFromScannedUtf8(
+    StringType::layout* target,
+    const uint8_t* data,
+    int64_t bytecount,
+    int64_t pointcount,
+    int bytes_per_codepoint
+) {
+    target->hash_cache = -1;
+    target->bytes_per_codepoint = bytes_per_codepoint;
+    target->pointcount = pointcount;
+
+    if (pointcount == bytecount) {
+        // pure ASCII
+        memcpy(target->data, data, bytecount);
+    } else if (bytes_per_codepoint == 1) {
+        Utf8::decode(data, bytecount, (uint8_t*)target->data);
+    } else if (bytes_per_codepoint == 2) {
+        Utf8::decode(data, bytecount, (uint16_t*)target->data);
+    } else {
+        Utf8::decode(data, bytecount, (uint32_t*)target->data);
+    }
+}
+
+bool StringType::tryCreateFromUtf8Bytes(const uint8_t* data, int64_t bytecount, bool allowSurrogates, layout*& out) {
+    int64_t pointcount;
+    int bytes_per_codepoint;
+
+    if (!Utf8::scan(data, bytecount, allowSurrogates, pointcount, bytes_per_codepoint)) {
+        return false;
+    }
+
+    if (!pointcount) {
+        out = nullptr;
+        return true;
+    }
+
+    layout* new_layout = (layout*)tp_malloc(sizeof(layout) + pointcount * bytes_per_codepoint);
+    new_layout->refcount = 1;
+
+    fillFromScannedUtf8(new_layout, data, bytecount, pointcount, bytes_per_codepoint);
+
+    out = new_layout;
+    return true;
+}
+
+bool StringType::tryOverwriteFromUtf8Bytes(layout* target, const uint8_t* data, int64_t bytecount) {
+    int64_t pointcount;
+    int bytes_per_codepoint;
+
+    if (!Utf8::scan(data, bytecount, true, pointcount, bytes_per_codepoint)) {
+        throw std::runtime_error("corrupt utf8 data stream.");
+    }
+
+    if (!pointcount || pointcount * bytes_per_codepoint > target->pointcount * target->bytes_per_codepoint) {
+        return false;
+    }
+
+    fillFromScannedUtf8(target, data, bytecount, pointcount, bytes_per_codepoint);
+
+    return true;
+}
+
+StringType::layout* StringType::createFromUtf8Bytes(const uint8_t* data, int64_t bytecount) {
+    layout* res;
+
+    if (!tryCreateFromUtf8Bytes(data, bytecount, true, res)) {
+        throw std::runtime_error("corrupt utf8 data stream.");
+    }
+
+    return res;
+}
+
 StringType::layout* StringType::createFromUtf8(const char* utfEncodedString, int64_t length) {
     if (!length) {
         return nullptr;
@@ -1360,8 +1596,95 @@ bool StringType::cmp(instance_ptr left, instance_ptr right, int pyComparisonOp,
     return cmpResultToBoolForPyOrdering(pyComparisonOp, cmpStatic(*(layout**)left, *(layout**)right));
 }
 
+namespace {
+
+class StringInternTable {
+public:
+    class Hash {
+    public:
+        size_t operator()(StringType::layout* l) const {
+            return StringType::hash_static((instance_ptr)&l);
+        }
+    };
+
+    class Eq {
+    public:
+        bool operator()(StringType::layout* l, StringType::layout* r) const {
+            return StringType::cmpStaticEq(l, r);
+        }
+    };
+
+    StringType::layout* intern(StringType::layout* l) {
+        // hash outside the lock. This also fills out 'hash_cache', so that
+        // equality checks against the table's strings can short-circuit.
+        StringType::hash_static((instance_ptr)&l);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto it = mStrings.find(l);
+
+        if (it != mStrings.end()) {
+            StringType::layout* res = *it;
+            res->refcount++;
+            StringType::destroyStatic((instance_ptr)&l);
+            return res;
+        }
+
+        // the table keeps its own reference
+        l->refcount++;
+        mStrings.insert(l);
+
+        return l;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        return mStrings.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (auto l: mStrings) {
+            StringType::destroyStatic((instance_ptr)&l);
+        }
+
+        mStrings.clear();
+    }
+
+private:
+    std::mutex mMutex;
+
+    std::unordered_set<StringType::layout*, Hash, Eq> mStrings;
+};
+
+StringInternTable& internTable() {
+    static StringInternTable* table = new StringInternTable();
+    return *table;
+}
+
+} // end anonymous namespace
+
+StringType::layout* StringType::intern(layout* l) {
+    if (!l) {
+        return l;
+    }
+
+    return internTable().intern(l);
+}
+
+size_t StringType::internTableSize() {
+    return internTable().size();
+}
+
+void StringType::clearInternTable() {
+    internTable().clear();
+}
+
 bool StringType::cmpStaticEq(layout* left, layout* right) {
-    if ( !left && !right ) {
+    // interned strings (and copies of the same string) share a layout
+    if (left == right) {
         return true;
     }
     if ( !left && right ) {
@@ -1375,30 +1698,35 @@ bool StringType::cmpStaticEq(layout* left, layout* right) {
         return false;
     }
 
+    // equal strings hash equally regardless of codepoint width, since we
+    // always store a string at its narrowest width
+    if (left->hash_cache != -1 && right->hash_cache != -1 && left->hash_cache != right->hash_cache) {
+        return false;
+    }
+
     int bytesPerLeft = left->bytes_per_codepoint;
     int bytesPerRight = right->bytes_per_codepoint;
     int commonCount = std::min(left->pointcount, right->pointcount);
 
+    // codepoints of the same width are equal exactly when their bytes are
+    if (bytesPerLeft == bytesPerRight) {
+        return memcmp(left->data, right->data, bytesPerLeft * commonCount) == 0;
+    }
+
     char res = 0;
 
-    if (bytesPerLeft == 1 && bytesPerRight == 1) {
-        res = byteCompare(left->data, right->data, bytesPerLeft * commonCount);
-    } else if (bytesPerLeft == 1 && bytesPerRight == 2) {
+    if (bytesPerLeft == 1 && bytesPerRight == 2) {
         res = typedArrayCompare((uint8_t*)left->data, (uint16_t*)right->data, commonCount);
     } else if (bytesPerLeft == 1 && bytesPerRight == 4) {
         res = typedArrayCompare((uint8_t*)left->data, (uint32_t*)right->data, commonCount);
     } else if (bytesPerLeft == 2 && bytesPerRight == 1) {
         res = typedArrayCompare((uint16_t*)left->data, (uint8_t*)right->data, commonCount);
-    } else if (bytesPerLeft == 2 && bytesPerRight == 2) {
-        res = typedArrayCompare((uint16_t*)left->data, (uint16_t*)right->data, commonCount);
     } else if (bytesPerLeft == 2 && bytesPerRight == 4) {
         res = typedArrayCompare((uint16_t*)left->data, (uint32_t*)right->data, commonCount);
     } else if (bytesPerLeft == 4 && bytesPerRight == 1) {
         res = typedArrayCompare((uint32_t*)left->data, (uint8_t*)right->data, commonCount);
     } else if (bytesPerLeft == 4 && bytesPerRight == 2) {
         res = typedArrayCompare((uint32_t*)left->data, (uint16_t*)right->data, commonCount);
-    } else if (bytesPerLeft == 4 && bytesPerRight == 4) {
-        res = typedArrayCompare((uint32_t*)left->data, (uint32_t*)right->data, commonCount);
     } else {
         throw std::runtime_error("Nonsensical bytes-per-codepoint");
     }
@@ -1407,7 +1735,7 @@ bool StringType::cmpStaticEq(layout* left, layout* right) {
 }
 
 char StringType::cmpStatic(layout* left, layout* right) {
-    if ( !left && !right ) {
+    if (left == right) {
         return 0;
     }
     if ( !left && right ) {
@@ -1753,195 +2081,58 @@ void StringType::join(StringType::layout **outString, StringType::layout *separa
 
 // static
 bool StringType::to_int64(StringType::layout* s, int64_t *value) {
-    enum State {left_space, sign, digit, underscore, right_space, failed} state = left_space;
-    int64_t value_sign = 1;
     *value = 0;
 
-    if (s) {
-        for (int64_t i = 0; i < s->pointcount; i++) {
-            uint64_t c = StringType::getpoint(s, i);
-            if (uprops[c] & Uprops_SPACE) {
-                if (state == underscore || state == sign) {
-                    state = failed;
-                    break;
-                }
-                else if (state == digit) {
-                    state = right_space;
-                }
-            }
-            else if (c == '+' || c == '-') {
-                if (state != left_space) {
-                    state = failed;
-                    break;
-                }
-                if (c == '-') {
-                    value_sign = -1;
-                }
-                state = sign;
-            }
-            else if (c < 128 && c >= '0' && c <= '9') {
-                if (state == right_space) {
-                    state = failed;
-                    break;
-                }
-                *value *= 10;
-                *value += c - '0';
-                state = digit;
-            }
-            else if (c == '_') {
-                if (state != digit) {
-                    state = failed;
-                    break;
-                }
-                state = underscore;
-            }
-            else {
-                state = failed;
-                break;
-            }
-        }
-    }
-    if (state == digit || state == right_space) {
-        *value *= value_sign;
-        return true;
-    }
-    else {
+    bool ok = s && (
+        s->bytes_per_codepoint == 1 ? NumberParsing::parseInt((uint8_t*)s->data, s->pointcount, *value) :
+        s->bytes_per_codepoint == 2 ? NumberParsing::parseInt((uint16_t*)s->data, s->pointcount, *value) :
+                                      NumberParsing::parseInt((uint32_t*)s->data, s->pointcount, *value)
+    );
+
+    if (!ok) {
         *value = 0;
-        return false;
     }
+
+    return ok;
 }
 
 // static
 bool StringType::to_float64(StringType::layout* s, double* value) {
-    enum State {left_space, sign, whole, underscore, decimal, mantissa, underscore_mantissa,
-                exp, expsign, exponent, underscore_exponent,
-                right_space, identifier, identifier_right_space, failed} state = left_space;
-    const int MAX_FLOAT_STR = 48;
-    char buf[MAX_FLOAT_STR + 1];
-    int cur = 0;
     *value = 0.0;
 
-    if (s) {
-        for (int64_t i = 0; i < s->pointcount; i++) {
-            bool accumulate = true;
-            uint64_t c = StringType::getpoint(s, i);
-            if (uprops[c] & Uprops_SPACE) {
-                accumulate = false;
-                if (state == underscore || state == underscore_exponent || state == underscore_mantissa
-                        || state == sign || state == exp || state == expsign) {
-                    state = failed;
-                }
-                else if (state == identifier || state == identifier_right_space) {
-                    state = identifier_right_space;
-                }
-                else if (state == right_space || state == whole || state == decimal || state == mantissa || state == exponent) {
-                    state = right_space;
-                }
-            }
-            else if (c == '+' || c == '-') {
-                if (state == left_space) {
-                    state = sign;
-                }
-                else if (state == exp) {
-                    state = expsign;
-                }
-                else {
-                    state = failed;
-                }
-            }
-            else if (c < 128 && c >= '0' && c <= '9') {
-                if (state == decimal) {
-                    state = mantissa;
-                }
-                else if (state == exp) {
-                    state = exponent;
-                }
-                else if (state == right_space || state == identifier || state == identifier_right_space) {
-                    state = failed;
-                }
-                else if (state == underscore_mantissa) {
-                    state = mantissa;
-                }
-                else if (state == underscore_exponent) {
-                    state = exponent;
-                }
-                else {
-                    state = whole;
-                }
-            }
-            else if (c == '.') {
-                if (state == left_space || state == sign || state == whole) {
-                    state = decimal;
-                }
-                else {
-                    state = failed;
-                }
-            }
-            else if (c == 'e' || c == 'E') {
-                if (state == whole || state == decimal || state == mantissa) {
-                    state = exp;
-                }
-                else {
-                    state = failed;
-                }
-            }
-            else if (c == '_') {
-                accumulate = false;
-                if (state == whole) {
-                    state = underscore;
-                }
-                else if (state == mantissa) {
-                    state = underscore_mantissa;
-                }
-                else if (state == exponent) {
-                    state = underscore_exponent;
-                }
-                else {
-                    state = failed;
-                }
-            }
-            else if (c < 128) {
-                if (state == left_space || state == sign || state == identifier) {
-                    state = identifier;
-                }
-                else {
-                    state = failed;
-                }
-            }
-            else {
-                state = failed;
-            }
-            if (state == failed) {
-                break;
-            }
-            if (accumulate && cur < MAX_FLOAT_STR) {
-                buf[cur++] = c;
-            }
-        }
+    bool ok = s && (
+        s->bytes_per_codepoint == 1 ? NumberParsing::parseFloat((uint8_t*)s->data, s->pointcount, *value) :
+        s->bytes_per_codepoint == 2 ? NumberParsing::parseFloat((uint16_t*)s->data, s->pointcount, *value) :
+                                      NumberParsing::parseFloat((uint32_t*)s->data, s->pointcount, *value)
+    );
+
+    if (!ok) {
+        *value = 0.0;
     }
-    buf[cur] = 0;
-    if (state == identifier || state == identifier_right_space) {
-        char* start = buf;
-        if (*start == '+' || *start == '-') {
-            start++;
-        }
-        for (char* p = start; *p; p++) {
-            *p = tolower(*p);
-        }
-        if (strcmp(start, "inf") && strcmp(start, "infinity") && strcmp(start, "nan")) {
-            state = failed;
+
+    return ok;
+}
+
+// static
+int64_t StringType::to_int64_column(layout** strings, int64_t count, int64_t* out) {
+    for (int64_t i = 0; i < count; i++) {
+        if (!to_int64(strings[i], out + i)) {
+            return i;
         }
     }
-    if (state == whole || state == decimal || state == mantissa || state == exponent || state == right_space
-            || state == identifier || state == identifier_right_space) {
-        char* endptr;
-        *value = strtod(buf, &endptr);
-        return true;
-    }
-    else {
-        *value = 0.0;
-        return false;
+
+    return -1;
+}
+
+// static
+int64_t StringType::to_float64_column(layout** strings, int64_t count, double* out) {
+    for (int64_t i = 0; i < count; i++) {
+        if (!to_float64(strings[i], out + i)) {
+            return i;
+        }
     }
+
+    return -1;
 }
 
 StringType::layout* StringType::mult(layout* lhs, int64_t rhs) {
@@ -23,7 +23,7 @@ class StringType : public Type {
 public:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         typed_python_hash_type hash_cache;
         int32_t pointcount;
         int32_t bytes_per_codepoint; //1 implies
@@ -64,6 +64,19 @@ public:
     //return an increffed concatenated layout of lhs and rhs
     static layout* concatenate(layout* lhs, layout* rhs);
 
+    // build a string in a single allocation out of pieces whose total size is known
+    // up front, as compiled f-strings do. 'beginBuild' makes room for 'maxPointcount'
+    // codepoints of 'bytesPerCodepoint' bytes, which must be wide enough for every
+    // piece, and uses 'pointcount' as the write position. 'finishBuild' trims the
+    // allocation to fit and returns the increffed result.
+    static layout* beginBuild(int64_t maxPointcount, int32_t bytesPerCodepoint);
+
+    static void appendToBuild(layout* out, layout* piece);
+
+    static void appendAsciiToBuild(layout* out, const char* data, int64_t count);
+
+    static layout* finishBuild(layout* out, int64_t maxPointcount);
+
     //return an increffed lowercase conversion layout of l
     static layout* lower(layout *l);
 
@@ -112,11 +125,36 @@ public:
     static layout* getitem(layout* lhs, int64_t offset);
     static layout* getsubstr(layout* lhs, int64_t start, int64_t stop);
 
-    //return an increffed string containing the data from the utf-encoded string
+    //return an increffed string containing the data from the utf-encoded string.
+    //note that 'len' is the number of codepoints, not the number of bytes
     static layout* createFromUtf8(const char* utfEncodedString, int64_t len);
 
+    //decode 'bytecount' bytes of utf8 into a new string, stored at the narrowest
+    //width that holds its codepoints. Returns false (leaving 'out' alone) if the
+    //data isn't valid utf8. Encoded surrogates are accepted if 'allowSurrogates'.
+    static bool tryCreateFromUtf8Bytes(const uint8_t* data, int64_t bytecount, bool allowSurrogates, layout*& out);
+
+    //as above, but throws on invalid data
+    static layout* createFromUtf8Bytes(const uint8_t* data, int64_t bytecount);
+
+    //overwrite 'target', which nothing else may refer to, with the nonempty string
+    //'bytecount' bytes of utf8 encode, if it fits in the storage 'target' already
+    //has. Returns false (leaving 'target' alone) if it doesn't fit. Throws on
+    //invalid data.
+    static bool tryOverwriteFromUtf8Bytes(layout* target, const uint8_t* data, int64_t bytecount);
+
     static layout* createFromString(std::string s);
 
+    //return the canonical copy of 'l' from the process-wide intern table, adding 'l'
+    //if no equal string is there yet. Consumes the reference to 'l' and returns an
+    //increffed string. Interned strings live until 'clearInternTable' is called.
+    static layout* intern(layout* l);
+
+    static size_t internTableSize();
+
+    //drop the table's references to the strings interned so far.
+    static void clearInternTable();
+
     bool isBinaryCompatibleWithConcrete(Type* other) {
         if (other->getTypeCategory() != m_typeCategory) {
             return false;
@@ -160,43 +198,53 @@ public:
             return;
         }
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcLayout);
-        if (it == context.alreadyAllocated.end()) {
-            int64_t new_byteCount = srcLayout->pointcount * srcLayout->bytes_per_codepoint;
+        int64_t new_byteCount = srcLayout->pointcount * srcLayout->bytes_per_codepoint;
 
-            destLayout = (layout_ptr)context.slab->allocate(sizeof(layout) + new_byteCount, this);
-            destLayout->refcount = 0;
+        instance_ptr destPtr;
+        bool isNew;
+
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcLayout, [&]() {
+            layout_ptr newLayout = (layout_ptr)context.slab->allocate(sizeof(layout) + new_byteCount, this);
+            newLayout->refcount = 0;
+            return (instance_ptr)newLayout;
+        });
+
+        destLayout = (layout_ptr)destPtr;
+
+        if (isNew) {
             destLayout->hash_cache = srcLayout->hash_cache;
             destLayout->pointcount = srcLayout->pointcount;
             destLayout->bytes_per_codepoint = srcLayout->bytes_per_codepoint;
 
             memcpy(destLayout->data, srcLayout->data, new_byteCount);
-
-            context.alreadyAllocated[(instance_ptr)srcLayout] = (instance_ptr)destLayout;
-        } else {
-            destLayout = (layout_ptr)it->second;
         }
 
         destLayout->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         layout* l = *(layout**)instance;
 
         if (!l) {
             return 0;
         }
 
+        if (context.deferLayout(this, l, l->refcount)) {
+            return 0;
+        }
+
         // we don't have to check if we've seen this before if the refcount is 1
         // because there is only one holder.
         if (l->refcount != 1) {
-            if (alreadyVisited.find((void*)l) != alreadyVisited.end()) {
+            if (context.visited.contains((void*)l)) {
                 return 0;
             }
 
-            alreadyVisited.insert((void*)l);
+            context.visited.insert((void*)l);
         }
 
+        context.noteRefcount(l->refcount);
+
         if (outSlabs && Slab::slabForAlloc(l)) {
             outSlabs->insert(Slab::slabForAlloc(l));
             return 0;
@@ -274,9 +322,12 @@ public:
         int32_t ct = buffer.readUnsignedVarint();
 
         buffer.read_bytes_fun(ct, [&](const uint8_t* bytes) {
-            size_t codepointCount = countUtf8Codepoints(bytes, ct);
-            *(layout**)self = createFromUtf8((const char*)bytes, codepointCount);
+            *(layout**)self = createFromUtf8Bytes(bytes, ct);
         });
+
+        if (buffer.getContext().internStrings()) {
+            *(layout**)self = intern(*(layout**)self);
+        }
     }
 
     typed_python_hash_type hash(instance_ptr left) {
@@ -344,4 +395,10 @@ public:
     static bool to_int64(layout* s, int64_t* value);
 
     static bool to_float64(layout* s, double* value);
+
+    // parse each of the 'count' strings in 'strings' into 'out'. Returns the index
+    // of the first string that isn't a valid literal, or -1 if they all parsed.
+    static int64_t to_int64_column(layout** strings, int64_t count, int64_t* out);
+
+    static int64_t to_float64_column(layout** strings, int64_t count, double* out);
 };
@@ -0,0 +1,123 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "ThreadLocalSlots.hpp"
+#include "Type.hpp"
+#include "Memory.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace ThreadLocalSlots {
+
+namespace {
+
+std::mutex registryMutex;
+
+// the type of each slot. Only ever grows.
+std::vector<Type*> registeredTypes;
+
+// the calling thread's instances, indexed by slot. Null until first use.
+class ThreadSlots {
+public:
+    ~ThreadSlots() {
+        bool anyNonPod = false;
+
+        for (long k = 0; k < mSlots.size(); k++) {
+            if (mSlots[k] && !slotType(k)->isPOD()) {
+                anyNonPod = true;
+            }
+        }
+
+        if (anyNonPod) {
+            if (!Py_IsInitialized()) {
+                return;
+            }
+
+            PyGILState_STATE gilState = PyGILState_Ensure();
+            destroyAll();
+            PyGILState_Release(gilState);
+        } else {
+            destroyAll();
+        }
+    }
+
+    void* get(int64_t slot) {
+        if (slot < mSlots.size() && mSlots[slot]) {
+            return mSlots[slot];
+        }
+
+        return construct(slot);
+    }
+
+private:
+    void* construct(int64_t slot) {
+        Type* type = slotType(slot);
+
+        if (slot >= mSlots.size()) {
+            mSlots.resize(slot + 1);
+        }
+
+        void* data = tp_malloc(std::max<size_t>(type->bytecount(), 1));
+        type->constructor((instance_ptr)data);
+
+        mSlots[slot] = data;
+
+        return data;
+    }
+
+    void destroyAll() {
+        for (long k = 0; k < mSlots.size(); k++) {
+            if (mSlots[k]) {
+                slotType(k)->destroy((instance_ptr)mSlots[k]);
+                tp_free(mSlots[k]);
+                mSlots[k] = nullptr;
+            }
+        }
+    }
+
+    std::vector<void*> mSlots;
+};
+
+thread_local ThreadSlots threadSlots;
+
+} // end anonymous namespace
+
+int64_t allocate(Type* type) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    registeredTypes.push_back(type);
+
+    return registeredTypes.size() - 1;
+}
+
+int64_t count() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    return registeredTypes.size();
+}
+
+Type* slotType(int64_t slot) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    return registeredTypes[slot];
+}
+
+} // end namespace ThreadLocalSlots
+
+void* tp_thread_local_slot(int64_t slot) {
+    return ThreadLocalSlots::threadSlots.get(slot);
+}
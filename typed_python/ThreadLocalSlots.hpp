@@ -0,0 +1,57 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+class Type;
+
+/*********
+Per-thread storage for typed values, backing lib.thread_local.ThreadLocal.
+
+Each ThreadLocal registers a slot, which records the slot's Type. The first
+time a thread asks for a slot, we allocate a default-constructed instance of
+that Type for the thread. After that, asking for it is a bounds check and a
+load from a thread_local table, which is what compiled code does through
+tp_thread_local_slot.
+
+When a thread exits, we destroy its instances, so a Type's destructor (for
+instance a Class with a __del__) serves as a per-thread cleanup hook. Types
+that aren't POD are destroyed holding the GIL. If the interpreter is already
+gone, we leak them instead.
+
+Slots are never released: a ThreadLocal is meant to be a module-level global.
+*********/
+
+namespace ThreadLocalSlots {
+
+// register a slot holding a 'type', which must be default constructible
+int64_t allocate(Type* type);
+
+// how many slots have been registered
+int64_t count();
+
+Type* slotType(int64_t slot);
+
+}
+
+extern "C" {
+
+// the calling thread's instance for 'slot', constructing it on first use
+void* tp_thread_local_slot(int64_t slot);
+
+}
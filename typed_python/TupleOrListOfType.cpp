@@ -15,6 +15,7 @@
 ******************************************************************************/
 
 #include "AllTypes.hpp"
+#include <thread>
 
 bool TupleOrListOfType::isBinaryCompatibleWithConcrete(Type* other) {
     if (other->getTypeCategory() != m_typeCategory) {
@@ -119,30 +120,52 @@ bool TupleOrListOfType::cmp(instance_ptr left, instance_ptr right, int pyCompari
 
     size_t bytesPer = m_element_type->bytecount();
 
-    if (pyComparisonOp == Py_EQ) {
-        if (left_layout.count != right_layout.count) {
-            return false;
+    if (m_element_type->hasBitwiseEquality() && bytesPer) {
+        // compare the bytes directly, and only dispatch to the element type
+        // to order the first pair of elements that differ
+        if (pyComparisonOp == Py_EQ) {
+            return left_layout.count == right_layout.count
+                && memcmp(left_layout.data, right_layout.data, bytesPer * left_layout.count) == 0;
         }
 
-        for (long k = 0; k < left_layout.count && k < right_layout.count; k++) {
-            if (m_element_type->cmp(left_layout.data + bytesPer * k,
-                                           right_layout.data + bytesPer * k, Py_NE, suppressExceptions)) {
-                return false;
-            }
-        }
+        size_t commonBytes = bytesPer * std::min(left_layout.count, right_layout.count);
+        size_t offset = firstDifferingByte(left_layout.data, right_layout.data, commonBytes);
 
-        return true;
-    }
+        if (offset < commonBytes) {
+            size_t k = offset / bytesPer;
 
-    for (long k = 0; k < left_layout.count && k < right_layout.count; k++) {
-        if (m_element_type->cmp(left_layout.data + bytesPer * k,
-                                       right_layout.data + bytesPer * k, Py_NE, suppressExceptions)) {
             return cmpResultToBoolForPyOrdering(pyComparisonOp,
                 m_element_type->cmp(left_layout.data + bytesPer * k,
                                        right_layout.data + bytesPer * k, Py_LT, suppressExceptions)
                     ? -1 : 1
                 );
         }
+    } else {
+        if (pyComparisonOp == Py_EQ) {
+            if (left_layout.count != right_layout.count) {
+                return false;
+            }
+
+            for (long k = 0; k < left_layout.count && k < right_layout.count; k++) {
+                if (m_element_type->cmp(left_layout.data + bytesPer * k,
+                                               right_layout.data + bytesPer * k, Py_NE, suppressExceptions)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        for (long k = 0; k < left_layout.count && k < right_layout.count; k++) {
+            if (m_element_type->cmp(left_layout.data + bytesPer * k,
+                                           right_layout.data + bytesPer * k, Py_NE, suppressExceptions)) {
+                return cmpResultToBoolForPyOrdering(pyComparisonOp,
+                    m_element_type->cmp(left_layout.data + bytesPer * k,
+                                           right_layout.data + bytesPer * k, Py_LT, suppressExceptions)
+                        ? -1 : 1
+                    );
+            }
+        }
     }
 
     if (left_layout.count < right_layout.count) {
@@ -194,6 +217,75 @@ ListOfType* ListOfType::Make(Type* elt, ListOfType* knownType) {
     return it->second;
 }
 
+bool TupleOrListOfType::shouldDeepcopyElementsInParallel(layout_ptr srcLayout, DeepcopyContext& context) {
+    // below this, starting the threads costs more than they save
+    static const int64_t MIN_ELEMENTS_PER_THREAD = 1024;
+
+    return context.threadCount > 1
+        && !context.sharedMemo
+        && context.tpTypeMap.empty()
+        && !context.slab->isFreeStore()
+        && srcLayout->count >= MIN_ELEMENTS_PER_THREAD * 2
+        && m_element_type->canDeepcopyWithoutGil();
+}
+
+void TupleOrListOfType::deepcopyElementsInParallel(
+    layout_ptr destLayout,
+    layout_ptr srcLayout,
+    DeepcopyContext& context
+) {
+    // the threads share one memo, seeded with what we've copied so far, so
+    // substructure shared between elements is still copied exactly once.
+    ParallelDeepcopyMemo memo;
+
+    for (auto& srcAndDest: context.alreadyAllocated) {
+        memo.insert(srcAndDest.first, srcAndDest.second);
+    }
+
+    int64_t count = srcLayout->count;
+    int64_t threadCount = std::min<int64_t>(context.threadCount, count);
+    size_t eltSize = m_element_type->bytecount();
+
+    std::vector<std::exception_ptr> errors(threadCount);
+
+    {
+        PyEnsureGilReleased releaseTheGil;
+
+        std::vector<std::thread> threads;
+
+        for (int64_t t = 0; t < threadCount; t++) {
+            threads.push_back(std::thread([&, t]() {
+                try {
+                    DeepcopyContext threadContext(context.slab);
+                    threadContext.sharedMemo = &memo;
+
+                    for (int64_t k = count * t / threadCount; k < count * (t + 1) / threadCount; k++) {
+                        m_element_type->deepcopy(
+                            destLayout->data + k * eltSize,
+                            srcLayout->data + k * eltSize,
+                            threadContext
+                        );
+                    }
+                } catch(...) {
+                    errors[t] = std::current_exception();
+                }
+            }));
+        }
+
+        for (auto& thread: threads) {
+            thread.join();
+        }
+    }
+
+    memo.mergeInto(context.alreadyAllocated);
+
+    for (auto& error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 int64_t TupleOrListOfType::count(instance_ptr self) const {
     if (!(*(layout**)self)) {
         return 0;
@@ -223,10 +315,14 @@ void TupleOrListOfType::destroy(instance_ptr selfPtr) {
     }
 
     if (self->refcount.fetch_sub(1) == 1) {
+        if (type_live_counters_enabled) {
+            typeLiveCountersAdjust(this, self, -1);
+        }
+
         if (!m_element_type->isPOD()) {
             m_element_type->destroy(self->count, [&](int64_t k) {return eltPtr(self,k);});
         }
-        tp_free(self->data);
+        freeData(self);
         tp_free(self);
     }
 }
@@ -266,12 +362,29 @@ void TupleOrListOfType::reserve(instance_ptr self, size_t target) {
         target = self_layout->count;
     }
 
-    self_layout->data = (uint8_t*)tp_realloc(
-        self_layout->data,
-        getEltType()->bytecount() * self_layout->reserved,
-        getEltType()->bytecount() * target
-    );
+    TpAllocationTypeScope allocatingA(this);
+
+    if (type_live_counters_enabled) {
+        typeLiveCountersAdjustBytes(this, self_layout, -1);
+    }
+
+    if (hasInlineData(self_layout)) {
+        // inline storage can't be resized, so move to a separate block
+        uint8_t* newData = (uint8_t*)tp_malloc(getEltType()->bytecount() * target);
+        memcpy(newData, self_layout->data, getEltType()->bytecount() * self_layout->count);
+        self_layout->data = newData;
+    } else {
+        self_layout->data = (uint8_t*)tp_realloc(
+            self_layout->data,
+            getEltType()->bytecount() * self_layout->reserved,
+            getEltType()->bytecount() * target
+        );
+    }
     self_layout->reserved = target;
+
+    if (type_live_counters_enabled) {
+        typeLiveCountersAdjustBytes(this, self_layout, 1);
+    }
 }
 
 void TupleOrListOfType::reverse(instance_ptr self) {
@@ -309,6 +422,8 @@ void ListOfType::append(instance_ptr self, instance_ptr other) {
     layout_ptr& self_layout = *(layout_ptr*)self;
 
     if (!self_layout) {
+        TpAllocationTypeScope allocatingA(this);
+
         self_layout = (layout_ptr)tp_malloc(sizeof(layout));
         self_layout->data = (uint8_t*)tp_malloc(getEltType()->bytecount());
 
@@ -317,16 +432,30 @@ void ListOfType::append(instance_ptr self, instance_ptr other) {
         self_layout->reserved = 1;
         self_layout->hash_cache = -1;
 
+        if (type_live_counters_enabled) {
+            typeLiveCountersAdjust(this, self_layout, 1);
+        }
+
         getEltType()->copy_constructor(eltPtr(self, 0), other);
     } else {
         if (self_layout->count == self_layout->reserved) {
-            int64_t new_reserved = self_layout->reserved * 1.25 + 1;
+            TpAllocationTypeScope allocatingA(this);
+
+            if (type_live_counters_enabled) {
+                typeLiveCountersAdjustBytes(this, self_layout, -1);
+            }
+
+            int64_t new_reserved = grownReservation(self_layout->reserved, self_layout->count + 1);
             self_layout->data = (uint8_t*)tp_realloc(
                 self_layout->data,
                 getEltType()->bytecount() * self_layout->reserved,
                 getEltType()->bytecount() * new_reserved
             );
             self_layout->reserved = new_reserved;
+
+            if (type_live_counters_enabled) {
+                typeLiveCountersAdjustBytes(this, self_layout, 1);
+            }
         }
 
         getEltType()->copy_constructor(eltPtr(self, self_layout->count), other);
@@ -336,7 +465,15 @@ void ListOfType::append(instance_ptr self, instance_ptr other) {
 
 void ListOfType::ensureSpaceFor(instance_ptr data, size_t N) {
     if (reserved(data) < count(data) + N) {
-        reserve(data, count(data) + N);
+        reserve(data, grownReservation(reserved(data), count(data) + N));
+    }
+}
+
+void ListOfType::shrinkToFit(instance_ptr self) {
+    layout_ptr& self_layout = *(layout_ptr*)self;
+
+    if (self_layout->reserved > self_layout->count) {
+        reserve(self, self_layout->count);
     }
 }
 
@@ -357,7 +494,7 @@ void ListOfType::resize(instance_ptr self, size_t count) {
     layout_ptr& self_layout = *(layout_ptr*)self;
 
     if (count > self_layout->reserved) {
-        reserve(self, count);
+        reserve(self, grownReservation(self_layout->reserved, count));
     }
 
     if (count < self_layout->count) {
@@ -374,7 +511,7 @@ void ListOfType::resize(instance_ptr self, size_t count, instance_ptr value) {
     layout_ptr& self_layout = *(layout_ptr*)self;
 
     if (count > self_layout->reserved) {
-        reserve(self, count);
+        reserve(self, grownReservation(self_layout->reserved, count));
     }
 
     if (count < self_layout->count) {
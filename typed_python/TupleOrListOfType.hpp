@@ -18,12 +18,13 @@
 
 #include "Type.hpp"
 #include "Format.hpp"
+#include "ColumnarSerialization.hpp"
 
 class TupleOrListOfType : public Type {
 public:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         typed_python_hash_type hash_cache;
         int32_t count;
         int32_t reserved;
@@ -88,18 +89,22 @@ public:
             return;
         }
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcLayout);
-        if (it == context.alreadyAllocated.end()) {
-            destLayout = (layout_ptr)context.slab->allocate(sizeof(layout), this);
+        instance_ptr destPtr;
+        bool isNew;
+
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcLayout, [&]() {
+            layout_ptr newLayout = (layout_ptr)context.slab->allocate(sizeof(layout), this);
+            newLayout->refcount = 0;
+            return (instance_ptr)newLayout;
+        });
+
+        destLayout = (layout_ptr)destPtr;
+
+        if (isNew) {
             destLayout->hash_cache = srcLayout->hash_cache;
-            destLayout->refcount = 0;
 
             size_t reserveCount = srcLayout->count;
 
-            if (reserveCount == 0 && !m_is_tuple) {
-                reserveCount = 1;
-            }
-
             destLayout->reserved = reserveCount;
             destLayout->count = srcLayout->count;
 
@@ -112,6 +117,9 @@ public:
             if (destLayout->count) {
                 if (getEltType()->isPOD()) {
                     memcpy(destLayout->data, srcLayout->data, getEltType()->bytecount() * srcLayout->count);
+                } else
+                if (shouldDeepcopyElementsInParallel(srcLayout, context)) {
+                    deepcopyElementsInParallel(destLayout, srcLayout, context);
                 } else {
                     for (long k = 0; k < srcLayout->count; k++) {
                         m_element_type->deepcopy(
@@ -123,48 +131,64 @@ public:
                 }
             }
 
-            context.alreadyAllocated[(instance_ptr)srcLayout] = (instance_ptr)destLayout;
-        } else {
-            destLayout = (layout_ptr)it->second;
+            if (type_live_counters_enabled) {
+                typeLiveCountersAdjust(this, destLayout, 1);
+            }
         }
 
         destLayout->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    // is it worth splitting the elements of 'srcLayout' across context.threadCount
+    // threads? They have to be numerous, and the copy must not need the GIL.
+    bool shouldDeepcopyElementsInParallel(layout_ptr srcLayout, DeepcopyContext& context);
+
+    void deepcopyElementsInParallel(layout_ptr destLayout, layout_ptr srcLayout, DeepcopyContext& context);
+
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         layout_ptr& self_layout = *(layout_ptr*)instance;
 
         if (!self_layout) {
             return 0;
         }
 
-        if (alreadyVisited.find((void*)self_layout) != alreadyVisited.end()) {
+        if (context.deferLayout(this, self_layout, self_layout->refcount)) {
             return 0;
         }
 
-        alreadyVisited.insert((void*)self_layout);
+        if (context.visited.contains((void*)self_layout)) {
+            return 0;
+        }
+
+        context.visited.insert((void*)self_layout);
+        context.noteRefcount(self_layout->refcount);
 
         if (outSlabs && Slab::slabForAlloc(self_layout)) {
             outSlabs->insert(Slab::slabForAlloc(self_layout));
             return 0;
         }
 
+        if (context.shouldUseCache(this)) {
+            return context.cachedBytecount(this, self_layout, outSlabs);
+        }
+
         size_t reserveCount = self_layout->count;
 
-        // always allocate something for a list
-        if (reserveCount == 0 && !m_is_tuple) {
-            reserveCount = 1;
-        }
+        size_t res;
 
-        size_t res = bytesRequiredForAllocation(sizeof(layout));
+        if (hasInlineData(self_layout)) {
+            res = bytesRequiredForAllocation(sizeof(layout) + self_layout->reserved * getEltType()->bytecount());
+        } else {
+            res = bytesRequiredForAllocation(sizeof(layout));
 
-        if (reserveCount) {
-            res += bytesRequiredForAllocation(reserveCount * getEltType()->bytecount());
+            if (reserveCount) {
+                res += bytesRequiredForAllocation(reserveCount * getEltType()->bytecount());
+            }
         }
 
         if (!getEltType()->isPOD()) {
             for (long k = 0; k < self_layout->count; k++) {
-                res += m_element_type->deepBytecount(eltPtr(instance, k), alreadyVisited, outSlabs);
+                res += m_element_type->deepBytecount(eltPtr(instance, k), context, outSlabs);
             }
         }
 
@@ -181,6 +205,26 @@ public:
         return m_element_type;
     }
 
+    // TupleOf instances built with a known count keep their elements in the
+    // same allocation as the layout, immediately after it, so a small tuple
+    // costs a single tp_malloc and its elements share a cache line with the
+    // header. Lists (and tuples built incrementally) keep a separate 'data'
+    // block so they can grow with tp_realloc. The compiler's tuple_of_wrapper
+    // mirrors this check in its destructor.
+    static uint8_t* inlineDataFor(layout_ptr self) {
+        return (uint8_t*)(self + 1);
+    }
+
+    static bool hasInlineData(layout_ptr self) {
+        return self->data == inlineDataFor(self);
+    }
+
+    static void freeData(layout_ptr self) {
+        if (!hasInlineData(self)) {
+            tp_free(self->data);
+        }
+    }
+
     instance_ptr eltPtr(layout_ptr self, int64_t i) const {
         return eltPtr((instance_ptr)&self, i);
     }
@@ -209,28 +253,59 @@ public:
             return;
         }
 
-        self = (layout*)tp_malloc(sizeof(layout));
+        {
+            TpAllocationTypeScope allocatingA(this);
+
+            if (m_is_tuple) {
+                self = (layout*)tp_malloc(sizeof(layout) + getEltType()->bytecount() * count);
+                self->reserved = count;
+                self->data = inlineDataFor(self);
+            } else {
+                // empty lists don't get a data buffer until something is added
+                // to them. tp_malloc(0) is nullptr, which tp_realloc and tp_free
+                // both accept.
+                self = (layout*)tp_malloc(sizeof(layout));
+                self->reserved = count;
+                self->data = (uint8_t*)tp_malloc(getEltType()->bytecount() * self->reserved);
+            }
+        }
 
         self->count = count;
         self->refcount = 1;
-        self->reserved = std::max<int32_t>(1, count);
         self->hash_cache = -1;
-        self->data = (uint8_t*)tp_malloc(getEltType()->bytecount() * self->reserved);
 
         for (int64_t k = 0; k < count; k++) {
             try {
                 allocator(eltPtr(self, k), k);
             } catch(...) {
+                if (self->refcount > 1) {
+                    // the allocator handed out a reference to the layout (a
+                    // deserializer's memo does this), so leave it holding the
+                    // elements we constructed for that reference to destroy.
+                    self->count = k;
+                    self->refcount--;
+
+                    if (type_live_counters_enabled) {
+                        typeLiveCountersAdjust(this, self, 1);
+                    }
+
+                    throw;
+                }
+
                 if (!m_element_type->isPOD()) {
                     for (long k2 = k-1; k2 >= 0; k2--) {
                         m_element_type->destroy(eltPtr(self,k2));
                     }
                 }
-                tp_free(self->data);
+                freeData(self);
                 tp_free(self);
                 throw;
             }
         }
+
+        if (type_live_counters_enabled) {
+            typeLiveCountersAdjust(this, self, 1);
+        }
     }
     //construct a new list at 'selfPtr'. We call 'allocator(target_object, k)' repeatedly.
     //we stop when it returns 'false'
@@ -238,13 +313,17 @@ public:
     void constructorUnbounded(instance_ptr selfPtr, const sub_constructor& allocator) {
         layout_ptr& self = *(layout_ptr*)selfPtr;
 
-        self = (layout*)tp_malloc(sizeof(layout));
+        {
+            TpAllocationTypeScope allocatingA(this);
+
+            self = (layout*)tp_malloc(sizeof(layout));
+            self->data = (uint8_t*)tp_malloc(getEltType()->bytecount());
+        }
 
         self->count = 0;
         self->refcount = 1;
         self->reserved = 1;
         self->hash_cache = -1;
-        self->data = (uint8_t*)tp_malloc(getEltType()->bytecount() * self->reserved);
 
         while(true) {
             try {
@@ -254,13 +333,15 @@ public:
                         tp_free(self->data);
                         tp_free(self);
                         self = nullptr;
+                    } else if (type_live_counters_enabled) {
+                        typeLiveCountersAdjust(this, self, 1);
                     }
                     return;
                 }
 
                 self->count++;
                 if (self->count >= self->reserved) {
-                    reserve(selfPtr, self->reserved * 1.25 + 1);
+                    reserve(selfPtr, grownReservation(self->reserved, self->count + 1));
                 }
             } catch(...) {
                 if (!m_element_type->isPOD()) {
@@ -285,6 +366,18 @@ public:
 
     void reserve(instance_ptr self, size_t count);
 
+    // how many elements to reserve when a list that has room for 'reserved'
+    // needs room for 'needed'. Growing geometrically keeps append amortized O(1).
+    // Large buffers grow by remapping pages (see Memory.hpp), so we can afford a
+    // gentler step there. The compiler's list_of_wrapper mirrors this.
+    static size_t grownReservation(size_t reserved, size_t needed) {
+        size_t grown = reserved < 1024 ? reserved * 2 + 4 : reserved + reserved / 2;
+
+        grown = std::min<size_t>(grown, std::numeric_limits<int32_t>::max());
+
+        return std::max(grown, needed);
+    }
+
     void setSizeUnsafe(instance_ptr self, size_t count);
 
     void reverse(instance_ptr self);
@@ -392,6 +485,53 @@ public:
         }
     }
 
+    // write each field of 'ct' NamedTuple or Tuple elements as one BYTES
+    // message, numbered by the field's index. See ColumnarSerialization.hpp.
+    template<class buf_t>
+    void serializeColumns(const SerializationPlan& columns, instance_ptr self, size_t ct, buf_t& buffer) {
+        std::vector<uint8_t> column;
+
+        for (size_t k = 0; k < columns.size(); k++) {
+            column.clear();
+
+            ColumnarSerialization::encodeColumn(
+                columns[k],
+                this->eltPtr(self, 0),
+                m_element_type->bytecount(),
+                ct,
+                column
+            );
+
+            buffer.writeBeginBytes(k, column.size());
+            buffer.write_bytes(column.data(), column.size());
+        }
+    }
+
+    template<class buf_t>
+    void deserializeColumns(const SerializationPlan& columns, instance_ptr self, size_t ct, buf_t& buffer) {
+        for (size_t k = 0; k < columns.size(); k++) {
+            auto fieldAndWire = buffer.readFieldNumberAndWireType();
+
+            if (fieldAndWire.first != k || fieldAndWire.second != WireType::BYTES) {
+                throw std::runtime_error("Corrupt columnar data (expected column " + format(k) + ")");
+            }
+
+            size_t bytecount = buffer.readUnsignedVarint();
+
+            buffer.read_bytes_fun(bytecount, [&](uint8_t* data) {
+                ColumnarSerialization::decodeColumn(
+                    columns[k],
+                    data,
+                    bytecount,
+                    this->eltPtr(self, 0),
+                    m_element_type->bytecount(),
+                    ct,
+                    buffer.getContext().internStrings()
+                );
+            });
+        }
+    }
+
     template<class buf_t>
     void serialize(instance_ptr self, buf_t& buffer, size_t fieldNumber) {
         size_t ct = count(self);
@@ -419,6 +559,16 @@ public:
             buffer.writeBeginCompound(fieldNumber);
         }
 
+        const SerializationPlan* columns = nullptr;
+        if (ct && buffer.getContext().serializeListsColumnar()) {
+            columns = ColumnarSerialization::planFor(m_element_type);
+        }
+
+        if (columns) {
+            buffer.writeUnsignedVarintObject(3, ct);
+
+            serializeColumns(*columns, self, ct, buffer);
+        } else
         if (ct && m_element_type->isPOD() && buffer.getContext().serializePodListsInline()) {
             if (m_element_type->getTypeCategory() == TypeCategory::catInt64) {
                 buffer.writeUnsignedVarintObject(1, ct);
@@ -439,13 +589,29 @@ public:
         } else {
             buffer.writeUnsignedVarintObject(0, ct);
 
-            m_element_type->serializeMulti(
-                this->eltPtr(self, 0),
-                ct,
-                m_element_type->bytecount(),
-                buffer,
-                0
-            );
+            int64_t threadCount = buffer.threadsToSerialize(ct, {m_element_type});
+
+            if (threadCount > 1) {
+                buffer.serializeInParallel(threadCount, ct,
+                    [&](SerializationBuffer& threadBuffer, int64_t lo, int64_t hi) {
+                        m_element_type->serializeMulti(
+                            this->eltPtr(self, lo),
+                            hi - lo,
+                            m_element_type->bytecount(),
+                            threadBuffer,
+                            0
+                        );
+                    }
+                );
+            } else {
+                m_element_type->serializeMulti(
+                    this->eltPtr(self, 0),
+                    ct,
+                    m_element_type->bytecount(),
+                    buffer,
+                    0
+                );
+            }
         }
 
         buffer.writeEndCompound();
@@ -473,6 +639,7 @@ public:
                 try {
                     buffer.finishCompoundMessage(wireType);
                 } catch(...) {
+                    destroy(self);
                     throw std::runtime_error("1. Failed finishing: " + name());
                 }
 
@@ -484,19 +651,32 @@ public:
         size_t fieldnum = fieldnumAndWireType.first;
         size_t ct = buffer.readUnsignedVarint();
 
-        if (ct == 0) {
-            constructor(self);
+        // if reading the body fails once we've built the list, we drop our
+        // reference to it, so that neither it nor its elements leak.
+        auto fillOrRelease = [&](auto fill) {
+            try {
+                fill();
+            } catch(...) {
+                destroy(self);
+                throw;
+            }
+        };
 
+        if (ct == 0) {
             if (fieldnum != 0) {
                 throw std::runtime_error("Corrupt field num - empty list/tuple count should be 0");
             }
 
+            constructor(self);
+
             if (isListOf()) {
                 (*(layout**)self)->refcount++;
                 buffer.addCachedPointer(id, *((layout**)self), this);
             }
         } else {
             if (fieldnum == 0) {
+                buffer.chargeAllocation(ct, m_element_type->bytecount());
+
                 constructor(self, ct, [&](instance_ptr tgt, int k) {
                     if (k == 0 && isListOf()) {
                         buffer.addCachedPointer(id, *((layout**)self), this);
@@ -520,6 +700,9 @@ public:
                         "Compressed intArray data data makes no sense for " + m_element_type->name()
                     );
                 }
+
+                buffer.chargeAllocation(ct, sizeof(int64_t));
+
                 constructor(self, ct, [&](instance_ptr tgt, int k) {});
 
                 if (isListOf()) {
@@ -527,14 +710,16 @@ public:
                     buffer.addCachedPointer(id, *((layout**)self), this);
                 }
 
-                deserializeIntList(
-                    (int64_t*)this->eltPtr(self, 0),
-                    ct,
-                    buffer
-                );
+                fillOrRelease([&]() {
+                    deserializeIntList(
+                        (int64_t*)this->eltPtr(self, 0),
+                        ct,
+                        buffer
+                    );
+                });
             } else
             if (fieldnum == 2) {
-                if (!m_element_type->isPOD()) {
+                if (!m_element_type->isPOD() || !m_element_type->bytecount()) {
                     throw std::runtime_error(
                         "Compressed POD data makes no sense for " + m_element_type->name()
                     );
@@ -545,6 +730,8 @@ public:
                     throw std::runtime_error("Invalid inline POD data - not a proper multiple");
                 }
 
+                buffer.chargeAllocation(eltCount, m_element_type->bytecount());
+
                 constructor(self, eltCount, [&](instance_ptr tgt, int k) {});
 
                 if (isListOf()) {
@@ -552,7 +739,36 @@ public:
                     buffer.addCachedPointer(id, *((layout**)self), this);
                 }
 
-                buffer.read_bytes(this->eltPtr(self, 0), ct);
+                fillOrRelease([&]() {
+                    buffer.read_bytes(this->eltPtr(self, 0), ct);
+                });
+            } else
+            if (fieldnum == 3) {
+                const SerializationPlan* columns = ColumnarSerialization::planFor(m_element_type);
+
+                if (!columns) {
+                    throw std::runtime_error(
+                        "Columnar data makes no sense for " + m_element_type->name()
+                    );
+                }
+
+                buffer.chargeAllocation(ct, m_element_type->bytecount());
+
+                // all-zero bytes are a valid value of every field kind we
+                // write as a column, so the list is safe to destroy however
+                // far we get through the columns.
+                constructor(self, ct, [&](instance_ptr tgt, int k) {
+                    memset(tgt, 0, m_element_type->bytecount());
+                });
+
+                if (isListOf()) {
+                    (*(layout**)self)->refcount++;
+                    buffer.addCachedPointer(id, *((layout**)self), this);
+                }
+
+                fillOrRelease([&]() {
+                    deserializeColumns(*columns, self, ct, buffer);
+                });
             } else {
                 throw std::runtime_error("Corrupt fieldnum for tuple/listof body");
             }
@@ -562,6 +778,7 @@ public:
             buffer.finishCompoundMessage(wireType);
         }
         catch(...) {
+            destroy(self);
             throw std::runtime_error("2. Failed finishing: " + name() + ": " + format(ct));
         }
 
@@ -608,6 +825,9 @@ public:
 
     void ensureSpaceFor(instance_ptr self, size_t count);
 
+    // release any reserved space beyond the list's current length
+    void shrinkToFit(instance_ptr self);
+
     template<class initializer>
     void extend(instance_ptr self, size_t count, const initializer& initFun) {
         layout_ptr& self_layout = *(layout_ptr*)self;
@@ -120,21 +120,42 @@ void Type::swap(instance_ptr left, instance_ptr right) {
 
 // static
 char Type::byteCompare(uint8_t* l, uint8_t* r, size_t count) {
-    while (count >= 8 && *(uint64_t*)l == *(uint64_t*)r) {
-        l += 8;
-        r += 8;
-        count -= 8;
+    // memcmp compares bytes as unsigned, which is the order we want
+    int res = memcmp(l, r, count);
+
+    return res < 0 ? -1 : res > 0 ? 1 : 0;
+}
+
+size_t Type::firstDifferingByte(uint8_t* l, uint8_t* r, size_t count) {
+    size_t k = 0;
+
+    while (k + 8 <= count && *(uint64_t*)(l + k) == *(uint64_t*)(r + k)) {
+        k += 8;
     }
 
-    for (long k = 0; k < count; k++) {
-        if (l[k] < r[k]) {
-            return -1;
-        }
-        if (l[k] > r[k]) {
-            return 1;
+    while (k < count && l[k] == r[k]) {
+        k++;
+    }
+
+    return k;
+}
+
+bool Type::hasBitwiseEquality() {
+    if (isBool() || isInteger()) {
+        return true;
+    }
+
+    if (isComposite()) {
+        for (auto t: ((CompositeType*)this)->getTypes()) {
+            if (!t->hasBitwiseEquality()) {
+                return false;
+            }
         }
+
+        return true;
     }
-    return 0;
+
+    return false;
 }
 
 void Type::constructor(instance_ptr self) {
@@ -197,6 +218,98 @@ void Type::deepcopy(
     });
 }
 
+// true if 'isAllowed' holds for the category of every type reachable from 'root'
+template<class predicate_type>
+static bool allReachableTypeCategoriesAre(Type* root, const predicate_type& isAllowed) {
+    std::set<Type*> seen;
+    std::vector<Type*> toCheck({root});
+
+    while (toCheck.size()) {
+        Type* t = toCheck.back();
+        toCheck.pop_back();
+
+        if (seen.find(t) != seen.end()) {
+            continue;
+        }
+        seen.insert(t);
+
+        if (!isAllowed(t->getTypeCategory())) {
+            return false;
+        }
+
+        t->visitReferencedTypes([&](Type*& subtype) {
+            toCheck.push_back(subtype);
+        });
+    }
+
+    return true;
+}
+
+bool Type::canDeepcopyWithoutGil() {
+    return allReachableTypeCategoriesAre(this, [](TypeCategory category) {
+        switch (category) {
+            case catNone:
+            case catBool:
+            case catUInt8:
+            case catUInt16:
+            case catUInt32:
+            case catUInt64:
+            case catInt8:
+            case catInt16:
+            case catInt32:
+            case catInt64:
+            case catFloat32:
+            case catFloat64:
+            case catString:
+            case catBytes:
+            case catOneOf:
+            case catTupleOf:
+            case catListOf:
+            case catNamedTuple:
+            case catTuple:
+            case catDict:
+            case catConstDict:
+            case catSet:
+            case catAlternative:
+            case catConcreteAlternative:
+                return true;
+            default:
+                return false;
+        }
+    });
+}
+
+bool Type::isDeeplyImmutable() {
+    return allReachableTypeCategoriesAre(this, [](TypeCategory category) {
+        switch (category) {
+            case catNone:
+            case catBool:
+            case catUInt8:
+            case catUInt16:
+            case catUInt32:
+            case catUInt64:
+            case catInt8:
+            case catInt16:
+            case catInt32:
+            case catInt64:
+            case catFloat32:
+            case catFloat64:
+            case catString:
+            case catBytes:
+            case catOneOf:
+            case catTupleOf:
+            case catNamedTuple:
+            case catTuple:
+            case catConstDict:
+            case catAlternative:
+            case catConcreteAlternative:
+                return true;
+            default:
+                return false;
+        }
+    });
+}
+
 void Type::destroy(instance_ptr self) {
     this->check([&](auto& subtype) { subtype.destroy(self); } );
 }
@@ -17,6 +17,8 @@
 #pragma once
 
 #include "Memory.hpp"
+#include "Refcount.hpp"
+#include "TypeLiveCounters.hpp"
 #include <Python.h>
 #include <string>
 #include <vector>
@@ -39,6 +41,7 @@
 #include "MutuallyRecursiveTypeGroup.hpp"
 #include "Slab.hpp"
 #include "DeepcopyContext.hpp"
+#include "DeepBytecountContext.hpp"
 
 class SerializationBuffer;
 class DeserializationBuffer;
@@ -379,6 +382,16 @@ public:
         DeepcopyContext& context
     );
 
+    // can instances of this type be deepcopied without touching the python
+    // interpreter? True if every type reachable from this one is a plain typed
+    // container or value, so several threads may copy instances at once.
+    bool canDeepcopyWithoutGil();
+
+    // is every instance of this type immutable all the way down? True if every
+    // type reachable from this one is a value, a string, or an immutable container
+    // or alternative built from them.
+    bool isDeeplyImmutable();
+
     void deepcopyConcrete(
         instance_ptr dest,
         instance_ptr src,
@@ -394,17 +407,17 @@ public:
     // into types, modules, or functions). Don't include storage for 'instance' itself - just storage
     // that's allocated on the heap by this object. If 'outSlabs' is not the nullpointer, then if we
     // hit an allocation that's mapped to a slab, just mark the slab and return.
-    size_t deepBytecount(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecount(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         assertForwardsResolvedSufficientlyToInstantiate();
 
         return this->check([&](auto& subtype) {
-            return subtype.deepBytecountConcrete(instance, alreadyVisited, outSlabs);
+            return subtype.deepBytecountConcrete(instance, context, outSlabs);
         });
     }
 
     size_t deepBytecountConcrete(
         instance_ptr instance,
-        std::unordered_set<void*>& alreadyVisited,
+        DeepBytecountContext& context,
         std::set<Slab*>* outSlabs
     ) {
         throw std::runtime_error(
@@ -442,6 +455,8 @@ public:
     void deserialize(instance_ptr left, buf_t& buffer, size_t wireType) {
         assertForwardsResolvedSufficientlyToInstantiate();
 
+        typename buf_t::DepthGuard nesting(buffer);
+
         return this->check([&](auto& subtype) {
             return subtype.deserialize(left, buffer, wireType);
         });
@@ -455,6 +470,14 @@ public:
 
     static char byteCompare(uint8_t* l, uint8_t* r, size_t count);
 
+    // the offset of the first byte where 'l' and 'r' differ, or 'count' if they don't.
+    static size_t firstDifferingByte(uint8_t* l, uint8_t* r, size_t count);
+
+    // are two instances of this type equal exactly when their bytes are? True for
+    // integers and bools, and for Tuples and NamedTuples made only of them (which
+    // have no padding). Not for floats, since 0.0 == -0.0 and nan != nan.
+    bool hasBitwiseEquality();
+
     static std::string categoryToString(TypeCategory category) {
         if (category == Type::TypeCategory::catNone) { return "None"; }
         if (category == Type::TypeCategory::catBool) { return "Bool"; }
@@ -901,7 +924,33 @@ public:
         return m_recursive_forward_index;
     }
 
+    // the counters for our live instances, created the first time we need them.
+    TypeLiveCounters* liveCounters() {
+        TypeLiveCounters* counters = mLiveCounters.load();
+
+        if (!counters) {
+            TypeLiveCounters* newCounters = TypeLiveCounters::create();
+
+            if (mLiveCounters.compare_exchange_strong(counters, newCounters)) {
+                counters = newCounters;
+                registerLiveCounters();
+            } else {
+                TypeLiveCounters::release(newCounters);
+            }
+        }
+
+        return counters;
+    }
+
+    // returns nullptr if we've never counted an instance
+    TypeLiveCounters* liveCountersIfAny() const {
+        return mLiveCounters.load();
+    }
+
 protected:
+    // add us to the list that typeLiveCountersTypes returns
+    void registerLiveCounters();
+
     Type(TypeCategory in_typeCategory) :
             m_typeCategory(in_typeCategory),
             m_size(0),
@@ -915,7 +964,8 @@ protected:
             m_is_recursive_forward(false),
             m_recursive_forward_index(-1),
             mTypeGroup(nullptr),
-            mRecursiveTypeGroupIndex(-1)
+            mRecursiveTypeGroupIndex(-1),
+            mLiveCounters(nullptr)
         {}
 
     TypeCategory m_typeCategory;
@@ -969,4 +1019,8 @@ protected:
     MutuallyRecursiveTypeGroup* mTypeGroup;
 
     int32_t mRecursiveTypeGroupIndex;
+
+    // counts of our live instances, if TP_TYPE_LIVE_COUNTERS is on and we've
+    // had one. See TypeLiveCounters.hpp.
+    std::atomic<TypeLiveCounters*> mLiveCounters;
 };
@@ -0,0 +1,86 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#include "TypeLiveCounters.hpp"
+#include "AllTypes.hpp"
+
+bool type_live_counters_enabled = false;
+
+namespace {
+
+std::mutex& countedTypesMutex() {
+    static std::mutex* res = new std::mutex();
+    return *res;
+}
+
+std::vector<Type*>& countedTypes() {
+    static std::vector<Type*>* res = new std::vector<Type*>();
+    return *res;
+}
+
+std::atomic<size_t> nextThreadShard(0);
+
+} // end anonymous namespace
+
+size_t TypeLiveCounters::threadShard() {
+    static thread_local size_t shard = nextThreadShard++ % SHARD_COUNT;
+
+    return shard;
+}
+
+void Type::registerLiveCounters() {
+    std::lock_guard<std::mutex> lock(countedTypesMutex());
+
+    countedTypes().push_back(this);
+}
+
+std::vector<Type*> typeLiveCountersTypes() {
+    std::lock_guard<std::mutex> lock(countedTypesMutex());
+
+    return countedTypes();
+}
+
+int64_t typeLiveCountersFootprint(Type* t, void* layout) {
+    if (t->isTupleOf() || t->isListOf()) {
+        TupleOrListOfType::layout_ptr self = (TupleOrListOfType::layout_ptr)layout;
+        size_t eltBytes = ((TupleOrListOfType*)t)->getEltType()->bytecount();
+
+        if (TupleOrListOfType::hasInlineData(self)) {
+            return bytesRequiredForAllocation(sizeof(TupleOrListOfType::layout) + eltBytes * self->reserved);
+        }
+
+        return bytesRequiredForAllocation(sizeof(TupleOrListOfType::layout))
+            + bytesRequiredForAllocation(eltBytes * self->reserved);
+    }
+
+    if (t->isDict()) {
+        return ((hash_table_layout*)layout)->footprint(((DictType*)t)->bytesPerKeyValuePair());
+    }
+
+    if (t->isSet()) {
+        return ((hash_table_layout*)layout)->footprint(((SetType*)t)->bytesPerElement());
+    }
+
+    return 0;
+}
+
+void typeLiveCountersAdjust(Type* t, void* layout, int64_t sign) {
+    t->liveCounters()->adjust(sign, sign * typeLiveCountersFootprint(t, layout));
+}
+
+void typeLiveCountersAdjustBytes(Type* t, void* layout, int64_t sign) {
+    t->liveCounters()->adjust(0, sign * typeLiveCountersFootprint(t, layout));
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+class Type;
+
+// if true, we count the live instances (and the bytes they hold) of every ListOf,
+// TupleOf, Dict and Set type. Set once, from TP_TYPE_LIVE_COUNTERS, when _types is
+// imported, and never changed afterwards, so that every instance we see destroyed
+// is one we saw created. Compiled code reads the same setting (through
+// _types.typeLiveCountersEnabled) and only emits counting code if it's on.
+extern bool type_live_counters_enabled;
+
+/*****
+The live instance and byte counts of a single Type.
+
+Each count is split over SHARD_COUNT cache lines, and each thread only updates
+the shard it was assigned, so threads creating and destroying instances of the
+same type don't fight over one line. Reading a count sums the shards.
+*****/
+class TypeLiveCounters {
+public:
+    enum { SHARD_COUNT = 16 };
+
+    // plain 'new' only aligns to max_align_t before C++17, which would let the
+    // shards straddle cache lines, so we allocate on a cache line ourselves.
+    static TypeLiveCounters* create() {
+        void* storage = nullptr;
+
+        if (posix_memalign(&storage, alignof(TypeLiveCounters), sizeof(TypeLiveCounters))) {
+            throw std::bad_alloc();
+        }
+
+        return new (storage) TypeLiveCounters();
+    }
+
+    // free counters that came from 'create'
+    static void release(TypeLiveCounters* counters) {
+        counters->~TypeLiveCounters();
+        free(counters);
+    }
+
+    TypeLiveCounters() {
+        for (auto& shard: mShards) {
+            shard.instances.store(0);
+            shard.bytes.store(0);
+        }
+    }
+
+    void adjust(int64_t instances, int64_t bytes) {
+        Shard& shard = mShards[threadShard()];
+
+        shard.instances.fetch_add(instances, std::memory_order_relaxed);
+        shard.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    int64_t instances() const {
+        int64_t res = 0;
+
+        for (auto& shard: mShards) {
+            res += shard.instances.load(std::memory_order_relaxed);
+        }
+
+        return res;
+    }
+
+    int64_t bytes() const {
+        int64_t res = 0;
+
+        for (auto& shard: mShards) {
+            res += shard.bytes.load(std::memory_order_relaxed);
+        }
+
+        return res;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<int64_t> instances;
+        std::atomic<int64_t> bytes;
+    };
+
+    static size_t threadShard();
+
+    Shard mShards[SHARD_COUNT];
+};
+
+// the bytes held by the instance of 't' whose layout is at 'layout'. Only valid
+// for the types we count.
+int64_t typeLiveCountersFootprint(Type* t, void* layout);
+
+// count 'sign' (1 or -1) instances of 't', and their bytes. 'layout' must
+// be in the state it was created in, or is about to be destroyed in.
+void typeLiveCountersAdjust(Type* t, void* layout, int64_t sign);
+
+// add (sign = 1) or remove (sign = -1) the bytes held by the instance of 't'
+// at 'layout', without counting an instance. Changes to an instance's storage
+// are bracketed with -1 before and 1 after.
+void typeLiveCountersAdjustBytes(Type* t, void* layout, int64_t sign);
+
+// the types that have been counted so far
+std::vector<Type*> typeLiveCountersTypes();
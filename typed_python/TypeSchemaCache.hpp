@@ -0,0 +1,83 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include "Type.hpp"
+#include <unordered_map>
+#include <vector>
+
+/*********
+The types one side of a connection has agreed, ahead of time, to refer to
+by small integer ids.
+
+'SerializationContext.announceTypes' adds types to the sender's cache and
+returns a handshake message. 'acceptTypes' on the receiving side adds the same
+types, in the same order, to its own cache. After that, a context holding
+either cache writes each of those types as a single varint id rather than
+by name or group hash, and reads the ids back.
+
+Types are never destroyed, so we can hold plain Type pointers. Callers hold
+the GIL, which is what keeps the cache consistent.
+*********/
+
+class TypeSchemaCache {
+public:
+    // the id of 't', or -1 if it isn't in the cache
+    int64_t idFor(Type* t) const {
+        auto it = mTypeToId.find(t);
+
+        if (it == mTypeToId.end()) {
+            return -1;
+        }
+
+        return it->second;
+    }
+
+    // the type with id 'id', or nullptr
+    Type* typeFor(size_t id) const {
+        if (id >= mIdToType.size()) {
+            return nullptr;
+        }
+
+        return mIdToType[id];
+    }
+
+    // add 't' if it's new, and return its id either way
+    size_t add(Type* t) {
+        auto it = mTypeToId.find(t);
+
+        if (it != mTypeToId.end()) {
+            return it->second;
+        }
+
+        size_t id = mIdToType.size();
+
+        mIdToType.push_back(t);
+        mTypeToId[t] = id;
+
+        return id;
+    }
+
+    size_t size() const {
+        return mIdToType.size();
+    }
+
+private:
+    std::unordered_map<Type*, size_t> mTypeToId;
+
+    std::vector<Type*> mIdToType;
+};
@@ -24,7 +24,7 @@ class TypedCellType : public Type {
 public:
     class layout {
     public:
-        std::atomic<int64_t> refcount;
+        Refcount refcount;
         int64_t initialized;
         unsigned char data[];
     };
@@ -105,10 +105,18 @@ public:
             return;
         }
 
-        auto it = context.alreadyAllocated.find((instance_ptr)srcLayout);
-        if (it == context.alreadyAllocated.end()) {
-            destLayout = (layout_ptr)context.slab->allocate(sizeof(layout) + mHeldType->bytecount(), this);
-            destLayout->refcount = 0;
+        instance_ptr destPtr;
+        bool isNew;
+
+        std::tie(destPtr, isNew) = context.lookupOrAllocate((instance_ptr)srcLayout, [&]() {
+            layout_ptr newLayout = (layout_ptr)context.slab->allocate(sizeof(layout) + mHeldType->bytecount(), this);
+            newLayout->refcount = 0;
+            return (instance_ptr)newLayout;
+        });
+
+        destLayout = (layout_ptr)destPtr;
+
+        if (isNew) {
             destLayout->initialized = srcLayout->initialized;
 
             if (destLayout->initialized) {
@@ -118,27 +126,24 @@ public:
                     context
                 );
             }
-
-            context.alreadyAllocated[(instance_ptr)srcLayout] = (instance_ptr)destLayout;
-        } else {
-            destLayout = (layout_ptr)it->second;
         }
 
         destLayout->refcount++;
     }
 
-    size_t deepBytecountConcrete(instance_ptr instance, std::unordered_set<void*>& alreadyVisited, std::set<Slab*>* outSlabs) {
+    size_t deepBytecountConcrete(instance_ptr instance, DeepBytecountContext& context, std::set<Slab*>* outSlabs) {
         layout* l = *(layout**)instance;
 
         if (!l) {
             return 0;
         }
 
-        if (alreadyVisited.find((void*)l) != alreadyVisited.end()) {
+        if (context.visited.contains((void*)l)) {
             return 0;
         }
 
-        alreadyVisited.insert((void*)l);
+        context.visited.insert((void*)l);
+        context.noteRefcount(l->refcount);
 
         if (outSlabs && Slab::slabForAlloc(l)) {
             outSlabs->insert(Slab::slabForAlloc(l));
@@ -146,7 +151,7 @@ public:
         }
 
         return bytesRequiredForAllocation(
-            mHeldType->deepBytecount(l->data, alreadyVisited, outSlabs) + sizeof(layout)
+            mHeldType->deepBytecount(l->data, context, outSlabs) + sizeof(layout)
         );
     }
 
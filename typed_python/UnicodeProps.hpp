@@ -14,6 +14,8 @@
    limitations under the License.
 ******************************************************************************/
 
+#pragma once
+
 #include <Python.h>
 
 // Include information about which unicode characters are considered 'alphanumeric'
@@ -28,3 +30,20 @@
 #else
 #  include "UnicodeProps_3.7.4.hpp"
 #endif
+
+// The Uprops_ flags of codepoint 'c'. The tables are a few KB of bytes (see
+// unicodeprops.py), so even text that's all over the BMP stays in cache.
+inline uint16_t unicodeProps(uint32_t c) {
+    if (c < 256) {
+        return uprops_latin1[c];
+    }
+
+    if (c >= UPROPS_LIMIT) {
+        return 0;
+    }
+
+    uint32_t block1 = uprops_index0[c >> (UPROPS_SHIFT1 + UPROPS_SHIFT2)];
+    uint32_t block2 = uprops_index1[(block1 << UPROPS_SHIFT1) + ((c >> UPROPS_SHIFT2) & ((1 << UPROPS_SHIFT1) - 1))];
+
+    return uprops_records[uprops_index2[(block2 << UPROPS_SHIFT2) + (c & ((1 << UPROPS_SHIFT2) - 1))]];
+}
@@ -1,5 +1,5 @@
 /******************************************************************************
-   Copyright 2017-2019 typed_python Authors
+   Copyright 2017-2023 typed_python Authors
 
    Licensed under the Apache License, Version 2.0 (the "License");
    you may not use this file except in compliance with the License.
@@ -16,7 +16,7 @@
 
 #pragma once
 
-// Generated from:
+// Generated by unicodeprops.py from:
 /*  3.6.7 (default, Oct 22 2018, 11:32:17)
 [GCC 8.2.0]  */
 
@@ -29,215 +29,940 @@
 #define Uprops_SPACE 0x0040
 #define Uprops_PRINTABLE 0x0080
 #define Uprops_TITLE 0x0100
-static uint16_t uprops_runlength[] = {
-0x0,9, 0x40,5, 0x0,14, 0x40,4, 0xc0,1, 0x80,15, 0xb8,10, 0x80,7, 0x85,26, 0x80,6, 0x83,26, 0x80,4, 0x0,6, 0x40,1, 0x0,26, 0x40,1,
-0x80,9, 0x83,1, 0x80,2, 0x0,1, 0x80,4, 0xb0,2, 0x80,1, 0x83,1, 0x80,3, 0xb0,1, 0x83,1, 0x80,1, 0xa0,3, 0x80,1, 0x85,23, 0x80,1,
-0x85,7, 0x83,24, 0x80,1, 0x83,8, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,2, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,3,
-0x85,2, 0x83,1, 0x85,1, 0x83,1, 0x85,2, 0x83,1, 0x85,3, 0x83,2, 0x85,4, 0x83,1, 0x85,2, 0x83,1, 0x85,3, 0x83,3, 0x85,2, 0x83,1,
-0x85,2, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,2, 0x83,1, 0x85,1, 0x83,2, 0x85,1, 0x83,1, 0x85,2, 0x83,1, 0x85,3, 0x83,1,
-0x85,1, 0x83,1, 0x85,2, 0x83,2, 0x81,1, 0x85,1, 0x83,3, 0x81,4, 0x85,1, 0x181,1, 0x83,1, 0x85,1, 0x181,1, 0x83,1, 0x85,1, 0x181,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,2, 0x85,1, 0x181,1, 0x83,1, 0x85,1, 0x83,1, 0x85,3, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,7, 0x85,2, 0x83,1, 0x85,2, 0x83,2, 0x85,1, 0x83,1, 0x85,4, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,69, 0x81,1, 0x83,36, 0x81,7, 0x83,2, 0x80,4, 0x81,12, 0x80,14, 0x83,5, 0x80,7, 0x81,1, 0x80,1, 0x81,1,
-0x80,86, 0x82,1, 0x80,42, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x81,1, 0x80,1, 0x85,1, 0x83,1, 0x0,2, 0x83,4, 0x80,1, 0x85,1, 0x0,4,
-0x80,2, 0x85,1, 0x80,1, 0x85,3, 0x0,1, 0x85,1, 0x0,1, 0x85,2, 0x83,1, 0x85,17, 0x0,1, 0x85,9, 0x83,35, 0x85,1, 0x83,2, 0x85,3,
-0x83,3, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,5, 0x85,1, 0x83,1, 0x80,1, 0x85,1, 0x83,1, 0x85,2, 0x83,2,
-0x85,51, 0x83,48, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x80,8, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,2, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x0,1, 0x85,38, 0x0,2, 0x81,1, 0x80,6, 0x0,1, 0x83,39,
-0x0,1, 0x80,2, 0x0,2, 0x80,3, 0x0,1, 0x80,55, 0x0,8, 0x81,27, 0x0,5, 0x81,3, 0x80,2, 0x0,17, 0x80,22, 0x0,2, 0x80,2, 0x81,43,
-0x80,21, 0xb8,10, 0x80,4, 0x81,2, 0x80,1, 0x81,99, 0x80,1, 0x81,1, 0x80,7, 0x0,1, 0x80,7, 0x81,2, 0x80,7, 0x81,2, 0xb8,10, 0x81,3,
-0x80,2, 0x81,1, 0x80,14, 0x0,2, 0x81,1, 0x80,1, 0x81,30, 0x80,27, 0x0,2, 0x81,89, 0x80,11, 0x81,1, 0x0,14, 0xb8,10, 0x81,33, 0x80,9,
-0x81,2, 0x80,4, 0x81,1, 0x0,5, 0x81,22, 0x80,4, 0x81,1, 0x80,9, 0x81,1, 0x80,3, 0x81,1, 0x80,5, 0x0,2, 0x80,15, 0x0,1, 0x81,25,
-0x80,3, 0x0,2, 0x80,1, 0x0,65, 0x81,21, 0x0,1, 0x81,8, 0x0,22, 0x80,14, 0x0,1, 0x80,33, 0x81,54, 0x80,3, 0x81,1, 0x80,18, 0x81,1,
-0x80,7, 0x81,10, 0x80,4, 0xb8,10, 0x80,1, 0x81,16, 0x80,3, 0x0,1, 0x81,8, 0x0,2, 0x81,2, 0x0,2, 0x81,22, 0x0,1, 0x81,7, 0x0,1,
-0x81,1, 0x0,3, 0x81,4, 0x0,2, 0x80,1, 0x81,1, 0x80,7, 0x0,2, 0x80,2, 0x0,2, 0x80,3, 0x81,1, 0x0,8, 0x80,1, 0x0,4, 0x81,2,
-0x0,1, 0x81,3, 0x80,2, 0x0,2, 0xb8,10, 0x81,2, 0x80,2, 0xa0,6, 0x80,2, 0x0,5, 0x80,3, 0x0,1, 0x81,6, 0x0,4, 0x81,2, 0x0,2,
-0x81,22, 0x0,1, 0x81,7, 0x0,1, 0x81,2, 0x0,1, 0x81,2, 0x0,1, 0x81,2, 0x0,2, 0x80,1, 0x0,1, 0x80,5, 0x0,4, 0x80,2, 0x0,2,
-0x80,3, 0x0,3, 0x80,1, 0x0,7, 0x81,4, 0x0,1, 0x81,1, 0x0,7, 0xb8,10, 0x80,2, 0x81,3, 0x80,1, 0x0,11, 0x80,3, 0x0,1, 0x81,9,
-0x0,1, 0x81,3, 0x0,1, 0x81,22, 0x0,1, 0x81,7, 0x0,1, 0x81,2, 0x0,1, 0x81,5, 0x0,2, 0x80,1, 0x81,1, 0x80,8, 0x0,1, 0x80,3,
-0x0,1, 0x80,3, 0x0,2, 0x81,1, 0x0,15, 0x81,2, 0x80,2, 0x0,2, 0xb8,10, 0x80,2, 0x0,7, 0x81,1, 0x0,7, 0x80,3, 0x0,1, 0x81,8,
-0x0,2, 0x81,2, 0x0,2, 0x81,22, 0x0,1, 0x81,7, 0x0,1, 0x81,2, 0x0,1, 0x81,5, 0x0,2, 0x80,1, 0x81,1, 0x80,7, 0x0,2, 0x80,2,
-0x0,2, 0x80,3, 0x0,8, 0x80,2, 0x0,4, 0x81,2, 0x0,1, 0x81,3, 0x80,2, 0x0,2, 0xb8,10, 0x80,1, 0x81,1, 0xa0,6, 0x0,10, 0x80,1,
-0x81,1, 0x0,1, 0x81,6, 0x0,3, 0x81,3, 0x0,1, 0x81,4, 0x0,3, 0x81,2, 0x0,1, 0x81,1, 0x0,1, 0x81,2, 0x0,3, 0x81,2, 0x0,3,
-0x81,3, 0x0,3, 0x81,12, 0x0,4, 0x80,5, 0x0,3, 0x80,3, 0x0,1, 0x80,4, 0x0,2, 0x81,1, 0x0,6, 0x80,1, 0x0,14, 0xb8,10, 0xa0,3,
-0x80,8, 0x0,5, 0x80,4, 0x0,1, 0x81,8, 0x0,1, 0x81,3, 0x0,1, 0x81,23, 0x0,1, 0x81,16, 0x0,3, 0x81,1, 0x80,7, 0x0,1, 0x80,3,
-0x0,1, 0x80,4, 0x0,7, 0x80,2, 0x0,1, 0x81,3, 0x0,5, 0x81,2, 0x80,2, 0x0,2, 0xb8,10, 0x0,8, 0xa0,7, 0x80,1, 0x81,1, 0x80,3,
-0x0,1, 0x81,8, 0x0,1, 0x81,3, 0x0,1, 0x81,23, 0x0,1, 0x81,10, 0x0,1, 0x81,5, 0x0,2, 0x80,1, 0x81,1, 0x80,7, 0x0,1, 0x80,3,
-0x0,1, 0x80,4, 0x0,7, 0x80,2, 0x0,7, 0x81,1, 0x0,1, 0x81,2, 0x80,2, 0x0,2, 0xb8,10, 0x0,1, 0x81,2, 0x0,14, 0x80,3, 0x0,1,
-0x81,8, 0x0,1, 0x81,3, 0x0,1, 0x81,41, 0x0,2, 0x81,1, 0x80,7, 0x0,1, 0x80,3, 0x0,1, 0x80,4, 0x81,1, 0x80,1, 0x0,4, 0x81,3,
-0x80,1, 0xa0,7, 0x81,3, 0x80,2, 0x0,2, 0xb8,10, 0xa0,9, 0x80,1, 0x81,6, 0x0,2, 0x80,2, 0x0,1, 0x81,18, 0x0,3, 0x81,24, 0x0,1,
-0x81,9, 0x0,1, 0x81,1, 0x0,2, 0x81,7, 0x0,3, 0x80,1, 0x0,4, 0x80,6, 0x0,1, 0x80,1, 0x0,1, 0x80,8, 0x0,6, 0xb8,10, 0x0,2,
-0x80,3, 0x0,12, 0x81,48, 0x80,1, 0x81,2, 0x80,7, 0x0,4, 0x80,1, 0x81,7, 0x80,9, 0xb8,10, 0x80,2, 0x0,37, 0x81,2, 0x0,1, 0x81,1,
-0x0,2, 0x81,2, 0x0,1, 0x81,1, 0x0,2, 0x81,1, 0x0,6, 0x81,4, 0x0,1, 0x81,7, 0x0,1, 0x81,3, 0x0,1, 0x81,1, 0x0,1, 0x81,1,
-0x0,2, 0x81,2, 0x0,1, 0x81,4, 0x80,1, 0x81,2, 0x80,6, 0x0,1, 0x80,2, 0x81,1, 0x0,2, 0x81,5, 0x0,1, 0x81,1, 0x0,1, 0x80,6,
-0x0,2, 0xb8,10, 0x0,2, 0x81,4, 0x0,32, 0x81,1, 0x80,31, 0xb8,10, 0xa0,10, 0x80,12, 0x81,8, 0x0,1, 0x81,36, 0x0,4, 0x80,23, 0x81,5,
-0x80,11, 0x0,1, 0x80,36, 0x0,1, 0x80,15, 0x0,1, 0x80,13, 0x0,37, 0x81,43, 0x80,20, 0x81,1, 0xb8,10, 0x80,6, 0x81,6, 0x80,4, 0x81,4,
-0x80,3, 0x81,1, 0x80,3, 0x81,2, 0x80,7, 0x81,3, 0x80,4, 0x81,13, 0x80,12, 0x81,1, 0x80,1, 0xb8,10, 0x80,6, 0x85,38, 0x0,1, 0x85,1,
-0x0,5, 0x85,1, 0x0,2, 0x81,43, 0x80,1, 0x81,333, 0x0,1, 0x81,4, 0x0,2, 0x81,7, 0x0,1, 0x81,1, 0x0,1, 0x81,4, 0x0,2, 0x81,41,
-0x0,1, 0x81,4, 0x0,2, 0x81,33, 0x0,1, 0x81,4, 0x0,2, 0x81,7, 0x0,1, 0x81,1, 0x0,1, 0x81,4, 0x0,2, 0x81,15, 0x0,1, 0x81,57,
-0x0,1, 0x81,4, 0x0,2, 0x81,67, 0x0,2, 0x80,12, 0xb0,9, 0xa0,11, 0x0,3, 0x81,16, 0x80,10, 0x0,6, 0x85,86, 0x0,2, 0x83,6, 0x0,2,
-0x80,1, 0x81,620, 0x80,2, 0x81,17, 0x40,1, 0x81,26, 0x80,2, 0x0,3, 0x81,75, 0x80,3, 0xa0,3, 0x81,8, 0x0,7, 0x81,13, 0x0,1, 0x81,4,
-0x80,3, 0x0,11, 0x81,18, 0x80,5, 0x0,9, 0x81,18, 0x80,2, 0x0,12, 0x81,13, 0x0,1, 0x81,3, 0x0,1, 0x80,2, 0x0,12, 0x81,52, 0x80,35,
-0x81,1, 0x80,4, 0x81,1, 0x80,1, 0x0,2, 0xb8,10, 0x0,6, 0xa0,10, 0x0,6, 0x80,14, 0x0,2, 0xb8,10, 0x0,6, 0x81,88, 0x0,8, 0x81,5,
-0x80,2, 0x81,34, 0x80,1, 0x81,1, 0x0,5, 0x81,70, 0x0,10, 0x81,31, 0x0,1, 0x80,12, 0x0,4, 0x80,12, 0x0,4, 0x80,1, 0x0,3, 0x80,2,
-0xb8,10, 0x81,30, 0x0,2, 0x81,5, 0x0,11, 0x81,44, 0x0,4, 0x81,26, 0x0,6, 0xb8,10, 0xb0,1, 0x0,3, 0x80,34, 0x81,23, 0x80,5, 0x0,2,
-0x80,2, 0x81,53, 0x80,10, 0x0,1, 0x80,29, 0x0,2, 0x80,1, 0xb8,10, 0x0,6, 0xb8,10, 0x0,6, 0x80,7, 0x81,1, 0x80,6, 0x0,2, 0x80,15,
-0x0,65, 0x80,5, 0x81,47, 0x80,17, 0x81,7, 0x0,4, 0xb8,10, 0x80,35, 0x0,3, 0x80,3, 0x81,30, 0x80,13, 0x81,2, 0xb8,10, 0x81,44, 0x80,14,
-0x0,8, 0x80,4, 0x81,36, 0x80,20, 0x0,3, 0x80,5, 0xb8,10, 0x0,3, 0x81,3, 0xb8,10, 0x81,36, 0x80,2, 0x83,9, 0x0,55, 0x80,8, 0x0,8,
-0x80,25, 0x81,4, 0x80,1, 0x81,4, 0x80,3, 0x81,2, 0x0,1, 0x80,2, 0x0,6, 0x83,192, 0x80,54, 0x0,5, 0x80,5, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,9, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,9, 0x85,8, 0x83,6, 0x0,2, 0x85,6, 0x0,2, 0x83,8, 0x85,8, 0x83,8, 0x85,8, 0x83,6, 0x0,2,
-0x85,6, 0x0,2, 0x83,8, 0x0,1, 0x85,1, 0x0,1, 0x85,1, 0x0,1, 0x85,1, 0x0,1, 0x85,1, 0x83,8, 0x85,8, 0x83,14, 0x0,2, 0x83,8,
-0x181,8, 0x83,8, 0x181,8, 0x83,8, 0x181,8, 0x83,5, 0x0,1, 0x83,2, 0x85,4, 0x181,1, 0x80,1, 0x83,1, 0x80,3, 0x83,3, 0x0,1, 0x83,2,
-0x85,4, 0x181,1, 0x80,3, 0x83,4, 0x0,2, 0x83,2, 0x85,4, 0x0,1, 0x80,3, 0x83,8, 0x85,5, 0x80,3, 0x0,2, 0x83,3, 0x0,1, 0x83,2,
-0x85,4, 0x181,1, 0x80,2, 0x0,1, 0x40,11, 0x0,5, 0x80,24, 0x40,2, 0x0,5, 0x40,1, 0x80,47, 0x40,1, 0x0,16, 0xb0,1, 0x83,1, 0x0,2,
-0xb0,6, 0x80,5, 0x83,1, 0xb0,10, 0x80,5, 0x0,1, 0x83,13, 0x0,3, 0x80,31, 0x0,17, 0x80,33, 0x0,15, 0x80,2, 0x85,1, 0x80,4, 0x85,1,
-0x80,2, 0x83,1, 0x85,3, 0x83,2, 0x85,3, 0x83,1, 0x80,1, 0x85,1, 0x80,3, 0x85,5, 0x80,6, 0x85,1, 0x80,1, 0x85,1, 0x80,1, 0x85,1,
-0x80,1, 0x85,4, 0x80,1, 0x83,1, 0x85,4, 0x83,1, 0x81,4, 0x83,1, 0x80,2, 0x83,2, 0x85,2, 0x80,5, 0x85,1, 0x83,4, 0x80,4, 0x83,1,
-0x80,1, 0xa0,16, 0xa4,16, 0xa2,16, 0xa0,3, 0x85,1, 0x83,1, 0xa0,5, 0x80,2, 0x0,4, 0x80,623, 0x0,1, 0x80,39, 0x0,25, 0x80,11, 0x0,21,
-0xb0,9, 0xa0,11, 0xb0,9, 0xa0,11, 0xb0,9, 0xa0,11, 0x80,26, 0x84,26, 0x82,26, 0xb0,1, 0xa0,10, 0xb0,9, 0xa0,1, 0xb0,1, 0x80,630, 0xb0,9,
-0xa0,1, 0xb0,9, 0xa0,1, 0xb0,9, 0xa0,1, 0x80,992, 0x0,2, 0x80,32, 0x0,2, 0x80,34, 0x0,3, 0x80,12, 0x0,1, 0x80,8, 0x0,26, 0x80,4,
-0x0,16, 0x85,47, 0x0,1, 0x83,47, 0x0,1, 0x85,1, 0x83,1, 0x85,3, 0x83,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,4,
-0x83,1, 0x85,1, 0x83,2, 0x85,1, 0x83,8, 0x85,3, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,2, 0x80,6, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x80,3, 0x85,1,
-0x83,1, 0x0,5, 0x80,4, 0xa0,1, 0x80,2, 0x83,38, 0x0,1, 0x83,1, 0x0,5, 0x83,1, 0x0,2, 0x81,56, 0x0,7, 0x81,1, 0x80,1, 0x0,14,
-0x80,1, 0x81,23, 0x0,9, 0x81,7, 0x0,1, 0x81,7, 0x0,1, 0x81,7, 0x0,1, 0x81,7, 0x0,1, 0x81,7, 0x0,1, 0x81,7, 0x0,1, 0x81,7,
-0x0,1, 0x81,7, 0x0,1, 0x80,79, 0x81,1, 0x80,21, 0x0,59, 0x80,26, 0x0,1, 0x80,89, 0x0,12, 0x80,214, 0x0,26, 0x80,12, 0x0,4, 0x40,1,
-0x80,4, 0x81,2, 0xa0,1, 0x80,25, 0xa0,9, 0x80,7, 0x81,5, 0x80,2, 0xa0,3, 0x81,2, 0x80,3, 0x0,1, 0x81,86, 0x0,2, 0x80,4, 0x81,3,
-0x80,1, 0x81,90, 0x80,1, 0x81,4, 0x0,5, 0x81,41, 0x0,3, 0x81,94, 0x0,1, 0x80,2, 0xa0,4, 0x80,10, 0x81,27, 0x0,5, 0x80,36, 0x0,12,
-0x81,16, 0x80,31, 0x0,1, 0xa0,10, 0x80,30, 0xa0,8, 0x80,1, 0xa0,15, 0x80,32, 0xa0,10, 0x80,39, 0xa0,15, 0x80,63, 0x0,1, 0x80,256, 0x81,5,
-0xa1,1, 0x81,125, 0xa1,1, 0x81,934, 0xa1,1, 0x81,802, 0xa1,1, 0x81,4712, 0x0,10, 0x80,64, 0xa1,1, 0x81,2, 0xa1,1, 0x81,3, 0xa1,1, 0x81,1,
-0xa1,1, 0x81,83, 0xa1,1, 0x81,46, 0xa1,1, 0x81,7, 0xa1,1, 0x81,1, 0xa1,1, 0x81,40, 0xa1,2, 0x81,30, 0xa1,1, 0x81,8, 0xa1,1, 0x81,36,
-0xa1,1, 0x81,98, 0xa1,1, 0x81,403, 0xa1,1, 0x81,65, 0xa1,1, 0x81,34, 0xa1,1, 0x81,1, 0xa1,1, 0x81,1, 0xa1,1, 0x81,467, 0xa1,1, 0x81,1,
-0xa1,3, 0x81,6, 0xa1,1, 0x81,116, 0xa1,4, 0x81,790, 0xa1,1, 0x81,533, 0xa1,1, 0x81,7, 0xa1,1, 0x81,1408, 0xa1,1, 0x81,131, 0xa1,2, 0x81,12,
-0xa1,3, 0x81,1, 0xa1,1, 0x81,1005, 0xa1,1, 0x81,77, 0xa1,1, 0x81,1157, 0xa1,1, 0x81,1843, 0xa1,1, 0x81,1167, 0xa1,1, 0x81,743, 0xa1,1, 0x81,2567,
-0xa1,1, 0x81,933, 0xa1,1, 0x81,2177, 0xa1,1, 0x81,4, 0xa1,1, 0x81,124, 0xa1,1, 0x81,2288, 0xa1,1, 0x81,36, 0xa1,1, 0x81,5, 0xa1,1, 0x81,43,
-0xa1,1, 0x81,125, 0xa1,1, 0x81,2271, 0x0,42, 0x81,1165, 0x0,3, 0x80,55, 0x0,9, 0x81,46, 0x80,2, 0x81,269, 0x80,3, 0x81,16, 0xb8,10, 0x81,2,
-0x0,20, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x81,1,
-0x80,16, 0x81,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,3, 0x80,2, 0x81,70,
-0xa0,10, 0x80,8, 0x0,8, 0x80,23, 0x81,9, 0x80,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,3, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x85,1, 0x83,10, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,2, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1,
-0x81,1, 0x80,2, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x81,1, 0x85,1, 0x83,1, 0x85,1, 0x83,3, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1,
-0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,1, 0x83,1, 0x85,5,
-0x0,1, 0x85,5, 0x83,1, 0x85,1, 0x83,1, 0x0,63, 0x81,1, 0x83,3, 0x81,7, 0x80,1, 0x81,3, 0x80,1, 0x81,4, 0x80,1, 0x81,23, 0x80,9,
-0x0,4, 0xa0,6, 0x80,4, 0x0,6, 0x81,52, 0x80,4, 0x0,8, 0x80,2, 0x81,50, 0x80,18, 0x0,8, 0x80,2, 0xb8,10, 0x0,6, 0x80,18, 0x81,6,
-0x80,3, 0x81,1, 0x80,1, 0x81,1, 0x0,2, 0xb8,10, 0x81,28, 0x80,10, 0x81,23, 0x80,13, 0x0,11, 0x80,1, 0x81,29, 0x0,3, 0x80,4, 0x81,47,
-0x80,27, 0x0,1, 0x81,1, 0xb8,10, 0x0,4, 0x80,2, 0x81,5, 0x80,1, 0x81,10, 0xb8,10, 0x81,5, 0x0,1, 0x81,41, 0x80,14, 0x0,9, 0x81,3,
-0x80,1, 0x81,8, 0x80,2, 0x0,2, 0xb8,10, 0x0,2, 0x80,4, 0x81,23, 0x80,3, 0x81,1, 0x80,3, 0x81,50, 0x80,1, 0x81,1, 0x80,3, 0x81,2,
-0x80,2, 0x81,5, 0x80,2, 0x81,1, 0x80,1, 0x81,1, 0x0,24, 0x81,3, 0x80,2, 0x81,11, 0x80,7, 0x81,3, 0x80,2, 0x0,10, 0x81,6, 0x0,2,
-0x81,6, 0x0,2, 0x81,6, 0x0,9, 0x81,7, 0x0,1, 0x81,7, 0x0,1, 0x83,43, 0x80,1, 0x83,10, 0x0,10, 0x83,80, 0x81,35, 0x80,11, 0x0,2,
-0xb8,10, 0x0,6, 0x81,11172, 0x0,12, 0x81,23, 0x0,4, 0x81,49, 0x0,8452, 0x81,107, 0xa1,1, 0x81,7, 0xa1,1, 0x81,4, 0xa1,1, 0x81,57, 0xa1,1,
-0x81,30, 0xa1,1, 0x81,1, 0xa1,1, 0x81,41, 0xa1,1, 0x81,112, 0x0,2, 0x81,106, 0x0,38, 0x83,7, 0x0,12, 0x83,5, 0x0,5, 0x81,1, 0x80,1,
-0x81,10, 0x80,1, 0x81,13, 0x0,1, 0x81,5, 0x0,1, 0x81,1, 0x0,1, 0x81,2, 0x0,1, 0x81,2, 0x0,1, 0x81,108, 0x80,16, 0x0,17, 0x81,363,
-0x80,2, 0x0,16, 0x81,64, 0x0,2, 0x81,54, 0x0,40, 0x81,12, 0x80,2, 0x0,2, 0x80,26, 0x0,6, 0x80,51, 0x0,1, 0x80,19, 0x0,1, 0x80,4,
-0x0,4, 0x81,5, 0x0,1, 0x81,135, 0x0,4, 0x80,15, 0xb8,10, 0x80,7, 0x85,26, 0x80,6, 0x83,26, 0x80,11, 0x81,89, 0x0,3, 0x81,6, 0x0,2,
-0x81,6, 0x0,2, 0x81,6, 0x0,2, 0x81,3, 0x0,3, 0x80,7, 0x0,1, 0x80,7, 0x0,13, 0x80,2, 0x0,2, 0x81,12, 0x0,1, 0x81,26, 0x0,1,
-0x81,19, 0x0,1, 0x81,2, 0x0,1, 0x81,15, 0x0,2, 0x81,14, 0x0,34, 0x81,123, 0x0,5, 0x80,3, 0x0,4, 0xa0,45, 0x0,3, 0x80,9, 0xa0,57,
-0x80,17, 0xa0,2, 0x80,3, 0x0,1, 0x80,12, 0x0,4, 0x80,1, 0x0,47, 0x80,46, 0x0,130, 0x81,29, 0x0,3, 0x81,49, 0x0,15, 0x80,1, 0xa0,27,
-0x0,4, 0x81,32, 0xa0,4, 0x0,12, 0x81,17, 0xa0,1, 0x81,8, 0xa0,1, 0x0,5, 0x81,38, 0x80,5, 0x0,5, 0x81,30, 0x0,1, 0x80,1, 0x81,36,
-0x0,4, 0x81,8, 0x80,1, 0xa0,5, 0x0,42, 0x85,40, 0x83,40, 0x81,78, 0x0,2, 0xb8,10, 0x0,6, 0x85,36, 0x0,4, 0x83,36, 0x0,4, 0x81,40,
-0x0,8, 0x81,52, 0x0,11, 0x80,1, 0x0,144, 0x81,311, 0x0,9, 0x81,22, 0x0,10, 0x81,8, 0x0,152, 0x81,6, 0x0,2, 0x81,1, 0x0,1, 0x81,44,
-0x0,1, 0x81,2, 0x0,3, 0x81,1, 0x0,2, 0x81,23, 0x0,1, 0x80,1, 0xa0,8, 0x81,23, 0x80,2, 0xa0,7, 0x81,31, 0x0,8, 0xa0,9, 0x0,48,
-0x81,19, 0x0,1, 0x81,2, 0x0,5, 0xa0,5, 0x81,22, 0xa0,6, 0x0,3, 0x80,1, 0x81,26, 0x0,5, 0x80,1, 0x0,64, 0x81,56, 0x0,4, 0xa0,2,
-0x81,2, 0xa0,16, 0x0,2, 0xa0,46, 0x81,1, 0x80,3, 0x0,1, 0x80,2, 0x0,5, 0x80,4, 0x81,4, 0x0,1, 0x81,3, 0x0,1, 0x81,27, 0x0,4,
-0x80,3, 0x0,4, 0x80,1, 0xb0,4, 0xa0,4, 0x0,8, 0x80,9, 0x0,7, 0x81,29, 0xa0,2, 0x80,1, 0x81,29, 0xa0,3, 0x0,32, 0x81,8, 0x80,1,
-0x81,28, 0x80,2, 0x0,4, 0xa0,5, 0x80,7, 0x0,9, 0x81,54, 0x0,3, 0x80,7, 0x81,22, 0x0,2, 0xa0,8, 0x81,19, 0x0,5, 0xa0,8, 0x81,18,
-0x0,7, 0x80,4, 0x0,12, 0xa0,7, 0x0,80, 0x81,73, 0x0,55, 0x85,51, 0x0,13, 0x83,51, 0x0,7, 0xa0,6, 0x0,352, 0xb0,9, 0xa0,22, 0x0,385,
-0x80,3, 0x81,53, 0x80,22, 0x0,4, 0xb0,9, 0xa0,11, 0xb8,10, 0x0,15, 0x80,4, 0x81,45, 0x80,13, 0x0,1, 0x80,4, 0x0,14, 0x81,25, 0x0,7,
-0xb8,10, 0x0,6, 0x80,3, 0x81,36, 0x80,14, 0x0,1, 0xb8,10, 0x80,4, 0x0,12, 0x81,35, 0x80,3, 0x81,1, 0x0,9, 0x80,3, 0x81,48, 0x80,14,
-0x81,4, 0x80,9, 0x0,2, 0xb8,10, 0x81,1, 0x80,1, 0x81,1, 0x80,3, 0x0,1, 0xa0,20, 0x0,11, 0x81,18, 0x0,1, 0x81,25, 0x80,19, 0x0,65,
-0x81,7, 0x0,1, 0x81,1, 0x0,1, 0x81,4, 0x0,1, 0x81,15, 0x0,1, 0x81,10, 0x80,1, 0x0,6, 0x81,47, 0x80,12, 0x0,5, 0xb8,10, 0x0,6,
-0x80,4, 0x0,1, 0x81,8, 0x0,2, 0x81,2, 0x0,2, 0x81,22, 0x0,1, 0x81,7, 0x0,1, 0x81,2, 0x0,1, 0x81,5, 0x0,2, 0x80,1, 0x81,1,
-0x80,7, 0x0,2, 0x80,2, 0x0,2, 0x80,3, 0x0,2, 0x81,1, 0x0,6, 0x80,1, 0x0,5, 0x81,5, 0x80,2, 0x0,2, 0x80,7, 0x0,3, 0x80,5,
-0x0,139, 0x81,53, 0x80,18, 0x81,4, 0x80,5, 0xb8,10, 0x0,1, 0x80,1, 0x0,1, 0x80,1, 0x0,34, 0x81,48, 0x80,20, 0x81,2, 0x80,1, 0x81,1,
-0x0,8, 0xb8,10, 0x0,166, 0x81,47, 0x80,7, 0x0,2, 0x80,32, 0x81,4, 0x80,2, 0x0,34, 0x81,48, 0x80,20, 0x81,1, 0x0,11, 0xb8,10, 0x0,6,
-0x80,13, 0x0,19, 0x81,43, 0x80,13, 0x0,8, 0xb8,10, 0x0,54, 0x81,26, 0x0,3, 0x80,15, 0x0,4, 0xb8,10, 0xa0,2, 0x80,4, 0x0,352, 0x85,32,
-0x83,32, 0xb8,10, 0xa0,9, 0x0,12, 0x81,1, 0x0,448, 0x81,57, 0x0,263, 0x81,9, 0x0,1, 0x81,37, 0x80,8, 0x0,1, 0x80,8, 0x81,1, 0x80,5,
-0x0,10, 0xb8,10, 0xa0,19, 0x0,3, 0x80,2, 0x81,30, 0x0,2, 0x80,22, 0x0,1, 0x80,14, 0x0,841, 0x81,922, 0x0,102, 0xa0,111, 0x0,1, 0x80,5,
-0x0,11, 0x81,196, 0x0,2748, 0x81,1071, 0x0,4049, 0x81,583, 0x0,8633, 0x81,569, 0x0,7, 0x81,31, 0x0,1, 0xb8,10, 0x0,4, 0x80,2, 0x0,96, 0x81,30,
-0x0,2, 0x80,6, 0x0,10, 0x81,48, 0x80,16, 0x81,4, 0x80,2, 0x0,10, 0xb8,10, 0x0,1, 0xa0,7, 0x0,1, 0x81,21, 0x0,5, 0x81,19, 0x0,880,
-0x81,69, 0x0,11, 0x81,1, 0x80,46, 0x0,16, 0x80,4, 0x81,13, 0x0,64, 0x81,1, 0x0,31, 0x81,6125, 0x0,19, 0x81,755, 0x0,9485, 0x81,2, 0x0,3070,
-0x81,107, 0x0,5, 0x81,13, 0x0,3, 0x81,9, 0x0,7, 0x81,10, 0x0,2, 0x80,4, 0x0,4960, 0x80,246, 0x0,10, 0x80,39, 0x0,2, 0x80,74, 0x0,8,
-0x80,110, 0x0,23, 0x80,70, 0x0,186, 0x80,87, 0x0,9, 0xa0,18, 0x0,142, 0x85,26, 0x83,26, 0x85,26, 0x83,7, 0x0,1, 0x83,18, 0x85,26, 0x83,26,
-0x85,1, 0x0,1, 0x85,2, 0x0,2, 0x85,1, 0x0,2, 0x85,2, 0x0,2, 0x85,4, 0x0,1, 0x85,8, 0x83,4, 0x0,1, 0x83,1, 0x0,1, 0x83,7,
-0x0,1, 0x83,11, 0x85,26, 0x83,26, 0x85,2, 0x0,1, 0x85,4, 0x0,2, 0x85,8, 0x0,1, 0x85,7, 0x0,1, 0x83,26, 0x85,2, 0x0,1, 0x85,4,
-0x0,1, 0x85,5, 0x0,1, 0x85,1, 0x0,3, 0x85,7, 0x0,1, 0x83,26, 0x85,26, 0x83,26, 0x85,26, 0x83,26, 0x85,26, 0x83,26, 0x85,26, 0x83,26,
-0x85,26, 0x83,26, 0x85,26, 0x83,28, 0x0,2, 0x85,25, 0x80,1, 0x83,25, 0x80,1, 0x83,6, 0x85,25, 0x80,1, 0x83,25, 0x80,1, 0x83,6, 0x85,25,
-0x80,1, 0x83,25, 0x80,1, 0x83,6, 0x85,25, 0x80,1, 0x83,25, 0x80,1, 0x83,6, 0x85,25, 0x80,1, 0x83,25, 0x80,1, 0x83,6, 0x85,1, 0x83,1,
-0x0,2, 0xb8,50, 0x80,652, 0x0,15, 0x80,5, 0x0,1, 0x80,15, 0x0,1360, 0x80,7, 0x0,1, 0x80,17, 0x0,2, 0x80,7, 0x0,1, 0x80,2, 0x0,1,
-0x80,5, 0x0,2005, 0x81,197, 0x0,2, 0xa0,9, 0x80,7, 0x0,41, 0x85,34, 0x83,34, 0x80,7, 0x0,5, 0xb8,10, 0x0,4, 0x80,2, 0x0,1184, 0x81,4,
-0x0,1, 0x81,27, 0x0,1, 0x81,2, 0x0,1, 0x81,1, 0x0,2, 0x81,1, 0x0,1, 0x81,10, 0x0,1, 0x81,4, 0x0,1, 0x81,1, 0x0,1, 0x81,1,
-0x0,6, 0x81,1, 0x0,4, 0x81,1, 0x0,1, 0x81,1, 0x0,1, 0x81,1, 0x0,1, 0x81,3, 0x0,1, 0x81,2, 0x0,1, 0x81,1, 0x0,2, 0x81,1,
-0x0,1, 0x81,1, 0x0,1, 0x81,1, 0x0,1, 0x81,1, 0x0,1, 0x81,1, 0x0,1, 0x81,2, 0x0,1, 0x81,1, 0x0,2, 0x81,4, 0x0,1, 0x81,7,
-0x0,1, 0x81,4, 0x0,1, 0x81,4, 0x0,1, 0x81,1, 0x0,1, 0x81,10, 0x0,1, 0x81,17, 0x0,5, 0x81,3, 0x0,1, 0x81,5, 0x0,1, 0x81,17,
-0x0,52, 0x80,2, 0x0,270, 0x80,44, 0x0,4, 0x80,100, 0x0,12, 0x80,15, 0x0,2, 0x80,15, 0x0,1, 0x80,15, 0x0,1, 0x80,37, 0x0,10, 0xb0,11,
-0xa0,2, 0x0,3, 0x80,31, 0x0,1, 0x84,26, 0x80,6, 0x84,26, 0x80,2, 0x0,4, 0x84,26, 0x80,35, 0x0,57, 0x80,29, 0x0,13, 0x80,44, 0x0,4,
-0x80,9, 0x0,7, 0x80,2, 0x0,174, 0x80,979, 0x0,13, 0x80,13, 0x0,3, 0x80,7, 0x0,9, 0x80,116, 0x0,12, 0x80,85, 0x0,43, 0x80,12, 0x0,4,
-0x80,56, 0x0,8, 0x80,10, 0x0,6, 0x80,40, 0x0,8, 0x80,30, 0x0,98, 0x80,15, 0x0,1, 0x80,8, 0x0,8, 0x80,1, 0x0,2, 0x80,12, 0x0,1,
-0x80,12, 0x0,4, 0x80,15, 0x0,33, 0x80,18, 0x0,46, 0x80,1, 0x0,1599, 0x81,1, 0xa1,1, 0x81,98, 0xa1,1, 0x81,125, 0xa1,1, 0x81,62, 0xa1,1,
-0x81,2056, 0xa1,1, 0x81,88, 0xa1,1, 0x81,8, 0xa1,1, 0x81,15, 0xa1,1, 0x81,333, 0xa1,1, 0x81,18, 0xa1,1, 0x81,27, 0xa1,1, 0x81,6262, 0xa1,1,
-0x81,1543, 0xa1,1, 0x81,4482, 0xa1,1, 0x81,10065, 0xa1,1, 0x81,17513, 0x0,41, 0x81,4149, 0x0,11, 0x81,222, 0x0,2, 0x81,5762, 0x0,10590, 0x81,144, 0xa1,1,
-0x81,397, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,65535, 0x0,1773, 0x80,240, 0x0,65535, 0x0,65535,
-0x0,65042
+
+#define UPROPS_SHIFT1 6
+#define UPROPS_SHIFT2 2
+#define UPROPS_LIMIT 0xe01f0
+
+static const uint16_t uprops_latin1[256] = {
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x40, 0x40, 0x40, 0x40,
+    0xc0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0xb8, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85,
+    0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83,
+    0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x80, 0x80, 0x80, 0x80, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x40, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x83, 0x80, 0x80, 0x0, 0x80, 0x80,
+    0x80, 0x80, 0xb0, 0xb0, 0x80, 0x83, 0x80, 0x80, 0x80, 0xb0, 0x83, 0x80, 0xa0, 0xa0, 0xa0, 0x80,
+    0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85,
+    0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x80, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x83,
+    0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83,
+    0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x80, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83,
+};
+
+static const uint16_t uprops_records[16] = {
+    0x0, 0x40, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0xa0, 0xa1, 0xa2, 0xa4, 0xb0, 0xb8, 0xc0, 0x181,
 };
 
-// check 0x110000 == 0x110000
+static const uint8_t uprops_index0[3586] = {
+    0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x11, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e,
+    0x1f, 0x20, 0x21, 0x22, 0x23, 0x21, 0x21, 0x24, 0x21, 0x21, 0x21, 0x25, 0x26, 0x27, 0x28, 0x29,
+    0x2a, 0x2b, 0x2c, 0x21, 0x2d, 0x11, 0x11, 0x11, 0x2e, 0x11, 0x11, 0x2f, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x30, 0x31, 0x32,
+    0x11, 0x33, 0x11, 0x34, 0x11, 0x11, 0x35, 0x11, 0x36, 0x11, 0x11, 0x11, 0x11, 0x11, 0x37, 0x38,
+    0x11, 0x11, 0x39, 0x3a, 0x11, 0x11, 0x11, 0x3b, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x3c,
+    0x11, 0x11, 0x11, 0x3d, 0x11, 0x11, 0x3e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x3f, 0x11, 0x11, 0x11, 0x40, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x41, 0x42, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x43, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x44,
+    0x11, 0x11, 0x11, 0x11, 0x45, 0x11, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x4c, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4e, 0x4f, 0x50, 0x11, 0x51, 0x52, 0x53,
+    0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x11, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x4d, 0x60, 0x4d,
+    0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x4d, 0x6a, 0x4d, 0x6b, 0x4d, 0x4d, 0x4d,
+    0x11, 0x11, 0x11, 0x6c, 0x6d, 0x6e, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x11, 0x11, 0x11, 0x11, 0x6f, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x11, 0x11, 0x70, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x11, 0x11, 0x71, 0x72, 0x4d, 0x4d, 0x4d, 0x73,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x74, 0x11, 0x11, 0x75, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x76, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x77, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x21, 0x21, 0x80, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x81, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x82, 0x83, 0x4d, 0x4d, 0x4d, 0x4d, 0x84, 0x4d,
+    0x85, 0x86, 0x87, 0x21, 0x21, 0x21, 0x88, 0x89, 0x8a, 0x8b, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x8c, 0x8d, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x8e, 0x8f, 0x90, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x91, 0x11, 0x11, 0x11, 0x11, 0x11, 0x92, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x93, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x94, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x95, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x96, 0x97, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x98, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x91, 0x11, 0x99, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d, 0x4d,
+    0x4d, 0x9a,
+};
+
+static const uint8_t uprops_index1[9916] = {
+    0x0, 0x0, 0x1, 0x2, 0x0, 0x0, 0x0, 0x3, 0x4, 0x5, 0x5, 0x5, 0x6, 0x6, 0x7, 0x5,
+    0x8, 0x9, 0x9, 0x9, 0x9, 0x9, 0xa, 0x5, 0xb, 0xc, 0xc, 0xc, 0xc, 0xc, 0xd, 0xe,
+    0x0, 0xf, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x10, 0x5, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0xa, 0x9, 0x17, 0xc, 0xc, 0xc, 0xc, 0xc, 0xd, 0xc, 0xc,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x19, 0x19,
+    0x19, 0x19, 0x1a, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1b, 0x1c,
+    0x1d, 0x1e, 0x1f, 0x20, 0x1b, 0x1e, 0x21, 0x1b, 0x18, 0x1e, 0x1c, 0x1e, 0x1f, 0x19, 0x22, 0x21,
+    0x23, 0x24, 0x25, 0x19, 0x19, 0x19, 0x19, 0x1a, 0x18, 0x18, 0x18, 0x18, 0x26, 0x1e, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xc, 0x20, 0x1d,
+    0x19, 0x17, 0x18, 0x18, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0x27, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x28, 0x23,
+    0x29, 0x2a, 0x23, 0x23, 0x2b, 0x5, 0x5, 0x5, 0xc, 0x2c, 0x5, 0x2d, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x2e, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x18, 0x2f, 0x30, 0x31,
+    0x0, 0x32, 0x33, 0x34, 0x1f, 0x9, 0x9, 0x9, 0x35, 0x9, 0x9, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0x36, 0x20, 0x21, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xc, 0x37, 0x1d, 0x1f,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x38, 0x5, 0x39, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x1b, 0x19, 0x19, 0x1c, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3a, 0x9, 0x9, 0x9,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x33, 0x3b, 0x5, 0x3c, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0x3d, 0x3e, 0x3e, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x40, 0x41, 0x0, 0x0,
+    0x0, 0x42, 0x5, 0x5, 0x5, 0x5, 0x5, 0x42, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x40, 0x5, 0x5, 0x5, 0x5, 0x5, 0x6, 0x6, 0x7, 0x2a, 0x43, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x44, 0x5, 0x12, 0x5, 0x45, 0x5, 0x2a, 0x6, 0x6, 0x46, 0x47,
+    0x5, 0x5, 0x5, 0x48, 0x49, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0xe, 0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0x5, 0x5, 0x4b, 0x0, 0x0, 0x0,
+    0x6, 0x6, 0x46, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x2b, 0x4c, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0x4d, 0x5, 0x5, 0x4e, 0x4e, 0x48, 0x5, 0x5, 0x5, 0xe,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x4e, 0x4f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x51,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0x52, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0x44,
+    0x5, 0x5, 0x5, 0x5, 0x4e, 0x5, 0x23, 0x23, 0x2b, 0x53, 0x6, 0x6, 0x43, 0x23, 0x23, 0x23,
+    0x4e, 0x4a, 0x23, 0x54, 0x54, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x55, 0x56, 0x51, 0x44,
+    0x5, 0x57, 0x57, 0x4c, 0x0, 0x58, 0x0, 0x59, 0x2b, 0x5a, 0x6, 0x6, 0x2b, 0x5b, 0x5c, 0x0,
+    0x3e, 0x4a, 0x3f, 0x5d, 0x54, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x50, 0x5e, 0x51, 0x12,
+    0xe, 0x58, 0x57, 0x48, 0x5f, 0x0, 0x4a, 0x55, 0x0, 0x5a, 0x6, 0x6, 0x2a, 0x60, 0x0, 0x0,
+    0x3e, 0x4a, 0x23, 0x59, 0x59, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x50, 0x4a, 0x51, 0x44,
+    0x5, 0x52, 0x52, 0x48, 0x61, 0x0, 0x0, 0x0, 0x2b, 0x5a, 0x6, 0x6, 0x48, 0x0, 0x62, 0x0,
+    0x3e, 0x4a, 0x23, 0x54, 0x54, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x50, 0x4a, 0x51, 0x44,
+    0x5, 0x57, 0x57, 0x48, 0x0, 0x42, 0x0, 0x59, 0x2b, 0x5a, 0x6, 0x6, 0x63, 0x5b, 0x0, 0x0,
+    0x64, 0x4a, 0x3f, 0x56, 0x50, 0x51, 0x5e, 0x50, 0x5d, 0x61, 0x3f, 0x56, 0x23, 0x23, 0x51, 0x42,
+    0xe, 0x42, 0x12, 0x48, 0x61, 0x58, 0x0, 0x0, 0x0, 0x5a, 0x6, 0x6, 0x16, 0x5, 0xe, 0x0,
+    0x5, 0x4a, 0x23, 0x50, 0x50, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x23, 0x23, 0x51, 0x3b,
+    0x5, 0x12, 0x12, 0x48, 0x0, 0x3d, 0x3f, 0x0, 0x2b, 0x5a, 0x6, 0x6, 0x0, 0x0, 0x5b, 0x16,
+    0x4e, 0x4a, 0x23, 0x50, 0x50, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x23, 0x4a, 0x51, 0x44,
+    0x5, 0x12, 0x12, 0x48, 0x0, 0x3d, 0x0, 0x65, 0x2b, 0x5a, 0x6, 0x6, 0x5e, 0x0, 0x0, 0x0,
+    0x3e, 0x4a, 0x23, 0x50, 0x50, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x3b,
+    0x5, 0x12, 0x12, 0x4d, 0x0, 0x40, 0x5b, 0x66, 0x2b, 0x5a, 0x6, 0x6, 0x5b, 0x5b, 0x67, 0x23,
+    0x42, 0x4a, 0x23, 0x23, 0x23, 0x3f, 0x56, 0x23, 0x23, 0x23, 0x23, 0x23, 0x59, 0x23, 0x23, 0x62,
+    0x23, 0x3f, 0x4f, 0x58, 0x5, 0x68, 0x5, 0x5, 0x0, 0x5a, 0x6, 0x6, 0x42, 0x41, 0x0, 0x0,
+    0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x49, 0x5, 0xe, 0x58,
+    0x23, 0x40, 0x5, 0x5, 0x6, 0x6, 0x7, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5e, 0x54, 0x55, 0x62, 0x0, 0x23, 0x4a, 0x23, 0x4a, 0x69, 0x56, 0x4a, 0x49, 0x5, 0x52, 0x4b,
+    0x23, 0x55, 0x5, 0x48, 0x6, 0x6, 0x6a, 0x23, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x4e, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x6, 0x6, 0x6b, 0x5b, 0x5b, 0x5, 0x5, 0x5,
+    0x23, 0x23, 0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x3e, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x23, 0x4e, 0x5, 0x5, 0x3e, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x12,
+    0x5, 0x5, 0x5, 0x12, 0x5, 0x5, 0xe, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x5, 0x5, 0x6c,
+    0x6, 0x6, 0x7, 0x5, 0x23, 0x2b, 0x2a, 0x2b, 0x44, 0x45, 0x5, 0x2a, 0x4e, 0x43, 0x23, 0x23,
+    0x2b, 0x5, 0x5, 0x4d, 0x6, 0x6, 0x7, 0x5, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9,
+    0x9, 0x35, 0x0, 0x6d, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x50, 0x51, 0x23, 0x3f, 0x50, 0x51, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x50, 0x51, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x51, 0x23, 0x3f,
+    0x50, 0x51, 0x23, 0x23, 0x23, 0x3f, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x50, 0x51, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x3e, 0x5, 0x5, 0x6e, 0x6f, 0x70, 0x5b, 0x5b, 0x71,
+    0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x48, 0x0, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x72, 0xc, 0x73,
+    0x43, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x47, 0x23, 0x23, 0x23, 0x23,
+    0x74, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x41, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x75, 0x76, 0x23, 0x61, 0x0,
+    0x23, 0x23, 0x23, 0x50, 0x2b, 0x41, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x2b, 0xe, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x2b, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x50, 0x77, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x6c, 0x5, 0x60, 0x6, 0x6, 0x6a, 0x0, 0x5b, 0x5b, 0x78, 0x0,
+    0x5, 0x5, 0x5, 0x48, 0x6, 0x6, 0x6a, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x0,
+    0x23, 0x47, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x79, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x5, 0x5, 0x5, 0x0, 0x5, 0x5, 0x5, 0x0,
+    0x41, 0x53, 0x6, 0x6, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x23, 0x61, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x51, 0x0, 0x6, 0x6, 0x7a, 0x42, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x42, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x4e, 0x5, 0xe, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x57,
+    0x6, 0x6, 0x6a, 0x0, 0x6, 0x6, 0x6a, 0x0, 0x5, 0x6c, 0x5, 0x48, 0x5, 0x5, 0x5, 0xe,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x43, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5,
+    0x5, 0x43, 0x23, 0x0, 0x6, 0x6, 0x7, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x41,
+    0x6c, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x4e, 0x5, 0x5, 0x2a, 0x6, 0x6, 0x46, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0x5, 0x5, 0x5, 0x0, 0x0, 0x5,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x5, 0x5, 0x58, 0x5,
+    0x6, 0x6, 0x6a, 0x4a, 0x6, 0x6, 0x46, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b,
+    0xc, 0xc, 0x7b, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x0, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x43, 0x49, 0x2b, 0x7c, 0x48, 0x0,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x58, 0x5,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x21, 0xc, 0x1a, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0xc, 0xc, 0x9, 0x9, 0xc, 0x73, 0x9, 0x72, 0xc, 0xc, 0x9, 0x9, 0xc, 0xc, 0x9, 0x9,
+    0xc, 0x73, 0x9, 0x72, 0xc, 0xc, 0x7d, 0x7d, 0xc, 0xc, 0x9, 0x9, 0xc, 0xc, 0xc, 0x73,
+    0xc, 0xc, 0x7e, 0x7e, 0xc, 0xc, 0x7e, 0x7e, 0xc, 0xc, 0x7e, 0x7e, 0xc, 0x7f, 0x9, 0x80,
+    0x81, 0x7f, 0x9, 0x82, 0xc, 0x30, 0x9, 0x3e, 0xc, 0xc, 0x9, 0x83, 0x30, 0x7f, 0x9, 0x84,
+    0x3, 0x3, 0x85, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x2, 0x86, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x87, 0x0, 0x0, 0x0, 0x0, 0x88, 0x6f, 0x89, 0x8a,
+    0x6f, 0x6f, 0x89, 0xe, 0xc, 0xc, 0xc, 0x7b, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe,
+    0x0, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x41, 0x0, 0x0, 0x0,
+    0x32, 0x8b, 0x8c, 0x8d, 0x17, 0x8e, 0x8, 0x8f, 0x5, 0x90, 0x91, 0x92, 0x9, 0x28, 0x93, 0x20,
+    0x5, 0x94, 0x29, 0x11, 0x5b, 0x5b, 0x5b, 0x5b, 0x95, 0x95, 0x95, 0x95, 0x96, 0x96, 0x96, 0x96,
+    0x97, 0x98, 0x5c, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0xe, 0x0, 0x0, 0x0, 0x0, 0x0, 0x6f, 0x6f, 0x99, 0x5b, 0x5b, 0x6f, 0x6f, 0x99,
+    0x5b, 0x5b, 0x6f, 0x6f, 0x99, 0x5b, 0x5b, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x9a, 0x9b, 0x9b,
+    0x9b, 0x9b, 0x9b, 0x9b, 0x9c, 0x9c, 0x9c, 0x9c, 0x9c, 0x9c, 0x9d, 0x5b, 0x5b, 0x9e, 0x6f, 0x9f,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x13, 0x6f, 0xa0,
+    0x6f, 0x6f, 0xa1, 0x6f, 0xa0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x42, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x3e,
+    0x5, 0x5, 0x12, 0x5, 0x48, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x5, 0x0, 0x0, 0x0, 0x0,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x33, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xa2, 0x1e, 0xa3, 0x19, 0x1f, 0x18, 0x1c, 0xc, 0x20,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x2c, 0x8b, 0xa4, 0x39, 0x0, 0x3e, 0xa5,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xa6, 0x0, 0xa7, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x5d, 0x41, 0x0, 0x0, 0x58,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x0, 0x23, 0x3f, 0x23, 0x3f, 0x23, 0x3f, 0x23, 0x3f,
+    0x23, 0x3f, 0x23, 0x3f, 0x23, 0x3f, 0x23, 0x3f, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x6c, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x41, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x52, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0x0,
+    0x10, 0xa8, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xa9, 0x5b, 0x5c, 0x5, 0x43, 0x2b, 0x66, 0x4e,
+    0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x3e, 0x43, 0x43, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x23,
+    0x0, 0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x4a, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x3f, 0x75, 0x5c, 0x5, 0x5, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe, 0x5b, 0x5b, 0x5c, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5b, 0x5b, 0xa9, 0x5b, 0x5b, 0x5b, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5b, 0x5b, 0x5c, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xa9, 0x5b, 0x5b, 0x5b,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe,
+    0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0xab, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0xad, 0xab, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0xae, 0x23, 0xaf, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xab,
+    0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xab, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xb0, 0xaa, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0xb0, 0xb1, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0xb2, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xab, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa, 0x23, 0xaa, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xb3,
+    0x23, 0x23, 0x23, 0xb4, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0xab, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0xac, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xae, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x61, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0xe, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b,
+    0x23, 0x23, 0x23, 0x4e, 0x23, 0x23, 0x23, 0x23, 0x6, 0x6, 0x46, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xb5, 0x5, 0x5, 0x5, 0x6c,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x29, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xb6, 0x5b, 0x5b, 0x5, 0x5, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x6c, 0x23, 0x23, 0x39, 0x18, 0x18, 0x18, 0x1a, 0x18, 0x18, 0x18,
+    0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xc, 0xc, 0x19, 0x1d,
+    0x18, 0x18, 0xb7, 0xb8, 0x18, 0x1a, 0x18, 0x18, 0x18, 0x18, 0x1e, 0x33, 0x9, 0x18, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x5d, 0xb9, 0x23,
+    0xba, 0xba, 0x40, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x0, 0x5b, 0x5c, 0x48, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x0, 0x0,
+    0x2a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5,
+    0x5, 0x48, 0x0, 0x42, 0x6, 0x6, 0x6a, 0x0, 0x5, 0x5, 0x5, 0x5, 0x2a, 0x23, 0x6c, 0x4b,
+    0x6, 0x6, 0x46, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0x5, 0x5, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x40, 0x5, 0x5, 0x5, 0x0, 0x0, 0x58, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61,
+    0x5, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0xbb, 0x6, 0x6, 0x6a, 0x42, 0x23, 0x49, 0x23, 0x23, 0x6, 0x6, 0x46, 0x3f,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x4e, 0x5, 0x5, 0xe, 0x0, 0x0,
+    0x40, 0x23, 0x23, 0x48, 0x6, 0x6, 0x6a, 0x5, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x4d, 0x2a,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x44, 0x45, 0x43, 0x2b,
+    0x79, 0x0, 0x0, 0x0, 0x0, 0x0, 0x5d, 0x2b, 0x23, 0x23, 0x40, 0x5, 0x2a, 0xbc, 0x0, 0x0,
+    0x4a, 0x3f, 0x4a, 0x3f, 0x4a, 0x3f, 0x0, 0x0, 0x23, 0x3f, 0x23, 0x3f, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xd, 0xc, 0xc, 0x73, 0x0, 0x0, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x48, 0x6, 0x6, 0x6a, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x3f, 0x5d, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xab, 0x23, 0xab, 0x23, 0xae, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0xb0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0xc, 0xa2, 0x0, 0x0, 0xbd, 0xc, 0x0, 0xbe, 0x23, 0x23, 0x49, 0x23, 0x23, 0x3f, 0x23, 0x55,
+    0x59, 0x50, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0x5, 0x5, 0x5,
+    0x48, 0x0, 0x0, 0x0, 0x5d, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b,
+    0x0, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x56, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x48,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0xe, 0x5, 0x5, 0x5, 0x5, 0xe, 0x5, 0x0, 0x23, 0x50, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61,
+    0x3e, 0x5, 0x5, 0x5, 0x6, 0x6, 0x7, 0x5, 0x8, 0x9, 0x9, 0x9, 0x9, 0x9, 0xa, 0x5,
+    0xb, 0xc, 0xc, 0xc, 0xc, 0xc, 0xd, 0x5, 0x5, 0x2a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f,
+    0x56, 0x23, 0x56, 0x23, 0x56, 0x23, 0x56, 0x61, 0x5, 0xe, 0x5, 0xe, 0x0, 0x0, 0x0, 0x48,
+    0x23, 0x23, 0x23, 0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x59,
+    0x23, 0x23, 0x23, 0x51, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0,
+    0xe, 0xbf, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x58, 0x5, 0x5,
+    0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0xc0, 0x5,
+    0x5, 0x5, 0x75, 0xe, 0x5, 0x5, 0x5, 0x0, 0x41, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x61, 0x0, 0x0, 0x0, 0xa9, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5b, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0xc1, 0x23, 0xc2, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x2b, 0xe, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xc3, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x0, 0x23, 0x23, 0xa9, 0x78, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x6, 0x6, 0x6a, 0x0, 0x9, 0x9, 0x9, 0x9,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x0, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x0, 0x58, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x23, 0x23, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x51, 0x50, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x59, 0x61, 0x54,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0xc3, 0x5b, 0x5b, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0xa9, 0x5b,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0xbf, 0x5b, 0x5b, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x51, 0xbf, 0x5b,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0xb6, 0x5b, 0x58, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x58,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0xc4,
+    0x5b, 0x5b, 0x5b, 0x5b, 0xc5, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b,
+    0x4e, 0x3d, 0x0, 0x5, 0x23, 0x4a, 0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0xe, 0x58,
+    0x6f, 0x5b, 0x0, 0x0, 0x5, 0x5, 0x41, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xc6,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xc7, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x43, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xbc, 0xbf, 0x5b, 0x5, 0xe, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x3e, 0x5,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x5b, 0x5b, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x5b, 0x5b,
+    0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x3e, 0x41, 0x0, 0x0, 0xc8, 0x5b, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x61, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x33, 0x0, 0x0, 0x0,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xa2, 0x0, 0xc5, 0x5b,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x6f, 0x6f, 0x99, 0x5b, 0x5b, 0x5b, 0x5b, 0xc9,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x6c, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x48, 0xca, 0x6f, 0xa0, 0x5b, 0x5b, 0xcb, 0x6, 0x6, 0x0, 0x0, 0x0, 0x58,
+    0x6c, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x12,
+    0x48, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x0, 0x6, 0x6, 0x6a, 0x0,
+    0x6c, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x5, 0xcc, 0x6, 0x6,
+    0x5, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x4c, 0x0, 0x0,
+    0x6c, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x5,
+    0x43, 0x4e, 0x5, 0x48, 0x6, 0x6, 0xcd, 0x4e, 0xc8, 0x5b, 0x5b, 0x5b, 0x5b, 0x71, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x59, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x5, 0xe,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x3f, 0x50, 0x59, 0x23, 0x23, 0x23, 0x59, 0x23, 0x23, 0x60, 0x0, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0xe, 0x0, 0x6, 0x6, 0x6a, 0x0,
+    0x5, 0x4a, 0x23, 0x54, 0x54, 0x23, 0x23, 0x23, 0x23, 0x23, 0x50, 0x23, 0x50, 0x4a, 0x51, 0x44,
+    0x5, 0x57, 0x57, 0x48, 0x61, 0x58, 0x0, 0x4a, 0x2b, 0x42, 0x5, 0x41, 0x5, 0x41, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x4e, 0x5, 0x5,
+    0x5, 0x6c, 0x40, 0x5, 0x6, 0x6, 0xce, 0x5f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0xba, 0x0, 0x0, 0x6, 0x6, 0x6a, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x48, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x23, 0x48, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x61, 0x0, 0x0, 0x6, 0x6, 0x6a, 0x0, 0x5, 0x5, 0x5, 0x41, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0x5, 0x5, 0x0, 0x0,
+    0x6, 0x6, 0x6a, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x3e, 0x5, 0x5, 0x5, 0x0, 0x6, 0x6, 0x6b, 0x5,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x6, 0x6, 0x6b, 0x5b, 0xc9, 0x0, 0x0, 0x5d,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x0,
+    0x23, 0x23, 0x50, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x40, 0x5, 0xe, 0x5, 0x5,
+    0x4e, 0x48, 0x0, 0x0, 0x6, 0x6, 0x6b, 0x5b, 0x5b, 0x5b, 0x5b, 0x71, 0x2a, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x42, 0x5, 0x5, 0x5, 0x5, 0x5, 0x3e, 0x5, 0x5, 0xe, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b,
+    0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0x5b, 0xc9, 0x5, 0x41, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x3f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x6, 0x6, 0x6a, 0x42, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x5, 0x48, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5, 0x5, 0x5, 0x5,
+    0x23, 0x48, 0x0, 0x0, 0x6, 0x6, 0xcf, 0x5b, 0xd0, 0x23, 0x23, 0x23, 0x23, 0x23, 0x0, 0x4a,
+    0x23, 0x23, 0x23, 0x23, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x61, 0x0, 0x0, 0x4e, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe,
+    0x0, 0x0, 0x0, 0x58, 0x6c, 0x23, 0x23, 0x23, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x61, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x0, 0x0,
+    0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x23, 0x23, 0x23, 0x61,
+    0x23, 0x23, 0x61, 0x0, 0x23, 0x23, 0x51, 0x5, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe, 0x3e, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe, 0x0, 0x58, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x41, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x48, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0xe, 0x0, 0x0, 0x5b, 0x5b, 0x5b, 0x5b, 0x78, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x9, 0x9, 0x9,
+    0x9, 0x9, 0x9, 0x8d, 0xc, 0x7f, 0xc, 0xc, 0xc, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9,
+    0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x34, 0xd1, 0xd2, 0x3a, 0x34, 0x9, 0x8d, 0xa6, 0x3c,
+    0xc, 0x3c, 0xc, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0x35, 0x33, 0x3a, 0x9, 0x34, 0x9, 0xd3, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x35, 0x33,
+    0x9, 0xd4, 0xd5, 0x9, 0xd3, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9,
+    0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x9,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x9, 0x9, 0x9, 0x9,
+    0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0x73, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9,
+    0xd6, 0xc, 0xc, 0xc, 0xc, 0xc, 0xd, 0xc, 0x20, 0x9, 0x9, 0x9, 0x9, 0x9, 0xa, 0xc,
+    0xc, 0xc, 0xc, 0xc, 0xc, 0xd7, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0xd6, 0xc, 0xc,
+    0xc, 0xc, 0xc, 0xd, 0xc, 0x20, 0x9, 0x9, 0x9, 0x9, 0x9, 0xa, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0xd7, 0xc, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0xd6, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xd, 0xc, 0x1a, 0x5a, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x0, 0x0, 0x0, 0x58, 0x5, 0x3e, 0x5, 0x5, 0x5, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0xe, 0x5, 0x5, 0x5, 0x5, 0x57, 0x5, 0x52, 0x12, 0xe, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0xd8, 0x5b, 0x5b, 0x5, 0xe, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x9, 0x8d, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0x5, 0xe, 0x0, 0x6, 0x6, 0x6a, 0x42, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x4a, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x5e, 0x54, 0x4a, 0x23, 0x3f, 0x23, 0x69, 0x0,
+    0x65, 0x5d, 0x69, 0x4a, 0x5e, 0x54, 0x69, 0x69, 0x5e, 0x54, 0x3f, 0x23, 0x3f, 0x23, 0x4a, 0x55,
+    0x23, 0x23, 0x59, 0x23, 0x23, 0x23, 0x23, 0x0, 0x4a, 0x4a, 0x59, 0x23, 0x23, 0x23, 0x23, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x48, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x0, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0xe, 0x3e, 0x5, 0x5, 0x5,
+    0x3e, 0x5, 0x5, 0x5, 0x3e, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x0, 0x0,
+    0x6f, 0x6f, 0xa0, 0x71, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0xe, 0x9b, 0x9b, 0x9b, 0x9b,
+    0x9b, 0x9b, 0xd9, 0x5, 0x9b, 0x9b, 0x9b, 0x9b, 0x9b, 0x9b, 0xd9, 0x0, 0x9b, 0x9b, 0x9b, 0x9b,
+    0x9b, 0x9b, 0xd9, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x41, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x42, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0xe, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x0,
+    0x5, 0x5, 0x41, 0x0, 0x48, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0xe, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0x41, 0x5, 0xe, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x41, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x0, 0x0, 0x5, 0x5, 0x48, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x0, 0x0, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x48, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x5, 0x5, 0x5, 0xe, 0x5, 0x5, 0x0, 0x0, 0x57, 0x5, 0x5, 0xe,
+    0x5, 0x5, 0x5, 0x0, 0x5, 0x5, 0x5, 0xe, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x48, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x41, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0xab, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xac, 0x23, 0x23, 0x23, 0x23, 0xaa,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xae, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xab, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0xaa, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x3f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x61, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x51, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5,
+};
 
-static uint16_t uprops[0x110000];
+static const uint8_t uprops_index2[872] = {
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x1, 0x1, 0x1, 0x1, 0x1, 0x0, 0x0, 0x1, 0x1, 0x1, 0x1,
+    0xe, 0x2, 0x2, 0x2, 0x2, 0x2, 0x2, 0x2, 0xd, 0xd, 0xd, 0xd, 0xd, 0xd, 0x2, 0x2,
+    0x2, 0x7, 0x7, 0x7, 0x7, 0x7, 0x7, 0x7, 0x7, 0x7, 0x7, 0x2, 0x2, 0x5, 0x5, 0x5,
+    0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x5, 0x2, 0x2, 0x2, 0x2, 0x0, 0x0, 0x1, 0x0, 0x0,
+    0x1, 0x2, 0x2, 0x2, 0x2, 0x2, 0x5, 0x2, 0x2, 0x0, 0x2, 0x2, 0x2, 0x2, 0xc, 0xc,
+    0x2, 0x5, 0x2, 0x2, 0x2, 0xc, 0x5, 0x2, 0x8, 0x8, 0x8, 0x2, 0x7, 0x7, 0x7, 0x5,
+    0x7, 0x5, 0x7, 0x5, 0x5, 0x7, 0x5, 0x7, 0x5, 0x5, 0x7, 0x5, 0x7, 0x7, 0x5, 0x7,
+    0x5, 0x7, 0x5, 0x5, 0x5, 0x7, 0x7, 0x5, 0x7, 0x5, 0x7, 0x7, 0x5, 0x7, 0x7, 0x7,
+    0x5, 0x5, 0x7, 0x7, 0x7, 0x5, 0x5, 0x5, 0x7, 0x5, 0x5, 0x3, 0x3, 0x3, 0x3, 0x3,
+    0x7, 0xf, 0x5, 0x7, 0xf, 0x5, 0x7, 0xf, 0x5, 0x7, 0xf, 0x5, 0x3, 0x5, 0x5, 0x5,
+    0x5, 0x3, 0x3, 0x3, 0x5, 0x5, 0x2, 0x2, 0x2, 0x2, 0x3, 0x3, 0x3, 0x3, 0x2, 0x2,
+    0x5, 0x2, 0x2, 0x2, 0x3, 0x2, 0x3, 0x2, 0x2, 0x4, 0x2, 0x2, 0x3, 0x2, 0x7, 0x5,
+    0x0, 0x0, 0x5, 0x5, 0x5, 0x5, 0x2, 0x7, 0x2, 0x2, 0x7, 0x2, 0x7, 0x7, 0x7, 0x0,
+    0x7, 0x0, 0x7, 0x7, 0x7, 0x7, 0x0, 0x7, 0x5, 0x5, 0x5, 0x7, 0x7, 0x5, 0x2, 0x7,
+    0x7, 0x5, 0x2, 0x2, 0x2, 0x2, 0x7, 0x5, 0x0, 0x7, 0x7, 0x7, 0x0, 0x3, 0x2, 0x2,
+    0x0, 0x5, 0x5, 0x5, 0x0, 0x2, 0x2, 0x0, 0x0, 0x2, 0x2, 0x2, 0x3, 0x3, 0x3, 0x0,
+    0x3, 0x3, 0x3, 0x2, 0x2, 0x0, 0x0, 0x0, 0x0, 0x0, 0x2, 0x2, 0x2, 0x3, 0x3, 0x3,
+    0x2, 0x3, 0x2, 0x2, 0x2, 0x3, 0x3, 0x2, 0xd, 0xd, 0x3, 0x3, 0x3, 0x2, 0x2, 0x3,
+    0x2, 0x2, 0x0, 0x0, 0x3, 0x2, 0x3, 0x3, 0x0, 0x3, 0x3, 0x3, 0x2, 0x3, 0x0, 0x0,
+    0x2, 0x2, 0x3, 0x0, 0x2, 0x2, 0x3, 0x2, 0x3, 0x2, 0x2, 0x2, 0x0, 0x0, 0x2, 0x0,
+    0x3, 0x0, 0x3, 0x3, 0x3, 0x3, 0x0, 0x0, 0x2, 0x2, 0x0, 0x2, 0x2, 0x2, 0xd, 0xd,
+    0x3, 0x0, 0x0, 0x3, 0x3, 0x0, 0x3, 0x0, 0x0, 0x0, 0x3, 0x3, 0x2, 0x0, 0x0, 0x2,
+    0x0, 0x0, 0x0, 0x2, 0x3, 0x3, 0x0, 0x3, 0x0, 0x0, 0xd, 0xd, 0x8, 0x8, 0x8, 0x8,
+    0x8, 0x8, 0x2, 0x2, 0x0, 0x0, 0x0, 0x3, 0x0, 0x3, 0x3, 0x0, 0x0, 0x2, 0x0, 0x0,
+    0x3, 0x2, 0x0, 0x0, 0x3, 0x0, 0x0, 0x0, 0x0, 0x3, 0x0, 0x0, 0x2, 0x3, 0x8, 0x8,
+    0x0, 0x0, 0x2, 0x3, 0x0, 0x0, 0x3, 0x0, 0x8, 0x8, 0x8, 0x3, 0x8, 0x2, 0x3, 0x3,
+    0x2, 0x0, 0x2, 0x0, 0x0, 0x3, 0x0, 0x3, 0xd, 0xd, 0x0, 0x0, 0xd, 0xd, 0x8, 0x8,
+    0x2, 0x2, 0x2, 0x3, 0x0, 0x7, 0x0, 0x0, 0x2, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc, 0xc,
+    0xc, 0xc, 0x8, 0x8, 0x8, 0x0, 0x0, 0x0, 0x7, 0x7, 0x0, 0x0, 0x5, 0x5, 0x0, 0x0,
+    0x1, 0x3, 0x3, 0x3, 0x2, 0x2, 0x8, 0x8, 0x8, 0x3, 0x3, 0x3, 0x3, 0x0, 0x2, 0x2,
+    0x8, 0x8, 0x0, 0x0, 0x3, 0x2, 0x3, 0x0, 0xd, 0xd, 0xc, 0x0, 0x5, 0x0, 0x0, 0x0,
+    0x2, 0x3, 0x3, 0x0, 0x0, 0x7, 0x0, 0x7, 0xf, 0xf, 0xf, 0xf, 0x5, 0x0, 0x5, 0x5,
+    0xf, 0x2, 0x5, 0x2, 0x2, 0x2, 0x5, 0x5, 0xf, 0x2, 0x2, 0x2, 0x7, 0x2, 0x2, 0x2,
+    0xf, 0x2, 0x2, 0x0, 0x1, 0x1, 0x1, 0x0, 0x0, 0x0, 0x0, 0x1, 0x2, 0x2, 0x2, 0x1,
+    0xc, 0x5, 0x0, 0x0, 0xc, 0xc, 0x2, 0x2, 0x2, 0x2, 0x2, 0x5, 0x2, 0x2, 0x2, 0x7,
+    0x2, 0x2, 0x5, 0x7, 0x7, 0x7, 0x5, 0x5, 0x2, 0x7, 0x2, 0x2, 0x7, 0x7, 0x2, 0x2,
+    0x7, 0x2, 0x7, 0x2, 0x7, 0x2, 0x7, 0x7, 0x7, 0x7, 0x2, 0x5, 0x3, 0x5, 0x2, 0x2,
+    0x2, 0x7, 0x5, 0x5, 0xb, 0xb, 0xb, 0xb, 0xa, 0xa, 0xa, 0xa, 0x8, 0x8, 0x8, 0x7,
+    0x5, 0x8, 0x8, 0x8, 0xc, 0x8, 0x8, 0x8, 0x2, 0x2, 0x6, 0x6, 0x6, 0x6, 0x6, 0x6,
+    0x4, 0x4, 0x4, 0x4, 0x4, 0x4, 0xc, 0x8, 0x8, 0xc, 0xc, 0xc, 0xc, 0xc, 0x8, 0xc,
+    0xc, 0xc, 0xc, 0x8, 0xc, 0x8, 0xc, 0xc, 0x5, 0x5, 0x5, 0x0, 0x7, 0x5, 0x5, 0x7,
+    0x5, 0x7, 0x5, 0x2, 0x2, 0x8, 0x2, 0x2, 0x5, 0x5, 0x0, 0x5, 0x0, 0x5, 0x0, 0x0,
+    0x2, 0x3, 0x3, 0x8, 0x2, 0x8, 0x8, 0x8, 0x3, 0x9, 0x3, 0x3, 0x3, 0x3, 0x3, 0x9,
+    0x3, 0x3, 0x9, 0x3, 0x9, 0x3, 0x3, 0x9, 0x9, 0x3, 0x3, 0x3, 0x9, 0x3, 0x9, 0x3,
+    0x3, 0x9, 0x3, 0x9, 0x9, 0x9, 0x3, 0x3, 0x3, 0x9, 0x9, 0x9, 0x3, 0x3, 0x9, 0x9,
+    0x9, 0x9, 0x9, 0x3, 0x7, 0x5, 0x3, 0x2, 0x3, 0x3, 0x8, 0x8, 0x3, 0x2, 0x2, 0x7,
+    0x5, 0x7, 0x5, 0x3, 0x5, 0x5, 0x5, 0x3, 0x3, 0x3, 0x2, 0x3, 0x2, 0x2, 0x0, 0x3,
+    0x3, 0x2, 0x2, 0x0, 0x0, 0x0, 0x0, 0x5, 0x0, 0x3, 0x2, 0x3, 0x0, 0x0, 0x0, 0x8,
+    0x8, 0x2, 0x2, 0x2, 0x3, 0x8, 0x3, 0x3, 0x3, 0x3, 0x8, 0x0, 0x3, 0x3, 0x0, 0x2,
+    0x8, 0x8, 0x3, 0x3, 0x0, 0x0, 0x8, 0x8, 0x3, 0x8, 0x8, 0x2, 0x3, 0x8, 0x8, 0x8,
+    0x0, 0x8, 0x8, 0x8, 0x8, 0x8, 0x8, 0x0, 0x0, 0x0, 0xc, 0xc, 0x8, 0x8, 0xd, 0xd,
+    0x2, 0x0, 0xd, 0xd, 0xd, 0xd, 0x3, 0x2, 0xd, 0xd, 0x0, 0x2, 0xd, 0xd, 0x0, 0x8,
+    0x8, 0x8, 0x0, 0x3, 0x0, 0x0, 0x7, 0x0, 0x0, 0x7, 0x7, 0x0, 0x7, 0x0, 0x5, 0x5,
+    0x7, 0x0, 0x7, 0x0, 0x0, 0x0, 0x7, 0x7, 0x7, 0x2, 0x5, 0x5, 0x5, 0x2, 0x5, 0x5,
+    0x3, 0x0, 0x0, 0x8, 0x6, 0x6, 0x2, 0x2,
+};
 
-void initialize_uprops(void) {
-    uint16_t *cur = uprops;
-    for (long k = 0; k < 3169; k++)
-        for (long j = 0; j < uprops_runlength[k*2+1]; j++)
-            *cur++ = uprops_runlength[k*2];
-}
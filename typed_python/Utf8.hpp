@@ -0,0 +1,226 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*********
+Validation and decoding of UTF-8 byte streams into the 1, 2 or 4 byte
+codepoint arrays that StringType stores.
+
+'scan' makes a single pass over the input that validates it, counts its
+codepoints, and works out the narrowest codepoint width that can hold
+all of them. 'decode' then writes the codepoints out at that width. Both
+skip over runs of ASCII 16 bytes at a time, which is where real-world
+text spends most of its bytes, and 'decode' widens those runs with
+vector unpacks rather than one codepoint at a time.
+
+'decode' assumes its input has already been through 'scan'.
+*********/
+
+namespace Utf8 {
+
+#if defined(__SSE2__)
+
+inline __m128i load(const uint8_t* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+#endif
+
+// the number of ASCII bytes at the start of the 'n' bytes at 'p'
+inline int64_t asciiPrefix(const uint8_t* p, int64_t n) {
+    int64_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        int mask = _mm_movemask_epi8(load(p + i));
+
+        if (mask) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    while (i < n && !(p[i] & 0x80)) {
+        i++;
+    }
+
+    return i;
+}
+
+// decode the multi-byte sequence at 'p', which has 'n' bytes available.
+// Returns its length, or 0 if it's truncated, overlong, out of range, or
+// (unless 'allowSurrogates') encodes a UTF-16 surrogate.
+inline int decodeSequence(const uint8_t* p, int64_t n, bool allowSurrogates, uint32_t& codepoint) {
+    uint8_t lead = p[0];
+    int len;
+    uint32_t c;
+
+    if ((lead >> 5) == 0b110) {
+        len = 2;
+        c = lead & 0b11111;
+    } else if ((lead >> 4) == 0b1110) {
+        len = 3;
+        c = lead & 0b1111;
+    } else if ((lead >> 3) == 0b11110) {
+        len = 4;
+        c = lead & 0b111;
+    } else {
+        return 0;
+    }
+
+    if (n < len) {
+        return 0;
+    }
+
+    for (int k = 1; k < len; k++) {
+        if ((p[k] & 0xC0) != 0x80) {
+            return 0;
+        }
+        c = (c << 6) | (p[k] & 0b111111);
+    }
+
+    // reject overlong encodings, and anything past the end of unicode
+    static const uint32_t minForLength[5] = {0, 0, 0x80, 0x800, 0x10000};
+
+    if (c < minForLength[len] || c > 0x10FFFF) {
+        return 0;
+    }
+
+    if (!allowSurrogates && c >= 0xD800 && c <= 0xDFFF) {
+        return 0;
+    }
+
+    codepoint = c;
+    return len;
+}
+
+// validate the 'n' bytes at 'p', computing the number of codepoints they
+// hold and the narrowest width (1, 2, or 4) that can store them all.
+// Returns false if the data isn't valid UTF-8.
+inline bool scan(const uint8_t* p, int64_t n, bool allowSurrogates, int64_t& pointcount, int& bytesPerCodepoint) {
+    int64_t points = 0;
+    uint32_t maxCodepoint = 0;
+    int64_t i = 0;
+
+    while (i < n) {
+        int64_t run = asciiPrefix(p + i, n - i);
+        i += run;
+        points += run;
+
+        while (i < n && (p[i] & 0x80)) {
+            uint32_t c;
+            int len = decodeSequence(p + i, n - i, allowSurrogates, c);
+
+            if (!len) {
+                return false;
+            }
+
+            if (c > maxCodepoint) {
+                maxCodepoint = c;
+            }
+
+            i += len;
+            points++;
+        }
+    }
+
+    pointcount = points;
+    bytesPerCodepoint = maxCodepoint <= 0xFF ? 1 : maxCodepoint <= 0xFFFF ? 2 : 4;
+
+    return true;
+}
+
+#if defined(__SSE2__)
+
+// write 16 ASCII bytes out as 16 codepoints of type T
+template<class T>
+class Widen;
+
+template<>
+class Widen<uint8_t> {
+public:
+    static void store(uint8_t* out, __m128i v) {
+        _mm_storeu_si128((__m128i*)out, v);
+    }
+};
+
+template<>
+class Widen<uint16_t> {
+public:
+    static void store(uint16_t* out, __m128i v) {
+        __m128i zero = _mm_setzero_si128();
+        _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(out + 8), _mm_unpackhi_epi8(v, zero));
+    }
+};
+
+template<>
+class Widen<uint32_t> {
+public:
+    static void store(uint32_t* out, __m128i v) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+};
+
+#endif
+
+// decode the 'n' bytes of UTF-8 at 'p', which 'scan' has accepted with a
+// width of at most sizeof(T), into 'out'.
+template<class T>
+void decode(const uint8_t* p, int64_t n, T* out) {
+    int64_t i = 0;
+
+    while (i < n) {
+#if defined(__SSE2__)
+        for (; i + 16 <= n; i += 16, out += 16) {
+            __m128i v = load(p + i);
+
+            if (_mm_movemask_epi8(v)) {
+                break;
+            }
+
+            Widen<T>::store(out, v);
+        }
+#endif
+
+        // finish (or, without SSE2, do) the ASCII run one byte at a time
+        for (; i < n && !(p[i] & 0x80); i++) {
+            *out++ = p[i];
+        }
+
+        while (i < n && (p[i] & 0x80)) {
+            uint32_t c;
+            i += decodeSequence(p + i, n - i, true, c);
+            *out++ = c;
+        }
+    }
+}
+
+} // end namespace Utf8
@@ -0,0 +1,144 @@
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/*********
+Protobuf-style unsigned varints: seven bits per byte, low bits first, with
+the top bit of each byte set on every byte but the last.
+
+'decode' reads one varint without checking bounds, so callers either have
+MAX_BYTES readable bytes in front of them or fall back to a checked loop.
+'decodeMany' reads an array of them, eight at a time whenever the next
+eight are each a single byte (no continuation bits in the word), which is
+the common case for small ints and the deltas of sorted ones.
+*********/
+
+namespace Varint {
+
+// a 64 bit value takes at most ten bytes
+const size_t MAX_BYTES = 10;
+
+inline size_t encodedLength(uint64_t v) {
+    size_t len = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        len++;
+    }
+    return len;
+}
+
+// write 'v' to 'out', which must have room for MAX_BYTES. Returns the
+// number of bytes written.
+inline size_t encode(uint64_t v, uint8_t* out) {
+    size_t len = 0;
+
+    while (v >= 0x80) {
+        out[len++] = (v & 0x7F) | 0x80;
+        v >>= 7;
+    }
+    out[len++] = v;
+
+    return len;
+}
+
+// decode one varint from 'p', which must have MAX_BYTES readable bytes.
+// Returns the byte after it, or nullptr if it runs past MAX_BYTES.
+inline const uint8_t* decode(const uint8_t* p, uint64_t& out) {
+    uint64_t b = p[0];
+
+    if (b < 0x80) {
+        out = b;
+        return p + 1;
+    }
+
+    uint64_t res = b & 0x7F;
+
+    for (size_t i = 1; i < MAX_BYTES; i++) {
+        b = p[i];
+        res |= (b & 0x7F) << (7 * i);
+
+        if (b < 0x80) {
+            out = res;
+            return p + i + 1;
+        }
+    }
+
+    return nullptr;
+}
+
+// decode one varint from [p, end). Returns the byte after it, or nullptr
+// if it's truncated or runs past MAX_BYTES.
+inline const uint8_t* decodeChecked(const uint8_t* p, const uint8_t* end, uint64_t& out) {
+    if ((size_t)(end - p) >= MAX_BYTES) {
+        return decode(p, out);
+    }
+
+    uint64_t res = 0;
+
+    for (size_t i = 0; p + i < end; i++) {
+        uint64_t b = p[i];
+        res |= (b & 0x7F) << (7 * i);
+
+        if (b < 0x80) {
+            out = res;
+            return p + i + 1;
+        }
+    }
+
+    return nullptr;
+}
+
+// decode 'count' varints from [p, end) into 'out'. Returns the byte after
+// the last one, or nullptr if the data is truncated or corrupt.
+inline const uint8_t* decodeMany(const uint8_t* p, const uint8_t* end, uint64_t* out, size_t count) {
+    const uint64_t continuationBits = 0x8080808080808080ULL;
+
+    size_t i = 0;
+
+    while (i < count) {
+        if (i + 8 <= count && end - p >= 8) {
+            uint64_t word;
+            memcpy(&word, p, 8);
+
+            if (!(word & continuationBits)) {
+                for (size_t k = 0; k < 8; k++) {
+                    out[i + k] = p[k];
+                }
+
+                i += 8;
+                p += 8;
+                continue;
+            }
+        }
+
+        p = decodeChecked(p, end, out[i]);
+
+        if (!p) {
+            return nullptr;
+        }
+
+        i++;
+    }
+
+    return p;
+}
+
+} // end namespace Varint
@@ -34,7 +34,12 @@ from typed_python.internals import (
     typeKnownToCompiler,
     localVariableTypesKnownToCompiler,
     checkOneOfType,
-    checkType
+    checkType,
+    likely,
+    unlikely,
+    assume,
+    unreachable,
+    prefetch
 )
 from typed_python._types import bytecount, refcount
 from typed_python.module import Module
@@ -45,17 +50,22 @@ from typed_python.type_filter import TypeFilter
 from typed_python.compiler.typeof import TypeOf
 from typed_python._types import (
     Forward, TupleOf, ListOf, Tuple, NamedTuple, OneOf, ConstDict, SubclassOf,
-    Alternative, Value, serialize, deserialize, serializeStream, deserializeStream,
+    Alternative, Value, serialize, serializeInto, deserialize, deserializeUntrusted,
+    serializeStream, deserializeStream,
+    jsonEncode, jsonDecode,
+    configureCompiledPrint, flushCompiledPrint, compiledPrintRingBufferContents,
     PointerTo, RefTo, Dict, validateSerializedObject, validateSerializedObjectStream,
     decodeSerializedObject, getOrSetTypeResolver, Set, Class, Type, BoundMethod,
     TypedCell, pointerTo, refTo, copy, identityHash, PythonObjectOfType,
     deepBytecount, deepcopy, deepcopyContiguous, totalBytesAllocatedInSlabs,
-    deepBytecountAndSlabs, Slab,
+    deepBytecountAndSlabs, clearDeepBytecountCache, freeze, Slab,
     totalBytesAllocatedOnFreeStore,
-    ModuleRepresentation,
+    ModuleRepresentation, StreamingDeserializer, TypeSchemaCache,
     setGilReleaseThreadLoopSleepMicroseconds
 )
 import typed_python._types as _types
+import atexit
+import os
 import threading
 
 # in the c module, these are functions, but because they're not parametrized,
@@ -77,8 +87,9 @@ from typed_python.generator import Generator  # noqa
 
 # this has to come at the end to break import cyclic
 from typed_python.lib.map import map  # noqa
-from typed_python.lib.pmap import pmap  # noqa
+from typed_python.lib.pmap import pmap, preduce, pscan, pfilter  # noqa
 from typed_python.lib.reduce import reduce  # noqa
+from typed_python.lib.ufunc import ufunc  # noqa
 
 _types.initializeGlobalStatics()
 
@@ -91,7 +102,21 @@ _types.initializeGlobalStatics()
 # instead, we have a thread that checks in the background whether any thread wants us
 # to release, and if so, swap it out. This can yield a 10-50x performance improvement
 # when we're acquiring and releasing frequently.
-gilReleaseThreadLoop = threading.Thread(target=_types.gilReleaseThreadLoop, daemon=True)
-gilReleaseThreadLoop.start()
+def _startGilReleaseThreadLoop():
+    global gilReleaseThreadLoop
+
+    gilReleaseThreadLoop = threading.Thread(target=_types.gilReleaseThreadLoop, daemon=True)
+    gilReleaseThreadLoop.start()
+
+
+_startGilReleaseThreadLoop()
+
+# a forked child doesn't have the thread, so it needs one of its own. Until it
+# starts, the child releases the GIL immediately.
+os.register_at_fork(after_in_child=_startGilReleaseThreadLoop)
 
 _types.setGilReleaseThreadLoopSleepMicroseconds(500)
+
+# write out whatever compiled print has buffered on the main thread when the
+# interpreter exits.
+atexit.register(flushCompiledPrint)
@@ -1,4 +1,6 @@
 #include <chrono>
+#include <thread>
+#include <errno.h>
 #include <stdint.h>
 #include <stdarg.h>
 #include <cmath>
@@ -9,17 +11,62 @@
 #include "AllTypes.hpp"
 #include "StringType.hpp"
 #include "BytesType.hpp"
+#include "NumberFormatting.hpp"
+#include "OutputSink.hpp"
+#include "Regex.hpp"
+#include "FileIO.hpp"
 #include "hash_table_layout.hpp"
 #include "PyInstance.hpp"
+#include "NativeException.hpp"
 
 #include <pythread.h>
 
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 PyObject* getRuntimeSingleton() {
     return staticPythonInstance(
         "typed_python.compiler.runtime", "Runtime.singleton()"
     );
 }
 
+// a cache for one compiled 'getattr' call site on a python object. Compiled code
+// allocates one per site as a zeroed global. See np_pyobj_getattr_cached.
+class PyAttributeCache {
+public:
+    // the interned attribute name, created on first use and never released
+    PyObject* name;
+
+    // the type we last looked 'name' up on, and its tp_version_tag when we did
+    PyTypeObject* type;
+    int64_t versionTag;
+
+    // what _PyType_Lookup(type, name) returned. Borrowed: the type holds it
+    // for as long as its version tag doesn't change.
+    PyObject* descr;
+};
+
+static bool typeVersionTagIsValid(PyTypeObject* type) {
+#ifdef Py_TPFLAGS_VALID_VERSION_TAG
+    if (!PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
+        return false;
+    }
+#endif
+    return type->tp_version_tag != 0;
+}
+
+static bool typeHasInstanceDict(PyTypeObject* type) {
+#ifdef Py_TPFLAGS_MANAGED_DICT
+    if (PyType_HasFeature(type, Py_TPFLAGS_MANAGED_DICT)) {
+        return true;
+    }
+#endif
+    return type->tp_dictoffset != 0;
+}
+
 // Note: extern C identifiers are distinguished only up to 32 characters
 // nativepython_runtime_12345678901
 extern "C" {
@@ -58,7 +105,9 @@ extern "C" {
     void np_compileClassDispatch(ClassDispatchTable* classDispatchTable, int slot) {
         PyEnsureGilAcquired getTheGil;
 
-        // check if there is an error already in place
+        // check if there is an error already in place. Compiling runs python, and
+        // maybe compiled code, so one we haven't made yet has to be made now.
+        NativeException::materialize();
         PyObject *existingErrorTypePtr, *existingErrorValuePtr, *existingErrorTracebackPtr;
         PyErr_Fetch(&existingErrorTypePtr, &existingErrorValuePtr, &existingErrorTracebackPtr);
         PyObjectHolder existingErrorType, existingErrorValue, existingErrorTraceback;
@@ -156,7 +205,9 @@ extern "C" {
     void np_compileClassDestructor(VTable* vtable) {
         PyEnsureGilAcquired getTheGil;
 
-        // check if there is an error already in place
+        // check if there is an error already in place. Compiling runs python, and
+        // maybe compiled code, so one we haven't made yet has to be made now.
+        NativeException::materialize();
         PyObject *existingErrorTypePtr, *existingErrorValuePtr, *existingErrorTracebackPtr;
         PyErr_Fetch(&existingErrorTypePtr, &existingErrorValuePtr, &existingErrorTracebackPtr);
         PyObjectHolder existingErrorType, existingErrorValue, existingErrorTraceback;
@@ -781,6 +832,17 @@ extern "C" {
         return BytesType::createFromPtr(utf8_str, len);
     }
 
+    // 'len' zero bytes, for compiled code to fill in place
+    BytesType::layout* nativepython_runtime_bytes_zeros(int64_t len) {
+        if (!len) {
+            return nullptr;
+        }
+
+        BytesType::layout* res = BytesType::createUninitialized(len);
+        memset(res->data, 0, len);
+        return res;
+    }
+
     BytesType::layout* nativepython_runtime_bytes_lower(BytesType::layout* l) {
         return BytesType::lower(l);
     }
@@ -822,6 +884,72 @@ extern "C" {
         return BytesType::replace(l, old, the_new, count);
     }
 
+    int64_t nativepython_runtime_bytes_find(BytesType::layout* l, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::find(l, sub, start, end);
+    }
+
+    int64_t nativepython_runtime_bytes_rfind(BytesType::layout* l, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::rfind(l, sub, start, end);
+    }
+
+    int64_t nativepython_runtime_bytes_count(BytesType::layout* l, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::count(l, sub, start, end);
+    }
+
+    int64_t nativepython_runtime_buffer_find(uint8_t* data, int64_t len, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::find(data, len, sub, start, end);
+    }
+
+    int64_t nativepython_runtime_buffer_rfind(uint8_t* data, int64_t len, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::rfind(data, len, sub, start, end);
+    }
+
+    int64_t nativepython_runtime_buffer_count(uint8_t* data, int64_t len, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::count(data, len, sub, start, end);
+    }
+
+    // 'program' is the address of a Regex::Program, from _types.regexCompile.
+    // See Regex.hpp.
+    bool np_regex_search_str(int64_t program, StringType::layout* s, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans) {
+        return Regex::search((const Regex::Program*)program, s, pos, endpos, mode, spans);
+    }
+
+    bool np_regex_search_bytes(int64_t program, BytesType::layout* s, int64_t pos, int64_t endpos, int64_t mode, int64_t* spans) {
+        return Regex::search((const Regex::Program*)program, s, pos, endpos, mode, spans);
+    }
+
+    // _types.fileRead and fileWrite. These return -errno rather than raising.
+    int64_t np_file_read(int64_t fd, uint8_t* data, int64_t count) {
+        if (count < 0) {
+            return -EINVAL;
+        }
+
+        // never block while holding the GIL
+        PyEnsureGilReleased releaseTheGil(true);
+        PyEnsureGilReleased::finishDeferredRelease();
+
+        return FileIO::readSome(fd, data, count);
+    }
+
+    int64_t np_file_write(int64_t fd, uint8_t* data, int64_t count) {
+        if (count < 0) {
+            return -EINVAL;
+        }
+
+        PyEnsureGilReleased releaseTheGil(true);
+        PyEnsureGilReleased::finishDeferredRelease();
+
+        return FileIO::writeAll(fd, data, count);
+    }
+
+    int64_t np_file_write_bytes(int64_t fd, BytesType::layout* data) {
+        if (!data) {
+            return 0;
+        }
+
+        return np_file_write(fd, data->data, data->bytecount);
+    }
+
     enum Codec { CODEC_UNKNOWN = 0, CODEC_UTF8 };
     Codec CodecFromStr(const char *s) {
         if (!s || !strcmp(s, "utf-8")
@@ -869,10 +997,16 @@ extern "C" {
             ErrHandler errhandler = ErrHandlerFromStr(c_errors);
             if (errhandler) {
                 if (codec == CODEC_UTF8) {
-                    uint8_t* data = l ? (uint8_t*)(l->data) : 0;
-                    // TODO: combine countUtf8Codepoints and createFromUtf8 into a single function with a single loop
-                    size_t pointCount = l ? StringType::countUtf8Codepoints(data, l->bytecount) : 0;
-                    return StringType::createFromUtf8((const char*)data, pointCount);
+                    if (!l) {
+                        return nullptr;
+                    }
+
+                    // invalid data falls through to the interpreter, which knows
+                    // how to apply 'errhandler' and to raise UnicodeDecodeError
+                    StringType::layout* ret;
+                    if (StringType::tryCreateFromUtf8Bytes((uint8_t*)l->data, l->bytecount, false, ret)) {
+                        return ret;
+                    }
                 }
             }
         }
@@ -1025,6 +1159,13 @@ extern "C" {
     void setExceptionState(PyObject* exception, PyObject* cause) {
         PyEnsureGilAcquired getTheGil;
 
+        if (!exception && !cause && NativeException::reraiseHandled()) {
+            return;
+        }
+
+        // a new exception's context is the one we're handling
+        NativeException::materializeHandled();
+
         // check if the exception is actually an exception. If not,
         // we can't even raise it.
         if (exception) {
@@ -1102,18 +1243,29 @@ extern "C" {
         );
     }
 
+    // raise 'excType' (a builtin exception type) with 'arg', or no argument if
+    // 'argType' is null, without building the exception. See NativeException.hpp.
+    void np_initialize_native_exception(PyObject* excType, instance_ptr arg, Type* argType) {
+        PyEnsureGilAcquired getTheGil;
+        NativeException::raise(excType, argType, arg);
+    }
+
     void np_clear_exception() {
         PyEnsureGilAcquired getTheGil;
+        NativeException::clearPending();
         PyErr_Clear();
     }
 
     void np_clear_exc_info() {
         PyEnsureGilAcquired getTheGil;
+        NativeException::clearHandled();
         PyErr_SetExcInfo(NULL, NULL, NULL);
     }
 
     void np_fetch_exception_tuple(instance_ptr inst) {
         PyEnsureGilAcquired getTheGil;
+        NativeException::materialize();
+        NativeException::clearHandled();
 
         static Type* return_type = Tuple::Make({
             PythonObjectOfType::AnyPyObject(),
@@ -1162,6 +1314,11 @@ extern "C" {
 
     bool np_match_exception(PyObject* exc) {
         PyEnsureGilAcquired getTheGil;
+
+        if (NativeException::isPending()) {
+            return NativeException::pendingMatches(exc);
+        }
+
         return PyErr_ExceptionMatches(exc);
     }
 
@@ -1176,6 +1333,9 @@ extern "C" {
     PythonObjectOfType::layout_type* np_fetch_exception() {
         PyEnsureGilAcquired getTheGil;
 
+        NativeException::materialize();
+        NativeException::clearHandled();
+
         PyObject* type;
         PyObject* value;
         PyObject* traceback;
@@ -1199,6 +1359,14 @@ extern "C" {
     void np_catch_exception() {
         PyEnsureGilAcquired getTheGil;
 
+        // nobody asked for the exception object, so we don't have to make one
+        if (NativeException::isPending()) {
+            NativeException::catchPending();
+            return;
+        }
+
+        NativeException::clearHandled();
+
         PyObject* type;
         PyObject* value;
         PyObject* traceback;
@@ -1215,6 +1383,12 @@ extern "C" {
 
     void np_add_traceback(const char* funcname, const char* filename, int lineno) {
         PyEnsureGilAcquired getTheGil;
+
+        if (NativeException::isPending()) {
+            NativeException::addTraceback(funcname, filename, lineno);
+            return;
+        }
+
         _PyTraceback_Add(funcname, filename, lineno);
     }
 
@@ -1243,7 +1417,7 @@ extern "C" {
         }
         Py_ssize_t s;
         const char* c = PyUnicode_AsUTF8AndSize(r, &s);
-        StringType::layout *ret = StringType::createFromUtf8(c, s);
+        StringType::layout *ret = StringType::createFromUtf8Bytes((const uint8_t*)c, s);
         decref(r);
         return ret;
     }
@@ -1268,7 +1442,7 @@ extern "C" {
 
         Py_ssize_t s;
         const char* c = PyUnicode_AsUTF8AndSize(r, &s);
-        *outStr = StringType::createFromUtf8(c, s);
+        *outStr = StringType::createFromUtf8Bytes((const uint8_t*)c, s);
         decref(r);
 
         return true;
@@ -1491,9 +1665,119 @@ extern "C" {
         return PythonObjectOfType::stealToCreateLayout(res);
     }
 
+    // 'getattr' on a python object from a compiled call site with its own PyAttributeCache.
+    // We intern the attribute name once, look module attributes up directly in the
+    // module's dict, and for instances of types with no instance dict and the default
+    // __getattribute__ (which includes list, dict, str and int), remember what the type
+    // lookup found for as long as the type's tp_version_tag says it hasn't changed.
+    PythonObjectOfType::layout_type* np_pyobj_getattr_cached(
+            PythonObjectOfType::layout_type* p,
+            PyAttributeCache* cache,
+            const char* a
+    ) {
+        PyEnsureGilAcquired getTheGil;
+
+        if (!cache->name) {
+            cache->name = PyUnicode_InternFromString(a);
+
+            if (!cache->name) {
+                throw PythonExceptionSet();
+            }
+        }
+
+        PyObject* obj = p->pyObj;
+        PyTypeObject* type = Py_TYPE(obj);
+
+        if (PyModule_CheckExact(obj)) {
+            PyObject* res = PyDict_GetItemWithError(PyModule_GetDict(obj), cache->name);
+
+            if (res) {
+                return PythonObjectOfType::stealToCreateLayout(incref(res));
+            }
+
+            if (PyErr_Occurred()) {
+                throw PythonExceptionSet();
+            }
+        } else if (type->tp_getattro == PyObject_GenericGetAttr && !typeHasInstanceDict(type)) {
+            PyObject* descr;
+
+            if (cache->type == type && cache->versionTag == type->tp_version_tag && typeVersionTagIsValid(type)) {
+                descr = cache->descr;
+            } else {
+                descr = _PyType_Lookup(type, cache->name);
+
+                if (typeVersionTagIsValid(type)) {
+                    cache->type = type;
+                    cache->versionTag = type->tp_version_tag;
+                    cache->descr = descr;
+                } else {
+                    cache->type = nullptr;
+                }
+            }
+
+            // without an instance dict, there's nowhere else for the attribute to be,
+            // so this is what PyObject_GenericGetAttr would do. If there's no descriptor
+            // we let it produce the AttributeError.
+            if (descr) {
+                PyObjectHolder holdDescr(descr);
+
+                descrgetfunc f = Py_TYPE(descr)->tp_descr_get;
+
+                PyObject* res = f ? f(descr, obj, (PyObject*)type) : incref(descr);
+
+                if (!res) {
+                    throw PythonExceptionSet();
+                }
+
+                return PythonObjectOfType::stealToCreateLayout(res);
+            }
+        }
+
+        PyObject* res = PyObject_GetAttr(obj, cache->name);
+
+        if (!res) {
+            throw PythonExceptionSet();
+        }
+
+        return PythonObjectOfType::stealToCreateLayout(res);
+    }
+
     PythonObjectOfType::layout_type* nativepython_runtime_getitem_pyobj(PythonObjectOfType::layout_type* p, PythonObjectOfType::layout_type* a) {
         PyEnsureGilAcquired getTheGil;
 
+        // exact lists, tuples and dicts are common enough to index directly. Anything
+        // out of range or missing takes the generic path, which raises the right error.
+        if ((PyList_CheckExact(p->pyObj) || PyTuple_CheckExact(p->pyObj)) && PyLong_CheckExact(a->pyObj)) {
+            Py_ssize_t size = PyList_CheckExact(p->pyObj) ? PyList_GET_SIZE(p->pyObj) : PyTuple_GET_SIZE(p->pyObj);
+            Py_ssize_t ix = PyLong_AsSsize_t(a->pyObj);
+
+            if (ix == -1 && PyErr_Occurred()) {
+                PyErr_Clear();
+            } else {
+                if (ix < 0) {
+                    ix += size;
+                }
+
+                if (ix >= 0 && ix < size) {
+                    return PythonObjectOfType::stealToCreateLayout(
+                        incref(
+                            PyList_CheckExact(p->pyObj) ? PyList_GET_ITEM(p->pyObj, ix) : PyTuple_GET_ITEM(p->pyObj, ix)
+                        )
+                    );
+                }
+            }
+        } else if (PyDict_CheckExact(p->pyObj)) {
+            PyObject* res = PyDict_GetItemWithError(p->pyObj, a->pyObj);
+
+            if (res) {
+                return PythonObjectOfType::stealToCreateLayout(incref(res));
+            }
+
+            if (PyErr_Occurred()) {
+                throw PythonExceptionSet();
+            }
+        }
+
         PyObject* res = PyObject_GetItem(p->pyObj, a->pyObj);
 
         if (!res) {
@@ -1520,6 +1804,25 @@ extern "C" {
     ) {
         PyEnsureGilAcquired getTheGil;
 
+        if (PyList_CheckExact(p->pyObj) && PyLong_CheckExact(index->pyObj)) {
+            Py_ssize_t size = PyList_GET_SIZE(p->pyObj);
+            Py_ssize_t ix = PyLong_AsSsize_t(index->pyObj);
+
+            if (ix == -1 && PyErr_Occurred()) {
+                PyErr_Clear();
+            } else {
+                if (ix < 0) {
+                    ix += size;
+                }
+
+                if (ix >= 0 && ix < size) {
+                    // steals the reference to the new value and releases the old one
+                    PyList_SetItem(p->pyObj, ix, incref(value->pyObj));
+                    return;
+                }
+            }
+        }
+
         int res = PyObject_SetItem(p->pyObj, index->pyObj, value->pyObj);
 
         if (res) {
@@ -1798,7 +2101,26 @@ extern "C" {
     }
 
     void nativepython_print_string(StringType::layout* layout) {
-        std::cout << StringType::Make()->toUtf8String((instance_ptr)&layout) << std::flush;
+        OutputSink::writeUtf8(layout);
+        OutputSink::endPrint(false);
+    }
+
+    // compiled print writes each argument into the calling thread's output
+    // buffer, and then ends the line with np_print_end. See OutputSink.hpp.
+    void np_print_append_str(StringType::layout* layout) {
+        OutputSink::writeUtf8(layout);
+    }
+
+    void np_print_append_int64(int64_t i) {
+        OutputSink::writeInt64(i);
+    }
+
+    void np_print_append_float64(double f) {
+        OutputSink::writeFloat64(f);
+    }
+
+    void np_print_end(bool flush) {
+        OutputSink::endPrint(flush);
     }
 
     /* convert a float to an int, returning true if conversion is successful.
@@ -1870,50 +2192,52 @@ extern "C" {
     }
 
     StringType::layout* nativepython_int64_to_string(int64_t i) {
-        char data[21];
+        char data[NumberFormatting::MAX_INT64_CHARS];
 
-        int64_t count = sprintf((char*)data, "%ld", i);
+        int64_t count = NumberFormatting::formatInt64(i, data);
         return StringType::createFromUtf8(data, count);
     }
 
     StringType::layout* nativepython_uint64_to_string(uint64_t u) {
-        char data[24];
+        char data[NumberFormatting::MAX_INT64_CHARS + 3];
 
-        int64_t count = sprintf((char*)data, "%luu64", u);
+        int64_t count = NumberFormatting::formatUInt64(u, data);
+        memcpy(data + count, "u64", 3);
+        return StringType::createFromUtf8(data, count + 3);
+    }
+
+    StringType::layout* nativepython_float64_to_string(double f) {
+        char data[NumberFormatting::MAX_FLOAT64_CHARS];
+
+        int64_t count = NumberFormatting::formatFloat64(f, data);
         return StringType::createFromUtf8(data, count);
     }
 
+    // compiled f-strings bound the size of their result, allocate it once, and
+    // format each piece straight into it. 'widthMask' is the bitwise-or of the
+    // widths of the str pieces.
+    StringType::layout* np_fstring_begin(int64_t maxPointcount, int64_t widthMask) {
+        return StringType::beginBuild(maxPointcount, widthMask & 4 ? 4 : widthMask & 2 ? 2 : 1);
+    }
 
-    StringType::layout* nativepython_float64_to_string(double f) {
-        char buf[32] = "";
-        double a = fabs(f);
-
-        if (a >= 1e16) sprintf(buf, "%.16e", f);
-        else if (a >= 1e15 || a == 0.0) sprintf(buf, "%.1f", f);
-        else if (a >= 1e14) sprintf(buf, "%.2f", f);
-        else if (a >= 1e13) sprintf(buf, "%.3f", f);
-        else if (a >= 1e12) sprintf(buf, "%.4f", f);
-        else if (a >= 1e11) sprintf(buf, "%.5f", f);
-        else if (a >= 1e10) sprintf(buf, "%.6f", f);
-        else if (a >= 1e9) sprintf(buf, "%.7f", f);
-        else if (a >= 1e8) sprintf(buf, "%.8f", f);
-        else if (a >= 1e7) sprintf(buf, "%.9f", f);
-        else if (a >= 1e6) sprintf(buf, "%.10f", f);
-        else if (a >= 1e5) sprintf(buf, "%.11f", f);
-        else if (a >= 1e4) sprintf(buf, "%.12f", f);
-        else if (a >= 1e3) sprintf(buf, "%.13f", f);
-        else if (a >= 1e2) sprintf(buf, "%.14f", f);
-        else if (a >= 10) sprintf(buf, "%.15f", f);
-        else if (a >= 1) sprintf(buf, "%.16f", f);
-        else if (a >= 0.1) sprintf(buf, "%.17f", f);
-        else if (a >= 0.01) sprintf(buf, "%.18f", f);
-        else if (a >= 0.001) sprintf(buf, "%.19f", f);
-        else if (a >= 0.0001) sprintf(buf, "%.20f", f);
-        else sprintf(buf, "%.16e", f);
-
-        remove_trailing_zeros_pystyle(buf);
-
-        return StringType::createFromUtf8(&buf[0], strlen(buf));
+    void np_fstring_append_str(StringType::layout* out, StringType::layout* piece) {
+        StringType::appendToBuild(out, piece);
+    }
+
+    void np_fstring_append_int64(StringType::layout* out, int64_t i) {
+        char data[NumberFormatting::MAX_INT64_CHARS];
+
+        StringType::appendAsciiToBuild(out, data, NumberFormatting::formatInt64(i, data));
+    }
+
+    void np_fstring_append_float64(StringType::layout* out, double f) {
+        char data[NumberFormatting::MAX_FLOAT64_CHARS];
+
+        StringType::appendAsciiToBuild(out, data, NumberFormatting::formatFloat64(f, data));
+    }
+
+    StringType::layout* np_fstring_finish(StringType::layout* out, int64_t maxPointcount) {
+        return StringType::finishBuild(out, maxPointcount);
     }
 
     StringType::layout* nativepython_float32_to_string(float f) {
@@ -1945,7 +2269,33 @@ extern "C" {
         return result;
     }
 
-    int32_t nativepython_tableAllocateNewSlot(hash_table_layout* layout, size_t kvPairSize) {
+    // like tableCreate, but counted as a live instance of 'tp'. Compiled code only
+    // uses this when type_live_counters_enabled is set.
+    hash_table_layout* nativepython_tableCreateCounted(Type* tp) {
+        hash_table_layout* result = nativepython_tableCreate();
+
+        result->startCounting(tp);
+
+        return result;
+    }
+
+    // stop counting a Dict or Set that's about to be destroyed.
+    void nativepython_tableStopCounting(hash_table_layout* layout) {
+        if (layout->counted_type) {
+            typeLiveCountersAdjust(layout->counted_type, layout, -1);
+        }
+    }
+
+    // count 'sign' instances of the ListOf or TupleOf 'tp', whose layout is at 'layout'.
+    void nativepython_typeLiveCountersAdjust(Type* tp, void* layout, int64_t sign) {
+        typeLiveCountersAdjust(tp, layout, sign);
+    }
+
+    void nativepython_typeLiveCountersAdjustBytes(Type* tp, void* layout, int64_t sign) {
+        typeLiveCountersAdjustBytes(tp, layout, sign);
+    }
+
+    int64_t nativepython_tableAllocateNewSlot(hash_table_layout* layout, size_t kvPairSize) {
         return layout->allocateNewSlot(kvPairSize);
     }
 
@@ -1984,6 +2334,14 @@ extern "C" {
         layout->compressItemTable(kvPairSize);
     }
 
+    void nativepython_tableCompact(hash_table_layout* layout, size_t kvPairSize) {
+        layout->compact(kvPairSize);
+    }
+
+    void nativepython_tableReserve(hash_table_layout* layout, size_t kvPairSize, int64_t additional) {
+        layout->reserveForInsertion(kvPairSize, additional);
+    }
+
     int32_t nativepython_hash_float32(float val) {
         HashAccumulator acc;
 
@@ -2497,6 +2855,62 @@ extern "C" {
         return false; // __exit__ returning false means don't suppress exceptions
     }
 
+    // block while '*addr' holds 'expected', until np_futex_wake wakes us or
+    // 'timeoutNanoseconds' passes (if it's not negative). Returns false if we
+    // timed out. We can also return early, so callers must recheck '*addr'.
+    // If 'processShared', 'addr' may be in memory mapped by other processes,
+    // and they can wake us too.
+    bool np_futex_wait(int32_t* addr, int32_t expected, int64_t timeoutNanoseconds, bool processShared) {
+        // never block while holding the GIL
+        PyEnsureGilReleased releaseTheGil(true);
+        PyEnsureGilReleased::finishDeferredRelease();
+
+#if defined(__linux__)
+        struct timespec timeout;
+        timeout.tv_sec = timeoutNanoseconds / 1000000000;
+        timeout.tv_nsec = timeoutNanoseconds % 1000000000;
+
+        long res = syscall(
+            SYS_futex,
+            addr,
+            processShared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+            expected,
+            timeoutNanoseconds >= 0 ? &timeout : nullptr,
+            nullptr,
+            0
+        );
+
+        return !(res == -1 && errno == ETIMEDOUT);
+#else
+        // no futexes here, so we poll
+        int64_t sleepNanoseconds = 50000;
+
+        if (timeoutNanoseconds >= 0 && timeoutNanoseconds < sleepNanoseconds) {
+            sleepNanoseconds = timeoutNanoseconds;
+        }
+
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNanoseconds));
+
+        return timeoutNanoseconds < 0 || sleepNanoseconds < timeoutNanoseconds;
+#endif
+    }
+
+    // wake up to 'count' threads blocked in np_futex_wait on 'addr'. Waiters
+    // in other processes only see this if both sides pass 'processShared'.
+    void np_futex_wake(int32_t* addr, int64_t count, bool processShared) {
+#if defined(__linux__)
+        syscall(
+            SYS_futex,
+            addr,
+            processShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE,
+            (int32_t)std::min<int64_t>(count, std::numeric_limits<int32_t>::max()),
+            nullptr,
+            nullptr,
+            0
+        );
+#endif
+    }
+
     double np_pyobj_ceil(PythonObjectOfType::layout_type* obj) {
         PyEnsureGilAcquired acquireTheGil;
 
@@ -2647,6 +3061,52 @@ extern "C" {
         }
     }
 
+    ListOfType::layout* np_str_column_to_int64(ListOfType::layout* strings) {
+        static ListOfType* listOfIntT = ListOfType::Make(Int64::Make());
+
+        ListOfType::layout* outList;
+        listOfIntT->constructor((instance_ptr)&outList);
+        listOfIntT->reserve((instance_ptr)&outList, strings->count);
+
+        int64_t bad = StringType::to_int64_column((StringType::layout**)strings->data, strings->count, (int64_t*)outList->data);
+
+        if (bad >= 0) {
+            listOfIntT->destroy((instance_ptr)&outList);
+
+            PyEnsureGilAcquired getTheGil;
+            PyErr_Format(PyExc_ValueError, "invalid literal for int() with base 10: '%s'",
+                StringType::Make()->toUtf8String(strings->data + bad * sizeof(StringType::layout*)).c_str());
+            throw PythonExceptionSet();
+        }
+
+        listOfIntT->setSizeUnsafe((instance_ptr)&outList, strings->count);
+
+        return outList;
+    }
+
+    ListOfType::layout* np_str_column_to_float64(ListOfType::layout* strings) {
+        static ListOfType* listOfFloatT = ListOfType::Make(Float64::Make());
+
+        ListOfType::layout* outList;
+        listOfFloatT->constructor((instance_ptr)&outList);
+        listOfFloatT->reserve((instance_ptr)&outList, strings->count);
+
+        int64_t bad = StringType::to_float64_column((StringType::layout**)strings->data, strings->count, (double*)outList->data);
+
+        if (bad >= 0) {
+            listOfFloatT->destroy((instance_ptr)&outList);
+
+            PyEnsureGilAcquired getTheGil;
+            PyErr_Format(PyExc_ValueError, "could not convert string to float: '%s'",
+                StringType::Make()->toUtf8String(strings->data + bad * sizeof(StringType::layout*)).c_str());
+            throw PythonExceptionSet();
+        }
+
+        listOfFloatT->setSizeUnsafe((instance_ptr)&outList, strings->count);
+
+        return outList;
+    }
+
     int64_t np_bytes_to_int64(BytesType::layout* s) {
         int64_t ret = 0;
         if (BytesType::to_int64(s, &ret)) {
@@ -2716,6 +3176,43 @@ extern "C" {
         );
     }
 
+    hash_table_layout* tp_dict_from_columns(
+            TupleOrListOfType::layout* keys,
+            TupleOrListOfType::layout* values,
+            Type* dictType
+    ) {
+        DictType* dictT = (DictType*)dictType;
+
+        if (keys->count != values->count) {
+            PyEnsureGilAcquired getTheGil;
+            PyErr_Format(
+                PyExc_ValueError,
+                "Dict.fromColumns got %d keys but %d values",
+                (int)keys->count,
+                (int)values->count
+            );
+            throw PythonExceptionSet();
+        }
+
+        hash_table_layout* res;
+
+        dictT->constructor((instance_ptr)&res);
+        dictT->insertColumns((instance_ptr)&res, keys->data, values->data, keys->count);
+
+        return res;
+    }
+
+    hash_table_layout* tp_set_from_list(TupleOrListOfType::layout* elements, Type* setType) {
+        SetType* setT = (SetType*)setType;
+
+        hash_table_layout* res;
+
+        setT->constructor((instance_ptr)&res);
+        setT->insertElements((instance_ptr)&res, elements->data, elements->count);
+
+        return res;
+    }
+
     TupleOrListOfType::layout* tp_list_or_tuple_of_from_bytes(BytesType::layout* bytes, Type* typeObj) {
         if (!typeObj->isTupleOrListOf() || !((TupleOrListOfType*)typeObj)->getEltType()->isPOD()) {
             PyEnsureGilAcquired getTheGil;
@@ -2814,10 +3311,10 @@ extern "C" {
         return res;
     }
 
-    void np_deserialize_no_context(BytesType::layout* bytes, instance_ptr data, Type* type) {
+    void np_deserialize_buffer_no_context(uint8_t* bytes, int64_t bytecount, instance_ptr data, Type* type) {
         NullSerializationContext context;
 
-        DeserializationBuffer buf(bytes->data, bytes->bytecount, context);
+        DeserializationBuffer buf(bytes, bytecount, context);
 
         auto fieldAndWireType = buf.readFieldNumberAndWireType();
 
@@ -2831,6 +3328,10 @@ extern "C" {
         }
     }
 
+    void np_deserialize_no_context(BytesType::layout* bytes, instance_ptr data, Type* type) {
+        np_deserialize_buffer_no_context(bytes->data, bytes->bytecount, data, type);
+    }
+
     BytesType::layout* np_serialize(instance_ptr data, Type* type, Type* serContextType, instance_ptr serializationContext) {
         PythonSerializationContext context(InstanceRef(serializationContext, serContextType));
 
@@ -2846,10 +3347,17 @@ extern "C" {
         return res;
     }
 
-    void np_deserialize(BytesType::layout* bytes, instance_ptr data, Type* type, Type* serContextType, instance_ptr serializationContext) {
+    void np_deserialize_buffer(
+            uint8_t* bytes,
+            int64_t bytecount,
+            instance_ptr data,
+            Type* type,
+            Type* serContextType,
+            instance_ptr serializationContext
+    ) {
         PythonSerializationContext context(InstanceRef(serializationContext, serContextType));
 
-        DeserializationBuffer buf(bytes->data, bytes->bytecount, context);
+        DeserializationBuffer buf(bytes, bytecount, context);
 
         auto fieldAndWireType = buf.readFieldNumberAndWireType();
 
@@ -2863,6 +3371,10 @@ extern "C" {
         }
     }
 
+    void np_deserialize(BytesType::layout* bytes, instance_ptr data, Type* type, Type* serContextType, instance_ptr serializationContext) {
+        np_deserialize_buffer(bytes->data, bytes->bytecount, data, type, serContextType, serializationContext);
+    }
+
     void np_const_dict_sort_kv_pairs(ConstDictType::layout* instance, ConstDictType* dictType) {
         try {
             dictType->sortKvPairs((instance_ptr)&instance);
@@ -18,11 +18,14 @@
 #include <Python.h>
 #include <frameobject.h>
 #include <numpy/arrayobject.h>
+#include <numpy/ufuncobject.h>
+#include <limits>
 #include <map>
 #include <memory>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <fcntl.h>
 #include <unordered_set>
 
 #include "AllTypes.hpp"
@@ -37,8 +40,20 @@
 #include "PyTemporaryReferenceTracer.hpp"
 #include "PySlab.hpp"
 #include "PyModuleRepresentation.hpp"
+#include "PyStreamingDeserializer.hpp"
+#include "PyTypeSchemaCache.hpp"
+#include "PySerializationNameCache.hpp"
+#include "JsonCodec.hpp"
+#include "CsvReader.hpp"
+#include "OutputSink.hpp"
+#include "Regex.hpp"
+#include "NumpyUfunc.hpp"
+#include "FileIO.hpp"
+#include "DeltaSerialization.hpp"
+#include "InPlaceDeserialization.hpp"
 #include "_types.hpp"
 #include "CompilerVisibleObjectVisitor.hpp"
+#include "ThreadLocalSlots.hpp"
 
 PyObject *MakeTupleOrListOfType(PyObject* nullValue, PyObject* args, bool isTuple) {
     std::vector<Type*> types;
@@ -614,6 +629,11 @@ PyObject* initializeGlobalStatics(PyObject* nullValue, PyObject* args, PyObject*
     osModule();
     weakrefModule();
 
+    // keep the threads we run in the background usable in processes we fork
+    PyEnsureGilReleased::installForkHandlers();
+    SerializationBuffer::installForkHandlers();
+    DeserializationBuffer::installForkHandlers();
+
     return incref(Py_None);
 }
 
@@ -1595,6 +1615,38 @@ PyObject* totalBytesAllocatedOnFreeStore(PyObject* nullValue, PyObject* args) {
     return PyLong_FromLong(tpBytesAllocatedOnFreeStore());
 }
 
+PyDoc_STRVAR(
+    stringInternTableSize_doc,
+    "stringInternTableSize() -> int\n\n"
+    "returns the number of distinct strings in the string intern table.\n"
+);
+
+PyObject* stringInternTableSize(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 0) {
+        PyErr_SetString(PyExc_TypeError, "stringInternTableSize takes 0 argument");
+        return NULL;
+    }
+
+    return PyLong_FromLong(StringType::internTableSize());
+}
+
+PyDoc_STRVAR(
+    clearStringInternTable_doc,
+    "clearStringInternTable() -> None\n\n"
+    "drops the intern table's references to the strings interned so far.\n"
+);
+
+PyObject* clearStringInternTable(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 0) {
+        PyErr_SetString(PyExc_TypeError, "clearStringInternTable takes 0 argument");
+        return NULL;
+    }
+
+    StringType::clearInternTable();
+
+    Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR(deepcopy_doc,
     "deepcopy(o, typeMap=None)\n\n"
     "Make a 'deep copy' of the object graph starting at 'o'. The deepcopier\n"
@@ -1661,7 +1713,7 @@ PyObject* deepcopy(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
 }
 
 PyDoc_STRVAR(deepcopyContiguous_doc,
-    "deepcopyContiguous(o, trackInternalTypes=False)\n\n"
+    "deepcopyContiguous(o, trackInternalTypes=False, tag=None, threads=1, shared=False)\n\n"
     "Make a 'deep copy' of the object graph starting at 'o', placing the new\n"
     "objects in a 'Slab', which is a contiguously allocated block of memory.\n"
     "The deepcopier looks inside of standard python objects with '__dict__',\n"
@@ -1669,24 +1721,50 @@ PyDoc_STRVAR(deepcopyContiguous_doc,
     "functions, types, modules, and anything without a standard __dict__.\n\n"
     "If 'trackInternalTypes' is True, the the resulting Slab object tracks\n"
     "details on the types of the objects allocated inside of it for diagnostic\n"
-    "purposes. See typed_python.Slab for details."
+    "purposes. See typed_python.Slab for details.\n\n"
+    "If 'threads' is greater than 1, large ListOf and TupleOf instances whose\n"
+    "elements contain no python objects have their elements copied by that many\n"
+    "threads at once, without the GIL. Shared substructure is still copied once.\n\n"
+    "If 'shared' is True, the slab's memory is a MAP_SHARED mapping, so worker\n"
+    "processes forked afterwards read the same physical pages instead of getting\n"
+    "copy-on-write copies that their refcount updates gradually duplicate. The\n"
+    "copy is only usable in this process and its forked children, since it holds\n"
+    "pointers into this process's heap. Keep a reference to it in the parent for\n"
+    "as long as the workers use it: an object whose last reference goes away in\n"
+    "a worker is destroyed there, and the parent can't release the slab after."
 );
 
 PyObject* deepcopyContiguous(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
-    static const char *kwlist[] = {"arg", "trackInternalTypes", "tag", NULL};
+    static const char *kwlist[] = {"arg", "trackInternalTypes", "tag", "threads", "shared", NULL};
 
     PyObject* arg;
     PyObject* tag = nullptr;
     int trackInternalTypes = 0;
+    int threads = 1;
+    int shared = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|pO", (char**)kwlist, &arg, &trackInternalTypes, &tag)) {
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "O|pOip", (char**)kwlist, &arg, &trackInternalTypes, &tag, &threads, &shared
+    )) {
         return NULL;
     }
 
-    std::unordered_set<void*> visited;
-    size_t bytecount = PythonObjectOfType::deepBytecountForPyObj(arg, visited, nullptr);
+    if (threads < 1) {
+        PyErr_SetString(PyExc_ValueError, "deepcopyContiguous needs at least one thread");
+        return NULL;
+    }
+
+    DeepBytecountContext bytecountContext;
+    size_t bytecount = PythonObjectOfType::deepBytecountForPyObj(arg, bytecountContext, nullptr);
+
+    Slab* slab;
 
-    Slab* slab = new Slab(false, bytecount);
+    try {
+        slab = new Slab(false, bytecount, shared);
+    } catch(std::exception& e) {
+        PyErr_SetString(PyExc_MemoryError, e.what());
+        return NULL;
+    }
 
     if (tag) {
         slab->setTag(tag);
@@ -1697,6 +1775,7 @@ PyObject* deepcopyContiguous(PyObject* nullValue, PyObject* args, PyObject* kwar
     }
 
     DeepcopyContext context(slab);
+    context.threadCount = threads;
 
     try {
         PyObject* res = PythonObjectOfType::deepcopyPyObject(arg, context);
@@ -1743,36 +1822,66 @@ PyObject *getAllSlabs(PyObject* nullValue, PyObject* args) {
 }
 
 
+// compute the deep bytecount of 'arg', optionally using the DeepBytecountCache.
+// Must be called with the GIL held.
+static size_t computeDeepBytecount(PyObject* arg, bool cacheImmutable, std::set<Slab*>* outSlabs) {
+    Type* actualType = PyInstance::extractTypeFrom(arg->ob_type);
+
+    if (!cacheImmutable) {
+        DeepBytecountContext context;
+
+        if (!actualType) {
+            return PythonObjectOfType::deepBytecountForPyObj(arg, context, outSlabs);
+        }
+
+        PyEnsureGilReleased releaseTheGil;
+
+        return actualType->deepBytecount(((PyInstance*)arg)->dataPtr(), context, outSlabs);
+    }
+
+    DeepBytecountCache& cache = DeepBytecountCache::singleton();
+
+    // the walk may need to reacquire the GIL while it holds the cache,
+    // so we can't hold the GIL while we wait for it.
+    PyEnsureGilReleased releaseTheGil;
+
+    std::lock_guard<std::mutex> lock(cache.mutex());
+
+    cache.prune();
+
+    DeepBytecountContext context(&cache);
+
+    if (!actualType) {
+        return PythonObjectOfType::deepBytecountForPyObj(arg, context, outSlabs);
+    }
+
+    return actualType->deepBytecount(((PyInstance*)arg)->dataPtr(), context, outSlabs);
+}
+
 PyDoc_STRVAR(
     deepBytecountAndSlabs_doc,
-    "deepBytecountAndSlabs(o) -> (int, Slab)\n\n"
+    "deepBytecountAndSlabs(o, cacheImmutable=False) -> (int, Slab)\n\n"
     "Returns the bytecount of all non-slab allocations reachable from 'o',\n"
     "as well as a list of all the Slab objects reachable from 'o'.\n\n"
     "Use this to determine how many bytes in your graph are not in slabs\n"
-    "or to check if you can reach the same Slab from multiple places.\n"
+    "or to check if you can reach the same Slab from multiple places.\n\n"
+    "If 'cacheImmutable', remember the sizes of the immutable TupleOf and\n"
+    "ConstDict instances we see, as in deepBytecount.\n"
 );
-PyObject *deepBytecountAndSlabs(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "deepBytecountAndSlabs takes 1 argument");
+PyObject *deepBytecountAndSlabs(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"o", "cacheImmutable", NULL};
+
+    PyObject* arg;
+    int cacheImmutable = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", (char**)kwlist, &arg, &cacheImmutable)) {
         return NULL;
     }
 
-    PyObject* arg = PyTuple_GetItem(args, 0);
-
     std::set<Slab*> slabs;
-    std::unordered_set<void*> seen;
-    Type* actualType = PyInstance::extractTypeFrom(arg->ob_type);
 
     return translateExceptionToPyObject([&]() {
-        size_t sz;
-
-        if (!actualType) {
-            sz = PythonObjectOfType::deepBytecountForPyObj(arg, seen, &slabs);
-        } else {
-            PyEnsureGilReleased releaseTheGil;
-
-            sz = actualType->deepBytecount(((PyInstance*)arg)->dataPtr(), seen, &slabs);
-        }
+        size_t sz = computeDeepBytecount(arg, cacheImmutable, &slabs);
 
         PyObjectStealer szAsLong(PyLong_FromLong(sz));
         PyObjectStealer pySlabList(PyList_New(0));
@@ -1788,37 +1897,112 @@ PyObject *deepBytecountAndSlabs(PyObject* nullValue, PyObject* args) {
 
 PyDoc_STRVAR(
     deepBytecount_doc,
-    "deepBytecount(o) -> int\n\n"
+    "deepBytecount(o, cacheImmutable=False) -> int\n\n"
     "Determine how many bytes of data would be required to represent 'o'\n"
     "and all the objects beneath it. We use the same rules for reachablility\n"
     "as we do for 'deepcopy' and 'deepcopyContiguous'. This predicts\n"
-    "the size of the resulting Slab if you call deepcopyContiguous(o)."
+    "the size of the resulting Slab if you call deepcopyContiguous(o).\n\n"
+    "If 'cacheImmutable', remember the size of each TupleOf and ConstDict\n"
+    "holding only immutable data that we walk, so that later calls can skip\n"
+    "its contents. The cache holds a reference to each such instance until a\n"
+    "later call finds that nothing else does, or until you call\n"
+    "clearDeepBytecountCache(). Data that was held exclusively by a cached\n"
+    "instance when we first saw it, but is later shared with other parts of\n"
+    "the graph, may be counted twice."
 );
 
-PyObject *deepBytecount(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "deepBytecount takes 1 argument");
+PyObject *deepBytecount(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"o", "cacheImmutable", NULL};
+
+    PyObject* arg;
+    int cacheImmutable = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", (char**)kwlist, &arg, &cacheImmutable)) {
         return NULL;
     }
 
-    PyObject* arg = PyTuple_GetItem(args, 0);
+    return translateExceptionToPyObject([&]() {
+        return PyLong_FromLong(computeDeepBytecount(arg, cacheImmutable, nullptr));
+    });
+}
+
+PyDoc_STRVAR(
+    freeze_doc,
+    "freeze(o) -> int\n\n"
+    "Make every refcounted typed_python object reachable from 'o' immortal,\n"
+    "using the same rules for reachability as deepBytecount. Increfs and\n"
+    "decrefs of an immortal object, from the interpreter or from compiled code,\n"
+    "don't write to its refcount, so threads reading frozen data never contend\n"
+    "on it, and it's never destroyed. Use this on reference data you load once\n"
+    "and keep for the life of the process, ideally after deepcopyContiguous has\n"
+    "put it in its own Slab. Nothing stops you from modifying a frozen ListOf,\n"
+    "Dict or Class, but whatever you take out of it is leaked.\n\n"
+    "Returns the number of objects we froze."
+);
 
-    std::unordered_set<void*> seen;
+PyObject *freeze(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"o", NULL};
 
-    Type* actualType = PyInstance::extractTypeFrom(arg->ob_type);
+    PyObject* arg;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &arg)) {
+        return NULL;
+    }
 
     return translateExceptionToPyObject([&]() {
-        size_t sz;
+        Type* actualType = PyInstance::extractTypeFrom(arg->ob_type);
+
+        std::vector<Refcount*> refcounts;
+
+        DeepBytecountContext context;
+        context.refcountsToFreeze = &refcounts;
 
         if (!actualType) {
-            sz = PythonObjectOfType::deepBytecountForPyObj(arg, seen, nullptr);
+            PythonObjectOfType::deepBytecountForPyObj(arg, context, nullptr);
         } else {
             PyEnsureGilReleased releaseTheGil;
 
-            sz = actualType->deepBytecount(((PyInstance*)arg)->dataPtr(), seen, nullptr);
+            actualType->deepBytecount(((PyInstance*)arg)->dataPtr(), context, nullptr);
+        }
+
+        for (auto refcount: refcounts) {
+            refcount->makeImmortal();
+        }
+
+        return PyLong_FromLong(refcounts.size());
+    });
+}
+
+PyDoc_STRVAR(
+    clearDeepBytecountCache_doc,
+    "clearDeepBytecountCache() -> int\n\n"
+    "Release everything that deepBytecount(o, cacheImmutable=True) is holding\n"
+    "on to. Returns the number of cache entries released."
+);
+
+PyObject *clearDeepBytecountCache(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        DeepBytecountCache& cache = DeepBytecountCache::singleton();
+
+        size_t count;
+
+        {
+            PyEnsureGilReleased releaseTheGil;
+
+            std::lock_guard<std::mutex> lock(cache.mutex());
+
+            count = cache.size();
+
+            cache.clear();
         }
 
-        return PyLong_FromLong(sz);
+        return PyLong_FromLong(count);
     });
 }
 
@@ -1830,6 +2014,61 @@ PyObject *deepBytecount(PyObject* nullValue, PyObject* args) {
     @param a2: Instance
     @param a3: Serialization Context (optional)
 */
+// build the context for a serialization call: a NullSerializationContext,
+// unless 'contextObj' is a SerializationContext. Returns false with a python
+// exception set if it isn't a valid one.
+static bool makeSerializationContext(PyObject* contextObj, std::shared_ptr<SerializationContext>& context) {
+    context.reset(new NullSerializationContext());
+
+    try {
+        if (contextObj && contextObj != Py_None) {
+            context.reset(new PythonSerializationContext(contextObj));
+        }
+    } catch (std::exception& e) {
+        PyErr_SetString(PyExc_TypeError, e.what());
+        return false;
+    } catch(PythonExceptionSet& e) {
+        return false;
+    }
+
+    return true;
+}
+
+// serialize python object 'value' as a 'serializeType' into 'b' and finalize
+// it. Returns false with a python exception set on failure.
+static bool serializeIntoBuffer(Type* serializeType, PyObject* value, SerializationBuffer& b) {
+    Type* actualType = PyInstance::extractTypeFrom(value->ob_type);
+
+    try{
+        serializeType->assertForwardsResolved();
+
+        if (actualType == serializeType) {
+            //the simple case
+            PyEnsureGilReleased releaseTheGil;
+
+            actualType->serialize(((PyInstance*)value)->dataPtr(), b, 0);
+        } else {
+            //try to construct a 'serialize type' from the argument and then serialize that
+            Instance i = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+                PyInstance::copyConstructFromPythonInstance(serializeType, p, value, ConversionLevel::New);
+            });
+
+            PyEnsureGilReleased releaseTheGil;
+
+            i.type()->serialize(i.data(), b, 0);
+        }
+
+        b.finalize();
+    } catch (std::exception& e) {
+        PyErr_SetString(PyExc_TypeError, e.what());
+        return false;
+    } catch(PythonExceptionSet& e) {
+        return false;
+    }
+
+    return true;
+}
+
 PyObject *serialize(PyObject* nullValue, PyObject* args) {
     if (PyTuple_Size(args) != 2 && PyTuple_Size(args) != 3) {
         PyErr_SetString(PyExc_TypeError, "serialize takes 2 or 3 positional arguments");
@@ -1851,54 +2090,107 @@ PyObject *serialize(PyObject* nullValue, PyObject* args) {
         return NULL;
     }
 
-    serializeType->assertForwardsResolved();
+    std::shared_ptr<SerializationContext> context;
 
-    Type* actualType = PyInstance::extractTypeFrom(a2->ob_type);
+    if (!makeSerializationContext(a3, context)) {
+        return NULL;
+    }
 
-    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+    SerializationBuffer b(*context);
 
-    try {
-        if (a3 && a3 != Py_None) {
-            context.reset(new PythonSerializationContext(a3));
-        }
-    } catch (std::exception& e) {
-        PyErr_SetString(PyExc_TypeError, e.what());
+    if (!serializeIntoBuffer(serializeType, a2, b)) {
         return NULL;
-    } catch(PythonExceptionSet& e) {
+    }
+
+    PyObject* bytes = PyBytes_FromStringAndSize(NULL, b.size());
+    b.copyInto((uint8_t*)PyBytes_AS_STRING(bytes));
+
+    return bytes;
+}
+
+PyDoc_STRVAR(
+    serializeInto_doc,
+    "serializeInto(buffer, T, value, serializationContext=None) -> int\n\n"
+    "Serialize 'value' as a T, exactly as 'serialize' would, but write the bytes\n"
+    "to the start of 'buffer' rather than into a new bytes object, and return\n"
+    "how many bytes were written. A bytearray that's too small is grown to fit.\n"
+    "Any other writable buffer (a memoryview, a numpy array, an mmap) has to\n"
+    "be large enough already, or we raise ValueError and leave it untouched.\n\n"
+    "Reusing one buffer for a series of small messages avoids allocating a\n"
+    "bytes object for each of them.\n"
+);
+
+PyObject *serializeInto(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 3 && PyTuple_Size(args) != 4) {
+        PyErr_SetString(PyExc_TypeError, "serializeInto takes 3 or 4 positional arguments");
         return NULL;
     }
 
-    SerializationBuffer b(*context);
+    PyObjectHolder target(PyTuple_GetItem(args, 0));
+    PyObjectHolder a1(PyTuple_GetItem(args, 1));
+    PyObjectHolder a2(PyTuple_GetItem(args, 2));
+    PyObjectHolder a3(PyTuple_Size(args) == 4 ? PyTuple_GetItem(args, 3) : nullptr);
 
-    try{
-        if (actualType == serializeType) {
-            //the simple case
-            PyEnsureGilReleased releaseTheGil;
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(a1);
 
-            actualType->serialize(((PyInstance*)(PyObject*)a2)->dataPtr(), b, 0);
-        } else {
-            //try to construct a 'serialize type' from the argument and then serialize that
-            Instance i = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
-                PyInstance::copyConstructFromPythonInstance(serializeType, p, a2, ConversionLevel::New);
-            });
+    if (!serializeType) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "second argument to serializeInto must be a type object, not %S",
+            (PyObject*)a1
+            );
+        return NULL;
+    }
 
-            PyEnsureGilReleased releaseTheGil;
+    std::shared_ptr<SerializationContext> context;
 
-            i.type()->serialize(i.data(), b, 0);
+    if (!makeSerializationContext(a3, context)) {
+        return NULL;
+    }
+
+    SerializationBuffer b(*context);
+
+    if (!serializeIntoBuffer(serializeType, a2, b)) {
+        return NULL;
+    }
+
+    size_t bytecount = b.size();
+
+    if (PyByteArray_Check(target)) {
+        if ((size_t)PyByteArray_GET_SIZE((PyObject*)target) < bytecount) {
+            if (PyByteArray_Resize(target, bytecount) == -1) {
+                return NULL;
+            }
         }
 
-        b.finalize();
-    } catch (std::exception& e) {
-        PyErr_SetString(PyExc_TypeError, e.what());
+        b.copyInto((uint8_t*)PyByteArray_AS_STRING((PyObject*)target));
+
+        return PyLong_FromSize_t(bytecount);
+    }
+
+    Py_buffer view;
+
+    if (PyObject_GetBuffer(target, &view, PyBUF_WRITABLE) == -1) {
         return NULL;
-    } catch(PythonExceptionSet& e) {
+    }
+
+    if ((size_t)view.len < bytecount) {
+        PyBuffer_Release(&view);
+
+        PyErr_Format(
+            PyExc_ValueError,
+            "serializeInto needs %zu bytes, but the buffer only has %zd",
+            bytecount,
+            view.len
+        );
         return NULL;
     }
 
-    PyObject* bytes = PyBytes_FromStringAndSize(NULL, b.size());
-    b.copyInto((uint8_t*)PyBytes_AS_STRING(bytes));
+    b.copyInto((uint8_t*)view.buf);
 
-    return bytes;
+    PyBuffer_Release(&view);
+
+    return PyLong_FromSize_t(bytecount);
 }
 
 PyObject *setPropertyGetSetDel(PyObject* nullValue, PyObject* args) {
@@ -2174,18 +2466,22 @@ PyObject *deserialize(PyObject* nullValue, PyObject* args) {
         PyErr_SetString(PyExc_TypeError, "first argument to deserialize must be a type object");
         return NULL;
     }
-    if (!PyBytes_Check(a2)) {
-        PyErr_SetString(PyExc_TypeError, "second argument to deserialize must be a bytes object");
-        return NULL;
-    }
 
     std::shared_ptr<SerializationContext> context(new NullSerializationContext());
     if (a3 && a3 != Py_None) {
         context.reset(new PythonSerializationContext(a3));
     }
 
-    return translateExceptionToPyObject([&]() {
-        DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a2), PyBytes_GET_SIZE((PyObject*)a2), *context);
+    // anything that exports a buffer (bytes, memoryview, mmap, ...) is read in place
+    Py_buffer view;
+    if (PyObject_GetBuffer(a2, &view, PyBUF_SIMPLE) == -1) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "second argument to deserialize must be a bytes-like object");
+        return NULL;
+    }
+
+    PyObject* res = translateExceptionToPyObject([&]() {
+        DeserializationBuffer buf((uint8_t*)view.buf, view.len, *context);
 
         serializeType->assertForwardsResolved();
 
@@ -2197,813 +2493,1907 @@ PyObject *deserialize(PyObject* nullValue, PyObject* args) {
 
         return PyInstance::extractPythonObject(i.data(), i.type());
     });
+
+    PyBuffer_Release(&view);
+
+    return res;
 }
 
-PyObject *decodeSerializedObject(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "validateSerializedObject takes 1 bytes argument");
+PyDoc_STRVAR(deserializeUntrusted_doc,
+    "deserializeUntrusted(T, data, serializationContext=None, maxDepth=1000, maxBytes=1 << 30) -> T\n\n"
+    "Like 'deserialize', but for data we didn't produce ourselves, in place of\n"
+    "checking it with 'validateSerializedObject' first. We check it as we go:\n"
+    "objects may nest at most 'maxDepth' deep, the element counts in the data\n"
+    "may ask for at most 'maxBytes' bytes of containers in total, and the data\n"
+    "must hold exactly one object. Zero means no limit. Anything wrong with the\n"
+    "data raises a TypeError, and frees whatever we'd built so far.\n"
+);
+
+PyObject* deserializeUntrusted(PyObject* null, PyObject* args, PyObject* kwargs) {
+    PyObject* pyType;
+    PyObject* pyData;
+    PyObject* pyContext = Py_None;
+    unsigned long long maxDepth = 1000;
+    unsigned long long maxBytes = 1ULL << 30;
+
+    static const char *kwlist[] = {"T", "data", "serializationContext", "maxDepth", "maxBytes", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OO|OKK", (char**)kwlist, &pyType, &pyData, &pyContext, &maxDepth, &maxBytes
+    )) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    if (!PyBytes_Check(a1)) {
-        PyErr_SetString(PyExc_TypeError, "first argument to validateSerializedObject must be a bytes object");
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(pyType);
+
+    if (!serializeType) {
+        PyErr_SetString(PyExc_TypeError, "first argument to deserializeUntrusted must be a type object");
         return NULL;
     }
 
     std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+    if (pyContext != Py_None) {
+        context.reset(new PythonSerializationContext(pyContext));
+    }
 
-    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a1), PyBytes_GET_SIZE((PyObject*)a1), *context);
+    Py_buffer view;
+    if (PyObject_GetBuffer(pyData, &view, PyBUF_SIMPLE) == -1) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "second argument to deserializeUntrusted must be a bytes-like object");
+        return NULL;
+    }
 
-    std::function<PyObject* (size_t)> decode = [&](size_t wireType) {
-        if (wireType == WireType::VARINT) {
-            return PyLong_FromLong(buf.readSignedVarint());
-        }
-        if (wireType == WireType::EMPTY) {
-            return PyList_New(0);
-        }
-        if (wireType == WireType::BITS_32) {
-            float f = buf.read<float>();
-            Instance i((instance_ptr)&f, ::Float32::Make());
+    PyObject* res = translateExceptionToPyObject([&]() {
+        DeserializationBuffer buf((uint8_t*)view.buf, view.len, *context);
+        buf.setLimits(maxDepth, maxBytes);
 
-            return PyInstance::fromInstance(i);
+        serializeType->assertForwardsResolved();
+
+        Instance i = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            PyEnsureGilReleased releaseTheGil;
+            auto fieldAndWireType = buf.readFieldNumberAndWireType();
+            serializeType->deserialize(p, buf, fieldAndWireType.second);
+        });
+
+        if (!buf.isDone()) {
+            throw std::runtime_error("Data continues past the end of the object");
         }
-        if (wireType == WireType::BITS_64) {
-            return PyFloat_FromDouble(buf.read<double>());
-        }
-        if (wireType == WireType::BYTES) {
-            size_t count = buf.readUnsignedVarint();
-            return buf.read_bytes_fun(count, [&](uint8_t* bytes) {
-                return PyBytes_FromStringAndSize((const char*)bytes, count);
-            });
-        }
-        if (wireType == WireType::SINGLE) {
-            auto fieldAndWire = buf.readFieldNumberAndWireType();
 
-            PyObjectStealer res(decode(fieldAndWire.second));
+        return PyInstance::extractPythonObject(i.data(), i.type());
+    });
 
-            PyObjectStealer result(PyList_New(0));
-            PyObjectStealer key(PyLong_FromLong(fieldAndWire.first));
-            PyObjectStealer tup(PyTuple_Pack(2, (PyObject*)key, (PyObject*)res));
-            PyList_Append(result, tup);
-            return incref(result);
-        }
-        if (wireType == WireType::BEGIN_COMPOUND) {
-            PyObjectStealer result(PyList_New(0));
+    PyBuffer_Release(&view);
 
-            while (true) {
-                auto fieldAndWire = buf.readFieldNumberAndWireType();
+    return res;
+}
 
-                if (fieldAndWire.second == WireType::END_COMPOUND) {
-                    return incref(result);
-                }
+PyDoc_STRVAR(
+    jsonEncode_doc,
+    "jsonEncode(T, value) -> bytes\n\n"
+    "Encode 'value', converted to T if it isn't one already, as UTF-8 json.\n"
+    "T may be built out of None, bool, ints, floats, str, ListOf, TupleOf, Set,\n"
+    "Tuple, NamedTuple (as objects), Dict with str or int keys, and OneOf."
+);
 
-                PyObjectStealer res(decode(fieldAndWire.second));
+PyObject *jsonEncode(PyObject* nullValue, PyObject* args) {
+    PyObject* typeArg;
+    PyObject* value;
 
-                PyObjectStealer key(PyLong_FromLong(fieldAndWire.first));
-                //(PyObject*) are because this is a variadic function and doesn't cast the pointers
-                //correctly
-                PyObjectStealer tup(PyTuple_Pack(2, (PyObject*)key, (PyObject*)res));
-                PyList_Append(result, tup);
-            }
-        }
+    if (!PyArg_ParseTuple(args, "OO", &typeArg, &value)) {
+        return NULL;
+    }
 
-        throw std::runtime_error("Invalid wire type encountered: " + format(wireType));
-    };
+    Type* encodeType = PyInstance::unwrapTypeArgToTypePtr(typeArg);
 
-    return translateExceptionToPyObject([&](){
-        auto msg = buf.readFieldNumberAndWireType();
+    if (!encodeType) {
+        PyErr_Format(PyExc_TypeError, "first argument to jsonEncode must be a type object, not %S", typeArg);
+        return NULL;
+    }
 
-        PyObjectStealer res(decode(msg.second));
+    return translateExceptionToPyObject([&]() {
+        encodeType->assertForwardsResolved();
 
-        if (!buf.isDone()) {
-            PyObjectStealer resDict(PyDict_New());
-            PyDict_SetItemString(resDict, "result", res);
-            PyDict_SetItemString(
-                resDict,
-                "remainingBytes",
-                PyBytes_FromStringAndSize(
-                    (const char*)PyBytes_AsString(a1) + buf.pos(),
-                    PyBytes_GET_SIZE((PyObject*)a1) - buf.pos()
-                )
-            );
+        Instance i = Instance::createAndInitialize(encodeType, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(encodeType, p, value, ConversionLevel::New);
+        });
 
-            return incref(resDict);
+        std::string out;
+
+        {
+            PyEnsureGilReleased releaseTheGil;
+            JsonCodec::encode(encodeType, i.data(), out);
         }
 
-        return incref(res);
+        return PyBytes_FromStringAndSize(out.data(), out.size());
     });
 }
 
-PyObject *validateSerializedObject(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "validateSerializedObject takes 1 bytes argument");
-        return NULL;
-    }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+PyDoc_STRVAR(
+    jsonDecode_doc,
+    "jsonDecode(T, data) -> T\n\n"
+    "Decode the json document in 'data' (a str, or a bytes-like object holding\n"
+    "UTF-8) directly into a T, without building python objects along the way.\n"
+    "Raises ValueError if the document isn't valid json or doesn't fit T. See\n"
+    "jsonEncode for the types we support."
+);
 
-    if (!PyBytes_Check(a1)) {
-        PyErr_SetString(PyExc_TypeError, "first argument to validateSerializedObject must be a bytes object");
+PyObject *jsonDecode(PyObject* nullValue, PyObject* args) {
+    PyObject* typeArg;
+    PyObject* data;
+
+    if (!PyArg_ParseTuple(args, "OO", &typeArg, &data)) {
         return NULL;
     }
 
-    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+    Type* decodeType = PyInstance::unwrapTypeArgToTypePtr(typeArg);
 
-    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a1), PyBytes_GET_SIZE((PyObject*)a1), *context);
+    if (!decodeType) {
+        PyErr_Format(PyExc_TypeError, "first argument to jsonDecode must be a type object, not %S", typeArg);
+        return NULL;
+    }
 
-    return translateExceptionToPyObject([&](){
-        try {
-            buf.readMessageAndDiscard();
+    // a str is decoded from its utf8, which python caches on the object
+    Py_buffer view;
 
-            if (buf.isDone()) {
-                return incref(Py_None);
-            }
+    if (PyUnicode_Check(data)) {
+        Py_ssize_t len;
+        const char* utf8 = PyUnicode_AsUTF8AndSize(data, &len);
 
-            std::ostringstream remaining;
-            remaining << PyBytes_GET_SIZE((PyObject*)a1) - buf.pos();
-            throw std::runtime_error(
-                "Stream had " +
-                remaining.str() +
-                " bytes remaining to process."
-            );
-        } catch(std::exception& e) {
-            return PyUnicode_FromString(e.what());
+        if (!utf8) {
+            return NULL;
         }
-    });
-}
 
-PyObject *validateSerializedObjectStream(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "validateSerializedObjectStream takes 1 bytes argument");
+        PyBuffer_FillInfo(&view, data, (void*)utf8, len, 1, PyBUF_SIMPLE);
+    } else if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) == -1) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "second argument to jsonDecode must be a str or bytes-like object");
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    if (!PyBytes_Check(a1)) {
-        PyErr_SetString(PyExc_TypeError, "first argument to validateSerializedObjectStream must be a bytes object");
-        return NULL;
-    }
+    PyObject* res = nullptr;
 
-    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+    try {
+        decodeType->assertForwardsResolved();
 
-    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a1), PyBytes_GET_SIZE((PyObject*)a1), *context);
+        Instance i = Instance::createAndInitialize(decodeType, [&](instance_ptr p) {
+            PyEnsureGilReleased releaseTheGil;
+            JsonCodec::decode(decodeType, (const uint8_t*)view.buf, view.len, p);
+        });
 
-    return translateExceptionToPyObject([&](){
-        try {
-            while (!buf.isDone()) {
-                buf.readMessageAndDiscard();
-            }
+        res = PyInstance::extractPythonObject(i.data(), i.type());
+    } catch(PythonExceptionSet& e) {
+    } catch(std::exception& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+    }
 
-            return incref(Py_None);
-        } catch(std::exception& e) {
-            return PyUnicode_FromString(e.what());
-        }
-    });
+    PyBuffer_Release(&view);
+
+    return res;
 }
 
-PyObject *deserializeStream(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 2 && PyTuple_Size(args) != 3) {
-        PyErr_SetString(PyExc_TypeError, "deserialize takes 2 or 3 positional arguments");
+PyDoc_STRVAR(
+    readCsvColumns_doc,
+    "readCsvColumns(data, RowType, delimiter=',', header=True, internStrings=True, threadCount=1)"
+    " -> dict\n\n"
+    "Parse the csv in the bytes-like object 'data' into a dict from each field name of\n"
+    "the NamedTuple 'RowType' to a ListOf(T) of that field's values. Fields may be bool,\n"
+    "ints, floats, str, or OneOf(None, T) of those, where empty cells become None.\n"
+    "Parsing runs without the GIL, on up to 'threadCount' threads. Raises ValueError\n"
+    "if the csv is malformed or a cell doesn't fit its field."
+);
+
+PyObject *readCsvColumns(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"data", "RowType", "delimiter", "header", "internStrings", "threadCount", NULL};
+
+    PyObject* data;
+    PyObject* typeArg;
+    const char* delimiter = ",";
+    int header = 1;
+    int internStrings = 1;
+    long threadCount = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OO|sppl", (char**)kwlist,
+            &data, &typeArg, &delimiter, &header, &internStrings, &threadCount
+    )) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
-    PyObjectHolder a2(PyTuple_GetItem(args, 1));
-    PyObjectHolder a3(PyTuple_Size(args) == 3 ? PyTuple_GetItem(args, 2) : nullptr);
 
-    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(a1);
+    Type* rowType = PyInstance::unwrapTypeArgToTypePtr(typeArg);
 
-    if (!serializeType) {
-        PyErr_SetString(PyExc_TypeError, "first argument to deserialize must be a type object");
+    if (!rowType || !rowType->isNamedTuple()) {
+        PyErr_Format(PyExc_TypeError, "RowType must be a NamedTuple, not %S", typeArg);
         return NULL;
     }
-    if (!PyBytes_Check(a2)) {
-        PyErr_SetString(PyExc_TypeError, "second argument to deserialize must be a bytes object");
+
+    if (strlen(delimiter) != 1 || delimiter[0] == '"' || delimiter[0] == '\n' || delimiter[0] == '\r') {
+        PyErr_Format(PyExc_ValueError, "delimiter must be a single character other than a quote or newline");
         return NULL;
     }
 
-    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
-    if (a3 && a3 != Py_None) {
-        context.reset(new PythonSerializationContext(a3));
+    if (threadCount < 1) {
+        PyErr_Format(PyExc_ValueError, "threadCount must be positive");
+        return NULL;
     }
 
-    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a2), PyBytes_GET_SIZE((PyObject*)a2), *context);
+    CsvReader::Options options;
+    options.delimiter = delimiter[0];
+    options.header = header;
+    options.internStrings = internStrings;
+    options.threadCount = threadCount;
 
-    try {
-        serializeType->assertForwardsResolved();
+    Py_buffer view;
 
-        TupleOfType* tupType = TupleOfType::Make(serializeType);
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) == -1) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "readCsvColumns needs a bytes-like object");
+        return NULL;
+    }
 
-        tupType->assertForwardsResolved();
+    PyObject* res = nullptr;
 
-        Instance i = Instance::createAndInitialize(tupType, [&](instance_ptr p) {
+    try {
+        rowType->assertForwardsResolved();
+
+        std::vector<Instance> columns;
+
+        {
             PyEnsureGilReleased releaseTheGil;
+            CsvReader::readColumns(rowType, (const uint8_t*)view.buf, view.len, options, columns);
+        }
 
-            tupType->constructorUnbounded(p, [&](instance_ptr tupElt, int index) {
-                if (buf.isDone()) {
-                    return false;
-                }
+        PyObjectStealer resDict(PyDict_New());
 
-                auto fieldAndWireType = buf.readFieldNumberAndWireType();
-                serializeType->deserialize(tupElt, buf, fieldAndWireType.second);
+        for (long k = 0; k < columns.size(); k++) {
+            PyObjectStealer column(PyInstance::extractPythonObject(columns[k]));
 
-                return true;
-            });
-        });
+            if (!column) {
+                throw PythonExceptionSet();
+            }
 
-        return PyInstance::extractPythonObject(i.data(), i.type());
-    } catch(std::exception& e) {
-        PyErr_SetString(PyExc_TypeError, e.what());
-        return NULL;
+            PyDict_SetItemString(resDict, ((NamedTuple*)rowType)->getNames()[k].c_str(), column);
+        }
+
+        res = incref(resDict);
     } catch(PythonExceptionSet& e) {
-        return NULL;
+    } catch(std::exception& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
     }
+
+    PyBuffer_Release(&view);
+
+    return res;
 }
 
-PyObject *allForwardTypesResolved(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "allForwardTypesResolved takes 1 positional argument");
-        return NULL;
-    }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+PyDoc_STRVAR(
+    configureCompiledPrint_doc,
+    "configureCompiledPrint(fd=None, path=None, ringBufferSize=None, bufferSize=0)\n\n"
+    "Choose where 'print' in compiled code writes: to the file descriptor 'fd', to\n"
+    "the file at 'path' (appending, and created if need be), or to an in-memory ring\n"
+    "buffer keeping the last 'ringBufferSize' bytes (see compiledPrintRingBufferContents).\n"
+    "With none of them, compiled print goes to stdout, which is the default.\n\n"
+    "Each thread buffers its output until it holds 'bufferSize' bytes. The default\n"
+    "of 0 writes every print immediately. A thread's buffer is also written when it\n"
+    "prints with flush=True, calls flushCompiledPrint, or exits."
+);
 
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+PyObject *configureCompiledPrint(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"fd", "path", "ringBufferSize", "bufferSize", NULL};
 
-    if (!t) {
-        PyErr_SetString(
-            PyExc_TypeError,
-            "first argument to 'allForwardTypesResolved' must be a type object"
-        );
+    PyObject* fd = Py_None;
+    PyObject* path = Py_None;
+    PyObject* ringBufferSize = Py_None;
+    Py_ssize_t bufferSize = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "|OOOn", (char**)kwlist, &fd, &path, &ringBufferSize, &bufferSize
+    )) {
         return NULL;
     }
 
-    return incref(t->resolved() ? Py_True : Py_False);
-}
-
-PyObject *isSimple(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "isSimple takes 1 positional argument");
+    if ((fd != Py_None) + (path != Py_None) + (ringBufferSize != Py_None) > 1) {
+        PyErr_SetString(PyExc_ValueError, "configureCompiledPrint takes at most one of fd, path and ringBufferSize");
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
-
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
 
-    if (!t) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'isSimple' must be a type object");
+    if (bufferSize < 0) {
+        PyErr_SetString(PyExc_ValueError, "bufferSize can't be negative");
         return NULL;
     }
 
-    return incref(t->isSimple() ? Py_True : Py_False);
-}
+    if (fd != Py_None) {
+        long fdValue = PyLong_AsLong(fd);
 
-PyObject *isPOD(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "isPOD takes 1 positional argument");
-        return NULL;
-    }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+        if (fdValue == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
 
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+        OutputSink::setFdTarget(fdValue, false);
+    } else if (path != Py_None) {
+        PyObject* pathBytes;
 
-    if (!t) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'isPOD' must be a type object");
-        return NULL;
-    }
+        if (!PyUnicode_FSConverter(path, &pathBytes)) {
+            return NULL;
+        }
 
-    return incref(t->isPOD() ? Py_True : Py_False);
-}
+        PyObjectStealer holdPath(pathBytes);
 
-PyObject *is_default_constructible(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "is_default_constructible takes 1 positional argument");
-        return NULL;
-    }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+        int opened = ::open(PyBytes_AsString(pathBytes), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
 
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+        if (opened < 0) {
+            return PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        }
 
-    if (!t) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'is_default_constructible' must be a type object");
-        return NULL;
-    }
+        OutputSink::setFdTarget(opened, true);
+    } else if (ringBufferSize != Py_None) {
+        Py_ssize_t capacity = PyLong_AsSsize_t(ringBufferSize);
 
-    return incref(t->is_default_constructible() ? Py_True : Py_False);
-}
+        if (capacity == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
 
-PyObject *all_alternatives_empty(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "all_alternatives_empty takes 1 positional argument");
-        return NULL;
+        if (capacity <= 0) {
+            PyErr_SetString(PyExc_ValueError, "ringBufferSize must be positive");
+            return NULL;
+        }
+
+        OutputSink::setRingBufferTarget(capacity);
+    } else {
+        OutputSink::setFdTarget(1, false);
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+    OutputSink::setBufferSize(bufferSize);
 
-    if (!t) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'all_alternatives_empty' must be a type object");
-        return NULL;
-    }
+    return incref(Py_None);
+}
 
-    if (t->getTypeCategory() == Type::TypeCategory::catAlternative) {
-        return incref(((Alternative*)t)->all_alternatives_empty() ? Py_True : Py_False);
-    }
-    else if (t->getTypeCategory() == Type::TypeCategory::catConcreteAlternative) {
-        return incref(((ConcreteAlternative*)t)->getAlternative()->all_alternatives_empty() ? Py_True : Py_False);
-    }
-    else {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'all_alternatives_empty' must be an Alternative or ConcreteAlternative");
-        return NULL;
-    }
+PyDoc_STRVAR(
+    flushCompiledPrint_doc,
+    "flushCompiledPrint()\n\n"
+    "Write out whatever compiled print has buffered on the calling thread."
+);
 
-    return incref(((Alternative*)t)->all_alternatives_empty() ? Py_True : Py_False);
-}
+PyObject *flushCompiledPrint(PyObject* nullValue, PyObject* args) {
+    OutputSink::flushThisThread();
 
-PyObject *wantsToDefaultConstruct(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "wantsToDefaultConstruct takes 1 positional argument");
-        return NULL;
-    }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+    return incref(Py_None);
+}
 
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+PyDoc_STRVAR(
+    compiledPrintRingBufferContents_doc,
+    "compiledPrintRingBufferContents() -> bytes\n\n"
+    "The bytes in the ring buffer configured by configureCompiledPrint(ringBufferSize=...),\n"
+    "oldest first. Doesn't include output threads are still buffering."
+);
 
-    if (!t) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'wantsToDefaultConstruct' must be a type object");
-        return NULL;
-    }
+PyObject *compiledPrintRingBufferContents(PyObject* nullValue, PyObject* args) {
+    std::string contents = OutputSink::ringBufferContents();
 
-    return incref(HeldClass::wantsToDefaultConstruct(t) ? Py_True : Py_False);
+    return PyBytes_FromStringAndSize(contents.data(), contents.size());
 }
 
-PyObject *bytecount(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "bytecount takes 1 positional argument");
-        return NULL;
-    }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+PyDoc_STRVAR(
+    regexCompile_doc,
+    "regexCompile(pattern, flags=0) -> (program, groupCount, groupIndex)\n\n"
+    "Compile the str or bytes regular expression 'pattern' for regexSearch, with\n"
+    "'flags' taken from the 're' module (IGNORECASE, MULTILINE, DOTALL, VERBOSE and\n"
+    "ASCII). Returns the program (an int), its number of capturing groups, and a\n"
+    "dict from the name of each named group to its index. Raises ValueError for\n"
+    "malformed patterns, and for backreferences and lookaround, which we don't support."
+);
 
-    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+PyObject *regexCompile(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"pattern", "flags", NULL};
 
-    if (!t) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'bytecount' must be a type object");
+    PyObject* pattern;
+    long long flags = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|L", (char**)kwlist, &pattern, &flags)) {
         return NULL;
     }
 
-    return PyLong_FromLong(t->bytecount());
-}
+    std::vector<uint32_t> codepoints;
+    bool isBytes = PyBytes_Check(pattern);
 
-PyObject *typesAreEquivalent(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 2) {
-        PyErr_SetString(PyExc_TypeError, "typesAreEquivalent takes 3 positional arguments");
+    if (isBytes) {
+        const uint8_t* data = (const uint8_t*)PyBytes_AS_STRING(pattern);
+        codepoints.assign(data, data + PyBytes_GET_SIZE(pattern));
+    } else if (PyUnicode_Check(pattern)) {
+        int kind = PyUnicode_KIND(pattern);
+        void* data = PyUnicode_DATA(pattern);
+
+        for (Py_ssize_t k = 0; k < PyUnicode_GET_LENGTH(pattern); k++) {
+            codepoints.push_back(PyUnicode_READ(kind, data, k));
+        }
+    } else {
+        PyErr_Format(PyExc_TypeError, "regex pattern must be str or bytes, not %S", pattern->ob_type);
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
-    PyObjectHolder a2(PyTuple_GetItem(args, 1));
 
-    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+    const Regex::Program* program;
 
-    if (!t1) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'typesAreEquivalent' must be a type object");
+    try {
+        program = Regex::compile(codepoints, flags, isBytes);
+    } catch(std::exception& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
         return NULL;
     }
 
-    Type* t2 = PyInstance::unwrapTypeArgToTypePtr(a2);
+    PyObjectStealer groupIndex(PyDict_New());
 
-    if (!t2) {
-        PyErr_SetString(PyExc_TypeError, "second argument to 'typesAreEquivalent' must be a type object");
-        return NULL;
+    for (auto& nameAndIndex: Regex::groupIndex(program)) {
+        PyObjectStealer index(PyLong_FromLongLong(nameAndIndex.second));
+        PyDict_SetItemString(groupIndex, nameAndIndex.first.c_str(), index);
     }
 
-    return Type::typesEquivalent(t1, t2) ? incref(Py_True) : incref(Py_False);
+    return Py_BuildValue("(LLO)", (long long)program, (long long)Regex::groupCount(program), (PyObject*)groupIndex);
 }
 
-PyObject *disableNativeDispatch(PyObject* nullValue, PyObject* args) {
-    native_dispatch_disabled++;
-    return incref(Py_None);
-}
+PyDoc_STRVAR(
+    regexSearch_doc,
+    "regexSearch(program, s, pos, endpos, mode, spans) -> bool\n\n"
+    "Run a program from regexCompile against s[pos:endpos] the way re's match (mode 0),\n"
+    "search (mode 1) or fullmatch (mode 2) would. On a match, write the start and end\n"
+    "of the match and of each group (-1 if it didn't participate) into the ListOf(int)\n"
+    "'spans', which must have room for 2 * (groupCount + 1) of them, and return True.\n"
+    "Adding 4 to 'mode' rejects an empty match at 'pos'."
+);
 
-PyObject *enableNativeDispatch(PyObject* nullValue, PyObject* args) {
-    native_dispatch_disabled--;
-    return incref(Py_None);
-}
+PyObject *regexSearch(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"program", "s", "pos", "endpos", "mode", "spans", NULL};
 
-PyObject *isDispatchEnabled(PyObject* nullValue, PyObject* args) {
-    return incref(native_dispatch_disabled ? Py_False : Py_True);
-}
+    long long programAddress;
+    PyObject* s;
+    long long pos;
+    long long endpos;
+    long long mode;
+    PyObject* spans;
 
-PyObject *installNativeFunctionPointer(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 5) {
-        PyErr_SetString(PyExc_TypeError, "installNativeFunctionPointer takes 5 positional arguments");
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "LOLLLO", (char**)kwlist, &programAddress, &s, &pos, &endpos, &mode, &spans
+    )) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
-    PyObjectHolder a2(PyTuple_GetItem(args, 1));
-    PyObjectHolder a3(PyTuple_GetItem(args, 2));
-    PyObjectHolder a4(PyTuple_GetItem(args, 3));
-    PyObjectHolder a5(PyTuple_GetItem(args, 4));
 
-    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+    const Regex::Program* program = Regex::lookup(programAddress);
 
-    if (!t1 || t1->getTypeCategory() != Type::TypeCategory::catFunction) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'installNativeFunctionPointer' must be a Function");
+    if (!program) {
+        PyErr_SetString(PyExc_ValueError, "not a compiled regex program");
         return NULL;
     }
 
-    if (!PyLong_Check(a2)) {
-        PyErr_SetString(PyExc_TypeError, "second argument to 'installNativeFunctionPointer' must be an integer 'index'");
+    if ((mode & ~Regex::MODE_MUST_ADVANCE) < Regex::MODE_MATCH || (mode & ~Regex::MODE_MUST_ADVANCE) > Regex::MODE_FULLMATCH) {
+        PyErr_SetString(PyExc_ValueError, "mode must be 0 (match), 1 (search) or 2 (fullmatch), plus 4 to reject empty matches at 'pos'");
         return NULL;
     }
 
-    if (!PyLong_Check(a3)) {
-        PyErr_SetString(PyExc_TypeError, "third argument to 'installNativeFunctionPointer' must be an integer function pointer");
+    if (Regex::isBytes(program) ? !PyBytes_Check(s) : !PyUnicode_Check(s)) {
+        PyErr_Format(
+            PyExc_TypeError,
+            Regex::isBytes(program) ? "can't use a bytes pattern on %S" : "can't use a str pattern on %S",
+            s->ob_type
+        );
         return NULL;
     }
 
+    static ListOfType* spansType = ListOfType::Make(::Int64::Make());
 
-    Type* returnType = PyInstance::unwrapTypeArgToTypePtr(a4);
-
-    if (!returnType) {
-        PyErr_SetString(PyExc_TypeError, "fourth argument to 'installNativeFunctionPointer' must be a type object (return type)");
+    if (PyInstance::extractTypeFrom(spans->ob_type) != spansType) {
+        PyErr_SetString(PyExc_TypeError, "spans must be a ListOf(int)");
         return NULL;
     }
 
-    std::vector<Type*> argTypes;
+    instance_ptr spansData = ((PyInstance*)spans)->dataPtr();
 
-    if (!unpackTupleToTypes(a5, argTypes)) {
+    if (spansType->count(spansData) < 2 * (Regex::groupCount(program) + 1)) {
+        PyErr_SetString(PyExc_ValueError, "spans is too short for this program");
         return NULL;
     }
 
-    Function* f = (Function*)t1;
+    return translateExceptionToPyObject([&]() {
+        Type* sType = Regex::isBytes(program) ? (Type*)BytesType::Make() : (Type*)StringType::Make();
 
-    int index = PyLong_AsLong(a2);
-    size_t ptr = PyLong_AsSize_t(a3);
+        Instance sInstance = Instance::createAndInitialize(sType, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(sType, p, s, ConversionLevel::Signature);
+        });
 
-    if (index < 0 || index >= f->getOverloads().size()) {
-        PyErr_SetString(PyExc_TypeError, "index is out of bounds");
-        return NULL;
-    }
+        bool matched;
 
-    f->addCompiledSpecialization(index,(compiled_code_entrypoint)ptr, returnType, argTypes);
+        if (Regex::isBytes(program)) {
+            matched = Regex::search(
+                program, *(BytesType::layout**)sInstance.data(), pos, endpos, mode,
+                (int64_t*)spansType->eltPtr(spansData, 0)
+            );
+        } else {
+            matched = Regex::search(
+                program, *(StringType::layout**)sInstance.data(), pos, endpos, mode,
+                (int64_t*)spansType->eltPtr(spansData, 0)
+            );
+        }
 
-    return incref(Py_None);
+        return incref(matched ? Py_True : Py_False);
+    });
 }
 
-PyObject *touchCompiledSpecializations(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 2) {
-        PyErr_SetString(PyExc_TypeError, "touchCompiledSpecializations takes 2 positional arguments");
+PyDoc_STRVAR(
+    makeUfunc_doc,
+    "makeUfunc(name, doc, nin, nout, typeNums, loop) -> numpy.ufunc\n\n"
+    "Make a numpy ufunc with 'nin' inputs and 'nout' outputs, over the numpy type numbers\n"
+    "'typeNums' (inputs first), whose inner loop is the compiled entrypoint at address\n"
+    "'loop'. That must be a function of (args, count, steps), the pointers, element count\n"
+    "and strides numpy passes to an inner loop. See typed_python/lib/ufunc.py."
+);
+
+PyObject *makeUfunc(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"name", "doc", "nin", "nout", "typeNums", "loop", NULL};
+
+    const char* name;
+    const char* doc;
+    int nin;
+    int nout;
+    PyObject* typeNums;
+    long long loop;
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "ssiiOL", (char**)kwlist, &name, &doc, &nin, &nout, &typeNums, &loop
+    )) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
-    PyObjectHolder a2(PyTuple_GetItem(args, 1));
 
-    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+    return translateExceptionToPyObject([&]() {
+        std::vector<int> nums;
 
-    if (!t1 || t1->getTypeCategory() != Type::TypeCategory::catFunction) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'touchCompiledSpecializations' must be a Function");
+        iterate(typeNums, [&](PyObject* typeNum) {
+            if (!PyLong_Check(typeNum)) {
+                throw std::runtime_error("typeNums must be ints");
+            }
+            nums.push_back(PyLong_AsLong(typeNum));
+        });
+
+        return NumpyUfunc::make(name, doc, nin, nout, nums, (compiled_code_entrypoint)loop);
+    });
+}
+
+PyDoc_STRVAR(
+    fileRead_doc,
+    "fileRead(fd, address, count) -> int\n\n"
+    "Read up to 'count' bytes from the file descriptor 'fd' into memory at 'address',\n"
+    "without the GIL. Returns how many bytes we read, zero at the end of the file, or\n"
+    "-errno if the read failed. Compiled code calls this directly. See\n"
+    "typed_python/lib/typed_file.py."
+);
+
+PyObject *fileRead(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"fd", "address", "count", NULL};
+
+    int fd;
+    unsigned long long address;
+    long long count;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iKL", (char**)kwlist, &fd, &address, &count)) {
         return NULL;
     }
 
-    if (!PyLong_Check(a2)) {
-        PyErr_SetString(PyExc_TypeError, "second argument to 'touchCompiledSpecializations' must be an integer 'index'");
+    if (count < 0) {
+        PyErr_SetString(PyExc_ValueError, "count can't be negative");
         return NULL;
     }
 
-    Function* f = (Function*)t1;
+    int64_t res;
 
-    int index = PyLong_AsLong(a2);
+    {
+        PyEnsureGilReleased releaseTheGil;
 
-    if (index < 0 || index >= f->getOverloads().size()) {
-        PyErr_SetString(PyExc_TypeError, "index is out of bounds");
-        return NULL;
+        res = FileIO::readSome(fd, (uint8_t*)address, count);
     }
 
-    f->touchCompiledSpecializations(index);
-
-    return incref(Py_None);
+    return PyLong_FromLongLong(res);
 }
 
-PyObject *isRecursive(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "isRecursive takes 1 positional argument");
+PyDoc_STRVAR(
+    fileWrite_doc,
+    "fileWrite(fd, data) -> int\n"
+    "fileWrite(fd, address, count) -> int\n\n"
+    "Write all of 'data' (anything that exports a buffer), or 'count' bytes of memory at\n"
+    "'address', to the file descriptor 'fd', without the GIL. Returns how many bytes we\n"
+    "wrote, or -errno if a write failed. Compiled code calls this directly (with bytes,\n"
+    "or an address and count). See typed_python/lib/typed_file.py."
+);
+
+PyObject *fileWrite(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"fd", "data", "count", NULL};
+
+    int fd;
+    PyObject* data;
+    long long count = -1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iO|L", (char**)kwlist, &fd, &data, &count)) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    MutuallyRecursiveTypeGroup* group = nullptr;
+    if (count >= 0) {
+        unsigned long long address = PyLong_AsUnsignedLongLong(data);
 
-    return translateExceptionToPyObject([&]() {
-        MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
-        group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+        if (address == (unsigned long long)-1 && PyErr_Occurred()) {
+            return NULL;
+        }
 
-        if (!group) {
-            return incref(Py_False);
+        int64_t res;
+
+        {
+            PyEnsureGilReleased releaseTheGil;
+
+            res = FileIO::writeAll(fd, (uint8_t*)address, count);
         }
 
-        return incref(group->getIndexToObject().size() > 1 ? Py_True : Py_False);
-    });
-}
+        return PyLong_FromLongLong(res);
+    }
 
-PyDoc_STRVAR(
-    resetCompilerVisibleObjectHashCache_doc,
-    "resetCompilerVisibleObjectHashCache() -> None\n\n"
-    "Reset the list of objects the identity hasher has seen. This is used in test to allow\n"
-    "us to inject a fault and then verify we detect it, and not leave that fault lying around."
-);
+    Py_buffer view;
 
-PyObject *resetCompilerVisibleObjectHashCache(PyObject* nullValue, PyObject* args) {
-    return translateExceptionToPyObject([&]() {
-        CompilerVisibleObjectVisitor::singleton().resetCache();
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) == -1) {
+        return NULL;
+    }
 
-        return incref(Py_None);
-    });
+    int64_t res;
+
+    {
+        PyEnsureGilReleased releaseTheGil;
+
+        res = FileIO::writeAll(fd, (uint8_t*)view.buf, view.len);
+    }
+
+    PyBuffer_Release(&view);
+
+    return PyLong_FromLongLong(res);
 }
 
 PyDoc_STRVAR(
-    checkForHashInstability_doc,
-    "checkForHashInstability() -> OneOf(None, str)\n\n"
-    "Walk every object that's been seen by the MutuallyRecursiveTypeGroup framework and verify\n"
-    "that the exact sequence of objects visible to it have not changed. If they have, return\n"
-    "a string detailing which objects changed and how (which could be very large).\n\n"
-    "During normal execution, this should always return None. However, if anything visible to\n"
-    "the compiler, such as a method on a class, or the identity of a module-level variable \n"
-    "changes, this function will find it. If such errors go undetected, it can cause various\n"
-    "errors, including multiple copies of the same type (since the hash is not stable) or \n"
-    "errors while computing hashes because the assumptions of the hasher are violated."
+    serializeToFile_doc,
+    "serializeToFile(T, value, fd, serializationContext=None, maxPendingBytes=64MB) -> int\n\n"
+    "Serialize 'value' as a T, exactly as 'serialize' would, but write the bytes to the\n"
+    "file descriptor 'fd' as we go, and return how many we wrote. A writer thread\n"
+    "takes each ~1MB block as it fills (and compresses it, if the context compresses\n"
+    "without threads), so serialization and writing overlap, and we never hold more\n"
+    "than 'maxPendingBytes' of serialized data at once. Raises OSError if a write fails,\n"
+    "in which case the file holds an unusable prefix of the data."
 );
 
-PyObject *checkForHashInstability(PyObject* nullValue, PyObject* args) {
-    return translateExceptionToPyObject([&]() {
-        try {
-            CompilerVisibleObjectVisitor::singleton().checkForInstability();
+PyObject *serializeToFile(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"T", "value", "fd", "serializationContext", "maxPendingBytes", NULL};
 
-            return incref(Py_None);
-        } catch(std::runtime_error& err) {
-            return PyUnicode_FromString(err.what());
-        }
-    });
-}
+    PyObject* pyType;
+    PyObject* value;
+    int fd;
+    PyObject* pyContext = Py_None;
+    long long maxPendingBytes = 64 * 1024 * 1024;
 
-PyObject *typeWalkRecord(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "typeWalkRecord takes 1 positional argument");
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OOi|OL", (char**)kwlist, &pyType, &value, &fd, &pyContext, &maxPendingBytes
+    )) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    return translateExceptionToPyObject([&]() {
-        TypeOrPyobj obj((PyObject*)a1);
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(pyType);
 
-        return PyUnicode_FromString(
-            ("Walk of " + obj.name() + ":\n\n" + CompilerVisibleObjectVisitor::recordWalkAsString(obj)).c_str()
+    if (!serializeType) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "first argument to serializeToFile must be a type object, not %S",
+            pyType
         );
-    });
-}
+        return NULL;
+    }
 
-PyObject *typesAndObjectsVisibleToCompilerFrom(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "typesAndObjectsVisibleToCompilerFrom takes 1 positional argument");
+    std::shared_ptr<SerializationContext> context;
+
+    if (!makeSerializationContext(pyContext, context)) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    return translateExceptionToPyObject([&]() {
-        std::vector<TypeOrPyobj> visible;
+    FileIO::AsyncWriter writer(fd, std::max<long long>(maxPendingBytes, 0));
 
-        MutuallyRecursiveTypeGroup::visibleFrom((PyObject*)a1, visible);
+    bool serialized;
+    int error;
 
-        PyObjectStealer res(PyList_New(0));
+    {
+        SerializationBuffer b(*context, &writer);
 
-        for (auto& t: visible) {
-            PyList_Append(
-                res,
-                t.type() ?
-                    (PyObject*)PyInstance::typeObj(t.type())
-                :   t.pyobj()
-            );
-        }
+        serialized = serializeIntoBuffer(serializeType, value, b);
+    }
 
-        return incref(res);
-    });
-}
+    {
+        PyEnsureGilReleased releaseTheGil;
 
-PyObject *recursiveTypeGroupHash(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "recursiveTypeGroupHash takes 1 positional argument");
+        error = writer.close();
+    }
+
+    if (error) {
+        // this is why serialization stopped, if it did
+        PyErr_Clear();
+        errno = error;
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+
+    if (!serialized) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    MutuallyRecursiveTypeGroup* group = nullptr;
+    return PyLong_FromSize_t(writer.bytesWritten());
+}
 
-    return translateExceptionToPyObject([&]() {
-        if (PyType_Check(a1)) {
-            Type* typeArg = PyInstance::extractTypeFrom(a1);
-            if (typeArg) {
-                group = typeArg->getRecursiveTypeGroup();
-            }
-        }
+PyDoc_STRVAR(
+    serializeDelta_doc,
+    "serializeDelta(T, previous, current, serializationContext=None) -> bytes\n\n"
+    "Serialize 'current' as a T, as the difference from the T 'previous'. Parts of\n"
+    "'current' that are unchanged from 'previous' (including immutable containers it\n"
+    "shares with it) cost a byte or so each. 'deserializeDelta' turns the result\n"
+    "back into 'current', given the same 'previous'. See DeltaSerialization.hpp."
+);
 
-        if (!group) {
-            MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
-            group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
-        }
+PyObject *serializeDelta(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"T", "previous", "current", "serializationContext", NULL};
 
-        if (!group) {
-            return incref(Py_None);
-        }
+    PyObject* pyType;
+    PyObject* previous;
+    PyObject* current;
+    PyObject* pyContext = Py_None;
 
-        return PyUnicode_FromString(group->hash().digestAsHexString().c_str());
-    });
-}
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OOO|O", (char**)kwlist, &pyType, &previous, &current, &pyContext
+    )) {
+        return NULL;
+    }
 
-PyObject *recursiveTypeGroupReprDeepFlag(PyObject* nullValue, PyObject* args, bool deep) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "recursiveTypeGroupRepr takes 1 positional argument");
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(pyType);
+
+    if (!serializeType) {
+        PyErr_Format(PyExc_TypeError, "first argument to serializeDelta must be a type object, not %S", pyType);
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    MutuallyRecursiveTypeGroup* group = nullptr;
+    std::shared_ptr<SerializationContext> context;
+
+    if (!makeSerializationContext(pyContext, context)) {
+        return NULL;
+    }
 
     return translateExceptionToPyObject([&]() {
-        MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
-        group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+        serializeType->assertForwardsResolved();
 
-        if (!group) {
-            return incref(Py_None);
-        }
+        Instance previousInstance = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(serializeType, p, previous, ConversionLevel::New);
+        });
 
-        return PyUnicode_FromString(group->repr(deep).c_str());
+        Instance currentInstance = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(serializeType, p, current, ConversionLevel::New);
+        });
+
+        SerializationBuffer b(*context);
+
+        DeltaSerialization::serialize(serializeType, previousInstance.data(), currentInstance.data(), b);
+
+        b.finalize();
+
+        PyObject* bytes = PyBytes_FromStringAndSize(NULL, b.size());
+        b.copyInto((uint8_t*)PyBytes_AS_STRING(bytes));
+
+        return bytes;
     });
 }
 
-PyObject *recursiveTypeGroupRepr(PyObject* nullValue, PyObject* args) {
-    return recursiveTypeGroupReprDeepFlag(nullValue, args, false);
-}
+PyDoc_STRVAR(
+    deserializeDelta_doc,
+    "deserializeDelta(T, previous, delta, serializationContext=None) -> T\n\n"
+    "Rebuild the T that 'serializeDelta(T, previous, current)' produced 'delta' from.\n"
+    "'previous' has to be the value it was compared against. Parts that didn't change\n"
+    "are copied from 'previous', so the result shares its immutable containers."
+);
 
+PyObject *deserializeDelta(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"T", "previous", "delta", "serializationContext", NULL};
 
-PyObject *recursiveTypeGroupDeepRepr(PyObject* nullValue, PyObject* args) {
-    return recursiveTypeGroupReprDeepFlag(nullValue, args, true);
-}
+    PyObject* pyType;
+    PyObject* previous;
+    PyObject* delta;
+    PyObject* pyContext = Py_None;
 
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OOO|O", (char**)kwlist, &pyType, &previous, &delta, &pyContext
+    )) {
+        return NULL;
+    }
 
-PyObject *recursiveTypeGroup(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "recursiveTypeGroup takes 1 positional argument");
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(pyType);
+
+    if (!serializeType) {
+        PyErr_Format(PyExc_TypeError, "first argument to deserializeDelta must be a type object, not %S", pyType);
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    MutuallyRecursiveTypeGroup* group = nullptr;
+    std::shared_ptr<SerializationContext> context;
 
-    return translateExceptionToPyObject([&]() {
-        MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
-        group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+    if (!makeSerializationContext(pyContext, context)) {
+        return NULL;
+    }
 
-        if (!group) {
-            return incref(Py_None);
-        }
+    Py_buffer view;
+    if (PyObject_GetBuffer(delta, &view, PyBUF_SIMPLE) == -1) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "'delta' must be a bytes-like object");
+        return NULL;
+    }
 
-        PyObjectStealer res(PyList_New(0));
+    PyObject* res = translateExceptionToPyObject([&]() {
+        serializeType->assertForwardsResolved();
 
-        for (auto ixAndType: group->getIndexToObject()) {
-            PyList_Append(
-                res,
-                ixAndType.second.type() ?
-                    (PyObject*)PyInstance::typeObj(ixAndType.second.type())
-                :   ixAndType.second.pyobj()
-            );
-        }
+        Instance previousInstance = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(serializeType, p, previous, ConversionLevel::New);
+        });
 
-        return incref(res);
+        DeserializationBuffer buf((uint8_t*)view.buf, view.len, *context);
+
+        Instance i = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            DeltaSerialization::deserialize(serializeType, previousInstance.data(), buf, p);
+        });
+
+        return PyInstance::extractPythonObject(i.data(), i.type());
     });
+
+    PyBuffer_Release(&view);
+
+    return res;
 }
 
-PyObject *referencedTypes(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1) {
-        PyErr_SetString(PyExc_TypeError, "referencedTypes takes 1 positional argument");
+PyDoc_STRVAR(
+    deserializeInto_doc,
+    "deserializeInto(T, data, existing, serializationContext=None) -> T\n\n"
+    "Deserialize 'data' as 'deserialize' would, reusing the storage of 'existing', a T.\n"
+    "If 'existing' is a ListOf, Dict or Set, it's filled in place and returned. Containers\n"
+    "inside it that nothing else refers to are refilled rather than reallocated, so a loop\n"
+    "decoding messages of the same shape into one value allocates almost nothing. Any other\n"
+    "'existing' is copied first, so the result is a new value. See InPlaceDeserialization.hpp."
+);
+
+PyObject *deserializeInto(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"T", "data", "existing", "serializationContext", NULL};
+
+    PyObject* pyType;
+    PyObject* data;
+    PyObject* existing;
+    PyObject* pyContext = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "OOO|O", (char**)kwlist, &pyType, &data, &existing, &pyContext
+    )) {
         return NULL;
     }
-    PyObjectHolder a1(PyTuple_GetItem(args, 0));
 
-    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(pyType);
 
-    if (!t1) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'referencedTypes' must be a type object");
+    if (!serializeType) {
+        PyErr_Format(PyExc_TypeError, "first argument to deserializeInto must be a type object, not %S", pyType);
         return NULL;
     }
 
-    return translateExceptionToPyObject([&]() {
-        PyObjectStealer res(PyList_New(0));
+    std::shared_ptr<SerializationContext> context;
 
-        t1->visitReferencedTypes([&](Type* refType) {
-            PyList_Append(
-                res,
-                (PyObject*)PyInstance::typeObj(refType)
+    if (!makeSerializationContext(pyContext, context)) {
+        return NULL;
+    }
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) == -1) {
+        PyErr_Clear();
+        PyErr_SetString(PyExc_TypeError, "second argument to deserializeInto must be a bytes-like object");
+        return NULL;
+    }
+
+    PyObject* res = translateExceptionToPyObject([&]() {
+        serializeType->assertForwardsResolved();
+
+        DeserializationBuffer buf((uint8_t*)view.buf, view.len, *context);
+
+        // we keep the GIL while we fill in 'existing', since other threads can see it
+        if (PyInstance::extractTypeFrom(existing->ob_type) == serializeType && (
+                serializeType->getTypeCategory() == Type::TypeCategory::catListOf
+                || serializeType->getTypeCategory() == Type::TypeCategory::catDict
+                || serializeType->getTypeCategory() == Type::TypeCategory::catSet
+        )) {
+            auto fieldAndWireType = buf.readFieldNumberAndWireType();
+            InPlaceDeserialization::deserialize(
+                serializeType,
+                ((PyInstance*)existing)->dataPtr(),
+                buf,
+                fieldAndWireType.second
             );
+
+            return incref(existing);
+        }
+
+        Instance i = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(serializeType, p, existing, ConversionLevel::New);
         });
 
-        return incref(res);
+        auto fieldAndWireType = buf.readFieldNumberAndWireType();
+        InPlaceDeserialization::deserialize(serializeType, i.data(), buf, fieldAndWireType.second);
+
+        return PyInstance::extractPythonObject(i.data(), i.type());
     });
+
+    PyBuffer_Release(&view);
+
+    return res;
 }
 
-PyObject *isBinaryCompatible(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 2) {
-        PyErr_SetString(PyExc_TypeError, "isBinaryCompatible takes 2 positional arguments");
+PyObject *decodeSerializedObject(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "validateSerializedObject takes 1 bytes argument");
         return NULL;
     }
     PyObjectHolder a1(PyTuple_GetItem(args, 0));
-    PyObjectHolder a2(PyTuple_GetItem(args, 1));
-
-    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
-    Type* t2 = PyInstance::unwrapTypeArgToTypePtr(a2);
 
-    if (!t1) {
-        PyErr_SetString(PyExc_TypeError, "first argument to 'isBinaryCompatible' must be a type object");
-        return NULL;
-    }
-    if (!t2) {
-        PyErr_SetString(PyExc_TypeError, "second argument to 'isBinaryCompatible' must be a type object");
+    if (!PyBytes_Check(a1)) {
+        PyErr_SetString(PyExc_TypeError, "first argument to validateSerializedObject must be a bytes object");
         return NULL;
     }
 
-    return incref(t1->isBinaryCompatibleWith(t2) ? Py_True : Py_False);
-}
-
-PyObject *MakeForward(PyObject* nullValue, PyObject* args) {
-    int num_args = PyTuple_Size(args);
+    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
 
-    PyThreadState * ts = PyThreadState_Get();
-    std::string moduleName;
-    PyObject* pyModuleName;
+    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a1), PyBytes_GET_SIZE((PyObject*)a1), *context);
 
-    if (ts->frame && ts->frame->f_globals &&
-            (pyModuleName = PyDict_GetItemString(ts->frame->f_globals, "__name__"))) {
-        if (PyUnicode_Check(pyModuleName)) {
-            moduleName = PyUnicode_AsUTF8(pyModuleName);
+    std::function<PyObject* (size_t)> decode = [&](size_t wireType) {
+        if (wireType == WireType::VARINT) {
+            return PyLong_FromLong(buf.readSignedVarint());
         }
-    }
+        if (wireType == WireType::EMPTY) {
+            return PyList_New(0);
+        }
+        if (wireType == WireType::BITS_32) {
+            float f = buf.read<float>();
+            Instance i((instance_ptr)&f, ::Float32::Make());
 
-    if (num_args > 1 || !PyUnicode_Check(PyTuple_GetItem(args,0))) {
-        PyErr_SetString(PyExc_TypeError, "Forward takes a zero or one string positional arguments.");
-        return NULL;
-    }
+            return PyInstance::fromInstance(i);
+        }
+        if (wireType == WireType::BITS_64) {
+            return PyFloat_FromDouble(buf.read<double>());
+        }
+        if (wireType == WireType::BYTES) {
+            size_t count = buf.readUnsignedVarint();
+            return buf.read_bytes_fun(count, [&](uint8_t* bytes) {
+                return PyBytes_FromStringAndSize((const char*)bytes, count);
+            });
+        }
+        if (wireType == WireType::SINGLE) {
+            auto fieldAndWire = buf.readFieldNumberAndWireType();
 
-    if (num_args == 1) {
-        std::string name = PyUnicode_AsUTF8(PyTuple_GetItem(args,0));
+            PyObjectStealer res(decode(fieldAndWire.second));
 
-        if (moduleName.size()) {
-            name = moduleName + "." + name;
+            PyObjectStealer result(PyList_New(0));
+            PyObjectStealer key(PyLong_FromLong(fieldAndWire.first));
+            PyObjectStealer tup(PyTuple_Pack(2, (PyObject*)key, (PyObject*)res));
+            PyList_Append(result, tup);
+            return incref(result);
         }
+        if (wireType == WireType::BEGIN_COMPOUND) {
+            PyObjectStealer result(PyList_New(0));
 
-        return incref((PyObject*)PyInstance::typeObj(
-            ::Forward::Make(name)
-            ));
-    } else {
-        return incref((PyObject*)PyInstance::typeObj(
-            ::Forward::Make()
-            ));
-    }
-}
+            while (true) {
+                auto fieldAndWire = buf.readFieldNumberAndWireType();
 
-/*********
-calls PyCode_New and faithfully maintains the identities of tuples passed in.
+                if (fieldAndWire.second == WireType::END_COMPOUND) {
+                    return incref(result);
+                }
 
-this has signature
-    PyCode_New(
-        int argcount,
-        int kwonlyargcount,
-        int nlocals,
-        int stacksize,
-        int flags,
-        PyObject *code,
-        PyObject *consts,
-        PyObject *names,
-        PyObject *varnames,
-        PyObject *freevars,
-        PyObject *cellvars,
-        PyObject *filename,
-        PyObject *name,
-        int firstlineno,
-        PyObject *lnotab
-    )
+                PyObjectStealer res(decode(fieldAndWire.second));
 
-you may also call, after 3.8, PyCode_NewWithPosOnlyArgs which has signature
+                PyObjectStealer key(PyLong_FromLong(fieldAndWire.first));
+                //(PyObject*) are because this is a variadic function and doesn't cast the pointers
+                //correctly
+                PyObjectStealer tup(PyTuple_Pack(2, (PyObject*)key, (PyObject*)res));
+                PyList_Append(result, tup);
+            }
+        }
 
-PyCodeObject* PyCode_NewWithPosOnlyArgs(
-    int argcount,
-    int posonlyargcount,
-    int kwonlyargcount,
-    int nlocals,
-    int stacksize,
-    int flags,
-    PyObject *code,
-    PyObject *consts,
-    PyObject *names,
-    PyObject *varnames,
-    PyObject *freevars,
-    PyObject *cellvars,
-    PyObject *filename,
+        throw std::runtime_error("Invalid wire type encountered: " + format(wireType));
+    };
+
+    return translateExceptionToPyObject([&](){
+        auto msg = buf.readFieldNumberAndWireType();
+
+        PyObjectStealer res(decode(msg.second));
+
+        if (!buf.isDone()) {
+            PyObjectStealer resDict(PyDict_New());
+            PyDict_SetItemString(resDict, "result", res);
+            PyDict_SetItemString(
+                resDict,
+                "remainingBytes",
+                PyBytes_FromStringAndSize(
+                    (const char*)PyBytes_AsString(a1) + buf.pos(),
+                    PyBytes_GET_SIZE((PyObject*)a1) - buf.pos()
+                )
+            );
+
+            return incref(resDict);
+        }
+
+        return incref(res);
+    });
+}
+
+PyObject *validateSerializedObject(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "validateSerializedObject takes 1 bytes argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    if (!PyBytes_Check(a1)) {
+        PyErr_SetString(PyExc_TypeError, "first argument to validateSerializedObject must be a bytes object");
+        return NULL;
+    }
+
+    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+
+    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a1), PyBytes_GET_SIZE((PyObject*)a1), *context);
+
+    return translateExceptionToPyObject([&](){
+        try {
+            buf.readMessageAndDiscard();
+
+            if (buf.isDone()) {
+                return incref(Py_None);
+            }
+
+            std::ostringstream remaining;
+            remaining << PyBytes_GET_SIZE((PyObject*)a1) - buf.pos();
+            throw std::runtime_error(
+                "Stream had " +
+                remaining.str() +
+                " bytes remaining to process."
+            );
+        } catch(std::exception& e) {
+            return PyUnicode_FromString(e.what());
+        }
+    });
+}
+
+PyObject *validateSerializedObjectStream(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "validateSerializedObjectStream takes 1 bytes argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    if (!PyBytes_Check(a1)) {
+        PyErr_SetString(PyExc_TypeError, "first argument to validateSerializedObjectStream must be a bytes object");
+        return NULL;
+    }
+
+    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+
+    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a1), PyBytes_GET_SIZE((PyObject*)a1), *context);
+
+    return translateExceptionToPyObject([&](){
+        try {
+            while (!buf.isDone()) {
+                buf.readMessageAndDiscard();
+            }
+
+            return incref(Py_None);
+        } catch(std::exception& e) {
+            return PyUnicode_FromString(e.what());
+        }
+    });
+}
+
+PyObject *deserializeStream(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 2 && PyTuple_Size(args) != 3) {
+        PyErr_SetString(PyExc_TypeError, "deserialize takes 2 or 3 positional arguments");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+    PyObjectHolder a2(PyTuple_GetItem(args, 1));
+    PyObjectHolder a3(PyTuple_Size(args) == 3 ? PyTuple_GetItem(args, 2) : nullptr);
+
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!serializeType) {
+        PyErr_SetString(PyExc_TypeError, "first argument to deserialize must be a type object");
+        return NULL;
+    }
+    if (!PyBytes_Check(a2)) {
+        PyErr_SetString(PyExc_TypeError, "second argument to deserialize must be a bytes object");
+        return NULL;
+    }
+
+    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+    if (a3 && a3 != Py_None) {
+        context.reset(new PythonSerializationContext(a3));
+    }
+
+    DeserializationBuffer buf((uint8_t*)PyBytes_AsString(a2), PyBytes_GET_SIZE((PyObject*)a2), *context);
+
+    try {
+        serializeType->assertForwardsResolved();
+
+        TupleOfType* tupType = TupleOfType::Make(serializeType);
+
+        tupType->assertForwardsResolved();
+
+        Instance i = Instance::createAndInitialize(tupType, [&](instance_ptr p) {
+            PyEnsureGilReleased releaseTheGil;
+
+            tupType->constructorUnbounded(p, [&](instance_ptr tupElt, int index) {
+                if (buf.isDone()) {
+                    return false;
+                }
+
+                auto fieldAndWireType = buf.readFieldNumberAndWireType();
+                serializeType->deserialize(tupElt, buf, fieldAndWireType.second);
+
+                return true;
+            });
+        });
+
+        return PyInstance::extractPythonObject(i.data(), i.type());
+    } catch(std::exception& e) {
+        PyErr_SetString(PyExc_TypeError, e.what());
+        return NULL;
+    } catch(PythonExceptionSet& e) {
+        return NULL;
+    }
+}
+
+PyObject *allForwardTypesResolved(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "allForwardTypesResolved takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(
+            PyExc_TypeError,
+            "first argument to 'allForwardTypesResolved' must be a type object"
+        );
+        return NULL;
+    }
+
+    return incref(t->resolved() ? Py_True : Py_False);
+}
+
+PyObject *isSimple(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "isSimple takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'isSimple' must be a type object");
+        return NULL;
+    }
+
+    return incref(t->isSimple() ? Py_True : Py_False);
+}
+
+PyObject *isPOD(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "isPOD takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'isPOD' must be a type object");
+        return NULL;
+    }
+
+    return incref(t->isPOD() ? Py_True : Py_False);
+}
+
+PyObject *is_default_constructible(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "is_default_constructible takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'is_default_constructible' must be a type object");
+        return NULL;
+    }
+
+    return incref(t->is_default_constructible() ? Py_True : Py_False);
+}
+
+PyObject *all_alternatives_empty(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "all_alternatives_empty takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'all_alternatives_empty' must be a type object");
+        return NULL;
+    }
+
+    if (t->getTypeCategory() == Type::TypeCategory::catAlternative) {
+        return incref(((Alternative*)t)->all_alternatives_empty() ? Py_True : Py_False);
+    }
+    else if (t->getTypeCategory() == Type::TypeCategory::catConcreteAlternative) {
+        return incref(((ConcreteAlternative*)t)->getAlternative()->all_alternatives_empty() ? Py_True : Py_False);
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'all_alternatives_empty' must be an Alternative or ConcreteAlternative");
+        return NULL;
+    }
+
+    return incref(((Alternative*)t)->all_alternatives_empty() ? Py_True : Py_False);
+}
+
+PyObject *alternative_is_inline(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "alternative_is_inline takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'alternative_is_inline' must be a type object");
+        return NULL;
+    }
+
+    if (t->getTypeCategory() == Type::TypeCategory::catAlternative) {
+        return incref(((Alternative*)t)->is_inline() ? Py_True : Py_False);
+    }
+    else if (t->getTypeCategory() == Type::TypeCategory::catConcreteAlternative) {
+        return incref(((ConcreteAlternative*)t)->getAlternative()->is_inline() ? Py_True : Py_False);
+    }
+
+    PyErr_SetString(PyExc_TypeError, "first argument to 'alternative_is_inline' must be an Alternative or ConcreteAlternative");
+    return NULL;
+}
+
+PyObject *oneof_null_niche_index(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "oneof_null_niche_index takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t || t->getTypeCategory() != Type::TypeCategory::catOneOf) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'oneof_null_niche_index' must be a OneOf");
+        return NULL;
+    }
+
+    int index = ((OneOfType*)t)->nullNicheIndex();
+
+    if (index < 0) {
+        return incref(Py_None);
+    }
+
+    return PyLong_FromLong(index);
+}
+
+PyObject *wantsToDefaultConstruct(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "wantsToDefaultConstruct takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'wantsToDefaultConstruct' must be a type object");
+        return NULL;
+    }
+
+    return incref(HeldClass::wantsToDefaultConstruct(t) ? Py_True : Py_False);
+}
+
+PyObject *bytecount(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "bytecount takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'bytecount' must be a type object");
+        return NULL;
+    }
+
+    return PyLong_FromLong(t->bytecount());
+}
+
+PyObject *typesAreEquivalent(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 2) {
+        PyErr_SetString(PyExc_TypeError, "typesAreEquivalent takes 3 positional arguments");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+    PyObjectHolder a2(PyTuple_GetItem(args, 1));
+
+    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t1) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'typesAreEquivalent' must be a type object");
+        return NULL;
+    }
+
+    Type* t2 = PyInstance::unwrapTypeArgToTypePtr(a2);
+
+    if (!t2) {
+        PyErr_SetString(PyExc_TypeError, "second argument to 'typesAreEquivalent' must be a type object");
+        return NULL;
+    }
+
+    return Type::typesEquivalent(t1, t2) ? incref(Py_True) : incref(Py_False);
+}
+
+PyObject *disableNativeDispatch(PyObject* nullValue, PyObject* args) {
+    native_dispatch_disabled++;
+    return incref(Py_None);
+}
+
+PyObject *enableNativeDispatch(PyObject* nullValue, PyObject* args) {
+    native_dispatch_disabled--;
+    return incref(Py_None);
+}
+
+PyObject *isDispatchEnabled(PyObject* nullValue, PyObject* args) {
+    return incref(native_dispatch_disabled ? Py_False : Py_True);
+}
+
+PyObject *refcountsAreThreadConfined(PyObject* nullValue, PyObject* args) {
+    return incref(refcounts_are_thread_confined ? Py_True : Py_False);
+}
+
+PyObject *immortalRefcount(PyObject* nullValue, PyObject* args) {
+    return Py_BuildValue("(LL)", (long long)IMMORTAL_REFCOUNT, (long long)IMMORTAL_REFCOUNT_THRESHOLD);
+}
+
+PyObject *installNativeFunctionPointer(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 5 && PyTuple_Size(args) != 7 && PyTuple_Size(args) != 8) {
+        PyErr_SetString(PyExc_TypeError, "installNativeFunctionPointer takes 5, 7 or 8 positional arguments");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+    PyObjectHolder a2(PyTuple_GetItem(args, 1));
+    PyObjectHolder a3(PyTuple_GetItem(args, 2));
+    PyObjectHolder a4(PyTuple_GetItem(args, 3));
+    PyObjectHolder a5(PyTuple_GetItem(args, 4));
+
+    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t1 || t1->getTypeCategory() != Type::TypeCategory::catFunction) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'installNativeFunctionPointer' must be a Function");
+        return NULL;
+    }
+
+    if (!PyLong_Check(a2)) {
+        PyErr_SetString(PyExc_TypeError, "second argument to 'installNativeFunctionPointer' must be an integer 'index'");
+        return NULL;
+    }
+
+    if (!PyLong_Check(a3)) {
+        PyErr_SetString(PyExc_TypeError, "third argument to 'installNativeFunctionPointer' must be an integer function pointer");
+        return NULL;
+    }
+
+
+    Type* returnType = PyInstance::unwrapTypeArgToTypePtr(a4);
+
+    if (!returnType) {
+        PyErr_SetString(PyExc_TypeError, "fourth argument to 'installNativeFunctionPointer' must be a type object (return type)");
+        return NULL;
+    }
+
+    std::vector<Type*> argTypes;
+
+    if (!unpackTupleToTypes(a5, argTypes)) {
+        return NULL;
+    }
+
+    Function* f = (Function*)t1;
+
+    int index = PyLong_AsLong(a2);
+    size_t ptr = PyLong_AsSize_t(a3);
+
+    if (index < 0 || index >= f->getOverloads().size()) {
+        PyErr_SetString(PyExc_TypeError, "index is out of bounds");
+        return NULL;
+    }
+
+    // optionally, the number of calls after which to call 'onHot', which
+    // may then install a replacement with the same signature. 'onHot' may be
+    // None if we only pass the eighth argument.
+    int64_t hotAfterCalls = 0;
+    PyObject* onHot = nullptr;
+    bool releaseGilImmediately = false;
+
+    if (PyTuple_Size(args) >= 7) {
+        hotAfterCalls = PyLong_AsLongLong(PyTuple_GetItem(args, 5));
+
+        if (hotAfterCalls == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+
+        onHot = PyTuple_GetItem(args, 6);
+
+        if (onHot == Py_None) {
+            onHot = nullptr;
+        } else if (!PyCallable_Check(onHot)) {
+            PyErr_SetString(PyExc_TypeError, "seventh argument to 'installNativeFunctionPointer' must be callable");
+            return NULL;
+        }
+    }
+
+    // optionally, whether the entrypoint was compiled 'nogil' and so can
+    // release the GIL as soon as it's called.
+    if (PyTuple_Size(args) == 8) {
+        int isTrue = PyObject_IsTrue(PyTuple_GetItem(args, 7));
+
+        if (isTrue == -1) {
+            return NULL;
+        }
+
+        releaseGilImmediately = isTrue;
+    }
+
+    f->addCompiledSpecialization(
+        index,
+        (compiled_code_entrypoint)ptr,
+        returnType,
+        argTypes,
+        hotAfterCalls,
+        onHot,
+        releaseGilImmediately
+    );
+
+    return incref(Py_None);
+}
+
+PyObject *touchCompiledSpecializations(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 2) {
+        PyErr_SetString(PyExc_TypeError, "touchCompiledSpecializations takes 2 positional arguments");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+    PyObjectHolder a2(PyTuple_GetItem(args, 1));
+
+    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t1 || t1->getTypeCategory() != Type::TypeCategory::catFunction) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'touchCompiledSpecializations' must be a Function");
+        return NULL;
+    }
+
+    if (!PyLong_Check(a2)) {
+        PyErr_SetString(PyExc_TypeError, "second argument to 'touchCompiledSpecializations' must be an integer 'index'");
+        return NULL;
+    }
+
+    Function* f = (Function*)t1;
+
+    int index = PyLong_AsLong(a2);
+
+    if (index < 0 || index >= f->getOverloads().size()) {
+        PyErr_SetString(PyExc_TypeError, "index is out of bounds");
+        return NULL;
+    }
+
+    f->touchCompiledSpecializations(index);
+
+    return incref(Py_None);
+}
+
+PyObject *materializeFunctionOverloads(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "materializeFunctionOverloads takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t1 || t1->getTypeCategory() != Type::TypeCategory::catFunction) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'materializeFunctionOverloads' must be a Function");
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        return PyFunctionInstance::materializeOverloads((Function*)t1);
+    });
+}
+
+PyDoc_STRVAR(entrypointDispatchCacheStats_doc,
+    "entrypointDispatchCacheStats(f) -> dict\n\n"
+    "Return the state of the cache calls from the interpreter into the Entrypoint\n"
+    "'f' (a Function, or its type) use to skip overload resolution: 'hits' and\n"
+    "'misses' count the calls that could use it, and 'entries' is the number of\n"
+    "argument type signatures it holds. Calls with keyword arguments, and calls to\n"
+    "functions whose signature depends on argument values, never use the cache."
+);
+
+PyObject *entrypointDispatchCacheStats(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"f", NULL};
+
+    PyObject* funcArg;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &funcArg)) {
+        return NULL;
+    }
+
+    Type* t = PyInstance::extractTypeFrom(funcArg->ob_type);
+
+    if (!t || t->getTypeCategory() != Type::TypeCategory::catFunction) {
+        t = PyInstance::unwrapTypeArgToTypePtr(funcArg);
+        PyErr_Clear();
+    }
+
+    if (!t || t->getTypeCategory() != Type::TypeCategory::catFunction) {
+        PyErr_SetString(PyExc_TypeError, "entrypointDispatchCacheStats expects a Function");
+        return NULL;
+    }
+
+    FunctionDispatchCache& cache = ((Function*)t)->getDispatchCache();
+
+    PyObjectStealer res(PyDict_New());
+    PyObjectStealer hits(PyLong_FromLongLong(cache.hits()));
+    PyObjectStealer misses(PyLong_FromLongLong(cache.misses()));
+    PyObjectStealer entries(PyLong_FromSize_t(cache.size()));
+
+    PyDict_SetItemString(res, "hits", hits);
+    PyDict_SetItemString(res, "misses", misses);
+    PyDict_SetItemString(res, "entries", entries);
+
+    return incref((PyObject*)res);
+}
+
+PyObject *isRecursive(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "isRecursive takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    MutuallyRecursiveTypeGroup* group = nullptr;
+
+    return translateExceptionToPyObject([&]() {
+        MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
+        group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+
+        if (!group) {
+            return incref(Py_False);
+        }
+
+        return incref(group->getIndexToObject().size() > 1 ? Py_True : Py_False);
+    });
+}
+
+PyDoc_STRVAR(
+    resetCompilerVisibleObjectHashCache_doc,
+    "resetCompilerVisibleObjectHashCache() -> None\n\n"
+    "Reset the list of objects the identity hasher has seen. This is used in test to allow\n"
+    "us to inject a fault and then verify we detect it, and not leave that fault lying around."
+);
+
+PyObject *resetCompilerVisibleObjectHashCache(PyObject* nullValue, PyObject* args) {
+    return translateExceptionToPyObject([&]() {
+        CompilerVisibleObjectVisitor::singleton().resetCache();
+
+        return incref(Py_None);
+    });
+}
+
+PyDoc_STRVAR(
+    checkForHashInstability_doc,
+    "checkForHashInstability() -> OneOf(None, str)\n\n"
+    "Walk every object that's been seen by the MutuallyRecursiveTypeGroup framework and verify\n"
+    "that the exact sequence of objects visible to it have not changed. If they have, return\n"
+    "a string detailing which objects changed and how (which could be very large).\n\n"
+    "During normal execution, this should always return None. However, if anything visible to\n"
+    "the compiler, such as a method on a class, or the identity of a module-level variable \n"
+    "changes, this function will find it. If such errors go undetected, it can cause various\n"
+    "errors, including multiple copies of the same type (since the hash is not stable) or \n"
+    "errors while computing hashes because the assumptions of the hasher are violated."
+);
+
+PyObject *checkForHashInstability(PyObject* nullValue, PyObject* args) {
+    return translateExceptionToPyObject([&]() {
+        try {
+            CompilerVisibleObjectVisitor::singleton().checkForInstability();
+
+            return incref(Py_None);
+        } catch(std::runtime_error& err) {
+            return PyUnicode_FromString(err.what());
+        }
+    });
+}
+
+PyObject *typeWalkRecord(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "typeWalkRecord takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    return translateExceptionToPyObject([&]() {
+        TypeOrPyobj obj((PyObject*)a1);
+
+        return PyUnicode_FromString(
+            ("Walk of " + obj.name() + ":\n\n" + CompilerVisibleObjectVisitor::recordWalkAsString(obj)).c_str()
+        );
+    });
+}
+
+PyObject *typesAndObjectsVisibleToCompilerFrom(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "typesAndObjectsVisibleToCompilerFrom takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    return translateExceptionToPyObject([&]() {
+        std::vector<TypeOrPyobj> visible;
+
+        MutuallyRecursiveTypeGroup::visibleFrom((PyObject*)a1, visible);
+
+        PyObjectStealer res(PyList_New(0));
+
+        for (auto& t: visible) {
+            PyList_Append(
+                res,
+                t.type() ?
+                    (PyObject*)PyInstance::typeObj(t.type())
+                :   t.pyobj()
+            );
+        }
+
+        return incref(res);
+    });
+}
+
+PyObject *recursiveTypeGroupHash(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "recursiveTypeGroupHash takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    MutuallyRecursiveTypeGroup* group = nullptr;
+
+    return translateExceptionToPyObject([&]() {
+        if (PyType_Check(a1)) {
+            Type* typeArg = PyInstance::extractTypeFrom(a1);
+            if (typeArg) {
+                group = typeArg->getRecursiveTypeGroup();
+            }
+        }
+
+        if (!group) {
+            MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
+            group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+        }
+
+        if (!group) {
+            return incref(Py_None);
+        }
+
+        return PyUnicode_FromString(group->hash().digestAsHexString().c_str());
+    });
+}
+
+PyObject *recursiveTypeGroupReprDeepFlag(PyObject* nullValue, PyObject* args, bool deep) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "recursiveTypeGroupRepr takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    MutuallyRecursiveTypeGroup* group = nullptr;
+
+    return translateExceptionToPyObject([&]() {
+        MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
+        group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+
+        if (!group) {
+            return incref(Py_None);
+        }
+
+        return PyUnicode_FromString(group->repr(deep).c_str());
+    });
+}
+
+PyObject *recursiveTypeGroupRepr(PyObject* nullValue, PyObject* args) {
+    return recursiveTypeGroupReprDeepFlag(nullValue, args, false);
+}
+
+
+PyObject *recursiveTypeGroupDeepRepr(PyObject* nullValue, PyObject* args) {
+    return recursiveTypeGroupReprDeepFlag(nullValue, args, true);
+}
+
+
+PyObject *recursiveTypeGroup(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "recursiveTypeGroup takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    MutuallyRecursiveTypeGroup* group = nullptr;
+
+    return translateExceptionToPyObject([&]() {
+        MutuallyRecursiveTypeGroup::ensureRecursiveTypeGroup((PyObject*)a1);
+        group = MutuallyRecursiveTypeGroup::groupAndIndexFor((PyObject*)a1).first;
+
+        if (!group) {
+            return incref(Py_None);
+        }
+
+        PyObjectStealer res(PyList_New(0));
+
+        for (auto ixAndType: group->getIndexToObject()) {
+            PyList_Append(
+                res,
+                ixAndType.second.type() ?
+                    (PyObject*)PyInstance::typeObj(ixAndType.second.type())
+                :   ixAndType.second.pyobj()
+            );
+        }
+
+        return incref(res);
+    });
+}
+
+PyObject *referencedTypes(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1) {
+        PyErr_SetString(PyExc_TypeError, "referencedTypes takes 1 positional argument");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+
+    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+
+    if (!t1) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'referencedTypes' must be a type object");
+        return NULL;
+    }
+
+    return translateExceptionToPyObject([&]() {
+        PyObjectStealer res(PyList_New(0));
+
+        t1->visitReferencedTypes([&](Type* refType) {
+            PyList_Append(
+                res,
+                (PyObject*)PyInstance::typeObj(refType)
+            );
+        });
+
+        return incref(res);
+    });
+}
+
+PyObject *isBinaryCompatible(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 2) {
+        PyErr_SetString(PyExc_TypeError, "isBinaryCompatible takes 2 positional arguments");
+        return NULL;
+    }
+    PyObjectHolder a1(PyTuple_GetItem(args, 0));
+    PyObjectHolder a2(PyTuple_GetItem(args, 1));
+
+    Type* t1 = PyInstance::unwrapTypeArgToTypePtr(a1);
+    Type* t2 = PyInstance::unwrapTypeArgToTypePtr(a2);
+
+    if (!t1) {
+        PyErr_SetString(PyExc_TypeError, "first argument to 'isBinaryCompatible' must be a type object");
+        return NULL;
+    }
+    if (!t2) {
+        PyErr_SetString(PyExc_TypeError, "second argument to 'isBinaryCompatible' must be a type object");
+        return NULL;
+    }
+
+    return incref(t1->isBinaryCompatibleWith(t2) ? Py_True : Py_False);
+}
+
+PyObject *MakeForward(PyObject* nullValue, PyObject* args) {
+    int num_args = PyTuple_Size(args);
+
+    PyThreadState * ts = PyThreadState_Get();
+    std::string moduleName;
+    PyObject* pyModuleName;
+
+    if (ts->frame && ts->frame->f_globals &&
+            (pyModuleName = PyDict_GetItemString(ts->frame->f_globals, "__name__"))) {
+        if (PyUnicode_Check(pyModuleName)) {
+            moduleName = PyUnicode_AsUTF8(pyModuleName);
+        }
+    }
+
+    if (num_args > 1 || !PyUnicode_Check(PyTuple_GetItem(args,0))) {
+        PyErr_SetString(PyExc_TypeError, "Forward takes a zero or one string positional arguments.");
+        return NULL;
+    }
+
+    if (num_args == 1) {
+        std::string name = PyUnicode_AsUTF8(PyTuple_GetItem(args,0));
+
+        if (moduleName.size()) {
+            name = moduleName + "." + name;
+        }
+
+        return incref((PyObject*)PyInstance::typeObj(
+            ::Forward::Make(name)
+            ));
+    } else {
+        return incref((PyObject*)PyInstance::typeObj(
+            ::Forward::Make()
+            ));
+    }
+}
+
+/*********
+calls PyCode_New and faithfully maintains the identities of tuples passed in.
+
+this has signature
+    PyCode_New(
+        int argcount,
+        int kwonlyargcount,
+        int nlocals,
+        int stacksize,
+        int flags,
+        PyObject *code,
+        PyObject *consts,
+        PyObject *names,
+        PyObject *varnames,
+        PyObject *freevars,
+        PyObject *cellvars,
+        PyObject *filename,
+        PyObject *name,
+        int firstlineno,
+        PyObject *lnotab
+    )
+
+you may also call, after 3.8, PyCode_NewWithPosOnlyArgs which has signature
+
+PyCodeObject* PyCode_NewWithPosOnlyArgs(
+    int argcount,
+    int posonlyargcount,
+    int kwonlyargcount,
+    int nlocals,
+    int stacksize,
+    int flags,
+    PyObject *code,
+    PyObject *consts,
+    PyObject *names,
+    PyObject *varnames,
+    PyObject *freevars,
+    PyObject *cellvars,
+    PyObject *filename,
     PyObject *name,
     int firstlineno,
     PyObject *lnotab
@@ -3032,238 +4422,805 @@ PyObject* buildCodeObject(PyObject* nullValue, PyObject* args, PyObject* kwargs)
         NULL
     };
 
-    static const char* operatorList = (
-        PY_MINOR_VERSION < 8 ? "iiiiiOOOOOOOOiO" : "iiiiiiOOOOOOOOiO"
+    static const char* operatorList = (
+        PY_MINOR_VERSION < 8 ? "iiiiiOOOOOOOOiO" : "iiiiiiOOOOOOOOiO"
+    );
+
+    int co_argcount;
+
+#   if PY_MINOR_VERSION >= 8
+    int co_posonlyargcount;
+#   endif
+
+    int co_kwonlyargcount;
+    int co_nlocals;
+    int co_stacksize;
+    int co_flags;
+    PyObject* co_code;
+    PyObject* co_consts;
+    PyObject* co_names;
+    PyObject* co_varnames;
+    PyObject* co_filename;
+    PyObject* co_name;
+    int co_firstlineno;
+    PyObject* co_lnotab;
+    PyObject* co_freevars;
+    PyObject* co_cellvars;
+
+    return translateExceptionToPyObject([&]() {
+        if (!PyArg_ParseTupleAndKeywords(
+            args,
+            kwargs,
+            operatorList,
+            (char**)kwlist,
+            &co_argcount,
+        #   if PY_MINOR_VERSION >= 8
+            &co_posonlyargcount,
+        #   endif
+            &co_kwonlyargcount,
+            &co_nlocals,
+            &co_stacksize,
+            &co_flags,
+            &co_code,
+            &co_consts,
+            &co_names,
+            &co_varnames,
+            &co_freevars,
+            &co_cellvars,
+            &co_filename,
+            &co_name,
+            &co_firstlineno,
+            &co_lnotab
+        ))
+        {
+            throw PythonExceptionSet();
+        }
+
+#if PY_MINOR_VERSION < 8
+        PyCodeObject* result = PyCode_New(
+#else
+        PyCodeObject* result = PyCode_NewWithPosOnlyArgs(
+#endif
+            co_argcount,
+        #   if PY_MINOR_VERSION >= 8
+            co_posonlyargcount,
+        #   endif
+            co_kwonlyargcount,
+            co_nlocals,
+            co_stacksize,
+            co_flags,
+            co_code,
+            co_consts,
+            co_names,
+            co_varnames,
+            co_freevars,
+            co_cellvars,
+            co_filename,
+            co_name,
+            co_firstlineno,
+            co_lnotab
+        );
+
+        if (!result) {
+            throw PythonExceptionSet();
+        }
+
+        return (PyObject*)result;
+    });
+}
+
+PyObject* buildPyFunctionObject(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {"code", "globals", "closure", NULL};
+
+    PyObject* pyCode;
+    PyObject* pyGlobals;
+    PyObject* pyClosure;
+
+    return translateExceptionToPyObject([&]() {
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO", (char**)kwlist, &pyCode, &pyGlobals, &pyClosure)) {
+            throw PythonExceptionSet();
+        }
+
+        if (!PyCode_Check(pyCode)) {
+            throw std::runtime_error("'code' argument to buildPyFunctionObject must be a Code object.");
+        }
+
+        if (!PyDict_Check(pyGlobals)) {
+            throw std::runtime_error("'globals' argument to buildPyFunctionObject must be a dict.");
+        }
+
+        if (!PyTuple_Check(pyClosure)) {
+            throw std::runtime_error("'closure' argument to buildPyFunctionObject must be a tuple.");
+        }
+
+        iterate(pyClosure, [&](PyObject* shouldBeCell) {
+            if (!PyCell_Check(shouldBeCell)) {
+                throw std::runtime_error("closure elements must be cells.");
+            }
+        });
+
+        PyObject* result = PyFunction_New(pyCode, pyGlobals);
+        if (!result) {
+            throw PythonExceptionSet();
+        }
+
+        if (PyFunction_SetClosure(result, pyClosure) == -1) {
+            throw PythonExceptionSet();
+        }
+
+        return result;
+    });
+}
+
+PyObject *MakeAlternativeType(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
+    if (PyTuple_Size(args) != 1 || !PyUnicode_Check(PyTuple_GetItem(args,0))) {
+        PyErr_SetString(PyExc_TypeError, "Alternative takes a single string positional argument.");
+        return NULL;
+    }
+
+    std::string name = PyUnicode_AsUTF8(PyTuple_GetItem(args,0));
+
+    std::vector<std::pair<std::string, NamedTuple*> > definitions;
+
+    std::map<std::string, Function*> functions;
+
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+
+    while (kwargs && PyDict_Next(kwargs, &pos, &key, &value)) {
+        assert(PyUnicode_Check(key));
+
+        std::string fieldName(PyUnicode_AsUTF8(key));
+
+        if (PyFunction_Check(value)) {
+            functions[fieldName] = PyFunctionInstance::convertPythonObjectToFunctionType(key, value, true, false);
+
+            if (functions[fieldName] == nullptr) {
+                //error code is already set
+                return nullptr;
+            }
+        }
+        else {
+            if (!PyDict_Check(value)) {
+                PyErr_SetString(PyExc_TypeError, "Alternative members must be initialized with dicts.");
+                return NULL;
+            }
+
+            PyObject* ntPyPtr = MakeNamedTupleType(nullptr, nullptr, value);
+            if (!ntPyPtr) {
+                return NULL;
+            }
+
+            NamedTuple* ntPtr = (NamedTuple*)PyInstance::extractTypeFrom((PyTypeObject*)ntPyPtr);
+
+            assert(ntPtr);
+
+            definitions.push_back(std::make_pair(fieldName, ntPtr));
+        }
+    };
+
+    static_assert(PY_MAJOR_VERSION >= 3, "typed_python is a python3 project only");
+
+    PyThreadState * ts = PyThreadState_Get();
+    std::string moduleName;
+    PyObject* pyModuleName;
+
+    if (ts->frame && ts->frame->f_globals &&
+            (pyModuleName = PyDict_GetItemString(ts->frame->f_globals, "__name__"))) {
+        if (PyUnicode_Check(pyModuleName)) {
+            moduleName = PyUnicode_AsUTF8(pyModuleName);
+        }
+    }
+
+    if (PY_MINOR_VERSION <= 5) {
+        //we cannot rely on the ordering of 'kwargs' here because of the python version, so
+        //we sort it. this will be a problem for anyone running some processes using different
+        //python versions that share python code.
+        std::sort(definitions.begin(), definitions.end());
+    }
+
+    return incref((PyObject*)PyInstance::typeObj(
+        ::Alternative::Make(name, moduleName, definitions, functions)
+    ));
+}
+
+PyObject *getTypePointer(PyObject* nullValue, PyObject* args) {
+    if (PyTuple_Size(args) != 1 || !PyInstance::unwrapTypeArgToTypePtr(PyTuple_GetItem(args,0))) {
+        PyErr_SetString(PyExc_TypeError, "getTypePointer takes 1 positional argument (a type)");
+        return NULL;
+    }
+
+    Type* type = PyInstance::unwrapTypeArgToTypePtr(PyTuple_GetItem(args,0));
+
+    return PyLong_FromLong((uint64_t)type);
+}
+
+PyObject* _temporaryReferenceTracerActive(PyObject* null, PyObject* args, PyObject* kwargs) {
+    return incref(
+        PyTemporaryReferenceTracer::globalTracer.frameToActions.size() ?
+        Py_True : Py_False
     );
+}
 
-    int co_argcount;
+PyDoc_STRVAR(temporaryReferenceTracerStats_doc,
+    "temporaryReferenceTracerStats() -> dict\n\n"
+    "Return counters describing how often the interpreter has had to trace temporary\n"
+    "references to HeldClass instances: 'tracedObjects' and 'keepalives' count the\n"
+    "references and keepalives registered, 'installs' the number of times the trace\n"
+    "function was installed, 'events' the number of trace events it received, and\n"
+    "'mutedFrames' the number of frames whose line events it switched off because\n"
+    "they held nothing it was tracing."
+);
 
-#   if PY_MINOR_VERSION >= 8
-    int co_posonlyargcount;
-#   endif
+PyObject* temporaryReferenceTracerStats(PyObject* null, PyObject* args, PyObject* kwargs) {
+    PyTemporaryReferenceTracer& tracer = PyTemporaryReferenceTracer::globalTracer;
 
-    int co_kwonlyargcount;
-    int co_nlocals;
-    int co_stacksize;
-    int co_flags;
-    PyObject* co_code;
-    PyObject* co_consts;
-    PyObject* co_names;
-    PyObject* co_varnames;
-    PyObject* co_filename;
-    PyObject* co_name;
-    int co_firstlineno;
-    PyObject* co_lnotab;
-    PyObject* co_freevars;
-    PyObject* co_cellvars;
+    PyObjectStealer res(PyDict_New());
 
-    return translateExceptionToPyObject([&]() {
-        if (!PyArg_ParseTupleAndKeywords(
-            args,
-            kwargs,
-            operatorList,
-            (char**)kwlist,
-            &co_argcount,
-        #   if PY_MINOR_VERSION >= 8
-            &co_posonlyargcount,
-        #   endif
-            &co_kwonlyargcount,
-            &co_nlocals,
-            &co_stacksize,
-            &co_flags,
-            &co_code,
-            &co_consts,
-            &co_names,
-            &co_varnames,
-            &co_freevars,
-            &co_cellvars,
-            &co_filename,
-            &co_name,
-            &co_firstlineno,
-            &co_lnotab
-        ))
-        {
-            throw PythonExceptionSet();
-        }
+    PyObjectStealer tracedObjects(PyLong_FromLongLong(tracer.tracedObjectCount));
+    PyObjectStealer keepalives(PyLong_FromLongLong(tracer.keepaliveCount));
+    PyObjectStealer installs(PyLong_FromLongLong(tracer.installCount));
+    PyObjectStealer events(PyLong_FromLongLong(tracer.eventCount));
+    PyObjectStealer mutedFrames(PyLong_FromLongLong(tracer.mutedFrameCount));
+
+    PyDict_SetItemString(res, "tracedObjects", tracedObjects);
+    PyDict_SetItemString(res, "keepalives", keepalives);
+    PyDict_SetItemString(res, "installs", installs);
+    PyDict_SetItemString(res, "events", events);
+    PyDict_SetItemString(res, "mutedFrames", mutedFrames);
+
+    return incref((PyObject*)res);
+}
+
+PyDoc_STRVAR(sha1Implementation_doc,
+    "sha1Implementation() -> str\n\n"
+    "Return the name of the SHA-1 compression function ShaHash is using: 'x86-sha-ni',\n"
+    "'armv8-crypto' or 'scalar'. Hardware implementations are picked automatically\n"
+    "when the CPU supports them, unless TP_SHA1_NO_HW is set in the environment."
+);
+
+PyObject* sha1Implementation(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return PyUnicode_FromString(mbedtls_sha1_implementation());
+}
+
+PyObject* setGilReleaseThreadLoopSleepMicroseconds(PyObject* null, PyObject* args, PyObject* kwargs) {
+    int64_t microseconds;
+
+    static const char *kwlist[] = {"microseconds", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", (char**)kwlist, &microseconds)) {
+        return NULL;
+    }
+
+    PyEnsureGilReleased::setGilReleaseThreadLoopSleepMicroseconds(microseconds);
+
+    return incref(Py_None);
+}
+
+PyDoc_STRVAR(pushArena_doc,
+    "pushArena(bytes) -> None\n\n"
+    "Allocate a Slab of 'bytes' and make it the current arena for this thread.\n"
+    "Until 'popArena' is called, typed_python allocations made on this thread\n"
+    "are bump-allocated out of the arena. Once it fills up, allocations go\n"
+    "back to the free store. Objects allocated in the arena keep it alive,\n"
+    "so the arena's memory is released when the last of them is destroyed.\n"
+);
+
+PyObject* pushArena(PyObject* null, PyObject* args, PyObject* kwargs) {
+    int64_t bytes;
+
+    static const char *kwlist[] = {"bytes", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", (char**)kwlist, &bytes)) {
+        return NULL;
+    }
+
+    if (bytes <= 0) {
+        PyErr_SetString(PyExc_ValueError, "pushArena requires a positive bytecount");
+        return NULL;
+    }
+
+    tp_push_arena(bytes);
+
+    return incref(Py_None);
+}
+
+PyDoc_STRVAR(popArena_doc,
+    "popArena() -> None\n\n"
+    "Stop allocating into the arena most recently pushed on this thread.\n"
+);
+
+PyObject* popArena(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    if (!tp_pop_arena()) {
+        PyErr_SetString(PyExc_RuntimeError, "popArena called with no active arena");
+        return NULL;
+    }
+
+    return incref(Py_None);
+}
+
+PyDoc_STRVAR(arenaDepth_doc,
+    "arenaDepth() -> int\n\n"
+    "Return the number of arenas currently pushed on this thread.\n"
+);
+
+PyObject* arenaDepth(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return PyLong_FromLong(tp_arena_depth());
+}
+
+PyDoc_STRVAR(allocateThreadLocalSlot_doc,
+    "allocateThreadLocalSlot(T) -> int\n\n"
+    "Register a new per-thread slot holding a default-constructed T, and return\n"
+    "its index. Slots are never released.\n"
+);
+
+PyObject* allocateThreadLocalSlot(PyObject* null, PyObject* args, PyObject* kwargs) {
+    PyObject* pyType;
+
+    static const char *kwlist[] = {"T", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &pyType)) {
+        return NULL;
+    }
+
+    Type* type = PyInstance::unwrapTypeArgToTypePtr(pyType);
+
+    if (!type) {
+        PyErr_SetString(PyExc_TypeError, "allocateThreadLocalSlot requires a Type");
+        return NULL;
+    }
+
+    if (!type->is_default_constructible()) {
+        PyErr_Format(
+            PyExc_TypeError,
+            "Can't make a thread-local %s since it's not default constructible",
+            type->name().c_str()
+        );
+        return NULL;
+    }
+
+    return PyLong_FromLong(ThreadLocalSlots::allocate(type));
+}
+
+PyDoc_STRVAR(threadLocalSlotPointer_doc,
+    "threadLocalSlotPointer(slot) -> PointerTo(T)\n\n"
+    "Return a pointer to the calling thread's T for 'slot', constructing it if\n"
+    "this thread hasn't used the slot yet. It's valid until the thread exits.\n"
+);
+
+PyObject* threadLocalSlotPointer(PyObject* null, PyObject* args, PyObject* kwargs) {
+    int64_t slot;
+
+    static const char *kwlist[] = {"slot", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", (char**)kwlist, &slot)) {
+        return NULL;
+    }
+
+    if (slot < 0 || slot >= ThreadLocalSlots::count()) {
+        PyErr_Format(PyExc_IndexError, "%lld is not a registered thread-local slot", (long long)slot);
+        return NULL;
+    }
+
+    void* data = tp_thread_local_slot(slot);
+
+    return PyInstance::extractPythonObject(
+        (instance_ptr)&data,
+        PointerTo::Make(ThreadLocalSlots::slotType(slot))
+    );
+}
+
+PyDoc_STRVAR(setHugePages_doc,
+    "setHugePages(enabled) -> None\n\n"
+    "Choose whether large allocations (big ListOf buffers, for instance) made\n"
+    "from now on ask the kernel for transparent huge pages. Off by default.\n"
+    "Only has an effect on linux.\n"
+);
+
+PyObject* setHugePages(PyObject* null, PyObject* args, PyObject* kwargs) {
+    int enabled;
+
+    static const char *kwlist[] = {"enabled", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "p", (char**)kwlist, &enabled)) {
+        return NULL;
+    }
+
+    tp_set_huge_pages(enabled);
+
+    return incref(Py_None);
+}
+
+PyDoc_STRVAR(hugePages_doc,
+    "hugePages() -> bool\n\n"
+    "Return whether large allocations ask for transparent huge pages.\n"
+);
+
+PyObject* hugePages(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return incref(tp_huge_pages() ? Py_True : Py_False);
+}
+
+PyDoc_STRVAR(setAllocationSampling_doc,
+    "setAllocationSampling(bytesBetweenSamples) -> None\n\n"
+    "Sample one typed_python allocation per 'bytesBetweenSamples' bytes allocated,\n"
+    "on average. Zero turns sampling off. Samples already taken are kept until\n"
+    "their allocations are freed. See 'liveAllocationSamples'.\n"
+);
+
+PyObject* setAllocationSampling(PyObject* null, PyObject* args, PyObject* kwargs) {
+    int64_t bytesBetweenSamples;
+
+    static const char *kwlist[] = {"bytesBetweenSamples", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", (char**)kwlist, &bytesBetweenSamples)) {
+        return NULL;
+    }
+
+    if (bytesBetweenSamples < 0) {
+        PyErr_SetString(PyExc_ValueError, "setAllocationSampling requires a non-negative bytecount");
+        return NULL;
+    }
 
-#if PY_MINOR_VERSION < 8
-        PyCodeObject* result = PyCode_New(
-#else
-        PyCodeObject* result = PyCode_NewWithPosOnlyArgs(
-#endif
-            co_argcount,
-        #   if PY_MINOR_VERSION >= 8
-            co_posonlyargcount,
-        #   endif
-            co_kwonlyargcount,
-            co_nlocals,
-            co_stacksize,
-            co_flags,
-            co_code,
-            co_consts,
-            co_names,
-            co_varnames,
-            co_freevars,
-            co_cellvars,
-            co_filename,
-            co_name,
-            co_firstlineno,
-            co_lnotab
-        );
+    tp_set_allocation_sampling(bytesBetweenSamples);
 
-        if (!result) {
-            throw PythonExceptionSet();
-        }
+    return incref(Py_None);
+}
 
-        return (PyObject*)result;
-    });
+PyDoc_STRVAR(allocationSampling_doc,
+    "allocationSampling() -> int\n\n"
+    "Return the mean number of bytes between allocation samples, or 0 if\n"
+    "we're not sampling.\n"
+);
+
+PyObject* allocationSampling(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
+
+    return PyLong_FromLongLong(tp_allocation_sampling());
 }
 
-PyObject* buildPyFunctionObject(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
-    static const char *kwlist[] = {"code", "globals", "closure", NULL};
+PyDoc_STRVAR(liveAllocationSamples_doc,
+    "liveAllocationSamples() -> [(type, bytes, estimatedBytes, site)]\n\n"
+    "Return the sampled allocations that haven't been freed yet. 'type' is the\n"
+    "typed_python Type being allocated, or None if we don't know. 'estimatedBytes'\n"
+    "is how many bytes of live allocations the sample stands for, so summing it\n"
+    "estimates the live bytes of a group of samples. 'site' is the address of the\n"
+    "code that asked for the memory, which for compiled code is inside the\n"
+    "compiled function.\n"
+);
 
-    PyObject* pyCode;
-    PyObject* pyGlobals;
-    PyObject* pyClosure;
+PyObject* liveAllocationSamples(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
 
-    return translateExceptionToPyObject([&]() {
-        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO", (char**)kwlist, &pyCode, &pyGlobals, &pyClosure)) {
-            throw PythonExceptionSet();
-        }
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
 
-        if (!PyCode_Check(pyCode)) {
-            throw std::runtime_error("'code' argument to buildPyFunctionObject must be a Code object.");
-        }
+    return translateExceptionToPyObject([&]() {
+        std::vector<TpAllocationSample> samples = tpLiveAllocationSamples();
 
-        if (!PyDict_Check(pyGlobals)) {
-            throw std::runtime_error("'globals' argument to buildPyFunctionObject must be a dict.");
-        }
+        PyObjectStealer res(PyList_New(0));
 
-        if (!PyTuple_Check(pyClosure)) {
-            throw std::runtime_error("'closure' argument to buildPyFunctionObject must be a tuple.");
-        }
+        for (auto& sample: samples) {
+            PyObjectStealer tup(
+                Py_BuildValue(
+                    "(OndK)",
+                    sample.type ? (PyObject*)PyInstance::typeObj(sample.type) : Py_None,
+                    (Py_ssize_t)sample.bytes,
+                    sample.estimatedBytes,
+                    (unsigned long long)sample.site
+                )
+            );
 
-        iterate(pyClosure, [&](PyObject* shouldBeCell) {
-            if (!PyCell_Check(shouldBeCell)) {
-                throw std::runtime_error("closure elements must be cells.");
+            if (!tup) {
+                throw PythonExceptionSet();
             }
-        });
-
-        PyObject* result = PyFunction_New(pyCode, pyGlobals);
-        if (!result) {
-            throw PythonExceptionSet();
-        }
 
-        if (PyFunction_SetClosure(result, pyClosure) == -1) {
-            throw PythonExceptionSet();
+            PyList_Append(res, tup);
         }
 
-        return result;
+        return incref((PyObject*)res);
     });
 }
 
-PyObject *MakeAlternativeType(PyObject* nullValue, PyObject* args, PyObject* kwargs) {
-    if (PyTuple_Size(args) != 1 || !PyUnicode_Check(PyTuple_GetItem(args,0))) {
-        PyErr_SetString(PyExc_TypeError, "Alternative takes a single string positional argument.");
+PyDoc_STRVAR(typeLiveCountersEnabled_doc,
+    "typeLiveCountersEnabled() -> bool\n\n"
+    "Return True if this process counts the live instances of each ListOf,\n"
+    "TupleOf, Dict and Set type. That's decided by TP_TYPE_LIVE_COUNTERS=1 in\n"
+    "the environment when typed_python is imported, and can't change afterwards.\n"
+);
+
+PyObject* typeLiveCountersEnabled(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
         return NULL;
     }
 
-    std::string name = PyUnicode_AsUTF8(PyTuple_GetItem(args,0));
+    return incref(type_live_counters_enabled ? Py_True : Py_False);
+}
 
-    std::vector<std::pair<std::string, NamedTuple*> > definitions;
+PyDoc_STRVAR(typeLiveCounters_doc,
+    "typeLiveCounters() -> [(type, instances, bytes)]\n\n"
+    "Return the number of live instances of each counted type, and the bytes\n"
+    "they hold directly (not counting what their elements point to). Types\n"
+    "appear once we've seen an instance of them. See 'typeLiveCountersEnabled'.\n"
+);
 
-    std::map<std::string, Function*> functions;
+PyObject* typeLiveCounters(PyObject* null, PyObject* args, PyObject* kwargs) {
+    static const char *kwlist[] = {NULL};
 
-    PyObject *key, *value;
-    Py_ssize_t pos = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", (char**)kwlist)) {
+        return NULL;
+    }
 
-    while (kwargs && PyDict_Next(kwargs, &pos, &key, &value)) {
-        assert(PyUnicode_Check(key));
+    return translateExceptionToPyObject([&]() {
+        PyObjectStealer res(PyList_New(0));
 
-        std::string fieldName(PyUnicode_AsUTF8(key));
+        for (Type* t: typeLiveCountersTypes()) {
+            TypeLiveCounters* counters = t->liveCounters();
 
-        if (PyFunction_Check(value)) {
-            functions[fieldName] = PyFunctionInstance::convertPythonObjectToFunctionType(key, value, true, false);
+            PyObjectStealer tup(
+                Py_BuildValue(
+                    "(OLL)",
+                    (PyObject*)PyInstance::typeObj(t),
+                    (long long)counters->instances(),
+                    (long long)counters->bytes()
+                )
+            );
 
-            if (functions[fieldName] == nullptr) {
-                //error code is already set
-                return nullptr;
+            if (!tup) {
+                throw PythonExceptionSet();
             }
+
+            PyList_Append(res, tup);
         }
-        else {
-            if (!PyDict_Check(value)) {
-                PyErr_SetString(PyExc_TypeError, "Alternative members must be initialized with dicts.");
-                return NULL;
-            }
 
-            PyObject* ntPyPtr = MakeNamedTupleType(nullptr, nullptr, value);
-            if (!ntPyPtr) {
-                return NULL;
-            }
+        return incref((PyObject*)res);
+    });
+}
 
-            NamedTuple* ntPtr = (NamedTuple*)PyInstance::extractTypeFrom((PyTypeObject*)ntPyPtr);
+PyDoc_STRVAR(bufferAddress_doc,
+    "bufferAddress(obj) -> (address, size)\n\n"
+    "Return the address and size of the contiguous buffer that 'obj' exports\n"
+    "through the buffer protocol. The address is only valid for as long as\n"
+    "something holds the export open, so callers should pass a memoryview\n"
+    "and keep it alive while they use the address.\n"
+);
 
-            assert(ntPtr);
+PyObject* bufferAddress(PyObject* null, PyObject* args, PyObject* kwargs) {
+    PyObject* obj;
 
-            definitions.push_back(std::make_pair(fieldName, ntPtr));
-        }
-    };
+    static const char *kwlist[] = {"obj", NULL};
 
-    static_assert(PY_MAJOR_VERSION >= 3, "typed_python is a python3 project only");
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &obj)) {
+        return NULL;
+    }
 
-    PyThreadState * ts = PyThreadState_Get();
-    std::string moduleName;
-    PyObject* pyModuleName;
+    Py_buffer view;
 
-    if (ts->frame && ts->frame->f_globals &&
-            (pyModuleName = PyDict_GetItemString(ts->frame->f_globals, "__name__"))) {
-        if (PyUnicode_Check(pyModuleName)) {
-            moduleName = PyUnicode_AsUTF8(pyModuleName);
-        }
+    if (PyObject_GetBuffer(obj, &view, PyBUF_SIMPLE) == -1) {
+        return NULL;
     }
 
-    if (PY_MINOR_VERSION <= 5) {
-        //we cannot rely on the ordering of 'kwargs' here because of the python version, so
-        //we sort it. this will be a problem for anyone running some processes using different
-        //python versions that share python code.
-        std::sort(definitions.begin(), definitions.end());
-    }
+    PyObject* res = Py_BuildValue("(KL)", (unsigned long long)view.buf, (long long)view.len);
 
-    return incref((PyObject*)PyInstance::typeObj(
-        ::Alternative::Make(name, moduleName, definitions, functions)
-    ));
+    PyBuffer_Release(&view);
+
+    return res;
 }
 
-PyObject *getTypePointer(PyObject* nullValue, PyObject* args) {
-    if (PyTuple_Size(args) != 1 || !PyInstance::unwrapTypeArgToTypePtr(PyTuple_GetItem(args,0))) {
-        PyErr_SetString(PyExc_TypeError, "getTypePointer takes 1 positional argument (a type)");
+// parse (address, size, sub, start=0, end=size) and run 'op' over the buffer
+template<class op_type>
+PyObject* bufferSearch(PyObject* args, PyObject* kwargs, const op_type& op) {
+    unsigned long long address;
+    long long size;
+    PyObject* sub;
+    long long start = 0;
+    long long end = std::numeric_limits<long long>::max();
+
+    static const char *kwlist[] = {"address", "size", "sub", "start", "end", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "KLO|LL", (char**)kwlist, &address, &size, &sub, &start, &end)) {
         return NULL;
     }
 
-    Type* type = PyInstance::unwrapTypeArgToTypePtr(PyTuple_GetItem(args,0));
+    if (!PyBytes_Check(sub)) {
+        PyErr_SetString(PyExc_TypeError, "'sub' must be a bytes object");
+        return NULL;
+    }
 
-    return PyLong_FromLong((uint64_t)type);
-}
+    Instance subInst = Instance::createAndInitialize(BytesType::Make(), [&](instance_ptr p) {
+        *(BytesType::layout**)p = BytesType::createFromPtr(PyBytes_AsString(sub), PyBytes_GET_SIZE(sub));
+    });
 
-PyObject* _temporaryReferenceTracerActive(PyObject* null, PyObject* args, PyObject* kwargs) {
-    return incref(
-        PyTemporaryReferenceTracer::globalTracer.frameToActions.size() ?
-        Py_True : Py_False
+    return PyLong_FromLongLong(
+        op((const uint8_t*)address, size, *(BytesType::layout**)subInst.data(), start, end)
     );
 }
 
-PyObject* setGilReleaseThreadLoopSleepMicroseconds(PyObject* null, PyObject* args, PyObject* kwargs) {
-    int64_t microseconds;
+PyDoc_STRVAR(bufferFind_doc,
+    "bufferFind(address, size, sub, start=0, end=size) -> int\n\n"
+    "Like bytes.find, but over 'size' bytes of memory at 'address', such as\n"
+    "a buffer located with 'bufferAddress'.\n"
+);
 
-    static const char *kwlist[] = {"microseconds", NULL};
+PyObject* bufferFind(PyObject* null, PyObject* args, PyObject* kwargs) {
+    return bufferSearch(args, kwargs, [](const uint8_t* data, int64_t len, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::find(data, len, sub, start, end);
+    });
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", (char**)kwlist, &microseconds)) {
+PyDoc_STRVAR(bufferRFind_doc,
+    "bufferRFind(address, size, sub, start=0, end=size) -> int\n\n"
+    "Like bytes.rfind, over memory at 'address'. See 'bufferFind'.\n"
+);
+
+PyObject* bufferRFind(PyObject* null, PyObject* args, PyObject* kwargs) {
+    return bufferSearch(args, kwargs, [](const uint8_t* data, int64_t len, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::rfind(data, len, sub, start, end);
+    });
+}
+
+PyDoc_STRVAR(bufferCount_doc,
+    "bufferCount(address, size, sub, start=0, end=size) -> int\n\n"
+    "Like bytes.count, over memory at 'address'. See 'bufferFind'.\n"
+);
+
+PyObject* bufferCount(PyObject* null, PyObject* args, PyObject* kwargs) {
+    return bufferSearch(args, kwargs, [](const uint8_t* data, int64_t len, BytesType::layout* sub, int64_t start, int64_t end) {
+        return BytesType::count(data, len, sub, start, end);
+    });
+}
+
+PyDoc_STRVAR(deserializeBuffer_doc,
+    "deserializeBuffer(T, address, size, serializationContext=None) -> T\n\n"
+    "Like 'deserialize', but reads the serialized data directly out of 'size'\n"
+    "bytes at 'address' rather than out of a bytes object.\n"
+);
+
+PyObject* deserializeBuffer(PyObject* null, PyObject* args, PyObject* kwargs) {
+    PyObject* pyType;
+    unsigned long long address;
+    long long size;
+    PyObject* pyContext = Py_None;
+
+    static const char *kwlist[] = {"T", "address", "size", "serializationContext", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OKL|O", (char**)kwlist, &pyType, &address, &size, &pyContext)) {
         return NULL;
     }
 
-    PyEnsureGilReleased::setGilReleaseThreadLoopSleepMicroseconds(microseconds);
+    Type* serializeType = PyInstance::unwrapTypeArgToTypePtr(pyType);
 
-    return incref(Py_None);
+    if (!serializeType) {
+        PyErr_SetString(PyExc_TypeError, "first argument to deserializeBuffer must be a type object");
+        return NULL;
+    }
+
+    std::shared_ptr<SerializationContext> context(new NullSerializationContext());
+    if (pyContext != Py_None) {
+        context.reset(new PythonSerializationContext(pyContext));
+    }
+
+    return translateExceptionToPyObject([&]() {
+        DeserializationBuffer buf((uint8_t*)address, size, *context);
+
+        serializeType->assertForwardsResolved();
+
+        Instance i = Instance::createAndInitialize(serializeType, [&](instance_ptr p) {
+            PyEnsureGilReleased releaseTheGil;
+            auto fieldAndWireType = buf.readFieldNumberAndWireType();
+            serializeType->deserialize(p, buf, fieldAndWireType.second);
+        });
+
+        return PyInstance::extractPythonObject(i.data(), i.type());
+    });
+}
+
+// parse a ListOf(str) (or anything convertible to one) into a ListOf of 'eltType' with 'parse',
+// which is StringType::to_int64_column or StringType::to_float64_column
+template<class elt_type, class parse_type>
+PyObject* parseStringColumn(PyObject* args, PyObject* kwargs, Type* eltType, const char* errorFormat, const parse_type& parse) {
+    PyObject* pyStrings;
+
+    static const char *kwlist[] = {"strings", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char**)kwlist, &pyStrings)) {
+        return NULL;
+    }
+
+    static ListOfType* listOfStrT = ListOfType::Make(StringType::Make());
+    ListOfType* outT = ListOfType::Make(eltType);
+
+    return translateExceptionToPyObject([&]() {
+        Instance strings = Instance::createAndInitialize(listOfStrT, [&](instance_ptr p) {
+            PyInstance::copyConstructFromPythonInstance(listOfStrT, p, pyStrings, ConversionLevel::ImplicitContainers);
+        });
+
+        ListOfType::layout* stringsLayout = *(ListOfType::layout**)strings.data();
+        int64_t count = stringsLayout->count;
+
+        Instance out = Instance::createAndInitialize(outT, [&](instance_ptr p) {
+            outT->constructor(p);
+            outT->reserve(p, count);
+        });
+
+        int64_t bad;
+        {
+            PyEnsureGilReleased releaseTheGil;
+
+            bad = parse(
+                (StringType::layout**)stringsLayout->data,
+                count,
+                (elt_type*)(*(ListOfType::layout**)out.data())->data
+            );
+        }
+
+        if (bad >= 0) {
+            PyErr_Format(
+                PyExc_ValueError,
+                errorFormat,
+                StringType::Make()->toUtf8String(stringsLayout->data + bad * sizeof(StringType::layout*)).c_str()
+            );
+            throw PythonExceptionSet();
+        }
+
+        outT->setSizeUnsafe(out.data(), count);
+
+        return PyInstance::extractPythonObject(out.data(), outT);
+    });
+}
+
+PyDoc_STRVAR(parseInt64Column_doc,
+    "parseInt64Column(strings) -> ListOf(int)\n\n"
+    "Parse every string in 'strings' the way int() would, in a single call that\n"
+    "releases the GIL. Raises ValueError on the first string that isn't an integer.\n"
+);
+
+PyObject* parseInt64Column(PyObject* null, PyObject* args, PyObject* kwargs) {
+    return parseStringColumn<int64_t>(
+        args, kwargs, Int64::Make(), "invalid literal for int() with base 10: '%s'", StringType::to_int64_column
+    );
+}
+
+PyDoc_STRVAR(parseFloat64Column_doc,
+    "parseFloat64Column(strings) -> ListOf(float)\n\n"
+    "Parse every string in 'strings' the way float() would, in a single call that\n"
+    "releases the GIL. Raises ValueError on the first string that isn't a float.\n"
+);
+
+PyObject* parseFloat64Column(PyObject* null, PyObject* args, PyObject* kwargs) {
+    return parseStringColumn<double>(
+        args, kwargs, Float64::Make(), "could not convert string to float: '%s'", StringType::to_float64_column
+    );
 }
 
 PyObject* gilReleaseThreadLoop(PyObject* null, PyObject* args, PyObject* kwargs) {
@@ -3277,15 +5234,39 @@ PyObject* gilReleaseThreadLoop(PyObject* null, PyObject* args, PyObject* kwargs)
 static PyMethodDef module_methods[] = {
     {"canConvertToTrivially", (PyCFunction)canConvertToTrivially, METH_VARARGS, canConvertToTrivially_doc},
     {"TypeFor", (PyCFunction)MakeTypeFor, METH_VARARGS, NULL},
-    {"deepBytecount", (PyCFunction)deepBytecount, METH_VARARGS, deepBytecount_doc},
-    {"deepBytecountAndSlabs", (PyCFunction)deepBytecountAndSlabs, METH_VARARGS, deepBytecountAndSlabs_doc},
+    {"deepBytecount", (PyCFunction)deepBytecount, METH_VARARGS | METH_KEYWORDS, deepBytecount_doc},
+    {"freeze", (PyCFunction)freeze, METH_VARARGS | METH_KEYWORDS, freeze_doc},
+    {"deepBytecountAndSlabs", (PyCFunction)deepBytecountAndSlabs, METH_VARARGS | METH_KEYWORDS, deepBytecountAndSlabs_doc},
+    {"clearDeepBytecountCache", (PyCFunction)clearDeepBytecountCache, METH_VARARGS | METH_KEYWORDS,
+        clearDeepBytecountCache_doc},
     {"getAllSlabs", (PyCFunction)getAllSlabs, METH_VARARGS, getAllSlabs_doc},
     {"totalBytesAllocatedOnFreeStore", (PyCFunction)totalBytesAllocatedOnFreeStore, METH_VARARGS, totalBytesAllocatedOnFreeStore_doc},
     {"totalBytesAllocatedInSlabs", (PyCFunction)totalBytesAllocatedInSlabs, METH_VARARGS, totalBytesAllocatedInSlabs_doc},
+    {"stringInternTableSize", (PyCFunction)stringInternTableSize, METH_VARARGS, stringInternTableSize_doc},
+    {"clearStringInternTable", (PyCFunction)clearStringInternTable, METH_VARARGS, clearStringInternTable_doc},
     {"deepcopy", (PyCFunction)deepcopy, METH_VARARGS | METH_KEYWORDS, deepcopy_doc},
     {"deepcopyContiguous", (PyCFunction)deepcopyContiguous, METH_VARARGS | METH_KEYWORDS, deepcopyContiguous_doc},
     {"serialize", (PyCFunction)serialize, METH_VARARGS, NULL},
+    {"serializeInto", (PyCFunction)serializeInto, METH_VARARGS, serializeInto_doc},
     {"deserialize", (PyCFunction)deserialize, METH_VARARGS, NULL},
+    {"deserializeUntrusted", (PyCFunction)deserializeUntrusted, METH_VARARGS | METH_KEYWORDS, deserializeUntrusted_doc},
+    {"jsonEncode", (PyCFunction)jsonEncode, METH_VARARGS, jsonEncode_doc},
+    {"jsonDecode", (PyCFunction)jsonDecode, METH_VARARGS, jsonDecode_doc},
+    {"readCsvColumns", (PyCFunction)readCsvColumns, METH_VARARGS | METH_KEYWORDS, readCsvColumns_doc},
+    {"configureCompiledPrint", (PyCFunction)configureCompiledPrint, METH_VARARGS | METH_KEYWORDS,
+        configureCompiledPrint_doc},
+    {"flushCompiledPrint", (PyCFunction)flushCompiledPrint, METH_NOARGS, flushCompiledPrint_doc},
+    {"compiledPrintRingBufferContents", (PyCFunction)compiledPrintRingBufferContents, METH_NOARGS,
+        compiledPrintRingBufferContents_doc},
+    {"regexCompile", (PyCFunction)regexCompile, METH_VARARGS | METH_KEYWORDS, regexCompile_doc},
+    {"regexSearch", (PyCFunction)regexSearch, METH_VARARGS | METH_KEYWORDS, regexSearch_doc},
+    {"makeUfunc", (PyCFunction)makeUfunc, METH_VARARGS | METH_KEYWORDS, makeUfunc_doc},
+    {"fileRead", (PyCFunction)fileRead, METH_VARARGS | METH_KEYWORDS, fileRead_doc},
+    {"fileWrite", (PyCFunction)fileWrite, METH_VARARGS | METH_KEYWORDS, fileWrite_doc},
+    {"serializeToFile", (PyCFunction)serializeToFile, METH_VARARGS | METH_KEYWORDS, serializeToFile_doc},
+    {"serializeDelta", (PyCFunction)serializeDelta, METH_VARARGS | METH_KEYWORDS, serializeDelta_doc},
+    {"deserializeDelta", (PyCFunction)deserializeDelta, METH_VARARGS | METH_KEYWORDS, deserializeDelta_doc},
+    {"deserializeInto", (PyCFunction)deserializeInto, METH_VARARGS | METH_KEYWORDS, deserializeInto_doc},
     {"decodeSerializedObject", (PyCFunction)decodeSerializedObject, METH_VARARGS, NULL},
     {"validateSerializedObject", (PyCFunction)validateSerializedObject, METH_VARARGS, NULL},
     {"validateSerializedObjectStream", (PyCFunction)validateSerializedObjectStream, METH_VARARGS, NULL},
@@ -3313,11 +5294,18 @@ static PyMethodDef module_methods[] = {
     {"referencedTypes", (PyCFunction)referencedTypes, METH_VARARGS, NULL},
     {"wantsToDefaultConstruct", (PyCFunction)wantsToDefaultConstruct, METH_VARARGS, NULL},
     {"all_alternatives_empty", (PyCFunction)all_alternatives_empty, METH_VARARGS, NULL},
+    {"alternative_is_inline", (PyCFunction)alternative_is_inline, METH_VARARGS, NULL},
+    {"oneof_null_niche_index", (PyCFunction)oneof_null_niche_index, METH_VARARGS, NULL},
     {"installNativeFunctionPointer", (PyCFunction)installNativeFunctionPointer, METH_VARARGS, NULL},
     {"touchCompiledSpecializations", (PyCFunction)touchCompiledSpecializations, METH_VARARGS, NULL},
+    {"materializeFunctionOverloads", (PyCFunction)materializeFunctionOverloads, METH_VARARGS, NULL},
+    {"entrypointDispatchCacheStats", (PyCFunction)entrypointDispatchCacheStats, METH_VARARGS | METH_KEYWORDS,
+        entrypointDispatchCacheStats_doc},
     {"disableNativeDispatch", (PyCFunction)disableNativeDispatch, METH_VARARGS, NULL},
     {"enableNativeDispatch", (PyCFunction)enableNativeDispatch, METH_VARARGS, NULL},
     {"isDispatchEnabled", (PyCFunction)isDispatchEnabled, METH_VARARGS, NULL},
+    {"refcountsAreThreadConfined", (PyCFunction)refcountsAreThreadConfined, METH_VARARGS, NULL},
+    {"immortalRefcount", (PyCFunction)immortalRefcount, METH_VARARGS, NULL},
     {"refcount", (PyCFunction)refcount, METH_VARARGS, NULL},
     {"getOrSetTypeResolver", (PyCFunction)getOrSetTypeResolver, METH_VARARGS, NULL},
     {"pointerTo", (PyCFunction)pointerTo, METH_VARARGS, NULL},
@@ -3349,9 +5337,32 @@ static PyMethodDef module_methods[] = {
     {"isValidArithmeticUpcast", (PyCFunction)isValidArithmeticUpcast, METH_VARARGS | METH_KEYWORDS, NULL},
     {"isValidArithmeticConversion", (PyCFunction)isValidArithmeticConversion, METH_VARARGS | METH_KEYWORDS, NULL},
     {"_temporaryReferenceTracerActive", (PyCFunction)_temporaryReferenceTracerActive, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"temporaryReferenceTracerStats", (PyCFunction)temporaryReferenceTracerStats, METH_VARARGS | METH_KEYWORDS,
+        temporaryReferenceTracerStats_doc},
+    {"sha1Implementation", (PyCFunction)sha1Implementation, METH_VARARGS | METH_KEYWORDS, sha1Implementation_doc},
     {"gilReleaseThreadLoop", (PyCFunction)gilReleaseThreadLoop, METH_VARARGS | METH_KEYWORDS, NULL},
     {"setGilReleaseThreadLoopSleepMicroseconds", (PyCFunction)setGilReleaseThreadLoopSleepMicroseconds, METH_VARARGS | METH_KEYWORDS, NULL},
     {"setModuleDict", (PyCFunction)setModuleDict, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"pushArena", (PyCFunction)pushArena, METH_VARARGS | METH_KEYWORDS, pushArena_doc},
+    {"popArena", (PyCFunction)popArena, METH_VARARGS | METH_KEYWORDS, popArena_doc},
+    {"arenaDepth", (PyCFunction)arenaDepth, METH_VARARGS | METH_KEYWORDS, arenaDepth_doc},
+    {"allocateThreadLocalSlot", (PyCFunction)allocateThreadLocalSlot, METH_VARARGS | METH_KEYWORDS, allocateThreadLocalSlot_doc},
+    {"threadLocalSlotPointer", (PyCFunction)threadLocalSlotPointer, METH_VARARGS | METH_KEYWORDS, threadLocalSlotPointer_doc},
+    {"setHugePages", (PyCFunction)setHugePages, METH_VARARGS | METH_KEYWORDS, setHugePages_doc},
+    {"hugePages", (PyCFunction)hugePages, METH_VARARGS | METH_KEYWORDS, hugePages_doc},
+    {"setAllocationSampling", (PyCFunction)setAllocationSampling, METH_VARARGS | METH_KEYWORDS, setAllocationSampling_doc},
+    {"allocationSampling", (PyCFunction)allocationSampling, METH_VARARGS | METH_KEYWORDS, allocationSampling_doc},
+    {"liveAllocationSamples", (PyCFunction)liveAllocationSamples, METH_VARARGS | METH_KEYWORDS, liveAllocationSamples_doc},
+    {"typeLiveCountersEnabled", (PyCFunction)typeLiveCountersEnabled, METH_VARARGS | METH_KEYWORDS,
+        typeLiveCountersEnabled_doc},
+    {"typeLiveCounters", (PyCFunction)typeLiveCounters, METH_VARARGS | METH_KEYWORDS, typeLiveCounters_doc},
+    {"bufferAddress", (PyCFunction)bufferAddress, METH_VARARGS | METH_KEYWORDS, bufferAddress_doc},
+    {"bufferFind", (PyCFunction)bufferFind, METH_VARARGS | METH_KEYWORDS, bufferFind_doc},
+    {"bufferRFind", (PyCFunction)bufferRFind, METH_VARARGS | METH_KEYWORDS, bufferRFind_doc},
+    {"bufferCount", (PyCFunction)bufferCount, METH_VARARGS | METH_KEYWORDS, bufferCount_doc},
+    {"deserializeBuffer", (PyCFunction)deserializeBuffer, METH_VARARGS | METH_KEYWORDS, deserializeBuffer_doc},
+    {"parseInt64Column", (PyCFunction)parseInt64Column, METH_VARARGS | METH_KEYWORDS, parseInt64Column_doc},
+    {"parseFloat64Column", (PyCFunction)parseFloat64Column, METH_VARARGS | METH_KEYWORDS, parseFloat64Column_doc},
     {NULL, NULL}
 };
 
@@ -3377,13 +5388,21 @@ void updateTypeRepForType(Type* type, PyTypeObject* pyType) {
 PyMODINIT_FUNC
 PyInit__types(void)
 {
-    // initialize unicode property table, for StringType
-    initialize_uprops();
+    // this has to be decided before we create any refcounted objects, and
+    // can't change afterwards. See Refcount.hpp.
+    const char* threadConfinedRefcounts = getenv("TP_THREAD_CONFINED_REFCOUNTS");
+    refcounts_are_thread_confined = threadConfinedRefcounts && std::string(threadConfinedRefcounts) == "1";
+
+    // likewise, we have to count every instance from the start, or we'd see
+    // instances destroyed that we never saw created. See TypeLiveCounters.hpp.
+    const char* typeLiveCounters = getenv("TP_TYPE_LIVE_COUNTERS");
+    type_live_counters_enabled = typeLiveCounters && std::string(typeLiveCounters) == "1";
 
     //initialize numpy. This is only OK because all the .cpp files get
     //glommed together in a single file. If we were to change that behavior,
     //then additional steps must be taken as per the API documentation.
     import_array();
+    import_umath();
 
     PyObject *module = PyModule_Create(&moduledef);
 
@@ -3434,8 +5453,23 @@ PyInit__types(void)
         return NULL;
     }
 
+    if (PyType_Ready(&PyType_StreamingDeserializer) < 0) {
+        return NULL;
+    }
+
+    if (PyType_Ready(&PyType_TypeSchemaCache) < 0) {
+        return NULL;
+    }
+
+    if (PyType_Ready(&PyType_SerializationNameCache) < 0) {
+        return NULL;
+    }
+
     PyModule_AddObject(module, "Slab", (PyObject*)incref(&PyType_Slab));
     PyModule_AddObject(module, "ModuleRepresentation", (PyObject*)incref(&PyType_ModuleRepresentation));
+    PyModule_AddObject(module, "StreamingDeserializer", (PyObject*)incref(&PyType_StreamingDeserializer));
+    PyModule_AddObject(module, "TypeSchemaCache", (PyObject*)incref(&PyType_TypeSchemaCache));
+    PyModule_AddObject(module, "SerializationNameCache", (PyObject*)incref(&PyType_SerializationNameCache));
 
     return module;
 }
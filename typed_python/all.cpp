@@ -48,6 +48,16 @@ compile the entire group all at once.
 #include "BytesType.cpp"
 #include "ClassType.cpp"
 #include "CompositeType.cpp"
+#include "ColumnarSerialization.cpp"
+#include "ArrowInterop.cpp"
+#include "JsonCodec.cpp"
+#include "CsvReader.cpp"
+#include "OutputSink.cpp"
+#include "Regex.cpp"
+#include "NumpyUfunc.cpp"
+#include "FileIO.cpp"
+#include "DeltaSerialization.cpp"
+#include "InPlaceDeserialization.cpp"
 #include "ConcreteAlternativeType.cpp"
 #include "DictType.cpp"
 #include "ConstDictType.cpp"
@@ -72,8 +82,15 @@ compile the entire group all at once.
 #include "Memory.cpp"
 #include "PySlab.cpp"
 #include "PyModuleRepresentation.cpp"
+#include "PyStreamingDeserializer.cpp"
+#include "PyTypeSchemaCache.cpp"
+#include "PySerializationNameCache.cpp"
 #include "Slab.cpp"
+#include "DeepBytecountContext.cpp"
+#include "TypeLiveCounters.cpp"
 #include "PyTemporaryReferenceTracer.cpp"
+#include "NativeException.cpp"
+#include "ThreadLocalSlots.cpp"
 
 #include "lz4.c"
 #include "lz4frame.c"
@@ -0,0 +1,235 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Ahead-of-time compilation of a set of entrypoints into a deployable artifact.
+
+    python -m typed_python.aot build OUTDIR --entrypoint 'mypkg.pricing.price(ListOf(Trade), float)'
+
+compiles each entrypoint for exactly the argument types given, links everything
+that produced into a single shared object, and writes it to OUTDIR along with a
+manifest, 'aot_manifest.json', describing what's in it. OUTDIR is laid out as
+a compiler cache, so a process started with TP_COMPILER_CACHE=OUTDIR, running
+the same code, loads those entrypoints from it instead of compiling them.
+
+The argument types are python expressions, evaluated with everything from
+typed_python and the entrypoint's module in scope.
+
+We compile in a fresh process whose compiler cache is a staging directory, and
+then copy only the modules that define symbols into OUTDIR, so the artifact
+doesn't carry the parts 'compact' linked together. Modules built with
+cpu-specific variants (see TP_COMPILER_MULTIVERSION) can't be relinked, so they
+get copied as they are.
+"""
+
+import importlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import typed_python
+from typed_python import _types
+
+MANIFEST_FILE = "aot_manifest.json"
+
+# bump this whenever the layout of an artifact changes
+FORMAT_VERSION = 1
+
+
+def parseEntrypoint(spec):
+    """Resolve an entrypoint like 'pkg.mod.f(int, float)' to (funcObj, argTypes).
+
+    The function may be any attribute path inside the module, like 'pkg.mod.C.f'.
+    We import the longest prefix of the dotted name that is a module.
+    """
+    if "(" not in spec or not spec.endswith(")"):
+        raise ValueError(f"Entrypoint {spec!r} should look like 'module.function(argType, ...)'")
+
+    path, argText = spec[:-1].split("(", 1)
+    parts = path.strip().split(".")
+
+    for i in range(len(parts) - 1, 0, -1):
+        try:
+            module = importlib.import_module(".".join(parts[:i]))
+        except ImportError:
+            continue
+
+        obj = module
+
+        for attr in parts[i:]:
+            obj = getattr(obj, attr)
+
+        namespace = dict(vars(typed_python))
+        namespace.update(vars(module))
+
+        argTypes = eval("(" + argText + ",)", namespace) if argText.strip() else ()
+
+        if not isinstance(obj, _types.Function):
+            raise TypeError(f"{path} is not an Entrypoint or a typed_python Function")
+
+        return obj, list(argTypes)
+
+    raise ImportError(f"Can't find a module to import for entrypoint {spec!r}")
+
+
+def build(outputDir, entrypoints, searchPath=None, version=None):
+    """Compile 'entrypoints' into an artifact in 'outputDir' and return its manifest.
+
+    Args:
+        outputDir - where to write the artifact. It shouldn't exist yet.
+        entrypoints - a list of strings like 'pkg.mod.f(int, float)'
+        searchPath - None, or a list of directories to put on the compiling
+            process's sys.path.
+        version - a string to record in the manifest as the artifact's version.
+    """
+    if os.path.exists(outputDir):
+        raise ValueError(f"{outputDir} already exists")
+
+    with tempfile.TemporaryDirectory() as stagingDir:
+        env = dict(os.environ)
+        env["TP_COMPILER_CACHE"] = stagingDir
+        env.pop("TP_COMPILER_PGO", None)
+
+        if searchPath:
+            env["PYTHONPATH"] = os.pathsep.join(
+                list(searchPath) + ([env["PYTHONPATH"]] if env.get("PYTHONPATH") else [])
+            )
+
+        subprocess.check_call(
+            [sys.executable, "-m", "typed_python.aot", "compile", outputDir]
+            + (["--version", version] if version is not None else [])
+            + [arg for spec in entrypoints for arg in ("--entrypoint", spec)],
+            env=env
+        )
+
+    return readManifest(outputDir)
+
+
+def compileIntoArtifact(outputDir, entrypoints, version=None):
+    """Compile 'entrypoints' in this process and write the artifact to 'outputDir'.
+
+    This process's compiler cache has to be empty, since we ship all of it.
+    'build' runs this in a fresh process for us.
+    """
+    from typed_python.compiler.runtime import Runtime
+    from typed_python.compiler.compiler_cache_index import CompilerCacheIndex
+    from typed_python.compiler.type_group_hash_cache import TYPE_GROUP_DIR
+    from typed_python.compiler.class_dispatch_cache import CLASS_DISPATCH_DIR
+
+    runtime = Runtime.singleton()
+    cache = runtime.compilerCache
+
+    if cache is None:
+        raise Exception("Ahead-of-time compilation needs TP_COMPILER_CACHE to point at a staging directory")
+
+    t0 = time.time()
+
+    for spec in entrypoints:
+        funcObj, argTypes = parseEntrypoint(spec)
+        runtime.compiledEntrypointAddress(funcObj, argTypes)
+
+    compileTime = time.time() - t0
+
+    cache.compact(singleModule=True)
+
+    # the modules that now define each symbol, and everything they need loaded first
+    moduleHashes = set()
+    for moduleHash, linkNames in cache.scanNameManifests():
+        for name in linkNames:
+            moduleHashes.add(cache.index.lookup(name))
+
+    moduleHashes.discard(None)
+
+    toCheck = list(moduleHashes)
+    while toCheck:
+        moduleHash = toCheck.pop()
+
+        if not cache.readModuleManifests(moduleHash):
+            raise Exception(f"Compiler cache module {moduleHash} is invalid")
+
+        for subHash in cache.moduleManifests[moduleHash][3]:
+            if subHash not in moduleHashes:
+                moduleHashes.add(subHash)
+                toCheck.append(subHash)
+
+    # a cache for a particular target cpu lives in a subdirectory, and so does the artifact
+    targetDir = os.path.join(
+        outputDir, os.path.relpath(cache.cacheDir, os.path.abspath(os.getenv("TP_COMPILER_CACHE")))
+    )
+
+    os.makedirs(targetDir)
+
+    for moduleHash in sorted(moduleHashes):
+        shutil.copytree(os.path.join(cache.cacheDir, moduleHash), os.path.join(targetDir, moduleHash))
+
+    for subdir in (TYPE_GROUP_DIR, CLASS_DISPATCH_DIR):
+        if os.path.exists(os.path.join(cache.cacheDir, subdir)):
+            shutil.copytree(os.path.join(cache.cacheDir, subdir), os.path.join(targetDir, subdir))
+
+    CompilerCacheIndex(targetDir).build(
+        (moduleHash, linkNames)
+        for moduleHash, linkNames in cache.scanNameManifests()
+        if moduleHash in moduleHashes
+    )
+
+    manifest = dict(
+        formatVersion=FORMAT_VERSION,
+        version=version,
+        typedPythonVersion=typed_python.__version__,
+        pythonVersion="%s.%s" % sys.version_info[:2],
+        platform=sys.platform,
+        targetSubdirectory=os.path.relpath(targetDir, outputDir),
+        modules=sorted(moduleHashes),
+        entrypoints=list(entrypoints),
+        compileSeconds=compileTime,
+        created=time.time()
+    )
+
+    with open(os.path.join(outputDir, MANIFEST_FILE), "w") as f:
+        json.dump(manifest, f, indent=2)
+
+    return manifest
+
+
+def readManifest(artifactDir):
+    """Return the manifest of the artifact in 'artifactDir'."""
+    with open(os.path.join(artifactDir, MANIFEST_FILE), "r") as f:
+        return json.load(f)
+
+
+def compatibilityProblems(artifactDir):
+    """Return a list of the reasons this process can't use the artifact in 'artifactDir'.
+
+    An artifact only works with the typed_python and python it was built with.
+    """
+    manifest = readManifest(artifactDir)
+    problems = []
+
+    if manifest.get("formatVersion") != FORMAT_VERSION:
+        problems.append(f"it has format version {manifest.get('formatVersion')}, not {FORMAT_VERSION}")
+
+    if manifest["typedPythonVersion"] != typed_python.__version__:
+        problems.append(f"it was built with typed_python {manifest['typedPythonVersion']}, not {typed_python.__version__}")
+
+    if manifest["pythonVersion"] != "%s.%s" % sys.version_info[:2]:
+        problems.append(f"it was built for python {manifest['pythonVersion']}")
+
+    if manifest["platform"] != sys.platform:
+        problems.append(f"it was built for {manifest['platform']}")
+
+    return problems
@@ -0,0 +1,65 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import argparse
+import json
+import sys
+
+from typed_python.aot import build, compileIntoArtifact, readManifest, compatibilityProblems
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Compile typed_python entrypoints ahead of time.")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    buildParser = commands.add_parser("build", help="compile entrypoints into an artifact directory")
+    buildParser.add_argument("output", help="the directory to write the artifact to")
+    buildParser.add_argument("--entrypoint", action="append", default=[], required=True,
+                             help="an entrypoint and its argument types, like 'pkg.mod.f(int, float)'")
+    buildParser.add_argument("--path", action="append", default=[],
+                             help="a directory to import the entrypoints' modules from")
+    buildParser.add_argument("--version", help="a version string to record in the manifest")
+
+    # what 'build' runs in a fresh process with TP_COMPILER_CACHE set to a staging directory
+    compileParser = commands.add_parser("compile")
+    compileParser.add_argument("output")
+    compileParser.add_argument("--entrypoint", action="append", default=[])
+    compileParser.add_argument("--version")
+
+    infoParser = commands.add_parser("info", help="describe an artifact, and whether this process could use it")
+    infoParser.add_argument("artifact")
+
+    args = parser.parse_args(argv[1:])
+
+    if args.command == "build":
+        manifest = build(args.output, args.entrypoint, args.path, args.version)
+        print(f"compiled {len(manifest['entrypoints'])} entrypoint(s) into {len(manifest['modules'])} module(s)")
+    elif args.command == "compile":
+        compileIntoArtifact(args.output, args.entrypoint, args.version)
+    else:
+        print(json.dumps(readManifest(args.artifact), indent=2))
+
+        problems = compatibilityProblems(args.artifact)
+
+        for problem in problems:
+            print("can't use this artifact: " + problem)
+
+        if problems:
+            return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,74 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+
+import pytest
+
+from typed_python.aot import build, compatibilityProblems, parseEntrypoint
+from typed_python.test_util import evaluateExprInFreshProcess, instantiateFiles
+
+XMODULE = "\n".join([
+    "from typed_python import Entrypoint, ListOf",
+    "def square(x):",
+    "    return x * x",
+    "@Entrypoint",
+    "def sumOfSquares(xs):",
+    "    res = 0.0",
+    "    for x in xs:",
+    "        res += square(x)",
+    "    return res",
+    "@Entrypoint",
+    "def addOne(x):",
+    "    return x + 1",
+])
+
+VERSION = {'x.py': XMODULE}
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_build_artifact_and_run_from_it(tmp_path):
+    sourceDir = str(tmp_path / "src")
+    artifactDir = str(tmp_path / "artifact")
+
+    os.makedirs(sourceDir)
+    instantiateFiles(VERSION, sourceDir)
+
+    manifest = build(
+        artifactDir,
+        ["x.sumOfSquares(ListOf(float))", "x.addOne(int)"],
+        searchPath=[sourceDir],
+        version="1.2.3"
+    )
+
+    assert manifest['version'] == "1.2.3"
+    assert len(manifest['modules']) == 1
+    assert compatibilityProblems(artifactDir) == []
+
+    conversions = "len(typed_python.compiler.runtime.Runtime.singleton().converter._times_calculated)"
+
+    # a process using the artifact doesn't convert anything
+    assert evaluateExprInFreshProcess(
+        VERSION, f'(x.sumOfSquares(ListOf(float)([1, 2, 3])), x.addOne(10), {conversions})', artifactDir
+    ) == (14.0, 11, 0)
+
+
+def test_parse_entrypoint():
+    funcObj, argTypes = parseEntrypoint("typed_python.lib.sorting.sorted(ListOf(int))")
+
+    assert funcObj.__name__ == "sorted"
+    assert [str(T) for T in argTypes] == ["ListOf(int)"]
+
+    with pytest.raises(ValueError):
+        parseEntrypoint("typed_python.lib.sorting.sorted")
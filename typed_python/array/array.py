@@ -19,16 +19,542 @@ from typed_python import (
     Entrypoint
 )
 
-from typed_python.array.fortran import axpy, gemv, gemm, getri, getrf
+from typed_python.array.fortran import (
+    axpy, gemv, gemm, getri, getrf, gesv, potrf, potrs, gels, syev, hasBlas
+)
+from typed_python.lib.pmap import ensureThreads
+from typed_python.lib.simd import Float64x4, Float32x8
 
 
 def min(a, b):
     return a if a < b else b
 
 
+# elementwise operations on Arrays with at least this many elements run on the
+# pmap thread pool. A ListOf, so compiled code sees changes to it.
+_parallelThreshold = ListOf(int)([1 << 20])
+
+_CACHE_LINE_BYTES = 64
+
+
+def getParallelThreshold():
+    return _parallelThreshold[0]
+
+
+def setParallelThreshold(count):
+    """Set the smallest Array whose elementwise operations we split across threads."""
+    assert count >= 0
+    _parallelThreshold[0] = count
+
+
+def _elementwise(count, p, stride, runRange):
+    """Call 'runRange(lo, hi)' to cover [0, count), across the pmap pool if 'count' is big.
+
+    'p' points at element 0 of the output and 'stride' is its step. Every chunk but
+    the last covers a whole number of cache lines of the output, and when the output is
+    contiguous they start on a line, so no two threads write to the same one.
+    """
+    if count < _parallelThreshold[0]:
+        runRange(0, count)
+        return
+
+    pool = ensureThreads()
+
+    elementBytes = int(p + 1) - int(p)
+    stepBytes = max(1, elementBytes * (stride if stride > 0 else -stride))
+    lineSteps = max(1, _CACHE_LINE_BYTES // stepBytes)
+
+    # the first chunk runs up to the first element that starts a line
+    head = 0
+    if stride == 1:
+        head = (_CACHE_LINE_BYTES - int(p) % _CACHE_LINE_BYTES) % _CACHE_LINE_BYTES // elementBytes
+
+    chunk = max(lineSteps, count // (pool.threadCount * 8))
+    chunk = (chunk + lineSteps - 1) // lineSteps * lineSteps
+    chunkCount = max(1, (count - head + chunk - 1) // chunk)
+
+    def runChunk(chunkIx):
+        lo = 0 if chunkIx == 0 else head + chunkIx * chunk
+        runRange(lo, min(count, head + (chunkIx + 1) * chunk))
+
+    pool.parallel_for(chunkCount, runChunk, 1)
+
+
+# edge length of the tiles the compiled matmul works through. Three 64x64 float
+# tiles fit comfortably in L2.
+_MATMUL_BLOCK = 64
+
+
+class _BlasKernels(Class, Final):
+    """Matrix products for float and Float32, handed off to BLAS.
+
+    BLAS is column-major. We describe each operand with 'Matrix._blasLayout', so
+    row-major matrices and transposed views both go in without a copy.
+    """
+    @staticmethod
+    def matmul(a, b, result):
+        aTrans, lda = a._blasLayout()
+        if not lda:
+            a = a.clone()
+            aTrans, lda = a._blasLayout()
+
+        bTrans, ldb = b._blasLayout()
+        if not ldb:
+            b = b.clone()
+            bTrans, ldb = b._blasLayout()
+
+        # 'result' is row-major, so BLAS sees its transpose, which is b^T @ a^T
+        gemm(
+            bTrans,
+            aTrans,
+            b._shape[1],
+            a._shape[0],
+            a._shape[1],
+            1.0,
+            b._vals.pointerUnsafe(b._offset),
+            ldb,
+            a._vals.pointerUnsafe(a._offset),
+            lda,
+            0.0,
+            result._vals.pointerUnsafe(result._offset),
+            result._stride[0],
+        )
+
+    @staticmethod
+    def addInto(dest, src):
+        axpy(dest._shape, 1.0, src._vals.pointerUnsafe(src._offset), src._stride, dest._vals.pointerUnsafe(dest._offset), dest._stride)
+
+    @staticmethod
+    def matvec(m, x, result, transposed):
+        """result = m @ x, or x @ m if 'transposed'."""
+        trans, ld = m._blasLayout()
+        if not ld:
+            m = m.clone()
+            trans, ld = m._blasLayout()
+
+        # if trans is 'N', the buffer BLAS sees is m^T, which it has to transpose
+        # back to compute m @ x.
+        if trans == 'N':
+            bufferRows, bufferCols = m._shape[1], m._shape[0]
+            trans = 'N' if transposed else 'T'
+        else:
+            bufferRows, bufferCols = m._shape[0], m._shape[1]
+            trans = 'T' if transposed else 'N'
+
+        gemv(
+            trans,
+            bufferRows,
+            bufferCols,
+            1.0,
+            m._vals.pointerUnsafe(m._offset),
+            ld,
+            x._vals.pointerUnsafe(x._offset),
+            x._stride,
+            0.0,
+            result.pointerUnsafe(0),
+            1
+        )
+
+
+class _BlockedKernels(Class, Final):
+    """Matrix products as compiled loops, for when we have no BLAS or T isn't a float.
+
+    The innermost loops always walk the output and one operand with a stride of 1,
+    which is the form LLVM knows how to vectorize.
+    """
+    @staticmethod
+    def matmul(a, b, result):
+        if b._stride[1] != 1:
+            b = b.clone()
+
+        rows = a._shape[0]
+        inner = a._shape[1]
+        cols = b._shape[1]
+
+        aRowStride = a._stride[0]
+        aColStride = a._stride[1]
+        bRowStride = b._stride[0]
+        resultRowStride = result._stride[0]
+
+        pA = a._vals.pointerUnsafe(a._offset)
+        pB = b._vals.pointerUnsafe(b._offset)
+        pResult = result._vals.pointerUnsafe(result._offset)
+
+        for i0 in range(0, rows, _MATMUL_BLOCK):
+            i1 = min(i0 + _MATMUL_BLOCK, rows)
+
+            for k0 in range(0, inner, _MATMUL_BLOCK):
+                k1 = min(k0 + _MATMUL_BLOCK, inner)
+
+                for j0 in range(0, cols, _MATMUL_BLOCK):
+                    j1 = min(j0 + _MATMUL_BLOCK, cols)
+
+                    for i in range(i0, i1):
+                        pResultRow = pResult + i * resultRowStride
+                        pARow = pA + i * aRowStride
+
+                        for k in range(k0, k1):
+                            aik = (pARow + k * aColStride).get()
+                            pBRow = pB + k * bRowStride
+
+                            for j in range(j0, j1):
+                                (pResultRow + j).set((pResultRow + j).get() + aik * (pBRow + j).get())
+
+    @staticmethod
+    def addInto(dest, src):
+        dest._inplaceBinop(src, lambda a, b: a + b)
+
+    @staticmethod
+    def matvec(m, x, result, transposed):
+        """result = m @ x, or x @ m if 'transposed'. 'result' must start out zeroed."""
+        if m._stride[1] != 1:
+            m = m.clone()
+
+        pX = x._vals.pointerUnsafe(x._offset)
+        pResult = result.pointerUnsafe(0)
+        pRow = m._vals.pointerUnsafe(m._offset)
+
+        if transposed:
+            # accumulate x[i] times each row into the result
+            for i in range(m._shape[0]):
+                xi = (pX + i * x._stride).get()
+
+                for j in range(m._shape[1]):
+                    (pResult + j).set((pResult + j).get() + xi * (pRow + j).get())
+
+                pRow += m._stride[0]
+        else:
+            # dot each row with x
+            for i in range(m._shape[0]):
+                total = pRow.get() * pX.get()
+
+                for j in range(1, m._shape[1]):
+                    total += (pRow + j).get() * (pX + j * x._stride).get()
+
+                (pResult + i).set(total)
+                pRow += m._stride[0]
+
+
+# reductions split their input into chunks of at least this many elements, and into at
+# most this many chunks. The chunking depends only on the element count, so a reduction
+# gives the same answer whether or not it runs in parallel.
+_REDUCE_MIN_CHUNK = 4096
+_REDUCE_MAX_CHUNKS = 256
+
+
+def _reduceChunkSize(count):
+    return max(_REDUCE_MIN_CHUNK, (count + _REDUCE_MAX_CHUNKS - 1) // _REDUCE_MAX_CHUNKS)
+
+
+def _reduceChunks(count, T, reduceRange):
+    """Return the ListOf(T) of 'reduceRange(lo, hi)' over each chunk of [0, count), in order.
+
+    The chunks run on the pmap pool if 'count' is big.
+    """
+    chunk = _reduceChunkSize(count)
+    chunkCount = (count + chunk - 1) // chunk
+
+    partials = ListOf(T)()
+    partials.resize(chunkCount)
+    pPartials = partials.pointerUnsafe(0)
+
+    def runChunk(chunkIx):
+        (pPartials + chunkIx).set(reduceRange(chunkIx * chunk, min(count, (chunkIx + 1) * chunk)))
+
+    if count < _parallelThreshold[0]:
+        for chunkIx in range(chunkCount):
+            runChunk(chunkIx)
+    else:
+        ensureThreads().parallel_for(chunkCount, runChunk, 1)
+
+    return partials
+
+
+def _neumaierAdd(total, compensation, x):
+    """Add 'x' to 'total', collecting the low-order bits the add loses in 'compensation'."""
+    t = total + x
+
+    if abs(total) >= abs(x):
+        compensation += (total - t) + x
+    else:
+        compensation += (x - t) + total
+
+    return t, compensation
+
+
+def _neumaierSum(values, zero):
+    total = zero
+    compensation = zero
+
+    for x in values:
+        total, compensation = _neumaierAdd(total, compensation, x)
+
+    return total + compensation
+
+
+@TypeFunction
+def _ScalarReductions(T):
+    """Reductions over the elements [lo, hi) of a strided run of T, as plain compiled loops.
+
+    Sums keep four independent accumulators so consecutive adds don't wait on each
+    other. For integers LLVM vectorizes these loops itself, since integer addition
+    is associative.
+    """
+    class _ScalarReductions_(Class, Final):
+        @staticmethod
+        def sum(p, stride, lo, hi) -> T:
+            acc0 = T()
+            acc1 = T()
+            acc2 = T()
+            acc3 = T()
+
+            i = lo
+            while i + 4 <= hi:
+                acc0 += (p + i * stride).get()
+                acc1 += (p + (i + 1) * stride).get()
+                acc2 += (p + (i + 2) * stride).get()
+                acc3 += (p + (i + 3) * stride).get()
+                i += 4
+
+            res = (acc0 + acc1) + (acc2 + acc3)
+            while i < hi:
+                res += (p + i * stride).get()
+                i += 1
+
+            return res
+
+        @staticmethod
+        def compensatedSum(p, stride, lo, hi) -> T:
+            total = T()
+            compensation = T()
+
+            for i in range(lo, hi):
+                total, compensation = _neumaierAdd(total, compensation, (p + i * stride).get())
+
+            return total + compensation
+
+        @staticmethod
+        def sumSquaredDeviations(p, stride, lo, hi, mean: float) -> float:
+            res = 0.0
+
+            for i in range(lo, hi):
+                d = float((p + i * stride).get()) - mean
+                res += d * d
+
+            return res
+
+        @staticmethod
+        def minimum(p, stride, lo, hi) -> T:
+            res = (p + lo * stride).get()
+
+            for i in range(lo + 1, hi):
+                x = (p + i * stride).get()
+                if x < res:
+                    res = x
+
+            return res
+
+        @staticmethod
+        def maximum(p, stride, lo, hi) -> T:
+            res = (p + lo * stride).get()
+
+            for i in range(lo + 1, hi):
+                x = (p + i * stride).get()
+                if x > res:
+                    res = x
+
+            return res
+
+        @staticmethod
+        def find(p, stride, lo, hi, value: T) -> int:
+            """The first i in [lo, hi) whose element equals 'value', or -1."""
+            for i in range(lo, hi):
+                if (p + i * stride).get() == value:
+                    return i
+
+            return -1
+
+        @staticmethod
+        def dot(p, stride, q, qStride, lo, hi) -> T:
+            acc0 = T()
+            acc1 = T()
+            acc2 = T()
+            acc3 = T()
+
+            i = lo
+            while i + 4 <= hi:
+                acc0 += (p + i * stride).get() * (q + i * qStride).get()
+                acc1 += (p + (i + 1) * stride).get() * (q + (i + 1) * qStride).get()
+                acc2 += (p + (i + 2) * stride).get() * (q + (i + 2) * qStride).get()
+                acc3 += (p + (i + 3) * stride).get() * (q + (i + 3) * qStride).get()
+                i += 4
+
+            res = (acc0 + acc1) + (acc2 + acc3)
+            while i < hi:
+                res += (p + i * stride).get() * (q + i * qStride).get()
+                i += 1
+
+            return res
+
+    return _ScalarReductions_
+
+
+@TypeFunction
+def _SimdReductions(T, V):
+    """The reductions of '_ScalarReductions(T)', on lanes of the simd vector V when the data is contiguous.
+
+    LLVM won't vectorize a floating point sum on its own, since that reorders the
+    adds. We do it explicitly, with two vector accumulators in flight.
+    """
+    lanes = len(V.ElementTypes)
+    scalar = _ScalarReductions(T)
+
+    class _SimdReductions_(Class, Final):
+        @staticmethod
+        def sum(p, stride, lo, hi) -> T:
+            if stride != 1:
+                return scalar.sum(p, stride, lo, hi)
+
+            acc0 = V.splat(0.0)
+            acc1 = V.splat(0.0)
+
+            i = lo
+            while i + 2 * lanes <= hi:
+                acc0 += V.load(p + i)
+                acc1 += V.load(p + (i + lanes))
+                i += 2 * lanes
+
+            res = (acc0 + acc1).sum()
+            while i < hi:
+                res += (p + i).get()
+                i += 1
+
+            return res
+
+        @staticmethod
+        def compensatedSum(p, stride, lo, hi) -> T:
+            if stride != 1:
+                return scalar.compensatedSum(p, stride, lo, hi)
+
+            # Kahan summation in each lane
+            total = V.splat(0.0)
+            compensation = V.splat(0.0)
+
+            i = lo
+            while i + lanes <= hi:
+                y = V.load(p + i) - compensation
+                t = total + y
+                compensation = (t - total) - y
+                total = t
+                i += lanes
+
+            laneTotals = ListOf(T)()
+            laneTotals.resize(lanes)
+            (total - compensation).store(laneTotals)
+
+            res = T()
+            resCompensation = T()
+            for x in laneTotals:
+                res, resCompensation = _neumaierAdd(res, resCompensation, x)
+
+            while i < hi:
+                res, resCompensation = _neumaierAdd(res, resCompensation, (p + i).get())
+                i += 1
+
+            return res + resCompensation
+
+        @staticmethod
+        def sumSquaredDeviations(p, stride, lo, hi, mean: float) -> float:
+            if stride != 1:
+                return scalar.sumSquaredDeviations(p, stride, lo, hi, mean)
+
+            m = V.splat(mean)
+            acc0 = V.splat(0.0)
+            acc1 = V.splat(0.0)
+
+            i = lo
+            while i + 2 * lanes <= hi:
+                d0 = V.load(p + i) - m
+                d1 = V.load(p + (i + lanes)) - m
+                acc0 += d0 * d0
+                acc1 += d1 * d1
+                i += 2 * lanes
+
+            return float((acc0 + acc1).sum()) + scalar.sumSquaredDeviations(p, 1, i, hi, mean)
+
+        @staticmethod
+        def minimum(p, stride, lo, hi) -> T:
+            if stride != 1 or hi - lo < lanes:
+                return scalar.minimum(p, stride, lo, hi)
+
+            acc = V.load(p + lo)
+
+            i = lo + lanes
+            while i + lanes <= hi:
+                acc = acc.min(V.load(p + i))
+                i += lanes
+
+            res = acc.reduceMin()
+            if i < hi:
+                tail = scalar.minimum(p, 1, i, hi)
+                if tail < res:
+                    res = tail
+
+            return res
+
+        @staticmethod
+        def maximum(p, stride, lo, hi) -> T:
+            if stride != 1 or hi - lo < lanes:
+                return scalar.maximum(p, stride, lo, hi)
+
+            acc = V.load(p + lo)
+
+            i = lo + lanes
+            while i + lanes <= hi:
+                acc = acc.max(V.load(p + i))
+                i += lanes
+
+            res = acc.reduceMax()
+            if i < hi:
+                tail = scalar.maximum(p, 1, i, hi)
+                if tail > res:
+                    res = tail
+
+            return res
+
+        @staticmethod
+        def find(p, stride, lo, hi, value: T) -> int:
+            return scalar.find(p, stride, lo, hi, value)
+
+        @staticmethod
+        def dot(p, stride, q, qStride, lo, hi) -> T:
+            if stride != 1 or qStride != 1:
+                return scalar.dot(p, stride, q, qStride, lo, hi)
+
+            acc0 = V.splat(0.0)
+            acc1 = V.splat(0.0)
+
+            i = lo
+            while i + 2 * lanes <= hi:
+                acc0 += V.load(p + i) * V.load(q + i)
+                acc1 += V.load(p + (i + lanes)) * V.load(q + (i + lanes))
+                i += 2 * lanes
+
+            return (acc0 + acc1).sum() + scalar.dot(p, 1, q, 1, i, hi)
+
+    return _SimdReductions_
+
+
+# the simd vector type we reduce Arrays of each float type with
+_SIMD_VECTORS = {float: Float64x4, Float32: Float32x8}
+
+
 @TypeFunction
 def Array(T):
     """Implements a simple, strongly typed array."""
+    kernels = _BlasKernels if hasBlas and T in (float, Float32) else _BlockedKernels
+    reductions = _SimdReductions(T, _SIMD_VECTORS[T]) if T in _SIMD_VECTORS else _ScalarReductions(T)
+
     class Array_(Class, Final):
         _vals = Member(ListOf(T))
         _offset = Member(int)
@@ -80,10 +606,8 @@ def Array(T):
         def __iadd__(self, other):
             self._inplaceBinopCheck(other)
 
-            if (T is float or T is Float32) and isinstance(other, Array(T)):
-                p = self._vals.pointerUnsafe(self._offset)
-                p2 = other._vals.pointerUnsafe(other._offset)
-                axpy(self._shape, 1.0, p2, self._stride, p, other._stride)
+            if isinstance(other, Array(T)) and self._shape < _parallelThreshold[0]:
+                kernels.addInto(self, other)
             else:
                 self._inplaceBinop(other, lambda a, b: a + b)
 
@@ -171,27 +695,19 @@ def Array(T):
         def __pos__(self):
             return self.clone()
 
+        def lazy(self):
+            """An expression for this array that builds up a LazyExpression instead of computing.
+
+            '(a.lazy() * b + c).log().eval()' computes the result in a single loop.
+            """
+            return LazyExpression(_Load, Array(T), None)(left=self, shape=self._shape)
+
         # operators
         #########################################
 
         @Entrypoint
         def __matmul__(self, other: Array(T)) -> T:  # noqa
-            if other.shape != self.shape:
-                raise Exception(f"Mismatched array sizes: {self.shape} != {other.shape}")
-
-            res = T()
-
-            ownStride = self._stride
-            otherStride = other._stride
-            ownP = self._vals.pointerUnsafe(self._offset)
-            otherP = other._vals.pointerUnsafe(other._offset)
-
-            for i in range(self._shape):
-                res += ownP.get() * otherP.get()
-                ownP += ownStride
-                otherP += otherStride
-
-            return res
+            return self.dot(other)
 
         def __matmul__(self, other: Matrix(T)) -> Array(T):  # noqa
             return other.__rmatmul__(self)
@@ -209,29 +725,41 @@ def Array(T):
         def _inplaceBinop(self, other: Array(T), binaryFunc):
             p = self._vals.pointerUnsafe(self._offset)
             p2 = other._vals.pointerUnsafe(other._offset)
+            stride = self._stride
+            stride2 = other._stride
 
-            for i in range(self._shape):
-                (p + i * self._stride).set(binaryFunc(
-                    (p + i * self._stride).get(),
-                    (p2 + i * other._stride).get()
-                ))
+            def runRange(lo, hi):
+                for i in range(lo, hi):
+                    (p + i * stride).set(binaryFunc(
+                        (p + i * stride).get(),
+                        (p2 + i * stride2).get()
+                    ))
+
+            _elementwise(self._shape, p, stride, runRange)
 
             return self
 
         @Entrypoint
         def _inplaceUnaryOp(self, f):
             p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
 
-            for i in range(self._shape):
-                p.set(f(p.get()))
-                p += self._stride
+            def runRange(lo, hi):
+                for i in range(lo, hi):
+                    (p + i * stride).set(f((p + i * stride).get()))
+
+            _elementwise(self._shape, p, stride, runRange)
 
         @Entrypoint  # noqa
         def _inplaceBinop(self, other: T, binaryFunc):  # noqa
             p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
 
-            for i in range(self._shape):
-                (p + i * self._stride).set(binaryFunc((p + i * self._stride).get(), other))
+            def runRange(lo, hi):
+                for i in range(lo, hi):
+                    (p + i * stride).set(binaryFunc((p + i * stride).get(), other))
+
+            _elementwise(self._shape, p, stride, runRange)
 
             return self
 
@@ -264,15 +792,168 @@ def Array(T):
             res.resize(count, value)
             return Array(T)(res)
 
+        # reductions
+        #########################################
+
         @Entrypoint
-        def sum(self):
+        def sum(self, compensated=False) -> T:
+            """The sum of the elements.
+
+            If 'compensated', carry the rounding error of each add along (Kahan-Neumaier
+            summation). That's slower, but the result no longer drifts with the length
+            of the Array.
+            """
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+
+            if compensated:
+                return _neumaierSum(
+                    _reduceChunks(self._shape, T, lambda lo, hi: reductions.compensatedSum(p, stride, lo, hi)),
+                    T()
+                )
+
             res = T()
+            for partial in _reduceChunks(self._shape, T, lambda lo, hi: reductions.sum(p, stride, lo, hi)):
+                res += partial
 
-            pRead = self._vals.pointerUnsafe(self._offset)
+            return res
 
-            for i in range(self._shape):
-                res += pRead.get()
-                pRead += self._stride
+        @Entrypoint
+        def mean(self) -> float:
+            if self._shape == 0:
+                raise ValueError("mean of an empty Array")
+
+            return float(self.sum()) / self._shape
+
+        @Entrypoint
+        def var(self, ddof=0) -> float:
+            """The variance of the elements, dividing by len - 'ddof'. Computed in two passes."""
+            if self._shape - ddof <= 0:
+                raise ValueError("var needs more elements than 'ddof'")
+
+            mean = self.mean()
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+
+            res = 0.0
+            for partial in _reduceChunks(
+                self._shape, float, lambda lo, hi: reductions.sumSquaredDeviations(p, stride, lo, hi, mean)
+            ):
+                res += partial
+
+            return res / (self._shape - ddof)
+
+        @Entrypoint
+        def min(self) -> T:
+            if self._shape == 0:
+                raise ValueError("min of an empty Array")
+
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+
+            partials = _reduceChunks(self._shape, T, lambda lo, hi: reductions.minimum(p, stride, lo, hi))
+
+            res = partials[0]
+            for partial in partials:
+                if partial < res:
+                    res = partial
+
+            return res
+
+        @Entrypoint
+        def max(self) -> T:
+            if self._shape == 0:
+                raise ValueError("max of an empty Array")
+
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+
+            partials = _reduceChunks(self._shape, T, lambda lo, hi: reductions.maximum(p, stride, lo, hi))
+
+            res = partials[0]
+            for partial in partials:
+                if partial > res:
+                    res = partial
+
+            return res
+
+        @Entrypoint
+        def argmin(self) -> int:
+            """The index of the first smallest element."""
+            return self._indexOf(self.min())
+
+        @Entrypoint
+        def argmax(self) -> int:
+            """The index of the first largest element."""
+            return self._indexOf(self.max())
+
+        @Entrypoint
+        def _indexOf(self, value: T) -> int:
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+
+            for ix in _reduceChunks(self._shape, int, lambda lo, hi: reductions.find(p, stride, lo, hi, value)):
+                if ix >= 0:
+                    return ix
+
+            return -1
+
+        @Entrypoint
+        def cumsum(self) -> Array(T):
+            """The running sums of the elements.
+
+            Big Arrays are scanned in parallel, with each chunk starting from the total
+            of the chunks before it, so float results can differ from a serial scan in
+            the last few bits.
+            """
+            count = self._shape
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+
+            newVals = ListOf(T)()
+            newVals.resize(count)
+            pWrite = newVals.pointerUnsafe(0)
+
+            def scanRange(lo, hi, start):
+                total = start
+                for i in range(lo, hi):
+                    total += (p + i * stride).get()
+                    (pWrite + i).set(total)
+
+            if count < _parallelThreshold[0]:
+                scanRange(0, count, T())
+            else:
+                starts = _reduceChunks(count, T, lambda lo, hi: reductions.sum(p, stride, lo, hi))
+
+                total = T()
+                for i in range(len(starts)):
+                    chunkTotal = starts[i]
+                    starts[i] = total
+                    total += chunkTotal
+
+                chunk = _reduceChunkSize(count)
+                pStarts = starts.pointerUnsafe(0)
+
+                def runChunk(chunkIx):
+                    scanRange(chunkIx * chunk, min(count, (chunkIx + 1) * chunk), (pStarts + chunkIx).get())
+
+                ensureThreads().parallel_for(len(starts), runChunk, 1)
+
+            return Array(T)(newVals, 0, 1, count)
+
+        @Entrypoint
+        def dot(self, other: Array(T)) -> T:
+            if other._shape != self._shape:
+                raise Exception(f"Mismatched array sizes: {self._shape} != {other._shape}")
+
+            p = self._vals.pointerUnsafe(self._offset)
+            stride = self._stride
+            q = other._vals.pointerUnsafe(other._offset)
+            qStride = other._stride
+
+            res = T()
+            for partial in _reduceChunks(self._shape, T, lambda lo, hi: reductions.dot(p, stride, q, qStride, lo, hi)):
+                res += partial
 
             return res
 
@@ -318,8 +999,46 @@ def Array(T):
     return Array_
 
 
+def _solveBatch(As, bs, solveOne):
+    """Return the ListOf 'solveOne(As[i], bs[i])' for each i.
+
+    Every problem in the batch has to be the same shape. They run on the pmap pool
+    if, by a rough count of the floating point work, there's enough of them.
+    """
+    if len(As) != len(bs):
+        raise Exception(f"Batch size mismatch: {len(As)} != {len(bs)}")
+
+    results = ListOf(type(As).ElementType)()
+    results.resize(len(As))
+
+    if not len(As):
+        return results
+
+    for i in range(len(As)):
+        if As[i]._shape != As[0]._shape or bs[i]._shape != bs[0]._shape:
+            raise Exception("Every problem in a batch needs the same shape")
+
+    n = max(As[0]._shape[0], As[0]._shape[1])
+    work = len(As) * n * n * (n + bs[0]._shape[1])
+
+    pResults = results.pointerUnsafe(0)
+
+    def solveAt(i):
+        (pResults + i).set(solveOne(As[i], bs[i]))
+
+    if work < _parallelThreshold[0]:
+        for i in range(len(As)):
+            solveAt(i)
+    else:
+        ensureThreads().parallel_for(len(As), solveAt)
+
+    return results
+
+
 @TypeFunction
 def Matrix(T):
+    kernels = _BlasKernels if hasBlas and T in (float, Float32) else _BlockedKernels
+
     class Matrix_(Class, Final):
         _vals = Member(ListOf(T))
 
@@ -658,30 +1377,32 @@ def Matrix(T):
         def set(self, i, j, value):
             self._vals[i * self._stride[0] + j * self._stride[1] + self._offset] = value
 
+        def _blasLayout(self) -> Tuple(str, int):
+            """Describe our storage the way BLAS, which is column-major, wants it.
+
+            Returns ('N', ld) if we're row-major, in which case BLAS sees our
+            transpose with leading dimension 'ld', or ('T', ld) if we're column-major
+            (say, a transposed view), in which case BLAS sees us. Returns ('N', 0) if
+            we're neither and need a copy first.
+            """
+            if self._stride[1] == 1 and self._stride[0] >= max(1, self._shape[1]):
+                return ('N', self._stride[0])
+
+            if self._stride[0] == 1 and self._stride[1] >= max(1, self._shape[0]):
+                return ('T', self._stride[1])
+
+            return ('N', 0)
+
         def __matmul__(self, other: Matrix(T)):
             if self._shape[1] != other._shape[0]:
                 raise Exception("Size mismatch")
 
-            self = self.getCanonicalForm()
-            other = other.getCanonicalForm()
-
-            result = Matrix(T).zeros(self._shape[0], other._shape[1])
-
-            gemm(
-                'N',
-                'N',
-                other._shape[1],
-                self._shape[0],
-                self._shape[1],
-                1.0,
-                other._vals.pointerUnsafe(other._offset),
-                other._stride[0],
-                self._vals.pointerUnsafe(self._offset),
-                self._stride[0],
-                0.0,
-                result._vals.pointerUnsafe(result._offset),
-                result._stride[0],
-            )
+            result = Matrix(T).full(self._shape[0], other._shape[1], T())
+
+            if self._shape[0] == 0 or self._shape[1] == 0 or other._shape[1] == 0:
+                return result
+
+            kernels.matmul(self, other, result)
 
             return result
 
@@ -746,54 +1467,227 @@ def Matrix(T):
 
             return selfT.transpose()
 
-        def __matmul__(self, other: Array(T)):  # noqa
-            # ensures that this is a simply-strided (row-major) matrix
-            self = self.getCanonicalForm()
+        ##################################################################
+        # Linear algebra, through LAPACK
+        #
+        # LAPACK is column-major. 'transpose().toList()' copies a matrix out in
+        # that layout, and '_fromColumnMajor' wraps such a copy back up.
+
+        @staticmethod
+        def _fromColumnMajor(vals: ListOf(T), rows: int, columns: int, ld: int) -> Matrix(T):
+            return Matrix(T)(vals, 0, Tuple(int, int)((1, ld)), Tuple(int, int)((rows, columns)))
+
+        @staticmethod
+        def _column(x: Array(T)) -> Matrix(T):
+            return Matrix(T)(x.toList(), 0, Tuple(int, int)((1, 1)), Tuple(int, int)((len(x), 1)))
+
+        def _checkSystem(self, b: Matrix(T)):
+            if self._shape[0] != self._shape[1]:
+                raise Exception("Can't solve a system with a non-square matrix")
+
+            if b._shape[0] != self._shape[0]:
+                raise Exception(f"Size mismatch: {self._shape[0]} != {b._shape[0]}")
+
+        def solve(self, b: Matrix(T)) -> Matrix(T):
+            """Return the x with self @ x == b, by LU factorization.
+
+            If we're singular, x is all nan.
+            """
+            self._checkSystem(b)
+
+            n = self._shape[0]
+            a = self.transpose().toList()
+            x = b.transpose().toList()
+            info = 0
+
+            if n and b._shape[1]:
+                ipiv = ListOf(Int32)()
+                ipiv.resize(n)
+
+                info = gesv(n, b._shape[1], a, n, ipiv, x, n, 0)
+
+            res = Matrix(T)._fromColumnMajor(x, n, b._shape[1], max(1, n))
+
+            if info != 0:
+                return res * math.nan
+
+            return res
+
+        def solve(self, b: Array(T)) -> Array(T):  # noqa
+            return Array(T)(self.solve(Matrix(T)._column(b)).toList())
+
+        def cholesky(self) -> Matrix(T):
+            """Return the lower-triangular L with L @ L.transpose() == self.
+
+            We must be symmetric, and only our lower triangle is read. If we aren't
+            positive definite, L is all nan.
+            """
+            if self._shape[0] != self._shape[1]:
+                raise Exception("Can't factor a non-square matrix")
+
+            n = self._shape[0]
+            a = self.transpose().toList()
+
+            for j in range(n):
+                for i in range(j):
+                    a[j * n + i] = T()
+
+            info = potrf('L', n, a, n, 0) if n else 0
+
+            res = Matrix(T)._fromColumnMajor(a, n, n, max(1, n))
+
+            if info != 0:
+                return res * math.nan
+
+            return res
+
+        def choleskySolve(self, b: Matrix(T)) -> Matrix(T):
+            """Return the x with self @ x == b, for a symmetric positive definite self.
+
+            Only our lower triangle is read. This is about twice as fast as 'solve'.
+            If we aren't positive definite, x is all nan.
+            """
+            self._checkSystem(b)
+
+            n = self._shape[0]
+            a = self.transpose().toList()
+            x = b.transpose().toList()
+            info = 0
+
+            if n and b._shape[1]:
+                info = potrf('L', n, a, n, 0)
+
+                if info == 0:
+                    info = potrs('L', n, b._shape[1], a, n, x, n, 0)
 
+            res = Matrix(T)._fromColumnMajor(x, n, b._shape[1], max(1, n))
+
+            if info != 0:
+                return res * math.nan
+
+            return res
+
+        def choleskySolve(self, b: Array(T)) -> Array(T):  # noqa
+            return Array(T)(self.choleskySolve(Matrix(T)._column(b)).toList())
+
+        def lstsq(self, b: Matrix(T)) -> Matrix(T):
+            """Return the x minimizing the norm of self @ x - b, by QR factorization.
+
+            If we have fewer rows than columns, it's the x of smallest norm solving the
+            system exactly instead. We need full rank: if we don't have it, x is all nan.
+            """
+            rows = self._shape[0]
+            columns = self._shape[1]
+            rhs = b._shape[1]
+
+            if b._shape[0] != rows:
+                raise Exception(f"Size mismatch: {rows} != {b._shape[0]}")
+
+            # gels writes x over b, so b needs room for whichever of them is taller
+            ld = max(1, max(rows, columns))
+
+            a = self.transpose().toList()
+            bVals = b.transpose().toList()
+
+            x = ListOf(T)()
+            x.resize(ld * rhs)
+
+            for j in range(rhs):
+                for i in range(rows):
+                    x[j * ld + i] = bVals[j * rows + i]
+
+            info = 0
+
+            if rows and columns and rhs:
+                # do a workspace query
+                work = ListOf(T)()
+                work.resize(1)
+
+                gels('N', rows, columns, rhs, a, max(1, rows), x, ld, work, -1, 0)
+
+                work.resize(max(1, int(work[0])))
+
+                info = gels('N', rows, columns, rhs, a, max(1, rows), x, ld, work, len(work), 0)
+
+            res = Matrix(T)._fromColumnMajor(x, columns, rhs, ld).clone()
+
+            if info != 0:
+                return res * math.nan
+
+            return res
+
+        def lstsq(self, b: Array(T)) -> Array(T):  # noqa
+            return Array(T)(self.lstsq(Matrix(T)._column(b)).toList())
+
+        def eigh(self) -> Tuple(Array(T), Matrix(T)):
+            """Return the eigenvalues, ascending, and the matching eigenvectors as columns.
+
+            We must be symmetric, and only our lower triangle is read. If the
+            decomposition fails to converge, both are all nan.
+            """
+            if self._shape[0] != self._shape[1]:
+                raise Exception("Can't decompose a non-square matrix")
+
+            n = self._shape[0]
+            a = self.transpose().toList()
+
+            w = ListOf(T)()
+            w.resize(n)
+
+            if n:
+                # do a workspace query
+                work = ListOf(T)()
+                work.resize(1)
+
+                syev('V', 'L', n, a, n, w, work, -1, 0)
+
+                work.resize(max(1, int(work[0])))
+
+                if syev('V', 'L', n, a, n, w, work, len(work), 0) != 0:
+                    for i in range(n):
+                        w[i] = math.nan
+
+                    for i in range(n * n):
+                        a[i] = math.nan
+
+            return (Array(T)(w), Matrix(T)._fromColumnMajor(a, n, n, max(1, n)))
+
+        @staticmethod
+        def solveBatch(As: ListOf(Matrix(T)), bs: ListOf(Matrix(T))) -> ListOf(Matrix(T)):
+            """'As[i].solve(bs[i])' for each i. See '_solveBatch'."""
+            return _solveBatch(As, bs, lambda a, b: a.solve(b))
+
+        @staticmethod
+        def choleskySolveBatch(As: ListOf(Matrix(T)), bs: ListOf(Matrix(T))) -> ListOf(Matrix(T)):
+            """'As[i].choleskySolve(bs[i])' for each i. See '_solveBatch'."""
+            return _solveBatch(As, bs, lambda a, b: a.choleskySolve(b))
+
+        @staticmethod
+        def lstsqBatch(As: ListOf(Matrix(T)), bs: ListOf(Matrix(T))) -> ListOf(Matrix(T)):
+            """'As[i].lstsq(bs[i])' for each i. See '_solveBatch'."""
+            return _solveBatch(As, bs, lambda a, b: a.lstsq(b))
+
+        def __matmul__(self, other: Array(T)):  # noqa
             result = ListOf(T)()
             result.resize(self._shape[0])
 
             if self._shape[1] != other._shape:
                 raise Exception("Size mismatch")
 
-            gemv(
-                'T',
-                self._shape[1],
-                self._shape[0],
-                1.0,
-                self._vals,
-                self._stride[0],
-                other._vals.pointerUnsafe(other._offset),
-                other._stride,
-                1.0,
-                result,
-                1
-            )
+            if self._shape[0] and self._shape[1]:
+                kernels.matvec(self, other, result, False)
 
             return Array(T)(result)
 
         def __rmatmul__(self, other: Array(T)):
-            self = self.getCanonicalForm()
-
             result = ListOf(T)()
             result.resize(self._shape[1])
 
             if self._shape[0] != other._shape:
                 raise Exception(f"Size mismatch: {self._shape[1]} != {other._shape}")
 
-            gemv(
-                'N',
-                self._shape[1],
-                self._shape[0],
-                1.0,
-                self._vals,
-                self._stride[0],
-                other._vals.pointerUnsafe(other._offset),
-                other._stride,
-                1.0,
-                result,
-                1
-            )
+            if self._shape[0] and self._shape[1]:
+                kernels.matvec(self, other, result, True)
 
             return Array(T)(result)
 
@@ -829,3 +1723,262 @@ def Matrix(T):
             return repr(self)
 
     return Matrix_
+
+
+##################################################################
+# Lazy expressions
+#
+# Operators on a LazyExpression build a bigger LazyExpression rather than
+# computing anything. The structure of the expression is all in its type, so when
+# we compile 'eval' every node's 'at' inlines into the one loop, and the whole
+# expression costs a single pass and a single allocation.
+#
+# Each node's operation is one of the classes below. 'apply(node, i)' computes
+# element 'i' of the node from its children.
+
+
+class _Load(Class, Final):
+    """A leaf reading from an Array."""
+    @staticmethod
+    def apply(node, i):
+        array = node.left
+        return array._vals.pointerUnsafe(array._offset + i * array._stride).get()
+
+
+class _Constant(Class, Final):
+    """A leaf with the same value everywhere."""
+    @staticmethod
+    def apply(node, i):
+        return node.left
+
+
+class _Add(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return node.left.at(i) + node.right.at(i)
+
+
+class _Sub(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return node.left.at(i) - node.right.at(i)
+
+
+class _Mul(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return node.left.at(i) * node.right.at(i)
+
+
+class _TrueDiv(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return node.left.at(i) / node.right.at(i)
+
+
+class _FloorDiv(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return node.left.at(i) // node.right.at(i)
+
+
+class _Pow(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return node.left.at(i) ** node.right.at(i)
+
+
+class _Neg(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return -node.left.at(i)
+
+
+class _Abs(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        a = node.left.at(i)
+        return -a if a < 0 else a
+
+
+class _Log(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return math.log(node.left.at(i))
+
+
+class _Cos(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return math.cos(node.left.at(i))
+
+
+class _Sin(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return math.sin(node.left.at(i))
+
+
+class _Tanh(Class, Final):
+    @staticmethod
+    def apply(node, i):
+        return math.tanh(node.left.at(i))
+
+
+def _combinedShape(leftShape, rightShape):
+    """The shape of a node whose children have these shapes. Constants have shape -1."""
+    if leftShape < 0:
+        return rightShape
+
+    if rightShape < 0:
+        return leftShape
+
+    if leftShape != rightShape:
+        raise Exception("Mismatched array sizes.")
+
+    return leftShape
+
+
+def _binary(Op, left, right):
+    return LazyExpression(Op, type(left), type(right))(
+        left=left, right=right, shape=_combinedShape(left.shape, right.shape)
+    )
+
+
+def _unary(Op, child):
+    return LazyExpression(Op, type(child), None)(left=child, shape=child.shape)
+
+
+@TypeFunction
+def LazyExpression(Op, L, R):
+    """An unevaluated elementwise expression over Arrays.
+
+    Build one with 'Array.lazy()' and the usual operators, then call 'eval' to get
+    an Array, or 'sum' to reduce it without storing it at all. Numbers are
+    broadcast, as they are for Array.
+
+    Args:
+        Op - the operation at this node: one of _Load, _Constant, _Add, and so on.
+        L - the type of the left (or only) child. For _Load it's the Array type,
+            and for _Constant the element type.
+        R - the type of the right child, or None.
+    """
+    if Op is _Load:
+        T = L.ElementType
+    elif Op is _Constant:
+        T = L
+    else:
+        T = L.ElementType
+
+    class LazyExpression_(Class, Final):
+        left = Member(L)
+        right = Member(R)
+
+        # the length of the result, or -1 for a constant
+        shape = Member(int)
+
+        ElementType = T
+
+        def __len__(self):
+            return self.shape
+
+        def at(self, i: int) -> T:
+            return Op.apply(self, i)
+
+        @staticmethod
+        def _lift(x: T):
+            return LazyExpression(_Constant, T, None)(left=x, shape=-1)
+
+        @staticmethod  # noqa
+        def _lift(x: Array(T)):  # noqa
+            return x.lazy()
+
+        @staticmethod  # noqa
+        def _lift(x):  # noqa
+            return x
+
+        def __add__(self, other):
+            return _binary(_Add, self, LazyExpression_._lift(other))
+
+        def __radd__(self, other):
+            return _binary(_Add, LazyExpression_._lift(other), self)
+
+        def __sub__(self, other):
+            return _binary(_Sub, self, LazyExpression_._lift(other))
+
+        def __rsub__(self, other):
+            return _binary(_Sub, LazyExpression_._lift(other), self)
+
+        def __mul__(self, other):
+            return _binary(_Mul, self, LazyExpression_._lift(other))
+
+        def __rmul__(self, other):
+            return _binary(_Mul, LazyExpression_._lift(other), self)
+
+        def __truediv__(self, other):
+            return _binary(_TrueDiv, self, LazyExpression_._lift(other))
+
+        def __rtruediv__(self, other):
+            return _binary(_TrueDiv, LazyExpression_._lift(other), self)
+
+        def __floordiv__(self, other):
+            return _binary(_FloorDiv, self, LazyExpression_._lift(other))
+
+        def __rfloordiv__(self, other):
+            return _binary(_FloorDiv, LazyExpression_._lift(other), self)
+
+        def __pow__(self, p):
+            return _binary(_Pow, self, LazyExpression_._lift(p))
+
+        def __neg__(self):
+            return _unary(_Neg, self)
+
+        def __pos__(self):
+            return self
+
+        def abs(self):
+            return _unary(_Abs, self)
+
+        def log(self):
+            return _unary(_Log, self)
+
+        def cos(self):
+            return _unary(_Cos, self)
+
+        def sin(self):
+            return _unary(_Sin, self)
+
+        def tanh(self):
+            return _unary(_Tanh, self)
+
+        @Entrypoint
+        def eval(self) -> Array(T):
+            """Compute every element of the expression in one pass."""
+            if self.shape < 0:
+                raise Exception("Can't evaluate an expression that doesn't contain an Array.")
+
+            newVals = ListOf(T)()
+            newVals.reserve(self.shape)
+            pWrite = newVals.pointerUnsafe(0)
+
+            for i in range(self.shape):
+                pWrite.set(self.at(i))
+                pWrite += 1
+            newVals.setSizeUnsafe(self.shape)
+
+            return Array(T)(newVals, 0, 1, self.shape)
+
+        @Entrypoint
+        def sum(self) -> T:
+            """The sum of the elements of the expression, without storing them."""
+            if self.shape < 0:
+                raise Exception("Can't evaluate an expression that doesn't contain an Array.")
+
+            res = T()
+
+            for i in range(self.shape):
+                res += self.at(i)
+
+            return res
+
+    return LazyExpression_
@@ -19,8 +19,10 @@ import numpy
 import os
 
 from typed_python.test_util import estimateFunctionMultithreadSlowdown
-from typed_python.array.array import Array, Matrix
-from typed_python import Entrypoint
+from typed_python.array.array import (
+    Array, Matrix, _BlockedKernels, getParallelThreshold, setParallelThreshold
+)
+from typed_python import Entrypoint, ListOf, Float32
 
 
 def test_float_array_addition():
@@ -102,6 +104,158 @@ def test_float_array_addition_wrong_size():
         x += x2
 
 
+def test_parallel_elementwise_ops_match_serial_ones():
+    def compute(a, b):
+        return [
+            (a + b).toList(),
+            (a - b).toList(),
+            (a * b).toList(),
+            (a / (b + 1)).toList(),
+            (a * 2.5).toList(),
+            a.cos().toList(),
+            (a + 1).log().toList(),
+        ]
+
+    a = Array(float)(ListOf(float)(range(20011)))
+    b = Array(float)(ListOf(float)([x * 0.5 for x in range(40022)]), 1, 2, 20011)
+
+    serial = compute(a, b)
+
+    oldThreshold = getParallelThreshold()
+    setParallelThreshold(1)
+
+    try:
+        assert compute(a, b) == serial
+
+        # in-place ops on a strided view only touch the view
+        b += a
+        assert b._vals[0] == 0.0
+        assert b._vals[1] == 0.5
+        assert b[10] == 10.5 + 10
+    finally:
+        setParallelThreshold(oldThreshold)
+
+
+def test_reductions_match_numpy():
+    values = numpy.random.RandomState(1).normal(size=20011)
+
+    for T in [float, Float32]:
+        a = Array(T)(ListOf(T)(values))
+        asNumpy = numpy.array(values, dtype=numpy.float64 if T is float else numpy.float32)
+        tolerance = 1e-9 if T is float else 1e-3
+
+        assert a.sum() == pytest.approx(asNumpy.sum(), rel=tolerance, abs=tolerance)
+        assert a.sum(compensated=True) == pytest.approx(asNumpy.sum(), rel=tolerance, abs=tolerance)
+        assert a.mean() == pytest.approx(asNumpy.mean(), rel=tolerance, abs=tolerance)
+        assert a.var() == pytest.approx(asNumpy.var(), rel=tolerance)
+        assert a.var(ddof=1) == pytest.approx(asNumpy.var(ddof=1), rel=tolerance)
+        assert a.min() == asNumpy.min()
+        assert a.max() == asNumpy.max()
+        assert a.argmin() == asNumpy.argmin()
+        assert a.argmax() == asNumpy.argmax()
+        assert a.dot(a) == pytest.approx(asNumpy.dot(asNumpy), rel=tolerance)
+        assert a @ a == a.dot(a)
+        assert numpy.allclose(a.cumsum().toList(), numpy.cumsum(asNumpy), rtol=tolerance, atol=tolerance)
+
+    ints = Array(int)(ListOf(int)([3, -1, 4, 1, -5, 9, 2, 6, -5, 9]))
+
+    assert ints.sum() == 23
+    assert ints.sum(compensated=True) == 23
+    assert ints.min() == -5
+    assert ints.argmin() == 4
+    assert ints.argmax() == 5
+    assert ints.mean() == 2.3
+    assert ints.cumsum().toList() == list(numpy.cumsum(ints.toList()))
+
+    # strided views
+    strided = Array(float)(ListOf(float)(values), 1, 3, 6000)
+    assert strided.sum() == pytest.approx(values[1::3][:6000].sum())
+    assert strided.argmax() == values[1::3][:6000].argmax()
+    assert strided.dot(Array(float)(ListOf(float)(values[:6000]))) == pytest.approx(values[1::3][:6000].dot(values[:6000]))
+
+    with pytest.raises(ValueError):
+        Array(float)([]).min()
+
+    with pytest.raises(ValueError):
+        Array(float)([1.0]).var(ddof=1)
+
+    assert Array(float)([]).sum() == 0.0
+
+
+def test_compensated_sum_is_more_accurate():
+    # 1.0 followed by many values each too small to change it on its own
+    vals = ListOf(float)([1.0])
+    vals.extend([1e-16] * 100000)
+    a = Array(float)(vals)
+
+    assert a.sum(compensated=True) == pytest.approx(1.0 + 1e-11, rel=1e-14)
+    assert abs(a.sum(compensated=True) - (1.0 + 1e-11)) <= abs(a.sum() - (1.0 + 1e-11))
+
+
+def test_parallel_reductions_match_serial_ones():
+    def compute(a):
+        return [a.sum(), a.sum(compensated=True), a.var(), a.min(), a.argmax(), a.dot(a), a.cumsum().toList()]
+
+    a = Array(float)(ListOf(float)(numpy.random.RandomState(2).uniform(size=100003)))
+
+    serial = compute(a)
+
+    oldThreshold = getParallelThreshold()
+    setParallelThreshold(1)
+
+    try:
+        parallel = compute(a)
+    finally:
+        setParallelThreshold(oldThreshold)
+
+    # chunking doesn't depend on the thread count, so only the cumsum may differ
+    assert parallel[:-1] == serial[:-1]
+    assert numpy.allclose(parallel[-1], serial[-1], rtol=1e-12)
+
+
+
+def test_lazy_expressions_match_eager_ones():
+    a = Array(float)([1, 2, 3, 4])
+    b = Array(float)([0.5, 1.5, 2.5, 3.5])
+    c = Array(float)([2, 4, 6, 8])
+
+    def same(lazy, eager):
+        assert lazy.eval().toList() == eager.toList()
+
+    same((a.lazy() * b + c).log(), (a * b + c).log())
+    same(a.lazy() - b / c, a - b / c)
+    same((a.lazy() // 2 + 1) ** 2, (a // 2 + 1) ** 2)
+    same(-(a.lazy() - 3).abs(), -(a - 3).abs())
+    same(a.lazy().cos() + a.lazy().sin() * a.lazy().tanh(), a.cos() + a.sin() * a.tanh())
+
+    # numbers broadcast, on either side
+    assert (10 - a.lazy()).eval().toList() == [9, 8, 7, 6]
+    assert (2 / a.lazy() + 1).eval().toList() == [3, 2, 2 / 3 + 1, 1.5]
+
+    assert (a.lazy() * b).sum() == (a * b).sum()
+
+
+def test_lazy_expressions_from_compiled_code():
+    @Entrypoint
+    def f(a: Array(float), b: Array(float), c: Array(float)):
+        return (a.lazy() * b + c).log().eval()
+
+    a = Array(float)([1, 2, 3])
+    assert f(a, a, a).toList() == (a * a + a).log().toList()
+
+
+def test_lazy_expressions_on_strided_arrays():
+    m = Matrix(float).make(3, 4, lambda i, j: i * 10 + j)
+    column = m.transpose()[1]
+
+    assert (column.lazy() + 1).eval().toList() == [2, 12, 22]
+
+
+def test_lazy_expression_wrong_size():
+    with pytest.raises(Exception, match="Mismatched array sizes"):
+        Array(float).ones(3).lazy() + Array(float).zeros(4).lazy()
+
+
 def test_basic_matrix_ops():
     m = Matrix(float).identity(10)
 
@@ -245,6 +399,60 @@ def test_rectangular_matrix_multiply():
     assert (m @ m2)[0][3] == 1.0
 
 
+def toNumpy(m):
+    return numpy.array(m.toList()).reshape(m.shape)
+
+
+def paddedMatrix(rows, columns, seed):
+    """A row-major matrix with a leading dimension wider than it is, living at an offset."""
+    numpy.random.seed(seed)
+    ld = columns + 3
+    vals = numpy.random.uniform(size=rows * ld + 2)
+
+    return Matrix(float)(ListOf(float)(vals), 2, (ld, 1), (rows, columns))
+
+
+def test_matrix_multiply_strided_and_transposed():
+    a = paddedMatrix(70, 66, 1)
+    b = paddedMatrix(66, 65, 2)
+    bT = paddedMatrix(65, 66, 3).transpose()
+    everyOther = Matrix(float)(paddedMatrix(66, 130, 4)._vals, 0, (133, 2), (66, 65))
+
+    for left in [a, paddedMatrix(66, 70, 5).transpose()]:
+        for right in [b, bT, everyOther]:
+            expected = toNumpy(left) @ toNumpy(right)
+
+            assert numpy.abs(toNumpy(left @ right) - expected).max() < 1e-10
+
+            result = Matrix(float).zeros(70, 65)
+            _BlockedKernels.matmul(left, right, result)
+
+            assert numpy.abs(toNumpy(result) - expected).max() < 1e-10
+
+
+def test_matrix_vector_multiply_strided_and_transposed():
+    x = Array(float)(ListOf(float)(range(40)), 1, 2, 20)
+
+    for m in [paddedMatrix(7, 20, 1), paddedMatrix(20, 7, 2).transpose()]:
+        assert numpy.abs(numpy.array((m @ x).toList()) - toNumpy(m) @ numpy.array(x.toList())).max() < 1e-10
+
+        y = Array(float)(list(range(7)))
+        assert numpy.abs(numpy.array((y @ m).toList()) - numpy.array(y.toList()) @ toNumpy(m)).max() < 1e-10
+
+
+def test_integer_matrix_multiply():
+    m = Matrix(int).make(3, 4, lambda i, j: i + j)
+    m2 = Matrix(int).make(4, 2, lambda i, j: i * j - 1)
+
+    assert (m @ m2).toList() == (toNumpy(m) @ toNumpy(m2)).flatten().tolist()
+    assert (m.transpose() @ Array(int)([1, 2, 3])).toList() == [8, 14, 20, 26]
+
+
+def test_multiply_empty_matrices():
+    assert (Matrix(float).zeros(3, 0) @ Matrix(float).zeros(0, 2)).toList() == [0.0] * 6
+    assert (Matrix(float).zeros(0, 3) @ Array(float)([1, 2, 3])).toList() == []
+
+
 def l1norm(m):
     return m.flatten().abs().sum()
 
@@ -259,6 +467,113 @@ def test_invert():
     assert l1norm((m @ ~m) - Matrix(float).identity(10)) < 1e-10
 
 
+def toNumpy(m):
+    return numpy.array(m.toList()).reshape(m.shape[0], m.shape[1])
+
+
+def randomMatrix(rows, columns, seed):
+    values = numpy.random.RandomState(seed).normal(size=(rows, columns))
+    return Matrix(float).make(rows, columns, lambda i, j: values[i, j])
+
+
+def test_solve():
+    a = randomMatrix(6, 6, 1) + Matrix(float).identity(6) * 5
+    b = randomMatrix(6, 3, 2)
+
+    x = a.solve(b)
+    assert numpy.allclose(toNumpy(x), numpy.linalg.solve(toNumpy(a), toNumpy(b)))
+    assert l1norm(a @ x - b) < 1e-10
+
+    # a transposed view goes in the same way
+    xT = a.transpose().solve(b)
+    assert numpy.allclose(toNumpy(xT), numpy.linalg.solve(toNumpy(a).T, toNumpy(b)))
+
+    v = b.transpose()[0]
+    assert numpy.allclose(a.solve(v).toList(), numpy.linalg.solve(toNumpy(a), v.toList()))
+
+    singular = Matrix(float).ones(3, 3)
+    assert numpy.isnan(singular.solve(Matrix(float).ones(3, 1)).toList()).all()
+
+    with pytest.raises(Exception):
+        a.solve(randomMatrix(5, 1, 3))
+
+
+def test_cholesky():
+    m = randomMatrix(5, 5, 4)
+    spd = m @ m.transpose() + Matrix(float).identity(5)
+    b = randomMatrix(5, 2, 5)
+
+    lower = spd.cholesky()
+    assert numpy.allclose(toNumpy(lower), numpy.linalg.cholesky(toNumpy(spd)))
+    assert l1norm(lower @ lower.transpose() - spd) < 1e-10
+
+    assert numpy.allclose(toNumpy(spd.choleskySolve(b)), numpy.linalg.solve(toNumpy(spd), toNumpy(b)))
+
+    notPositive = Matrix(float).identity(3) * -1.0
+    assert numpy.isnan(notPositive.cholesky().toList()).all()
+    assert numpy.isnan(notPositive.choleskySolve(Matrix(float).ones(3, 1)).toList()).all()
+
+
+def test_lstsq():
+    a = randomMatrix(20, 4, 6)
+    b = randomMatrix(20, 2, 7)
+
+    x = a.lstsq(b)
+    assert x.shape == (4, 2)
+    assert numpy.allclose(toNumpy(x), numpy.linalg.lstsq(toNumpy(a), toNumpy(b), rcond=None)[0])
+
+    # underdetermined: the minimum norm solution
+    wide = randomMatrix(3, 5, 8)
+    rhs = randomMatrix(3, 1, 9)
+    assert numpy.allclose(toNumpy(wide.lstsq(rhs)), numpy.linalg.lstsq(toNumpy(wide), toNumpy(rhs), rcond=None)[0])
+
+    v = b.transpose()[1]
+    assert numpy.allclose(a.lstsq(v).toList(), numpy.linalg.lstsq(toNumpy(a), v.toList(), rcond=None)[0])
+
+
+def test_eigh():
+    m = randomMatrix(6, 6, 10)
+    symmetric = m + m.transpose()
+
+    values, vectors = symmetric.eigh()
+    expectedValues = numpy.linalg.eigh(toNumpy(symmetric))[0]
+
+    assert numpy.allclose(values.toList(), expectedValues)
+    assert numpy.allclose(toNumpy(symmetric @ vectors), toNumpy(vectors) * numpy.array(values.toList()))
+    assert numpy.allclose(toNumpy(vectors.transpose() @ vectors), numpy.identity(6))
+
+
+def test_solve_batch_matches_individual_solves():
+    As = ListOf(Matrix(float))([randomMatrix(4, 4, i) + Matrix(float).identity(4) * 4 for i in range(50)])
+    bs = ListOf(Matrix(float))([randomMatrix(4, 2, 100 + i) for i in range(50)])
+
+    def check(batch, solveOne):
+        assert len(batch) == len(As)
+        for i in range(len(As)):
+            assert batch[i].toList() == solveOne(As[i], bs[i]).toList()
+
+    check(Matrix(float).solveBatch(As, bs), lambda a, b: a.solve(b))
+    check(Matrix(float).lstsqBatch(As, bs), lambda a, b: a.lstsq(b))
+
+    spds = ListOf(Matrix(float))([a @ a.transpose() for a in As])
+    assert [x.toList() for x in Matrix(float).choleskySolveBatch(spds, bs)] == [
+        a.choleskySolve(b).toList() for a, b in zip(spds, bs)
+    ]
+
+    oldThreshold = getParallelThreshold()
+    setParallelThreshold(1)
+
+    try:
+        check(Matrix(float).solveBatch(As, bs), lambda a, b: a.solve(b))
+    finally:
+        setParallelThreshold(oldThreshold)
+
+    with pytest.raises(Exception):
+        Matrix(float).solveBatch(As, ListOf(Matrix(float))([randomMatrix(4, 3, 0)] * 50))
+
+    assert len(Matrix(float).solveBatch(ListOf(Matrix(float))(), ListOf(Matrix(float))())) == 0
+
+
 def test_create_matrix():
     m = Matrix(float).make(10, 10, lambda row, col: row * 20 - col)
 
@@ -1,5 +1,4 @@
 import os
-import numpy
 import ctypes
 
 from typed_python import Int32, Float32, Entrypoint, PointerTo, ListOf, TupleOf, UInt8
@@ -17,6 +16,11 @@ def searchForLapackLib():
     except Exception:
         pass
 
+    try:
+        import numpy
+    except ImportError:
+        return None
+
     libdirs = [os.path.dirname(numpy.__file__)]
 
     for libdirPath in libdirs:
@@ -53,23 +57,24 @@ def isValidLapack(blasLibPath):
 
 blasLibPath = searchForLapackLib()
 
-
-if blasLibPath is None:
-    raise Exception("Couldn't find a valid implementation of lapack.")
+# if this is False, the wrappers below still exist but can't be linked, so callers
+# need to check it and fall back to compiled loops.
+hasBlas = blasLibPath is not None
 
 # this loads the blas shared library as a 'global' library, which allows our llvm instructions
 # to find the functions they bind to. If we don't do this, then when we compile things like
 # 'daxpy_', when we go to link the library it will just blow up. Maybe at some point
 # we can figure out how to make a library dependency on the blas library at linktime instead
 # of loading global symbols like this...
-blas = ctypes.CDLL(blasLibPath, mode=ctypes.RTLD_GLOBAL)
+if hasBlas:
+    blas = ctypes.CDLL(blasLibPath, mode=ctypes.RTLD_GLOBAL)
 
-# verify we can get 'daxpy_', which means we found a real blas.
-try:
-    blas.daxpy_
-    blas.dgemm_
-except Exception:
-    raise Exception("Couldn't find a valid implementation of lapack.")
+    # verify we can get 'daxpy_', which means we found a real blas.
+    try:
+        blas.daxpy_
+        blas.dgemm_
+    except Exception:
+        raise Exception("Couldn't find a valid implementation of lapack.")
 
 
 def makePointer(e, viableOutputTypes):
@@ -144,7 +149,7 @@ class axpy_(CompilableBuiltin):
             return
 
         targetFun = externalCallTarget(
-            "daxpy_" if T is float else "faxpy_",
+            "daxpy_" if T is float else "saxpy_",
             native_ast.Void,
             native_ast.Int32.pointer(),
             nativeT.pointer(),
@@ -235,7 +240,7 @@ class gemm_(CompilableBuiltin):
             return
 
         targetFun = externalCallTarget(
-            "dgemm_" if T is float else "fgemm_",
+            "dgemm_" if T is float else "sgemm_",
             native_ast.Void,
             native_ast.UInt8.pointer(),
             native_ast.UInt8.pointer(),
@@ -339,7 +344,7 @@ class gemv_(CompilableBuiltin):
             return
 
         targetFun = externalCallTarget(
-            "dgemv_" if T is float else "fgemv_",
+            "dgemv_" if T is float else "sgemv_",
             native_ast.Void,
             native_ast.UInt8.pointer(),
             native_ast.Int32.pointer(),
@@ -423,7 +428,7 @@ class getrf_(CompilableBuiltin):
             return
 
         targetFun = externalCallTarget(
-            "dgetrf_" if T is float else "fgetrf_",
+            "dgetrf_" if T is float else "sgetrf_",
             native_ast.Void,
             native_ast.Int32.pointer(),
             native_ast.Int32.pointer(),
@@ -503,7 +508,7 @@ class getri_(CompilableBuiltin):
             return
 
         targetFun = externalCallTarget(
-            "dgetri_" if T is float else "fgetri_",
+            "dgetri_" if T is float else "sgetri_",
             native_ast.Void,
             native_ast.Int32.pointer(),
             nativeT.pointer(),
@@ -544,3 +549,169 @@ def getri(N, A, LDA, IPIV, WORK, LWORK, INFO):
 
     """
     return getri_()(N, A, LDA, IPIV, WORK, LWORK, INFO)
+
+
+class LapackRoutine(CompilableBuiltin):
+    """Calls the LAPACK routine 'd<name>_' or 's<name>_', by the element type of its first array.
+
+    Unlike the wrappers above, which each spell their call out, this one is driven by
+    'signature', a space-separated list naming each argument in order as one of:
+
+        char - a character code, passed as a UInt8
+        int - an integer, passed as an Int32
+        array - a ListOf of float or Float32, or a pointer to one of those
+        ints - a ListOf of Int32 or a pointer to one
+        info - the Int32 LAPACK writes its status into. We return it.
+    """
+    def __init__(self, name, signature):
+        super().__init__()
+
+        self.name = name
+        self.signature = tuple(signature.split())
+
+    def __eq__(self, other):
+        return isinstance(other, LapackRoutine) and (self.name, self.signature) == (other.name, other.signature)
+
+    def __hash__(self):
+        return hash(("LapackRoutine", self.name, self.signature))
+
+    def __str__(self):
+        return f"LapackRoutine({self.name})"
+
+    def convert_call(self, context, instance, args, kwargs):
+        if len(args) != len(self.signature) or kwargs:
+            # this will just produce an exception in the generated code saying we can't
+            # handle these arguments
+            return super().convert_call(context, instance, args, kwargs)
+
+        # determine the type from the first array
+        A = makePointer(args[self.signature.index("array")], (float, Float32))
+        if not A:
+            return
+
+        T = A.expr_type.typeRepresentation.ElementType
+        nativeT = native_ast.Float64 if T is float else native_ast.Float32
+
+        nativeArgs = []
+        nativeArgTypes = []
+        info = None
+
+        for kind, arg in zip(self.signature, args):
+            if kind == "char":
+                e = ensureOnStack(arg, UInt8)
+                nativeArgTypes.append(native_ast.UInt8.pointer())
+            elif kind in ("int", "info"):
+                e = ensureOnStack(arg, Int32)
+                nativeArgTypes.append(native_ast.Int32.pointer())
+            elif kind == "array":
+                e = makePointer(arg, (T,))
+                nativeArgTypes.append(nativeT.pointer())
+            else:
+                assert kind == "ints", kind
+                e = makePointer(arg, (Int32,))
+                nativeArgTypes.append(native_ast.Int32.pointer())
+
+            if not e:
+                return
+
+            nativeArgs.append(e.nonref_expr if kind in ("array", "ints") else e.expr)
+
+            if kind == "info":
+                info = e
+
+        targetFun = externalCallTarget(
+            ("d" if T is float else "s") + self.name + "_",
+            native_ast.Void,
+            *nativeArgTypes
+        )
+
+        context.pushEffect(targetFun.call(*nativeArgs))
+
+        return info
+
+
+gesv_ = LapackRoutine("gesv", "int int array int ints array int info")
+potrf_ = LapackRoutine("potrf", "char int array int info")
+potrs_ = LapackRoutine("potrs", "char int int array int array int info")
+gels_ = LapackRoutine("gels", "char int int int array int array int array int info")
+syev_ = LapackRoutine("syev", "char char int array int array array int info")
+
+
+@Entrypoint
+def gesv(N, NRHS, A, LDA, IPIV, B, LDB, INFO):
+    """Linear system solution
+
+    DGESV computes the solution to a real system of linear equations
+        A * X = B,
+    where A is an N-by-N matrix and X and B are N-by-NRHS matrices.
+
+    The LU decomposition with partial pivoting and row interchanges is
+    used to factor A as A = P * L * U. On exit, A holds the factors and B holds X.
+
+    Returns:
+        INFO, which is 0 on success and i > 0 if U(i,i) is exactly zero.
+    """
+    return gesv_(N, NRHS, A, LDA, IPIV, B, LDB, INFO)
+
+
+@Entrypoint
+def potrf(UPLO: str, N, A, LDA, INFO):
+    """Cholesky factorization
+
+    DPOTRF computes the Cholesky factorization of a real symmetric
+    positive definite matrix A, as A = U**T * U if UPLO is 'U' or
+    A = L * L**T if UPLO is 'L'. Only that triangle of A is read or written.
+
+    Returns:
+        INFO, which is 0 on success and i > 0 if A isn't positive definite.
+    """
+    return potrf_(ord(UPLO[0]), N, A, LDA, INFO)
+
+
+@Entrypoint
+def potrs(UPLO: str, N, NRHS, A, LDA, B, LDB, INFO):
+    """Linear system solution from a Cholesky factorization
+
+    DPOTRS solves A * X = B with A symmetric positive definite, using
+    the factorization of A computed by DPOTRF. On exit, B holds X.
+
+    Returns:
+        INFO, which is 0 on success.
+    """
+    return potrs_(ord(UPLO[0]), N, NRHS, A, LDA, B, LDB, INFO)
+
+
+@Entrypoint
+def gels(TRANS: str, M, N, NRHS, A, LDA, B, LDB, WORK, LWORK, INFO):
+    """Least squares solution
+
+    DGELS solves overdetermined or underdetermined real linear systems
+    involving an M-by-N matrix A, or its transpose, using a QR or LQ
+    factorization of A. A must have full rank. On exit, B holds the solution
+    in its first N rows (for TRANS = 'N').
+
+    If LWORK is -1, this is a workspace query, and WORK[0] is set to the
+    optimal LWORK.
+
+    Returns:
+        INFO, which is 0 on success and i > 0 if A doesn't have full rank.
+    """
+    return gels_(ord(TRANS[0]), M, N, NRHS, A, LDA, B, LDB, WORK, LWORK, INFO)
+
+
+@Entrypoint
+def syev(JOBZ: str, UPLO: str, N, A, LDA, W, WORK, LWORK, INFO):
+    """Symmetric eigendecomposition
+
+    DSYEV computes all eigenvalues and, if JOBZ is 'V', eigenvectors of a
+    real symmetric matrix A, reading the UPLO triangle of A. The eigenvalues
+    go in W in ascending order, and the orthonormal eigenvectors replace the
+    columns of A.
+
+    If LWORK is -1, this is a workspace query, and WORK[0] is set to the
+    optimal LWORK.
+
+    Returns:
+        INFO, which is 0 on success and i > 0 if the algorithm failed to converge.
+    """
+    return syev_(ord(JOBZ[0]), ord(UPLO[0]), N, A, LDA, W, WORK, LWORK, INFO)
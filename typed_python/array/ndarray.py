@@ -0,0 +1,501 @@
+#   Copyright 2017-2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""An N-dimensional strided array.
+
+An NDArray is a window onto a flat ListOf(T): element (i0, i1, ...) lives at
+'offset + i0 * strides[0] + i1 * strides[1] + ...'. Indexing, slicing, transposing,
+broadcasting, and reshaping a contiguous array all just compute a new offset,
+shape and strides over the same buffer, so they don't copy anything. Writes
+through a view show up in every other view of the buffer.
+
+Binary operators broadcast the way numpy does: shapes are aligned on their last
+axis, and an axis of length 1 (or a missing leading one) stretches to match the
+other side. The result of an operator is always a new contiguous array.
+"""
+
+import math
+
+from typed_python import Class, Member, ListOf, TupleOf, Final, TypeFunction, Entrypoint
+from typed_python.array.array import Array
+
+
+def _product(shape):
+    res = 1
+
+    for s in shape:
+        res *= s
+
+    return res
+
+
+def _contiguousStrides(shape):
+    """The strides of a C-ordered array with this shape."""
+    strides = ListOf(int)()
+    strides.resize(len(shape))
+
+    stride = 1
+
+    for axis in range(len(shape) - 1, -1, -1):
+        strides[axis] = stride
+        stride *= shape[axis]
+
+    return strides
+
+
+def _broadcastShapes(shape1, shape2):
+    """The shape two arrays of these shapes broadcast to, following numpy's rules."""
+    ndim = max(len(shape1), len(shape2))
+
+    res = ListOf(int)()
+    res.resize(ndim)
+
+    for axis in range(ndim):
+        ix1 = len(shape1) - ndim + axis
+        ix2 = len(shape2) - ndim + axis
+
+        s1 = shape1[ix1] if ix1 >= 0 else 1
+        s2 = shape2[ix2] if ix2 >= 0 else 1
+
+        if s1 != s2 and s1 != 1 and s2 != 1:
+            raise Exception(f"Shapes {shape1} and {shape2} can't be broadcast together.")
+
+        res[axis] = s1 if s2 == 1 else s2
+
+    return res
+
+
+@TypeFunction
+def NDArray(T):
+    """Implements a strongly typed N-dimensional array over a shared ListOf(T)."""
+    class NDArray_(Class, Final):
+        _vals = Member(ListOf(T))
+        _offset = Member(int)
+        _shape = Member(ListOf(int))
+        _strides = Member(ListOf(int))
+
+        ElementType = T
+
+        def __init__(self, vals, shape):
+            vals = ListOf(T)(vals)
+            shape = ListOf(int)(shape)
+
+            if _product(shape) != len(vals):
+                raise Exception(f"Can't make an array of shape {shape} out of {len(vals)} values.")
+
+            self._vals = vals
+            self._offset = 0
+            self._shape = shape
+            self._strides = _contiguousStrides(shape)
+
+        def __init__(self, vals, offset, shape, strides):  # noqa
+            self._vals = vals
+            self._offset = offset
+            self._shape = shape
+            self._strides = strides
+
+        @Entrypoint
+        @staticmethod
+        def full(shape: ListOf(int), value: T):
+            for s in shape:
+                if s < 0:
+                    raise Exception("Can't have a negative array size.")
+
+            vals = ListOf(T)()
+            vals.resize(_product(shape), value)
+
+            return NDArray(T)(vals, 0, ListOf(int)(shape), _contiguousStrides(shape))
+
+        @staticmethod
+        def zeros(shape):
+            return NDArray_.full(shape, T())
+
+        @staticmethod
+        def ones(shape):
+            return NDArray_.full(shape, T(1))
+
+        @staticmethod
+        def fromArray(array: Array(T)):
+            """A one-dimensional view of the same values as 'array'."""
+            return NDArray(T)(array._vals, array._offset, ListOf(int)([array._shape]), ListOf(int)([array._stride]))
+
+        @property
+        def shape(self):
+            return TupleOf(int)(self._shape)
+
+        @property
+        def strides(self):
+            return TupleOf(int)(self._strides)
+
+        @property
+        def ndim(self):
+            return len(self._shape)
+
+        @property
+        def size(self):
+            return _product(self._shape)
+
+        def __len__(self):
+            if not self._shape:
+                raise TypeError("A 0-dimensional array has no length.")
+
+            return self._shape[0]
+
+        def isContiguous(self):
+            return self._strides == _contiguousStrides(self._shape)
+
+        ##################################################################
+        # Indexing and views
+
+        def _elementOffset(self, index: TupleOf(int)) -> int:
+            if len(index) != len(self._shape):
+                raise IndexError(f"Expected {len(self._shape)} indices but got {len(index)}")
+
+            offset = self._offset
+
+            for axis in range(len(index)):
+                i = index[axis]
+
+                if i < 0 or i >= self._shape[axis]:
+                    raise IndexError(f"Index {i} is out of bounds [0, {self._shape[axis]}) on axis {axis}")
+
+                offset += i * self._strides[axis]
+
+            return offset
+
+        def __getitem__(self, i: int):
+            """A view of the subarray at position 'i' along the first axis."""
+            if not self._shape:
+                raise IndexError("Can't index a 0-dimensional array.")
+
+            if i < 0 or i >= self._shape[0]:
+                raise IndexError(f"Index {i} is out of bounds [0, {self._shape[0]})")
+
+            return NDArray(T)(self._vals, self._offset + i * self._strides[0], self._shape[1:], self._strides[1:])
+
+        def __getitem__(self, index: TupleOf(int)) -> T:  # noqa
+            return self._vals[self._elementOffset(index)]
+
+        def __setitem__(self, index: TupleOf(int), value: T):
+            self._vals[self._elementOffset(index)] = value
+
+        def item(self) -> T:
+            """The single element of an array of size 1."""
+            if self.size != 1:
+                raise Exception(f"Can't take the item of an array of shape {self._shape}.")
+
+            return self._vals[self._offset]
+
+        def slice(self, axis: int, start: int, stop: int, step: int = 1):
+            """A view of the elements 'start:stop:step' along 'axis', as for a python slice of a list.
+
+            Only positive steps are supported.
+            """
+            if axis < 0 or axis >= len(self._shape):
+                raise IndexError(f"Axis {axis} is out of bounds for an array with {len(self._shape)} dimensions")
+
+            if step <= 0:
+                raise Exception("Slice step must be positive.")
+
+            length = self._shape[axis]
+
+            if start < 0:
+                start += length
+            if stop < 0:
+                stop += length
+
+            start = max(0, min(start, length))
+            stop = max(0, min(stop, length))
+            count = max(0, (stop - start + step - 1) // step)
+
+            shape = ListOf(int)(self._shape)
+            strides = ListOf(int)(self._strides)
+
+            shape[axis] = count
+            strides[axis] = self._strides[axis] * step
+
+            return NDArray(T)(self._vals, self._offset + start * self._strides[axis], shape, strides)
+
+        def transpose(self):
+            """A view with the order of the axes reversed."""
+            shape = ListOf(int)()
+            strides = ListOf(int)()
+
+            for axis in range(len(self._shape) - 1, -1, -1):
+                shape.append(self._shape[axis])
+                strides.append(self._strides[axis])
+
+            return NDArray(T)(self._vals, self._offset, shape, strides)
+
+        def transpose(self, axes: ListOf(int)):  # noqa
+            """A view whose axis 'i' is our axis 'axes[i]'."""
+            seen = ListOf(bool)()
+            seen.resize(len(self._shape))
+
+            for axis in axes:
+                if len(axes) != len(self._shape) or axis < 0 or axis >= len(self._shape) or seen[axis]:
+                    raise Exception(f"{axes} isn't a permutation of the axes of an array with {len(self._shape)} dimensions")
+                seen[axis] = True
+
+            shape = ListOf(int)()
+            strides = ListOf(int)()
+
+            for axis in axes:
+                shape.append(self._shape[axis])
+                strides.append(self._strides[axis])
+
+            return NDArray(T)(self._vals, self._offset, shape, strides)
+
+        def reshape(self, shape: ListOf(int)):
+            """An array with the same elements in C order and a new shape. One axis may be -1,
+            in which case we work out its length.
+
+            This is a view if we're contiguous, and a copy otherwise.
+            """
+            shape = ListOf(int)(shape)
+            size = self.size
+            inferred = -1
+            known = 1
+
+            for axis in range(len(shape)):
+                if shape[axis] == -1:
+                    if inferred >= 0:
+                        raise Exception("Only one axis can be -1 in a reshape.")
+                    inferred = axis
+                else:
+                    known *= shape[axis]
+
+            if inferred >= 0 and known > 0 and size % known == 0:
+                shape[inferred] = size // known
+
+            for s in shape:
+                if s < 0:
+                    raise Exception(f"Can't reshape an array of shape {self._shape} to {shape}.")
+
+            if _product(shape) != size:
+                raise Exception(f"Can't reshape an array of shape {self._shape} to {shape}.")
+
+            if not self.isContiguous():
+                return self.copy().reshape(shape)
+
+            return NDArray(T)(self._vals, self._offset, shape, _contiguousStrides(shape))
+
+        def broadcastTo(self, shape: ListOf(int)):
+            """A view of this array stretched to 'shape', using stride 0 for the broadcast axes."""
+            shape = ListOf(int)(shape)
+
+            if _broadcastShapes(self._shape, shape) != shape:
+                raise Exception(f"Can't broadcast an array of shape {self._shape} to {shape}.")
+
+            strides = ListOf(int)()
+            strides.resize(len(shape))
+
+            for axis in range(len(shape)):
+                ownAxis = axis - (len(shape) - len(self._shape))
+
+                if ownAxis >= 0 and self._shape[ownAxis] == shape[axis]:
+                    strides[axis] = self._strides[ownAxis]
+
+            return NDArray(T)(self._vals, self._offset, shape, strides)
+
+        @Entrypoint
+        def _rowOffsets(self) -> ListOf(int):
+            """The offset of the first element of each innermost row, in C order."""
+            res = ListOf(int)()
+            ndim = len(self._shape)
+
+            if _product(self._shape) == 0:
+                return res
+
+            if ndim <= 1:
+                res.append(self._offset)
+                return res
+
+            res.reserve(_product(self._shape) // self._shape[ndim - 1])
+
+            counters = ListOf(int)()
+            counters.resize(ndim - 1)
+            offset = self._offset
+
+            while True:
+                res.append(offset)
+
+                # step the outer axes like an odometer
+                axis = ndim - 2
+
+                while axis >= 0:
+                    counters[axis] += 1
+                    offset += self._strides[axis]
+
+                    if counters[axis] < self._shape[axis]:
+                        break
+
+                    offset -= self._strides[axis] * self._shape[axis]
+                    counters[axis] = 0
+                    axis -= 1
+
+                if axis < 0:
+                    return res
+
+        def _rowLength(self) -> int:
+            return self._shape[len(self._shape) - 1] if self._shape else 1
+
+        def _rowStride(self) -> int:
+            return self._strides[len(self._strides) - 1] if self._strides else 0
+
+        @Entrypoint
+        def _map(self, f):
+            """A new contiguous array holding 'f' of each of our elements."""
+            newVals = ListOf(T)()
+            newVals.reserve(self.size)
+
+            pWrite = newVals.pointerUnsafe(0)
+            rowLength = self._rowLength()
+            rowStride = self._rowStride()
+
+            for rowOffset in self._rowOffsets():
+                pRead = self._vals.pointerUnsafe(rowOffset)
+
+                for i in range(rowLength):
+                    pWrite.set(f(pRead.get()))
+                    pWrite += 1
+                    pRead += rowStride
+
+            newVals.setSizeUnsafe(self.size)
+
+            return NDArray(T)(newVals, 0, ListOf(int)(self._shape), _contiguousStrides(self._shape))
+
+        @Entrypoint
+        def _zipWith(self, other: NDArray(T), f):
+            """A new contiguous array holding 'f' of each pair of our elements, after broadcasting."""
+            shape = _broadcastShapes(self._shape, other._shape)
+            left = self.broadcastTo(shape)
+            right = other.broadcastTo(shape)
+
+            size = _product(shape)
+            newVals = ListOf(T)()
+            newVals.reserve(size)
+
+            pWrite = newVals.pointerUnsafe(0)
+            rowLength = left._rowLength()
+            leftStride = left._rowStride()
+            rightStride = right._rowStride()
+            leftOffsets = left._rowOffsets()
+            rightOffsets = right._rowOffsets()
+
+            for row in range(len(leftOffsets)):
+                pLeft = left._vals.pointerUnsafe(leftOffsets[row])
+                pRight = right._vals.pointerUnsafe(rightOffsets[row])
+
+                for i in range(rowLength):
+                    pWrite.set(f(pLeft.get(), pRight.get()))
+                    pWrite += 1
+                    pLeft += leftStride
+                    pRight += rightStride
+
+            newVals.setSizeUnsafe(size)
+
+            return NDArray(T)(newVals, 0, shape, _contiguousStrides(shape))
+
+        @Entrypoint
+        def _zipWith(self, other: T, f):  # noqa
+            return self._map(lambda a: f(a, other))
+
+        def copy(self):
+            """A contiguous copy of this array."""
+            return self._map(lambda a: a)
+
+        def toList(self):
+            """Our elements, flattened in C order."""
+            return self.copy()._vals
+
+        @Entrypoint
+        def sum(self) -> T:
+            res = T()
+            rowLength = self._rowLength()
+            rowStride = self._rowStride()
+
+            for rowOffset in self._rowOffsets():
+                pRead = self._vals.pointerUnsafe(rowOffset)
+
+                for i in range(rowLength):
+                    res += pRead.get()
+                    pRead += rowStride
+
+            return res
+
+        ##################################################################
+        # Operators
+
+        def __add__(self, other):
+            return self._zipWith(other, lambda a, b: a + b)
+
+        def __radd__(self, other: T):
+            return self._map(lambda a: other + a)
+
+        def __sub__(self, other):
+            return self._zipWith(other, lambda a, b: a - b)
+
+        def __rsub__(self, other: T):
+            return self._map(lambda a: other - a)
+
+        def __mul__(self, other):
+            return self._zipWith(other, lambda a, b: a * b)
+
+        def __rmul__(self, other: T):
+            return self._map(lambda a: other * a)
+
+        def __truediv__(self, other):
+            return self._zipWith(other, lambda a, b: a / b)
+
+        def __rtruediv__(self, other: T):
+            return self._map(lambda a: other / a)
+
+        def __floordiv__(self, other):
+            return self._zipWith(other, lambda a, b: a // b)
+
+        def __rfloordiv__(self, other: T):
+            return self._map(lambda a: other // a)
+
+        def __pow__(self, p):
+            return self._map(lambda a: a ** p)
+
+        def __neg__(self):
+            return self._map(lambda a: -a)
+
+        def __pos__(self):
+            return self.copy()
+
+        def abs(self):
+            return self._map(lambda a: -a if a < 0 else a)
+
+        def log(self):
+            return self._map(lambda a: math.log(a))
+
+        def cos(self):
+            return self._map(lambda a: math.cos(a))
+
+        def sin(self):
+            return self._map(lambda a: math.sin(a))
+
+        def tanh(self):
+            return self._map(lambda a: math.tanh(a))
+
+        def __repr__(self):
+            return f"NDArray({T.__name__})({list(self.toList())}, shape={list(self._shape)})"
+
+        def __str__(self):
+            return repr(self)
+
+    return NDArray_
@@ -0,0 +1,158 @@
+#   Copyright 2017-2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python.array.array import Array
+from typed_python.array.ndarray import NDArray
+from typed_python import Entrypoint, ListOf
+
+
+def arange(*shape):
+    size = 1
+    for s in shape:
+        size *= s
+
+    return NDArray(float)(list(range(size)), shape)
+
+
+def test_indexing():
+    a = arange(2, 3, 4)
+
+    assert a.shape == (2, 3, 4)
+    assert a.strides == (12, 4, 1)
+    assert a.ndim == 3
+    assert a.size == 24
+    assert a[1, 2, 3] == 23
+
+    assert a[1].shape == (3, 4)
+    assert a[1][2, 3] == 23
+    assert a[1][2][3].item() == 23
+
+    with pytest.raises(IndexError):
+        a[2, 0, 0]
+
+    with pytest.raises(IndexError):
+        a[0, 0]
+
+
+def test_views_share_storage():
+    a = arange(2, 3, 4)
+
+    a[1][2, 0] = -1
+    a.transpose()[3, 1, 0] = -2
+    a.slice(2, 1, 4, 2)[0, 0, 0] = -3
+
+    assert a[1, 2, 0] == -1
+    assert a[0, 1, 3] == -2
+    assert a[0, 0, 1] == -3
+
+
+def test_transpose():
+    a = arange(2, 3, 4)
+
+    t = a.transpose()
+    assert t.shape == (4, 3, 2)
+    assert not t.isContiguous()
+    assert t.toList() == [a[i, j, k] for k in range(4) for j in range(3) for i in range(2)]
+
+    p = a.transpose([1, 0, 2])
+    assert p.shape == (3, 2, 4)
+    assert p[2, 1, 3] == 23
+
+    with pytest.raises(Exception):
+        a.transpose([0, 0, 1])
+
+
+def test_slice():
+    a = arange(2, 3, 4)
+
+    s = a.slice(2, 1, 4, 2)
+    assert s.shape == (2, 3, 2)
+    assert s.toList() == [x for x in range(24) if x % 4 in (1, 3)]
+
+    assert a.slice(1, -2, 100).shape == (2, 2, 4)
+    assert a.slice(0, 5, 10).size == 0
+
+
+def test_reshape():
+    a = arange(2, 3, 4)
+
+    r = a.reshape([4, -1])
+    assert r.shape == (4, 6)
+    assert r.toList() == a.toList()
+
+    # contiguous reshapes are views
+    r[0, 0] = 100
+    assert a[0, 0, 0] == 100
+
+    # other ones copy
+    t = a.transpose()
+    assert t.reshape([24]).toList() == t.toList()
+
+    with pytest.raises(Exception, match="reshape"):
+        a.reshape([5, -1])
+
+
+def test_broadcasting():
+    a = arange(2, 3, 4)
+    row = NDArray(float)([10, 20, 30, 40], [4])
+    column = NDArray(float)([1, 2, 3], [3, 1])
+
+    assert (a + row).shape == (2, 3, 4)
+    assert (a + row)[1, 2, 3] == 63
+
+    assert (column * row).shape == (3, 4)
+    assert (column * row).toList() == [c * r for c in [1, 2, 3] for r in [10, 20, 30, 40]]
+
+    assert (a - column)[1, 2, 0] == 20 - 3
+
+    assert row.broadcastTo([2, 4]).strides == (0, 1)
+
+    with pytest.raises(Exception, match="broadcast"):
+        a + NDArray(float)([1, 2], [2])
+
+
+def test_scalar_ops():
+    a = arange(2, 2)
+
+    assert (a + 1).toList() == [1, 2, 3, 4]
+    assert (1 - a).toList() == [1, 0, -1, -2]
+    assert (a * 2).toList() == [0, 2, 4, 6]
+    assert (-a).toList() == [0, -1, -2, -3]
+    assert (a ** 2).toList() == [0, 1, 4, 9]
+    assert a.transpose().sum() == 6
+
+
+def test_from_array():
+    array = Array(float)([1, 2, 3])
+    a = NDArray(float).fromArray(array)
+
+    a[1, ] = 10
+    assert array[1] == 10
+
+
+def test_ndarray_from_compiled_code():
+    @Entrypoint
+    def normalizeRows(a: NDArray(float)):
+        rowSums = NDArray(float).zeros(ListOf(int)([a.shape[0], 1]))
+
+        for i in range(a.shape[0]):
+            rowSums[i, 0] = a[i].sum()
+
+        return a / rowSums
+
+    res = normalizeRows(arange(2, 2) + 1)
+
+    assert res.toList() == [1 / 3, 2 / 3, 3 / 7, 4 / 7]
@@ -0,0 +1,174 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A benchmark suite, for catching performance regressions between commits.
+
+Run it with 'make bench', or directly:
+
+    python -m typed_python.benchmarks --out results.json
+    python -m typed_python.benchmarks --filter dict --compare results.json
+
+Each benchmark (see suite.py) does some setup, and returns a function that
+does a fixed amount of work, and the number of items of work it does. We call
+the function once to warm up (which compiles anything it needs), then time
+'repeat' more calls, and report the best and median times and the throughput
+of the median. Results are written as JSON, keyed by benchmark name, along with
+the commit and machine they came from, so they can be kept and compared:
+'--compare' reports every benchmark whose median got slower by more than
+'--tolerance' relative to an earlier run.
+
+To add a benchmark, decorate a function of 'scale' in suite.py with
+'@benchmark(name, unit)'. 'scale' multiplies the amount of work, so the tests
+can run the whole suite quickly.
+"""
+
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+
+# name -> (unit, setupFunction), in the order they were defined
+_benchmarks = {}
+
+
+def benchmark(name, unit):
+    """Register a benchmark.
+
+    The decorated function takes a 'scale' and returns (run, items), where
+    'run()' does 'items' units of work.
+    """
+    def decorator(setup):
+        assert name not in _benchmarks, name
+        _benchmarks[name] = (unit, setup)
+        return setup
+
+    return decorator
+
+
+def benchmarkNames():
+    # importing the suite registers its benchmarks
+    import typed_python.benchmarks.suite  # noqa
+
+    return list(_benchmarks)
+
+
+def runBenchmark(name, repeat=5, scale=1.0):
+    """Run one benchmark, returning a dict that's ready to write as JSON."""
+    benchmarkNames()
+
+    unit, setup = _benchmarks[name]
+
+    run, items = setup(scale)
+
+    run()
+
+    seconds = []
+    for _ in range(repeat):
+        t0 = time.perf_counter()
+        run()
+        seconds.append(time.perf_counter() - t0)
+
+    median = statistics.median(seconds)
+
+    return dict(
+        unit=unit,
+        items=items,
+        seconds=seconds,
+        best=min(seconds),
+        median=median,
+        itemsPerSecond=items / median if median > 0 else None,
+    )
+
+
+def _currentCommit():
+    try:
+        return subprocess.check_output(
+            ["git", "rev-parse", "HEAD"],
+            cwd=os.path.dirname(os.path.abspath(__file__)),
+            stderr=subprocess.DEVNULL
+        ).decode("ascii").strip()
+    except Exception:
+        return None
+
+
+def runBenchmarks(filter=None, repeat=5, scale=1.0, log=None):
+    """Run every benchmark whose name contains 'filter' (or all of them).
+
+    Returns a dict, ready to write as JSON, holding the results under
+    'benchmarks' and a description of where they came from.
+    """
+    results = {}
+
+    for name in benchmarkNames():
+        if filter and filter not in name:
+            continue
+
+        results[name] = runBenchmark(name, repeat, scale)
+
+        if log:
+            log(formatResult(name, results[name]))
+
+    return dict(
+        commit=_currentCommit(),
+        timestamp=time.time(),
+        python=sys.version.split()[0],
+        platform=platform.platform(),
+        cpuCount=os.cpu_count(),
+        repeat=repeat,
+        scale=scale,
+        benchmarks=results,
+    )
+
+
+def formatResult(name, result):
+    rate = result['itemsPerSecond']
+
+    return "%-32s %10.4fs median %10.4fs best %14s %s/s" % (
+        name,
+        result['median'],
+        result['best'],
+        "%.4g" % rate if rate is not None else "-",
+        result['unit']
+    )
+
+
+def compareResults(baseline, current, tolerance=0.1):
+    """Compare two results from 'runBenchmarks'.
+
+    Returns a list of (name, baselineMedian, currentMedian, ratio) for the
+    benchmarks in both whose median time grew by more than 'tolerance', worst first.
+    """
+    regressions = []
+
+    for name, result in current['benchmarks'].items():
+        if name not in baseline['benchmarks']:
+            continue
+
+        old = baseline['benchmarks'][name]
+
+        if not old['items'] or not result['items']:
+            continue
+
+        # compare time per item, in case the two runs used different scales
+        oldTime = old['median'] / old['items']
+        newTime = result['median'] / result['items']
+
+        if oldTime > 0 and newTime > oldTime * (1 + tolerance):
+            regressions.append((name, old['median'], result['median'], newTime / oldTime))
+
+    return sorted(regressions, key=lambda r: -r[3])
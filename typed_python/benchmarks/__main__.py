@@ -0,0 +1,66 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import argparse
+import json
+import sys
+
+from typed_python.benchmarks import runBenchmarks, compareResults, benchmarkNames
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Run the typed_python benchmark suite.")
+    parser.add_argument("--out", help="write the results to this JSON file")
+    parser.add_argument("--compare", help="report regressions against the results in this JSON file")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="how much slower (as a fraction) a benchmark has to get to count as a regression")
+    parser.add_argument("--filter", help="only run benchmarks whose name contains this")
+    parser.add_argument("--repeat", type=int, default=5, help="timed runs of each benchmark")
+    parser.add_argument("--scale", type=float, default=1.0, help="multiply the work each benchmark does")
+    parser.add_argument("--list", action="store_true", help="list the benchmarks and exit")
+    parser.add_argument("--fail-on-regression", action="store_true",
+                        help="exit with status 1 if '--compare' finds a regression")
+    args = parser.parse_args(argv[1:])
+
+    if args.list:
+        for name in benchmarkNames():
+            print(name)
+        return 0
+
+    results = runBenchmarks(args.filter, args.repeat, args.scale, log=print)
+
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(results, f, indent=2)
+
+    if args.compare:
+        with open(args.compare, "r") as f:
+            baseline = json.load(f)
+
+        regressions = compareResults(baseline, results, args.tolerance)
+
+        print()
+        print(f"compared to {baseline.get('commit')}: {len(regressions)} regression(s)")
+
+        for name, oldMedian, newMedian, ratio in regressions:
+            print("%-32s %10.4fs -> %10.4fs (%.2fx)" % (name, oldMedian, newMedian, ratio))
+
+        if regressions and args.fail_on_regression:
+            return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
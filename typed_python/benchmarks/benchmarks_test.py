@@ -0,0 +1,45 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import json
+
+from typed_python.benchmarks import runBenchmarks, compareResults, benchmarkNames
+
+
+def test_every_benchmark_runs_and_results_are_json():
+    results = runBenchmarks(repeat=1, scale=0.001)
+
+    assert set(results['benchmarks']) == set(benchmarkNames())
+
+    for name in ['dict_lookup', 'str_split', 'serialize', 'entrypoint_call', 'pmap_1_threads', 'compile_latency']:
+        result = results['benchmarks'][name]
+        assert result['items'] > 0
+        assert len(result['seconds']) == 1
+
+    assert json.loads(json.dumps(results)) == results
+
+
+def test_compare_results_finds_regressions():
+    def results(**medians):
+        return dict(benchmarks={
+            name: dict(median=median, items=100) for name, median in medians.items()
+        })
+
+    regressions = compareResults(
+        results(a=1.0, b=1.0, c=1.0),
+        results(a=1.05, b=2.0, c=0.5, d=10.0),
+        tolerance=0.1
+    )
+
+    assert [(name, ratio) for name, _, _, ratio in regressions] == [('b', 2.0)]
@@ -0,0 +1,294 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""The benchmarks run by 'python -m typed_python.benchmarks'. See __init__.py."""
+
+import os
+
+from typed_python import (
+    Entrypoint, ListOf, Dict, Set, NamedTuple, serialize, deserialize, deepcopyContiguous
+)
+from typed_python.benchmarks import benchmark
+from typed_python.lib.thread_pool import ThreadPool
+
+
+def _count(n, scale):
+    return max(1, int(n * scale))
+
+
+def _keys(count):
+    # spread the keys out so they don't land in consecutive buckets
+    return ListOf(int)([(i * 2654435761) % (2 ** 40) for i in range(count)])
+
+
+@Entrypoint
+def _dictInsert(keys: ListOf(int)) -> Dict(int, int):
+    res = Dict(int, int)()
+    for k in keys:
+        res[k] = k
+    return res
+
+
+@Entrypoint
+def _dictLookup(d: Dict(int, int), keys: ListOf(int)) -> int:
+    res = 0
+    for k in keys:
+        res += d.get(k, 0)
+    return res
+
+
+@Entrypoint
+def _strDictLookup(d: Dict(str, int), keys: ListOf(str)) -> int:
+    res = 0
+    for k in keys:
+        res += d.get(k, 0)
+    return res
+
+
+@Entrypoint
+def _setInsert(keys: ListOf(int)) -> Set(int):
+    res = Set(int)()
+    for k in keys:
+        res.add(k)
+    return res
+
+
+@Entrypoint
+def _setLookup(s: Set(int), keys: ListOf(int)) -> int:
+    res = 0
+    for k in keys:
+        if k in s:
+            res += 1
+    return res
+
+
+@benchmark("dict_insert", "inserts")
+def dictInsert(scale):
+    keys = _keys(_count(1000000, scale))
+    return lambda: _dictInsert(keys), len(keys)
+
+
+@benchmark("dict_lookup", "lookups")
+def dictLookup(scale):
+    keys = _keys(_count(1000000, scale))
+    d = _dictInsert(keys)
+    return lambda: _dictLookup(d, keys), len(keys)
+
+
+@benchmark("dict_str_lookup", "lookups")
+def dictStrLookup(scale):
+    keys = ListOf(str)(["key_" + str(k) for k in _keys(_count(200000, scale))])
+    d = Dict(str, int)({k: i for i, k in enumerate(keys)})
+    return lambda: _strDictLookup(d, keys), len(keys)
+
+
+@benchmark("set_insert", "inserts")
+def setInsert(scale):
+    keys = _keys(_count(1000000, scale))
+    return lambda: _setInsert(keys), len(keys)
+
+
+@benchmark("set_lookup", "lookups")
+def setLookup(scale):
+    keys = _keys(_count(1000000, scale))
+    s = _setInsert(keys)
+    return lambda: _setLookup(s, keys), len(keys)
+
+
+@Entrypoint
+def _listAppend(count: int) -> ListOf(float):
+    res = ListOf(float)()
+    for i in range(count):
+        res.append(i)
+    return res
+
+
+@Entrypoint
+def _listSum(values: ListOf(float)) -> float:
+    res = 0.0
+    for v in values:
+        res += v
+    return res
+
+
+@benchmark("list_append", "appends")
+def listAppend(scale):
+    count = _count(10000000, scale)
+    return lambda: _listAppend(count), count
+
+
+@benchmark("list_iterate", "elements")
+def listIterate(scale):
+    values = _listAppend(_count(10000000, scale))
+    return lambda: _listSum(values), len(values)
+
+
+def _text(scale):
+    return " ".join("word%d" % (i % 1000) for i in range(_count(1000000, scale)))
+
+
+@Entrypoint
+def _strFindAll(s: str, needle: str) -> int:
+    res = 0
+    pos = s.find(needle)
+    while pos >= 0:
+        res += 1
+        pos = s.find(needle, pos + 1)
+    return res
+
+
+@Entrypoint
+def _strSplit(s: str) -> ListOf(str):
+    return s.split(" ")
+
+
+@Entrypoint
+def _strJoin(parts: ListOf(str)) -> str:
+    return " ".join(parts)
+
+
+@benchmark("str_find", "bytes")
+def strFind(scale):
+    s = _text(scale)
+    return lambda: _strFindAll(s, "word999 "), len(s)
+
+
+@benchmark("str_split", "bytes")
+def strSplit(scale):
+    s = _text(scale)
+    return lambda: _strSplit(s), len(s)
+
+
+@benchmark("str_join", "bytes")
+def strJoin(scale):
+    s = _text(scale)
+    parts = _strSplit(s)
+    return lambda: _strJoin(parts), len(s)
+
+
+Row = NamedTuple(id=int, price=float, name=str, tags=ListOf(str))
+
+
+def _rows(scale):
+    return ListOf(Row)([
+        Row(id=i, price=i * 0.5, name="row%d" % i, tags=["a", "b%d" % (i % 10)])
+        for i in range(_count(200000, scale))
+    ])
+
+
+@benchmark("serialize", "bytes")
+def serializeRows(scale):
+    rows = _rows(scale)
+    return lambda: serialize(ListOf(Row), rows), len(serialize(ListOf(Row), rows))
+
+
+@benchmark("deserialize", "bytes")
+def deserializeRows(scale):
+    data = serialize(ListOf(Row), _rows(scale))
+    return lambda: deserialize(ListOf(Row), data), len(data)
+
+
+@benchmark("deepcopy_contiguous", "rows")
+def deepcopyRows(scale):
+    rows = _rows(scale)
+    return lambda: deepcopyContiguous(rows), len(rows)
+
+
+@Entrypoint
+def _addOne(x: int) -> int:
+    return x + 1
+
+
+@benchmark("entrypoint_call", "calls")
+def entrypointCall(scale):
+    count = _count(200000, scale)
+
+    def run():
+        for i in range(count):
+            _addOne(i)
+
+    return run, count
+
+
+@Entrypoint
+def _sumSquaresSlice(out: ListOf(float), i: int, perItem: int) -> None:
+    res = 0.0
+    for j in range(i * perItem, (i + 1) * perItem):
+        res += float(j) * float(j)
+    out[i] = res
+
+
+_pools = {}
+
+
+def _pool(threadCount):
+    # pools can't be shut down, so share them between repeats and runs
+    if threadCount not in _pools:
+        _pools[threadCount] = ThreadPool(threadCount)
+    return _pools[threadCount]
+
+
+def _pmapScaling(threadCount):
+    def setup(scale):
+        items = 1024
+        perItem = _count(20000, scale)
+        out = ListOf(float)()
+        out.resize(items)
+        pool = _pool(threadCount)
+
+        def run():
+            pool.parallel_for(items, lambda i: _sumSquaresSlice(out, i, perItem))
+
+        return run, items * perItem
+
+    return setup
+
+
+_threadCounts = [1]
+while _threadCounts[-1] * 2 <= (os.cpu_count() or 1):
+    _threadCounts.append(_threadCounts[-1] * 2)
+
+for _threadCount in _threadCounts:
+    benchmark("pmap_%d_threads" % _threadCount, "elements")(_pmapScaling(_threadCount))
+
+
+_compiledFunctionCount = [0]
+
+
+@benchmark("compile_latency", "functions")
+def compileLatency(scale):
+    count = _count(5, scale)
+
+    def run():
+        for _ in range(count):
+            # a new constant makes a new function, so neither the in-memory
+            # nor the on-disk compiler cache can help us.
+            _compiledFunctionCount[0] += 1
+
+            namespace = {'Entrypoint': Entrypoint, 'ListOf': ListOf, 'Dict': Dict}
+
+            exec(
+                "@Entrypoint\n"
+                "def f(x: ListOf(int)) -> Dict(int, int):\n"
+                "    res = Dict(int, int)()\n"
+                "    for v in x:\n"
+                "        if v %% 3 == 0:\n"
+                "            res[v] = res.get(v, 0) + %d\n"
+                "    return res\n" % _compiledFunctionCount[0],
+                namespace
+            )
+
+            namespace['f'](ListOf(int)([1, 2, 3]))
+
+    return run, count
@@ -0,0 +1,64 @@
+"""Per-function opt-ins that trade python's arithmetic semantics for speed.
+
+By default compiled code does float arithmetic exactly the way the interpreter
+would (no reassociation, NaNs and signed zeros respected), which keeps llvm from
+vectorizing reductions like 'res += x[i] * y[i]'. And although compiled ints wrap
+on overflow, llvm can't assume they don't, which blocks it from widening loop
+counters and reasoning about address arithmetic.
+
+A numeric kernel whose ranges the user has checked can opt out of either one with
+
+    @Entrypoint(fastMath=True, assumeNoIntOverflow=True)
+    def dot(x: ListOf(float), y: ListOf(float)):
+        ...
+
+'fastMath' lets llvm treat float +, -, * and / as real-number arithmetic (llvm's
+'fast' flag): it may reassociate, and it may assume no NaNs or infinities reach
+them. 'assumeNoIntOverflow' marks signed int +, - and * 'nsw', so overflowing
+produces an undefined value rather than a wrapped one. Python-level errors like
+ZeroDivisionError are still raised either way.
+
+The options belong to the function's code object, so they apply to every
+specialization of it, to the functions and lambdas defined inside it, and to its
+comprehensions. They don't spread to the functions it calls.
+"""
+
+from typed_python import NamedTuple
+
+ArithmeticOptions = NamedTuple(fastMath=bool, assumeNoIntOverflow=bool)
+
+DEFAULT_OPTIONS = ArithmeticOptions()
+
+# code object -> ArithmeticOptions, for every function that opted in
+_optionsByCode = {}
+
+
+def setArithmeticOptions(code, options):
+    """Make functions with code object 'code' (and those nested inside it) compile with 'options'."""
+    _optionsByCode[code] = options
+
+    for const in code.co_consts:
+        if isinstance(const, type(code)):
+            setArithmeticOptions(const, options)
+
+
+def arithmeticOptionsFor(code):
+    """Return the ArithmeticOptions functions with code object 'code' compile with."""
+    return _optionsByCode.get(code, DEFAULT_OPTIONS)
+
+
+def llvmFlagsFor(options, isFloat, isSignedInt):
+    """Return the llvm flags to put on an arithmetic instruction under 'options'.
+
+    Args:
+        options - an ArithmeticOptions
+        isFloat - True if the instruction operates on floats
+        isSignedInt - True if the instruction operates on signed ints
+    """
+    if isFloat and options.fastMath:
+        return ('fast',)
+
+    if isSignedInt and options.assumeNoIntOverflow:
+        return ('nsw',)
+
+    return ()
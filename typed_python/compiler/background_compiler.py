@@ -0,0 +1,125 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import logging
+import queue
+import threading
+
+from typed_python.compiler.value_specialization import specializedArguments
+
+
+class BackgroundCompiler:
+    """Compiles new specializations on a background thread while callers run in the interpreter.
+
+    Normally, a call to an Entrypoint that needs a specialization we haven't compiled yet
+    blocks until the compiler has produced it, which can take seconds. When the runtime
+    has a BackgroundCompiler, 'compileFunctionOverload' asks it to 'defer' such calls
+    instead. We pick the specialization's argument types, queue it up for our thread,
+    and tell the caller to run the plain python implementation (or whichever existing
+    specialization the arguments can convert to). Once the compiled specialization is
+    installed, dispatch picks it up on its own.
+
+    We never wait for the runtime lock on the caller's thread: if someone holds it
+    (usually our own thread, compiling), the call runs in the interpreter and we'll
+    try to queue it again the next time it's made.
+    """
+    def __init__(self, runtime):
+        self.runtime = runtime
+
+        self._queue = queue.Queue()
+        self._thread = None
+        self._threadLock = threading.Lock()
+
+        # (functionType, overloadIx, argument wrappers) for everything we've queued
+        self._requested = set()
+
+        self.specializationsCompiled = 0
+
+    def defer(self, functionType, overloadIx, arguments):
+        """Queue up a compile of 'functionType.overloads[overloadIx]' for 'arguments'.
+
+        Returns:
+            True if the caller should run in the interpreter, or False if it should
+            compile synchronously, as it would without us. We say False if the calling
+            thread is already inside the compiler, or if the arguments can't match
+            the overload at all.
+        """
+        if not self.runtime.lock.acquire(blocking=False):
+            return True
+
+        try:
+            if self.runtime.converter.isCurrentlyConverting():
+                return False
+
+            overload = functionType.overloads[overloadIx]
+
+            specialized = specializedArguments(overload.functionCode)
+
+            inputWrappers = [
+                self.runtime.pickSpecializationTypeFor(
+                    overload.args[i], arguments[i], specializeOnValue=overload.args[i].name in specialized
+                )
+                for i in range(len(arguments))
+            ]
+
+            if any(x is None for x in inputWrappers):
+                return False
+
+            key = (functionType, overloadIx, tuple(inputWrappers))
+
+            if key not in self._requested:
+                self._requested.add(key)
+                self._ensureThread()
+                self._queue.put((functionType, overloadIx, inputWrappers))
+
+            return True
+        finally:
+            self.runtime.lock.release()
+
+    def waitUntilIdle(self):
+        """Block until we've compiled everything queued so far."""
+        self._queue.join()
+
+    def resetAfterFork(self):
+        """Forget our thread and queue in a forked child, which has neither.
+
+        Whatever the parent queued but hadn't compiled gets queued again the
+        next time the child calls it.
+        """
+        self._queue = queue.Queue()
+        self._thread = None
+        self._threadLock = threading.Lock()
+        self._requested = set()
+
+    def _ensureThread(self):
+        with self._threadLock:
+            if self._thread is None:
+                self._thread = threading.Thread(target=self._run, name="typed_python compiler", daemon=True)
+                self._thread.start()
+
+    def _run(self):
+        while True:
+            functionType, overloadIx, inputWrappers = self._queue.get()
+
+            try:
+                self.runtime.compileFunctionOverload(
+                    functionType, overloadIx, inputWrappers, argumentsAreTypes=True
+                )
+                self.specializationsCompiled += 1
+            except Exception:
+                # callers keep running in the interpreter, which will raise whatever
+                # real error the code has.
+                logging.exception("Failed to compile %s in the background", functionType)
+            finally:
+                self._queue.task_done()
@@ -22,6 +22,7 @@ import struct
 
 from typed_python.compiler.native_function_pointer import NativeFunctionPointer
 from typed_python.compiler.loaded_module import LoadedModule
+import typed_python.compiler.perf_map as perf_map
 from typed_python.hash import sha_hash
 
 
@@ -36,15 +37,38 @@ class LoadedBinarySharedObject(LoadedModule):
 class BinarySharedObject:
     """Models a shared object library (.so) loadable on linux systems."""
 
-    def __init__(self, binaryForm, functionTypes, globalVariableDefinitions):
+    # the llvm features of the cpu we're running on, once we've asked for them
+    _hostFeatures = None
+
+    def __init__(
+        self,
+        binaryForm,
+        functionTypes,
+        globalVariableDefinitions,
+        variants=None,
+        objectForm=None,
+        partGlobalVariableDefinitions=None
+    ):
         """
         Args:
             binaryForm - a bytes object containing the actual compiled code for the module
             globalVariableDefinitions - a map from name to GlobalVariableDefinition
+            variants - a dict from an llvm feature string (like '+avx2,+fma') to the
+                bytes of a copy of the module compiled to use those features. It
+                defines the same symbols and globals as 'binaryForm'.
+            objectForm - if not None, the bytes of the '.o' file we linked 'binaryForm'
+                from, which lets us relink it with other modules later.
+            partGlobalVariableDefinitions - if not None, this shared object was linked
+                from several modules, each of which has its own globals and its own
+                accessor for them. This maps the name of each accessor to the globals
+                it fills out, and there's no accessor named GET_GLOBAL_VARIABLES_NAME.
         """
         self.binaryForm = binaryForm
         self.functionTypes = functionTypes
         self.globalVariableDefinitions = globalVariableDefinitions
+        self.variants = dict(variants or {})
+        self.objectForm = objectForm
+        self.partGlobalVariableDefinitions = partGlobalVariableDefinitions
         self.hash = sha_hash(binaryForm)
 
     @property
@@ -52,35 +76,109 @@ class BinarySharedObject:
         return self.functionTypes.keys()
 
     @staticmethod
-    def fromDisk(path, globalVariableDefinitions, functionNameToType):
+    def fromDisk(path, globalVariableDefinitions, functionNameToType, partGlobalVariableDefinitions=None):
         with open(path, "rb") as f:
             binaryForm = f.read()
 
-        return BinarySharedObject(binaryForm, functionNameToType, globalVariableDefinitions)
+        return BinarySharedObject(
+            binaryForm,
+            functionNameToType,
+            globalVariableDefinitions,
+            partGlobalVariableDefinitions=partGlobalVariableDefinitions
+        )
 
     @staticmethod
-    def fromModule(module, globalVariableDefinitions, functionNameToType):
-        target_triple = llvm.get_process_triple()
-        target = llvm.Target.from_triple(target_triple)
-        target_machine_shared_object = target.create_target_machine(reloc='pic', codemodel='default')
+    def fromModule(module, globalVariableDefinitions, functionNameToType, targetMachine=None, variantObjects=None):
+        """Build a BinarySharedObject from an llvm module.
+
+        Args:
+            module - the llvm module to generate code for
+            globalVariableDefinitions - a map from name to GlobalVariableDefinition
+            functionNameToType - a map from name to native function type
+            targetMachine - the llvm TargetMachine to generate code with. It must use
+                'pic' relocation. By default we target the generic cpu.
+            variantObjects - a dict from llvm feature string to the contents of an
+                object file holding a copy of 'module' compiled to use those features.
+        """
+        if targetMachine is None:
+            target_triple = llvm.get_process_triple()
+            target = llvm.Target.from_triple(target_triple)
+            targetMachine = target.create_target_machine(reloc='pic', codemodel='default')
 
         # returns the contents of a '.o' file coming out of a c++ compiler like clang
-        o_file_contents = target_machine_shared_object.emit_object(module)
+        o_file_contents = targetMachine.emit_object(module)
+
+        return BinarySharedObject(
+            BinarySharedObject.linkObjectFile(o_file_contents),
+            functionNameToType,
+            globalVariableDefinitions,
+            {
+                features: BinarySharedObject.linkObjectFile(contents)
+                for features, contents in (variantObjects or {}).items()
+            },
+            objectForm=o_file_contents
+        )
+
+    @staticmethod
+    def linkObjectFile(o_file_contents):
+        """Link the contents of a '.o' file into a shared object and return its bytes."""
+        return BinarySharedObject.linkObjectFiles([o_file_contents])
+
+    @staticmethod
+    def linkObjectFiles(o_files_contents, symbolRenames=None):
+        """Link the contents of several '.o' files into one shared object and return its bytes.
+
+        Functions that the compiler repeated into several modules are defined in more
+        than one of the objects. Their definitions are identical, so we let the linker
+        keep the first one.
+
+        Args:
+            o_files_contents - a list of bytes, one per object file
+            symbolRenames - if not None, a list with one dict per object file, from the
+                names of symbols it defines to the names they should have once linked
+        """
 
         # we have to run it through 'ld' to link it. if we want to support windows,
         # we should use 'llvm' directly instead of 'llmvlite', in which case this
         # kind of linking operation would be easier to express directly without
         # resorting to subprocesses.
         with tempfile.TemporaryDirectory() as tf:
-            with open(os.path.join(tf, "module.o"), "wb") as o_file:
-                o_file.write(o_file_contents)
+            o_paths = []
+
+            for i, o_file_contents in enumerate(o_files_contents):
+                o_paths.append(os.path.join(tf, f"module_{i}.o"))
+
+                with open(o_paths[-1], "wb") as o_file:
+                    o_file.write(o_file_contents)
+
+                if symbolRenames and symbolRenames[i]:
+                    subprocess.check_call(
+                        ["objcopy"]
+                        + [f"--redefine-sym={old}={new}" for old, new in symbolRenames[i].items()]
+                        + [o_paths[-1]]
+                    )
 
             subprocess.check_call(
-                ["g++", "-shared", "-shared-libgcc", "-fPIC", os.path.join(tf, "module.o"), "-o", os.path.join(tf, "module.so")]
+                ["g++", "-shared", "-shared-libgcc", "-fPIC"]
+                + (["-Wl,--allow-multiple-definition"] if len(o_paths) > 1 else [])
+                + o_paths
+                + ["-o", os.path.join(tf, "module.so")]
             )
 
             with open(os.path.join(tf, "module.so"), "rb") as so_file:
-                return BinarySharedObject(so_file.read(), functionNameToType, globalVariableDefinitions)
+                return so_file.read()
+
+    @staticmethod
+    def hostSupportsFeatures(features):
+        """Can this machine run code compiled with the llvm feature string 'features'?"""
+        if BinarySharedObject._hostFeatures is None:
+            BinarySharedObject._hostFeatures = dict(llvm.get_host_cpu_features())
+
+        for feature in features.split(","):
+            if feature.startswith("+") and not BinarySharedObject._hostFeatures.get(feature[1:], False):
+                return False
+
+        return True
 
     def load(self, storageDir):
         """Instantiate this .so in temporary storage and return a dict from symbol -> integer function pointer"""
@@ -123,12 +221,29 @@ class BinarySharedObject:
                 self.functionTypes[symbol].output,
             )
 
+        if perf_map.perfMapEnabled():
+            with open(modulePath, "rb") as f:
+                functionSizes = perf_map.functionSizesInElf(f.read())
+
+            perf_map.recordFunctions(
+                {symbol: fp.fp for symbol, fp in functionPointers.items()},
+                functionSizes
+            )
+
         loadedModule = LoadedBinarySharedObject(
             self,
             modulePath,
             functionPointers,
             self.globalVariableDefinitions
         )
-        loadedModule.linkGlobalVariables()
+
+        if self.partGlobalVariableDefinitions is None:
+            loadedModule.linkGlobalVariables()
+        else:
+            for accessorName, globalVariableDefinitions in self.partGlobalVariableDefinitions.items():
+                LoadedModule(
+                    {LoadedModule.GET_GLOBAL_VARIABLES_NAME: functionPointers[accessorName]},
+                    globalVariableDefinitions
+                ).linkGlobalVariables()
 
         return loadedModule
@@ -0,0 +1,174 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import hashlib
+import os
+import sys
+import uuid
+
+from typed_python import _types
+from typed_python.SerializationContext import SerializationContext
+
+
+# the name of the directory inside the compiler cache where we keep our files.
+# It's not 40 characters long, so the CompilerCache won't mistake it for a module.
+CLASS_DISPATCH_DIR = "class_dispatches"
+
+
+class ClassDispatchCache:
+    """A persistent record of the class dispatches and destructors processes needed.
+
+    Compiled code calls a method of a Class it only knows as one of its bases
+    through a dispatch table, and the entries of that table (and the destructors
+    of Classes held as a base) get compiled the first time a call needs them.
+    Even when the compiler cache holds the code, that's a conversion and a module
+    load in the middle of whatever loop made the call.
+
+    So every time we compile one, we record it here, and a later process can
+    install the ones it's likely to need all at once (see
+    Runtime.prefillClassDispatches). We name classes by module and qualname, and
+    only ever look them up in modules that are already imported. A record whose
+    class no longer has the identity hash it had when we wrote it is skipped.
+
+    Each record gets its own file, named by a hash of its contents, which we write
+    under a tempname and then rename, as NativeAstCache does.
+    """
+    def __init__(self, cacheDir):
+        self.cacheDir = os.path.join(cacheDir, CLASS_DISPATCH_DIR)
+
+        if not os.path.exists(self.cacheDir):
+            try:
+                os.makedirs(self.cacheDir)
+            except IOError:
+                pass
+
+        # the records we've read or written, as a dict from file name to record
+        self._records = None
+
+    @staticmethod
+    def _className(cls):
+        return (cls.__module__, cls.__qualname__, _types.identityHash(cls))
+
+    def recordDispatch(self, interfaceClass, implementingClass, methodName, retType, argTupleType, kwargTupleType):
+        try:
+            signature = SerializationContext().serialize((retType, argTupleType, kwargTupleType))
+        except Exception:
+            return
+
+        self._write(
+            ("dispatch", self._className(interfaceClass), self._className(implementingClass), methodName, signature)
+        )
+
+    def recordDestructor(self, cls):
+        self._write(("destructor", None, self._className(cls), None, None))
+
+    def _write(self, record):
+        data = SerializationContext().serialize(record)
+        fileName = hashlib.sha1(data).hexdigest() + ".dat"
+
+        records = self._readAll()
+
+        if fileName in records:
+            return
+
+        records[fileName] = record
+
+        path = os.path.join(self.cacheDir, fileName)
+        tempPath = path + "_" + str(uuid.uuid4())
+
+        try:
+            with open(tempPath, "wb") as f:
+                f.write(data)
+
+            os.rename(tempPath, path)
+        except IOError:
+            if os.path.exists(tempPath):
+                os.remove(tempPath)
+
+    def _readAll(self):
+        if self._records is None:
+            self._records = {}
+
+            try:
+                fileNames = os.listdir(self.cacheDir)
+            except IOError:
+                fileNames = []
+
+            for fileName in fileNames:
+                if not fileName.endswith(".dat"):
+                    continue
+
+                try:
+                    with open(os.path.join(self.cacheDir, fileName), "rb") as f:
+                        self._records[fileName] = SerializationContext().deserialize(f.read())
+                except Exception:
+                    pass
+
+        return self._records
+
+    @staticmethod
+    def _lookupClass(name):
+        moduleName, qualname, identity = name
+
+        obj = sys.modules.get(moduleName)
+
+        for part in qualname.split("."):
+            if obj is None:
+                return None
+
+            obj = getattr(obj, part, None)
+
+        if getattr(obj, "__typed_python_category__", None) != "Class":
+            return None
+
+        if _types.identityHash(obj) != identity:
+            return None
+
+        return obj
+
+    def dispatches(self, implementingClass=None):
+        """Yield (interfaceClass, implementingClass, methodName, retType, argTupleType, kwargTupleType).
+
+        We only yield records whose classes we can find as they were, and if
+        'implementingClass' is given, only the ones for it.
+        """
+        for kind, interfaceName, implementingName, methodName, signature in list(self._readAll().values()):
+            if kind != "dispatch":
+                continue
+
+            implementing = self._lookupClass(implementingName)
+
+            if implementing is None or (implementingClass is not None and implementing is not implementingClass):
+                continue
+
+            interface = self._lookupClass(interfaceName)
+
+            if interface is None:
+                continue
+
+            try:
+                retType, argTupleType, kwargTupleType = SerializationContext().deserialize(signature)
+            except Exception:
+                continue
+
+            yield interface, implementing, methodName, retType, argTupleType, kwargTupleType
+
+    def destructors(self):
+        """Yield each Class whose destructor we recorded that we can find as it was."""
+        for kind, _, className, _, _ in list(self._readAll().values()):
+            if kind == "destructor":
+                cls = self._lookupClass(className)
+
+                if cls is not None:
+                    yield cls
@@ -0,0 +1,374 @@
+"""Replace short-lived Class instances with one local variable per member.
+
+A function like
+
+    def f(n):
+        res = 0.0
+        for i in range(n):
+            p = Point(x=i, y=i * 2)
+            res += p.x * p.y
+        return res
+
+allocates, refcounts, and frees a 'Point' on every pass through the loop,
+even though nothing outside the loop body ever sees it. If we can see that
+'p' is only ever used to read and write its data members, we can rewrite the
+function as
+
+    def f(n):
+        res = 0.0
+        for i in range(n):
+            .p.x = <convert to Point.x's type>(i)
+            .p.y = <convert to Point.y's type>(i * 2)
+            res += .p.x * .p.y
+        return res
+
+which never touches the heap and which llvm can keep in registers.
+
+We only do this for constructions of the form 'x = C(member=value, ...)' where
+'C' is a Class with no '__init__' (so construction is just member
+initialization) and no attribute hooks, 'x' is assigned exactly once, and
+every other mention of 'x' reads or assigns a data member in the statements
+that follow the construction in the same block. Anything else - passing 'x'
+to a function, returning it, calling a method on it, capturing it in a
+closure - counts as an escape and leaves the function alone.
+"""
+
+import typed_python.python_ast as python_ast
+from typed_python import _types
+from typed_python.compiler.conversion_level import ConversionLevel
+from typed_python.compiler.python_ast_analysis import visitPyAstChildren, computeVariablesAssignmentCounts, nodeTypes
+from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
+import typed_python.compiler
+
+# if a Class defines any of these, constructing it or touching its members can run user code.
+_ATTRIBUTE_HOOKS = ('__init__', '__getattr__', '__setattr__', '__delattr__', '__del__')
+
+
+class InitializeClassMember(CompilableBuiltin):
+    """Produce a value for a member of a Class the way the Class itself would.
+
+    Called with one argument, convert it to the member's type the way assigning
+    to the member would. Called with none, produce the member's initial value
+    the way the Class constructor would.
+    """
+    def __init__(self, classType, memberName):
+        super().__init__()
+
+        self.classType = classType
+        self.memberName = memberName
+        self.memberType = classType.MemberTypes[classType.MemberNames.index(memberName)]
+
+    def __eq__(self, other):
+        if not isinstance(other, InitializeClassMember):
+            return False
+
+        return self.classType is other.classType and self.memberName == other.memberName
+
+    def __hash__(self):
+        return hash((InitializeClassMember, self.classType, self.memberName))
+
+    def __str__(self):
+        return f"InitializeClassMember({self.classType.__qualname__}.{self.memberName})"
+
+    def convert_call(self, context, instance, args, kwargs):
+        if kwargs or len(args) > 1:
+            return super().convert_call(context, instance, args, kwargs)
+
+        if args:
+            return args[0].convert_to_type(self.memberType, ConversionLevel.ImplicitContainers)
+
+        if self.memberName in self.classType.MemberDefaultValues:
+            defaultValue = typed_python.compiler.python_object_representation.pythonObjectRepresentation(
+                context,
+                self.classType.MemberDefaultValues[self.memberName]
+            )
+
+            return context.push(self.memberType, lambda ref: ref.convert_copy_initialize(defaultValue))
+
+        return context.push(self.memberType, lambda ref: ref.convert_default_initialize())
+
+
+def classDataMembers(classType):
+    """Return the names of the members of 'classType' that attribute access reads directly."""
+    return set(
+        name for name in classType.MemberNames
+        if name not in classType.MemberFunctions
+        and name not in classType.ClassMemberFunctions
+        and name not in classType.StaticMemberFunctions
+        and name not in classType.PropertyFunctions
+    )
+
+
+def matchClassConstruction(s, lookupClass):
+    """If 's' is 'x = C(member=value, ...)' and we could replace 'x' by its members, return (x, C).
+
+    Args:
+        s - a python_ast.Statement
+        lookupClass - a function from a name to the Class it refers to, or None
+    """
+    if not s.matches.Assign or len(s.targets) != 1 or not s.targets[0].matches.Name:
+        return None
+
+    call = s.value
+
+    if not call.matches.Call or call.args or not call.func.matches.Name:
+        return None
+
+    classType = lookupClass(call.func.id)
+
+    if getattr(classType, '__typed_python_category__', None) != 'Class':
+        return None
+
+    if any(hook in classType.MemberFunctions for hook in _ATTRIBUTE_HOOKS):
+        return None
+
+    dataMembers = classDataMembers(classType)
+    passed = [kw.arg for kw in call.keywords]
+
+    if any(name is None or name not in dataMembers for name in passed) or len(set(passed)) != len(passed):
+        return None
+
+    # every member has to start out initialized, or reading it could throw an AttributeError
+    for name, memberType in zip(classType.MemberNames, classType.MemberTypes):
+        if name not in passed and not (
+            _types.wantsToDefaultConstruct(memberType) or classType.ClassMembers[name].isNonempty
+        ):
+            return None
+
+    return s.targets[0].id, classType
+
+
+def _isNestedScope(node):
+    if isinstance(node, python_ast.Statement):
+        return node.matches.FunctionDef or node.matches.AsyncFunctionDef or node.matches.ClassDef
+
+    if isinstance(node, python_ast.Expr):
+        return (
+            node.matches.Lambda or node.matches.ListComp or node.matches.SetComp
+            or node.matches.DictComp or node.matches.GeneratorExp
+        )
+
+    return False
+
+
+def _isMemberOf(e, varname, dataMembers):
+    return e.matches.Attribute and e.value.matches.Name and e.value.id == varname and e.attr in dataMembers
+
+
+def _countMentions(node, varname):
+    """Count every place 'varname' could be read or bound in 'node', including in nested scopes."""
+    count = [0]
+
+    def visit(x):
+        if isinstance(x, python_ast.Expr) and x.matches.Name and x.id == varname:
+            count[0] += 1
+        elif isinstance(x, python_ast.Arg) and x.arg == varname:
+            count[0] += 1
+        elif isinstance(x, python_ast.ExceptionHandler) and x.name == varname:
+            count[0] += 1
+        elif isinstance(x, python_ast.Statement) and (x.matches.Global or x.matches.NonLocal) and varname in x.names:
+            count[0] += 1
+
+        return True
+
+    visitPyAstChildren(node, visit)
+
+    return count[0]
+
+
+def _countMemberAccesses(statements, varname, classType, canAugAssign):
+    """Count the mentions of 'varname' in 'statements' that only touch a data member.
+
+    Returns None if we see a use we can't rewrite. Mentions inside nested scopes
+    aren't counted, so they make the totals disagree with '_countMentions'.
+    """
+    dataMembers = classDataMembers(classType)
+    count = [0]
+    ok = [True]
+
+    def memberType(name):
+        return classType.MemberTypes[classType.MemberNames.index(name)]
+
+    def visit(x):
+        if _isNestedScope(x):
+            return False
+
+        if isinstance(x, python_ast.Statement):
+            if x.matches.Assign and len(x.targets) == 1 and _isMemberOf(x.targets[0], varname, dataMembers):
+                count[0] += 1
+                visitPyAstChildren(x.value, visit)
+                return False
+
+            if x.matches.AugAssign and _isMemberOf(x.target, varname, dataMembers):
+                if not canAugAssign(memberType(x.target.attr)):
+                    ok[0] = False
+                count[0] += 1
+                visitPyAstChildren(x.value, visit)
+                return False
+
+        if isinstance(x, python_ast.Expr) and _isMemberOf(x, varname, dataMembers) and x.ctx.matches.Load:
+            count[0] += 1
+            return False
+
+        return True
+
+    visitPyAstChildren(statements, visit)
+
+    return count[0] if ok[0] else None
+
+
+def _statementLists(statements):
+    """Yield every list of statements in 'statements' that runs in the current scope, including itself."""
+    yield statements
+
+    for s in statements:
+        if _isNestedScope(s):
+            continue
+
+        for name in ('body', 'orelse', 'finalbody'):
+            if name in s.ElementType.ElementNames:
+                yield from _statementLists(getattr(s, name))
+
+        if s.matches.Try:
+            for handler in s.handlers:
+                yield from _statementLists(handler.body)
+
+
+def findScalarReplaceableInstances(statements, lookupClass, canReplaceVariable, canAugAssign):
+    """Find the Class instances in a function body that never escape it.
+
+    Args:
+        statements - the body of the function, as a list of python_ast.Statement
+        lookupClass - a function from a name to the Class it refers to, or None
+        canReplaceVariable - a function from a variable name to True if it's a plain
+            local (not an argument, and not read by a closure)
+        canAugAssign - a function from a member type to True if 'x.m += v' means the
+            same thing as 'x.m = x.m + v' for members of that type
+
+    Returns:
+        a dict from variable name to the Class it holds.
+    """
+    assignmentCounts = computeVariablesAssignmentCounts(statements)
+
+    res = {}
+
+    for block in _statementLists(statements):
+        for i in range(len(block)):
+            match = matchClassConstruction(block[i], lookupClass)
+
+            if match is None:
+                continue
+
+            varname, classType = match
+
+            if assignmentCounts.get(varname) != 1 or not canReplaceVariable(varname):
+                continue
+
+            # the only mentions of 'varname' are the construction, and member accesses after it
+            memberAccesses = _countMemberAccesses(block[i + 1:], varname, classType, canAugAssign)
+
+            if memberAccesses is not None and memberAccesses + 1 == _countMentions(statements, varname):
+                res[varname] = classType
+
+    return res
+
+
+def memberVarname(varname, memberName):
+    return f".{varname}.{memberName}"
+
+
+def scalarReplaceInstances(statements, replacements):
+    """Rewrite 'statements', replacing each variable in 'replacements' with its members.
+
+    Args:
+        statements - a list of python_ast.Statement
+        replacements - the result of 'findScalarReplaceableInstances'
+
+    Returns:
+        a new list of python_ast.Statement
+    """
+    def at(node, **kwargs):
+        return dict(line_number=node.line_number, col_offset=node.col_offset, filename=node.filename, **kwargs)
+
+    def initializeMember(node, varname, memberName, *args):
+        classType = replacements[varname]
+
+        return python_ast.Statement.Assign(
+            targets=(python_ast.Expr.Name(**at(node, id=memberVarname(varname, memberName), ctx=python_ast.ExprContext.Store())),),
+            value=python_ast.Expr.Call(
+                **at(
+                    node,
+                    func=python_ast.Expr.Constant(**at(node, value=InitializeClassMember(classType, memberName))),
+                    args=args,
+                    keywords=()
+                )
+            ),
+            **at(node)
+        )
+
+    def readMember(node, varname, memberName):
+        return python_ast.Expr.Name(**at(node, id=memberVarname(varname, memberName), ctx=python_ast.ExprContext.Load()))
+
+    def replaceStatement(s):
+        if s.matches.Assign and len(s.targets) == 1:
+            target = s.targets[0]
+
+            if target.matches.Name and target.id in replacements:
+                classType = replacements[target.id]
+                passed = {kw.arg: rebuild(kw.value) for kw in s.value.keywords}
+
+                return [initializeMember(s, target.id, name, value) for name, value in passed.items()] + [
+                    initializeMember(s, target.id, name) for name in classType.MemberNames if name not in passed
+                ]
+
+            if target.matches.Attribute and target.value.matches.Name and target.value.id in replacements:
+                return [initializeMember(s, target.value.id, target.attr, rebuild(s.value))]
+
+        if s.matches.AugAssign and s.target.matches.Attribute and s.target.value.matches.Name and s.target.value.id in replacements:
+            varname, memberName = s.target.value.id, s.target.attr
+
+            return [
+                initializeMember(
+                    s,
+                    varname,
+                    memberName,
+                    python_ast.Expr.BinOp(**at(s, left=readMember(s.target, varname, memberName), op=s.op, right=rebuild(s.value)))
+                )
+            ]
+
+        return None
+
+    def replaceExpr(e):
+        if e.matches.Attribute and e.value.matches.Name and e.value.id in replacements:
+            return readMember(e, e.value.id, e.attr)
+
+        return None
+
+    def rebuild(node):
+        if isinstance(node, python_ast.Expr):
+            replacement = replaceExpr(node)
+            if replacement is not None:
+                return replacement
+
+            if node.matches.Constant:
+                return node
+
+        if isinstance(node, nodeTypes):
+            return type(node)(**{name: rebuild(getattr(node, name)) for name in node.ElementType.ElementNames})
+
+        if isinstance(node, list) or getattr(type(node), '__typed_python_category__', None) == 'TupleOf':
+            res = []
+
+            for x in node:
+                replacement = replaceStatement(x) if isinstance(x, python_ast.Statement) else None
+
+                if replacement is not None:
+                    res.extend(replacement)
+                else:
+                    res.append(rebuild(x))
+
+            return res
+
+        return node
+
+    return rebuild(list(statements))
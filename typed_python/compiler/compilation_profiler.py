@@ -0,0 +1,215 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import json
+import logging
+import os
+import threading
+import time
+import uuid
+
+
+# the phases of compilation we time. Every phase we record belongs to one of these.
+CONVERT = "convert"                  # python -> native_ast for a single function
+TYPE_INFERENCE = "type_inference"    # a round of '_resolveAllInflightFunctions'
+LLVM_IR = "llvm_ir"                  # native_ast -> llvm IR
+OPTIMIZE = "optimize"                # llvm optimization passes
+CODEGEN = "codegen"                  # llvm IR -> machine code
+FINALIZE = "finalize"                # loading and relocating machine code in the engine
+CACHE_LOAD = "cache_load"            # reading manifests and shared objects from the compiler cache
+CACHE_STORE = "cache_store"          # linking and writing new modules into the compiler cache
+
+
+class CompilationPhase:
+    """A span of time the compiler spent on one thing.
+
+    'start' and 'duration' are in seconds, on the 'time.perf_counter' clock.
+    """
+    __slots__ = ["name", "category", "start", "duration", "threadId", "args"]
+
+    def __init__(self, name, category, start, duration, threadId, args):
+        self.name = name
+        self.category = category
+        self.start = start
+        self.duration = duration
+        self.threadId = threadId
+        self.args = args
+
+    def __repr__(self):
+        return f"CompilationPhase({self.name!r}, {self.category!r}, {self.duration:.6f})"
+
+
+class _NoPhase:
+    def __enter__(self):
+        return self
+
+    def addArgs(self, **args):
+        pass
+
+    def __exit__(self, *args):
+        return False
+
+
+_noPhase = _NoPhase()
+
+
+class _Phase:
+    __slots__ = ["profiler", "name", "category", "args", "start"]
+
+    def __init__(self, profiler, name, category, args):
+        self.profiler = profiler
+        self.name = name
+        self.category = category
+        self.args = args
+
+    def __enter__(self):
+        self.start = time.perf_counter()
+        return self
+
+    def addArgs(self, **args):
+        """Record more about the phase than we knew when it started."""
+        self.args = dict(self.args, **args)
+
+    def __exit__(self, *args):
+        self.profiler._record(
+            CompilationPhase(
+                self.name,
+                self.category,
+                self.start,
+                time.perf_counter() - self.start,
+                threading.get_ident(),
+                self.args
+            )
+        )
+        return False
+
+
+class CompilationProfiler:
+    """Times the phases of compilation, so we can see where a slow cold start goes.
+
+    The compiler wraps each phase it goes through in 'phase(name, category)'. When
+    nobody is interested, that costs an attribute check. Once someone calls 'start'
+    we keep every phase we see until they call 'stop', and we hand each one to our
+    listeners (like RuntimeEventVisitors) as it finishes.
+
+    Phases nest, and they can happen on background threads (tier-up, parallel
+    codegen, background compilation), so we record the thread each one ran on.
+    'toChromeTrace' turns what we've recorded into the JSON that chrome://tracing
+    and Perfetto read.
+    """
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._phases = []
+        self._listeners = []
+        self._recording = False
+
+        # true if 'phase' needs to time anything
+        self.active = False
+
+    def start(self):
+        """Start recording phases, discarding anything we recorded before."""
+        with self._lock:
+            self._phases = []
+            self._recording = True
+            self._updateActive()
+
+    def stop(self):
+        """Stop recording, and return the phases we recorded."""
+        with self._lock:
+            self._recording = False
+            self._updateActive()
+            return list(self._phases)
+
+    def phases(self):
+        with self._lock:
+            return list(self._phases)
+
+    def addListener(self, listener):
+        """Call 'listener(compilationPhase)' on whichever thread finishes each phase."""
+        with self._lock:
+            self._listeners.append(listener)
+            self._updateActive()
+
+    def removeListener(self, listener):
+        with self._lock:
+            self._listeners.remove(listener)
+            self._updateActive()
+
+    def _updateActive(self):
+        self.active = self._recording or bool(self._listeners)
+
+    def phase(self, name, category, **args):
+        """Return a context manager that times the code it wraps as a phase."""
+        if not self.active:
+            return _noPhase
+
+        return _Phase(self, name, category, args)
+
+    def _record(self, phase):
+        with self._lock:
+            if self._recording:
+                self._phases.append(phase)
+
+            listeners = list(self._listeners)
+
+        for listener in listeners:
+            try:
+                listener(phase)
+            except Exception:
+                logging.exception("compilation phase listener %s threw an unexpected exception", listener)
+
+    def totalsByCategory(self, phases=None):
+        """Return a dict from category to the total seconds spent in it.
+
+        Phases nest (an 'optimize' phase sits inside an 'llvm_ir' one, say), so the
+        totals of different categories overlap.
+        """
+        res = {}
+
+        for phase in (self.phases() if phases is None else phases):
+            res[phase.category] = res.get(phase.category, 0.0) + phase.duration
+
+        return res
+
+    def toChromeTrace(self, phases=None):
+        """Return our phases as a Chrome trace, a dict you can json.dump."""
+        pid = os.getpid()
+
+        return {
+            "traceEvents": [
+                {
+                    "name": phase.name,
+                    "cat": phase.category,
+                    "ph": "X",
+                    "ts": phase.start * 1000000.0,
+                    "dur": phase.duration * 1000000.0,
+                    "pid": pid,
+                    "tid": phase.threadId,
+                    "args": {k: str(v) for k, v in phase.args.items()}
+                }
+                for phase in (self.phases() if phases is None else phases)
+            ],
+            "displayTimeUnit": "ms"
+        }
+
+    def saveChromeTrace(self, path, phases=None):
+        tempPath = path + "_" + str(uuid.uuid4())
+
+        with open(tempPath, "w") as f:
+            json.dump(self.toChromeTrace(phases), f)
+
+        os.rename(tempPath, path)
+
+
+compilationProfiler = CompilationProfiler()
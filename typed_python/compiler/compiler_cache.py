@@ -16,7 +16,14 @@ import os
 import uuid
 import shutil
 from typed_python.compiler.loaded_module import LoadedModule
+from typed_python.compiler.module_definition import ModuleDefinition
 from typed_python.compiler.binary_shared_object import BinarySharedObject
+from typed_python.compiler.type_group_hash_cache import TypeGroupHashCache
+from typed_python.compiler.native_ast_cache import NativeAstCache
+from typed_python.compiler.class_dispatch_cache import ClassDispatchCache
+from typed_python.compiler.compiler_cache_index import CompilerCacheIndex
+from typed_python.compiler.compiler_cache_gc import CompilerCacheCollector, touchModule, LAST_USED_FILE
+from typed_python.compiler.compilation_profiler import compilationProfiler, CACHE_LOAD
 
 from typed_python.SerializationContext import SerializationContext
 from typed_python import Dict, ListOf
@@ -42,12 +49,28 @@ class CompilerCache:
     which we achieve by only ever writing to it, and using directory renames
     to guarantee atomicity.
 
-    The biggest drawback here is that we have to load a bunch of 'manifest' objects
-    when we first boot up, which could be slow. We could improve this substantially
-    by making it possible to determine if a given function is in the cache by organizing
-    the manifests by, say, function name.
+    Loading is lazy: the converter only needs a cached module's manifests to call
+    into it, so we don't dlopen its shared object, or link its globals, until
+    something needs one of its function pointers or links new code against it.
+
+    To find out which module defines a given symbol, we consult a single
+    append-only CompilerCacheIndex, rather than reading the manifest of every
+    module at startup. We only read a module's own manifests once something
+    asks for one of its symbols.
+
+    Alongside the modules, we keep the native_ast of every function we convert (see
+    NativeAstCache), so that a function whose module is gone doesn't have to go
+    through conversion and type inference again, and a record of the class dispatches
+    and destructors we've compiled (see ClassDispatchCache).
+
+    If we're given 'maxBytes', we evict the least recently used modules at startup
+    until the cache fits (see CompilerCacheCollector).
+
+    Every compile adds a small module, and a process that uses them has to dlopen
+    and link each one. 'compact' relinks modules that get loaded together into one
+    shared object.
     """
-    def __init__(self, cacheDir):
+    def __init__(self, cacheDir, maxBytes=None):
         self.cacheDir = cacheDir
 
         ensureDirExists(cacheDir)
@@ -55,43 +78,101 @@ class CompilerCache:
         self.loadedModules = Dict(str, LoadedModule)()
         self.nameToModuleHash = Dict(str, str)()
 
+        # module hash -> the manifests 'readModuleManifests' read for it. A module
+        # can be in here without being in 'loadedModules'.
+        self.moduleManifests = {}
+
         self.modulesMarkedValid = set()
         self.modulesMarkedInvalid = set()
 
+        self.typeGroupHashes = TypeGroupHashCache(cacheDir)
+
+        self.nativeAsts = NativeAstCache(cacheDir)
+
+        self.classDispatches = ClassDispatchCache(cacheDir)
+
+        self.index = CompilerCacheIndex(cacheDir)
+
+        if not self.index.exists():
+            self.index.build(self.scanNameManifests())
+
+        if maxBytes is not None:
+            CompilerCacheCollector(cacheDir, maxBytes).collect()
+
+    def scanNameManifests(self):
+        """Yield (moduleHash, linkNames) for every module in the cache.
+
+        We only need this to build the index for a cache written before we had one.
+        """
         for moduleHash in os.listdir(self.cacheDir):
             if len(moduleHash) == 40:
-                self.loadNameManifestFromStoredModuleByHash(moduleHash)
+                try:
+                    with open(os.path.join(self.cacheDir, moduleHash, "name_manifest.dat"), "rb") as f:
+                        manifest = SerializationContext().deserialize(f.read(), Dict(str, str))
+                except Exception:
+                    continue
+
+                yield moduleHash, list(manifest)
 
     def hasSymbol(self, linkName):
+        if linkName in self.nameToModuleHash:
+            return True
+
+        moduleHash = self.index.lookup(linkName)
+
+        if moduleHash is None:
+            return False
+
+        # this reads the module's name manifest into 'nameToModuleHash',
+        # as long as the module and its submodules are valid
+        if not self.loadNameManifestFromStoredModuleByHash(moduleHash):
+            return False
+
         return linkName in self.nameToModuleHash
 
     def markModuleHashInvalid(self, hashstr):
-        with open(os.path.join(self.cacheDir, hashstr, "marked_invalid"), "w"):
+        try:
+            with open(os.path.join(self.cacheDir, hashstr, "marked_invalid"), "w"):
+                pass
+        except FileNotFoundError:
+            # it's been evicted
             pass
 
     def loadForSymbol(self, linkName):
-        moduleHash = self.nameToModuleHash[linkName]
+        """Return what the converter needs to know about the module defining 'linkName'.
+
+        This only reads the module's manifests. We don't load the shared object itself
+        (or the modules it depends on) until someone needs a function pointer from it
+        or links new code against it. See 'ensureModuleLoaded'.
 
-        nameToTypedCallTarget = {}
-        nameToNativeFunctionType = {}
+        Returns:
+            None if the module is invalid, or a pair of dicts from link name to
+            TypedCallTarget and from link name to native function type.
+        """
+        moduleHash = self.nameToModuleHash[linkName]
 
-        if not self.loadModuleByHash(moduleHash, nameToTypedCallTarget, nameToNativeFunctionType):
+        if not self.readModuleManifests(moduleHash):
             return None
 
-        return nameToTypedCallTarget, nameToNativeFunctionType
+        callTargets, functionNameToNativeType, _, _, _ = self.moduleManifests[moduleHash]
+
+        return dict(callTargets), dict(functionNameToNativeType)
 
-    def loadModuleByHash(self, moduleHash, nameToTypedCallTarget, nameToNativeFunctionType):
-        """Load a module by name.
+    def readModuleManifests(self, moduleHash):
+        """Read and validate the manifests of a module, if we haven't already.
 
-        As we load, place all the newly imported typed call targets into
-        'nameToTypedCallTarget' so that the rest of the system knows what functions
-        have been uncovered.
+        Returns:
+            True if the module is valid, in which case 'moduleManifests[moduleHash]'
+            holds its (callTargets, functionNameToNativeType, globalVarDefs, submodules,
+            partGlobalVarDefs), the last of which is None unless 'compact' wrote it.
         """
-        if moduleHash in self.loadedModules:
+        if moduleHash in self.moduleManifests:
             return True
 
         targetDir = os.path.join(self.cacheDir, moduleHash)
 
+        touchModule(targetDir)
+
         try:
             with open(os.path.join(targetDir, "type_manifest.dat"), "rb") as f:
                 callTargets = SerializationContext().deserialize(f.read())
@@ -104,37 +185,70 @@ class CompilerCache:
 
             with open(os.path.join(targetDir, "submodules.dat"), "rb") as f:
                 submodules = SerializationContext().deserialize(f.read(), ListOf(str))
+
+            partGlobalVarDefs = None
+            if os.path.exists(os.path.join(targetDir, "part_globals.dat")):
+                with open(os.path.join(targetDir, "part_globals.dat"), "rb") as f:
+                    partGlobalVarDefs = SerializationContext().deserialize(f.read())
         except Exception:
             self.markModuleHashInvalid(moduleHash)
             return False
 
-        if not LoadedModule.validateGlobalVariables(globalVarDefs):
-            self.markModuleHashInvalid(moduleHash)
-            return False
+        for defs in ([globalVarDefs] if partGlobalVarDefs is None else partGlobalVarDefs.values()):
+            if not LoadedModule.validateGlobalVariables(defs):
+                self.markModuleHashInvalid(moduleHash)
+                return False
+
+        self.moduleManifests[moduleHash] = (
+            callTargets, functionNameToNativeType, globalVarDefs, submodules, partGlobalVarDefs
+        )
+
+        return True
+
+    def ensureModuleLoaded(self, moduleHash):
+        """Load a module's shared object and link its globals, if we haven't already.
+
+        The modules it depends on get loaded first, since the dynamic linker needs
+        their symbols to resolve ours.
+        """
+        if moduleHash in self.loadedModules:
+            return
+
+        if not self.readModuleManifests(moduleHash):
+            raise Exception(f"Compiler cache module {moduleHash} is invalid")
+
+        _, functionNameToNativeType, globalVarDefs, submodules, partGlobalVarDefs = self.moduleManifests[moduleHash]
 
-        # load the submodules first
         for submodule in submodules:
-            if not self.loadModuleByHash(
-                submodule,
-                nameToTypedCallTarget,
-                nameToNativeFunctionType
-            ):
-                return False
+            self.ensureModuleLoaded(submodule)
 
-        modulePath = os.path.join(targetDir, "module.so")
+        modulePath = self.modulePathForHost(os.path.join(self.cacheDir, moduleHash))
 
-        loaded = BinarySharedObject.fromDisk(
-            modulePath,
-            globalVarDefs,
-            functionNameToNativeType
-        ).loadFromPath(modulePath)
+        with compilationProfiler.phase(moduleHash, CACHE_LOAD, path=modulePath):
+            self.loadedModules[moduleHash] = BinarySharedObject.fromDisk(
+                modulePath,
+                globalVarDefs,
+                functionNameToNativeType,
+                partGlobalVarDefs
+            ).loadFromPath(modulePath)
 
-        self.loadedModules[moduleHash] = loaded
+    def ensureSymbolsLoaded(self, linkNames):
+        """Load the modules defining 'linkNames', so that new code can link against them."""
+        for moduleHash in set(self.nameToModuleHash[name] for name in linkNames):
+            self.ensureModuleLoaded(moduleHash)
 
-        nameToTypedCallTarget.update(callTargets)
-        nameToNativeFunctionType.update(functionNameToNativeType)
+    def ensureKnownModulesLoaded(self):
+        """Load every module whose manifests we've read, and return how many we loaded.
 
-        return True
+        Those are the modules defining code the converter has linked against, which
+        we'd otherwise load the first time something calls into them.
+        """
+        loadedBefore = len(self.loadedModules)
+
+        for moduleHash in list(self.moduleManifests):
+            self.ensureModuleLoaded(moduleHash)
+
+        return len(self.loadedModules) - loadedBefore
 
     def addModule(self, binarySharedObject, nameToTypedCallTarget, linkDependencies):
         """Add new code to the compiler cache.
@@ -151,10 +265,13 @@ class CompilerCache:
         for name in linkDependencies:
             dependentHashes.add(self.nameToModuleHash[name])
 
+        for moduleHash in dependentHashes:
+            self.ensureModuleLoaded(moduleHash)
+
         path, hashToUse = self.writeModuleToDisk(binarySharedObject, nameToTypedCallTarget, dependentHashes)
 
         self.loadedModules[hashToUse] = (
-            binarySharedObject.loadFromPath(os.path.join(path, "module.so"))
+            binarySharedObject.loadFromPath(self.modulePathForHost(path))
         )
 
         for n in binarySharedObject.definedSymbols:
@@ -166,8 +283,8 @@ class CompilerCache:
 
         targetDir = os.path.join(self.cacheDir, moduleHash)
 
-        # ignore 'marked invalid'
-        if os.path.exists(os.path.join(targetDir, "marked_invalid")):
+        # ignore 'marked invalid', and modules that have been evicted
+        if os.path.exists(os.path.join(targetDir, "marked_invalid")) or not os.path.exists(targetDir):
             # just bail - don't try to read it now
 
             # for the moment, we don't try to clean up the cache, because
@@ -176,8 +293,13 @@ class CompilerCache:
             self.modulesMarkedInvalid.add(moduleHash)
             return False
 
-        with open(os.path.join(targetDir, "submodules.dat"), "rb") as f:
-            submodules = SerializationContext().deserialize(f.read(), ListOf(str))
+        try:
+            with open(os.path.join(targetDir, "submodules.dat"), "rb") as f:
+                submodules = SerializationContext().deserialize(f.read(), ListOf(str))
+        except FileNotFoundError:
+            # it was evicted while we were looking at it
+            self.modulesMarkedInvalid.add(moduleHash)
+            return False
 
         for subHash in submodules:
             if not self.loadNameManifestFromStoredModuleByHash(subHash):
@@ -193,6 +315,128 @@ class CompilerCache:
 
         return True
 
+    def compact(self, singleModule=False):
+        """Relink modules that always get loaded together into single shared objects.
+
+        A module can't be loaded without the modules it depends on, so we take each
+        connected group of modules in the dependency graph and link their object files
+        into one new module. Each part keeps its own globals accessor, renamed so they
+        don't collide, and we link each part's globals through it.
+
+        The new modules are appended to the index, so they take over their parts'
+        symbols in every process that starts after this. We leave the parts alone,
+        since running processes may still be using them, and they stop getting used,
+        so the CompilerCacheCollector will evict them eventually.
+
+        We skip modules written without their object file, modules with cpu-specific
+        variants, and modules that are themselves the result of a compaction.
+
+        If 'singleModule', we link every module we don't skip into one, whether or
+        not they depend on each other (see typed_python.aot).
+
+        Returns:
+            a list of the hashes of the modules we wrote.
+        """
+        candidates = {}
+
+        for moduleHash in os.listdir(self.cacheDir):
+            targetDir = os.path.join(self.cacheDir, moduleHash)
+
+            if (
+                len(moduleHash) != 40
+                or not os.path.exists(os.path.join(targetDir, "module.o"))
+                or os.path.exists(os.path.join(targetDir, "variants.dat"))
+                or os.path.exists(os.path.join(targetDir, "part_globals.dat"))
+                or os.path.exists(os.path.join(targetDir, "marked_invalid"))
+            ):
+                continue
+
+            if self.readModuleManifests(moduleHash):
+                candidates[moduleHash] = self.moduleManifests[moduleHash]
+
+        # union-find over the dependency edges between candidates
+        parent = {moduleHash: moduleHash for moduleHash in candidates}
+
+        def find(moduleHash):
+            while parent[moduleHash] != moduleHash:
+                parent[moduleHash] = parent[parent[moduleHash]]
+                moduleHash = parent[moduleHash]
+            return moduleHash
+
+        for moduleHash, (_, _, _, submodules, _) in candidates.items():
+            for subHash in submodules:
+                if subHash in parent:
+                    parent[find(subHash)] = find(moduleHash)
+
+        groups = {}
+        for moduleHash in sorted(candidates):
+            groups.setdefault(None if singleModule else find(moduleHash), []).append(moduleHash)
+
+        return [
+            self.writeCompactedModule(group, candidates)
+            for group in groups.values()
+            if len(group) > 1
+        ]
+
+    def writeCompactedModule(self, group, manifests):
+        """Link the modules in 'group' into one module and write it out. Returns its hash."""
+        objectFiles = []
+        symbolRenames = []
+        callTargets = {}
+        functionTypes = {}
+        globalVarDefs = {}
+        partGlobalVarDefs = {}
+        submodules = set()
+
+        for moduleHash in group:
+            with open(os.path.join(self.cacheDir, moduleHash, "module.o"), "rb") as f:
+                objectFiles.append(f.read())
+
+            partCallTargets, partFunctionTypes, partGlobals, partSubmodules, _ = manifests[moduleHash]
+
+            accessorName = ModuleDefinition.GET_GLOBAL_VARIABLES_NAME + "." + moduleHash
+            symbolRenames.append({ModuleDefinition.GET_GLOBAL_VARIABLES_NAME: accessorName})
+
+            callTargets.update(partCallTargets)
+
+            for name, nativeType in partFunctionTypes.items():
+                if name == ModuleDefinition.GET_GLOBAL_VARIABLES_NAME:
+                    name = accessorName
+                functionTypes[name] = nativeType
+
+            globalVarDefs.update(partGlobals)
+            partGlobalVarDefs[accessorName] = partGlobals
+            submodules.update(partSubmodules)
+
+        binarySharedObject = BinarySharedObject(
+            BinarySharedObject.linkObjectFiles(objectFiles, symbolRenames),
+            functionTypes,
+            globalVarDefs,
+            partGlobalVariableDefinitions=partGlobalVarDefs
+        )
+
+        _, hashToUse = self.writeModuleToDisk(binarySharedObject, callTargets, submodules - set(group))
+
+        return hashToUse
+
+    def modulePathForHost(self, targetDir):
+        """Return the path of the best shared object in 'targetDir' that this cpu can run.
+
+        That's the first variant listed in 'variants.dat' whose features we support, or
+        the generic 'module.so' if there isn't one.
+        """
+        variantsPath = os.path.join(targetDir, "variants.dat")
+
+        if os.path.exists(variantsPath):
+            with open(variantsPath, "rb") as f:
+                variantFeatures = SerializationContext().deserialize(f.read(), ListOf(str))
+
+            for i, features in enumerate(variantFeatures):
+                if BinarySharedObject.hostSupportsFeatures(features):
+                    return os.path.join(targetDir, f"variant_{i}.so")
+
+        return os.path.join(targetDir, "module.so")
+
     def writeModuleToDisk(self, binarySharedObject, nameToTypedCallTarget, submodules):
         """Write out a disk representation of this module.
 
@@ -223,6 +467,26 @@ class CompilerCache:
         with open(os.path.join(tempTargetDir, "module.so"), "wb") as f:
             f.write(binarySharedObject.binaryForm)
 
+        # keep the object file, so that 'compact' can relink it with other modules
+        if binarySharedObject.objectForm is not None:
+            with open(os.path.join(tempTargetDir, "module.o"), "wb") as f:
+                f.write(binarySharedObject.objectForm)
+
+        if binarySharedObject.partGlobalVariableDefinitions is not None:
+            with open(os.path.join(tempTargetDir, "part_globals.dat"), "wb") as f:
+                f.write(SerializationContext().serialize(binarySharedObject.partGlobalVariableDefinitions))
+
+        # write the variants of the module compiled for particular cpu features
+        variantFeatures = list(binarySharedObject.variants)
+
+        for i, features in enumerate(variantFeatures):
+            with open(os.path.join(tempTargetDir, f"variant_{i}.so"), "wb") as f:
+                f.write(binarySharedObject.variants[features])
+
+        if variantFeatures:
+            with open(os.path.join(tempTargetDir, "variants.dat"), "wb") as f:
+                f.write(SerializationContext().serialize(ListOf(str)(variantFeatures), ListOf(str)))
+
         # write the manifest. Every TP process using the cache will have to
         # load the manifest every time, so we try to use compiled code to load it
         manifest = Dict(str, str)()
@@ -251,6 +515,9 @@ class CompilerCache:
         with open(os.path.join(tempTargetDir, "submodules.dat"), "wb") as f:
             f.write(SerializationContext().serialize(ListOf(str)(submodules), ListOf(str)))
 
+        with open(os.path.join(tempTargetDir, LAST_USED_FILE), "w"):
+            pass
+
         try:
             os.rename(tempTargetDir, targetDir)
         except IOError:
@@ -259,6 +526,9 @@ class CompilerCache:
             else:
                 shutil.rmtree(tempTargetDir)
 
+        # only announce the module once it's fully in place
+        self.index.append(hashToUse, manifest)
+
         return targetDir, hashToUse
 
     def function_pointer_by_name(self, linkName):
@@ -266,7 +536,6 @@ class CompilerCache:
         if moduleHash is None:
             raise Exception("Can't find a module for " + linkName)
 
-        if moduleHash not in self.loadedModules:
-            self.loadForSymbol(linkName)
+        self.ensureModuleLoaded(moduleHash)
 
         return self.loadedModules[moduleHash].functionPointers[linkName]
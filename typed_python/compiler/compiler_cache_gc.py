@@ -0,0 +1,192 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+import shutil
+import time
+import uuid
+
+from typed_python.SerializationContext import SerializationContext
+from typed_python import ListOf
+
+
+# the file in each module directory whose mtime records when a process last used it
+LAST_USED_FILE = "last_used"
+
+# we never evict a module that someone used more recently than this, so that we
+# don't pull files out from under a process that's in the middle of loading it.
+MIN_IDLE_SECONDS = 600
+
+# directories that writers crashed before renaming into place, and evicted modules
+# that a collector crashed before deleting, are removed once they're this old.
+ABANDONED_SECONDS = 3600
+
+# evicted modules get renamed to this prefix plus a uuid before we delete them.
+# It's not 40 characters long, so nobody mistakes it for a module.
+EVICTED_PREFIX = "evicted_"
+
+
+def touchModule(moduleDir):
+    """Record that we just used the module in 'moduleDir'."""
+    path = os.path.join(moduleDir, LAST_USED_FILE)
+
+    try:
+        os.utime(path)
+    except FileNotFoundError:
+        try:
+            with open(path, "w"):
+                pass
+        except FileNotFoundError:
+            # the module got evicted
+            pass
+
+
+class CompilerCacheCollector:
+    """Evicts the least recently used modules from a compiler cache until it fits in 'maxBytes'.
+
+    A module's directory holds a LAST_USED_FILE that the CompilerCache touches whenever
+    a process first reads it. Modules depend on the modules listed in their
+    'submodules.dat', and a module whose dependency is gone can't be loaded, so when we
+    evict a module we evict everything that depends on it, directly or not, too.
+    Modules marked invalid go first, regardless of size.
+
+    Eviction is a rename to a name that isn't a module hash, followed by a delete, so
+    readers either see the whole module or none of it. A process that already loaded
+    a module's shared object keeps working, since unlinking a mapped file doesn't unmap
+    it. Entries in the symbol index that point at evicted modules are harmless: the
+    CompilerCache treats a missing module like an invalid one and recompiles.
+    """
+    def __init__(self, cacheDir, maxBytes, minIdleSeconds=MIN_IDLE_SECONDS):
+        self.cacheDir = cacheDir
+        self.maxBytes = maxBytes
+        self.minIdleSeconds = minIdleSeconds
+
+    def collect(self):
+        """Evict modules until the cache fits. Returns the hashes of the modules we evicted."""
+        now = time.time()
+
+        self._removeAbandonedDirectories(now)
+
+        modules = self._scanModules()
+
+        dependents = {moduleHash: set() for moduleHash in modules}
+        for moduleHash, module in modules.items():
+            for subHash in module["submodules"]:
+                if subHash in dependents:
+                    dependents[subHash].add(moduleHash)
+
+        totalBytes = sum(module["bytes"] for module in modules.values())
+
+        evicted = []
+
+        def evictWithDependents(moduleHash):
+            nonlocal totalBytes
+
+            toEvict = self._closure(moduleHash, dependents)
+
+            if any(now - modules[h]["lastUsed"] < self.minIdleSeconds for h in toEvict):
+                return
+
+            for h in toEvict:
+                if h in modules and self._evict(h):
+                    totalBytes -= modules[h]["bytes"]
+                    evicted.append(h)
+                    del modules[h]
+
+        for moduleHash in [h for h in modules if modules[h]["invalid"]]:
+            if moduleHash in modules:
+                evictWithDependents(moduleHash)
+
+        for moduleHash in sorted(modules, key=lambda h: modules[h]["lastUsed"]):
+            if totalBytes <= self.maxBytes:
+                break
+
+            if moduleHash in modules:
+                evictWithDependents(moduleHash)
+
+        return evicted
+
+    @staticmethod
+    def _closure(moduleHash, dependents):
+        res = set()
+        stack = [moduleHash]
+
+        while stack:
+            h = stack.pop()
+            if h not in res:
+                res.add(h)
+                stack.extend(dependents.get(h, ()))
+
+        return res
+
+    def _scanModules(self):
+        modules = {}
+
+        for name in os.listdir(self.cacheDir):
+            if len(name) != 40:
+                continue
+
+            moduleDir = os.path.join(self.cacheDir, name)
+
+            try:
+                moduleBytes = 0
+                for fname in os.listdir(moduleDir):
+                    moduleBytes += os.stat(os.path.join(moduleDir, fname)).st_size
+
+                lastUsedPath = os.path.join(moduleDir, LAST_USED_FILE)
+                lastUsed = os.stat(lastUsedPath if os.path.exists(lastUsedPath) else moduleDir).st_mtime
+
+                try:
+                    with open(os.path.join(moduleDir, "submodules.dat"), "rb") as f:
+                        submodules = list(SerializationContext().deserialize(f.read(), ListOf(str)))
+                    invalid = os.path.exists(os.path.join(moduleDir, "marked_invalid"))
+                except Exception:
+                    submodules = []
+                    invalid = True
+            except FileNotFoundError:
+                # someone else evicted it
+                continue
+
+            modules[name] = dict(bytes=moduleBytes, lastUsed=lastUsed, submodules=submodules, invalid=invalid)
+
+        return modules
+
+    def _evict(self, moduleHash):
+        evictedDir = os.path.join(self.cacheDir, EVICTED_PREFIX + str(uuid.uuid4()))
+
+        try:
+            os.rename(os.path.join(self.cacheDir, moduleHash), evictedDir)
+        except FileNotFoundError:
+            # another collector got there first
+            return False
+
+        shutil.rmtree(evictedDir, ignore_errors=True)
+
+        return True
+
+    def _removeAbandonedDirectories(self, now):
+        for name in os.listdir(self.cacheDir):
+            path = os.path.join(self.cacheDir, name)
+
+            # module directories being written are named '<hash>_<uuid>'
+            isAbandonedWrite = len(name) > 41 and name[40] == "_"
+
+            if not (isAbandonedWrite or name.startswith(EVICTED_PREFIX)) or not os.path.isdir(path):
+                continue
+
+            try:
+                if now - os.stat(path).st_mtime > ABANDONED_SECONDS:
+                    shutil.rmtree(path, ignore_errors=True)
+            except FileNotFoundError:
+                pass
@@ -0,0 +1,178 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import mmap
+import os
+import struct
+import uuid
+import zlib
+
+
+# the name of the index file inside the compiler cache. It's not 40 characters
+# long, so the CompilerCache won't mistake it for a module.
+INDEX_FILE = "symbol_index.dat"
+
+# every record starts with this, so that we can find the next record if we hit
+# one that was only partially written.
+RECORD_MAGIC = b"\x00TPI"
+
+# magic, payload length, crc32 of the payload
+RECORD_HEADER = struct.Struct("<4sII")
+
+HASH_LENGTH = 40
+
+
+class CompilerCacheIndex:
+    """An append-only index from link name to module hash for the CompilerCache.
+
+    Without it, a process has to open and deserialize the name manifest of every
+    module in the cache before it can tell whether any symbol is cached, which gets
+    slow once the cache holds tens of thousands of modules.
+
+    Each module contributes one record, written with a single O_APPEND write after
+    the module's directory has been renamed into place. A record is
+
+        RECORD_MAGIC, payload length, crc32(payload), payload
+
+    where the payload is the module hash followed by its link names, separated by
+    newlines. Readers mmap the file and parse whatever has been appended since they
+    last looked, so they also pick up modules that other processes write later.
+    A torn record (say, from a writer that crashed) fails its checksum and we skip
+    ahead to the next magic.
+
+    The index only tells us where a symbol might be. The CompilerCache still checks
+    that the module and its submodules are valid when it loads them.
+    """
+    def __init__(self, cacheDir):
+        self.indexPath = os.path.join(cacheDir, INDEX_FILE)
+
+        self.nameToModuleHash = {}
+
+        # how much of the file we've parsed
+        self._bytesRead = 0
+
+    def exists(self):
+        return os.path.exists(self.indexPath)
+
+    def lookup(self, linkName):
+        """Return the hash of a module defining 'linkName', or None."""
+        if linkName not in self.nameToModuleHash:
+            self._readNewRecords()
+
+        return self.nameToModuleHash.get(linkName)
+
+    def append(self, moduleHash, linkNames):
+        """Record that module 'moduleHash' defines 'linkNames'."""
+        record = self._encodeRecord(moduleHash, linkNames)
+
+        fd = os.open(self.indexPath, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o666)
+        try:
+            os.write(fd, record)
+        finally:
+            os.close(fd)
+
+    def build(self, moduleHashesAndLinkNames):
+        """Create the index file from scratch, unless someone else already has.
+
+        Args:
+            moduleHashesAndLinkNames - an iterable of (moduleHash, linkNames)
+        """
+        tempPath = self.indexPath + "_" + str(uuid.uuid4())
+
+        try:
+            with open(tempPath, "wb") as f:
+                for moduleHash, linkNames in moduleHashesAndLinkNames:
+                    f.write(self._encodeRecord(moduleHash, linkNames))
+
+            # unlike 'rename', 'link' won't replace an index that another process
+            # created (and maybe appended to) while we were scanning.
+            try:
+                os.link(tempPath, self.indexPath)
+            except FileExistsError:
+                pass
+        finally:
+            if os.path.exists(tempPath):
+                os.remove(tempPath)
+
+    @staticmethod
+    def _encodeRecord(moduleHash, linkNames):
+        assert len(moduleHash) == HASH_LENGTH
+
+        payload = "\n".join([moduleHash] + list(linkNames)).encode("utf8")
+
+        return RECORD_HEADER.pack(RECORD_MAGIC, len(payload), zlib.crc32(payload)) + payload
+
+    def _readNewRecords(self):
+        try:
+            fd = os.open(self.indexPath, os.O_RDONLY)
+        except FileNotFoundError:
+            return
+
+        try:
+            size = os.fstat(fd).st_size
+
+            if size <= self._bytesRead:
+                return
+
+            with mmap.mmap(fd, size, access=mmap.ACCESS_READ) as data:
+                self._bytesRead = self._parseRecords(data, self._bytesRead, size)
+        finally:
+            os.close(fd)
+
+    def _parseRecords(self, data, offset, size):
+        """Parse the records in data[offset:size] and return where we stopped."""
+        while offset + RECORD_HEADER.size <= size:
+            magic, length, checksum = RECORD_HEADER.unpack_from(data, offset)
+
+            if magic != RECORD_MAGIC:
+                offset = self._nextRecord(data, offset, size)
+                continue
+
+            end = offset + RECORD_HEADER.size + length
+
+            if end > size:
+                # a record that's still being written, or a torn one. In the
+                # first case we'll read it next time. In the second, a later
+                # record will eventually give us a magic to skip to.
+                nextOffset = self._nextRecord(data, offset, size)
+
+                if nextOffset >= size:
+                    return offset
+
+                offset = nextOffset
+                continue
+
+            payload = data[offset + RECORD_HEADER.size:end]
+
+            if zlib.crc32(payload) != checksum:
+                offset = self._nextRecord(data, offset, size)
+                continue
+
+            lines = payload.decode("utf8").split("\n")
+
+            for linkName in lines[1:]:
+                self.nameToModuleHash[linkName] = lines[0]
+
+            offset = end
+
+        return offset
+
+    @staticmethod
+    def _nextRecord(data, offset, size):
+        nextOffset = data.find(RECORD_MAGIC, offset + 1, size)
+
+        if nextOffset < 0:
+            return size
+
+        return nextOffset
@@ -0,0 +1,190 @@
+"""Fuse chained comprehensions into a single set of loops.
+
+A comprehension like
+
+    [f(x) for x in [g(y) for y in lst] if p(x)]
+
+builds a complete intermediate list just so the outer comprehension can walk
+it once and throw it away. When the inner comprehension is a list
+comprehension or a generator expression, we can instead run its loops
+directly and bind the outer loop variable to each element as it's produced:
+
+    for .y in lst:
+        x = g(.y)
+        if p(x):
+            yield f(x)
+
+(where '.y' stands for the inner comprehension's 'y', renamed so it can't
+collide with anything in the outer comprehension).
+
+For a generator expression this is exactly what python does. For a list
+comprehension the only visible difference is that calls to 'g' and 'f' are
+interleaved rather than all of the 'g' calls happening first. We only fuse
+comprehensions that can't rebind variables in any other scope, so the set of
+values produced is always the same.
+"""
+
+import typed_python.python_ast as python_ast
+from typed_python.compiler.generator_inlining import _renameVariables
+from typed_python.compiler.python_ast_analysis import visitPyAstChildren
+
+
+def comprehensionLoops(generators, body):
+    """Nest 'body' inside the loops and conditions of a comprehension.
+
+    The first generator is the outermost loop, and its conditions are tested in
+    order, the way python evaluates them.
+
+    Args:
+        generators - the python_ast.Comprehension objects of a comprehension
+        body - a list of python_ast.Statement to run for each element
+
+    Returns:
+        a list of python_ast.Statement
+    """
+    for comprehension in reversed(list(generators)):
+        for ifExpr in reversed(list(comprehension.ifs)):
+            body = [python_ast.Statement.If(test=ifExpr, body=body, orelse=[])]
+
+        body = _loopOver(comprehension, body)
+
+    return body
+
+
+def _loopOver(comprehension, body):
+    """Return statements running 'body' for each value 'comprehension.iter' produces."""
+    inner = comprehension.iter
+
+    if not _canFuse(inner):
+        # loops get named temporaries from their position, so give each one its target's
+        return [
+            python_ast.Statement.For(
+                target=comprehension.target,
+                iter=inner,
+                body=body,
+                orelse=[],
+                line_number=comprehension.target.line_number,
+                col_offset=comprehension.target.col_offset,
+                filename=comprehension.target.filename
+            )
+        ]
+
+    inner = _renameComprehensionVariables(inner)
+
+    bind = python_ast.Statement.Assign(
+        targets=(comprehension.target,),
+        value=inner.elt,
+        line_number=inner.elt.line_number,
+        col_offset=inner.elt.col_offset,
+        filename=inner.elt.filename
+    )
+
+    return comprehensionLoops(inner.generators, [bind] + body)
+
+
+def _comprehensionTargetNames(comp):
+    names = set()
+
+    def visit(x):
+        if isinstance(x, python_ast.Expr) and x.matches.Name:
+            names.add(x.id)
+        return True
+
+    for comprehension in comp.generators:
+        visitPyAstChildren(comprehension.target, visit)
+
+    return names
+
+
+def _renameComprehensionVariables(comp):
+    """Rename the loop variables of 'comp' so they're distinct from anything around it.
+
+    The first generator's 'iter' is evaluated in the enclosing scope, so it keeps
+    its names.
+    """
+    prefix = f".{comp.line_number}.{comp.col_offset}."
+    names = _comprehensionTargetNames(comp)
+
+    def rename(n):
+        return prefix + n if n in names else None
+
+    generators = [
+        python_ast.Comprehension.Item(
+            target=_renameVariables(c.target, rename),
+            iter=c.iter if i == 0 else _renameVariables(c.iter, rename),
+            ifs=_renameVariables(c.ifs, rename),
+            is_async=c.is_async
+        )
+        for i, c in enumerate(comp.generators)
+    ]
+
+    return type(comp)(
+        elt=_renameVariables(comp.elt, rename),
+        generators=generators,
+        line_number=comp.line_number,
+        col_offset=comp.col_offset,
+        filename=comp.filename
+    )
+
+
+def _canFuse(expr):
+    """Is 'expr' a comprehension whose loops we can run in place of iterating over its result?"""
+    if not isinstance(expr, python_ast.Expr) or not (expr.matches.ListComp or expr.matches.GeneratorExp):
+        return False
+
+    if any(c.is_async for c in expr.generators):
+        return False
+
+    # renaming the loop variables has to reach every use of them, so anything
+    # that could shadow one (a lambda, or a comprehension we aren't fusing) stops us
+    renamed = [expr.elt]
+
+    for i, comprehension in enumerate(expr.generators):
+        renamed.append(comprehension.target)
+        renamed.extend(comprehension.ifs)
+
+        if i > 0 and not _canFuse(comprehension.iter):
+            renamed.append(comprehension.iter)
+
+    return all(_hasNoNestedScopes(e) for e in renamed)
+
+
+def _hasNoNestedScopes(node):
+    ok = [True]
+
+    def visit(x):
+        if isinstance(x, python_ast.Expr) and (
+            x.matches.Lambda or x.matches.ListComp or x.matches.SetComp or x.matches.DictComp
+            or x.matches.GeneratorExp or x.matches.Yield or x.matches.YieldFrom or x.matches.Await
+        ):
+            ok[0] = False
+            return False
+
+        return True
+
+    visitPyAstChildren(node, visit)
+
+    return ok[0]
+
+
+def presizableLoop(statements):
+    """If the comprehension body 'statements' yields exactly once per pass through its only loop, return that loop.
+
+    Comprehensions like '[f(x) for x in lst]' (or fused ones, which bind some
+    variables before yielding) produce one element for each element of what
+    they iterate, so a list comprehension can size its result up front.
+    """
+    if len(statements) != 1 or not statements[0].matches.For or statements[0].orelse:
+        return None
+
+    loop = statements[0]
+
+    if not loop.body or not all(s.matches.Assign for s in loop.body[:-1]):
+        return None
+
+    last = loop.body[-1]
+
+    if not (last.matches.Expr and last.value.matches.Yield):
+        return None
+
+    return loop
@@ -104,6 +104,73 @@ class DirectedGraph:
 
         return sorted(nodes, key=lambda n: (levels.get(n, 0), indices[n]))
 
+    def stronglyConnectedComponents(self, nodes):
+        """Group 'nodes' into the strongly connected components of the graph between them.
+
+        We only follow edges between members of 'nodes'. Components come out in reverse
+        topological order: if there's an edge from one component to another, the
+        destination comes first.
+
+        Returns:
+            a list of lists of nodes.
+        """
+        nodes = set(nodes)
+
+        index = {}
+        lowlink = {}
+        stack = []
+        onStack = set()
+        components = []
+
+        for root in nodes:
+            if root in index:
+                continue
+
+            index[root] = lowlink[root] = len(index)
+            stack.append(root)
+            onStack.add(root)
+
+            # the nodes we're visiting, each with an iterator over its remaining children
+            work = [(root, iter(self.outgoing(root)))]
+
+            while work:
+                node, children = work[-1]
+
+                for child in children:
+                    if child not in nodes:
+                        continue
+
+                    if child not in index:
+                        index[child] = lowlink[child] = len(index)
+                        stack.append(child)
+                        onStack.add(child)
+                        work.append((child, iter(self.outgoing(child))))
+                        break
+
+                    if child in onStack:
+                        lowlink[node] = min(lowlink[node], index[child])
+                else:
+                    work.pop()
+
+                    if work:
+                        parent = work[-1][0]
+                        lowlink[parent] = min(lowlink[parent], lowlink[node])
+
+                    if lowlink[node] == index[node]:
+                        component = []
+
+                        while True:
+                            member = stack.pop()
+                            onStack.discard(member)
+                            component.append(member)
+
+                            if member == node:
+                                break
+
+                        components.append(component)
+
+        return components
+
     def createsCycle(self, source, dest):
         """would adding 'source->dest' node make the graph cyclic?"""
         if source == dest:
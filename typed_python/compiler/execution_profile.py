@@ -0,0 +1,161 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import json
+import os
+import threading
+import uuid
+
+
+# llvm's branch weights are 32 bit, so we scale counts down to fit.
+MAX_BRANCH_WEIGHT = 2 ** 31 - 1
+
+# a function counts as hot (and gets an 'inlinehint') if it was called at least
+# this fraction as often as the most-called function in the profile.
+HOT_FUNCTION_FRACTION = 0.01
+
+
+class ExecutionProfile:
+    """Counts recorded by instrumented compiled code, keyed by link name.
+
+    'entryCounts' maps a function's link name to the number of times it was called.
+    'branchCounts' maps (link name, branch index) to [timesFalse, timesTrue], where
+    branch index counts the conditional branches in the function in the order the
+    llvm converter emits them. Link names are stable across processes, and so is
+    the order we convert a function's branches in, so a profile written by one
+    process applies to the same code compiled by another.
+    """
+    def __init__(self, entryCounts=None, branchCounts=None):
+        self.entryCounts = dict(entryCounts or {})
+        self.branchCounts = dict(branchCounts or {})
+
+        self._hotThreshold = None
+
+    @staticmethod
+    def load(path):
+        """Read a profile written by 'save', or return an empty one if there isn't one."""
+        if not os.path.exists(path):
+            return ExecutionProfile()
+
+        with open(path, "r") as f:
+            data = json.load(f)
+
+        return ExecutionProfile(
+            data["entryCounts"],
+            {(name, int(ix)): counts for name, ix, counts in data["branchCounts"]}
+        )
+
+    def save(self, path):
+        tempPath = path + "_" + str(uuid.uuid4())
+
+        with open(tempPath, "w") as f:
+            json.dump(
+                dict(
+                    entryCounts=self.entryCounts,
+                    branchCounts=[
+                        [name, ix, counts] for (name, ix), counts in sorted(self.branchCounts.items())
+                    ]
+                ),
+                f
+            )
+
+        os.rename(tempPath, path)
+
+    def merge(self, other):
+        """Add the counts in 'other' to ours."""
+        for name, count in other.entryCounts.items():
+            self.entryCounts[name] = self.entryCounts.get(name, 0) + count
+
+        for key, counts in other.branchCounts.items():
+            existing = self.branchCounts.get(key, [0, 0])
+            self.branchCounts[key] = [existing[0] + counts[0], existing[1] + counts[1]]
+
+        self._hotThreshold = None
+
+    def branchWeights(self, name, branchIndex):
+        """Return llvm branch weights [true, false] for a branch, or None if we never saw it."""
+        counts = self.branchCounts.get((name, branchIndex))
+
+        if counts is None or not (counts[0] or counts[1]):
+            return None
+
+        scale = max(1, (max(counts) + MAX_BRANCH_WEIGHT - 1) // MAX_BRANCH_WEIGHT)
+
+        # a weight of zero tells llvm the branch is impossible, which is stronger
+        # than anything a profile can tell us.
+        return [max(1, counts[1] // scale), max(1, counts[0] // scale)]
+
+    def isCold(self, name):
+        return self.entryCounts.get(name) == 0
+
+    def isHot(self, name):
+        if self._hotThreshold is None:
+            self._hotThreshold = max(1, max(self.entryCounts.values(), default=0) * HOT_FUNCTION_FRACTION)
+
+        return self.entryCounts.get(name, 0) >= self._hotThreshold
+
+
+class ProfileCounters:
+    """The counters of all the instrumented code loaded into this process.
+
+    LoadedModule.linkGlobalVariables hands us a pointer to each counter as it links
+    an instrumented module. A function may have been repeated into several modules,
+    in which case we sum its counters.
+    """
+    def __init__(self):
+        self._lock = threading.Lock()
+
+        # link name -> list of PointerTo(int)
+        self._entryCounters = {}
+
+        # (link name, branch index) -> list of PointerTo(int), each to a [false, true] pair
+        self._branchCounters = {}
+
+    def addEntryCounter(self, name, pointer):
+        with self._lock:
+            self._entryCounters.setdefault(name, []).append(pointer)
+
+    def addBranchCounters(self, name, branchIndex, pointer):
+        with self._lock:
+            self._branchCounters.setdefault((name, branchIndex), []).append(pointer)
+
+    def snapshot(self, reset=False):
+        """Return an ExecutionProfile holding the current value of every counter.
+
+        If 'reset', zero the counters as we go, so that the next snapshot only holds
+        what happened after this one. Compiled code doesn't update the counters
+        atomically, so we may lose a few counts that race with this.
+        """
+        def read(pointer):
+            res = pointer.get()
+
+            if reset:
+                pointer.set(0)
+
+            return res
+
+        with self._lock:
+            return ExecutionProfile(
+                {
+                    name: sum(read(p) for p in pointers)
+                    for name, pointers in self._entryCounters.items()
+                },
+                {
+                    key: [sum(read(p) for p in pointers), sum(read(p + 1) for p in pointers)]
+                    for key, pointers in self._branchCounters.items()
+                }
+            )
+
+
+liveCounters = ProfileCounters()
@@ -15,7 +15,9 @@
 from typed_python.compiler.global_variable_definition import GlobalVariableMetadata
 import typed_python.compiler
 import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler.performance_lint as performance_lint
 from typed_python.compiler.type_wrappers.wrapper import Wrapper
+from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
 from typed_python.compiler.merge_type_wrappers import mergeTypeWrappers
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 import types
@@ -678,12 +680,22 @@ class ExpressionConversionContext:
 
                     expr = results.get(targets[-1], native_ast.nullExpr)
 
-                    for t in reversed(targets[:-1]):
-                        expr = native_ast.Expression.Branch(
-                            cond=expression.cast(native_ast.Int64).eq(native_ast.const_int_expr(t)),
-                            true=results.get(t, native_ast.nullExpr),
-                            false=expr
+                    if len(targets) > 2:
+                        # one 'switch' evaluates 'expression' once and jumps straight
+                        # to the right case, rather than testing each target in turn
+                        expr = native_ast.Expression.Switch(
+                            value=expression.cast(native_ast.Int64),
+                            targets=targets[:-1],
+                            cases=[results.get(t, native_ast.nullExpr) for t in targets[:-1]],
+                            default=expr
                         )
+                    else:
+                        for t in reversed(targets[:-1]):
+                            expr = native_ast.Expression.Branch(
+                                cond=expression.cast(native_ast.Int64).eq(native_ast.const_int_expr(t)),
+                                true=results.get(t, native_ast.nullExpr),
+                                false=expr
+                            )
 
                     self.pushEffect(expr)
 
@@ -1291,6 +1303,11 @@ class ExpressionConversionContext:
                 return x
             return self.constant(x)
 
+        nativeExcType = self._nativeExceptionType(excType)
+
+        if nativeExcType is not None and len(args) <= 1 and not kwargs:
+            return self.pushNativeException(nativeExcType, toTyped(args[0]) if args else None)
+
         args = [toTyped(excType)] + [toTyped(x) for x in args]
         kwargs = {k: toTyped(v) for k, v in kwargs.items()}
 
@@ -1325,6 +1342,56 @@ class ExpressionConversionContext:
             )
         )
 
+    @staticmethod
+    def _nativeExceptionType(excType):
+        """The builtin exception type 'excType' is or holds, if we can raise it without building it.
+
+        The builtin types have no side effects when we construct them, so we can put that off
+        until someone wants the exception object. See NativeException.hpp.
+        """
+        if isinstance(excType, TypedExpression):
+            T = excType.expr_type.typeRepresentation
+
+            if getattr(T, '__typed_python_category__', None) != 'Value':
+                return None
+
+            excType = T.Value
+
+        if isinstance(excType, type) and issubclass(excType, BaseException) and excType.__module__ == 'builtins':
+            return excType
+
+        return None
+
+    def pushNativeException(self, excType, arg):
+        """Push a side-effect that raises builtin exception 'excType' with 'arg' (or None) lazily."""
+        nullPtr = native_ast.Expression.Constant(val=native_ast.Constant.NullPointer(value_type=native_ast.Void))
+
+        if arg is not None:
+            arg = arg.demasquerade().ensureIsReference()
+            argPtr = arg.expr.cast(native_ast.VoidPtr)
+            argTypePtr = self.getTypePointer(arg.expr_type.typeRepresentation)
+        else:
+            argPtr = argTypePtr = nullPtr
+
+        self.pushEffect(
+            runtime_functions.initialize_native_exception.call(
+                native_ast.Expression.GlobalVariable(
+                    name="py_exception_type_" + str(excType),
+                    type=native_ast.VoidPtr,
+                    metadata=GlobalVariableMetadata.IdOfPyObject(
+                        value=excType
+                    )
+                ).load().cast(native_ast.Void.pointer()),
+                argPtr,
+                argTypePtr
+            )
+            >> native_ast.Expression.Throw(
+                expr=native_ast.Expression.Constant(
+                    val=native_ast.Constant.NullPointer(value_type=native_ast.UInt8.pointer())
+                )
+            )
+        )
+
     def pushExceptionClear(self):
         nativeExpr = (
             runtime_functions.clear_exception.call()
@@ -1494,6 +1561,55 @@ class ExpressionConversionContext:
 
         return self.call_typed_call_target(callTarget, args)
 
+    def convert_formatted_value_ast(self, ast, allowUnformattedNumbers=False):
+        """Convert the FormattedValue 'ast' (one '{...}' in an f-string) to a str.
+
+        If 'allowUnformattedNumbers', an int or float with no conversion or format
+        spec comes back as is, so that the enclosing f-string can format it
+        straight into its result.
+        """
+        value = self.convert_expression_ast(ast.value)
+
+        if value is None:
+            return None
+
+        if ast.conversion == ord('r'):
+            value = value.convert_repr()
+        elif ast.conversion == ord('a'):
+            value = pythonObjectRepresentation(self, ascii).convert_call(
+                [value.convert_to_type(object, ConversionLevel.Signature)], {}
+            )
+        elif (
+            allowUnformattedNumbers
+            and ast.format_spec is None
+            and value.expr_type.typeRepresentation in (int, float)
+        ):
+            if value.isConstant:
+                return self.constant(str(value.constantValue))
+
+            return value
+
+        if value is None:
+            return None
+
+        if ast.format_spec is not None:
+            format_spec = self.convert_expression_ast(ast.format_spec)
+            if format_spec is None:
+                return None
+        else:
+            format_spec = None
+
+        result = value.convert_format(format_spec)
+
+        if result is None:
+            return
+
+        if result.expr_type.typeRepresentation is not str:
+            self.pushException(TypeError, "Expected string, but got %s" % result.expr_type.typeRepresentation)
+            return None
+
+        return result
+
     def convert_expression_ast(self, ast):
         """Convert a python_ast.Expression node to a TypedExpression.
 
@@ -1501,6 +1617,27 @@ class ExpressionConversionContext:
             None if the expression doesn't return control flow to the caller
             or a TypedExpression.
         """
+        functionContext = self.functionContext
+
+        priorLineNumber = functionContext.currentLineNumber
+        functionContext.currentLineNumber = ast.line_number
+
+        try:
+            res = self._convert_expression_ast(ast)
+
+            if res is not None and (
+                getattr(res.expr_type.typeRepresentation, "__typed_python_category__", None) == "PythonObjectOfType"
+            ):
+                functionContext.notePerformance(
+                    performance_lint.OBJECT,
+                    f"{performance_lint.describeExpression(ast)} has type {res.expr_type.typeRepresentation.__name__}"
+                )
+
+            return res
+        finally:
+            functionContext.currentLineNumber = priorLineNumber
+
+    def _convert_expression_ast(self, ast):
         if ast.matches.Attribute:
             attr = ast.attr
             val = self.convert_expression_ast(ast.value)
@@ -1880,46 +2017,26 @@ class ExpressionConversionContext:
             return out_slot
 
         if ast.matches.FormattedValue:
-            value = self.convert_expression_ast(ast.value)
-
-            if value is None:
-                return None
-
-            if ast.format_spec is not None:
-                format_spec = self.convert_expression_ast(ast.format_spec)
-                if format_spec is None:
-                    return None
-            else:
-                format_spec = None
-
-            result = value.convert_format(format_spec)
-
-            if result is None:
-                return
-
-            if result.expr_type.typeRepresentation is not str:
-                self.pushException(TypeError, "Expected string, but got %s" % result.expr_type.typeRepresentation)
-                return None
-
-            return result
+            return self.convert_formatted_value_ast(ast)
 
         if ast.matches.JoinedStr:
-            converted = [self.convert_expression_ast(v) for v in ast.values]
+            pieces = []
 
-            for v in converted:
-                if v is None:
-                    return None
+            for v in ast.values:
+                if v.matches.FormattedValue:
+                    piece = self.convert_formatted_value_ast(v, allowUnformattedNumbers=True)
+                else:
+                    piece = self.convert_expression_ast(v)
 
-            if all(v.isConstant and isinstance(v.constantValue, str) for v in converted):
-                return self.constant("".join(v.constantValue for v in converted))
+                if piece is None:
+                    return None
 
-            items_to_join = self.push(ListOf(str), lambda s: s.convert_default_initialize())
+                pieces.append(piece)
 
-            for v in converted:
-                if items_to_join.convert_method_call("append", (v,), {}) is None:
-                    return None
+            if all(v.isConstant and isinstance(v.constantValue, str) for v in pieces):
+                return self.constant("".join(v.constantValue for v in pieces))
 
-            return pythonObjectRepresentation(self, "").convert_method_call("join", (items_to_join,), {})
+            return typeWrapper(str).convert_joined_str(self, pieces)
 
         if ast.matches.List:
             aList = self.constant(list).convert_call([], {})
@@ -2004,7 +2121,7 @@ class ExpressionConversionContext:
             ).convert_call([], {})
 
         if ast.matches.Constant:
-            if ast.value is isinstance:
+            if ast.value is isinstance or isinstance(ast.value, CompilableBuiltin):
                 return pythonObjectRepresentation(self, ast.value)
 
             return self.constant(ast.value, allowArbitrary=True)
@@ -2020,6 +2137,25 @@ class ExpressionConversionContext:
             generatorFunc
         )
 
+    def convert_generator_as_reduction(self, ast, ConversionContextType, outputType=None):
+        """Run the generator expression 'ast' directly inside a reduction like 'any' or 'min'.
+
+        Args:
+            ast - a python_ast.Expr.GeneratorExp
+            ConversionContextType - the ComprehensionConversionContextBase subclass
+                that performs the reduction
+            outputType - the type the reduction returns, if it's known up front.
+        """
+        generatorFunc = self.functionContext.localVariableExpression(self, ".closure").changeType(
+            self.functionContext.functionDefToType[ast]
+        )
+        return generatorFunc.expr_type.convert_comprehension(
+            generatorFunc.context,
+            generatorFunc,
+            ConversionContextType,
+            outputType
+        )
+
     def convert_generator_as_set_comprehension(self, ast):
         generatorFunc = self.functionContext.localVariableExpression(self, ".closure").changeType(
             self.functionContext.functionDefToType[ast]
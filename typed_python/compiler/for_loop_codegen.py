@@ -162,10 +162,10 @@ def rewriteForLoopStatement(s):
     assert s.matches.For, type(s)
 
     """Rewrite a generic for loop, making no assumptions about its type."""
-    iteratorExpressionVarname = f".for.{s.line_number}.iteratorExpr"
-    iteratorVarname = f".for.{s.line_number}.iterator"
-    iteratorValuePtrVarname = f".for.{s.line_number}.iteratorValuePtr"
-    iteratorTrigger = f".for.{s.line_number}.triggerElse"
+    iteratorExpressionVarname = f".for.{s.line_number}.{s.col_offset}.iteratorExpr"
+    iteratorVarname = f".for.{s.line_number}.{s.col_offset}.iterator"
+    iteratorValuePtrVarname = f".for.{s.line_number}.{s.col_offset}.iteratorValuePtr"
+    iteratorTrigger = f".for.{s.line_number}.{s.col_offset}.triggerElse"
 
     yield assign(iteratorExpressionVarname, s.iter)
     yield importAs(
@@ -217,9 +217,9 @@ def rewriteForLoopStatement(s):
 
 def rewriteIntiterForLoop(iterableVarname, target, body, orelse):
     """Rewrite a generic for loop, making no assumptions about its type."""
-    iteratorMaxValue = f".for.{target.line_number}.iteratorMaxValue"
-    iteratorValue = f".for.{target.line_number}.iteratorValue"
-    iteratorTrigger = f".for.{target.line_number}.triggerElse"
+    iteratorMaxValue = f".for.{target.line_number}.{target.col_offset}.iteratorMaxValue"
+    iteratorValue = f".for.{target.line_number}.{target.col_offset}.iteratorValue"
+    iteratorTrigger = f".for.{target.line_number}.{target.col_offset}.triggerElse"
 
     yield assign(
         iteratorMaxValue,
@@ -248,3 +248,234 @@ def rewriteIntiterForLoop(iterableVarname, target, body, orelse):
             test=readVar(iteratorTrigger),
             body=orelse
         )
+
+
+# builtins a loop body may call without us giving up on proving that the containers
+# it indexes keep their length. With arithmetic arguments, none of them run user code.
+LENGTH_PRESERVING_BUILTINS = {
+    'len': len, 'range': range, 'abs': abs, 'float': float, 'int': int, 'bool': bool, 'min': min, 'max': max
+}
+
+# what 'classifyName' says about a variable mentioned in a loop body
+ARITHMETIC = "arithmetic"                    # a number (or a OneOf of numbers)
+LIST_OF_ARITHMETIC = "list_of_arithmetic"    # a ListOf of numbers
+TUPLE_OF_ARITHMETIC = "tuple_of_arithmetic"  # a TupleOf of numbers
+UNKNOWN_LOCAL = "unknown_local"              # a local whose type we don't know yet
+
+
+def constantValue(e):
+    """Return the python value of a constant expression, or raise KeyError."""
+    if e.matches.Constant:
+        return e.value
+
+    if e.matches.Num and (e.n.matches.Int or e.n.matches.Float or e.n.matches.Boolean):
+        return e.n.value
+
+    if e.matches.Num and e.n.matches.None_:
+        return None
+
+    raise KeyError(e)
+
+
+def _isConstant(e, predicate):
+    try:
+        return predicate(constantValue(e))
+    except KeyError:
+        return False
+
+
+def matchRangeOverLenLoop(s):
+    """If 's' is 'for i in range(len(x))' or 'for i in range(0, len(x))', return (i, x).
+
+    Loops with an 'else' clause don't match, since the 'else' clause runs after
+    the loop variable has gone out of range.
+    """
+    if not s.matches.For or s.orelse or not s.target.matches.Name:
+        return None
+
+    rangeCall = s.iter
+
+    if not (rangeCall.matches.Call and rangeCall.func.matches.Name and rangeCall.func.id == 'range'
+            and not rangeCall.keywords):
+        return None
+
+    if len(rangeCall.args) == 1:
+        lenCall = rangeCall.args[0]
+    elif len(rangeCall.args) == 2 and _isConstant(rangeCall.args[0], lambda v: type(v) is int and v == 0):
+        lenCall = rangeCall.args[1]
+    else:
+        return None
+
+    if not (lenCall.matches.Call and lenCall.func.matches.Name and lenCall.func.id == 'len'
+            and len(lenCall.args) == 1 and not lenCall.keywords and lenCall.args[0].matches.Name):
+        return None
+
+    return s.target.id, lenCall.args[0].id
+
+
+def loopBodyPreservesContainerLengths(body, containerName, indexName, classifyName, isBuiltin):
+    """Can we prove that 'body' never changes the length of any container, or 'indexName'?
+
+    We're deliberately conservative, and only accept straight-line arithmetic: the
+    variables the body mentions must be numbers, or ListOf/TupleOf of numbers that it
+    only ever indexes or takes the 'len' of. It can't call anything but the
+    LENGTH_PRESERVING_BUILTINS, look up attributes, or yield. Since none of that can
+    run user code, no one can append to or pop from a container while the body runs.
+    It also can't assign to 'containerName' or 'indexName'.
+
+    Args:
+        body - a list of python_ast.Statement
+        containerName - the name of the container the loop ranges over
+        indexName - the name of the loop variable
+        classifyName - a function from a variable name to ARITHMETIC, LIST_OF_ARITHMETIC,
+            TUPLE_OF_ARITHMETIC, UNKNOWN_LOCAL, or None if it could be something else
+        isBuiltin - a function (name, builtin) returning True if 'name' refers to 'builtin'
+    """
+    def checkName(name, asContainer):
+        kind = classifyName(name)
+
+        if kind in (LIST_OF_ARITHMETIC, TUPLE_OF_ARITHMETIC):
+            return asContainer
+
+        return kind in (ARITHMETIC, UNKNOWN_LOCAL) and not asContainer
+
+    def checkExpr(e):
+        if e.matches.Num or e.matches.Constant:
+            return _isConstant(e, lambda v: v is None or isinstance(v, (int, float, bool)))
+
+        if e.matches.Name:
+            return e.id != containerName and checkName(e.id, False)
+
+        if e.matches.BinOp:
+            return checkExpr(e.left) and checkExpr(e.right)
+
+        if e.matches.UnaryOp:
+            return checkExpr(e.operand)
+
+        if e.matches.BoolOp:
+            return all(checkExpr(v) for v in e.values)
+
+        if e.matches.Compare:
+            return checkExpr(e.left) and all(checkExpr(c) for c in e.comparators)
+
+        if e.matches.IfExp:
+            return checkExpr(e.test) and checkExpr(e.body) and checkExpr(e.orelse)
+
+        if e.matches.Subscript:
+            return e.value.matches.Name and checkName(e.value.id, True) and not e.slice.matches.Slice and checkExpr(e.slice)
+
+        if e.matches.Call:
+            if e.keywords or not e.func.matches.Name or e.func.id not in LENGTH_PRESERVING_BUILTINS:
+                return False
+
+            if not isBuiltin(e.func.id, LENGTH_PRESERVING_BUILTINS[e.func.id]):
+                return False
+
+            if e.func.id == 'len':
+                return len(e.args) == 1 and e.args[0].matches.Name and checkName(e.args[0].id, True)
+
+            return all(checkExpr(a) for a in e.args)
+
+        return False
+
+    def checkTarget(t):
+        if t.matches.Name:
+            return t.id not in (containerName, indexName) and checkName(t.id, False)
+
+        if t.matches.Subscript:
+            # only lists can be assigned into. Leave the error for tuples to the normal path.
+            return t.value.matches.Name and classifyName(t.value.id) == LIST_OF_ARITHMETIC and checkExpr(t)
+
+        return False
+
+    def checkStatement(s):
+        if s.matches.Pass or s.matches.Break or s.matches.Continue:
+            return True
+
+        if s.matches.Expr:
+            return checkExpr(s.value)
+
+        if s.matches.Assign:
+            return all(checkTarget(t) for t in s.targets) and checkExpr(s.value)
+
+        if s.matches.AugAssign:
+            return checkTarget(s.target) and checkExpr(s.value)
+
+        if s.matches.If or s.matches.While:
+            return checkExpr(s.test) and checkStatements(s.body) and checkStatements(s.orelse)
+
+        if s.matches.For:
+            return checkTarget(s.target) and checkExpr(s.iter) and checkStatements(s.body) and checkStatements(s.orelse)
+
+        return False
+
+    def checkStatements(statements):
+        return all(checkStatement(s) for s in statements)
+
+    return checkStatements(body)
+
+
+def _replaceExpressions(node, replace):
+    """Rebuild a python_ast statement or expression tree, replacing expressions with 'replace'.
+
+    'replace' returns a new expression, or None to leave an expression (and recurse into it).
+    We only recurse into the kinds of statements 'loopBodyPreservesContainerLengths' accepts.
+    """
+    if isinstance(node, python_ast.Expr):
+        replacement = replace(node)
+        if replacement is not None:
+            return replacement
+
+    if isinstance(node, (python_ast.Expr, python_ast.Statement)):
+        return type(node)(**{
+            name: _replaceExpressions(getattr(node, name), replace) for name in node.ElementType.ElementNames
+        })
+
+    if getattr(type(node), '__typed_python_category__', None) == 'TupleOf':
+        return [_replaceExpressions(x, replace) for x in node]
+
+    return node
+
+
+def rewriteSubscriptsAsPointerAccesses(statements, containerName, indexName, pointerVarname):
+    """Replace 'containerName[indexName]' in 'statements' with 'pointerVarname[indexName]'.
+
+    'pointerVarname' should hold 'containerName.pointerUnsafe(0)'. Indexing a pointer
+    doesn't check bounds or reload the container's data pointer, so once we've proven
+    the index is in bounds, this turns a loop over a list into one llvm can vectorize.
+
+    Returns None if there was nothing to rewrite.
+    """
+    found = []
+
+    def replace(e):
+        if (
+            e.matches.Subscript
+            and e.value.matches.Name and e.value.id == containerName
+            and e.slice.matches.Name and e.slice.id == indexName
+        ):
+            found.append(e)
+
+            return python_ast.Expr.Subscript(
+                value=python_ast.Expr.Name(
+                    id=pointerVarname,
+                    ctx=python_ast.ExprContext.Load(),
+                    line_number=e.value.line_number,
+                    col_offset=e.value.col_offset,
+                    filename=e.value.filename
+                ),
+                slice=e.slice,
+                ctx=e.ctx,
+                line_number=e.line_number,
+                col_offset=e.col_offset,
+                filename=e.filename
+            )
+
+        return None
+
+    res = [_replaceExpressions(s, replace) for s in statements]
+
+    if not found:
+        return None
+
+    return res
@@ -15,8 +15,22 @@
 import typed_python.python_ast as python_ast
 import importlib
 import typed_python.compiler.codegen_helpers as codegen_helpers
-from typed_python.compiler.for_loop_codegen import rewriteForLoops, rewriteIntiterForLoop
+from typed_python.compiler.for_loop_codegen import (
+    rewriteForLoops,
+    rewriteIntiterForLoop,
+    matchRangeOverLenLoop,
+    loopBodyPreservesContainerLengths,
+    rewriteSubscriptsAsPointerAccesses,
+    ARITHMETIC,
+    LIST_OF_ARITHMETIC,
+    TUPLE_OF_ARITHMETIC,
+    UNKNOWN_LOCAL,
+)
+from typed_python.compiler.arithmetic_options import DEFAULT_OPTIONS
+from typed_python.compiler.class_scalar_replacement import findScalarReplaceableInstances, scalarReplaceInstances
+from typed_python.compiler.comprehension_fusion import presizableLoop
 from typed_python.compiler.generator_codegen import GeneratorCodegen
+from typed_python.compiler.generator_inlining import InlinableGenerator, inlineGeneratorIntoLoop
 from typed_python.compiler.withblock_codegen import expandWithBlockIntoTryCatch
 from typed_python.compiler.python_ast_analysis import (
     computeAssignedVariables,
@@ -33,7 +47,8 @@ import typed_python.compiler
 import typed_python.compiler.native_ast as native_ast
 from typed_python import (
     _types, Type, ListOf, PointerTo, pointerTo, Set, Dict, Member,
-    OneOf, Function, Tuple, Forward, Class, NamedTuple, Value, TupleOf
+    OneOf, Function, Tuple, Forward, Class, NamedTuple, Value, TupleOf,
+    Int8, UInt8, Int16, UInt16, Int32, UInt32, UInt64, Float32
 )
 from typed_python.generator import Generator
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
@@ -43,6 +58,7 @@ from typed_python.compiler.type_wrappers.none_wrapper import NoneWrapper
 from typed_python.compiler.typed_expression import TypedExpression
 from typed_python.compiler.conversion_exception import ConversionException
 from typed_python.compiler.function_metadata import FunctionMetadata
+from typed_python.compiler.performance_lint import PerformanceNote
 from typed_python.compiler.merge_type_wrappers import mergeTypeWrappers
 from typed_python.python_ast import evaluateFunctionDefWithLocalsInCells
 
@@ -59,6 +75,18 @@ typeWrapper = lambda t: typed_python.compiler.python_object_representation.typed
 # storage for mutually recursive function types
 _closureCycleMemo = {}
 
+_arithmeticTypes = (int, float, bool, Int8, UInt8, Int16, UInt16, Int32, UInt32, UInt64, Float32)
+
+
+def _isArithmeticType(T):
+    if T in _arithmeticTypes:
+        return True
+
+    if isinstance(T, type) and issubclass(T, OneOf):
+        return all(_isArithmeticType(subT) for subT in T.Types)
+
+    return False
+
 
 class FunctionOutput:
     pass
@@ -115,6 +143,7 @@ class ConversionContextBase:
         closureVarnames,
         globalVars,
         globalVarsRaw,
+        arithmeticOptions=DEFAULT_OPTIONS,
     ):
         """Initialize a FunctionConverter
 
@@ -130,8 +159,20 @@ class ConversionContextBase:
                 before the actual func args.
             globalVars - a dict from name to the actual python object in the globals for this function
             globalVarsRaw - the original dict where these globals live.
+            arithmeticOptions - the ArithmeticOptions this function opted into.
         """
         self.name = name
+        self.arithmeticOptions = arithmeticOptions
+
+        # set by the converter if this function may not produce python objects. See nogil.py.
+        self.nogil = False
+        # set by the converter if this function keeps the counters in instrumentation.py
+        self.instrument = False
+
+        # the PerformanceNotes (see performance_lint.py) from our latest conversion
+        # pass, as keys, in the order we made them, and the source line we're on
+        self.performanceNotes = {}
+        self.currentLineNumber = 0
         self.funcArgNames = funcArgNames
 
         self.variablesAssigned = set()
@@ -163,6 +204,9 @@ class ConversionContextBase:
         # variables in closure slots that are not single-assignment function defs need slots
         self.variablesNeedingClosureSlots = set()
 
+        # whether our closure holds copies of its variables (see buildClosureTypes)
+        self.closureIsByValue = False
+
         # for all typed functions we have ever defined, the original untyped function.
         # This grows with each pass and is there to help us when we're walking types
         # looking for our own closures to replace.
@@ -192,6 +236,9 @@ class ConversionContextBase:
         self._tempStackVarIx = 0
         self._tempIterVarIx = 0
 
+        # code objects of the generators whose bodies we're in the middle of inlining
+        self._generatorsBeingInlined = []
+
         self._typesAreUnstable = False
         self._functionOutputTypeKnown = False
         self._functionYieldTypeKnown = False
@@ -390,6 +437,17 @@ class ConversionContextBase:
         if not self.variablesNeedingClosureSlots:
             # we don't need any slots at all
             self.closureType = Tuple()
+        elif self.closureIsByValue:
+            # the closure is a NamedTuple of our arguments, held inline in each function
+            # object, so a lambda over a few ints is a few ints, and reading them is a load
+            # rather than a trip through a refcounted heap object. Argument types can't
+            # refer to our own closure, so this doesn't need a Forward.
+            self.closureType = NamedTuple(
+                **{
+                    var: self._varname_to_type[var].typeRepresentation
+                    for var in sorted(self.variablesNeedingClosureSlots)
+                }
+            )
         else:
             self.closureType = Forward(self.name + ".closure")
 
@@ -405,7 +463,7 @@ class ConversionContextBase:
             self.functionDefToType[ast] = self.functionDefToType[ast].define(typedFuncType)
             self.typedFunctionTypeToClosurelessFunctionType[typedFuncType] = untypedFuncType
 
-        if self.variablesNeedingClosureSlots:
+        if self.variablesNeedingClosureSlots and not self.closureIsByValue:
             # now build the closure type itself and replace the forward with the defined class
             closureMembers = []
             classMembers = []
@@ -456,11 +514,18 @@ class ConversionContextBase:
 
         _closureCycleMemo[closureKey] = (self.closureType, dict(self.functionDefToType))
 
+    def notePerformance(self, kind, description):
+        """Record a PerformanceNote of 'kind' (see performance_lint.py) at the current line."""
+        self.performanceNotes[
+            PerformanceNote(kind=kind, lineNumber=self.currentLineNumber, description=description)
+        ] = True
+
     def convertToNativeFunction(self):
         self.tempLetVarIx = 0
         self._tempStackVarIx = 0
         self._tempIterVarIx = 0
         self.functionMetadata = FunctionMetadata()
+        self.performanceNotes = {}
 
         variableStates = FunctionStackState()
 
@@ -747,6 +812,9 @@ class ConversionContextBase:
             self._varname_to_type[varname] = finalType
 
     def closureDestructor(self, variableStates):
+        if self.closureIsByValue:
+            return self.byValueClosureDestructors(variableStates)
+
         if not issubclass(self.closureType, Class):
             return []
 
@@ -757,6 +825,25 @@ class ConversionContextBase:
 
         return [context.finalize(None)]
 
+    def byValueClosureDestructors(self, variableStates):
+        res = []
+
+        for name in sorted(self.variablesNeedingClosureSlots):
+            varType = self._varname_to_type.get(name)
+
+            if varType is None or varType.is_empty or varType.is_pod:
+                continue
+
+            context = ExpressionConversionContext(self, variableStates)
+
+            with context.ifelse(context.isInitializedVarExpr(name)) as (true, false):
+                with true:
+                    self.localVariableExpression(context, name).convert_destroy()
+
+            res.append(context.finalize(None))
+
+        return res
+
     def closureInitializer(self, variableStates):
         if not issubclass(self.closureType, Class):
             return []
@@ -909,7 +996,18 @@ class ConversionContextBase:
         assert varname not in self.functionDefsAssignedOnce
 
         if self.shouldReadAndWriteVariableFromClosure(varname):
-            self.localVariableExpression(subcontext, ".closure").convert_set_attribute(varname, val_to_store)
+            if self.closureIsByValue:
+                # this is the argument being copied in, which is the only assignment there is
+                slot_ref = self.localVariableExpression(subcontext, varname)
+                converted = val_to_store.convert_to_type(slot_ref.expr_type, ConversionLevel.Signature)
+
+                if converted is None:
+                    return
+
+                slot_ref.convert_copy_initialize(converted)
+            else:
+                self.localVariableExpression(subcontext, ".closure").convert_set_attribute(varname, val_to_store)
+
             subcontext.markVariableInitialized(varname)
             return
 
@@ -1097,6 +1195,7 @@ class FunctionConversionContext(ConversionContextBase):
         globalVarsRaw,
         ast_arg,
         ast,
+        arithmeticOptions=DEFAULT_OPTIONS,
     ):
         super().__init__(
             converter,
@@ -1108,12 +1207,16 @@ class FunctionConversionContext(ConversionContextBase):
             closureVarnames,
             globalVars,
             globalVarsRaw,
+            arithmeticOptions,
         )
 
         self._statements = statements = self.extractStatements(ast)
+        self._scalarReplacedStatements = None
 
         self.variablesAssigned = computeAssignedVariables(statements)
-        self.variablesBound = computeFunctionArgVariables(ast_arg) | set(closureVarnames)
+        argVariables = computeFunctionArgVariables(ast_arg)
+
+        self.variablesBound = argVariables | set(closureVarnames)
 
         # the set of variables that are captured in closures in this function.
         # this includes recursive functions, which will not be in the closure itself
@@ -1158,6 +1261,18 @@ class FunctionConversionContext(ConversionContextBase):
             [c for c in self.variablesReadByClosures if c not in self.functionDefsAssignedOnce]
         )
 
+        # if our closures only read arguments that we never reassign, nobody can see a
+        # change to them after they're captured, so the closure can hold copies.
+        # 'variablesAssigned' only counts assignments in the body at this point.
+        self.closureIsByValue = (
+            bool(self.variablesNeedingClosureSlots)
+            and not self.isGenerator
+            and all(
+                name in argVariables and name not in self.variablesAssigned
+                for name in self.variablesNeedingClosureSlots
+            )
+        )
+
         self._constructInitialVarnameToType()
 
     @property
@@ -1200,12 +1315,40 @@ class FunctionConversionContext(ConversionContextBase):
 
     def convert_function_body(self, variableStates: FunctionStackState):
         return self.convert_statement_list_ast(
-            rewriteForLoops(self._statements) if self.isGenerator else self._statements,
+            rewriteForLoops(self._statements) if self.isGenerator else self.statementsWithInstancesScalarReplaced(),
             variableStates,
             ControlFlowBlocks(),
             toplevel=True,
         )
 
+    def statementsWithInstancesScalarReplaced(self):
+        """Our statements, with Class instances that never escape the function replaced by their members.
+
+        Constructing a Class means a malloc, refcounting, and a free. If all we ever
+        do with an instance is read and write its members, we can keep each member
+        in its own local variable instead, which is as cheap as a local can be.
+        """
+        if self._scalarReplacedStatements is None:
+            def lookupClass(name):
+                if self.isLocalVariable(name) or self.isClosureVariable(name):
+                    return None
+
+                return self.freeVariableLookup(name)
+
+            replacements = findScalarReplaceableInstances(
+                self._statements,
+                lookupClass,
+                lambda name: name not in self.variablesBound and name not in self.variablesReadByClosures,
+                lambda T: _isArithmeticType(T) or T in (str, bytes)
+            )
+
+            if replacements:
+                self._scalarReplacedStatements = scalarReplaceInstances(self._statements, replacements)
+            else:
+                self._scalarReplacedStatements = self._statements
+
+        return self._scalarReplacedStatements
+
     def convert_delete(self, expression, variableStates):
         """Convert the target of a 'del' statement.
 
@@ -1399,6 +1542,7 @@ class FunctionConversionContext(ConversionContextBase):
             return to the caller. If false, then we can assume that the code throws an
             exception or 'returns' from the function.
         """
+        self.currentLineNumber = ast.line_number
 
         try:
             return self._convert_statement_ast(ast, variableStates, controlFlowBlocks)
@@ -1897,6 +2041,20 @@ class FunctionConversionContext(ConversionContextBase):
             return (complete, ((body_returns and orelse_returns) or working_returns) and final_returns)
 
         if ast.matches.For:
+            inlined = self._inlineGeneratorIntoLoop(ast)
+            if inlined is not None:
+                generatorCode, statements = inlined
+
+                self._generatorsBeingInlined.append(generatorCode)
+                try:
+                    return self.convert_statement_list_ast(statements, variableStates, controlFlowBlocks)
+                finally:
+                    self._generatorsBeingInlined.pop()
+
+            hoisted = self._hoistBoundsChecksOutOfLoop(ast, variableStates)
+            if hoisted is not None:
+                return self.convert_statement_list_ast(hoisted, variableStates, controlFlowBlocks)
+
             context = ExpressionConversionContext(self, variableStates)
 
             to_iterate = context.convert_expression_ast(ast.iter)
@@ -2174,6 +2332,131 @@ class FunctionConversionContext(ConversionContextBase):
 
         raise ConversionException("Can't handle python ast Statement.%s" % ast.Name)
 
+    def _inlineGeneratorIntoLoop(self, ast):
+        """Rewrite 'for x in gen(...)' to run the body of 'gen' in place, if we can.
+
+        Otherwise we'd build a generator object on the heap and make a virtual
+        '__next__' call for every value it produces. We can only do this if 'gen' is
+        a global generator function simple enough for 'InlinableGenerator', and every
+        global it refers to means the same thing here.
+
+        Returns:
+            None, or a pair (code, statements) of the generator's code object and the
+            statements to convert in place of 'ast'.
+        """
+        call = ast.iter
+
+        if not call.matches.Call or not call.func.matches.Name or call.keywords:
+            return None
+
+        if any(a.matches.Starred for a in call.args):
+            return None
+
+        if self.isLocalVariable(call.func.id) or self.isClosureVariable(call.func.id):
+            return None
+
+        generator = InlinableGenerator.fromFunction(self.freeVariableLookup(call.func.id))
+
+        if generator is None or len(generator.argNames) != len(call.args):
+            return None
+
+        # don't unroll a generator that loops over itself
+        if generator.code in self._generatorsBeingInlined:
+            return None
+
+        for name in generator.freeVariables():
+            found, value = generator.lookupGlobal(name)
+
+            if not found or self.isLocalVariable(name) or self.isClosureVariable(name):
+                return None
+
+            if (name not in self._globals and name not in __builtins__) or self.freeVariableLookup(name) is not value:
+                return None
+
+        return generator.code, inlineGeneratorIntoLoop(ast, generator, call.args)
+
+    def _hoistBoundsChecksOutOfLoop(self, ast, variableStates):
+        """Rewrite 'for i in range(len(x))' so that 'x[i]' doesn't check bounds, if we can.
+
+        If 'x' is a ListOf or TupleOf of numbers, and we can prove the loop body
+        can't change its length, every 'x[i]' in the body is in bounds. We replace
+        them with indexing into 'x.pointerUnsafe(0)', which we compute once, before
+        the loop. That leaves llvm a loop with no early exits and no reloads of the
+        list's layout, which its loop vectorizer can handle.
+
+        Returns a list of statements to convert in place of 'ast', or None.
+        """
+        loopVars = matchRangeOverLenLoop(ast)
+        if loopVars is None:
+            return None
+
+        indexName, containerName = loopVars
+
+        if self.freeVariableLookup("range") is not range or self.freeVariableLookup("len") is not len:
+            return None
+
+        if not self.isLocalVariable(containerName) or self.isClosureVariable(containerName):
+            return None
+
+        def classifyName(name):
+            if self.isClosureVariable(name):
+                return None
+
+            if not self.isLocalVariable(name):
+                return ARITHMETIC if isinstance(self.freeVariableLookup(name), (int, float, bool)) else None
+
+            T = variableStates.currentType(name)
+
+            if T is None:
+                return UNKNOWN_LOCAL
+
+            if _isArithmeticType(T):
+                return ARITHMETIC
+
+            category = getattr(T, '__typed_python_category__', None)
+
+            if category in ("ListOf", "TupleOf") and _isArithmeticType(T.ElementType):
+                return LIST_OF_ARITHMETIC if category == "ListOf" else TUPLE_OF_ARITHMETIC
+
+            return None
+
+        if classifyName(containerName) not in (LIST_OF_ARITHMETIC, TUPLE_OF_ARITHMETIC):
+            return None
+
+        if not loopBodyPreservesContainerLengths(
+            ast.body,
+            containerName,
+            indexName,
+            classifyName,
+            lambda name, builtin: self.freeVariableLookup(name) is builtin
+        ):
+            return None
+
+        pointerVarname = f".for.{ast.line_number}.{ast.col_offset}.{containerName}.pointer"
+
+        body = rewriteSubscriptsAsPointerAccesses(ast.body, containerName, indexName, pointerVarname)
+        if body is None:
+            return None
+
+        return [
+            codegen_helpers.assign(
+                pointerVarname,
+                codegen_helpers.makeCallExpr(
+                    codegen_helpers.attr(codegen_helpers.readVar(containerName), "pointerUnsafe"),
+                    codegen_helpers.const(0)
+                )
+            ),
+            python_ast.Statement.For(
+                target=ast.target,
+                iter=ast.iter,
+                body=body,
+                orelse=ast.orelse,
+                line_number=ast.line_number,
+                col_offset=ast.col_offset,
+                filename=ast.filename
+            )
+        ]
+
     def convert_iteration_expression(self, to_iterate, ast, variableSuffix, controlFlowBlocks):
         """Convert the 'For' statement in 'ast', where to_iterate is the iterable."""
         context = to_iterate.context
@@ -2221,7 +2504,7 @@ class FunctionConversionContext(ConversionContextBase):
             # can see through better. Eventually, we'd like to be able to pull apart
             # everything we're doing with classes for optimization purposes,
             # but at the moment, this is more expedient.
-            iter_varname = ".iterate_over." + str(ast.line_number) + variableSuffix
+            iter_varname = f".iterate_over.{ast.line_number}.{ast.col_offset}" + variableSuffix
 
             self.assignToLocalVariable(iter_varname, to_iterate, variableStates)
 
@@ -2234,7 +2517,7 @@ class FunctionConversionContext(ConversionContextBase):
             return context.finalize(inner, exceptionsTakeFrom=ast), innerReturns
 
         # create a variable to hold the iterator, and instantiate it there
-        iter_varname = ".iter." + str(ast.line_number) + variableSuffix
+        iter_varname = f".iter.{ast.line_number}.{ast.col_offset}" + variableSuffix
 
         iterator_object = to_iterate.convert_method_call("__iter__", (), {})
         if iterator_object is None:
@@ -2249,7 +2532,7 @@ class FunctionConversionContext(ConversionContextBase):
             # can see through better. Eventually, we'd like to be able to pull apart
             # everything we're doing with classes for optimization purposes,
             # but at the moment, this is more expedient.
-            iter_varname = ".iterate_over." + str(ast.line_number) + variableSuffix
+            iter_varname = f".iterate_over.{ast.line_number}.{ast.col_offset}" + variableSuffix
 
             self.assignToLocalVariable(iter_varname, iterator_object, variableStates)
 
@@ -2591,21 +2874,27 @@ class ComprehensionConversionContextBase(FunctionConversionContext):
     def functionVariableInitializations(self, variableStates):
         context = ExpressionConversionContext(self, variableStates)
 
-        self.localVariableExpression(context, ".comprehension_accumulator").convert_default_initialize()
+        self.initializeAccumulator(context)
 
         return [context.finalize(None)]
 
+    def initializeAccumulator(self, context):
+        self.localVariableExpression(context, ".comprehension_accumulator").convert_default_initialize()
+
     def generateDestructors(self, variableStates):
         destructors = super().generateDestructors(variableStates)
 
         context = ExpressionConversionContext(self, variableStates)
-        accumulator = self.localVariableExpression(context, ".comprehension_accumulator")
-        accumulator.convert_destroy()
+
+        self.destroyAccumulator(context)
 
         nativeDestructor = context.finalize(None)
 
         return destructors + [native_ast.Teardown.Always(expr=nativeDestructor)]
 
+    def destroyAccumulator(self, context):
+        self.localVariableExpression(context, ".comprehension_accumulator").convert_destroy()
+
     def processYieldExpression(self, expr):
         """Called with the body of a yield statement so that subclasses can handle.
 
@@ -2651,6 +2940,30 @@ class ListComprehensionConversionContext(ComprehensionConversionContextBase):
         else:
             return typeWrapper(ListOf(None))
 
+    def convert_iteration_expression(self, to_iterate, ast, variableSuffix, controlFlowBlocks):
+        # if every element of 'to_iterate' becomes exactly one element of the list, and
+        # we know how many there are, size the list once up front rather than growing it.
+        if (
+            ast is presizableLoop(self.statementsWithInstancesScalarReplaced())
+            and to_iterate.expr_type.has_intiter()
+            and self.comprehensionAccumulatorType().typeRepresentation.ElementType is not type(None)
+        ):
+            context = to_iterate.context
+
+            if not to_iterate.isReference:
+                to_iterate = context.pushMove(to_iterate)
+
+            size = to_iterate.convert_intiter_size()
+
+            if size is not None:
+                with context.ifelse(size > 0) as (ifNonempty, ifEmpty):
+                    with ifNonempty:
+                        self.localVariableExpression(context, ".comprehension_accumulator").convert_method_call(
+                            "reserve", [size], {}
+                        )
+
+        return super().convert_iteration_expression(to_iterate, ast, variableSuffix, controlFlowBlocks)
+
     def processYieldExpression(self, expr):
         """Called with the body of a yield statement so that subclasses can handle.
 
@@ -2745,3 +3058,133 @@ class DictComprehensionConversionContext(ComprehensionConversionContextBase):
         )
 
         return TypedDictMasqueradingAsDict(self.comprehensionAccumulatorType().typeRepresentation)
+
+
+class AnyAllComprehensionConversionContextBase(ComprehensionConversionContextBase):
+    """Convert a generator function as the argument to 'any' or 'all'.
+
+    Instead of building a Generator and iterating it, we run the generator's
+    loops directly and return as soon as a yielded value decides the answer.
+    We get converted with a known output type of 'bool'.
+    """
+
+    # the truth value of an element that decides the result, which is also the result
+    decidingTruthValue = None
+
+    def comprehensionAccumulatorType(self):
+        return typeWrapper(bool)
+
+    def processYieldExpression(self, expr):
+        context = expr.context
+
+        with context.ifelse(expr) as (ifTrue, ifFalse):
+            with ifTrue if self.decidingTruthValue else ifFalse:
+                context.pushReturnValue(context.constant(self.decidingTruthValue))
+
+    def handleFlowsOffEnd(self, variableStates: FunctionStackState):
+        subcontext = ExpressionConversionContext(self, variableStates)
+
+        subcontext.pushReturnValue(subcontext.constant(not self.decidingTruthValue))
+
+        return subcontext.finalize(None, exceptionsTakeFrom=None), False
+
+
+class AnyComprehensionConversionContext(AnyAllComprehensionConversionContextBase):
+    decidingTruthValue = True
+
+
+class AllComprehensionConversionContext(AnyAllComprehensionConversionContextBase):
+    decidingTruthValue = False
+
+
+class MinMaxComprehensionConversionContextBase(ComprehensionConversionContextBase):
+    """Convert a generator function as the argument to 'min' or 'max'.
+
+    The accumulator holds the best element we've seen so far. It has the type of
+    the yielded elements and stays uninitialized until the first one arrives, so
+    we track whether we have one in '.comprehension_has_value'.
+    """
+
+    # name of the builtin we implement, for the error message
+    builtinName = None
+
+    # an element replaces the accumulator if 'element <op> accumulator'
+    comparisonOp = None
+
+    def comprehensionAccumulatorType(self):
+        if FunctionYield in self._varname_to_type:
+            return self._varname_to_type[FunctionYield]
+        else:
+            return typeWrapper(None)
+
+    def localVariableExpression(self, context: ExpressionConversionContext, name):
+        if name == ".comprehension_has_value":
+            return TypedExpression(
+                context,
+                native_ast.Expression.StackSlot(name=name, type=native_ast.Bool),
+                typeWrapper(bool),
+                isReference=True,
+            )
+
+        return super().localVariableExpression(context, name)
+
+    def initializeAccumulator(self, context):
+        context.pushEffect(
+            self.localVariableExpression(context, ".comprehension_has_value").expr.store(native_ast.falseExpr)
+        )
+
+    def destroyAccumulator(self, context):
+        with context.ifelse(self.localVariableExpression(context, ".comprehension_has_value")) as (ifTrue, ifFalse):
+            with ifTrue:
+                self.localVariableExpression(context, ".comprehension_accumulator").convert_destroy()
+
+    def processYieldExpression(self, expr):
+        context = expr.context
+        accumulator = self.localVariableExpression(context, ".comprehension_accumulator")
+        hasValue = self.localVariableExpression(context, ".comprehension_has_value")
+
+        if accumulator.expr_type != expr.expr_type:
+            # we're still inferring the yield type, so this pass gets thrown away.
+            return
+
+        with context.ifelse(hasValue) as (ifHasValue, ifEmpty):
+            with ifHasValue:
+                isBetter = expr.convert_bin_op(self.comparisonOp, accumulator)
+
+                if isBetter is not None:
+                    with context.ifelse(isBetter) as (ifBetter, ifNotBetter):
+                        with ifBetter:
+                            accumulator.convert_assign(expr)
+
+            with ifEmpty:
+                accumulator.convert_copy_initialize(expr)
+                context.pushEffect(hasValue.expr.store(native_ast.trueExpr))
+
+    def handleFlowsOffEnd(self, variableStates: FunctionStackState):
+        assert not self._functionOutputTypeKnown
+
+        subcontext = ExpressionConversionContext(self, variableStates)
+
+        with subcontext.ifelse(self.localVariableExpression(subcontext, ".comprehension_has_value")) as (
+            ifHasValue, ifEmpty
+        ):
+            with ifEmpty:
+                subcontext.pushException(ValueError, f"{self.builtinName}() arg is an empty sequence")
+
+        resExpr = self.localVariableExpression(subcontext, ".comprehension_accumulator")
+
+        self.setVariableType(FunctionOutput, resExpr.expr_type)
+
+        subcontext.pushReturnValue(resExpr)
+
+        return subcontext.finalize(None, exceptionsTakeFrom=None), False
+
+
+class MinComprehensionConversionContext(MinMaxComprehensionConversionContextBase):
+    builtinName = "min"
+    comparisonOp = python_ast.ComparisonOp.Lt()
+
+
+class MaxComprehensionConversionContext(MinMaxComprehensionConversionContextBase):
+    builtinName = "max"
+    comparisonOp = python_ast.ComparisonOp.Gt()
@@ -10,3 +10,17 @@ class FunctionMetadata:
 
     def getConstantReturnValue(self):
         return self._constantReturnValue[0] if self._constantReturnValue else None
+
+    def hasSameConstantReturnValueAs(self, other):
+        if not self._constantReturnValue or not other._constantReturnValue:
+            return not self._constantReturnValue and not other._constantReturnValue
+
+        mine, theirs = self._constantReturnValue[0], other._constantReturnValue[0]
+
+        if mine is theirs:
+            return True
+
+        try:
+            return type(mine) is type(theirs) and bool(mine == theirs)
+        except Exception:
+            return False
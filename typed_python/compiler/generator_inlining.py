@@ -0,0 +1,370 @@
+"""Inline the body of a generator into the for loop that consumes it.
+
+Compiling a generator produces a Class holding its frame, and every pass through
+a loop like
+
+    for x in evens(n):
+        total += x
+
+makes a virtual '__next__' call into that state machine. When the generator is
+a plain function we can see, and the loop calls it directly, we can do better:
+run the generator's body in place, with every 'yield v' replaced by the loop
+body. If
+
+    def evens(n):
+        i = 0
+        while i < n:
+            yield i
+            i += 2
+
+then the loop above becomes (with '.evens.<line>.<col>.' in front of the names
+that belong to the generator)
+
+    n = n
+    broke = False
+    while True:
+        i = 0
+        while i < n:
+            while True:
+                x = i
+                total += x
+                break
+            if broke:
+                break
+            i += 2
+        if broke:
+            break
+        break
+
+A 'continue' in the loop body becomes a 'break' out of the 'while True' that
+wraps it, which resumes the generator. A 'break' sets 'broke', and we check it
+after every loop in the generator that could have yielded, which unwinds all
+the way out. The loop's 'else' clause runs only if 'broke' is never set.
+
+We're deliberately conservative about which generators we inline: no 'return',
+no 'try' or 'with', no nested functions or comprehensions, no annotated or
+defaulted arguments, and 'yield' only as a statement. The generator's globals
+must mean the same thing in the function we inline it into.
+"""
+
+import builtins
+import inspect
+import types
+
+import typed_python.python_ast as python_ast
+from typed_python.compiler.codegen_helpers import const
+from typed_python.compiler.python_ast_analysis import computeAssignedVariables, visitPyAstChildren, nodeTypes
+
+_SIMPLE_STATEMENTS = ('Assign', 'AugAssign', 'Expr', 'Pass', 'Break', 'Continue')
+_COMPOUND_STATEMENTS = ('If', 'While', 'For')
+
+
+class InlinableGenerator:
+    """A generator function whose body we can paste into a for loop.
+
+    Attributes:
+        name - the name of the function
+        code - its code object
+        argNames - the names of its (positional, unannotated) arguments
+        statements - its body, as a list of python_ast.Statement
+        globals - a dict holding the values of the globals it refers to
+    """
+    def __init__(self, name, code, argNames, statements, globals):
+        self.name = name
+        self.code = code
+        self.argNames = argNames
+        self.statements = statements
+        self.globals = globals
+
+    @staticmethod
+    def fromFunction(f):
+        """Return an InlinableGenerator for 'f', or None if 'f' isn't a generator we can inline."""
+        if getattr(f, '__typed_python_category__', None) == 'Function':
+            if len(f.overloads) != 1:
+                return None
+
+            overload = f.overloads[0]
+
+            if (
+                overload.closureVarLookups or overload.methodOf is not None
+                or overload.returnType is not None or overload.signatureFunction is not None
+            ):
+                return None
+
+            if any(
+                a.typeFilter is not None or a.defaultValue is not None or a.isStarArg or a.isKwarg
+                for a in overload.args
+            ):
+                return None
+
+            code = overload.functionCode
+            functionGlobals = overload.realizedGlobals
+        elif isinstance(f, types.FunctionType):
+            if f.__closure__ or f.__defaults__ or f.__kwdefaults__ or f.__annotations__:
+                return None
+
+            code = f.__code__
+            functionGlobals = f.__globals__
+        else:
+            return None
+
+        if not code.co_flags & inspect.CO_GENERATOR:
+            return None
+
+        if code.co_flags & (inspect.CO_VARARGS | inspect.CO_VARKEYWORDS) or code.co_kwonlyargcount:
+            return None
+
+        functionDef = python_ast.convertFunctionToAlgebraicPyAst(code)
+
+        if not functionDef.matches.FunctionDef or not _canInline(functionDef.body):
+            return None
+
+        return InlinableGenerator(
+            code.co_name,
+            code,
+            list(code.co_varnames[:code.co_argcount]),
+            functionDef.body,
+            functionGlobals
+        )
+
+    def lookupGlobal(self, name):
+        """Return (True, value) if 'name' is a global or builtin for this function, else (False, None)."""
+        if name in self.globals:
+            return True, self.globals[name]
+
+        if hasattr(builtins, name):
+            return True, getattr(builtins, name)
+
+        return False, None
+
+    def freeVariables(self):
+        """Return the names the body reads that aren't arguments or locals."""
+        localNames = set(self.argNames) | computeAssignedVariables(self.statements)
+        res = set()
+
+        def visit(x):
+            if isinstance(x, python_ast.Expr) and x.matches.Name and x.id not in localNames:
+                res.add(x.id)
+            return True
+
+        visitPyAstChildren(self.statements, visit)
+
+        return res
+
+
+def _isYieldStatement(s):
+    return s.matches.Expr and s.value.matches.Yield
+
+
+def _canInline(statements):
+    """Is every statement in 'statements' one we know how to paste into a loop?"""
+    for s in statements:
+        if s.Name not in _SIMPLE_STATEMENTS and s.Name not in _COMPOUND_STATEMENTS:
+            return False
+
+        if _isYieldStatement(s):
+            if s.value.value is not None and not _isPlainExpression(s.value.value):
+                return False
+        elif s.Name in _SIMPLE_STATEMENTS:
+            if not _isPlainExpression(s):
+                return False
+        else:
+            headers = [s.test] if not s.matches.For else [s.target, s.iter]
+
+            if not all(_isPlainExpression(e) for e in headers):
+                return False
+
+            if not _canInline(s.body) or not _canInline(s.orelse):
+                return False
+
+    return True
+
+
+def _isPlainExpression(node):
+    """True if 'node' has no yields and no nested scopes."""
+    ok = [True]
+
+    def visit(x):
+        if isinstance(x, python_ast.Expr) and (
+            x.matches.Yield or x.matches.YieldFrom or x.matches.Await or x.matches.Lambda
+            or x.matches.ListComp or x.matches.SetComp or x.matches.DictComp or x.matches.GeneratorExp
+        ):
+            ok[0] = False
+            return False
+
+        return True
+
+    visitPyAstChildren(node, visit)
+
+    return ok[0]
+
+
+def _containsYield(s):
+    if _isYieldStatement(s):
+        return True
+
+    if s.Name in _COMPOUND_STATEMENTS:
+        return any(_containsYield(c) for c in s.body) or any(_containsYield(c) for c in s.orelse)
+
+    return False
+
+
+def _renameVariables(node, rename):
+    """Rebuild a python_ast tree, renaming every variable for which 'rename' returns a new name."""
+    if isinstance(node, python_ast.Expr):
+        if node.matches.Name:
+            newName = rename(node.id)
+
+            if newName is not None:
+                return python_ast.Expr.Name(
+                    id=newName,
+                    ctx=node.ctx,
+                    line_number=node.line_number,
+                    col_offset=node.col_offset,
+                    filename=node.filename
+                )
+
+            return node
+
+        if node.matches.Constant:
+            return node
+
+    if isinstance(node, nodeTypes):
+        return type(node)(**{name: _renameVariables(getattr(node, name), rename) for name in node.ElementType.ElementNames})
+
+    if isinstance(node, list) or getattr(type(node), '__typed_python_category__', None) == 'TupleOf':
+        return [_renameVariables(x, rename) for x in node]
+
+    return node
+
+
+def _redirectLoopControl(statements, onBreak, onContinue):
+    """Replace the 'break' and 'continue' statements that belong to the loop whose body is 'statements'.
+
+    We leave the bodies of nested loops (and nested scopes) alone, but not their
+    'else' clauses, since a 'break' there belongs to us.
+    """
+    res = []
+
+    for s in statements:
+        if s.matches.Break:
+            res.extend(onBreak(s))
+        elif s.matches.Continue:
+            res.extend(onContinue(s))
+        elif s.matches.If:
+            res.append(_withFields(s, body=_redirectLoopControl(s.body, onBreak, onContinue),
+                                   orelse=_redirectLoopControl(s.orelse, onBreak, onContinue)))
+        elif s.matches.For or s.matches.While:
+            res.append(_withFields(s, orelse=_redirectLoopControl(s.orelse, onBreak, onContinue)))
+        elif s.matches.With:
+            res.append(_withFields(s, body=_redirectLoopControl(s.body, onBreak, onContinue)))
+        elif s.matches.Try:
+            res.append(
+                _withFields(
+                    s,
+                    body=_redirectLoopControl(s.body, onBreak, onContinue),
+                    handlers=[
+                        _withFields(h, body=_redirectLoopControl(h.body, onBreak, onContinue)) for h in s.handlers
+                    ],
+                    orelse=_redirectLoopControl(s.orelse, onBreak, onContinue),
+                    finalbody=_redirectLoopControl(s.finalbody, onBreak, onContinue)
+                )
+            )
+        else:
+            res.append(s)
+
+    return res
+
+
+def _withFields(node, **fields):
+    return type(node)(**{name: fields.get(name, getattr(node, name)) for name in node.ElementType.ElementNames})
+
+
+def inlineGeneratorIntoLoop(loop, generator, args):
+    """Rewrite 'for <target> in generator(*args): ...' so it runs the generator's body in place.
+
+    Args:
+        loop - the python_ast.Statement.For
+        generator - an InlinableGenerator
+        args - the python_ast.Expr arguments 'loop' passes to the generator
+
+    Returns:
+        a list of python_ast.Statement to run in place of 'loop'.
+    """
+    prefix = f".{generator.name}.{loop.line_number}.{loop.col_offset}."
+    brokeVarname = prefix + ".broke"
+    localNames = set(generator.argNames) | computeAssignedVariables(generator.statements)
+
+    def at(**kwargs):
+        return dict(line_number=loop.line_number, col_offset=loop.col_offset, filename=loop.filename, **kwargs)
+
+    def name(varname, ctx):
+        return python_ast.Expr.Name(**at(id=varname, ctx=ctx))
+
+    def assign(varname, value):
+        return python_ast.Statement.Assign(**at(targets=(name(varname, python_ast.ExprContext.Store()),), value=value))
+
+    def breakOut():
+        return python_ast.Statement.Break(**at())
+
+    def ifBrokeBreak():
+        return python_ast.Statement.If(
+            **at(test=name(brokeVarname, python_ast.ExprContext.Load()), body=[breakOut()], orelse=[])
+        )
+
+    # 'continue' resumes the generator, 'break' abandons it
+    loopBody = _redirectLoopControl(
+        loop.body,
+        lambda s: [assign(brokeVarname, const(True)), breakOut()],
+        lambda s: [breakOut()]
+    )
+
+    def runLoopBody(yieldStatement):
+        value = yieldStatement.value.value
+
+        return [
+            python_ast.Statement.While(
+                **at(
+                    test=const(True),
+                    body=[
+                        python_ast.Statement.Assign(
+                            **at(targets=(loop.target,), value=value if value is not None else const(None))
+                        )
+                    ] + loopBody + [breakOut()],
+                    orelse=[]
+                )
+            ),
+            ifBrokeBreak()
+        ]
+
+    def inline(statements):
+        res = []
+
+        for s in statements:
+            if _isYieldStatement(s):
+                res.extend(runLoopBody(s))
+            elif s.Name in _COMPOUND_STATEMENTS:
+                res.append(_withFields(s, body=inline(s.body), orelse=inline(s.orelse)))
+
+                if (s.matches.For or s.matches.While) and _containsYield(s):
+                    res.append(ifBrokeBreak())
+            else:
+                res.append(s)
+
+        return res
+
+    body = _renameVariables(generator.statements, lambda n: prefix + n if n in localNames else None)
+
+    res = [assign(prefix + argName, arg) for argName, arg in zip(generator.argNames, args)]
+    res.append(assign(brokeVarname, const(False)))
+    res.append(python_ast.Statement.While(**at(test=const(True), body=inline(body) + [breakOut()], orelse=[])))
+
+    if loop.orelse:
+        res.append(
+            python_ast.Statement.If(
+                **at(test=name(brokeVarname, python_ast.ExprContext.Load()), body=[python_ast.Statement.Pass(**at())],
+                     orelse=loop.orelse)
+            )
+        )
+
+    return res
@@ -56,6 +56,15 @@ GlobalVariableMetadata = Alternative(
         argTupleType=object,
         kwargTupleType=object
     ),
+    # counters written by code compiled for profiling. Their values live
+    # in the global itself.
+    EntryCounter=dict(functionName=str),
+    BranchCounters=dict(functionName=str, branchIndex=int),
+    # the counters of an instrumented function (see instrumentation.py)
+    InstrumentationCounters=dict(functionName=str),
+    # the PyAttributeCache of a compiled 'getattr' on a python object. It
+    # starts out zeroed and the runtime fills it in.
+    PyAttributeCache=dict(attr=str),
     __repr__=metadataRepr
 )
 
@@ -0,0 +1,131 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""Counters compiled code keeps about itself, for finding unexpectedly slow paths.
+
+An instrumented function counts
+
+    calls - how many times it was called
+    cycles - the cpu cycles (llvm.readcyclecounter, i.e. rdtsc on x86) between
+        entering it and returning from it, summed over the calls that returned
+        normally. This includes the time spent in the functions it calls.
+    pythonObjectCalls - how many times it called into the interpreter to operate
+        on a python object ('np_pyobj_*' and friends). These are the silent
+        fallbacks that happen when type inference can't see a concrete type.
+
+Ask for it per function with
+
+    @Entrypoint(instrument=True)
+    def f(...):
+        ...
+
+which, like 'nogil', also instruments the functions 'f' calls (they get converted
+again, under their own names), or for everything compiled from now on with
+TP_COMPILER_INSTRUMENT=1 or 'instrumentEverything()'. Instrumented code has
+different link names from uninstrumented code, so the two coexist in the
+compiler cache.
+
+Read the counters with 'Runtime.singleton().getProfile()', which returns a dict
+from link name to dict(calls=, cycles=, pythonObjectCalls=). Compiled code
+updates the counters with relaxed atomic adds, so counts from many threads are
+exact, at the cost of some cache-line contention on functions that several
+threads call at once.
+"""
+
+import os
+import threading
+
+
+# the slots in each function's array of counters
+CALLS = 0
+CYCLES = 1
+PYTHON_OBJECT_CALLS = 2
+COUNTER_COUNT = 3
+
+COUNTER_NAMES = ("calls", "cycles", "pythonObjectCalls")
+
+# code objects of functions that opted in
+_instrumentedCodes = set()
+
+_instrumentEverything = [os.getenv("TP_COMPILER_INSTRUMENT") == "1"]
+
+# external functions with 'pyobj' in their names that don't reach into the interpreter
+_NOT_FALLBACKS = {"np_destroy_pyobj_handle", "nativepython_runtime_get_pyobj_None"}
+
+
+def setInstrumented(code):
+    """Make functions with code object 'code' (and those nested inside it) instrumented."""
+    _instrumentedCodes.add(code)
+
+    for const in code.co_consts:
+        if isinstance(const, type(code)):
+            setInstrumented(const)
+
+
+def instrumentEverything():
+    """Instrument every function we convert from now on."""
+    _instrumentEverything[0] = True
+
+
+def isInstrumented(code):
+    return _instrumentEverything[0] or code in _instrumentedCodes
+
+
+def isPythonObjectFallback(externalFunctionName):
+    """Is a call to the external function with this name a call into the interpreter?"""
+    return "pyobj" in externalFunctionName and externalFunctionName not in _NOT_FALLBACKS
+
+
+class InstrumentationCounters:
+    """The counters of all the instrumented code loaded into this process.
+
+    LoadedModule.linkGlobalVariables hands us a pointer to each function's counters
+    as it links them. A function may have been repeated into several modules, in
+    which case we sum its counters.
+    """
+    def __init__(self):
+        self._lock = threading.Lock()
+
+        # link name -> list of PointerTo(int), each to COUNTER_COUNT counters
+        self._counters = {}
+
+    def addCounters(self, name, pointer):
+        with self._lock:
+            self._counters.setdefault(name, []).append(pointer)
+
+    def snapshot(self, reset=False):
+        """Return a dict from link name to dict(calls=, cycles=, pythonObjectCalls=).
+
+        If 'reset', zero the counters as we go, so that the next snapshot only holds
+        what happened after this one. Updates that race with the reset may be lost.
+        """
+        def read(pointer):
+            res = pointer.get()
+
+            if reset:
+                pointer.set(0)
+
+            return res
+
+        with self._lock:
+            return {
+                name: {
+                    counterName: sum(read(p + slot) for p in pointers)
+                    for slot, counterName in enumerate(COUNTER_NAMES)
+                }
+                for name, pointers in self._counters.items()
+            }
+
+
+liveInstrumentation = InstrumentationCounters()
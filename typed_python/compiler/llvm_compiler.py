@@ -16,22 +16,81 @@ import llvmlite.binding as llvm
 import llvmlite.ir
 import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler.native_ast_to_llvm as native_ast_to_llvm
+import typed_python.compiler.perf_map as perf_map
+import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 
 from typed_python.compiler.loaded_module import LoadedModule
 from typed_python.compiler.native_function_pointer import NativeFunctionPointer
 from typed_python.compiler.binary_shared_object import BinarySharedObject
+from typed_python.compiler.module_definition import ModuleDefinition
+from typed_python.compiler.compilation_profiler import (
+    compilationProfiler, LLVM_IR, OPTIMIZE, CODEGEN, FINALIZE
+)
 
 import ctypes
+import hashlib
+import itertools
+import os
+from concurrent.futures import ThreadPoolExecutor
 from typed_python import _types
 
 llvm.initialize()
 llvm.initialize_native_target()
 llvm.initialize_native_asmprinter()  # yes, even this one
 
+
+def resolveTargetCpu(cpuName):
+    """Return the llvm (cpu, features) to compile for, given a cpu name.
+
+    'host' means the cpu we're running on, with every feature it supports.
+    """
+    if cpuName == "host":
+        return llvm.get_host_cpu_name(), llvm.get_host_cpu_features().flatten()
+
+    return cpuName, ""
+
+
+# if TP_COMPILER_TARGET_CPU is set (to 'host' or an llvm cpu name like 'skylake'),
+# we generate code for that cpu rather than for the generic one, so that we can
+# use instructions like AVX2 in vectorized loops.
+target_cpu, target_features = resolveTargetCpu(os.getenv("TP_COMPILER_TARGET_CPU") or "")
+
+# if TP_COMPILER_MULTIVERSION is set, each shared object we build for the compiler
+# cache also gets a variant for each of the ';'-separated llvm feature strings it
+# lists (like '+avx2,+fma;+avx512f,+avx512bw'), most specific first. Processes
+# loading the module from the cache use the first variant their cpu supports.
+multiversion_features = [f for f in (os.getenv("TP_COMPILER_MULTIVERSION") or "").split(";") if f]
+
 target_triple = llvm.get_process_triple()
 target = llvm.Target.from_triple(target_triple)
-target_machine = target.create_target_machine()
-target_machine_shared_object = target.create_target_machine(reloc='pic', codemodel='default')
+target_machine = target.create_target_machine(cpu=target_cpu, features=target_features)
+target_machine_shared_object = target.create_target_machine(
+    cpu=target_cpu, features=target_features, reloc='pic', codemodel='default'
+)
+
+
+def targetCacheSubdirectory():
+    """Return the compiler cache subdirectory for code built for our target cpu.
+
+    Code built for a specific cpu can't be shared with processes on other machines,
+    so it lives in a subdirectory keyed by the cpu and its features. Code built for
+    the generic cpu lives at the top level. Code built for thread-confined refcounts
+    isn't safe to load into a process that shares objects between threads, so it
+    gets its own subdirectory too, as does code that maintains type live counters.
+    """
+    threadConfined = native_ast_to_llvm.thread_confined_refcounts
+    liveCounters = runtime_functions.type_live_counters
+
+    if not target_cpu and not target_features and not threadConfined and not liveCounters:
+        return None
+
+    return "target_" + hashlib.sha1(
+        (
+            target_cpu + ";" + target_features
+            + (";thread_confined" if threadConfined else "")
+            + (";type_live_counters" if liveCounters else "")
+        ).encode("utf8")
+    ).hexdigest()[:16]
 
 ctypes.CDLL(_types.__file__, mode=ctypes.RTLD_GLOBAL)
 
@@ -57,40 +116,78 @@ def sizeof_native_type(native_type):
 # there can be only one llvm engine alive at once.
 _engineCache = []
 
+# the suffix we give to the functions in an optimized copy of a module that
+# we first compiled at a low optimization level, so they don't collide with
+# the originals.
+TIER_UP_SUFFIX = ".tier_up"
+
+# the optimization level we use for the first build of a module when the
+# compiler is tiered.
+TIER_ONE_OPT_LEVEL = 1
+
+# 'buildModules' gives each module's '.get_global_variables' accessor a distinct
+# name ending in this plus a counter, since they all get loaded in one go.
+PARALLEL_ACCESSOR_SUFFIX = ".parallel_"
 
-def create_execution_engine(inlineThreshold):
-    if _engineCache:
-        return _engineCache[0]
 
+def create_pass_manager(optLevel, inlineThreshold, machine=None):
     pmb = llvm.create_pass_manager_builder()
-    pmb.opt_level = 3
+    pmb.opt_level = optLevel
     pmb.size_level = 0
     pmb.inlining_threshold = inlineThreshold
-    pmb.loop_vectorize = True
-    pmb.slp_vectorize = True
+    pmb.loop_vectorize = optLevel >= 3
+    pmb.slp_vectorize = optLevel >= 3
 
     pass_manager = llvm.create_module_pass_manager()
     pmb.populate(pass_manager)
 
-    target_machine.add_analysis_passes(pass_manager)
+    (machine or target_machine).add_analysis_passes(pass_manager)
 
-    # And an execution engine with an empty backing module
+    return pass_manager
+
+
+def create_execution_engine():
+    if _engineCache:
+        return _engineCache[0]
+
+    # an execution engine with an empty backing module
     backing_mod = llvm.parse_assembly("")
     engine = llvm.create_mcjit_compiler(backing_mod, target_machine)
 
-    _engineCache.append((engine, pass_manager))
+    # so perf_map can see the sizes of functions we load with 'add_module'
+    engine.set_object_cache(perf_map.noteCompiledObject)
+
+    _engineCache.append(engine)
 
-    return engine, pass_manager
+    return engine
 
 
 class Compiler:
-    def __init__(self, inlineThreshold):
-        self.engine, self.module_pass_manager = create_execution_engine(inlineThreshold)
+    def __init__(self, inlineThreshold, tiered=False, parallelism=1):
+        """Initialize a Compiler.
+
+        Args:
+            inlineThreshold - the llvm inlining threshold to use.
+            tiered - if True, 'buildModule' optimizes lightly so that new code is
+                ready to run sooner, and remembers each module it builds so that
+                'compileOptimizedModule' can produce a fully optimized copy of it
+                later if it turns out to be hot.
+            parallelism - the number of threads 'buildModules' may use to optimize
+                and generate code.
+        """
+        self.engine = create_execution_engine()
         self.converter = native_ast_to_llvm.Converter()
         self.functions_by_name = {}
         self.inlineThreshold = inlineThreshold
         self.verbose = False
         self.optimize = True
+        self.tiered = tiered
+        self.parallelism = parallelism
+
+        self._accessorCounter = itertools.count()
+
+        # function name -> the ModuleDefinition we built it in at tier one
+        self._tierOneModules = {}
 
     def markExternal(self, functionNameToType):
         """Provide type signatures for a set of external functions."""
@@ -102,30 +199,65 @@ class Compiler:
     def mark_llvm_codegen_verbose(self):
         self.verbose = True
 
-    def buildSharedObject(self, functions):
-        """Add native definitions and return a BinarySharedObject representing the compiled code."""
-        module = self.converter.add_functions(functions)
+    def instrumentForProfiling(self):
+        """Make the code we build from now on count its calls and branch outcomes."""
+        self.converter.instrumentForProfiling = True
 
-        try:
-            mod = llvm.parse_assembly(module.moduleText)
-            mod.verify()
-        except Exception:
-            print("failing: ", module)
-            raise
+    def instrumentFunction(self, name):
+        """Make the function with link name 'name' keep the counters in instrumentation.py."""
+        self.converter.instrumentedFunctions.add(name)
+
+    def useExecutionProfile(self, profile):
+        """Use an ExecutionProfile to guide how we optimize the code we build from now on."""
+        self.converter.profile = profile
 
-        # Now add the module and make sure it is ready for execution
-        self.engine.add_module(mod)
+    def buildSharedObject(self, functions, importableDefinitions=None):
+        """Add native definitions and return a BinarySharedObject representing the compiled code.
+
+        Args:
+            functions - a map from name to native_ast.Function
+            importableDefinitions - None, or a map from the names of functions defined
+                in shared objects we've loaded to their native_ast.Function. llvm may
+                inline the ones 'functions' call, but we don't define them again.
+        """
+        with compilationProfiler.phase(
+            "add_functions", LLVM_IR, functions=len(functions), importable=len(importableDefinitions or ())
+        ):
+            module = self.converter.add_functions(functions, importableDefinitions)
+
+            # we load the code from the shared object, so the execution engine never
+            # sees this module, and it gets a private context so that its types and
+            # constants go away with it.
+            try:
+                mod = llvm.parse_assembly(module.moduleText, context=llvm.create_context())
+                mod.verify()
+            except Exception:
+                print("failing: ", module)
+                raise
 
         if self.optimize:
-            self.module_pass_manager.run(mod)
+            with compilationProfiler.phase("module_pass_manager", OPTIMIZE):
+                create_pass_manager(3, self.inlineThreshold, target_machine_shared_object).run(mod)
 
-        self.engine.finalize_object()
+        variants = {}
 
-        return BinarySharedObject.fromModule(
-            mod,
-            module.globalVariableDefinitions,
-            module.functionNameToType,
-        )
+        for features in multiversion_features:
+            variants[features] = self._emitObject(
+                module.moduleText,
+                3,
+                lambda name: name,
+                target.create_target_machine(features=features, reloc='pic', codemodel='default')
+            )
+
+        # this generates the module's code again, position-independent, and links it
+        with compilationProfiler.phase("emitSharedObject", CODEGEN, variants=len(variants)):
+            return BinarySharedObject.fromModule(
+                mod,
+                module.globalVariableDefinitions,
+                module.functionNameToType,
+                target_machine_shared_object,
+                variants
+            )
 
     def function_pointer_by_name(self, name):
         return self.functions_by_name.get(name)
@@ -133,58 +265,221 @@ class Compiler:
     def buildModule(self, functions):
         """Compile a list of functions into a new module.
 
+        Like 'buildModules', we hand the execution engine an object file rather
+        than the module itself, since MCJIT would keep a module's IR alive for as
+        long as the process runs.
+
         Args:
             functions - a map from name to native_ast.Function
 
         Returns:
-            None, or a LoadedModule object.
+            None, or a LoadedModule object whose global variables haven't been
+            linked yet.
         """
         if not functions:
             return None
 
-        # module is a ModuleDefinition object
-        module = self.converter.add_functions(functions)
+        return self.buildModules([functions])[0]
+
+    def buildModules(self, groups):
+        """Compile several groups of functions into one module each, in parallel.
+
+        The groups may call each other. We convert them all to llvm IR (which is
+        pure python, so there's nothing to gain from threads), then parse, optimize
+        and generate code for each module on its own thread with its own llvm
+        context. llvmlite releases the GIL while llvm works, so this scales with
+        the number of modules. Finally we load all the object files into the
+        engine and link them together in one step.
+
+        Args:
+            groups - a list of maps from name to native_ast.Function
+
+        Returns:
+            a list of LoadedModule objects, one per group, whose global variables
+            haven't been linked yet.
+        """
+        with compilationProfiler.phase("add_function_groups", LLVM_IR, groups=len(groups)):
+            modules = self.converter.add_function_groups(groups)
+
+        accessorNames = [
+            ModuleDefinition.GET_GLOBAL_VARIABLES_NAME + PARALLEL_ACCESSOR_SUFFIX + str(next(self._accessorCounter))
+            for _ in modules
+        ]
+
+        optLevel = TIER_ONE_OPT_LEVEL if self.tiered else 3
+
+        def compileOne(moduleAndAccessorName):
+            module, accessorName = moduleAndAccessorName
+
+            return self._emitObject(
+                module.moduleText,
+                optLevel,
+                lambda name: accessorName if name == ModuleDefinition.GET_GLOBAL_VARIABLES_NAME else name
+            )
+
+        with ThreadPoolExecutor(max_workers=min(self.parallelism, len(modules))) as pool:
+            objects = list(pool.map(compileOne, zip(modules, accessorNames)))
+
+        # the modules refer to each other, so we can only finalize once they're all in
+        with compilationProfiler.phase("finalize_object", FINALIZE, objects=len(objects)):
+            for objectBytes in objects:
+                self.engine.add_object_file(llvm.ObjectFileRef.from_data(objectBytes))
+
+            self.engine.finalize_object()
+
+        functionSizes = {}
+        if perf_map.perfMapEnabled():
+            for objectBytes in objects:
+                functionSizes.update(perf_map.functionSizesInElf(objectBytes))
+
+        loadedModules = []
+
+        for functions, module, accessorName in zip(groups, modules, accessorNames):
+            if self.tiered:
+                for fname in functions:
+                    self._tierOneModules[fname] = module
+
+            native_function_pointers = {}
+
+            for fname in functions:
+                native_function_pointers[fname] = NativeFunctionPointer(
+                    fname,
+                    self.engine.get_function_address(fname),
+                    [x[1] for x in functions[fname].args],
+                    functions[fname].output_type
+                )
+                self.functions_by_name[fname] = native_function_pointers[fname]
+
+            perf_map.recordFunctions(
+                {fname: native_function_pointers[fname].fp for fname in functions},
+                functionSizes
+            )
+
+            native_function_pointers[module.GET_GLOBAL_VARIABLES_NAME] = NativeFunctionPointer(
+                module.GET_GLOBAL_VARIABLES_NAME,
+                self.engine.get_function_address(accessorName),
+                [native_ast.Void.pointer().pointer()],
+                native_ast.Void
+            )
+
+            loadedModules.append(
+                LoadedModule(native_function_pointers, module.globalVariableDefinitions)
+            )
+
+        return loadedModules
+
+    def _emitObject(self, moduleText, optLevel, renameFunction, machine=None):
+        """Parse, optimize, and generate code for a module in a private llvm context.
+
+        This doesn't touch the execution engine or llvm's global context, so it's safe
+        to call from any thread without holding the runtime lock.
+
+        Args:
+            moduleText - the llvm IR of the module
+            optLevel - the optimization level to run at
+            renameFunction - a function from the name of each function the module
+                defines to the name it should have in the object file.
+            machine - the llvm TargetMachine to generate code with. By default,
+                a fresh one like the execution engine's.
+
+        Returns:
+            the bytes of an object file.
+        """
+        context = llvm.create_context()
 
         try:
-            mod = llvm.parse_assembly(module.moduleText)
+            mod = llvm.parse_assembly(moduleText, context=context)
+
+            for func in mod.functions:
+                if not func.is_declaration:
+                    newName = renameFunction(func.name)
+
+                    if newName != func.name:
+                        func.name = newName
+
             mod.verify()
         except Exception:
-            print("failing: ", module)
+            print("failing: ", moduleText)
             raise
 
-        # Now add the module and make sure it is ready for execution
-        self.engine.add_module(mod)
+        if machine is None:
+            machine = target.create_target_machine(cpu=target_cpu, features=target_features)
 
         if self.optimize:
-            self.module_pass_manager.run(mod)
+            with compilationProfiler.phase("pass_manager", OPTIMIZE, optLevel=optLevel):
+                create_pass_manager(optLevel, self.inlineThreshold, machine).run(mod)
 
         if self.verbose:
             print(mod)
 
-        self.engine.finalize_object()
+        with compilationProfiler.phase("emit_object", CODEGEN):
+            return machine.emit_object(mod)
 
-        # Look up the function pointer (a Python int)
-        native_function_pointers = {}
+    def memoryStats(self):
+        """Return a dict describing what we're holding on to for the code we've built.
+
+        This has the keys of 'Converter.memoryStats', plus 'tierOneModules', the number
+        of tier-one modules we keep so we can optimize them later, and
+        'tierOneModuleBytes', the size of their llvm IR.
+        """
+        tierOneModules = {id(m): m for m in self._tierOneModules.values()}
+
+        return dict(
+            self.converter.memoryStats(),
+            tierOneModules=len(tierOneModules),
+            tierOneModuleBytes=sum(len(m.moduleText) for m in tierOneModules.values())
+        )
+
+    def tierOneModuleFor(self, name):
+        """Return the ModuleDefinition we built 'name' in at tier one, or None."""
+        return self._tierOneModules.get(name)
+
+    def compileOptimizedModule(self, moduleDefinition):
+        """Produce a fully optimized object file from a module we built at tier one.
+
+        This doesn't touch the execution engine or llvm's global context, so it's safe
+        to run on a background thread without holding the runtime lock. Every function
+        the module defines gets TIER_UP_SUFFIX appended to its name, so the new copy
+        can live alongside the original.
+
+        Returns:
+            the bytes of an object file, to pass to 'loadOptimizedModule'.
+        """
+        return self._emitObject(moduleDefinition.moduleText, 3, lambda name: name + TIER_UP_SUFFIX)
 
-        for fname in functions:
-            func_ptr = self.engine.get_function_address(fname)
-            input_types = [x[1] for x in functions[fname].args]
-            output_type = functions[fname].output_type
+    def loadOptimizedModule(self, moduleDefinition, objectBytes):
+        """Load the output of 'compileOptimizedModule' into the execution engine.
 
+        The caller must hold the runtime lock.
+
+        Returns:
+            a LoadedModule whose function pointers are keyed by the original names,
+            with its global variables already linked.
+        """
+        with compilationProfiler.phase("finalize_object", FINALIZE):
+            self.engine.add_object_file(llvm.ObjectFileRef.from_data(objectBytes))
+            self.engine.finalize_object()
+
+        native_function_pointers = {}
+
+        for fname, fType in moduleDefinition.functionNameToType.items():
             native_function_pointers[fname] = NativeFunctionPointer(
-                fname, func_ptr, input_types, output_type
+                fname,
+                self.engine.get_function_address(fname + TIER_UP_SUFFIX),
+                fType.args,
+                fType.output
             )
-            self.functions_by_name[fname] = native_function_pointers[fname]
 
-        native_function_pointers[module.GET_GLOBAL_VARIABLES_NAME] = (
-            NativeFunctionPointer(
-                module.GET_GLOBAL_VARIABLES_NAME,
-                self.engine.get_function_address(
-                    module.GET_GLOBAL_VARIABLES_NAME
-                ),
-                [native_ast.Void.pointer().pointer()],
-                native_ast.Void
+        if perf_map.perfMapEnabled():
+            perf_map.recordFunctions(
+                {
+                    fname + TIER_UP_SUFFIX: fp.fp
+                    for fname, fp in native_function_pointers.items()
+                },
+                perf_map.functionSizesInElf(objectBytes)
             )
-        )
 
-        return LoadedModule(native_function_pointers, module.globalVariableDefinitions)
+        loaded = LoadedModule(native_function_pointers, moduleDefinition.globalVariableDefinitions)
+        loaded.linkGlobalVariables()
+
+        return loaded
@@ -1,6 +1,8 @@
 from typed_python.compiler.module_definition import ModuleDefinition
 from typed_python import PointerTo, ListOf, Class
 from typed_python import _types
+from typed_python.compiler.execution_profile import liveCounters
+from typed_python.compiler.instrumentation import liveInstrumentation
 
 
 class LoadedModule:
@@ -125,3 +127,12 @@ class LoadedModule:
                 pointers[i].cast(int).initialize(
                     _types.getTypePointer(meta.value)
                 )
+
+            elif meta.matches.EntryCounter:
+                liveCounters.addEntryCounter(meta.functionName, pointers[i].cast(int))
+
+            elif meta.matches.BranchCounters:
+                liveCounters.addBranchCounters(meta.functionName, meta.branchIndex, pointers[i].cast(int))
+
+            elif meta.matches.InstrumentationCounters:
+                liveInstrumentation.addCounters(meta.functionName, pointers[i].cast(int))
@@ -48,6 +48,8 @@ def type_str(c):
         return "void"
     if c.matches.Array:
         return str(c.element_type) + "[" + str(c.count) + "]"
+    if c.matches.Vector:
+        return "<" + str(c.count) + " x " + str(c.element_type) + ">"
 
     assert False, type(c)
 
@@ -64,6 +66,9 @@ Type = Type.define(Alternative(
     Int={'bits': int, 'signed': bool},
     Struct={'element_types': TupleOf(Tuple(str, Type)), 'name': str},
     Array={'element_type': Type, 'count': int},
+    # an llvm vector of 'count' ints or floats, which arithmetic and comparison
+    # operate on lane by lane. Comparisons produce a Vector of Bool.
+    Vector={'element_type': Type, 'count': int},
     Function={'output': Type, 'args': TupleOf(Type), 'varargs': bool, 'can_throw': bool},
     Pointer={'value_type': Type},
     attr_ix=type_attr_ix,
@@ -312,12 +317,26 @@ def expr_str(self):
         return "(" + str(self.ptr) + ")[0]=" + str(self.val)
     if self.matches.AtomicAdd:
         return "atomic_add(" + str(self.ptr) + "," + str(self.val) + ")"
+    if self.matches.AtomicLoad:
+        return "atomic_load(" + str(self.ptr) + ")"
+    if self.matches.AtomicStore:
+        return "atomic_store(" + str(self.ptr) + "," + str(self.val) + ")"
+    if self.matches.AtomicCompareExchange:
+        return "atomic_compare_exchange(" + str(self.ptr) + "," + str(self.expected) + "," + str(self.val) + ")"
+    if self.matches.AtomicFetchAdd:
+        return "atomic_fetch_add(" + str(self.ptr) + "," + str(self.val) + ")"
+    if self.matches.AtomicExchange:
+        return "atomic_exchange(" + str(self.ptr) + "," + str(self.val) + ")"
     if self.matches.Alloca:
         return "alloca(" + str(self.type) + ")"
     if self.matches.Cast:
         return "cast(%s,%s)" % (str(self.left), str(self.to_type))
     if self.matches.Binop:
         return "((%s)%s(%s))" % (str(self.left), str(self.op), str(self.right))
+    if self.matches.Unreachable:
+        return "unreachable"
+    if self.matches.Select:
+        return "select(%s,%s,%s)" % (str(self.cond), str(self.left), str(self.right))
     if self.matches.Unaryop:
         return "(%s(%s))" % (str(self.op), str(self.operand))
     if self.matches.Variable:
@@ -347,6 +366,11 @@ def expr_str(self):
                 + indent(t).rstrip() + ("\nelse:\n" + indent(f).rstrip() if self.false != nullExpr else "")
         else:
             return "((%s) if %s else (%s))" % (t, str(self.cond), f)
+    if self.matches.Switch:
+        res = "switch " + str(self.value) + ":\n"
+        for target, case in zip(self.targets, self.cases):
+            res += indent("case %s:\n" % target + indent(str(case)).rstrip()) + "\n"
+        return res + indent("default:\n" + indent(str(self.default)).rstrip())
     if self.matches.MakeStruct:
         return "struct(" + \
             ",".join("%s=%s" % (k, str(v)) for k, v in self.args) + ")"
@@ -533,9 +557,17 @@ Expression = Expression.define(Alternative(
     Load={'ptr': Expression},
     Store={'ptr': Expression, 'val': Expression},
     AtomicAdd={'ptr': Expression, 'val': Expression},
+    AtomicLoad={'ptr': Expression},
+    AtomicStore={'ptr': Expression, 'val': Expression},
+    AtomicCompareExchange={'ptr': Expression, 'expected': Expression, 'val': Expression},
+    AtomicFetchAdd={'ptr': Expression, 'val': Expression},
+    AtomicExchange={'ptr': Expression, 'val': Expression},
     Alloca={'type': Type},
     Cast={'left': Expression, 'to_type': Type},
     Binop={'op': BinaryOp, 'left': Expression, 'right': Expression},
+    # 'left' where 'cond' is true and 'right' where it's false, without branching.
+    # 'cond' is a Bool, or a Vector of Bool with as many lanes as 'left' and 'right'.
+    Select={'cond': Expression, 'left': Expression, 'right': Expression},
     Unaryop={'op': UnaryOp, 'operand': Expression},
     Variable={'name': str},
     Attribute={'left': Expression, 'attr': str},
@@ -549,7 +581,17 @@ Expression = Expression.define(Alternative(
         'true': Expression,
         'false': Expression
     },
+    # evaluate 'value' (an Int64) once, then evaluate cases[i] if it equals targets[i],
+    # or 'default' if it equals none of them. This becomes a single llvm 'switch'.
+    Switch={
+        'value': Expression,
+        'targets': TupleOf(int),
+        'cases': TupleOf(Expression),
+        'default': Expression
+    },
     Throw={'expr': Expression },  # throw a pointer.
+    # promise llvm that control never gets here.
+    Unreachable={},
     # evaluate 'expr', which must have type 'void' if it returns. if it throws an exception,
     # evaluate 'handler', which must also have type 'void' if it returns, with the exception
     # bound to 'varname'
@@ -618,7 +660,15 @@ Expression = Expression.define(Alternative(
     load=lambda self: Expression.Load(ptr=self),
     store=lambda self, val: Expression.Store(ptr=self, val=ensureExpr(val)),
     atomic_add=lambda self, val: Expression.AtomicAdd(ptr=self, val=ensureExpr(val)),
+    atomic_load=lambda self: Expression.AtomicLoad(ptr=self),
+    atomic_store=lambda self, val: Expression.AtomicStore(ptr=self, val=ensureExpr(val)),
+    atomic_compare_exchange=lambda self, expected, val: Expression.AtomicCompareExchange(
+        ptr=self, expected=ensureExpr(expected), val=ensureExpr(val)
+    ),
+    atomic_fetch_add=lambda self, val: Expression.AtomicFetchAdd(ptr=self, val=ensureExpr(val)),
+    atomic_exchange=lambda self, val: Expression.AtomicExchange(ptr=self, val=ensureExpr(val)),
     cast=lambda self, targetType: Expression.Cast(left=self, to_type=targetType),
+    select=lambda self, left, right: Expression.Select(cond=self, left=ensureExpr(left), right=ensureExpr(right)),
     with_comment=lambda self, c: Expression.Comment(comment=c, expr=self),
     elemPtr=lambda self, *exprs: Expression.ElementPtr(left=self, offsets=[ensureExpr(e) for e in exprs]),
     is_simple=expr_is_simple,
@@ -724,6 +774,30 @@ def const_bytes_cstr(i):
     )
 
 
+LLVM_FLAGS_COMMENT_PREFIX = "llvm-flags:"
+
+
+def withLlvmFlags(binop, flags):
+    """Ask for the llvm instruction produced by 'binop' (an Expression.Binop) to carry 'flags'.
+
+    'flags' is a sequence of llvm instruction flags like 'nsw' or 'fast'. Each one
+    lets llvm assume something python semantics don't promise, so only use this
+    where the user has opted in.
+    """
+    if not flags:
+        return binop
+
+    return Expression.Comment(comment=LLVM_FLAGS_COMMENT_PREFIX + " ".join(flags), expr=binop)
+
+
+def llvmFlagsFromComment(comment):
+    """Return the flags 'withLlvmFlags' encoded in 'comment', or an empty tuple."""
+    if not comment.startswith(LLVM_FLAGS_COMMENT_PREFIX):
+        return ()
+
+    return tuple(comment[len(LLVM_FLAGS_COMMENT_PREFIX):].split())
+
+
 FunctionBody = Alternative(
     "FunctionBody",
     Internal={'body': Expression},
@@ -0,0 +1,114 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import hashlib
+import os
+import uuid
+
+from typed_python.SerializationContext import SerializationContext
+
+
+# the name of the directory inside the compiler cache where we keep our files.
+# It's not 40 characters long, so the CompilerCache won't mistake it for a module.
+NATIVE_AST_DIR = "native_asts"
+
+
+class NativeAstCache:
+    """A persistent cache of the native_ast the converter produced for each function.
+
+    Converting a function to native_ast, and running type inference on it, is done
+    before llvm ever sees it, and its result depends only on the function's identity,
+    which its link name includes. So whenever we convert a function, we store its
+    definition (after refcount elision), its TypedCallTarget, and the identities and
+    link names of the functions it calls. If a later process needs that link name and
+    no module in the compiler cache defines it (because the module got evicted or
+    marked invalid, or the process that converted it died before llvm finished),
+    it can hand the stored definition straight to llvm instead of converting the
+    function again.
+
+    Each function gets its own file, named by a hash of its link name, which we write
+    under a tempname and then rename so that concurrent processes never see a partial
+    file. Since the content is determined by the name, racing writers are harmless.
+    """
+    def __init__(self, cacheDir):
+        self.cacheDir = os.path.join(cacheDir, NATIVE_AST_DIR)
+
+        if not os.path.exists(self.cacheDir):
+            try:
+                os.makedirs(self.cacheDir)
+            except IOError:
+                pass
+
+        self.hits = 0
+        self.misses = 0
+
+    def _entryPath(self, linkName):
+        return os.path.join(self.cacheDir, hashlib.sha1(linkName.encode("utf8")).hexdigest() + ".dat")
+
+    def lookup(self, linkName):
+        """Return what we stored for 'linkName', or None.
+
+        Returns:
+            None, or a tuple (identity, definition, callTarget, dependencies) where
+            'dependencies' is a list of (identity, linkName) pairs for the functions
+            'definition' calls.
+        """
+        try:
+            with open(self._entryPath(linkName), "rb") as f:
+                storedName, identity, definition, callTarget, dependencies = (
+                    SerializationContext().deserialize(f.read())
+                )
+        except FileNotFoundError:
+            self.misses += 1
+            return None
+        except Exception:
+            # a corrupt entry, or one naming objects we can't find anymore,
+            # is just a cache miss
+            self.misses += 1
+            return None
+
+        if storedName != linkName:
+            self.misses += 1
+            return None
+
+        self.hits += 1
+
+        return identity, definition, callTarget, [tuple(dep) for dep in dependencies]
+
+    def store(self, linkName, identity, definition, callTarget, dependencies):
+        """Record the conversion of 'linkName', unless we already have it."""
+        path = self._entryPath(linkName)
+
+        if os.path.exists(path):
+            return
+
+        try:
+            data = SerializationContext().serialize(
+                (linkName, identity, definition, callTarget, list(dependencies))
+            )
+        except Exception:
+            # the definition refers to something we can't serialize, so
+            # we'll just have to convert it again next time
+            return
+
+        tempPath = path + "_" + str(uuid.uuid4())
+
+        try:
+            with open(tempPath, "wb") as f:
+                f.write(data)
+
+            os.rename(tempPath, path)
+        except IOError:
+            if os.path.exists(tempPath):
+                os.remove(tempPath)
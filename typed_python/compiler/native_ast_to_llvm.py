@@ -14,7 +14,9 @@
 
 import typed_python.compiler.native_ast as native_ast
 from typed_python.compiler.module_definition import ModuleDefinition
-from typed_python.compiler.global_variable_definition import GlobalVariableDefinition
+from typed_python.compiler.global_variable_definition import GlobalVariableDefinition, GlobalVariableMetadata
+from typed_python.compiler import instrumentation
+from typed_python import _types, TupleOf
 import llvmlite.ir
 import os
 
@@ -33,6 +35,28 @@ pointer_size = 8
 
 CROSS_MODULE_INLINE_COMPLEXITY = 40
 
+# the most expressions a cached function's native_ast can have for us to copy
+# its body into a module that calls it (see 'Converter.add_functions')
+CROSS_MODULE_IMPORT_COMPLEXITY = 40
+
+# libm functions we call directly. They don't touch memory we can see (we never
+# read errno) and they never throw, so we tell llvm as much. That lets it hoist
+# them out of loops, fold them over constants, and drop calls whose results are
+# unused, the same way it treats its own math intrinsics.
+PURE_EXTERNAL_FUNCTIONS = frozenset([
+    'acos', 'acosh', 'asin', 'asinh', 'atan', 'atan2', 'atanh', 'cosh',
+    'erf', 'erfc', 'expm1', 'fmod', 'log1p', 'sinh', 'tan', 'tanh'
+])
+
+# if true, the process promised (via TP_THREAD_CONFINED_REFCOUNTS) never to share
+# objects between concurrently running threads, so we update refcounts with a plain
+# load and store instead of an atomic read-modify-write.
+thread_confined_refcounts = _types.refcountsAreThreadConfined()
+
+# refcounts at or above this belong to objects that 'freeze' made immortal, and
+# we leave them alone. See Refcount.hpp.
+_, immortal_refcount_threshold = _types.immortalRefcount()
+
 
 def llvmBool(i):
     return llvmlite.ir.Constant(llvm_i1, i)
@@ -76,6 +100,9 @@ def type_to_llvm_type(t):
     if t.matches.Array:
         return llvmlite.ir.ArrayType(type_to_llvm_type(t.element_type), t.count)
 
+    if t.matches.Vector:
+        return llvmlite.ir.VectorType(type_to_llvm_type(t.element_type), t.count)
+
     if t.matches.Float and t.bits == 64:
         return llvmlite.ir.DoubleType()
 
@@ -95,6 +122,33 @@ def type_to_llvm_type(t):
     assert False, "Can't handle %s yet" % t
 
 
+# the weight llvm itself gives the expected side of a branch on 'llvm.expect'
+EXPECTED_BRANCH_WEIGHT = 2000
+
+
+def expectedBranchWeights(cond_llvm):
+    """The weights for a branch on 'cond_llvm' if it's a call to 'llvm.expect.i1', or None.
+
+    llvm only turns 'llvm.expect' into branch weights in a function pass we don't
+    run, so we attach them ourselves.
+    """
+    if (
+        isinstance(cond_llvm, llvmlite.ir.CallInstr)
+        and getattr(cond_llvm.callee, "name", None) == "llvm.expect.i1"
+        and isinstance(cond_llvm.args[1], llvmlite.ir.Constant)
+    ):
+        if cond_llvm.args[1].constant:
+            return [EXPECTED_BRANCH_WEIGHT, 1]
+        return [1, EXPECTED_BRANCH_WEIGHT]
+
+    return None
+
+
+def vector_alignment(t):
+    """The alignment we load and store vector type 't' with: that of one of its elements."""
+    return max(1, t.element_type.bits // 8)
+
+
 strings_ever = [0]
 
 
@@ -523,6 +577,10 @@ class FunctionConverter:
         self.tags_initialized = {}
         self.stack_slots = {}
 
+        # the number of conditional branches we've emitted, which identifies
+        # each branch in an execution profile
+        self.branchCount = 0
+
     def tags_as(self, new_tags):
         class scoper():
             def __init__(scoper_self):
@@ -547,6 +605,34 @@ class FunctionConverter:
 
         self.exception_slot = builder.alloca(llvm_i8ptr, name="exception_slot")
 
+        if self.converter.instrumentForProfiling:
+            counter = self.convert(
+                native_ast.Expression.GlobalVariable(
+                    name=".prof.%s.entry" % self.function.name,
+                    type=native_ast.Int64,
+                    metadata=GlobalVariableMetadata.EntryCounter(functionName=self.function.name)
+                )
+            ).llvm_value
+
+            builder.store(builder.add(builder.load(counter), llvmI64(1)), counter)
+
+        # if this function is instrumented, its counters (see instrumentation.py),
+        # and the cycle counter as of its entry
+        self.instrumentationCounters = None
+        self.entryCycles = None
+
+        if self.function.name in self.converter.instrumentedFunctions:
+            self.instrumentationCounters = self.convert(
+                native_ast.Expression.GlobalVariable(
+                    name=".instrument.%s" % self.function.name,
+                    type=native_ast.Type.Array(element_type=native_ast.Int64, count=instrumentation.COUNTER_COUNT),
+                    metadata=GlobalVariableMetadata.InstrumentationCounters(functionName=self.function.name)
+                )
+            ).llvm_value
+
+            self.addToInstrumentationCounter(instrumentation.CALLS, llvmI64(1))
+            self.entryCycles = self.readCycleCounter()
+
         # if populated, we are expected to write our return value to 'return_slot' and jump here
         # on return
         self.teardown_handler = TeardownHandler(self, None)
@@ -554,6 +640,78 @@ class FunctionConverter:
     def finalize(self):
         self.teardown_handler.generate_teardown(lambda tags: None, self.return_slot, self.exception_slot)
 
+    def addToInstrumentationCounter(self, slot, llvm_value):
+        counter = self.builder.gep(self.instrumentationCounters, [llvmI64(0), llvmI64(slot)])
+        self.builder.atomic_rmw("add", counter, llvm_value, "monotonic")
+
+    def readCycleCounter(self):
+        return self.builder.call(
+            self.namedCallTargetToLLVM(
+                native_ast.NamedCallTarget(
+                    name="llvm.readcyclecounter",
+                    arg_types=(),
+                    output_type=native_ast.Int64,
+                    external=True,
+                    varargs=False,
+                    intrinsic=True,
+                    can_throw=False
+                )
+            ).llvm_value,
+            []
+        )
+
+    def countCyclesAtReturns(self):
+        """If we're instrumented, add the cycles since entry to our counter before each 'ret'.
+
+        Returns are emitted in several places (teardowns, and the end of the body), so
+        we find them once the whole function has been generated.
+        """
+        if self.instrumentationCounters is None:
+            return
+
+        for block in list(self.function.blocks):
+            if isinstance(block.terminator, llvmlite.ir.instructions.Ret):
+                self.builder.position_before(block.terminator)
+
+                self.addToInstrumentationCounter(
+                    instrumentation.CYCLES,
+                    self.builder.sub(self.readCycleCounter(), self.entryCycles)
+                )
+
+    def profileBranch(self, cond_llvm):
+        """Account for the conditional branch on 'cond_llvm' we're about to emit.
+
+        If we're instrumenting, count which way it goes.
+
+        Returns:
+            None, or the weights to give the branch from our execution profile,
+            or failing that from a 'likely' or 'unlikely' in the condition.
+        """
+        branchIndex = self.branchCount
+        self.branchCount += 1
+
+        name = self.function.name
+
+        if self.converter.instrumentForProfiling:
+            counters = self.convert(
+                native_ast.Expression.GlobalVariable(
+                    name=".prof.%s.%s" % (name, branchIndex),
+                    type=native_ast.Type.Array(element_type=native_ast.Int64, count=2),
+                    metadata=GlobalVariableMetadata.BranchCounters(functionName=name, branchIndex=branchIndex)
+                )
+            ).llvm_value
+
+            slot = self.builder.gep(counters, [llvmI64(0), self.builder.zext(cond_llvm, llvm_i64)])
+            self.builder.store(self.builder.add(self.builder.load(slot), llvmI64(1)), slot)
+
+        if self.converter.profile is not None:
+            weights = self.converter.profile.branchWeights(name, branchIndex)
+
+            if weights is not None:
+                return weights
+
+        return expectedBranchWeights(cond_llvm)
+
     def generate_exception_landing_pad(self, block):
         with self.builder.goto_block(block):
             res = self.builder.landingpad(exception_type_llvm)
@@ -647,6 +805,10 @@ class FunctionConverter:
                     self.external_function_references[target.name] = \
                         llvmlite.ir.Function(self.module, func_type, target.name)
 
+                    if target.name in PURE_EXTERNAL_FUNCTIONS:
+                        self.external_function_references[target.name].attributes.add("readnone")
+                        self.external_function_references[target.name].attributes.add("nounwind")
+
             func = self.external_function_references[target.name]
         elif target.name in self.converter._externallyDefinedFunctionTypes:
             # this function is defined in a shared object that we've loaded from a prior
@@ -658,12 +820,17 @@ class FunctionConverter:
                     var_arg=target.varargs
                 )
 
-                assert target.name not in self.converter._function_definitions, target.name
+                assert target.name not in self.converter._functions_by_name, target.name
 
                 self.external_function_references[target.name] = (
                     llvmlite.ir.Function(self.module, func_type, target.name)
                 )
 
+                if target.name in self.converter._importableDefinitions:
+                    self.converter.importFunctionIntoModule(
+                        target.name, self.external_function_references[target.name]
+                    )
+
             func = self.external_function_references[target.name]
         else:
             func = self.converter._functions_by_name[target.name]
@@ -671,8 +838,8 @@ class FunctionConverter:
             if func.module is not self.module:
                 # first, see if we'd like to inline this module
                 if (
-                    self.converter.totalFunctionComplexity(target.name) < CROSS_MODULE_INLINE_COMPLEXITY
-                    and self.converter.canBeInlined(target.name)
+                    self.converter.canBeInlined(target.name)
+                    and self.converter.totalFunctionComplexity(target.name) < CROSS_MODULE_INLINE_COMPLEXITY
                 ):
                     func = self.converter.repeatFunctionInModule(target.name, self.module)
                 else:
@@ -688,7 +855,8 @@ class FunctionConverter:
                 args=target.arg_types,
                 output=target.output_type,
                 varargs=target.varargs,
-                can_throw=target.can_throw
+                # a plain 'call' is enough for compiled functions nothing can unwind out of
+                can_throw=target.can_throw and (target.external or not self.converter.functionCantUnwind(target.name))
             ).pointer()
         )
 
@@ -718,6 +886,100 @@ class FunctionConverter:
 
         return res
 
+    def atomicOperandsAsIntegers(self, ptr, *vals):
+        """Return llvm values for 'ptr' and 'vals', bitcast to integers if they're floats.
+
+        cmpxchg and xchg only take integers, so we do float atomics on the bits.
+        """
+        if not ptr.native_type.value_type.matches.Float:
+            return ptr.llvm_value, [v.llvm_value for v in vals]
+
+        intType = llvmlite.ir.IntType(ptr.native_type.value_type.bits)
+
+        return (
+            self.builder.bitcast(ptr.llvm_value, intType.as_pointer()),
+            [self.builder.bitcast(v.llvm_value, intType) for v in vals]
+        )
+
+    def atomicResultFromInteger(self, llvm_value, native_type):
+        if native_type.matches.Float:
+            llvm_value = self.builder.bitcast(llvm_value, type_to_llvm_type(native_type))
+
+        return TypedLLVMValue(llvm_value, native_type)
+
+    def convertBinop(self, expr, flags=()):
+        """Convert an Expression.Binop, tagging the llvm instruction with 'flags'.
+
+        'flags' are llvm instruction flags like 'nsw' or 'fast'. We only apply them to
+        arithmetic that can carry them, and never to comparisons.
+        """
+        lhs = self.convert(expr.left)
+        if lhs is None:
+            return
+        rhs = self.convert(expr.right)
+        if rhs is None:
+            return
+
+        # vectors work lane by lane, so we dispatch on the type of their elements
+        if lhs.native_type.matches.Vector:
+            kind = lhs.native_type.element_type
+            compareType = native_ast.Type.Vector(element_type=native_ast.Bool, count=lhs.native_type.count)
+        else:
+            kind = lhs.native_type
+            compareType = native_ast.Bool
+
+        for which, rep in [('Gt', '>'), ('Lt', '<'), ('GtE', '>='),
+                           ('LtE', '<='), ('Eq', "=="), ("NotEq", "!=")]:
+            if getattr(expr.op.matches, which):
+                if kind.matches.Float:
+                    return TypedLLVMValue(
+                        self.builder.fcmp_ordered(rep, lhs.llvm_value, rhs.llvm_value),
+                        compareType
+                    )
+                elif kind.matches.Int:
+                    if kind.signed:
+                        return TypedLLVMValue(
+                            self.builder.icmp_signed(rep, lhs.llvm_value, rhs.llvm_value),
+                            compareType
+                        )
+                    else:
+                        return TypedLLVMValue(
+                            self.builder.icmp_unsigned(rep, lhs.llvm_value, rhs.llvm_value),
+                            compareType
+                        )
+
+        for py_op, floatop, intop_s, intop_u in [('Add', 'fadd', 'add', 'add'),
+                                                 ('Mul', 'fmul', 'mul', 'mul'),
+                                                 ('Div', 'fdiv', 'sdiv', 'udiv'),
+                                                 ('Mod', 'frem', 'srem', 'urem'),
+                                                 ('Sub', 'fsub', 'sub', 'sub'),
+                                                 ('LShift', None, 'shl', 'shl'),
+                                                 ('RShift', None, 'ashr', 'lshr'),
+                                                 ('BitOr', None, 'or_', 'or_'),
+                                                 ('BitXor', None, 'xor', 'xor'),
+                                                 ('BitAnd', None, 'and_', 'and_')]:
+            if getattr(expr.op.matches, py_op):
+                assert lhs.native_type == rhs.native_type, \
+                    "malformed types: expect lhs&rhs to be the same but got %s,%s,%s\n\nexpr=%s"\
+                    % (py_op, lhs.native_type, rhs.native_type, expr)
+                if kind.matches.Float and floatop is not None:
+                    floatFlags = flags if floatop != 'frem' else ()
+                    return TypedLLVMValue(
+                        getattr(self.builder, floatop)(lhs.llvm_value, rhs.llvm_value, flags=floatFlags),
+                        lhs.native_type
+                    )
+                elif kind.matches.Int:
+                    llvm_op = intop_s if kind.signed else intop_u
+                    intFlags = flags if llvm_op in ('add', 'sub', 'mul') else ()
+
+                    if llvm_op is not None:
+                        return TypedLLVMValue(
+                            getattr(self.builder, llvm_op)(lhs.llvm_value, rhs.llvm_value, flags=intFlags),
+                            lhs.native_type
+                        )
+
+        assert False, "can't apply binary operator %s to %s" % (expr.op, lhs.native_type)
+
     def _convert(self, expr):
         """Actually convert 'expr' into underlying llvm instructions."""
         if expr.matches.ApplyIntermediates:
@@ -864,17 +1126,107 @@ class FunctionConverter:
             ptr = self.convert(expr.ptr)
             val = self.convert(expr.val)
 
-            if not val.native_type.matches.Void:
+            if val.native_type.matches.Vector:
+                # vectors live inside ordinary typed_python objects, which only
+                # guarantee the alignment of a single element.
+                self.builder.store(val.llvm_value, ptr.llvm_value, align=vector_alignment(val.native_type))
+            elif not val.native_type.matches.Void:
                 self.builder.store(val.llvm_value, ptr.llvm_value)
 
             return TypedLLVMValue(None, native_ast.Type.Void())
 
         if expr.matches.AtomicAdd:
+            # refcounts are the only thing we atomic_add, and we update them
+            # the same way the C++ side does. See Refcount.hpp.
             ptr = self.convert(expr.ptr)
             val = self.convert(expr.val)
 
+            llvmType = type_to_llvm_type(val.native_type)
+
+            if thread_confined_refcounts:
+                old = self.builder.load(ptr.llvm_value)
+            else:
+                old = self.builder.load_atomic(ptr.llvm_value, "monotonic", val.native_type.bits // 8)
+
+            isMortal = self.builder.icmp_signed(
+                "<", old, llvmlite.ir.Constant(llvmType, immortal_refcount_threshold)
+            )
+
+            loadBlock = self.builder.block
+
+            # we never write to the refcount of an immortal object
+            with self.builder.if_then(isMortal, likely=True):
+                if thread_confined_refcounts:
+                    self.builder.store(self.builder.add(old, val.llvm_value), ptr.llvm_value)
+                    updated = old
+                else:
+                    updated = self.builder.atomic_rmw("add", ptr.llvm_value, val.llvm_value, "monotonic")
+
+                updateBlock = self.builder.block
+
+            result = self.builder.phi(llvmType)
+            result.add_incoming(old, loadBlock)
+            result.add_incoming(updated, updateBlock)
+
+            return TypedLLVMValue(result, val.native_type)
+
+        # the atomics below are sequentially consistent. Unlike AtomicAdd they're
+        # only emitted for user code (see PointerTo's 'atomic*' methods), so
+        # 'thread_confined_refcounts' doesn't apply to them.
+        if expr.matches.AtomicLoad:
+            ptr = self.convert(expr.ptr)
+            valueType = ptr.native_type.value_type
+
             return TypedLLVMValue(
-                self.builder.atomic_rmw("add", ptr.llvm_value, val.llvm_value, "monotonic"),
+                self.builder.load_atomic(ptr.llvm_value, "seq_cst", valueType.bits // 8),
+                valueType
+            )
+
+        if expr.matches.AtomicStore:
+            ptr = self.convert(expr.ptr)
+            val = self.convert(expr.val)
+
+            self.builder.store_atomic(val.llvm_value, ptr.llvm_value, "seq_cst", val.native_type.bits // 8)
+
+            return TypedLLVMValue(None, native_ast.Type.Void())
+
+        if expr.matches.AtomicCompareExchange:
+            ptr = self.convert(expr.ptr)
+            expected = self.convert(expr.expected)
+            val = self.convert(expr.val)
+
+            ptrValue, (expectedValue, valValue) = self.atomicOperandsAsIntegers(
+                ptr, expected, val
+            )
+
+            # cmpxchg gives back {old value, success}. The caller can tell
+            # whether it succeeded by comparing the old value to 'expected'.
+            res = self.builder.cmpxchg(ptrValue, expectedValue, valValue, "seq_cst", "seq_cst")
+
+            return self.atomicResultFromInteger(self.builder.extract_value(res, 0), val.native_type)
+
+        if expr.matches.AtomicFetchAdd:
+            ptr = self.convert(expr.ptr)
+            val = self.convert(expr.val)
+
+            return TypedLLVMValue(
+                self.builder.atomic_rmw(
+                    "fadd" if val.native_type.matches.Float else "add",
+                    ptr.llvm_value,
+                    val.llvm_value,
+                    "seq_cst"
+                ),
+                val.native_type
+            )
+
+        if expr.matches.AtomicExchange:
+            ptr = self.convert(expr.ptr)
+            val = self.convert(expr.val)
+
+            ptrValue, (valValue,) = self.atomicOperandsAsIntegers(ptr, val)
+
+            return self.atomicResultFromInteger(
+                self.builder.atomic_rmw("xchg", ptrValue, valValue, "seq_cst"),
                 val.native_type
             )
 
@@ -886,8 +1238,32 @@ class FunctionConverter:
             if ptr.native_type.value_type.matches.Void:
                 return TypedLLVMValue(None, ptr.native_type.value_type)
 
+            if ptr.native_type.value_type.matches.Vector:
+                return TypedLLVMValue(
+                    self.builder.load(ptr.llvm_value, align=vector_alignment(ptr.native_type.value_type)),
+                    ptr.native_type.value_type
+                )
+
             return TypedLLVMValue(self.builder.load(ptr.llvm_value), ptr.native_type.value_type)
 
+        if expr.matches.Select:
+            cond = self.convert(expr.cond)
+            if cond is None:
+                return
+            lhs = self.convert(expr.left)
+            if lhs is None:
+                return
+            rhs = self.convert(expr.right)
+            if rhs is None:
+                return
+
+            assert lhs.native_type == rhs.native_type, (lhs.native_type, rhs.native_type)
+
+            return TypedLLVMValue(
+                self.builder.select(cond.llvm_value, lhs.llvm_value, rhs.llvm_value),
+                lhs.native_type
+            )
+
         if expr.matches.Constant:
             return constant_to_typed_llvm_value(self.module, self.builder, expr.val)
 
@@ -911,29 +1287,44 @@ class FunctionConverter:
             if lhs.native_type.matches.Int and expr.to_type.matches.Pointer:
                 return TypedLLVMValue(self.builder.inttoptr(lhs.llvm_value, target_type), expr.to_type)
 
-            if lhs.native_type.matches.Float and expr.to_type.matches.Int:
-                if expr.to_type.signed:
+            # a vector casts lane by lane to a vector with as many lanes, using
+            # the same instructions as a cast of its elements would.
+            lhsKind = lhs.native_type
+            toKind = expr.to_type
+
+            if lhs.native_type.matches.Vector or expr.to_type.matches.Vector:
+                if not (
+                    lhs.native_type.matches.Vector and expr.to_type.matches.Vector
+                    and lhs.native_type.count == expr.to_type.count
+                ):
+                    raise Exception(f"Invalid cast: {lhs.native_type} to {expr.to_type}")
+
+                lhsKind = lhs.native_type.element_type
+                toKind = expr.to_type.element_type
+
+            if lhsKind.matches.Float and toKind.matches.Int:
+                if toKind.signed:
                     return TypedLLVMValue(self.builder.fptosi(lhs.llvm_value, target_type), expr.to_type)
                 else:
                     return TypedLLVMValue(self.builder.fptoui(lhs.llvm_value, target_type), expr.to_type)
 
-            elif lhs.native_type.matches.Float and expr.to_type.matches.Float:
-                if lhs.native_type.bits > expr.to_type.bits:
+            elif lhsKind.matches.Float and toKind.matches.Float:
+                if lhsKind.bits > toKind.bits:
                     return TypedLLVMValue(self.builder.fptrunc(lhs.llvm_value, target_type), expr.to_type)
                 else:
                     return TypedLLVMValue(self.builder.fpext(lhs.llvm_value, target_type), expr.to_type)
 
-            elif lhs.native_type.matches.Int and expr.to_type.matches.Int:
-                if lhs.native_type.bits < expr.to_type.bits:
-                    if lhs.native_type.signed:
+            elif lhsKind.matches.Int and toKind.matches.Int:
+                if lhsKind.bits < toKind.bits:
+                    if lhsKind.signed:
                         return TypedLLVMValue(self.builder.sext(lhs.llvm_value, target_type), expr.to_type)
                     else:
                         return TypedLLVMValue(self.builder.zext(lhs.llvm_value, target_type), expr.to_type)
                 else:
                     return TypedLLVMValue(self.builder.trunc(lhs.llvm_value, target_type), expr.to_type)
 
-            elif lhs.native_type.matches.Int and expr.to_type.matches.Float:
-                if lhs.native_type.signed:
+            elif lhsKind.matches.Int and toKind.matches.Float:
+                if lhsKind.signed:
                     return TypedLLVMValue(self.builder.sitofp(lhs.llvm_value, target_type), expr.to_type)
                 else:
                     return TypedLLVMValue(self.builder.uitofp(lhs.llvm_value, target_type), expr.to_type)
@@ -1018,7 +1409,13 @@ class FunctionConverter:
             true_tags = dict(orig_tags)
             false_tags = dict(orig_tags)
 
+            weights = self.profileBranch(cond_llvm)
+            branch_block = self.builder.block
+
             with self.builder.if_else(cond_llvm) as (then, otherwise):
+                if weights is not None:
+                    branch_block.terminator.set_weights(weights)
+
                 with then:
                     self.tags_initialized = true_tags
                     true = self.convert(expr.true)
@@ -1083,6 +1480,78 @@ class FunctionConverter:
 
             return TypedLLVMValue(final, true.native_type)
 
+        if expr.matches.Switch:
+            value = self.convert(expr.value)
+
+            if value is None:
+                return None
+
+            orig_tags = dict(self.tags_initialized)
+
+            default_block = self.builder.append_basic_block("switch_default")
+            done_block = self.builder.append_basic_block("switch_done")
+
+            switch = self.builder.switch(value.llvm_value, default_block)
+
+            # (result, tags, block) for each case whose control flow reaches 'done_block'
+            arms = []
+
+            for target, case in list(zip(expr.targets, expr.cases)) + [(None, expr.default)]:
+                if target is None:
+                    block = default_block
+                else:
+                    block = self.builder.append_basic_block("switch_case_%s" % target)
+                    switch.add_case(llvmlite.ir.Constant(value.llvm_value.type, target), block)
+
+                self.builder.position_at_start(block)
+                self.tags_initialized = dict(orig_tags)
+
+                result = self.convert(case)
+
+                if result is not None:
+                    arms.append((result, self.tags_initialized, self.builder.block))
+                    self.builder.branch(done_block)
+
+            self.builder.position_at_start(done_block)
+
+            if not arms:
+                self.tags_initialized = orig_tags
+                self.builder.unreachable()
+                return None
+
+            # merge the tags as in 'Branch', but across every arm
+            final_tags = {}
+            for tag in set(tag for _, tags, _ in arms for tag in tags):
+                vals = [tags.get(tag, False) for _, tags, _ in arms]
+
+                if all(val is True for val in vals):
+                    final_tags[tag] = True
+                elif all(not isinstance(val, bool) for val in vals) and len(set(val.name for val in vals)) == 1:
+                    final_tags[tag] = vals[0]
+                else:
+                    tag_llvm_value = self.builder.phi(llvm_i1, 'is_initialized.merge.' + tag)
+                    for val, (_, _, block) in zip(vals, arms):
+                        tag_llvm_value.add_incoming(llvmBool(val) if isinstance(val, bool) else val, block)
+                    final_tags[tag] = tag_llvm_value
+
+            self.tags_initialized = final_tags
+
+            for result, _, _ in arms:
+                if result.native_type != arms[0][0].native_type:
+                    raise Exception(
+                        "Expected switch cases to have the same type, but %s != %s\n\n%s"
+                        % (result, arms[0][0], expr)
+                    )
+
+            if arms[0][0].native_type.matches.Void:
+                return TypedLLVMValue(None, native_ast.Type.Void())
+
+            final = self.builder.phi(type_to_llvm_type(arms[0][0].native_type))
+            for result, _, block in arms:
+                final.add_incoming(result.llvm_value, block)
+
+            return TypedLLVMValue(final, arms[0][0].native_type)
+
         if expr.matches.While:
             tags = dict(self.tags_initialized)
 
@@ -1108,7 +1577,13 @@ class FunctionConverter:
             else:
                 cond_llvm = llvmlite.ir.Constant(llvm_i1, 0)
 
+            weights = self.profileBranch(cond_llvm)
+            branch_block = self.builder.block
+
             with self.builder.if_else(cond_llvm) as (then, otherwise):
+                if weights is not None:
+                    branch_block.terminator.set_weights(weights)
+
                 with then:
                     true = self.convert(expr.while_true)
                     if true is not None:
@@ -1197,60 +1672,7 @@ class FunctionConverter:
             assert False, "can't apply unary operand %s to %s" % (expr.op, str(operand.native_type))
 
         if expr.matches.Binop:
-            lhs = self.convert(expr.left)
-            if lhs is None:
-                return
-            rhs = self.convert(expr.right)
-            if rhs is None:
-                return
-
-            for which, rep in [('Gt', '>'), ('Lt', '<'), ('GtE', '>='),
-                               ('LtE', '<='), ('Eq', "=="), ("NotEq", "!=")]:
-                if getattr(expr.op.matches, which):
-                    if lhs.native_type.matches.Float:
-                        return TypedLLVMValue(
-                            self.builder.fcmp_ordered(rep, lhs.llvm_value, rhs.llvm_value),
-                            native_ast.Bool
-                        )
-                    elif lhs.native_type.matches.Int:
-                        if lhs.native_type.signed:
-                            return TypedLLVMValue(
-                                self.builder.icmp_signed(rep, lhs.llvm_value, rhs.llvm_value),
-                                native_ast.Bool
-                            )
-                        else:
-                            return TypedLLVMValue(
-                                self.builder.icmp_unsigned(rep, lhs.llvm_value, rhs.llvm_value),
-                                native_ast.Bool
-                            )
-
-            for py_op, floatop, intop_s, intop_u in [('Add', 'fadd', 'add', 'add'),
-                                                     ('Mul', 'fmul', 'mul', 'mul'),
-                                                     ('Div', 'fdiv', 'sdiv', 'udiv'),
-                                                     ('Mod', 'frem', 'srem', 'urem'),
-                                                     ('Sub', 'fsub', 'sub', 'sub'),
-                                                     ('LShift', None, 'shl', 'shl'),
-                                                     ('RShift', None, 'ashr', 'lshr'),
-                                                     ('BitOr', None, 'or_', 'or_'),
-                                                     ('BitXor', None, 'xor', 'xor'),
-                                                     ('BitAnd', None, 'and_', 'and_')]:
-                if getattr(expr.op.matches, py_op):
-                    assert lhs.native_type == rhs.native_type, \
-                        "malformed types: expect lhs&rhs to be the same but got %s,%s,%s\n\nexpr=%s"\
-                        % (py_op, lhs.native_type, rhs.native_type, expr)
-                    if lhs.native_type.matches.Float and floatop is not None:
-                        return TypedLLVMValue(
-                            getattr(self.builder, floatop)(lhs.llvm_value, rhs.llvm_value),
-                            lhs.native_type
-                        )
-                    elif lhs.native_type.matches.Int:
-                        llvm_op = intop_s if lhs.native_type.signed else intop_u
-
-                        if llvm_op is not None:
-                            return TypedLLVMValue(
-                                getattr(self.builder, llvm_op)(lhs.llvm_value, rhs.llvm_value),
-                                lhs.native_type
-                            )
+            return self.convertBinop(expr)
 
         if expr.matches.Call:
             target_or_ptr = expr.target
@@ -1265,6 +1687,13 @@ class FunctionConverter:
 
                 func = self.namedCallTargetToLLVM(target)
 
+                if (
+                    self.instrumentationCounters is not None
+                    and target.external
+                    and instrumentation.isPythonObjectFallback(target.name)
+                ):
+                    self.addToInstrumentationCounter(instrumentation.PYTHON_OBJECT_CALLS, llvmI64(1))
+
                 if self.converter._printAllNativeCalls:
                     self.builder.call(
                         self.namedCallTargetToLLVM(
@@ -1334,6 +1763,11 @@ class FunctionConverter:
             return res
 
         if expr.matches.Comment:
+            flags = native_ast.llvmFlagsFromComment(expr.comment)
+
+            if flags and expr.expr.matches.Binop:
+                return self.convertBinop(expr.expr, flags)
+
             return self.convert(expr.expr)
 
         if expr.matches.ActivatesTeardown:
@@ -1341,6 +1775,10 @@ class FunctionConverter:
             self.tags_initialized[expr.name] = True
             return TypedLLVMValue(None, native_ast.Type.Void())
 
+        if expr.matches.Unreachable:
+            self.builder.unreachable()
+            return None
+
         if expr.matches.Throw:
             arg = self.convert(expr.expr)
 
@@ -1464,6 +1902,87 @@ class FunctionConverter:
         assert False, "can't handle %s" % repr(expr)
 
 
+def unwindingSummary(body):
+    """Work out how an exception could unwind out of a function whose body is 'body'.
+
+    'Expression.couldThrow' only asks whether a throw could land in one of our own
+    handlers. Here we also count the exceptions we'd let fly straight through us:
+    external functions marked 'can_throw=False' are called with a plain 'call', but
+    they're C++ and can still throw.
+
+    Returns:
+        a pair (unwinds, callees) where 'unwinds' is True if 'body' could unwind
+        no matter what the compiled functions it calls do, and 'callees' is the set
+        of names of the compiled functions it calls.
+    """
+    callees = set()
+    stack = [body]
+
+    while stack:
+        expr = stack.pop()
+
+        if expr.matches.Throw:
+            return True, callees
+
+        if expr.matches.Call:
+            if expr.target.matches.Pointer:
+                return True, callees
+
+            target = expr.target.target
+
+            if target.external and not target.intrinsic and target.name not in PURE_EXTERNAL_FUNCTIONS:
+                return True, callees
+
+            if not target.external:
+                callees.add(target.name)
+
+        if expr.matches.MakeStruct:
+            stack.extend(e for _, e in expr.args)
+
+        if expr.matches.Finally:
+            stack.extend(t.expr for t in expr.teardowns)
+
+        for name in expr.ElementType.ElementNames:
+            child = getattr(expr, name)
+
+            if isinstance(child, native_ast.Expression):
+                stack.append(child)
+            elif isinstance(child, TupleOf(native_ast.Expression)):
+                stack.extend(child)
+            elif isinstance(child, TupleOf(native_ast.ExpressionIntermediate)):
+                stack.extend(i.expr for i in child)
+
+    return False, callees
+
+
+def expressionCount(body, limit):
+    """Count the expressions in 'body', stopping once we've seen more than 'limit'."""
+    count = 0
+    stack = [body]
+
+    while stack and count <= limit:
+        expr = stack.pop()
+        count += 1
+
+        if expr.matches.MakeStruct:
+            stack.extend(e for _, e in expr.args)
+
+        if expr.matches.Finally:
+            stack.extend(t.expr for t in expr.teardowns)
+
+        for name in expr.ElementType.ElementNames:
+            child = getattr(expr, name)
+
+            if isinstance(child, native_ast.Expression):
+                stack.append(child)
+            elif isinstance(child, TupleOf(native_ast.Expression)):
+                stack.extend(child)
+            elif isinstance(child, TupleOf(native_ast.ExpressionIntermediate)):
+                stack.extend(i.expr for i in child)
+
+    return count
+
+
 def populate_needed_externals(external_function_references, module):
     def define(fname, output, inputs, vararg=False):
         external_function_references[fname] = \
@@ -1483,13 +2002,40 @@ def populate_needed_externals(external_function_references, module):
     define("tp_gxx_personality_v0", llvm_void, [])
 
 
+class DefinedFunction:
+    """What we remember about a function once the module defining it is built.
+
+    'Converter._functions_by_name' holds an llvmlite.ir.Function for each function
+    while we're building its module. Each of those keeps its whole module's IR
+    alive, and we only need its name and type to call it from another module, so
+    we swap in one of these once we're done with it. Its 'module' is None, which is
+    never the module we're building.
+    """
+    def __init__(self, name, function_type):
+        self.name = name
+        self.function_type = function_type
+        self.module = None
+
+
 class Converter:
     def __init__(self):
         object.__init__(self)
-        self._modules = {}
+        # the number of llvm modules we've generated
+        self.moduleCount = 0
+
+        # name -> an llvmlite.ir.Function for the functions in the modules we're
+        # building, or a DefinedFunction for functions in modules we've built.
         self._functions_by_name = {}
+
+        # name -> native_ast.Function, for the functions that are small enough for us
+        # to repeat in other modules (see 'repeatFunctionInModule'). We drop the rest
+        # once we've built their modules.
         self._function_definitions = {}
 
+        # names of the functions whose llvmlite.ir.Function we need to swap out for
+        # a DefinedFunction once the current batch is built
+        self._functionsToRetire = set()
+
         # a map from function name to function type for functions that
         # are defined in external shared objects and linked in to this one.
         self._externallyDefinedFunctionTypes = {}
@@ -1499,6 +2045,30 @@ class Converter:
 
         self._inlineRequests = []
 
+        # definitions of externally defined functions that the batch 'add_functions'
+        # is converting may copy into its module, and the (name, llvm function)
+        # pairs it has asked for so far
+        self._importableDefinitions = {}
+        self._importRequests = []
+
+        # names of the functions in the batch 'add_function_groups' is converting
+        self._pendingDefinitions = set()
+
+        # names of the functions we've defined that no exception can unwind out of.
+        # Calls to them don't need an 'invoke' or a landing pad.
+        self._functionsThatCantUnwind = set()
+
+        # if True, the code we generate counts calls and branch outcomes in
+        # global counters (see execution_profile.py)
+        self.instrumentForProfiling = False
+
+        # if not None, an ExecutionProfile we use to weight branches and to
+        # mark functions as hot or cold
+        self.profile = None
+
+        # link names of the functions that keep the counters in instrumentation.py
+        self.instrumentedFunctions = set()
+
         self._printAllNativeCalls = os.getenv("TP_COMPILER_LOG_NATIVE_CALLS")
         self.verbose = False
 
@@ -1506,8 +2076,53 @@ class Converter:
         """Provide type signatures for a set of external functions."""
         self._externallyDefinedFunctionTypes.update(functionNameToType)
 
+    def functionCantUnwind(self, name):
+        """Do we know that no exception can unwind out of the compiled function 'name'?"""
+        if name in self._functionsThatCantUnwind:
+            return True
+
+        if name in self._externallyDefinedFunctionTypes:
+            return not self._externallyDefinedFunctionTypes[name].can_throw
+
+        return False
+
+    def _inferFunctionsThatCantUnwind(self, names_to_definitions):
+        """Find the functions in 'names_to_definitions' that no exception can unwind out of.
+
+        A function can't unwind if its body can't on its own, and neither can anything
+        it calls. We start by assuming that's true of everything in the batch and
+        knock functions out until nothing changes, so (mutually) recursive functions
+        that only do arithmetic still qualify.
+        """
+        summaries = {}
+        couldUnwind = set()
+
+        for name, definition in names_to_definitions.items():
+            if definition.body.matches.External:
+                couldUnwind.add(name)
+            else:
+                unwinds, callees = unwindingSummary(definition.body.body)
+
+                if unwinds or any(
+                    c not in names_to_definitions and not self.functionCantUnwind(c) for c in callees
+                ):
+                    couldUnwind.add(name)
+                else:
+                    summaries[name] = callees
+
+        changed = True
+        while changed:
+            changed = False
+
+            for name, callees in summaries.items():
+                if name not in couldUnwind and callees & couldUnwind:
+                    couldUnwind.add(name)
+                    changed = True
+
+        self._functionsThatCantUnwind.update(set(names_to_definitions) - couldUnwind)
+
     def canBeInlined(self, name):
-        return name not in self._externallyDefinedFunctionTypes
+        return name not in self._externallyDefinedFunctionTypes and name not in self._pendingDefinitions
 
     def totalFunctionComplexity(self, name):
         """Return the total number of instructions contained in a function.
@@ -1536,32 +2151,128 @@ class Converter:
         """
         assert name in self._functions_by_name
         assert self._functions_by_name[name].module != module
+        assert name in self._function_definitions
 
-        existingFunctionDef = self._functions_by_name[name]
-
-        funcType = existingFunctionDef.type
-        if funcType.is_pointer:
-            funcType = funcType.pointee
+        funcType = self._functions_by_name[name].function_type
 
         assert isinstance(funcType, llvmlite.ir.FunctionType)
 
         self._functions_by_name[name] = llvmlite.ir.Function(module, funcType, name)
+        self._functionsToRetire.add(name)
 
         self._inlineRequests.append(name)
 
         return self._functions_by_name[name]
 
-    def add_functions(self, names_to_definitions):
-        names_to_definitions = dict(names_to_definitions)
+    def importFunctionIntoModule(self, name, func):
+        """Request that the externally defined function 'name' get its body in func's module.
+
+        We give it 'available_externally' linkage, so llvm may inline it or
+        reason about it, but never emits it: calls it leaves alone still go to the
+        shared object that defines it.
+        """
+        func.linkage = 'available_externally'
+
+        self._importRequests.append((name, func))
+
+    def add_functions(self, names_to_definitions, importableDefinitions=None):
+        """Define a group of functions in a new module.
+
+        Args:
+            names_to_definitions - a map from name to native_ast.Function
+            importableDefinitions - None, or a map from the names of externally
+                defined functions to their native_ast.Function. Each one the module
+                calls gets its body copied in, so that llvm can inline it.
+
+        Returns:
+            a ModuleDefinition.
+        """
+        self._importableDefinitions = dict(importableDefinitions or {})
+
+        try:
+            return self.add_function_groups([names_to_definitions])[0]
+        finally:
+            self._importableDefinitions = {}
+
+    def add_function_groups(self, groups):
+        """Define several groups of functions at once, each group in its own module.
+
+        Functions in one group may call functions in any other group. We declare
+        every function before converting any of them, and we never repeat a function
+        from this batch in another module, since it has no body yet.
+
+        Args:
+            groups - a list of maps from name to native_ast.Function
+
+        Returns:
+            a list of ModuleDefinition objects, one per group.
+        """
+        groups = [dict(names_to_definitions) for names_to_definitions in groups]
+
+        self._inferFunctionsThatCantUnwind(
+            {name: definition for names_to_definitions in groups for name, definition in names_to_definitions.items()}
+        )
+
+        declared = [self._declareModule(names_to_definitions) for names_to_definitions in groups]
+
+        for names_to_definitions in groups:
+            self._pendingDefinitions.update(names_to_definitions)
+
+        try:
+            res = [
+                self._defineModule(names_to_definitions, *moduleAndTypes)
+                for names_to_definitions, moduleAndTypes in zip(groups, declared)
+            ]
+        finally:
+            self._pendingDefinitions.clear()
+
+        self._retireFunctions()
+
+        return res
+
+    def _retireFunctions(self):
+        """Let go of the llvm IR and native_ast of the functions in the batch we just built.
+
+        Once a module's text is built, the only thing we need a function's IR for is
+        counting its instructions, to decide whether to repeat it in other modules. So
+        we count them now, and keep the native_ast only of the functions small enough
+        to repeat.
+        """
+        for name in self._functionsToRetire:
+            func = self._functions_by_name[name]
+
+            if isinstance(func, DefinedFunction):
+                continue
+
+            if self.totalFunctionComplexity(name) >= CROSS_MODULE_INLINE_COMPLEXITY:
+                self._function_definitions.pop(name, None)
+
+            self._functions_by_name[name] = DefinedFunction(name, func.function_type)
+
+        self._functionsToRetire.clear()
 
+    def memoryStats(self):
+        """Return a dict describing what we're holding on to for the modules we've built.
+
+        'modules' is how many we've generated, 'functions' how many functions they
+        define, and 'inlinableDefinitions' how many of those we keep the native_ast
+        of so we can repeat them in later modules.
+        """
+        return dict(
+            modules=self.moduleCount,
+            functions=len(self._functions_by_name),
+            inlinableDefinitions=len(self._function_definitions)
+        )
+
+    def _declareModule(self, names_to_definitions):
         for name in names_to_definitions:
             assert name not in self._functions_by_name, "can't define %s twice" % name
 
-        module_name = "module_%s" % len(self._modules)
+        module_name = "module_%s" % self.moduleCount
 
         module = llvmlite.ir.Module(name=module_name)
 
-        self._modules[module_name] = module
+        self.moduleCount += 1
 
         external_function_references = {}
         populate_needed_externals(external_function_references, module)
@@ -1573,7 +2284,7 @@ class Converter:
                 output=function.output_type,
                 args=[x[1] for x in function.args],
                 varargs=False,
-                can_throw=True
+                can_throw=name not in self._functionsThatCantUnwind
             )
             func_type = llvmlite.ir.FunctionType(
                 type_to_llvm_type(function.output_type),
@@ -1583,7 +2294,11 @@ class Converter:
 
             self._functions_by_name[name].linkage = 'external'
             self._function_definitions[name] = function
+            self._functionsToRetire.add(name)
+
+        return module, external_function_references, functionTypes
 
+    def _defineModule(self, names_to_definitions, module, external_function_references, functionTypes):
         if self.verbose:
             for name in names_to_definitions:
                 definition = names_to_definitions[name]
@@ -1605,12 +2320,29 @@ class Converter:
         globalDefinitions = {}
         globalDefinitionsLlvmValues = {}
 
+        # name -> llvm function, for the functions we're copying in from other modules
+        importedFunctions = {}
+
         while names_to_definitions:
             for name in sorted(names_to_definitions):
                 definition = names_to_definitions.pop(name)
-                func = self._functions_by_name[name]
+
+                if name in importedFunctions:
+                    func = importedFunctions.pop(name)
+                else:
+                    func = self._functions_by_name[name]
+
                 func.attributes.personality = external_function_references["tp_gxx_personality_v0"]
 
+                if self.functionCantUnwind(name):
+                    func.attributes.add("nounwind")
+
+                if self.profile is not None:
+                    if self.profile.isHot(name):
+                        func.attributes.add("inlinehint")
+                    elif self.profile.isCold(name):
+                        func.attributes.add("cold")
+
                 # for a in func.args:
                 #     if a.type.is_pointer:
                 #         a.add_attribute("noalias")
@@ -1653,6 +2385,8 @@ class Converter:
                         if not builder.block.is_terminated:
                             builder.unreachable()
 
+                    func_converter.countCyclesAtReturns()
+
                 except Exception:
                     print("function failing = " + name)
                     raise
@@ -1663,6 +2397,11 @@ class Converter:
                 names_to_definitions[name] = self._function_definitions[name]
             self._inlineRequests.clear()
 
+            for name, func in self._importRequests:
+                names_to_definitions[name] = self._importableDefinitions[name]
+                importedFunctions[name] = func
+            self._importRequests.clear()
+
         # define a function that accepts a pointer and fills it out with a table of pointer values
         # so that we can link in any type objects that are defined within the source code.
         self.defineGlobalMetadataAccessor(module, globalDefinitions, globalDefinitionsLlvmValues)
@@ -15,6 +15,7 @@
 import typed_python.compiler.native_ast as native_ast
 from typed_python.compiler.expression_conversion_context import ExpressionConversionContext
 from typed_python.compiler.function_metadata import FunctionMetadata
+from typed_python.compiler.arithmetic_options import DEFAULT_OPTIONS
 
 
 class NativeFunctionConversionContext:
@@ -31,6 +32,10 @@ class NativeFunctionConversionContext:
         self._generatingFunction = generatingFunction
         self._identity = identity
         self.functionMetadata = FunctionMetadata()
+        self.arithmeticOptions = DEFAULT_OPTIONS
+        self.nogil = False
+        self.instrument = False
+        self.currentLineNumber = 0
 
     def getInputTypes(self):
         return self._input_types
@@ -46,6 +51,10 @@ class NativeFunctionConversionContext:
     def identity(self):
         return self._identity
 
+    def notePerformance(self, kind, description):
+        # native functions have no source for the performance lint to point at
+        pass
+
     def allocateLetVarname(self):
         self.varnames += 1
         return ".var_%s" % self.varnames
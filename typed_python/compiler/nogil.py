@@ -0,0 +1,40 @@
+"""Entrypoints that promise never to need the GIL.
+
+Compiled code holds on to the GIL lazily: calling an Entrypoint from the
+interpreter only releases it a little while later (see PyGilState.cpp), and any
+operation on an 'object' goes back to the interpreter for it. A numeric kernel
+that other threads are waiting on can instead ask for
+
+    @Entrypoint(nogil=True)
+    def kernel(x: ListOf(float)):
+        ...
+
+which releases the GIL as soon as the call starts, and makes it a compile-time
+error for the function, or anything it calls, to produce a python object:
+calling a NotCompiled function, using an untyped global, 'print', and so on.
+
+Raising an exception still reaches into the interpreter to build the exception,
+and so does 'except', which binds one. Those paths take the GIL back for as
+long as they need it.
+
+Like ArithmeticOptions, the promise belongs to the function's code object and
+the ones nested inside it. The functions it calls are converted separately
+(with their own names) when reached from a nogil function, so that they get
+checked too.
+"""
+
+# code objects of functions that opted in
+_nogilCodes = set()
+
+
+def setNogil(code):
+    """Make functions with code object 'code' (and those nested inside it) nogil."""
+    _nogilCodes.add(code)
+
+    for const in code.co_consts:
+        if isinstance(const, type(code)):
+            setNogil(const)
+
+
+def isNogil(code):
+    return code in _nogilCodes
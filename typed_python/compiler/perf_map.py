@@ -0,0 +1,148 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""Tell sampling profilers the names of the functions we compile.
+
+Code that MCJIT generates lives in anonymous memory, so 'perf' and py-spy can
+only show it as raw addresses. If TP_PERF_MAP=1 is set when typed_python is
+imported, or 'enablePerfMap()' is called, then whenever we load compiled
+functions we append a line
+
+    <start address> <size> <name>
+
+to /tmp/perf-<pid>.map, which is where 'perf report' and py-spy look for the
+symbols of JIT-compiled code. We do the same for modules loaded from the
+compiler cache, since the cache may evict and delete a module's .so while the
+process is still running it.
+
+Names are the functions' link names with the identity hash shortened, which
+is enough to tell overloads and specializations apart, e.g.
+
+    tp.mymodule.f.(int, float)->float.1a2b3c4d
+
+Sizes come from the symbol tables of the object files we load.
+"""
+
+import os
+import re
+import struct
+import threading
+
+
+_enabled = [os.getenv("TP_PERF_MAP") == "1"]
+
+_lock = threading.Lock()
+
+# function name -> size in bytes, from objects that MCJIT compiled but that
+# haven't been loaded yet
+_pendingSizes = {}
+
+# the size we claim for a function if we can't find out its real size
+_DEFAULT_FUNCTION_SIZE = 256
+
+
+def enablePerfMap():
+    """Start writing /tmp/perf-<pid>.map. Only functions loaded from now on get names."""
+    _enabled[0] = True
+
+
+def perfMapEnabled():
+    return _enabled[0]
+
+
+def perfMapPath():
+    return f"/tmp/perf-{os.getpid()}.map"
+
+
+def readableName(linkName):
+    """Shorten the identity hash at the end of a link name to 8 characters."""
+    return re.sub(r"\.([0-9a-f]{8})[0-9a-f]{8,}(?=$|\.)", r".\1", linkName)
+
+
+def functionSizesInElf(data):
+    """Return a dict from function name to size for the functions an ELF file defines.
+
+    'data' is the bytes of a relocatable object or a shared object, as llvm and
+    'ld' produce them for this machine (64 bit, little endian). Returns an empty
+    dict for anything else.
+    """
+    if len(data) < 64 or data[:4] != b"\x7fELF" or data[4] != 2 or data[5] != 1:
+        return {}
+
+    sectionHeaderOffset, = struct.unpack_from("<Q", data, 0x28)
+    sectionHeaderSize, sectionCount = struct.unpack_from("<HH", data, 0x3A)
+
+    sections = [
+        struct.unpack_from("<IIQQQQIIQQ", data, sectionHeaderOffset + i * sectionHeaderSize)
+        for i in range(sectionCount)
+    ]
+
+    SHT_SYMTAB = 2
+    SHT_DYNSYM = 11
+    STT_FUNC = 2
+
+    res = {}
+
+    for _, shType, _, _, offset, size, link, _, _, entrySize in sections:
+        if shType not in (SHT_SYMTAB, SHT_DYNSYM) or not entrySize:
+            continue
+
+        stringsOffset = sections[link][4]
+
+        for symOffset in range(offset, offset + size, entrySize):
+            nameOffset, info, _, _, _, symSize = struct.unpack_from("<IBBHQQ", data, symOffset)
+
+            if info & 0xF == STT_FUNC and symSize:
+                nameEnd = data.index(b"\0", stringsOffset + nameOffset)
+                res[data[stringsOffset + nameOffset:nameEnd].decode("utf8", "replace")] = symSize
+
+    return res
+
+
+def noteCompiledObject(module, objectBytes):
+    """Remember the function sizes in an object that MCJIT just compiled.
+
+    We install this as the execution engine's object cache callback, so we see
+    the code for modules that go through 'add_module', which we otherwise never
+    get our hands on.
+    """
+    if _enabled[0]:
+        sizes = functionSizesInElf(objectBytes)
+
+        with _lock:
+            _pendingSizes.update(sizes)
+
+
+def recordFunctions(addresses, sizes=None):
+    """Write perf map entries for functions that were just loaded.
+
+    Args:
+        addresses - a dict from link name to the address of the function
+        sizes - a dict from link name to size. Names it doesn't have are looked
+            up in what 'noteCompiledObject' saw.
+    """
+    if not _enabled[0] or not addresses:
+        return
+
+    with _lock:
+        lines = []
+
+        for name, address in addresses.items():
+            size = (sizes or {}).get(name) or _pendingSizes.pop(name, None) or _DEFAULT_FUNCTION_SIZE
+
+            if address:
+                lines.append(f"{address:x} {size:x} {readableName(name)}\n")
+
+        with open(perfMapPath(), "a") as f:
+            f.write("".join(lines))
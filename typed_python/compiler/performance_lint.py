@@ -0,0 +1,79 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""Notes on the places compiled code is slower than it looks.
+
+When type inference can't pin something down it quietly falls back to 'object',
+which means calling into the interpreter for every operation on it, or to a
+OneOf, which means branching on the runtime type every time it's used. Neither
+is an error, so nothing tells you. As it converts each function, the compiler
+records a PerformanceNote for
+
+    OBJECT - each expression whose type is a python object type
+    ONEOF_DISPATCH - each operation that has to dispatch on which type a OneOf holds
+    TO_PYTHON - each conversion of a typed value into a python object
+    FROM_PYTHON - each conversion of a python object into a typed value
+
+with the source line it happened on. Collect them with
+
+    with PerformanceLintVisitor() as lint:
+        f(...)
+
+    print(lint.report())
+
+(see runtime.py). Only functions compiled inside the block are reported.
+"""
+
+from typed_python import NamedTuple
+
+OBJECT = "object"
+ONEOF_DISPATCH = "oneOfDispatch"
+TO_PYTHON = "toPython"
+FROM_PYTHON = "fromPython"
+
+PerformanceNote = NamedTuple(kind=str, lineNumber=int, description=str)
+
+
+def describeExpression(ast):
+    """Return a short description of the python_ast.Expr 'ast' for a PerformanceNote."""
+    if ast.matches.Name:
+        return f"variable '{ast.id}'"
+
+    if ast.matches.Attribute:
+        return f"attribute '.{ast.attr}'"
+
+    if ast.matches.Call and ast.func.matches.Name:
+        return f"call to '{ast.func.id}'"
+
+    return f"{ast.Name} expression"
+
+
+def formatReport(functions):
+    """Format the notes of some compiled functions as text.
+
+    Args:
+        functions - a list of (funcName, filename, inputTypes, notes), where 'notes'
+            is a list of PerformanceNote.
+    """
+    lines = []
+
+    for funcName, filename, inputTypes, notes in functions:
+        lines.append(
+            f"{funcName}({', '.join(str(t.typeRepresentation) for t in inputTypes)}) in {filename}:"
+        )
+
+        for note in sorted(notes, key=lambda note: note.lineNumber):
+            lines.append(f"    line {note.lineNumber}: {note.kind}: {note.description}")
+
+    return "\n".join(lines)
@@ -54,8 +54,10 @@ from typed_python.compiler.type_wrappers.hash_wrapper import HashWrapper
 from typed_python.compiler.type_wrappers.range_wrapper import range as compilableRange
 from typed_python.compiler.type_wrappers.print_wrapper import PrintWrapper
 from typed_python.compiler.type_wrappers.serialize_wrapper import SerializeWrapper
-from typed_python.compiler.type_wrappers.deserialize_wrapper import DeserializeWrapper
+from typed_python.compiler.type_wrappers.deserialize_wrapper import DeserializeWrapper, DeserializeBufferWrapper
 from typed_python.compiler.type_wrappers.time_wrapper import TimeWrapper
+from typed_python.compiler.type_wrappers.arena_wrapper import ArenaFunctionWrapper
+from typed_python.compiler.type_wrappers.file_wrapper import FileFunctionWrapper
 from typed_python.compiler.type_wrappers.super_wrapper import SuperWrapper
 from typed_python.compiler.type_wrappers.hasattr_wrapper import HasattrWrapper
 from typed_python.compiler.type_wrappers.compiler_introspection_wrappers import (
@@ -63,13 +65,23 @@ from typed_python.compiler.type_wrappers.compiler_introspection_wrappers import
     TypeKnownToCompiler,
     LocalVariableTypesKnownToCompiler,
 )
+from typed_python.compiler.type_wrappers.compiler_hint_wrappers import (
+    LikelyWrapper,
+    AssumeWrapper,
+    UnreachableWrapper,
+    PrefetchWrapper,
+)
 from typed_python.compiler.type_wrappers.make_named_tuple_wrapper import MakeNamedTupleWrapper
 from typed_python.compiler.type_wrappers.math_wrappers import MathFunctionWrapper
 from typed_python.compiler.type_wrappers.builtin_wrappers import BuiltinWrapper
 from typed_python.compiler.type_wrappers.bytecount_wrapper import BytecountWrapper
 from typed_python.compiler.type_wrappers.arithmetic_wrapper import IntWrapper, FloatWrapper, BoolWrapper
-from typed_python.compiler.type_wrappers.string_wrapper import StringWrapper, StringMaketransWrapper
-from typed_python.compiler.type_wrappers.bytes_wrapper import BytesWrapper, BytesMaketransWrapper
+from typed_python.compiler.type_wrappers.string_wrapper import (
+    StringWrapper, StringMaketransWrapper, StringColumnParseFunctionWrapper, RegexSearchFunctionWrapper
+)
+from typed_python.compiler.type_wrappers.bytes_wrapper import (
+    BytesWrapper, BytesMaketransWrapper, BufferSearchFunctionWrapper, StructFunctionWrapper
+)
 from typed_python.compiler.type_wrappers.python_object_of_type_wrapper import PythonObjectOfTypeWrapper
 from typed_python.compiler.type_wrappers.abs_wrapper import AbsWrapper
 from typed_python.compiler.type_wrappers.all_any_wrapper import AllWrapper, AnyWrapper
@@ -78,7 +90,7 @@ from typed_python.compiler.type_wrappers.repr_wrapper import ReprWrapper
 from types import ModuleType
 from typed_python._types import (
     TypeFor, bytecount, prepareArgumentToBePassedToCompiler, allForwardTypesResolved,
-    serialize, deserialize
+    serialize, deserialize, deserializeBuffer
 )
 from typed_python import (
     Type, Int32, Int16, Int8, UInt64, UInt32, UInt16,
@@ -86,6 +98,7 @@ from typed_python import (
     ListOf, isCompiled,
     typeKnownToCompiler,
     localVariableTypesKnownToCompiler,
+    likely, unlikely, assume, unreachable, prefetch,
     pointerTo, refTo
 )
 
@@ -302,6 +315,27 @@ def pythonObjectRepresentation(context, f, owningGlobalScopeAndName=None):
     if f is time.time:
         return TypedExpression(context, native_ast.nullExpr, TimeWrapper(), False)
 
+    if f in ArenaFunctionWrapper.SUPPORTED_FUNCTIONS:
+        return TypedExpression(context, native_ast.nullExpr, ArenaFunctionWrapper(f), False)
+
+    if f is deserializeBuffer:
+        return TypedExpression(context, native_ast.nullExpr, DeserializeBufferWrapper(), False)
+
+    if f in BufferSearchFunctionWrapper.SUPPORTED_FUNCTIONS:
+        return TypedExpression(context, native_ast.nullExpr, BufferSearchFunctionWrapper(f), False)
+
+    if f in StructFunctionWrapper.SUPPORTED_FUNCTIONS:
+        return TypedExpression(context, native_ast.nullExpr, StructFunctionWrapper(f), False)
+
+    if f in StringColumnParseFunctionWrapper.SUPPORTED_FUNCTIONS:
+        return TypedExpression(context, native_ast.nullExpr, StringColumnParseFunctionWrapper(f), False)
+
+    if f in RegexSearchFunctionWrapper.SUPPORTED_FUNCTIONS:
+        return TypedExpression(context, native_ast.nullExpr, RegexSearchFunctionWrapper(f), False)
+
+    if f in FileFunctionWrapper.SUPPORTED_FUNCTIONS:
+        return TypedExpression(context, native_ast.nullExpr, FileFunctionWrapper(f), False)
+
     if f is super:
         return TypedExpression(context, native_ast.nullExpr, SuperWrapper(), False)
 
@@ -323,6 +357,18 @@ def pythonObjectRepresentation(context, f, owningGlobalScopeAndName=None):
     if f is makeNamedTuple:
         return TypedExpression(context, native_ast.nullExpr, MakeNamedTupleWrapper(), False)
 
+    if f is likely or f is unlikely:
+        return TypedExpression(context, native_ast.nullExpr, LikelyWrapper(f), False)
+
+    if f is assume:
+        return TypedExpression(context, native_ast.nullExpr, AssumeWrapper(), False)
+
+    if f is unreachable:
+        return TypedExpression(context, native_ast.nullExpr, UnreachableWrapper(), False)
+
+    if f is prefetch:
+        return TypedExpression(context, native_ast.nullExpr, PrefetchWrapper(), False)
+
     if f in MathFunctionWrapper.SUPPORTED_FUNCTIONS:
         return TypedExpression(context, native_ast.nullExpr, MathFunctionWrapper(f), False)
 
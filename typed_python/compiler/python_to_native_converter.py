@@ -23,6 +23,9 @@ import typed_python._types as _types
 import typed_python.compiler
 import typed_python.compiler.native_ast as native_ast
 from typed_python.compiler.native_function_pointer import NativeFunctionPointer
+from typed_python.compiler.arithmetic_options import DEFAULT_OPTIONS, arithmeticOptionsFor
+from typed_python.compiler.nogil import isNogil
+from typed_python.compiler.instrumentation import isInstrumented
 from sortedcontainers import SortedSet
 from typed_python.compiler.directed_graph import DirectedGraph
 from typed_python.compiler.type_wrappers.wrapper import Wrapper
@@ -34,14 +37,32 @@ from typed_python.compiler.type_wrappers.python_typed_function_wrapper import (
     PythonTypedFunctionWrapper, CannotBeDetermined, NoReturnTypeSpecified
 )
 from typed_python.compiler.typed_call_target import TypedCallTarget
+from typed_python.compiler.refcount_elision import elideRefcounts
+from typed_python.compiler.native_ast_to_llvm import expressionCount, CROSS_MODULE_IMPORT_COMPLEXITY
+from typed_python.compiler.compilation_profiler import (
+    compilationProfiler, TYPE_INFERENCE, CONVERT, CACHE_LOAD, CACHE_STORE
+)
 
 typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
 
 
 VALIDATE_FUNCTION_DEFINITIONS_STABLE = False
 
+# when the llvm compiler can use several threads, we only split a batch of new
+# functions into parallel modules if each module gets at least this many.
+MIN_FUNCTIONS_PER_PARALLEL_MODULE = 32
+
 
 class FunctionDependencyGraph:
+    """The call graph of the functions we're converting, and which of them need converting again.
+
+    We convert functions we've never seen before first, in the order we find them.
+    Then we convert the callers of functions whose signatures changed, taking the
+    strongly connected components of the call graph in reverse topological order,
+    so that a caller generally sees its callees' final signatures the first time it
+    converts again, and cycles settle among themselves before their callers start.
+    Functions whose own variable types were still changing go last.
+    """
     def __init__(self):
         self._dependencies = DirectedGraph()
 
@@ -54,27 +75,72 @@ class FunctionDependencyGraph:
         # nodes that need to recompute
         self._dirty_inflight_functions = set()
 
-        # (priority, node) pairs that need to recompute
-        self._dirty_inflight_functions_with_order = SortedSet(key=lambda pair: pair[0])
+        # (priority, node) pairs for nodes we've never computed
+        self._dirty_new_functions = SortedSet(key=lambda pair: pair[0])
+
+        # nodes that need to recompute because something they call changed
+        self._dirty_callers = set()
+
+        # (priority, node) pairs for nodes whose own types were unstable
+        self._dirty_unstable_functions = SortedSet(key=lambda pair: pair[0])
+
+        # node -> the index of its strongly connected component in reverse
+        # topological order, or None if the graph has changed since we computed it
+        self._component_order = None
 
     def dropNode(self, node):
         self._dependencies.dropNode(node, False)
         if node in self._identity_levels:
             del self._identity_levels[node]
         self._dirty_inflight_functions.discard(node)
+        self._dirty_callers.discard(node)
+        self._component_order = None
+
+    def getNextDirtyNode(self, inflight):
+        """Return the next node to recompute, or None.
+
+        Args:
+            inflight - the nodes we're converting right now. Nothing else calls
+                them, so we only need the graph between them to order the callers.
+        """
+        while self._dirty_new_functions:
+            priority, identity = self._dirty_new_functions.pop()
+
+            if identity in self._dirty_inflight_functions:
+                return self._takeDirtyNode(identity)
+
+        if self._dirty_callers:
+            if self._component_order is None:
+                self._component_order = {}
 
-    def getNextDirtyNode(self):
-        while self._dirty_inflight_functions_with_order:
-            priority, identity = self._dirty_inflight_functions_with_order.pop()
+                for index, component in enumerate(self._dependencies.stronglyConnectedComponents(inflight)):
+                    for node in component:
+                        self._component_order[node] = index
+
+            # callees' components first, and the deepest nodes first within one
+            return self._takeDirtyNode(
+                min(
+                    self._dirty_callers,
+                    key=lambda n: (self._component_order.get(n, -1), -self._identity_levels.get(n, 0))
+                )
+            )
+
+        while self._dirty_unstable_functions:
+            priority, identity = self._dirty_unstable_functions.pop()
 
             if identity in self._dirty_inflight_functions:
-                self._dirty_inflight_functions.discard(identity)
+                return self._takeDirtyNode(identity)
+
+    def _takeDirtyNode(self, identity):
+        self._dirty_inflight_functions.discard(identity)
+        self._dirty_callers.discard(identity)
 
-                return identity
+        return identity
 
     def addRoot(self, identity):
         if identity not in self._identity_levels:
             self._identity_levels[identity] = 0
+            self._component_order = None
             self.markDirty(identity)
 
     def addEdge(self, caller, callee):
@@ -86,17 +152,22 @@ class FunctionDependencyGraph:
 
             self.markDirty(callee, isNew=True)
 
-        self._dependencies.addEdge(caller, callee)
+        if not self._dependencies.hasEdge(caller, callee):
+            self._dependencies.addEdge(caller, callee)
+            self._component_order = None
 
     def getNamesDependedOn(self, caller):
         return self._dependencies.outgoing(caller)
 
+    def stronglyConnectedComponents(self, nodes):
+        return self._dependencies.stronglyConnectedComponents(nodes)
+
     def markDirtyWithLowPriority(self, callee):
-        # mark this dirty, but call it back after new functions.
+        # mark this dirty, but call it back after new functions and callers.
         self._dirty_inflight_functions.add(callee)
 
         level = self._identity_levels[callee]
-        self._dirty_inflight_functions_with_order.add((-1000000 + level, callee))
+        self._dirty_unstable_functions.add((level, callee))
 
     def markDirty(self, callee, isNew=False):
         self._dirty_inflight_functions.add(callee)
@@ -104,11 +175,9 @@ class FunctionDependencyGraph:
         if isNew:
             # if its a new node, compute it with higher priority the _higher_ it is in the stack
             # so that we do a depth-first search on the way down
-            level = 1000000 - self._identity_levels[callee]
+            self._dirty_new_functions.add((-self._identity_levels[callee], callee))
         else:
-            level = self._identity_levels[callee]
-
-        self._dirty_inflight_functions_with_order.add((level, callee))
+            self._dirty_callers.add(callee)
 
     def functionReturnSignatureChanged(self, identity):
         for caller in self._dependencies.incoming(identity):
@@ -131,15 +200,37 @@ class PythonToNativeConverter:
         # all names we loaded from the cache
         self._allCachedNames = set()
 
+        # link name of a cached function -> None, or the (definition, dependencies)
+        # that let new modules copy its body in (see '_importableCachedDefinitions')
+        self._importableCachedFunctions = {}
+
         self._link_name_for_identity = {}
         self._identity_for_link_name = {}
+
+        # link name -> native_ast.Function, for the functions we've defined but not yet
+        # handed to the llvm compiler. 'extract_new_function_definitions' empties it,
+        # and '_definitionsBuilt' counts what it handed over.
         self._definitions = {}
+        self._definitionsBuilt = 0
+
         self._targets = {}
+
+        # identity -> (native_ast.Function, output type) and identity -> the python
+        # function it came from, for the functions we're converting right now.
+        # We drop both once we've installed them. '_times_calculated' counts how
+        # many times we converted each identity, and we keep it for good.
         self._inflight_definitions = {}
         self._inflight_function_conversions = {}
         self._identifier_to_pyfunc = {}
         self._times_calculated = {}
 
+        # identity -> how many times we converted it in the current call
+        # to '_resolveAllInflightFunctions'
+        self._passes_this_round = {}
+
+        # what '_typeInferenceGroups' said about the last round of type inference
+        self.lastTypeInferenceGroups = []
+
         # function names that have been defined but not yet compiled
         self._new_native_functions = set()
 
@@ -165,7 +256,22 @@ class PythonToNativeConverter:
         return len(self._inflight_function_conversions) > 0
 
     def getDefinitionCount(self):
-        return len(self._definitions)
+        return self._definitionsBuilt + len(self._definitions)
+
+    def memoryStats(self):
+        """Return a dict describing the conversion state we're holding on to.
+
+        'functions' is the number of functions we've defined, whose call targets we
+        keep. The rest count state that should only be around while we're compiling:
+        'pendingDefinitions' are defined but not yet built, and 'inflightConversions'
+        and 'inflightDefinitions' are in the middle of type inference.
+        """
+        return dict(
+            functions=len(self._targets),
+            pendingDefinitions=len(self._definitions),
+            inflightConversions=len(self._inflight_function_conversions),
+            inflightDefinitions=len(self._inflight_definitions),
+        )
 
     def addVisitor(self, visitor):
         self._visitors.append(visitor)
@@ -192,8 +298,20 @@ class PythonToNativeConverter:
             return
 
         if self.compilerCache is None:
-            loadedModule = self.llvmCompiler.buildModule(targets)
-            loadedModule.linkGlobalVariables()
+            moduleCount = min(
+                self.llvmCompiler.parallelism,
+                len(targets) // MIN_FUNCTIONS_PER_PARALLEL_MODULE
+            )
+
+            if moduleCount > 1:
+                loadedModules = self.llvmCompiler.buildModules(
+                    self.partitionAlongCallGraph(targets, moduleCount)
+                )
+            else:
+                loadedModules = [self.llvmCompiler.buildModule(targets)]
+
+            for loadedModule in loadedModules:
+                loadedModule.linkGlobalVariables()
             return
 
         # get a set of function names that we depend on
@@ -207,22 +325,144 @@ class PythonToNativeConverter:
                     if depLN not in targets:
                         externallyUsed.add(depLN)
 
-        binary = self.llvmCompiler.buildSharedObject(targets)
+        importableDefinitions = self._importableCachedDefinitions(externallyUsed, targets)
 
-        self.compilerCache.addModule(
-            binary,
-            {name: self._targets[name] for name in targets if name in self._targets},
-            externallyUsed
-        )
+        # an imported body may call things the module didn't call before
+        for name in importableDefinitions:
+            for _, depLN in self._importableCachedFunctions[name][1]:
+                if depLN not in targets:
+                    externallyUsed.add(depLN)
+
+        # the llvm engine resolves the new code's references to cached functions
+        # when it builds it, so their shared objects have to be loaded by then.
+        with compilationProfiler.phase("ensureSymbolsLoaded", CACHE_LOAD, symbols=len(externallyUsed)):
+            self.compilerCache.ensureSymbolsLoaded(externallyUsed)
+
+        binary = self.llvmCompiler.buildSharedObject(targets, importableDefinitions)
+
+        with compilationProfiler.phase("addModule", CACHE_STORE, functions=len(targets)):
+            self.compilerCache.addModule(
+                binary,
+                {name: self._targets[name] for name in targets if name in self._targets},
+                externallyUsed
+            )
+
+    def _importableCachedDefinitions(self, externallyUsed, targets):
+        """Find the functions in cached modules whose bodies a new module may copy in.
+
+        llvm can't see into a shared object we loaded from the compiler cache, so a
+        new module could never inline even a trivial getter defined in one. But if
+        the native_ast cache has the function's definition, and it's small, we can
+        hand that to llvm too, as long as everything it calls is either in the new
+        module or in the compiler cache as well.
+
+        Returns:
+            a map from link name to native_ast.Function.
+        """
+        res = {}
+
+        for name in externallyUsed:
+            if name not in self._allCachedNames:
+                continue
+
+            if name not in self._importableCachedFunctions:
+                self._importableCachedFunctions[name] = self._lookupImportableDefinition(name)
+
+            if self._importableCachedFunctions[name] is None:
+                continue
+
+            definition, dependencies = self._importableCachedFunctions[name]
+
+            if all(
+                depLN in targets or (depLN in self._allCachedNames and self.compilerCache.hasSymbol(depLN))
+                for _, depLN in dependencies
+            ):
+                res[name] = definition
+
+        return res
+
+    def _lookupImportableDefinition(self, name):
+        """Return (definition, dependencies) for a small cached function 'name', or None."""
+        entry = self.compilerCache.nativeAsts.lookup(name)
+
+        if entry is None:
+            return None
+
+        _, definition, _, dependencies = entry
+
+        if definition.body.matches.External:
+            return None
+
+        if expressionCount(definition.body.body, CROSS_MODULE_IMPORT_COMPLEXITY) > CROSS_MODULE_IMPORT_COMPLEXITY:
+            return None
+
+        return definition, dependencies
+
+    def partitionAlongCallGraph(self, targets, moduleCount):
+        """Split a batch of new functions into 'moduleCount' groups of about equal size.
+
+        We lay the functions out depth-first along the call graph, starting from the
+        ones nothing else in the batch calls, and cut that order into contiguous runs,
+        so that most callees end up in the same module as their callers, where llvm
+        can still inline them.
+
+        Args:
+            targets - a map from link name to native_ast.Function
+            moduleCount - the number of groups to produce
+
+        Returns:
+            a list of maps from link name to native_ast.Function
+        """
+        callees = {}
+
+        for funcName in targets:
+            callees[funcName] = set()
+
+            ident = self._identity_for_link_name.get(funcName)
+            if ident is not None:
+                for dep in self._dependencies.getNamesDependedOn(ident):
+                    depLN = self._link_name_for_identity.get(dep)
+                    if depLN in targets and depLN != funcName:
+                        callees[funcName].add(depLN)
+
+        called = set()
+        for funcCallees in callees.values():
+            called.update(funcCallees)
+
+        order = []
+        seen = set()
+
+        # visit the roots first, then anything only reachable through a cycle
+        for root in [n for n in sorted(targets) if n not in called] + sorted(targets):
+            stack = [root]
+
+            while stack:
+                funcName = stack.pop()
+
+                if funcName in seen:
+                    continue
+
+                seen.add(funcName)
+                order.append(funcName)
+
+                stack.extend(sorted(callees[funcName] - seen, reverse=True))
+
+        groupSize = (len(order) + moduleCount - 1) // moduleCount
+
+        return [
+            {funcName: targets[funcName] for funcName in order[i:i + groupSize]}
+            for i in range(0, len(order), groupSize)
+        ]
 
     def extract_new_function_definitions(self):
         """Return a list of all new function definitions from the last conversion."""
         res = {}
 
         for u in self._new_native_functions:
-            res[u] = self._definitions[u]
+            res[u] = self._definitions.pop(u)
 
         self._new_native_functions = set()
+        self._definitionsBuilt += len(res)
 
         return res
 
@@ -243,7 +483,8 @@ class PythonToNativeConverter:
         closureVars,
         input_types,
         output_type,
-        conversionType
+        conversionType,
+        arithmeticOptions
     ):
         ConverterType = conversionType or FunctionConversionContext
 
@@ -260,6 +501,7 @@ class PythonToNativeConverter:
             funcGlobalsRaw,
             pyast.args,
             pyast,
+            arithmeticOptions,
         )
 
     def defineLinkName(self, identity, linkName):
@@ -281,21 +523,85 @@ class PythonToNativeConverter:
 
         self._loadFromCompilerCache(linkName)
 
+        if linkName not in self._allCachedNames:
+            self._loadFromNativeAstCache(linkName)
+
         return True
 
     def _loadFromCompilerCache(self, linkName):
         if self.compilerCache:
-            if self.compilerCache.hasSymbol(linkName):
-                callTargetsAndTypes = self.compilerCache.loadForSymbol(linkName)
+            with compilationProfiler.phase(linkName, CACHE_LOAD):
+                if self.compilerCache.hasSymbol(linkName):
+                    callTargetsAndTypes = self.compilerCache.loadForSymbol(linkName)
+
+                    if callTargetsAndTypes is not None:
+                        newTypedCallTargets, newNativeFunctionTypes = callTargetsAndTypes
+
+                        self._targets.update(newTypedCallTargets)
+                        self.llvmCompiler.markExternal(newNativeFunctionTypes)
+
+                        self._allDefinedNames.update(newNativeFunctionTypes)
+                        self._allCachedNames.update(newNativeFunctionTypes)
+
+    def _loadFromNativeAstCache(self, linkName):
+        """Define 'linkName' from the native_ast the compiler cache stored when we last converted it.
+
+        No module defines it, but if we converted it before, we can skip straight to
+        handing its definition to llvm. We only do that if everything it calls is
+        defined already, is in a cached module, or was stored too (in which case we
+        define that the same way), so we never leave a function half-defined.
+
+        Returns:
+            True if we defined 'linkName'.
+        """
+        if not self.compilerCache:
+            return False
+
+        entries = {}
+        toCheck = [linkName]
 
-                if callTargetsAndTypes is not None:
-                    newTypedCallTargets, newNativeFunctionTypes = callTargetsAndTypes
+        with compilationProfiler.phase(linkName, CACHE_LOAD, nativeAst=True):
+            while toCheck:
+                name = toCheck.pop()
 
-                    self._targets.update(newTypedCallTargets)
-                    self.llvmCompiler.markExternal(newNativeFunctionTypes)
+                if name in entries:
+                    continue
 
-                    self._allDefinedNames.update(newNativeFunctionTypes)
-                    self._allCachedNames.update(newNativeFunctionTypes)
+                entry = self.compilerCache.nativeAsts.lookup(name)
+
+                if entry is None:
+                    return False
+
+                entries[name] = entry
+
+                for _, depName in entry[3]:
+                    if depName not in entries and depName not in self._allDefinedNames:
+                        self._loadFromCompilerCache(depName)
+
+                        if depName not in self._allDefinedNames:
+                            toCheck.append(depName)
+
+        for name, (identity, definition, callTarget, _) in entries.items():
+            self._link_name_for_identity[identity] = name
+            self._identity_for_link_name[name] = identity
+            self._allDefinedNames.add(name)
+
+            # so that type inference leaves it alone, as it does functions in cached modules
+            self._allCachedNames.add(name)
+
+            self._targets[name] = callTarget
+            self._definitions[name] = definition
+            self._new_native_functions.add(name)
+            self._dependencies.addRoot(identity)
+
+        for name, (identity, _, _, dependencies) in entries.items():
+            for depIdentity, depName in dependencies:
+                if depName not in entries:
+                    self.defineLinkName(depIdentity, depName)
+
+                self._dependencies.addEdge(identity, depIdentity)
+
+        return True
 
     def defineNonPythonFunction(self, name, identityTuple, context):
         """Define a non-python generating function (if we haven't defined it before already)
@@ -335,6 +641,7 @@ class PythonToNativeConverter:
             self._resolveAllInflightFunctions()
             self._installInflightFunctions(name)
             self._inflight_function_conversions.clear()
+            self._inflight_definitions.clear()
 
         return self._targets.get(linkName)
 
@@ -511,8 +818,44 @@ class PythonToNativeConverter:
         return linkName
 
     def _resolveAllInflightFunctions(self):
+        self._passes_this_round = {}
+
+        with compilationProfiler.phase("resolveAllInflightFunctions", TYPE_INFERENCE) as phase:
+            self._resolveInflightFunctionsUntilStable()
+
+            self.lastTypeInferenceGroups = self._typeInferenceGroups()
+
+            phase.addArgs(
+                functions=len(self._passes_this_round),
+                conversions=sum(self._passes_this_round.values()),
+                groups=len(self.lastTypeInferenceGroups),
+                slowestGroups=[
+                    (passes, len(linkNames), linkNames[0])
+                    for passes, linkNames in self.lastTypeInferenceGroups[:5]
+                ]
+            )
+
+    def _typeInferenceGroups(self):
+        """Return how many passes each group of mutually recursive functions took in this round.
+
+        Returns:
+            a list of (passes, linkNames), one for each strongly connected component
+            of the functions we converted, where 'passes' is the most times we converted
+            any one of them. Most passes first.
+        """
+        groups = []
+
+        for component in self._dependencies.stronglyConnectedComponents(self._passes_this_round):
+            groups.append((
+                max(self._passes_this_round[identity] for identity in component),
+                sorted(self._link_name_for_identity[identity] for identity in component)
+            ))
+
+        return sorted(groups, key=lambda group: (-group[0], group[1]))
+
+    def _resolveInflightFunctionsUntilStable(self):
         while True:
-            identity = self._dependencies.getNextDirtyNode()
+            identity = self._dependencies.getNextDirtyNode(self._inflight_function_conversions)
             if not identity:
                 return
 
@@ -522,14 +865,14 @@ class PythonToNativeConverter:
 
             functionConverter = self._inflight_function_conversions[identity]
 
-            hasDefinitionBeforeConversion = identity in self._inflight_definitions
-
             try:
                 self._currentlyConverting = identity
 
                 self._times_calculated[identity] = self._times_calculated.get(identity, 0) + 1
+                self._passes_this_round[identity] = self._passes_this_round.get(identity, 0) + 1
 
-                nativeFunction, actual_output_type = functionConverter.convertToNativeFunction()
+                with compilationProfiler.phase(linkName, CONVERT, timesCalculated=self._times_calculated[identity]):
+                    nativeFunction, actual_output_type = functionConverter.convertToNativeFunction()
 
                 if nativeFunction is not None:
                     self._inflight_definitions[identity] = (nativeFunction, actual_output_type)
@@ -543,6 +886,7 @@ class PythonToNativeConverter:
                         ln = self._link_name_for_identity.pop(i)
                         self._identity_for_link_name.pop(ln)
 
+                    self._identifier_to_pyfunc.pop(i, None)
                     self._dependencies.dropNode(i)
 
                 self._inflight_function_conversions.clear()
@@ -551,22 +895,15 @@ class PythonToNativeConverter:
             finally:
                 self._currentlyConverting = None
 
-            dirtyUpstream = False
-
-            # figure out whether we ought to recalculate all the upstream nodes of this
-            # node. we do that if we get a definition and we didn't have one before, or if
-            # our type stability changed
             if nativeFunction is not None:
-                if not hasDefinitionBeforeConversion:
-                    dirtyUpstream = True
-
                 if functionConverter.typesAreUnstable():
                     functionConverter.resetTypeInstabilityFlag()
                     self._dependencies.markDirtyWithLowPriority(identity)
-                    dirtyUpstream = True
 
                 name = self._link_name_for_identity[identity]
 
+                previousTarget = self._targets.get(name)
+
                 self._targets[name] = self.getTypedCallTarget(
                     name,
                     functionConverter._input_types,
@@ -575,8 +912,10 @@ class PythonToNativeConverter:
                     functionMetadata=functionConverter.functionMetadata
                 )
 
-            if dirtyUpstream:
-                self._dependencies.functionReturnSignatureChanged(identity)
+                # our callers only ever see our TypedCallTarget, so they only need to
+                # convert again if it's new or says something different than it did.
+                if previousTarget is None or not previousTarget.hasSameSignatureAs(self._targets[name]):
+                    self._dependencies.functionReturnSignatureChanged(identity)
 
     def triggerVirtualDestructor(self, instanceType):
         self._delayedDestructors.append(instanceType)
@@ -622,53 +961,111 @@ class PythonToNativeConverter:
                 self.compileClassDestructor(T)
 
     def compileSingleClassDispatch(self, interfaceClass, implementingClass, slotIndex):
-        if (interfaceClass, implementingClass, slotIndex) in self._installedVMIs:
+        self.compileClassDispatches([(interfaceClass, implementingClass, slotIndex)])
+
+    def compileClassDispatches(self, dispatches, destructors=()):
+        """Compile and install a batch of class dispatches and destructors, linked as one module.
+
+        Args:
+            dispatches - a list of (interfaceClass, implementingClass, slotIndex)
+            destructors - a list of Classes
+        """
+        dispatches = [d for d in dict.fromkeys(dispatches) if d not in self._installedVMIs]
+        destructors = [T for T in dict.fromkeys(destructors) if T not in self._installedDestructors]
+
+        if not dispatches and not destructors:
             return
 
-        name, retType, argTypeTuple, kwargTypeTuple = _types.getClassMethodDispatchSignature(interfaceClass, implementingClass, slotIndex)
+        dispatchTargets = []
 
-        # we are compiling the function 'name' in 'implementingClass' to be installed when
-        # viewing an instance of 'implementingClass' as 'interfaceClass' that's function
-        # 'name' called with signature '(*argTypeTuple, **kwargTypeTuple) -> retType'
-        typedCallTarget = ClassWrapper.compileVirtualMethodInstantiation(
-            self,
-            interfaceClass,
-            implementingClass,
-            name,
-            retType,
-            argTypeTuple,
-            kwargTypeTuple
-        )
+        for interfaceClass, implementingClass, slotIndex in dispatches:
+            name, retType, argTypeTuple, kwargTypeTuple = _types.getClassMethodDispatchSignature(
+                interfaceClass, implementingClass, slotIndex
+            )
+
+            # we are compiling the function 'name' in 'implementingClass' to be installed when
+            # viewing an instance of 'implementingClass' as 'interfaceClass' that's function
+            # 'name' called with signature '(*argTypeTuple, **kwargTypeTuple) -> retType'
+            typedCallTarget = ClassWrapper.compileVirtualMethodInstantiation(
+                self,
+                interfaceClass,
+                implementingClass,
+                name,
+                retType,
+                argTypeTuple,
+                kwargTypeTuple
+            )
+
+            assert typedCallTarget is not None
+
+            dispatchTargets.append(typedCallTarget)
+
+            if self.compilerCache is not None:
+                self.compilerCache.classDispatches.recordDispatch(
+                    interfaceClass, implementingClass, name, retType, argTypeTuple, kwargTypeTuple
+                )
+
+        destructorTargets = []
+
+        for T in destructors:
+            typedCallTarget = typeWrapper(T).compileDestructor(self)
 
-        assert typedCallTarget is not None
+            assert typedCallTarget is not None
+
+            destructorTargets.append(typedCallTarget)
+
+            if self.compilerCache is not None:
+                self.compilerCache.classDispatches.recordDestructor(T)
 
         self.buildAndLinkNewModule()
 
-        fp = self.functionPointerByName(typedCallTarget.name)
+        for (interfaceClass, implementingClass, slotIndex), typedCallTarget in zip(dispatches, dispatchTargets):
+            fp = self.functionPointerByName(typedCallTarget.name)
 
-        if fp is None:
-            raise Exception(f"Couldn't find a function pointer for {typedCallTarget.name}")
+            if fp is None:
+                raise Exception(f"Couldn't find a function pointer for {typedCallTarget.name}")
 
-        _types.installClassMethodDispatch(interfaceClass, implementingClass, slotIndex, fp.fp)
+            _types.installClassMethodDispatch(interfaceClass, implementingClass, slotIndex, fp.fp)
 
-        self._installedVMIs.add(
-            (interfaceClass, implementingClass, slotIndex)
-        )
+            self._installedVMIs.add(
+                (interfaceClass, implementingClass, slotIndex)
+            )
+
+        for T, typedCallTarget in zip(destructors, destructorTargets):
+            fp = self.functionPointerByName(typedCallTarget.name)
+
+            _types.installClassDestructor(T, fp.fp)
+            self._installedDestructors.add(T)
 
     def compileClassDestructor(self, cls):
-        if cls in self._installedDestructors:
-            return
+        self.compileClassDispatches([], [cls])
+
+    def recordedClassDispatches(self, implementingClass=None):
+        """The dispatches and destructors earlier processes compiled, that we haven't.
 
-        typedCallTarget = typeWrapper(cls).compileDestructor(self)
+        Returns:
+            a pair (dispatches, destructors) to pass to 'compileClassDispatches'. If
+            'implementingClass' is given, only the ones for it.
+        """
+        if self.compilerCache is None:
+            return [], []
 
-        assert typedCallTarget is not None
+        dispatches = []
 
-        self.buildAndLinkNewModule()
+        for interface, implementing, name, retType, argTupleType, kwargTupleType in (
+            self.compilerCache.classDispatches.dispatches(implementingClass)
+        ):
+            slot = _types.allocateClassMethodDispatch(interface, name, retType, argTupleType, kwargTupleType)
 
-        fp = self.functionPointerByName(typedCallTarget.name)
+            if (interface, implementing, slot) not in self._installedVMIs:
+                dispatches.append((interface, implementing, slot))
 
-        _types.installClassDestructor(cls, fp.fp)
-        self._installedDestructors.add(cls)
+        destructors = [
+            T for T in self.compilerCache.classDispatches.destructors()
+            if T not in self._installedDestructors and implementingClass in (None, T)
+        ]
+
+        return dispatches, destructors
 
     def functionPointerByName(self, linkerName) -> NativeFunctionPointer:
         """Find a NativeFunctionPointer for a given link-time name.
@@ -753,6 +1150,9 @@ class PythonToNativeConverter:
         if isinstance(hashable, Wrapper):
             return hashable.identityHash()
 
+        if self.compilerCache is not None:
+            return Hash(self.compilerCache.typeGroupHashes.identityHash(hashable))
+
         return Hash(_types.identityHash(hashable))
 
     def hashGlobals(self, funcGlobals, code, funcGlobalsFromCells):
@@ -829,6 +1229,10 @@ class PythonToNativeConverter:
 
         input_types = tuple([typedPythonTypeToTypeWrapper(i) for i in input_types])
 
+        arithmeticOptions = self.arithmeticOptionsForConversion(funcCode, conversionType)
+        nogil = self.nogilForConversion(funcCode)
+        instrument = self.instrumentForConversion(funcCode)
+
         identityHash = (
             Hash.from_integer(1)
             + self.hashObjectToIdentity((
@@ -842,6 +1246,21 @@ class PythonToNativeConverter:
             self.hashGlobals(funcGlobals, funcCode, funcGlobalsFromCells)
         )
 
+        if arithmeticOptions != DEFAULT_OPTIONS:
+            # only hash the options in when they're set, so that opting in doesn't change
+            # the names (and the compiler cache entries) of everything else
+            identityHash += self.hashObjectToIdentity(
+                ("arithmeticOptions", arithmeticOptions.fastMath, arithmeticOptions.assumeNoIntOverflow)
+            )
+
+        if nogil:
+            # likewise, and this keeps the checked copy of a function called from nogil
+            # code separate from the unchecked one everybody else calls
+            identityHash += self.hashObjectToIdentity("nogil")
+
+        if instrument:
+            identityHash += self.hashObjectToIdentity("instrument")
+
         assert not identityHash.isPoison()
 
         identity = identityHash.hexdigest
@@ -850,10 +1269,8 @@ class PythonToNativeConverter:
 
         self.defineLinkName(identity, name)
 
-        if identity not in self._identifier_to_pyfunc:
-            self._identifier_to_pyfunc[identity] = (
-                funcName, funcCode, funcGlobals, closureVars, input_types, output_type, conversionType
-            )
+        if instrument:
+            self.llvmCompiler.instrumentFunction(name)
 
         isRoot = len(self._inflight_function_conversions) == 0
 
@@ -869,6 +1286,10 @@ class PythonToNativeConverter:
             return self._targets[name]
 
         if identity not in self._inflight_function_conversions:
+            self._identifier_to_pyfunc[identity] = (
+                funcName, funcCode, funcGlobals, closureVars, input_types, output_type, conversionType
+            )
+
             functionConverter = self.createConversionContext(
                 identity,
                 funcName,
@@ -878,8 +1299,11 @@ class PythonToNativeConverter:
                 closureVars,
                 input_types,
                 output_type,
-                conversionType
+                conversionType,
+                arithmeticOptions
             )
+            functionConverter.nogil = nogil
+            functionConverter.instrument = instrument
 
             self._inflight_function_conversions[identity] = functionConverter
 
@@ -890,6 +1314,7 @@ class PythonToNativeConverter:
                 return self._targets[name]
             finally:
                 self._inflight_function_conversions.clear()
+                self._inflight_definitions.clear()
 
         else:
             # above us on the stack, we are walking a set of function conversions.
@@ -902,6 +1327,50 @@ class PythonToNativeConverter:
             else:
                 return None
 
+    def arithmeticOptionsForConversion(self, funcCode, conversionType):
+        """Return the ArithmeticOptions to convert 'funcCode' with.
+
+        Comprehensions get rebuilt from the ast of the function they appear in, so
+        their code objects are new. They inherit the options of the function we're
+        converting them from.
+        """
+        options = arithmeticOptionsFor(funcCode)
+
+        if (
+            options == DEFAULT_OPTIONS
+            and conversionType is not None
+            and self._currentlyConverting in self._inflight_function_conversions
+        ):
+            return self._inflight_function_conversions[self._currentlyConverting].arithmeticOptions
+
+        return options
+
+    def nogilForConversion(self, funcCode):
+        """Return True if 'funcCode' must be converted without producing python objects.
+
+        That's the case if it opted in, or if we reached it from a function that did.
+        """
+        if isNogil(funcCode):
+            return True
+
+        if self._currentlyConverting in self._inflight_function_conversions:
+            return self._inflight_function_conversions[self._currentlyConverting].nogil
+
+        return False
+
+    def instrumentForConversion(self, funcCode):
+        """Return True if 'funcCode' should keep the counters in instrumentation.py.
+
+        That's the case if it opted in, or if we reached it from a function that did.
+        """
+        if isInstrumented(funcCode):
+            return True
+
+        if self._currentlyConverting in self._inflight_function_conversions:
+            return self._inflight_function_conversions[self._currentlyConverting].instrument
+
+        return False
+
     def _installInflightFunctions(self, name):
         if VALIDATE_FUNCTION_DEFINITIONS_STABLE:
             # this should always be true, but its expensive so we have it off by default
@@ -957,6 +1426,10 @@ class PythonToNativeConverter:
                         outboundTargets
                     )
 
+            # this holds on to the function's globals and closure, which we don't need
+            # once the visitors have seen it
+            self._identifier_to_pyfunc.pop(identifier, None)
+
             if identifier not in self._inflight_definitions:
                 raise Exception(
                     f"Expected a definition for {identifier} depended on by:\n"
@@ -967,5 +1440,18 @@ class PythonToNativeConverter:
 
             name = self._link_name_for_identity[identifier]
 
-            self._definitions[name] = nativeFunction
+            self._definitions[name] = elideRefcounts(nativeFunction)
             self._new_native_functions.add(name)
+
+            if self.compilerCache is not None:
+                with compilationProfiler.phase(name, CACHE_STORE, nativeAst=True):
+                    self.compilerCache.nativeAsts.store(
+                        name,
+                        identifier,
+                        self._definitions[name],
+                        self._targets[name],
+                        [
+                            (dep, self._link_name_for_identity[dep])
+                            for dep in self._dependencies.getNamesDependedOn(identifier)
+                        ]
+                    )
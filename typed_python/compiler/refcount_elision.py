@@ -0,0 +1,468 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""Remove incref/decref pairs on temporaries that a live reference keeps alive anyway.
+
+Every time the compiler copies a refcounted value (a ListOf, a str, a Class instance...)
+into a temporary stack slot, it increfs it, and it decrefs it again when the temporary
+goes out of scope at the end of the enclosing expression. Both are atomic operations.
+If the value was loaded from some location that still holds its own reference for as
+long as the temporary is in use, neither one does anything useful.
+
+ExpressionConversionContext.finalize lays temporaries out as
+
+    Finally(
+        expr=ApplyIntermediates(
+            base,
+            [..., Effect(<copy 'src' into StackSlot s>), ..., Effect(ActivatesTeardown(s)), ...]
+        ),
+        teardowns=[..., ByTag(s, <decref s>), ...]
+    )
+
+and RefcountedWrapper.convert_copy_initialize tags the copy with 'markRefcountCopy'.
+For each such copy we find the last intermediate that uses 's', and we borrow instead of
+copying (keep the store, drop the incref, the activation and the teardown) if
+
+    * 'src' is a load from a location built out of stack slots, let-variables, and
+      pointer arithmetic, so we know what could change it;
+    * nothing before that last use can release a reference: there are no calls, no
+      stores except to stack slots that 'src' doesn't depend on, and no atomic adds
+      other than increfs. Code that can only end in a 'Throw' is exempt (unless there's
+      a TryCatch that could resume), since control never comes back to use 's';
+    * the temporary's value is only ever inspected - dereferenced, compared, or branched
+      on - so it can't end up owned by anything else.
+
+Calls are treated as barriers, since we don't know what they release. That leaves
+temporaries that outlive a call, and named local variables, which live until the
+function exits, with their refcounting intact.
+"""
+
+import typed_python.compiler.native_ast as native_ast
+from typed_python import TupleOf
+
+
+# set this to False to compile without eliding anything
+ELIDE_REFCOUNTS = True
+
+REFCOUNT_COPY_COMMENT = "refcount copy"
+
+ExpressionIntermediate = native_ast.ExpressionIntermediate
+Expression = native_ast.Expression
+
+
+def markRefcountCopy(storeExpr, increfExpr):
+    """Tag the copy-initialization of a refcounted value, so 'elideRefcounts' can find it.
+
+    Args:
+        storeExpr - a native_ast.Expression.Store writing the value into its slot
+        increfExpr - the expression that increfs the value once it's stored
+    """
+    return Expression.Comment(comment=REFCOUNT_COPY_COMMENT, expr=storeExpr >> increfExpr)
+
+
+def refcountCopyStore(expr):
+    """If 'expr' was made by 'markRefcountCopy', return its Store. Otherwise None."""
+    if (
+        expr.matches.Comment
+        and expr.comment == REFCOUNT_COPY_COMMENT
+        and expr.expr.matches.Sequence
+        and expr.expr.vals[0].matches.Store
+    ):
+        return expr.expr.vals[0]
+
+    return None
+
+
+def elideRefcounts(nativeFunction):
+    """Return 'nativeFunction' (a native_ast.Function) with redundant refcounting removed."""
+    if not ELIDE_REFCOUNTS or not nativeFunction.body.matches.Internal:
+        return nativeFunction
+
+    newBody = _rewrite(nativeFunction.body.body)
+
+    if newBody is None:
+        return nativeFunction
+
+    return native_ast.Function(
+        args=nativeFunction.args,
+        body=native_ast.FunctionBody.Internal(body=newBody),
+        output_type=nativeFunction.output_type
+    )
+
+
+def _rewrite(expr):
+    """Elide what we can in 'expr', innermost scopes first.
+
+    Returns:
+        the new expression, or None if nothing changed. (typed_python hands us a new
+        python object every time we read a field, so we can't compare by identity.)
+    """
+    if expr.matches.MakeStruct:
+        newArgs = [(name, _rewrite(e)) for name, e in expr.args]
+
+        if all(new is None for _, new in newArgs):
+            return None
+
+        return Expression.MakeStruct(
+            args=[(name, new if new is not None else old) for (name, new), (_, old) in zip(newArgs, expr.args)]
+        )
+
+    args = {}
+    changed = False
+
+    for name in expr.ElementType.ElementNames:
+        child = getattr(expr, name)
+        newChild = None
+
+        if isinstance(child, Expression):
+            newChild = _rewrite(child)
+        elif isinstance(child, TupleOf(Expression)):
+            newChild = _rewriteAll(child, _rewrite)
+        elif isinstance(child, TupleOf(ExpressionIntermediate)):
+            newChild = _rewriteAll(child, _rewriteIntermediate)
+        elif isinstance(child, TupleOf(native_ast.Teardown)):
+            newChild = _rewriteAll(child, _rewriteTeardown)
+
+        args[name] = newChild if newChild is not None else child
+        changed = changed or newChild is not None
+
+    if changed:
+        expr = type(expr)(**args)
+
+    if expr.matches.Finally and expr.expr.matches.ApplyIntermediates:
+        elided = _elideInFinally(expr)
+
+        if elided is not None:
+            return elided
+
+    return expr if changed else None
+
+
+def _rewriteAll(children, rewriteOne):
+    newChildren = [rewriteOne(c) for c in children]
+
+    if all(c is None for c in newChildren):
+        return None
+
+    return [new if new is not None else old for new, old in zip(newChildren, children)]
+
+
+def _rewriteIntermediate(intermediate):
+    newExpr = _rewrite(intermediate.expr)
+
+    if newExpr is None:
+        return None
+
+    return _withExpr(intermediate, newExpr)
+
+
+def _rewriteTeardown(teardown):
+    newExpr = _rewrite(teardown.expr)
+
+    if newExpr is None:
+        return None
+
+    if teardown.matches.ByTag:
+        return native_ast.Teardown.ByTag(tag=teardown.tag, expr=newExpr)
+
+    return native_ast.Teardown.Always(expr=newExpr)
+
+
+def _withExpr(intermediate, expr):
+    if intermediate.matches.Effect:
+        return ExpressionIntermediate.Effect(expr=expr)
+    if intermediate.matches.Terminal:
+        return ExpressionIntermediate.Terminal(expr=expr)
+    if intermediate.matches.Simple:
+        return ExpressionIntermediate.Simple(name=intermediate.name, expr=expr)
+
+    return ExpressionIntermediate.StackSlot(name=intermediate.name, expr=expr)
+
+
+def _elideInFinally(finallyExpr):
+    """Return 'finallyExpr' with the copies we can borrow elided, or None if there aren't any."""
+    applyExpr = finallyExpr.expr
+    intermediates = list(applyExpr.intermediates)
+    teardowns = list(finallyExpr.teardowns)
+
+    teardownTags = [t.tag for t in teardowns if t.matches.ByTag]
+
+    elidedAny = False
+
+    for copyIx in range(len(intermediates)):
+        if not intermediates[copyIx].matches.Effect:
+            continue
+
+        store = refcountCopyStore(intermediates[copyIx].expr)
+
+        if store is None or not store.ptr.matches.StackSlot:
+            continue
+
+        slotName = store.ptr.name
+
+        if teardownTags.count(slotName) != 1:
+            continue
+
+        activationIx = _canBorrow(store, slotName, intermediates, copyIx, applyExpr.base, teardowns)
+
+        if activationIx is None:
+            continue
+
+        intermediates[copyIx] = ExpressionIntermediate.Effect(expr=store)
+        intermediates[activationIx] = ExpressionIntermediate.Effect(expr=native_ast.nullExpr)
+        teardowns = [t for t in teardowns if not (t.matches.ByTag and t.tag == slotName)]
+        elidedAny = True
+
+    if not elidedAny:
+        return None
+
+    intermediates = [
+        i for i in intermediates if not (i.matches.Effect and i.expr == native_ast.nullExpr)
+    ]
+
+    return Expression.Finally(
+        expr=Expression.ApplyIntermediates(base=applyExpr.base, intermediates=intermediates),
+        teardowns=teardowns,
+        name=finallyExpr.name
+    )
+
+
+def _isActivation(intermediate, slotName):
+    return (
+        (intermediate.matches.Effect or intermediate.matches.StackSlot)
+        and intermediate.expr.matches.ActivatesTeardown
+        and intermediate.expr.name == slotName
+    )
+
+
+def _canBorrow(store, slotName, intermediates, copyIx, base, teardowns):
+    """Decide whether the copy at 'intermediates[copyIx]' can be a borrow.
+
+    Returns:
+        None, or the index of the intermediate that activates the slot's teardown.
+    """
+    sourceSlots = _stableLocationSlots(store.val.ptr) if store.val.matches.Load else None
+
+    if sourceSlots is None or slotName in sourceSlots:
+        return None
+
+    # nothing else may touch the slot before we initialize it
+    for i in intermediates[:copyIx]:
+        if _mentionsSlot(i.expr, slotName):
+            return None
+
+    if _mentionsSlot(store.val, slotName):
+        return None
+
+    for t in teardowns:
+        if not (t.matches.ByTag and t.tag == slotName) and _mentionsSlot(t.expr, slotName):
+            return None
+
+    activationIx = None
+    rest = []
+
+    for ix in range(copyIx + 1, len(intermediates)):
+        if _isActivation(intermediates[ix], slotName) and activationIx is None:
+            activationIx = ix
+        else:
+            rest.append(intermediates[ix].expr)
+
+    rest.append(base)
+
+    if activationIx is None:
+        return None
+
+    lastUse = max([ix for ix, e in enumerate(rest) if _mentionsSlot(e, slotName)], default=-1)
+
+    live = rest[:lastUse + 1]
+
+    if any(_mentionsActivation(e, slotName) for e in rest):
+        return None
+
+    canResume = any(_containsTryCatch(e) for e in live)
+
+    for e in live:
+        if _isSlotValue(e, slotName) or not _isBorrowSafe(e, slotName, sourceSlots, canResume):
+            return None
+
+    return activationIx
+
+
+def _stableLocationSlots(ptr):
+    """Return the stack slots the location 'ptr' depends on, or None if we can't tell.
+
+    We understand locations made of stack slots, let-variables, constants, and pointer
+    arithmetic, including loads through pointers (which we treat as heap memory, and so
+    only changeable by calls and stores outside the stack).
+    """
+    if ptr.matches.StackSlot:
+        return {ptr.name}
+
+    if ptr.matches.Variable or ptr.matches.Constant:
+        return set()
+
+    if ptr.matches.Load or ptr.matches.Cast or ptr.matches.StructElementByIndex:
+        return _stableLocationSlots(ptr.ptr if ptr.matches.Load else ptr.left)
+
+    if ptr.matches.ElementPtr:
+        res = _stableLocationSlots(ptr.left)
+
+        for o in ptr.offsets:
+            sub = _stableLocationSlots(o)
+
+            if res is None or sub is None:
+                return None
+
+            res = res | sub
+
+        return res
+
+    if ptr.matches.Binop:
+        left = _stableLocationSlots(ptr.left)
+        right = _stableLocationSlots(ptr.right)
+
+        if left is None or right is None:
+            return None
+
+        return left | right
+
+    return None
+
+
+def _stackSlotRoot(ptr):
+    """If 'ptr' points into a stack slot (without going through a load), return the slot's name."""
+    while True:
+        if ptr.matches.StackSlot:
+            return ptr.name
+
+        if ptr.matches.ElementPtr or ptr.matches.Cast or ptr.matches.StructElementByIndex:
+            ptr = ptr.left
+        else:
+            return None
+
+
+def _namedChildren(expr):
+    """Yield (fieldName, child) for every native_ast.Expression directly inside 'expr'."""
+    if expr.matches.MakeStruct:
+        for _, e in expr.args:
+            yield "args", e
+        return
+
+    if expr.matches.Call and expr.target.matches.Pointer:
+        yield "target", expr.target.expr
+
+    if expr.matches.Finally:
+        for t in expr.teardowns:
+            yield "teardowns", t.expr
+
+    for name in expr.ElementType.ElementNames:
+        child = getattr(expr, name)
+
+        if isinstance(child, Expression):
+            yield name, child
+        elif isinstance(child, TupleOf(Expression)):
+            for c in child:
+                yield name, c
+        elif isinstance(child, TupleOf(ExpressionIntermediate)):
+            for i in child:
+                yield name, i.expr
+
+
+def _children(expr):
+    for _, child in _namedChildren(expr):
+        yield child
+
+
+def _mentionsSlot(expr, slotName):
+    if expr.matches.StackSlot:
+        return expr.name == slotName
+
+    return any(_mentionsSlot(c, slotName) for c in _children(expr))
+
+
+def _mentionsActivation(expr, slotName):
+    if expr.matches.ActivatesTeardown:
+        return expr.name == slotName
+
+    return any(_mentionsActivation(c, slotName) for c in _children(expr))
+
+
+def _containsTryCatch(expr):
+    if expr.matches.TryCatch:
+        return True
+
+    return any(_containsTryCatch(c) for c in _children(expr))
+
+
+def _alwaysThrows(expr):
+    if expr.matches.Throw:
+        return True
+
+    if expr.matches.Sequence:
+        return _alwaysThrows(expr.vals[-1])
+
+    return False
+
+
+def _isSlotValue(expr, slotName):
+    return expr.matches.Load and expr.ptr.matches.StackSlot and expr.ptr.name == slotName
+
+
+def _isBorrowSafe(expr, slotName, sourceSlots, canResume):
+    """Check that 'expr' can't release the source's reference or take ownership of the slot's value.
+
+    Our caller has already checked how 'expr' itself uses the slot.
+    """
+    if _isSlotValue(expr, slotName):
+        return True
+
+    if expr.matches.StackSlot:
+        return expr.name != slotName
+
+    if not canResume and _alwaysThrows(expr) and not _mentionsSlot(expr, slotName):
+        return True
+
+    if expr.matches.Call:
+        return False
+
+    if expr.matches.Store:
+        root = _stackSlotRoot(expr.ptr)
+
+        if root is None or root == slotName or root in sourceSlots:
+            return False
+
+    if (
+        expr.matches.AtomicStore or expr.matches.AtomicCompareExchange
+        or expr.matches.AtomicFetchAdd or expr.matches.AtomicExchange
+    ):
+        return False
+
+    if expr.matches.AtomicAdd:
+        if not (expr.val.matches.Constant and expr.val.val.matches.Int and expr.val.val.val > 0):
+            return False
+
+    for fieldName, child in _namedChildren(expr):
+        # the slot's value may only be dereferenced, compared or branched on
+        if _isSlotValue(child, slotName) and not (
+            (expr.matches.ElementPtr and fieldName == "left")
+            or (expr.matches.Branch and fieldName == "cond")
+            or (expr.matches.Switch and fieldName == "value")
+            or expr.matches.Binop
+        ):
+            return False
+
+        if not _isBorrowSafe(child, slotName, sourceSlots, canResume):
+            return False
+
+    return True
@@ -12,16 +12,30 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import atexit
+import gc
 import threading
 import os
 import time
 import types
 import typed_python.compiler.python_to_native_converter as python_to_native_converter
 import typed_python.compiler.llvm_compiler as llvm_compiler
+import typed_python.compiler.performance_lint as performance_lint
 import typed_python
 from typed_python.compiler.runtime_lock import runtimeLock
 from typed_python.compiler.conversion_level import ConversionLevel
+from typed_python.compiler.arithmetic_options import ArithmeticOptions, setArithmeticOptions
+from typed_python.compiler.nogil import setNogil
+from typed_python.compiler.value_specialization import setSpecializedArguments, specializedArguments, canSpecializeOn
+from typed_python.compiler.specialization_budget import (
+    SpecializationBudget, setSpecializationBudget, genericSpecializationTypeFor
+)
+from typed_python.compiler.instrumentation import setInstrumented, liveInstrumentation
 from typed_python.compiler.compiler_cache import CompilerCache
+from typed_python.compiler.tier_up_compiler import TierUpCompiler
+from typed_python.compiler.background_compiler import BackgroundCompiler
+from typed_python.compiler.execution_profile import ExecutionProfile, liveCounters
+from typed_python.compiler.compilation_profiler import compilationProfiler
 from typed_python.type_function import TypeFunction
 from typed_python.compiler.type_wrappers.typed_tuple_masquerading_as_tuple_wrapper import TypedTupleMasqueradingAsTuple
 from typed_python.compiler.type_wrappers.named_tuple_masquerading_as_dict_wrapper import NamedTupleMasqueradingAsDict
@@ -71,6 +85,14 @@ class RuntimeEventVisitor:
     ):
         pass
 
+    def onCompilationPhase(self, phase):
+        """Called with a CompilationPhase each time the compiler finishes a phase of its work.
+
+        This can happen on background compiler threads. We only time phases for
+        visitors that override this.
+        """
+        pass
+
     def __enter__(self):
         Runtime.singleton().addEventVisitor(self)
         return self
@@ -169,6 +191,50 @@ class PrintNewFunctionVisitor(RuntimeEventVisitor):
                     print("        ", callTarget)
 
 
+class PerformanceLintVisitor(RuntimeEventVisitor):
+    """A visitor that collects the places compiled code falls back to python objects or OneOf dispatch.
+
+    Usage:
+        with PerformanceLintVisitor() as lint:
+            f()
+
+        print(lint.report())
+
+    See typed_python/compiler/performance_lint.py for what gets reported.
+    """
+    def __init__(self):
+        # a list of (funcName, filename, inputTypes, notes)
+        self.functions = []
+
+    def onNewFunction(
+        self,
+        identifier,
+        functionConverter,
+        nativeFunction,
+        funcName,
+        funcCode,
+        funcGlobals,
+        closureVars,
+        inputTypes,
+        outputType,
+        yieldType,
+        variableTypes,
+        conversionType,
+        calledFunctions,
+    ):
+        if functionConverter.performanceNotes:
+            self.functions.append(
+                (funcName, funcCode.co_filename, inputTypes, list(functionConverter.performanceNotes))
+            )
+
+    def notesFor(self, funcName):
+        """Return the PerformanceNotes of every specialization of 'funcName' we saw compiled."""
+        return [note for name, _, _, notes in self.functions if name == funcName for note in notes]
+
+    def report(self):
+        return performance_lint.formatReport(self.functions)
+
+
 class CountCompilationsVisitor(RuntimeEventVisitor):
     def __init__(self):
         self.count = 0
@@ -201,13 +267,66 @@ class Runtime:
         return _singleton[0]
 
     def __init__(self):
-        if os.getenv("TP_COMPILER_CACHE"):
-            self.compilerCache = CompilerCache(
-                os.path.abspath(os.getenv("TP_COMPILER_CACHE"))
+        # TP_COMPILER_PGO=instrument makes the code we compile count its calls and
+        # branch outcomes, and adds the counts to the execution profile when the
+        # process exits. TP_COMPILER_PGO=use weights branches and marks functions hot
+        # or cold according to that profile. The profile lives at
+        # TP_COMPILER_PGO_PROFILE, or next to the compiler cache. Instrumented code
+        # never goes into the compiler cache, and code that's already there doesn't
+        # get rebuilt to use a new profile.
+        pgoMode = os.getenv("TP_COMPILER_PGO")
+
+        if os.getenv("TP_COMPILER_PGO_PROFILE"):
+            self.executionProfilePath = os.path.abspath(os.getenv("TP_COMPILER_PGO_PROFILE"))
+        elif os.getenv("TP_COMPILER_CACHE"):
+            self.executionProfilePath = os.path.join(
+                os.path.abspath(os.getenv("TP_COMPILER_CACHE")), "execution_profile.json"
             )
+        else:
+            self.executionProfilePath = None
+
+        if pgoMode not in (None, "", "instrument", "use"):
+            raise Exception(f"TP_COMPILER_PGO should be 'instrument' or 'use', not {pgoMode}")
+
+        if pgoMode and self.executionProfilePath is None:
+            raise Exception("TP_COMPILER_PGO needs TP_COMPILER_PGO_PROFILE or TP_COMPILER_CACHE")
+
+        if os.getenv("TP_COMPILER_CACHE") and pgoMode != "instrument":
+            cacheDir = os.path.abspath(os.getenv("TP_COMPILER_CACHE"))
+
+            # code built for a particular cpu (see TP_COMPILER_TARGET_CPU) gets its own cache
+            if llvm_compiler.targetCacheSubdirectory() is not None:
+                cacheDir = os.path.join(cacheDir, llvm_compiler.targetCacheSubdirectory())
+
+            # if TP_COMPILER_CACHE_MAX_BYTES is set, we evict least recently used
+            # modules at startup until the cache is no bigger than that.
+            maxBytes = os.getenv("TP_COMPILER_CACHE_MAX_BYTES")
+
+            self.compilerCache = CompilerCache(cacheDir, int(maxBytes) if maxBytes else None)
         else:
             self.compilerCache = None
-        self.llvm_compiler = llvm_compiler.Compiler(inlineThreshold=100)
+
+        # if TP_COMPILER_TIERED is set, we build new code quickly at a low optimization
+        # level, and rebuild each entrypoint at full optimization on a background thread
+        # once it's been called TP_COMPILER_TIERED times. Code we write to the compiler
+        # cache is always fully optimized.
+        tierUpAfterCalls = int(os.getenv("TP_COMPILER_TIERED") or 0)
+
+        # if TP_COMPILER_THREADS is set, large batches of new functions get split into
+        # that many modules, which we optimize and generate code for in parallel.
+        compilerThreads = int(os.getenv("TP_COMPILER_THREADS") or 1)
+
+        self.llvm_compiler = llvm_compiler.Compiler(
+            inlineThreshold=100,
+            tiered=tierUpAfterCalls > 0,
+            parallelism=compilerThreads
+        )
+
+        if pgoMode == "instrument":
+            self.llvm_compiler.instrumentForProfiling()
+            atexit.register(self.saveExecutionProfile)
+        elif pgoMode == "use":
+            self.llvm_compiler.useExecutionProfile(ExecutionProfile.load(self.executionProfilePath))
         self.converter = python_to_native_converter.PythonToNativeConverter(
             self.llvm_compiler,
             self.compilerCache
@@ -215,6 +334,34 @@ class Runtime:
         self.lock = runtimeLock
         self.timesCompiled = 0
 
+        # if TP_COMPILER_SPECIALIZATION_BUDGET is set, a function that already has that
+        # many specializations gets a generic one instead of another. See
+        # specialization_budget.py.
+        budget = os.getenv("TP_COMPILER_SPECIALIZATION_BUDGET")
+        self.specializationBudget = SpecializationBudget(int(budget) if budget else None)
+
+        if tierUpAfterCalls > 0:
+            self.tierUpCompiler = TierUpCompiler(self.lock, self.llvm_compiler, tierUpAfterCalls)
+        else:
+            self.tierUpCompiler = None
+
+        # if TP_COMPILER_ASYNC is set, calls that need a new specialization run in the
+        # interpreter while we compile it on a background thread, rather than waiting.
+        if os.getenv("TP_COMPILER_ASYNC"):
+            self.backgroundCompiler = BackgroundCompiler(self)
+        else:
+            self.backgroundCompiler = None
+
+        # if TP_COMPILER_TRACE is set, we time every phase of compilation and write
+        # them out to that path as a Chrome trace (see chrome://tracing) at exit.
+        self.compilationTracePath = os.getenv("TP_COMPILER_TRACE")
+
+        if self.compilationTracePath:
+            compilationProfiler.start()
+            atexit.register(self.saveCompilationTrace)
+
+        os.register_at_fork(after_in_child=self._resetAfterFork)
+
         if os.getenv("TP_COMPILER_VERBOSE"):
             self.verbosityLevel = int(os.getenv("TP_COMPILER_VERBOSE"))
             if self.verbosityLevel >= 2:
@@ -232,9 +379,15 @@ class Runtime:
     def addEventVisitor(self, visitor: RuntimeEventVisitor):
         self.converter.addVisitor(visitor)
 
+        if type(visitor).onCompilationPhase is not RuntimeEventVisitor.onCompilationPhase:
+            compilationProfiler.addListener(visitor.onCompilationPhase)
+
     def removeEventVisitor(self, visitor: RuntimeEventVisitor):
         self.converter.removeVisitor(visitor)
 
+        if type(visitor).onCompilationPhase is not RuntimeEventVisitor.onCompilationPhase:
+            compilationProfiler.removeListener(visitor.onCompilationPhase)
+
     @staticmethod
     def passingTypeForValue(arg):
         if isinstance(arg, types.FunctionType):
@@ -249,7 +402,7 @@ class Runtime:
         return type(arg)
 
     @staticmethod
-    def pickSpecializationTypeFor(overloadArg, argValue, argumentsAreTypes=False):
+    def pickSpecializationTypeFor(overloadArg, argValue, argumentsAreTypes=False, specializeOnValue=False):
         """Compute the typeWrapper we'll use for this particular argument based on 'argValue'.
 
         Args:
@@ -259,6 +412,8 @@ class Runtime:
                 not the tuple itself.
             argValue - the value being passed for this argument. If 'argumentsAreTypes' is true,
                 then this is the actual type, not the value.
+            specializeOnValue - if True, and 'argValue' is a value we can specialize on (see
+                value_specialization.py), pass it as Value(argValue).
 
         Returns:
             the Wrapper or type instance to use for this argument.
@@ -287,6 +442,15 @@ class Runtime:
         if (overloadArg.isStarArg or overloadArg.isKwarg) and resType != argType:
             return None
 
+        if (
+            specializeOnValue
+            and not argumentsAreTypes
+            and not (overloadArg.isStarArg or overloadArg.isKwarg)
+            and canSpecializeOn(argValue)
+            and resType == typeWrapper(type(argValue))
+        ):
+            return typeWrapper(Value(argValue))
+
         return resType
 
     def compileFunctionOverload(self, functionType, overloadIx, arguments, argumentsAreTypes=False):
@@ -302,8 +466,13 @@ class Runtime:
 
         Returns:
             None if it is not possible to match this overload with these arguments or
-            a TypedCallTarget.
+            a TypedCallTarget. If we have a BackgroundCompiler and it took the request,
+            False, meaning the caller should run the function in the interpreter.
         """
+        if self.backgroundCompiler is not None and not argumentsAreTypes:
+            if self.backgroundCompiler.defer(functionType, overloadIx, arguments):
+                return False
+
         overload = functionType.overloads[overloadIx]
 
         assert len(arguments) == len(overload.args)
@@ -316,16 +485,37 @@ class Runtime:
 
             with self.lock:
                 inputWrappers = []
+                specialized = specializedArguments(overload.functionCode)
 
                 for i in range(len(arguments)):
                     inputWrappers.append(
-                        self.pickSpecializationTypeFor(overload.args[i], arguments[i], argumentsAreTypes)
+                        self.pickSpecializationTypeFor(
+                            overload.args[i], arguments[i], argumentsAreTypes, overload.args[i].name in specialized
+                        )
                     )
 
                 if any(x is None for x in inputWrappers):
                     # this signature is unmatchable with these arguments.
                     return None
 
+                isGeneric = self.specializationBudget.isExhausted(overload.functionCode)
+
+                if isGeneric:
+                    inputWrappers = [
+                        typeWrapper(genericSpecializationTypeFor(overload.args[i], inputWrappers[i]))
+                        for i in range(len(arguments))
+                    ]
+
+                    if self.verbosityLevel > 0:
+                        print(
+                            f"typed_python runtime: {functionType.__qualname__} is out of specializations, "
+                            "so we're compiling a generic one"
+                        )
+
+                self.specializationBudget.recordSpecialization(
+                    overload.functionCode, functionType.__qualname__, isGeneric
+                )
+
                 self.timesCompiled += 1
 
                 callTarget = self.converter.convertTypedFunctionCall(
@@ -347,11 +537,23 @@ class Runtime:
 
                 fp = self.converter.functionPointerByName(wrappingCallTargetName)
 
-                overload._installNativePointer(
-                    fp.fp,
-                    callTarget.output_type.typeRepresentation if callTarget.output_type is not None else type(None),
-                    [i.typeRepresentation for i in callTarget.input_types]
+                returnType = (
+                    callTarget.output_type.typeRepresentation if callTarget.output_type is not None else type(None)
                 )
+                argumentTypes = [i.typeRepresentation for i in callTarget.input_types]
+
+                if self.tierUpCompiler is not None and self.tierUpCompiler.canTierUp(wrappingCallTargetName):
+                    overload._installNativePointer(
+                        fp.fp,
+                        returnType,
+                        argumentTypes,
+                        self.tierUpCompiler.hotAfterCalls,
+                        self.tierUpCompiler.onHotCallback(
+                            overload, wrappingCallTargetName, returnType, argumentTypes
+                        )
+                    )
+                else:
+                    overload._installNativePointer(fp.fp, returnType, argumentTypes)
 
                 self.converter.flushDelayedVMIs()
 
@@ -365,12 +567,63 @@ class Runtime:
                     f"{self.converter.getDefinitionCount() - defCount} functions."
                 )
 
+    def saveExecutionProfile(self):
+        """Add the counts our instrumented code has recorded since the last save to the profile on disk."""
+        profile = ExecutionProfile.load(self.executionProfilePath)
+        profile.merge(liveCounters.snapshot(reset=True))
+        profile.save(self.executionProfilePath)
+
+    def getProfile(self, reset=False):
+        """Return the counters kept by instrumented compiled code.
+
+        Returns:
+            a dict from link name to dict(calls=, cycles=, pythonObjectCalls=) for
+            every instrumented function we've loaded. See instrumentation.py. If
+            'reset', zero the counters afterwards.
+        """
+        return liveInstrumentation.snapshot(reset=reset)
+
+    def specializationBudgetReport(self):
+        """Return a list of dicts describing the functions that used up their specialization budget.
+
+        Each has the function's 'name', 'filename' and 'line', its 'budget', and how many
+        'specializations' and 'genericSpecializations' we compiled for it.
+        """
+        return self.specializationBudget.report()
+
+    def compilerMemoryStats(self):
+        """Return a dict describing the state the compiler holds on to between compilations.
+
+        'converter' has the counts from 'PythonToNativeConverter.memoryStats', and 'llvm'
+        the ones from 'llvm_compiler.Compiler.memoryStats'. In a long-running process
+        that compiles on demand, the 'functions' and 'modules' counts grow with the
+        code we've compiled, but the pending and inflight counts should be zero between
+        compilations, and 'inlinableDefinitions' only counts small functions.
+        """
+        with self.lock:
+            return dict(
+                converter=self.converter.memoryStats(),
+                llvm=self.llvm_compiler.memoryStats()
+            )
+
+    def saveCompilationTrace(self, path=None):
+        """Write the compilation phases we've recorded so far to 'path' as a Chrome trace.
+
+        By default, we write to TP_COMPILER_TRACE. Phases are only recorded once someone
+        has called 'compilationProfiler.start()', which TP_COMPILER_TRACE does for us.
+        """
+        compilationProfiler.saveChromeTrace(path or self.compilationTracePath)
+
     def compileClassDispatch(self, interfaceClass, implementingClass, slotIndex):
         t0 = time.time()
 
         with self.lock:
-            self.converter.compileSingleClassDispatch(
-                interfaceClass, implementingClass, slotIndex
+            # whatever earlier processes needed for this class, we'll probably need
+            # too, so we build it all now rather than stalling for each one.
+            dispatches, destructors = self.converter.recordedClassDispatches(implementingClass)
+
+            self.converter.compileClassDispatches(
+                [(interfaceClass, implementingClass, slotIndex)] + dispatches, destructors
             )
 
         if self.verbosityLevel > 0:
@@ -391,7 +644,9 @@ class Runtime:
         t0 = time.time()
 
         with self.lock:
-            self.converter.compileClassDestructor(cls)
+            dispatches, destructors = self.converter.recordedClassDispatches(cls)
+
+            self.converter.compileClassDispatches(dispatches, [cls] + destructors)
 
         if self.verbosityLevel > 0:
             print(
@@ -401,6 +656,102 @@ class Runtime:
 
         return True
 
+    def prefillClassDispatches(self, background=False):
+        """Install the class dispatches and destructors that earlier processes needed.
+
+        Compiled code calling a method of a Class it only knows as a base class
+        compiles the dispatch the first time it happens, which can be a long stall
+        in the middle of a loop. The compiler cache remembers every dispatch and
+        destructor we've compiled (see class_dispatch_cache.py), so a process that
+        calls this once its modules are imported builds them all up front, in a
+        single module. Records for classes in modules that aren't imported yet are
+        left for later.
+
+        Args:
+            background - if True, do the work on a daemon thread and return it.
+        """
+        if background:
+            thread = threading.Thread(target=self.prefillClassDispatches, daemon=True)
+            thread.start()
+            return thread
+
+        t0 = time.time()
+
+        with self.lock:
+            dispatches, destructors = self.converter.recordedClassDispatches()
+
+            self.converter.compileClassDispatches(dispatches, destructors)
+
+        if self.verbosityLevel > 0:
+            print(
+                f"typed_python runtime spent {time.time()-t0:.3f} seconds installing "
+                f"{len(dispatches)} class dispatches and {len(destructors)} destructors"
+            )
+
+    def prepareForFork(self, freeze=True):
+        """Do the work forked workers would each repeat, so they share the parent's copy.
+
+        Call this in a server's parent process once it's warmed up, just before it
+        forks its workers. We
+
+            * wait for the background and tier-up compilers to finish what they've
+              been given,
+            * compile every class dispatch slot that's been allocated but not filled,
+              along with the dispatches and destructors the compiler cache recorded
+              (see 'prefillClassDispatches'),
+            * load and link every compiler cache module the code we've converted
+              refers to, rather than leaving it to the first call, and
+            * if 'freeze', collect garbage and then move everything that's left into
+              the permanent generation with gc.freeze(), so that collections in the
+              children don't write to (and so copy) the pages it lives on.
+
+        Forking is safe without this, just slower for the children: os.fork waits
+        for whoever is compiling to finish (see runtime_lock.py), a child starts its
+        own GIL release thread (see typed_python/__init__.py) and compression threads
+        as it needs them, and the background compilers start over in the child with
+        nothing queued. The child shares the parent's llvm engine, which is fine
+        since it can't have been in use when we forked.
+
+        Returns:
+            a dict with the number of class 'dispatches' and 'destructors' we made sure were installed, and
+            the number of compiler cache 'modules' we loaded.
+        """
+        if self.backgroundCompiler is not None:
+            self.backgroundCompiler.waitUntilIdle()
+
+        if self.tierUpCompiler is not None:
+            self.tierUpCompiler.waitUntilIdle()
+
+        with self.lock:
+            dispatches, destructors = self.converter.recordedClassDispatches()
+
+            while True:
+                unlinked = _types.getNextUnlinkedClassMethodDispatch()
+
+                if unlinked is None:
+                    break
+
+                dispatches.append(unlinked)
+
+            self.converter.compileClassDispatches(dispatches, destructors)
+
+            modulesLoaded = (
+                self.compilerCache.ensureKnownModulesLoaded() if self.compilerCache is not None else 0
+            )
+
+        if freeze:
+            gc.collect()
+            gc.freeze()
+
+        return dict(dispatches=len(dispatches), destructors=len(destructors), modules=modulesLoaded)
+
+    def _resetAfterFork(self):
+        if self.backgroundCompiler is not None:
+            self.backgroundCompiler.resetAfterFork()
+
+        if self.tierUpCompiler is not None:
+            self.tierUpCompiler.resetAfterFork()
+
     def resultTypeForCall(self, funcObj, argTypes, kwargTypes):
         """Determine the result of calling funcObj with things of type 'argTypes' and 'kwargTypes'
 
@@ -461,6 +812,49 @@ class Runtime:
         _resultTypeCache[key] = mergeTypeWrappers(possibleTypes)
         return _resultTypeCache[key]
 
+    def compiledEntrypointAddress(self, funcObj, argTypes):
+        """Compile 'funcObj' for arguments of exactly 'argTypes', and return the address of its entrypoint.
+
+        That's a native function 'void f(void* returnSlot, void** args)' taking a pointer to
+        each argument, which C code can call directly, like the ones we install in Function
+        overloads. Compiled code that raises unwinds out of it with the exception set in
+        the interpreter.
+
+        Args:
+            funcObj - a typed_python.Function object with no closure variables.
+            argTypes - a list of Type objects.
+
+        Returns:
+            the address, as an int.
+        """
+        assert isinstance(funcObj, typed_python._types.Function)
+
+        funcObj = _types.prepareArgumentToBePassedToCompiler(funcObj)
+
+        argTypes = [typeWrapper(a) for a in argTypes]
+
+        ExpressionConversionContext = typed_python.compiler.expression_conversion_context.ExpressionConversionContext
+
+        for overloadIx in range(len(funcObj.overloads)):
+            overload = funcObj.overloads[overloadIx]
+
+            if overload.closureVarLookups:
+                # the entrypoint would expect the closure's cells as arguments too
+                raise TypeError(f"Can't take the entrypoint of {funcObj}, since it has a closure.")
+
+            argumentSignature = ExpressionConversionContext.computeFunctionArgumentTypeSignature(overload, argTypes, {})
+
+            if argumentSignature is None:
+                continue
+
+            callTarget = self.compileFunctionOverload(funcObj, overloadIx, argumentSignature, argumentsAreTypes=True)
+
+            if callTarget is not None:
+                with self.lock:
+                    return self.converter.functionPointerByName(self.converter.generateCallConverter(callTarget)).fp
+
+        raise TypeError(f"{funcObj} can't be called with arguments of type {argTypes}")
+
 
 def NotCompiled(pyFunc, returnTypeOverride=None):
     """Decorate 'pyFunc' to prevent it from being compiled.
@@ -481,14 +875,46 @@ def NotCompiled(pyFunc, returnTypeOverride=None):
     return pyFunc
 
 
-def Entrypoint(pyFunc):
+def Entrypoint(
+    pyFunc=None, *, fastMath=False, assumeNoIntOverflow=False, nogil=False, instrument=False, specializeOn=None,
+    specializationBudget=None
+):
     """Decorate 'pyFunc' to JIT-compile it based on the signature of the arguments.
 
     Each time you call 'pyFunc', we look at the argument signature and see whether
     we have already compiled a form of that function. If so, we dispatch to that.
     Otherwise, we compile a new form (which blocks) and then use that when
     compilation has completed.
+
+    Called with only keyword arguments, as in '@Entrypoint(fastMath=True)', this
+    returns a decorator.
+
+    Args:
+        pyFunc - the function to compile
+        fastMath - if True, let llvm reassociate float arithmetic in 'pyFunc' and
+            assume it never sees NaNs or infinities.
+        assumeNoIntOverflow - if True, let llvm assume signed int arithmetic in
+            'pyFunc' never overflows.
+        nogil - if True, release the GIL as soon as a call from the interpreter
+            starts, and refuse to compile 'pyFunc' if it, or anything it calls,
+            would need python objects. See typed_python/compiler/nogil.py.
+        instrument - if True, make 'pyFunc' and the functions it calls count their
+            calls, cycles, and calls into the interpreter, which you can read with
+            'Runtime.singleton().getProfile()'. See typed_python/compiler/instrumentation.py.
+        specializeOn - None, or a list of argument names. Each value of those arguments
+            gets its own compiled form of 'pyFunc' in which it's a constant. See
+            typed_python/compiler/value_specialization.py.
+        specializationBudget - None, or the most specializations to compile of 'pyFunc'
+            before it gets a generic one. See typed_python/compiler/specialization_budget.py.
+
+        See typed_python/compiler/arithmetic_options.py for exactly what the first two allow.
     """
+    if pyFunc is None:
+        return lambda pyFunc: Entrypoint(
+            pyFunc, fastMath=fastMath, assumeNoIntOverflow=assumeNoIntOverflow, nogil=nogil, instrument=instrument,
+            specializeOn=specializeOn, specializationBudget=specializationBudget
+        )
+
     Runtime.singleton()
 
     wrapInStatic = False
@@ -506,6 +932,34 @@ def Entrypoint(pyFunc):
 
     typedFunc = typedFunc.withEntrypoint(True)
 
+    if fastMath or assumeNoIntOverflow:
+        options = ArithmeticOptions(fastMath=fastMath, assumeNoIntOverflow=assumeNoIntOverflow)
+
+        for overload in typedFunc.overloads:
+            setArithmeticOptions(overload.functionCode, options)
+
+    if nogil:
+        for overload in typedFunc.overloads:
+            setNogil(overload.functionCode)
+
+    if instrument:
+        for overload in typedFunc.overloads:
+            setInstrumented(overload.functionCode)
+
+    if specializeOn:
+        for overload in typedFunc.overloads:
+            argNames = [a.name for a in overload.args]
+
+            for name in specializeOn:
+                if name not in argNames:
+                    raise Exception(f"Can't specialize {typedFunc.__name__} on '{name}': it has no such argument")
+
+            setSpecializedArguments(overload.functionCode, specializeOn)
+
+    if specializationBudget is not None:
+        for overload in typedFunc.overloads:
+            setSpecializationBudget(overload.functionCode, specializationBudget)
+
     if wrapInStatic:
         return staticmethod(typedFunc)
 
@@ -12,6 +12,15 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import os
 import threading
 
 runtimeLock = threading.RLock()
+
+# fork while nobody else is compiling, so that a child never inherits the lock
+# held by a thread it doesn't have. The forking thread owns it in the child too.
+os.register_at_fork(
+    before=runtimeLock.acquire,
+    after_in_parent=runtimeLock.release,
+    after_in_child=runtimeLock.release
+)
@@ -0,0 +1,98 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""A limit on how many specializations we compile of each function.
+
+An Entrypoint gets a new compiled specialization for each combination of
+argument types it's called with. Polymorphic code can end up with hundreds
+of nearly identical ones, each of which costs a compile stall, space in the
+compiler cache, and instruction cache. A function can be given a budget,
+
+    @Entrypoint(specializationBudget=8)
+    def f(x, y):
+        ...
+
+and TP_COMPILER_SPECIALIZATION_BUDGET sets one for every function that
+doesn't have its own. Once a function has used its budget, the next call
+that needs a new specialization gets a generic one instead: each argument
+is passed as its annotation, or as 'object' if it has none. Since that
+accepts whatever the function does, it's the last specialization we compile.
+The ones we already compiled still get used for the calls they match.
+
+'report' lists the functions that ran out, which is the place to look for
+code that would be better off with annotations.
+"""
+
+# code object -> the most specializations to compile for it
+_budgets = {}
+
+
+def setSpecializationBudget(code, budget):
+    _budgets[code] = budget
+
+
+class SpecializationBudget:
+    def __init__(self, defaultBudget=None):
+        # None means no limit
+        self.defaultBudget = defaultBudget
+
+        # code object -> how many non-generic specializations we've compiled
+        self._counts = {}
+
+        # code object -> (function name, number of generic specializations)
+        self._exhausted = {}
+
+    def budgetFor(self, code):
+        return _budgets.get(code, self.defaultBudget)
+
+    def isExhausted(self, code):
+        budget = self.budgetFor(code)
+
+        return budget is not None and self._counts.get(code, 0) >= budget
+
+    def recordSpecialization(self, code, funcName, isGeneric):
+        if isGeneric:
+            name, count = self._exhausted.get(code, (funcName, 0))
+            self._exhausted[code] = (name, count + 1)
+        else:
+            self._counts[code] = self._counts.get(code, 0) + 1
+
+    def report(self):
+        """Return a list of dicts describing each function that used up its budget."""
+        return [
+            dict(
+                name=name,
+                filename=code.co_filename,
+                line=code.co_firstlineno,
+                budget=self.budgetFor(code),
+                specializations=self._counts.get(code, 0),
+                genericSpecializations=genericCount
+            )
+            for code, (name, genericCount) in self._exhausted.items()
+        ]
+
+
+def genericSpecializationTypeFor(overloadArg, picked):
+    """The type to pass an argument as once its function is out of budget.
+
+    'picked' is the type we'd have used otherwise. *args and **kwargs keep it,
+    since they have to be passed as the exact tuple they are.
+    """
+    if overloadArg.isStarArg or overloadArg.isKwarg:
+        return picked
+
+    if overloadArg.typeFilter is not None:
+        return overloadArg.typeFilter
+
+    return object
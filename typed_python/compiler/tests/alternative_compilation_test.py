@@ -1785,3 +1785,57 @@ class TestAlternativeCompilation(unittest.TestCase):
             assert getx(a) == Entrypoint(getx)(a)
             assert gety(a) == Entrypoint(gety)(a)
             assert getz(a) == Entrypoint(getz)(a)
+
+    def test_inline_alternatives(self):
+        Result = Alternative("Result", Ok=dict(value=int), Err=dict(code=Int16))
+
+        assert _types.alternative_is_inline(Result)
+
+        @Entrypoint
+        def makeResults(count: int):
+            res = ListOf(Result)()
+
+            for i in range(count):
+                if i % 3:
+                    res.append(Result.Ok(value=i))
+                else:
+                    res.append(Result.Err(code=i))
+
+            return res
+
+        @Entrypoint
+        def total(results: ListOf(Result)):
+            res = 0
+
+            for r in results:
+                if r.matches.Ok:
+                    res += r.value
+                else:
+                    res -= r.code
+
+            return res
+
+        @Entrypoint
+        def value(r: Result):
+            return r.value
+
+        @Entrypoint
+        def okValue(r: Result.Ok):
+            return r.value
+
+        @Entrypoint
+        def downcast(r: Result):
+            return okValue(r)
+
+        results = makeResults(9)
+
+        assert results[1] == Result.Ok(value=1)
+        assert results[3] == Result.Err(code=3)
+        assert total(results) == sum(i if i % 3 else -i for i in range(9))
+        assert value(Result.Ok(value=5)) == 5
+
+        with self.assertRaises(AttributeError):
+            value(Result.Err(code=5))
+
+        assert downcast(Result.Ok(value=7)) == 7
+
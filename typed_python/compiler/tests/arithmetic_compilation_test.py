@@ -724,3 +724,33 @@ class TestArithmeticCompilation(unittest.TestCase):
             return x[int(not False)]
 
         self.assertIs(sliceAtNotZeroFloat.resultTypeFor(Tuple(int, float)).interpreterTypeRepresentation, float)
+
+    def test_arithmetic_options(self):
+        @Entrypoint(fastMath=True, assumeNoIntOverflow=True)
+        def dot(x: ListOf(float), y: ListOf(float)):
+            res = 0.0
+            for i in range(len(x)):
+                res += x[i] * y[i]
+            return res
+
+        @Entrypoint(assumeNoIntOverflow=True)
+        def sumOfSquares(n: int):
+            squares = [i * i for i in range(n)]
+            res = 0
+            for s in squares:
+                res += s
+            return res
+
+        @Entrypoint(fastMath=True)
+        def divide(x: float, y: float):
+            return x / y
+
+        # every partial sum is exactly representable, so reassociating can't change the result
+        x = ListOf(float)([i * 0.5 for i in range(1000)])
+
+        self.assertEqual(dot(x, x), sum(v * v for v in x))
+        self.assertEqual(sumOfSquares(1000), sum(i * i for i in range(1000)))
+
+        # python-level errors are still raised
+        with self.assertRaises(ZeroDivisionError):
+            divide(1.0, 0.0)
@@ -36,10 +36,10 @@ class TestBuiltinCompilation(unittest.TestCase):
         NT2 = NamedTuple(s=str, t=TupleOf(int))
         Alt1 = Alternative("Alt1", X={'a': int}, Y={'b': str})
         cases = [
-            # (float, 1.23456789), # fails with compiled str=1.2345678899999999
-            # (float, 12.3456789), # fails with compiled str=12.345678899999999
-            # (float, -1.23456789), # fails with compiled str=-1.2345678899999999
-            # (float, -12.3456789), # fails with compiled str=-12.345678899999999
+            (float, 1.23456789),
+            (float, 12.3456789),
+            (float, -1.23456789),
+            (float, -12.3456789),
             (bool, True),
             (float, 1.0/7.0),  # verify number of digits after decimal in string representation
             (float, 8.0/7.0),  # verify number of digits after decimal in string representation
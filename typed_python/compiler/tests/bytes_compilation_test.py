@@ -12,6 +12,7 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import struct
 import time
 import unittest
 
@@ -19,7 +20,7 @@ from flaky import flaky
 from typed_python import Compiled, Entrypoint, ListOf, TupleOf, Dict, ConstDict
 from typed_python.compiler.type_wrappers.bytes_wrapper import bytesJoinIterable, \
     bytes_isalnum, bytes_isalpha, \
-    bytes_isdigit, bytes_islower, bytes_isspace, bytes_istitle, bytes_isupper, bytes_replace, \
+    bytes_isdigit, bytes_islower, bytes_isspace, bytes_istitle, bytes_isupper, \
     bytes_startswith, bytes_startswith_range, bytes_endswith, bytes_endswith_range, \
     bytes_count, bytes_count_single, bytes_find, bytes_find_single, \
     bytes_rfind, bytes_rfind_single, bytes_index, bytes_index_single, bytes_rindex, bytes_rindex_single, \
@@ -267,7 +268,12 @@ class TestBytesCompilation(unittest.TestCase):
             (b'A\x00B\x00C\x00DEF\x00G\x00', b'\x00'),
             (b'A\x00BA\x00C', b'A\x00B'),
             (b'A\x00b\x00C\x00DEF\x00G\x00', b'\x00b'),
-            (b'Ax\x00yBx\x00Cx\x00yDEFx\x00yGx\x00y', b'x\x00y')
+            (b'Ax\x00yBx\x00Cx\x00yDEFx\x00yGx\x00y', b'x\x00y'),
+            (b'a\x1cb\x1fc \x85d\xa0e',),
+            (b' \t ', None, 1),
+            (b'  field one\tfield\ttwo   three ' * 10, None, 7),
+            (b'x' * 40 + b' ' * 20 + b'y' * 40, None, 1),
+            (b'AxyBxy' * 20, b'xy', 11),
         ]:
             self.assertEqual(split(*args), compiledSplit(*args), args)
             self.assertEqual(rsplit(*args), compiledRsplit(*args), args)
@@ -580,6 +586,21 @@ class TestBytesCompilation(unittest.TestCase):
                                 with self.assertRaises(ValueError):
                                     Entrypoint(g)(v, sub, start, end)
 
+    def test_bytes_search_long_needles(self):
+        @Entrypoint
+        def c_search(s: bytes, sub: bytes):
+            return (s.find(sub), s.rfind(sub), s.count(sub), s.find(sub, 7, -3), s.rfind(sub, 7, -3))
+
+        def py_search(s, sub):
+            return (s.find(sub), s.rfind(sub), s.count(sub), s.find(sub, 7, -3), s.rfind(sub, 7, -3))
+
+        haystacks = [b"a" * 1000, (b"a" * 40 + b"b") * 30, b"a" * 500 + b"b" + b"a" * 500, b"ab" * 300, b""]
+        needles = [b"b", b"aaab", b"a" * 40 + b"b", b"b" + b"a" * 40, b"a" * 33, b"ab" * 20 + b"a", b"x"]
+
+        for hay in haystacks:
+            for needle in needles:
+                self.assertEqual(c_search(hay, needle), py_search(hay, needle), (hay, needle))
+
     def test_bytes_mult(self):
         def f_mult(x, n):
             return x * n
@@ -737,6 +758,37 @@ class TestBytesCompilation(unittest.TestCase):
                         r2 = result_or_exception(Entrypoint(f), v, enc, err)
                         self.assertEqual(r1, r2)
 
+    def test_bytes_decode_utf8_widths_and_invalid_data(self):
+        @Entrypoint
+        def decode(x: bytes, err: str) -> str:
+            return x.decode('utf-8', err)
+
+        values = [
+            b'x' * 40,
+            b'x' * 37 + 'caf\u00e9'.encode() + b'y' * 20,
+            ('\u20ac' * 20 + 'abc' * 10).encode(),
+            ('a' * 17 + '\U0001F600' + 'b' * 33).encode(),
+            b'x' * 20 + b'\xff' + b'y' * 20,
+            b'x' * 20 + b'\xC3',
+            b'\xC0\x80',
+            b'\xED\xA0\x80',
+            b'\xF4\x90\x80\x80',
+        ]
+
+        for v in values:
+            for err in ["strict", "ignore", "replace"]:
+                r1 = result_or_exception(lambda: v.decode('utf-8', err))
+                r2 = result_or_exception(lambda: decode(v, err))
+                self.assertEqual(r1, r2, (v, err))
+
+        # a latin-1 string decodes to the same (narrowest) layout the interpreter
+        # would pick, so it hashes the same as the interpreter's copy
+        @Entrypoint
+        def decodedIsIn(x: bytes, d: Dict(str, int)) -> bool:
+            return x.decode('utf-8') in d
+
+        self.assertTrue(decodedIsIn('caf\u00e9'.encode(), Dict(str, int)({'caf\u00e9': 1})))
+
     def test_bytes_translate(self):
         def f_translate1(x, table):
             return x.translate(table)
@@ -925,9 +977,6 @@ class TestBytesCompilation(unittest.TestCase):
             self.assertEqual(bytes_isupper(v), v.isupper())
 
         v = b'a1A\ta1A\n1A'
-        self.assertEqual(bytes_replace(v, b'a', b'xyz', 1), v.replace(b'a', b'xyz', 1))
-        self.assertEqual(bytes_replace(v, b'a', b'xyz', 0), v.replace(b'a', b'xyz', 0))
-        self.assertEqual(bytes_replace(v, b'', b'xyz', 2), v.replace(b'', b'xyz', 2))
         self.assertEqual(bytes_startswith(v, b'a'), v.startswith(b'a'))
         self.assertEqual(bytes_startswith(v, b'A'), v.startswith(b'A'))
         self.assertEqual(bytes_startswith_range(v, b'a', -4, 2), v.startswith(b'a', -4, 2))
@@ -968,3 +1017,91 @@ class TestBytesCompilation(unittest.TestCase):
         self.assertEqual(bytes_expandtabs(v, 8), v.expandtabs(8))
         self.assertEqual(bytes_zfill(v, 20), v.zfill(20))
         self.assertEqual(bytes_zfill(b'+123', 20), b'+123'.zfill(20))
+
+    def test_struct_pack_and_unpack(self):
+        @Entrypoint
+        def pack(a: int, b: int, c: float, d: bool, e: bytes):
+            return (
+                struct.pack("<IhdQ?", a, b, c, a, d),
+                struct.pack(">IhdQ?", a, b, c, a, d),
+                struct.pack("@bI3sxc", 5, a, e, b"z"),
+                struct.pack("!f", c),
+            )
+
+        for args in [(1, -2, 0.5, True, b"ab"), (0xDEADBEEF, 32767, -1e300, False, b"abcdef")]:
+            a, b, c, d, e = args
+            self.assertEqual(
+                pack(*args),
+                (
+                    struct.pack("<IhdQ?", a, b, c, a, d),
+                    struct.pack(">IhdQ?", a, b, c, a, d),
+                    struct.pack("@bI3sxc", 5, a, e, b"z"),
+                    struct.pack("!f", c),
+                )
+            )
+
+        @Entrypoint
+        def unpackLittle(x: bytes):
+            return struct.unpack("<IhdQ?", x)
+
+        @Entrypoint
+        def unpackBig(x: bytes, offset: int):
+            return struct.unpack_from(">IhdQ?", x, offset)
+
+        @Entrypoint
+        def unpackStrings(x: bytes):
+            return struct.unpack("@bi3sxc", x)
+
+        little = struct.pack("<IhdQ?", 0xDEADBEEF, -2, 0.25, 2 ** 63 + 5, True)
+        big = b"xy" + struct.pack(">IhdQ?", 7, -300, -1.5, 12, False)
+
+        self.assertEqual(unpackLittle(little), struct.unpack("<IhdQ?", little))
+        self.assertEqual(unpackBig(big, 2), struct.unpack_from(">IhdQ?", big, 2))
+        self.assertEqual(unpackBig(big, -len(big) + 2), struct.unpack_from(">IhdQ?", big, 2))
+        self.assertEqual(
+            unpackStrings(struct.pack("@bi3sxc", 3, 4, b"abc", b"d")),
+            struct.unpack("@bi3sxc", struct.pack("@bi3sxc", 3, 4, b"abc", b"d"))
+        )
+
+        @Entrypoint
+        def calcsize():
+            return struct.calcsize("<IhdQ?")
+
+        self.assertEqual(calcsize(), struct.calcsize("<IhdQ?"))
+
+    def test_struct_errors_match_interpreter(self):
+        @Entrypoint
+        def packShort(x: int):
+            return struct.pack("<h", x)
+
+        @Entrypoint
+        def packChar(x: bytes):
+            return struct.pack("c", x)
+
+        @Entrypoint
+        def unpack(x: bytes):
+            return struct.unpack("<i", x)
+
+        @Entrypoint
+        def unpackFrom(x: bytes, offset: int):
+            return struct.unpack_from("<i", x, offset)
+
+        for f, args in [
+            (packShort, (32768,)),
+            (packShort, (-32769,)),
+            (packChar, (b"ab",)),
+            (unpack, (b"abc",)),
+            (unpack, (b"abcde",)),
+            (unpackFrom, (b"abcd", 1)),
+            (unpackFrom, (b"abcd", -5)),
+        ]:
+            with self.assertRaises(struct.error):
+                f(*args)
+
+    def test_struct_with_nonconstant_format_falls_back(self):
+        @Entrypoint
+        def pack(fmt: str, x: int):
+            return struct.pack(fmt, x)
+
+        self.assertEqual(pack("<i", 5), struct.pack("<i", 5))
+        self.assertEqual(pack(">e", 1), struct.pack(">e", 1))
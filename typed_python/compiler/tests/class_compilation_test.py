@@ -3030,3 +3030,87 @@ class TestClassCompilationCompilation(unittest.TestCase):
             return c.f(x)
 
         call(C(), N(x=10))
+
+    def test_devirtualized_calls_still_dispatch_to_new_subclasses(self):
+        class Shape(Class):
+            def area(self) -> float:
+                raise NotImplementedError()
+
+        class Square(Shape, Final):
+            side = Member(float)
+
+            def area(self) -> float:
+                return self.side * self.side
+
+        class Rect(Shape):
+            w = Member(float)
+            h = Member(float)
+
+            def area(self) -> float:
+                return self.w * self.h
+
+        @Entrypoint
+        def totalArea(shapes: ListOf(Shape)):
+            res = 0.0
+            for s in shapes:
+                res += s.area()
+            return res
+
+        assert totalArea([Square(side=2.0), Rect(w=2.0, h=3.0)]) == 10.0
+
+        # neither of these existed when we compiled 'totalArea', so they have
+        # to go through the vtable
+        class Circle(Shape):
+            r = Member(float)
+
+            def area(self) -> float:
+                return 3.0 * self.r * self.r
+
+        class BigRect(Rect):
+            def area(self) -> float:
+                return 2.0 * self.w * self.h
+
+        assert totalArea([Square(side=2.0), Circle(r=1.0), BigRect(w=1.0, h=1.0), Rect(w=1.0, h=1.0)]) == 10.0
+
+    def test_instances_that_dont_escape_are_replaced_by_their_members(self):
+        class Point(Class):
+            x = Member(float)
+            y = Member(float)
+            label = Member(str, "p")
+            count = Member(int)
+
+        @Entrypoint
+        def sumOfProducts(n: int):
+            res = 0.0
+            labels = ""
+            for i in range(n):
+                p = Point(x=i, y=i * 2)
+                p.x += 1
+                p.count += 1
+                if i == 0:
+                    p.label = "first"
+                labels += p.label
+                res += p.x * p.y + p.count
+            return (res, labels)
+
+        assert sumOfProducts(3) == ((1 * 0 + 1) + (2 * 2 + 1) + (3 * 4 + 1), "firstpp")
+
+        @Entrypoint
+        def pointThatEscapes(x: float):
+            p = Point(x=x, y=x)
+            p.y += 1
+            return p
+
+        p = pointThatEscapes(1.0)
+        assert (p.x, p.y, p.label, p.count) == (1.0, 2.0, "p", 0)
+
+        @Entrypoint
+        def readsPreviousIteration(n: int):
+            res = 0.0
+            for i in range(n):
+                if i > 0:
+                    res += p.x
+                p = Point(x=i, y=i)
+            return res
+
+        assert readsPreviousIteration(3) == 1.0
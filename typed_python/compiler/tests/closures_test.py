@@ -1119,3 +1119,55 @@ class TestCompilingClosures(unittest.TestCase):
             return callIt2(f, x)
 
         assert callIt(makeClosure(float, int), "1.2") == 11.2
+
+    def test_closures_of_unassigned_arguments_hold_them_by_value(self):
+        @Entrypoint
+        def makeAdder(k: int, scale: float):
+            return lambda x: (x + k) * scale
+
+        adder = makeAdder(3, 2.0)
+
+        assert adder.ClosureType == NamedTuple(k=int, scale=float)
+        assert adder(1) == 8.0
+
+        @Entrypoint
+        def applyAll(values: ListOf(int), k: int):
+            return ListOf(int)([v + k for v in values])
+
+        assert applyAll(ListOf(int)([1, 2, 3]), 10) == [11, 12, 13]
+
+    def test_by_value_closures_refcount_their_arguments(self):
+        @Entrypoint
+        def makeGetter(tup: TupleOf(int), name: str):
+            return lambda: (tup, name)
+
+        aTup = TupleOf(int)([1, 2, 3])
+
+        getter = makeGetter(aTup, "a name")
+
+        assert getter.ClosureType == NamedTuple(name=str, tup=TupleOf(int))
+        assert getter() == (aTup, "a name")
+        assert refcount(aTup) == 2
+
+        getter = None
+
+        assert refcount(aTup) == 1
+
+        @Entrypoint
+        def callInPlace(tup: TupleOf(int)):
+            return (lambda: len(tup))()
+
+        assert callInPlace(aTup) == 3
+        assert refcount(aTup) == 1
+
+    def test_closures_of_reassigned_arguments_share_them(self):
+        @Entrypoint
+        def makeCounter(k: int):
+            f = lambda: k
+            k = k + 1
+            return f
+
+        counter = makeCounter(1)
+
+        assert counter() == 2
+        assert issubclass(counter.ClosureType, Class)
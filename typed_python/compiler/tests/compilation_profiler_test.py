@@ -0,0 +1,111 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import json
+import os
+import tempfile
+
+from typed_python import Entrypoint, ListOf
+from typed_python.compiler.runtime import RuntimeEventVisitor
+from typed_python.compiler.compilation_profiler import (
+    CompilationProfiler, compilationProfiler, CONVERT, TYPE_INFERENCE, LLVM_IR, FINALIZE
+)
+from typed_python.test_util import evaluateExprInFreshProcess
+
+
+def test_profiler_only_records_while_started():
+    profiler = CompilationProfiler()
+
+    with profiler.phase("ignored", CONVERT):
+        pass
+
+    profiler.start()
+
+    with profiler.phase("outer", TYPE_INFERENCE):
+        with profiler.phase("inner", CONVERT, timesCalculated=2):
+            pass
+
+    phases = profiler.stop()
+
+    with profiler.phase("ignored", CONVERT):
+        pass
+
+    assert [p.name for p in phases] == ["inner", "outer"]
+    assert phases[0].duration <= phases[1].duration
+    assert set(profiler.totalsByCategory(phases)) == {CONVERT, TYPE_INFERENCE}
+
+    trace = profiler.toChromeTrace(phases)
+
+    assert [e["name"] for e in trace["traceEvents"]] == ["inner", "outer"]
+    assert trace["traceEvents"][0]["ph"] == "X"
+    assert trace["traceEvents"][0]["args"] == {"timesCalculated": "2"}
+
+
+def test_compilation_phases_are_recorded():
+    @Entrypoint
+    def sumList(x: ListOf(float)):
+        res = 0.0
+        for v in x:
+            res += v
+        return res
+
+    compilationProfiler.start()
+    try:
+        sumList(ListOf(float)([1.0, 2.0]))
+    finally:
+        phases = compilationProfiler.stop()
+
+    categories = set(p.category for p in phases)
+
+    for category in [CONVERT, TYPE_INFERENCE, LLVM_IR, FINALIZE]:
+        assert category in categories
+
+    assert any("sumList" in p.name for p in phases if p.category == CONVERT)
+
+
+def test_visitors_see_compilation_phases():
+    class Visitor(RuntimeEventVisitor):
+        def __init__(self):
+            self.phases = []
+
+        def onCompilationPhase(self, phase):
+            self.phases.append(phase)
+
+    @Entrypoint
+    def addOne(x: int):
+        return x + 1
+
+    with Visitor() as v:
+        addOne(1)
+
+    assert any(p.category == CONVERT for p in v.phases)
+
+    assert not compilationProfiler.active
+
+
+def test_compilation_trace_is_written_at_exit(monkeypatch):
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "trace.json")
+
+        monkeypatch.setenv("TP_COMPILER_TRACE", path)
+
+        assert evaluateExprInFreshProcess(
+            {'x.py': "@Entrypoint\ndef f(x):\n    return x + 1\n"},
+            'x.f(10)'
+        ) == 11
+
+        with open(path) as f:
+            trace = json.load(f)
+
+        assert CONVERT in set(e["cat"] for e in trace["traceEvents"])
@@ -14,8 +14,20 @@
 
 import tempfile
 import os
+import shutil
 import pytest
 from typed_python.test_util import evaluateExprInFreshProcess
+from typed_python.compiler.compiler_cache_index import CompilerCacheIndex, INDEX_FILE
+from typed_python.compiler.compiler_cache_gc import CompilerCacheCollector, LAST_USED_FILE
+from typed_python.compiler.native_ast_cache import NATIVE_AST_DIR
+from typed_python.SerializationContext import SerializationContext
+from typed_python import ListOf
+
+
+def cachedModules(compilerCacheDir):
+    """Return the module directories in the cache, ignoring its other bookkeeping."""
+    return [x for x in os.listdir(compilerCacheDir) if len(x) == 40]
+
 
 MAIN_MODULE = """
 @Entrypoint
@@ -28,26 +40,26 @@ def f(x):
 def test_compiler_cache_populates():
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10.5)', compilerCacheDir) == 11.5
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(11)', compilerCacheDir) == 12
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
 def test_compiler_cache_can_handle_conflicting_versions_of_the_same_code():
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE.replace('1', '2')}, 'x.f(10)', compilerCacheDir) == 12
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -68,13 +80,13 @@ def test_compiler_cache_can_detect_invalidation_through_modules():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION1, 'y.g(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         assert evaluateExprInFreshProcess(VERSION2, 'y.g(10)', compilerCacheDir) == 12
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         assert evaluateExprInFreshProcess(VERSION1, 'y.g(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -96,10 +108,10 @@ def test_compiler_cache_robust_to_irrelevant_module_changes():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION1, 'y.g(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         assert evaluateExprInFreshProcess(VERSION2, 'y.g(10)', compilerCacheDir) == 11
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -124,15 +136,15 @@ def test_compiler_cache_understands_type_changes():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION1, 'y.g(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # no recompilation necessary
         assert evaluateExprInFreshProcess(VERSION2, 'y.g(1)', compilerCacheDir) == 3
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # this forces a recompile
         assert evaluateExprInFreshProcess(VERSION3, 'y.g(1)', compilerCacheDir) == 2.5
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -178,11 +190,11 @@ def test_compiler_cache_understands_granular_module_accesses():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION1, 'y.g(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # no recompilation necessary
         assert evaluateExprInFreshProcess(VERSION2, 'y.g(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -205,15 +217,15 @@ def test_load_dependent_modules():
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         # add an item to the cache
         assert evaluateExprInFreshProcess(VERSION1, 'x.f(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # add a dependent function
         assert evaluateExprInFreshProcess(VERSION2, 'x.g(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         # we should be able to load correctly
         assert evaluateExprInFreshProcess(VERSION2, 'x.g(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -241,19 +253,19 @@ def test_reference_existing_function_twice():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION1, 'x.f(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # add some content and nothing recompiles
         assert evaluateExprInFreshProcess(VERSION2, 'x.f(1)', compilerCacheDir) == 2
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # recompiles with 'g1' and 'g2' referencing 'f'
         assert evaluateExprInFreshProcess(VERSION2, 'x.g(1)', compilerCacheDir) == 4
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         # can load it
         assert evaluateExprInFreshProcess(VERSION2, 'x.g(1)', compilerCacheDir) == 4
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -275,11 +287,11 @@ def test_compiler_cache_handles_class_destructors_correctly():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION, 'x.f(1)', compilerCacheDir) == 1
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         # we can reuse the class destructor from the first time around
         assert evaluateExprInFreshProcess(VERSION, 'x.g(1)', compilerCacheDir) == 1
-        assert len(os.listdir(compilerCacheDir)) == 3
+        assert len(cachedModules(compilerCacheDir)) == 3
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -301,11 +313,11 @@ def test_compiler_cache_handles_classes():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION, 'x.f(1)', compilerCacheDir) == 1
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         # we can reuse the class destructor from the first time around
         assert evaluateExprInFreshProcess(VERSION, 'x.g(1)', compilerCacheDir) == 1
-        assert len(os.listdir(compilerCacheDir)) == 3
+        assert len(cachedModules(compilerCacheDir)) == 3
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -322,11 +334,11 @@ def test_compiler_cache_handles_references_to_globals():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION, 'x.f(1)', compilerCacheDir) == [1]
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # we can reuse the class destructor from the first time around
         assert evaluateExprInFreshProcess(VERSION, '(x.f(1), x.aList)', compilerCacheDir) == ([1], [1])
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
 
 @pytest.mark.skipif('sys.platform=="darwin"')
@@ -355,12 +367,12 @@ def test_compiler_cache_handles_changed_types():
 
     with tempfile.TemporaryDirectory() as compilerCacheDir:
         assert evaluateExprInFreshProcess(VERSION1, 'x.g1(1)', compilerCacheDir) == 1
-        assert len(os.listdir(compilerCacheDir)) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
 
         # if we try to use 'f', it should work even though we no longer have
         # a defniition for 'g2'
         assert evaluateExprInFreshProcess(VERSION2, 'x.f(1)', compilerCacheDir) == 1
-        assert len(os.listdir(compilerCacheDir)) == 2
+        assert len(cachedModules(compilerCacheDir)) == 2
 
         badCt = 0
         for subdir in os.listdir(compilerCacheDir):
@@ -395,3 +407,317 @@ def test_ordering_is_stable_under_code_change():
         )
 
         assert names == names2
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_reuses_type_group_hashes():
+    xmodule = "\n".join([
+        "def f(x):",
+        "    return x + 1",
+    ])
+    ymodule = "\n".join([
+        "from x import f",
+        "@Entrypoint",
+        "def g(x):",
+        "    return f(x)",
+    ])
+
+    VERSION1 = {'x.py': xmodule, 'y.py': ymodule}
+    VERSION2 = {'x.py': xmodule.replace('1', '2'), 'y.py': ymodule}
+
+    cache = "typed_python.compiler.runtime.Runtime.singleton().compilerCache.typeGroupHashes"
+    hits = cache + ".hits"
+    misses = cache + ".misses"
+
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        assert evaluateExprInFreshProcess(VERSION1, f'(y.g(10), {misses} > 0)', compilerCacheDir) == (11, True)
+        assert evaluateExprInFreshProcess(VERSION1, f'(y.g(10), {hits} > 0)', compilerCacheDir) == (11, True)
+
+        # 'f' changed, so its old hash must not come out of the cache
+        assert evaluateExprInFreshProcess(VERSION2, 'y.g(10)', compilerCacheDir) == 12
+        assert len(cachedModules(compilerCacheDir)) == 2
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_reuses_native_ast_of_evicted_modules():
+    xmodule = "\n".join([
+        "def f(x):",
+        "    return x + 1",
+    ])
+    ymodule = "\n".join([
+        "from x import f",
+        "@Entrypoint",
+        "def g(x):",
+        "    return f(x) * 2",
+    ])
+
+    VERSION = {'x.py': xmodule, 'y.py': ymodule}
+
+    runtime = "typed_python.compiler.runtime.Runtime.singleton()"
+    hits = runtime + ".compilerCache.nativeAsts.hits"
+    conversions = "len(" + runtime + ".converter._times_calculated)"
+
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        assert evaluateExprInFreshProcess(VERSION, f'(y.g(10), {conversions} > 0)', compilerCacheDir) == (22, True)
+        assert os.listdir(os.path.join(compilerCacheDir, NATIVE_AST_DIR))
+
+        for moduleHash in cachedModules(compilerCacheDir):
+            shutil.rmtree(os.path.join(compilerCacheDir, moduleHash))
+
+        # the modules are gone, but we don't need to convert anything to rebuild them
+        assert evaluateExprInFreshProcess(
+            VERSION, f'(y.g(10), {hits} > 0, {conversions})', compilerCacheDir
+        ) == (22, True, 0)
+        assert len(cachedModules(compilerCacheDir)) == 1
+
+        # and the rebuilt module serves the next process
+        assert evaluateExprInFreshProcess(VERSION, f'(y.g(10), {hits})', compilerCacheDir) == (22, 0)
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_imports_small_cached_callees():
+    xmodule = "\n".join([
+        "@Entrypoint",
+        "def f(x):",
+        "    return x + 1",
+    ])
+    ymodule = "\n".join([
+        "from x import f",
+        "@Entrypoint",
+        "def g(n):",
+        "    res = 0",
+        "    for i in range(n):",
+        "        res += f(i)",
+        "    return res",
+    ])
+
+    VERSION = {'x.py': xmodule, 'y.py': ymodule}
+
+    runtime = "typed_python.compiler.runtime.Runtime.singleton()"
+    imported = f"[n for n, v in {runtime}.converter._importableCachedFunctions.items() if v is not None]"
+
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        assert evaluateExprInFreshProcess(VERSION, 'x.f(10)', compilerCacheDir) == 11
+
+        # 'f' comes out of the cache, but the module we build for 'g' gets its body
+        res, importedNames = evaluateExprInFreshProcess(VERSION, f'(y.g(10), {imported})', compilerCacheDir)
+
+        assert res == 55
+        assert importedNames
+
+        # and the module still calls the cached copy, so the next process can load it
+        assert evaluateExprInFreshProcess(VERSION, 'y.g(10)', compilerCacheDir) == 55
+        assert len(cachedModules(compilerCacheDir)) == 2
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_rebuilds_missing_index():
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
+        assert len(cachedModules(compilerCacheDir)) == 1
+        assert os.path.exists(os.path.join(compilerCacheDir, INDEX_FILE))
+
+        # a cache written before we had an index should still get used
+        os.remove(os.path.join(compilerCacheDir, INDEX_FILE))
+
+        assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
+        assert len(cachedModules(compilerCacheDir)) == 1
+        assert os.path.exists(os.path.join(compilerCacheDir, INDEX_FILE))
+
+
+def test_compiler_cache_index_skips_torn_records():
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        index = CompilerCacheIndex(compilerCacheDir)
+
+        index.build([("a" * 40, ["f", "g"])])
+
+        # simulate a writer that died halfway through its record
+        with open(index.indexPath, "ab") as f:
+            f.write(CompilerCacheIndex._encodeRecord("b" * 40, ["h"])[:-3])
+
+        index.append("c" * 40, ["k"])
+
+        reader = CompilerCacheIndex(compilerCacheDir)
+
+        assert reader.lookup("g") == "a" * 40
+        assert reader.lookup("h") is None
+        assert reader.lookup("k") == "c" * 40
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_keeps_cpu_specific_code_apart(monkeypatch):
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
+
+        monkeypatch.setenv("TP_COMPILER_TARGET_CPU", "host")
+
+        assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
+
+        targetDirs = [x for x in os.listdir(compilerCacheDir) if x.startswith("target_")]
+
+        assert len(targetDirs) == 1
+        assert len(cachedModules(compilerCacheDir)) == 1
+        assert len(cachedModules(os.path.join(compilerCacheDir, targetDirs[0]))) == 1
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_multiversioned_modules(monkeypatch):
+    # no cpu has this feature, so we'll always fall back to the next variant
+    monkeypatch.setenv("TP_COMPILER_MULTIVERSION", "+avx512f,+not-a-real-feature;+sse2")
+
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
+
+        moduleDir = os.path.join(compilerCacheDir, cachedModules(compilerCacheDir)[0])
+
+        assert os.path.exists(os.path.join(moduleDir, "variants.dat"))
+        assert os.path.exists(os.path.join(moduleDir, "variant_0.so"))
+        assert os.path.exists(os.path.join(moduleDir, "variant_1.so"))
+
+        assert evaluateExprInFreshProcess({'x.py': MAIN_MODULE}, 'x.f(10)', compilerCacheDir) == 11
+
+
+TWO_ENTRYPOINTS_MODULE = """
+from typed_python.compiler.runtime import Runtime
+
+@Entrypoint
+def f(x):
+    return x + 1
+
+@Entrypoint
+def g(x):
+    return x + 2
+
+def loadedModuleCount():
+    return len(Runtime.singleton().compilerCache.loadedModules)
+"""
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_loads_modules_lazily():
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        VERSION = {'x.py': TWO_ENTRYPOINTS_MODULE}
+
+        assert evaluateExprInFreshProcess(VERSION, 'x.f(10)', compilerCacheDir) == 11
+        assert evaluateExprInFreshProcess(VERSION, 'x.g(10)', compilerCacheDir) == 12
+        assert len(cachedModules(compilerCacheDir)) == 2
+
+        # calling 'f' shouldn't load the module holding 'g'
+        assert evaluateExprInFreshProcess(VERSION, '(x.f(10), x.loadedModuleCount())', compilerCacheDir) == (11, 1)
+
+
+def makeFakeModule(cacheDir, moduleHash, size, lastUsed, submodules=()):
+    moduleDir = os.path.join(cacheDir, moduleHash)
+    os.makedirs(moduleDir)
+
+    with open(os.path.join(moduleDir, "module.so"), "wb") as f:
+        f.write(b" " * size)
+
+    with open(os.path.join(moduleDir, "submodules.dat"), "wb") as f:
+        f.write(SerializationContext().serialize(ListOf(str)(submodules), ListOf(str)))
+
+    with open(os.path.join(moduleDir, LAST_USED_FILE), "w"):
+        pass
+
+    os.utime(os.path.join(moduleDir, LAST_USED_FILE), (lastUsed, lastUsed))
+
+
+def test_compiler_cache_collector_evicts_lru_modules_with_their_dependents():
+    A, B, C = "a" * 40, "b" * 40, "c" * 40
+
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        makeFakeModule(compilerCacheDir, A, 10000, 1000)
+        makeFakeModule(compilerCacheDir, B, 10000, 3000, [A])
+        makeFakeModule(compilerCacheDir, C, 10000, 2000)
+
+        # everything was used recently enough that we leave it alone
+        assert CompilerCacheCollector(compilerCacheDir, 15000, minIdleSeconds=10 ** 10).collect() == []
+
+        # 'A' is the oldest, and evicting it takes 'B' with it, even though
+        # 'B' was used more recently than 'C'
+        assert sorted(CompilerCacheCollector(compilerCacheDir, 15000, minIdleSeconds=0).collect()) == [A, B]
+
+        assert cachedModules(compilerCacheDir) == [C]
+
+
+DEPENDENT_ENTRYPOINTS_MODULE = """
+from typed_python.compiler.runtime import Runtime
+
+@Entrypoint
+def f(x):
+    return x + 1
+
+@Entrypoint
+def g(x):
+    return f(x) * 2
+
+def compactCache():
+    return len(Runtime.singleton().compilerCache.compact())
+
+def loadedModuleCount():
+    return len(Runtime.singleton().compilerCache.loadedModules)
+"""
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_compacts_dependent_modules():
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        VERSION = {'x.py': DEPENDENT_ENTRYPOINTS_MODULE}
+
+        assert evaluateExprInFreshProcess(VERSION, 'x.f(10)', compilerCacheDir) == 11
+        assert evaluateExprInFreshProcess(VERSION, 'x.g(10)', compilerCacheDir) == 22
+        assert evaluateExprInFreshProcess(VERSION, '(x.g(10), x.loadedModuleCount())', compilerCacheDir) == (22, 2)
+
+        assert evaluateExprInFreshProcess(VERSION, 'x.compactCache()', compilerCacheDir) == 1
+        assert len(cachedModules(compilerCacheDir)) == 3
+
+        # both functions now come from the merged module
+        assert evaluateExprInFreshProcess(VERSION, '(x.g(10), x.loadedModuleCount())', compilerCacheDir) == (22, 1)
+        assert evaluateExprInFreshProcess(VERSION, '(x.f(10), x.loadedModuleCount())', compilerCacheDir) == (11, 1)
+
+        # there's nothing left to merge
+        assert evaluateExprInFreshProcess(VERSION, 'x.compactCache()', compilerCacheDir) == 0
+
+
+CLASS_DISPATCH_MODULE = """
+from typed_python.compiler.runtime import Runtime
+
+class Base(Class):
+    def m(self, x: int) -> int:
+        return x
+
+class Child(Base):
+    def m(self, x: int) -> int:
+        return x * 10
+
+@Entrypoint
+def callM(b: Base, x: int):
+    return b.m(x)
+
+def installedDispatches():
+    return len(Runtime.singleton().converter._installedVMIs)
+
+def prefill():
+    Runtime.singleton().prefillClassDispatches()
+    return installedDispatches()
+"""
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_compiler_cache_prefills_recorded_class_dispatches():
+    with tempfile.TemporaryDirectory() as compilerCacheDir:
+        VERSION = {'x.py': CLASS_DISPATCH_MODULE}
+
+        assert evaluateExprInFreshProcess(VERSION, 'x.callM(x.Child(), 2)', compilerCacheDir) == 20
+
+        # a fresh process has compiled no dispatches until it asks for the recorded ones
+        assert evaluateExprInFreshProcess(VERSION, 'x.installedDispatches()', compilerCacheDir) == 0
+
+        # after which calls don't need any new ones
+        prefilled, result, installed = evaluateExprInFreshProcess(
+            VERSION, '(x.prefill(), x.callM(x.Child(), 3), x.installedDispatches())', compilerCacheDir
+        )
+
+        assert prefilled > 0
+        assert result == 30
+        assert installed == prefilled
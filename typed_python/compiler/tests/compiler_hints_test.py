@@ -0,0 +1,138 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import llvmlite.ir
+import pytest
+
+from typed_python import (
+    Class, Member, Entrypoint, ListOf, UndefinedBehaviorException,
+    likely, unlikely, assume, unreachable, prefetch
+)
+from typed_python.compiler.native_ast_to_llvm import expectedBranchWeights, EXPECTED_BRANCH_WEIGHT
+
+
+class Node(Class):
+    value = Member(int)
+
+
+def test_likely_and_unlikely_return_the_condition():
+    @Entrypoint
+    def countPositive(values: ListOf(int)):
+        res = 0
+        for v in values:
+            if likely(v > 0):
+                res += 1
+            if unlikely(v == 0):
+                res += 100
+        return res
+
+    assert countPositive(ListOf(int)([1, -2, 3, 0])) == 102
+
+    @Entrypoint
+    def asBool(x: int):
+        return likely(x), unlikely(x)
+
+    assert asBool(0) == (False, False)
+    assert asBool(5) == (True, True)
+
+    assert likely(5) is True
+    assert unlikely([]) is False
+
+
+def test_expect_becomes_branch_weights():
+    module = llvmlite.ir.Module()
+    i1 = llvmlite.ir.IntType(1)
+    expect = llvmlite.ir.Function(module, llvmlite.ir.FunctionType(i1, [i1, i1]), "llvm.expect.i1")
+    other = llvmlite.ir.Function(module, llvmlite.ir.FunctionType(i1, [i1, i1]), "other")
+    func = llvmlite.ir.Function(module, llvmlite.ir.FunctionType(i1, [i1]), "f")
+    builder = llvmlite.ir.IRBuilder(func.append_basic_block())
+
+    isTrue = builder.call(expect, [func.args[0], llvmlite.ir.Constant(i1, 1)])
+    isFalse = builder.call(expect, [func.args[0], llvmlite.ir.Constant(i1, 0)])
+
+    assert expectedBranchWeights(isTrue) == [EXPECTED_BRANCH_WEIGHT, 1]
+    assert expectedBranchWeights(isFalse) == [1, EXPECTED_BRANCH_WEIGHT]
+    assert expectedBranchWeights(builder.call(other, [func.args[0], llvmlite.ir.Constant(i1, 1)])) is None
+    assert expectedBranchWeights(func.args[0]) is None
+
+
+def test_assume_and_unreachable():
+    @Entrypoint
+    def divideBySmall(x: int, y: int):
+        assume(y > 0)
+        assume(y < 16)
+        return x // y
+
+    assert divideBySmall(100, 7) == 14
+
+    @Entrypoint
+    def sign(x: int) -> int:
+        if x > 0:
+            return 1
+        if x < 0:
+            return -1
+        if x == 0:
+            return 0
+        unreachable()
+
+    assert sign(10) == 1
+    assert sign(-3) == -1
+    assert sign(0) == 0
+
+    assume(True)
+
+    with pytest.raises(UndefinedBehaviorException):
+        assume(False)
+
+    with pytest.raises(UndefinedBehaviorException):
+        unreachable()
+
+
+def test_prefetch():
+    @Entrypoint
+    def sumList(values: ListOf(int)):
+        res = 0
+        for i in range(len(values)):
+            if i + 8 < len(values):
+                prefetch(values.pointerUnsafe(i + 8), 0)
+            res += values[i]
+        return res
+
+    assert sumList(ListOf(int)(range(100))) == sum(range(100))
+
+    @Entrypoint
+    def valueOf(node: Node):
+        prefetch(node, locality=3, forWriting=False)
+        return node.value
+
+    assert valueOf(Node(value=3)) == 3
+
+    @Entrypoint
+    def prefetchForWriting(values: ListOf(int)):
+        prefetch(values.pointerUnsafe(0), 1, True)
+        values[0] = 1
+
+    values = ListOf(int)([0])
+    prefetchForWriting(values)
+    assert values[0] == 1
+
+    @Entrypoint
+    def badLocality(values: ListOf(int), locality: int):
+        prefetch(values.pointerUnsafe(0), locality)
+
+    with pytest.raises(TypeError):
+        badLocality(values, 1)
+
+    # the interpreter ignores it
+    prefetch(values.pointerUnsafe(0))
@@ -540,6 +540,41 @@ class TestDictCompilation(unittest.TestCase):
         f(aDict, someStrings, 1000000)
         print(time.time() - t0, "to lookup 100mm strings")
 
+    def test_dict_compact_compiles(self):
+        @Entrypoint
+        def slide(d: Dict(int, int), count: int):
+            for i in range(count):
+                d[len(d) + i] = i
+                del d[i]
+
+        @Entrypoint
+        def compactIt(d: Dict(int, int)):
+            d.compact()
+
+        d = Dict(int, int)({i: i for i in range(10)})
+
+        slide(d, 1000)
+        compactIt(d)
+
+        assert len(d) == 10
+        assert all(d[k] == k - 10 for k in d)
+
+    def test_dict_from_columns_compiles(self):
+        @Entrypoint
+        def build(keys: ListOf(int), values: ListOf(str)):
+            return Dict(int, str).fromColumns(keys, values)
+
+        keys = ListOf(int)(range(10000))
+        values = ListOf(str)([str(k) for k in keys])
+
+        d = build(keys, values)
+
+        assert len(d) == len(keys)
+        assert all(d[k] == str(k) for k in keys)
+
+        with self.assertRaises(ValueError):
+            build(keys, values[:10])
+
     def test_dict_clear_compiles(self):
         T = Dict(str, str)
 
@@ -862,6 +897,79 @@ class TestDictCompilation(unittest.TestCase):
             if time.time() - t0 > 1e-5:
                 print(i, time.time() - t0)
 
+    def test_dict_probing_agrees_between_compiled_and_interpreted_code(self):
+        # keys that are multiples of 128 share a control-byte tag, so this
+        # exercises long probe sequences through full groups and tombstones.
+        @Entrypoint
+        def addCompiled(d: Dict(int, int), keys: ListOf(int)):
+            for k in keys:
+                d[k] = k
+
+        @Entrypoint
+        def removeCompiled(d: Dict(int, int), keys: ListOf(int)):
+            for k in keys:
+                del d[k]
+
+        @Entrypoint
+        def countCompiled(d: Dict(int, int), keys: ListOf(int)) -> int:
+            res = 0
+            for k in keys:
+                if k in d:
+                    res += 1
+            return res
+
+        keys = ListOf(int)([i * 128 for i in range(2000)])
+        evens = ListOf(int)(keys[::2])
+        odds = ListOf(int)(keys[1::2])
+
+        d = Dict(int, int)()
+
+        addCompiled(d, evens)
+        for k in odds:
+            d[k] = k
+
+        assert len(d) == len(keys)
+        assert countCompiled(d, keys) == len(keys)
+        assert all(k in d for k in keys)
+
+        removeCompiled(d, odds)
+        assert countCompiled(d, keys) == len(evens)
+        assert not any(k in d for k in odds)
+
+        for k in evens[:500]:
+            del d[k]
+
+        addCompiled(d, odds)
+
+        assert countCompiled(d, keys) == len(keys) - 500
+        assert sorted(d) == sorted(list(evens[500:]) + list(odds))
+
+    def test_dict_group_hash_agrees_for_high_bit_keys(self):
+        # keys whose hashes differ only in their upper bits should still
+        # spread across groups identically in compiled and interpreted code.
+        @Entrypoint
+        def addCompiled(d: Dict(int, int), keys: ListOf(int)):
+            for k in keys:
+                d[k] = k
+
+        @Entrypoint
+        def countCompiled(d: Dict(int, int), keys: ListOf(int)) -> int:
+            res = 0
+            for k in keys:
+                if k in d:
+                    res += 1
+            return res
+
+        keys = ListOf(int)([i << 20 for i in range(1, 3000)])
+
+        d = Dict(int, int)()
+        addCompiled(d, keys[::2])
+        for k in keys[1::2]:
+            d[k] = k
+
+        assert countCompiled(d, keys) == len(keys)
+        assert all(d[k] == k for k in keys)
+
     def test_dict_of_object_compiles(self):
         aDict = Dict(object, object)()
 
@@ -1013,3 +1121,203 @@ class TestDictCompilation(unittest.TestCase):
 
         setItem(d, ConstDict(int, int)({1: 2}), 3)
         assert getItem(d, ConstDict(int, int)({1: 2})) == 3
+
+    def test_dict_get_many(self):
+        @Entrypoint
+        def getMany(d: Dict(str, int), keys: ListOf(str)):
+            return d.getMany(keys, -1)
+
+        for count in [0, 1, 10, 1000]:
+            d = Dict(str, int)({str(i): i for i in range(count)})
+
+            # more keys than the lookahead, half of which are missing
+            keys = ListOf(str)([str(i) for i in range(-50, count + 50)])
+
+            expected = ListOf(int)([d.get(k, -1) for k in keys])
+
+            assert d.getMany(keys, -1) == expected
+            assert getMany(d, keys) == expected
+
+    def test_dict_get_many_object_keys(self):
+        @Entrypoint
+        def getMany(d: Dict(object, str), keys: ListOf(object)):
+            return d.getMany(keys, "missing")
+
+        d = Dict(object, str)({i: str(i) for i in range(100)})
+        d["hi"] = "there"
+
+        keys = ListOf(object)([-1, "hi", 5, "nope", 99, None])
+
+        assert getMany(d, keys) == ["missing", "there", "5", "missing", "99", "missing"]
+        assert d.getMany(keys, "missing") == getMany(d, keys)
+
+    def test_dict_iteration_skips_deleted_slots(self):
+        @Entrypoint
+        def keysOf(d: Dict(int, int)):
+            res = ListOf(int)()
+            for k in d:
+                res.append(k)
+            return res
+
+        @Entrypoint
+        def setElementsOf(s: Set(int)):
+            res = ListOf(int)()
+            for k in s:
+                res.append(k)
+            return res
+
+        for count in [0, 1, 7, 8, 9, 100, 1000]:
+            for stride in [1, 3, 8, 13, 64]:
+                d = Dict(int, int)({i: i for i in range(count)})
+                s = Set(int)(range(count))
+
+                # leave runs of deleted slots of every length and alignment
+                for i in range(count):
+                    if i % stride:
+                        del d[i]
+                        s.discard(i)
+
+                expected = [i for i in range(count) if i % stride == 0]
+
+                assert list(d) == expected
+                assert keysOf(d) == expected
+                assert sorted(s) == expected
+                assert sorted(setElementsOf(s)) == expected
+
+    def test_dict_keys_differing_only_in_high_bits(self):
+        @Entrypoint
+        def fill(d: Dict(int, int), keys: ListOf(int)):
+            for k in keys:
+                d[k] = k + 1
+
+        @Entrypoint
+        def countPresent(d: Dict(int, int), keys: ListOf(int)):
+            res = 0
+            for k in keys:
+                if d.get(k, 0) == k + 1:
+                    res += 1
+            return res
+
+        # these all have the same low bits, which used to mean the same control tag
+        keys = ListOf(int)([i << 20 for i in range(5000)])
+
+        compiledDict = Dict(int, int)()
+        fill(compiledDict, keys)
+
+        interpretedDict = Dict(int, int)({k: k + 1 for k in keys})
+
+        # tables built by either side have to be readable by the other
+        for d in [compiledDict, interpretedDict]:
+            assert countPresent(d, keys) == len(keys)
+            assert all(d[k] == k + 1 for k in keys)
+            assert countPresent(d, ListOf(int)([k + 1 for k in keys])) == 0
+
+    def test_small_tables_grow_and_shrink(self):
+        @Entrypoint
+        def addKeys(d: Dict(object, int), keys: ListOf(int)):
+            for k in keys:
+                d[k] = k
+
+        @Entrypoint
+        def removeKeys(d: Dict(object, int), keys: ListOf(int)):
+            for k in keys:
+                del d[k]
+
+        @Entrypoint
+        def countPresent(d: Dict(object, int), keys: ListOf(int)):
+            res = 0
+            for k in keys:
+                if k in d:
+                    res += 1
+            return res
+
+        @Entrypoint
+        def addElements(s: Set(int), keys: ListOf(int)):
+            for k in keys:
+                s.add(k)
+
+        @Entrypoint
+        def intersect(s1: Set(int), s2: Set(int)):
+            return s1 & s2
+
+        # negative keys hash negative, which both sides have to store the same way
+        keys = ListOf(int)([k * (-1) ** k for k in range(40)])
+
+        for growCompiled in [False, True]:
+            for shrinkCompiled in [False, True]:
+                d = Dict(object, int)()
+
+                # grow one key at a time, through the small table and out of it
+                for i, k in enumerate(keys):
+                    if growCompiled:
+                        addKeys(d, ListOf(int)([k]))
+                    else:
+                        d[k] = k
+
+                    assert countPresent(d, keys) == i + 1
+                    assert all(d[k2] == k2 for k2 in keys[:i + 1])
+
+                # and shrink until the table is small again
+                for i, k in enumerate(keys):
+                    if shrinkCompiled:
+                        removeKeys(d, ListOf(int)([k]))
+                    else:
+                        del d[k]
+
+                    assert countPresent(d, keys) == len(keys) - i - 1
+                    assert all(k2 in d for k2 in keys[i + 1:])
+
+                assert not d
+
+                addKeys(d, keys[:5])
+                d.clear()
+                addKeys(d, keys[:3])
+                assert sorted(d) == sorted(keys[:3])
+
+        for n1 in [0, 3, 8, 9, 20]:
+            for n2 in [0, 5, 8, 12]:
+                s1 = Set(int)(range(n1))
+                s2 = Set(int)()
+                addElements(s2, ListOf(int)(range(2, 2 + n2)))
+
+                assert intersect(s1, s2) == set(range(n1)) & set(range(2, 2 + n2))
+                assert intersect(s2, s1) == intersect(s1, s2)
+
+    def test_object_key_lookups_skip_eq(self):
+        eqCalls = []
+
+        class Key:
+            def __init__(self, x):
+                self.x = x
+
+            def __hash__(self):
+                return self.x * 1000003
+
+            def __eq__(self, other):
+                eqCalls.append(self.x)
+                return isinstance(other, Key) and other.x == self.x
+
+        @Entrypoint
+        def countPresent(d: Dict(object, int), keys: ListOf(object)):
+            res = 0
+            for k in keys:
+                if k in d:
+                    res += 1
+            return res
+
+        keys = [Key(i) for i in range(100)]
+
+        for count in [5, 100]:
+            d = Dict(object, int)({k: k.x for k in keys[:count]})
+
+            # looking up the objects we inserted never needs '__eq__'
+            del eqCalls[:]
+            assert countPresent(d, ListOf(object)(keys[:count])) == count
+            assert not eqCalls
+
+            # but equal objects that aren't the same one still match
+            assert countPresent(d, ListOf(object)([Key(i) for i in range(count)])) == count
+            assert countPresent(d, ListOf(object)([Key(i) for i in range(count, count + 10)])) == 0
+
+        d = Dict(object, int)({"a": 1, 2: 2, 3.5: 3, None: 4, "ab" * 10: 5})
+        assert countPresent(d, ListOf(object)(["a", 2, 3.5, None, "ab" * 10, "b", 2.5])) == 5
@@ -14,11 +14,12 @@
 
 from typed_python import (
     ListOf, Class, Member, Final, TupleOf, DisableCompiledCode,
-    isCompiled, SerializationContext
+    isCompiled, SerializationContext, Value
 )
-from typed_python._types import touchCompiledSpecializations
+from typed_python._types import touchCompiledSpecializations, entrypointDispatchCacheStats
 from typed_python import Entrypoint, NotCompiled
 from typed_python.compiler.runtime import Runtime, RuntimeEventVisitor
+from typed_python.test_util import evaluateExprInFreshProcess
 from flaky import flaky
 import pytest
 import traceback
@@ -84,6 +85,57 @@ class TestCompileSpecializedEntrypoints(unittest.TestCase):
 
         self.assertEqual(Runtime.singleton().timesCompiled - compileCount, 2)
 
+    def test_entrypoint_specialized_on_argument_values(self):
+        @Entrypoint(specializeOn=['mode'])
+        def f(x: int, mode):
+            if mode == 0:
+                return x + 1
+            if mode == 1:
+                return "one"
+            return x * 2
+
+        compileCount = Runtime.singleton().timesCompiled
+
+        for i in range(5):
+            assert f(i, 0) == i + 1
+            assert f(i, 1) == "one"
+            assert f(i, 2) == i * 2
+
+        # one form per value of 'mode', and each one only returns what its branch returns
+        assert Runtime.singleton().timesCompiled - compileCount == 3
+        assert f.resultTypeFor(int, Value(0)).typeRepresentation is int
+        assert f.resultTypeFor(int, Value(1)).typeRepresentation is str
+
+        # values we can't specialize on are passed as usual
+        assert f(3, 2.5) == 6.0
+
+        with self.assertRaisesRegex(Exception, "no such argument"):
+            Entrypoint(specializeOn=['notAnArg'])(lambda x: x)
+
+    def test_entrypoint_specialization_budget(self):
+        @Entrypoint(specializationBudget=2)
+        def identity(x):
+            return x
+
+        compileCount = Runtime.singleton().timesCompiled
+
+        assert identity(1) == 1
+        assert identity(1.5) == 1.5
+
+        # out of budget, so this gets the generic form, which everything else then uses
+        assert identity("a") == "a"
+        assert identity(b"b") == b"b"
+        assert identity(None) is None
+
+        assert Runtime.singleton().timesCompiled - compileCount == 3
+
+        report = [r for r in Runtime.singleton().specializationBudgetReport() if r['name'] == 'identity']
+
+        assert len(report) == 1
+        assert report[0]['budget'] == 2
+        assert report[0]['specializations'] == 2
+        assert report[0]['genericSpecializations'] == 1
+
     @flaky(max_runs=3, min_passes=1)
     def test_specialized_entrypoint_dispatch_perf(self):
         def add(x, y):
@@ -628,3 +680,101 @@ class TestCompileSpecializedEntrypoints(unittest.TestCase):
         assert callIt(f1) is l1
         assert callIt(f2) is l2
         assert callIt(f3) is l1
+
+    def test_entrypoint_dispatch_cache(self):
+        @Entrypoint
+        def addOne(x):
+            return x + 1
+
+        assert addOne(1) == 2
+        assert addOne(1.5) == 2.5
+
+        stats = entrypointDispatchCacheStats(addOne)
+        assert stats['entries'] == 2
+
+        for i in range(100):
+            assert addOne(i) == i + 1
+            assert addOne(float(i)) == i + 1.0
+
+        newStats = entrypointDispatchCacheStats(addOne)
+        assert newStats['hits'] - stats['hits'] == 200
+        assert newStats['misses'] == stats['misses']
+
+        # calls with keyword arguments go the long way, but still work
+        assert addOne(x=3) == 4
+        assert entrypointDispatchCacheStats(addOne)['hits'] == newStats['hits']
+
+    def test_entrypoint_dispatch_cache_respects_overload_order(self):
+        @Entrypoint
+        def f(x: int):
+            return "int"
+
+        @f.overload
+        def f(x: float):
+            return "float"
+
+        @f.overload
+        def f(x):
+            return "object"
+
+        for _ in range(3):
+            assert f(1) == "int"
+            assert f(1.5) == "float"
+            assert f("hi") == "object"
+
+        assert entrypointDispatchCacheStats(f)['hits'] > 0
+
+    def test_entrypoint_and_bound_method_argument_passing(self):
+        # calls from the interpreter arrive through vectorcall, with the keyword
+        # arguments' values after the positional ones
+        @Entrypoint
+        def f(x, y=2):
+            return x * 10 + y
+
+        assert f(1) == 12
+        assert f(1, 3) == 13
+        assert f(1, y=3) == 13
+        assert f(y=3, x=1) == 13
+
+        with self.assertRaises(TypeError):
+            f(1, z=3)
+
+        class C(Class, Final):
+            z = Member(int)
+
+            def m(self, x, y=1):
+                return self.z + x * 10 + y
+
+        c = C(z=100)
+
+        assert c.m(1) == 111
+        assert c.m(1, 2) == 112
+        assert c.m(y=3, x=2) == 123
+
+        with self.assertRaises(TypeError):
+            c.m(1, 2, 3)
+
+
+ASYNC_MODULE = """
+from typed_python import Entrypoint, isCompiled
+from typed_python.compiler.runtime import Runtime
+
+@Entrypoint
+def whereDidIRun(x: int):
+    return isCompiled(), x + 1
+
+def callBeforeAndAfterCompiling():
+    first = whereDidIRun(1)
+
+    Runtime.singleton().backgroundCompiler.waitUntilIdle()
+
+    return first, whereDidIRun(2), Runtime.singleton().backgroundCompiler.specializationsCompiled
+"""
+
+
+def test_async_compilation_falls_back_to_interpreter(monkeypatch):
+    monkeypatch.setenv("TP_COMPILER_ASYNC", "1")
+
+    assert evaluateExprInFreshProcess(
+        {'x.py': ASYNC_MODULE}, 'x.callBeforeAndAfterCompiling()'
+    ) == ((False, 2), (True, 3), 1)
@@ -15,7 +15,7 @@
 import pytest
 import traceback
 
-from typed_python import Entrypoint, ListOf, NotCompiled, _types
+from typed_python import Dict, Entrypoint, ListOf, NotCompiled, _types
 
 
 def test_string_to_int_error_catchable():
@@ -264,3 +264,41 @@ def test_raise_simple_str():
 
     with pytest.raises(UserWarning):
         raiseStringException(100)
+
+
+def test_builtin_exceptions_raised_natively_behave_like_python_ones():
+    @Entrypoint
+    def countMissing(d: Dict(int, int), n):
+        missing = 0
+        for i in range(n):
+            try:
+                raise KeyError(i)
+            except KeyError:
+                if i not in d:
+                    missing += 1
+        return missing
+
+    assert countMissing(Dict(int, int)({1: 2}), 100) == 99
+
+    @Entrypoint
+    def argOf(x):
+        try:
+            raise ValueError(x)
+        except ValueError as e:
+            return e.args[0]
+
+    assert argOf(10) == 10
+    assert argOf("hi") == "hi"
+
+    @Entrypoint
+    def reraises(x):
+        try:
+            raise IndexError(x)
+        except IndexError:
+            raise
+
+    with pytest.raises(IndexError) as info:
+        reraises(3)
+
+    assert info.value.args == (3,)
+    assert 'reraises' in "".join(traceback.format_tb(info.tb))
@@ -0,0 +1,99 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+import tempfile
+
+import pytest
+
+from typed_python.compiler.execution_profile import ExecutionProfile, MAX_BRANCH_WEIGHT
+from typed_python.test_util import evaluateExprInFreshProcess
+
+
+def test_execution_profile_round_trips_and_merges():
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "profile.json")
+
+        ExecutionProfile({'f': 10}, {('f', 0): [1, 9]}).save(path)
+
+        profile = ExecutionProfile.load(path)
+        profile.merge(ExecutionProfile({'f': 5, 'g': 0}, {('f', 0): [2, 3], ('g', 1): [4, 0]}))
+
+        assert profile.entryCounts == {'f': 15, 'g': 0}
+        assert profile.branchCounts == {('f', 0): [3, 12], ('g', 1): [4, 0]}
+
+        assert ExecutionProfile.load(os.path.join(tf, "missing.json")).entryCounts == {}
+
+
+def test_execution_profile_weights_and_hotness():
+    profile = ExecutionProfile(
+        {'hot': 1000, 'warm': 5, 'cold': 0},
+        {('hot', 0): [0, 100], ('hot', 1): [0, 0], ('hot', 2): [2 ** 40, 2 ** 39]}
+    )
+
+    # weights are [true, false], and never zero
+    assert profile.branchWeights('hot', 0) == [100, 1]
+    assert profile.branchWeights('hot', 1) is None
+    assert profile.branchWeights('hot', 3) is None
+
+    bigWeights = profile.branchWeights('hot', 2)
+    assert max(bigWeights) <= MAX_BRANCH_WEIGHT
+    assert bigWeights[1] > bigWeights[0]
+
+    assert profile.isHot('hot')
+    assert not profile.isHot('warm')
+    assert profile.isCold('cold')
+    assert not profile.isCold('unknown')
+
+
+PROFILED_MODULE = """
+from typed_python import Entrypoint
+from typed_python.compiler.runtime import Runtime
+
+@Entrypoint
+def countOdd(x: int):
+    res = 0
+    for i in range(x):
+        if i % 7 != 0:
+            res += 1
+    return res
+
+def instrumentedRun():
+    res = countOdd(700)
+
+    Runtime.singleton().saveExecutionProfile()
+
+    return res
+"""
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_profile_guided_compilation(monkeypatch):
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "profile.json")
+
+        monkeypatch.setenv("TP_COMPILER_PGO_PROFILE", path)
+        monkeypatch.setenv("TP_COMPILER_PGO", "instrument")
+
+        assert evaluateExprInFreshProcess({'x.py': PROFILED_MODULE}, 'x.instrumentedRun()') == 600
+
+        profile = ExecutionProfile.load(path)
+
+        # the odd-counting branch went 600 to 100
+        assert [600, 100] in [sorted(counts, reverse=True) for counts in profile.branchCounts.values()]
+        assert profile.entryCounts
+
+        monkeypatch.setenv("TP_COMPILER_PGO", "use")
+
+        assert evaluateExprInFreshProcess({'x.py': PROFILED_MODULE}, 'x.countOdd(700)') == 600
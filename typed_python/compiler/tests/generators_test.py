@@ -972,3 +972,104 @@ class TestGeneratorsAndComprehensions(unittest.TestCase):
             TypedIterator = extractIteratorType(type(typedWithoutAdaptor))
             print(TypedIterator)
             assert TypedIterator is not IteratorAdaptor
+
+    def test_generators_inlined_into_for_loops(self):
+        def evens(n):
+            i = 0
+            while i < n:
+                yield i
+                i += 2
+
+        def pairs(n):
+            for i in range(n):
+                for j in range(i):
+                    if (i + j) % 3 == 0:
+                        continue
+                    yield (i, j)
+            yield (-1, -1)
+
+        def sumEvens(n):
+            res = 0
+            for x in evens(n):
+                if x == 4:
+                    continue
+                res += x
+            return res
+
+        def firstEvenOver(n, threshold):
+            for x in evens(n):
+                if x > threshold:
+                    break
+            else:
+                return -1
+            return x
+
+        def sumPairs(n, stopAt):
+            res = 0
+            for i, j in pairs(n):
+                for k in range(3):
+                    if k == 1:
+                        break
+                    res += i * j + k
+                if i == stopAt:
+                    break
+            else:
+                res = -res
+            return res
+
+        for f, args in [
+            (sumEvens, (10,)),
+            (firstEvenOver, (10, 5)),
+            (firstEvenOver, (10, 100)),
+            (sumPairs, (6, 4)),
+            (sumPairs, (6, 100)),
+        ]:
+            assert Entrypoint(f)(*args) == f(*args), (f, args)
+
+    def test_chained_comprehensions_are_fused(self):
+        def squaresOfOdds(lst: ListOf(int)):
+            return [x * x for x in [y + 1 for y in lst] if x % 2]
+
+        def shadowedNames(lst: ListOf(int)):
+            y = 100
+            return [(x, y) for x in (y * 2 for y in lst for z in range(y)) if x > 2]
+
+        def nested(lst: ListOf(int)):
+            return {x: i for x in [y - 1 for y in [z * 3 for z in lst]] for i in range(x % 3)}
+
+        def pairsInOrder(lst: ListOf(int)):
+            return [(a, b) for a in lst for b in lst if a < b if b < 4]
+
+        def reductions(lst: ListOf(int)):
+            return (
+                any(x > 3 for x in lst),
+                all(x > 3 for x in lst),
+                any(x > 1 for x in lst for y in range(x)),
+                min(x % 3 for x in lst),
+                max((x % 3, x) for x in [y * 2 for y in lst]),
+            )
+
+        def minOfNothing(lst: ListOf(int)):
+            return min(x for x in lst if x > 100)
+
+        lst = ListOf(int)([1, 2, 3, 4, 5])
+
+        for f in [squaresOfOdds, shadowedNames, nested, pairsInOrder, reductions]:
+            assert Entrypoint(f)(lst) == f(lst), f
+
+        with self.assertRaisesRegex(ValueError, "empty sequence"):
+            Entrypoint(minOfNothing)(lst)
+
+    def test_any_stops_at_first_true_element(self):
+        seen = ListOf(int)()
+
+        def check(x):
+            seen.append(x)
+            return x > 2
+
+        @Entrypoint
+        def anyOver(lst: ListOf(int)):
+            return any(check(x) for x in lst)
+
+        assert anyOver(ListOf(int)([1, 2, 3, 4, 5]))
+        assert seen == [1, 2, 3]
@@ -1,9 +1,11 @@
 import unittest
 import math
+import pytest
 import sys
 import time
 from flaky import flaky
 
+from typed_python import _types
 from typed_python import Class, Final, ListOf, Held, Member, PointerTo, pointerTo, Function
 from typed_python.test_util import currentMemUsageMb
 
@@ -321,6 +323,31 @@ class TestHeldClassInterpreterSemantics(unittest.TestCase):
         assert traced1 == traced2
         assert type(objects1[0]) is H
 
+    @pytest.mark.skipif(sys.gettrace() is not None, reason="muting frames is disabled under another tracer")
+    def test_temporary_reference_tracer_skips_frames_without_references(self):
+        aList = ListOf(H)()
+        aList.resize(1)
+
+        def busy():
+            total = 0
+            for i in range(1000):
+                total += i
+            return total
+
+        def f(h):
+            return busy()
+
+        stats0 = _types.temporaryReferenceTracerStats()
+        f(aList[0])
+        stats1 = _types.temporaryReferenceTracerStats()
+
+        assert stats1['tracedObjects'] > stats0['tracedObjects']
+
+        # 'f' and 'busy' hold no references, so each of them should only
+        # report its call and its return, not every line it runs
+        assert stats1['events'] - stats0['events'] < 100
+        assert stats1['mutedFrames'] - stats0['mutedFrames'] >= 2
+
     def test_held_class_instance_conversion_doesnt_leak(self):
         aList = ListOf(H)()
         aList.resize(1)
@@ -0,0 +1,85 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import Entrypoint, ListOf
+from typed_python.compiler.runtime import Runtime
+from typed_python.compiler.instrumentation import isPythonObjectFallback
+
+
+def profileOf(functionName):
+    return {
+        name: counters for name, counters in Runtime.singleton().getProfile().items()
+        if f".{functionName}." in name
+    }
+
+
+def test_python_object_fallback_names():
+    assert isPythonObjectFallback("np_pyobj_Add")
+    assert isPythonObjectFallback("nativepython_runtime_getattr_pyobj")
+    assert not isPythonObjectFallback("np_destroy_pyobj_handle")
+    assert not isPythonObjectFallback("nativepython_runtime_get_pyobj_None")
+    assert not isPythonObjectFallback("np_hash_string")
+
+
+def test_instrumented_entrypoint_counts_calls_cycles_and_fallbacks():
+    def instrumentedHelper(x: object) -> object:
+        return x + 1
+
+    @Entrypoint(instrument=True)
+    def instrumentedSum(values: ListOf(int), boxed: object):
+        res = 0
+        for v in values:
+            res += v
+        return instrumentedHelper(boxed)
+
+    for _ in range(10):
+        instrumentedSum(ListOf(int)(range(100)), 1)
+
+    counters, = profileOf("instrumentedSum").values()
+
+    assert counters['calls'] == 10
+    assert counters['cycles'] > 0
+
+    # the helper is instrumented too, because an instrumented function called it
+    helperCounters, = profileOf("instrumentedHelper").values()
+
+    assert helperCounters['calls'] == 10
+    assert helperCounters['pythonObjectCalls'] >= 10
+
+
+def test_uninstrumented_entrypoints_dont_count():
+    @Entrypoint
+    def uninstrumentedAdd(x: int):
+        return x + 1
+
+    uninstrumentedAdd(1)
+
+    assert profileOf("uninstrumentedAdd") == {}
+
+
+def test_get_profile_reset():
+    @Entrypoint(instrument=True)
+    def instrumentedToReset(x: int):
+        return x + 1
+
+    instrumentedToReset(1)
+    instrumentedToReset(2)
+
+    assert list(profileOf("instrumentedToReset").values())[0]['calls'] == 2
+
+    Runtime.singleton().getProfile(reset=True)
+
+    instrumentedToReset(3)
+
+    assert list(profileOf("instrumentedToReset").values())[0]['calls'] == 1
@@ -50,7 +50,7 @@ class TestListOfCompilation(unittest.TestCase):
         lst = f()
 
         assert isinstance(lst, ListOf(int))
-        assert lst.reserved() == 1
+        assert lst.reserved() == 0
 
     def test_list_of_list_refcounts(self):
         @Compiled
@@ -291,6 +291,50 @@ class TestListOfCompilation(unittest.TestCase):
 
             self.assertEqual(t, t2)
 
+    def test_list_growth_matches_interpreter(self):
+        @Compiled
+        def appendOne(x: ListOf(int)):
+            x.append(0)
+
+        compiled = ListOf(int)()
+        interpreted = ListOf(int)()
+
+        for _ in range(5000):
+            appendOne(compiled)
+            interpreted.append(0)
+
+            self.assertEqual(compiled.reserved(), interpreted.reserved())
+
+    def test_list_extend_reserves_once(self):
+        @Compiled
+        def f(x: ListOf(int), y: TupleOf(int)):
+            x.extend(y)
+
+        aList = ListOf(int)([1])
+        aList.reserve(1)
+
+        f(aList, TupleOf(int)(range(100)))
+        self.assertEqual(aList.reserved(), 101)
+
+        # small extends still grow geometrically
+        f(aList, TupleOf(int)(range(10)))
+        self.assertEqual(len(aList), 111)
+        self.assertEqual(aList.reserved(), 206)
+        self.assertEqual(aList[110], 9)
+
+    def test_list_shrink_to_fit(self):
+        @Compiled
+        def f(x: ListOf(int)):
+            x.shrinkToFit()
+
+        aList = ListOf(int)(range(10))
+        aList.reserve(100)
+
+        f(aList)
+
+        self.assertEqual(aList.reserved(), 10)
+        self.assertEqual(aList, list(range(10)))
+
     def test_list_append(self):
         T = ListOf(int)
 
@@ -826,3 +870,44 @@ class TestListOfCompilation(unittest.TestCase):
             return res
 
         assert sumThem([[1], [2], [3, 4, 5]]) == 15
+
+    def test_range_over_len_loops_without_bounds_checks(self):
+        @Entrypoint
+        def dot(x: ListOf(float), y: ListOf(float)):
+            res = 0.0
+            for i in range(len(x)):
+                res += x[i] * y[i]
+            return res
+
+        @Entrypoint
+        def axpy(a: float, x: TupleOf(float), y: ListOf(float)):
+            for i in range(0, len(y)):
+                y[i] += a * x[i]
+
+        x = ListOf(float)([1.0, 2.0, 3.0])
+        y = ListOf(float)([4.0, 5.0, 6.0])
+
+        assert dot(x, y) == 32.0
+        assert dot(ListOf(float)(), y) == 0.0
+
+        # 'y[i]' is still checked, since nothing proves 'y' is as long as 'x'
+        with self.assertRaises(IndexError):
+            dot(x, ListOf(float)([1.0]))
+
+        axpy(2.0, TupleOf(float)(x), y)
+        assert y == [6.0, 9.0, 12.0]
+
+        with self.assertRaises(IndexError):
+            axpy(2.0, TupleOf(float)([1.0]), y)
+
+    def test_range_over_len_loops_that_resize_keep_bounds_checks(self):
+        @Entrypoint
+        def sumWhilePopping(x: ListOf(int)):
+            res = 0
+            for i in range(len(x)):
+                res += x[i]
+                x.pop()
+            return res
+
+        with self.assertRaises(IndexError):
+            sumWhilePopping(ListOf(int)([1, 2, 3, 4]))
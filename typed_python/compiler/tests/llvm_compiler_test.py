@@ -19,6 +19,7 @@ import tempfile
 from typed_python import PointerTo, ListOf, Runtime
 from typed_python.compiler.module_definition import ModuleDefinition
 from typed_python.compiler.global_variable_definition import GlobalVariableMetadata
+from typed_python.test_util import evaluateExprInFreshProcess
 
 import pytest
 import ctypes
@@ -131,3 +132,116 @@ def test_create_binary_shared_object():
         pointers[0].set(5)
 
         assert loaded.functionPointers['__test_f_2']() == 5
+
+
+TIERED_MODULE = """
+from typed_python import Entrypoint
+from typed_python.compiler.runtime import Runtime
+
+@Entrypoint
+def sumTo(x: int):
+    res = 0
+    for i in range(x):
+        res += i
+    return res
+
+def callUntilTieredUp():
+    results = [sumTo(100) for _ in range(20)]
+
+    Runtime.singleton().tierUpCompiler.waitUntilIdle()
+
+    results += [sumTo(100) for _ in range(5)]
+
+    return (
+        results == [4950] * 25,
+        Runtime.singleton().tierUpCompiler.modulesOptimized,
+        Runtime.singleton().tierUpCompiler.entrypointsReplaced
+    )
+"""
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_tiered_compilation_swaps_in_optimized_entrypoint(monkeypatch):
+    monkeypatch.setenv("TP_COMPILER_TIERED", "10")
+
+    assert evaluateExprInFreshProcess({'x.py': TIERED_MODULE}, 'x.callUntilTieredUp()') == (True, 1, 1)
+
+
+PARALLEL_MODULE = """
+from typed_python import Entrypoint, Function
+from typed_python.compiler.runtime import Runtime
+
+""" + "".join(
+    f"@Function\ndef chain{i}(x: int):\n    return chain{i + 1}(x) + {i}\n\n" for i in range(200)
+) + """
+@Function
+def chain200(x: int):
+    return x
+
+@Entrypoint
+def callChain(x: int):
+    return chain0(x)
+
+def buildInParallel():
+    modulesBefore = Runtime.singleton().llvm_compiler.converter.moduleCount
+
+    res = callChain(1)
+
+    return res, Runtime.singleton().llvm_compiler.converter.moduleCount - modulesBefore
+"""
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_parallel_module_compilation(monkeypatch):
+    monkeypatch.setenv("TP_COMPILER_THREADS", "4")
+
+    res, modulesBuilt = evaluateExprInFreshProcess({'x.py': PARALLEL_MODULE}, 'x.buildInParallel()')
+
+    assert res == 1 + sum(range(200))
+    assert modulesBuilt >= 4
+
+
+MEMORY_MODULE = """
+from typed_python import Entrypoint, ListOf
+from typed_python.compiler.native_ast_to_llvm import DefinedFunction
+from typed_python.compiler.runtime import Runtime
+
+@Entrypoint
+def small(x):
+    return x + 1
+
+@Entrypoint
+def big(x):
+    res = ListOf(type(x))()
+    for i in range(10):
+        if i % 2:
+            res.append(x + i)
+        else:
+            res.append(x * i)
+    for i in range(len(res)):
+        res[i] = res[i] - res[len(res) - 1 - i]
+    return res
+
+def compileAndMeasure():
+    for T in [int, float, bool, str, bytes]:
+        small(T())
+        big(T())
+
+    stats = Runtime.singleton().compilerMemoryStats()
+    converter = Runtime.singleton().llvm_compiler.converter
+
+    return (
+        stats['converter']['pendingDefinitions'],
+        stats['converter']['inflightConversions'],
+        stats['converter']['inflightDefinitions'],
+        len(Runtime.singleton().converter._identifier_to_pyfunc),
+        stats['llvm']['inlinableDefinitions'] < stats['llvm']['functions'],
+        all(isinstance(f, DefinedFunction) for f in converter._functions_by_name.values())
+    )
+"""
+
+
+def test_compiler_drops_conversion_state_once_modules_are_built():
+    res = evaluateExprInFreshProcess({'x.py': MEMORY_MODULE}, 'x.compileAndMeasure()')
+
+    assert res == (0, 0, 0, 0, True, True)
@@ -12,6 +12,7 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 import os
+import pytest
 import threading
 import time
 import unittest
@@ -23,6 +24,7 @@ from typed_python import (
 )
 
 import typed_python._types as _types
+from typed_python.test_util import evaluateExprInFreshProcess
 
 
 def thread_apply(f, argtuples):
@@ -270,3 +272,96 @@ class TestMultithreading(unittest.TestCase):
         # is held as 'object', you'd see 2.0 or higher, so this still verifies that we are
         # getting c-level parallelism at this threshold.
         self.assertLess(twoThreads / oneThread, 1.65, (oneThread, twoThreads))
+
+
+
+THREAD_CONFINED_MODULE = """
+from typed_python import _types
+
+@Entrypoint
+def copies(x: ListOf(str), times: int):
+    res = ListOf(ListOf(str))()
+    for _ in range(times):
+        res.append(x)
+    return res
+
+def refcountsAfterCopies():
+    x = ListOf(str)(['a'])
+    before = _types.refcount(x)
+    held = copies(x, 10)
+    during = _types.refcount(x)
+    held = None
+    return (_types.refcountsAreThreadConfined(), during - before, _types.refcount(x) - before)
+"""
+
+
+def test_thread_confined_refcounts(monkeypatch):
+    monkeypatch.setenv("TP_THREAD_CONFINED_REFCOUNTS", "1")
+
+    assert evaluateExprInFreshProcess(
+        {'x.py': THREAD_CONFINED_MODULE}, 'x.refcountsAfterCopies()'
+    ) == (True, 10, 0)
+
+
+def test_nogil_entrypoint_runs_and_checks_for_python_objects():
+    def plusOne(x: float) -> float:
+        return x + 1
+
+    @Entrypoint(nogil=True)
+    def total(x: ListOf(float)) -> float:
+        res = 0.0
+        for v in x:
+            res += plusOne(v)
+        return res
+
+    assert total(ListOf(float)([1.0, 2.0, 3.0])) == 9.0
+
+    @Entrypoint(nogil=True)
+    def usesAnObject(x: ListOf(float)) -> float:
+        o = object()  # noqa: F841
+        return x[0]
+
+    with pytest.raises(Exception, match="nogil"):
+        usesAnObject(ListOf(float)([1.0]))
+
+
+
+@pytest.mark.skipif('sys.platform=="darwin"')
+def test_fork_after_prepare_for_fork():
+    from typed_python.compiler.runtime import Runtime
+
+    @Entrypoint
+    def total(x: ListOf(float)) -> float:
+        res = 0.0
+        for v in x:
+            res += v
+        return res
+
+    aList = ListOf(float)(range(1000000))
+    context = SerializationContext().withCompression()
+
+    # start the compression threads in the parent
+    assert context.deserialize(context.serialize(aList)) == aList
+
+    expected = total(aList)
+
+    Runtime.singleton().prepareForFork(freeze=False)
+
+    pid = os.fork()
+
+    if pid == 0:
+        try:
+            results = thread_apply(total, [(aList,)] * 4)
+
+            ok = (
+                all(results[i] == expected for i in range(4))
+                and context.deserialize(context.serialize(aList)) == aList
+            )
+        except Exception:
+            ok = False
+
+        os._exit(0 if ok else 1)
+
+    _, status = os.waitpid(pid, 0)
+
+    assert os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0
@@ -16,6 +16,7 @@ from typed_python.compiler.native_ast import (
     Expression, Void, Int32, nullExpr, Function, FunctionBody,
     Teardown, const_int32_expr, CallTarget, NamedCallTarget
 )
+import typed_python.compiler.native_ast as native_ast
 from typed_python.compiler.llvm_compiler import llvm
 import typed_python.compiler.native_ast_to_llvm as native_ast_to_llvm
 import unittest
@@ -35,6 +36,20 @@ def externalCallTarget(name, output, *inputs):
     )
 
 
+def compiledCallTarget(name, output, *inputs):
+    return CallTarget.Named(
+        target=NamedCallTarget(
+            name=name,
+            arg_types=inputs,
+            output_type=output,
+            external=False,
+            varargs=False,
+            intrinsic=False,
+            can_throw=True
+        )
+    )
+
+
 class TestNativeAstToLlvm(unittest.TestCase):
     def test_teardowns(self):
         converter = native_ast_to_llvm.Converter()
@@ -64,3 +79,132 @@ class TestNativeAstToLlvm(unittest.TestCase):
         moduleDef = converter.add_functions({'f': f})
         mod = llvm.parse_assembly(moduleDef.moduleText)
         mod.verify()
+
+    def test_calls_to_functions_that_cant_unwind_dont_need_landing_pads(self):
+        converter = native_ast_to_llvm.Converter()
+
+        a = Expression.Variable(name='a')
+
+        def function(body):
+            return Function(args=[('a', Int32)], output_type=Int32, body=FunctionBody.Internal(body))
+
+        # 'countdown' only does arithmetic and calls itself. 'throws' calls something external.
+        countdown = compiledCallTarget("countdown", Int32, Int32)
+        throws = compiledCallTarget("throws", Int32, Int32)
+
+        moduleDef = converter.add_functions({
+            'countdown': function(
+                Expression.Return(
+                    arg=Expression.Branch(
+                        cond=a.gt(const_int32_expr(0)),
+                        true=countdown.call(a.sub(const_int32_expr(1))),
+                        false=a
+                    ),
+                    blockName=None
+                )
+            ),
+            'throws': function(
+                externalCallTarget("thrower", Void).call() >> Expression.Return(arg=a, blockName=None)
+            ),
+            'caller': function(
+                Expression.Return(arg=countdown.call(a).add(throws.call(a)), blockName=None)
+            ),
+        })
+
+        llvm.parse_assembly(moduleDef.moduleText).verify()
+
+        assert not moduleDef.functionNameToType['countdown'].can_throw
+        assert moduleDef.functionNameToType['throws'].can_throw
+        assert moduleDef.functionNameToType['caller'].can_throw
+
+        callerText = moduleDef.moduleText[moduleDef.moduleText.index('define i32 @"caller"'):]
+        callerText = callerText[:callerText.index("\n}")]
+
+        assert 'call i32 @"countdown"' in callerText
+        assert 'invoke i32 @"throws"' in callerText
+
+    def test_unwinding_summary(self):
+        thrower = externalCallTarget("thrower", Void)
+        sqrt = CallTarget.Named(
+            target=NamedCallTarget(
+                name="llvm.sqrt.f64",
+                arg_types=(native_ast.Float64,),
+                output_type=native_ast.Float64,
+                external=True,
+                varargs=False,
+                intrinsic=True,
+                can_throw=False
+            )
+        )
+        other = compiledCallTarget("other", Void)
+
+        assert native_ast_to_llvm.unwindingSummary(sqrt.call(native_ast.const_float_expr(2.0))) == (False, set())
+        assert native_ast_to_llvm.unwindingSummary(other.call() >> nullExpr) == (False, {"other"})
+        assert native_ast_to_llvm.unwindingSummary(thrower.call())[0]
+
+        # destructors in teardowns count too
+        assert native_ast_to_llvm.unwindingSummary(
+            Expression.Finally(expr=nullExpr, teardowns=[Teardown.Always(expr=thrower.call())], name=None)
+        )[0]
+
+    def test_binops_carry_requested_llvm_flags(self):
+        converter = native_ast_to_llvm.Converter()
+
+        i = Expression.Variable(name='i')
+        x = Expression.Variable(name='x')
+
+        moduleDef = converter.add_functions({
+            'f': Function(
+                args=[('i', native_ast.Int64), ('x', native_ast.Float64)],
+                output_type=native_ast.Float64,
+                body=FunctionBody.Internal(
+                    Expression.Return(
+                        arg=native_ast.withLlvmFlags(x.mul(x), ('fast',)).add(
+                            native_ast.withLlvmFlags(i.add(i), ('nsw',)).cast(native_ast.Float64)
+                        ),
+                        blockName=None
+                    )
+                )
+            )
+        })
+
+        llvm.parse_assembly(moduleDef.moduleText).verify()
+
+        assert 'fmul fast double' in moduleDef.moduleText
+        assert 'add nsw i64' in moduleDef.moduleText
+
+        # flags only go on the Binop they were asked for
+        assert 'fadd double' in moduleDef.moduleText
+
+    def test_switch(self):
+        converter = native_ast_to_llvm.Converter()
+
+        i = Expression.Variable(name='i')
+        thrower = externalCallTarget("thrower", Void)
+
+        moduleDef = converter.add_functions({
+            'f': Function(
+                args=[('i', native_ast.Int64)],
+                output_type=native_ast.Int64,
+                body=FunctionBody.Internal(
+                    Expression.Return(
+                        arg=Expression.Switch(
+                            value=i,
+                            targets=(0, 1, 5),
+                            cases=(
+                                native_ast.const_int_expr(10),
+                                native_ast.const_int_expr(11),
+                                # a case that never falls through
+                                thrower.call() >> Expression.Return(arg=native_ast.const_int_expr(0), blockName=None),
+                            ),
+                            default=i.add(native_ast.const_int_expr(100))
+                        ),
+                        blockName=None
+                    )
+                )
+            )
+        })
+
+        llvm.parse_assembly(moduleDef.moduleText).verify()
+
+        assert 'switch i64' in moduleDef.moduleText
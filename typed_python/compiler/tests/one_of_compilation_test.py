@@ -732,3 +732,49 @@ class TestOneOfCompilation(unittest.TestCase):
             return a + b
 
         unpackIt((1, 2))
+
+    def test_oneof_none_or_list_uses_null_niche(self):
+        O = OneOf(None, ListOf(int))
+
+        assert typeWrapper(O).nullNicheIndex == 1
+
+        @Entrypoint
+        def totalLength(xs: ListOf(O)):
+            res = 0
+
+            for x in xs:
+                if x is not None:
+                    res += len(x)
+
+            return res
+
+        @Entrypoint
+        def clearEveryOther(xs: ListOf(O)):
+            for i in range(0, len(xs), 2):
+                xs[i] = None
+
+        @Entrypoint
+        def fill(xs: ListOf(O), value: ListOf(int)):
+            for i in range(len(xs)):
+                if xs[i] is None:
+                    xs[i] = value
+
+        aList = ListOf(int)([1, 2, 3])
+        xs = ListOf(O)([aList, None, aList, aList])
+
+        assert totalLength(xs) == 9
+
+        clearEveryOther(xs)
+
+        assert xs == [None, None, None, [1, 2, 3]]
+        assert totalLength(xs) == 3
+        assert _types.refcount(aList) == 2
+
+        fill(xs, ListOf(int)([4]))
+
+        assert xs == [[4], [4], [4], [1, 2, 3]]
+        assert totalLength(xs) == 6
+
+        xs.clear()
+
+        assert _types.refcount(aList) == 1
@@ -0,0 +1,71 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import _types
+from typed_python.compiler.perf_map import readableName, functionSizesInElf
+from typed_python.test_util import evaluateExprInFreshProcess
+
+
+def test_readable_name_shortens_the_identity_hash():
+    identityHash = "0123456789abcdef0123456789abcdef01234567"
+
+    assert readableName(f"tp.M.f.{identityHash}") == "tp.M.f.01234567"
+    assert readableName(f"tp.M.f.{identityHash}.tier_up") == "tp.M.f.01234567.tier_up"
+    assert readableName("tp.M.f") == "tp.M.f"
+
+
+def test_function_sizes_in_elf():
+    with open(_types.__file__, "rb") as f:
+        sizes = functionSizesInElf(f.read())
+
+    assert "PyInit__types" in sizes
+    assert all(size > 0 for size in sizes.values())
+
+    assert functionSizesInElf(b"not an elf file") == {}
+
+
+def test_perf_map_names_compiled_functions(monkeypatch):
+    monkeypatch.setenv("TP_PERF_MAP", "1")
+
+    lines = evaluateExprInFreshProcess(
+        {
+            'M.py': (
+                "from typed_python import Entrypoint\n"
+                "@Entrypoint\n"
+                "def perfMapProbe(x: int) -> int:\n"
+                "    return x + 1\n"
+                "perfMapProbe(1)\n"
+            )
+        },
+        "open('/tmp/perf-%d.map' % __import__('os').getpid()).read().splitlines()"
+    )
+
+    probeLines = [line for line in lines if 'perfMapProbe' in line]
+
+    assert probeLines
+
+    for line in probeLines:
+        address, size, name = line.split(" ", 2)
+
+        assert int(address, 16) > 0
+        assert int(size, 16) > 0
+
+
+def test_perf_map_is_off_by_default(monkeypatch):
+    monkeypatch.delenv("TP_PERF_MAP", raising=False)
+
+    assert not evaluateExprInFreshProcess(
+        {'M.py': "from typed_python.compiler.perf_map import perfMapEnabled\n"},
+        "M.perfMapEnabled()"
+    )
@@ -0,0 +1,85 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import Entrypoint, Compiled, NotCompiled, ListOf, OneOf
+from typed_python.compiler.runtime import PerformanceLintVisitor
+from typed_python.compiler.performance_lint import OBJECT, ONEOF_DISPATCH, TO_PYTHON, FROM_PYTHON
+
+
+def lineOf(f, offset):
+    return f.overloads[0].functionCode.co_firstlineno + offset
+
+
+def test_lint_reports_object_expressions_and_conversions():
+    @NotCompiled
+    def untyped():
+        return 10
+
+    @Entrypoint
+    def lintedUsesObject(x: int) -> int:
+        y = untyped()
+        return x + y
+
+    with PerformanceLintVisitor() as lint:
+        lintedUsesObject(1)
+
+    notes = lint.notesFor("lintedUsesObject")
+    kinds = {note.kind for note in notes}
+
+    assert OBJECT in kinds
+    assert FROM_PYTHON in kinds
+
+    assert any(
+        note.kind == OBJECT and note.lineNumber == lineOf(lintedUsesObject, 2) and "untyped" in note.description
+        for note in notes
+    )
+
+    assert "lintedUsesObject" in lint.report()
+
+
+def test_lint_reports_oneof_dispatch():
+    with PerformanceLintVisitor() as lint:
+        @Compiled
+        def lintedOneOf(x: OneOf(int, float), y: int) -> OneOf(int, float):
+            return x + y
+
+    notes = [note for note in lint.notesFor("lintedOneOf") if note.kind == ONEOF_DISPATCH]
+
+    assert notes
+    assert all("OneOf(int, float)" in note.description for note in notes)
+
+
+def test_lint_reports_conversion_to_python():
+    @Entrypoint
+    def lintedToPython(x: int) -> object:
+        return x
+
+    with PerformanceLintVisitor() as lint:
+        lintedToPython(1)
+
+    assert TO_PYTHON in {note.kind for note in lint.notesFor("lintedToPython")}
+
+
+def test_well_typed_code_has_no_notes():
+    @Entrypoint
+    def lintedClean(x: ListOf(int)) -> int:
+        res = 0
+        for v in x:
+            res += v
+        return res
+
+    with PerformanceLintVisitor() as lint:
+        lintedClean(ListOf(int)([1, 2, 3]))
+
+    assert lint.notesFor("lintedClean") == []
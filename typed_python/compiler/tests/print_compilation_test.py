@@ -0,0 +1,126 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+import tempfile
+import threading
+
+import pytest
+
+from typed_python import (
+    Entrypoint, ListOf, OneOf, configureCompiledPrint, flushCompiledPrint, compiledPrintRingBufferContents
+)
+
+
+@pytest.fixture
+def ringBuffer():
+    configureCompiledPrint(ringBufferSize=1 << 20)
+    yield
+    configureCompiledPrint()
+
+
+@Entrypoint
+def printThings(i: int, f: float, s: str, b: bool, o: OneOf(None, ListOf(int))):
+    print(i, f, s, b, o)
+    print(i, f, sep="|", end=";\n")
+    print()
+
+
+def test_compiled_print_formats_like_the_interpreter(ringBuffer):
+    printThings(-12, 0.1, "héllo", True, None)
+    printThings(0, 1e300, "", False, ListOf(int)([1, 2]))
+
+    expected = ""
+    for args in [(-12, 0.1, "héllo", True, None), (0, 1e300, "", False, [1, 2])]:
+        expected += " ".join(str(a) for a in args) + "\n"
+        expected += "%s|%s;\n" % (args[0], args[1])
+        expected += "\n"
+
+    assert compiledPrintRingBufferContents() == expected.encode("utf8")
+
+
+@Entrypoint
+def printRange(count: int):
+    for i in range(count):
+        print(i)
+
+
+@Entrypoint
+def printAndFlush(x: int):
+    print(x, flush=True)
+
+
+def test_compiled_print_buffers(ringBuffer):
+    configureCompiledPrint(ringBufferSize=1 << 20, bufferSize=1 << 16)
+
+    printRange(10)
+    assert compiledPrintRingBufferContents() == b""
+
+    flushCompiledPrint()
+    assert compiledPrintRingBufferContents() == "".join("%s\n" % i for i in range(10)).encode()
+
+    printAndFlush(10)
+    assert compiledPrintRingBufferContents().endswith(b"9\n10\n")
+
+    # a full buffer gets written without asking
+    printRange(100000)
+    assert len(compiledPrintRingBufferContents()) > 1 << 16
+
+
+def test_compiled_print_flushes_when_the_thread_exits(ringBuffer):
+    configureCompiledPrint(ringBufferSize=1 << 20, bufferSize=1 << 16)
+
+    thread = threading.Thread(target=printRange, args=(3,))
+    thread.start()
+    thread.join()
+
+    assert compiledPrintRingBufferContents() == b"0\n1\n2\n"
+
+
+def test_compiled_print_ring_buffer_keeps_the_tail():
+    try:
+        configureCompiledPrint(ringBufferSize=10)
+
+        printRange(1000)
+
+        assert compiledPrintRingBufferContents() == "".join("%s\n" % i for i in range(1000)).encode()[-10:]
+    finally:
+        configureCompiledPrint()
+
+
+def test_compiled_print_to_path():
+    with tempfile.TemporaryDirectory() as tempDir:
+        path = os.path.join(tempDir, "log.txt")
+
+        try:
+            configureCompiledPrint(path=path)
+            printRange(3)
+            configureCompiledPrint(path=path)
+            printRange(2)
+        finally:
+            configureCompiledPrint()
+
+        with open(path) as f:
+            assert f.read() == "0\n1\n2\n0\n1\n"
+
+
+def test_configure_compiled_print_errors():
+    with pytest.raises(ValueError):
+        configureCompiledPrint(fd=1, ringBufferSize=10)
+
+    with pytest.raises(ValueError):
+        configureCompiledPrint(ringBufferSize=0)
+
+    with pytest.raises(OSError):
+        configureCompiledPrint(path="/this/directory/does/not/exist/log.txt")
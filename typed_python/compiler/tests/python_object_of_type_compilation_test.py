@@ -975,3 +975,115 @@ class TestPythonObjectOfTypeCompilation(unittest.TestCase):
             return f(globalFun)
 
         assert call(str) == str(globalFun)
+
+    def test_cached_getattr_follows_type_changes(self):
+        class Slotted:
+            __slots__ = ['x']
+
+            def __init__(self, x):
+                self.x = x
+
+            def f(self):
+                return "f"
+
+        class WithDict:
+            def f(self):
+                return "dict f"
+
+        @Entrypoint
+        def getF(o: object):
+            return o.f
+
+        @Entrypoint
+        def getX(o: object):
+            return o.x
+
+        @Entrypoint
+        def getSqrt(o: object):
+            return o.sqrt
+
+        s = Slotted(1)
+
+        assert getF(s)() == "f"
+        assert getX(s) == 1
+
+        # changing the class invalidates what the call site cached
+        Slotted.f = lambda self: "patched"
+        assert getF(s)() == "patched"
+
+        # the same site sees other types, and instances that shadow methods
+        w = WithDict()
+        assert getF(w)() == "dict f"
+        w.f = lambda: "instance f"
+        assert getF(w)() == "instance f"
+
+        assert getF(s)() == "patched"
+
+        with self.assertRaises(AttributeError):
+            getX(Slotted.__new__(Slotted))
+
+        with self.assertRaises(AttributeError):
+            getX(w)
+
+        @Entrypoint
+        def getAppend(o: object):
+            return o.append
+
+        aList = []
+        getAppend(aList)(1)
+        getAppend(aList)(2)
+        assert aList == [1, 2]
+
+        import math
+
+        assert getSqrt(math)(4.0) == 2.0
+
+        with self.assertRaises(AttributeError):
+            getSqrt(w)
+
+    def test_builtin_getitem_and_setitem_fast_paths(self):
+        @Entrypoint
+        def getitem(o: object, i: object):
+            return o[i]
+
+        @Entrypoint
+        def setitem(o: object, i: object, v: object):
+            o[i] = v
+
+        for container in [[1, 2, 3], (1, 2, 3)]:
+            assert getitem(container, 0) == 1
+            assert getitem(container, -1) == 3
+
+            with self.assertRaises(IndexError):
+                getitem(container, 3)
+
+            with self.assertRaises(IndexError):
+                getitem(container, -4)
+
+            with self.assertRaises(IndexError):
+                getitem(container, 10 ** 30)
+
+        assert getitem({"a": 1}, "a") == 1
+
+        with self.assertRaises(KeyError):
+            getitem({"a": 1}, "b")
+
+        class MissingDict(dict):
+            def __missing__(self, k):
+                return k * 2
+
+        assert getitem(MissingDict(), "b") == "bb"
+
+        aList = [1, 2, 3]
+        value = object()
+        refcountBefore = refcount(value)
+
+        setitem(aList, -1, value)
+        assert aList[2] is value
+        assert refcount(value) == refcountBefore + 1
+
+        setitem(aList, -1, 0)
+        assert refcount(value) == refcountBefore
+
+        with self.assertRaises(IndexError):
+            setitem(aList, 3, 0)
@@ -0,0 +1,118 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import typed_python.compiler.native_ast as native_ast
+from typed_python import Class, Member, ListOf, Entrypoint, _types
+from typed_python.compiler.refcount_elision import elideRefcounts, markRefcountCopy
+
+Expression = native_ast.Expression
+ExpressionIntermediate = native_ast.ExpressionIntermediate
+
+decref = native_ast.CallTarget.Named(
+    target=native_ast.NamedCallTarget(
+        name="decref",
+        arg_types=(native_ast.Int64Ptr.pointer(),),
+        output_type=native_ast.Void,
+        external=True,
+        varargs=False,
+        intrinsic=False,
+        can_throw=False
+    )
+)
+
+slot = Expression.StackSlot(name="tmp", type=native_ast.Int64Ptr)
+source = Expression.Variable(name="src")
+
+
+def functionUsingTemporary(*usesOfTemporary):
+    """A function that copies '*src' into a temporary, then evaluates 'usesOfTemporary'."""
+    return native_ast.Function(
+        args=(("src", native_ast.Int64Ptr.pointer()),),
+        body=native_ast.FunctionBody.Internal(
+            body=Expression.Finally(
+                expr=Expression.ApplyIntermediates(
+                    base=slot.load().ElementPtrIntegers(1).load(),
+                    intermediates=(
+                        ExpressionIntermediate.Effect(
+                            expr=markRefcountCopy(
+                                slot.store(source.load()),
+                                slot.load().ElementPtrIntegers(0).atomic_add(1) >> native_ast.nullExpr
+                            )
+                        ),
+                        ExpressionIntermediate.Effect(expr=Expression.ActivatesTeardown(name="tmp")),
+                    ) + tuple(ExpressionIntermediate.Effect(expr=e) for e in usesOfTemporary)
+                ),
+                teardowns=(native_ast.Teardown.ByTag(tag="tmp", expr=decref.call(slot)),),
+                name=None
+            )
+        ),
+        output_type=native_ast.Int64
+    )
+
+
+def test_borrow_temporary_kept_alive_by_its_source():
+    elided = str(elideRefcounts(functionUsingTemporary()))
+
+    assert "atomic_add" not in elided
+    assert "decref" not in elided
+    assert "tmp" in elided
+
+
+def test_calls_prevent_borrowing():
+    f = functionUsingTemporary(
+        decref.call(source),
+        slot.load().ElementPtrIntegers(2).load()
+    )
+
+    assert elideRefcounts(f) is f
+
+
+def test_calls_that_can_only_throw_dont_prevent_borrowing():
+    f = functionUsingTemporary(
+        Expression.Branch(
+            cond=slot.load(),
+            true=native_ast.nullExpr,
+            false=decref.call(source) >> Expression.Throw(expr=source.load())
+        )
+    )
+
+    assert "atomic_add" not in str(elideRefcounts(f))
+
+
+def test_escaping_temporaries_are_not_borrowed():
+    f = functionUsingTemporary(
+        source.store(slot.load())
+    )
+
+    assert elideRefcounts(f) is f
+
+
+def test_refcounts_are_unchanged_by_compiled_code():
+    class C(Class):
+        x = Member(int)
+        name = Member(str)
+
+    @Entrypoint
+    def sumNames(items: ListOf(C)):
+        res = 0
+        for i in range(len(items)):
+            res += items[i].x + len(items[i].name)
+        return res
+
+    items = ListOf(C)([C(x=i, name="n" * i) for i in range(10)])
+
+    refcounts = [_types.refcount(c) for c in items]
+
+    assert sumNames(items) == 2 * sum(range(10))
+    assert [_types.refcount(c) for c in items] == refcounts
@@ -269,6 +269,26 @@ class TestSetCompilation(unittest.TestCase):
         set_discard(s, 'dd')
         self.assertEqual(s, set())
 
+    def test_set_from_list_compiles(self):
+        @Entrypoint
+        def build(elements: ListOf(str)):
+            return Set(str).fromList(elements)
+
+        elements = ListOf(str)([str(i % 500) for i in range(2000)])
+
+        self.assertEqual(build(elements), Set(str)([str(i) for i in range(500)]))
+
+    def test_set_compact_compiles(self):
+        @Entrypoint
+        def shrink(s: Set(int)):
+            for i in range(990):
+                s.discard(i)
+            s.compact()
+
+        s = Set(int)(range(1000))
+        shrink(s)
+        self.assertEqual(s, Set(int)(range(990, 1000)))
+
     def test_set_clear(self):
         @Entrypoint
         def set_clear(s):
@@ -1216,3 +1236,95 @@ class TestSetCompilation(unittest.TestCase):
             assert A.A(a=i) in s
             assert contains(s, A.A(a=i))
             assert not contains(s, A.A(a=-i))
+
+    def test_set_contains_many(self):
+        @Entrypoint
+        def containsMany(s: Set(int), keys: ListOf(int)):
+            return s.containsMany(keys)
+
+        for count in [0, 1, 10, 1000]:
+            s = Set(int)(range(0, count * 2, 2))
+            keys = ListOf(int)(range(-50, count * 2 + 50))
+
+            expected = ListOf(bool)([k in s for k in keys])
+
+            assert s.containsMany(keys) == expected
+            assert containsMany(s, keys) == expected
+
+    def test_set_algebra_on_large_sets(self):
+        for T in [int, str, object]:
+            S = Set(T)
+
+            def inplace_union(x: S, y: S):
+                x |= y
+                return x
+
+            def inplace_intersection(x: S, y: S):
+                x &= y
+                return x
+
+            def inplace_difference(x: S, y: S):
+                x -= y
+                return x
+
+            def inplace_symmetric_difference(x: S, y: S):
+                x ^= y
+                return x
+
+            def update(x: S, y: S):
+                x.update(y)
+                return x
+
+            def intersection_update(x: S, y: S):
+                x.intersection_update(y)
+                return x
+
+            def difference_update(x: S, y: S):
+                x.difference_update(y)
+                return x
+
+            def symmetric_difference_update(x: S, y: S):
+                x.symmetric_difference_update(y)
+                return x
+
+            def op_union(x: S, y: S):
+                return x | y
+
+            def op_intersection(x: S, y: S):
+                return x & y
+
+            def op_difference(x: S, y: S):
+                return x - y
+
+            def op_symmetric_difference(x: S, y: S):
+                return x ^ y
+
+            fns = [
+                inplace_union, inplace_intersection, inplace_difference, inplace_symmetric_difference,
+                update, intersection_update, difference_update, symmetric_difference_update,
+                op_union, op_intersection, op_difference, op_symmetric_difference
+            ]
+
+            # sizes on both sides of the cutoffs where we switch strategies
+            for leftSize, rightSize in [(0, 100), (100, 0), (1000, 10), (10, 1000), (1000, 1500)]:
+                left = set(T(i) if T is not object else i for i in range(0, leftSize * 2, 2))
+                right = set(T(i) if T is not object else i for i in range(0, rightSize * 3, 3))
+
+                for f in fns:
+                    expected = f(set(left), set(right))
+
+                    assert f(S(left), S(right)) == expected, (T, f, leftSize, rightSize)
+                    assert Compiled(f)(S(left), S(right)) == expected, (T, f, leftSize, rightSize)
+
+                    # in-place operations have to modify the set itself
+                    x = S(left)
+                    alias = x
+                    Compiled(f)(x, S(right))
+                    if f.__name__.startswith('op_'):
+                        assert alias == left
+                    else:
+                        assert alias == expected
+
+                    # and work when both sides are the same set
+                    x = S(left)
+                    assert Compiled(f)(x, x) == f(set(left), set(left))
@@ -495,6 +495,28 @@ class TestStringCompilation(unittest.TestCase):
                                 with self.assertRaises(ValueError):
                                     Entrypoint(g)(v, sub, start, end)
 
+    def test_string_search_long_needles_and_wide_codepoints(self):
+        @Entrypoint
+        def c_search(s: str, sub: str):
+            return (s.find(sub), s.rfind(sub), s.count(sub))
+
+        def py_search(s, sub):
+            return (s.find(sub), s.rfind(sub), s.count(sub))
+
+        for alphabet in ["ab", "a\u00e9", "a\u1234", "a\U0001f600"]:
+            a, b = alphabet
+            haystacks = [
+                a * 1000,
+                (a * 40 + b) * 30,
+                a * 500 + b + a * 500,
+                (a + b) * 300,
+            ]
+            needles = [b, a * 3 + b, a * 40 + b, b + a * 40, a * 33, (a + b) * 20 + a, "x", "\u1234" * 2]
+
+            for hay in haystacks:
+                for needle in needles:
+                    self.assertEqual(c_search(hay, needle), py_search(hay, needle), (hay, needle))
+
     def test_string_count(self):
         def f_count(x, sub):
             return x.count(sub)
@@ -535,6 +557,108 @@ class TestStringCompilation(unittest.TestCase):
 
         self.assertEqual(toString(1), "1.0")
 
+    def test_string_from_float_is_shortest_repr(self):
+        @Compiled
+        def toString(f: float):
+            return str(f)
+
+        values = [
+            0.1, 0.3, 1 / 3, 2 / 3, 1.23456789, 5e-324, 2.2250738585072014e-308, 1.7976931348623157e308,
+            1e15, 1e16, 1e17, 1e-4, 1e-5, 123456789012345678.0, 0.000123, -0.0, 9007199254740993.0,
+            float('inf'), float('-inf'), float('nan')
+        ]
+
+        for v in values:
+            self.assertEqual(toString(v), str(v))
+            self.assertEqual(toString(-v), str(-v))
+
+    def test_fstring_matches_interpreter(self):
+        def fstr(s: str, i: int, f: float):
+            return f"[{s}|{i}|{f}] {i}{s}{f}"
+
+        def fstrWithSpecs(s: str, i: int, f: float):
+            return f"{s!r} {i:>5} {f:.3f} {s:^9} {i!r}"
+
+        compiledFstr = Entrypoint(fstr)
+        compiledFstrWithSpecs = Entrypoint(fstrWithSpecs)
+
+        for s in ["", "a", "hi there", "caf\u00e9", "\u4e2d\u6587", "\U0001f600 emoji"]:
+            for i in [0, -1, 7, 10 ** 18, -2 ** 63, 2 ** 63 - 1]:
+                for f in [0.0, -0.0, 0.1, 1e100, -1.5e-7, float('inf')]:
+                    self.assertEqual(compiledFstr(s, i, f), fstr(s, i, f))
+                    self.assertEqual(compiledFstrWithSpecs(s, i, f), fstrWithSpecs(s, i, f))
+
+        @Entrypoint
+        def onlyConstants():
+            return f"{1}-{2.5}-{'x'}"
+
+        self.assertEqual(onlyConstants(), "1-2.5-x")
+
+    def test_string_to_float_and_int_match_interpreter(self):
+        @Entrypoint
+        def toFloat(s: str):
+            return float(s)
+
+        @Entrypoint
+        def toInt(s: str):
+            return int(s)
+
+        @Entrypoint
+        def bytesToFloat(s: bytes):
+            return float(s)
+
+        literals = [
+            "0", "-0", "1.5", " 12 ", "\t-3.25\n", "+.5", "5.", ".", "", "-", "1e10", "1E-10", "1e", ".e5",
+            "1_000.000_1", "1__0", "_1", "1_", "1._5", "1e1_0", "1e_1", "0x10", "1.5x", "1 2",
+            "inf", "-Infinity", "+NaN", "infinit", "1e400", "-1e400", "1e-400",
+            "0.1", "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4703282292062328e-324",
+            "1.7976931348623157e308", "1.7976931348623159e308", "9007199254740993",
+            "123456789012345678901234567890.123456789", "0." + "0" * 400 + "1", "1" + "0" * 400,
+            "8.98846567431157953864652595394512365e307", "1.5\u2003", "\u00a01.5", "\U0001F600",
+            "123", "-9223372036854775808", "9_223_372_036_854_775_807", "+ 5",
+        ]
+
+        # compare reprs, so that nan matches nan and -0.0 doesn't match 0.0
+        for s in literals:
+            r1 = repr(callOrExceptType(float, s))
+            self.assertEqual(r1, repr(callOrExceptType(toFloat, s)), s)
+
+            if s.isascii():
+                self.assertEqual(r1, repr(callOrExceptType(bytesToFloat, s.encode())), s)
+
+            r1 = callOrExceptType(int, s)
+            if r1[0] == "Normal" and not (-2**63 <= r1[1] < 2**63):
+                continue
+            self.assertEqual(r1, callOrExceptType(toInt, s), s)
+
+    def test_string_column_parsing(self):
+        @Entrypoint
+        def parseFloats(strings: ListOf(str)):
+            return _types.parseFloat64Column(strings)
+
+        @Entrypoint
+        def parseInts(strings: ListOf(str)):
+            return _types.parseInt64Column(strings)
+
+        strings = ListOf(str)(["1.5", " -2", "3e3", "1_000", "0.1"])
+
+        self.assertEqual(_types.parseFloat64Column(strings), ListOf(float)([1.5, -2, 3e3, 1000, 0.1]))
+        self.assertEqual(parseFloats(strings), ListOf(float)([1.5, -2, 3e3, 1000, 0.1]))
+        self.assertEqual(_types.parseFloat64Column(["1", "2"]), ListOf(float)([1, 2]))
+        self.assertEqual(parseFloats(ListOf(str)()), ListOf(float)())
+
+        self.assertEqual(_types.parseInt64Column(["1", " -2 ", "3_000"]), ListOf(int)([1, -2, 3000]))
+        self.assertEqual(parseInts(ListOf(str)(["1", " -2 ", "3_000"])), ListOf(int)([1, -2, 3000]))
+
+        with self.assertRaisesRegex(ValueError, "could not convert string to float: 'x'"):
+            _types.parseFloat64Column(["1", "x"])
+
+        with self.assertRaisesRegex(ValueError, "could not convert string to float: 'x'"):
+            parseFloats(ListOf(str)(["1", "x"]))
+
+        with self.assertRaisesRegex(ValueError, "invalid literal for int"):
+            parseInts(ListOf(str)(["1.5"]))
+
     @pytest.mark.skipif("sys.version_info.minor >= 8", reason="differences in unicode handling between 3.7 and 3.8")
     def test_string_is_something(self):
         @Compiled
@@ -815,6 +939,87 @@ class TestStringCompilation(unittest.TestCase):
         endusage = currentMemUsageMb()
         self.assertLess(endusage, startusage + 1)
 
+    def test_string_case_and_predicates_ascii_and_latin1(self):
+        @Entrypoint
+        def caseOps(s: str):
+            return (s.upper(), s.lower(), s.casefold(), s.swapcase())
+
+        @Entrypoint
+        def predicates(s: str):
+            return (
+                s.isalpha(), s.isalnum(), s.isdecimal(), s.isdigit(), s.isnumeric(),
+                s.isspace(), s.isprintable(), s.islower(), s.isupper()
+            )
+
+        strings = [
+            "abcdefghijklmnopqrstuvwxyz" * 3,
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ" * 3,
+            "helloWorld_123 and [more] {text}~" * 2,
+            "0123456789" * 5,
+            " \t\n\r\x0b\x0c\x1c\x1d\x1e\x1f" * 4,
+            "lower case only 123",
+            "UPPER CASE ONLY 123",
+            "x" * 40 + "\x7f",
+            "abc" * 10 + "\xe9",
+            "ABC" * 10 + "\xff",
+            "stra\xdfe" * 5,
+            "\xa0" * 20,
+        ]
+
+        for s in strings:
+            self.assertEqual(caseOps(s), (s.upper(), s.lower(), s.casefold(), s.swapcase()), s)
+            self.assertEqual(
+                predicates(s),
+                (
+                    s.isalpha(), s.isalnum(), s.isdecimal(), s.isdigit(), s.isnumeric(),
+                    s.isspace(), s.isprintable(), s.islower(), s.isupper()
+                ),
+                s
+            )
+
+    def test_string_split_on_whitespace_at_each_width(self):
+        @Entrypoint
+        def c_split(s: str, m: int) -> ListOf(str):
+            return s.split(None, m)
+
+        @Entrypoint
+        def c_rsplit(s: str, m: int) -> ListOf(str):
+            return s.rsplit(None, m)
+
+        strings = [
+            "",
+            "   ",
+            " \t\n\x0b\x0c\r\x1c\x1d\x1e\x1f\x85\xa0 ",
+            "a\x1cb\x85c\xa0d",
+            "  field one\tfield\ttwo   three " * 10,
+            "x" * 40 + " " * 20 + "y" * 40,
+            "caf\xe9 au   lait\xa0" * 5,
+            "\u2003wide\u3000spaces\u2003 here " * 5,
+            "\U0001f600 four\u2029byte " * 5,
+        ]
+
+        for s in strings:
+            for m in [-1, 0, 1, 2, 7]:
+                self.assertEqual(c_split(s, m), s.split(None, m), (s, m))
+                self.assertEqual(c_rsplit(s, m), s.rsplit(None, m), (s, m))
+
+    def test_string_split_with_overlapping_separators(self):
+        @Entrypoint
+        def c_split(s: str, sep: str, m: int) -> ListOf(str):
+            return s.split(sep, m)
+
+        @Entrypoint
+        def c_rsplit(s: str, sep: str, m: int) -> ListOf(str):
+            return s.rsplit(sep, m)
+
+        strings = ["aaaaa", "aaaaaa", "a,b,,c," * 50, ",", "\u1234,\u1234,,", "x" * 100]
+
+        for s in strings:
+            for sep in ["aa", "a", ",", ",,", "\u1234,", "xxx"]:
+                for m in [-1, 0, 1, 2, 5]:
+                    self.assertEqual(c_split(s, sep, m), s.split(sep, m), (s, sep, m))
+                    self.assertEqual(c_rsplit(s, sep, m), s.rsplit(sep, m), (s, sep, m))
+
     @flaky(max_runs=3, min_passes=1)
     def test_string_split_perf(self):
         def splitAndCount(s: str, sep: str, times: int):
@@ -12,7 +12,7 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from typed_python import Function, TupleOf, Compiled, Entrypoint, ListOf
+from typed_python import Function, TupleOf, Compiled, Entrypoint, ListOf, Tuple, NamedTuple, UInt8, Int16
 import typed_python._types as _types
 import unittest
 import time
@@ -67,6 +67,29 @@ class TestTupleOfCompilation(unittest.TestCase):
 
         print(t_py / t_fast, " speedup")
 
+    def test_compiled_code_releases_interpreter_built_tuples(self):
+        # tuples built by the interpreter hold their elements inline, so compiled
+        # destructors must not try to free a separate data block for them.
+        @Entrypoint
+        def dropAll(tups: ListOf(TupleOf(str))) -> int:
+            total = 0
+            while tups:
+                total += len(tups.pop())
+            return total
+
+        tups = ListOf(TupleOf(str))([TupleOf(str)(["a" * i] * (i % 4)) for i in range(1000)])
+        anInlineTuple = tups[3]
+        self.assertEqual(_types.refcount(anInlineTuple), 2)
+
+        self.assertEqual(dropAll(tups), sum(i % 4 for i in range(1000)))
+        self.assertEqual(_types.refcount(anInlineTuple), 1)
+
+        @Entrypoint
+        def rebuild(t: TupleOf(int)) -> TupleOf(int):
+            return TupleOf(int)(ListOf(int)(t) + ListOf(int)(t))
+
+        self.assertEqual(rebuild(TupleOf(int)([1, 2, 3])), (1, 2, 3, 1, 2, 3))
+
     def test_tuple_passing(self):
         @Compiled
         def f(x: TupleOf(int)) -> int:
@@ -256,3 +279,38 @@ class TestTupleOfCompilation(unittest.TestCase):
 
         assert addIt((1, 2), 3) == (3, 1, 2)
         assert addItLst((1, 2), 3) == (3, 1, 2)
+
+    def test_compare_tuples_of_pod(self):
+        # all of these compare bytewise, except the floats, which can't
+        for T, values in [
+            (int, [[], [0], [1], [-1], [1, 2], [1, 3], [2 ** 40, 1], [-(2 ** 40), 1], [1, 2, 3]]),
+            (UInt8, [[], [0], [255], [1, 255], [255, 1]]),
+            (Tuple(Int16, bool), [[], [(0, False)], [(-1, True)], [(256, False), (1, True)], [(1, True)]]),
+            (NamedTuple(a=int, b=UInt8), [[], [(1, 2)], [(1, 3)], [(-1, 200)], [(1, 2), (0, 0)]]),
+            (float, [[], [0.0], [-0.0], [0.0, -0.0], [-0.0, 0.0], [1.5, -2.0], [-2.0, 1.5]]),
+        ]:
+            TOf = TupleOf(T)
+
+            @Entrypoint
+            def compareAll(l: TOf, r: TOf):
+                return ListOf(bool)([l == r, l != r, l < r, l <= r, l > r, l >= r])
+
+            for l in values:
+                for r in values:
+                    expected = [l == r, l != r, l < r, l <= r, l > r, l >= r]
+
+                    tl = TOf(l)
+                    tr = TOf(r)
+
+                    assert [tl == tr, tl != tr, tl < tr, tl <= tr, tl > tr, tl >= tr] == expected, (T, l, r)
+                    assert compareAll(tl, tr) == expected, (T, l, r)
+
+    def test_compare_pod_named_tuples(self):
+        NT = NamedTuple(x=int, y=UInt8, z=Int16)
+
+        values = [(0, 0, 0), (0, 0, -1), (0, 1, -300), (-5, 255, 0), (2 ** 40, 0, 1), (0, 0, 1)]
+
+        for l in values:
+            for r in values:
+                assert (NT(x=l[0], y=l[1], z=l[2]) < NT(x=r[0], y=r[1], z=r[2])) == (l < r)
+                assert (NT(x=l[0], y=l[1], z=l[2]) == NT(x=r[0], y=r[1], z=r[2])) == (l == r)
@@ -21,6 +21,7 @@ from typed_python import (
 )
 from typed_python.compiler.runtime import Entrypoint
 from typed_python.compiler.runtime import Runtime
+from typed_python.compiler.compilation_profiler import compilationProfiler, TYPE_INFERENCE
 import unittest
 import time
 
@@ -433,3 +434,40 @@ class TestTypeInference(unittest.TestCase):
 
         assert f.resultTypeFor(str).typeRepresentation is str
         assert f.resultTypeFor(type(None)).typeRepresentation is str
+
+    def test_type_inference_counts_passes_per_group(self):
+        def isEven(n):
+            if n == 0:
+                return True
+            return isOdd(n - 1)
+
+        def isOdd(n):
+            if n == 0:
+                return False
+            return isEven(n - 1)
+
+        @Entrypoint
+        def countEvens(n: int):
+            res = 0
+            for i in range(n):
+                if isEven(i):
+                    res += 1
+            return res
+
+        compilationProfiler.start()
+        try:
+            assert countEvens(10) == 5
+        finally:
+            phases = compilationProfiler.stop()
+
+        groups = [
+            group
+            for p in phases if p.category == TYPE_INFERENCE and "slowestGroups" in p.args
+            for group in p.args["slowestGroups"]
+        ]
+
+        # isEven and isOdd call each other, so they settle as one group
+        passes, functionCount, firstName = [g for g in groups if ".isEven." in g[2]][0]
+
+        assert functionCount == 2
+        assert passes >= 1
@@ -0,0 +1,112 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import logging
+import queue
+import threading
+
+
+class TierUpCompiler:
+    """Rebuilds hot entrypoints with full optimization on a background thread.
+
+    When the runtime compiles in tiered mode, the llvm Compiler builds new code at a
+    low optimization level so the first call to a new specialization returns quickly.
+    Each entrypoint it installs counts its calls, and once it's been called
+    'hotAfterCalls' times it hands us the overload and link name through the callback
+    from 'onHotCallback'.
+
+    We then rebuild the whole tier-one module containing that entrypoint at O3 without
+    holding the runtime lock, load it under the lock, and install the optimized
+    entrypoint in place of the original. Only the entrypoint gets swapped: native code
+    that already calls into the tier-one module keeps doing so.
+    """
+    def __init__(self, lock, llvmCompiler, hotAfterCalls):
+        self.lock = lock
+        self.llvmCompiler = llvmCompiler
+        self.hotAfterCalls = hotAfterCalls
+
+        self._queue = queue.Queue()
+        self._thread = None
+        self._threadLock = threading.Lock()
+
+        # tier-one ModuleDefinition -> the optimized LoadedModule
+        self._optimizedModules = {}
+
+        self.modulesOptimized = 0
+        self.entrypointsReplaced = 0
+
+    def canTierUp(self, linkName):
+        return self.llvmCompiler.tierOneModuleFor(linkName) is not None
+
+    def onHotCallback(self, overload, linkName, returnType, argumentTypes):
+        """Return the callback to install alongside the tier-one entrypoint 'linkName'."""
+        def onHot():
+            self._ensureThread()
+            self._queue.put((overload, linkName, returnType, argumentTypes))
+
+        return onHot
+
+    def waitUntilIdle(self):
+        """Block until we've processed everything that's become hot so far."""
+        self._queue.join()
+
+    def resetAfterFork(self):
+        """Forget our thread and queue in a forked child, which has neither.
+
+        Entrypoints that became hot in the parent but weren't rebuilt yet stay at
+        tier one in the child.
+        """
+        self._queue = queue.Queue()
+        self._thread = None
+        self._threadLock = threading.Lock()
+
+    def _ensureThread(self):
+        with self._threadLock:
+            if self._thread is None:
+                self._thread = threading.Thread(target=self._run, name="typed_python tier-up", daemon=True)
+                self._thread.start()
+
+    def _run(self):
+        while True:
+            request = self._queue.get()
+
+            try:
+                self._tierUp(*request)
+            except Exception:
+                # the tier-one code keeps working, so this isn't fatal
+                logging.exception("Failed to build an optimized version of %s", request[1])
+            finally:
+                self._queue.task_done()
+
+    def _tierUp(self, overload, linkName, returnType, argumentTypes):
+        moduleDefinition = self.llvmCompiler.tierOneModuleFor(linkName)
+
+        if moduleDefinition not in self._optimizedModules:
+            objectBytes = self.llvmCompiler.compileOptimizedModule(moduleDefinition)
+
+            with self.lock:
+                if moduleDefinition not in self._optimizedModules:
+                    self._optimizedModules[moduleDefinition] = self.llvmCompiler.loadOptimizedModule(
+                        moduleDefinition,
+                        objectBytes
+                    )
+                    self.modulesOptimized += 1
+
+        with self.lock:
+            overload._installNativePointer(
+                self._optimizedModules[moduleDefinition].functionPointers[linkName].fp,
+                returnType,
+                argumentTypes
+            )
+            self.entrypointsReplaced += 1
@@ -0,0 +1,259 @@
+#   Copyright 2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import hashlib
+import os
+import sys
+import types
+import uuid
+
+from typed_python import _types
+from typed_python.hash import Hash
+from typed_python.SerializationContext import SerializationContext
+
+
+# the name of the directory inside the compiler cache where we keep our files.
+# It's not 40 characters long, so the CompilerCache won't mistake it for a module.
+TYPE_GROUP_DIR = "type_group_hashes"
+
+
+class TypeGroupHashCache:
+    """A persistent cache of identity hashes for module-level functions and classes.
+
+    Computing the identity hash of an object requires building the
+    MutuallyRecursiveTypeGroup of every object the compiler can see from it, and then
+    hashing all of them. For a large codebase this is most of the cost of warming up
+    the compiler, and it's the same every time the process starts, as long as the code
+    hasn't changed.
+
+    We store the identity hash of each named module-level object we're asked about,
+    keyed on the source hash of the module it's defined in. Alongside each hash we
+    record the source hashes of every module whose objects were reachable from it at
+    the time we computed it. On a later start, if every one of those modules still has
+    the same source, the stored hash is still correct, and we can return it without
+    walking the object graph. This assumes a module's contents are determined by its
+    source, which is the same assumption the compiler cache makes about module-level
+    values it can see.
+
+    Each module gets its own file, named by module and source hash, which we write
+    under a tempname and then rename so that concurrent processes never see a partial
+    file. If two writers race on the same file, one of them loses its new entries,
+    which just means a cache miss next time.
+    """
+    def __init__(self, cacheDir):
+        self.cacheDir = os.path.join(cacheDir, TYPE_GROUP_DIR)
+
+        if not os.path.exists(self.cacheDir):
+            try:
+                os.makedirs(self.cacheDir)
+            except IOError:
+                pass
+
+        # module name -> source hash (or None if we can't hash it)
+        self._moduleSourceHashes = {}
+
+        # (module name, source hash) -> {qualname: (identityHashBytes, {moduleName: sourceHash})}
+        self._entries = {}
+
+        # id(obj) -> set of module names reachable from obj, for objects we've
+        # already walked in this process
+        self._reachableModules = {}
+
+        self.hits = 0
+        self.misses = 0
+
+    def identityHash(self, obj):
+        """Return the identity hash of 'obj' as bytes, using the cache if we can."""
+        located = self._locate(obj)
+
+        if located is None:
+            return _types.identityHash(obj)
+
+        moduleName, qualname, sourceHash = located
+
+        entries = self._entriesFor(moduleName, sourceHash)
+
+        if qualname in entries:
+            identityHash, dependencies = entries[qualname]
+
+            if all(self.moduleSourceHash(m) == h for m, h in dependencies.items()):
+                self.hits += 1
+                return identityHash
+
+        self.misses += 1
+
+        identityHash = _types.identityHash(obj)
+
+        if Hash(identityHash).isPoison():
+            return identityHash
+
+        dependencies = {}
+        for m in self._modulesReachableFrom(obj):
+            h = self.moduleSourceHash(m)
+
+            if h is None:
+                # we can't tell whether this module changes, so we can't cache
+                return identityHash
+
+            dependencies[m] = h
+
+        entries[qualname] = (identityHash, dependencies)
+
+        self._writeEntries(moduleName, sourceHash, entries)
+
+        return identityHash
+
+    def moduleSourceHash(self, moduleName):
+        """Return a hex string hashing the source of the module, or None."""
+        if moduleName not in self._moduleSourceHashes:
+            self._moduleSourceHashes[moduleName] = self._computeModuleSourceHash(moduleName)
+
+        return self._moduleSourceHashes[moduleName]
+
+    @staticmethod
+    def _computeModuleSourceHash(moduleName):
+        module = sys.modules.get(moduleName)
+
+        if module is None:
+            return None
+
+        if moduleName in sys.builtin_module_names:
+            return "builtin"
+
+        filename = getattr(module, "__file__", None)
+
+        if not filename or not os.path.isfile(filename):
+            return None
+
+        # the way we hash depends on typed_python itself, so fold in our own binary
+        hasher = hashlib.sha1()
+
+        st = os.stat(_types.__file__)
+        hasher.update(f"{st.st_size}:{st.st_mtime_ns}".encode("utf8"))
+
+        if filename.endswith(".py"):
+            with open(filename, "rb") as f:
+                hasher.update(f.read())
+        else:
+            # extension modules can be large, so use the file stamp instead
+            st = os.stat(filename)
+            hasher.update(f"{filename}:{st.st_size}:{st.st_mtime_ns}".encode("utf8"))
+
+        return hasher.hexdigest()
+
+    def _locate(self, obj):
+        """Determine (moduleName, qualname, sourceHash) for a cacheable object, or None.
+
+        We only cache objects that can be found again by name: functions and classes
+        (python or typed_python) that are bound to their own name at module level.
+        """
+        if not isinstance(obj, (type, types.FunctionType)):
+            return None
+
+        moduleName = getattr(obj, "__module__", None)
+        qualname = getattr(obj, "__qualname__", None)
+
+        if not isinstance(moduleName, str) or not isinstance(qualname, str):
+            return None
+
+        if "<" in qualname or "." in qualname:
+            return None
+
+        module = sys.modules.get(moduleName)
+
+        if module is None or getattr(module, qualname, None) is not obj:
+            return None
+
+        sourceHash = self.moduleSourceHash(moduleName)
+
+        if sourceHash is None:
+            return None
+
+        return moduleName, qualname, sourceHash
+
+    def _modulesReachableFrom(self, obj):
+        """Return the names of all modules whose objects the compiler can see from 'obj'."""
+        if id(obj) in self._reachableModules:
+            return self._reachableModules[id(obj)]
+
+        modules = set()
+        seen = set()
+        toCheck = [obj]
+
+        # hold references to everything we've seen so that ids stay unique
+        # for the duration of the walk
+        keepalive = []
+
+        while toCheck:
+            o = toCheck.pop()
+
+            if id(o) in seen:
+                continue
+
+            seen.add(id(o))
+            keepalive.append(o)
+
+            if o is not obj and id(o) in self._reachableModules:
+                modules.update(self._reachableModules[id(o)])
+                continue
+
+            if isinstance(o, types.ModuleType):
+                modules.add(o.__name__)
+            elif isinstance(o, (type, types.FunctionType)):
+                moduleName = getattr(o, "__module__", None)
+                if isinstance(moduleName, str):
+                    modules.add(moduleName)
+
+            toCheck.extend(_types.typesAndObjectsVisibleToCompilerFrom(o))
+
+        # only memoize by the root, which is a named module-level object and
+        # therefore stays alive as long as its module does
+        self._reachableModules[id(obj)] = modules
+
+        return modules
+
+    def _entriesPath(self, moduleName, sourceHash):
+        return os.path.join(self.cacheDir, moduleName + "." + sourceHash + ".dat")
+
+    def _entriesFor(self, moduleName, sourceHash):
+        key = (moduleName, sourceHash)
+
+        if key not in self._entries:
+            entries = {}
+
+            try:
+                with open(self._entriesPath(moduleName, sourceHash), "rb") as f:
+                    entries = SerializationContext().deserialize(f.read())
+            except FileNotFoundError:
+                pass
+            except Exception:
+                # a corrupt entry file is just a cache miss
+                entries = {}
+
+            self._entries[key] = entries
+
+        return self._entries[key]
+
+    def _writeEntries(self, moduleName, sourceHash, entries):
+        path = self._entriesPath(moduleName, sourceHash)
+        tempPath = path + "_" + str(uuid.uuid4())
+
+        try:
+            with open(tempPath, "wb") as f:
+                f.write(SerializationContext().serialize(entries))
+
+            os.rename(tempPath, path)
+        except IOError:
+            if os.path.exists(tempPath):
+                os.remove(tempPath)
@@ -46,6 +46,15 @@ class AllWrapper(Wrapper):
     def convert_call(self, context, expr, args, kwargs):
         return context.call_py_function(all, args, kwargs)
 
+    def convert_call_on_container_expression(self, context, inst, argExpr):
+        if argExpr.matches.GeneratorExp:
+            # run the generator's loops directly, stopping at the first falsy element
+            from typed_python.compiler.function_conversion_context import AllComprehensionConversionContext
+
+            return context.convert_generator_as_reduction(argExpr, AllComprehensionConversionContext, bool)
+
+        return super().convert_call_on_container_expression(context, inst, argExpr)
+
 
 class AnyWrapper(Wrapper):
     is_pod = True
@@ -59,4 +68,13 @@ class AnyWrapper(Wrapper):
         return native_ast.Type.Void()
 
     def convert_call(self, context, expr, args, kwargs):
-        return context.call_py_function(all, args, kwargs)
+        return context.call_py_function(any, args, kwargs)
+
+    def convert_call_on_container_expression(self, context, inst, argExpr):
+        if argExpr.matches.GeneratorExp:
+            # run the generator's loops directly, stopping at the first truthy element
+            from typed_python.compiler.function_conversion_context import AnyComprehensionConversionContext
+
+            return context.convert_generator_as_reduction(argExpr, AnyComprehensionConversionContext, bool)
+
+        return super().convert_call_on_container_expression(context, inst, argExpr)
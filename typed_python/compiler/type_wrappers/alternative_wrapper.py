@@ -37,11 +37,15 @@ def makeAlternativeWrapper(t):
     if t.__typed_python_category__ == "ConcreteAlternative":
         if _types.all_alternatives_empty(t):
             return ConcreteSimpleAlternativeWrapper(t)
+        elif _types.alternative_is_inline(t):
+            return ConcreteInlineAlternativeWrapper(t)
         else:
             return ConcreteAlternativeWrapper(t)
 
     if _types.all_alternatives_empty(t):
         return SimpleAlternativeWrapper(t)
+    elif _types.alternative_is_inline(t):
+        return InlineAlternativeWrapper(t)
     else:
         return AlternativeWrapper(t)
 
@@ -268,18 +272,15 @@ class ConcreteSimpleAlternativeWrapper(AlternativeWrapperMixin, Wrapper):
         return super().convert_to_self_with_target(context, targetVal, sourceVal, level, mayThrowOnFailure)
 
 
-class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
-    is_pod = False
-    is_empty = False
-    is_pass_by_ref = True
+class AlternativeWithDataWrapperMixin(AlternativeWrapperMixin):
+    """Common code for alternatives whose subtypes hold data.
 
+    Subclasses say where the data lives by implementing 'whichExpr' and 'refAs'.
+    """
     def __init__(self, t):
         super().__init__(t)
 
-        element_types = [('refcount', native_ast.Int64), ('which', native_ast.Int64), ('data', native_ast.UInt8)]
-
         self.alternativeType = t
-        self.layoutType = native_ast.Type.Struct(element_types=element_types, name=t.__qualname__+"Layout").pointer()
         self.matcherType = typeWrapper(_types.AlternativeMatcher(self.typeRepresentation))
         self._alternatives = None
 
@@ -296,6 +297,14 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
     def getNativeLayoutType(self):
         return self.layoutType
 
+    def whichExpr(self, context, instance):
+        """Return a native expression for the index of the alternative 'instance' holds."""
+        raise NotImplementedError(self)
+
+    def refAs(self, context, instance, whichIx):
+        """Return a reference to the data of 'instance', assuming it holds alternative 'whichIx'."""
+        raise NotImplementedError(self)
+
     def convert_default_initialize(self, context, instance):
         defaultType = self.alternativeType.__typed_python_alternatives__[0]
 
@@ -304,34 +313,6 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
             instance.changeType(defaultType)
         )
 
-    def on_refcount_zero(self, context, instance):
-        return (
-            context.converter.defineNativeFunction(
-                "destructor_" + str(self.typeRepresentation),
-                ('destructor', self),
-                [self],
-                typeWrapper(type(None)),
-                self.generateNativeDestructorFunction
-            )
-            .call(instance)
-        )
-
-    def refAs(self, context, instance, whichIx):
-        return context.pushReference(
-            self.alternatives[whichIx].typeRepresentation,
-            instance.nonref_expr.ElementPtrIntegers(0, 2).cast(self.alternatives[whichIx].getNativeLayoutType().pointer())
-        )
-
-    def generateNativeDestructorFunction(self, context, out, instance):
-        with context.switch(instance.nonref_expr.ElementPtrIntegers(0, 1).load(),
-                            range(len(self.alternatives)),
-                            False) as indicesAndContexts:
-            for ix, subcontext in indicesAndContexts:
-                with subcontext:
-                    self.refAs(context, instance, ix).convert_destroy()
-
-        context.pushEffect(runtime_functions.free.call(instance.nonref_expr.cast(native_ast.UInt8Ptr)))
-
     def convert_attribute(self, context, instance, attribute, nocheck=False):
         if attribute == 'matches':
             return instance.changeType(self.matcherType)
@@ -357,7 +338,7 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
             return super().convert_attribute(context, instance, attribute)
 
         if len(validIndices) == 1:
-            with context.ifelse(instance.nonref_expr.ElementPtrIntegers(0, 1).load().neq(validIndices[0])) as (then, otherwise):
+            with context.ifelse(self.whichExpr(context, instance).neq(validIndices[0])) as (then, otherwise):
                 with then:
                     context.pushException(AttributeError, "Object has no attribute '%s'" % attribute)
             return self.refAs(context, instance, validIndices[0]).convert_attribute(attribute)
@@ -386,7 +367,7 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
                 )
 
     def generateNativeGetattr(self, context, outputType, validIndices, out, instance, attr):
-        which = instance.nonref_expr.ElementPtrIntegers(0, 1).load()
+        which = self.whichExpr(context, instance)
         for ix in validIndices:
             with context.ifelse(which.eq(ix)) as (ifTrue, ifFalse):
                 with ifTrue:
@@ -407,7 +388,7 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
 
         if index == -1:
             return context.constant(False)
-        return context.pushPod(bool, instance.nonref_expr.ElementPtrIntegers(0, 1).load().eq(index))
+        return context.pushPod(bool, self.whichExpr(context, instance).eq(index))
 
     def convert_type_call(self, context, typeInst, args, kwargs):
         if len(args) == 0 and not kwargs:
@@ -421,7 +402,7 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
         assert out is None
 
         with context.switch(
-            instance.nonref_expr.ElementPtrIntegers(0, 1).load(),
+            self.whichExpr(context, instance),
             list(range(len(alternatives))),
             False
         ) as indicesAndContexts:
@@ -435,7 +416,8 @@ class AlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
                     )
 
 
-class ConcreteAlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
+class AlternativeWrapper(AlternativeWithDataWrapperMixin, RefcountedWrapper):
+    """Wrapper around alternatives held as a pointer to a refcounted layout."""
     is_pod = False
     is_empty = False
     is_pass_by_ref = True
@@ -445,33 +427,98 @@ class ConcreteAlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
 
         element_types = [('refcount', native_ast.Int64), ('which', native_ast.Int64), ('data', native_ast.UInt8)]
 
+        self.layoutType = native_ast.Type.Struct(element_types=element_types, name=t.__qualname__+"Layout").pointer()
+
+    def whichExpr(self, context, instance):
+        return instance.nonref_expr.ElementPtrIntegers(0, 1).load()
+
+    def on_refcount_zero(self, context, instance):
+        return (
+            context.converter.defineNativeFunction(
+                "destructor_" + str(self.typeRepresentation),
+                ('destructor', self),
+                [self],
+                typeWrapper(type(None)),
+                self.generateNativeDestructorFunction
+            )
+            .call(instance)
+        )
+
+    def refAs(self, context, instance, whichIx):
+        return context.pushReference(
+            self.alternatives[whichIx].typeRepresentation,
+            instance.nonref_expr.ElementPtrIntegers(0, 2).cast(self.alternatives[whichIx].getNativeLayoutType().pointer())
+        )
+
+    def generateNativeDestructorFunction(self, context, out, instance):
+        with context.switch(self.whichExpr(context, instance),
+                            range(len(self.alternatives)),
+                            False) as indicesAndContexts:
+            for ix, subcontext in indicesAndContexts:
+                with subcontext:
+                    self.refAs(context, instance, ix).convert_destroy()
+
+        context.pushEffect(runtime_functions.free.call(instance.nonref_expr.cast(native_ast.UInt8Ptr)))
+
+
+class InlineAlternativeWrapper(AlternativeWithDataWrapperMixin, Wrapper):
+    """Wrapper around alternatives stored inline, as an index byte followed by POD data."""
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = True
+
+    def __init__(self, t):
+        super().__init__(t)
+
+        self.layoutType = native_ast.Type.Array(element_type=native_ast.UInt8, count=_types.bytecount(t))
+
+    def whichExpr(self, context, instance):
+        if not instance.isReference:
+            instance = context.pushMove(instance)
+
+        return instance.expr.cast(native_ast.UInt8Ptr).load().cast(native_ast.Int64)
+
+    def refAs(self, context, instance, whichIx):
+        if not instance.isReference:
+            instance = context.pushMove(instance)
+
+        return context.pushReference(
+            self.alternatives[whichIx].typeRepresentation,
+            instance.expr.cast(native_ast.UInt8Ptr)
+                .ElementPtrIntegers(1)
+                .cast(self.alternatives[whichIx].getNativeLayoutType().pointer())
+        )
+
+
+class ConcreteAlternativeWithDataWrapperMixin(AlternativeWrapperMixin):
+    """Common code for specific alternatives whose subtypes hold data.
+
+    Subclasses say where the data lives by implementing 'refToInner' and
+    'generateConstructor'.
+    """
+    def __init__(self, t):
+        super().__init__(t)
+
         self.alternativeType = t.Alternative
         self.indexInParent = t.Index
         self.underlyingLayout = typeWrapper(t.ElementType)  # a NamedTuple
         self.matcherType = typeWrapper(_types.AlternativeMatcher(self.typeRepresentation))
-        self.layoutType = native_ast.Type.Struct(element_types=element_types, name=t.__qualname__+"Layout").pointer()
-
-    def convert_default_initialize(self, context, instance):
-        self.generateConstructor(
-            instance.context,
-            instance
-        )
 
     def getNativeLayoutType(self):
         return self.layoutType
 
-    def on_refcount_zero(self, context, instance):
-        altWrapper = typeWrapper(self.alternativeType)
+    def refToInner(self, context, instance):
+        """Return a reference to the NamedTuple holding the data of 'instance'."""
+        raise NotImplementedError(self)
 
-        return altWrapper.on_refcount_zero(
-            context,
-            instance.changeType(altWrapper)
-        )
+    def generateConstructor(self, context, out, *args):
+        """Initialize 'out' as an instance of this alternative, with data 'args'."""
+        raise NotImplementedError(self)
 
-    def refToInner(self, context, instance):
-        return context.pushReference(
-            self.underlyingLayout,
-            instance.nonref_expr.ElementPtrIntegers(0, 2).cast(self.underlyingLayout.getNativeLayoutType().pointer())
+    def convert_default_initialize(self, context, instance):
+        self.generateConstructor(
+            instance.context,
+            instance
         )
 
     def convert_to_type_with_target(self, context, instance, targetVal, conversionLevel, mayThrowOnFailure=False):
@@ -535,18 +582,6 @@ class ConcreteAlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
                 ).call(new_alt, *[kwargs[eltName] for eltName in tupletype.ElementNames])
         ).changeType(typeWrapper(self.alternativeType))
 
-    def generateConstructor(self, context, out, *args):
-        context.pushEffect(
-            out.expr.store(
-                runtime_functions.malloc.call(native_ast.const_int_expr(16 + self.underlyingLayout.getBytecount()))
-                    .cast(self.getNativeLayoutType())
-            ) >>
-            out.expr.load().ElementPtrIntegers(0, 0).store(native_ast.const_int_expr(1)) >>  # refcount
-            out.expr.load().ElementPtrIntegers(0, 1).store(native_ast.const_int_expr(self.indexInParent))  # which
-        )
-
-        self.refToInner(context, out).convert_initialize_from_args(*args)
-
     def convert_attribute(self, context, instance, attribute, nocheck=False):
         if attribute == 'matches':
             return instance.changeType(self.matcherType)
@@ -574,7 +609,7 @@ class ConcreteAlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
 
     def convert_to_self_with_target(self, context, targetVal, sourceVal, level: ConversionLevel, mayThrowOnFailure=False):
         if sourceVal.expr_type.typeRepresentation == self.alternativeType:
-            matches = sourceVal.nonref_expr.ElementPtrIntegers(0, 1).load().eq(self.typeRepresentation.Index)
+            matches = sourceVal.expr_type.whichExpr(context, sourceVal).eq(self.typeRepresentation.Index)
 
             with context.ifelse(matches) as (ifTrue, ifFalse):
                 with ifTrue:
@@ -587,6 +622,74 @@ class ConcreteAlternativeWrapper(AlternativeWrapperMixin, RefcountedWrapper):
         return super().convert_to_self_with_target(context, targetVal, sourceVal, level, mayThrowOnFailure)
 
 
+class ConcreteAlternativeWrapper(ConcreteAlternativeWithDataWrapperMixin, RefcountedWrapper):
+    """Wrapper around a specific alternative held as a pointer to a refcounted layout."""
+    is_pod = False
+    is_empty = False
+    is_pass_by_ref = True
+
+    def __init__(self, t):
+        super().__init__(t)
+
+        element_types = [('refcount', native_ast.Int64), ('which', native_ast.Int64), ('data', native_ast.UInt8)]
+
+        self.layoutType = native_ast.Type.Struct(element_types=element_types, name=t.__qualname__+"Layout").pointer()
+
+    def on_refcount_zero(self, context, instance):
+        altWrapper = typeWrapper(self.alternativeType)
+
+        return altWrapper.on_refcount_zero(
+            context,
+            instance.changeType(altWrapper)
+        )
+
+    def refToInner(self, context, instance):
+        return context.pushReference(
+            self.underlyingLayout,
+            instance.nonref_expr.ElementPtrIntegers(0, 2).cast(self.underlyingLayout.getNativeLayoutType().pointer())
+        )
+
+    def generateConstructor(self, context, out, *args):
+        context.pushEffect(
+            out.expr.store(
+                runtime_functions.malloc.call(native_ast.const_int_expr(16 + self.underlyingLayout.getBytecount()))
+                    .cast(self.getNativeLayoutType())
+            ) >>
+            out.expr.load().ElementPtrIntegers(0, 0).store(native_ast.const_int_expr(1)) >>  # refcount
+            out.expr.load().ElementPtrIntegers(0, 1).store(native_ast.const_int_expr(self.indexInParent))  # which
+        )
+
+        self.refToInner(context, out).convert_initialize_from_args(*args)
+
+
+class ConcreteInlineAlternativeWrapper(ConcreteAlternativeWithDataWrapperMixin, Wrapper):
+    """Wrapper around a specific alternative stored inline, as an index byte followed by POD data."""
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = True
+
+    def __init__(self, t):
+        super().__init__(t)
+
+        self.layoutType = native_ast.Type.Array(element_type=native_ast.UInt8, count=_types.bytecount(t))
+
+    def refToInner(self, context, instance):
+        if not instance.isReference:
+            instance = context.pushMove(instance)
+
+        return context.pushReference(
+            self.underlyingLayout,
+            instance.expr.cast(native_ast.UInt8Ptr)
+                .ElementPtrIntegers(1)
+                .cast(self.underlyingLayout.getNativeLayoutType().pointer())
+        )
+
+    def generateConstructor(self, context, out, *args):
+        context.pushEffect(
+            out.expr.cast(native_ast.UInt8Ptr).store(native_ast.const_uint8_expr(self.indexInParent))  # which
+        )
+
+        self.refToInner(context, out).convert_initialize_from_args(*args)
 class AlternativeMatcherWrapper(Wrapper):
     def __init__(self, t):
         super().__init__(t)
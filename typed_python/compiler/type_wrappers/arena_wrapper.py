@@ -0,0 +1,64 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python.compiler.type_wrappers.wrapper import Wrapper
+from typed_python.compiler.conversion_level import ConversionLevel
+import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
+from typed_python._types import pushArena, popArena, arenaDepth
+
+
+class ArenaFunctionWrapper(Wrapper):
+    """Compiled versions of _types.pushArena, popArena, and arenaDepth."""
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    SUPPORTED_FUNCTIONS = (pushArena, popArena, arenaDepth)
+
+    def __init__(self, f):
+        assert f in self.SUPPORTED_FUNCTIONS
+        super().__init__(f)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def convert_call(self, context, expr, args, kwargs):
+        f = self.typeRepresentation
+
+        if f is pushArena:
+            if len(args) + len(kwargs) == 1 and set(kwargs) <= {'bytes'}:
+                bytesArg = args[0] if args else kwargs['bytes']
+                bytesArg = bytesArg.convert_to_type(int, ConversionLevel.Implicit)
+                if bytesArg is None:
+                    return None
+
+                with context.ifelse(bytesArg.nonref_expr.lte(0)) as (ifTrue, ifFalse):
+                    with ifTrue:
+                        context.pushException(ValueError, "pushArena requires a positive bytecount")
+
+                context.pushEffect(runtime_functions.tp_push_arena.call(bytesArg.nonref_expr))
+                return context.constant(None)
+
+        if f is popArena and not args and not kwargs:
+            with context.ifelse(runtime_functions.tp_pop_arena.call()) as (ifTrue, ifFalse):
+                with ifFalse:
+                    context.pushException(RuntimeError, "popArena called with no active arena")
+
+            return context.constant(None)
+
+        if f is arenaDepth and not args and not kwargs:
+            return context.pushPod(int, runtime_functions.tp_arena_depth.call())
+
+        return super().convert_call(context, expr, args, kwargs)
@@ -14,6 +14,7 @@
 
 import typed_python.python_ast as python_ast
 from typed_python.compiler.conversion_level import ConversionLevel
+from typed_python.compiler.arithmetic_options import llvmFlagsFor
 from typed_python.type_promotion import computeArithmeticBinaryResultType, bitness, signedness, floatness, isSignedInt
 from typed_python import _types
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
@@ -57,6 +58,37 @@ pyCompOp = {
     python_ast.ComparisonOp.GtE(): native_ast.BinaryOp.GtE()
 }
 
+# the operators the function's ArithmeticOptions can loosen
+pyOpsWithLlvmFlags = {
+    python_ast.BinaryOp.Add(),
+    python_ast.BinaryOp.Sub(),
+    python_ast.BinaryOp.Mult(),
+    python_ast.BinaryOp.Div()
+}
+
+
+def arithmeticBinop(context, left, op, right):
+    """Apply python operator 'op' to two values of the same arithmetic type, as a native Binop.
+
+    If the function we're converting opted into looser arithmetic semantics (see
+    arithmetic_options.py), the Binop asks llvm for the matching instruction flags.
+    """
+    binop = native_ast.Expression.Binop(
+        left=left.nonref_expr,
+        right=right.nonref_expr,
+        op=pyOpToNative[op]
+    )
+
+    if op not in pyOpsWithLlvmFlags:
+        return binop
+
+    T = left.expr_type.typeRepresentation
+
+    return native_ast.withLlvmFlags(
+        binop,
+        llvmFlagsFor(context.functionContext.arithmeticOptions, floatness(T), isSignedInt(T))
+    )
+
 
 class ArithmeticTypeWrapper(Wrapper):
     is_pod = True
@@ -359,6 +391,25 @@ class IntWrapper(ArithmeticTypeWrapper):
             if op.matches.FloorDiv and not inplace:
                 return context.constant(left.constantValue // right.constantValue)
 
+        if (
+            left.isConstant and right.isConstant
+            and type(left.constantValue) in (bool, int, float) and type(right.constantValue) in (bool, int, float)
+        ):
+            # fold comparisons of constants (like an argument we specialized on) so
+            # that the branches they gate disappear during conversion
+            if op.matches.Eq:
+                return context.constant(left.constantValue == right.constantValue)
+            if op.matches.NotEq:
+                return context.constant(left.constantValue != right.constantValue)
+            if op.matches.Lt:
+                return context.constant(left.constantValue < right.constantValue)
+            if op.matches.LtE:
+                return context.constant(left.constantValue <= right.constantValue)
+            if op.matches.Gt:
+                return context.constant(left.constantValue > right.constantValue)
+            if op.matches.GtE:
+                return context.constant(left.constantValue >= right.constantValue)
+
         if op.matches.Div and isinstance(right.expr_type, ArithmeticTypeWrapper):
             T = toWrapper(
                 computeArithmeticBinaryResultType(
@@ -481,14 +532,7 @@ class IntWrapper(ArithmeticTypeWrapper):
                 )
             )
         if op in pyOpToNative:
-            return context.pushPod(
-                self,
-                native_ast.Expression.Binop(
-                    left=left.nonref_expr,
-                    right=right.nonref_expr,
-                    op=pyOpToNative[op]
-                )
-            )
+            return context.pushPod(self, arithmeticBinop(context, left, op, right))
         if op in pyCompOp:
             return context.pushPod(
                 bool,
@@ -816,14 +860,7 @@ class FloatWrapper(ArithmeticTypeWrapper):
                 with ifFalse:
                     context.pushException(ZeroDivisionError, "division by zero")
 
-            return context.pushPod(
-                self,
-                native_ast.Expression.Binop(
-                    left=left.nonref_expr,
-                    right=right.nonref_expr,
-                    op=pyOpToNative[op]
-                )
-            )
+            return context.pushPod(self, arithmeticBinop(context, left, op, right))
 
         if op.matches.Pow:
             return context.pushPod(
@@ -837,14 +874,7 @@ class FloatWrapper(ArithmeticTypeWrapper):
             ).convert_to_type(self, ConversionLevel.Implicit)
 
         if op in pyOpToNative and op not in pyOpNotForFloat:
-            return context.pushPod(
-                self,
-                native_ast.Expression.Binop(
-                    left=left.nonref_expr,
-                    right=right.nonref_expr,
-                    op=pyOpToNative[op]
-                )
-            )
+            return context.pushPod(self, arithmeticBinop(context, left, op, right))
 
         if op in pyCompOp:
             return context.pushPod(
@@ -12,7 +12,10 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import re
+import struct
 import sys
+
 from typed_python import sha_hash
 from typed_python.compiler.global_variable_definition import GlobalVariableMetadata
 from typed_python.compiler.conversion_level import ConversionLevel
@@ -22,9 +25,10 @@ from typed_python.compiler.type_wrappers.bound_method_wrapper import BoundMethod
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 from typed_python.compiler.type_wrappers.typed_list_masquerading_as_list_wrapper import TypedListMasqueradingAsList
 
-from typed_python import UInt8, Int32, ListOf, Tuple, TupleOf, Dict, Set, ConstDict
+from typed_python import UInt8, Int32, UInt64, Float32, ListOf, Tuple, TupleOf, Dict, Set, ConstDict
 from typed_python import Class, Final, Member, pointerTo, PointerTo
 from typed_python.type_promotion import isInteger
+from typed_python._types import bufferFind, bufferRFind, bufferCount
 
 import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler
@@ -80,65 +84,6 @@ def bytesJoinIterable(sep, iterable):
     return sep.join(items)
 
 
-IS_38_OR_LOWER = sys.version_info.minor <= 8
-
-
-def bytes_replace(x: bytes, old: bytes, new: bytes, maxCount: int) -> bytes:
-    """Given a bytes object, replaces old subsequence with new subsequence at most maxCount times.
-
-    Compiling bytes.replace compiles this function.
-    This function is only intended to be executed in this compiled form.
-
-    Args:
-        x: A bytes object to operate on.
-        old: The subsequence of bytes to search for.
-        new: The replacement value for each found subsequence.
-        maxCount: Replaces at most maxCount occurrences. Use -1 to indicate no limit.
-
-    Returns:
-        Adjusted bytes object with replacement(s).
-    """
-    if IS_38_OR_LOWER:
-        # versions 3.8 and lower have a bug where b''.replace(b'', b'SOMETHING', 1) returns
-        # the empty string.
-        if maxCount == 0 or (maxCount >= 0 and len(x) == 0 and len(old) == 0):
-            return x
-    else:
-        if maxCount == 0:
-            return x
-
-        if maxCount >= 0 and len(x) == 0 and len(old) == 0:
-            return new
-
-    accumulator = ListOf(bytes)()
-
-    pos = 0
-    seen = 0
-    inc = 0 if len(old) else 1
-    if len(old) == 0:
-        accumulator.append(b'')
-        seen += 1
-
-    while True:
-        if maxCount >= 0 and seen >= maxCount:
-            nextLoc = -1
-        else:
-            nextLoc = x.find(old, pos)
-
-        if nextLoc >= 0 and nextLoc < len(x):
-            accumulator.append(x[pos:nextLoc + inc])
-
-            if len(old):
-                pos = nextLoc + len(old)
-            else:
-                pos += 1
-
-            seen += 1
-        else:
-            accumulator.append(x[pos:])
-            return new.join(accumulator)
-
-
 def bytes_isalnum(x: bytes) -> bool:
     """Checks if given bytes object contains only alphanumeric elements.
 
@@ -1244,6 +1189,15 @@ class BytesWrapper(RefcountedWrapper):
         rindex=(bytes_rindex, bytes_rindex_single),
     )
 
+    # the same methods, when 'sub' is a bytes object
+    _native_find_methods = dict(
+        count=runtime_functions.bytes_count,
+        find=runtime_functions.bytes_find,
+        rfind=runtime_functions.bytes_rfind,
+        index=runtime_functions.bytes_find,
+        rindex=runtime_functions.bytes_rfind,
+    )
+
     # bytes methods that map to c++ functions
     _bytes_methods = dict(
         lower=runtime_functions.bytes_lower,
@@ -1283,6 +1237,33 @@ class BytesWrapper(RefcountedWrapper):
 
         return super().convert_attribute(context, instance, attr)
 
+    def convert_native_find(self, context, instance, methodname, sub, start, end):
+        """Search for a bytes 'sub' using the runtime's vectorized search."""
+        start = start.convert_to_type(int, ConversionLevel.Signature)
+        end = end.convert_to_type(int, ConversionLevel.Signature)
+
+        if start is None or end is None:
+            return None
+
+        native_f = self._native_find_methods[methodname]
+
+        res = context.pushPod(
+            int,
+            native_f.call(
+                instance.nonref_expr.cast(VoidPtr),
+                sub.nonref_expr.cast(VoidPtr),
+                start.nonref_expr,
+                end.nonref_expr
+            )
+        )
+
+        if methodname in ('index', 'rindex'):
+            with context.ifelse(res.nonref_expr.eq(-1)) as (ifNotFound, _):
+                with ifNotFound:
+                    context.pushException(ValueError, "subsection not found")
+
+        return res
+
     def has_intiter(self):
         """Does this type support the 'intiter' format?"""
         return True
@@ -1407,6 +1388,8 @@ class BytesWrapper(RefcountedWrapper):
 
             if isInteger(args[0].expr_type.typeRepresentation):
                 py_f = self._find_methods[methodname][1]
+            elif args[0].expr_type == self:
+                return self.convert_native_find(context, instance, methodname, args[0], start, end)
             else:
                 py_f = self._find_methods[methodname][0]
             return context.call_py_function(py_f, (instance, args[0], start, end), {})
@@ -1453,20 +1436,17 @@ class BytesWrapper(RefcountedWrapper):
                     )
                     return
 
-                arg2 = context.constant(-1) if len(args) == 2 else args[2]
-                return context.call_py_function(bytes_replace, (instance, args[0], args[1], arg2), {})
-                # code below is for experimenting with compiling to C++ call instead of compiled python.
-                # return context.push(
-                #     bytes,
-                #     lambda bytesRef: bytesRef.expr.store(
-                #         runtime_functions.bytes_replace.call(
-                #             instance.nonref_expr.cast(VoidPtr),
-                #             args[0].nonref_expr.cast(VoidPtr),
-                #             args[1].nonref_expr.cast(VoidPtr),
-                #             args[2].nonref_expr if len(args) == 3 else native_ast.const_int_expr(-1)
-                #         ).cast(self.layoutType)
-                #     )
-                # )
+                return context.push(
+                    bytes,
+                    lambda bytesRef: bytesRef.expr.store(
+                        runtime_functions.bytes_replace.call(
+                            instance.nonref_expr.cast(VoidPtr),
+                            args[0].nonref_expr.cast(VoidPtr),
+                            args[1].nonref_expr.cast(VoidPtr),
+                            args[2].nonref_expr if len(args) == 3 else native_ast.const_int_expr(-1)
+                        ).cast(self.layoutType)
+                    )
+                )
 
         if methodname == 'join' and not kwargs:
             if len(args) == 1:
@@ -1868,3 +1848,351 @@ class BytesMaketransWrapper(Wrapper):
             return args[0].convert_method_call("maketrans", (args[0], args[1]), {})
 
         return super().convert_call(context, expr, args, kwargs)
+
+
+class BufferSearchFunctionWrapper(Wrapper):
+    """Compiled versions of _types.bufferFind, bufferRFind, and bufferCount.
+
+    These run the same search as bytes.find and friends over memory we don't own,
+    identified by an integer address and size (see _types.bufferAddress).
+    """
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    SUPPORTED_FUNCTIONS = (bufferFind, bufferRFind, bufferCount)
+
+    def __init__(self, f):
+        assert f in self.SUPPORTED_FUNCTIONS
+        super().__init__(f)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def runtimeFunction(self):
+        if self.typeRepresentation is bufferFind:
+            return runtime_functions.buffer_find
+        if self.typeRepresentation is bufferRFind:
+            return runtime_functions.buffer_rfind
+        return runtime_functions.buffer_count
+
+    def convert_call(self, context, expr, args, kwargs):
+        if 3 <= len(args) <= 5 and not kwargs:
+            address = args[0].convert_to_type(int, ConversionLevel.Signature)
+            size = args[1].convert_to_type(int, ConversionLevel.Signature)
+            sub = args[2].convert_to_type(bytes, ConversionLevel.Signature)
+
+            if address is None or size is None or sub is None:
+                return None
+
+            start = args[3].convert_to_type(int, ConversionLevel.Signature) if len(args) > 3 else context.constant(0)
+            end = args[4].convert_to_type(int, ConversionLevel.Signature) if len(args) > 4 else size
+
+            if start is None or end is None:
+                return None
+
+            return context.pushPod(
+                int,
+                self.runtimeFunction().call(
+                    address.nonref_expr.cast(native_ast.UInt8Ptr),
+                    size.nonref_expr,
+                    sub.nonref_expr.cast(VoidPtr),
+                    start.nonref_expr,
+                    end.nonref_expr
+                )
+            )
+
+        return super().convert_call(context, expr, args, kwargs)
+
+
+# for each integer struct code, whether it's signed
+_STRUCT_INT_CODES = dict(b=True, B=False, h=True, H=False, i=True, I=False, l=True, L=False,
+                         q=True, Q=False, n=True, N=False)
+
+_NATIVE_INT_TYPES = {
+    (1, True): native_ast.Int8, (1, False): native_ast.UInt8,
+    (2, True): native_ast.Int16, (2, False): native_ast.UInt16,
+    (4, True): native_ast.Int32, (4, False): native_ast.UInt32,
+    (8, True): native_ast.Int64, (8, False): native_ast.UInt64,
+}
+
+
+def parseStructFormat(fmt):
+    """Lay out a constant struct format, or return None if we can't compile it.
+
+    Returns:
+        (totalSize, swapBytes, items), where 'items' is a list of (code, offset, size),
+        one per value packed or unpacked. 's' items are a single value of 'size' bytes.
+    """
+    if isinstance(fmt, bytes):
+        try:
+            fmt = fmt.decode("ascii")
+        except UnicodeDecodeError:
+            return None
+
+    try:
+        totalSize = struct.calcsize(fmt)
+    except struct.error:
+        return None
+
+    order = fmt[0] if fmt and fmt[0] in "@=<>!" else "@"
+    body = fmt[1:] if fmt and fmt[0] in "@=<>!" else fmt
+
+    bigEndian = order in ">!" or (order in "@=" and sys.byteorder == "big")
+    swapBytes = bigEndian != (sys.byteorder == "big")
+
+    # the offset of each item is wherever calcsize says the format up to and
+    # including it ends, less its own size. That gets native alignment right.
+    items = []
+    prefix = order
+
+    for count, code in re.findall(r"(\d*)([a-zA-Z?])", body.replace(" ", "").replace("\t", "")):
+        count = int(count) if count else 1
+
+        if code in "ePp":
+            return None
+
+        if code == "x":
+            prefix += "%dx" % count
+        elif code == "s":
+            prefix += "%ds" % count
+            items.append((code, struct.calcsize(prefix) - count, count))
+        else:
+            size = struct.calcsize(order + code)
+
+            for _ in range(count):
+                prefix += code
+                items.append((code, struct.calcsize(prefix) - size, size))
+
+    assert struct.calcsize(prefix) == totalSize
+
+    return totalSize, swapBytes, items
+
+
+class StructFunctionWrapper(Wrapper):
+    """Compiled versions of struct.pack, unpack, unpack_from and calcsize.
+
+    When the format is a constant, we lay it out at compile time and unroll the
+    call into a load or store per value at a fixed offset, byteswapping values
+    whose byte order isn't native. Ints are range-checked the way struct.pack
+    checks them, except for 8-byte unsigned ones, which wrap. Anything else
+    (non-constant formats, 'e', 'p' and 'P' codes, buffers that aren't bytes)
+    goes through the interpreter.
+    """
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    SUPPORTED_FUNCTIONS = (struct.pack, struct.unpack, struct.unpack_from, struct.calcsize)
+
+    def __init__(self, f):
+        assert f in self.SUPPORTED_FUNCTIONS
+        super().__init__(f)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def convert_call(self, context, expr, args, kwargs):
+        layout = parseStructFormat(args[0].constantValue) if args and not kwargs and args[0].isConstant else None
+
+        if layout is None:
+            return super().convert_call(context, expr, args, kwargs)
+
+        totalSize, swapBytes, items = layout
+        f = self.typeRepresentation
+
+        if f is struct.calcsize and len(args) == 1:
+            return context.constant(totalSize)
+
+        if f is struct.pack and len(args) == len(items) + 1:
+            if all(self.canPack(code, arg.expr_type.typeRepresentation) for (code, _, _), arg in zip(items, args[1:])):
+                return self.convert_pack(context, totalSize, swapBytes, items, args[1:])
+
+        if f in (struct.unpack, struct.unpack_from) and len(args) in ((2,) if f is struct.unpack else (2, 3)):
+            buffer = args[1]
+
+            if buffer.expr_type.typeRepresentation is bytes:
+                offset = context.constant(0)
+
+                if len(args) == 3:
+                    offset = args[2].toIndex()
+
+                    if offset is None:
+                        return None
+
+                return self.convert_unpack(context, totalSize, swapBytes, items, buffer, offset, f is struct.unpack)
+
+        return super().convert_call(context, expr, args, kwargs)
+
+    @staticmethod
+    def canPack(code, T):
+        """Can we pack a T with 'code' without going through the interpreter?"""
+        if code in _STRUCT_INT_CODES:
+            return T is bool or isInteger(T)
+        if code in "fd":
+            return T in (bool, float, Float32) or isInteger(T)
+        if code == "?":
+            return True
+        return T is bytes
+
+    @staticmethod
+    def pushStructError(context, message):
+        context.pushException(struct.error, message)
+
+    def convert_pack(self, context, totalSize, swapBytes, items, args):
+        # convert all the values before we allocate, so nothing leaks if one fails
+        values = []
+
+        for (code, offset, size), arg in zip(items, args):
+            if code in _STRUCT_INT_CODES:
+                value = arg.convert_to_type(UInt64 if code in "QN" else int, ConversionLevel.Implicit)
+
+                if value is None:
+                    return None
+
+                if size < 8:
+                    signed = _STRUCT_INT_CODES[code]
+                    lo, hi = (-(1 << (size * 8 - 1)), (1 << (size * 8 - 1)) - 1) if signed else (0, (1 << (size * 8)) - 1)
+
+                    with context.ifelse(value.nonref_expr.lt(lo).bitor(value.nonref_expr.gt(hi))) as (true, false):
+                        with true:
+                            self.pushStructError(context, "'%s' format requires %s <= number <= %s" % (code, lo, hi))
+            elif code == "?":
+                value = arg.toBool()
+            elif code in "fd":
+                value = arg.convert_to_type(float, ConversionLevel.Implicit)
+            else:
+                value = arg.convert_to_type(bytes, ConversionLevel.Signature)
+
+                if value is not None and code == "c":
+                    with context.ifelse(value.convert_len().nonref_expr.neq(1)) as (true, false):
+                        with true:
+                            self.pushStructError(context, "char format requires a bytes object of length 1")
+
+            if value is None:
+                return None
+
+            values.append(value)
+
+        result = context.push(
+            bytes,
+            lambda bytesRef: bytesRef.expr.store(
+                runtime_functions.bytes_zeros.call(totalSize).cast(self.bytesLayoutType())
+            )
+        )
+
+        data = result.nonref_expr.ElementPtrIntegers(0, 3)
+
+        for (code, offset, size), value in zip(items, values):
+            target = data.elemPtr(offset)
+
+            if code in _STRUCT_INT_CODES:
+                nativeType = _NATIVE_INT_TYPES[size, _STRUCT_INT_CODES[code]]
+                nativeValue = value.nonref_expr.cast(nativeType)
+
+                if swapBytes and size > 1:
+                    nativeValue = runtime_functions.bswap[nativeType].call(nativeValue)
+
+                context.pushEffect(target.cast(nativeType.pointer()).store(nativeValue))
+            elif code == "?":
+                context.pushEffect(target.store(value.nonref_expr.cast(native_ast.UInt8)))
+            elif code in "fd":
+                floatType = native_ast.Float32 if code == "f" else native_ast.Float64
+                context.pushEffect(target.cast(floatType.pointer()).store(value.nonref_expr.cast(floatType)))
+
+                if swapBytes:
+                    intType = _NATIVE_INT_TYPES[size, False]
+                    intPtr = target.cast(intType.pointer())
+                    context.pushEffect(intPtr.store(runtime_functions.bswap[intType].call(intPtr.load())))
+            else:
+                # 's' truncates or zero-pads to its size
+                length = value.convert_len()
+
+                with context.ifelse(length.nonref_expr.gt(0)) as (true, false):
+                    with true:
+                        context.pushEffect(
+                            runtime_functions.memcpy.call(
+                                target,
+                                value.nonref_expr.ElementPtrIntegers(0, 3),
+                                native_ast.Expression.Branch(
+                                    cond=length.nonref_expr.lt(size),
+                                    true=length.nonref_expr,
+                                    false=native_ast.const_int_expr(size)
+                                )
+                            )
+                        )
+
+        return result
+
+    def convert_unpack(self, context, totalSize, swapBytes, items, buffer, offset, exactSize):
+        length = buffer.convert_len()
+
+        if exactSize:
+            with context.ifelse(length.nonref_expr.neq(totalSize)) as (true, false):
+                with true:
+                    self.pushStructError(context, "unpack requires a buffer of %s bytes" % totalSize)
+        else:
+            offset = context.pushPod(
+                int,
+                native_ast.Expression.Branch(
+                    cond=offset.nonref_expr.lt(0),
+                    true=offset.nonref_expr.add(length.nonref_expr),
+                    false=offset.nonref_expr
+                )
+            )
+
+            with context.ifelse(
+                offset.nonref_expr.lt(0).bitor(offset.nonref_expr.add(totalSize).gt(length.nonref_expr))
+            ) as (true, false):
+                with true:
+                    self.pushStructError(
+                        context, "unpack_from requires a buffer of at least %s bytes" % totalSize
+                    )
+
+        data = buffer.nonref_expr.ElementPtrIntegers(0, 3).elemPtr(offset.nonref_expr)
+
+        values = []
+
+        for code, itemOffset, size in items:
+            source = data.elemPtr(itemOffset)
+
+            if code in _STRUCT_INT_CODES:
+                nativeType = _NATIVE_INT_TYPES[size, _STRUCT_INT_CODES[code]]
+                nativeValue = source.cast(nativeType.pointer()).load()
+
+                if swapBytes and size > 1:
+                    nativeValue = runtime_functions.bswap[nativeType].call(nativeValue)
+
+                if size == 8 and not _STRUCT_INT_CODES[code]:
+                    values.append(context.pushPod(UInt64, nativeValue))
+                else:
+                    values.append(context.pushPod(int, nativeValue.cast(native_ast.Int64)))
+            elif code == "?":
+                values.append(context.pushPod(bool, source.load().neq(native_ast.const_uint8_expr(0))))
+            elif code in "fd":
+                floatType = native_ast.Float32 if code == "f" else native_ast.Float64
+
+                if swapBytes:
+                    intType = _NATIVE_INT_TYPES[size, False]
+                    swapped = context.pushStackSlot(intType)
+                    context.pushEffect(
+                        swapped.store(runtime_functions.bswap[intType].call(source.cast(intType.pointer()).load()))
+                    )
+                    source = swapped
+
+                values.append(context.pushPod(float, source.cast(floatType.pointer()).load().cast(native_ast.Float64)))
+            else:
+                values.append(
+                    context.push(
+                        bytes,
+                        lambda bytesRef, source=source, size=size: bytesRef.expr.store(
+                            runtime_functions.bytes_from_ptr_and_len.call(source, size).cast(self.bytesLayoutType())
+                        )
+                    )
+                )
+
+        return typeWrapper(Tuple(*[v.expr_type.typeRepresentation for v in values])).createFromArgs(context, values)
+
+    @staticmethod
+    def bytesLayoutType():
+        return typeWrapper(bytes).getNativeLayoutType()
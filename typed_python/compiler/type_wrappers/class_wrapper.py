@@ -32,6 +32,7 @@ from typed_python import (
     _types, PointerTo, Tuple, NamedTuple, bytecount, RefTo, SubclassOf,
     Class, Value, Alternative
 )
+from typed_python.internals import knownSubclassesOf
 
 import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler
@@ -78,6 +79,10 @@ vtable_type = native_ast.Type.Struct(
 
 _classCouldBeInstanceOfCache = {}
 
+# the most concrete classes a virtual method call will check for and call directly
+# before falling back to the vtable.
+MAX_SPECULATED_CLASSES = 4
+
 
 def classCouldBeInstanceOf(cls, other):
     """Determine whether an instance of cls could be an instance of other.
@@ -1150,28 +1155,6 @@ class ClassWrapper(ClassOrAlternativeWrapperMixin, RefcountedWrapper):
 
         kwargTupleType = NamedTuple(**{k: v.typeRepresentation for k, v in argAndKwargTypes[1].items()})
 
-        dispatchSlot = context.allocateClassMethodDispatchSlot(
-            self.typeRepresentation,
-            methodName,
-            retType,
-            argTupleType,
-            kwargTupleType
-        )
-
-        classDispatchTable = self.classDispatchTable(instance)
-
-        funcPtr = classDispatchTable.ElementPtrIntegers(0, 2).load().elemPtr(dispatchSlot).load()
-
-        with context.ifelse(funcPtr.cast(native_ast.Int64)) as (ifTrue, ifFalse):
-            with ifFalse:
-                # we have an empty slot. We need to compile it
-                context.pushEffect(
-                    runtime_functions.compileClassDispatch.call(
-                        classDispatchTable.cast(native_ast.VoidPtr),
-                        dispatchSlot
-                    )
-                )
-
         # we always pass the instance, regardless of whether this is a
         # regular method, classmethod or staticmethod call. Receiving code
         # can decide what to do with it. We don't have to worry about the case
@@ -1203,9 +1186,105 @@ class ClassWrapper(ClassOrAlternativeWrapperMixin, RefcountedWrapper):
             if convertedArgs[-1] is None:
                 return None
 
-        res = context.call_function_pointer(funcPtr, convertedArgs, typeWrapper(retType))
+        def callThroughVtable():
+            dispatchSlot = context.allocateClassMethodDispatchSlot(
+                self.typeRepresentation,
+                methodName,
+                retType,
+                argTupleType,
+                kwargTupleType
+            )
 
-        return res
+            classDispatchTable = self.classDispatchTable(instance)
+
+            funcPtr = classDispatchTable.ElementPtrIntegers(0, 2).load().elemPtr(dispatchSlot).load()
+
+            with context.ifelse(funcPtr.cast(native_ast.Int64)) as (ifTrue, ifFalse):
+                with ifFalse:
+                    # we have an empty slot. We need to compile it
+                    context.pushEffect(
+                        runtime_functions.compileClassDispatch.call(
+                            classDispatchTable.cast(native_ast.VoidPtr),
+                            dispatchSlot
+                        )
+                    )
+
+            return context.call_function_pointer(funcPtr, convertedArgs, typeWrapper(retType))
+
+        speculatedClasses = self.speculatedImplementingClasses() if matchesAsInstance else []
+
+        if not speculatedClasses:
+            return callThroughVtable()
+
+        # check the instance's concrete class against each class we expect to see,
+        # and call that class' implementation directly (so llvm can inline it) if it
+        # matches. The implementation is the same function the vtable would hold,
+        # so the only difference is how we find it.
+        output = context.allocateUninitializedSlot(retType)
+
+        def callDirectlyOrFallBack(classesToTry):
+            if not classesToTry:
+                res = callThroughVtable()
+            else:
+                with context.ifelse(self.isExactlyOfClassNativeExpr(context, instance, classesToTry[0])) as (ifTrue, ifFalse):
+                    with ifTrue:
+                        res = context.call_typed_call_target(
+                            ClassWrapper.compileVirtualMethodInstantiation(
+                                context.converter,
+                                self.typeRepresentation,
+                                classesToTry[0],
+                                methodName,
+                                retType,
+                                argTupleType,
+                                kwargTupleType
+                            ),
+                            [instance.changeType(typeWrapper(classesToTry[0]))] + convertedArgs[1:]
+                        )
+
+                        if res is not None:
+                            output.convert_copy_initialize(res)
+                            context.markUninitializedSlotInitialized(output)
+
+                    with ifFalse:
+                        callDirectlyOrFallBack(classesToTry[1:])
+
+                return
+
+            if res is not None:
+                output.convert_copy_initialize(res)
+                context.markUninitializedSlotInitialized(output)
+
+        callDirectlyOrFallBack(speculatedClasses)
+
+        return output
+
+    def speculatedImplementingClasses(self):
+        """Return the concrete classes we expect instances known as us to have.
+
+        Calls through the vtable can't be inlined, so for each class we return, virtual
+        method calls check whether the instance is exactly of that class and, if so,
+        call its implementation directly. We use the classes defined so far: ourself,
+        if nobody has subclassed us, or otherwise the leaves of our class hierarchy, as
+        long as there are at most MAX_SPECULATED_CLASSES of them. Classes defined after
+        we compile just take the vtable path.
+        """
+        subclasses = knownSubclassesOf(self.typeRepresentation)
+
+        if not subclasses:
+            return [self.typeRepresentation]
+
+        leaves = [cls for cls in subclasses if cls.IsFinal or not knownSubclassesOf(cls)]
+
+        if len(leaves) > MAX_SPECULATED_CLASSES:
+            return []
+
+        return leaves
+
+    def isExactlyOfClassNativeExpr(self, context, instance, cls):
+        """Return a native expression that's true if 'instance' is exactly of class 'cls', not a subclass."""
+        return self.get_class_type_ptr_as_voidptr(instance).cast(native_ast.UInt64).eq(
+            context.getTypePointer(cls).cast(native_ast.UInt64)
+        )
 
     def stripClassDispatchIndex(self, context, instance):
         """Return 'instance' with a class-dispatch of 0.
@@ -1430,13 +1509,9 @@ class ClassWrapper(ClassOrAlternativeWrapperMixin, RefcountedWrapper):
             out.expr.load().ElementPtrIntegers(0, 1).store(self.vtableExpr)
         )
 
-        # clear bits of init flags
-        for byteOffset in range(self.bytesOfInitBits):
-            context.pushEffect(
-                out.nonref_expr
-                .cast(native_ast.UInt8.pointer())
-                .ElementPtrIntegers(self.BYTES_BEFORE_INIT_BITS + byteOffset).store(native_ast.const_uint8_expr(0))
-            )
+        # every member we construct here gets its init flag set, so we can
+        # write each byte of flags once rather than clearing and then setting bits
+        initBits = [0] * self.bytesOfInitBits
 
         for i in range(len(self.classType.MemberTypes)):
             if _types.wantsToDefaultConstruct(self.classType.MemberTypes[i]) or self.fieldGuaranteedInitialized(i):
@@ -1449,7 +1524,16 @@ class ClassWrapper(ClassOrAlternativeWrapperMixin, RefcountedWrapper):
                     )
                 else:
                     context.pushReference(self.classType.MemberTypes[i], self.memberPtr(out, i)).convert_default_initialize()
-                context.pushEffect(self.setIsInitializedExpr(out, i))
+
+                if not self.fieldGuaranteedInitialized(i):
+                    initBits[i // 8] |= 1 << (i % 8)
+
+        for byteOffset in range(self.bytesOfInitBits):
+            context.pushEffect(
+                out.nonref_expr
+                .cast(native_ast.UInt8.pointer())
+                .ElementPtrIntegers(self.BYTES_BEFORE_INIT_BITS + byteOffset).store(native_ast.const_uint8_expr(initBits[byteOffset]))
+            )
 
         # break our args back out to unnamed and named arguments
         unnamedArgs = []
@@ -0,0 +1,152 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python.internals import likely, assume, unreachable, prefetch
+from typed_python.compiler.type_wrappers.wrapper import Wrapper
+from typed_python.compiler.type_wrappers.runtime_functions import externalCallTarget
+import typed_python.compiler.native_ast as native_ast
+
+
+# native_ast_to_llvm recognizes branches on this, and gives them weights
+expectBool = externalCallTarget("llvm.expect.i1", native_ast.Bool, native_ast.Bool, native_ast.Bool, intrinsic=True)
+
+assumeTrue = externalCallTarget("llvm.assume", native_ast.Void, native_ast.Bool, intrinsic=True)
+
+# address, whether we'll write, locality (0-3), and cache type (1 is data)
+prefetchAddress = externalCallTarget(
+    "llvm.prefetch",
+    native_ast.Void,
+    native_ast.Int8Ptr,
+    native_ast.Int32,
+    native_ast.Int32,
+    native_ast.Int32,
+    intrinsic=True
+)
+
+
+class CompilerHintWrapper(Wrapper):
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+
+class LikelyWrapper(CompilerHintWrapper):
+    """Implements 'likely' and 'unlikely'."""
+
+    def __init__(self, f):
+        super().__init__(f)
+        self.expected = f is likely
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 1 or kwargs:
+            context.pushException(TypeError, f"{self.typeRepresentation.__name__}() accepts 1 positional argument")
+            return
+
+        cond = args[0].toBool()
+        if cond is None:
+            return None
+
+        return context.pushPod(bool, expectBool.call(cond.nonref_expr, native_ast.const_bool_expr(self.expected)))
+
+
+class AssumeWrapper(CompilerHintWrapper):
+    def __init__(self):
+        super().__init__(assume)
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 1 or kwargs:
+            context.pushException(TypeError, "assume() accepts 1 positional argument")
+            return
+
+        cond = args[0].toBool()
+        if cond is None:
+            return None
+
+        context.pushEffect(assumeTrue.call(cond.nonref_expr))
+
+        return context.pushVoid()
+
+
+class UnreachableWrapper(CompilerHintWrapper):
+    def __init__(self):
+        super().__init__(unreachable)
+
+    def convert_call(self, context, expr, args, kwargs):
+        if args or kwargs:
+            context.pushException(TypeError, "unreachable() accepts no arguments")
+            return
+
+        context.pushTerminal(native_ast.Expression.Unreachable())
+
+        return None
+
+
+class PrefetchWrapper(CompilerHintWrapper):
+    def __init__(self):
+        super().__init__(prefetch)
+
+    def convert_call(self, context, expr, args, kwargs):
+        kwargs = dict(kwargs)
+
+        if not args or len(args) > 3:
+            context.pushException(TypeError, "prefetch() accepts 1 to 3 arguments")
+            return
+
+        for name, value in zip(["locality", "forWriting"], args[1:]):
+            if name in kwargs:
+                context.pushException(TypeError, f"prefetch() got multiple values for argument '{name}'")
+                return
+            kwargs[name] = value
+
+        for name in kwargs:
+            if name not in ("locality", "forWriting"):
+                context.pushException(TypeError, f"prefetch() got an unexpected keyword argument '{name}'")
+                return
+
+        locality = kwargs.get("locality")
+        forWriting = kwargs.get("forWriting")
+
+        if locality is not None and not (
+            locality.isConstant and isinstance(locality.constantValue, int) and 0 <= locality.constantValue <= 3
+        ):
+            context.pushException(TypeError, "prefetch() needs 'locality' to be a constant from 0 to 3")
+            return
+
+        if forWriting is not None and not (forWriting.isConstant and isinstance(forWriting.constantValue, bool)):
+            context.pushException(TypeError, "prefetch() needs 'forWriting' to be a constant bool")
+            return
+
+        if not args[0].expr_type.getNativeLayoutType().matches.Pointer:
+            context.pushException(TypeError, f"Can't prefetch a {args[0].expr_type}, since it's not a pointer")
+            return
+
+        address = args[0].nonref_expr
+
+        # Class instances keep their dispatch index in the top bits of the pointer
+        if hasattr(args[0].expr_type, "get_layout_pointer_native"):
+            address = args[0].expr_type.get_layout_pointer_native(address)
+
+        context.pushEffect(
+            prefetchAddress.call(
+                address.cast(native_ast.Int8Ptr),
+                native_ast.const_int32_expr(1 if forWriting is not None and forWriting.constantValue else 0),
+                native_ast.const_int32_expr(3 if locality is None else locality.constantValue),
+                native_ast.const_int32_expr(1)
+            )
+        )
+
+        return context.pushVoid()
@@ -21,7 +21,7 @@ from typed_python.compiler.typed_expression import TypedExpression
 from typed_python.compiler.type_wrappers.dict_wrapper import DictWrapper
 from typed_python import (
     Tuple, TypeFunction, Held, Member, Final, Class, ConstDict, PointerTo, Int32, UInt8,
-    bytecount, TupleOf, Set
+    bytecount, TupleOf, ListOf
 )
 from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
 
@@ -201,27 +201,35 @@ def allocate_empty_const_dict(ptrToOutDict, kvCount):
 
 
 def const_dict_sub(ptrToOutDict, lhs, rhs):
-    # lhs is a dict and rhs is a TupleOf
-    indicesToRemove = Set(int)()
-
-    for toRemove in rhs:
-        ix = const_dict_index_of_key(lhs, toRemove)
-        if ix >= 0:
-            indicesToRemove.add(ix)
+    # lhs is a dict and rhs is a TupleOf. We flag the entries to drop and
+    # then copy the rest across in one pass.
+    toRemove = ListOf(bool)()
+    toRemove.resize(len(lhs), False)
+    removeCount = 0
+
+    for key in rhs:
+        ix = const_dict_index_of_key(lhs, key)
+        if ix >= 0 and not toRemove[ix]:
+            toRemove[ix] = True
+            removeCount += 1
+
+    if removeCount == 0:
+        ptrToOutDict.initialize(lhs)
+        return
 
-    if len(indicesToRemove) == len(lhs):
+    if removeCount == len(lhs):
         # initialize it to zero
         ptrToOutDict.cast(PointerTo(None)).set(PointerTo(None)())
         return
 
     ptrToOutDict.cast(PointerTo(None)).set(
-        allocate_empty_const_dict(ptrToOutDict, len(lhs) - len(indicesToRemove))
+        allocate_empty_const_dict(ptrToOutDict, len(lhs) - removeCount)
     )
 
     outIx = 0
 
     for i in range(len(lhs)):
-        if i not in indicesToRemove:
+        if not toRemove[i]:
             ptrToOutDict.get().initialize_kv_pair_unsafe(
                 outIx,
                 lhs.get_key_by_index_unsafe(i),
@@ -229,7 +237,7 @@ def const_dict_sub(ptrToOutDict, lhs, rhs):
             )
             outIx += 1
 
-    assert outIx == len(lhs) - len(indicesToRemove)
+    assert outIx == len(lhs) - removeCount
     ptrToOutDict.get().set_kv_count_unsafe(outIx)
 
 
@@ -17,7 +17,57 @@ import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 from typed_python import Type, SerializationContext
 from typed_python.compiler.conversion_level import ConversionLevel
-from typed_python._types import deserialize
+from typed_python._types import deserialize, deserializeBuffer
+
+
+def deserializeInto(context, T, serContextArg, callNoContext, callWithContext):
+    """Generate code to deserialize an instance of T, returning it.
+
+    Args:
+        context - the ExpressionConversionContext
+        T - the type we're deserializing
+        serContextArg - a TypedExpression that should be None or a SerializationContext
+        callNoContext - a function from the uninitialized slot to a native expression
+            that deserializes into it without a context
+        callWithContext - a function from the uninitialized slot and the
+            SerializationContext to a native expression that deserializes into it.
+    """
+    # create an uninitialized slot. if we throw during deserialization
+    # it won't be initialized and so we won't try to destroy it.
+    inst = context.allocateUninitializedSlot(T)
+
+    isNone = serContextArg.convert_to_type_with_target(
+        context.push(type(None), lambda n: None),
+        ConversionLevel.Signature
+    )
+
+    serContext = context.allocateUninitializedSlot(SerializationContext)
+
+    isSerializationContext = serContextArg.convert_to_type_with_target(
+        serContext,
+        ConversionLevel.Signature
+    )
+
+    with context.ifelse(isNone.nonref_expr) as (ifTrue, ifFalse):
+        with ifTrue:
+            context.pushEffect(callNoContext(inst))
+            context.markUninitializedSlotInitialized(inst)
+
+        with ifFalse:
+            with context.ifelse(isSerializationContext.nonref_expr) as (ifTrueSc, ifFalseSc):
+                with ifTrueSc:
+                    context.markUninitializedSlotInitialized(serContext)
+                    context.pushEffect(callWithContext(inst, serContext))
+                    context.markUninitializedSlotInitialized(inst)
+
+                with ifFalseSc:
+                    context.pushException(TypeError, "Expected a SerializationContext")
+
+    return inst
+
+
+def isDeserializableType(T):
+    return issubclass(T, (Type, str, int, float, bytes, bool))
 
 
 class DeserializeWrapper(Wrapper):
@@ -41,7 +91,7 @@ class DeserializeWrapper(Wrapper):
 
         T = args[0].expr_type.typeRepresentation.Value
 
-        if not issubclass(T, (Type, str, int, float, bytes, bool)):
+        if not isDeserializableType(T):
             return context.constant(deserialize, allowArbitrary=True).convert_call(args, kwargs)
 
         data = args[1].toBytes()
@@ -49,51 +99,73 @@ class DeserializeWrapper(Wrapper):
         if data is None:
             return None
 
-        # create an uninitialized slot. if we throw during deserialization
-        # it won't be initialized and so we won't try to destroy it.
-        inst = context.allocateUninitializedSlot(T)
-
-        isNone = args[2].convert_to_type_with_target(
-            context.push(type(None), lambda n: None),
-            ConversionLevel.Signature
+        return deserializeInto(
+            context,
+            T,
+            args[2],
+            lambda inst: runtime_functions.deserialize_no_context.call(
+                data.nonref_expr.cast(native_ast.VoidPtr),
+                inst.expr.cast(native_ast.VoidPtr),
+                context.getTypePointer(T).cast(native_ast.VoidPtr)
+            ),
+            lambda inst, serContext: runtime_functions.deserialize.call(
+                data.nonref_expr.cast(native_ast.VoidPtr),
+                inst.expr.cast(native_ast.VoidPtr),
+                context.getTypePointer(T).cast(native_ast.VoidPtr),
+                context.getTypePointer(SerializationContext).cast(native_ast.VoidPtr),
+                serContext.expr.cast(native_ast.VoidPtr)
+            )
         )
 
-        serContext = context.allocateUninitializedSlot(SerializationContext)
 
-        isSerializationContext = args[2].convert_to_type_with_target(
-            serContext,
-            ConversionLevel.Signature
-        )
+class DeserializeBufferWrapper(Wrapper):
+    """The compiled version of _types.deserializeBuffer(T, address, size, serializationContext)."""
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
 
-        with context.ifelse(isNone.nonref_expr) as (ifTrue, ifFalse):
-            with ifTrue:
-                context.pushEffect(
-                    runtime_functions.deserialize_no_context.call(
-                        data.nonref_expr.cast(native_ast.VoidPtr),
-                        inst.expr.cast(native_ast.VoidPtr),
-                        context.getTypePointer(T).cast(native_ast.VoidPtr)
-                    )
-                )
-                context.markUninitializedSlotInitialized(inst)
-
-            with ifFalse:
-                with context.ifelse(isSerializationContext.nonref_expr) as (ifTrueSc, ifFalseSc):
-                    with ifTrueSc:
-                        context.markUninitializedSlotInitialized(serContext)
-
-                        context.pushEffect(
-                            runtime_functions.deserialize.call(
-                                data.nonref_expr.cast(native_ast.VoidPtr),
-                                inst.expr.cast(native_ast.VoidPtr),
-                                context.getTypePointer(T).cast(native_ast.VoidPtr),
-                                context.getTypePointer(SerializationContext).cast(native_ast.VoidPtr),
-                                serContext.expr.cast(native_ast.VoidPtr)
-                            )
-                        )
-
-                        context.markUninitializedSlotInitialized(inst)
-
-                    with ifFalseSc:
-                        context.pushException(TypeError, "Expected a SerializationContext")
-
-        return inst
+    def __init__(self):
+        super().__init__(deserializeBuffer)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) not in (3, 4) or kwargs:
+            return super().convert_call(context, expr, args, kwargs)
+
+        if not args[0].expr_type.is_py_type_object_wrapper:
+            return context.constant(deserializeBuffer, allowArbitrary=True).convert_call(args, kwargs)
+
+        T = args[0].expr_type.typeRepresentation.Value
+
+        if not isDeserializableType(T):
+            return context.constant(deserializeBuffer, allowArbitrary=True).convert_call(args, kwargs)
+
+        address = args[1].convert_to_type(int, ConversionLevel.Signature)
+        size = args[2].convert_to_type(int, ConversionLevel.Signature)
+
+        if address is None or size is None:
+            return None
+
+        serContextArg = args[3] if len(args) == 4 else context.constant(None)
+
+        return deserializeInto(
+            context,
+            T,
+            serContextArg,
+            lambda inst: runtime_functions.deserialize_buffer_no_context.call(
+                address.nonref_expr.cast(native_ast.UInt8Ptr),
+                size.nonref_expr,
+                inst.expr.cast(native_ast.VoidPtr),
+                context.getTypePointer(T).cast(native_ast.VoidPtr)
+            ),
+            lambda inst, serContext: runtime_functions.deserialize_buffer.call(
+                address.nonref_expr.cast(native_ast.UInt8Ptr),
+                size.nonref_expr,
+                inst.expr.cast(native_ast.VoidPtr),
+                context.getTypePointer(T).cast(native_ast.VoidPtr),
+                context.getTypePointer(SerializationContext).cast(native_ast.VoidPtr),
+                serContext.expr.cast(native_ast.VoidPtr)
+            )
+        )
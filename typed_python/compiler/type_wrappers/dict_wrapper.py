@@ -18,8 +18,10 @@ from typed_python.compiler.conversion_level import ConversionLevel
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 from typed_python.compiler.type_wrappers.bound_method_wrapper import BoundMethodWrapper
 from typed_python.compiler.type_wrappers.hash_table_implementation import table_next_slot, table_clear, \
-    dict_table_contains, dict_delitem, dict_getitem, dict_get, dict_setitem
-from typed_python import Tuple, PointerTo, Int32, UInt8, Dict, ConstDict, TypeFunction, Held, Class, Member, Final
+    dict_table_contains, dict_delitem, dict_getitem, dict_get, dict_get_many, dict_setitem
+from typed_python import (
+    Tuple, PointerTo, Int32, UInt8, Dict, ConstDict, ListOf, TypeFunction, Held, Class, Member, Final
+)
 
 import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler
@@ -138,7 +140,9 @@ class DictWrapperBase(RefcountedWrapper):
             ('hash_table_size', native_ast.Int64),
             ('hash_table_count', native_ast.Int64),
             ('hash_table_empty_slots', native_ast.Int64),
-            ('setdefault', native_ast.Int64)
+            ('hash_table_control', native_ast.UInt8Ptr),
+            ('hash_table_wide_slots', native_ast.Int64),
+            ('counted_type', native_ast.UInt8Ptr)
         ), name="DictWrapper").pointer()
 
     def on_refcount_zero(self, context, instance):
@@ -172,6 +176,16 @@ class DictWrapper(DictWrapperBase):
         return True
 
     def convert_default_initialize(self, context, instance):
+        if runtime_functions.type_live_counters:
+            context.pushEffect(
+                instance.expr.store(
+                    runtime_functions.table_create_counted.call(
+                        context.getTypePointer(self.dictType)
+                    ).cast(self.layoutType)
+                )
+            )
+            return
+
         context.pushEffect(
             instance.expr.store(
                 runtime_functions.table_create.call().cast(self.layoutType)
@@ -187,8 +201,8 @@ class DictWrapper(DictWrapperBase):
                 "deleteItemByIndexUnsafe",
                 "initializeValueByIndexUnsafe", "assignValueByIndexUnsafe",
                 "initializeKeyByIndexUnsafe", "_allocateNewSlotUnsafe", "_resizeTableUnsafe",
-                "_top_item_slot", "_compressItemTableUnsafe", "get", "items", "keys", "values", "setdefault",
-                "pop", "clear", "copy", "update"):
+                "_top_item_slot", "_compressItemTableUnsafe", "get", "getMany", "items", "keys", "values", "setdefault",
+                "pop", "clear", "compact", "copy", "update"):
             return expr.changeType(BoundMethodWrapper.Make(self, attr))
 
         if attr == '_items_populated':
@@ -221,6 +235,18 @@ class DictWrapper(DictWrapperBase):
                 expr.nonref_expr.ElementPtrIntegers(0, 6).load()
             )
 
+        if attr == '_hash_table_control':
+            return context.pushPod(
+                PointerTo(UInt8),
+                expr.nonref_expr.ElementPtrIntegers(0, 10).load()
+            )
+
+        if attr == '_hash_table_wide_slots':
+            return context.pushPod(
+                int,
+                expr.nonref_expr.ElementPtrIntegers(0, 11).load()
+            )
+
         if attr == '_hash_table_size':
             return context.pushPod(
                 int,
@@ -371,6 +397,15 @@ class DictWrapper(DictWrapperBase):
                 )
                 return context.pushVoid()
 
+            if methodname == "compact":
+                context.pushEffect(
+                    runtime_functions.table_compact.call(
+                        instance.nonref_expr.cast(native_ast.VoidPtr),
+                        context.constant(self.kvBytecount)
+                    )
+                )
+                return context.pushVoid()
+
             if methodname == "_resizeTableUnsafe":
                 context.pushEffect(
                     runtime_functions.table_resize.call(
@@ -381,7 +416,7 @@ class DictWrapper(DictWrapperBase):
 
             if methodname == "_allocateNewSlotUnsafe":
                 return context.pushPod(
-                    Int32,
+                    int,
                     runtime_functions.table_allocate_new_slot.call(
                         instance.nonref_expr.cast(native_ast.VoidPtr),
                         context.constant(self.kvBytecount)
@@ -408,6 +443,15 @@ class DictWrapper(DictWrapperBase):
             if len(args) == 1:
                 return context.call_py_function(dict_update, (instance, args[0]), {})
 
+        if methodname == "getMany":
+            if len(args) == 2:
+                keys = args[0].convert_to_type(ListOf(self.keyType.typeRepresentation), ConversionLevel.ImplicitContainers)
+                default = args[1].convert_to_type(self.valueType, ConversionLevel.ImplicitContainers)
+                if keys is None or default is None:
+                    return None
+
+                return context.call_py_function(dict_get_many, (instance, keys, default), {})
+
         if len(args) == 1:
             if methodname == "get":
                 return self.convert_get(context, instance, args[0], context.constant(None))
@@ -595,6 +639,9 @@ class DictWrapper(DictWrapperBase):
         )
 
     def generateNativeDestructorFunction(self, context, out, inst):
+        if runtime_functions.type_live_counters:
+            context.pushEffect(runtime_functions.table_stop_counting.call(inst.nonref_expr.cast(native_ast.VoidPtr)))
+
         with context.loop(self.convert_items_reserved(context, inst)) as i:
             with context.ifelse(self.convert_slot_populated_native(inst, i).neq(0)) as (then, otherwise):
                 with then:
@@ -606,6 +653,7 @@ class DictWrapper(DictWrapperBase):
             runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 2).load().cast(native_ast.UInt8Ptr)) >>
             runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 5).load().cast(native_ast.UInt8Ptr)) >>
             runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 6).load().cast(native_ast.UInt8Ptr)) >>
+            runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 10).load().cast(native_ast.UInt8Ptr)) >>
             runtime_functions.free.call(inst.nonref_expr.cast(native_ast.UInt8Ptr))
         )
 
@@ -621,6 +669,36 @@ class DictWrapper(DictWrapperBase):
 
         return super().convert_type_call(context, typeInst, args, kwargs)
 
+    def convert_type_attribute(self, context, typeInst, attr):
+        if attr in ('fromColumns',):
+            return typeInst.changeType(BoundMethodWrapper.Make(typeInst.expr_type, attr))
+
+        return super().convert_type_attribute(context, typeInst, attr)
+
+    def convert_type_method_call(self, context, typeInst, methodname, args, kwargs):
+        if methodname == "fromColumns" and len(args) == 2 and not kwargs:
+            keys = args[0].convert_to_type(ListOf(self.keyType.typeRepresentation), ConversionLevel.ImplicitContainers)
+            if keys is None:
+                return None
+
+            values = args[1].convert_to_type(ListOf(self.valueType.typeRepresentation), ConversionLevel.ImplicitContainers)
+            if values is None:
+                return None
+
+            return context.push(
+                self,
+                lambda newDictPtr:
+                newDictPtr.expr.store(
+                    runtime_functions.dict_from_columns.call(
+                        keys.nonref_expr.cast(native_ast.VoidPtr),
+                        values.nonref_expr.cast(native_ast.VoidPtr),
+                        context.getTypePointer(self.typeRepresentation).cast(native_ast.VoidPtr)
+                    ).cast(self.layoutType)
+                )
+            )
+
+        return super().convert_type_method_call(context, typeInst, methodname, args, kwargs)
+
     def _can_convert_to_type(self, targetType, conversionLevel):
         if not conversionLevel.isNewOrHigher():
             return False
@@ -0,0 +1,69 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python.compiler.type_wrappers.wrapper import Wrapper
+from typed_python.compiler.conversion_level import ConversionLevel
+import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
+from typed_python._types import fileRead, fileWrite
+
+
+class FileFunctionWrapper(Wrapper):
+    """Compiled versions of _types.fileRead and fileWrite.
+
+    Like the interpreted versions, these release the GIL while they block,
+    and return -errno rather than raising.
+    """
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    SUPPORTED_FUNCTIONS = (fileRead, fileWrite)
+
+    def __init__(self, f):
+        assert f in self.SUPPORTED_FUNCTIONS
+        super().__init__(f)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def convert_call(self, context, expr, args, kwargs):
+        if kwargs:
+            return super().convert_call(context, expr, args, kwargs)
+
+        if self.typeRepresentation is fileWrite and len(args) == 2 and args[1].expr_type.typeRepresentation is bytes:
+            fd = args[0].convert_to_type(int, ConversionLevel.Signature)
+
+            if fd is None:
+                return None
+
+            return context.pushPod(
+                int,
+                runtime_functions.file_write_bytes.call(fd.nonref_expr, args[1].nonref_expr.cast(native_ast.VoidPtr))
+            )
+
+        if len(args) == 3:
+            fd, address, count = [arg.convert_to_type(int, ConversionLevel.Signature) for arg in args]
+
+            if fd is None or address is None or count is None:
+                return None
+
+            fn = runtime_functions.file_read if self.typeRepresentation is fileRead else runtime_functions.file_write
+
+            return context.pushPod(
+                int,
+                fn.call(fd.nonref_expr, address.nonref_expr.cast(native_ast.UInt8Ptr), count.nonref_expr)
+            )
+
+        return super().convert_call(context, expr, args, kwargs)
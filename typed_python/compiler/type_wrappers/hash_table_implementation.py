@@ -12,14 +12,32 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from typed_python import UInt64, Int32, Type
+from typed_python import UInt64, UInt8, Int32, Type, ListOf
 from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
 from typed_python.compiler.conversion_level import ConversionLevel
+from typed_python.python_ast import ComparisonOp
 
 
+# these must match the constants in hash_table_layout.hpp, which describes
+# the probing scheme in detail.
 EMPTY = -1
 DELETED = -2
-PERTURB_SHIFT = 5
+GROUP_WIDTH = 16
+TAG_BITS = 7
+TAG_MASK = 0x7F
+CONTROL_EMPTY = 0x80
+CONTROL_DELETED = 0xFE
+GROUP_HASH_MULTIPLIER_HIGH = 0x9E3779B9
+GROUP_HASH_MULTIPLIER_LOW = 0x7F4A7C15
+HASH_MIX_SHIFT = 32
+
+# tables whose items all fit in this many slots have no hashtable, just the
+# hash of each item slot in '_hash_table_hashes'. See 'isSmall' in
+# hash_table_layout.hpp.
+SMALL_TABLE_SIZE = 8
+
+# how many keys ahead of the one we're resolving batched lookups prefetch
+LOOKUP_BATCH = 16
 
 
 class NativeHash(CompilableBuiltin):
@@ -88,73 +106,285 @@ class NativeHash(CompilableBuiltin):
         return hashIt(x)
 
 
+class SameObject(CompilableBuiltin):
+    """'SameObject()(a, b)' is True if 'a' and 'b' are both held as 'object' and are the same python object.
+
+    For anything else it's the constant False, so code guarded by it compiles away. We
+    use it to settle key comparisons in tables with object keys without calling
+    '__eq__', which means taking the GIL and calling back into the interpreter. Looking
+    up the very object we inserted (an interned string, a small int, a type) is the
+    common case in mixed-type lookup tables.
+    """
+    def __eq__(self, other):
+        return isinstance(other, SameObject)
+
+    def __hash__(self):
+        return hash("SameObject")
+
+    def convert_call(self, context, instance, args, kwargs):
+        if len(args) == 2 and not kwargs:
+            if args[0].expr_type.typeRepresentation is object and args[1].expr_type.typeRepresentation is object:
+                return args[0].convert_bin_op(ComparisonOp.Is(), args[1])
+
+            return context.constant(False)
+
+        return super().convert_call(context, instance, args, kwargs)
+
+
+def table_mix_hash(itemHash):
+    multiplier = (UInt64(GROUP_HASH_MULTIPLIER_HIGH) << UInt64(32)) | UInt64(GROUP_HASH_MULTIPLIER_LOW)
+
+    mixed = UInt64(itemHash) * multiplier
+
+    return mixed ^ (mixed >> UInt64(HASH_MIX_SHIFT))
+
+
+def table_control_tag(itemHash):
+    return UInt8(table_mix_hash(itemHash) & UInt64(TAG_MASK))
+
+
+def table_first_group(itemHash, groupMask):
+    return (table_mix_hash(itemHash) >> UInt64(TAG_BITS)) & groupMask
+
+
+def table_small_hash(itemHash):
+    """Return 'itemHash' the way a small table stores it."""
+    smallHash = Int32(itemHash)
+
+    if smallHash < 0:
+        smallHash = -smallHash
+
+    return smallHash
+
+
+def table_key_matches(instance, slotIndex, item):
+    """Return whether the key in 'slotIndex' equals 'item', which has the key's hash."""
+    key = instance.getKeyByIndexUnsafe(slotIndex)
+
+    if SameObject()(key, item):
+        return True
+
+    return key == item
+
+
+def table_get_slot(instance, bucket):
+    if not instance._hash_table_slots:
+        # in a small table, buckets are item slots
+        return bucket
+
+    if instance._hash_table_wide_slots:
+        return instance._hash_table_slots.cast(int)[bucket]
+
+    return int(instance._hash_table_slots[bucket])
+
+
+def table_set_slot(instance, bucket, slot):
+    if instance._hash_table_wide_slots:
+        instance._hash_table_slots.cast(int)[bucket] = slot
+    else:
+        instance._hash_table_slots[bucket] = slot
+
+
 def table_add_slot(instance, itemHash, slot):
-    if (instance._hash_table_count * 2 + 1 > instance._hash_table_size or
+    if instance._hash_table_control and (
+            instance._hash_table_count * 2 + 1 > instance._hash_table_size or
             instance._hash_table_empty_slots < (instance._hash_table_size >> 2) + 1):
         instance._resizeTableUnsafe()
 
+    if not instance._hash_table_control:
+        if instance._items_reserved <= SMALL_TABLE_SIZE:
+            # '_allocateNewSlotUnsafe' allocated the small table's hashes
+            instance._hash_table_hashes[slot] = table_small_hash(itemHash)
+            instance._items_populated[slot] = 1
+            instance._hash_table_count += 1
+
+            return
+
+        instance._resizeTableUnsafe()
+
     if itemHash < 0:
         itemHash = -itemHash
 
-    mask = UInt64(instance._hash_table_size) - UInt64(1)
-    perturb = UInt64(itemHash)
-    offset = UInt64(itemHash)
+    control = instance._hash_table_control
+    groupMask = UInt64(instance._hash_table_size >> 4) - UInt64(1)
+    group = table_first_group(itemHash, groupMask)
+    step = UInt64(1)
 
     while True:
-        if (
-            instance._hash_table_slots[offset & mask] == EMPTY
-            or instance._hash_table_slots[offset & mask] == DELETED
-        ):
-            if instance._hash_table_slots[offset & mask] == EMPTY:
-                instance._hash_table_empty_slots -= 1
-
-            instance._hash_table_slots[offset & mask] = slot
-            instance._hash_table_hashes[offset & mask] = itemHash
-            instance._items_populated[slot] = 1
-            instance._hash_table_count += 1
+        bucket = group * UInt64(GROUP_WIDTH)
 
-            return
+        for _ in range(GROUP_WIDTH):
+            if control[bucket] & CONTROL_EMPTY:
+                if control[bucket] == CONTROL_EMPTY:
+                    instance._hash_table_empty_slots -= 1
 
-        offset = UInt64(offset << 2) + offset + perturb + UInt64(1)
-        perturb = UInt64(perturb >> PERTURB_SHIFT)
+                control[bucket] = table_control_tag(itemHash)
+                table_set_slot(instance, bucket, slot)
+                instance._hash_table_hashes[bucket] = itemHash
+                instance._items_populated[slot] = 1
+                instance._hash_table_count += 1
 
+                return
 
-def table_slot_for_key(instance, itemHash, item):
-    slots = instance._hash_table_slots
+            bucket += UInt64(1)
 
-    if not slots:
-        return -1
+        group = (group + step) & groupMask
+        step += UInt64(1)
+
+
+def table_bucket_for_key(instance, itemHash, item):
+    """Return the hashtable bucket holding 'item', or -1 if it's not present."""
+    control = instance._hash_table_control
+
+    if not control:
+        return table_small_bucket_for_key(instance, itemHash, item)
 
     if itemHash < 0:
         itemHash = -itemHash
 
-    mask = UInt64(instance._hash_table_size) - UInt64(1)
-    perturb = UInt64(itemHash)
-    offset = UInt64(itemHash)
+    # the table keeps each item's hash, so we only compare keys, which for
+    # object keys means calling into the interpreter, when the whole hash matches
+    storedHash = Int32(itemHash)
+    hashes = instance._hash_table_hashes
+
+    tag = table_control_tag(itemHash)
+    groupMask = UInt64(instance._hash_table_size >> 4) - UInt64(1)
+    group = table_first_group(itemHash, groupMask)
+    step = UInt64(1)
 
     while True:
-        slotIndex = int((slots + (offset & mask)).get())
+        groupStart = group * UInt64(GROUP_WIDTH)
+        bucket = groupStart
+        sawEmpty = False
 
-        if slotIndex == EMPTY:
-            return -1
+        # scan the whole group's control bytes, which live in a single
+        # cache line, and only look at the items whose tags match.
+        for _ in range(GROUP_WIDTH):
+            controlByte = control[bucket]
 
-        if slotIndex != DELETED and (instance._hash_table_hashes + (offset & mask)).get() == itemHash:
-            if instance.getKeyByIndexUnsafe(slotIndex) == item:
-                return slotIndex
+            if controlByte == tag and hashes[bucket] == storedHash:
+                if table_key_matches(instance, table_get_slot(instance, bucket), item):
+                    return int(bucket)
+            elif controlByte == CONTROL_EMPTY:
+                sawEmpty = True
 
-        offset = UInt64(offset << 2) + offset + perturb + UInt64(1)
-        perturb = UInt64(perturb >> PERTURB_SHIFT)
+            bucket += UInt64(1)
+
+        if sawEmpty:
+            return -1
+
+        group = (group + step) & groupMask
+        step += UInt64(1)
 
     # not necessary, but currently we don't realize that the while loop
     # never exits, and so we think there's a possibility we return None
     return 0
 
 
+def table_small_bucket_for_key(instance, itemHash, item):
+    hashes = instance._hash_table_hashes
+
+    if not hashes:
+        return -1
+
+    smallHash = table_small_hash(itemHash)
+
+    for slot in range(min(instance._top_item_slot, SMALL_TABLE_SIZE)):
+        if hashes[slot] == smallHash and table_key_matches(instance, slot, item):
+            return slot
+
+    return -1
+
+
+def table_bucket_count(instance):
+    """Return how many buckets there are to walk with table_bucket_populated."""
+    if instance._hash_table_control:
+        return instance._hash_table_size
+
+    return min(instance._top_item_slot, SMALL_TABLE_SIZE)
+
+
+def table_slot_for_key(instance, itemHash, item):
+    bucket = table_bucket_for_key(instance, itemHash, item)
+
+    if bucket == -1:
+        return -1
+
+    return table_get_slot(instance, bucket)
+
+
+def table_normalized_hash(itemHash):
+    """Return 'itemHash' the way the table stores it, as a UInt64."""
+    if itemHash < 0:
+        itemHash = -itemHash
+
+    return UInt64(itemHash)
+
+
+def table_prefetch_group(instance, itemHash):
+    """Start loading the control bytes and slots of the first group 'itemHash' probes."""
+    control = instance._hash_table_control
+
+    if not control:
+        return
+
+    groupMask = UInt64(instance._hash_table_size >> 4) - UInt64(1)
+    bucket = int(table_first_group(itemHash, groupMask) * UInt64(GROUP_WIDTH))
+
+    (control + bucket).prefetch()
+
+    if instance._hash_table_wide_slots:
+        (instance._hash_table_slots.cast(int) + bucket).prefetch()
+    else:
+        (instance._hash_table_slots + bucket).prefetch()
+
+
+def table_slots_for_keys(instance, keys, hashes):
+    """Return the slot of each of 'keys', or -1 for the ones that aren't present.
+
+    'hashes' holds the normalized hash of each key. A lone lookup in a big
+    table stalls on a cache miss for its group and then another for its item.
+    Here we prefetch the group of the key LOOKUP_BATCH places ahead of the
+    one we're resolving, so those misses overlap.
+    """
+    count = len(keys)
+
+    slots = ListOf(int)()
+    slots.resize(count)
+
+    for i in range(min(count, LOOKUP_BATCH)):
+        table_prefetch_group(instance, hashes[i])
+
+    for i in range(count):
+        if i + LOOKUP_BATCH < count:
+            table_prefetch_group(instance, hashes[i + LOOKUP_BATCH])
+
+        slots[i] = table_slot_for_key(instance, hashes[i], keys[i])
+
+    return slots
+
+
 def table_next_slot(instance, slotIx):
+    """Return the first populated slot after 'slotIx', or -1 if there isn't one.
+
+    Nothing at or past '_top_item_slot' is populated, and we skip runs of
+    deleted slots eight at a time by reading '_items_populated' as words.
+    """
     slotIx += 1
 
-    while slotIx < instance._items_reserved:
-        if instance._items_populated[slotIx]:
+    populated = instance._items_populated
+    top = instance._top_item_slot
+
+    while slotIx < top and slotIx & 7:
+        if populated[slotIx]:
+            return slotIx
+        slotIx += 1
+
+    while slotIx + 8 <= top and not (populated + slotIx).cast(UInt64).get():
+        slotIx += 8
+
+    while slotIx < top:
+        if populated[slotIx]:
             return slotIx
         slotIx += 1
 
@@ -168,46 +398,59 @@ def table_remove_key(instance, item, itemHash, raises):
     if instance._hash_table_count < instance._hash_table_size >> 3:
         instance._resizeTableUnsafe()
 
-    slots = instance._hash_table_slots
+    bucket = table_bucket_for_key(instance, itemHash, item)
 
-    if not slots:
+    if bucket == -1:
         if raises:
             raise KeyError(item)
         else:
             return 0
 
-    if itemHash < 0:
-        itemHash = -itemHash
+    table_remove_bucket(instance, bucket)
 
-    mask = UInt64(instance._hash_table_size) - UInt64(1)
-    perturb = UInt64(itemHash)
-    offset = UInt64(itemHash)
+    return 0
 
-    while True:
-        slotIndex = int((slots + (offset & mask)).get())
-
-        if slotIndex == EMPTY:
-            if raises:
-                raise KeyError(item)
-            else:
-                return 0
-
-        if slotIndex != DELETED and (instance._hash_table_hashes + (offset & mask)).get() == itemHash:
-            if instance.getKeyByIndexUnsafe(slotIndex) == item:
-                instance._hash_table_hashes[offset & mask] = -1
-                instance._hash_table_slots[offset & mask] = DELETED
-                instance._hash_table_count -= 1
-                instance._items_populated[slotIndex] = 0
-
-                instance.deleteItemByIndexUnsafe(slotIndex)
-                return
 
-        offset = (offset << 2) + offset + perturb + UInt64(1)
-        perturb = perturb >> PERTURB_SHIFT
+def table_remove_bucket(instance, bucket):
+    """Remove and destroy the item in 'bucket'.
 
-    # not necessary, but currently we don't currently realize that the while loop
-    # never exits, and so we think there's a possibility we return None
-    return 0
+    Unlike table_remove_key, this never compresses or resizes the table, so
+    it's safe to call while walking the table's buckets.
+    """
+    if not instance._hash_table_control:
+        instance._hash_table_hashes[bucket] = EMPTY
+        instance._hash_table_count -= 1
+        instance._items_populated[bucket] = 0
+
+        instance.deleteItemByIndexUnsafe(bucket)
+        return
+
+    slotIndex = table_get_slot(instance, bucket)
+
+    instance._hash_table_control[bucket] = CONTROL_DELETED
+    instance._hash_table_hashes[bucket] = -1
+    table_set_slot(instance, bucket, DELETED)
+    instance._hash_table_count -= 1
+    instance._items_populated[slotIndex] = 0
+
+    instance.deleteItemByIndexUnsafe(slotIndex)
+
+
+def table_bucket_populated(instance, bucket):
+    if not instance._hash_table_control:
+        return instance._items_populated[bucket] != 0
+
+    return not (instance._hash_table_control[bucket] & CONTROL_EMPTY)
+
+
+def table_stored_hash(instance, bucket):
+    """Return the hash stored in 'bucket', in a form we can pass back to the table functions.
+
+    The table keeps only the low 32 bits of each hash, and object hashes are
+    sign-extended 32 bit values, so widening it again gives back a hash that
+    probes exactly like the one the item was inserted with.
+    """
+    return UInt64(instance._hash_table_hashes[bucket])
 
 
 def table_clear(instance):
@@ -220,9 +463,14 @@ def table_clear(instance):
 
         slotIx += 1
 
+    if not instance._hash_table_control and instance._hash_table_hashes:
+        for i in range(SMALL_TABLE_SIZE):
+            instance._hash_table_hashes[i] = EMPTY
+
     for i in range(instance._hash_table_size):
+        instance._hash_table_control[i] = CONTROL_EMPTY
         instance._hash_table_hashes[i] = EMPTY
-        instance._hash_table_slots[i] = -1
+        table_set_slot(instance, i, EMPTY)
 
     instance._hash_table_count = 0
     instance._hash_table_empty_slots = instance._hash_table_size
@@ -268,6 +516,27 @@ def dict_get(instance, item, default):
     return instance.getValueByIndexUnsafe(slot)
 
 
+def dict_get_many(instance, keys, default):
+    hashes = ListOf(UInt64)()
+    hashes.resize(len(keys))
+
+    for i in range(len(keys)):
+        hashes[i] = table_normalized_hash(NativeHash(instance.KeyType)(keys[i]))
+
+    slots = table_slots_for_keys(instance, keys, hashes)
+
+    res = ListOf(type(instance).ValueType)()
+    res.reserve(len(slots))
+
+    for slot in slots:
+        if slot == -1:
+            res.append(default)
+        else:
+            res.append(instance.getValueByIndexUnsafe(slot))
+
+    return res
+
+
 def dict_setitem(instance, key, value):
     itemHash = NativeHash(instance.KeyType)(key)
 
@@ -292,18 +561,32 @@ def set_table_contains(instance, item):
     return slot != -1
 
 
-def set_add(instance, key):
-    itemHash = NativeHash(instance.ElementType)(key)
+def set_contains_many(instance, keys):
+    hashes = ListOf(UInt64)()
+    hashes.resize(len(keys))
 
-    slot = table_slot_for_key(instance, itemHash, key)
+    for i in range(len(keys)):
+        hashes[i] = table_normalized_hash(NativeHash(instance.ElementType)(keys[i]))
 
-    if slot == -1:
-        newSlot = instance._allocateNewSlotUnsafe()
-        table_add_slot(instance, itemHash, newSlot)
-        instance.initializeKeyByIndexUnsafe(newSlot, key)
+    slots = table_slots_for_keys(instance, keys, hashes)
+
+    res = ListOf(bool)()
+    res.resize(len(slots))
+
+    for i in range(len(slots)):
+        res[i] = slots[i] != -1
+
+    return res
 
 
-def set_add_or_remove(instance, key):
+def set_add_new_with_hash(instance, key, itemHash):
+    """Add 'key', which must not already be in the set, given its hash."""
+    newSlot = instance._allocateNewSlotUnsafe()
+    table_add_slot(instance, itemHash, newSlot)
+    instance.initializeKeyByIndexUnsafe(newSlot, key)
+
+
+def set_add(instance, key):
     itemHash = NativeHash(instance.ElementType)(key)
 
     slot = table_slot_for_key(instance, itemHash, key)
@@ -312,8 +595,6 @@ def set_add_or_remove(instance, key):
         newSlot = instance._allocateNewSlotUnsafe()
         table_add_slot(instance, itemHash, newSlot)
         instance.initializeKeyByIndexUnsafe(newSlot, key)
-    else:
-        table_remove_key(instance, key, itemHash, False)
 
 
 def set_remove(instance, key):
@@ -197,15 +197,9 @@ class HeldClassWrapper(ClassOrAlternativeWrapperMixin, Wrapper):
             argNames - a tuple of (None|str) with the names of the args as they were passed.
             *args - Typed expressions representing each argument passed to us.
         """
-        # clear bits of init flags
-        for byteOffset in range(self.bytesOfInitBits):
-            context.pushEffect(
-                out.expr
-                .cast(native_ast.UInt8.pointer())
-                .ElementPtrIntegers(byteOffset).store(
-                    native_ast.const_uint8_expr(0)
-                )
-            )
+        # every member we construct here gets its init flag set, so we can
+        # write each byte of flags once rather than clearing and then setting bits
+        initBits = [0] * self.bytesOfInitBits
 
         for i in range(len(self.classType.MemberTypes)):
             if _types.wantsToDefaultConstruct(self.classType.MemberTypes[i]) or self.fieldGuaranteedInitialized(i):
@@ -218,7 +212,16 @@ class HeldClassWrapper(ClassOrAlternativeWrapperMixin, Wrapper):
                     )
                 else:
                     context.pushReference(self.classType.MemberTypes[i], self.memberPtr(out, i)).convert_default_initialize()
-                context.pushEffect(self.setIsInitializedExpr(out, i))
+
+                if not self.fieldGuaranteedInitialized(i):
+                    initBits[i // 8] |= 1 << (i % 8)
+
+        for byteOffset in range(self.bytesOfInitBits):
+            context.pushEffect(
+                out.expr
+                .cast(native_ast.UInt8.pointer())
+                .ElementPtrIntegers(byteOffset).store(native_ast.const_uint8_expr(initBits[byteOffset]))
+            )
 
         # break our args back out to unnamed and named arguments
         unnamedArgs = []
@@ -18,7 +18,7 @@ from typed_python.compiler.type_wrappers.bound_method_wrapper import BoundMethod
 from typed_python.compiler.conversion_level import ConversionLevel
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 
-from typed_python import ListOf
+from typed_python import ListOf, TupleOf
 
 import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler
@@ -27,10 +27,14 @@ typeWrapper = lambda t: typed_python.compiler.python_object_representation.typed
 
 
 def list_of_extend(aList, extendWith):
-    if isinstance(extendWith, ListOf):
-        # don't iterate in case 'extendWith' is 'aList', in which case we could
-        # segfault if the list gets resized underneath us
-        for i in range(len(extendWith)):
+    if isinstance(extendWith, ListOf) or isinstance(extendWith, TupleOf):
+        # we know how many elements are coming, so make room for them once. Don't
+        # iterate, in case 'extendWith' is 'aList', in which case we could segfault
+        # if the list gets resized underneath us
+        count = len(extendWith)
+        aList._ensureSpaceFor(count)
+
+        for i in range(count):
             aList.append(extendWith[i])
     else:
         for thing in extendWith:
@@ -59,7 +63,7 @@ class ListOfWrapper(TupleOrListOfWrapper):
 
     def convert_attribute(self, context, instance, attr):
         if attr in ("copy", "resize", "reserve", "reserved", "extend", "append",
-                    "clear", "pop", "setSizeUnsafe"):
+                    "clear", "pop", "setSizeUnsafe", "shrinkToFit", "_ensureSpaceFor"):
             return instance.changeType(BoundMethodWrapper.Make(self, attr))
 
         return super().convert_attribute(context, instance, attr)
@@ -195,6 +199,27 @@ class ListOfWrapper(TupleOrListOfWrapper):
                         self.generateReserve
                     ).call(instance, count)
                 )
+        if methodname == "_ensureSpaceFor":
+            if len(args) == 1:
+                count = args[0].toInt64()
+                if count is None:
+                    return
+
+                return context.pushPod(
+                    None,
+                    context.converter.defineNativeFunction(
+                        'ensureSpaceFor(' + self.typeRepresentation.__name__ + ")",
+                        ('util', self, 'ensureSpaceFor'),
+                        [self, int],
+                        None,
+                        self.generateEnsureSpaceFor
+                    ).call(instance, count)
+                )
+
+        if methodname == "shrinkToFit":
+            if len(args) == 0:
+                return self.convert_method_call(context, instance, "reserve", (context.constant(0),), {})
+
         if methodname == "reserved":
             if len(args) == 0:
                 return context.pushPod(
@@ -265,7 +290,9 @@ class ListOfWrapper(TupleOrListOfWrapper):
             with if_bigger:
                 with context.ifelse(listInst.convert_reserved() < countInst) as (if_needs_reserve, _):
                     with if_needs_reserve:
-                        self.convert_method_call(context, listInst, "reserve", (countInst,), {})
+                        self.convert_method_call(
+                            context, listInst, "reserve", (self.convert_grown_reservation(context, listInst, countInst),), {}
+                        )
 
                 with context.loop(countInst - listInst.convert_len()) as i:
                     if arg is None:
@@ -289,10 +316,48 @@ class ListOfWrapper(TupleOrListOfWrapper):
             listInst.nonref_expr.ElementPtrIntegers(0, 2).store(native_ast.Int32.zero())
         )
 
+    def convert_grown_reservation(self, context, listInst, needed):
+        """How much to reserve when 'listInst' needs room for 'needed' elements.
+
+        Mirrors TupleOrListOfType::grownReservation.
+        """
+        reserved = listInst.convert_reserved()
+
+        res = context.push(int, lambda tgt: tgt.expr.store((reserved + reserved // 2).nonref_expr))
+
+        with context.ifelse(reserved < 1024) as (then, _):
+            with then:
+                context.pushEffect(res.expr.store((reserved * 2 + 4).nonref_expr))
+
+        with context.ifelse(res > 2 ** 31 - 1) as (then, _):
+            with then:
+                context.pushEffect(res.expr.store(native_ast.const_int_expr(2 ** 31 - 1)))
+
+        with context.ifelse(res < needed) as (then, _):
+            with then:
+                context.pushEffect(res.expr.store(needed.nonref_expr))
+
+        return res
+
+    def generateEnsureSpaceFor(self, context, out, listInst, countInst):
+        needed = listInst.convert_len() + countInst
+
+        with context.ifelse(listInst.convert_reserved() < needed) as (if_needs_reserve, _):
+            with if_needs_reserve:
+                self.convert_method_call(
+                    context, listInst, "reserve", (self.convert_grown_reservation(context, listInst, needed),), {}
+                )
+
     def generateAppend(self, context, out, listInst, arg):
         with context.ifelse(listInst.convert_reserved() < listInst.convert_len()+1) as (if_needs_reserve, _):
             with if_needs_reserve:
-                self.convert_method_call(context, listInst, "reserve", ((listInst.convert_len() * 5) / 4 + 1,), {})
+                self.convert_method_call(
+                    context,
+                    listInst,
+                    "reserve",
+                    (self.convert_grown_reservation(context, listInst, listInst.convert_len() + 1),),
+                    {}
+                )
 
         listInst.convert_getitem_unsafe(listInst.convert_len()).convert_copy_initialize(arg)
 
@@ -323,6 +388,8 @@ class ListOfWrapper(TupleOrListOfWrapper):
             with then:
                 context.pushEffect(countInst.expr.store(listInst.convert_len().nonref_expr))
 
+        self.adjustLiveBytes(context, listInst, -1)
+
         context.pushEffect(
             listInst.nonref_expr.ElementPtrIntegers(0, 4).store(
                 runtime_functions.realloc.call(
@@ -341,6 +408,8 @@ class ListOfWrapper(TupleOrListOfWrapper):
             listInst.nonref_expr.ElementPtrIntegers(0, 3).store(countInst.nonref_expr.cast(native_ast.Int32))
         )
 
+        self.adjustLiveBytes(context, listInst, 1)
+
     def generateReserved(self, context, out, listInst):
         context.pushEffect(native_ast.Expression.Return(arg=listInst.convert_reserved().nonref_expr))
 
@@ -366,13 +435,16 @@ class ListOfWrapper(TupleOrListOfWrapper):
                         ('refcount', native_ast.const_int_expr(1)),
                         ('hash_cache', native_ast.const_int32_expr(-1)),
                         ('count', native_ast.const_int32_expr(0)),
-                        ('reserved', native_ast.const_int32_expr(1)),
-                        ('data', runtime_functions.malloc.call(self.underlyingWrapperType.getBytecount())),
+                        ('reserved', native_ast.const_int32_expr(0)),
+                        # the data buffer is allocated when the first element is added
+                        ('data', native_ast.UInt8Ptr.zero()),
                     )
                 )
             )
         )
 
+        self.adjustLiveInstances(context, out, 1)
+
     def convert_setitem(self, context, expr, index, item):
         if item is None:
             return None
@@ -48,7 +48,7 @@ from math import (
     gamma,
     gcd,
     hypot,
-    # inf,
+    inf,
     isclose,
     isfinite,
     isinf,
@@ -189,6 +189,20 @@ def native_hypot(arg1, arg2):
     return runtime_functions.sqrt64.call(arg1 * arg1 + arg2 * arg2)
 
 
+# these are plain comparisons rather than calls into the runtime, so llvm can fold
+# them together with the arithmetic around them.
+def native_isinf(arg):
+    return runtime_functions.fabs64.call(arg.nonref_expr).eq(native_ast.const_float_expr(inf))
+
+
+def native_isfinite(arg):
+    return runtime_functions.fabs64.call(arg.nonref_expr).lt(native_ast.const_float_expr(inf))
+
+
+def native_isnan(arg):
+    return arg.nonref_expr.eq(arg.nonref_expr).logical_not()
+
+
 class MathFunctionWrapper(Wrapper):
     is_pod = True
     is_empty = False
@@ -213,21 +227,21 @@ class MathFunctionWrapper(Wrapper):
         atanh: MathImpl(f=runtime_functions.atanh64),
         # ceil: MathImpl(f=runtime_functions.ceil64),  # see BuiltinWrapper
         cos: MathImpl(f=runtime_functions.cos64),
-        cosh: MathImpl(f=runtime_functions.cosh64),
+        cosh: MathImpl(f=runtime_functions.cosh64, check_inf=True),
         degrees: MathImpl(f=native_degrees),
         erf: MathImpl(f=runtime_functions.erf64),
         erfc: MathImpl(f=runtime_functions.erfc64),
         exp: MathImpl(f=runtime_functions.exp64, check_inf=True),
-        expm1: MathImpl(f=runtime_functions.expm1_64),
+        expm1: MathImpl(f=runtime_functions.expm1_64, check_inf=True),
         fabs: MathImpl(f=runtime_functions.fabs64),
         factorial: MathImpl(f=runtime_functions.factorial64),
         # floor: MathImpl(f=runtime_functions.floor64),  # see BuiltinWrapper
         frexp: MathImpl(f=runtime_functions.frexp64, ret=(float, int)),
         fsum: MathImpl(f=None, args=("iterable",)),  # special case, in this table for completeness
         gamma: MathImpl(f=runtime_functions.gamma64),
-        isfinite: MathImpl(f=runtime_functions.isfinite_float64, ret=bool),
-        isinf: MathImpl(f=runtime_functions.isinf_float64, ret=bool),
-        isnan: MathImpl(f=runtime_functions.isnan_float64, ret=bool),
+        isfinite: MathImpl(f=native_isfinite, ret=bool),
+        isinf: MathImpl(f=native_isinf, ret=bool),
+        isnan: MathImpl(f=native_isnan, ret=bool),
         ldexp: MathImpl(f=runtime_functions.ldexp64, args=(float, int)),
         lgamma: MathImpl(f=runtime_functions.lgamma64),
         log: MathImpl(f=runtime_functions.log64),
@@ -239,7 +253,7 @@ class MathFunctionWrapper(Wrapper):
         sin: MathImpl(f=runtime_functions.sin64),
         sinh: MathImpl(f=runtime_functions.sinh64, check_inf=True),
         sqrt: MathImpl(f=runtime_functions.sqrt64),
-        tan: MathImpl(f=runtime_functions.tan64),
+        tan: MathImpl(f=runtime_functions.tan64, check_inf=True),
         tanh: MathImpl(f=runtime_functions.tanh64),
         atan2: MathImpl(f=runtime_functions.atan2_64, args=(float, float)),
         copysign: MathImpl(f=runtime_functions.copysign64, args=(float, float)),
@@ -350,15 +364,14 @@ class MathFunctionWrapper(Wrapper):
                                 with ifTrue3:  # arg1 == 0, arg2 < 0
                                     context.pushException(ValueError, "math domain error")
                         with ifFalse2:  # arg1 < 0
-                            f_isinf = runtime_functions.isinf_float64
-                            with context.ifelse(f_isinf.call(arg1)) as (ifTrue4, ifFalse4):
+                            with context.ifelse(native_isinf(arg1)) as (ifTrue4, ifFalse4):
                                 with ifFalse4:  # arg1 < 0 and arg1 is finite
                                     f_floor = runtime_functions.floor64
                                     with context.ifelse(f_floor.call(arg2).sub(arg2).neq(0.0)) as (ifTrue5, ifFalse5):
                                         with ifTrue5:  # arg1 < 0, arg1 is finite, arg2 not an integer
                                             context.pushException(ValueError, "math domain error")
         if self.typeRepresentation in (cos, sin, tan):
-            with context.ifelse(runtime_functions.isinf_float64.call(arg1)) as (ifTrue, ifFalse):
+            with context.ifelse(native_isinf(arg1)) as (ifTrue, ifFalse):
                 with ifTrue:
                     context.pushException(ValueError, "math domain error")
         elif self.typeRepresentation in (acos, asin):
@@ -391,7 +404,7 @@ class MathFunctionWrapper(Wrapper):
         elif self.typeRepresentation is gamma:
             with context.ifelse(arg1 <= 0.0) as (ifTrue, ifFalse):
                 with ifTrue:
-                    with context.ifelse(runtime_functions.isinf_float64.call(arg1)) as (ifTrue2, ifFalse2):
+                    with context.ifelse(native_isinf(arg1)) as (ifTrue2, ifFalse2):
                         with ifTrue2:  # arg1 == -inf   Note: inf is ok but not -inf
                             context.pushException(ValueError, "math domain error")
                     f_floor = runtime_functions.floor64
@@ -436,13 +449,11 @@ class MathFunctionWrapper(Wrapper):
 
             # Check for nonfinite return value with finite arguments passed in
             if impl.check_inf:
-                f_isinf = runtime_functions.isinf_float64
-                with context.ifelse(f_isinf.call(ret)) as (ifTrue, ifFalse):
+                with context.ifelse(native_isinf(ret)) as (ifTrue, ifFalse):
                     with ifTrue:
-                        f_isfinite = runtime_functions.isfinite_float64
                         with context.ifelse(
-                            f_isfinite.call(arg1) if len(args) == 1 else
-                            f_isfinite.call(arg1).bitand(f_isfinite.call(arg2))
+                            native_isfinite(arg1) if len(args) == 1 else
+                            native_isfinite(arg1).bitand(native_isfinite(arg2))
                         ) as (ifTrue2, ifFalse2):
                             with ifTrue2:
                                 context.pushException(OverflowError, 'math range error')
@@ -245,6 +245,16 @@ class MinMaxWrapper(Wrapper):
 
         return super().convert_call(context, expr, args, kwargs)
 
+    def convert_call_on_container_expression(self, context, inst, argExpr):
+        if argExpr.matches.GeneratorExp:
+            # run the generator's loops directly rather than building a Generator and iterating it
+            return context.convert_generator_as_reduction(argExpr, self.reductionConversionContextType())
+
+        return super().convert_call_on_container_expression(context, inst, argExpr)
+
+    def reductionConversionContextType(self):
+        raise NotImplementedError(self)
+
 
 class MinWrapper(MinMaxWrapper):
     def __init__(self):
@@ -258,6 +268,11 @@ class MinWrapper(MinMaxWrapper):
             min
         )
 
+    def reductionConversionContextType(self):
+        from typed_python.compiler.function_conversion_context import MinComprehensionConversionContext
+
+        return MinComprehensionConversionContext
+
 
 class MaxWrapper(MinMaxWrapper):
     def __init__(self):
@@ -270,3 +285,8 @@ class MaxWrapper(MinMaxWrapper):
             i_max_key_default,
             max
         )
+
+    def reductionConversionContextType(self):
+        from typed_python.compiler.function_conversion_context import MaxComprehensionConversionContext
+
+        return MaxComprehensionConversionContext
@@ -18,6 +18,7 @@ from typed_python import _types, OneOf, PointerTo
 from typed_python.compiler.typed_expression import TypedExpression
 from typed_python.compiler.conversion_level import ConversionLevel
 import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler.performance_lint as performance_lint
 import typed_python.compiler
 
 typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
@@ -35,17 +36,24 @@ class OneOfWrapper(Wrapper):
         assert hasattr(t, '__typed_python_category__')
         super().__init__(t)
 
-        excessBytes = _types.bytecount(t)-1
+        # if set, we're OneOf(None, T) for a T that's a pointer that's never null,
+        # and we're laid out as a T that's nullptr when we hold None.
+        self.nullNicheIndex = _types.oneof_null_niche_index(t)
 
-        self.layoutType = native_ast.Type.Struct(
-            element_types=(
-                ('which', native_ast.UInt8),
-                ('data', native_ast.Type.Array(element_type=native_ast.UInt8, count=excessBytes))
-            ),
-            name='OneOfLayout'
-        )
+        if self.nullNicheIndex is not None:
+            self.layoutType = typeWrapper(t.Types[self.nullNicheIndex]).getNativeLayoutType()
+        else:
+            excessBytes = _types.bytecount(t)-1
+
+            self.layoutType = native_ast.Type.Struct(
+                element_types=(
+                    ('which', native_ast.UInt8),
+                    ('data', native_ast.Type.Array(element_type=native_ast.UInt8, count=excessBytes))
+                ),
+                name='OneOfLayout'
+            )
 
-        self._is_pod = all(typeWrapper(possibility).is_pod for possibility in t.Types)
+        self._is_pod = self.nullNicheIndex is None and all(typeWrapper(possibility).is_pod for possibility in t.Types)
 
     @property
     def is_pod(self):
@@ -55,8 +63,31 @@ class OneOfWrapper(Wrapper):
         return self.layoutType
 
     def convert_which_native(self, expr):
+        if self.nullNicheIndex is not None:
+            asInt = expr.cast(native_ast.VoidPtr.pointer()).load().cast(native_ast.Int64)
+
+            # the nullptr is None, which is whichever type isn't at 'nullNicheIndex'
+            if self.nullNicheIndex == 0:
+                return asInt.eq(0).cast(native_ast.UInt8)
+            else:
+                return asInt.neq(0).cast(native_ast.UInt8)
+
         return expr.ElementPtrIntegers(0, 0).load()
 
+    def convert_store_which_native(self, expr, which):
+        """Mark the OneOf at pointer 'expr' as holding its 'which'th type.
+
+        Do this after initializing the value, since storing None in a
+        null-niche OneOf is what writes the nullptr.
+        """
+        if self.nullNicheIndex is not None:
+            if which == self.nullNicheIndex:
+                return native_ast.nullExpr
+
+            return expr.cast(native_ast.VoidPtr.pointer()).store(native_ast.VoidPtr.zero())
+
+        return expr.ElementPtrIntegers(0, 0).store(native_ast.const_uint8_expr(which))
+
     def get_iteration_expressions(self, context, expr):
         itExprs = None
 
@@ -85,6 +116,11 @@ class OneOfWrapper(Wrapper):
 
             return itExprs
 
+    def noteDispatch(self, context, operation):
+        context.functionContext.notePerformance(
+            performance_lint.ONEOF_DISPATCH, f"{operation} dispatches on the type held by a {self.typeRepresentation.__name__}"
+        )
+
     def unwrap(self, context, expr, generator):
         """Call 'generator' on 'expr' cast down to each subtype and combine the results.
         """
@@ -129,6 +165,8 @@ class OneOfWrapper(Wrapper):
         return out_slot
 
     def convert_attribute(self, context, instance, attribute):
+        self.noteDispatch(context, f"attribute '.{attribute}'")
+
         return context.expressionAsFunctionCall(
             "oneof_attribute",
             (instance,),
@@ -141,6 +179,8 @@ class OneOfWrapper(Wrapper):
         )
 
     def convert_method_call(self, context, instance, methodName, args, kwargs):
+        self.noteDispatch(context, f"method '{methodName}'")
+
         # just unwrap us
         kwargNames = list(kwargs)
         kwargVals = tuple(kwargs.values())
@@ -168,6 +208,8 @@ class OneOfWrapper(Wrapper):
         )
 
     def convert_call(self, context, instance, args, kwargs):
+        self.noteDispatch(context, "call")
+
         # just unwrap us
         kwargNames = list(kwargs)
         kwargVals = tuple(kwargs.values())
@@ -193,22 +235,32 @@ class OneOfWrapper(Wrapper):
         )
 
     def convert_hash(self, context, expr):
+        self.noteDispatch(context, "hash")
+
         # just unwrap us
         return self.unwrap(context, expr, lambda realInstance: realInstance.convert_hash())
 
     def convert_getitem(self, context, expr, index):
+        self.noteDispatch(context, "getitem")
+
         # just unwrap us
         return self.unwrap(context, expr, lambda realInstance: realInstance.convert_getitem(index))
 
     def convert_setitem(self, context, expr, index, value):
+        self.noteDispatch(context, "setitem")
+
         # just unwrap us
         return self.unwrap(context, expr, lambda realInstance: realInstance.convert_setitem(index, value))
 
     def convert_getslice(self, context, expr, lower, upper, step):
+        self.noteDispatch(context, "getslice")
+
         # just unwrap us
         return self.unwrap(context, expr, lambda realInstance: realInstance.convert_getslice(lower, upper, step))
 
     def convert_abs(self, context, expr):
+        self.noteDispatch(context, "abs")
+
         return context.expressionAsFunctionCall(
             "oneof_abs",
             (expr,),
@@ -221,6 +273,8 @@ class OneOfWrapper(Wrapper):
         )
 
     def convert_unary_op(self, context, left, op):
+        self.noteDispatch(context, f"unary {type(op).__name__}")
+
         return context.expressionAsFunctionCall(
             "oneof_unaryop",
             (left,),
@@ -285,6 +339,8 @@ class OneOfWrapper(Wrapper):
                         )
                     )
 
+        self.noteDispatch(context, f"binary {type(op).__name__}")
+
         return context.expressionAsFunctionCall(
             "oneof_binop_" + type(op).__name__,
             (left, right),
@@ -300,6 +356,8 @@ class OneOfWrapper(Wrapper):
         assert r.expr_type == self
         assert r.isReference
 
+        self.noteDispatch(context, f"binary {type(op).__name__}")
+
         return context.expressionAsFunctionCall(
             "oneof_binop_reverse",
             (l, r),
@@ -315,7 +373,7 @@ class OneOfWrapper(Wrapper):
         for i, t in enumerate(self.typeRepresentation.Types):
             if _types.is_default_constructible(t):
                 self.refAs(context, target, i).convert_default_initialize()
-                context.pushEffect(target.expr.ElementPtrIntegers(0, 0).store(native_ast.const_uint8_expr(i)))
+                context.pushEffect(self.convert_store_which_native(target.expr, i))
                 return
 
         context.pushException(TypeError, "Can't default-initialize any subtypes of %s" % self.typeRepresentation.__qualname__)
@@ -359,6 +417,9 @@ class OneOfWrapper(Wrapper):
 
         tw = typeWrapper(self.typeRepresentation.Types[which])
 
+        if self.nullNicheIndex is not None:
+            return context.pushReference(tw, expr.expr.cast(tw.getNativeLayoutType().pointer()))
+
         return context.pushReference(
             tw,
             expr.expr.ElementPtrIntegers(0, 1).cast(tw.getNativeLayoutType().pointer())
@@ -386,14 +447,14 @@ class OneOfWrapper(Wrapper):
         assert expr.isReference
         assert other.expr_type == self
 
-        with context.switch(other.expr.ElementPtrIntegers(0, 0).load(),
+        with context.switch(self.convert_which_native(other.expr),
                             range(len(self.typeRepresentation.Types)),
                             False) as indicesAndContexts:
             for ix, subcontext in indicesAndContexts:
                 with subcontext:
                     self.refAs(context, expr, ix).convert_copy_initialize(self.refAs(context, other, ix))
                     context.pushEffect(
-                        expr.expr.ElementPtrIntegers(0, 0).store(native_ast.const_uint8_expr(ix))
+                        self.convert_store_which_native(expr.expr, ix)
                     )
 
     def convert_destroy(self, context, target):
@@ -413,7 +474,7 @@ class OneOfWrapper(Wrapper):
 
     def convert_destroy_inner(self, context, expr):
         if not self.is_pod:
-            with context.switch(expr.expr.ElementPtrIntegers(0, 0).load(),
+            with context.switch(self.convert_which_native(expr.expr),
                                 range(len(self.typeRepresentation.Types)),
                                 False) as indicesAndContexts:
                 for ix, subcontext in indicesAndContexts:
@@ -447,7 +508,7 @@ class OneOfWrapper(Wrapper):
 
         allSucceed = True
 
-        with context.switch(expr.expr.ElementPtrIntegers(0, 0).load(),
+        with context.switch(self.convert_which_native(expr.expr),
                             range(len(self.typeRepresentation.Types)),
                             False) as indicesAndContexts:
             for ix, subcontext in indicesAndContexts:
@@ -514,7 +575,7 @@ class OneOfWrapper(Wrapper):
                     typedTarget.convert_copy_initialize(convertFrom)
 
                     context.pushEffect(
-                        targetVal.expr.ElementPtrIntegers(0, 0).store(native_ast.const_uint8_expr(ix))
+                        self.convert_store_which_native(targetVal.expr, ix)
                     )
                     context.pushEffect(
                         native_ast.Expression.Return(arg=native_ast.const_bool_expr(True))
@@ -536,7 +597,7 @@ class OneOfWrapper(Wrapper):
                         if converted.expr.matches.Constant and converted.expr.val.matches.Int and converted.expr.val.val:
                             # we _definitely_ match
                             context.pushEffect(
-                                targetVal.expr.ElementPtrIntegers(0, 0).store(native_ast.const_uint8_expr(ix))
+                                self.convert_store_which_native(targetVal.expr, ix)
                             )
                             context.pushEffect(
                                 native_ast.Expression.Return(arg=native_ast.const_bool_expr(True))
@@ -551,7 +612,7 @@ class OneOfWrapper(Wrapper):
                             with context.ifelse(converted.nonref_expr) as (ifTrue, ifFalse):
                                 with ifTrue:
                                     context.pushEffect(
-                                        targetVal.expr.ElementPtrIntegers(0, 0).store(native_ast.const_uint8_expr(ix))
+                                        self.convert_store_which_native(targetVal.expr, ix)
                                     )
                                     context.pushEffect(
                                         native_ast.Expression.Return(arg=native_ast.const_bool_expr(True))
@@ -580,6 +641,8 @@ class OneOfWrapper(Wrapper):
         return super().convert_type_call(context, typeInst, args, kwargs)
 
     def convert_builtin(self, f, context, expr, a1=None):
+        self.noteDispatch(context, f"builtin '{f.__name__}'")
+
         return context.expressionAsFunctionCall(
             "oneof_convert_builtin",
             (expr,) + ((a1,) if a1 is not None else ()),
@@ -594,6 +657,8 @@ class OneOfWrapper(Wrapper):
         return expr.unwrap(lambda e: e.convert_builtin(f, a1))
 
     def convert_index_cast(self, context, expr):
+        self.noteDispatch(context, "index")
+
         return context.expressionAsFunctionCall(
             "oneof_convert_index",
             (expr,),
@@ -20,6 +20,7 @@ from typed_python.compiler.conversion_level import ConversionLevel
 from typed_python import PointerTo, pointerTo
 
 import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 import typed_python.compiler
 
 typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
@@ -131,12 +132,38 @@ class PointerToWrapper(Wrapper):
         if attr in ("set", "get", "initialize", "cast", "destroy"):
             return instance.changeType(BoundMethodWrapper.Make(self, attr))
 
+        if attr in self.ATOMIC_METHODS and self.supportsAtomics():
+            return instance.changeType(BoundMethodWrapper.Make(self, attr))
+
+        if attr in self.FUTEX_METHODS and self.supportsFutex():
+            return instance.changeType(BoundMethodWrapper.Make(self, attr))
+
+        if attr == "prefetch":
+            return instance.changeType(BoundMethodWrapper.Make(self, attr))
+
         return typeWrapper(self.typeRepresentation.ElementType).convert_attribute_pointerTo(
             context,
             instance,
             attr
         )
 
+    ATOMIC_METHODS = ("atomicLoad", "atomicStore", "atomicCompareExchange", "atomicFetchAdd", "atomicExchange")
+
+    FUTEX_METHODS = ("futexWait", "futexWake", "sharedFutexWait", "sharedFutexWake")
+
+    def supportsAtomics(self):
+        """Can we operate atomically on what we point to? Only for integers of at least a byte, and floats."""
+        eltWrapper = typeWrapper(self.typeRepresentation.ElementType)
+        layout = eltWrapper.getNativeLayoutType()
+
+        return eltWrapper.is_pod and (layout.matches.Int and layout.bits >= 8 or layout.matches.Float)
+
+    def supportsFutex(self):
+        """Can threads block on what we point to? Only for 32 bit integers."""
+        layout = typeWrapper(self.typeRepresentation.ElementType).getNativeLayoutType()
+
+        return layout.matches.Int and layout.bits == 32
+
     def convert_getitem(self, context, instance, key):
         addedValue = instance + key
 
@@ -188,6 +215,82 @@ class PointerToWrapper(Wrapper):
             if len(args) == 0:
                 return context.pushReference(self.typeRepresentation.ElementType, instance.nonref_expr)
 
+        # sequentially consistent atomic operations, for building lock-free datastructures
+        if methodname in self.ATOMIC_METHODS and self.supportsAtomics():
+            ElementType = self.typeRepresentation.ElementType
+
+            vals = [a.convert_to_type(ElementType, ConversionLevel.Implicit) for a in args]
+            if any(v is None for v in vals):
+                return None
+
+            if methodname == "atomicLoad" and len(vals) == 0:
+                return context.pushPod(ElementType, instance.nonref_expr.atomic_load())
+
+            if methodname == "atomicStore" and len(vals) == 1:
+                context.pushEffect(instance.nonref_expr.atomic_store(vals[0].nonref_expr))
+                return context.pushVoid()
+
+            if methodname == "atomicCompareExchange" and len(vals) == 2:
+                # returns what was there before, which equals 'expected' iff we stored 'val'
+                return context.pushPod(
+                    ElementType,
+                    instance.nonref_expr.atomic_compare_exchange(vals[0].nonref_expr, vals[1].nonref_expr)
+                )
+
+            # both return what was there before
+            if methodname == "atomicFetchAdd" and len(vals) == 1:
+                return context.pushPod(ElementType, instance.nonref_expr.atomic_fetch_add(vals[0].nonref_expr))
+
+            if methodname == "atomicExchange" and len(vals) == 1:
+                return context.pushPod(ElementType, instance.nonref_expr.atomic_exchange(vals[0].nonref_expr))
+
+        # block until another thread calls 'futexWake' on the same address, for
+        # building locks. See np_futex_wait in _runtime.cpp. The 'shared' versions
+        # work across processes, on memory that's mapped into all of them.
+        if methodname in ("futexWait", "sharedFutexWait") and len(args) in (1, 2) and self.supportsFutex():
+            expected = args[0].convert_to_type(self.typeRepresentation.ElementType, ConversionLevel.Implicit)
+            timeout = args[1].toInt64() if len(args) == 2 else context.constant(-1)
+
+            if expected is None or timeout is None:
+                return None
+
+            return context.pushPod(
+                bool,
+                runtime_functions.futex_wait.call(
+                    instance.nonref_expr.cast(native_ast.Int32.pointer()),
+                    expected.nonref_expr,
+                    timeout.nonref_expr,
+                    native_ast.const_bool_expr(methodname == "sharedFutexWait")
+                )
+            )
+
+        if methodname in ("futexWake", "sharedFutexWake") and len(args) == 1 and self.supportsFutex():
+            count = args[0].toInt64()
+
+            if count is None:
+                return None
+
+            context.pushEffect(
+                runtime_functions.futex_wake.call(
+                    instance.nonref_expr.cast(native_ast.Int32.pointer()),
+                    count.nonref_expr,
+                    native_ast.const_bool_expr(methodname == "sharedFutexWake")
+                )
+            )
+            return context.pushVoid()
+
+        # ask the cpu to start loading what we point to, because we'll read it soon
+        if methodname == "prefetch" and len(args) == 0:
+            context.pushEffect(
+                runtime_functions.prefetch.call(
+                    instance.nonref_expr.cast(native_ast.UInt8Ptr),
+                    native_ast.const_int32_expr(0),
+                    native_ast.const_int32_expr(3),
+                    native_ast.const_int32_expr(1)
+                )
+            )
+            return context.pushVoid()
+
         if methodname == "cast":
             if len(args) == 1 and isinstance(args[0].expr_type, PythonTypeObjectWrapper):
                 tgtType = typeWrapper(PointerTo(args[0].expr_type.typeRepresentation.Value))
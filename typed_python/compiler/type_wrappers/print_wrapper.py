@@ -14,10 +14,18 @@
 
 from typed_python.compiler.type_wrappers.wrapper import Wrapper
 import typed_python.compiler.native_ast as native_ast
-from typed_python.compiler.type_wrappers.runtime_functions import print_string
+from typed_python.compiler.type_wrappers.runtime_functions import (
+    print_append_str, print_append_int64, print_append_float64, print_end
+)
 
 
 class PrintWrapper(Wrapper):
+    """Compiled 'print'.
+
+    We write each argument into the thread's output buffer (see OutputSink.hpp),
+    formatting ints and floats directly rather than making a str of each, and
+    then end the line, which writes the buffer out unless buffering is on.
+    """
     is_pod = True
     is_empty = False
     is_pass_by_ref = False
@@ -31,6 +39,7 @@ class PrintWrapper(Wrapper):
     def convert_call(self, context, expr, args, kwargs):
         sep = context.constant(" ")
         end = context.constant("\n")
+        flush = context.constant(False)
 
         for kwargName, value in kwargs.items():
             if kwargName == 'sep':
@@ -41,28 +50,45 @@ class PrintWrapper(Wrapper):
                 end = value.toStr()
                 if end is None:
                     return
+            elif kwargName == 'flush':
+                flush = value.toBool()
+                if flush is None:
+                    return
             else:
                 context.pushException(TypeError, f"'{kwargName}' is an invalid keyword argument for this function")
                 return
 
-        res = None
+        # convert everything that could throw before writing anything, so that
+        # a failed print doesn't leave half a line in the buffer
+        pieces = []
 
-        # it would be better to use join
         for a in args:
-            converted = a.toStr()
-            if converted is None:
-                return None
-
-            if res is None:
-                res = converted
+            if a.expr_type.typeRepresentation in (int, float):
+                pieces.append(a)
             else:
-                res = res + sep + converted
+                converted = a.toStr()
+                if converted is None:
+                    return None
+                pieces.append(converted)
 
-        if res is None:
-            res = end
-        else:
-            res = res + end
+        for i, piece in enumerate(pieces):
+            if i:
+                self.append(context, sep)
+            self.append(context, piece)
 
-        context.pushEffect(print_string.call(res.nonref_expr.cast(native_ast.VoidPtr)))
+        self.append(context, end)
+
+        context.pushEffect(print_end.call(flush.nonref_expr))
 
         return context.pushVoid()
+
+    @staticmethod
+    def append(context, piece):
+        T = piece.expr_type.typeRepresentation
+
+        if T is int:
+            context.pushEffect(print_append_int64.call(piece.nonref_expr))
+        elif T is float:
+            context.pushEffect(print_append_float64.call(piece.nonref_expr))
+        else:
+            context.pushEffect(print_append_str.call(piece.nonref_expr.cast(native_ast.VoidPtr)))
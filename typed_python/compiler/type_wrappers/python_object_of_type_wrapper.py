@@ -18,8 +18,10 @@ from typed_python.compiler.type_wrappers.refcounted_wrapper import RefcountedWra
 from typed_python.compiler.type_wrappers.bound_method_wrapper import BoundMethodWrapper
 from typed_python.compiler.conversion_level import ConversionLevel
 from typed_python.compiler.typed_expression import TypedExpression
-from typed_python import OneOf
+from typed_python import OneOf, sha_hash
+from typed_python.compiler.global_variable_definition import GlobalVariableMetadata
 import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler.performance_lint as performance_lint
 from typed_python.compiler.native_ast import VoidPtr, UInt64
 import typed_python
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
@@ -95,11 +97,23 @@ class PythonObjectOfTypeWrapper(RefcountedWrapper):
 
         assert isinstance(attr, str)
 
+        functionContext = context.functionContext
+
+        # each call site gets its own cache
+        attributeCache = native_ast.Expression.GlobalVariable(
+            name="pyattr_cache_"
+            + sha_hash((functionContext.name, functionContext.currentLineNumber, attr)).hexdigest
+            + "_" + attr[:20],
+            type=native_ast.Type.Array(element_type=native_ast.Int64, count=4),
+            metadata=GlobalVariableMetadata.PyAttributeCache(attr=attr)
+        )
+
         return context.push(
             object,
             lambda targetSlot: targetSlot.expr.store(
-                runtime_functions.getattr_pyobj.call(
+                runtime_functions.cached_getattr_pyobj.call(
                     instance.nonref_expr.cast(VoidPtr),
+                    attributeCache.cast(VoidPtr),
                     native_ast.const_utf8_cstr(attr)
                 ).cast(self.getNativeLayoutType())
             )
@@ -330,6 +344,10 @@ class PythonObjectOfTypeWrapper(RefcountedWrapper):
         t = target_type.typeRepresentation
 
         if not issubclass(t, OneOf):
+            context.functionContext.notePerformance(
+                performance_lint.FROM_PYTHON, f"convert {self.typeRepresentation.__name__} to {t.__name__}"
+            )
+
             return context.pushPod(
                 bool,
                 runtime_functions.pyobj_to_typed.call(
@@ -360,6 +378,8 @@ class PythonObjectOfTypeWrapper(RefcountedWrapper):
         if not sourceVal.isReference:
             sourceVal = context.pushMove(sourceVal)
 
+        context.functionContext.notePerformance(performance_lint.TO_PYTHON, f"convert {t.__name__} to object")
+
         context.pushEffect(
             targetVal.expr.store(
                 runtime_functions.to_pyobj.call(
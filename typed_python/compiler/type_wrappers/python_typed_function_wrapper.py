@@ -203,7 +203,7 @@ class PythonTypedFunctionWrapper(Wrapper):
                 t = t.ElementTypes[pathElt]
             elif isinstance(pathElt, str):
                 if issubclass(t, NamedTuple):
-                    t = t.ElementTypes[t.ElementNames.find(pathElt)]
+                    t = t.ElementTypes[t.ElementNames.index(pathElt)]
                 elif issubclass(t, Class):
                     if pathElt not in t.MemberNames:
                         # this can happen when be bind a variable to a closure
@@ -322,7 +322,7 @@ class PythonTypedFunctionWrapper(Wrapper):
 
         return self.convert_comprehension(context, instance, DictComprehensionConversionContext)
 
-    def convert_comprehension(self, context, instance, ConvertionContextType):
+    def convert_comprehension(self, context, instance, ConvertionContextType, outputType=None):
         # we should have exactly one overload that takes no arguments and has no return type
         assert len(self.typeRepresentation.overloads) == 1
         overload = self.typeRepresentation.overloads[0]
@@ -350,7 +350,7 @@ class PythonTypedFunctionWrapper(Wrapper):
             list(overload.funcGlobalsInCells),
             list(overload.closureVarLookups),
             [typeWrapper(self.closurePathToCellType(path, closureType)) for path in overload.closureVarLookups.values()],
-            None,
+            outputType,
             conversionType=ConvertionContextType
         )
 
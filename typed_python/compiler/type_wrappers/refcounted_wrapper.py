@@ -15,6 +15,7 @@
 from typed_python.compiler.type_wrappers.wrapper import Wrapper
 from typed_python.compiler.typed_expression import TypedExpression
 import typed_python.compiler.native_ast as native_ast
+from typed_python.compiler.refcount_elision import markRefcountCopy
 
 
 class RefcountedWrapper(Wrapper):
@@ -73,23 +74,16 @@ class RefcountedWrapper(Wrapper):
         other = other.nonref_expr
 
         if self.CAN_BE_NULL:
-            context.pushEffect(
-                native_ast.Expression.Branch(
-                    cond=other,
-                    false=expr.store(other),
-                    true=(
-                        expr.store(other) >>
-                        self.get_refcount_ptr_expr(expr.load()).atomic_add(1) >>
-                        native_ast.nullExpr
-                    )
-                )
+            incref = native_ast.Expression.Branch(
+                cond=expr.load(),
+                false=native_ast.nullExpr,
+                true=self.get_refcount_ptr_expr(expr.load()).atomic_add(1) >> native_ast.nullExpr
             )
         else:
-            context.pushEffect(
-                expr.store(other) >>
-                self.get_refcount_ptr_expr(expr.load()).atomic_add(1) >>
-                native_ast.nullExpr
-            )
+            incref = self.get_refcount_ptr_expr(expr.load()).atomic_add(1) >> native_ast.nullExpr
+
+        # tagged so that 'elideRefcounts' can turn it into a borrow
+        context.pushEffect(markRefcountCopy(expr.store(other), incref))
 
     def convert_destroy(self, context, target):
         res = context.expressionAsFunctionCall(
@@ -14,6 +14,7 @@
 
 import typed_python.compiler.native_ast as native_ast
 import typed_python.python_ast as python_ast
+from typed_python import _types
 
 
 Bool = native_ast.Bool
@@ -120,8 +121,12 @@ free = externalCallTarget("tp_free", Void, UInt8Ptr)
 malloc = externalCallTarget("tp_malloc", UInt8Ptr, Int64)
 
 realloc = externalCallTarget("tp_realloc", UInt8Ptr, UInt8Ptr, Int64, Int64)
+tp_push_arena = externalCallTarget("tp_push_arena", Void, Int64)
+tp_pop_arena = externalCallTarget("tp_pop_arena", Bool)
+tp_arena_depth = externalCallTarget("tp_arena_depth", Int64)
 memcpy = externalCallTarget("memcpy", UInt8Ptr, UInt8Ptr, UInt8Ptr, Int64)
 memmove = externalCallTarget("memmove", UInt8Ptr, UInt8Ptr, UInt8Ptr, Int64)
+memcmp = externalCallTarget("memcmp", Int32, UInt8Ptr, UInt8Ptr, Int64)
 
 computeTypeClassDispatchTable = externalCallTarget(
     "computeTypeClassDispatchTable", Void.pointer(), Void.pointer(), Void.pointer()
@@ -129,19 +134,22 @@ computeTypeClassDispatchTable = externalCallTarget(
 
 secondsSinceEpoch = externalCallTarget("np_secondsSinceEpoch", Float64)
 
-acos64 = externalCallTarget("np_acos_float64", Float64, Float64)
+# the functions below that call plain libm symbols leave any python-level error
+# checking to the caller (see MathFunctionWrapper), so that llvm can see what they
+# are and treat them as pure (see PURE_EXTERNAL_FUNCTIONS in native_ast_to_llvm).
+acos64 = externalCallTarget("acos", Float64, Float64)
 
-acosh64 = externalCallTarget("np_acosh_float64", Float64, Float64)
+acosh64 = externalCallTarget("acosh", Float64, Float64)
 
-asin64 = externalCallTarget("np_asin_float64", Float64, Float64)
+asin64 = externalCallTarget("asin", Float64, Float64)
 
-asinh64 = externalCallTarget("np_asinh_float64", Float64, Float64)
+asinh64 = externalCallTarget("asinh", Float64, Float64)
 
-atan64 = externalCallTarget("np_atan_float64", Float64, Float64)
+atan64 = externalCallTarget("atan", Float64, Float64)
 
-atan2_64 = externalCallTarget("np_atan2_float64", Float64, Float64, Float64)
+atan2_64 = externalCallTarget("atan2", Float64, Float64, Float64)
 
-atanh64 = externalCallTarget("np_atanh_float64", Float64, Float64)
+atanh64 = externalCallTarget("atanh", Float64, Float64)
 
 ceil64 = externalCallTarget("llvm.ceil.f64", Float64, Float64, intrinsic=True)
 
@@ -149,15 +157,15 @@ copysign64 = externalCallTarget("llvm.copysign.f64", Float64, Float64, Float64,
 
 cos64 = externalCallTarget("llvm.cos.f64", Float64, Float64, intrinsic=True)
 
-cosh64 = externalCallTarget("np_cosh_float64", Float64, Float64)
+cosh64 = externalCallTarget("cosh", Float64, Float64)
 
-erf64 = externalCallTarget("np_erf_float64", Float64, Float64)
+erf64 = externalCallTarget("erf", Float64, Float64)
 
-erfc64 = externalCallTarget("np_erfc_float64", Float64, Float64)
+erfc64 = externalCallTarget("erfc", Float64, Float64)
 
 exp64 = externalCallTarget("llvm.exp.f64", Float64, Float64, intrinsic=True)
 
-expm1_64 = externalCallTarget("np_expm1_float64", Float64, Float64)
+expm1_64 = externalCallTarget("expm1", Float64, Float64)
 
 fabs64 = externalCallTarget("llvm.fabs.f64", Float64, Float64, intrinsic=True)
 
@@ -166,7 +174,7 @@ factorial64 = externalCallTarget("np_factorial64", Float64, Float64)
 
 floor64 = externalCallTarget("llvm.floor.f64", Float64, Float64, intrinsic=True)
 
-fmod64 = externalCallTarget("np_fmod_float64", Float64, Float64, Float64)
+fmod64 = externalCallTarget("fmod", Float64, Float64, Float64)
 
 frexp64 = externalCallTarget("np_frexp_float64", Void, Float64, Void.pointer())
 
@@ -182,7 +190,7 @@ lgamma64 = externalCallTarget("np_lgamma_float64", Float64, Float64)
 
 log64 = externalCallTarget("llvm.log.f64", Float64, Float64, intrinsic=True)
 
-log1p64 = externalCallTarget("np_log1p_float64", Float64, Float64)
+log1p64 = externalCallTarget("log1p", Float64, Float64)
 
 log2_64 = externalCallTarget("llvm.log2.f64", Float64, Float64, intrinsic=True)
 
@@ -196,22 +204,38 @@ remainder64 = externalCallTarget("llvm.frem.f64", Float64, Float64, Float64, int
 
 sin64 = externalCallTarget("llvm.sin.f64", Float64, Float64, intrinsic=True)
 
-sinh64 = externalCallTarget("np_sinh_float64", Float64, Float64)
+sinh64 = externalCallTarget("sinh", Float64, Float64)
 
 sqrt64 = externalCallTarget("llvm.sqrt.f64", Float64, Float64, intrinsic=True)
 
-tan64 = externalCallTarget("np_tan_float64", Float64, Float64)
+tan64 = externalCallTarget("tan", Float64, Float64)
 
-tanh64 = externalCallTarget("np_tanh_float64", Float64, Float64)
+tanh64 = externalCallTarget("tanh", Float64, Float64)
 
 trunc64 = externalCallTarget("llvm.trunc.f64", Float64, Float64, intrinsic=True)
 
+# llvm.bswap, keyed by the native int type to swap. Signed and unsigned ints of
+# a width share the intrinsic, since llvm ints carry no sign.
+bswap = {
+    t: externalCallTarget("llvm.bswap.i%s" % t.bits, t, t, intrinsic=True)
+    for t in [Int16, Int32, Int64, UInt16, UInt32, UInt64]
+}
+
 initialize_exception = externalCallTarget(
     "np_initialize_exception",
     Void,
     Void.pointer()
 )
 
+# (excType, arg, argType): see NativeException.hpp
+initialize_native_exception = externalCallTarget(
+    "np_initialize_native_exception",
+    Void,
+    Void.pointer(),
+    Void.pointer(),
+    Void.pointer()
+)
+
 initialize_exception_w_cause = externalCallTarget(
     "np_initialize_exception_w_cause",
     Void,
@@ -457,6 +481,16 @@ getattr_pyobj = externalCallTarget(
     canThrow=True
 )
 
+# takes a pointer to the call site's PyAttributeCache (see _runtime.cpp)
+cached_getattr_pyobj = externalCallTarget(
+    "np_pyobj_getattr_cached",
+    Void.pointer(),
+    Void.pointer(),
+    Void.pointer(),
+    UInt8Ptr,
+    canThrow=True
+)
+
 setattr_pyobj = externalCallTarget(
     "nativepython_runtime_setattr_pyobj",
     Void,
@@ -771,6 +805,12 @@ bytes_from_ptr_and_len = externalCallTarget(
     UInt8Ptr, Int64
 )
 
+bytes_zeros = externalCallTarget(
+    "nativepython_runtime_bytes_zeros",
+    Void.pointer(),
+    Int64
+)
+
 bytes_join = externalCallTarget(
     "nativepython_runtime_bytes_join",
     Void,
@@ -859,6 +899,72 @@ bytes_replace = externalCallTarget(
     Int64
 )
 
+bytes_find = externalCallTarget(
+    "nativepython_runtime_bytes_find",
+    Int64,
+    Void.pointer(), Void.pointer(), Int64, Int64
+)
+
+bytes_rfind = externalCallTarget(
+    "nativepython_runtime_bytes_rfind",
+    Int64,
+    Void.pointer(), Void.pointer(), Int64, Int64
+)
+
+bytes_count = externalCallTarget(
+    "nativepython_runtime_bytes_count",
+    Int64,
+    Void.pointer(), Void.pointer(), Int64, Int64
+)
+
+buffer_find = externalCallTarget(
+    "nativepython_runtime_buffer_find",
+    Int64,
+    UInt8Ptr, Int64, Void.pointer(), Int64, Int64
+)
+
+regex_search_str = externalCallTarget(
+    "np_regex_search_str",
+    Bool,
+    Int64, Void.pointer(), Int64, Int64, Int64, Int64.pointer()
+)
+
+regex_search_bytes = externalCallTarget(
+    "np_regex_search_bytes",
+    Bool,
+    Int64, Void.pointer(), Int64, Int64, Int64, Int64.pointer()
+)
+
+file_read = externalCallTarget(
+    "np_file_read",
+    Int64,
+    Int64, UInt8Ptr, Int64
+)
+
+file_write = externalCallTarget(
+    "np_file_write",
+    Int64,
+    Int64, UInt8Ptr, Int64
+)
+
+file_write_bytes = externalCallTarget(
+    "np_file_write_bytes",
+    Int64,
+    Int64, Void.pointer()
+)
+
+buffer_rfind = externalCallTarget(
+    "nativepython_runtime_buffer_rfind",
+    Int64,
+    UInt8Ptr, Int64, Void.pointer(), Int64, Int64
+)
+
+buffer_count = externalCallTarget(
+    "nativepython_runtime_buffer_count",
+    Int64,
+    UInt8Ptr, Int64, Void.pointer(), Int64, Int64
+)
+
 bytes_decode = externalCallTarget(
     "nativepython_runtime_bytes_decode",
     Void.pointer(),
@@ -896,6 +1002,30 @@ print_string = externalCallTarget(
     Void.pointer()
 )
 
+print_append_str = externalCallTarget(
+    "np_print_append_str",
+    Void,
+    Void.pointer()
+)
+
+print_append_int64 = externalCallTarget(
+    "np_print_append_int64",
+    Void,
+    Int64
+)
+
+print_append_float64 = externalCallTarget(
+    "np_print_append_float64",
+    Void,
+    Float64
+)
+
+print_end = externalCallTarget(
+    "np_print_end",
+    Void,
+    Bool
+)
+
 int64_to_string = externalCallTarget(
     "nativepython_int64_to_string",
     Void.pointer(),
@@ -920,6 +1050,41 @@ float32_to_string = externalCallTarget(
     Float32
 )
 
+fstring_begin = externalCallTarget(
+    "np_fstring_begin",
+    Void.pointer(),
+    Int64,
+    Int64
+)
+
+fstring_append_str = externalCallTarget(
+    "np_fstring_append_str",
+    Void,
+    Void.pointer(),
+    Void.pointer()
+)
+
+fstring_append_int64 = externalCallTarget(
+    "np_fstring_append_int64",
+    Void,
+    Void.pointer(),
+    Int64
+)
+
+fstring_append_float64 = externalCallTarget(
+    "np_fstring_append_float64",
+    Void,
+    Void.pointer(),
+    Float64
+)
+
+fstring_finish = externalCallTarget(
+    "np_fstring_finish",
+    Void.pointer(),
+    Void.pointer(),
+    Int64
+)
+
 float64_to_int = externalCallTarget(
     "nativepython_float64_to_int",
     Bool,
@@ -953,7 +1118,7 @@ table_create = externalCallTarget(
 
 table_allocate_new_slot = externalCallTarget(
     "nativepython_tableAllocateNewSlot",
-    Int32,
+    Int64,
     Void.pointer(), Int64
 )
 
@@ -976,6 +1141,47 @@ table_compress = externalCallTarget(
     Void.pointer(), Int64
 )
 
+table_compact = externalCallTarget(
+    "nativepython_tableCompact",
+    Void,
+    Void.pointer(), Int64
+)
+
+table_reserve = externalCallTarget(
+    "nativepython_tableReserve",
+    Void,
+    Void.pointer(), Int64, Int64
+)
+
+# if true, the process counts the live instances of each ListOf, TupleOf, Dict and
+# Set type (see TypeLiveCounters.hpp), and compiled code that creates, grows or
+# destroys one has to keep the counts up to date using the functions below.
+type_live_counters = _types.typeLiveCountersEnabled()
+
+table_create_counted = externalCallTarget(
+    "nativepython_tableCreateCounted",
+    Void.pointer(),
+    Void.pointer()
+)
+
+table_stop_counting = externalCallTarget(
+    "nativepython_tableStopCounting",
+    Void,
+    Void.pointer()
+)
+
+type_live_counters_adjust = externalCallTarget(
+    "nativepython_typeLiveCountersAdjust",
+    Void,
+    Void.pointer(), Void.pointer(), Int64
+)
+
+type_live_counters_adjust_bytes = externalCallTarget(
+    "nativepython_typeLiveCountersAdjustBytes",
+    Void,
+    Void.pointer(), Void.pointer(), Int64
+)
+
 hash_float32 = externalCallTarget(
     "nativepython_hash_float32",
     Int32,
@@ -1087,6 +1293,27 @@ pyobj_locktype_lock = externalCallTarget(
     Void.pointer()
 )
 
+futex_wait = externalCallTarget(
+    "np_futex_wait",
+    Bool,
+    Int32.pointer(),
+    Int32,
+    Int64,
+    Bool
+)
+
+futex_wake = externalCallTarget(
+    "np_futex_wake",
+    Void,
+    Int32.pointer(),
+    Int64,
+    Bool
+)
+
+# a hint that we'll read the cache line at this address soon. The arguments
+# after the address are (0=read, 3=keep in all cache levels, 1=data cache)
+prefetch = externalCallTarget("llvm.prefetch.p0i8", Void, UInt8Ptr, Int32, Int32, Int32, intrinsic=True)
+
 pyobj_iter_next = externalCallTarget(
     "np_pyobj_iter_next",
     Void.pointer(),
@@ -1136,6 +1363,21 @@ list_or_tuple_of_to_bytes = externalCallTarget(
     Void.pointer()   # and a Type*
 )
 
+dict_from_columns = externalCallTarget(
+    "tp_dict_from_columns",
+    Void.pointer(),  # returns a hash_table_layout*
+    Void.pointer(),  # accepts a ListOf layout of keys
+    Void.pointer(),  # a ListOf layout of values
+    Void.pointer()   # and the Dict Type*
+)
+
+set_from_list = externalCallTarget(
+    "tp_set_from_list",
+    Void.pointer(),  # returns a hash_table_layout*
+    Void.pointer(),  # accepts a ListOf layout of elements
+    Void.pointer()   # and the Set Type*
+)
+
 list_or_tuple_of_from_bytes = externalCallTarget(
     "tp_list_or_tuple_of_from_bytes",
     Void.pointer(),  # returns a TupleOrListOfType::layout_type*
@@ -1157,6 +1399,18 @@ str_to_float64 = externalCallTarget(
     canThrow=True
 )
 
+str_column_to_int64 = externalCallTarget(
+    "np_str_column_to_int64",
+    Void.pointer(),
+    Void.pointer()
+)
+
+str_column_to_float64 = externalCallTarget(
+    "np_str_column_to_float64",
+    Void.pointer(),
+    Void.pointer()
+)
+
 bytes_to_int64 = externalCallTarget(
     "np_bytes_to_int64",
     Int64,
@@ -1220,6 +1474,26 @@ deserialize_no_context = externalCallTarget(
     Void.pointer()
 )
 
+deserialize_buffer = externalCallTarget(
+    "np_deserialize_buffer",
+    Void,
+    UInt8Ptr,
+    Int64,
+    Void.pointer(),
+    Void.pointer(),
+    Void.pointer(),
+    Void.pointer()
+)
+
+deserialize_buffer_no_context = externalCallTarget(
+    "np_deserialize_buffer_no_context",
+    Void,
+    UInt8Ptr,
+    Int64,
+    Void.pointer(),
+    Void.pointer()
+)
+
 const_dict_sort_kv_pairs = externalCallTarget(
     "np_const_dict_sort_kv_pairs",
     Void,
@@ -18,7 +18,9 @@ import typed_python.compiler.type_wrappers.runtime_functions as runtime_function
 from typed_python.compiler.type_wrappers.bound_method_wrapper import BoundMethodWrapper
 from typed_python.compiler.conversion_level import ConversionLevel
 from typed_python.compiler.type_wrappers.hash_table_implementation import table_next_slot, table_clear, \
-    set_table_contains, set_add, set_add_or_remove, set_remove, set_discard, set_pop
+    table_get_slot, table_bucket_for_key, table_slot_for_key, table_remove_bucket, table_bucket_populated, table_stored_hash, \
+    table_bucket_count, set_table_contains, set_contains_many, set_add, set_add_new_with_hash, set_remove, set_discard, \
+    set_pop
 from typed_python import (
     PointerTo, Int32, UInt8, ListOf, TupleOf, Set, Tuple, NamedTuple, Dict, ConstDict, TypeFunction,
     Class, Held, Final, Member
@@ -109,62 +111,153 @@ def initialize_set_from_other_implicit_containers(ptrToOutSet, iterable, mayThro
     return False
 
 
+# Set algebra between two sets of the same type. These walk the hashtable
+# buckets, so they can reuse the hash stored with each element instead of
+# rehashing it, and size their target once before inserting into it.
+
+def set_update_from_set(left, right):
+    left._reserveForInsertionUnsafe(len(right))
+
+    for bucket in range(table_bucket_count(right)):
+        if table_bucket_populated(right, bucket):
+            itemHash = table_stored_hash(right, bucket)
+            key = right.getKeyByIndexUnsafe(table_get_slot(right, bucket))
+
+            if table_slot_for_key(left, itemHash, key) == -1:
+                set_add_new_with_hash(left, key, itemHash)
+
+
+def set_intersection_update_from_set(left, right):
+    for bucket in range(table_bucket_count(left)):
+        if table_bucket_populated(left, bucket):
+            itemHash = table_stored_hash(left, bucket)
+            key = left.getKeyByIndexUnsafe(table_get_slot(left, bucket))
+
+            if table_slot_for_key(right, itemHash, key) == -1:
+                table_remove_bucket(left, bucket)
+
+
+def set_difference_update_from_set(left, right):
+    if len(right) < len(left):
+        for bucket in range(table_bucket_count(right)):
+            if table_bucket_populated(right, bucket):
+                itemHash = table_stored_hash(right, bucket)
+                leftBucket = table_bucket_for_key(left, itemHash, right.getKeyByIndexUnsafe(table_get_slot(right, bucket)))
+
+                if leftBucket != -1:
+                    table_remove_bucket(left, leftBucket)
+    else:
+        for bucket in range(table_bucket_count(left)):
+            if table_bucket_populated(left, bucket):
+                itemHash = table_stored_hash(left, bucket)
+                key = left.getKeyByIndexUnsafe(table_get_slot(left, bucket))
+
+                if table_slot_for_key(right, itemHash, key) != -1:
+                    table_remove_bucket(left, bucket)
+
+
+def set_symmetric_difference_update_from_set(left, right):
+    left._reserveForInsertionUnsafe(len(right))
+
+    for bucket in range(table_bucket_count(right)):
+        if table_bucket_populated(right, bucket):
+            itemHash = table_stored_hash(right, bucket)
+            key = right.getKeyByIndexUnsafe(table_get_slot(right, bucket))
+            leftBucket = table_bucket_for_key(left, itemHash, key)
+
+            if leftBucket != -1:
+                table_remove_bucket(left, leftBucket)
+            else:
+                set_add_new_with_hash(left, key, itemHash)
+
+
 def set_union(left, right):
     if len(left) >= len(right):
         result = left.copy()
-        for i in right:
-            result.add(i)
+        set_update_from_set(result, right)
     else:
         result = right.copy()
-        for i in left:
-            result.add(i)
+        set_update_from_set(result, left)
     return result
 
 
 def set_intersection(left, right):
+    result = type(left)()
+
     if len(left) > len(right):
-        result = right.copy()
-        for i in right:
-            if i not in left:
-                result.discard(i)
+        set_intersection_into(result, right, left)
     else:
-        result = left.copy()
-        for i in left:
-            if i not in right:
-                result.discard(i)
+        set_intersection_into(result, left, right)
+
     return result
 
 
+def set_intersection_into(result, smaller, larger):
+    result._reserveForInsertionUnsafe(len(smaller))
+
+    for bucket in range(table_bucket_count(smaller)):
+        if table_bucket_populated(smaller, bucket):
+            itemHash = table_stored_hash(smaller, bucket)
+            key = smaller.getKeyByIndexUnsafe(table_get_slot(smaller, bucket))
+
+            if table_slot_for_key(larger, itemHash, key) != -1:
+                set_add_new_with_hash(result, key, itemHash)
+
+
 def set_difference(left, right):
     if len(left) / 4 > len(right):
         result = left.copy()
-        for i in right:
-            result.discard(i)
-    else:
-        result = type(left)()
-        for i in left:
-            if i not in right:
-                result.add(i)
+        set_difference_update_from_set(result, right)
+        return result
+
+    result = type(left)()
+    result._reserveForInsertionUnsafe(len(left))
+
+    for bucket in range(table_bucket_count(left)):
+        if table_bucket_populated(left, bucket):
+            itemHash = table_stored_hash(left, bucket)
+            key = left.getKeyByIndexUnsafe(table_get_slot(left, bucket))
+
+            if table_slot_for_key(right, itemHash, key) == -1:
+                set_add_new_with_hash(result, key, itemHash)
+
     return result
 
 
 def set_symmetric_difference(left, right):
-    if len(left) / 2 > len(right):
+    if len(left) >= len(right):
         result = left.copy()
-        for i in right:
-            set_add_or_remove(result, i)
-    elif len(right) / 2 > len(left):
-        result = right.copy()
-        for i in left:
-            set_add_or_remove(result, i)
+        set_symmetric_difference_update_from_set(result, right)
     else:
-        result = type(left)()
-        for i in left:
-            if i not in right:
-                result.add(i)
-        for i in right:
-            if i not in left:
-                result.add(i)
+        result = right.copy()
+        set_symmetric_difference_update_from_set(result, left)
+    return result
+
+
+def set_inplace_union(left, right):
+    set_update_from_set(left, right)
+    return left
+
+
+def set_inplace_intersection(left, right):
+    set_intersection_update_from_set(left, right)
+    return left
+
+
+def set_inplace_difference(left, right):
+    set_difference_update_from_set(left, right)
+    return left
+
+
+def set_inplace_symmetric_difference(left, right):
+    set_symmetric_difference_update_from_set(left, right)
+    return left
+
+
+# for generic iterables:
+def set_symmetric_difference_iterable(left, right):
+    result = left.copy()
+    set_symmetric_difference_update(result, right)
     return result
 
 
@@ -182,7 +275,7 @@ def set_symmetric_difference_update(left, right):
 
 
 def set_union_multiple(left, *others):
-    result = left
+    result = left.copy()
     for o in others:
         result |= o
     return result
@@ -195,7 +288,7 @@ def set_update(left, *others):
 
 
 def set_intersection_multiple(left, *others):
-    result = left
+    result = left.copy()
     for o in others:
         result &= o
     return result
@@ -219,7 +312,7 @@ def set_intersection_update(left, *others):
 
 
 def set_difference_multiple(left, *others):
-    result = left
+    result = left.copy()
     for o in others:
         result -= o
     return result
@@ -314,7 +407,9 @@ class SetWrapper(RefcountedWrapper):
             ('hash_table_size', native_ast.Int64),
             ('hash_table_count', native_ast.Int64),
             ('hash_table_empty_slots', native_ast.Int64),
-            ('reserved', native_ast.Int64)  # not used
+            ('hash_table_control', native_ast.UInt8Ptr),
+            ('hash_table_wide_slots', native_ast.Int64),
+            ('counted_type', native_ast.UInt8Ptr)
         ), name="SetWrapper").pointer()
 
     def on_refcount_zero(self, context, instance):
@@ -343,6 +438,16 @@ class SetWrapper(RefcountedWrapper):
         return True
 
     def convert_default_initialize(self, context, instance):
+        if runtime_functions.type_live_counters:
+            context.pushEffect(
+                instance.expr.store(
+                    runtime_functions.table_create_counted.call(
+                        context.getTypePointer(self.setType)
+                    ).cast(self.layoutType)
+                )
+            )
+            return
+
         context.pushEffect(
             instance.expr.store(
                 runtime_functions.table_create.call().cast(self.layoutType)
@@ -353,11 +458,11 @@ class SetWrapper(RefcountedWrapper):
         if attr in (
                 "getKeyPtrByIndexUnsafe", "getKeyByIndexUnsafe", "deleteItemByIndexUnsafe",
                 "initializeKeyByIndexUnsafe", "_allocateNewSlotUnsafe", "_resizeTableUnsafe",
-                "_compressItemTableUnsafe",
-                "add", "remove", "discard", "pop", "clear", "copy", "log",
+                "_compressItemTableUnsafe", "_reserveForInsertionUnsafe",
+                "add", "remove", "discard", "pop", "clear", "compact", "copy", "log",
                 "union", "intersection", "difference", "symmetric_difference",
                 "update", "intersection_update", "difference_update", "symmetric_difference_update",
-                "issubset", "issuperset", "isdisjoint", "__iter__"):
+                "issubset", "issuperset", "isdisjoint", "containsMany", "__iter__"):
             return expr.changeType(BoundMethodWrapper.Make(self, attr))
 
         if attr == '_items':
@@ -396,6 +501,18 @@ class SetWrapper(RefcountedWrapper):
                 expr.nonref_expr.ElementPtrIntegers(0, 6).load()
             )
 
+        if attr == '_hash_table_control':
+            return context.pushPod(
+                PointerTo(UInt8),
+                expr.nonref_expr.ElementPtrIntegers(0, 10).load()
+            )
+
+        if attr == '_hash_table_wide_slots':
+            return context.pushPod(
+                int,
+                expr.nonref_expr.ElementPtrIntegers(0, 11).load()
+            )
+
         if attr == '_hash_table_size':
             return context.pushPod(
                 int,
@@ -483,6 +600,22 @@ class SetWrapper(RefcountedWrapper):
                 {}
             )
 
+        # with a single argument of our own type, go straight to the set-to-set versions
+        if len(args) == 1 and args[0].expr_type == instance.expr_type:
+            setToSet = {
+                'union': set_union,
+                'intersection': set_intersection,
+                'difference': set_difference,
+                'symmetric_difference': set_symmetric_difference,
+                'update': set_update_from_set,
+                'intersection_update': set_intersection_update_from_set,
+                'difference_update': set_difference_update_from_set,
+                'symmetric_difference_update': set_symmetric_difference_update_from_set,
+            }.get(methodname)
+
+            if setToSet is not None:
+                return context.call_py_function(setToSet, (instance, args[0]), {})
+
         if methodname == 'union':
             return context.call_py_function(set_union_multiple, (instance, *args), {})
 
@@ -504,7 +637,7 @@ class SetWrapper(RefcountedWrapper):
         if methodname == 'symmetric_difference':
             if len(args) != 1:
                 return context.pushException(TypeError, f"symmetric_difference() takes exactly one argument ({len(args)} given)")
-            return context.call_py_function(set_symmetric_difference, (instance, args[0]), {})
+            return context.call_py_function(set_symmetric_difference_iterable, (instance, args[0]), {})
 
         if methodname == 'symmetric_difference_update':
             if len(args) != 1:
@@ -525,6 +658,15 @@ class SetWrapper(RefcountedWrapper):
                 )
                 return context.pushVoid()
 
+            if methodname == "compact":
+                context.pushEffect(
+                    runtime_functions.table_compact.call(
+                        instance.nonref_expr.cast(native_ast.VoidPtr),
+                        context.constant(self.keyBytecount)
+                    )
+                )
+                return context.pushVoid()
+
             if methodname == "_resizeTableUnsafe":
                 context.pushEffect(
                     runtime_functions.table_resize.call(
@@ -546,7 +688,7 @@ class SetWrapper(RefcountedWrapper):
 
             if methodname == "_allocateNewSlotUnsafe":
                 return context.pushPod(
-                    Int32,
+                    int,
                     runtime_functions.table_allocate_new_slot.call(
                         instance.nonref_expr.cast(native_ast.VoidPtr),
                         context.constant(self.keyBytecount)
@@ -554,6 +696,27 @@ class SetWrapper(RefcountedWrapper):
                 )
 
         if len(args) == 1:
+            if methodname == "_reserveForInsertionUnsafe":
+                count = args[0].toInt64()
+                if count is None:
+                    return None
+
+                context.pushEffect(
+                    runtime_functions.table_reserve.call(
+                        instance.nonref_expr.cast(native_ast.VoidPtr),
+                        context.constant(self.keyBytecount),
+                        count.nonref_expr
+                    )
+                )
+                return context.pushVoid()
+
+            if methodname == "containsMany":
+                keys = args[0].convert_to_type(ListOf(self.keyType.typeRepresentation), ConversionLevel.ImplicitContainers)
+                if keys is None:
+                    return None
+
+                return context.call_py_function(set_contains_many, (instance, keys), {})
+
             if methodname == "isdisjoint":
                 return context.call_py_function(set_disjoint, (instance, args[0]), {})
             if methodname == "issubset":
@@ -649,6 +812,16 @@ class SetWrapper(RefcountedWrapper):
         return context.pushPod(int, self.convert_len_native(expr))
 
     def convert_bin_op(self, context, left, op, right, inplace):
+        if right.expr_type == left.expr_type and inplace:
+            if op.matches.BitOr:
+                return context.call_py_function(set_inplace_union, (left, right), {})
+            if op.matches.BitAnd:
+                return context.call_py_function(set_inplace_intersection, (left, right), {})
+            if op.matches.Sub:
+                return context.call_py_function(set_inplace_difference, (left, right), {})
+            if op.matches.BitXor:
+                return context.call_py_function(set_inplace_symmetric_difference, (left, right), {})
+
         if right.expr_type == left.expr_type:
             if op.matches.BitOr:
                 return context.call_py_function(set_union, (left, right), {})
@@ -696,6 +869,9 @@ class SetWrapper(RefcountedWrapper):
         )
 
     def generateNativeDestructorFunction(self, context, out, inst):
+        if runtime_functions.type_live_counters:
+            context.pushEffect(runtime_functions.table_stop_counting.call(inst.nonref_expr.cast(native_ast.VoidPtr)))
+
         with context.loop(self.convert_items_reserved(context, inst)) as i:
             with context.ifelse(self.convert_slot_populated_native(inst, i)) as (then, otherwise):
                 with then:
@@ -706,6 +882,7 @@ class SetWrapper(RefcountedWrapper):
             runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 2).load().cast(native_ast.UInt8Ptr)) >>
             runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 5).load().cast(native_ast.UInt8Ptr)) >>
             runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 6).load().cast(native_ast.UInt8Ptr)) >>
+            runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 10).load().cast(native_ast.UInt8Ptr)) >>
             runtime_functions.free.call(inst.nonref_expr.cast(native_ast.UInt8Ptr))
         )
 
@@ -737,6 +914,31 @@ class SetWrapper(RefcountedWrapper):
 
         return super().convert_type_call(context, typeInst, args, kwargs)
 
+    def convert_type_attribute(self, context, typeInst, attr):
+        if attr in ('fromList',):
+            return typeInst.changeType(BoundMethodWrapper.Make(typeInst.expr_type, attr))
+
+        return super().convert_type_attribute(context, typeInst, attr)
+
+    def convert_type_method_call(self, context, typeInst, methodname, args, kwargs):
+        if methodname == "fromList" and len(args) == 1 and not kwargs:
+            elements = args[0].convert_to_type(ListOf(self.keyType.typeRepresentation), ConversionLevel.ImplicitContainers)
+            if elements is None:
+                return None
+
+            return context.push(
+                self,
+                lambda newSetPtr:
+                newSetPtr.expr.store(
+                    runtime_functions.set_from_list.call(
+                        elements.nonref_expr.cast(native_ast.VoidPtr),
+                        context.getTypePointer(self.typeRepresentation).cast(native_ast.VoidPtr)
+                    ).cast(self.layoutType)
+                )
+            )
+
+        return super().convert_type_method_call(context, typeInst, methodname, args, kwargs)
+
     def _can_convert_from_type(self, otherType, conversionLevel):
         if not conversionLevel.isImplicitContainersOrHigher():
             # Set only allows 'implicit containers' conversions or higher
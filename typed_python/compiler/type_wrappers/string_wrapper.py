@@ -33,6 +33,7 @@ from typed_python import (
 from typed_python import Class, Final, Member, pointerTo, PointerTo
 
 from typed_python.compiler.native_ast import VoidPtr
+from typed_python._types import parseInt64Column, parseFloat64Column, regexSearch
 
 typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
 
@@ -665,6 +666,72 @@ class StringWrapper(RefcountedWrapper):
 
         return context.pushPod(int, self.convert_len_native(expr.nonref_expr))
 
+    def convert_bytes_per_codepoint_native(self, expr):
+        return native_ast.Expression.Branch(
+            cond=expr,
+            false=native_ast.const_int_expr(1),
+            true=(
+                expr.ElementPtrIntegers(0, 3).load().cast(native_ast.Int64)
+            )
+        )
+
+    # the most characters str() produces for an int or a float
+    MAX_FORMATTED_LENGTH = {int: 20, float: 24}
+
+    def convert_joined_str(self, context, pieces):
+        """Concatenate the str, int, and float expressions in 'pieces', as an f-string does.
+
+        Rather than making a str for each piece and joining them, we bound the
+        size of the result, allocate it once, and format the ints and floats
+        directly into it.
+        """
+        maxPointcount = native_ast.const_int_expr(0)
+        widthMask = native_ast.const_int_expr(1)
+
+        for piece in pieces:
+            T = piece.expr_type.typeRepresentation
+
+            if T is str:
+                if piece.isConstant:
+                    maxCodepoint = max((ord(c) for c in piece.constantValue), default=0)
+
+                    maxPointcount = maxPointcount.add(len(piece.constantValue))
+                    widthMask = widthMask.bitor(1 if maxCodepoint < 0x100 else 2 if maxCodepoint < 0x10000 else 4)
+                else:
+                    maxPointcount = maxPointcount.add(self.convert_len_native(piece.nonref_expr))
+                    widthMask = widthMask.bitor(self.convert_bytes_per_codepoint_native(piece.nonref_expr))
+            else:
+                maxPointcount = maxPointcount.add(self.MAX_FORMATTED_LENGTH[T])
+
+        maxPointcount = context.pushPod(int, maxPointcount)
+
+        def build(out):
+            steps = [out.expr.store(runtime_functions.fstring_begin.call(maxPointcount.nonref_expr, widthMask).cast(self.layoutType))]
+
+            for piece in pieces:
+                T = piece.expr_type.typeRepresentation
+
+                if T is str:
+                    steps.append(
+                        runtime_functions.fstring_append_str.call(
+                            out.nonref_expr.cast(VoidPtr), piece.nonref_expr.cast(VoidPtr)
+                        )
+                    )
+                elif T is int:
+                    steps.append(runtime_functions.fstring_append_int64.call(out.nonref_expr.cast(VoidPtr), piece.nonref_expr))
+                else:
+                    steps.append(runtime_functions.fstring_append_float64.call(out.nonref_expr.cast(VoidPtr), piece.nonref_expr))
+
+            steps.append(
+                out.expr.store(
+                    runtime_functions.fstring_finish.call(out.nonref_expr.cast(VoidPtr), maxPointcount.nonref_expr).cast(self.layoutType)
+                )
+            )
+
+            return native_ast.makeSequence(steps)
+
+        return context.push(str, build)
+
     def constant(self, context, s):
         return typed_python.compiler.typed_expression.TypedExpression(
             context,
@@ -712,7 +779,8 @@ class StringWrapper(RefcountedWrapper):
     _methods = ['split', 'rsplit', 'splitlines', 'join', 'partition', 'rpartition',
                 'strip', 'rstrip', 'lstrip', 'startswith', 'endswith', 'replace',
                 "translate", "maketrans",
-                '__iter__', 'encode', 'center', 'ljust', 'rjust', 'expandtabs', 'splitlines', 'zfill'] \
+                '__iter__', 'encode', 'center', 'ljust', 'rjust', 'expandtabs', 'splitlines', 'zfill',
+                '_codepointUnsafe'] \
         + list(_bool_methods) + list(_str_methods) + list(_find_methods)
 
     def convert_attribute(self, context, instance, attr):
@@ -726,6 +794,29 @@ class StringWrapper(RefcountedWrapper):
         if methodname not in self._methods:
             return super().convert_method_call(context, instance, methodname, args, kwargs)
 
+        if methodname == "_codepointUnsafe" and len(args) == 1 and not kwargs:
+            # ord(s[i]) without making the one-character string, and without
+            # checking 'i', which must be in range. Compiled-code only.
+            ix = args[0].toInt64()
+            if ix is None:
+                return None
+
+            data = instance.nonref_expr.ElementPtrIntegers(0, 4)
+            bytesPerCodepoint = self.convert_bytes_per_codepoint_native(instance.nonref_expr)
+
+            return context.pushPod(
+                int,
+                native_ast.Expression.Branch(
+                    cond=bytesPerCodepoint.eq(1),
+                    true=data.elemPtr(ix.nonref_expr).load().cast(native_ast.Int64),
+                    false=native_ast.Expression.Branch(
+                        cond=bytesPerCodepoint.eq(2),
+                        true=data.cast(native_ast.UInt16.pointer()).elemPtr(ix.nonref_expr).load().cast(native_ast.Int64),
+                        false=data.cast(native_ast.UInt32.pointer()).elemPtr(ix.nonref_expr).load().cast(native_ast.Int64)
+                    )
+                )
+            )
+
         if methodname == "__iter__" and not args and not kwargs:
             return typeWrapper(StringIterator).convert_type_call(
                 context,
@@ -1136,3 +1227,96 @@ class StringMaketransWrapper(Wrapper):
                 return static_str_instance.convert_method_call("maketrans", (args[0], args[1], args[2]), {})
 
         return super().convert_call(context, expr, args, kwargs)
+
+
+class StringColumnParseFunctionWrapper(Wrapper):
+    """Compiled versions of _types.parseInt64Column and parseFloat64Column."""
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    SUPPORTED_FUNCTIONS = (parseInt64Column, parseFloat64Column)
+
+    def __init__(self, f):
+        assert f in self.SUPPORTED_FUNCTIONS
+        super().__init__(f)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) == 1 and not kwargs:
+            strings = args[0].convert_to_type(ListOf(str), ConversionLevel.ImplicitContainers)
+
+            if strings is None:
+                return None
+
+            if self.typeRepresentation is parseInt64Column:
+                outT, fn = ListOf(int), runtime_functions.str_column_to_int64
+            else:
+                outT, fn = ListOf(float), runtime_functions.str_column_to_float64
+
+            return context.push(
+                outT,
+                lambda out: out.expr.store(
+                    fn.call(strings.nonref_expr.cast(VoidPtr)).cast(out.expr_type.getNativeLayoutType())
+                )
+            )
+
+        return super().convert_call(context, expr, args, kwargs)
+
+
+class RegexSearchFunctionWrapper(Wrapper):
+    """The compiled version of _types.regexSearch, which typed_python.lib.regex uses.
+
+    Unlike the interpreted version, this trusts that 'program' came from regexCompile
+    and matches the type of 's', that 'mode' is valid, and that 'spans' is long enough.
+    """
+    is_pod = True
+    is_empty = False
+    is_pass_by_ref = False
+
+    SUPPORTED_FUNCTIONS = (regexSearch,)
+
+    def __init__(self, f):
+        assert f in self.SUPPORTED_FUNCTIONS
+        super().__init__(f)
+
+    def getNativeLayoutType(self):
+        return native_ast.Type.Void()
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) == 6 and not kwargs and args[1].expr_type.typeRepresentation in (str, bytes):
+            s = args[1]
+
+            if s.expr_type.typeRepresentation is str:
+                fn = runtime_functions.regex_search_str
+            else:
+                fn = runtime_functions.regex_search_bytes
+
+            program, pos, endpos, mode = [
+                arg.convert_to_type(int, ConversionLevel.Signature) for arg in (args[0], args[2], args[3], args[4])
+            ]
+            spans = args[5].convert_to_type(ListOf(int), ConversionLevel.Signature)
+
+            if program is None or pos is None or endpos is None or mode is None or spans is None:
+                return None
+
+            spansPtr = spans.convert_method_call("pointerUnsafe", (context.constant(0),), {})
+
+            if spansPtr is None:
+                return None
+
+            return context.pushPod(
+                bool,
+                fn.call(
+                    program.nonref_expr,
+                    s.nonref_expr.cast(VoidPtr),
+                    pos.nonref_expr,
+                    endpos.nonref_expr,
+                    mode.nonref_expr,
+                    spansPtr.nonref_expr.cast(native_ast.Int64.pointer())
+                )
+            )
+
+        return super().convert_call(context, expr, args, kwargs)
@@ -22,6 +22,7 @@ from typed_python.compiler.converter_utils import (
     InitializeRefAsUpcastContainers
 )
 from typed_python.type_function import TypeFunction
+from typed_python.type_promotion import isInteger
 import typed_python.compiler.type_wrappers.runtime_functions as runtime_functions
 from typed_python.compiler.typed_expression import TypedExpression
 
@@ -61,6 +62,21 @@ def tuple_compare_eq(left, right):
     return True
 
 
+def tuple_compare_eq_bitwise(left, right):
+    """Compare two 'TupleOf' instances whose elements have bitwise equality."""
+    if len(left) != len(right):
+        return False
+
+    if not len(left):
+        return True
+
+    return BytesEqual()(left.pointerUnsafe(0), right.pointerUnsafe(0), len(left))
+
+
+def tuple_compare_neq_bitwise(left, right):
+    return not tuple_compare_eq_bitwise(left, right)
+
+
 def tuple_compare_lt(left, right):
     """Compare two 'TupleOf' instances by comparing their individual elements."""
     for i in range(min(len(left), len(right))):
@@ -110,6 +126,52 @@ def tuple_of_hash(instance):
     return val
 
 
+def hasBitwiseEquality(T):
+    """Are two instances of T equal exactly when their bytes are?
+
+    This mirrors Type::hasBitwiseEquality: integers and bools, and Tuples and
+    NamedTuples made only of them.
+    """
+    if isInteger(T):
+        return True
+
+    if isinstance(T, type) and issubclass(T, (Tuple, NamedTuple)):
+        return all(hasBitwiseEquality(E) for E in T.ElementTypes)
+
+    return False
+
+
+class BytesEqual(CompilableBuiltin):
+    """Check whether 'count' elements behind two PointerTo(T) are bytewise equal.
+
+    Only use this where hasBitwiseEquality(T).
+    """
+    def __eq__(self, other):
+        return isinstance(other, BytesEqual)
+
+    def __hash__(self):
+        return hash("BytesEqual")
+
+    def convert_call(self, context, instance, args, kwargs):
+        if len(args) == 3 and not kwargs and args[0].expr_type == args[1].expr_type:
+            count = args[2].toInt64()
+            if count is None:
+                return None
+
+            bytesPer = typeWrapper(args[0].expr_type.typeRepresentation.ElementType).getBytecount()
+
+            return context.pushPod(
+                bool,
+                runtime_functions.memcmp.call(
+                    args[0].nonref_expr.cast(native_ast.UInt8Ptr),
+                    args[1].nonref_expr.cast(native_ast.UInt8Ptr),
+                    count.nonref_expr.mul(native_ast.const_int_expr(bytesPer))
+                ).eq(native_ast.const_int32_expr(0))
+            )
+
+        return super().convert_call(context, instance, args, kwargs)
+
+
 class PreReservedTupleOrList(CompilableBuiltin):
     def __init__(self, tupleType):
         super().__init__()
@@ -144,15 +206,18 @@ class PreReservedTupleOrList(CompilableBuiltin):
                         context.pushEffect(
                             self.initializeEmptyListExpr(out, length)
                         )
+                        self.tupleTypeWrapper.adjustLiveInstances(context, out, 1)
 
                 context.markUninitializedSlotInitialized(out)
 
                 return out
             else:
-                return context.push(
+                out = context.push(
                     self.tupleType,
                     lambda out: self.initializeEmptyListExpr(out, length)
                 )
+                self.tupleTypeWrapper.adjustLiveInstances(context, out, 1)
+                return out
 
         return super().convert_call(context, instance, args, kwargs)
 
@@ -349,14 +414,45 @@ class TupleOrListOfWrapper(RefcountedWrapper):
             .call(instance)
         )
 
+    def adjustLiveInstances(self, context, inst, sign):
+        """Count 'sign' instances of our type if we're keeping type live counters."""
+        if runtime_functions.type_live_counters:
+            context.pushEffect(
+                runtime_functions.type_live_counters_adjust.call(
+                    context.getTypePointer(self.typeRepresentation),
+                    inst.nonref_expr.cast(native_ast.VoidPtr),
+                    sign
+                )
+            )
+
+    def adjustLiveBytes(self, context, inst, sign):
+        """Add or remove the bytes 'inst' holds from our type's live counters, if we keep them."""
+        if runtime_functions.type_live_counters:
+            context.pushEffect(
+                runtime_functions.type_live_counters_adjust_bytes.call(
+                    context.getTypePointer(self.typeRepresentation),
+                    inst.nonref_expr.cast(native_ast.VoidPtr),
+                    sign
+                )
+            )
+
     def generateNativeDestructorFunction(self, context, out, inst):
+        self.adjustLiveInstances(context, inst, -1)
+
         if not self.underlyingWrapperType.is_pod:
             with context.loop(inst.convert_len()) as i:
                 inst.convert_getitem_unsafe(i).convert_destroy()
 
-        context.pushEffect(
-            runtime_functions.free.call(inst.nonref_expr.ElementPtrIntegers(0, 4).load())
-        )
+        # tuples built by the interpreter may hold their elements inline, directly
+        # after the layout (see TupleOrListOfType::hasInlineData), in which case
+        # there's no separate data block to free.
+        data = inst.nonref_expr.ElementPtrIntegers(0, 4).load()
+        inlineData = inst.nonref_expr.ElementPtrIntegers(1).cast(native_ast.UInt8Ptr)
+
+        with context.ifelse(data.cast(native_ast.Int64).eq(inlineData.cast(native_ast.Int64))) as (isInline, notInline):
+            with notInline:
+                context.pushEffect(runtime_functions.free.call(data))
+
         context.pushEffect(
             runtime_functions.free.call(inst.nonref_expr.cast(native_ast.UInt8Ptr))
         )
@@ -367,6 +463,12 @@ class TupleOrListOfWrapper(RefcountedWrapper):
                 return context.call_py_function(concatenate_tuple_or_list, (left, right), {})
 
         if right.expr_type == left.expr_type:
+            if hasBitwiseEquality(self.typeRepresentation.ElementType):
+                if op.matches.Eq:
+                    return context.call_py_function(tuple_compare_eq_bitwise, (left, right), {})
+                if op.matches.NotEq:
+                    return context.call_py_function(tuple_compare_neq_bitwise, (left, right), {})
+
             if op.matches.Eq:
                 return context.call_py_function(tuple_compare_eq, (left, right), {})
             if op.matches.NotEq:
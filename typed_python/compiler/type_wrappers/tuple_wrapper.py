@@ -661,7 +661,12 @@ class NamedTupleWrapper(TupleWrapper):
         This function will return a TypedExpression, or None if it set an exception."""
         return self.convert_method_call(context, instance, "__typed_python_int_iter_value__", [], {})
 
-    def convert_attribute(self, context, instance, attribute):
+    def convert_attribute(self, context, instance, attribute, nocheck=False):
+        # closures that hold their variables by value read them with 'nocheck',
+        # and a variable can be called anything, 'replacing' included
+        if nocheck and attribute in self.namesToIndices:
+            return self.refAs(context, instance, self.namesToIndices[attribute])
+
         if attribute in ["replacing"]:
             return instance.changeType(BoundMethodWrapper.Make(self, attribute))
 
@@ -695,6 +700,18 @@ class NamedTupleWrapper(TupleWrapper):
             "'%s' object has no attribute '%s'" % (str(self.typeRepresentation), attribute)
         )
 
+    def convert_len(self, context, instance):
+        if self.has_method("__len__"):
+            return self.convert_method_call(context, instance, "__len__", (), {})
+
+        return super().convert_len(context, instance)
+
+    def convert_getitem(self, context, instance, index):
+        if self.has_method("__getitem__"):
+            return self.convert_method_call(context, instance, "__getitem__", (index,), {})
+
+        return super().convert_getitem(context, instance, index)
+
     def convert_fastnext(self, context, instance):
         if self.isSubclassOfNamedTuple:
             return self.convert_method_call(context, instance, "__fastnext__", [], {})
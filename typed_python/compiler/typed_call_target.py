@@ -37,6 +37,16 @@ class TypedCallTarget:
     def call(self, *args):
         return native_ast.CallTarget.Named(target=self.named_call_target).call(*args)
 
+    def hasSameSignatureAs(self, other):
+        """Would code calling 'other' come out the same as code calling us?"""
+        return (
+            self.named_call_target == other.named_call_target
+            and self.input_types == other.input_types
+            and self.output_type == other.output_type
+            and self.alwaysRaises == other.alwaysRaises
+            and self.functionMetadata.hasSameConstantReturnValueAs(other.functionMetadata)
+        )
+
     @property
     def name(self):
         return self.named_call_target.name
@@ -17,6 +17,7 @@ from typed_python.python_ast import BinaryOp, ComparisonOp, BooleanOp
 import typed_python.compiler.native_ast as native_ast
 import typed_python.compiler
 from typed_python.compiler.conversion_level import ConversionLevel
+from typed_python.compiler.conversion_exception import ConversionException
 
 
 from typed_python.compiler.type_wrappers.wrapper import Wrapper
@@ -51,6 +52,13 @@ class TypedExpression:
         self.isReference = isReference
         self.constantValue = constantValue
 
+        if t is not None and context is not None and context.functionContext.nogil:
+            if getattr(t.typeRepresentation, "__typed_python_category__", None) == "PythonObjectOfType":
+                raise ConversionException(
+                    f"{context.functionContext.name} can't use the python object type {t.typeRepresentation.__name__} "
+                    "because it's compiled with nogil=True"
+                )
+
         if self.constantValue is None and self.expr_type.is_compile_time_constant:
             self.constantValue = self.expr_type.getCompileTimeConstant()
 
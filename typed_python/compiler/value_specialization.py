@@ -0,0 +1,57 @@
+#   Copyright 2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""Entrypoints specialized on the values of some of their arguments.
+
+Normally an Entrypoint gets compiled once per set of argument types, and
+its arguments are runtime values inside the compiled body. A kernel whose
+inner loop is gated by a couple of configuration flags can instead ask for
+
+    @Entrypoint(specializeOn=['mode', 'useWeights'])
+    def kernel(xs: ListOf(float), mode: int, useWeights: bool):
+        ...
+
+and each distinct value of 'mode' and 'useWeights' that reaches it from the
+interpreter gets its own compiled form, in which the argument has type
+Value(x). The converter treats those as constants, so comparisons against
+them fold and the branches they gate disappear before type inference ever
+sees them.
+
+Only arguments whose value is a str, bytes, bool, int or None get specialized
+(floats compare equal across -0.0 and 0.0, and never to a NaN), and only when
+the value already has the type the argument would have been passed as.
+Anything else is passed as usual. Each distinct value costs a compilation, so
+this is for arguments that take a handful of values.
+
+Like nogil, this belongs to the function's code object.
+"""
+
+# code object -> the names of the arguments to specialize on
+_specializedArguments = {}
+
+# types whose values the converter can hold as constants
+SPECIALIZABLE_TYPES = (str, bytes, bool, int, type(None))
+
+
+def setSpecializedArguments(code, argNames):
+    """Compile functions with code object 'code' separately for each value of 'argNames'."""
+    _specializedArguments[code] = frozenset(argNames)
+
+
+def specializedArguments(code):
+    return _specializedArguments.get(code, frozenset())
+
+
+def canSpecializeOn(value):
+    return type(value) in SPECIALIZABLE_TYPES
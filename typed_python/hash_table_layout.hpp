@@ -16,7 +16,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include "Refcount.hpp"
+#include "TypeLiveCounters.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 // for Dict, items would be key, value pairs
 // for Set, items would be keys
@@ -32,13 +39,56 @@ class hash_table_layout {
         , hash_table_hashes(nullptr)
         , hash_table_size(0)
         , hash_table_count(0)
-        , hash_table_empty_slots(0) {}
-
-    // We follow the same hashing scheme as the internals of pythons dictionaries
-    // as detailed here:
-    //      https://hg.python.org/cpython/file/52f68c95e025/Objects/dictobject.c#l296
-
-    enum { EMPTY = -1, DELETED = -2, PERTURB_SHIFT = 5, MIN_SIZE = 8 };
+        , hash_table_empty_slots(0)
+        , hash_table_control(nullptr)
+        , hash_table_wide_slots(0)
+        , counted_type(nullptr) {}
+
+    // The hashtable is open-addressed and split into groups of GROUP_WIDTH
+    // consecutive buckets. Alongside 'hash_table_slots' and 'hash_table_hashes'
+    // we keep one control byte per bucket: CONTROL_EMPTY, CONTROL_DELETED, or a
+    // 7 bit tag taken from the hash of the item in that bucket. Lookups scan a whole
+    // group of control bytes at once (with SSE2 when it's available) and only
+    // touch 'hash_table_slots' and the items for buckets whose tag matches, so
+    // a miss on a large table typically costs a single cache line.
+    //
+    // The tag and the first group both come from 'mixHash', which spreads the
+    // hash across 64 bits with a multiplicative (Fibonacci) mix and then folds
+    // the high half back onto the low half, so every bit we use depends on every
+    // bit of the hash. Keys whose hashes differ only in their high bits (ints
+    // that are multiples of a power of two, tuples of small ints) therefore
+    // still get different tags and groups, and very large tables can use all of
+    // their groups. We then proceed with triangular probing over groups, which visits
+    // every group exactly once because the group count is a power of two. We
+    // stop at the first group containing an empty bucket.
+    // compiler/type_wrappers/hash_table_implementation.py mirrors this scheme
+    // exactly, so the two must be changed together.
+    //
+    // Item slot indices are stored as int32_t until the table holds more than
+    // MAX_NARROW_SLOTS items, at which point 'hash_table_slots' is rewritten as
+    // an array of int64_t and 'hash_table_wide_slots' is set. Always go through
+    // slotAt/setSlotAt to read or write it.
+    //
+    // Most tables only ever hold a handful of items, and for those we don't build
+    // the hashtable at all. While every item lives in one of the first
+    // SMALL_TABLE_SIZE item slots, 'hash_table_slots' and 'hash_table_control' are
+    // null, 'hash_table_size' is zero, and 'hash_table_hashes' holds
+    // SMALL_TABLE_SIZE hashes indexed by item slot, EMPTY where the slot isn't
+    // populated. A lookup compares its hash against all of them at once (with SSE2
+    // when it's available) and only compares keys where the hash matches. In this
+    // mode a 'bucket' is just an item slot. 'add' builds the hashtable once the item
+    // table outgrows SMALL_TABLE_SIZE, and 'resizeTable' drops it again once the
+    // item table is compressed back down to that size.
+
+    enum { EMPTY = -1, DELETED = -2, MIN_SIZE = 16, GROUP_WIDTH = 16, TAG_BITS = 7, SMALL_TABLE_SIZE = 8 };
+
+    enum { CONTROL_EMPTY = 0x80, CONTROL_DELETED = 0xFE };
+
+    static const uint64_t GROUP_HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+    static const uint64_t HASH_MIX_SHIFT = 32;
+
+    static const int64_t MAX_NARROW_SLOTS = 0x7FFFFFFF;
 
     void setTo(int32_t* ptr, int32_t value, size_t count) {
         for (size_t k = 0; k < count; k++) {
@@ -46,72 +96,329 @@ class hash_table_layout {
         }
     }
 
+    static uint64_t mixHash(uint64_t hash) {
+        uint64_t mixed = hash * GROUP_HASH_MULTIPLIER;
+        return mixed ^ (mixed >> HASH_MIX_SHIFT);
+    }
+
+    static uint8_t controlTagFor(uint64_t hash) {
+        return mixHash(hash) & ((1 << TAG_BITS) - 1);
+    }
+
+    // the first group to probe for an item with the given (non-negative) hash
+    uint64_t firstGroupFor(uint64_t hash) const {
+        return (mixHash(hash) >> TAG_BITS) & (hash_table_size / GROUP_WIDTH - 1);
+    }
+
+    size_t bytesPerSlot() const {
+        return hash_table_wide_slots ? sizeof(int64_t) : sizeof(int32_t);
+    }
+
+    int64_t slotAt(size_t bucket) const {
+        if (hash_table_wide_slots) {
+            return ((int64_t*)hash_table_slots)[bucket];
+        }
+        return hash_table_slots[bucket];
+    }
+
+    void setSlotAt(size_t bucket, int64_t slot) {
+        if (hash_table_wide_slots) {
+            ((int64_t*)hash_table_slots)[bucket] = slot;
+        } else {
+            hash_table_slots[bucket] = slot;
+        }
+    }
+
+    // are we holding our items' hashes by item slot rather than in a hashtable?
+    bool isSmall() const {
+        return !hash_table_slots && hash_table_hashes;
+    }
+
+    // allocate the hashes of a small table, with every slot empty
+    void allocateSmallTable() {
+        hash_table_hashes = (typed_python_hash_type*)tp_malloc(SMALL_TABLE_SIZE * sizeof(typed_python_hash_type));
+        setTo(hash_table_hashes, EMPTY, SMALL_TABLE_SIZE);
+    }
+
+    // a bitmask of the item slots of a small table holding the (normalized) 'hash'
+    uint32_t smallTableMatch(typed_python_hash_type hash) const {
+#ifdef __SSE2__
+        __m128i needle = _mm_set1_epi32(hash);
+        __m128i low = _mm_loadu_si128((const __m128i*)hash_table_hashes);
+        __m128i high = _mm_loadu_si128((const __m128i*)(hash_table_hashes + 4));
+
+        return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, needle)))
+            | (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, needle))) << 4);
+#else
+        uint32_t res = 0;
+        for (long k = 0; k < SMALL_TABLE_SIZE; k++) {
+            if (hash_table_hashes[k] == hash) {
+                res |= (1 << k);
+            }
+        }
+        return res;
+#endif
+    }
+
+    // the bytes held by 'hash_table_slots', 'hash_table_hashes' and 'hash_table_control'
+    size_t hashTableFootprint() const {
+        if (isSmall()) {
+            return bytesRequiredForAllocation(sizeof(typed_python_hash_type) * SMALL_TABLE_SIZE);
+        }
+
+        if (!hash_table_slots) {
+            return 0;
+        }
+
+        return bytesRequiredForAllocation(bytesPerSlot() * hash_table_size)
+            + bytesRequiredForAllocation(sizeof(typed_python_hash_type) * hash_table_size)
+            + bytesRequiredForAllocation(hash_table_size);
+    }
+
+    // brackets anything that changes how much storage we hold, so that the
+    // live byte count of 'counted_type' follows it. These nest (allocateNewSlot
+    // calls compressItemTable, for instance) and only the outermost one counts.
+    class StorageChange {
+    public:
+        StorageChange(hash_table_layout* table) : mTable(nullptr) {
+            if (table->counted_type && currentTable() != table) {
+                mTable = table;
+                currentTable() = table;
+                typeLiveCountersAdjustBytes(table->counted_type, table, -1);
+            }
+        }
+
+        ~StorageChange() {
+            if (mTable) {
+                typeLiveCountersAdjustBytes(mTable->counted_type, mTable, 1);
+                currentTable() = nullptr;
+            }
+        }
+
+    private:
+        static hash_table_layout*& currentTable() {
+            static thread_local hash_table_layout* table = nullptr;
+            return table;
+        }
+
+        hash_table_layout* mTable;
+    };
+
+    // count this (newly constructed) table as a live instance of 't'
+    void startCounting(Type* t) {
+        counted_type = t;
+        typeLiveCountersAdjust(t, this, 1);
+    }
+
+    // the bytes we hold, if each item is 'item_size' bytes.
+    size_t footprint(size_t item_size) const {
+        size_t res = bytesRequiredForAllocation(sizeof(hash_table_layout));
+
+        if (items) {
+            res += bytesRequiredForAllocation(items_reserved);
+            res += bytesRequiredForAllocation(items_reserved * item_size);
+        }
+
+        return res + hashTableFootprint();
+    }
+
+    // switch 'hash_table_slots' over to 64-bit slot indices.
+    void widenSlots() {
+        StorageChange change(this);
+
+        if (hash_table_wide_slots) {
+            return;
+        }
+
+        if (hash_table_slots) {
+            int64_t* wideSlots = (int64_t*)tp_malloc(hash_table_size * sizeof(int64_t));
+
+            for (size_t k = 0; k < hash_table_size; k++) {
+                wideSlots[k] = hash_table_slots[k];
+            }
+
+            tp_free(hash_table_slots);
+            hash_table_slots = (int32_t*)wideSlots;
+        }
+
+        hash_table_wide_slots = 1;
+    }
+
+    // a bitmask of the buckets in the group starting at 'control' whose control
+    // byte is exactly 'value'
+    static uint32_t groupMatch(const uint8_t* control, uint8_t value) {
+#ifdef __SSE2__
+        __m128i group = _mm_loadu_si128((const __m128i*)control);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#else
+        uint32_t res = 0;
+        for (long k = 0; k < GROUP_WIDTH; k++) {
+            if (control[k] == value) {
+                res |= (1 << k);
+            }
+        }
+        return res;
+#endif
+    }
+
+    // a bitmask of the buckets in the group starting at 'control' that are
+    // either empty or deleted (both have the top bit set, unlike any tag).
+    static uint32_t groupMatchEmptyOrDeleted(const uint8_t* control) {
+#ifdef __SSE2__
+        return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)control));
+#else
+        uint32_t res = 0;
+        for (long k = 0; k < GROUP_WIDTH; k++) {
+            if (control[k] & 0x80) {
+                res |= (1 << k);
+            }
+        }
+        return res;
+#endif
+    }
+
+    static long lowestSetBit(uint32_t mask) {
+        return __builtin_ctz(mask);
+    }
+
     // return the index of the object indexed by 'hash', or -1
     template <class eq_func>
-    int32_t find(int32_t item_size, typed_python_hash_type hash, const eq_func& compare) {
-        if (!hash_table_slots) {
+    int64_t find(size_t item_size, typed_python_hash_type hash, const eq_func& compare) {
+        int64_t bucket = findBucket(item_size, hash, compare);
+
+        if (bucket < 0) {
             return -1;
         }
 
+        return hash_table_slots ? slotAt(bucket) : bucket;
+    }
+
+    // return the bucket in the hashtable holding the object indexed by 'hash', or -1
+    template <class eq_func>
+    int64_t findBucket(size_t item_size, typed_python_hash_type hash, const eq_func& compare) {
         if (hash < 0) {
             hash = -hash;
         }
 
-        uint64_t mask = hash_table_size - 1;
-        uint64_t perturb = hash;
-        uint64_t offset = hash;
+        if (!hash_table_slots) {
+            if (!hash_table_hashes) {
+                return -1;
+            }
 
-        while (true) {
-            // slot is empty
-            int32_t slot = hash_table_slots[offset & mask];
+            uint32_t matches = smallTableMatch(hash);
 
-            if (slot == EMPTY) {
-                return -1;
+            while (matches) {
+                int64_t slot = lowestSetBit(matches);
+
+                if (compare(items + item_size * slot)) {
+                    return slot;
+                }
+
+                matches &= matches - 1;
             }
 
-            if (slot != DELETED && hash_table_hashes[offset & mask] == hash
-                && compare(items + item_size * slot)) {
-                return slot;
+            return -1;
+        }
+
+        uint64_t groupMask = hash_table_size / GROUP_WIDTH - 1;
+        uint64_t group = firstGroupFor(hash);
+        uint8_t tag = controlTagFor(hash);
+
+        for (uint64_t step = 1; true; step++) {
+            const uint8_t* control = hash_table_control + group * GROUP_WIDTH;
+
+            uint32_t matches = groupMatch(control, tag);
+
+            while (matches) {
+                int64_t bucket = group * GROUP_WIDTH + lowestSetBit(matches);
+
+                // a tag matches one key in 128 at random, so check the whole
+                // hash before 'compare', which may call into python
+                if (hash_table_hashes[bucket] == hash && compare(items + item_size * slotAt(bucket))) {
+                    return bucket;
+                }
+
+                matches &= matches - 1;
+            }
+
+            if (groupMatch(control, CONTROL_EMPTY)) {
+                return -1;
             }
 
-            offset = (offset << 2) + offset + perturb + 1;
-            perturb >>= PERTURB_SHIFT;
+            group = (group + step) & groupMask;
         }
     }
 
     // add an item to the hash table
-    void add(typed_python_hash_type hash, int32_t slot) {
-        if (hash_table_count * 2 + 1 > hash_table_size
-            || hash_table_empty_slots < hash_table_size / 4 + 1) {
+    void add(typed_python_hash_type hash, int64_t slot) {
+        if (hash < 0) {
+            hash = -hash;
+        }
+
+        if (hash_table_slots && (hash_table_count * 2 + 1 > hash_table_size
+                || hash_table_empty_slots < hash_table_size / 4 + 1)) {
             resizeTable();
         }
 
-        if (hash < 0) {
-            hash = -hash;
+        if (!hash_table_slots) {
+            if (items_reserved <= SMALL_TABLE_SIZE) {
+                if (!hash_table_hashes) {
+                    StorageChange change(this);
+                    allocateSmallTable();
+                }
+
+                hash_table_hashes[slot] = hash;
+                items_populated[slot] = 1;
+                hash_table_count++;
+                return;
+            }
+
+            resizeTable();
         }
 
-        uint64_t mask = hash_table_size - 1;
-        uint64_t perturb = hash;
-        uint64_t offset = hash;
+        uint64_t groupMask = hash_table_size / GROUP_WIDTH - 1;
+        uint64_t group = firstGroupFor(hash);
+
+        for (uint64_t step = 1; true; step++) {
+            const uint8_t* control = hash_table_control + group * GROUP_WIDTH;
+
+            uint32_t available = groupMatchEmptyOrDeleted(control);
+
+            if (available) {
+                int64_t bucket = group * GROUP_WIDTH + lowestSetBit(available);
 
-        while (true) {
-            if (hash_table_slots[offset & mask] == EMPTY || hash_table_slots[offset & mask] == DELETED) {
-                if (hash_table_slots[offset & mask] == EMPTY) {
+                if (hash_table_control[bucket] == CONTROL_EMPTY) {
                     hash_table_empty_slots--;
                 }
 
-                hash_table_slots[offset & mask] = slot;
-                hash_table_hashes[offset & mask] = hash;
+                hash_table_control[bucket] = controlTagFor(hash);
+                setSlotAt(bucket, slot);
+                hash_table_hashes[bucket] = hash;
                 items_populated[slot] = 1;
                 hash_table_count++;
                 return;
             }
 
-            offset = (offset << 2) + offset + perturb + 1;
-            perturb >>= PERTURB_SHIFT;
+            group = (group + step) & groupMask;
         }
     }
 
+    // allocate (uninitialized) hashtable arrays for 'hash_table_size' buckets
+    void allocateHashTableArrays() {
+        hash_table_slots = (int32_t*)tp_malloc(hash_table_size * bytesPerSlot());
+        hash_table_hashes = (typed_python_hash_type*)tp_malloc(hash_table_size * sizeof(typed_python_hash_type));
+        hash_table_control = (uint8_t*)tp_malloc(hash_table_size);
+    }
+
+    // mark every bucket in the hashtable as empty
+    void clearHashTableArrays() {
+        for (size_t k = 0; k < hash_table_size; k++) {
+            setSlotAt(k, EMPTY);
+        }
+        setTo(hash_table_hashes, EMPTY, hash_table_size);
+        std::memset(hash_table_control, CONTROL_EMPTY, hash_table_size);
+    }
+
     // remove an item with the given hash. returning the item slot where it
     // lived.
     //-1 if not found
@@ -119,8 +426,8 @@ class hash_table_layout {
     // held by the caller. In particular, the caller should NOT pass a 'compare' function
     // that compares to a pointer to our internals.
     template <class eq_func>
-    int32_t remove(int32_t item_size, typed_python_hash_type hash, const eq_func& compare) {
-        if (!hash_table_slots) {
+    int64_t remove(size_t item_size, typed_python_hash_type hash, const eq_func& compare) {
+        if (!hash_table_slots && !hash_table_hashes) {
             return -1;
         }
 
@@ -133,42 +440,111 @@ class hash_table_layout {
             resizeTable();
         }
 
-        if (hash < 0) {
-            hash = -hash;
+        int64_t bucket = findBucket(item_size, hash, compare);
+
+        if (bucket < 0) {
+            // we never found the item
+            return -1;
         }
 
-        uint64_t mask = hash_table_size - 1;
-        uint64_t perturb = hash;
-        uint64_t offset = hash;
+        return removeBucket(bucket);
+    }
 
-        while (true) {
-            int32_t slot = hash_table_slots[offset & mask];
+    // remove the item in 'bucket' from the hashtable and return its slot, which the
+    // caller is responsible for destroying. Unlike 'remove', this never compresses or
+    // resizes anything, so it's safe to call from inside 'visitBuckets'.
+    int64_t removeBucket(int64_t bucket) {
+        if (!hash_table_slots) {
+            items_populated[bucket] = 0;
+            hash_table_hashes[bucket] = EMPTY;
+            hash_table_count -= 1;
 
-            if (slot == EMPTY) {
-                // we never found the item
-                return -1;
+            return bucket;
+        }
+
+        int64_t slot = slotAt(bucket);
+
+        items_populated[slot] = 0;
+
+        hash_table_control[bucket] = CONTROL_DELETED;
+        setSlotAt(bucket, DELETED);
+        hash_table_hashes[bucket] = -1;
+        hash_table_count -= 1;
+
+        return slot;
+    }
+
+    // call 'visitor(bucket, item, hash)' for every item in the hashtable, where 'hash'
+    // is the hash we stored for it. Passing that hash back to 'find' or 'add' is the
+    // same as passing the item's own hash, so callers can avoid rehashing items.
+    template <class visitor_type>
+    void visitBuckets(size_t item_size, const visitor_type& visitor) {
+        if (!hash_table_slots) {
+            if (hash_table_hashes) {
+                int64_t top = std::min<int64_t>(top_item_slot, SMALL_TABLE_SIZE);
+
+                for (int64_t slot = 0; slot < top; slot++) {
+                    if (items_populated[slot]) {
+                        visitor(slot, items + item_size * slot, hash_table_hashes[slot]);
+                    }
+                }
             }
 
-            if (slot != DELETED && compare(items + item_size * slot)) {
-                items_populated[slot] = 0;
+            return;
+        }
+
+        for (size_t bucket = 0; bucket < hash_table_size; bucket++) {
+            if (!(hash_table_control[bucket] & CONTROL_EMPTY)) {
+                visitor(bucket, items + item_size * slotAt(bucket), hash_table_hashes[bucket]);
+            }
+        }
+    }
 
-                hash_table_slots[offset & mask] = DELETED;
-                hash_table_hashes[offset & mask] = -1;
-                hash_table_count -= 1;
+    // return the first populated slot at or after 'slot', or 'items_reserved' if there
+    // isn't one. Nothing at or past 'top_item_slot' is populated, and we skip runs of
+    // deleted slots eight at a time, so iterating a table that's had most of its items
+    // removed doesn't have to look at every byte of 'items_populated'.
+    int64_t nextPopulatedSlot(int64_t slot) const {
+        int64_t top = std::min<int64_t>(top_item_slot, items_reserved);
 
+        while (slot < top && (slot & 7)) {
+            if (items_populated[slot]) {
                 return slot;
             }
+            slot++;
+        }
+
+        while (slot + 8 <= top) {
+            uint64_t word;
+            memcpy(&word, items_populated + slot, sizeof(word));
 
-            offset = (offset << 2) + offset + perturb + 1;
-            perturb >>= PERTURB_SHIFT;
+            if (word) {
+                break;
+            }
+
+            slot += 8;
         }
+
+        while (slot < top) {
+            if (items_populated[slot]) {
+                return slot;
+            }
+            slot++;
+        }
+
+        return items_reserved;
     }
 
-    void compressItemTable(size_t item_size) {
-        std::vector<int32_t> newItemPositions;
-        int32_t count_so_far = 0;
+    // slide all the populated items down to the front of the item table,
+    // preserving their order, and shrink the table to hold at least
+    // 'minReserved' items.
+    void compressItemTable(size_t item_size, size_t minReserved = 0) {
+        StorageChange change(this);
 
-        for (long k = 0; k < items_reserved; k++) {
+        std::vector<int64_t> newItemPositions;
+        int64_t count_so_far = 0;
+
+        for (int64_t k = 0; k < items_reserved; k++) {
             if (items_populated[k]) {
                 newItemPositions.push_back(count_so_far);
 
@@ -178,6 +554,11 @@ class hash_table_layout {
 
                     memcpy(items + item_size * count_so_far, items + item_size * k,
                            item_size);
+
+                    if (isSmall()) {
+                        hash_table_hashes[count_so_far] = hash_table_hashes[k];
+                        hash_table_hashes[k] = EMPTY;
+                    }
                 }
 
                 count_so_far++;
@@ -186,36 +567,43 @@ class hash_table_layout {
             }
         }
 
-        items_populated = (uint8_t*)tp_realloc(items_populated, items_reserved, count_so_far);
-        items = (uint8_t*)tp_realloc(items, items_reserved * item_size, count_so_far * item_size);
+        size_t new_reserved = std::max<size_t>(count_so_far, minReserved);
 
-        items_reserved = count_so_far;
-        top_item_slot = items_reserved;
+        if (new_reserved != items_reserved) {
+            items_populated = (uint8_t*)tp_realloc(items_populated, items_reserved, new_reserved);
+            items = (uint8_t*)tp_realloc(items, items_reserved * item_size, new_reserved * item_size);
+
+            items_reserved = new_reserved;
+        }
 
-        for (long k = 0; k < hash_table_size; k++) {
-            if (hash_table_slots[k] >= 0) {
-                if (hash_table_slots[k] >= newItemPositions.size()) {
+        top_item_slot = count_so_far;
+
+        for (size_t k = 0; k < hash_table_size; k++) {
+            int64_t slot = slotAt(k);
+
+            if (slot >= 0) {
+                if (slot >= newItemPositions.size()) {
                     throw std::runtime_error("corrupt slot");
                 }
 
-                hash_table_slots[k] = newItemPositions[hash_table_slots[k]];
+                slot = newItemPositions[slot];
 
-                if (hash_table_slots[k] < 0) {
+                if (slot < 0) {
                     throw std::runtime_error("invalid slot");
                 }
-            }
-        }
 
-        for (long k = 0; k < hash_table_size; k++) {
-            if (hash_table_slots[k] >= 0) {
-                if (hash_table_slots[k] >= items_reserved) {
+                if (slot >= items_reserved) {
                     throw std::runtime_error("failed during compression");
                 }
+
+                setSlotAt(k, slot);
             }
         }
     }
 
-    int32_t allocateNewSlot(size_t item_size) {
+    int64_t allocateNewSlot(size_t item_size) {
+        StorageChange change(this);
+
         if (!items) {
             items_reserved = 4;
             items = (uint8_t*)tp_malloc(items_reserved * item_size);
@@ -226,6 +614,19 @@ class hash_table_layout {
             for (long k = 0; k < items_reserved; k++) {
                 items_populated[k] = 0;
             }
+
+            // compiled code adds items to small tables without calling back into
+            // us, so they need their hashes allocated up front
+            if (!hash_table_slots && !hash_table_hashes) {
+                allocateSmallTable();
+            }
+        }
+
+        // if at least a quarter of the item table is holes left by removed
+        // items, reuse them rather than growing, so that tables with a steady
+        // stream of inserts and removes stay proportional to their live size.
+        if (top_item_slot >= items_reserved && hash_table_count * 4 <= items_reserved * 3) {
+            compressItemTable(item_size, items_reserved);
         }
 
         while (top_item_slot >= items_reserved) {
@@ -234,16 +635,77 @@ class hash_table_layout {
             items = (uint8_t*)tp_realloc(items, item_size * old_reserved, item_size * items_reserved);
             items_populated = (uint8_t*)tp_realloc(items_populated, old_reserved, items_reserved);
 
-            for (long k = old_reserved; k < items_reserved; k++) {
+            for (size_t k = old_reserved; k < items_reserved; k++) {
                 items_populated[k] = 0;
             }
         }
 
+        if (items_reserved > MAX_NARROW_SLOTS) {
+            widenSlots();
+        }
+
         return top_item_slot++;
     }
 
-    int32_t pickHashTableSize(int32_t minSize) {
-        int32_t ct = MIN_SIZE;
+    // make sure we can insert 'additional' new items without growing the item
+    // table or resizing the hashtable.
+    void reserveForInsertion(size_t item_size, size_t additional) {
+        StorageChange change(this);
+
+        size_t needed = top_item_slot + additional;
+
+        if (!items) {
+            items_reserved = std::max<size_t>(needed, 4);
+            items = (uint8_t*)tp_malloc(items_reserved * item_size);
+            std::memset(items, 0, items_reserved * item_size);
+            items_populated = (uint8_t*)tp_malloc(items_reserved);
+            std::memset(items_populated, 0, items_reserved);
+            top_item_slot = 0;
+
+            if (!hash_table_slots && !hash_table_hashes) {
+                allocateSmallTable();
+            }
+        } else if (needed > items_reserved) {
+            size_t old_reserved = items_reserved;
+            items_reserved = needed;
+            items = (uint8_t*)tp_realloc(items, item_size * old_reserved, item_size * items_reserved);
+            items_populated = (uint8_t*)tp_realloc(items_populated, old_reserved, items_reserved);
+            std::memset(items_populated + old_reserved, 0, items_reserved - old_reserved);
+        }
+
+        if (items_reserved > MAX_NARROW_SLOTS) {
+            widenSlots();
+        }
+
+        // a small table that can hold them all never resizes in 'add'
+        if (isSmall() && items_reserved <= SMALL_TABLE_SIZE) {
+            return;
+        }
+
+        // resize now if any of the insertions would trigger a resize in 'add'
+        if (!hash_table_slots
+                || (hash_table_count + additional) * 2 + 1 > hash_table_size
+                || hash_table_empty_slots < additional + hash_table_size / 4 + 1) {
+            resizeTable((hash_table_count + additional + 1) * 2);
+        }
+    }
+
+    // release any item slots and hashtable buckets beyond what we need to
+    // hold the live items. Unlike the automatic policy, this sizes the item
+    // table to exactly the number of live items.
+    void compact(size_t item_size) {
+        if (!hash_table_slots && !hash_table_hashes) {
+            return;
+        }
+
+        StorageChange change(this);
+
+        compressItemTable(item_size);
+        resizeTable();
+    }
+
+    size_t pickHashTableSize(size_t minSize) {
+        size_t ct = MIN_SIZE;
         while (ct < minSize) {
             ct <<= 1;
         }
@@ -253,7 +715,7 @@ class hash_table_layout {
     // called after we have deleted everything that's populated, and need to
     // zero out the hash_table's internals.
     void allItemsHaveBeenRemoved() {
-        if (!hash_table_slots) {
+        if (!hash_table_slots && !hash_table_hashes) {
             return;
         }
 
@@ -261,8 +723,12 @@ class hash_table_layout {
         top_item_slot = 0;
         hash_table_empty_slots = hash_table_size;
 
-        setTo(hash_table_slots, EMPTY, hash_table_size);
-        setTo(hash_table_hashes, EMPTY, hash_table_size);
+        if (isSmall()) {
+            setTo(hash_table_hashes, EMPTY, SMALL_TABLE_SIZE);
+        } else {
+            clearHashTableArrays();
+        }
+
         std::memset(items_populated, 0, items_reserved);
     }
 
@@ -272,7 +738,12 @@ class hash_table_layout {
         new (result) hash_table_layout;
 
         result->refcount = 1;
+        result->counted_type = counted_type;
+
         if (!items) {
+            if (counted_type) {
+                typeLiveCountersAdjust(counted_type, result, 1);
+            }
             return result;
         }
         result->items_reserved = items_reserved;
@@ -280,13 +751,14 @@ class hash_table_layout {
         result->hash_table_size = hash_table_size;
         result->hash_table_count = hash_table_count;
         result->hash_table_empty_slots = hash_table_empty_slots;
+        result->hash_table_wide_slots = hash_table_wide_slots;
 
         result->items = (uint8_t*)tp_malloc(item_size * items_reserved);
         if (isPOD) {
             memcpy(result->items, items, item_size * items_reserved);
         }
         else {
-            for (int i=0; i<items_reserved; i++) {
+            for (size_t i=0; i<items_reserved; i++) {
                 if (items_populated[i]) {
                     copy_constructor(result->items + item_size * i, items + item_size * i);
                 }
@@ -296,99 +768,183 @@ class hash_table_layout {
         result->items_populated = (uint8_t*)tp_malloc(items_reserved);
         memcpy(result->items_populated, items_populated, items_reserved);
 
-        result->hash_table_slots = (int32_t*)tp_malloc(hash_table_size * sizeof(int32_t));
-        memcpy(result->hash_table_slots, hash_table_slots, hash_table_size * sizeof(int32_t));
+        if (isSmall()) {
+            result->hash_table_hashes = (typed_python_hash_type*)tp_malloc(SMALL_TABLE_SIZE * sizeof(typed_python_hash_type));
+            memcpy(result->hash_table_hashes, hash_table_hashes, SMALL_TABLE_SIZE * sizeof(typed_python_hash_type));
+        } else if (hash_table_slots) {
+            result->hash_table_slots = (int32_t*)tp_malloc(hash_table_size * bytesPerSlot());
+            memcpy(result->hash_table_slots, hash_table_slots, hash_table_size * bytesPerSlot());
+
+            result->hash_table_hashes = (typed_python_hash_type*)tp_malloc(hash_table_size * sizeof(typed_python_hash_type));
+            memcpy(result->hash_table_hashes, hash_table_hashes, hash_table_size * sizeof(typed_python_hash_type));
+
+            result->hash_table_control = (uint8_t*)tp_malloc(hash_table_size);
+            memcpy(result->hash_table_control, hash_table_control, hash_table_size);
+        }
+
+        if (counted_type) {
+            typeLiveCountersAdjust(counted_type, result, 1);
+        }
 
-        result->hash_table_hashes = (typed_python_hash_type*)tp_malloc(hash_table_size * sizeof(typed_python_hash_type));
-        memcpy(result->hash_table_hashes, hash_table_hashes, hash_table_size * sizeof(typed_python_hash_type));
         return result;
     }
 
-    void resizeTable() {
-        if (!hash_table_slots) {
-            hash_table_size = pickHashTableSize(hash_table_count * 4);
-            hash_table_slots = (int32_t*)tp_malloc(hash_table_size * sizeof(int32_t));
-            setTo(hash_table_slots, EMPTY, hash_table_size);
-            hash_table_hashes = (typed_python_hash_type*)tp_malloc(hash_table_size * sizeof(typed_python_hash_type));
-            setTo(hash_table_hashes, EMPTY, hash_table_size);
+    // rebuild the hashtable with at least 'minSize' buckets, dropping any
+    // tombstones. If the item table fits in SMALL_TABLE_SIZE slots and we weren't
+    // asked for any particular size, we become (or stay) a small table instead.
+    void resizeTable(size_t minSize = 0) {
+        StorageChange change(this);
+
+        if (minSize == 0 && items_reserved <= SMALL_TABLE_SIZE) {
+            if (isSmall()) {
+                return;
+            }
+
+            size_t oldSize = hash_table_size;
+            int32_t* oldSlots = hash_table_slots;
+            typed_python_hash_type* oldHashes = hash_table_hashes;
+            uint8_t* oldControl = hash_table_control;
+
+            hash_table_slots = nullptr;
+            hash_table_control = nullptr;
+            hash_table_size = 0;
+            hash_table_empty_slots = 0;
+
+            allocateSmallTable();
+
+            for (size_t k = 0; k < oldSize; k++) {
+                int64_t slot = hash_table_wide_slots ? ((int64_t*)oldSlots)[k] : oldSlots[k];
+
+                if (slot != EMPTY && slot != DELETED) {
+                    hash_table_hashes[slot] = oldHashes[k];
+                }
+            }
+
+            tp_free(oldSlots);
+            tp_free(oldHashes);
+            tp_free(oldControl);
+        } else if (!hash_table_slots) {
+            typed_python_hash_type* smallHashes = hash_table_hashes;
+
+            hash_table_size = pickHashTableSize(std::max<size_t>(hash_table_count * 4, minSize));
+            allocateHashTableArrays();
+            clearHashTableArrays();
             hash_table_count = 0;
             hash_table_empty_slots = hash_table_size;
 
+            if (smallHashes) {
+                int64_t top = std::min<int64_t>(top_item_slot, SMALL_TABLE_SIZE);
+
+                for (int64_t slot = 0; slot < top; slot++) {
+                    if (items_populated[slot]) {
+                        add(smallHashes[slot], slot);
+                    }
+                }
+
+                tp_free(smallHashes);
+            }
         } else {
-            int32_t oldSize = hash_table_size;
+            size_t oldSize = hash_table_size;
             int32_t* oldSlots = hash_table_slots;
             typed_python_hash_type* oldHashes = hash_table_hashes;
+            uint8_t* oldControl = hash_table_control;
 
             // make sure the table's not too small
-            hash_table_size = pickHashTableSize(hash_table_count * 4);
+            hash_table_size = pickHashTableSize(std::max<size_t>(hash_table_count * 4, minSize));
 
-            hash_table_slots = (int32_t*)tp_malloc(hash_table_size * sizeof(int32_t));
-            setTo(hash_table_slots, EMPTY, hash_table_size);
-            hash_table_hashes =
-              (typed_python_hash_type*)tp_malloc(hash_table_size * sizeof(typed_python_hash_type));
-            setTo(hash_table_hashes, EMPTY, hash_table_size);
+            allocateHashTableArrays();
+            clearHashTableArrays();
             hash_table_count = 0;
             hash_table_empty_slots = hash_table_size;
 
-            for (long k = 0; k < oldSize; k++) {
-                if (oldSlots[k] != EMPTY && oldSlots[k] != DELETED) {
-                    add(oldHashes[k], oldSlots[k]);
+            for (size_t k = 0; k < oldSize; k++) {
+                int64_t slot = hash_table_wide_slots ? ((int64_t*)oldSlots)[k] : oldSlots[k];
+
+                if (slot != EMPTY && slot != DELETED) {
+                    add(oldHashes[k], slot);
                 }
             }
 
             tp_free(oldSlots);
             tp_free(oldHashes);
+            tp_free(oldControl);
         }
     }
 
-    void prepareForDeserialization(uint32_t slotCount, size_t item_size) {
-        if (hash_table_size) {
+    void prepareForDeserialization(size_t slotCount, size_t item_size) {
+        if (hash_table_size || hash_table_hashes) {
             throw std::runtime_error("deserialization prepare should only be called on "
                                      "empty tables");
         }
 
+        StorageChange change(this);
+
         items_reserved = slotCount;
         items_populated = (uint8_t*)tp_malloc(slotCount);
         items = (uint8_t*)tp_malloc(slotCount * item_size);
 
-        for (long k = 0; k < items_reserved; k++) {
+        for (size_t k = 0; k < items_reserved; k++) {
             items_populated[k] = true;
         }
 
         top_item_slot = items_reserved;
+
+        if (items_reserved > MAX_NARROW_SLOTS) {
+            widenSlots();
+        }
+    }
+
+    // deserialization failed after filling in the first 'itemsRead' items. Mark
+    // the rest unpopulated, so that destroying the table only destroys those.
+    void abandonDeserialization(size_t itemsRead) {
+        if (!items_populated) {
+            items_reserved = 0;
+            return;
+        }
+
+        for (size_t k = itemsRead; k < items_reserved; k++) {
+            items_populated[k] = false;
+        }
     }
 
     template <class hash_fun_type>
     void buildHashTableAfterDeserialization(size_t item_size, const hash_fun_type& hash_fun) {
-        hash_table_size = pickHashTableSize(items_reserved * 2);
-        hash_table_slots = (int32_t*)tp_malloc(hash_table_size * sizeof(int32_t));
-        hash_table_hashes =
-          (typed_python_hash_type*)tp_malloc(hash_table_size * sizeof(typed_python_hash_type));
-        hash_table_count = 0;
-        hash_table_empty_slots = hash_table_size;
+        StorageChange change(this);
 
-        for (long k = 0; k < hash_table_size; k++) {
-            hash_table_slots[k] = EMPTY;
-            hash_table_hashes[k] = -1;
+        if (items_reserved <= SMALL_TABLE_SIZE) {
+            allocateSmallTable();
+        } else {
+            hash_table_size = pickHashTableSize(items_reserved * 2);
+            allocateHashTableArrays();
+            clearHashTableArrays();
+            hash_table_empty_slots = hash_table_size;
         }
 
-        for (long k = 0; k < items_reserved; k++) {
+        hash_table_count = 0;
+
+        for (size_t k = 0; k < items_reserved; k++) {
             add(hash_fun(items + item_size * k), k);
         }
     }
 
-    hash_table_layout* deepcopy(
-        DeepcopyContext& context,
-        Type* dictOrSetType,
-        Type* keyType,
-        Type* valueType
-    ) {
+    // allocate an empty table in the context's slab for a deepcopy to fill in.
+    static hash_table_layout* allocateForDeepcopy(DeepcopyContext& context, Type* dictOrSetType) {
         hash_table_layout* dest = (hash_table_layout*)context.slab->allocate(sizeof(hash_table_layout), dictOrSetType);
 
         new (dest) hash_table_layout();
 
-        dest->refcount = 1;
+        dest->refcount = 0;
 
+        return dest;
+    }
+
+    // deepcopy our contents into 'dest', which came from 'allocateForDeepcopy'.
+    void deepcopyInto(
+        hash_table_layout* dest,
+        DeepcopyContext& context,
+        Type* keyType,
+        Type* valueType
+    ) {
         int bytesPerKVPair = keyType->bytecount() + (valueType ? valueType->bytecount() : 0);
 
         dest->items = (uint8_t*)context.slab->allocate(
@@ -438,12 +994,30 @@ class hash_table_layout {
         dest->hash_table_count = this->hash_table_count;
         dest->hash_table_size = this->hash_table_size;
         dest->hash_table_empty_slots = this->hash_table_empty_slots;
+        dest->hash_table_wide_slots = this->hash_table_wide_slots;
 
-        dest->hash_table_slots = (int32_t*)context.slab->allocate(sizeof(int32_t) * this->hash_table_size, nullptr);
+        if (isSmall()) {
+            dest->hash_table_hashes = (typed_python_hash_type*)context.slab->allocate(
+                sizeof(typed_python_hash_type) * SMALL_TABLE_SIZE,
+                nullptr
+            );
+            memcpy(
+                dest->hash_table_hashes,
+                this->hash_table_hashes,
+                sizeof(typed_python_hash_type) * SMALL_TABLE_SIZE
+            );
+            return;
+        }
+
+        if (!this->hash_table_slots) {
+            return;
+        }
+
+        dest->hash_table_slots = (int32_t*)context.slab->allocate(bytesPerSlot() * this->hash_table_size, nullptr);
         memcpy(
             dest->hash_table_slots,
             this->hash_table_slots,
-            sizeof(int32_t) * this->hash_table_size
+            bytesPerSlot() * this->hash_table_size
         );
 
         dest->hash_table_hashes = (typed_python_hash_type*)context.slab->allocate(
@@ -456,11 +1030,50 @@ class hash_table_layout {
             sizeof(typed_python_hash_type) * this->hash_table_size
         );
 
-        return dest;
+        dest->hash_table_control = (uint8_t*)context.slab->allocate(this->hash_table_size, nullptr);
+        memcpy(dest->hash_table_control, this->hash_table_control, this->hash_table_size);
     }
 
 
+    void checkSmallTableInvariants(const std::string& reason) {
+        for (long k = SMALL_TABLE_SIZE; k < items_reserved; k++) {
+            if (items_populated[k]) {
+                throw std::runtime_error(reason + ": small table has an item past its last slot");
+            }
+        }
+
+        int64_t popCount = 0;
+
+        for (long k = 0; k < SMALL_TABLE_SIZE; k++) {
+            bool populated = k < items_reserved && items_populated[k];
+
+            if (populated) {
+                popCount++;
+
+                if (top_item_slot <= k) {
+                    throw std::runtime_error(reason
+                                             + ": top item slot should be greater "
+                                               "than all populated items");
+                }
+            } else if (hash_table_hashes[k] != EMPTY) {
+                throw std::runtime_error(reason + ": small table has a hash for an empty slot");
+            }
+        }
+
+        if (popCount != hash_table_count) {
+            throw std::runtime_error(reason
+                                     + ": populated item count is "
+                                       "not the same as the "
+                                       "hashtable count");
+        }
+    }
+
     void checkInvariants(std::string reason) {
+        if (isSmall()) {
+            checkSmallTableInvariants(reason);
+            return;
+        }
+
         int64_t popCount = 0;
         for (long k = 0; k < items_reserved; k++) {
             if (items_populated[k]) {
@@ -482,19 +1095,33 @@ class hash_table_layout {
 
         int64_t filledSlots = 0;
         int64_t deletedSlots = 0;
-        for (long k = 0; k < hash_table_size; k++) {
-            if (hash_table_slots[k] == DELETED) {
+        for (size_t k = 0; k < hash_table_size; k++) {
+            int64_t slot = slotAt(k);
+
+            if (slot == DELETED) {
                 deletedSlots++;
-            } else if (hash_table_slots[k] != EMPTY) {
+
+                if (hash_table_control[k] != CONTROL_DELETED) {
+                    throw std::runtime_error(reason + ": deleted bucket has the wrong control byte");
+                }
+            } else if (slot == EMPTY) {
+                if (hash_table_control[k] != CONTROL_EMPTY) {
+                    throw std::runtime_error(reason + ": empty bucket has the wrong control byte");
+                }
+            } else {
                 filledSlots++;
 
-                if (hash_table_slots[k] >= items_reserved) {
+                if (hash_table_control[k] != controlTagFor(hash_table_hashes[k])) {
+                    throw std::runtime_error(reason + ": filled bucket has the wrong control byte");
+                }
+
+                if (slot >= items_reserved) {
                     throw std::runtime_error(reason
                                              + ": hash table has slot entry out "
                                                "of bounds with item list");
                 }
 
-                if (!items_populated[hash_table_slots[k]]) {
+                if (!items_populated[slot]) {
                     throw std::runtime_error(reason
                                              + ": hash table points to unmarked "
                                                "slot");
@@ -515,9 +1142,9 @@ class hash_table_layout {
     }
 
     bool empty() const { return hash_table_count == 0; }
-    int32_t size() const { return hash_table_count; }
+    size_t size() const { return hash_table_count; }
 
-    std::atomic<int64_t> refcount;
+    Refcount refcount;
 
     uint8_t* items; // packed set of key_value pairs.
     uint8_t* items_populated; // array of bool for whether populated
@@ -526,7 +1153,8 @@ class hash_table_layout {
 
     int32_t* hash_table_slots; // a hashtable. each actual object hash to
                                // the slot index it holds. -1 if not
-                               // populated.
+                               // populated. Holds int64_t entries if
+                               // 'hash_table_wide_slots' is set.
     typed_python_hash_type* hash_table_hashes; // a hashtable. each actual object hash to
                                                // the hash in that part of the table. -1 if
                                                // not populated.
@@ -535,6 +1163,13 @@ class hash_table_layout {
     size_t hash_table_empty_slots; // slots that are not empty in the
                                    // table. Recall that some slots are
                                    // 'deleted'
+    uint8_t* hash_table_control; // one control byte per bucket: CONTROL_EMPTY,
+                                 // CONTROL_DELETED, or the 7-bit tag of the
+                                 // hash held in the bucket.
+    int64_t hash_table_wide_slots; // nonzero if 'hash_table_slots' holds
+                                   // int64_t slot indices.
+    Type* counted_type; // if not null, the Dict or Set type whose live counters
+                        // include us. See TypeLiveCounters.hpp.
 };
 
 
@@ -153,6 +153,43 @@ magicMethodTypes = {
 }
 
 
+def _fullArgSpec(f):
+    """Equivalent to 'inspect.getfullargspec(f)', but much cheaper for plain python functions.
+
+    We make a Function type for every method of every Class, so this is a noticeable
+    part of what importing a module full of them costs, and 'inspect' builds a full
+    Signature object just to throw it away.
+    """
+    if type(f) is not FunctionType or "__signature__" in f.__dict__:
+        return inspect.getfullargspec(f)
+
+    code = f.__code__
+    names = code.co_varnames
+    pos = code.co_argcount
+    kwonly = code.co_kwonlyargcount
+
+    varargs = None
+    varkw = None
+    ix = pos + kwonly
+
+    if code.co_flags & inspect.CO_VARARGS:
+        varargs = names[ix]
+        ix += 1
+
+    if code.co_flags & inspect.CO_VARKEYWORDS:
+        varkw = names[ix]
+
+    return inspect.FullArgSpec(
+        list(names[:pos]),
+        varargs,
+        varkw,
+        f.__defaults__,
+        list(names[pos:pos + kwonly]),
+        f.__kwdefaults__,
+        dict(f.__annotations__)
+    )
+
+
 def makeFunctionType(
     name, f, classname=None, ignoreAnnotations=False, assumeClosuresGlobal=False, returnTypeOverride=None
 ):
@@ -183,7 +220,7 @@ def makeFunctionType(
     if isinstance(f, type) and issubclass(f, typed_python._types.Function):
         return f
 
-    spec = inspect.getfullargspec(f)
+    spec = _fullArgSpec(f)
 
     def getAnn(argname):
         """ Return the annotated type for the given argument or None. """
@@ -257,6 +294,17 @@ def makeFunctionType(
     return res
 
 
+# for each Class, the Classes defined so far that inherit from it, directly or not.
+# The compiler uses this to guess which concrete classes a virtual method call will
+# see. Classes can be defined at any time, so it's only ever a guess.
+_knownSubclasses = {}
+
+
+def knownSubclassesOf(cls):
+    """Return a list of the Classes defined so far that have 'cls' as a base."""
+    return list(_knownSubclasses.get(cls, ()))
+
+
 class ClassMetaclass(type):
     @classmethod
     def __prepare__(cls, *args, **kwargs):
@@ -353,6 +401,9 @@ class ClassMetaclass(type):
         if classCell is not None:
             typed_python._types.setPyCellContents(classCell, res)
 
+        for base in res.MRO[1:]:
+            _knownSubclasses.setdefault(base, []).append(res)
+
         return res
 
     def __subclasscheck__(cls, subcls):
@@ -427,6 +478,23 @@ class FunctionOverloadArg:
         return res
 
 
+class LazyFunctionOverloads:
+    """Stands in for 'overloads' in the dict of a Function type until someone asks for it.
+
+    The first lookup builds the FunctionOverload objects and puts them in the
+    type's dict in our place.
+    """
+    def __get__(self, instance, owner):
+        for T in owner.__mro__:
+            if T.__dict__.get("overloads") is self:
+                return typed_python._types.materializeFunctionOverloads(T)
+
+        raise AttributeError("overloads")
+
+
+lazyFunctionOverloads = LazyFunctionOverloads()
+
+
 class FunctionOverload:
     def __init__(self, functionTypeObject, index, code, funcGlobalsInCells, closureVarLookups, returnType, signatureFunction, methodOf):
         """Initialize a FunctionOverload.
@@ -520,8 +588,19 @@ class FunctionOverload:
             return "FunctionOverload(%s, returns %s, %s)" % (self.methodOf.Class.__name__, self.returnType, self.args)
         return "FunctionOverload(returns %s, %s)" % (self.returnType, self.args)
 
-    def _installNativePointer(self, fp, returnType, argumentTypes):
-        typed_python._types.installNativeFunctionPointer(
+    def _installNativePointer(self, fp, returnType, argumentTypes, hotAfterCalls=0, onHot=None):
+        """Install a compiled entrypoint for this overload.
+
+        If 'onHot' is given, we call it (with no arguments) once the entrypoint has
+        been called 'hotAfterCalls' times. Installing a new pointer with the same
+        signature after that replaces this one.
+
+        If the overload was marked nogil (see compiler/nogil.py) the entrypoint
+        releases the GIL as soon as it's called.
+        """
+        from typed_python.compiler.nogil import isNogil
+
+        args = (
             self.functionTypeObject,
             self.index,
             fp,
@@ -529,6 +608,13 @@ class FunctionOverload:
             tuple(argumentTypes)[len(self.closureVarLookups):],
         )
 
+        if isNogil(self.functionCode):
+            args += (hotAfterCalls, onHot, True)
+        elif onHot is not None:
+            args += (hotAfterCalls, onHot)
+
+        typed_python._types.installNativeFunctionPointer(*args)
+
 
 class DisableCompiledCode:
     def __init__(self):
@@ -592,6 +678,51 @@ def checkType(x, *types):
     return x
 
 
+def likely(cond):
+    """Return bool(cond), telling the compiler that it's usually true.
+
+    Compiled code lays out a branch on 'likely(x)' with the true side as the
+    fall-through path, and keeps the false side out of the way. A profile from
+    TP_COMPILER_PGO overrides this.
+    """
+    return bool(cond)
+
+
+def unlikely(cond):
+    """Return bool(cond), telling the compiler that it's usually false. See 'likely'."""
+    return bool(cond)
+
+
+def assume(cond):
+    """Promise the compiler that 'cond' is true, so it can optimize on that basis.
+
+    Compiled code doesn't check the promise, and breaking it is undefined
+    behavior. Interpreted code checks it.
+    """
+    if not cond:
+        raise UndefinedBehaviorException("assume() was passed a false condition")
+
+
+def unreachable():
+    """Promise the compiler that control never reaches this call.
+
+    Reaching it in compiled code is undefined behavior. In interpreted code,
+    it raises UndefinedBehaviorException.
+    """
+    raise UndefinedBehaviorException("Reached a call to unreachable()")
+
+
+def prefetch(ptr, locality=3, forWriting=False):
+    """Ask the cpu to start loading the memory 'ptr' points at into its cache.
+
+    'ptr' is a PointerTo or an instance of a Class. 'locality' is a constant
+    from 0 (don't keep it cached once we're done with it) to 3 (keep it in
+    every level of cache). Pass 'forWriting=True' if we're about to write to it.
+
+    This does nothing in interpreted code.
+    """
+
+
 def typeKnownToCompiler(x):
     """Returns the type object that the compiler knows for 'x'
 
@@ -0,0 +1,115 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Find out what's using memory, cheaply enough to leave on in production.
+
+    with AllocationSampling(bytesBetweenSamples=512 * 1024):
+        ... run the workload ...
+
+        liveBytesByType()        # {ListOf(float): 81000000.0, None: 2000000.0, ...}
+        topAllocationSites(10)   # [(siteName, estimatedBytes), ...]
+
+While sampling is on, typed_python picks one allocation per
+'bytesBetweenSamples' bytes allocated (on average, with every byte equally
+likely to be picked), and remembers its size, its Type and the code that
+allocated it until it's freed. Allocations that aren't picked cost a single
+thread-local subtraction. The numbers we report are estimates of live bytes,
+scaled up from the samples.
+
+The Type is known for Class instances, ListOf and TupleOf (including their
+growth), Slab allocations and anything allocated through an Instance. Other
+allocations (dict tables, strings, and most allocations made directly by
+compiled code) are reported under None, but their site tells you where they
+came from. Sites inside compiled code are named after the compiled function
+if this process compiled it; otherwise they're reported as a hex address.
+"""
+
+import bisect
+
+from typed_python._types import setAllocationSampling, allocationSampling, liveAllocationSamples
+
+
+class AllocationSampling:
+    """Turn allocation sampling on for the duration of a 'with' block.
+
+    Samples taken inside the block can still be inspected after it exits,
+    for as long as their allocations stay alive.
+    """
+    def __init__(self, bytesBetweenSamples=512 * 1024):
+        self.bytesBetweenSamples = bytesBetweenSamples
+        self.priorBytesBetweenSamples = None
+
+    def __enter__(self):
+        self.priorBytesBetweenSamples = allocationSampling()
+        setAllocationSampling(self.bytesBetweenSamples)
+        return self
+
+    def __exit__(self, excType, excValue, traceback):
+        setAllocationSampling(self.priorBytesBetweenSamples)
+        return False
+
+
+def liveBytesByType():
+    """Return a dict from Type (or None) to the estimated live bytes allocated for it."""
+    res = {}
+
+    for T, _, estimatedBytes, _ in liveAllocationSamples():
+        res[T] = res.get(T, 0.0) + estimatedBytes
+
+    return res
+
+
+def topAllocationSites(count=20):
+    """Return the 'count' sites holding the most live bytes, as (siteName, estimatedBytes), largest first."""
+    bytesBySite = {}
+
+    for _, _, estimatedBytes, site in liveAllocationSamples():
+        bytesBySite[site] = bytesBySite.get(site, 0.0) + estimatedBytes
+
+    namer = _SiteNamer()
+
+    return [
+        (namer.name(site), estimatedBytes)
+        for site, estimatedBytes in sorted(bytesBySite.items(), key=lambda siteAndBytes: -siteAndBytes[1])[:count]
+    ]
+
+
+class _SiteNamer:
+    """Name addresses after the compiled function containing them, if we can tell."""
+    def __init__(self):
+        from typed_python.compiler.runtime import _singleton
+
+        self.starts = []
+
+        if _singleton[0] is not None:
+            self.starts = sorted(
+                (fp.fp, name) for name, fp in _singleton[0].llvm_compiler.functions_by_name.items()
+            )
+
+    def name(self, site):
+        # the compiled function starting closest below 'site'. Sites in C++ code
+        # land past the end of some compiled function, so only trust it if it's
+        # nearby.
+        ix = bisect.bisect_right(self.starts, (site, chr(0x10FFFF))) - 1
+
+        if ix >= 0 and site - self.starts[ix][0] < _MAX_COMPILED_FUNCTION_BYTES:
+            start, name = self.starts[ix]
+            return f"{name}+{site - start:#x}"
+
+        return f"{site:#x}"
+
+
+# we don't know where compiled functions end, so we assume they're no bigger than this
+_MAX_COMPILED_FUNCTION_BYTES = 1024 * 1024
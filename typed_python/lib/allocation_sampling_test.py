@@ -0,0 +1,53 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import ListOf, Entrypoint
+from typed_python._types import allocationSampling, liveAllocationSamples
+from typed_python.lib.allocation_sampling import AllocationSampling, liveBytesByType, topAllocationSites
+
+
+def test_sampling_attributes_live_bytes_to_types():
+    with AllocationSampling(bytesBetweenSamples=64 * 1024):
+        assert allocationSampling() == 64 * 1024
+
+        lists = [ListOf(float)(range(1000)) for _ in range(2000)]
+
+    assert allocationSampling() == 0
+
+    # 2000 lists of 8000 bytes is 16mb, although lists may have reserved more
+    estimate = liveBytesByType().get(ListOf(float), 0.0)
+    assert 12e6 < estimate < 40e6, estimate
+
+    lists = None  # noqa: F841
+
+    assert liveBytesByType().get(ListOf(float), 0.0) < 1e6
+
+
+def test_sampling_follows_lists_as_they_grow():
+    @Entrypoint
+    def appendMany(aList: ListOf(int), count: int):
+        for i in range(count):
+            aList.append(i)
+
+    with AllocationSampling(bytesBetweenSamples=1024):
+        aList = ListOf(int)()
+        appendMany(aList, 1000000)
+
+        sizes = [bytes for T, bytes, _, _ in liveAllocationSamples() if bytes >= 8000000]
+        assert sizes
+
+        assert topAllocationSites(1)[0][1] >= 8000000
+
+    aList = None
+    assert not [bytes for T, bytes, _, _ in liveAllocationSamples() if bytes >= 8000000]
@@ -0,0 +1,46 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import Class, Member, Final
+from typed_python._types import pushArena, popArena
+
+
+class ArenaScope(Class, Final):
+    """A context manager that bump-allocates typed_python objects into a Slab.
+
+    Usage:
+
+        with ArenaScope(bytes=64 * 1024 * 1024):
+            ... build lots of temporary ListOf/Dict/str objects ...
+
+    Every allocation made on this thread while the scope is active comes
+    out of a single Slab. Once the Slab is full, allocations spill over
+    to the regular free store. Objects allocated in the arena may outlive
+    the scope: each one holds a reference to the Slab, which is released
+    in one shot once the last of them is destroyed.
+
+    Works both in the interpreter and in compiled code.
+    """
+    bytes = Member(int)
+
+    def __init__(self, bytes: int):
+        self.bytes = bytes
+
+    def __enter__(self):
+        pushArena(self.bytes)
+        return self
+
+    def __exit__(self, excType, excValue, traceback) -> bool:
+        popArena()
+        return False
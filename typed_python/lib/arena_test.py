@@ -0,0 +1,106 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import (
+    ListOf, Dict, Entrypoint, totalBytesAllocatedInSlabs, totalBytesAllocatedOnFreeStore
+)
+from typed_python._types import arenaDepth, popArena
+from typed_python.lib.arena import ArenaScope
+
+
+def test_arena_allocations_come_from_slab():
+    slabBytes0 = totalBytesAllocatedInSlabs()
+
+    with ArenaScope(bytes=1024 * 1024):
+        assert arenaDepth() == 1
+        assert totalBytesAllocatedInSlabs() >= slabBytes0 + 1024 * 1024
+
+        freeStoreBytes = totalBytesAllocatedOnFreeStore()
+        aList = ListOf(int)(range(1000))
+
+        # the list went into the arena, not the free store
+        assert totalBytesAllocatedOnFreeStore() == freeStoreBytes
+
+    assert arenaDepth() == 0
+
+    # the list keeps the arena alive after the scope exits
+    assert totalBytesAllocatedInSlabs() >= slabBytes0 + 1024 * 1024
+    assert aList[999] == 999
+
+    aList = None
+
+    assert totalBytesAllocatedInSlabs() == slabBytes0
+
+
+def test_arena_spills_to_free_store_when_full():
+    slabBytes0 = totalBytesAllocatedInSlabs()
+
+    with ArenaScope(bytes=1024):
+        aList = ListOf(int)(range(10000))
+
+    assert aList[9999] == 9999
+
+    aList = None
+
+    assert totalBytesAllocatedInSlabs() == slabBytes0
+
+
+def test_pop_arena_without_push_throws():
+    with pytest.raises(RuntimeError):
+        popArena()
+
+
+def test_arena_in_compiled_code():
+    @Entrypoint
+    def buildTemporaries(count: int) -> int:
+        res = 0
+
+        with ArenaScope(bytes=16 * 1024 * 1024):
+            for i in range(count):
+                d = Dict(int, str)()
+                d[i] = str(i)
+                res += len(d[i])
+
+        return res
+
+    slabBytes0 = totalBytesAllocatedInSlabs()
+
+    assert buildTemporaries(1000) == sum(len(str(i)) for i in range(1000))
+    assert arenaDepth() == 0
+    assert totalBytesAllocatedInSlabs() == slabBytes0
+
+
+def test_lists_grow_in_place_in_an_arena():
+    @Entrypoint
+    def appendMany(aList: ListOf(int), count: int):
+        for i in range(count):
+            aList.append(i)
+
+    # compile it before we're in the arena
+    appendMany(ListOf(int)(), 1)
+
+    with ArenaScope(bytes=1024 * 1024):
+        aList = ListOf(int)()
+        aList.append(-1)
+
+        address = int(aList.pointerUnsafe(0))
+
+        # nothing else gets allocated, so the buffer stays the last thing in the arena
+        appendMany(aList, 10000)
+
+        assert int(aList.pointerUnsafe(0)) == address
+
+    assert aList[10000] == 9999
@@ -0,0 +1,343 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A packed list of bits, for filter masks.
+
+A ListOf(bool) spends a byte on every element. A Bitset packs them 64 to a
+UInt64 word, so a mask over a column is an eighth of the size, and 'and', 'or',
+'not' and counting work a word at a time. Those are unit-stride loops over
+ListOf(UInt64) that llvm vectorizes, and counting uses llvm's ctpop.
+
+Usage:
+
+    mask = bitsetWhere(prices, lambda p: p > 100.0)
+    mask &= bitsetWhere(volumes, lambda v: v > 0)
+
+    mask.count()              # how many rows passed
+    mask.compress(prices)     # a ListOf(float) of the prices that passed
+
+    for i in mask.setBits():  # the row indices that passed
+        ...
+
+Bits past the end of the last word are always zero, which is what lets 'count'
+and the word-level operations ignore the size.
+
+This module also exposes 'popcount' and 'countTrailingZeros' on 64 bit words.
+They're llvm intrinsics in compiled code and plain python in the interpreter.
+"""
+
+from typed_python import Class, Final, Member, Forward, ListOf, UInt64, Entrypoint
+from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
+from typed_python.compiler.type_wrappers.runtime_functions import externalCallTarget
+import typed_python.compiler.native_ast as native_ast
+
+
+_WORD_MASK = (1 << 64) - 1
+
+
+_ctpop64 = externalCallTarget("llvm.ctpop.i64", native_ast.Int64, native_ast.UInt64, intrinsic=True)
+_cttz64 = externalCallTarget("llvm.cttz.i64", native_ast.Int64, native_ast.UInt64, native_ast.Bool, intrinsic=True)
+
+
+class PopCount(CompilableBuiltin):
+    """popcount(x) is the number of bits set in the 64 bit word 'x'."""
+    def __eq__(self, other):
+        return isinstance(other, PopCount)
+
+    def __hash__(self):
+        return hash("PopCount")
+
+    def __call__(self, x):
+        return bin(int(x) & _WORD_MASK).count("1")
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 1 or kwargs:
+            context.pushException(TypeError, "popcount takes one positional argument")
+            return
+
+        word = args[0].toUInt64()
+        if word is None:
+            return None
+
+        return context.pushPod(int, _ctpop64.call(word.nonref_expr))
+
+
+class CountTrailingZeros(CompilableBuiltin):
+    """countTrailingZeros(x) is the index of the lowest set bit in the 64 bit word 'x', or 64 if 'x' is zero."""
+    def __eq__(self, other):
+        return isinstance(other, CountTrailingZeros)
+
+    def __hash__(self):
+        return hash("CountTrailingZeros")
+
+    def __call__(self, x):
+        x = int(x) & _WORD_MASK
+
+        if not x:
+            return 64
+
+        return (x & -x).bit_length() - 1
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 1 or kwargs:
+            context.pushException(TypeError, "countTrailingZeros takes one positional argument")
+            return
+
+        word = args[0].toUInt64()
+        if word is None:
+            return None
+
+        # the second argument says whether zero is undefined. It isn't: we want 64.
+        return context.pushPod(int, _cttz64.call(word.nonref_expr, native_ast.const_bool_expr(False)))
+
+
+popcount = PopCount()
+countTrailingZeros = CountTrailingZeros()
+
+
+Bitset = Forward("Bitset")
+
+
+@Bitset.define
+class Bitset(Class, Final):
+    """A list of bools, packed into UInt64 words. See the module docstring."""
+    words = Member(ListOf(UInt64), nonempty=True)
+    size = Member(int, nonempty=True)
+
+    def __init__(self):
+        pass
+
+    def __init__(self, size: int):  # noqa: F811
+        self.resize(size)
+
+    def __len__(self) -> int:
+        return self.size
+
+    def __getitem__(self, i: int) -> bool:
+        if i < 0 or i >= self.size:
+            raise IndexError("Bitset index out of range")
+
+        return (self.words[i >> 6] >> UInt64(i & 63)) & UInt64(1) != UInt64(0)
+
+    def __setitem__(self, i: int, value: bool) -> None:
+        if i < 0 or i >= self.size:
+            raise IndexError("Bitset index out of range")
+
+        bit = UInt64(1) << UInt64(i & 63)
+
+        if value:
+            self.words[i >> 6] |= bit
+        else:
+            self.words[i >> 6] &= ~bit
+
+    def append(self, value: bool) -> None:
+        self.resize(self.size + 1)
+
+        if value:
+            self[self.size - 1] = True
+
+    def resize(self, size: int) -> None:
+        """Change the number of bits. New bits are zero."""
+        if size < 0:
+            raise ValueError("Bitset size can't be negative")
+
+        self.words.resize((size + 63) // 64)
+        self.size = size
+        self._clearTail()
+
+    def _clearTail(self) -> None:
+        """Zero the bits of the last word that are past 'size'."""
+        if self.size & 63:
+            self.words[-1] &= (UInt64(1) << UInt64(self.size & 63)) - UInt64(1)
+
+    @Entrypoint
+    def count(self) -> int:
+        """The number of set bits."""
+        res = 0
+        words = self.words.pointerUnsafe(0)
+
+        for i in range(len(self.words)):
+            res += popcount(words[i])
+
+        return res
+
+    def any(self) -> bool:
+        for word in self.words:
+            if word:
+                return True
+
+        return False
+
+    def _checkSameSize(self, other: Bitset) -> None:
+        if other.size != self.size:
+            raise ValueError("Bitsets have different sizes")
+
+    @Entrypoint
+    def __iand__(self, other: Bitset) -> Bitset:
+        self._checkSameSize(other)
+        words = self.words.pointerUnsafe(0)
+        otherWords = other.words.pointerUnsafe(0)
+
+        for i in range(len(self.words)):
+            words[i] &= otherWords[i]
+
+        return self
+
+    @Entrypoint
+    def __ior__(self, other: Bitset) -> Bitset:
+        self._checkSameSize(other)
+        words = self.words.pointerUnsafe(0)
+        otherWords = other.words.pointerUnsafe(0)
+
+        for i in range(len(self.words)):
+            words[i] |= otherWords[i]
+
+        return self
+
+    @Entrypoint
+    def __ixor__(self, other: Bitset) -> Bitset:
+        self._checkSameSize(other)
+        words = self.words.pointerUnsafe(0)
+        otherWords = other.words.pointerUnsafe(0)
+
+        for i in range(len(self.words)):
+            words[i] ^= otherWords[i]
+
+        return self
+
+    def __and__(self, other: Bitset) -> Bitset:
+        res = self.copy()
+        res &= other
+        return res
+
+    def __or__(self, other: Bitset) -> Bitset:
+        res = self.copy()
+        res |= other
+        return res
+
+    def __xor__(self, other: Bitset) -> Bitset:
+        res = self.copy()
+        res ^= other
+        return res
+
+    @Entrypoint
+    def __invert__(self) -> Bitset:
+        res = Bitset()
+        res.words = ListOf(UInt64)(self.words)
+        res.size = self.size
+
+        words = res.words.pointerUnsafe(0)
+
+        for i in range(len(res.words)):
+            words[i] = ~words[i]
+
+        res._clearTail()
+
+        return res
+
+    def copy(self) -> Bitset:
+        res = Bitset()
+        res.words = ListOf(UInt64)(self.words)
+        res.size = self.size
+        return res
+
+    def __eq__(self, other: Bitset) -> bool:
+        return self.size == other.size and self.words == other.words
+
+    @Entrypoint
+    def setBits(self) -> ListOf(int):
+        """Return the indices of the set bits, in increasing order."""
+        res = ListOf(int)()
+        res.reserve(self.count())
+
+        words = self.words.pointerUnsafe(0)
+
+        for wordIx in range(len(self.words)):
+            word = words[wordIx]
+
+            while word:
+                res.append(wordIx * 64 + countTrailingZeros(word))
+                word &= word - UInt64(1)
+
+        return res
+
+    @Entrypoint
+    def compress(self, lst):
+        """Return a ListOf holding the elements of 'lst' whose bits are set, in order."""
+        if len(lst) != self.size:
+            raise ValueError("Bitset.compress needs a list of the same size")
+
+        res = ListOf(lst.ElementType)()
+        res.reserve(self.count())
+
+        p = lst.pointerUnsafe(0)
+        words = self.words.pointerUnsafe(0)
+
+        for wordIx in range(len(self.words)):
+            word = words[wordIx]
+
+            while word:
+                res.append(p[wordIx * 64 + countTrailingZeros(word)])
+                word &= word - UInt64(1)
+
+        return res
+
+    @Entrypoint
+    def toMask(self) -> ListOf(bool):
+        res = ListOf(bool)()
+        res.resize(self.size)
+
+        p = res.pointerUnsafe(0)
+        words = self.words.pointerUnsafe(0)
+
+        for i in range(self.size):
+            p[i] = (words[i >> 6] >> UInt64(i & 63)) & UInt64(1) != UInt64(0)
+
+        return res
+
+
+@Entrypoint
+def bitsetFromMask(mask: ListOf(bool)) -> Bitset:
+    """Return a Bitset with the same bits as 'mask'."""
+    res = Bitset(len(mask))
+    p = mask.pointerUnsafe(0)
+    words = res.words.pointerUnsafe(0)
+
+    for i in range(len(mask)):
+        if p[i]:
+            words[i >> 6] |= UInt64(1) << UInt64(i & 63)
+
+    return res
+
+
+@Entrypoint
+def bitsetWhere(lst, pred) -> Bitset:
+    """Return a Bitset whose bit i is 'pred(lst[i])'. We build each word in a register."""
+    count = len(lst)
+    res = Bitset(count)
+    p = lst.pointerUnsafe(0)
+    words = res.words.pointerUnsafe(0)
+
+    for wordIx in range((count + 63) // 64):
+        base = wordIx * 64
+        word = UInt64(0)
+
+        for bit in range(min(64, count - base)):
+            if pred(p[base + bit]):
+                word |= UInt64(1) << UInt64(bit)
+
+        words[wordIx] = word
+
+    return res
@@ -0,0 +1,129 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import random
+
+import pytest
+
+from typed_python import Entrypoint, ListOf, UInt64
+from typed_python.lib.bitset import Bitset, bitsetFromMask, bitsetWhere, popcount, countTrailingZeros
+
+
+def test_popcount_and_count_trailing_zeros():
+    @Entrypoint
+    def compiledPopcount(x: UInt64) -> int:
+        return popcount(x)
+
+    @Entrypoint
+    def compiledCountTrailingZeros(x: UInt64) -> int:
+        return countTrailingZeros(x)
+
+    for x in [0, 1, 2, 3, 0x80, 2 ** 63, 2 ** 64 - 1, 0xF0F0F0F000000000]:
+        assert popcount(x) == compiledPopcount(x) == bin(x).count("1")
+        assert countTrailingZeros(x) == compiledCountTrailingZeros(x)
+
+    assert countTrailingZeros(0) == 64
+    assert countTrailingZeros(2 ** 63) == 63
+
+
+def test_bitset_basic():
+    bits = Bitset(100)
+
+    assert len(bits) == 100
+    assert not bits.any()
+    assert bits.count() == 0
+
+    bits[0] = True
+    bits[63] = True
+    bits[64] = True
+    bits[99] = True
+
+    assert bits[63] and bits[64] and not bits[65]
+    assert bits.count() == 4
+    assert bits.setBits() == [0, 63, 64, 99]
+
+    bits[63] = False
+    assert bits.setBits() == [0, 64, 99]
+
+    with pytest.raises(IndexError):
+        bits[100]
+
+    bits.append(True)
+    assert len(bits) == 101
+    assert bits.setBits() == [0, 64, 99, 100]
+
+    bits.resize(64)
+    assert bits.setBits() == [0]
+
+    bits.resize(128)
+    assert bits.setBits() == [0]
+
+
+def test_bitset_word_operations():
+    maskA = [random.random() < 0.3 for _ in range(1000)]
+    maskB = [random.random() < 0.6 for _ in range(1000)]
+
+    a = bitsetFromMask(ListOf(bool)(maskA))
+    b = bitsetFromMask(ListOf(bool)(maskB))
+
+    assert a.toMask() == maskA
+    assert (a & b).toMask() == [x and y for x, y in zip(maskA, maskB)]
+    assert (a | b).toMask() == [x or y for x, y in zip(maskA, maskB)]
+    assert (a ^ b).toMask() == [x != y for x, y in zip(maskA, maskB)]
+    assert (~a).toMask() == [not x for x in maskA]
+    assert (~a).count() == 1000 - sum(maskA)
+
+    c = a.copy()
+    c &= b
+    assert c == a & b
+    assert a.toMask() == maskA
+
+    with pytest.raises(ValueError):
+        a & Bitset(999)
+
+
+def test_bitset_compress():
+    values = ListOf(float)([random.random() for _ in range(1000)])
+
+    bits = bitsetWhere(values, lambda x: x > 0.5)
+
+    assert bits.toMask() == [x > 0.5 for x in values]
+    assert bits.compress(values) == [x for x in values if x > 0.5]
+    assert bits.setBits() == [i for i, x in enumerate(values) if x > 0.5]
+
+    names = ListOf(str)([str(i) for i in range(1000)])
+    assert bits.compress(names) == [names[i] for i in bits.setBits()]
+
+    with pytest.raises(ValueError):
+        bits.compress(ListOf(int)())
+
+
+def test_iterate_set_bits_in_compiled_code():
+    @Entrypoint
+    def sumWhere(bits: Bitset, values: ListOf(int)) -> int:
+        res = 0
+
+        for wordIx in range(len(bits.words)):
+            word = bits.words[wordIx]
+
+            while word:
+                res += values[wordIx * 64 + countTrailingZeros(word)]
+                word &= word - UInt64(1)
+
+        return res
+
+    values = ListOf(int)(range(500))
+    bits = bitsetWhere(values, lambda x: x % 7 == 0)
+
+    assert sumWhere(bits, values) == sum(x for x in values if x % 7 == 0)
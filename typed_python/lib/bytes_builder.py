@@ -0,0 +1,142 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import (
+    Class, Member, Final, ListOf, PointerTo, UInt8, UInt16, UInt32, UInt64,
+    Int8, Int16, Int32, Float32
+)
+
+
+class BytesBuilder(Class, Final):
+    """Accumulates a binary message in a growable buffer.
+
+    Usage:
+
+        bb = BytesBuilder()
+        bb.writeUInt8(MSG_NEW_ORDER)
+        bb.writeInt64LE(orderId)
+        bb.writeFloat64LE(price)
+        bb.writeBytes(symbol)
+        message = bb.build()
+
+    Concatenating bytes with '+' copies the whole message every time. A
+    BytesBuilder appends into a buffer that doubles when it fills, and each
+    write is a store straight into it, so building a message costs one copy
+    of it, in 'build'.
+
+    Ints are truncated to the width being written, like a cast to Int32 and
+    so on, rather than checked. The 'LE' methods write little-endian with a
+    native store, so they assume a little-endian machine; the 'BE' methods
+    write big-endian (network order).
+
+    Works both in the interpreter and in compiled code.
+    """
+    _buffer = Member(ListOf(UInt8), nonempty=True)
+
+    def _append(self, byteCount: int) -> PointerTo(UInt8):
+        """Grow the buffer by 'byteCount' uninitialized bytes, returning a pointer to them."""
+        count = len(self._buffer)
+
+        if count + byteCount > self._buffer.reserved():
+            self._buffer.reserve(max(count + byteCount, self._buffer.reserved() * 2, 64))
+
+        self._buffer.setSizeUnsafe(count + byteCount)
+
+        return self._buffer.pointerUnsafe(count)
+
+    def _reverseLast(self, byteCount: int) -> None:
+        p = self._buffer.pointerUnsafe(len(self._buffer) - byteCount)
+
+        for i in range(byteCount // 2):
+            low = (p + i).get()
+            (p + i).set((p + (byteCount - 1 - i)).get())
+            (p + (byteCount - 1 - i)).set(low)
+
+    def writeBytes(self, b: bytes) -> None:
+        p = self._append(len(b))
+
+        for i in range(len(b)):
+            (p + i).set(UInt8(b[i]))
+
+    def writeUInt8(self, x: int) -> None:
+        self._append(1).set(UInt8(x))
+
+    def writeInt8(self, x: int) -> None:
+        self._append(1).cast(Int8).set(Int8(x))
+
+    def writeUInt16LE(self, x: int) -> None:
+        self._append(2).cast(UInt16).set(UInt16(x))
+
+    def writeUInt16BE(self, x: int) -> None:
+        self.writeUInt16LE(x)
+        self._reverseLast(2)
+
+    def writeInt16LE(self, x: int) -> None:
+        self._append(2).cast(Int16).set(Int16(x))
+
+    def writeInt16BE(self, x: int) -> None:
+        self.writeInt16LE(x)
+        self._reverseLast(2)
+
+    def writeUInt32LE(self, x: int) -> None:
+        self._append(4).cast(UInt32).set(UInt32(x))
+
+    def writeUInt32BE(self, x: int) -> None:
+        self.writeUInt32LE(x)
+        self._reverseLast(4)
+
+    def writeInt32LE(self, x: int) -> None:
+        self._append(4).cast(Int32).set(Int32(x))
+
+    def writeInt32BE(self, x: int) -> None:
+        self.writeInt32LE(x)
+        self._reverseLast(4)
+
+    def writeUInt64LE(self, x: UInt64) -> None:
+        self._append(8).cast(UInt64).set(x)
+
+    def writeUInt64BE(self, x: UInt64) -> None:
+        self.writeUInt64LE(x)
+        self._reverseLast(8)
+
+    def writeInt64LE(self, x: int) -> None:
+        self._append(8).cast(int).set(x)
+
+    def writeInt64BE(self, x: int) -> None:
+        self.writeInt64LE(x)
+        self._reverseLast(8)
+
+    def writeFloat32LE(self, x: float) -> None:
+        self._append(4).cast(Float32).set(Float32(x))
+
+    def writeFloat32BE(self, x: float) -> None:
+        self.writeFloat32LE(x)
+        self._reverseLast(4)
+
+    def writeFloat64LE(self, x: float) -> None:
+        self._append(8).cast(float).set(x)
+
+    def writeFloat64BE(self, x: float) -> None:
+        self.writeFloat64LE(x)
+        self._reverseLast(8)
+
+    def clear(self) -> None:
+        """Forget what we've written, but keep the buffer for the next message."""
+        self._buffer.setSizeUnsafe(0)
+
+    def build(self) -> bytes:
+        return self._buffer.toBytes()
+
+    def __len__(self) -> int:
+        return len(self._buffer)
@@ -0,0 +1,93 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import struct
+
+from typed_python import Entrypoint
+from typed_python.lib.bytes_builder import BytesBuilder
+
+
+def writeEverything(bb: BytesBuilder) -> None:
+    bb.writeUInt8(255)
+    bb.writeInt8(-2)
+    bb.writeUInt16LE(0x1234)
+    bb.writeUInt16BE(0x1234)
+    bb.writeInt16LE(-3)
+    bb.writeInt16BE(-3)
+    bb.writeUInt32LE(0xDEADBEEF)
+    bb.writeUInt32BE(0xDEADBEEF)
+    bb.writeInt32LE(-4)
+    bb.writeInt32BE(-4)
+    bb.writeUInt64LE(0x0123456789ABCDEF)
+    bb.writeUInt64BE(0x0123456789ABCDEF)
+    bb.writeInt64LE(-5)
+    bb.writeInt64BE(-5)
+    bb.writeFloat32LE(1.5)
+    bb.writeFloat32BE(1.5)
+    bb.writeFloat64LE(-0.1)
+    bb.writeFloat64BE(-0.1)
+    bb.writeBytes(b"abc")
+    bb.writeBytes(b"")
+
+
+EXPECTED = b"".join([
+    struct.pack("<Bb", 255, -2),
+    struct.pack("<H", 0x1234), struct.pack(">H", 0x1234),
+    struct.pack("<h", -3), struct.pack(">h", -3),
+    struct.pack("<I", 0xDEADBEEF), struct.pack(">I", 0xDEADBEEF),
+    struct.pack("<i", -4), struct.pack(">i", -4),
+    struct.pack("<Q", 0x0123456789ABCDEF), struct.pack(">Q", 0x0123456789ABCDEF),
+    struct.pack("<q", -5), struct.pack(">q", -5),
+    struct.pack("<f", 1.5), struct.pack(">f", 1.5),
+    struct.pack("<d", -0.1), struct.pack(">d", -0.1),
+    b"abc",
+])
+
+
+def test_bytes_builder_interpreted():
+    bb = BytesBuilder()
+
+    assert bb.build() == b""
+
+    writeEverything(bb)
+
+    assert bb.build() == EXPECTED
+    assert len(bb) == len(EXPECTED)
+
+    bb.clear()
+    assert bb.build() == b""
+
+    bb.writeUInt16BE(0x0102)
+    assert bb.build() == b"\x01\x02"
+
+
+def test_bytes_builder_compiled():
+    @Entrypoint
+    def build() -> bytes:
+        bb = BytesBuilder()
+        writeEverything(bb)
+        return bb.build()
+
+    assert build() == EXPECTED
+
+
+def test_bytes_builder_grows():
+    @Entrypoint
+    def build(count: int) -> bytes:
+        bb = BytesBuilder()
+        for i in range(count):
+            bb.writeUInt32BE(i)
+        return bb.build()
+
+    assert build(10000) == b"".join(struct.pack(">I", i) for i in range(10000))
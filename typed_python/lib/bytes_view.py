@@ -0,0 +1,119 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import Class, Member, Final, Forward, OneOf, Tuple, NotCompiled
+from typed_python._types import (
+    bufferAddress, bufferFind, bufferRFind, bufferCount, deserializeBuffer
+)
+
+
+@NotCompiled
+def _exportBuffer(source) -> Tuple(object, int, int):
+    view = memoryview(source)
+
+    if not view.contiguous:
+        raise ValueError("BytesView requires a contiguous buffer")
+
+    view = view.cast('B')
+    address, size = bufferAddress(view)
+
+    return (view, address, size)
+
+
+def _clip(ix, size):
+    if ix < 0:
+        ix += size
+        if ix < 0:
+            return 0
+    if ix > size:
+        return size
+    return ix
+
+
+BytesView = Forward("BytesView")
+
+
+@BytesView.define
+class BytesView(Class, Final):
+    """A read-only window onto bytes owned by some other object.
+
+    Usage:
+
+        with open(path, 'rb') as f:
+            m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        view = BytesView(m)
+        header = view.slice(0, 16)
+        payload = view.slice(16, len(view)).deserialize(ListOf(Trade))
+
+    Making a Bytes out of a socket payload or an mmapped file copies all of
+    it. A BytesView wraps anything that exports a contiguous buffer
+    (bytes, bytearray, mmap, memoryview, numpy arrays, ...) and reads it in
+    place: slicing returns another view onto the same memory, and 'find',
+    'rfind', 'count' and 'deserialize' run directly against the buffer.
+
+    The view holds a memoryview of the source, which keeps it alive and
+    stops it from being resized or closed underneath us.
+
+    Works both in the interpreter and in compiled code.
+    """
+    _buffer = Member(object)
+    _address = Member(int, nonempty=True)
+    _start = Member(int, nonempty=True)
+    _size = Member(int, nonempty=True)
+
+    def __init__(self, source):
+        self._buffer, self._address, self._size = _exportBuffer(source)
+
+    def __init__(self, other: BytesView, start: int, size: int):  # noqa
+        self._buffer = other._buffer
+        self._address = other._address
+        self._start = start
+        self._size = size
+
+    def __len__(self) -> int:
+        return self._size
+
+    def __getitem__(self, i: int) -> int:
+        if i < 0:
+            i += self._size
+
+        if i < 0 or i >= self._size:
+            raise IndexError("BytesView index out of range")
+
+        return int(self._buffer[self._start + i])
+
+    def slice(self, start: int, stop: int) -> BytesView:
+        """Return a view of self[start:stop], without copying."""
+        start = _clip(start, self._size)
+        stop = _clip(stop, self._size)
+
+        return BytesView(self, self._start + start, max(stop - start, 0))
+
+    def find(self, sub: bytes, start: int = 0, end: OneOf(None, int) = None) -> int:
+        return bufferFind(self._address + self._start, self._size, sub, start, self._size if end is None else end)
+
+    def rfind(self, sub: bytes, start: int = 0, end: OneOf(None, int) = None) -> int:
+        return bufferRFind(self._address + self._start, self._size, sub, start, self._size if end is None else end)
+
+    def count(self, sub: bytes, start: int = 0, end: OneOf(None, int) = None) -> int:
+        return bufferCount(self._address + self._start, self._size, sub, start, self._size if end is None else end)
+
+    def deserialize(self, T, serializationContext=None):
+        """Deserialize an instance of T from the bytes in this view."""
+        return deserializeBuffer(T, self._address + self._start, self._size, serializationContext)
+
+    def toBytes(self) -> bytes:
+        """Copy the contents of the view into a new bytes object."""
+        return bytes(self._buffer[self._start:self._start + self._size])
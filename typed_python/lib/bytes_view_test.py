@@ -0,0 +1,83 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import mmap
+import pytest
+import tempfile
+from typed_python import Entrypoint, ListOf, serialize, deserialize
+from typed_python.lib.bytes_view import BytesView
+
+
+def test_bytes_view_basic():
+    data = bytearray(b"hello, world")
+    view = BytesView(data)
+
+    assert len(view) == 12
+    assert view[0] == ord("h")
+    assert view[-1] == ord("d")
+    assert view.toBytes() == b"hello, world"
+
+    with pytest.raises(IndexError):
+        view[12]
+
+    sub = view.slice(7, 100)
+    assert sub.toBytes() == b"world"
+    assert sub.slice(-3, -1).toBytes() == b"rl"
+    assert view.slice(5, 2).toBytes() == b""
+
+    # views share the memory of the source, rather than copying it
+    data[7] = ord("W")
+    assert sub.toBytes() == b"World"
+
+
+def test_bytes_view_search_matches_bytes():
+    data = b"abcab" * 50 + b"xyz" + b"abcab" * 50
+    view = BytesView(data)
+
+    @Entrypoint
+    def compiledFind(v: BytesView, sub: bytes, start: int) -> int:
+        return v.find(sub, start)
+
+    for sub in [b"", b"a", b"cab", b"xyz", b"abcabx", b"nope", b"abcab" * 10]:
+        for start in [0, 3, -20, 1000]:
+            assert view.find(sub, start) == data.find(sub, start), (sub, start)
+            assert compiledFind(view, sub, start) == data.find(sub, start), (sub, start)
+            assert view.rfind(sub, start) == data.rfind(sub, start), (sub, start)
+            assert view.count(sub, start) == data.count(sub, start), (sub, start)
+
+        sliced = view.slice(100, 300)
+        assert sliced.find(sub) == data[100:300].find(sub)
+
+
+def test_bytes_view_deserialize_in_place():
+    T = ListOf(str)
+    payload = serialize(T, T(["a", "b", "c" * 100]))
+    header = b"HEADER--"
+
+    with tempfile.TemporaryFile() as f:
+        f.write(header + payload)
+        f.flush()
+
+        m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        view = BytesView(m)
+
+        @Entrypoint
+        def compiledDeserialize(v: BytesView) -> T:
+            return v.slice(8, len(v)).deserialize(T)
+
+        assert view.slice(8, len(view)).deserialize(T) == T(["a", "b", "c" * 100])
+        assert compiledDeserialize(view) == T(["a", "b", "c" * 100])
+
+        # deserialize itself reads any buffer in place
+        assert deserialize(T, memoryview(m)[8:]) == T(["a", "b", "c" * 100])
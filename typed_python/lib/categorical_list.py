@@ -0,0 +1,211 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A dictionary-encoded list, for columns with few distinct values.
+
+A 'ListOf(str)' holding hundreds of millions of copies of a few thousand
+strings spends a pointer per row, and comparing two rows means comparing
+strings. 'CategoricalListOf(str)' stores each distinct value once, in
+'categories', and each row as an Int32 index into it, in 'codes'.
+
+Usage:
+
+    colors = CategoricalListOf(str)(["red", "blue", "red"])
+
+    colors[2]                   # "red"
+    colors.codes                # [0, 1, 0]
+    colors.categories           # ["red", "blue"]
+    colors.equalsMask("red")    # [True, False, True], comparing codes only
+    colors.groupBy()            # {"red": [0, 2], "blue": [1]}
+
+Codes are handed out in order of first appearance and never change, so
+they're safe to hold on to while the list grows.
+
+To find the code for a value we keep a map from hash to code rather than a
+Dict(T, Int32), so that serializing the list writes each category once,
+in 'categories', instead of once there and once more as a Dict key. The
+methods that hash are Entrypoints, so the hashes are typed_python's
+deterministic ones and stay valid across processes. So are the methods
+that scan 'codes'. Serializing with
+'SerializationContext().withSerializePodListsInline()' writes 'codes' as
+one block of memory.
+"""
+
+from typed_python import Class, Final, Member, TypeFunction, ListOf, Dict, Int32, Entrypoint
+
+
+@TypeFunction
+def CategoricalListOf(T):
+    """Create a dictionary-encoded list of the hashable type T."""
+    class CategoricalListOf(Class, Final, __name__=f"CategoricalListOf({T.__name__})"):
+        ElementType = T
+
+        # one entry per row: an index into 'categories'
+        codes = Member(ListOf(Int32), nonempty=True)
+
+        # one entry per distinct value
+        categories = Member(ListOf(T), nonempty=True)
+
+        # hash(value) -> the last code added with that hash. '_sameHash[code]' is
+        # the previous code with the same hash as 'code', or -1.
+        _codeForHash = Member(Dict(int, Int32), nonempty=True)
+        _sameHash = Member(ListOf(Int32), nonempty=True)
+
+        def __init__(self):
+            pass
+
+        def __init__(self, values):  # noqa: F811
+            for value in values:
+                self.append(value)
+
+        def __len__(self) -> int:
+            return len(self.codes)
+
+        @Entrypoint
+        def codeFor(self, value: T) -> int:
+            """Return the code for 'value', or -1 if it's not one of our categories."""
+            h = hash(value)
+
+            if h not in self._codeForHash:
+                return -1
+
+            code = int(self._codeForHash[h])
+
+            while code >= 0:
+                if self.categories[code] == value:
+                    return code
+
+                code = int(self._sameHash[code])
+
+            return -1
+
+        @Entrypoint
+        def encode(self, value: T) -> int:
+            """Return the code for 'value', adding it to our categories if it's new."""
+            code = self.codeFor(value)
+
+            if code >= 0:
+                return code
+
+            code = len(self.categories)
+
+            if code >= 2 ** 31 - 1:
+                raise OverflowError("CategoricalListOf can't hold more than 2**31 - 1 categories")
+
+            h = hash(value)
+
+            if h in self._codeForHash:
+                self._sameHash.append(self._codeForHash[h])
+            else:
+                self._sameHash.append(Int32(-1))
+
+            self._codeForHash[h] = Int32(code)
+            self.categories.append(value)
+
+            return code
+
+        def append(self, value: T) -> None:
+            self.codes.append(Int32(self.encode(value)))
+
+        def __getitem__(self, i: int) -> T:
+            return self.categories[self.codes[i]]
+
+        def __setitem__(self, i: int, value: T) -> None:
+            self.codes[i] = Int32(self.encode(value))
+
+        @Entrypoint
+        def toList(self) -> ListOf(T):
+            res = ListOf(T)()
+            res.reserve(len(self.codes))
+
+            for code in self.codes:
+                res.append(self.categories[code])
+
+            return res
+
+        @Entrypoint
+        def equalsMask(self, value: T) -> ListOf(bool):
+            """Return a ListOf(bool) that's True for each row equal to 'value'."""
+            res = ListOf(bool)()
+            res.resize(len(self.codes))
+
+            code = Int32(self.codeFor(value))
+
+            if code < 0:
+                return res
+
+            src = self.codes.pointerUnsafe(0)
+            dest = res.pointerUnsafe(0)
+
+            for i in range(len(self.codes)):
+                dest[i] = src[i] == code
+
+            return res
+
+        @Entrypoint
+        def indicesOf(self, value: T) -> ListOf(int):
+            """Return the rows equal to 'value', in order."""
+            res = ListOf(int)()
+            code = Int32(self.codeFor(value))
+
+            if code < 0:
+                return res
+
+            src = self.codes.pointerUnsafe(0)
+
+            for i in range(len(self.codes)):
+                if src[i] == code:
+                    res.append(i)
+
+            return res
+
+        @Entrypoint
+        def countsByCode(self) -> ListOf(int):
+            """Return how many rows have each code. Categories with no rows count zero."""
+            res = ListOf(int)()
+            res.resize(len(self.categories))
+
+            counts = res.pointerUnsafe(0)
+            src = self.codes.pointerUnsafe(0)
+
+            for i in range(len(self.codes)):
+                counts[src[i]] += 1
+
+            return res
+
+        @Entrypoint
+        def groupBy(self) -> Dict(T, ListOf(int)):
+            """Return a Dict from each value that has rows to the list of those rows."""
+            counts = self.countsByCode()
+            groups = ListOf(ListOf(int))()
+            groups.resize(len(self.categories))
+
+            for code in range(len(self.categories)):
+                groups[code].reserve(counts[code])
+
+            src = self.codes.pointerUnsafe(0)
+
+            for i in range(len(self.codes)):
+                groups[src[i]].append(i)
+
+            res = Dict(T, ListOf(int))()
+
+            for code in range(len(self.categories)):
+                if counts[code]:
+                    res[self.categories[code]] = groups[code]
+
+            return res
+
+    return CategoricalListOf
@@ -0,0 +1,100 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import Entrypoint, ListOf, SerializationContext
+from typed_python.lib.categorical_list import CategoricalListOf
+
+
+def test_categorical_list_basic():
+    colors = CategoricalListOf(str)(["red", "blue", "red"])
+
+    assert len(colors) == 3
+    assert colors[0] == "red"
+    assert colors[-1] == "red"
+    assert colors.codes == [0, 1, 0]
+    assert colors.categories == ["red", "blue"]
+    assert colors.toList() == ["red", "blue", "red"]
+
+    colors[1] = "green"
+    assert colors.codes == [0, 2, 0]
+    assert colors.codeFor("blue") == 1
+    assert colors.codeFor("purple") == -1
+
+    with pytest.raises(IndexError):
+        colors[3]
+
+
+def test_categorical_list_filters_and_groups():
+    values = [str(i % 7) for i in range(100)]
+    column = CategoricalListOf(str)(values)
+
+    assert column.equalsMask("3") == [v == "3" for v in values]
+    assert column.equalsMask("missing") == [False] * 100
+    assert column.indicesOf("3") == [i for i, v in enumerate(values) if v == "3"]
+    assert column.countsByCode() == [values.count(c) for c in column.categories]
+
+    groups = column.groupBy()
+
+    assert len(groups) == 7
+    for value in column.categories:
+        assert groups[value] == [i for i, v in enumerate(values) if v == value]
+
+
+def test_categorical_list_hash_collisions():
+    # small ints hash to themselves, so these are likely to share a hash
+    # once it's folded down to 32 bits
+    values = [1, 1 + 2 ** 32, 1, 2 ** 32, 0]
+    column = CategoricalListOf(int)(values)
+
+    assert column.codes == [0, 1, 0, 2, 3]
+    assert column.toList() == values
+    assert [column.codeFor(v) for v in values] == [0, 1, 0, 2, 3]
+
+
+def test_categorical_list_serializes_categories_once():
+    longValue = "x" * 10000
+    column = CategoricalListOf(str)([longValue, "short"] * 1000)
+
+    sc = SerializationContext().withSerializePodListsInline()
+    data = sc.serialize(column)
+
+    assert len(data) < 3 * len(longValue)
+
+    column2 = sc.deserialize(data)
+
+    assert column2.toList() == column.toList()
+    assert column2.codeFor(longValue) == 0
+
+    column2.append("new")
+    assert column2.codeFor("new") == 2
+
+
+def test_categorical_list_in_compiled_code():
+    @Entrypoint
+    def countEqual(column: CategoricalListOf(str), value: str):
+        code = column.codeFor(value)
+        res = 0
+
+        for c in column.codes:
+            if c == code:
+                res += 1
+
+        return res
+
+    column = CategoricalListOf(str)(ListOf(str)(["a", "b", "a", "c"]))
+
+    assert countEqual(column, "a") == 2
+    assert countEqual(column, "d") == 0
@@ -0,0 +1,197 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A list of NamedTuples stored one column at a time.
+
+'ListOf(NamedTuple(x=float, y=float, id=int))' keeps its rows next to each
+other, so a loop that only looks at 'x' still drags 'y' and 'id' through the
+cache. 'ColumnarListOf(NamedTuple(x=float, y=float, id=int))' keeps a separate
+'ListOf(float)' for 'x', another for 'y', and a 'ListOf(int)' for 'id'.
+
+Usage:
+
+    Point = NamedTuple(x=float, y=float, id=int)
+
+    points = ColumnarListOf(Point)()
+    points.append(Point(x=1.0, y=2.0, id=0))
+
+    points[0]          # Point(x=1.0, y=2.0, id=0), assembled from the columns
+    points.columns.x   # the ListOf(float) holding every 'x'
+
+    # keep the rows with positive 'x'
+    positive = points.filter(columnMask(points.columns.x, lambda x: x > 0))
+
+Rows are assembled on demand, so indexing, appending and 'toRows' behave like
+they do on a ListOf(T). Code that only needs a few fields should go through
+'columns' instead: each column is an ordinary ListOf, and a loop over it is a
+unit-stride loop the compiler can vectorize.
+
+The columns are shared, not copied, when you read them out of 'columns'.
+Appending to one of them directly leaves the columns with different lengths,
+which the row methods don't check for.
+"""
+
+from typed_python import ListOf, NamedTuple, Entrypoint
+from typed_python import Class, Final, Member  # noqa: F401
+from typed_python.macro import Macro
+
+
+@Entrypoint
+def columnMask(column, predicate) -> ListOf(bool):
+    """Return a ListOf(bool) holding 'predicate(x)' for each element 'x' of 'column'."""
+    res = ListOf(bool)()
+    res.resize(len(column))
+
+    src = column.pointerUnsafe(0)
+    dest = res.pointerUnsafe(0)
+
+    for i in range(len(column)):
+        dest[i] = predicate(src[i])
+
+    return res
+
+
+@Entrypoint
+def _countTrue(mask: ListOf(bool)) -> int:
+    res = 0
+    p = mask.pointerUnsafe(0)
+
+    for i in range(len(mask)):
+        if p[i]:
+            res += 1
+
+    return res
+
+
+@Entrypoint
+def _compress(column, mask: ListOf(bool), count: int):
+    """Return the elements of 'column' where 'mask' is True. There are 'count' of them."""
+    res = ListOf(column.ElementType)()
+    res.reserve(count)
+
+    src = column.pointerUnsafe(0)
+    p = mask.pointerUnsafe(0)
+
+    for i in range(len(column)):
+        if p[i]:
+            res.append(src[i])
+
+    return res
+
+
+@Entrypoint
+def _gather(column, indices: ListOf(int)):
+    """Return the elements of 'column' at 'indices'. The indices have already been checked."""
+    res = ListOf(column.ElementType)()
+    res.reserve(len(indices))
+
+    src = column.pointerUnsafe(0)
+
+    for i in indices:
+        res.append(src[i])
+
+    return res
+
+
+@Macro
+def ColumnarListOf(T):
+    """Create a list of the NamedTuple type 'T' that stores each field in its own ListOf."""
+    if getattr(T, "__typed_python_category__", None) != "NamedTuple" or not T.ElementNames:
+        raise TypeError(f"ColumnarListOf needs a NamedTuple with at least one field, not {T}")
+
+    names = T.ElementNames
+    Columns = NamedTuple(**{name: ListOf(eltType) for name, eltType in zip(names, T.ElementTypes)})
+
+    def eachColumn(pattern):
+        return ", ".join(pattern.format(name=name) for name in names)
+
+    output = []
+    output.append("class ColumnarListOf_(Class, Final, __name__=typeName):")
+    output.append("    ElementType = T")
+    output.append("    ColumnsType = Columns")
+    output.append("    columns = Member(Columns)")
+
+    output.append("    def __init__(self):")
+    output.append("        pass")
+
+    output.append("    def __init__(self, rows):")
+    output.append("        for row in rows:")
+    output.append("            self.append(row)")
+
+    output.append("    def __len__(self) -> int:")
+    output.append(f"        return len(self.columns.{names[0]})")
+
+    output.append("    def _checkIndex(self, i: int) -> int:")
+    output.append("        if i < 0:")
+    output.append("            i += len(self)")
+    output.append("        if i < 0 or i >= len(self):")
+    output.append("            raise IndexError('index out of range')")
+    output.append("        return i")
+
+    output.append("    def __getitem__(self, i: int) -> T:")
+    output.append("        i = self._checkIndex(i)")
+    output.append("        return T(" + eachColumn("{name}=self.columns.{name}[i]") + ")")
+
+    output.append("    def __setitem__(self, i: int, row: T) -> None:")
+    output.append("        i = self._checkIndex(i)")
+    for name in names:
+        output.append(f"        self.columns.{name}[i] = row.{name}")
+
+    output.append("    def append(self, row: T) -> None:")
+    for name in names:
+        output.append(f"        self.columns.{name}.append(row.{name})")
+
+    output.append("    def extend(self, other) -> None:")
+    for name in names:
+        output.append(f"        self.columns.{name}.extend(other.columns.{name})")
+
+    output.append("    def reserve(self, count: int) -> None:")
+    for name in names:
+        output.append(f"        self.columns.{name}.reserve(count)")
+
+    output.append("    def clear(self) -> None:")
+    for name in names:
+        output.append(f"        self.columns.{name}.clear()")
+
+    output.append("    def toRows(self) -> ListOf(T):")
+    output.append("        res = ListOf(T)()")
+    output.append("        res.reserve(len(self))")
+    output.append("        for i in range(len(self)):")
+    output.append("            res.append(T(" + eachColumn("{name}=self.columns.{name}[i]") + "))")
+    output.append("        return res")
+
+    output.append("    def filter(self, mask: ListOf(bool)):")
+    output.append("        if len(mask) != len(self):")
+    output.append("            raise ValueError('filter mask has the wrong length')")
+    output.append("        count = _countTrue(mask)")
+    output.append("        res = ColumnarListOf_()")
+    output.append("        res.columns = Columns(" + eachColumn("{name}=_compress(self.columns.{name}, mask, count)") + ")")
+    output.append("        return res")
+
+    output.append("    def take(self, indices: ListOf(int)):")
+    output.append("        size = len(self)")
+    output.append("        for i in indices:")
+    output.append("            if i < 0 or i >= size:")
+    output.append("                raise IndexError('index out of range')")
+    output.append("        res = ColumnarListOf_()")
+    output.append("        res.columns = Columns(" + eachColumn("{name}=_gather(self.columns.{name}, indices)") + ")")
+    output.append("        return res")
+
+    output.append("return ColumnarListOf_")
+
+    return {
+        "sourceText": output,
+        "locals": {"T": T, "Columns": Columns, "typeName": f"ColumnarListOf({T.__name__})"},
+    }
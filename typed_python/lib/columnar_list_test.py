@@ -0,0 +1,126 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import Entrypoint, ListOf, NamedTuple
+from typed_python.lib.columnar_list import ColumnarListOf, columnMask
+
+
+Point = NamedTuple(x=float, y=float, id=int)
+
+
+def makePoints(count):
+    return ColumnarListOf(Point)([Point(x=i - count / 2, y=i * 2.0, id=i) for i in range(count)])
+
+
+def test_columnar_list_rows():
+    points = ColumnarListOf(Point)()
+
+    assert ColumnarListOf(Point) is ColumnarListOf(Point)
+    assert len(points) == 0
+
+    points.append(Point(x=1.0, y=2.0, id=3))
+    points.append(Point(x=4.0, y=5.0, id=6))
+
+    assert len(points) == 2
+    assert points[0] == Point(x=1.0, y=2.0, id=3)
+    assert points[-1] == Point(x=4.0, y=5.0, id=6)
+
+    points[0] = Point(x=-1.0, y=-2.0, id=-3)
+    assert points.toRows() == ListOf(Point)([Point(x=-1.0, y=-2.0, id=-3), Point(x=4.0, y=5.0, id=6)])
+
+    with pytest.raises(IndexError):
+        points[2]
+
+    with pytest.raises(IndexError):
+        points[-3] = Point()
+
+    points.extend(points)
+    assert len(points) == 4
+    assert points[3] == points[1]
+
+    points.clear()
+    assert len(points) == 0
+
+
+def test_columnar_list_columns_are_shared():
+    points = makePoints(10)
+
+    assert points.columns.id == list(range(10))
+    assert isinstance(points.columns.x, ListOf(float))
+
+    points.columns.y[3] = 100.0
+    assert points[3].y == 100.0
+
+
+def test_columnar_list_filter_and_take():
+    points = makePoints(10)
+
+    positive = points.filter(columnMask(points.columns.x, lambda x: x > 0))
+
+    assert positive.columns.id == [6, 7, 8, 9]
+    assert positive.toRows() == [p for p in points.toRows() if p.x > 0]
+
+    assert points.take(ListOf(int)([9, 0, 9])).columns.id == [9, 0, 9]
+
+    with pytest.raises(ValueError):
+        points.filter(ListOf(bool)([True]))
+
+    with pytest.raises(IndexError):
+        points.take(ListOf(int)([10]))
+
+
+def test_columnar_list_refcounted_fields():
+    Row = NamedTuple(name=str, tags=ListOf(str))
+
+    rows = ColumnarListOf(Row)()
+    rows.append(Row(name="a", tags=["x"]))
+    rows.append(Row(name="b", tags=[]))
+
+    assert rows.filter(columnMask(rows.columns.tags, lambda t: len(t) > 0)).toRows() == [Row(name="a", tags=["x"])]
+
+
+def test_columnar_list_in_compiled_code():
+    @Entrypoint
+    def sumXWhereIdIsEven(points: ColumnarListOf(Point)):
+        res = 0.0
+        xs = points.columns.x
+        ids = points.columns.id
+
+        for i in range(len(points)):
+            if ids[i] % 2 == 0:
+                res += xs[i]
+
+        return res
+
+    @Entrypoint
+    def build(count: int):
+        res = ColumnarListOf(Point)()
+        res.reserve(count)
+
+        for i in range(count):
+            res.append(Point(x=i - count / 2, y=i * 2.0, id=i))
+
+        return res
+
+    points = build(10)
+
+    assert points.toRows() == makePoints(10).toRows()
+    assert sumXWhereIdIsEven(points) == sum(p.x for p in points.toRows() if p.id % 2 == 0)
+
+
+def test_columnar_list_needs_a_named_tuple():
+    with pytest.raises(TypeError):
+        ColumnarListOf(int)
@@ -0,0 +1,390 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A compact, relocatable frozen form for read-only object graphs.
+
+'deepcopyContiguous' copies a graph into a Slab, where every object keeps its
+normal layout: a max_align_t header per allocation, a refcount, and 64-bit
+absolute pointers to its children. For a tree of small TupleOfs, most of the
+slab is headers and pointers, and the pointers tie it to the address it was
+built at.
+
+'CompactSlab(T).freeze(value)' writes 'value' into one ListOf(UInt8) instead:
+
+    header: UInt32 magic, UInt32 version
+    root: the inline form of the value, at byte 8
+
+where the inline form of a value depends on its type:
+
+    POD types (numbers, and Tuples, NamedTuples and OneOfs of them): their
+        native bytes.
+    str and bytes: a UInt32 offset of a record holding a UInt32 byte count and
+        then the (utf-8) bytes.
+    TupleOf(E) and ListOf(E): a UInt32 offset of a record holding a UInt32 count
+        and then the inline forms of the elements, back to back.
+
+Offsets count from the start of the buffer, and 0 means an empty record. Nothing
+in the buffer is an address, so it can be written to disk (see 'toBytes') and
+read back anywhere with 'fromBytes'. Records carry no header or refcount, and
+each is aligned only as much as its contents need.
+
+'root()' returns a view, not a copy: sequences come back as 'CompactSequence'
+views, whose indexing reads straight out of the buffer in compiled code. POD
+values, strs and bytes come back by value. 'thaw()' rebuilds the whole original
+value.
+
+    @Entrypoint
+    def total(slab: CompactSlab(TupleOf(TupleOf(int)))) -> int:
+        res = 0
+        for row in slab.root():
+            for x in row:
+                res += x
+        return res
+
+A buffer is limited to 4GB, and other types (Classes, Dicts, PointerTo and so
+on) can't be frozen this way.
+"""
+
+from typed_python import (
+    NamedTuple, ListOf, Class, Final, TypeFunction, UInt8, UInt32
+)
+from typed_python._types import isPOD, bytecount
+
+
+# "TPCS", read as a little-endian UInt32
+_MAGIC = 0x53435054
+_VERSION = 1
+_HEADER_BYTES = 8
+_MAX_BYTES = 1 << 32
+
+
+def _alignUp(x, alignment):
+    return (x + alignment - 1) // alignment * alignment
+
+
+def _allocate(buf, byteCount, alignment):
+    """Append 'byteCount' zeroed bytes to 'buf' at a multiple of 'alignment', and return where they start."""
+    at = _alignUp(len(buf), alignment)
+
+    if at + byteCount > _MAX_BYTES:
+        raise OverflowError("A CompactSlab can't be bigger than 4GB")
+
+    if at + byteCount > buf.reserved():
+        buf.reserve(max(at + byteCount, buf.reserved() * 2))
+
+    buf.resize(at + byteCount)
+
+    return at
+
+
+def _writeUInt32(buf, at, value):
+    buf.pointerUnsafe(at).cast(UInt32).set(UInt32(value))
+
+
+def _readUInt32(data, at) -> int:
+    return int(data.pointerUnsafe(at).cast(UInt32).get())
+
+
+def _recordCount(data, offset, headerBytes, elementBytes) -> int:
+    """The count heading the record at 'offset', once we've checked the record fits in 'data'."""
+    if offset < _HEADER_BYTES or offset + 4 > len(data):
+        raise IndexError("Corrupt CompactSlab: a record is out of range")
+
+    count = int(data.pointerUnsafe(offset).cast(UInt32).get())
+
+    if offset + headerBytes + count * elementBytes > len(data):
+        raise IndexError("Corrupt CompactSlab: a record is out of range")
+
+    return count
+
+
+def _writeBytes(buf, at, value: bytes):
+    if not len(value):
+        return
+
+    recordAt = _allocate(buf, 4 + len(value), 4)
+
+    p = buf.pointerUnsafe(recordAt)
+    p.cast(UInt32).set(UInt32(len(value)))
+    p += 4
+
+    for i in range(len(value)):
+        (p + i).set(UInt8(value[i]))
+
+    _writeUInt32(buf, at, recordAt)
+
+
+def _readBytes(data, at) -> bytes:
+    offset = _readUInt32(data, at)
+
+    if offset == 0:
+        return b""
+
+    count = _recordCount(data, offset, 4, 1)
+
+    return data[offset + 4:offset + 4 + count].toBytes()
+
+
+def _isRelocatablePod(T):
+    category = getattr(T, "__typed_python_category__", None)
+
+    if category == "PointerTo":
+        return False
+
+    if category in ("Tuple", "NamedTuple"):
+        return all(_isRelocatablePod(t) for t in T.ElementTypes)
+
+    return isPOD(T)
+
+
+def _podAlignment(byteCount):
+    alignment = 1
+
+    while alignment < 8 and byteCount and byteCount % (alignment * 2) == 0:
+        alignment *= 2
+
+    return alignment
+
+
+@TypeFunction
+def _PodLayout(T):
+    class _PodLayout_(Class, Final):
+        inlineSize = bytecount(T)
+        alignment = _podAlignment(bytecount(T))
+
+        @staticmethod
+        def write(buf: ListOf(UInt8), at: int, value: T) -> None:
+            buf.pointerUnsafe(at).cast(T).set(value)
+
+        @staticmethod
+        def read(data: ListOf(UInt8), at: int) -> T:
+            return data.pointerUnsafe(at).cast(T).get()
+
+        @staticmethod
+        def thaw(data: ListOf(UInt8), at: int) -> T:
+            return data.pointerUnsafe(at).cast(T).get()
+
+    return _PodLayout_
+
+
+class _BytesLayout(Class, Final):
+    inlineSize = 4
+    alignment = 4
+
+    @staticmethod
+    def write(buf: ListOf(UInt8), at: int, value: bytes) -> None:
+        _writeBytes(buf, at, value)
+
+    @staticmethod
+    def read(data: ListOf(UInt8), at: int) -> bytes:
+        return _readBytes(data, at)
+
+    @staticmethod
+    def thaw(data: ListOf(UInt8), at: int) -> bytes:
+        return _readBytes(data, at)
+
+
+class _StrLayout(Class, Final):
+    inlineSize = 4
+    alignment = 4
+
+    @staticmethod
+    def write(buf: ListOf(UInt8), at: int, value: str) -> None:
+        _writeBytes(buf, at, value.encode("utf-8"))
+
+    @staticmethod
+    def read(data: ListOf(UInt8), at: int) -> str:
+        return _readBytes(data, at).decode("utf-8")
+
+    @staticmethod
+    def thaw(data: ListOf(UInt8), at: int) -> str:
+        return _readBytes(data, at).decode("utf-8")
+
+
+@TypeFunction
+def _SequenceLayout(T):
+    L = CompactLayout(T.ElementType)
+    View = CompactSequence(T)
+
+    # where the elements start, relative to the count
+    elementsStart = _alignUp(4, L.alignment)
+
+    class _SequenceLayout_(Class, Final):
+        inlineSize = 4
+        alignment = 4
+
+        @staticmethod
+        def write(buf: ListOf(UInt8), at: int, value: T) -> None:
+            if not len(value):
+                return
+
+            recordAt = _allocate(buf, elementsStart + len(value) * L.inlineSize, max(4, L.alignment))
+            _writeUInt32(buf, recordAt, len(value))
+
+            for i in range(len(value)):
+                L.write(buf, recordAt + elementsStart + i * L.inlineSize, value[i])
+
+            _writeUInt32(buf, at, recordAt)
+
+        @staticmethod
+        def read(data: ListOf(UInt8), at: int) -> View:
+            offset = _readUInt32(data, at)
+
+            if offset == 0:
+                return View(data=data, start=0, count=0)
+
+            count = _recordCount(data, offset, elementsStart, L.inlineSize)
+
+            return View(data=data, start=offset + elementsStart, count=count)
+
+        @staticmethod
+        def thaw(data: ListOf(UInt8), at: int) -> T:
+            return _SequenceLayout_.read(data, at).thaw()
+
+    return _SequenceLayout_
+
+
+@TypeFunction
+def CompactLayout(T):
+    """The Class whose staticmethods write and read a T in a compact slab.
+
+    Each has the class attributes 'inlineSize' and 'alignment', which describe T's
+    inline form, and the staticmethods
+
+        write(buf, at, value) - write the inline form of 'value' at buf[at], appending
+            any records it needs to 'buf'.
+        read(data, at) - the value, or view, whose inline form is at data[at].
+        thaw(data, at) - the T whose inline form is at data[at].
+    """
+    if T is str:
+        return _StrLayout
+
+    if T is bytes:
+        return _BytesLayout
+
+    if getattr(T, "__typed_python_category__", None) in ("TupleOf", "ListOf"):
+        return _SequenceLayout(T)
+
+    if _isRelocatablePod(T):
+        return _PodLayout(T)
+
+    raise TypeError(f"A CompactSlab can't hold a {T.__name__}")
+
+
+def _viewType(T):
+    """The type 'CompactLayout(T).read' returns."""
+    if getattr(T, "__typed_python_category__", None) in ("TupleOf", "ListOf"):
+        return CompactSequence(T)
+
+    return T
+
+
+@TypeFunction
+def CompactSequence(T):
+    """A read-only view of a TupleOf or ListOf 'T' frozen in a compact slab."""
+    L = CompactLayout(T.ElementType)
+    ElementView = _viewType(T.ElementType)
+
+    class CompactSequence_(NamedTuple(data=ListOf(UInt8), start=int, count=int)):
+        def __len__(self):
+            return self.count
+
+        def __getitem__(self, i: int):
+            if i < 0:
+                i += self.count
+
+            if i < 0 or i >= self.count:
+                raise IndexError("CompactSequence index out of range")
+
+            return L.read(self.data, self.start + i * L.inlineSize)
+
+        def __typed_python_int_iter_size__(self):
+            return self.count
+
+        def __typed_python_int_iter_value__(self, i):
+            return L.read(self.data, self.start + i * L.inlineSize)
+
+        def __iter__(self):
+            items = ListOf(ElementView)()
+
+            for i in range(self.count):
+                items.append(L.read(self.data, self.start + i * L.inlineSize))
+
+            return iter(items)
+
+        def thaw(self) -> T:
+            """Copy the viewed sequence out, as a T."""
+            res = ListOf(T.ElementType)()
+            res.reserve(self.count)
+
+            for i in range(self.count):
+                res.append(L.thaw(self.data, self.start + i * L.inlineSize))
+
+            return T(res)
+
+        def __repr__(self):
+            return f"CompactSequence({self.thaw()!r})"
+
+    return CompactSequence_
+
+
+@TypeFunction
+def CompactSlab(T):
+    """A T frozen into the compact format described in this module's docstring."""
+    L = CompactLayout(T)
+
+    class CompactSlab_(NamedTuple(data=ListOf(UInt8))):
+        @staticmethod
+        def freeze(value: T):
+            buf = ListOf(UInt8)()
+
+            _allocate(buf, _HEADER_BYTES + L.inlineSize, 8)
+            _writeUInt32(buf, 0, _MAGIC)
+            _writeUInt32(buf, 4, _VERSION)
+
+            L.write(buf, _HEADER_BYTES, value)
+
+            return CompactSlab_(data=buf)
+
+        @staticmethod
+        def fromBytes(data):
+            """Wrap the bytes, or ListOf(UInt8), that 'toBytes' produced, after checking its header."""
+            return CompactSlab_._fromBuffer(ListOf(UInt8)(data))
+
+        @staticmethod
+        def _fromBuffer(data: ListOf(UInt8)):
+            if len(data) < _HEADER_BYTES + L.inlineSize or _readUInt32(data, 0) != _MAGIC:
+                raise ValueError("Not a CompactSlab")
+
+            if _readUInt32(data, 4) != _VERSION:
+                raise ValueError(f"Can't read version {_readUInt32(data, 4)} of the CompactSlab format")
+
+            return CompactSlab_(data=data)
+
+        def root(self):
+            """The frozen value, as a view if it's a sequence."""
+            return L.read(self.data, _HEADER_BYTES)
+
+        def thaw(self) -> T:
+            """Copy the frozen value back out as a T."""
+            return L.thaw(self.data, _HEADER_BYTES)
+
+        def toBytes(self) -> bytes:
+            return self.data.toBytes()
+
+        def bytecount(self) -> int:
+            return len(self.data)
+
+    return CompactSlab_
@@ -0,0 +1,124 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import (
+    Entrypoint, TupleOf, ListOf, NamedTuple, Dict, Float32, Int16, OneOf, UInt8, deepBytecount
+)
+from typed_python.lib.compact_slab import CompactSlab, CompactSequence
+
+
+Point = NamedTuple(x=Float32, y=Float32, tag=Int16)
+
+
+def test_round_trips():
+    values = [
+        (int, 12),
+        (str, "hello, wörld"),
+        (bytes, b"\x00\x01\x02"),
+        (TupleOf(int), TupleOf(int)([1, 2, 3])),
+        (ListOf(str), ListOf(str)(["a", "", "ccc"])),
+        (TupleOf(TupleOf(int)), TupleOf(TupleOf(int))([[], [1], [2, 3]])),
+        (TupleOf(Point), TupleOf(Point)([Point(x=1, y=2, tag=3), Point(x=-1, y=0.5, tag=-7)])),
+        (TupleOf(OneOf(None, float)), TupleOf(OneOf(None, float))([None, 1.5])),
+        (TupleOf(bytes), TupleOf(bytes)([b"", b"xyz"])),
+    ]
+
+    for T, value in values:
+        slab = CompactSlab(T).freeze(value)
+
+        assert slab.thaw() == value
+        assert type(slab.thaw()) is T
+
+
+def test_views_read_without_thawing():
+    T = TupleOf(TupleOf(int))
+    slab = CompactSlab(T).freeze(T([[1, 2], [], [3, 4, 5]]))
+
+    root = slab.root()
+
+    assert isinstance(root, CompactSequence(T))
+    assert len(root) == 3
+    assert root[2][1] == 4
+    assert root[-1][-1] == 5
+    assert len(root[1]) == 0
+    assert [list(row) for row in root] == [[1, 2], [], [3, 4, 5]]
+
+    with pytest.raises(IndexError):
+        root[3]
+
+    with pytest.raises(IndexError):
+        root[0][2]
+
+    assert root[0].thaw() == TupleOf(int)([1, 2])
+
+
+def test_compiled_accessors():
+    T = TupleOf(TupleOf(int))
+
+    @Entrypoint
+    def total(slab: CompactSlab(T)) -> int:
+        res = 0
+        for row in slab.root():
+            for x in row:
+                res += x
+        return res
+
+    @Entrypoint
+    def longestName(slab: CompactSlab(ListOf(str))) -> str:
+        res = ""
+        for i in range(len(slab.root())):
+            if len(slab.root()[i]) > len(res):
+                res = slab.root()[i]
+        return res
+
+    value = T([list(range(i)) for i in range(100)])
+
+    assert total(CompactSlab(T).freeze(value)) == sum(sum(row) for row in value)
+    assert longestName(CompactSlab(ListOf(str)).freeze(ListOf(str)(["ab", "abcd", "abc"]))) == "abcd"
+
+
+def test_compact_slabs_are_relocatable():
+    T = TupleOf(TupleOf(str))
+    value = T([["a", "bb"], ["ccc"]])
+
+    serialized = CompactSlab(T).freeze(value).toBytes()
+
+    assert CompactSlab(T).fromBytes(serialized).thaw() == value
+    assert CompactSlab(T).fromBytes(ListOf(UInt8)(serialized)).root()[1][0] == "ccc"
+
+    with pytest.raises(ValueError):
+        CompactSlab(T).fromBytes(b"not a slab at all")
+
+    corrupt = ListOf(UInt8)(serialized)
+    corrupt[8] = 255
+
+    with pytest.raises(IndexError):
+        CompactSlab(T).fromBytes(corrupt).root()
+
+
+def test_compact_slabs_are_smaller():
+    T = TupleOf(TupleOf(int))
+    value = T([[i, i + 1] for i in range(1000)])
+
+    assert CompactSlab(T).freeze(value).bytecount() * 2 < deepBytecount(value)
+
+
+def test_unsupported_types():
+    with pytest.raises(TypeError):
+        CompactSlab(Dict(int, int))
+
+    with pytest.raises(TypeError):
+        CompactSlab(TupleOf(object))
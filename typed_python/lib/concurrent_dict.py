@@ -0,0 +1,193 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A dict that many threads can use at once.
+
+'Dict' isn't synchronized, so sharing one between threads means putting one
+lock around every access. 'ConcurrentDict(K, V)' splits the keys across a
+power-of-two number of 'Dict' shards picked by the key's hash, each behind
+its own 'Mutex', so threads only contend when they touch the same shard:
+
+    cache = ConcurrentDict(str, float)(shardCount=64)
+
+    cache["a"] = 1.0
+    cache.getOrInsert("b", 2.0)                 # insert unless already present
+    cache.update("a", lambda x: x + 1.0, 0.0)   # read-modify-write under the lock
+
+Every method is an Entrypoint, so it's usable (and fast) from compiled code.
+'items', 'keys' and 'values' lock one shard at a time, so they don't see a
+single moment in time if other threads are writing.
+"""
+
+from typed_python import Class, Final, Member, TypeFunction, ListOf, Dict, OneOf, Tuple, Entrypoint
+from typed_python.sync import Mutex
+
+
+@TypeFunction
+def ConcurrentDict(K, V):
+    class ConcurrentDict_(Class, Final, __name__=f"ConcurrentDict({K.__name__}, {V.__name__})"):
+        KeyType = K
+        ValueType = V
+
+        _shards = Member(ListOf(Dict(K, V)), nonempty=True)
+        _locks = Member(ListOf(Mutex), nonempty=True)
+        _mask = Member(int, nonempty=True)
+
+        def __init__(self, shardCount=64):
+            """Create an empty dict with at least 'shardCount' shards (rounded up to a power of two)."""
+            count = 1
+            while count < shardCount:
+                count *= 2
+
+            # we pick shards with bits 20 and up of the hash, since Dict uses the low ones
+            assert count <= 2048, "Can't have more than 2048 shards"
+
+            self._mask = count - 1
+
+            for _ in range(count):
+                self._shards.append(Dict(K, V)())
+                self._locks.append(Mutex())
+
+        @Entrypoint
+        def _shardFor(self, k: K) -> int:
+            return (hash(k) >> 20) & self._mask
+
+        @Entrypoint
+        def __len__(self) -> int:
+            res = 0
+
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    res += len(self._shards[i])
+
+            return res
+
+        @Entrypoint
+        def __contains__(self, k: K) -> bool:
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return k in self._shards[s]
+
+        @Entrypoint
+        def __getitem__(self, k: K) -> V:
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return self._shards[s][k]
+
+        @Entrypoint
+        def get(self, k: K) -> OneOf(None, V):
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return self._shards[s].get(k)
+
+        @Entrypoint
+        def get(self, k: K, default: V) -> V:  # noqa: F811
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return self._shards[s].get(k, default)
+
+        @Entrypoint
+        def __setitem__(self, k: K, v: V) -> None:
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                self._shards[s][k] = v
+
+        @Entrypoint
+        def __delitem__(self, k: K) -> None:
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                del self._shards[s][k]
+
+        @Entrypoint
+        def pop(self, k: K) -> V:
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return self._shards[s].pop(k)
+
+        @Entrypoint
+        def getOrInsert(self, k: K, v: V) -> V:
+            """Return the value for 'k', first setting it to 'v' if 'k' isn't present."""
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return self._shards[s].setdefault(k, v)
+
+        @Entrypoint
+        def update(self, k: K, f, default: V) -> V:
+            """Set self[k] to f(self[k]) (or f(default) if 'k' isn't present) and return it.
+
+            'f' runs while we hold the shard's lock, so it shouldn't touch this dict.
+            """
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                shard = self._shards[s]
+                res = V(f(shard.get(k, default)))
+                shard[k] = res
+                return res
+
+        @Entrypoint
+        def clear(self) -> None:
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    self._shards[i].clear()
+
+        @Entrypoint
+        def items(self) -> ListOf(Tuple(K, V)):
+            res = ListOf(Tuple(K, V))()
+
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    for k, v in self._shards[i].items():
+                        res.append((k, v))
+
+            return res
+
+        @Entrypoint
+        def keys(self) -> ListOf(K):
+            res = ListOf(K)()
+
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    for k in self._shards[i]:
+                        res.append(k)
+
+            return res
+
+        @Entrypoint
+        def values(self) -> ListOf(V):
+            res = ListOf(V)()
+
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    for v in self._shards[i].values():
+                        res.append(v)
+
+            return res
+
+        def __iter__(self):
+            return iter(self.keys())
+
+        def __repr__(self) -> str:
+            return "ConcurrentDict({" + ", ".join(f"{k!r}: {v!r}" for k, v in self.items()) + "})"
+
+    return ConcurrentDict_
@@ -0,0 +1,81 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import threading
+
+import pytest
+
+from typed_python import Entrypoint
+from typed_python.lib.concurrent_dict import ConcurrentDict
+
+
+def test_concurrent_dict_basics():
+    d = ConcurrentDict(str, int)(shardCount=5)
+
+    assert len(d._shards) == 8
+
+    d["a"] = 1
+    d["b"] = 2
+
+    assert len(d) == 2
+    assert d["a"] == 1
+    assert "b" in d and "c" not in d
+    assert d.get("c") is None
+    assert d.get("c", 3) == 3
+
+    with pytest.raises(KeyError):
+        d["c"]
+
+    assert d.getOrInsert("a", 10) == 1
+    assert d.getOrInsert("c", 10) == 10
+    assert d.update("a", lambda x: x + 5, 0) == 6
+    assert d.update("z", lambda x: x + 5, 0) == 5
+
+    assert sorted(d.items()) == [("a", 6), ("b", 2), ("c", 10), ("z", 5)]
+    assert sorted(d) == ["a", "b", "c", "z"]
+
+    assert d.pop("b") == 2
+    del d["c"]
+
+    assert sorted(d.keys()) == ["a", "z"]
+    assert sorted(d.values()) == [5, 6]
+
+    d.clear()
+
+    assert len(d) == 0
+
+
+def test_concurrent_dict_from_many_threads():
+    T = ConcurrentDict(int, int)
+    d = T()
+
+    @Entrypoint
+    def work(d: T, threadIx: int, n: int) -> None:
+        for i in range(n):
+            # every thread counts into the same keys, and owns some of its own
+            d.update(i % 100, lambda x: x + 1, 0)
+            d[1000000 * (threadIx + 1) + i] = i
+            d.getOrInsert(-1, threadIx)
+
+    threads = [threading.Thread(target=work, args=(d, i, 20000)) for i in range(4)]
+
+    for t in threads:
+        t.start()
+
+    for t in threads:
+        t.join()
+
+    assert all(d[i] == 800 for i in range(100))
+    assert len(d) == 100 + 4 * 20000 + 1
+    assert d[-1] in range(4)
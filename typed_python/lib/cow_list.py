@@ -0,0 +1,152 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A list that can be snapshotted without copying its elements.
+
+Snapshotting a 'ListOf(T)' means 'ListOf(T)(other)', which copies every
+element and increfs each one that's refcounted. 'CowList(T)' keeps its
+elements in chunks of CHUNK_SIZE and snapshots by sharing them:
+
+    events = CowList(Event)()
+    events.append(e)
+    ...
+    snap = events.snapshot()    # copies one pointer per chunk
+
+After a snapshot, neither side owns its chunks. The first write to a chunk
+(setting, appending or popping an element in it) copies that one chunk, so
+a snapshot that's mostly read costs a pointer per chunk, and each chunk
+written afterwards costs one chunk copy the first time.
+"""
+
+from typed_python import TypeFunction, Class, Member, Final, Entrypoint, ListOf, Forward
+
+
+CHUNK_SIZE = 1024
+
+
+@TypeFunction
+def CowList(T):
+    CowList_ = Forward("CowList_")
+
+    @CowList_.define
+    class CowList_(Class, Final, __name__=f"CowList({T.__name__})"):
+        ElementType = T
+
+        # every chunk but the last holds exactly CHUNK_SIZE elements
+        _chunks = Member(ListOf(ListOf(T)), nonempty=True)
+
+        # whether _chunks[i] is ours alone, or may be shared with a snapshot
+        _owned = Member(ListOf(bool), nonempty=True)
+
+        _len = Member(int, nonempty=True)
+
+        def __init__(self):
+            pass
+
+        def __init__(self, elements):  # noqa: F811
+            for e in elements:
+                self.append(e)
+
+        def __len__(self) -> int:
+            return self._len
+
+        @Entrypoint
+        def _checkIndex(self, i: int) -> int:
+            if i < 0:
+                i += self._len
+
+            if i < 0 or i >= self._len:
+                raise IndexError("CowList index out of range")
+
+            return i
+
+        @Entrypoint
+        def _ownChunk(self, c: int) -> ListOf(T):
+            """Return chunk 'c', copying it first if it might be shared."""
+            if not self._owned[c]:
+                self._chunks[c] = ListOf(T)(self._chunks[c])
+                self._owned[c] = True
+
+            return self._chunks[c]
+
+        @Entrypoint
+        def __getitem__(self, i: int) -> T:
+            i = self._checkIndex(i)
+
+            return self._chunks[i // CHUNK_SIZE][i % CHUNK_SIZE]
+
+        @Entrypoint
+        def __setitem__(self, i: int, v: T) -> None:
+            i = self._checkIndex(i)
+
+            self._ownChunk(i // CHUNK_SIZE)[i % CHUNK_SIZE] = v
+
+        @Entrypoint
+        def append(self, v: T) -> None:
+            if self._len % CHUNK_SIZE == 0:
+                self._chunks.append(ListOf(T)())
+                self._owned.append(True)
+
+            self._ownChunk(len(self._chunks) - 1).append(v)
+            self._len += 1
+
+        @Entrypoint
+        def pop(self) -> T:
+            if not self._len:
+                raise IndexError("pop from empty CowList")
+
+            c = len(self._chunks) - 1
+            res = self._ownChunk(c).pop()
+            self._len -= 1
+
+            if not len(self._chunks[c]):
+                self._chunks.pop()
+                self._owned.pop()
+
+            return res
+
+        @Entrypoint
+        def snapshot(self) -> CowList_:
+            """Return a copy of this list that shares our chunks until one side writes."""
+            res = CowList_()
+            res._chunks = ListOf(ListOf(T))(self._chunks)
+            res._len = self._len
+
+            for c in range(len(self._chunks)):
+                self._owned[c] = False
+                res._owned.append(False)
+
+            return res
+
+        @Entrypoint
+        def toList(self) -> ListOf(T):
+            res = ListOf(T)()
+            res.reserve(self._len)
+
+            for chunk in self._chunks:
+                for e in chunk:
+                    res.append(e)
+
+            return res
+
+        def __iter__(self):
+            for chunk in self._chunks:
+                for e in chunk:
+                    yield e
+
+        def __repr__(self) -> str:
+            return f"CowList({list(self)!r})"
+
+    return CowList_
@@ -0,0 +1,115 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import numpy
+import pytest
+
+from typed_python import Entrypoint, ListOf
+from typed_python.lib.cow_list import CowList, CHUNK_SIZE
+
+
+def sharesChunk(l1, l2, c):
+    return l1._chunks[c].pointerUnsafe(0) == l2._chunks[c].pointerUnsafe(0)
+
+
+def test_cow_list_basics():
+    T = CowList(str)
+
+    l = T(["a", "b", "c"])
+
+    assert len(l) == 3
+    assert l[0] == "a" and l[-1] == "c"
+    assert list(l) == ["a", "b", "c"]
+
+    l[1] = "x"
+    assert l.toList() == ["a", "x", "c"]
+
+    assert l.pop() == "c"
+    assert len(l) == 2
+
+    with pytest.raises(IndexError):
+        l[2]
+
+    with pytest.raises(IndexError):
+        T().pop()
+
+
+def test_cow_list_snapshots_share_chunks_until_written():
+    l = CowList(int)(range(CHUNK_SIZE * 3 + 5))
+
+    s = l.snapshot()
+
+    assert all(sharesChunk(l, s, c) for c in range(4))
+
+    l[CHUNK_SIZE + 1] = -1
+
+    assert s[CHUNK_SIZE + 1] == CHUNK_SIZE + 1
+    assert l[CHUNK_SIZE + 1] == -1
+
+    # only the chunk we wrote to got copied
+    assert sharesChunk(l, s, 0) and not sharesChunk(l, s, 1) and sharesChunk(l, s, 2)
+
+    s.append(100)
+    l.pop()
+
+    assert len(s) == CHUNK_SIZE * 3 + 6
+    assert len(l) == CHUNK_SIZE * 3 + 4
+    assert s[-1] == 100
+    assert s[-2] == l[-1] + 1
+
+
+def test_cow_list_matches_list():
+    numpy.random.seed(42)
+
+    l = CowList(int)()
+    reference = []
+    snapshots = []
+
+    for step in range(20000):
+        op = numpy.random.randint(10)
+
+        if op < 5 or not reference:
+            l.append(step)
+            reference.append(step)
+        elif op < 8:
+            i = numpy.random.randint(len(reference))
+            l[i] = -step
+            reference[i] = -step
+        elif op < 9:
+            assert l.pop() == reference.pop()
+        elif step % 100 == 0:
+            snapshots.append((l.snapshot(), list(reference)))
+
+    assert list(l) == reference
+
+    for s, r in snapshots:
+        assert s.toList() == r
+
+
+def test_cow_list_compiled():
+    @Entrypoint
+    def sumSnapshots(l: CowList(int), n: int) -> int:
+        res = 0
+
+        for i in range(n):
+            s = l.snapshot()
+            l[i % len(l)] = i
+            res += s[i % len(s)]
+
+        return res
+
+    l = CowList(int)(ListOf(int)(range(10000)))
+
+    assert sumSnapshots(l, 1000) == sum(range(1000))
+    assert l.toList()[:1000] == list(range(1000))
@@ -0,0 +1,66 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""Read a csv file into one typed column per field.
+
+    Trade = NamedTuple(symbol=str, price=float, size=int, note=OneOf(None, str))
+
+    columns = readCsv("trades.csv", Trade)
+    columns["price"]    # ListOf(float)
+
+The file is mmapped and parsed in native code on several threads at once,
+straight into the columns, without building a python object per cell. See
+CsvReader.hpp for the dialect we accept and how cells convert.
+"""
+
+import mmap
+import os
+
+from typed_python._types import readCsvColumns
+
+
+def readCsv(path, RowType, delimiter=",", header=True, internStrings=True, threadCount=None):
+    """Parse the csv file at 'path' into a dict from each field of 'RowType' to a ListOf.
+
+    Args:
+        path - the file to read (a str or PathLike), or a bytes-like object
+            holding the csv itself.
+        RowType - a NamedTuple whose fields are bool, ints, floats, str, or
+            OneOf(None, T) of those, where an empty cell is None.
+        delimiter - the single character separating fields.
+        header - if True, the first record names the columns, which we match to
+            the fields of RowType by name, ignoring extra columns. Otherwise the
+            columns are RowType's fields, in order.
+        internStrings - if True, equal strings in a str column share one copy,
+            which saves memory on low-cardinality columns.
+        threadCount - how many threads to parse on. Defaults to the number of cpus.
+
+    Raises:
+        ValueError if the csv is malformed or a cell doesn't fit its field.
+    """
+    if threadCount is None:
+        threadCount = os.cpu_count() or 1
+
+    kwargs = dict(delimiter=delimiter, header=header, internStrings=internStrings, threadCount=threadCount)
+
+    if not isinstance(path, (str, os.PathLike)):
+        return readCsvColumns(path, RowType, **kwargs)
+
+    with open(path, "rb") as f:
+        # you can't mmap an empty file
+        if os.fstat(f.fileno()).st_size == 0:
+            return readCsvColumns(b"", RowType, **kwargs)
+
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapping:
+            return readCsvColumns(mapping, RowType, **kwargs)
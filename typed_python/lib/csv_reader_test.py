@@ -0,0 +1,131 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import csv
+import io
+import os
+import tempfile
+
+import pytest
+
+from typed_python import NamedTuple, ListOf, OneOf, Int8, UInt16, Float32
+from typed_python.lib.csv_reader import readCsv
+
+
+Trade = NamedTuple(symbol=str, price=float, size=int, note=OneOf(None, str))
+
+
+def test_read_csv_columns():
+    columns = readCsv(
+        b"symbol,price,size,note\n"
+        b"AAPL,1.5,100,\n"
+        b'"MS,FT",-2e3,-7,"said ""hi""\nthen left"\r\n'
+        b"\n"
+        b"IBM,3,0,x",
+        Trade
+    )
+
+    assert list(columns) == ["symbol", "price", "size", "note"]
+    assert type(columns["price"]) is ListOf(float)
+    assert columns["symbol"] == ["AAPL", "MS,FT", "IBM"]
+    assert columns["price"] == [1.5, -2000.0, 3.0]
+    assert columns["size"] == [100, -7, 0]
+    assert columns["note"] == [None, 'said "hi"\nthen left', "x"]
+
+
+def test_read_csv_header_matches_by_name():
+    T = NamedTuple(b=int, a=str)
+
+    columns = readCsv(b"a,ignored,b\nx,1,2\ny,3,4\n", T)
+
+    assert columns == {"b": [2, 4], "a": ["x", "y"]}
+
+    assert readCsv(b"x\t1\ny\t2\n", T, header=False, delimiter="\t") == {"a": ["x", "y"], "b": [1, 2]}
+
+
+def test_read_csv_cell_types():
+    T = NamedTuple(a=Int8, b=UInt16, c=Float32, d=bool, e=OneOf(None, int))
+
+    columns = readCsv(b"a,b,c,d,e\n-128,65535,0.5,True,\n127,0,inf,0,5\n", T)
+
+    assert columns["a"] == [-128, 127]
+    assert columns["b"] == [65535, 0]
+    assert columns["c"] == [0.5, float("inf")]
+    assert columns["d"] == [True, False]
+    assert columns["e"] == [None, 5]
+
+
+@pytest.mark.parametrize("data", [
+    b"a,b,c,d,e\n128,0,0,true,\n",
+    b"a,b,c,d,e\n0,-1,0,true,\n",
+    b"a,b,c,d,e\n0,0,x,true,\n",
+    b"a,b,c,d,e\n0,0,0,yes,\n",
+    b"a,b,c,d,e\n0,0,0,true,1.5\n",
+    b"a,b,c,d,e\n0,0,0,true\n",
+    b"a,b,c,d,e\n0,0,0,true,,\n",
+    b'a,b,c,d,e\n0,0,0,true,"1\n',
+    b'a,b,c,d,e\n0,0,0,"true"x,1\n',
+    b"a,b,c,d\n0,0,0,true\n",
+])
+def test_read_csv_errors(data):
+    T = NamedTuple(a=Int8, b=UInt16, c=Float32, d=bool, e=OneOf(None, int))
+
+    with pytest.raises(ValueError):
+        readCsv(data, T)
+
+
+def test_read_csv_unsupported_field_type():
+    with pytest.raises(ValueError):
+        readCsv(b"a\n1\n", NamedTuple(a=ListOf(int)))
+
+    with pytest.raises(TypeError):
+        readCsv(b"a\n1\n", ListOf(int))
+
+
+def test_read_csv_file_in_parallel_matches_csv_module():
+    rows = [
+        ("S%s" % (i % 13), i * 0.25, i, "" if i % 5 else 'line\nbreak, "quoted" %s' % i)
+        for i in range(200000)
+    ]
+
+    out = io.StringIO()
+    writer = csv.writer(out)
+    writer.writerow(["symbol", "price", "size", "note"])
+    writer.writerows(rows)
+
+    with tempfile.TemporaryDirectory() as tempDir:
+        path = os.path.join(tempDir, "trades.csv")
+
+        with open(path, "w", newline="") as f:
+            f.write(out.getvalue())
+
+        assert os.path.getsize(path) > 4 * 1024 * 1024
+
+        for threadCount in [1, 4]:
+            columns = readCsv(path, Trade, threadCount=threadCount)
+
+            assert columns["symbol"] == [r[0] for r in rows]
+            assert columns["price"] == [r[1] for r in rows]
+            assert columns["size"] == [r[2] for r in rows]
+            assert columns["note"] == [r[3] or None for r in rows]
+
+
+def test_read_empty_csv():
+    with tempfile.TemporaryDirectory() as tempDir:
+        path = os.path.join(tempDir, "empty.csv")
+        open(path, "w").close()
+
+        assert readCsv(path, Trade, header=False) == {k: [] for k in Trade.ElementNames}
+
+    assert readCsv(b"symbol,price,size,note\n", Trade)["price"] == []
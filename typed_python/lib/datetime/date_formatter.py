@@ -12,8 +12,13 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from typed_python import Class, Dict, Entrypoint, Final, ListOf
-from typed_python.lib.datetime.date_time import Timezone, UTC
+from typed_python import Class, Dict, Entrypoint, Final, ListOf, NamedTuple, PointerTo, UInt8
+from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
+from typed_python.compiler.type_wrappers import runtime_functions
+from typed_python.lib.datetime.chrono import Chrono
+from typed_python.lib.datetime.date_time import Timezone, FixedOffsetTimezone, UTC
+import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler
 
 # int to string month mapping where 1 => January
 INT_TO_MONTH_NAMES = Dict(int, str)(
@@ -79,6 +84,115 @@ def convert_to_12h(hour: int):
     )
 
 
+
+typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
+
+
+class StrFromUtf8(CompilableBuiltin):
+    """'strFromUtf8(p, pointcount)' makes a str, in one allocation, from the utf-8 at 'p'.
+
+    'p' is a PointerTo(UInt8), and 'pointcount' is the number of codepoints (not bytes)
+    it encodes.
+    """
+    def __eq__(self, other):
+        return isinstance(other, StrFromUtf8)
+
+    def __hash__(self):
+        return hash("StrFromUtf8")
+
+    def convert_call(self, context, instance, args, kwargs):
+        if len(args) != 2 or kwargs or args[0].expr_type.typeRepresentation is not PointerTo(UInt8):
+            return super().convert_call(context, instance, args, kwargs)
+
+        pointcount = args[1].toInt64()
+        if pointcount is None:
+            return None
+
+        return context.push(
+            str,
+            lambda strRef: strRef.expr.store(
+                runtime_functions.string_from_utf8_and_len.call(
+                    args[0].nonref_expr.cast(native_ast.UInt8Ptr),
+                    pointcount.nonref_expr
+                ).cast(typeWrapper(str).getNativeLayoutType())
+            )
+        )
+
+
+strFromUtf8 = StrFromUtf8()
+
+# a directive writes at most this many bytes: an Int64 with its sign, or a name
+_MAX_DIRECTIVE_BYTES = 20
+
+_DIRECTIVES = "YmdHMSaAwbByIpZzjCu"
+
+# a run of literal text, if 'directive' is 0, or else the ord of a directive character
+_TemplateSegment = NamedTuple(directive=int, literal=bytes, pointcount=int)
+
+
+@Entrypoint
+def _compileTemplate(format: str) -> ListOf(_TemplateSegment):
+    """Split a format into literal runs and directives, the way DateFormatter.format reads it."""
+    res = ListOf(_TemplateSegment)()
+    literal = ListOf(str)()
+
+    def flushLiteral():
+        if len(literal):
+            text = "".join(literal)
+            res.append(_TemplateSegment(directive=0, literal=text.encode("utf-8"), pointcount=len(text)))
+            literal.clear()
+
+    pos = 0
+    while pos < len(format):
+        if format[pos] == "%" and pos + 1 < len(format):
+            directive = format[pos + 1]
+
+            if directive == "%":
+                literal.append("%")
+            elif directive in _DIRECTIVES:
+                flushLiteral()
+                res.append(_TemplateSegment(directive=ord(directive), literal=b"", pointcount=0))
+            else:
+                raise ValueError("Unsupported formatting directive: " + directive)
+
+            pos += 2
+        else:
+            literal.append(format[pos])
+            pos += 1
+
+    flushLiteral()
+
+    return res
+
+
+def _writeDigits(p: PointerTo(UInt8), value: int, width: int) -> int:
+    """Write 'value' in decimal at 'p', zero-padded to 'width' digits. Returns the bytes written."""
+    if value < 0:
+        p.set(UInt8(45))
+        return 1 + _writeDigits(p + 1, -value, width - 1)
+
+    count = 1
+    rest = value // 10
+    while rest:
+        count += 1
+        rest //= 10
+
+    count = max(count, width)
+
+    for i in range(count):
+        (p + (count - 1 - i)).set(UInt8(48 + value % 10))
+        value //= 10
+
+    return count
+
+
+def _writeAscii(p: PointerTo(UInt8), text: str) -> int:
+    for i in range(len(text)):
+        (p + i).set(UInt8(text._codepointUnsafe(i)))
+
+    return len(text)
+
+
 class DateFormatter(Class, Final):
     @Entrypoint
     @staticmethod
@@ -251,3 +365,127 @@ class DateFormatter(Class, Final):
                 result.append(format[pos])
             pos += 1
         return "".join(result)
+
+    @Entrypoint
+    @staticmethod
+    def formatMany(
+        timestamps: ListOf(float), timezone: Timezone = UTC, format: str = "%Y-%m-%d %H:%M:%S"
+    ) -> ListOf(str):
+        """
+        Formats each of a list of timestamps, as 'format' would
+        Parameters:
+            timestamps (ListOf(float)): UTC timestamps
+            timezone (Timezone): the locale whose clocks we show
+            format (str): A string specifying formatting directives. E.g. '%Y-%m-%d %H:%M:%S'
+        Returns:
+            (ListOf(str)): the formatted timestamps, in order
+
+        We parse 'format' once, write each row's digits straight into a scratch buffer
+        and make its str in one allocation from that. The calendar date is only
+        recomputed when a row falls on a different local day than the row before, so
+        sorted timestamps mostly skip it. For timezones other than fixed offsets we
+        still ask the timezone for each row's offset, which a TransitionTable answers
+        quickly.
+        """
+        template = _compileTemplate(format)
+
+        maxBytes = 0
+        for segment in template:
+            maxBytes += len(segment.literal) if segment.directive == 0 else _MAX_DIRECTIVE_BYTES
+
+        scratch = ListOf(UInt8)()
+        scratch.resize(max(1, maxBytes))
+        p = scratch.pointerUnsafe(0)
+
+        isFixedOffset = isinstance(timezone, FixedOffsetTimezone)
+        fixedOffsetHours = timezone.utcOffsetHours(0.0) if isFixedOffset else 0.0
+
+        cachedDay = 0
+        haveCachedDay = False
+        y = 0
+        m = 0
+        d = 0
+        weekday = 0
+        doy = 0
+
+        res = ListOf(str)()
+        res.reserve(len(timestamps))
+
+        for ts in timestamps:
+            offsetHours = fixedOffsetHours if isFixedOffset else timezone.utcOffsetHours(ts)
+            local = ts + offsetHours * 3600
+
+            day = int(local // 86400)
+            secondsSinceMidnight = local % 86400
+
+            if not haveCachedDay or day != cachedDay:
+                date = Chrono.civil_from_days(day)
+                y = date.year
+                m = date.month
+                d = date.day
+                weekday = Chrono.weekday_from_days(day)
+                doy = Chrono.day_of_year(y, m, d)
+                cachedDay = day
+                haveCachedDay = True
+
+            h = int(secondsSinceMidnight // 3600)
+            minute = int(secondsSinceMidnight % 3600 // 60)
+            second = int(secondsSinceMidnight % 60)
+
+            byteCount = 0
+            pointcount = 0
+
+            for segment in template:
+                directive = segment.directive
+                out = p + byteCount
+
+                if directive == 0:
+                    literal = segment.literal
+                    for i in range(len(literal)):
+                        (out + i).set(UInt8(literal[i]))
+                    written = len(literal)
+                elif directive == 89:  # Y
+                    written = _writeDigits(out, y, 4)
+                elif directive == 109:  # m
+                    written = _writeDigits(out, m, 2)
+                elif directive == 100:  # d
+                    written = _writeDigits(out, d, 2)
+                elif directive == 72:  # H
+                    written = _writeDigits(out, h, 2)
+                elif directive == 77:  # M
+                    written = _writeDigits(out, minute, 2)
+                elif directive == 83:  # S
+                    written = _writeDigits(out, second, 2)
+                elif directive == 97:  # a
+                    written = _writeAscii(out, INT_TO_DAY_ABBR[weekday])
+                elif directive == 65:  # A
+                    written = _writeAscii(out, INT_TO_DAY_NAMES[weekday])
+                elif directive == 119:  # w
+                    written = _writeDigits(out, weekday, 1)
+                elif directive == 98:  # b
+                    written = _writeAscii(out, INT_TO_MONTH_ABBR[m])
+                elif directive == 66:  # B
+                    written = _writeAscii(out, INT_TO_MONTH_NAMES[m])
+                elif directive == 121:  # y
+                    written = _writeDigits(out, y % 100, 2)
+                elif directive == 73:  # I
+                    written = _writeDigits(out, convert_to_12h(h), 2)
+                elif directive == 112:  # p
+                    written = _writeAscii(out, "AM" if h < 12 else "PM")
+                elif directive == 90:  # Z
+                    written = _writeAscii(out, "UTC")
+                elif directive == 122:  # z
+                    written = _writeAscii(out, "+0000")
+                elif directive == 106:  # j
+                    written = _writeDigits(out, doy, 3)
+                elif directive == 67:  # C
+                    written = _writeDigits(out, y // 100, 2)
+                else:  # u
+                    written = _writeDigits(out, 7 if weekday == 0 else weekday, 1)
+
+                byteCount += written
+                pointcount += segment.pointcount if directive == 0 else written
+
+            res.append(strFromUtf8(p, pointcount))
+
+        return res
@@ -15,6 +15,7 @@
 import unittest
 import time
 from datetime import datetime, timedelta
+from typed_python import ListOf
 from typed_python.lib.datetime.date_formatter import DateFormatter
 from typed_python.lib.datetime.date_time import UTC, FixedOffsetTimezone
 import pytz
@@ -362,3 +363,39 @@ class TestDateFormatter(unittest.TestCase):
             ) == minute.strftime("%Y-%m-%dT%H:%M:%S"), minute.strftime(
                 "%Y-%m-%dT%H:%M:%S"
             )
+
+    def test_format_many_matches_format(self):
+        timestamps = [
+            datetime.timestamp(dt)
+            for dt in get_datetimes_in_range(
+                start=datetime(2019, 12, 30, 22, 0, 0, 0, pytz.UTC),
+                end=datetime(2020, 1, 2, 3, 0, 0, 0, pytz.UTC),
+                step="minutes",
+            )
+        ]
+        timestamps += [0.0, -86400.0 * 400 + 17, 4102444799.0, 951782400.0]
+
+        for timezone in [UTC, FixedOffsetTimezone(offset_hours=-5), FixedOffsetTimezone(offset_hours=5.5)]:
+            for format in [
+                "%Y-%m-%d %H:%M:%S",
+                "%Y-%m-%dT%H:%M:%S",
+                "%a %A %w %u %b %B %y %C %j",
+                "%I:%M %p %Z %z %%",
+                "",
+                "no directives",
+                "été %d",
+                "trailing %",
+            ]:
+                formatted = DateFormatter.formatMany(ListOf(float)(timestamps), timezone, format)
+
+                assert len(formatted) == len(timestamps)
+
+                for ts, result in zip(timestamps, formatted):
+                    assert result == DateFormatter.format(ts, timezone, format), (ts, format)
+
+    def test_format_many_truncates_fractional_seconds(self):
+        assert DateFormatter.formatMany(ListOf(float)([0.75, 59.999])) == ["1970-01-01 00:00:00", "1970-01-01 00:00:59"]
+
+    def test_format_many_rejects_bad_directives(self):
+        with self.assertRaises(ValueError):
+            DateFormatter.formatMany(ListOf(float)([0.0]), UTC, "%Q")
@@ -12,7 +12,7 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from typed_python import Class, Dict, Final
+from typed_python import Class, Dict, Final, OneOf
 from typed_python import Entrypoint, ListOf
 from typed_python.lib.datetime.chrono import Chrono
 from typed_python.lib.datetime.date_time import (
@@ -62,6 +62,21 @@ DOT = "."
 AM = "am"
 PM = "pm"
 
+# codepoints checked by the fixed-layout ISO fast path
+_ZERO = ord("0")
+_DASH = ord("-")
+_COLON = ord(":")
+_DOT = ord(".")
+_PLUS = ord("+")
+_SPACE = ord(" ")
+_LOWER_T = ord("t")
+_UPPER_T = ord("T")
+_LOWER_Z = ord("z")
+_UPPER_Z = ord("Z")
+
+# the most fractional-second digits we can scale exactly in a double
+_MAX_FRACTION_DIGITS = 15
+
 MONTH_TO_INT = Dict(str, int)(
     {
         JAN: 1,
@@ -365,6 +380,25 @@ class DateParser(Class, Final):
         except ValueError:
             return DateParser.parse_non_iso(date_str)
 
+    @Entrypoint
+    @staticmethod
+    def parseMany(date_strs: ListOf(str), format: str = "") -> ListOf(float):
+        """
+        Parse a column of date strings into unix timestamps in one call.
+        Parameters:
+            date_strs (ListOf(str)): The strings to parse. Each is parsed exactly as 'parse' would.
+            format (str): An optional format string applied to every string.
+        Returns:
+            (ListOf(float)) A unix timestamp for each string, in order
+        """
+        res = ListOf(float)()
+        res.reserve(len(date_strs))
+
+        for date_str in date_strs:
+            res.append(DateParser.parse(date_str, format))
+
+        return res
+
     @Entrypoint
     @staticmethod
     def parse_with_format_and_timezone(
@@ -621,6 +655,151 @@ class DateParser(Class, Final):
 
         return timezone.timestamp(datetime)
 
+    @Entrypoint
+    @staticmethod
+    def _digits(date_str: str, start: int, count: int) -> int:
+        """
+        Reads the 'count' characters at 'start' as a decimal number. The caller
+        checks that they're in bounds.
+        Returns:
+            (int) The number, or -1 if any of the characters isn't an ascii digit
+        """
+        res = 0
+
+        for i in range(start, start + count):
+            digit = date_str._codepointUnsafe(i) - _ZERO
+
+            if digit < 0 or digit > 9:
+                return -1
+
+            res = res * 10 + digit
+
+        return res
+
+    @Entrypoint
+    @staticmethod
+    def _parse_fixed_iso(date_str: str) -> OneOf(None, float):
+        """
+        Parses the fixed-width ISO 8601 layouts that logs and tick data use, by
+        reading digits at known offsets rather than tokenizing. Those are
+            YYYY-MM-DD
+            YYYY-MM-DDTHH:MM
+            YYYY-MM-DDTHH:MM:SS
+            YYYY-MM-DDTHH:MM:SS.ffffff
+        where the 'T' may also be 't' or a space, and a time may be followed by 'Z'
+        or an offset like +HH, +HHMM or +HH:MM.
+        Returns:
+            (float) The same timestamp parse_iso_str would give, or None if the string
+            isn't one of these layouts or isn't a valid date, so the caller can fall
+            back to the general parser.
+        """
+        strlen = len(date_str)
+
+        if strlen < 10 or date_str._codepointUnsafe(4) != _DASH or date_str._codepointUnsafe(7) != _DASH:
+            return None
+
+        year = DateParser._digits(date_str, 0, 4)
+        month = DateParser._digits(date_str, 5, 2)
+        day = DateParser._digits(date_str, 8, 2)
+
+        if year < 0 or month < 0 or day < 0 or not Chrono.is_valid_date(year, month, day):
+            return None
+
+        if strlen == 10:
+            return float(Chrono.days_from_civil(year, month, day) * 86400)
+
+        separator = date_str._codepointUnsafe(10)
+
+        if separator != _UPPER_T and separator != _LOWER_T and separator != _SPACE:
+            return None
+
+        if strlen < 16 or date_str._codepointUnsafe(13) != _COLON:
+            return None
+
+        hour = DateParser._digits(date_str, 11, 2)
+        minute = DateParser._digits(date_str, 14, 2)
+        second = 0.0
+        cursor = 16
+
+        if hour < 0 or minute < 0:
+            return None
+
+        if cursor < strlen and date_str._codepointUnsafe(cursor) == _COLON:
+            if strlen < 19:
+                return None
+
+            # keep the fraction in an integer along with the whole seconds, so that one
+            # division by an exact power of ten rounds the same way float() would.
+            mantissa = DateParser._digits(date_str, 17, 2)
+            fractionDigits = 0
+            cursor = 19
+
+            if mantissa < 0:
+                return None
+
+            if cursor < strlen and date_str._codepointUnsafe(cursor) == _DOT:
+                cursor += 1
+
+                while cursor < strlen:
+                    digit = date_str._codepointUnsafe(cursor) - _ZERO
+
+                    if digit < 0 or digit > 9:
+                        break
+
+                    mantissa = mantissa * 10 + digit
+                    fractionDigits += 1
+                    cursor += 1
+
+                if fractionDigits == 0 or fractionDigits > _MAX_FRACTION_DIGITS:
+                    return None
+
+            second = float(mantissa) / float(10 ** fractionDigits)
+
+        if not Chrono.is_valid_time(hour, minute, second):
+            return None
+
+        offset_hours = 0.0
+        remaining = strlen - cursor
+
+        if remaining == 1:
+            zone = date_str._codepointUnsafe(cursor)
+
+            if zone != _UPPER_Z and zone != _LOWER_Z:
+                return None
+        elif remaining > 0:
+            sign = date_str._codepointUnsafe(cursor)
+
+            if sign != _PLUS and sign != _DASH:
+                return None
+
+            offset_hour = DateParser._digits(date_str, cursor + 1, 2) if remaining >= 3 else -1
+            offset_minute = 0
+
+            if offset_hour < 0:
+                return None
+
+            if remaining == 5:
+                offset_minute = DateParser._digits(date_str, cursor + 3, 2)
+            elif remaining == 6 and date_str._codepointUnsafe(cursor + 3) == _COLON:
+                offset_minute = DateParser._digits(date_str, cursor + 4, 2)
+            elif remaining != 3:
+                return None
+
+            if offset_minute < 0:
+                return None
+
+            offset_hours = float(offset_hour) + float(offset_minute) / 60
+
+            if sign == _DASH:
+                offset_hours = -offset_hours
+
+        # the same arithmetic as Timezone._timestampFromDatetimeAndOffset
+        return (
+            Chrono.days_from_civil(year, month, day) * 86400
+            - offset_hours * 3600
+            + (second + minute * 60 + hour * 3600)
+        )
+
     @Entrypoint
     @staticmethod
     def parse_iso_str(date_str: str) -> float:
@@ -632,6 +811,11 @@ class DateParser(Class, Final):
         Returns:
             unixtime(float): A unix timestamp
         """
+        fast = DateParser._parse_fixed_iso(date_str)
+
+        if fast is not None:
+            return fast
+
         tokens = DateParser._get_tokens(
             time_str=date_str.lower().replace(" ", T), skip_chars="/-:"
         )
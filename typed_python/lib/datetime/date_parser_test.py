@@ -671,6 +671,48 @@ class TestDateParser(unittest.TestCase):
         assert 1666355040 == DateParser.parse("2022-10-21t08:24:00NYC")
         assert 1671629040 == DateParser.parse("2022-12-21t08:24:00NYC")
 
+    def test_parse_fixed_iso_layouts(self):
+        moment = datetime(2020, 2, 29, 13, 17, 5, 0, pytz.UTC)
+
+        expected = {
+            "2020-02-29": datetime(2020, 2, 29, 0, 0, 0, 0, pytz.UTC).timestamp(),
+            "2020-02-29T13:17": datetime(2020, 2, 29, 13, 17, 0, 0, pytz.UTC).timestamp(),
+            "2020-02-29 13:17:05": moment.timestamp(),
+            "2020-02-29t13:17:05Z": moment.timestamp(),
+            "2020-02-29T13:17:05.250": moment.timestamp() + 0.25,
+            "2020-02-29T13:17:05+01": moment.timestamp() - 3600,
+            "2020-02-29T13:17:05+0130": moment.timestamp() - 5400,
+            "2020-02-29T13:17:05-05:00": moment.timestamp() + 5 * 3600,
+        }
+
+        for string, timestamp in expected.items():
+            assert DateParser.parse_iso_str(string) == timestamp, string
+
+    def test_parse_fixed_iso_falls_back(self):
+        # these look like the fixed layouts but aren't, so the general parser decides
+        assert DateParser.parse_iso_str("2022-10-21t08:24:00NYC") == 1666355040
+        assert DateParser.parse_iso_str("2020/02/29") == datetime(2020, 2, 29, 0, 0, 0, 0, pytz.UTC).timestamp()
+
+        for string in ["2020-02-30", "2020-13-01", "2020-02-01T25:00"]:
+            with pytest.raises(ValueError):
+                DateParser.parse_iso_str(string)
+
+    def test_parse_many(self):
+        strings = ListOf(str)(
+            ["2020-02-29T13:17:05.123Z", "1997", "January 2, 1997 2:00pm", "2022-10-21t08:24:00NYC"]
+        )
+
+        assert DateParser.parseMany(strings) == [DateParser.parse(s) for s in strings]
+        assert DateParser.parseMany(ListOf(str)()) == []
+
+        assert DateParser.parseMany(ListOf(str)(["1997-01-02", "2001-03-04"]), "%Y-%m-%d") == [
+            DateParser.parse_with_format("1997-01-02", "%Y-%m-%d"),
+            DateParser.parse_with_format("2001-03-04", "%Y-%m-%d"),
+        ]
+
+        with pytest.raises(ValueError):
+            DateParser.parseMany(ListOf(str)(["2020-02-29", "not a date"]))
+
     def test_compare_parse_iso_perf(self):
         runs = 100000
         date_strings = make_list_of_iso_datestrings(runs)
@@ -2,6 +2,7 @@ import pytz
 
 from typed_python import (
     Class,
+    Entrypoint,
     Final,
     Member,
     ConstDict,
@@ -506,6 +507,69 @@ class Timezone(Class):
         """
         raise NotImplementedError("Subclasses implement.")
 
+    def utcOffsetHours(self, timestamp: float) -> float:
+        """Return the number of hours a locale's clocks are ahead of UTC at the
+        inputted UTC timestamp.
+
+        Parameters
+        ----------
+        timestamp : float
+            timestamp
+
+        """
+        dateTime = self.datetime(timestamp)
+        local = (
+            dateTime.date.daysSinceEpoch() * 86400
+            + dateTime.timeOfDay.secondsSinceMidnight()
+        )
+
+        # offsets are whole numbers of seconds. Rounding drops the error from
+        # splitting 'timestamp' into a date and time and putting it back together.
+        return ((local - timestamp + 0.5) // 1) / 3600
+
+    @Entrypoint
+    def localTimestamps(self, timestamps: ListOf(float)) -> ListOf(float):
+        """Return, for each UTC timestamp, the timestamp UTC clocks show when a
+        locale's clocks show what they do at that instant. In other words, local
+        time as seconds since 1970-01-01 00:00.
+
+        Parameters
+        ----------
+        timestamps : ListOf(float)
+            UTC timestamps
+
+        """
+        res = ListOf(float)()
+        res.reserve(len(timestamps))
+
+        for timestamp in timestamps:
+            res.append(timestamp + self.utcOffsetHours(timestamp) * 3600)
+
+        return res
+
+    @Entrypoint
+    def datetimes(self, timestamps: ListOf(float)) -> ListOf(DateTime):
+        """Return the DateTime a locale's clocks would read at each of the inputted
+        UTC timestamps.
+
+        Parameters
+        ----------
+        timestamps : ListOf(float)
+            UTC timestamps
+
+        """
+        res = ListOf(DateTime)()
+        res.reserve(len(timestamps))
+
+        for timestamp in timestamps:
+            res.append(
+                self._datetimeFromTimestampAndOffset(
+                    timestamp, self.utcOffsetHours(timestamp)
+                )
+            )
+
+        return res
+
     @staticmethod
     def _datetimeFromTimestampAndOffset(
         timestamp: float, offset_hours: float
@@ -1156,6 +1220,130 @@ class PytzTimezone(Timezone, Final):
 NYC = PytzTimezone.fromName("America/New_York")
 EST = FixedOffsetTimezone(offset_hours=-5)
 
+# how far apart TransitionTable.build samples a timezone's offset when looking for
+# transitions. It would miss a pair of transitions closer than this that cancel out.
+_TRANSITION_SAMPLE_SECONDS = 6 * 3600
+
+
+class TransitionTable(Timezone, Final):
+    """A Timezone with its offsets from UTC precomputed over a range of years.
+
+    We find every instant in the range at which the wrapped timezone's offset
+    changes, and index them by day. Finding the offset at a timestamp is then an
+    array lookup, plus a comparison on the few days that have a transition,
+    rather than working out daylight savings rules or searching the timezone's
+    transitions every time. Outside the range we ask the wrapped timezone.
+
+    Converting a column of timestamps goes through 'localTimestamps' or
+    'datetimes':
+
+        table = TransitionTable.build(NYC, 1970, 2050)
+        localTimes = table.localTimestamps(utcTimestamps)
+    """
+
+    timezone = Member(Timezone)
+    start_timestamp = Member(float)
+    end_timestamp = Member(float)
+
+    # the UTC timestamps at which the offset changes. offsets[i] is the offset in
+    # hours from transitions[i - 1] up to transitions[i].
+    transitions = Member(ListOf(float))
+    offsets = Member(ListOf(float))
+
+    # for each day in the range, how many transitions happen at or before its start
+    day_index = Member(ListOf(int))
+
+    @Entrypoint
+    @staticmethod
+    def build(timezone: Timezone, startYear: int, endYear: int):
+        """Precompute 'timezone's offsets from the start of 'startYear' up to
+        the start of 'endYear'.
+
+        Parameters
+        ----------
+        timezone : Timezone
+            The timezone to tabulate.
+        startYear/endYear : int
+            The range of years to cover, as in range(startYear, endYear).
+        """
+        assert startYear < endYear
+
+        firstDay = Chrono.days_from_civil(startYear, 1, 1)
+        dayCount = Chrono.days_from_civil(endYear, 1, 1) - firstDay
+        start = float(firstDay * 86400)
+        end = start + dayCount * 86400
+
+        transitions = ListOf(float)()
+        offsets = ListOf(float)()
+
+        lo = start
+        offset = timezone.utcOffsetHours(lo)
+        offsets.append(offset)
+
+        while lo < end:
+            hi = min(lo + _TRANSITION_SAMPLE_SECONDS, end)
+
+            if timezone.utcOffsetHours(hi) == offset:
+                lo = hi
+            else:
+                # bisect until 'lo' and 'hi' are adjacent floats, so 'hi' is the
+                # first instant with the new offset however the timezone rounds.
+                while True:
+                    mid = lo + (hi - lo) / 2
+
+                    if mid <= lo or mid >= hi:
+                        break
+
+                    if timezone.utcOffsetHours(mid) == offset:
+                        lo = mid
+                    else:
+                        hi = mid
+
+                offset = timezone.utcOffsetHours(hi)
+                transitions.append(hi)
+                offsets.append(offset)
+                lo = hi
+
+        day_index = ListOf(int)()
+        day_index.reserve(dayCount)
+        count = 0
+
+        for day in range(dayCount):
+            dayStart = start + day * 86400
+
+            while count < len(transitions) and transitions[count] <= dayStart:
+                count += 1
+
+            day_index.append(count)
+
+        return TransitionTable(
+            timezone=timezone,
+            start_timestamp=start,
+            end_timestamp=end,
+            transitions=transitions,
+            offsets=offsets,
+            day_index=day_index,
+        )
+
+    def utcOffsetHours(self, timestamp: float) -> float:
+        if not (self.start_timestamp <= timestamp < self.end_timestamp):
+            return self.timezone.utcOffsetHours(timestamp)
+
+        i = self.day_index[int((timestamp - self.start_timestamp) // 86400)]
+
+        while i < len(self.transitions) and self.transitions[i] <= timestamp:
+            i += 1
+
+        return self.offsets[i]
+
+    def timestamp(self, dateTime: DateTime, afterFold: bool = False) -> float:
+        return self.timezone.timestamp(dateTime, afterFold)
+
+    def datetime(self, timestamp: float) -> DateTime:
+        return self._datetimeFromTimestampAndOffset(
+            timestamp, self.utcOffsetHours(timestamp)
+        )
+
 
 class TimezoneChecker(Class, Final):
     TIMEZONES = ConstDict(str, Timezone)(
@@ -15,7 +15,10 @@ from typed_python.lib.datetime.date_time import (
     last_weekday_of_month,
     OneFoldOnlyError,
     PytzTimezone,
+    TransitionTable,
+    UsTimezone,
 )
+from typed_python import ListOf
 from typed_python.lib.datetime.date_parser_test import get_datetimes_in_range
 from typed_python.lib.timestamp import Timestamp
 
@@ -406,3 +409,59 @@ def test_asNamedTuple():
     assert x.year == 2023
     assert x.month == 1
     assert x.day == 12
+
+
+def test_TransitionTable_matches_its_timezone():
+    for tz in [NYC, UsTimezone(-6, -5)(), EST]:
+        table = TransitionTable.build(tz, 1900, 2040)
+
+        start = UTC.timestamp(DateTime(1899, 6, 1, 0, 0, 0))
+        end = UTC.timestamp(DateTime(2041, 6, 1, 0, 0, 0))
+
+        # every hour and half hour hits the transitions themselves, and the
+        # random ones land in between. The ends are outside the table.
+        timestamps = ListOf(float)(range(int(start), int(end), 1800))
+        timestamps.extend([start + (end - start) * i / 100003 + 0.25 for i in range(100003)])
+
+        assert table.datetimes(timestamps) == tz.datetimes(timestamps)
+        assert table.localTimestamps(timestamps) == tz.localTimestamps(timestamps)
+
+    # one step either side of each transition
+    table = TransitionTable.build(NYC, 1970, 2040)
+
+    for transition in table.transitions:
+        for ts in [transition - 1e-6, transition, transition + 1e-6]:
+            assert table.utcOffsetHours(ts) == NYC.utcOffsetHours(ts)
+            assert table.datetime(ts) == NYC.datetime(ts)
+
+
+def test_TransitionTable_transitions():
+    table = TransitionTable.build(NYC, 2022, 2023)
+
+    # NYC keeps the old offset at the instant of a transition, so ours are a hair later
+    expected = [
+        UTC.timestamp(DateTime(2022, 3, 13, 7, 0, 0)),
+        UTC.timestamp(DateTime(2022, 11, 6, 6, 0, 0)),
+    ]
+
+    assert len(table.transitions) == 2
+    for ours, theirs in zip(table.transitions, expected):
+        assert theirs <= ours < theirs + 1e-3
+
+    assert list(table.offsets) == [-5.0, -4.0, -5.0]
+
+    assert TransitionTable.build(EST, 1970, 2100).transitions == []
+
+    # timestamp() defers to the timezone
+    dateTime = DateTime(2022, 11, 6, 1, 30, 0)
+    assert table.timestamp(dateTime, True) == NYC.timestamp(dateTime, True)
+
+
+def test_localTimestamps():
+    # the second is during daylight savings time
+    timestamps = ListOf(float)([0.0, 1667707200.5])
+
+    assert EST.localTimestamps(timestamps) == [-5 * 3600.0, 1667707200.5 - 5 * 3600]
+    assert NYC.localTimestamps(timestamps) == [-5 * 3600.0, 1667707200.5 - 4 * 3600]
+    assert NYC.datetimes(timestamps) == [NYC.datetime(ts) for ts in timestamps]
+    assert UTC.localTimestamps(ListOf(float)()) == []
@@ -0,0 +1,258 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A segmented double-ended queue.
+
+'ListOf(T)' is one contiguous buffer: 'pop(0)' and 'insert(0, x)' move every
+element, and growing it reallocates (and copies) the whole thing. 'DequeOf(T)'
+keeps its elements in fixed-size chunks of CHUNK_SIZE instead:
+
+    window = DequeOf(float)()
+    window.append(x)        # O(1) amortized at either end
+    window.appendLeft(x)
+    window.popLeft()
+    window[i]               # O(1)
+
+Chunks are allocated at their full size and never move, so elements keep
+their addresses for as long as they're in the deque, and growing to any size
+never copies more than the (small) list of chunk pointers.
+
+'chunkCount' and 'chunk' expose the chunks themselves, so work on a very large
+deque can be split up one chunk per task without copying anything. Slots
+outside the live range of a chunk hold T().
+
+T must be default-constructible, since chunks are allocated full of T().
+Use OneOf(None, T) for Class types.
+"""
+
+from typed_python import TypeFunction, Class, Member, Final, Entrypoint, ListOf, Forward, Tuple
+
+
+CHUNK_SIZE = 1024
+
+
+@TypeFunction
+def DequeOf(T):
+    DequeOf_ = Forward("DequeOf_")
+
+    @DequeOf_.define
+    class DequeOf_(Class, Final, __name__=f"DequeOf({T.__name__})"):
+        ElementType = T
+
+        # _chunks[_firstChunk:] are live. The slots before that are spare room
+        # for appendLeft, and hold empty lists.
+        _chunks = Member(ListOf(ListOf(T)), nonempty=True)
+        _firstChunk = Member(int, nonempty=True)
+
+        # the position of our first element within _chunks[_firstChunk]
+        _head = Member(int, nonempty=True)
+
+        _len = Member(int, nonempty=True)
+
+        def __init__(self):
+            pass
+
+        def __init__(self, elements):  # noqa: F811
+            for e in elements:
+                self.append(e)
+
+        def __len__(self) -> int:
+            return self._len
+
+        @staticmethod
+        def _newChunk() -> ListOf(T):
+            res = ListOf(T)()
+            res.resize(CHUNK_SIZE)
+            return res
+
+        @Entrypoint
+        def _locate(self, i: int) -> Tuple(int, int):
+            """Return (chunk slot, offset) of element 'i', which may be negative."""
+            if i < 0:
+                i += self._len
+
+            if i < 0 or i >= self._len:
+                raise IndexError("DequeOf index out of range")
+
+            pos = self._head + i
+
+            return (self._firstChunk + pos // CHUNK_SIZE, pos % CHUNK_SIZE)
+
+        @Entrypoint
+        def __getitem__(self, i: int) -> T:
+            c, off = self._locate(i)
+
+            return self._chunks[c][off]
+
+        @Entrypoint
+        def __setitem__(self, i: int, v: T) -> None:
+            c, off = self._locate(i)
+
+            self._chunks[c][off] = v
+
+        @Entrypoint
+        def append(self, v: T) -> None:
+            pos = self._head + self._len
+
+            if self._firstChunk + pos // CHUNK_SIZE == len(self._chunks):
+                self._chunks.append(DequeOf_._newChunk())
+
+            self._chunks[self._firstChunk + pos // CHUNK_SIZE][pos % CHUNK_SIZE] = v
+            self._len += 1
+
+        @Entrypoint
+        def appendLeft(self, v: T) -> None:
+            if self._len == 0 and len(self._chunks) == self._firstChunk:
+                self._chunks.append(DequeOf_._newChunk())
+                self._head = CHUNK_SIZE // 2
+
+            if self._head == 0:
+                if self._firstChunk == 0:
+                    self._growFront()
+
+                self._firstChunk -= 1
+                self._chunks[self._firstChunk] = DequeOf_._newChunk()
+                self._head = CHUNK_SIZE
+
+            self._head -= 1
+            self._chunks[self._firstChunk][self._head] = v
+            self._len += 1
+
+        @Entrypoint
+        def pop(self) -> T:
+            if not self._len:
+                raise IndexError("pop from an empty DequeOf")
+
+            pos = self._head + self._len - 1
+            chunk = self._chunks[self._firstChunk + pos // CHUNK_SIZE]
+
+            res = chunk[pos % CHUNK_SIZE]
+            chunk[pos % CHUNK_SIZE] = T()
+            self._len -= 1
+
+            if pos % CHUNK_SIZE == 0:
+                self._chunks.pop()
+
+            if self._len == 0:
+                self._reset()
+
+            return res
+
+        @Entrypoint
+        def popLeft(self) -> T:
+            if not self._len:
+                raise IndexError("pop from an empty DequeOf")
+
+            chunk = self._chunks[self._firstChunk]
+
+            res = chunk[self._head]
+            chunk[self._head] = T()
+            self._head += 1
+            self._len -= 1
+
+            if self._head == CHUNK_SIZE:
+                self._chunks[self._firstChunk] = ListOf(T)()
+                self._firstChunk += 1
+                self._head = 0
+
+                if self._firstChunk > 2 * (len(self._chunks) - self._firstChunk) + 16:
+                    self._dropFront()
+
+            if self._len == 0:
+                self._reset()
+
+            return res
+
+        @Entrypoint
+        def clear(self) -> None:
+            self._chunks = ListOf(ListOf(T))()
+            self._reset()
+
+        @Entrypoint
+        def _reset(self) -> None:
+            """Forget our (now empty) chunks."""
+            self._chunks.clear()
+            self._firstChunk = 0
+            self._head = 0
+            self._len = 0
+
+        @Entrypoint
+        def _growFront(self) -> None:
+            """Make room for at least as many chunks in front of us as we have."""
+            live = len(self._chunks) - self._firstChunk
+            spare = max(live, 1)
+
+            chunks = ListOf(ListOf(T))()
+            chunks.reserve(spare + live)
+            chunks.resize(spare)
+
+            for c in range(self._firstChunk, len(self._chunks)):
+                chunks.append(self._chunks[c])
+
+            self._chunks = chunks
+            self._firstChunk = spare
+
+        @Entrypoint
+        def _dropFront(self) -> None:
+            """Release most of the spare room popLeft has left in front of us."""
+            live = len(self._chunks) - self._firstChunk
+
+            chunks = ListOf(ListOf(T))()
+            chunks.reserve(2 * live)
+            chunks.resize(live)
+
+            for c in range(self._firstChunk, len(self._chunks)):
+                chunks.append(self._chunks[c])
+
+            self._chunks = chunks
+            self._firstChunk = live
+
+        @Entrypoint
+        def chunkCount(self) -> int:
+            return len(self._chunks) - self._firstChunk
+
+        @Entrypoint
+        def chunk(self, c: int) -> Tuple(ListOf(T), int, int):
+            """Return (chunk, start, stop) for our c'th chunk.
+
+            Our elements in that chunk are chunk[start:stop]. The chunk itself is
+            shared with us, not copied.
+            """
+            if c < 0 or c >= self.chunkCount():
+                raise IndexError("DequeOf chunk index out of range")
+
+            start = self._head if c == 0 else 0
+            stop = min(CHUNK_SIZE, self._head + self._len - c * CHUNK_SIZE)
+
+            return (self._chunks[self._firstChunk + c], start, stop)
+
+        @Entrypoint
+        def toList(self) -> ListOf(T):
+            res = ListOf(T)()
+            res.reserve(self._len)
+
+            for i in range(self._len):
+                res.append(self[i])
+
+            return res
+
+        def __iter__(self):
+            for i in range(self._len):
+                yield self[i]
+
+        def __repr__(self) -> str:
+            return f"DequeOf({list(self)!r})"
+
+    return DequeOf_
@@ -0,0 +1,152 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import collections
+import numpy
+import pytest
+
+from typed_python import Entrypoint
+from typed_python.lib.deque import DequeOf, CHUNK_SIZE
+
+
+def test_deque_basics():
+    d = DequeOf(str)(["b", "c"])
+
+    d.appendLeft("a")
+    d.append("d")
+
+    assert len(d) == 4
+    assert list(d) == ["a", "b", "c", "d"]
+    assert d[0] == "a" and d[-1] == "d"
+
+    d[1] = "x"
+
+    assert d.popLeft() == "a"
+    assert d.pop() == "d"
+    assert d.toList() == ["x", "c"]
+
+    d.clear()
+
+    assert len(d) == 0
+
+    with pytest.raises(IndexError):
+        d.pop()
+
+    with pytest.raises(IndexError):
+        d.popLeft()
+
+    with pytest.raises(IndexError):
+        d[0]
+
+
+def test_deque_matches_collections_deque():
+    numpy.random.seed(42)
+
+    d = DequeOf(int)()
+    reference = collections.deque()
+
+    for step in range(50000):
+        op = numpy.random.randint(8)
+
+        # drift towards the front for a while, and then back, so we cross
+        # plenty of chunk boundaries in both directions
+        if (step // 10000) % 2:
+            op = 7 - op
+
+        if op < 3 or not reference:
+            d.append(step)
+            reference.append(step)
+        elif op < 5:
+            d.appendLeft(step)
+            reference.appendleft(step)
+        elif op < 6:
+            assert d.pop() == reference.pop()
+        elif op < 7:
+            assert d.popLeft() == reference.popleft()
+        else:
+            i = numpy.random.randint(len(reference))
+            d[i] = -step
+            reference[i] = -step
+
+        assert len(d) == len(reference)
+
+    assert list(d) == list(reference)
+
+
+def test_deque_chunks_cover_elements():
+    d = DequeOf(int)(range(CHUNK_SIZE * 3))
+
+    for _ in range(CHUNK_SIZE + 10):
+        d.popLeft()
+
+    for i in range(20):
+        d.appendLeft(-i)
+
+    elements = []
+
+    for c in range(d.chunkCount()):
+        chunk, start, stop = d.chunk(c)
+        elements.extend(chunk[start:stop])
+
+    assert elements == list(d)
+
+
+def test_deque_elements_dont_move():
+    d = DequeOf(int)([1])
+
+    before = d.chunk(0)[0].pointerUnsafe(d.chunk(0)[1])
+
+    for i in range(CHUNK_SIZE * 10):
+        d.append(i)
+        d.appendLeft(i)
+
+    c = (d._head + CHUNK_SIZE * 10) // CHUNK_SIZE
+    chunk = d._chunks[d._firstChunk + c]
+
+    assert chunk[(d._head + CHUNK_SIZE * 10) % CHUNK_SIZE] == 1
+    assert chunk.pointerUnsafe((d._head + CHUNK_SIZE * 10) % CHUNK_SIZE) == before
+
+
+def test_deque_sliding_window_compiled():
+    @Entrypoint
+    def windowSums(n: int, window: int) -> float:
+        d = DequeOf(float)()
+        total = 0.0
+        res = 0.0
+
+        for i in range(n):
+            d.append(float(i))
+            total += i
+
+            if len(d) > window:
+                total -= d.popLeft()
+
+            res += total
+
+        return res
+
+    expected = 0.0
+    window = collections.deque()
+    total = 0.0
+
+    for i in range(100000):
+        window.append(float(i))
+        total += i
+
+        if len(window) > 100:
+            total -= window.popleft()
+
+        expected += total
+
+    assert windowSums(100000, 100) == expected
@@ -0,0 +1,247 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Group-by and join over key columns, without allocating anything per group.
+
+Grouping with a 'Dict(K, ListOf(int))' allocates a list for every distinct key
+and grows each of them one row at a time. Instead, 'groupBy' numbers the
+distinct keys with a single open-addressing table (like the one inside Dict,
+see hash_table_layout) and then lays the rows out group by group in one
+ListOf(int), compressed-sparse-row style:
+
+    grouping = groupBy(ListOf(str)(["a", "b", "a"]))
+
+    grouping.groupIds     # [0, 1, 0]: the group of each row
+    grouping.firstRows    # [0, 1]: a row holding each group's key
+    grouping.offsets      # [0, 2, 3]: group g is rows[offsets[g]:offsets[g + 1]]
+    grouping.rows         # [0, 2, 1]
+
+Groups are numbered in order of first appearance and the rows of each group are
+in increasing order.
+
+'hashJoin(left, right)' returns the matching (leftRow, rightRow) pairs of an
+inner equi-join, built from a grouping of 'right'. Pass 'parallel=True' to split
+the probe side into chunks on the pmap thread pool.
+
+Everything here works on any ListOf of a hashable type, including the codes of
+a CategoricalListOf.
+"""
+
+from typed_python import Entrypoint, ListOf, NamedTuple, Tuple
+from typed_python.lib.pmap import ensureThreads
+
+
+# the probe side of a parallel join is cut into chunks of at least this many rows
+_MIN_JOIN_CHUNK = 16384
+
+
+# An open-addressing table numbering the distinct keys of a column.
+#   slots - power-of-two sized. Each is 0 if empty or (group id + 1).
+#   hashes - the hash of each group's key, so most mismatches don't compare keys.
+#   firstRows - the first row of the column holding each group's key.
+KeyIndex = NamedTuple(slots=ListOf(int), hashes=ListOf(int), firstRows=ListOf(int))
+
+
+Grouping = NamedTuple(
+    groupIds=ListOf(int),
+    firstRows=ListOf(int),
+    offsets=ListOf(int),
+    rows=ListOf(int),
+)
+
+
+@Entrypoint
+def _findGroup(index: KeyIndex, keys, key, h: int) -> int:
+    """Return the group of 'key' (whose hash is 'h'), or -1 if 'keys' doesn't contain it."""
+    mask = len(index.slots) - 1
+    slot = h & mask
+
+    while True:
+        group = index.slots[slot] - 1
+
+        if group < 0:
+            return -1
+
+        if index.hashes[group] == h and keys[index.firstRows[group]] == key:
+            return group
+
+        slot = (slot + 1) & mask
+
+
+@Entrypoint
+def groupIds(keys) -> Tuple(ListOf(int), KeyIndex):
+    """Number the distinct values in 'keys' in order of first appearance.
+
+    Returns:
+        (ids, index), where ids[i] is the group of keys[i] and 'index' is the
+        table we built to find them.
+    """
+    count = len(keys)
+
+    tableSize = 8
+    while tableSize < count * 2:
+        tableSize *= 2
+
+    index = KeyIndex()
+    index.slots.resize(tableSize)
+
+    ids = ListOf(int)()
+    ids.resize(count)
+
+    slots = index.slots.pointerUnsafe(0)
+    mask = tableSize - 1
+
+    for i in range(count):
+        key = keys[i]
+        h = hash(key)
+        slot = h & mask
+
+        while True:
+            group = slots[slot] - 1
+
+            if group < 0:
+                group = len(index.firstRows)
+                slots[slot] = group + 1
+                index.hashes.append(h)
+                index.firstRows.append(i)
+                break
+
+            if index.hashes[group] == h and keys[index.firstRows[group]] == key:
+                break
+
+            slot = (slot + 1) & mask
+
+        ids[i] = group
+
+    return (ids, index)
+
+
+@Entrypoint
+def _groupByWithIndex(keys) -> Tuple(Grouping, KeyIndex):
+    ids, index = groupIds(keys)
+
+    count = len(keys)
+    groupCount = len(index.firstRows)
+
+    offsets = ListOf(int)()
+    offsets.resize(groupCount + 1)
+
+    pIds = ids.pointerUnsafe(0)
+    pOffsets = offsets.pointerUnsafe(0)
+
+    for i in range(count):
+        pOffsets[pIds[i] + 1] += 1
+
+    for g in range(groupCount):
+        pOffsets[g + 1] += pOffsets[g]
+
+    # counting sort: 'cursor[g]' is where the next row of group g goes
+    cursor = ListOf(int)(offsets)
+    pCursor = cursor.pointerUnsafe(0)
+
+    rows = ListOf(int)()
+    rows.resize(count)
+    pRows = rows.pointerUnsafe(0)
+
+    for i in range(count):
+        g = pIds[i]
+        pRows[pCursor[g]] = i
+        pCursor[g] += 1
+
+    return (Grouping(groupIds=ids, firstRows=index.firstRows, offsets=offsets, rows=rows), index)
+
+
+@Entrypoint
+def groupBy(keys) -> Grouping:
+    """Group the rows of 'keys' by value. See the module docstring for the layout of the result."""
+    return _groupByWithIndex(keys)[0]
+
+
+@Entrypoint
+def hashJoin(left, right, parallel=False) -> Tuple(ListOf(int), ListOf(int)):
+    """Find every pair of rows with left[i] == right[j].
+
+    Returns:
+        (leftRows, rightRows), the pairs in order of 'i' and then 'j'.
+    """
+    grouping, index = _groupByWithIndex(right)
+
+    count = len(left)
+
+    # the group of each row of 'left' in 'right', or -1
+    leftGroups = ListOf(int)()
+    leftGroups.resize(count)
+    pGroups = leftGroups.pointerUnsafe(0)
+    pOffsets = grouping.offsets.pointerUnsafe(0)
+    pRows = grouping.rows.pointerUnsafe(0)
+
+    chunkSize = max(count, 1)
+    if parallel:
+        chunkSize = max(_MIN_JOIN_CHUNK, count // (ensureThreads().threadCount * 4))
+
+    chunkCount = (count + chunkSize - 1) // chunkSize
+
+    matchCounts = ListOf(int)()
+    matchCounts.resize(chunkCount + 1)
+
+    def probeChunk(chunkIx):
+        matches = 0
+
+        for i in range(chunkIx * chunkSize, min(count, (chunkIx + 1) * chunkSize)):
+            key = left[i]
+            group = _findGroup(index, right, key, hash(key))
+            pGroups[i] = group
+
+            if group >= 0:
+                matches += pOffsets[group + 1] - pOffsets[group]
+
+        matchCounts[chunkIx + 1] = matches
+
+    if parallel and chunkCount > 1:
+        ensureThreads().parallel_for(chunkCount, probeChunk, 1)
+    else:
+        for chunkIx in range(chunkCount):
+            probeChunk(chunkIx)
+
+    for chunkIx in range(chunkCount):
+        matchCounts[chunkIx + 1] += matchCounts[chunkIx]
+
+    leftRows = ListOf(int)()
+    leftRows.resize(matchCounts[chunkCount])
+    rightRows = ListOf(int)()
+    rightRows.resize(matchCounts[chunkCount])
+
+    pLeft = leftRows.pointerUnsafe(0)
+    pRight = rightRows.pointerUnsafe(0)
+
+    def emitChunk(chunkIx):
+        pos = matchCounts[chunkIx]
+
+        for i in range(chunkIx * chunkSize, min(count, (chunkIx + 1) * chunkSize)):
+            group = pGroups[i]
+
+            if group >= 0:
+                for k in range(pOffsets[group], pOffsets[group + 1]):
+                    pLeft[pos] = i
+                    pRight[pos] = pRows[k]
+                    pos += 1
+
+    if parallel and chunkCount > 1:
+        ensureThreads().parallel_for(chunkCount, emitChunk, 1)
+    else:
+        for chunkIx in range(chunkCount):
+            emitChunk(chunkIx)
+
+    return (leftRows, rightRows)
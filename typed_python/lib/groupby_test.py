@@ -0,0 +1,87 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import random
+
+from typed_python import ListOf
+from typed_python.lib.groupby import groupBy, groupIds, hashJoin
+
+
+def naiveGroups(keys):
+    groups = {}
+    for i, k in enumerate(keys):
+        groups.setdefault(k, []).append(i)
+    return groups
+
+
+def test_group_by_strings():
+    grouping = groupBy(ListOf(str)(["a", "b", "a", "c", "b", "a"]))
+
+    assert grouping.groupIds == [0, 1, 0, 2, 1, 0]
+    assert grouping.firstRows == [0, 1, 3]
+    assert grouping.offsets == [0, 3, 5, 6]
+    assert grouping.rows == [0, 2, 5, 1, 4, 3]
+
+
+def test_group_by_matches_dict():
+    keys = ListOf(int)([random.randint(-50, 50) * 2 ** 40 for _ in range(5000)])
+
+    grouping = groupBy(keys)
+    groups = naiveGroups(keys)
+
+    assert len(grouping.firstRows) == len(groups)
+
+    for g, firstRow in enumerate(grouping.firstRows):
+        rows = grouping.rows[grouping.offsets[g]:grouping.offsets[g + 1]]
+        assert rows == groups[keys[firstRow]]
+
+
+def test_group_by_empty():
+    grouping = groupBy(ListOf(float)())
+
+    assert grouping.offsets == [0]
+    assert len(grouping.rows) == 0
+
+    ids, index = groupIds(ListOf(float)())
+    assert len(ids) == 0
+
+
+def test_hash_join():
+    left = ListOf(str)(["x", "y", "z", "x"])
+    right = ListOf(str)(["y", "x", "x", "w"])
+
+    leftRows, rightRows = hashJoin(left, right)
+    assert leftRows == [0, 0, 1, 3, 3]
+    assert rightRows == [1, 2, 0, 1, 2]
+
+    leftRows, rightRows = hashJoin(left, ListOf(str)())
+    assert len(leftRows) == len(rightRows) == 0
+
+
+def test_parallel_hash_join_matches_serial_one():
+    left = ListOf(int)([random.randint(0, 1000) for _ in range(100000)])
+    right = ListOf(int)([random.randint(0, 2000) for _ in range(3000)])
+
+    leftRows, rightRows = hashJoin(left, right, True)
+
+    serialLeftRows, serialRightRows = hashJoin(left, right)
+    assert leftRows == serialLeftRows
+    assert rightRows == serialRightRows
+
+    groups = naiveGroups(right)
+
+    assert len(leftRows) == sum(len(groups.get(k, ())) for k in left)
+
+    for i, j in zip(leftRows, rightRows):
+        assert left[i] == right[j]
@@ -0,0 +1,457 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Heaps, priority queues, and the n smallest or largest elements of a list.
+
+'heapify', 'heappush', 'heappop', 'heappushpop' and 'heapreplace' work on a
+ListOf the way the heapq module works on a list, and keep heapq's invariant,
+heap[k] <= heap[2k + 1] and heap[k] <= heap[2k + 2], so a list can go back and
+forth between them and heapq. (They may leave the elements arranged differently
+than heapq would, but they pop them in the same order.) Each takes an optional
+'key'.
+
+'PriorityQueue(T, key)' is a min-heap on key(x), in its own ListOf(T):
+
+    def eventTime(e):
+        return e.time
+
+    events = PriorityQueue(Event, eventTime)()
+    events.push(Event(time=3.0, ...))
+    nextEvent = events.pop()
+
+It's 4-ary rather than binary: the children of node k are 4k+1 ... 4k+4, which
+sit next to each other and usually share a cache line. A sift-down compares
+more siblings at each level, but it has half as many levels to go through, and
+each level costs one cache line rather than one per comparison.
+
+'nsmallest(values, n, key)' and 'nlargest(values, n, key)' return the n
+smallest (or largest) elements in order, like heapq's functions do, but don't
+push everything through a heap. When n is small next to len(values) we stream
+over values keeping the best n in a bounded heap. Otherwise we copy values and
+partition the copy with introselect: quickselect on a median-of-three pivot,
+which falls back to heap selection if its partitions keep coming out lopsided,
+so it's O(len(values) log n) at worst. Either way we then sort the n we kept.
+Equal elements can come back in any order.
+
+'pnsmallest' and 'pnlargest' split values into chunks on the pmap thread pool,
+pick the best n out of each chunk, and then pick the best n of those.
+"""
+
+from typed_python import TypeFunction, Class, Member, Final, Entrypoint, ListOf
+from typed_python.lib.pmap import pmap, _chunkSize, _chunkIndices
+from typed_python.lib.sorting import _swap, _sort3, _insertionSort, _siftDown as _siftDownMax, _pdqsort
+
+
+_INSERTION_SELECT_THRESHOLD = 24
+
+# below len(values) / n of this, nsmallest keeps a bounded heap instead of copying values
+_STREAMING_SELECT_RATIO = 16
+
+# PriorityQueue.pushMany rebuilds the whole heap if it's adding more than 1 / this
+# of the heap, rather than sifting up each new element
+_REBUILD_RATIO = 4
+
+
+def _lessThan(x, y):
+    return x < y
+
+
+def _greaterThan(x, y):
+    return y < x
+
+
+def _identity(x):
+    return x
+
+
+def _siftUp(heap, pos, arity, less):
+    """Move heap[pos] up towards the root until its parent isn't bigger."""
+    item = heap[pos]
+
+    while pos > 0:
+        parent = (pos - 1) // arity
+
+        if not less(item, heap[parent]):
+            break
+
+        heap[pos] = heap[parent]
+        pos = parent
+
+    heap[pos] = item
+
+
+def _siftDown(heap, pos, arity, less):
+    """Move heap[pos] down until none of its children is smaller."""
+    size = len(heap)
+    item = heap[pos]
+
+    while True:
+        first = arity * pos + 1
+
+        if first >= size:
+            break
+
+        best = first
+
+        for child in range(first + 1, min(first + arity, size)):
+            if less(heap[child], heap[best]):
+                best = child
+
+        if not less(heap[best], item):
+            break
+
+        heap[pos] = heap[best]
+        pos = best
+
+    heap[pos] = item
+
+
+def _heapify(heap, arity, less):
+    pos = (len(heap) - 2) // arity
+
+    while pos >= 0:
+        _siftDown(heap, pos, arity, less)
+        pos -= 1
+
+
+def _heappop(heap, arity, less):
+    if not len(heap):
+        raise IndexError("pop from an empty heap")
+
+    last = heap.pop()
+
+    if not len(heap):
+        return last
+
+    res = heap[0]
+    heap[0] = last
+    _siftDown(heap, 0, arity, less)
+
+    return res
+
+
+def _heapreplace(heap, item, arity, less):
+    if not len(heap):
+        raise IndexError("replace on an empty heap")
+
+    res = heap[0]
+    heap[0] = item
+    _siftDown(heap, 0, arity, less)
+
+    return res
+
+
+def _heappushpop(heap, item, arity, less):
+    if not len(heap) or not less(heap[0], item):
+        return item
+
+    res = heap[0]
+    heap[0] = item
+    _siftDown(heap, 0, arity, less)
+
+    return res
+
+
+@Entrypoint
+def heapify(heap, key=None):
+    """Rearrange the ListOf 'heap' into a heap, in linear time."""
+    if key is None:
+        _heapify(heap, 2, _lessThan)
+    else:
+        _heapify(heap, 2, lambda x, y: key(x) < key(y))
+
+
+@Entrypoint
+def heappush(heap, item, key=None):
+    """Push 'item' onto 'heap'."""
+    heap.append(item)
+
+    if key is None:
+        _siftUp(heap, len(heap) - 1, 2, _lessThan)
+    else:
+        _siftUp(heap, len(heap) - 1, 2, lambda x, y: key(x) < key(y))
+
+
+@Entrypoint
+def heappop(heap, key=None):
+    """Pop and return the smallest element of 'heap'."""
+    if key is None:
+        return _heappop(heap, 2, _lessThan)
+    else:
+        return _heappop(heap, 2, lambda x, y: key(x) < key(y))
+
+
+@Entrypoint
+def heapreplace(heap, item, key=None):
+    """Pop and return the smallest element of 'heap', then push 'item'."""
+    if key is None:
+        return _heapreplace(heap, item, 2, _lessThan)
+    else:
+        return _heapreplace(heap, item, 2, lambda x, y: key(x) < key(y))
+
+
+@Entrypoint
+def heappushpop(heap, item, key=None):
+    """Push 'item', then pop and return the smallest element of 'heap'. Faster than doing both."""
+    if key is None:
+        return _heappushpop(heap, item, 2, _lessThan)
+    else:
+        return _heappushpop(heap, item, 2, lambda x, y: key(x) < key(y))
+
+
+@TypeFunction
+def PriorityQueue(T, key=_identity):
+    """A 4-ary min-heap of T, ordered by key(x). See the module docstring."""
+    def less(x, y):
+        return key(x) < key(y)
+
+    class PriorityQueue_(Class, Final, __name__=f"PriorityQueue({T.__name__})"):
+        ElementType = T
+
+        _heap = Member(ListOf(T), nonempty=True)
+
+        def __init__(self):
+            pass
+
+        def __init__(self, values):  # noqa: F811
+            self._heap = ListOf(T)(values)
+            self._heapify()
+
+        @Entrypoint
+        def __len__(self) -> int:
+            return len(self._heap)
+
+        @Entrypoint
+        def push(self, item: T) -> None:
+            self._heap.append(item)
+            _siftUp(self._heap, len(self._heap) - 1, 4, less)
+
+        @Entrypoint
+        def pushMany(self, items: ListOf(T)) -> None:
+            start = len(self._heap)
+
+            self._heap.reserve(start + len(items))
+
+            for item in items:
+                self._heap.append(item)
+
+            if len(items) * _REBUILD_RATIO > len(self._heap):
+                _heapify(self._heap, 4, less)
+            else:
+                for pos in range(start, len(self._heap)):
+                    _siftUp(self._heap, pos, 4, less)
+
+        @Entrypoint
+        def peek(self) -> T:
+            """The smallest element, without removing it."""
+            if not len(self._heap):
+                raise IndexError("peek at an empty PriorityQueue")
+
+            return self._heap[0]
+
+        @Entrypoint
+        def pop(self) -> T:
+            """Remove and return the smallest element."""
+            return _heappop(self._heap, 4, less)
+
+        @Entrypoint
+        def popMany(self, maxCount: int) -> ListOf(T):
+            """Remove and return up to 'maxCount' of the smallest elements, smallest first."""
+            res = ListOf(T)()
+            res.reserve(min(maxCount, len(self._heap)))
+
+            while len(res) < maxCount and len(self._heap):
+                res.append(_heappop(self._heap, 4, less))
+
+            return res
+
+        @Entrypoint
+        def pushPop(self, item: T) -> T:
+            """Push 'item', then remove and return the smallest element."""
+            return _heappushpop(self._heap, item, 4, less)
+
+        @Entrypoint
+        def replace(self, item: T) -> T:
+            """Remove and return the smallest element, then push 'item'."""
+            return _heapreplace(self._heap, item, 4, less)
+
+        @Entrypoint
+        def clear(self) -> None:
+            self._heap.clear()
+
+        @Entrypoint
+        def toList(self) -> ListOf(T):
+            """The elements in heap order. Use 'popMany' to get them sorted."""
+            return ListOf(T)(self._heap)
+
+        @Entrypoint
+        def _heapify(self) -> None:
+            _heapify(self._heap, 4, less)
+
+    return PriorityQueue_
+
+
+def _heapSelect(values, begin, end, nth, less):
+    """Move the smallest 'nth - begin' elements of values[begin:end] to the front, using a max-heap of them."""
+    size = nth - begin
+
+    root = size // 2 - 1
+    while root >= 0:
+        _siftDownMax(values, begin, root, size, less)
+        root -= 1
+
+    for i in range(nth, end):
+        if less(values[i], values[begin]):
+            _swap(values, begin, i)
+            _siftDownMax(values, begin, 0, size, less)
+
+
+def _introselect(values, begin, end, nth, less):
+    """Rearrange values[begin:end] so no element of values[begin:nth] is bigger than any of values[nth:end]."""
+    depthLimit = 0
+    n = end - begin
+    while n > 1:
+        depthLimit += 2
+        n //= 2
+
+    while end - begin > _INSERTION_SELECT_THRESHOLD:
+        if nth <= begin or nth >= end:
+            return
+
+        if depthLimit == 0:
+            _heapSelect(values, begin, end, nth, less)
+            return
+
+        depthLimit -= 1
+
+        # the median of three ends up in the middle, and the other two stop the
+        # scans below from running off either end
+        mid = begin + (end - begin) // 2
+        _sort3(values, begin, mid, end - 1, less)
+        pivot = values[mid]
+
+        i = begin - 1
+        j = end
+
+        while True:
+            i += 1
+            while less(values[i], pivot):
+                i += 1
+
+            j -= 1
+            while less(pivot, values[j]):
+                j -= 1
+
+            if i >= j:
+                break
+
+            _swap(values, i, j)
+
+        # values[begin:j + 1] <= pivot <= values[j + 1:end], and both are nonempty
+        if nth <= j:
+            end = j + 1
+        else:
+            begin = j + 1
+
+    _insertionSort(values, begin, end, less)
+
+
+def _nBest(values, begin, end, n, less):
+    """The 'n' smallest elements of values[begin:end] under 'less', sorted."""
+    n = max(0, min(n, end - begin))
+
+    if n * _STREAMING_SELECT_RATIO < end - begin:
+        res = ListOf(type(values).ElementType)()
+        res.reserve(n)
+
+        for i in range(begin, begin + n):
+            res.append(values[i])
+
+        if n:
+            _heapSelect(res, 0, n, n, less)
+
+            for i in range(begin + n, end):
+                if less(values[i], res[0]):
+                    res[0] = values[i]
+                    _siftDownMax(res, 0, 0, n, less)
+    else:
+        res = ListOf(type(values).ElementType)()
+        res.reserve(end - begin)
+
+        for i in range(begin, end):
+            res.append(values[i])
+
+        _introselect(res, 0, len(res), n, less)
+        res.resize(n)
+
+    _pdqsort(res, 0, n, less)
+
+    return res
+
+
+def _parallelNBest(values, n, less):
+    count = len(values)
+    chunkSize = _chunkSize(count)
+    chunkCount = (count + chunkSize - 1) // chunkSize
+
+    if chunkCount <= 1 or n * chunkCount >= count:
+        return _nBest(values, 0, count, n, less)
+
+    def selectChunk(chunkIx):
+        lo = chunkIx * chunkSize
+        return _nBest(values, lo, min(count, lo + chunkSize), n, less)
+
+    candidates = ListOf(type(values).ElementType)()
+
+    for chunk in pmap(_chunkIndices(chunkCount), selectChunk, ListOf(type(values).ElementType)):
+        candidates.extend(chunk)
+
+    return _nBest(candidates, 0, len(candidates), n, less)
+
+
+@Entrypoint
+def nsmallest(values, n, key=None):
+    """Return a ListOf the 'n' smallest elements of 'values', smallest first."""
+    if key is None:
+        return _nBest(values, 0, len(values), n, _lessThan)
+    else:
+        return _nBest(values, 0, len(values), n, lambda x, y: key(x) < key(y))
+
+
+@Entrypoint
+def nlargest(values, n, key=None):
+    """Return a ListOf the 'n' largest elements of 'values', largest first."""
+    if key is None:
+        return _nBest(values, 0, len(values), n, _greaterThan)
+    else:
+        return _nBest(values, 0, len(values), n, lambda x, y: key(y) < key(x))
+
+
+@Entrypoint
+def pnsmallest(values, n, key=None):
+    """'nsmallest', with the work split across the pmap thread pool."""
+    if key is None:
+        return _parallelNBest(values, n, _lessThan)
+    else:
+        return _parallelNBest(values, n, lambda x, y: key(x) < key(y))
+
+
+@Entrypoint
+def pnlargest(values, n, key=None):
+    """'nlargest', with the work split across the pmap thread pool."""
+    if key is None:
+        return _parallelNBest(values, n, _greaterThan)
+    else:
+        return _parallelNBest(values, n, lambda x, y: key(y) < key(x))
@@ -0,0 +1,171 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import heapq
+import numpy
+import pytest
+
+from typed_python import ListOf, NamedTuple, Entrypoint
+from typed_python.lib.heap import (
+    heapify, heappush, heappop, heapreplace, heappushpop, PriorityQueue,
+    nsmallest, nlargest, pnsmallest, pnlargest
+)
+
+
+Event = NamedTuple(time=float, id=int)
+
+
+def eventTime(e):
+    return e.time
+
+
+def negate(x):
+    return -x
+
+
+def test_heapq_functions_match_heapq():
+    numpy.random.seed(42)
+
+    values = [int(x) for x in numpy.random.randint(0, 1000, 500)]
+
+    heap = ListOf(int)(values)
+    heapify(heap)
+
+    # heapq can read our heaps, and pops them in the same order
+    reference = list(heap)
+    assert [heapq.heappop(reference) for _ in range(len(heap))] == sorted(values)
+
+    reference = list(values)
+    heapq.heapify(reference)
+
+    for step in range(2000):
+        x = int(numpy.random.randint(0, 1000))
+        op = step % 4
+
+        if op == 0:
+            heappush(heap, x)
+            heapq.heappush(reference, x)
+        elif op == 1:
+            assert heappop(heap) == heapq.heappop(reference)
+        elif op == 2:
+            assert heapreplace(heap, x) == heapq.heapreplace(reference, x)
+        else:
+            assert heappushpop(heap, x) == heapq.heappushpop(reference, x)
+
+        assert heap[0] == reference[0]
+
+    assert sorted(heap) == sorted(reference)
+
+    with pytest.raises(IndexError):
+        heappop(ListOf(int)())
+
+    with pytest.raises(IndexError):
+        heapreplace(ListOf(int)(), 1)
+
+    assert heappushpop(ListOf(int)(), 1) == 1
+
+
+def test_heapq_functions_with_key():
+    heap = ListOf(int)()
+
+    for x in [3, 1, 4, 1, 5, 9, 2, 6]:
+        heappush(heap, x, negate)
+
+    assert [heappop(heap, negate) for _ in range(8)] == [9, 6, 5, 4, 3, 2, 1, 1]
+
+
+def test_priority_queue():
+    numpy.random.seed(42)
+
+    queue = PriorityQueue(int)()
+    reference = []
+
+    for step in range(5000):
+        if step % 3 == 2 and reference:
+            assert queue.peek() == reference[0]
+            assert queue.pop() == heapq.heappop(reference)
+        else:
+            x = int(numpy.random.randint(0, 100))
+            queue.push(x)
+            heapq.heappush(reference, x)
+
+        assert len(queue) == len(reference)
+
+    queue.pushMany(ListOf(int)(range(1000, 0, -1)))
+    reference.extend(range(1000, 0, -1))
+
+    assert queue.popMany(len(queue) + 10) == sorted(reference)
+
+    with pytest.raises(IndexError):
+        queue.pop()
+
+    with pytest.raises(IndexError):
+        queue.peek()
+
+
+def test_priority_queue_with_key():
+    events = PriorityQueue(Event, eventTime)([Event(time=3.0, id=0), Event(time=1.0, id=1)])
+
+    events.push(Event(time=2.0, id=2))
+
+    assert events.pushPop(Event(time=0.5, id=3)).id == 3
+    assert events.replace(Event(time=5.0, id=4)).id == 1
+    assert [e.id for e in events.popMany(10)] == [2, 0, 4]
+
+
+def test_priority_queue_in_compiled_code():
+    @Entrypoint
+    def heapSort(values: ListOf(float)) -> ListOf(float):
+        queue = PriorityQueue(float)()
+
+        for v in values:
+            queue.push(v)
+
+        return queue.popMany(len(values))
+
+    values = ListOf(float)(numpy.random.uniform(size=1000))
+
+    assert heapSort(values) == sorted(values)
+
+
+@pytest.mark.parametrize("count", [0, 1, 10, 100, 10000])
+def test_nsmallest_and_nlargest(count):
+    numpy.random.seed(count)
+
+    values = ListOf(int)(numpy.random.randint(0, count // 2 + 1, count))
+
+    for n in [0, 1, 5, count // 3, count, count + 5]:
+        assert nsmallest(values, n) == heapq.nsmallest(n, values)
+        assert nlargest(values, n) == heapq.nlargest(n, values)
+        assert nsmallest(values, n, negate) == heapq.nsmallest(n, values, key=negate)
+
+
+def test_nsmallest_of_sorted_and_equal_values():
+    for values in [range(10000), range(10000, 0, -1), [7] * 10000]:
+        values = ListOf(int)(values)
+
+        assert nsmallest(values, 5000) == sorted(values)[:5000]
+        assert nlargest(values, 5000) == sorted(values, reverse=True)[:5000]
+
+
+def test_parallel_nsmallest_and_nlargest():
+    numpy.random.seed(42)
+
+    values = ListOf(float)(numpy.random.uniform(size=1000000))
+
+    for n in [1, 100, 10000]:
+        assert pnsmallest(values, n) == sorted(values)[:n]
+        assert pnlargest(values, n) == sorted(values, reverse=True)[:n]
+
+    assert pnsmallest(values, 10, negate) == nlargest(values, 10)
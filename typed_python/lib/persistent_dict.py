@@ -0,0 +1,347 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""A persistent (immutable, structurally shared) analogue of ConstDict.
+
+ConstDict keeps its items in a single sorted array, so 'd + {k: v}' copies
+the whole thing. PersistentDict keeps them in a weight-balanced binary tree
+whose nodes are never modified once built, so adding or removing a key
+copies only the O(log n) nodes on the path to it, and every older version
+remains valid and shares the rest of its nodes with the new one.
+
+Like ConstDict, iteration is in sorted key order, and the dict can't be
+modified in place: use '+' with a mapping to add or replace keys, and '-'
+with an iterable of keys to remove them.
+"""
+
+from typed_python import (
+    TypeFunction, Class, Member, Final, Entrypoint, OneOf, Generator, Tuple,
+    Forward, ListOf
+)
+
+
+# the balance parameters from Adams' weight-balanced trees. A node's
+# subtrees may differ in size by at most a factor of DELTA, and RATIO
+# picks between single and double rotations when rebalancing.
+DELTA = 3
+RATIO = 2
+
+
+@TypeFunction
+def PersistentDict(K, V):
+    Node = Forward("Node")
+
+    @Node.define
+    class Node(Class, Final):
+        key = Member(K)
+        value = Member(V)
+
+        left = Member(OneOf(None, Node), nonempty=True)
+        right = Member(OneOf(None, Node), nonempty=True)
+        count = Member(int, nonempty=True)
+
+        @staticmethod
+        def size(t: OneOf(None, Node)) -> int:
+            if t is None:
+                return 0
+            return t.count
+
+        @staticmethod
+        def make(k: K, v: V, left: OneOf(None, Node), right: OneOf(None, Node)) -> Node:
+            return Node(
+                key=k,
+                value=v,
+                left=left,
+                right=right,
+                count=1 + Node.size(left) + Node.size(right)
+            )
+
+        @staticmethod
+        def balance(k: K, v: V, left: OneOf(None, Node), right: OneOf(None, Node)) -> Node:
+            sl = Node.size(left)
+            sr = Node.size(right)
+
+            if sl + sr <= 1:
+                return Node.make(k, v, left, right)
+
+            if sr > DELTA * sl:
+                if Node.size(right.left) < RATIO * Node.size(right.right):
+                    return Node.make(right.key, right.value, Node.make(k, v, left, right.left), right.right)
+
+                rl = right.left
+                return Node.make(
+                    rl.key,
+                    rl.value,
+                    Node.make(k, v, left, rl.left),
+                    Node.make(right.key, right.value, rl.right, right.right)
+                )
+
+            if sl > DELTA * sr:
+                if Node.size(left.right) < RATIO * Node.size(left.left):
+                    return Node.make(left.key, left.value, left.left, Node.make(k, v, left.right, right))
+
+                lr = left.right
+                return Node.make(
+                    lr.key,
+                    lr.value,
+                    Node.make(left.key, left.value, left.left, lr.left),
+                    Node.make(k, v, lr.right, right)
+                )
+
+            return Node.make(k, v, left, right)
+
+        @staticmethod
+        def insert(t: OneOf(None, Node), k: K, v: V) -> Node:
+            if t is None:
+                return Node(key=k, value=v, count=1)
+
+            if k < t.key:
+                return Node.balance(t.key, t.value, Node.insert(t.left, k, v), t.right)
+
+            if t.key < k:
+                return Node.balance(t.key, t.value, t.left, Node.insert(t.right, k, v))
+
+            return Node.make(k, v, t.left, t.right)
+
+        @staticmethod
+        def removeMin(t: Node) -> OneOf(None, Node):
+            if t.left is None:
+                return t.right
+
+            return Node.balance(t.key, t.value, Node.removeMin(t.left), t.right)
+
+        @staticmethod
+        def removeMax(t: Node) -> OneOf(None, Node):
+            if t.right is None:
+                return t.left
+
+            return Node.balance(t.key, t.value, t.left, Node.removeMax(t.right))
+
+        @staticmethod
+        def glue(left: OneOf(None, Node), right: OneOf(None, Node)) -> OneOf(None, Node):
+            if left is None:
+                return right
+
+            if right is None:
+                return left
+
+            if left.count > right.count:
+                m = left.last()
+                return Node.balance(m.key, m.value, Node.removeMax(left), right)
+
+            m = right.first()
+            return Node.balance(m.key, m.value, left, Node.removeMin(right))
+
+        @staticmethod
+        def remove(t: Node, k: K) -> OneOf(None, Node):
+            """Return 't' without 'k', which must be present."""
+            if k < t.key:
+                return Node.balance(t.key, t.value, Node.remove(t.left, k), t.right)
+
+            if t.key < k:
+                return Node.balance(t.key, t.value, t.left, Node.remove(t.right, k))
+
+            return Node.glue(t.left, t.right)
+
+        def first(self) -> Node:
+            if self.left is not None:
+                return self.left.first()
+            return self
+
+        def last(self) -> Node:
+            if self.right is not None:
+                return self.right.last()
+            return self
+
+        def find(self, k: K) -> OneOf(None, Node):
+            if k < self.key:
+                if self.left is None:
+                    return None
+                return self.left.find(k)
+
+            if self.key < k:
+                if self.right is None:
+                    return None
+                return self.right.find(k)
+
+            return self
+
+        def _checkInvariants(self):
+            assert self.count == 1 + Node.size(self.left) + Node.size(self.right)
+
+            if self.count > 2:
+                assert Node.size(self.left) <= DELTA * Node.size(self.right)
+                assert Node.size(self.right) <= DELTA * Node.size(self.left)
+
+            if self.left:
+                assert self.left.key < self.key
+                self.left._checkInvariants()
+
+            if self.right:
+                assert self.key < self.right.key
+                self.right._checkInvariants()
+
+        def height(self):
+            return max(
+                1 + (0 if self.left is None else self.left.height()),
+                1 + (0 if self.right is None else self.right.height())
+            )
+
+    PersistentDict_ = Forward("PersistentDict_")
+
+    @PersistentDict_.define
+    class PersistentDict_(Class, Final):
+        _root = Member(OneOf(None, Node), nonempty=True)
+
+        def __init__(self):
+            pass
+
+        def __init__(self, other):  # noqa
+            for key in other:
+                self._root = PersistentDict_._insert(self._root, key, other[key])
+
+        @staticmethod
+        def _fromRoot(root: OneOf(None, Node)) -> PersistentDict_:
+            res = PersistentDict_()
+            res._root = root
+            return res
+
+        @Entrypoint
+        @staticmethod
+        def _insert(root: OneOf(None, Node), k: K, v: V) -> Node:
+            return Node.insert(root, k, v)
+
+        @Entrypoint
+        @staticmethod
+        def _remove(root: OneOf(None, Node), k: K) -> OneOf(None, Node):
+            if root is not None and root.find(k) is not None:
+                return Node.remove(root, k)
+            return root
+
+        def height(self):
+            if self._root is None:
+                return 0
+            return self._root.height()
+
+        def __len__(self):
+            return self._root.count if self._root is not None else 0
+
+        @Entrypoint
+        def __getitem__(self, k: K) -> V:
+            if self._root is not None:
+                node = self._root.find(k)
+                if node is not None:
+                    return node.value
+
+            raise KeyError(k)
+
+        @Entrypoint
+        def __contains__(self, k: K) -> bool:
+            return self._root is not None and self._root.find(k) is not None
+
+        @Entrypoint
+        def get(self, k: K) -> OneOf(None, V):
+            if self._root is not None:
+                node = self._root.find(k)
+                if node is not None:
+                    return node.value
+            return None
+
+        @Entrypoint
+        def get(self, k: K, v: V) -> V:  # noqa
+            if self._root is not None:
+                node = self._root.find(k)
+                if node is not None:
+                    return node.value
+            return v
+
+        def __add__(self, other) -> PersistentDict_:
+            """Return a dict with the keys of 'other' added or replaced."""
+            root = self._root
+
+            for k in other:
+                root = PersistentDict_._insert(root, k, other[k])
+
+            return PersistentDict_._fromRoot(root)
+
+        def __sub__(self, keys) -> PersistentDict_:
+            """Return a dict without any of the keys in 'keys'."""
+            root = self._root
+
+            for k in keys:
+                root = PersistentDict_._remove(root, k)
+
+            return PersistentDict_._fromRoot(root)
+
+        @Entrypoint
+        def __eq__(self, other: PersistentDict_) -> bool:
+            if len(self) != len(other):
+                return False
+
+            for k, v in self.items():
+                if k not in other or other[k] != v:
+                    return False
+
+            return True
+
+        @Entrypoint
+        def _checkInvariants(self):
+            if not self._root:
+                return
+            self._root._checkInvariants()
+
+        @Entrypoint
+        def __str__(self):
+            return '{' + ", ".join(f'{k}: {v}' for k, v in self.items()) + '}'
+
+        @Entrypoint
+        def __repr__(self):
+            return '{' + ", ".join(f'{k}: {v}' for k, v in self.items()) + '}'
+
+        @Entrypoint
+        def items(self) -> Generator(Tuple(K, V)):
+            for node in self._nodes():
+                yield (node.key, node.value)
+
+        @Entrypoint
+        def keys(self) -> Generator(K):
+            for node in self._nodes():
+                yield node.key
+
+        @Entrypoint
+        def values(self) -> Generator(V):
+            for node in self._nodes():
+                yield node.value
+
+        @Entrypoint
+        def __iter__(self) -> Generator(K):
+            for node in self._nodes():
+                yield node.key
+
+        @Entrypoint
+        def _nodes(self) -> Generator(Node):
+            # an in-order walk, so we produce keys in sorted order like ConstDict
+            stack = ListOf(Node)()
+            node = self._root
+
+            while node is not None or stack:
+                while node is not None:
+                    stack.append(node)
+                    node = node.left
+
+                top = stack.pop()
+                yield top
+                node = top.right
+
+    return PersistentDict_
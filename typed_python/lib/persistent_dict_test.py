@@ -0,0 +1,109 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import numpy
+import pytest
+import time
+from typed_python import Entrypoint, ConstDict
+from typed_python.lib.persistent_dict import PersistentDict
+
+
+def test_persistent_dict_basic():
+    T = PersistentDict(int, str)
+
+    d = T()
+
+    assert len(d) == 0
+    assert 10 not in d
+    assert d.get(10) is None
+    assert d.get(10, "x") == "x"
+
+    with pytest.raises(KeyError):
+        d[10]
+
+    d2 = d + {10: "a", 5: "b"}
+
+    assert len(d) == 0
+    assert len(d2) == 2
+    assert d2[10] == "a"
+    assert d2[5] == "b"
+    assert list(d2) == [5, 10]
+    assert list(d2.items()) == [(5, "b"), (10, "a")]
+    assert str(d2) == "{5: b, 10: a}"
+
+    d3 = d2 - [5, 11]
+
+    assert list(d3.items()) == [(10, "a")]
+    assert list(d2.items()) == [(5, "b"), (10, "a")]
+
+    assert d2 + {5: "c"} == T({5: "c", 10: "a"})
+
+
+def test_persistent_dict_matches_const_dict():
+    numpy.random.seed(42)
+
+    T = PersistentDict(int, int)
+    d = T()
+    versions = []
+    reference = {}
+
+    for i in range(2000):
+        k = int(numpy.random.choice(500))
+
+        if numpy.random.uniform() < 0.3:
+            d = d - [k]
+            reference.pop(k, None)
+        else:
+            d = d + {k: i}
+            reference[k] = i
+
+        if i % 100 == 0:
+            d._checkInvariants()
+            versions.append((d, ConstDict(int, int)(reference)))
+
+    for version, expected in versions:
+        assert list(version.items()) == list(expected.items())
+
+
+def test_persistent_dict_updates_are_logarithmic():
+    T = PersistentDict(int, int)
+
+    @Entrypoint
+    def addOneAtATime(d: T, count: int) -> T:
+        for i in range(count):
+            d = d + ConstDict(int, int)({i: i})
+        return d
+
+    @Entrypoint
+    def addOneAtATimeConst(d: ConstDict(int, int), count: int) -> ConstDict(int, int):
+        for i in range(count):
+            d = d + ConstDict(int, int)({i: i})
+        return d
+
+    addOneAtATime(T(), 10)
+    addOneAtATimeConst(ConstDict(int, int)(), 10)
+
+    t0 = time.time()
+    d = addOneAtATime(T(), 20000)
+    persistentTime = time.time() - t0
+
+    t0 = time.time()
+    addOneAtATimeConst(ConstDict(int, int)(), 20000)
+    constTime = time.time() - t0
+
+    assert len(d) == 20000
+    assert d.height() < 30
+    assert list(d) == list(range(20000))
+
+    print(f"persistent: {persistentTime}, ConstDict: {constTime}")
@@ -15,84 +15,54 @@
 """
 Utilities for running operations in parallel.
 
-We require operations to be compilable for this to work.
+We require operations to be compilable for this to work. The work runs on a
+ThreadPool (see thread_pool.py), which workers balance by stealing ranges from
+each other.
+
+preduce, pscan and pfilter split their input into chunks whose size depends
+only on its length, never on the number of threads, and combine the chunks'
+results in order. So for a given list they always group the calls to 'op' the
+same way, and float sums come out exactly the same from run to run.
 """
 
-import threading
-from typed_python import Class, Final, Member, ListOf, TypeFunction, Tuple, NotCompiled, Entrypoint, PointerTo
-from typed_python.typed_queue import TypedQueue
+from typed_python import Final, Member, TypeFunction, NotCompiled, Entrypoint, ListOf, PointerTo
+from typed_python.lib.thread_pool import ParallelTask, ThreadPool
 import os
 
-_threads = []
-
-
-isJobExecutor = threading.local()
-
-
-class Job(Class):
-    def execute(self, i: int) -> None:
-        pass
-
-
-work_queue = TypedQueue(Tuple(Job, int))()
-
 
 @TypeFunction
 def ListJob(InputT, FuncT, OutT):
-    class ListJob(Job, Final):
+    class ListJob(ParallelTask, Final):
         OutputType = OutT
 
-        outputQueue = Member(TypedQueue(int))
-        exceptionQueue = Member(TypedQueue(Tuple(int, object)))
         inputPtr = Member(PointerTo(InputT))
         isInitializedPtr = Member(PointerTo(bool))
         outputPtr = Member(PointerTo(OutT))
-        jobGranularity = Member(int)
-        maxIndex = Member(int)
         f = Member(FuncT)
 
         def __init__(self, inputPtr, f, outputPtr, isInitializedPtr, jobGranularity, maxIndex):
             self.inputPtr = inputPtr
             self.outputPtr = outputPtr
             self.isInitializedPtr = isInitializedPtr
-            self.outputQueue = TypedQueue(int)()
-            self.exceptionQueue = TypedQueue(Tuple(int, object))()
-            self.jobGranularity = jobGranularity
-            self.maxIndex = maxIndex
             self.f = f
+            self._initialize(maxIndex, jobGranularity)
 
-        def execute(self, i: int) -> None:
+        def runRange(self, lo: int, hi: int) -> None:
             try:
-                for jobIx in range(i * self.jobGranularity, min(self.maxIndex, (i + 1) * self.jobGranularity)):
+                for jobIx in range(lo, hi):
                     (self.outputPtr + jobIx).initialize(self.f(self.inputPtr[jobIx]))
                     self.isInitializedPtr[jobIx] = True
             except Exception as e:
-                self.exceptionQueue.put(Tuple(int, object)((jobIx, e)))
-
-            self.outputQueue.put(i)
+                self.recordException(jobIx, e)
 
     return ListJob
 
 
-@NotCompiled
-def isExecutorThread() -> bool:
-    return getattr(isJobExecutor, 'isExecutor', False)
-
-
-@Entrypoint
-def workExecutor():
-    isJobExecutor.isExecutor = True
-
-    while True:
-        Job, ix = work_queue.get()
-
-        if ix >= 0:
-            Job.execute(ix)
-        else:
-            return
-
-        Job = None
+_threadPool = []
 
+# the chunking used by preduce, pscan and pfilter. See the module docstring.
+_MAX_CHUNKS = 256
+_MIN_CHUNK_SIZE = 4096
 
 _maxPmapThreads = [1000]
 
@@ -102,16 +72,18 @@ def getMaxPmapThreads():
 
 
 def setMaxPmapThreads(count):
+    """Set the number of threads pmap uses. Only has an effect before the first call to pmap."""
     assert count > 0
     _maxPmapThreads[0] = count
 
 
 @NotCompiled
-def ensureThreads():
-    if not _threads:
-        for i in range(min(_maxPmapThreads[0], os.cpu_count())):
-            _threads.append(threading.Thread(target=workExecutor, daemon=True))
-            _threads[-1].start()
+def ensureThreads() -> ThreadPool:
+    """Return the ThreadPool pmap runs on, starting it if we haven't yet."""
+    if not _threadPool:
+        _threadPool.append(ThreadPool(min(_maxPmapThreads[0], os.cpu_count())))
+
+    return _threadPool[0]
 
 
 @Entrypoint
@@ -122,17 +94,13 @@ def pmap(lst, f, OutT, minGranularity=1):
         lst - a ListOf of some type
         f - a function from lst.ElementType to OutT
         OutT - the result type
-        jobGranularity - how many items we should dispatch at once.
-            If you have very small tasks, you'll spend far more time
-            locking and unlocking the queue than you will actually
-            doing work. If None, this will pick something that tries to
-            avoid creating too many jobs
         minGranularity - the smallest batch size we'll allow.
-            If this is 1, then each item in the list is a job. If
-            greater than 1, then we will do no fewer than this many
-            jobs per thread dispatch.
+            If this is 1, then each item in the list may be run on its
+            own. If greater than 1, then we will run no fewer than this
+            many items at a time. Idle threads steal work from busy ones,
+            so this mostly matters when items are very cheap.
     """
-    ensureThreads()
+    pool = ensureThreads()
 
     jobGranularity = max(1, len(lst) // (int(os.cpu_count()) * 30), minGranularity)
 
@@ -156,48 +124,12 @@ def pmap(lst, f, OutT, minGranularity=1):
         len(lst)
     )
 
-    # fill out the work queue
-    jobCount = len(lst) // jobGranularity
-
-    if jobCount * jobGranularity < len(lst):
-        jobCount += 1
-
-    for i in range(jobCount):
-        tup = Tuple(Job, int)((job, i))
-        work_queue.put(tup)
-
-    # block until the work queue is complete
-    # if we're an executor thread, then we are part of a
-    # 'recursive' pmap call, and we need to do work!
-    if isExecutorThread():
-        while True:
-            jobAndIndex = work_queue.getNonblocking()
-            if jobAndIndex is None:
-                # it's OK to block now because if
-                # there are no outstanding jobs, then
-                # all of _our_ jobs have been picked up
-                job.outputQueue.getMany(jobCount, jobCount)
-                break
-            else:
-                j = jobAndIndex[0]
-                ix = jobAndIndex[1]
-
-                if ix >= 0:
-                    j.execute(ix)
-    else:
-        # we can just block on the queue
-        job.outputQueue.getMany(jobCount, jobCount)
-
-    # check if any of our threads excepted, and if so
-    # raise the earliest one in the sequence.
-    exceptionObj = None
-    minI = len(lst)
-
-    while job.exceptionQueue:
-        i, eo = job.exceptionQueue.get()
-        if i < minI:
-            minI = i
-            exceptionObj = eo
+    # if we're a worker thread (a 'recursive' pmap call), this works on the job
+    # alongside the other threads, so we can't deadlock.
+    pool.runTask(job, len(lst))
+
+    # if any of the items raised, raise the earliest one in the sequence.
+    exceptionObj = job.exception()
 
     if exceptionObj is not None:
         # if we're raising, we need to clean up our
@@ -211,3 +143,185 @@ def pmap(lst, f, OutT, minGranularity=1):
     res.setSizeUnsafe(len(lst))
 
     return res
+
+
+@Entrypoint
+def submit(f, OutT):
+    """Call 'f()' on pmap's threads, returning a Future(OutT) for its result. See thread_pool.py."""
+    return ensureThreads().submit(f, OutT)
+
+
+@Entrypoint
+def whenAll(futures):
+    """Return a Future for a ListOf the results of a ListOf(Future(T)), once all of them finish."""
+    return ensureThreads().whenAll(futures)
+
+
+def _chunkSize(count: int) -> int:
+    return max(_MIN_CHUNK_SIZE, (count + _MAX_CHUNKS - 1) // _MAX_CHUNKS)
+
+
+def _chunkIndices(chunkCount: int) -> ListOf(int):
+    res = ListOf(int)()
+    res.reserve(chunkCount)
+
+    for i in range(chunkCount):
+        res.append(i)
+
+    return res
+
+
+def _reduceRange(lst, op, lo, hi):
+    res = lst[lo]
+
+    for i in range(lo + 1, hi):
+        res = op(res, lst[i])
+
+    return res
+
+
+@Entrypoint
+def preduce(lst, op, init):
+    """Combine 'init' and the elements of 'lst' with 'op', in parallel.
+
+    The result is the same as 'functools.reduce(op, lst, init)', except that the
+    calls to 'op' are grouped differently, so 'op' must be associative. Each chunk
+    of the list is reduced on its own, and the partial results (converted to the
+    type of 'init') are combined in order.
+
+    Example:
+        total = preduce(ListOf(float)(...), lambda x, y: x + y, 0.0)
+    """
+    count = len(lst)
+    chunkSize = _chunkSize(count)
+
+    def reduceChunk(chunkIx):
+        lo = chunkIx * chunkSize
+        return _reduceRange(lst, op, lo, min(count, lo + chunkSize))
+
+    partials = pmap(_chunkIndices((count + chunkSize - 1) // chunkSize), reduceChunk, type(init))
+
+    res = init
+
+    for partial in partials:
+        res = op(res, partial)
+
+    return res
+
+
+@Entrypoint
+def pscan(lst, op, init):
+    """Return the running combination of 'init' and the elements of 'lst' with 'op', computed in parallel.
+
+    Element i of the result is op(...op(op(init, lst[0]), lst[1])..., lst[i]), as
+    the type of 'init'. 'op' must be associative. We reduce every chunk but the last
+    to find out what each chunk starts from, and then scan the chunks in parallel.
+
+    Example:
+        prefixSums = pscan(ListOf(float)(...), lambda x, y: x + y, 0.0)
+    """
+    T = type(init)
+    count = len(lst)
+    chunkSize = _chunkSize(count)
+    chunkCount = (count + chunkSize - 1) // chunkSize
+
+    def reduceChunk(chunkIx):
+        lo = chunkIx * chunkSize
+        return _reduceRange(lst, op, lo, min(count, lo + chunkSize))
+
+    partials = pmap(_chunkIndices(max(0, chunkCount - 1)), reduceChunk, T)
+
+    starts = ListOf(T)()
+    starts.reserve(chunkCount)
+
+    acc = init
+
+    for chunkIx in range(chunkCount):
+        starts.append(acc)
+
+        if chunkIx < len(partials):
+            acc = op(acc, partials[chunkIx])
+
+    # like pmap, we construct the results in place, and have to clean up
+    # after ourselves if 'op' throws.
+    res = ListOf(T)()
+    res.reserve(count)
+    resPtr = res.pointerUnsafe(0)
+
+    written = ListOf(int)()
+    written.resize(chunkCount)
+
+    def scanChunk(chunkIx):
+        lo = chunkIx * chunkSize
+        hi = min(count, lo + chunkSize)
+        runningValue = starts[chunkIx]
+        i = lo
+
+        try:
+            while i < hi:
+                runningValue = op(runningValue, lst[i])
+                (resPtr + i).initialize(runningValue)
+                i += 1
+        finally:
+            written[chunkIx] = i - lo
+
+    try:
+        ensureThreads().parallel_for(chunkCount, scanChunk, 1)
+    except Exception:
+        for chunkIx in range(chunkCount):
+            for i in range(written[chunkIx]):
+                (resPtr + chunkIx * chunkSize + i).destroy()
+        raise
+
+    res.setSizeUnsafe(count)
+
+    return res
+
+
+@Entrypoint
+def pfilter(lst, pred):
+    """Return a ListOf(lst.ElementType) of the elements of 'lst' for which 'pred' is true, in order.
+
+    Every chunk collects the elements it keeps, and then we copy the pieces into
+    the result in parallel.
+    """
+    count = len(lst)
+    chunkSize = _chunkSize(count)
+    chunkCount = (count + chunkSize - 1) // chunkSize
+
+    def filterChunk(chunkIx):
+        kept = ListOf(lst.ElementType)()
+
+        for i in range(chunkIx * chunkSize, min(count, (chunkIx + 1) * chunkSize)):
+            if pred(lst[i]):
+                kept.append(lst[i])
+
+        return kept
+
+    pieces = pmap(_chunkIndices(chunkCount), filterChunk, ListOf(lst.ElementType))
+
+    starts = ListOf(int)()
+    starts.reserve(chunkCount)
+
+    total = 0
+
+    for piece in pieces:
+        starts.append(total)
+        total += len(piece)
+
+    res = ListOf(lst.ElementType)()
+    res.reserve(total)
+    resPtr = res.pointerUnsafe(0)
+
+    def copyChunk(chunkIx):
+        piece = pieces[chunkIx]
+        start = starts[chunkIx]
+
+        for i in range(len(piece)):
+            (resPtr + start + i).initialize(piece[i])
+
+    ensureThreads().parallel_for(chunkCount, copyChunk, 1)
+
+    res.setSizeUnsafe(total)
+
+    return res
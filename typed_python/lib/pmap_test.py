@@ -17,7 +17,7 @@ import os
 import traceback
 
 from flaky import flaky
-from typed_python.lib.pmap import pmap
+from typed_python.lib.pmap import pmap, preduce, pscan, pfilter
 from typed_python.typed_queue import TypedQueue
 from typed_python import ListOf, Entrypoint, Class, Member, Final, Tuple, refcount, NotCompiled
 import time
@@ -233,3 +233,68 @@ def test_pmap_func_refcounts():
     closure = None
 
     assert refcount(x) == 1
+
+
+def add(x, y):
+    return x + y
+
+
+def test_preduce():
+    ints = ListOf(int)(range(100000))
+
+    assert preduce(ints, add, 0) == sum(range(100000))
+    assert preduce(ints, add, 10) == sum(range(100000)) + 10
+    assert preduce(ListOf(int)(), add, 10) == 10
+    assert preduce(ListOf(int)([3]), add, 0.5) == 3.5
+
+
+def test_preduce_float_sums_are_deterministic():
+    values = ListOf(float)([(i * 7919 % 1000) * 0.001 + 1e-9 * i for i in range(1000000)])
+
+    first = preduce(values, add, 0.0)
+
+    for _ in range(5):
+        assert preduce(values, add, 0.0) == first
+
+    # we're only off from the sequential sum by the rounding error
+    assert abs(first - sum(values)) < 1e-6
+
+
+def test_preduce_combines_in_order():
+    digits = ListOf(str)([str(i % 10) for i in range(20000)])
+
+    assert preduce(digits, add, "") == "".join(digits)
+
+
+def test_pscan():
+    for count in [0, 1, 5000, 100001]:
+        ints = ListOf(int)(range(count))
+
+        expected = []
+        total = 3
+        for i in range(count):
+            total += i
+            expected.append(total)
+
+        assert pscan(ints, add, 3) == expected
+
+
+def test_pscan_with_exceptions():
+    def throwsPastAMillion(x, y):
+        if x > 1000000:
+            raise ZeroDivisionError("too big")
+        return x + y
+
+    with pytest.raises(ZeroDivisionError):
+        pscan(ListOf(int)(range(100000)), throwsPastAMillion, 0)
+
+
+def test_pfilter():
+    for count in [0, 1, 5000, 100001]:
+        ints = ListOf(int)(range(count))
+
+        assert pfilter(ints, lambda x: x % 3 == 1) == [x for x in range(count) if x % 3 == 1]
+
+    strings = ListOf(str)([str(i) for i in range(20000)])
+
+    assert pfilter(strings, lambda s: s.endswith("7")) == [s for s in strings if s.endswith("7")]
@@ -0,0 +1,369 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Regular expressions that compiled code can run without the GIL.
+
+    LOG_LINE = Regex(r"(?P<time>\\S+) (?P<level>[A-Z]+) (?P<message>.*)")
+
+    @Entrypoint
+    def errors(lines: ListOf(str)) -> ListOf(str):
+        res = ListOf(str)()
+        for line in lines:
+            m = LOG_LINE.match(line)
+            if m is not None and m.group("level") == "ERROR":
+                res.append(m.group("message"))
+        return res
+
+Calling the 're' module from compiled code goes through the interpreter for
+every match. 'Regex(pattern)' compiles the pattern once, into a program for
+the matcher in Regex.cpp, which runs directly on str (at any codepoint
+width) and bytes, and in time linear in the length of the string. It's a
+RegexOf(str) or RegexOf(bytes), with 'match', 'search', 'fullmatch',
+'findall' and 'sub' that behave like re's, and matches are MatchOf(str) or
+MatchOf(bytes).
+
+We support the parts of re's syntax that don't need backtracking, which is
+everything except backreferences, lookaround, conditionals and possessive
+or atomic repetition. Those raise ValueError, as do malformed patterns.
+Groups that repeat and can match the empty string may report a different
+(earlier) capture than re does, but the match itself is always the same.
+
+Construct patterns once (say, at module level) rather than per call:
+compiling is cheap, but it goes through the interpreter.
+"""
+
+import sys
+
+from typed_python import (
+    TypeFunction, Class, Member, Final, ListOf, Dict, OneOf, Tuple, NotCompiled
+)
+from typed_python._types import regexCompile, regexSearch
+
+# modes for regexSearch
+MATCH = 0
+SEARCH = 1
+FULLMATCH = 2
+MUST_ADVANCE = 4
+
+
+@NotCompiled
+def _compile(pattern: object, flags: int) -> Tuple(int, int, Dict(str, int)):
+    program, groupCount, groupIndex = regexCompile(pattern, flags)
+
+    return (program, groupCount, Dict(str, int)(groupIndex))
+
+
+def _codepointOfStr(c: str) -> int:
+    return ord(c)
+
+
+def _codepointOfBytes(c: bytes) -> int:
+    return c[0]
+
+
+@TypeFunction
+def MatchOf(T):
+    class MatchOf_(Class, Final, __name__=f"MatchOf({T.__name__})"):
+        """A successful match of a RegexOf(T), like re.Match."""
+        string = Member(T)
+        pos = Member(int, nonempty=True)
+        endpos = Member(int, nonempty=True)
+
+        # the start and end of the match and then of each group, or -1
+        _spans = Member(ListOf(int), nonempty=True)
+        _groupIndex = Member(Dict(str, int))
+
+        def __init__(self, string: T, pos: int, endpos: int, spans: ListOf(int), groupIndex: Dict(str, int)):
+            self.string = string
+            self.pos = pos
+            self.endpos = endpos
+            self._spans = spans
+            self._groupIndex = groupIndex
+
+        def _group(self, group: int) -> int:
+            if group < 0 or 2 * group >= len(self._spans):
+                raise IndexError("no such group")
+            return group
+
+        def _group(self, name: str) -> int:  # noqa: F811
+            if name not in self._groupIndex:
+                raise IndexError("no such group")
+            return self._groupIndex[name]
+
+        def start(self, group=0) -> int:
+            return self._spans[2 * self._group(group)]
+
+        def end(self, group=0) -> int:
+            return self._spans[2 * self._group(group) + 1]
+
+        def span(self, group=0) -> Tuple(int, int):
+            g = self._group(group)
+            return (self._spans[2 * g], self._spans[2 * g + 1])
+
+        def group(self, group=0) -> OneOf(None, T):
+            g = self._group(group)
+
+            if self._spans[2 * g] < 0:
+                return None
+
+            return self.string[self._spans[2 * g]:self._spans[2 * g + 1]]
+
+        def __getitem__(self, group) -> OneOf(None, T):
+            return self.group(group)
+
+        def groups(self) -> ListOf(OneOf(None, T)):
+            res = ListOf(OneOf(None, T))()
+
+            for g in range(1, len(self._spans) // 2):
+                res.append(self.group(g))
+
+            return res
+
+        def groupdict(self) -> Dict(str, OneOf(None, T)):
+            res = Dict(str, OneOf(None, T))()
+
+            for name, g in self._groupIndex.items():
+                res[name] = self.group(g)
+
+            return res
+
+    return MatchOf_
+
+
+@TypeFunction
+def RegexOf(T):
+    _codepoint = _codepointOfStr if T is str else _codepointOfBytes
+
+    def _literal(s):
+        return s if T is str else s.encode("ascii")
+
+    BACKSLASH = _literal("\\")
+    CLOSE_NAME = _literal(">")
+
+    # the escapes a template may use, and what they mean
+    ESCAPE_CHARS = _literal("ntrfva")
+    ESCAPE_VALUES = _literal("\n\t\r\f\v\a")
+
+    class RegexOf_(Class, Final, __name__=f"RegexOf({T.__name__})"):
+        """A compiled regular expression over T (str or bytes), like re.Pattern."""
+        pattern = Member(T)
+        flags = Member(int, nonempty=True)
+        groups = Member(int, nonempty=True)
+        groupindex = Member(Dict(str, int))
+
+        # the address of the Regex::Program
+        _program = Member(int, nonempty=True)
+
+        def __init__(self, pattern: T, flags: int = 0):
+            self.pattern = pattern
+            self.flags = flags
+            self._program, self.groups, self.groupindex = _compile(pattern, flags)
+
+        def _newSpans(self) -> ListOf(int):
+            spans = ListOf(int)()
+            spans.resize(2 * (self.groups + 1))
+            return spans
+
+        def _run(self, s: T, pos: int, endpos: int, mode: int) -> OneOf(None, MatchOf(T)):
+            spans = self._newSpans()
+
+            if not regexSearch(self._program, s, pos, endpos, mode, spans):
+                return None
+
+            return MatchOf(T)(s, pos, endpos, spans, self.groupindex)
+
+        def match(self, s: T, pos: int = 0, endpos: int = sys.maxsize) -> OneOf(None, MatchOf(T)):
+            return self._run(s, pos, endpos, MATCH)
+
+        def search(self, s: T, pos: int = 0, endpos: int = sys.maxsize) -> OneOf(None, MatchOf(T)):
+            return self._run(s, pos, endpos, SEARCH)
+
+        def fullmatch(self, s: T, pos: int = 0, endpos: int = sys.maxsize) -> OneOf(None, MatchOf(T)):
+            return self._run(s, pos, endpos, FULLMATCH)
+
+        def findall(self, s: T, pos: int = 0, endpos: int = sys.maxsize) -> ListOf(T):
+            """Like re's findall, for patterns with at most one group.
+
+            re returns tuples when there are several groups, which we can't type,
+            so we raise instead. Use 'findMatches' for those.
+            """
+            if self.groups > 1:
+                raise ValueError("findall can't return more than one group. Use findMatches.")
+
+            res = ListOf(T)()
+            spans = self._newSpans()
+            mode = SEARCH
+            g = self.groups
+
+            while regexSearch(self._program, s, pos, endpos, mode, spans):
+                if spans[2 * g] >= 0:
+                    res.append(s[spans[2 * g]:spans[2 * g + 1]])
+                else:
+                    res.append(T())
+
+                mode = SEARCH | MUST_ADVANCE if spans[0] == spans[1] else SEARCH
+                pos = spans[1]
+
+            return res
+
+        def findMatches(self, s: T, pos: int = 0, endpos: int = sys.maxsize) -> ListOf(MatchOf(T)):
+            """Every match findall would find, as a list (not an iterator, as re.finditer returns)."""
+            res = ListOf(MatchOf(T))()
+            mode = SEARCH
+
+            while True:
+                spans = self._newSpans()
+
+                if not regexSearch(self._program, s, pos, endpos, mode, spans):
+                    return res
+
+                res.append(MatchOf(T)(s, pos, endpos, spans, self.groupindex))
+
+                mode = SEARCH | MUST_ADVANCE if spans[0] == spans[1] else SEARCH
+                pos = spans[1]
+
+        def _parseTemplate(self, repl: T) -> Tuple(ListOf(T), ListOf(int)):
+            """Split a replacement template into pieces: literal text (with a group of -1)
+            or a group reference (with an empty literal)."""
+            literals = ListOf(T)()
+            groupRefs = ListOf(int)()
+
+            literalStart = 0
+            i = 0
+
+            while i < len(repl):
+                if repl[i:i + 1] != BACKSLASH:
+                    i += 1
+                    continue
+
+                if i + 1 >= len(repl):
+                    raise ValueError("bad escape (end of pattern)")
+
+                literals.append(repl[literalStart:i])
+                groupRefs.append(-1)
+
+                c = repl[i + 1:i + 2]
+                code = _codepoint(c)
+                i += 2
+
+                if code >= 48 and code <= 57:
+                    group = code - 48
+
+                    if i < len(repl) and _codepoint(repl[i:i + 1]) >= 48 and _codepoint(repl[i:i + 1]) <= 57:
+                        group = group * 10 + _codepoint(repl[i:i + 1]) - 48
+                        i += 1
+
+                    literals.append(T())
+                    groupRefs.append(self._checkGroup(group))
+                elif code == 103:
+                    # \g<name> or \g<number>
+                    if i >= len(repl) or _codepoint(repl[i:i + 1]) != 60:
+                        raise ValueError("missing < in group reference")
+
+                    close = repl.find(CLOSE_NAME, i)
+
+                    if close < 0:
+                        raise ValueError("missing >, unterminated name")
+
+                    name = repl[i + 1:close]
+                    i = close + 1
+
+                    literals.append(T())
+                    groupRefs.append(self._groupOfName(name))
+                elif c == BACKSLASH:
+                    literals.append(BACKSLASH)
+                    groupRefs.append(-1)
+                elif ESCAPE_CHARS.find(c) >= 0:
+                    k = ESCAPE_CHARS.find(c)
+                    literals.append(ESCAPE_VALUES[k:k + 1])
+                    groupRefs.append(-1)
+                elif (code >= 65 and code <= 90) or (code >= 97 and code <= 122):
+                    raise ValueError("bad escape in replacement template")
+                else:
+                    # re keeps other escapes as they are
+                    literals.append(repl[i - 2:i])
+                    groupRefs.append(-1)
+
+                literalStart = i
+
+            literals.append(repl[literalStart:])
+            groupRefs.append(-1)
+
+            return (literals, groupRefs)
+
+        def _checkGroup(self, group: int) -> int:
+            if group > self.groups:
+                raise IndexError("invalid group reference")
+            return group
+
+        def _groupOfName(self, name: str) -> int:
+            if name in self.groupindex:
+                return self.groupindex[name]
+
+            for c in name:
+                if c < "0" or c > "9":
+                    raise IndexError("unknown group name")
+
+            return self._checkGroup(int(name))
+
+        def _groupOfName(self, name: bytes) -> int:  # noqa: F811
+            return self._groupOfName(name.decode("utf8"))
+
+        def sub(self, repl: T, s: T, count: int = 0) -> T:
+            """Like re's sub, where 'repl' is a template that may refer to groups
+            as \\1 or \\g<name>. Groups that didn't participate are replaced with
+            nothing."""
+            literals, groupRefs = self._parseTemplate(repl)
+
+            pieces = ListOf(T)()
+            spans = self._newSpans()
+            mode = SEARCH
+            pos = 0
+            last = 0
+            replaced = 0
+
+            while (count == 0 or replaced < count) and regexSearch(self._program, s, pos, len(s), mode, spans):
+                pieces.append(s[last:spans[0]])
+
+                for k in range(len(literals)):
+                    g = groupRefs[k]
+
+                    if g < 0:
+                        pieces.append(literals[k])
+                    elif spans[2 * g] >= 0:
+                        pieces.append(s[spans[2 * g]:spans[2 * g + 1]])
+
+                last = spans[1]
+                mode = SEARCH | MUST_ADVANCE if spans[0] == spans[1] else SEARCH
+                pos = spans[1]
+                replaced += 1
+
+            if not replaced:
+                return s
+
+            pieces.append(s[last:])
+
+            return T().join(pieces)
+
+    return RegexOf_
+
+
+def Regex(pattern, flags=0):
+    """Compile 'pattern' (a str or bytes) into a RegexOf(str) or RegexOf(bytes).
+
+    'flags' are those of the 're' module: IGNORECASE, MULTILINE, DOTALL, VERBOSE
+    and ASCII.
+    """
+    return RegexOf(type(pattern))(pattern, flags)
@@ -0,0 +1,245 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import re
+
+import pytest
+
+from typed_python import Entrypoint, ListOf, OneOf, Tuple
+from typed_python.lib.regex import Regex, RegexOf, MatchOf
+
+
+PATTERNS = [
+    r"abc", r"a*", r"a*?b", r"(a|ab)(c|bcd)(d*)", r"(a+)(b+)?", r"^\d+$", r"\bfoo\b", r"\Bfoo",
+    r"[a-z]+", r"[^a-z]+", r"(?P<year>\d{4})-(?P<month>\d\d)", r"a{2,3}", r"a{2,3}?", r"a{,2}",
+    r"x{", r".+", r"(?s).+", r"(?m)^cd$", r"\s+", r"\w+", r"(?a)\w+", r"[\d.]+", r"(a|b)*c",
+    r"(?:ab)+", r"a|", r"$", r"a\Z", r"\x41", r"[]a]+", r"[\w-]+", r"(?i)h[aeiou]llo",
+    r"(?x) a b  # a comment", r"(?i:A)b", r"(\w+)@(\w+)\.com", r"(a)|(b)", r"(a*?)(a*)",
+]
+
+STRINGS = [
+    "", "abc", "xxabcxx", "aaab", "abcd", "12345", "123\n", "a foo b", "afoo", "ABC def",
+    "on 2023-04-05", "aaaa", "ab\ncd\nef", "a \t\nb", "héllo wörld", "v1.2.3", "ababab",
+    "mail bob@example.com now", "HELLO hullo", "b", "日本語 text 123", "emoji \U0001F600 abc",
+]
+
+
+def spansOf(m):
+    if m is None:
+        return None
+    return [m.span(g) for g in range(len(m.groups()) + 1)]
+
+
+def reSpansOf(m):
+    if m is None:
+        return None
+    return [m.span(g) for g in range(len(m.groups()) + 1)]
+
+
+@Entrypoint
+def compiledSpans(r: RegexOf(str), s: str, mode: int) -> OneOf(None, ListOf(Tuple(int, int))):
+    if mode == 0:
+        m = r.match(s)
+    elif mode == 1:
+        m = r.search(s)
+    else:
+        m = r.fullmatch(s)
+
+    if m is None:
+        return None
+
+    res = ListOf(Tuple(int, int))()
+    for g in range(r.groups + 1):
+        res.append(m.span(g))
+    return res
+
+
+def test_regex_agrees_with_re():
+    for pattern in PATTERNS:
+        ours = Regex(pattern)
+        theirs = re.compile(pattern)
+
+        assert ours.groups == theirs.groups
+        assert dict(ours.groupindex) == dict(theirs.groupindex)
+
+        for s in STRINGS:
+            for mode, name in enumerate(["match", "search", "fullmatch"]):
+                expected = reSpansOf(getattr(theirs, name)(s))
+
+                assert spansOf(getattr(ours, name)(s)) == expected, (pattern, s, name)
+
+                compiled = compiledSpans(ours, s, mode)
+                assert (None if compiled is None else [tuple(x) for x in compiled]) == expected, (pattern, s, name)
+
+
+def test_regex_on_bytes():
+    r = Regex(rb"(\w+)=(\d+)")
+
+    assert isinstance(r, RegexOf(bytes))
+
+    m = r.search(b"  key=123 ")
+    assert isinstance(m, MatchOf(bytes))
+    assert m.group(0) == b"key=123"
+    assert m.group(1) == b"key"
+    assert m.span(2) == (6, 9)
+
+    @Entrypoint
+    def values(r: RegexOf(bytes), s: bytes) -> ListOf(bytes):
+        return r.findall(s)
+
+    assert values(Regex(rb"\d+"), b"a1 b22 c333") == [b"1", b"22", b"333"]
+
+    with pytest.raises(TypeError):
+        r.search("key=123")
+
+
+def test_regex_at_every_codepoint_width():
+    r = Regex(r"(\w+)-(\d+)")
+
+    for prefix in ["", "é", "日", "\U0001F600"]:
+        s = prefix + " name-42 " + prefix
+
+        m = r.search(s)
+        assert m.span() == re.search(r"(\w+)-(\d+)", s).span()
+        assert m.group(1) == "name"
+
+        assert compiledSpans(r, s, 1)[1] == (len(prefix) + 1, len(prefix) + 5)
+
+
+def test_match_groups():
+    r = Regex(r"(?P<key>\w+)(=(?P<value>\w+))?")
+
+    m = r.match("flag")
+    assert m.group() == "flag"
+    assert m.group("key") == "flag"
+    assert m.group("value") is None
+    assert m["key"] == "flag"
+    assert m.start("value") == -1
+    assert m.groups() == ["flag", None, None]
+    assert m.groupdict() == {"key": "flag", "value": None}
+
+    with pytest.raises(IndexError):
+        m.group(4)
+
+    with pytest.raises(IndexError):
+        m.group("nope")
+
+
+def test_pos_and_endpos():
+    for pattern in [r"^a", r"a$", r"\ba", r"a"]:
+        for pos in range(4):
+            for endpos in range(4):
+                for name in ["match", "search", "fullmatch"]:
+                    expected = getattr(re.compile(pattern), name)("aaa", pos, endpos)
+                    ours = getattr(Regex(pattern), name)("aaa", pos, endpos)
+
+                    assert spansOf(ours) == reSpansOf(expected), (pattern, pos, endpos, name)
+
+
+def test_findall():
+    for pattern, s in [
+        (r"\d+", "a1b22c333"), (r"a*|b", "b"), (r"x*", "abxd"), (r"(\w)\d", "a1 b2 cc"),
+        (r"(a)|b", "ab"), (r"", "abc"), (r"\b", "one two"),
+    ]:
+        assert Regex(pattern).findall(s) == re.findall(pattern, s), (pattern, s)
+
+    @Entrypoint
+    def findallCompiled(r: RegexOf(str), s: str) -> ListOf(str):
+        return r.findall(s)
+
+    assert findallCompiled(Regex(r"a*|b"), "baab") == re.findall(r"a*|b", "baab")
+
+    with pytest.raises(ValueError):
+        Regex(r"(a)(b)").findall("ab")
+
+    assert [m.span() for m in Regex(r"(a)(b)").findMatches("abab")] == [(0, 2), (2, 4)]
+
+
+def test_sub():
+    for pattern, repl, s in [
+        (r"\d+", "#", "a1b22c333"),
+        (r"x*", "-", "abxd"),
+        (r"(\w+)@(\w+)", r"\2 at \1", "bob@home, al@work"),
+        (r"(?P<k>\w+)=(?P<v>\w+)", r"\g<v>:\g<k>\n", "a=1 b=2"),
+        (r"(a)|b", r"[\1]", "ab"),
+        (r"a", r"\\", "aa"),
+        (r"a", r"\g<0>\g<0>", "banana"),
+        (r"nothing", "x", "unchanged"),
+    ]:
+        assert Regex(pattern).sub(repl, s) == re.sub(pattern, repl, s), (pattern, repl, s)
+
+    assert Regex(r"a").sub("b", "aaaa", 2) == "bbaa"
+    assert Regex(rb"\s+").sub(b" ", b"a  b\t\tc") == b"a b c"
+
+    @Entrypoint
+    def subCompiled(r: RegexOf(str), repl: str, s: str) -> str:
+        return r.sub(repl, s)
+
+    assert subCompiled(Regex(r"(\d+)"), r"<\1>", "a1b22") == "a<1>b<22>"
+
+    with pytest.raises(IndexError):
+        Regex(r"(a)").sub(r"\2", "a")
+
+    with pytest.raises(ValueError):
+        Regex(r"(a)").sub(r"\q", "a")
+
+
+def test_flags():
+    assert Regex("HELLO", re.IGNORECASE).match("hello") is not None
+    assert Regex("^b$", re.MULTILINE).search("a\nb\nc").span() == (2, 3)
+    assert Regex("a.b", re.DOTALL).match("a\nb") is not None
+    assert Regex(r"\w+", re.ASCII).match("héllo").span() == (0, 1)
+    assert Regex(r"\d", re.ASCII).match("١") is None
+    assert Regex(r"\d").match("١") is not None
+
+
+def test_unsupported_and_malformed_patterns():
+    for pattern in [r"(a)\1", r"(?=a)", r"(?<!a)b", r"(?P<n>a)(?P=n)", r"a++", r"(?>a)"]:
+        with pytest.raises(ValueError):
+            Regex(pattern)
+
+    for pattern in [r"(", r")", r"[a", r"a**", r"*a", r"\q", r"a{3,2}", r"(?P<1>a)", r"a(?i)b"]:
+        with pytest.raises(re.error):
+            re.compile(pattern)
+
+        with pytest.raises(ValueError):
+            Regex(pattern)
+
+
+def test_compiling_a_pattern_twice_reuses_it():
+    assert Regex(r"\d+")._program == Regex(r"\d+")._program
+    assert Regex(r"\d+")._program != Regex(r"\d+", re.ASCII)._program
+
+
+def test_parse_log_lines():
+    LOG_LINE = Regex(r"(?P<time>\S+) (?P<level>[A-Z]+) (?P<message>.*)")
+
+    @Entrypoint
+    def errors(lines: ListOf(str)) -> ListOf(str):
+        res = ListOf(str)()
+        for line in lines:
+            m = LOG_LINE.match(line)
+            if m is not None and m.group("level") == "ERROR":
+                res.append(m.group("message"))
+        return res
+
+    lines = ["12:00:01 INFO started", "12:00:02 ERROR disk full", "garbage", "12:00:03 ERROR ünïcode"]
+
+    assert errors(lines) == ["disk full", "ünïcode"]
+
+
+def test_matching_is_linear():
+    # catastrophic for a backtracking engine
+    assert Regex(r"(a*)*b").match("a" * 100000) is None
+    assert Regex(r"(x+x+)+y").search("x" * 10000) is None
@@ -0,0 +1,615 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A compressed set of ints, for big sets of ids.
+
+A Set(int) spends 20-odd bytes on every member between its item table and its
+hashtable. A RoaringBitmap splits its members by their upper 48 bits into
+containers of at most 65536 values, and stores each container as either
+
+    a sorted ListOf(UInt16) of the low 16 bits, when it has at most
+    ARRAY_MAX_SIZE members, which is 2 bytes per member, or
+
+    a 65536 bit bitmap, when it has more, which is 8kb no matter how full.
+
+So a set that's dense in places costs well under a byte per member there, and
+a sparse one costs about 2. This is the layout from Lemire et al's "Roaring
+Bitmaps".
+
+Usage:
+
+    ids = RoaringBitmap(ListOf(int)(someIds))
+    ids.add(123)
+
+    123 in ids
+    allowed = ids & entitled     # also '|' and '-'
+    ids.rank(1000)               # how many members are <= 1000
+    ids.select(10)               # the 11th smallest member
+
+Operations between bitmap containers are word-at-a-time loops over
+ListOf(UInt64) that llvm vectorizes. Containers switch representation as they
+cross ARRAY_MAX_SIZE, so they always use the smaller one.
+
+A RoaringBitmap is an ordinary Class of ListOfs, so it serializes with the
+rest of typed_python, and a SerializationContext that writes POD lists inline
+writes each container as its raw bytes.
+"""
+
+from typed_python import Class, Final, Member, Forward, ListOf, UInt16, UInt64, Entrypoint
+from typed_python.lib.bitset import popcount, countTrailingZeros
+
+
+# containers with more members than this are stored as bitmaps
+ARRAY_MAX_SIZE = 4096
+
+# the number of UInt64 words in a bitmap container
+BITMAP_WORDS = 1024
+
+
+def _lowerBound(values: ListOf(UInt16), low: int) -> int:
+    """Return the index of the first of the sorted 'values' that's >= 'low'."""
+    lo = 0
+    hi = len(values)
+
+    while lo < hi:
+        mid = (lo + hi) >> 1
+
+        if int(values[mid]) < low:
+            lo = mid + 1
+        else:
+            hi = mid
+
+    return lo
+
+
+def _countWords(words: ListOf(UInt64)) -> int:
+    res = 0
+    p = words.pointerUnsafe(0)
+
+    for i in range(len(words)):
+        res += popcount(p[i])
+
+    return res
+
+
+RoaringContainer = Forward("RoaringContainer")
+
+
+@RoaringContainer.define
+class RoaringContainer(Class, Final):
+    """The members of a RoaringBitmap that share their upper 48 bits, as their low 16 bits.
+
+    Exactly one of 'values' (a sorted array) and 'words' (a bitmap of
+    BITMAP_WORDS words) is nonempty, unless the container is empty.
+    """
+    values = Member(ListOf(UInt16), nonempty=True)
+    words = Member(ListOf(UInt64), nonempty=True)
+    count = Member(int, nonempty=True)
+
+    def isBitmap(self) -> bool:
+        return len(self.words) > 0
+
+    @Entrypoint
+    def __contains__(self, low: int) -> bool:
+        if self.isBitmap():
+            return (self.words[low >> 6] >> UInt64(low & 63)) & UInt64(1) != UInt64(0)
+
+        ix = _lowerBound(self.values, low)
+
+        return ix < len(self.values) and int(self.values[ix]) == low
+
+    @Entrypoint
+    def add(self, low: int) -> bool:
+        """Add 'low', returning whether it's new."""
+        if self.isBitmap():
+            bit = UInt64(1) << UInt64(low & 63)
+
+            if self.words[low >> 6] & bit:
+                return False
+
+            self.words[low >> 6] |= bit
+            self.count += 1
+            return True
+
+        ix = _lowerBound(self.values, low)
+
+        if ix < len(self.values) and int(self.values[ix]) == low:
+            return False
+
+        if len(self.values) >= ARRAY_MAX_SIZE:
+            self._toBitmap()
+            return self.add(low)
+
+        self.values.append(UInt16(0))
+
+        p = self.values.pointerUnsafe(0)
+        i = len(self.values) - 1
+
+        while i > ix:
+            p[i] = p[i - 1]
+            i -= 1
+
+        p[ix] = UInt16(low)
+        self.count += 1
+
+        return True
+
+    @Entrypoint
+    def discard(self, low: int) -> bool:
+        """Remove 'low', returning whether it was there."""
+        if self.isBitmap():
+            bit = UInt64(1) << UInt64(low & 63)
+
+            if not (self.words[low >> 6] & bit):
+                return False
+
+            self.words[low >> 6] &= ~bit
+            self.count -= 1
+            self._normalize()
+            return True
+
+        ix = _lowerBound(self.values, low)
+
+        if ix == len(self.values) or int(self.values[ix]) != low:
+            return False
+
+        p = self.values.pointerUnsafe(0)
+
+        for i in range(ix, len(self.values) - 1):
+            p[i] = p[i + 1]
+
+        self.values.resize(len(self.values) - 1)
+        self.count -= 1
+
+        return True
+
+    def _toBitmap(self) -> None:
+        words = ListOf(UInt64)()
+        words.resize(BITMAP_WORDS)
+
+        for v in self.values:
+            words[int(v) >> 6] |= UInt64(1) << UInt64(int(v) & 63)
+
+        self.words = words
+        self.values = ListOf(UInt16)()
+
+    def _toArray(self) -> None:
+        values = ListOf(UInt16)()
+        values.reserve(self.count)
+
+        for wordIx in range(len(self.words)):
+            word = self.words[wordIx]
+
+            while word:
+                values.append(UInt16(wordIx * 64 + countTrailingZeros(word)))
+                word &= word - UInt64(1)
+
+        self.values = values
+        self.words = ListOf(UInt64)()
+
+    def _normalize(self) -> None:
+        """Switch to whichever representation is right for our count."""
+        if self.isBitmap() and self.count <= ARRAY_MAX_SIZE:
+            self._toArray()
+        elif not self.isBitmap() and self.count > ARRAY_MAX_SIZE:
+            self._toBitmap()
+
+    @Entrypoint
+    def rank(self, low: int) -> int:
+        """The number of members <= 'low'."""
+        if not self.isBitmap():
+            return _lowerBound(self.values, low + 1)
+
+        p = self.words.pointerUnsafe(0)
+        res = 0
+
+        for i in range(low >> 6):
+            res += popcount(p[i])
+
+        if low & 63 == 63:
+            return res + popcount(p[low >> 6])
+
+        return res + popcount(p[low >> 6] & ((UInt64(1) << UInt64((low & 63) + 1)) - UInt64(1)))
+
+    @Entrypoint
+    def select(self, i: int) -> int:
+        """The i'th smallest member, counting from zero."""
+        if not self.isBitmap():
+            return int(self.values[i])
+
+        for wordIx in range(len(self.words)):
+            word = self.words[wordIx]
+            inWord = popcount(word)
+
+            if i < inWord:
+                for _ in range(i):
+                    word &= word - UInt64(1)
+
+                return wordIx * 64 + countTrailingZeros(word)
+
+            i -= inWord
+
+        raise IndexError("RoaringContainer.select index out of range")
+
+    @Entrypoint
+    def appendTo(self, res: ListOf(int), base: int) -> None:
+        """Append 'base | v' to 'res' for each of our members v, in order."""
+        if not self.isBitmap():
+            for v in self.values:
+                res.append(base | int(v))
+            return
+
+        for wordIx in range(len(self.words)):
+            word = self.words[wordIx]
+
+            while word:
+                res.append(base | (wordIx * 64 + countTrailingZeros(word)))
+                word &= word - UInt64(1)
+
+    @Entrypoint
+    def copy(self) -> RoaringContainer:
+        res = RoaringContainer()
+        res.values = ListOf(UInt16)(self.values)
+        res.words = ListOf(UInt64)(self.words)
+        res.count = self.count
+        return res
+
+    def __eq__(self, other: RoaringContainer) -> bool:
+        return self.count == other.count and self.values == other.values and self.words == other.words
+
+
+@Entrypoint
+def _containerOr(a: RoaringContainer, b: RoaringContainer) -> RoaringContainer:
+    if not a.isBitmap() and not b.isBitmap():
+        res = RoaringContainer()
+        res.values.reserve(len(a.values) + len(b.values))
+
+        i = 0
+        j = 0
+
+        while i < len(a.values) and j < len(b.values):
+            if a.values[i] < b.values[j]:
+                res.values.append(a.values[i])
+                i += 1
+            elif b.values[j] < a.values[i]:
+                res.values.append(b.values[j])
+                j += 1
+            else:
+                res.values.append(a.values[i])
+                i += 1
+                j += 1
+
+        while i < len(a.values):
+            res.values.append(a.values[i])
+            i += 1
+
+        while j < len(b.values):
+            res.values.append(b.values[j])
+            j += 1
+
+        res.count = len(res.values)
+        res._normalize()
+        return res
+
+    if not a.isBitmap():
+        return _containerOr(b, a)
+
+    res = a.copy()
+    words = res.words.pointerUnsafe(0)
+
+    if b.isBitmap():
+        otherWords = b.words.pointerUnsafe(0)
+
+        for i in range(BITMAP_WORDS):
+            words[i] |= otherWords[i]
+    else:
+        for v in b.values:
+            words[int(v) >> 6] |= UInt64(1) << UInt64(int(v) & 63)
+
+    res.count = _countWords(res.words)
+    return res
+
+
+@Entrypoint
+def _containerAnd(a: RoaringContainer, b: RoaringContainer) -> RoaringContainer:
+    res = RoaringContainer()
+
+    if a.isBitmap() and b.isBitmap():
+        res.words = ListOf(UInt64)(a.words)
+
+        words = res.words.pointerUnsafe(0)
+        otherWords = b.words.pointerUnsafe(0)
+
+        for i in range(BITMAP_WORDS):
+            words[i] &= otherWords[i]
+
+        res.count = _countWords(res.words)
+        res._normalize()
+        return res
+
+    if a.isBitmap():
+        return _containerAnd(b, a)
+
+    # 'a' is an array, so the result is one too
+    if b.isBitmap():
+        for v in a.values:
+            if int(v) in b:
+                res.values.append(v)
+    else:
+        i = 0
+        j = 0
+
+        while i < len(a.values) and j < len(b.values):
+            if a.values[i] < b.values[j]:
+                i += 1
+            elif b.values[j] < a.values[i]:
+                j += 1
+            else:
+                res.values.append(a.values[i])
+                i += 1
+                j += 1
+
+    res.count = len(res.values)
+    return res
+
+
+@Entrypoint
+def _containerAndNot(a: RoaringContainer, b: RoaringContainer) -> RoaringContainer:
+    if not a.isBitmap():
+        res = RoaringContainer()
+
+        for v in a.values:
+            if int(v) not in b:
+                res.values.append(v)
+
+        res.count = len(res.values)
+        return res
+
+    res = a.copy()
+    words = res.words.pointerUnsafe(0)
+
+    if b.isBitmap():
+        otherWords = b.words.pointerUnsafe(0)
+
+        for i in range(BITMAP_WORDS):
+            words[i] &= ~otherWords[i]
+    else:
+        for v in b.values:
+            words[int(v) >> 6] &= ~(UInt64(1) << UInt64(int(v) & 63))
+
+    res.count = _countWords(res.words)
+    res._normalize()
+    return res
+
+
+RoaringBitmap = Forward("RoaringBitmap")
+
+
+@RoaringBitmap.define
+class RoaringBitmap(Class, Final):
+    """A compressed set of ints. See the module docstring."""
+
+    # the upper 48 bits of the members of each container, in increasing order
+    _keys = Member(ListOf(int), nonempty=True)
+    _containers = Member(ListOf(RoaringContainer), nonempty=True)
+    _count = Member(int, nonempty=True)
+
+    def __init__(self):
+        pass
+
+    def __init__(self, values):  # noqa: F811
+        self.update(ListOf(int)(values))
+
+    def __len__(self) -> int:
+        return self._count
+
+    def _keyIndex(self, key: int) -> int:
+        """Return the index of the first of our keys that's >= 'key'."""
+        lo = 0
+        hi = len(self._keys)
+
+        while lo < hi:
+            mid = (lo + hi) >> 1
+
+            if self._keys[mid] < key:
+                lo = mid + 1
+            else:
+                hi = mid
+
+        return lo
+
+    def _append(self, key: int, container: RoaringContainer) -> None:
+        if container.count:
+            self._keys.append(key)
+            self._containers.append(container)
+            self._count += container.count
+
+    @Entrypoint
+    def __contains__(self, x: int) -> bool:
+        ix = self._keyIndex(x >> 16)
+
+        return ix < len(self._keys) and self._keys[ix] == x >> 16 and (x & 0xFFFF) in self._containers[ix]
+
+    @Entrypoint
+    def add(self, x: int) -> None:
+        key = x >> 16
+        ix = self._keyIndex(key)
+
+        if ix == len(self._keys) or self._keys[ix] != key:
+            self._keys.append(key)
+            self._containers.append(RoaringContainer())
+
+            i = len(self._keys) - 1
+
+            while i > ix:
+                self._keys[i] = self._keys[i - 1]
+                self._containers[i] = self._containers[i - 1]
+                i -= 1
+
+            self._keys[ix] = key
+            self._containers[ix] = RoaringContainer()
+
+        if self._containers[ix].add(x & 0xFFFF):
+            self._count += 1
+
+    @Entrypoint
+    def update(self, values: ListOf(int)) -> None:
+        for x in values:
+            self.add(x)
+
+    @Entrypoint
+    def discard(self, x: int) -> None:
+        key = x >> 16
+        ix = self._keyIndex(key)
+
+        if ix == len(self._keys) or self._keys[ix] != key:
+            return
+
+        if not self._containers[ix].discard(x & 0xFFFF):
+            return
+
+        self._count -= 1
+
+        if self._containers[ix].count == 0:
+            for i in range(ix, len(self._keys) - 1):
+                self._keys[i] = self._keys[i + 1]
+                self._containers[i] = self._containers[i + 1]
+
+            self._keys.resize(len(self._keys) - 1)
+            self._containers.resize(len(self._containers) - 1)
+
+    @Entrypoint
+    def rank(self, x: int) -> int:
+        """The number of members <= 'x'."""
+        key = x >> 16
+        res = 0
+
+        for i in range(len(self._keys)):
+            if self._keys[i] < key:
+                res += self._containers[i].count
+            elif self._keys[i] == key:
+                return res + self._containers[i].rank(x & 0xFFFF)
+            else:
+                return res
+
+        return res
+
+    @Entrypoint
+    def select(self, i: int) -> int:
+        """The i'th smallest member, counting from zero."""
+        if i < 0 or i >= self._count:
+            raise IndexError("RoaringBitmap.select index out of range")
+
+        for ix in range(len(self._keys)):
+            container = self._containers[ix]
+
+            if i < container.count:
+                return (self._keys[ix] << 16) | container.select(i)
+
+            i -= container.count
+
+        raise IndexError("RoaringBitmap.select index out of range")
+
+    @Entrypoint
+    def toList(self) -> ListOf(int):
+        """Return our members in increasing order."""
+        res = ListOf(int)()
+        res.reserve(self._count)
+
+        for ix in range(len(self._keys)):
+            self._containers[ix].appendTo(res, self._keys[ix] << 16)
+
+        return res
+
+    def __iter__(self):
+        return iter(self.toList())
+
+    @Entrypoint
+    def __or__(self, other: RoaringBitmap) -> RoaringBitmap:
+        res = RoaringBitmap()
+        i = 0
+        j = 0
+
+        while i < len(self._keys) and j < len(other._keys):
+            if self._keys[i] < other._keys[j]:
+                res._append(self._keys[i], self._containers[i].copy())
+                i += 1
+            elif other._keys[j] < self._keys[i]:
+                res._append(other._keys[j], other._containers[j].copy())
+                j += 1
+            else:
+                res._append(self._keys[i], _containerOr(self._containers[i], other._containers[j]))
+                i += 1
+                j += 1
+
+        while i < len(self._keys):
+            res._append(self._keys[i], self._containers[i].copy())
+            i += 1
+
+        while j < len(other._keys):
+            res._append(other._keys[j], other._containers[j].copy())
+            j += 1
+
+        return res
+
+    @Entrypoint
+    def __and__(self, other: RoaringBitmap) -> RoaringBitmap:
+        res = RoaringBitmap()
+        i = 0
+        j = 0
+
+        while i < len(self._keys) and j < len(other._keys):
+            if self._keys[i] < other._keys[j]:
+                i += 1
+            elif other._keys[j] < self._keys[i]:
+                j += 1
+            else:
+                res._append(self._keys[i], _containerAnd(self._containers[i], other._containers[j]))
+                i += 1
+                j += 1
+
+        return res
+
+    @Entrypoint
+    def __sub__(self, other: RoaringBitmap) -> RoaringBitmap:
+        res = RoaringBitmap()
+        j = 0
+
+        for i in range(len(self._keys)):
+            while j < len(other._keys) and other._keys[j] < self._keys[i]:
+                j += 1
+
+            if j < len(other._keys) and other._keys[j] == self._keys[i]:
+                res._append(self._keys[i], _containerAndNot(self._containers[i], other._containers[j]))
+            else:
+                res._append(self._keys[i], self._containers[i].copy())
+
+        return res
+
+    @Entrypoint
+    def __eq__(self, other: RoaringBitmap) -> bool:
+        if self._count != other._count or self._keys != other._keys:
+            return False
+
+        # containers are always in the representation their count calls for,
+        # so equal sets have equal containers
+        for i in range(len(self._containers)):
+            if not (self._containers[i] == other._containers[i]):
+                return False
+
+        return True
+
+    def __repr__(self) -> str:
+        return f"RoaringBitmap({list(self.toList())})"
@@ -0,0 +1,126 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import random
+
+import pytest
+
+from typed_python import Entrypoint, ListOf, SerializationContext
+from typed_python.lib.roaring import RoaringBitmap, ARRAY_MAX_SIZE
+
+
+def someIds(seed, count, spread):
+    r = random.Random(seed)
+    return [r.randrange(-spread, spread) for _ in range(count)]
+
+
+def test_roaring_bitmap_basic():
+    ids = RoaringBitmap()
+
+    assert len(ids) == 0
+    assert 5 not in ids
+
+    for x in [5, 3, 70000, -1, 5]:
+        ids.add(x)
+
+    assert len(ids) == 4
+    assert ids.toList() == [-1, 3, 5, 70000]
+    assert 70000 in ids and -1 in ids and 70001 not in ids
+
+    ids.discard(3)
+    ids.discard(4)
+
+    assert ids.toList() == [-1, 5, 70000]
+    assert list(ids) == [-1, 5, 70000]
+
+
+def test_roaring_bitmap_containers_switch_representation():
+    ids = RoaringBitmap(ListOf(int)(range(ARRAY_MAX_SIZE)))
+
+    assert not ids._containers[0].isBitmap()
+
+    ids.add(ARRAY_MAX_SIZE)
+    assert ids._containers[0].isBitmap()
+
+    ids.discard(0)
+    assert not ids._containers[0].isBitmap()
+
+    assert ids.toList() == list(range(1, ARRAY_MAX_SIZE + 1))
+
+
+@pytest.mark.parametrize('spread', [100, 10000, 1000000])
+def test_roaring_bitmap_matches_set(spread):
+    left = someIds(1, 20000, spread)
+    right = someIds(2, 20000, spread)
+
+    a = RoaringBitmap(ListOf(int)(left))
+    b = RoaringBitmap(ListOf(int)(right))
+
+    assert a.toList() == sorted(set(left))
+    assert len(a) == len(set(left))
+
+    assert (a | b).toList() == sorted(set(left) | set(right))
+    assert (a & b).toList() == sorted(set(left) & set(right))
+    assert (a - b).toList() == sorted(set(left) - set(right))
+    assert (b - a).toList() == sorted(set(right) - set(left))
+
+    assert a | b == b | a
+    assert a & b == b & a
+    assert a - a == RoaringBitmap()
+
+    for x in someIds(3, 1000, spread):
+        assert (x in a) == (x in set(left))
+
+
+def test_roaring_bitmap_rank_and_select():
+    values = sorted(set(someIds(4, 50000, 100000)))
+    ids = RoaringBitmap(ListOf(int)(values))
+
+    for i in range(0, len(values), 97):
+        assert ids.select(i) == values[i]
+        assert ids.rank(values[i]) == i + 1
+        assert ids.rank(values[i] - 1) == i
+
+    assert ids.rank(-10 ** 9) == 0
+    assert ids.rank(10 ** 9) == len(values)
+
+    with pytest.raises(IndexError):
+        ids.select(len(values))
+
+
+def test_roaring_bitmap_is_compact():
+    dense = RoaringBitmap(ListOf(int)(range(1000000)))
+
+    sc = SerializationContext().withSerializePodListsInline()
+
+    # sixteen full bitmaps, about a bit per member
+    assert len(sc.serialize(dense)) < 1000000 // 8 * 1.1
+
+    assert sc.deserialize(sc.serialize(dense)) == dense
+
+
+def test_roaring_bitmap_compiled():
+    @Entrypoint
+    def countIn(ids: RoaringBitmap, values: ListOf(int)) -> int:
+        res = 0
+
+        for x in values:
+            if x in ids:
+                res += 1
+
+        return res
+
+    ids = RoaringBitmap(ListOf(int)(range(0, 100000, 3)))
+
+    assert countIn(ids, ListOf(int)(range(100000))) == len(range(0, 100000, 3))
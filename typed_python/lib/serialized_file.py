@@ -0,0 +1,218 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""A random-access file of serialized records.
+
+The file is a header, the records themselves (each one exactly what
+'serialize(T, record, serializationContext)' produces), an index of where
+each record starts, and a fixed-size footer pointing at the index:
+
+    MAGIC
+    record 0
+    ...
+    record n-1
+    index: n + 1 little-endian uint64 offsets (the last is where the index starts)
+    footer: uint64 index offset, uint64 record count, MAGIC
+
+Opening the file mmaps it and reads nothing but the footer. Indexing
+deserializes just the requested record, in place, out of the mapping, so
+touching a few records of a huge archive only pages in those records.
+"""
+
+import array
+import mmap
+import struct
+import sys
+
+from typed_python import TypeFunction, Class, Member, Final, Generator, ListOf, OneOf, serialize
+from typed_python.lib.bytes_view import BytesView
+
+
+MAGIC = b"TPSERFL1"
+FOOTER = struct.Struct("<QQ8s")
+
+
+def _checkByteOrder():
+    # the index is read straight out of the mapping as native uint64s
+    if sys.byteorder != "little":
+        raise OSError("SerializedFile requires a little-endian machine")
+
+
+@TypeFunction
+def SerializedFile(T):
+    class SerializedFileWriter(Class, Final):
+        """Appends records of type T to a new SerializedFile."""
+        _file = Member(object)
+        _serializationContext = Member(object)
+        _offsets = Member(ListOf(int))
+        _position = Member(int, nonempty=True)
+
+        def __init__(self, path, serializationContext=None):
+            _checkByteOrder()
+
+            self._file = open(path, "wb")
+            self._serializationContext = serializationContext
+            self._file.write(MAGIC)
+            self._position = len(MAGIC)
+
+        def append(self, record: T) -> None:
+            if self._file is None:
+                raise ValueError("SerializedFile writer is already closed")
+
+            data = serialize(T, record, self._serializationContext)
+
+            self._file.write(data)
+            self._offsets.append(self._position)
+            self._position += len(data)
+
+        def close(self) -> None:
+            if self._file is None:
+                return
+
+            index = array.array("Q", self._offsets)
+            index.append(self._position)
+
+            self._file.write(index.tobytes())
+            self._file.write(FOOTER.pack(self._position, len(self._offsets), MAGIC))
+            self._file.close()
+            self._file = None
+
+        def __enter__(self):
+            return self
+
+        def __exit__(self, excType, excValue, traceback) -> bool:
+            self.close()
+            return False
+
+    class SerializedFile_(Class, Final):
+        """A read-only, random-access view of a file of records of type T.
+
+        Usage:
+
+            with SerializedFile(Trade).writer(path) as w:
+                for t in trades:
+                    w.append(t)
+
+            f = SerializedFile(Trade).open(path)
+            f[len(f) // 2]
+
+        The records must be read with a SerializationContext that's compatible
+        with the one they were written with.
+        """
+        _file = Member(object)
+        _mmap = Member(object)
+        _view = Member(OneOf(None, BytesView))
+        _index = Member(object)
+        _serializationContext = Member(object)
+        _count = Member(int, nonempty=True)
+
+        @staticmethod
+        def writer(path, serializationContext=None):
+            """Create (or truncate) 'path' and return a writer to append records to it."""
+            return SerializedFileWriter(path, serializationContext)
+
+        @staticmethod
+        def write(path, records, serializationContext=None):
+            """Write every record in 'records' to a new file at 'path'."""
+            with SerializedFileWriter(path, serializationContext) as w:
+                for r in records:
+                    w.append(r)
+
+        @staticmethod
+        def open(path, serializationContext=None):
+            return SerializedFile_(path, serializationContext)
+
+        def __init__(self, path, serializationContext=None):
+            _checkByteOrder()
+
+            self._file = open(path, "rb")
+
+            try:
+                self._mmap = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+            except ValueError:
+                # mmap refuses empty files, which can't be valid anyway
+                self._file.close()
+                raise ValueError(f"{path} is not a SerializedFile")
+
+            size = len(self._mmap)
+
+            if size < len(MAGIC) + FOOTER.size or self._mmap[:len(MAGIC)] != MAGIC:
+                self.close()
+                raise ValueError(f"{path} is not a SerializedFile")
+
+            indexOffset, count, magic = FOOTER.unpack_from(self._mmap, size - FOOTER.size)
+
+            if magic != MAGIC or indexOffset + 8 * (count + 1) != size - FOOTER.size:
+                self.close()
+                raise ValueError(f"{path} is not a SerializedFile, or it was never closed")
+
+            self._count = count
+            self._index = memoryview(self._mmap)[indexOffset:indexOffset + 8 * (count + 1)].cast("Q")
+            self._view = BytesView(self._mmap)
+            self._serializationContext = serializationContext
+
+        def __len__(self) -> int:
+            return self._count
+
+        def __getitem__(self, i: int) -> T:
+            if i < 0:
+                i += self._count
+
+            if i < 0 or i >= self._count:
+                raise IndexError("SerializedFile index out of range")
+
+            start = int(self._index[i])
+            stop = int(self._index[i + 1])
+
+            return self._view.slice(start, stop).deserialize(T, self._serializationContext)
+
+        def __iter__(self) -> Generator(T):
+            for i in range(self._count):
+                yield self[i]
+
+        def recordBytes(self, i: int) -> BytesView:
+            """Return a view of the serialized bytes of record 'i', without deserializing it."""
+            if i < 0:
+                i += self._count
+
+            if i < 0 or i >= self._count:
+                raise IndexError("SerializedFile index out of range")
+
+            return self._view.slice(int(self._index[i]), int(self._index[i + 1]))
+
+        def close(self) -> None:
+            # the index and the view both hold exports of the mapping, which
+            # have to go before it can be closed
+            if self._index is not None:
+                self._index.release()
+                self._index = None
+
+            self._view = None
+
+            if self._mmap is not None:
+                self._mmap.close()
+                self._mmap = None
+
+            if self._file is not None:
+                self._file.close()
+                self._file = None
+
+        def __enter__(self):
+            return self
+
+        def __exit__(self, excType, excValue, traceback) -> bool:
+            self.close()
+            return False
+
+    return SerializedFile_
@@ -0,0 +1,111 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+import pytest
+import tempfile
+from typed_python import Entrypoint, NamedTuple, ListOf, SerializationContext
+from typed_python.lib.serialized_file import SerializedFile
+
+
+Trade = NamedTuple(symbol=str, price=float, size=int)
+
+
+def makeTrades(count):
+    return [Trade(symbol="S%s" % (i % 7), price=i * 0.5, size=i) for i in range(count)]
+
+
+def test_serialized_file_round_trip():
+    trades = makeTrades(1000)
+
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "trades")
+
+        with SerializedFile(Trade).writer(path) as w:
+            for t in trades:
+                w.append(t)
+
+        with SerializedFile(Trade).open(path) as f:
+            assert len(f) == 1000
+            assert f[0] == trades[0]
+            assert f[500] == trades[500]
+            assert f[-1] == trades[-1]
+            assert list(f) == trades
+
+            with pytest.raises(IndexError):
+                f[1000]
+
+
+def test_serialized_file_with_context_and_empty_file():
+    sc = SerializationContext().withSerializePodListsInline()
+    T = ListOf(float)
+
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "lists")
+
+        SerializedFile(T).write(path, [T(range(i)) for i in range(50)], sc)
+
+        f = SerializedFile(T).open(path, sc)
+        assert len(f) == 50
+        assert f[49] == T(range(49))
+        assert f.recordBytes(3).deserialize(T, sc) == T(range(3))
+        f.close()
+
+        emptyPath = os.path.join(tf, "empty")
+        SerializedFile(T).write(emptyPath, [])
+
+        assert len(SerializedFile(T).open(emptyPath)) == 0
+
+
+def test_serialized_file_rejects_bad_files():
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "bad")
+
+        with open(path, "wb") as f:
+            f.write(b"not a serialized file at all")
+
+        with pytest.raises(ValueError):
+            SerializedFile(int).open(path)
+
+        # a writer that was never closed has no footer
+        w = SerializedFile(int).writer(path)
+        w.append(10)
+        w._file.flush()
+
+        with pytest.raises(ValueError):
+            SerializedFile(int).open(path)
+
+        w.close()
+        assert SerializedFile(int).open(path)[0] == 10
+
+
+def test_serialized_file_from_compiled_code():
+    trades = makeTrades(100)
+
+    with tempfile.TemporaryDirectory() as tf:
+        path = os.path.join(tf, "trades")
+        SerializedFile(Trade).write(path, trades)
+
+        f = SerializedFile(Trade).open(path)
+
+        @Entrypoint
+        def totalSize(f: SerializedFile(Trade), which: ListOf(int)) -> int:
+            res = 0
+            for i in which:
+                res += f[i].size
+            return res
+
+        assert totalSize(f, [1, 5, 99]) == 1 + 5 + 99
+
+        f.close()
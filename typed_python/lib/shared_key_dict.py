@@ -0,0 +1,273 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A dict for many small records with the same keys, sharing one copy of the keys.
+
+Millions of 'Dict(str, float)' records with the same twenty keys each carry
+their own hash table: a copy of every key, its hash, and the slot index.
+'SharedKeyDict(K, V)' works like CPython's key-sharing dicts. Each instance
+holds a 'SharedKeys' (the ordered keys and an index from key to position)
+and a 'ListOf(V)' of values in that order. Instances that got the same keys
+in the same order share one 'SharedKeys':
+
+    Record = SharedKeyDict(str, float)
+
+    r1 = Record()
+    r1["price"] = 10.0
+    r1["size"] = 2.0
+
+    r2 = Record()
+    r2["price"] = 11.0   # r2 reuses the keys r1 built
+    r2["size"] = 3.0     # so r1 and r2 hold the same SharedKeys
+
+The 'SharedKeys' form a tree rooted at the empty set of keys, per (K, V).
+Setting a new key moves a dict to the child of its current 'SharedKeys' for
+that key, creating it the first time anyone adds that key there. Deleting a
+key rebuilds the dict from the root with the remaining keys.
+
+A key's position only depends on the keys added before it, so code that
+looks up the same key in many records can find its position once and then
+check it with a single comparison:
+
+    ix = records[0].indexOf("price")
+
+    for r in records:
+        total += r.getAt(ix, "price")
+
+'getAt' falls back to a normal lookup for records whose keys differ.
+
+Adding keys grows the value list like any ListOf, so a record built up one
+key at a time can have spare capacity. 'compact' releases it.
+"""
+
+from typed_python import (
+    Class, Final, Member, TypeFunction, ListOf, Dict, Entrypoint, Forward, OneOf
+)
+
+
+@TypeFunction
+def SharedKeys(K):
+    """An ordered set of keys shared by many SharedKeyDict instances."""
+    SharedKeys_ = Forward("SharedKeys_")
+
+    @SharedKeys_.define
+    class SharedKeys_(Class, Final, __name__=f"SharedKeys({K.__name__})"):
+        keys = Member(ListOf(K), nonempty=True)
+
+        # key -> its position in 'keys'
+        _index = Member(Dict(K, int), nonempty=True)
+
+        # key -> the SharedKeys with our keys followed by that key
+        _children = Member(Dict(K, SharedKeys_), nonempty=True)
+
+        # the SharedKeys with no keys that we descend from, or None if that's us
+        _root = Member(OneOf(None, SharedKeys_), nonempty=True)
+
+        def __len__(self) -> int:
+            return len(self.keys)
+
+        @Entrypoint
+        def indexOf(self, k: K) -> int:
+            """Return the position of 'k', or -1 if it's not one of our keys."""
+            return self._index.get(k, -1)
+
+        @Entrypoint
+        def withKey(self, k: K) -> SharedKeys_:
+            """Return the SharedKeys with our keys followed by 'k'."""
+            if k in self._children:
+                return self._children[k]
+
+            res = SharedKeys_()
+            res.keys = ListOf(K)(self.keys)
+            res.keys.append(k)
+            res._index = Dict(K, int)(self._index)
+            res._index[k] = len(self.keys)
+            res._root = self.root()
+
+            self._children[k] = res
+
+            return res
+
+        @Entrypoint
+        def root(self) -> SharedKeys_:
+            if self._root is None:
+                return self
+
+            return self._root
+
+    return SharedKeys_
+
+
+# K -> the root SharedKeys(K) that new SharedKeyDicts start from
+_rootKeys = {}
+
+
+def rootSharedKeys(K):
+    """Return the empty SharedKeys(K) that every SharedKeyDict with keys K starts from."""
+    if K not in _rootKeys:
+        _rootKeys[K] = SharedKeys(K)()
+
+    return _rootKeys[K]
+
+
+@TypeFunction
+def SharedKeyDict(K, V):
+    """Create a dict from K to V whose instances share their keys."""
+    Keys = SharedKeys(K)
+
+    SharedKeyDict_ = Forward("SharedKeyDict_")
+
+    @SharedKeyDict_.define
+    class SharedKeyDict_(Class, Final, __name__=f"SharedKeyDict({K.__name__}, {V.__name__})"):
+        KeyType = K
+        ValueType = V
+
+        sharedKeys = Member(Keys, nonempty=True)
+
+        # the value of each of 'sharedKeys.keys', in the same order
+        _values = Member(ListOf(V), nonempty=True)
+
+        def __init__(self):
+            self.sharedKeys = rootSharedKeys(K)
+
+        def __init__(self, other):  # noqa: F811
+            self.sharedKeys = rootSharedKeys(K)
+
+            for k in other:
+                self[k] = other[k]
+
+        @staticmethod
+        def like(other: SharedKeyDict_) -> SharedKeyDict_:
+            """Return an empty SharedKeyDict that shares keys with 'other'."""
+            res = SharedKeyDict_()
+            res.sharedKeys = other.sharedKeys.root()
+            return res
+
+        def __len__(self) -> int:
+            return len(self._values)
+
+        @Entrypoint
+        def __contains__(self, k: K) -> bool:
+            return self.sharedKeys.indexOf(k) >= 0
+
+        @Entrypoint
+        def __getitem__(self, k: K) -> V:
+            ix = self.sharedKeys.indexOf(k)
+
+            if ix < 0:
+                raise KeyError(k)
+
+            return self._values[ix]
+
+        @Entrypoint
+        def get(self, k: K) -> OneOf(None, V):
+            ix = self.sharedKeys.indexOf(k)
+
+            if ix < 0:
+                return None
+
+            return self._values[ix]
+
+        @Entrypoint
+        def get(self, k: K, default: V) -> V:  # noqa: F811
+            ix = self.sharedKeys.indexOf(k)
+
+            if ix < 0:
+                return default
+
+            return self._values[ix]
+
+        @Entrypoint
+        def __setitem__(self, k: K, v: V) -> None:
+            ix = self.sharedKeys.indexOf(k)
+
+            if ix >= 0:
+                self._values[ix] = v
+                return
+
+            self.sharedKeys = self.sharedKeys.withKey(k)
+            self._values.append(v)
+
+        @Entrypoint
+        def __delitem__(self, k: K) -> None:
+            ix = self.sharedKeys.indexOf(k)
+
+            if ix < 0:
+                raise KeyError(k)
+
+            oldKeys = self.sharedKeys.keys
+            oldValues = self._values
+
+            keys = self.sharedKeys.root()
+            values = ListOf(V)()
+            values.reserve(len(oldValues) - 1)
+
+            for i in range(len(oldKeys)):
+                if i != ix:
+                    keys = keys.withKey(oldKeys[i])
+                    values.append(oldValues[i])
+
+            self.sharedKeys = keys
+            self._values = values
+
+        @Entrypoint
+        def indexOf(self, k: K) -> int:
+            """Return the position of 'k' in our keys, or -1 if we don't have it."""
+            return self.sharedKeys.indexOf(k)
+
+        @Entrypoint
+        def getAt(self, ix: int, k: K) -> V:
+            """Return self[k], given that 'ix' is probably the position of 'k'.
+
+            If 'ix' came from 'indexOf' on a dict whose keys start the same way
+            as ours, this is one comparison instead of a hash lookup.
+            """
+            keys = self.sharedKeys.keys
+
+            if ix >= 0 and ix < len(keys) and keys[ix] == k:
+                return self._values[ix]
+
+            return self[k]
+
+        def keys(self) -> ListOf(K):
+            return self.sharedKeys.keys
+
+        def values(self) -> ListOf(V):
+            return self._values
+
+        def items(self):
+            return zip(self.sharedKeys.keys, self._values)
+
+        def __iter__(self):
+            return iter(self.sharedKeys.keys)
+
+        def compact(self) -> None:
+            """Release the spare capacity in our values."""
+            self._values = ListOf(V)(self._values)
+
+        def __eq__(self, other) -> bool:
+            if len(self) != len(other):
+                return False
+
+            for k in self:
+                if k not in other or other[k] != self[k]:
+                    return False
+
+            return True
+
+        def __repr__(self) -> str:
+            return "{" + ", ".join(f"{k!r}: {v!r}" for k, v in self.items()) + "}"
+
+    return SharedKeyDict_
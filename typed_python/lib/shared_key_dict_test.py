@@ -0,0 +1,121 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import Dict, ListOf, Entrypoint, deepBytecount
+from typed_python.lib.shared_key_dict import SharedKeyDict
+
+Record = SharedKeyDict(str, float)
+
+
+def sameKeys(r1, r2):
+    return r1.sharedKeys.keys.pointerUnsafe(0) == r2.sharedKeys.keys.pointerUnsafe(0)
+
+
+def test_shared_key_dict_basics():
+    r = Record()
+    r["a"] = 1.0
+    r["b"] = 2.0
+    r["a"] = 3.0
+
+    assert len(r) == 2
+    assert r["a"] == 3.0
+    assert "b" in r and "c" not in r
+    assert r.get("c") is None
+    assert r.get("c", 5.0) == 5.0
+    assert list(r) == ["a", "b"]
+    assert list(r.items()) == [("a", 3.0), ("b", 2.0)]
+
+    with pytest.raises(KeyError):
+        r["c"]
+
+    del r["a"]
+
+    assert list(r.items()) == [("b", 2.0)]
+
+    with pytest.raises(KeyError):
+        del r["a"]
+
+    assert Record({"x": 1.0, "y": 2.0}) == Record({"x": 1.0, "y": 2.0})
+    assert Record({"x": 1.0}) != Record({"x": 2.0})
+
+
+def test_shared_key_dicts_share_keys():
+    r1 = Record({"a": 1.0, "b": 2.0, "c": 3.0})
+    r2 = Record({"a": 4.0, "b": 5.0, "c": 6.0})
+    r3 = Record({"a": 4.0, "c": 6.0})
+
+    assert sameKeys(r1, r2)
+    assert not sameKeys(r1, r3)
+
+    # deleting a key lands us on the keys we'd have had if we'd never added it
+    del r2["b"]
+    assert sameKeys(r2, r3)
+
+    assert sameKeys(Record.like(r1), Record())
+
+
+def test_shared_key_dict_smaller_than_dict():
+    keys = [f"field_{i}" for i in range(20)]
+
+    records = ListOf(Record)()
+    dicts = ListOf(Dict(str, float))()
+
+    # the SharedKeys tree gets counted once, so we need enough records to outweigh it
+    for i in range(1000):
+        r = Record()
+        d = Dict(str, float)()
+
+        for k in keys:
+            r[k] = float(i)
+            d[k] = float(i)
+
+        r.compact()
+
+        records.append(r)
+        dicts.append(d)
+
+    assert deepBytecount(records) * 2 < deepBytecount(dicts)
+
+
+def test_shared_key_dict_compiled_lookups():
+    records = ListOf(Record)()
+
+    for i in range(10):
+        records.append(Record({"price": float(i), "size": 2.0}))
+
+    # one record with its keys in a different order
+    records.append(Record({"size": 2.0, "price": 100.0}))
+
+    @Entrypoint
+    def totalPrice(records: ListOf(Record)) -> float:
+        ix = records[0].indexOf("price")
+        res = 0.0
+
+        for r in records:
+            res += r.getAt(ix, "price")
+
+        return res
+
+    @Entrypoint
+    def scaleSizes(records: ListOf(Record), factor: float) -> None:
+        for r in records:
+            r["size"] = r["size"] * factor
+
+    assert totalPrice(records) == sum(range(10)) + 100.0
+
+    scaleSizes(records, 3.0)
+
+    assert all(r["size"] == 6.0 for r in records)
@@ -0,0 +1,706 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Small fixed-width vectors of numbers, for code that wants to say how it uses SIMD.
+
+llvm vectorizes simple loops over ListOf on its own, but it gives up on loops
+that gather, blend or branch. These types let that kind of code spell out the
+lanes instead:
+
+    def clippedSum(prices: ListOf(float), cap: float) -> float:
+        total = Float64x4.splat(0.0)
+
+        for i in range(0, len(prices) - 3, 4):
+            v = Float64x4.load(prices, i)
+            total += blend(v > cap, Float64x4.splat(cap), v)
+
+        return total.sum()
+
+Each vector is a NamedTuple with one field per lane ('x0', 'x1', ...), so it
+can be stored anywhere a NamedTuple can. In compiled code, arithmetic,
+comparisons, min/max, blend, load and store become single llvm vector
+instructions. Horizontal reductions and gathers work a lane at a time. In the
+interpreter everything works a lane at a time.
+
+The vector types are Float64x2, Float64x4, Float32x4, Float32x8, Int64x2,
+Int64x4, Int32x4 and Int32x8. Comparing two vectors with <, <=, > or >= produces
+a mask, Mask2, Mask4 or Mask8, with a bool per lane. Use 'eq' and 'ne' to compare
+lane by lane, since == compares whole vectors like any other NamedTuple.
+
+Integer arithmetic wraps, the way it does for Int32 and int in compiled code.
+A scalar operand is broadcast to every lane.
+"""
+
+from typed_python import NamedTuple, Float32, Int32
+from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
+from typed_python.compiler.conversion_level import ConversionLevel
+import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler
+
+typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
+
+
+# vector or mask type -> (element type, lane count)
+_SHAPES = {}
+
+# lane count -> mask type
+_MASKS = {}
+
+_INT_BITS = {int: 64, Int32: 32}
+
+
+def _wrapInt(x, bits):
+    x &= (1 << bits) - 1
+    return x - (1 << bits) if x >> (bits - 1) else x
+
+
+def _makeVector(V, values):
+    elementType, count = _SHAPES[V]
+
+    if elementType in _INT_BITS:
+        values = [_wrapInt(x, _INT_BITS[elementType]) for x in values]
+
+    return V(**{V.ElementNames[i]: values[i] for i in range(count)})
+
+
+def _vectorTypeOf(*args):
+    for a in args:
+        if type(a) in _SHAPES:
+            return type(a)
+
+    raise TypeError("Expected a simd vector")
+
+
+def _lanes(V, x):
+    if type(x) is V:
+        return list(x)
+
+    return [x] * _SHAPES[V][1]
+
+
+def _nativeElementType(elementType):
+    # bools take a byte apiece in memory, so masks are vectors of bytes
+    if elementType is bool:
+        return native_ast.UInt8
+
+    return typeWrapper(elementType).getNativeLayoutType()
+
+
+def _nativeVectorType(V):
+    elementType, count = _SHAPES[V]
+
+    return native_ast.Type.Vector(element_type=_nativeElementType(elementType), count=count)
+
+
+def _compiledVectorTypeOf(context, args):
+    for a in args:
+        if a.expr_type.typeRepresentation in _SHAPES:
+            return a.expr_type.typeRepresentation
+
+    context.pushException(TypeError, "Expected a simd vector")
+
+
+def _loadVector(context, instance):
+    """Return a native expression with the llvm vector held in 'instance'."""
+    if not instance.isReference:
+        instance = context.pushMove(instance)
+
+    return instance.expr.cast(_nativeVectorType(instance.expr_type.typeRepresentation).pointer()).load()
+
+
+def _vectorOperand(context, instance, V):
+    """Return 'instance' as a native vector like V, broadcasting it if it's a scalar, or None."""
+    if instance.expr_type.typeRepresentation is V:
+        return _loadVector(context, instance)
+
+    elementType, count = _SHAPES[V]
+
+    scalar = instance.convert_to_type(elementType, ConversionLevel.Implicit)
+    if scalar is None:
+        return None
+
+    splat = context.allocateUninitializedSlot(V)
+
+    for i in range(count):
+        splat.refAs(i).convert_copy_initialize(scalar)
+
+    context.markUninitializedSlotInitialized(splat)
+
+    return _loadVector(context, splat)
+
+
+def _pushVector(context, V, vectorExpr):
+    """Return a new V holding the native vector 'vectorExpr'."""
+    result = context.allocateUninitializedSlot(V)
+
+    context.pushEffect(result.expr.cast(_nativeVectorType(V).pointer()).store(vectorExpr))
+    context.markUninitializedSlotInitialized(result)
+
+    return result
+
+
+_PYTHON_OPS = {
+    'add': lambda a, b: a + b,
+    'sub': lambda a, b: a - b,
+    'mul': lambda a, b: a * b,
+    'div': lambda a, b: a / b,
+    'and': lambda a, b: a & b,
+    'or': lambda a, b: a | b,
+    'xor': lambda a, b: a ^ b,
+    'min': lambda a, b: a if a < b else b,
+    'max': lambda a, b: a if a > b else b,
+    'lt': lambda a, b: a < b,
+    'le': lambda a, b: a <= b,
+    'gt': lambda a, b: a > b,
+    'ge': lambda a, b: a >= b,
+    'eq': lambda a, b: a == b,
+    'ne': lambda a, b: a != b,
+}
+
+_NATIVE_OPS = {
+    'add': native_ast.BinaryOp.Add,
+    'sub': native_ast.BinaryOp.Sub,
+    'mul': native_ast.BinaryOp.Mul,
+    'div': native_ast.BinaryOp.Div,
+    'and': native_ast.BinaryOp.BitAnd,
+    'or': native_ast.BinaryOp.BitOr,
+    'xor': native_ast.BinaryOp.BitXor,
+    'lt': native_ast.BinaryOp.Lt,
+    'le': native_ast.BinaryOp.LtE,
+    'gt': native_ast.BinaryOp.Gt,
+    'ge': native_ast.BinaryOp.GtE,
+    'eq': native_ast.BinaryOp.Eq,
+    'ne': native_ast.BinaryOp.NotEq,
+}
+
+_COMPARISONS = ('lt', 'le', 'gt', 'ge', 'eq', 'ne')
+
+
+class VectorOp(CompilableBuiltin):
+    """VectorOp(op)(a, b) applies 'op' lane by lane. One of 'a' and 'b' may be a scalar.
+
+    Comparisons produce the mask with as many lanes.
+    """
+    def __init__(self, op):
+        super().__init__()
+        self.op = op
+
+    def __eq__(self, other):
+        return isinstance(other, VectorOp) and other.op == self.op
+
+    def __hash__(self):
+        return hash(("VectorOp", self.op))
+
+    def __call__(self, a, b):
+        V = _vectorTypeOf(a, b)
+        values = [_PYTHON_OPS[self.op](x, y) for x, y in zip(_lanes(V, a), _lanes(V, b))]
+
+        if self.op in _COMPARISONS:
+            return _makeVector(_MASKS[_SHAPES[V][1]], values)
+
+        return _makeVector(V, values)
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 2 or kwargs:
+            context.pushException(TypeError, f"VectorOp({self.op}) takes two positional arguments")
+            return
+
+        V = _compiledVectorTypeOf(context, args)
+        if V is None:
+            return None
+
+        lhs = _vectorOperand(context, args[0], V)
+        if lhs is None:
+            return None
+
+        rhs = _vectorOperand(context, args[1], V)
+        if rhs is None:
+            return None
+
+        if self.op == 'min':
+            return _pushVector(context, V, lhs.lt(rhs).select(lhs, rhs))
+
+        if self.op == 'max':
+            return _pushVector(context, V, lhs.gt(rhs).select(lhs, rhs))
+
+        result = native_ast.Expression.Binop(op=_NATIVE_OPS[self.op](), left=lhs, right=rhs)
+
+        if self.op in _COMPARISONS:
+            M = _MASKS[_SHAPES[V][1]]
+
+            return _pushVector(context, M, result.cast(_nativeVectorType(M)))
+
+        return _pushVector(context, V, result)
+
+
+class VectorReduce(CompilableBuiltin):
+    """VectorReduce(op)(v) combines the lanes of 'v' with 'op', from first to last."""
+    def __init__(self, op):
+        super().__init__()
+        self.op = op
+
+    def __eq__(self, other):
+        return isinstance(other, VectorReduce) and other.op == self.op
+
+    def __hash__(self):
+        return hash(("VectorReduce", self.op))
+
+    def __call__(self, v):
+        V = _vectorTypeOf(v)
+        elementType = _SHAPES[V][0]
+
+        lanes = list(v)
+
+        result = lanes[0]
+        for x in lanes[1:]:
+            result = _PYTHON_OPS[self.op](result, x)
+
+        if elementType in _INT_BITS:
+            result = _wrapInt(result, _INT_BITS[elementType])
+
+        return elementType(result)
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 1 or kwargs:
+            context.pushException(TypeError, f"VectorReduce({self.op}) takes one positional argument")
+            return
+
+        V = _compiledVectorTypeOf(context, args)
+        if V is None:
+            return None
+
+        elementType, count = _SHAPES[V]
+
+        result = args[0].refAs(0).nonref_expr
+
+        # each partial result gets its own variable, so that min and max, which
+        # mention their operands twice, don't make an expression of size 2 ** count.
+        for i in range(1, count):
+            lane = args[0].refAs(i).nonref_expr
+
+            if self.op == 'min':
+                result = result.lt(lane).select(result, lane)
+            elif self.op == 'max':
+                result = result.gt(lane).select(result, lane)
+            else:
+                result = native_ast.Expression.Binop(op=_NATIVE_OPS[self.op](), left=result, right=lane)
+
+            result = context.pushPod(elementType, result).nonref_expr
+
+        return context.pushPod(elementType, result)
+
+
+class Splat(CompilableBuiltin):
+    """Splat()(V, x) makes a V with 'x' in every lane."""
+    def __eq__(self, other):
+        return isinstance(other, Splat)
+
+    def __hash__(self):
+        return hash("Splat")
+
+    def __call__(self, V, x):
+        return _makeVector(V, _lanes(V, x))
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 2 or kwargs or not args[0].isConstant:
+            context.pushException(TypeError, "Splat takes a vector type and a value")
+            return
+
+        V = args[0].constantValue
+
+        vector = _vectorOperand(context, args[1], V)
+        if vector is None:
+            return None
+
+        return _pushVector(context, V, vector)
+
+
+class Blend(CompilableBuiltin):
+    """Blend()(mask, a, b) takes each lane from 'a' where 'mask' is true and from 'b' where it isn't."""
+    def __eq__(self, other):
+        return isinstance(other, Blend)
+
+    def __hash__(self):
+        return hash("Blend")
+
+    def __call__(self, mask, a, b):
+        V = _vectorTypeOf(a, b)
+
+        if type(mask) is not _MASKS[_SHAPES[V][1]]:
+            raise TypeError(f"Can't blend {V.__name__} with a {type(mask).__name__}")
+
+        return _makeVector(V, [x if m else y for m, x, y in zip(mask, _lanes(V, a), _lanes(V, b))])
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 3 or kwargs:
+            context.pushException(TypeError, "blend takes three positional arguments")
+            return
+
+        V = _compiledVectorTypeOf(context, args[1:])
+        if V is None:
+            return None
+
+        elementType, count = _SHAPES[V]
+        M = _MASKS[count]
+
+        if args[0].expr_type.typeRepresentation is not M:
+            context.pushException(TypeError, f"Can't blend {V.__name__} with a {args[0].expr_type.typeRepresentation}")
+            return
+
+        cond = _loadVector(context, args[0]).cast(native_ast.Type.Vector(element_type=native_ast.Bool, count=count))
+
+        lhs = _vectorOperand(context, args[1], V)
+        if lhs is None:
+            return None
+
+        rhs = _vectorOperand(context, args[2], V)
+        if rhs is None:
+            return None
+
+        return _pushVector(context, V, cond.select(lhs, rhs))
+
+
+def _category(T):
+    return getattr(T, "__typed_python_category__", None)
+
+
+def _checkSource(V, sourceType, forWriting):
+    """Return an error message if we can't load V from (or store it into) a 'sourceType', or None."""
+    elementType = _SHAPES[V][0]
+
+    if forWriting:
+        if _category(sourceType) not in ("ListOf", "PointerTo"):
+            return f"Can't store a {V.__name__} into a {sourceType.__name__}"
+    elif _category(sourceType) not in ("ListOf", "TupleOf", "PointerTo"):
+        return f"Can't load a {V.__name__} from a {sourceType.__name__}"
+
+    if sourceType.ElementType is not elementType:
+        return f"{V.__name__} holds {elementType.__name__}, not {sourceType.ElementType.__name__}"
+
+
+def _compiledLanePointer(context, V, container, offset):
+    """Return a PointerTo the element at 'offset' of 'container', checking that V fits, or None."""
+    count = _SHAPES[V][1]
+
+    offset = offset.toInt64()
+    if offset is None:
+        return None
+
+    if _category(container.expr_type.typeRepresentation) == "PointerTo":
+        return container + offset
+
+    length = container.convert_len()
+    if length is None:
+        return None
+
+    with context.ifelse(
+        offset.nonref_expr.lt(0).bitor(offset.nonref_expr.add(count).gt(length.nonref_expr))
+    ) as (ifTrue, ifFalse):
+        with ifTrue:
+            context.pushException(IndexError, f"{V.__name__} index out of range")
+
+    return container.convert_method_call("pointerUnsafe", (offset,), {})
+
+
+def _checkLaneRange(V, container, offset):
+    if _category(type(container)) != "PointerTo" and (offset < 0 or offset + _SHAPES[V][1] > len(container)):
+        raise IndexError(f"{V.__name__} index out of range")
+
+
+class VectorLoad(CompilableBuiltin):
+    """VectorLoad()(V, source, offset) reads a V from consecutive elements of 'source'.
+
+    'source' is a ListOf, TupleOf or PointerTo of V's element type.
+    """
+    def __eq__(self, other):
+        return isinstance(other, VectorLoad)
+
+    def __hash__(self):
+        return hash("VectorLoad")
+
+    def __call__(self, V, source, offset):
+        error = _checkSource(V, type(source), False)
+        if error:
+            raise TypeError(error)
+
+        _checkLaneRange(V, source, offset)
+
+        return _makeVector(V, [source[offset + i] for i in range(_SHAPES[V][1])])
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 3 or kwargs or not args[0].isConstant:
+            context.pushException(TypeError, "VectorLoad takes a vector type, a source and an offset")
+            return
+
+        V = args[0].constantValue
+
+        error = _checkSource(V, args[1].expr_type.typeRepresentation, False)
+        if error:
+            context.pushException(TypeError, error)
+            return
+
+        ptr = _compiledLanePointer(context, V, args[1], args[2])
+        if ptr is None:
+            return None
+
+        return _pushVector(context, V, ptr.nonref_expr.cast(_nativeVectorType(V).pointer()).load())
+
+
+class VectorStore(CompilableBuiltin):
+    """VectorStore()(v, dest, offset) writes the lanes of 'v' to consecutive elements of 'dest'.
+
+    'dest' is a ListOf or PointerTo of v's element type.
+    """
+    def __eq__(self, other):
+        return isinstance(other, VectorStore)
+
+    def __hash__(self):
+        return hash("VectorStore")
+
+    def __call__(self, v, dest, offset):
+        V = _vectorTypeOf(v)
+
+        error = _checkSource(V, type(dest), True)
+        if error:
+            raise TypeError(error)
+
+        _checkLaneRange(V, dest, offset)
+
+        for i in range(_SHAPES[V][1]):
+            dest[offset + i] = v[i]
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 3 or kwargs:
+            context.pushException(TypeError, "VectorStore takes a vector, a destination and an offset")
+            return
+
+        V = _compiledVectorTypeOf(context, args[:1])
+        if V is None:
+            return None
+
+        error = _checkSource(V, args[1].expr_type.typeRepresentation, True)
+        if error:
+            context.pushException(TypeError, error)
+            return
+
+        ptr = _compiledLanePointer(context, V, args[1], args[2])
+        if ptr is None:
+            return None
+
+        context.pushEffect(
+            ptr.nonref_expr.cast(_nativeVectorType(V).pointer()).store(_loadVector(context, args[0]))
+        )
+
+        return context.pushVoid()
+
+
+class VectorGather(CompilableBuiltin):
+    """VectorGather()(V, source, indices) makes a V whose lane i is source[indices[i]]."""
+    def __eq__(self, other):
+        return isinstance(other, VectorGather)
+
+    def __hash__(self):
+        return hash("VectorGather")
+
+    def __call__(self, V, source, indices):
+        if type(indices) not in _SHAPES or _SHAPES[type(indices)][1] != _SHAPES[V][1]:
+            raise TypeError(f"Can't gather a {V.__name__} with a {type(indices).__name__}")
+
+        return _makeVector(V, [source[int(ix)] for ix in indices])
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 3 or kwargs or not args[0].isConstant:
+            context.pushException(TypeError, "VectorGather takes a vector type, a source and indices")
+            return
+
+        V = args[0].constantValue
+        elementType, count = _SHAPES[V]
+        indexType = args[2].expr_type.typeRepresentation
+
+        if indexType not in _SHAPES or _SHAPES[indexType][1] != count:
+            context.pushException(TypeError, f"Can't gather a {V.__name__} with a {indexType}")
+            return
+
+        result = context.allocateUninitializedSlot(V)
+
+        for i in range(count):
+            value = args[1].convert_getitem(args[2].refAs(i))
+            if value is None:
+                return None
+
+            value = value.convert_to_type(elementType, ConversionLevel.Implicit)
+            if value is None:
+                return None
+
+            result.refAs(i).convert_copy_initialize(value)
+
+        context.markUninitializedSlotInitialized(result)
+
+        return result
+
+
+_add = VectorOp('add')
+_sub = VectorOp('sub')
+_mul = VectorOp('mul')
+_div = VectorOp('div')
+_and = VectorOp('and')
+_or = VectorOp('or')
+_xor = VectorOp('xor')
+_min = VectorOp('min')
+_max = VectorOp('max')
+_lt = VectorOp('lt')
+_le = VectorOp('le')
+_gt = VectorOp('gt')
+_ge = VectorOp('ge')
+_eq = VectorOp('eq')
+_ne = VectorOp('ne')
+_sum = VectorReduce('add')
+_reduceMin = VectorReduce('min')
+_reduceMax = VectorReduce('max')
+_all = VectorReduce('and')
+_any = VectorReduce('or')
+_load = VectorLoad()
+_store = VectorStore()
+_gather = VectorGather()
+_splat = Splat()
+
+blend = Blend()
+
+
+def _defineMask(name, count):
+    def __and__(self, other):
+        return _and(self, other)
+
+    def __or__(self, other):
+        return _or(self, other)
+
+    def __xor__(self, other):
+        return _xor(self, other)
+
+    def __invert__(self):
+        return _xor(self, True)
+
+    def all(self):
+        """Is every lane true?"""
+        return _all(self)
+
+    def any(self):
+        """Is some lane true?"""
+        return _any(self)
+
+    base = NamedTuple(**{f"x{i}": bool for i in range(count)})
+
+    M = type(base)(
+        name,
+        (base,),
+        dict(
+            __module__=__name__,
+            __qualname__=name,
+            __doc__=f"A bool for each lane of a {count} lane simd vector.",
+            __and__=__and__,
+            __or__=__or__,
+            __xor__=__xor__,
+            __invert__=__invert__,
+            all=all,
+            any=any,
+        )
+    )
+
+    _SHAPES[M] = (bool, count)
+    _MASKS[count] = M
+
+    return M
+
+
+def _defineVector(name, elementType, count):
+    V = None
+
+    def load(source, offset=0):
+        """Read lanes from source[offset:offset + lanes]. 'source' is a ListOf, TupleOf or PointerTo."""
+        return _load(V, source, offset)
+
+    def gather(source, indices):
+        """Make the vector whose lane i is source[indices[i]]. 'indices' is an integer vector."""
+        return _gather(V, source, indices)
+
+    def splat(x):
+        """Make the vector with 'x' in every lane."""
+        return _splat(V, x)
+
+    def store(self, dest, offset=0):
+        """Write our lanes to dest[offset:offset + lanes]. 'dest' is a ListOf or PointerTo."""
+        _store(self, dest, offset)
+
+    methods = dict(
+        __module__=__name__,
+        __qualname__=name,
+        __doc__=f"A simd vector of {count} {elementType.__name__}.",
+        load=staticmethod(load),
+        gather=staticmethod(gather),
+        splat=staticmethod(splat),
+        store=store,
+        __add__=lambda self, other: _add(self, other),
+        __radd__=lambda self, other: _add(other, self),
+        __sub__=lambda self, other: _sub(self, other),
+        __rsub__=lambda self, other: _sub(other, self),
+        __mul__=lambda self, other: _mul(self, other),
+        __rmul__=lambda self, other: _mul(other, self),
+        __neg__=lambda self: _mul(self, -1),
+        __lt__=lambda self, other: _lt(self, other),
+        __le__=lambda self, other: _le(self, other),
+        __gt__=lambda self, other: _gt(self, other),
+        __ge__=lambda self, other: _ge(self, other),
+        eq=lambda self, other: _eq(self, other),
+        ne=lambda self, other: _ne(self, other),
+        min=lambda self, other: _min(self, other),
+        max=lambda self, other: _max(self, other),
+        sum=lambda self: _sum(self),
+        reduceMin=lambda self: _reduceMin(self),
+        reduceMax=lambda self: _reduceMax(self),
+    )
+
+    if elementType in _INT_BITS:
+        methods.update(
+            __and__=lambda self, other: _and(self, other),
+            __or__=lambda self, other: _or(self, other),
+            __xor__=lambda self, other: _xor(self, other),
+        )
+    else:
+        methods.update(
+            __truediv__=lambda self, other: _div(self, other),
+            __rtruediv__=lambda self, other: _div(other, self),
+        )
+
+    base = NamedTuple(**{f"x{i}": elementType for i in range(count)})
+
+    V = type(base)(name, (base,), methods)
+
+    _SHAPES[V] = (elementType, count)
+
+    return V
+
+
+Mask2 = _defineMask("Mask2", 2)
+Mask4 = _defineMask("Mask4", 4)
+Mask8 = _defineMask("Mask8", 8)
+
+Float64x2 = _defineVector("Float64x2", float, 2)
+Float64x4 = _defineVector("Float64x4", float, 4)
+Float32x4 = _defineVector("Float32x4", Float32, 4)
+Float32x8 = _defineVector("Float32x8", Float32, 8)
+Int64x2 = _defineVector("Int64x2", int, 2)
+Int64x4 = _defineVector("Int64x4", int, 4)
+Int32x4 = _defineVector("Int32x4", Int32, 4)
+Int32x8 = _defineVector("Int32x8", Int32, 8)
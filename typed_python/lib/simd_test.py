@@ -0,0 +1,147 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import Entrypoint, ListOf, TupleOf, Float32
+from typed_python.lib.simd import (
+    Float64x4, Float32x8, Int32x4, Int64x4, Mask4, Mask8, blend
+)
+
+
+def test_arithmetic_matches_interpreter():
+    def arithmetic(a, b):
+        return (a + b) * 2.0 - b / a, a.min(b), a.max(b), -a, 1.0 - a
+
+    compiled = Entrypoint(arithmetic)
+
+    a = Float64x4(x0=1.0, x1=-2.0, x2=3.5, x3=4.0)
+    b = Float64x4(x0=0.5, x1=2.0, x2=-1.0, x3=8.0)
+
+    assert compiled(a, b) == arithmetic(a, b)
+    assert arithmetic(a, b)[0].x0 == 2.5
+
+    a32 = Float32x8.splat(1.5)
+    b32 = Float32x8.load(ListOf(Float32)(range(8)))
+
+    assert compiled(a32, b32) == arithmetic(a32, b32)
+
+
+def test_integer_arithmetic_wraps():
+    def arithmetic(a, b):
+        return a * b + 1, a & b, a ^ b, a | 1
+
+    compiled = Entrypoint(arithmetic)
+
+    a = Int32x4(x0=2 ** 30, x1=-7, x2=3, x3=0)
+    b = Int32x4(x0=4, x1=5, x2=-1, x3=2 ** 31 - 1)
+
+    assert compiled(a, b) == arithmetic(a, b)
+    assert arithmetic(a, b)[0].x0 == 1
+
+    a64 = Int64x4.splat(2 ** 62)
+    assert compiled(a64, a64) == arithmetic(a64, a64)
+
+
+def test_comparisons_and_blend():
+    def clip(v, lo, hi):
+        return blend(v < lo, lo, blend(v > hi, hi, v)), (v < lo) | (v > hi), v.eq(lo)
+
+    compiled = Entrypoint(clip)
+
+    v = Float64x4(x0=-5.0, x1=0.5, x2=10.0, x3=0.0)
+
+    assert compiled(v, 0.0, 1.0) == clip(v, 0.0, 1.0)
+
+    clipped, outside, isZero = clip(v, 0.0, 1.0)
+
+    assert clipped == Float64x4(x0=0.0, x1=0.5, x2=1.0, x3=0.0)
+    assert outside == Mask4(x0=True, x1=False, x2=True, x3=False)
+    assert isZero == Mask4(x0=False, x1=False, x2=False, x3=True)
+
+    @Entrypoint
+    def maskOps(m: Mask4):
+        return ~m, m.any(), m.all(), (~m).any()
+
+    m = Mask4(x0=True, x1=False, x2=True, x3=False)
+
+    assert maskOps(m) == (Mask4(x0=False, x1=True, x2=False, x3=True), True, False, True)
+
+    with pytest.raises(TypeError):
+        blend(Mask8(), v, v)
+
+
+def test_reductions():
+    def reductions(v):
+        return v.sum(), v.reduceMin(), v.reduceMax()
+
+    compiled = Entrypoint(reductions)
+
+    v = Float32x8.load(ListOf(Float32)([3, 1, 4, 1, 5, 9, 2, 6]))
+
+    assert compiled(v) == reductions(v) == (31.0, 1.0, 9.0)
+
+    i = Int32x4(x0=2 ** 31 - 1, x1=1, x2=-3, x3=0)
+
+    assert compiled(i) == reductions(i) == (-2 ** 31 - 3, -3, 2 ** 31 - 1)
+
+
+def test_load_store_and_gather():
+    @Entrypoint
+    def scaleInPlace(values: ListOf(float), factor: float):
+        i = 0
+        while i + 4 <= len(values):
+            (Float64x4.load(values, i) * factor).store(values, i)
+            i += 4
+
+    values = ListOf(float)(range(10))
+    scaleInPlace(values, 2.0)
+
+    assert values == [0.0, 2.0, 4.0, 6.0, 8.0, 10.0, 12.0, 14.0, 8.0, 9.0]
+
+    @Entrypoint
+    def loadAt(values: TupleOf(float), offset: int):
+        return Float64x4.load(values, offset)
+
+    assert loadAt(TupleOf(float)(range(6)), 2) == Float64x4(x0=2.0, x1=3.0, x2=4.0, x3=5.0)
+
+    with pytest.raises(IndexError):
+        loadAt(TupleOf(float)(range(6)), 3)
+
+    with pytest.raises(IndexError):
+        loadAt(TupleOf(float)(range(6)), -1)
+
+    with pytest.raises(IndexError):
+        Float64x4.load(TupleOf(float)(range(6)), 3)
+
+    @Entrypoint
+    def loadFromPointer(values: ListOf(Float32)):
+        return Float32x8.load(values.pointerUnsafe(0))
+
+    floats = ListOf(Float32)(range(8))
+    assert loadFromPointer(floats) == Float32x8.load(floats)
+
+    def gather(values, indices):
+        return Float64x4.gather(values, indices)
+
+    table = ListOf(float)([10.0, 11.0, 12.0, 13.0, 14.0])
+    indices = Int32x4(x0=4, x1=0, x2=0, x3=2)
+
+    assert Entrypoint(gather)(table, indices) == gather(table, indices) == Float64x4(x0=14.0, x1=10.0, x2=10.0, x3=12.0)
+
+    with pytest.raises(IndexError):
+        Entrypoint(gather)(table, Int32x4(x0=5))
+
+    with pytest.raises(TypeError):
+        Float64x4.load(ListOf(int)(range(4)))
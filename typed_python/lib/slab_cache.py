@@ -0,0 +1,305 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Bounded caches of Slab-backed values, and a way to shed them under memory pressure.
+
+A SlabCache holds values copied into their own Slab with 'deepcopyContiguous',
+so each entry's memory is one block we can account for exactly and hand back
+to the OS in one piece:
+
+    cache = SlabCache(maxBytes=8 * 1024 ** 3, name="snapshots")
+    cache.put(day, snapshot)
+    ...
+    cache.get(day)
+
+Entries past 'maxBytes' are evicted least recently used first. Every SlabCache
+is also registered with the process-wide pressure handling here:
+
+    setSlabMemoryLimit(32 * 1024 ** 3)  # evict across all caches past this
+    relieveMemoryPressure(bytesToFree)  # e.g. from a cgroup memory.high watcher
+    addMemoryPressureCallback(f)        # f(bytesToFree) -> bytesFreed, for other caches
+
+'relieveMemoryPressure' evicts the least recently used entries across all
+caches first, and then asks the registered callbacks for the rest.
+
+'SlabCache.adviseCold' tells the kernel that the slabs of entries nobody has
+used for a while can be reclaimed first (or paged out now) without evicting
+them, and 'slabInfo' reports the size, age and tag of every live Slab.
+
+Evicting an entry only frees its slab once nothing else refers to the value,
+so callers shouldn't hold on to what 'get' returns longer than they need to.
+"""
+
+import threading
+import time
+import weakref
+
+from collections import OrderedDict
+
+from typed_python import deepcopyContiguous, deepBytecountAndSlabs, totalBytesAllocatedInSlabs
+from typed_python._types import getAllSlabs
+
+
+_lock = threading.RLock()
+
+# every live SlabCache
+_caches = weakref.WeakSet()
+
+# functions of bytesToFree returning the number of bytes they freed
+_pressureCallbacks = []
+
+# if not None, caches shed entries once Slabs hold more than this many bytes
+_slabMemoryLimit = [None]
+
+
+class SlabCache:
+    """An LRU cache whose values each live in their own Slab."""
+
+    def __init__(self, maxBytes=None, name=None):
+        """Initialize a SlabCache.
+
+        Args:
+            maxBytes - if not None, evict least recently used entries to keep the
+                total size of our slabs under this.
+            name - a name for the cache. Our slabs are tagged with (name, key).
+        """
+        self.maxBytes = maxBytes
+        self.name = name
+
+        self._lock = threading.RLock()
+
+        # key -> (value, [Slab], bytecount), least recently used first
+        self._entries = OrderedDict()
+        self._bytecount = 0
+
+        with _lock:
+            _caches.add(self)
+
+    def __len__(self):
+        return len(self._entries)
+
+    def __contains__(self, key):
+        return key in self._entries
+
+    def keys(self):
+        with self._lock:
+            return list(self._entries)
+
+    @property
+    def bytecount(self):
+        """The total size of the slabs our entries hold."""
+        return self._bytecount
+
+    def put(self, key, value):
+        """Copy 'value' into a new Slab and cache it under 'key'.
+
+        Returns:
+            the copy, which is what 'get' will return.
+        """
+        copy = deepcopyContiguous(value, tag=(self.name, key))
+        _, slabs = deepBytecountAndSlabs(copy)
+        bytecount = sum(slab.bytecount() for slab in slabs)
+
+        with self._lock:
+            self._discard(key)
+
+            self._entries[key] = (copy, slabs, bytecount)
+            self._bytecount += bytecount
+
+            if self.maxBytes is not None and self._bytecount > self.maxBytes:
+                self.evict(self._bytecount - self.maxBytes)
+
+        _checkSlabMemoryLimit()
+
+        return copy
+
+    def get(self, key, default=None):
+        """Return the value cached under 'key', marking it as recently used."""
+        with self._lock:
+            entry = self._entries.get(key)
+
+            if entry is None:
+                return default
+
+            self._entries.move_to_end(key)
+
+        for slab in entry[1]:
+            slab.touch()
+
+        return entry[0]
+
+    def pop(self, key, default=None):
+        """Remove 'key' from the cache, returning its value."""
+        with self._lock:
+            entry = self._entries.get(key)
+
+            if entry is None:
+                return default
+
+            self._discard(key)
+
+            return entry[0]
+
+    def clear(self):
+        with self._lock:
+            self._entries.clear()
+            self._bytecount = 0
+
+    def evict(self, bytesToFree):
+        """Evict least recently used entries until we've dropped 'bytesToFree' bytes.
+
+        Returns:
+            the number of bytes we dropped.
+        """
+        freed = 0
+
+        with self._lock:
+            while self._entries and freed < bytesToFree:
+                key = next(iter(self._entries))
+                freed += self._entries[key][2]
+                self._discard(key)
+
+        return freed
+
+    def adviseCold(self, idleSeconds, pageout=False):
+        """Tell the kernel it can reclaim the slabs of entries unused for 'idleSeconds'.
+
+        The entries stay in the cache. See Slab.adviseCold.
+
+        Returns:
+            the number of bytes we advised on.
+        """
+        cutoff = time.time() - idleSeconds
+        advised = 0
+
+        with self._lock:
+            entries = list(self._entries.values())
+
+        for _, slabs, _ in entries:
+            for slab in slabs:
+                if slab.lastTouched() < cutoff and slab.adviseCold(pageout=pageout):
+                    advised += slab.bytecount()
+
+        return advised
+
+    def _leastRecentlyUsed(self):
+        """Return (lastTouched, key, bytecount) for our entries, least recently used first."""
+        with self._lock:
+            return [
+                (max([slab.lastTouched() for slab in slabs], default=0.0), key, bytecount)
+                for key, (_, slabs, bytecount) in self._entries.items()
+            ]
+
+    def _discard(self, key):
+        entry = self._entries.pop(key, None)
+
+        if entry is not None:
+            self._bytecount -= entry[2]
+
+
+def addMemoryPressureCallback(callback):
+    """Ask 'callback(bytesToFree) -> bytesFreed' to help when we're under memory pressure.
+
+    Callbacks run after SlabCaches have evicted what they can.
+    """
+    with _lock:
+        _pressureCallbacks.append(callback)
+
+
+def removeMemoryPressureCallback(callback):
+    with _lock:
+        _pressureCallbacks.remove(callback)
+
+
+def relieveMemoryPressure(bytesToFree):
+    """Try to free 'bytesToFree' bytes.
+
+    We evict the least recently used entries across every SlabCache, and then
+    ask the callbacks from 'addMemoryPressureCallback' for whatever's left.
+
+    Returns:
+        the number of bytes freed.
+    """
+    with _lock:
+        caches = list(_caches)
+        callbacks = list(_pressureCallbacks)
+
+    candidates = sorted(
+        (lastTouched, id(cache), key, bytecount, cache)
+        for cache in caches
+        for lastTouched, key, bytecount in cache._leastRecentlyUsed()
+    )
+
+    freed = 0
+
+    for _, _, key, bytecount, cache in candidates:
+        if freed >= bytesToFree:
+            break
+
+        if key in cache:
+            cache.pop(key)
+            freed += bytecount
+
+    for callback in callbacks:
+        if freed >= bytesToFree:
+            break
+
+        freed += callback(bytesToFree - freed) or 0
+
+    return freed
+
+
+def setSlabMemoryLimit(maxBytes):
+    """Relieve memory pressure whenever a SlabCache grows Slab memory past 'maxBytes'.
+
+    'maxBytes' counts every live Slab in the process (see totalBytesAllocatedInSlabs),
+    not just the ones in caches. Pass None to turn the limit off.
+    """
+    _slabMemoryLimit[0] = maxBytes
+
+    _checkSlabMemoryLimit()
+
+
+def _checkSlabMemoryLimit():
+    limit = _slabMemoryLimit[0]
+
+    if limit is not None:
+        excess = totalBytesAllocatedInSlabs() - limit
+
+        if excess > 0:
+            relieveMemoryPressure(excess)
+
+
+def slabInfo():
+    """Return a list with a dict describing each live Slab, largest first.
+
+    Each dict has 'bytecount', 'refcount', 'tag', 'ageSeconds' (since the slab was
+    created) and 'idleSeconds' (since it was last touched).
+    """
+    now = time.time()
+
+    return sorted(
+        [
+            dict(
+                bytecount=slab.bytecount(),
+                refcount=slab.refcount(),
+                tag=slab.getTag(),
+                ageSeconds=now - slab.createdAt(),
+                idleSeconds=now - slab.lastTouched(),
+            )
+            for slab in getAllSlabs()
+        ],
+        key=lambda info: -info['bytecount']
+    )
@@ -0,0 +1,112 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import time
+
+from typed_python import ListOf, totalBytesAllocatedInSlabs
+from typed_python.lib.slab_cache import (
+    SlabCache, slabInfo, relieveMemoryPressure, addMemoryPressureCallback,
+    removeMemoryPressureCallback
+)
+
+
+def makeValue(i):
+    return ListOf(int)(range(i * 1000, i * 1000 + 1000))
+
+
+def test_slab_cache_evicts_least_recently_used():
+    slabBytes0 = totalBytesAllocatedInSlabs()
+
+    cache = SlabCache(name="lru")
+    cache.put(0, makeValue(0))
+    entryBytes = cache.bytecount
+
+    assert entryBytes >= 8000
+
+    cache.maxBytes = entryBytes * 3
+
+    cache.put(1, makeValue(1))
+    cache.put(2, makeValue(2))
+
+    # using 0 makes 1 the oldest
+    assert cache.get(0)[0] == 0
+
+    cache.put(3, makeValue(3))
+
+    assert sorted(cache.keys()) == [0, 2, 3]
+    assert cache.bytecount <= cache.maxBytes
+    assert cache.get(3)[999] == 3999
+
+    cache.clear()
+
+    assert totalBytesAllocatedInSlabs() == slabBytes0
+
+
+def test_slab_touch_and_info():
+    cache = SlabCache(name="info")
+    cache.put("k", makeValue(0))
+
+    info = [i for i in slabInfo() if i['tag'] == ("info", "k")]
+    assert len(info) == 1
+    assert info[0]['bytecount'] >= 8000
+    assert info[0]['ageSeconds'] >= 0
+
+    time.sleep(0.05)
+
+    idleBefore = [i for i in slabInfo() if i['tag'] == ("info", "k")][0]['idleSeconds']
+    cache.get("k")
+    idleAfter = [i for i in slabInfo() if i['tag'] == ("info", "k")][0]['idleSeconds']
+
+    assert idleAfter < idleBefore
+
+    # nothing has been idle for an hour, so we don't advise anything
+    assert cache.adviseCold(3600) == 0
+
+    # the slab is far too small to be mapped on its own, so there's nothing to advise
+    assert cache.adviseCold(0) == 0
+
+
+def test_relieve_memory_pressure_across_caches():
+    c1 = SlabCache(name="c1")
+    c2 = SlabCache(name="c2")
+
+    c1.put(0, makeValue(0))
+    c2.put(0, makeValue(1))
+    c1.put(1, makeValue(2))
+
+    # c1[0] is least recently used once we've touched everything else
+    c2.get(0)
+    c1.get(1)
+
+    freed = relieveMemoryPressure(1)
+
+    assert freed > 0
+    assert 0 not in c1
+    assert 0 in c2 and 1 in c1
+
+    asked = []
+
+    def callback(bytesToFree):
+        asked.append(bytesToFree)
+        return bytesToFree
+
+    addMemoryPressureCallback(callback)
+
+    try:
+        total = c1.bytecount + c2.bytecount
+        assert relieveMemoryPressure(total + 100) == total + 100
+        assert asked == [100]
+        assert len(c1) == len(c2) == 0
+    finally:
+        removeMemoryPressureCallback(callback)
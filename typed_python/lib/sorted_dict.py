@@ -1,3 +1,17 @@
+"""A dictionary that keeps its keys in sorted order.
+
+SortedDict(K, V) is a B+tree. Every node holds up to _MAX_KEYS keys in a
+contiguous ListOf, so a lookup touches a handful of nodes and scans
+their keys in cache, rather than chasing a pointer per comparison. Values live
+only in the leaves, and each leaf links to the next one, so iterating over the
+dict (or any range of it) walks the leaves in order without a stack.
+
+Inner nodes hold separator keys and one more child than they have keys. Every key
+under children[i] is less than keys[i], and every key under children[i + 1] is at
+least keys[i]. All leaves are at the same depth, and every node but the root
+holds at least _MIN_KEYS keys.
+"""
+
 from typed_python import (
     TypeFunction, Class, Member, Final, Entrypoint, OneOf, Generator, Tuple,
     Forward, ListOf
@@ -8,324 +22,443 @@ def less(x, y):
     return x < y
 
 
+_MAX_KEYS = 64
+_MIN_KEYS = _MAX_KEYS // 4
+
+# how full 'bulkLoad' makes each node, leaving room for later inserts
+_BULK_LOAD_KEYS = (_MAX_KEYS * 3) // 4
+
+
+def _insertAt(lst, i, x):
+    lst.append(x)
+
+    j = len(lst) - 1
+    while j > i:
+        lst[j] = lst[j - 1]
+        j -= 1
+
+    lst[i] = x
+
+
+def _evenPieceSizes(count, maxPieceSize):
+    """Split 'count' into as few pieces of at most 'maxPieceSize' as we can, with sizes as equal as possible."""
+    pieceCount = (count + maxPieceSize - 1) // maxPieceSize
+    res = ListOf(int)()
+
+    for i in range(pieceCount):
+        res.append(count // pieceCount + (1 if i < count % pieceCount else 0))
+
+    return res
+
+
 @TypeFunction
 def SortedDict(K, V, comparator=less):
     Node = Forward("Node")
 
     @Node.define
     class Node(Class, Final):
-        key = Member(K)
-        value = Member(V)
+        isLeaf = Member(bool, nonempty=True)
+        keys = Member(ListOf(K), nonempty=True)
+
+        # leaves only: values[i] goes with keys[i]
+        values = Member(ListOf(V), nonempty=True)
 
-        left = Member(OneOf(None, Node), nonempty=True)
-        right = Member(OneOf(None, Node), nonempty=True)
-        count = Member(int, nonempty=True)
+        # leaves only: the leaf holding the next keys in order
+        next = Member(OneOf(None, Node), nonempty=True)
 
-        def __contains__(self, k: K) -> bool:
-            if comparator(k, self.key):
-                if self.left is not None:
-                    return k in self.left
+        # inner nodes only
+        children = Member(ListOf(Node), nonempty=True)
+
+        def lowerBound(self, k: K) -> int:
+            """The index of the first key that isn't less than 'k'."""
+            lo = 0
+            hi = len(self.keys)
+
+            while lo < hi:
+                mid = (lo + hi) // 2
+
+                if comparator(self.keys[mid], k):
+                    lo = mid + 1
                 else:
-                    return False
-            elif comparator(self.key, k):
-                if self.right is not None:
-                    return k in self.right
+                    hi = mid
+
+            return lo
+
+        def upperBound(self, k: K) -> int:
+            """The index of the first key that's greater than 'k'."""
+            lo = 0
+            hi = len(self.keys)
+
+            while lo < hi:
+                mid = (lo + hi) // 2
+
+                if comparator(k, self.keys[mid]):
+                    hi = mid
                 else:
+                    lo = mid + 1
+
+            return lo
+
+        def indexOf(self, k: K) -> int:
+            """For a leaf, the index of 'k', or -1 if it's not here."""
+            i = self.lowerBound(k)
+
+            if i < len(self.keys) and not comparator(k, self.keys[i]):
+                return i
+
+            return -1
+
+        def leafFor(self, k: K) -> Node:
+            """The leaf under us that would hold 'k'."""
+            node = self
+
+            while not node.isLeaf:
+                node = node.children[node.upperBound(k)]
+
+            return node
+
+        def firstLeaf(self) -> Node:
+            node = self
+
+            while not node.isLeaf:
+                node = node.children[0]
+
+            return node
+
+        def lastLeaf(self) -> Node:
+            node = self
+
+            while not node.isLeaf:
+                node = node.children[len(node.children) - 1]
+
+            return node
+
+        def insert(self, k: K, v: V) -> bool:
+            """Set 'k' to 'v'. Return True if 'k' is new.
+
+            Children may come back with too many keys, in which case we split them.
+            The caller does the same for us.
+            """
+            if self.isLeaf:
+                i = self.lowerBound(k)
+
+                if i < len(self.keys) and not comparator(k, self.keys[i]):
+                    self.values[i] = v
                     return False
-            else:
+
+                _insertAt(self.keys, i, k)
+                _insertAt(self.values, i, v)
                 return True
 
-        def get(self, k: K) -> V:
-            if comparator(k, self.key):
-                if self.left is None:
-                    raise KeyError(k)
-                return self.left.get(k)
-            elif comparator(self.key, k):
-                if self.right is None:
-                    raise KeyError(k)
-                return self.right.get(k)
-            else:
-                return self.value
-
-        def set(self, k: K, v: V) -> bool:
-            if comparator(k, self.key):
-                if self.left is None:
-                    self.left = Node(key=k, value=v, count=1)
-                    self.count += 1
-                    return True
-                else:
-                    if self.left.set(k, v):
-                        self.count += 1
-                        self.rebalance()
-                        return True
-                    return False
-            elif comparator(self.key, k):
-                if self.right is None:
-                    self.right = Node(key=k, value=v, count=1)
-                    self.count += 1
-                    return True
-                else:
-                    if self.right.set(k, v):
-                        self.count += 1
-                        self.rebalance()
-                        return True
-                    return False
-            else:
-                self.value = v
+            i = self.upperBound(k)
+            child = self.children[i]
+
+            if not child.insert(k, v):
                 return False
 
-        def first(self) -> K:
-            if self.left is not None:
-                return self.left.first()
-            return self.key
+            if len(child.keys) > _MAX_KEYS:
+                self.splitChild(i)
 
-        def last(self) -> K:
-            if self.right is not None:
-                return self.right.last()
-            return self.key
+            return True
 
-        def become(self, otherNode: Node):
-            self.key = otherNode.key
-            self.value = otherNode.value
-            self.left = otherNode.left
-            self.right = otherNode.right
-            self.count = otherNode.count
+        def splitChild(self, i: int) -> None:
+            """Split children[i] in half, adding the new right half as children[i + 1]."""
+            child = self.children[i]
 
-        def _checkInvariants(self):
-            assert self.count == (
-                1 + (0 if not self.left else self.left.count)
-                + (0 if not self.right else self.right.count)
-            )
-            if self.left:
-                assert comparator(self.left.key, self.key)
-                self.left._checkInvariants()
-
-            if self.right:
-                assert comparator(self.key, self.right.key)
-                self.right._checkInvariants()
+            if child.isLeaf:
+                mid = len(child.keys) // 2
+
+                right = Node(
+                    isLeaf=True,
+                    keys=child.keys[mid:],
+                    values=child.values[mid:],
+                    next=child.next
+                )
+                separator = right.keys[0]
+
+                child.keys = child.keys[:mid]
+                child.values = child.values[:mid]
+                child.next = right
+            else:
+                mid = len(child.keys) // 2
+                separator = child.keys[mid]
+
+                right = Node(
+                    isLeaf=False,
+                    keys=child.keys[mid + 1:],
+                    children=child.children[mid + 1:]
+                )
+
+                child.keys = child.keys[:mid]
+                child.children = child.children[:mid + 1]
+
+            _insertAt(self.keys, i, separator)
+            _insertAt(self.children, i + 1, right)
 
         def remove(self, k: K) -> bool:
-            """Remove 'k' and return True if we are now empty."""
-            if comparator(k, self.key):
-                if self.left is None:
-                    raise KeyError(k)
+            """Remove 'k' from under us, returning False if it wasn't there.
 
-                if self.left.remove(k):
-                    self.left = None
+            Children may come back with too few keys, in which case we merge them
+            with a neighbor. The caller does the same for us.
+            """
+            if self.isLeaf:
+                i = self.indexOf(k)
 
-                self.count -= 1
-                self.rebalance()
-                return False
-            elif comparator(self.key, k):
-                if self.right is None:
-                    raise KeyError(k)
+                if i < 0:
+                    return False
+
+                self.keys.pop(i)
+                self.values.pop(i)
+                return True
 
-                if self.right.remove(k):
-                    self.right = None
+            i = self.upperBound(k)
 
-                self.count -= 1
-                self.rebalance()
+            if not self.children[i].remove(k):
                 return False
+
+            if len(self.children[i].keys) < _MIN_KEYS:
+                self.mergeChild(i)
+
+            return True
+
+        def mergeChild(self, i: int) -> None:
+            """children[i] is too small: merge it with a neighbor, splitting the result again if it's too big."""
+            left = i if i + 1 < len(self.children) else i - 1
+
+            leftChild = self.children[left]
+            rightChild = self.children[left + 1]
+
+            if leftChild.isLeaf:
+                leftChild.keys.extend(rightChild.keys)
+                leftChild.values.extend(rightChild.values)
+                leftChild.next = rightChild.next
             else:
-                if self.count == 1:
-                    return True  # just remove us
+                leftChild.keys.append(self.keys[left])
+                leftChild.keys.extend(rightChild.keys)
+                leftChild.children.extend(rightChild.children)
 
-                if self.left is not None and self.right is None:
-                    # just become 'left'
-                    self.become(self.left)
-                    return False
+            self.keys.pop(left)
+            self.children.pop(left + 1)
 
-                if self.right is not None and self.left is None:
-                    self.become(self.right)
-                    return False
+            if len(leftChild.keys) > _MAX_KEYS:
+                self.splitChild(left)
 
-                if self.right.count < self.left.count:
-                    self.key = self.left.last()
-                    self.value = self.left.get(self.key)
-                    if self.left.remove(self.key):
-                        self.left = None
-                    self.count -= 1
+        def height(self) -> int:
+            res = 1
+            node = self
 
-                    self.rebalance()
-                    return False
-                else:
-                    self.key = self.right.first()
-                    self.value = self.right.get(self.key)
+            while not node.isLeaf:
+                node = node.children[0]
+                res += 1
 
-                    if self.right.remove(self.key):
-                        self.right = None
-                    self.count -= 1
-                    self.rebalance()
-                    return False
+            return res
 
-        def rebalance(self):
-            if self.left is None and self.right is None:
-                assert self.count == 1
-                return
+        def checkInvariants(self, isRoot: bool, lo: OneOf(None, K), hi: OneOf(None, K)) -> int:
+            """Check the node's invariants and return how many keys are under it."""
+            assert isRoot or _MIN_KEYS <= len(self.keys) <= _MAX_KEYS
 
-            if self.left is None and self.right is not None:
-                if self.right.count <= 2:
-                    return
+            for i in range(1, len(self.keys)):
+                assert comparator(self.keys[i - 1], self.keys[i])
 
-                k = self.key
-                v = self.value
-                self.right.set(k, v)
-                self.become(self.right)
-                return
+            if len(self.keys):
+                if lo is not None:
+                    assert not comparator(self.keys[0], lo)
+                if hi is not None:
+                    assert comparator(self.keys[len(self.keys) - 1], hi)
 
-            if self.right is None and self.left is not None:
-                if self.left.count <= 2:
-                    return
+            if self.isLeaf:
+                assert len(self.values) == len(self.keys)
+                assert len(self.children) == 0
+                return len(self.keys)
 
-                k = self.key
-                v = self.value
-                self.left.set(k, v)
-                self.become(self.left)
-                return
+            assert len(self.children) == len(self.keys) + 1
 
-            if self.right is not None and self.left is not None:
-                # both are populated. we should have that the
-                # left count and right count imbalance is no greater than
-                # a factor of two
-                ll = 0 if self.left.left is None else self.left.left.count
-                lr = 0 if self.left.right is None else self.left.right.count
-                rl = 0 if self.right.left is None else self.right.left.count
-                rr = 0 if self.right.right is None else self.right.right.count
-
-                # if ll is much bigger than it should be, make 'll' the
-                # new left side
-                if ll > (3 + lr + rl + rr) * 2:
-                    leftKey = self.left.key
-                    leftVal = self.left.value
-                    rootKey = self.key
-                    rootValue = self.value
-
-                    lNode = self.left
-                    rNode = self.right
-                    llNode = self.left.left
-                    lrNode = self.left.right
-
-                    self.left = llNode
-                    self.key = leftKey
-                    self.value = leftVal
-
-                    self.right = Node(
-                        key=rootKey,
-                        value=rootValue,
-                        left=lrNode,
-                        right=rNode,
-                        count=1 + lr + rNode.count
-                    )
-                    self.count = 1 + self.left.count + self.right.count
-
-                elif rr > (3 + rl + lr + ll) * 2:
-                    rightKey = self.right.key
-                    rightVal = self.right.value
-                    rootKey = self.key
-                    rootValue = self.value
-
-                    lNode = self.left
-                    rNode = self.right
-                    rlNode = self.right.left
-                    rrNode = self.right.right
-
-                    self.right = rrNode
-                    self.key = rightKey
-                    self.value = rightVal
-
-                    self.left = Node(
-                        key=rootKey,
-                        value=rootValue,
-                        left=lNode,
-                        right=rlNode,
-                        count=1 + rl + lNode.count
-                    )
-                    self.count = 1 + self.left.count + self.right.count
+            depth = self.children[0].height()
+            res = 0
 
-        def height(self):
-            return max(
-                0,
-                1 + (0 if self.left is None else self.left.height()),
-                1 + (0 if self.right is None else self.right.height())
-            )
+            for i in range(len(self.children)):
+                assert self.children[i].height() == depth
+
+                res += self.children[i].checkInvariants(
+                    False,
+                    lo if i == 0 else self.keys[i - 1],
+                    hi if i == len(self.keys) else self.keys[i]
+                )
+
+            return res
 
     class SortedDict_(Class, Final):
-        _root = Member(OneOf(None, Node), nonempty=True)
+        _root = Member(Node, nonempty=True)
+        _size = Member(int, nonempty=True)
 
         def __init__(self):
-            pass
+            self._root = Node(isLeaf=True)
 
         def __init__(self, other):  # noqa
+            self._root = Node(isLeaf=True)
+
             for key in other:
                 self[key] = other[key]
 
         def height(self):
-            if self._root is None:
+            if self._size == 0:
                 return 0
             return self._root.height()
 
+        @Entrypoint
+        def bulkLoad(self, keys: ListOf(K), values: ListOf(V)) -> None:
+            """Fill an empty dict from 'keys', which must be strictly increasing, and the matching 'values'.
+
+            This builds the tree bottom up, which is much faster than inserting
+            the keys one at a time, and leaves every node about three quarters full.
+            """
+            if self._size:
+                raise ValueError("bulkLoad requires an empty SortedDict")
+
+            if len(keys) != len(values):
+                raise ValueError("bulkLoad requires as many values as keys")
+
+            for i in range(1, len(keys)):
+                if not comparator(keys[i - 1], keys[i]):
+                    raise ValueError("bulkLoad requires strictly increasing keys")
+
+            if not keys:
+                return
+
+            # build the leaves, then each level of inner nodes over the one below.
+            # 'firstKeys' holds the smallest key under each node of the level.
+            level = ListOf(Node)()
+            firstKeys = ListOf(K)()
+
+            pos = 0
+            for size in _evenPieceSizes(len(keys), _BULK_LOAD_KEYS):
+                leaf = Node(isLeaf=True, keys=keys[pos:pos + size], values=values[pos:pos + size])
+
+                if level:
+                    level[len(level) - 1].next = leaf
+
+                level.append(leaf)
+                firstKeys.append(keys[pos])
+                pos += size
+
+            while len(level) > 1:
+                nextLevel = ListOf(Node)()
+                nextFirstKeys = ListOf(K)()
+
+                pos = 0
+                for size in _evenPieceSizes(len(level), _BULK_LOAD_KEYS + 1):
+                    nextLevel.append(
+                        Node(isLeaf=False, keys=firstKeys[pos + 1:pos + size], children=level[pos:pos + size])
+                    )
+                    nextFirstKeys.append(firstKeys[pos])
+                    pos += size
+
+                level = nextLevel
+                firstKeys = nextFirstKeys
+
+            self._root = level[0]
+            self._size = len(keys)
+
         @Entrypoint
         def __getitem__(self, key) -> V:
-            if self._root is None:
+            leaf = self._root.leafFor(key)
+            i = leaf.indexOf(key)
+
+            if i < 0:
                 raise KeyError(key)
 
-            return self._root.get(key)
+            return leaf.values[i]
 
         @Entrypoint
         def __contains__(self, key) -> bool:
-            if self._root is None:
-                return False
-
-            return key in self._root
+            return self._root.leafFor(key).indexOf(key) >= 0
 
         @Entrypoint
         def __setitem__(self, k: K, v: V) -> None:
-            if self._root is None:
-                self._root = Node(key=k, value=v, count=1)
-            else:
-                self._root.set(k, v)
+            if self._root.insert(k, v):
+                self._size += 1
+
+                if len(self._root.keys) > _MAX_KEYS:
+                    newRoot = Node(isLeaf=False)
+                    newRoot.children.append(self._root)
+                    newRoot.splitChild(0)
+
+                    self._root = newRoot
 
         @Entrypoint
         def __delitem__(self, k: K) -> None:
-            if self._root is None:
+            if not self._remove(k):
                 raise KeyError(k)
 
-            if self._root.remove(k):
-                self._root = None
+        def _remove(self, k: K) -> bool:
+            if not self._root.remove(k):
+                return False
+
+            self._size -= 1
+
+            if not self._root.isLeaf and len(self._root.children) == 1:
+                self._root = self._root.children[0]
+
+            return True
 
         @Entrypoint
         def pop(self, k: K) -> V:
-            if self._root is None:
-                raise KeyError(k)
-
-            res = self._root.get(k)
-            if self._root.remove(k):
-                self._root = None
+            res = self[k]
+            self._remove(k)
             return res
 
         @Entrypoint
         def pop(self, k: K, v: V) -> V:  # noqa
-            if self._root is None or k not in self._root:
+            if k not in self:
                 return v
 
-            res = self._root.get(k)
-            if self._root.remove(k):
-                self._root = None
+            res = self[k]
+            self._remove(k)
             return res
 
         @Entrypoint
         def first(self) -> OneOf(None, K):
-            if self._root is None:
+            if self._size == 0:
                 return None
 
-            return self._root.first()
+            return self._root.firstLeaf().keys[0]
 
         @Entrypoint
         def last(self) -> OneOf(None, K):
-            if self._root is None:
+            if self._size == 0:
                 return None
 
-            return self._root.last()
+            leaf = self._root.lastLeaf()
+
+            return leaf.keys[len(leaf.keys) - 1]
+
+        @Entrypoint
+        def lowerBound(self, k: K) -> OneOf(None, K):
+            """The smallest key that isn't less than 'k', or None if there isn't one."""
+            leaf = self._root.leafFor(k)
+            i = leaf.lowerBound(k)
+
+            if i < len(leaf.keys):
+                return leaf.keys[i]
+
+            if leaf.next is not None:
+                return leaf.next.keys[0]
+
+            return None
+
+        @Entrypoint
+        def upperBound(self, k: K) -> OneOf(None, K):
+            """The smallest key that's greater than 'k', or None if there isn't one."""
+            leaf = self._root.leafFor(k)
+            i = leaf.upperBound(k)
+
+            if i < len(leaf.keys):
+                return leaf.keys[i]
+
+            if leaf.next is not None:
+                return leaf.next.keys[0]
+
+            return None
 
         @Entrypoint
         def get(self, k: K) -> V:
@@ -333,9 +466,13 @@ def SortedDict(K, V, comparator=less):
 
         @Entrypoint
         def get(self, k: K, v: V) -> V:  # noqa
-            if k in self:
-                return self[k]
-            return v
+            leaf = self._root.leafFor(k)
+            i = leaf.indexOf(k)
+
+            if i < 0:
+                return v
+
+            return leaf.values[i]
 
         @Entrypoint
         def setdefault(self, k: K) -> V:
@@ -358,64 +495,75 @@ def SortedDict(K, V, comparator=less):
             return '{' + ",".join(f'{k}: {v}' for k, v in self.items()) + '}'
 
         def __len__(self):
-            return self._root.count if self._root is not None else 0
+            return self._size
 
         @Entrypoint
         def _checkInvariants(self):
-            if not self._root:
-                return
-            self._root._checkInvariants()
+            assert self._root.checkInvariants(True, None, None) == self._size
+
+            # the leaves are linked together in order
+            count = 0
+            leaf = self._root.firstLeaf()
+
+            while True:
+                count += len(leaf.keys)
+
+                nextLeaf = leaf.next
+                if nextLeaf is None:
+                    break
+
+                assert comparator(leaf.keys[len(leaf.keys) - 1], nextLeaf.keys[0])
+                leaf = nextLeaf
+
+            assert count == self._size
 
         @Entrypoint
         def items(self) -> Generator(Tuple(K, V)):
-            stack = ListOf(Tuple(Node, bool))()
-            if self._root is None:
-                return
+            leaf = self._root.firstLeaf()
 
-            stack.append((self._root, True))
+            while True:
+                for i in range(len(leaf.keys)):
+                    yield (leaf.keys[i], leaf.values[i])
 
-            while stack:
-                node, wayDown = stack.pop()
+                nextLeaf = leaf.next
+                if nextLeaf is None:
+                    return
 
-                if wayDown:
-                    if node.left:
-                        stack.append((node, False))
-                        stack.append((node.left, True))
-                    else:
-                        yield (node.key, node.value)
+                leaf = nextLeaf
 
-                        if node.right:
-                            stack.append((node.right, True))
-                else:
-                    yield (node.key, node.value)
+        @Entrypoint
+        def itemsBetween(self, lo: K, hi: K) -> Generator(Tuple(K, V)):
+            """Iterate over the items whose keys are at least 'lo' and less than 'hi', in order."""
+            leaf = self._root.leafFor(lo)
+            i = leaf.lowerBound(lo)
 
-                    if node.right:
-                        stack.append((node.right, True))
+            while True:
+                while i < len(leaf.keys):
+                    if not comparator(leaf.keys[i], hi):
+                        return
 
-        @Entrypoint
-        def __iter__(self) -> Generator(K):
-            stack = ListOf(Tuple(Node, bool))()
-            if self._root is None:
-                return
+                    yield (leaf.keys[i], leaf.values[i])
+                    i += 1
 
-            stack.append((self._root, True))
+                nextLeaf = leaf.next
+                if nextLeaf is None:
+                    return
 
-            while stack:
-                node, wayDown = stack.pop()
+                leaf = nextLeaf
+                i = 0
 
-                if wayDown:
-                    if node.left:
-                        stack.append((node, False))
-                        stack.append((node.left, True))
-                    else:
-                        yield node.key
+        @Entrypoint
+        def __iter__(self) -> Generator(K):
+            leaf = self._root.firstLeaf()
 
-                        if node.right:
-                            stack.append((node.right, True))
-                else:
-                    yield node.key
+            while True:
+                for i in range(len(leaf.keys)):
+                    yield leaf.keys[i]
+
+                nextLeaf = leaf.next
+                if nextLeaf is None:
+                    return
 
-                    if node.right:
-                        stack.append((node.right, True))
+                leaf = nextLeaf
 
     return SortedDict_
@@ -142,3 +142,84 @@ def test_sorted_dict_compiled_iter():
 
     assert addItUp(d) == 45
     assert Entrypoint(addItUp)(d) == 45
+
+
+def test_sorted_dict_bounds():
+    d = SortedDict(int, int)()
+
+    assert d.lowerBound(0) is None
+    assert d.upperBound(0) is None
+
+    for i in range(0, 1000, 10):
+        d[i] = i
+
+    assert d.lowerBound(-5) == 0
+    assert d.lowerBound(10) == 10
+    assert d.lowerBound(11) == 20
+    assert d.upperBound(10) == 20
+    assert d.upperBound(989) == 990
+    assert d.lowerBound(991) is None
+    assert d.upperBound(990) is None
+
+
+def test_sorted_dict_items_between():
+    d = SortedDict(int, int)()
+
+    for i in range(0, 10000, 3):
+        d[i] = -i
+
+    assert list(d.itemsBetween(10, 40)) == [(i, -i) for i in range(12, 40, 3)]
+    assert list(d.itemsBetween(40, 10)) == []
+    assert list(d.itemsBetween(-100, 7)) == [(0, 0), (3, -3), (6, -6)]
+    assert len(list(d.itemsBetween(0, 100000))) == len(d)
+
+
+def test_sorted_dict_bulk_load():
+    for count in [0, 1, 47, 48, 49, 1000, 100000]:
+        d = SortedDict(int, int)()
+        d.bulkLoad(ListOf(int)(range(0, count * 2, 2)), ListOf(int)(range(count)))
+
+        d._checkInvariants()
+
+        assert len(d) == count
+        assert list(d) == list(range(0, count * 2, 2))
+
+        for i in range(0, count, 3):
+            d[i * 2 + 1] = 0
+
+        for i in range(0, count, 2):
+            del d[i * 2]
+
+        d._checkInvariants()
+
+    d = SortedDict(int, int)()
+
+    with pytest.raises(ValueError):
+        d.bulkLoad(ListOf(int)([1, 1]), ListOf(int)([1, 2]))
+
+    d[1] = 1
+
+    with pytest.raises(ValueError):
+        d.bulkLoad(ListOf(int)([2]), ListOf(int)([2]))
+
+
+def test_sorted_dict_matches_dict():
+    numpy.random.seed(43)
+
+    d = SortedDict(int, int)()
+    ref = {}
+
+    for x in numpy.random.choice(3000, size=50000):
+        x = int(x)
+        assert (x in d) == (x in ref)
+
+        if x in ref:
+            del d[x]
+            del ref[x]
+        else:
+            d[x] = x * 2
+            ref[x] = x * 2
+
+    d._checkInvariants()
+
+    assert list(d.items()) == sorted(ref.items())
@@ -12,67 +12,512 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-"""Code for sorting containers."""
+"""Code for sorting containers.
 
-from typed_python import ListOf, Entrypoint
+'sort' is pattern-defeating quicksort (Orson Peters' pdqsort): median-of-three
+(or a ninther, for big ranges) pivots, insertion sort for small ranges, and a
+check for ranges that partitioned without any swaps, which are probably already
+sorted. Runs of equal elements are split off in one pass. Partitions that come
+out badly unbalanced make us shuffle a few elements around, and if that keeps
+happening we fall back to heapsort, so the worst case is O(n log n) and the
+recursion depth is O(log n).
 
+'psort' sorts chunks of a ListOf on the pmap thread pool and then merges them in
+parallel. 'sortIndices' sorts indices into a container instead of moving the
+elements themselves.
 
-def _sortAroundPivot(values, start, end, ixPivot, less):
-    a = values[start]
-    values[start] = values[ixPivot]
-    values[ixPivot] = a
+Without a key, 'sort' doesn't compare ListOf(int) or ListOf(float) elements at
+all. It radix sorts them a byte at a time, least significant byte first, after
+mapping them onto unsigned integers in the same order (flipping the sign bit,
+and for negative floats all the bits). ListOf(str) gets a most-significant-first
+radix sort on codepoints, as long as they fit in a byte.
+"""
 
-    pivot = values[start]
-    i = start + 1
-    j = start + 1
+from typed_python import ListOf, PointerTo, Entrypoint
+from typed_python.lib.pmap import ensureThreads
 
-    while j <= end:
-        if not less(pivot, values[j]):
-            a = values[j]
-            values[j] = values[i]
-            values[i] = a
-            i += 1
-        j += 1
+_INSERTION_SORT_THRESHOLD = 24
+_NINTHER_THRESHOLD = 128
+_PARTIAL_INSERTION_SORT_LIMIT = 8
 
-    a = values[start]
-    values[start] = values[i - 1]
-    values[i - 1] = a
-    return i - 1
+# psort splits the list into at most this many chunks, and doesn't bother
+# with chunks smaller than _MIN_PARALLEL_SORT_CHUNK.
+_MAX_PARALLEL_SORT_CHUNKS = 64
+_MIN_PARALLEL_SORT_CHUNK = 16384
 
 
-def _quicksortBetween(values, start, end, randomSeed, less):
-    if end - start < 1:
+# below this many elements, pdqsort beats a radix sort
+_RADIX_SORT_THRESHOLD = 256
+_STRING_RADIX_SORT_THRESHOLD = 64
+
+# strings sharing a longer prefix than this get compared rather than bucketed further
+_MAX_STRING_RADIX_DEPTH = 256
+
+_SIGN_BIT = -9223372036854775808
+
+
+def _swap(values, i, j):
+    a = values[i]
+    values[i] = values[j]
+    values[j] = a
+
+
+def _sort2(values, i, j, less):
+    if less(values[j], values[i]):
+        _swap(values, i, j)
+
+
+def _sort3(values, i, j, k, less):
+    _sort2(values, i, j, less)
+    _sort2(values, j, k, less)
+    _sort2(values, i, j, less)
+
+
+def _insertionSort(values, begin, end, less):
+    """Sort values[begin:end]."""
+    for cur in range(begin + 1, end):
+        if less(values[cur], values[cur - 1]):
+            tmp = values[cur]
+            sift = cur
+
+            while sift > begin and less(tmp, values[sift - 1]):
+                values[sift] = values[sift - 1]
+                sift -= 1
+
+            values[sift] = tmp
+
+
+def _unguardedInsertionSort(values, begin, end, less):
+    """Sort values[begin:end], assuming values[begin - 1] is no bigger than any of them."""
+    for cur in range(begin + 1, end):
+        if less(values[cur], values[cur - 1]):
+            tmp = values[cur]
+            sift = cur
+
+            while less(tmp, values[sift - 1]):
+                values[sift] = values[sift - 1]
+                sift -= 1
+
+            values[sift] = tmp
+
+
+def _partialInsertionSort(values, begin, end, less):
+    """Try to insertion sort values[begin:end], giving up if it takes too many moves.
+
+    Returns True if the range is now sorted.
+    """
+    moves = 0
+
+    for cur in range(begin + 1, end):
+        if less(values[cur], values[cur - 1]):
+            tmp = values[cur]
+            sift = cur
+
+            while sift > begin and less(tmp, values[sift - 1]):
+                values[sift] = values[sift - 1]
+                sift -= 1
+
+            values[sift] = tmp
+            moves += cur - sift
+
+            if moves > _PARTIAL_INSERTION_SORT_LIMIT:
+                return False
+
+    return True
+
+
+def _siftDown(values, begin, root, size, less):
+    while True:
+        child = 2 * root + 1
+
+        if child >= size:
+            return
+
+        if child + 1 < size and less(values[begin + child], values[begin + child + 1]):
+            child += 1
+
+        if not less(values[begin + root], values[begin + child]):
+            return
+
+        _swap(values, begin + root, begin + child)
+        root = child
+
+
+def _heapSort(values, begin, end, less):
+    """Sort values[begin:end]."""
+    size = end - begin
+
+    root = size // 2 - 1
+    while root >= 0:
+        _siftDown(values, begin, root, size, less)
+        root -= 1
+
+    last = size - 1
+    while last > 0:
+        _swap(values, begin, begin + last)
+        _siftDown(values, begin, 0, last, less)
+        last -= 1
+
+
+def _partitionRight(values, begin, end, less):
+    """Partition values[begin:end] around values[begin], putting elements equal to the pivot on the right.
+
+    Returns:
+        (pivotPos, alreadyPartitioned), where 'alreadyPartitioned' is True if we didn't
+        have to move anything.
+    """
+    pivot = values[begin]
+    first = begin + 1
+    last = end
+
+    # the pivot is a median, so something stops each of these scans
+    while less(values[first], pivot):
+        first += 1
+
+    if first - 1 == begin:
+        while first < last:
+            last -= 1
+
+            if less(values[last], pivot):
+                break
+    else:
+        last -= 1
+
+        while not less(values[last], pivot):
+            last -= 1
+
+    alreadyPartitioned = first >= last
+
+    while first < last:
+        _swap(values, first, last)
+
+        first += 1
+        while less(values[first], pivot):
+            first += 1
+
+        last -= 1
+        while not less(values[last], pivot):
+            last -= 1
+
+    pivotPos = first - 1
+    values[begin] = values[pivotPos]
+    values[pivotPos] = pivot
+
+    return (pivotPos, alreadyPartitioned)
+
+
+def _partitionLeft(values, begin, end, less):
+    """Partition values[begin:end] around values[begin], putting elements equal to the pivot on the left.
+
+    Returns the new position of the pivot. We use this when the pivot equals the
+    element just before the range, in which case everything on the left is equal
+    to it and is done.
+    """
+    pivot = values[begin]
+    first = begin
+    last = end - 1
+
+    while less(pivot, values[last]):
+        last -= 1
+
+    if last + 1 == end:
+        while first < last:
+            first += 1
+
+            if less(pivot, values[first]):
+                break
+    else:
+        first += 1
+
+        while not less(pivot, values[first]):
+            first += 1
+
+    while first < last:
+        _swap(values, first, last)
+
+        last -= 1
+        while less(pivot, values[last]):
+            last -= 1
+
+        first += 1
+        while not less(pivot, values[first]):
+            first += 1
+
+    values[begin] = values[last]
+    values[last] = pivot
+
+    return last
+
+
+def _breakPatterns(values, begin, end, less):
+    """Swap a few elements of values[begin:end] around, so the next pivot choice is different."""
+    size = end - begin
+
+    if size < _INSERTION_SORT_THRESHOLD:
         return
 
-    newRandomSeed = 1013904223 + 1664525 * randomSeed
+    _swap(values, begin, begin + size // 4)
+    _swap(values, end - 1, end - size // 4)
+
+    if size > _NINTHER_THRESHOLD:
+        _swap(values, begin + 1, begin + (size // 4 + 1))
+        _swap(values, begin + 2, begin + (size // 4 + 2))
+        _swap(values, end - 2, end - (size // 4 + 1))
+        _swap(values, end - 3, end - (size // 4 + 2))
+
+
+def _pdqsortLoop(values, begin, end, badAllowed, leftmost, less):
+    """Sort values[begin:end].
+
+    Args:
+        badAllowed - how many more badly unbalanced partitions we put up with
+            before switching to heapsort.
+        leftmost - False if values[begin - 1] is no bigger than anything in the range.
+    """
+    while True:
+        size = end - begin
+
+        if size < _INSERTION_SORT_THRESHOLD:
+            if leftmost:
+                _insertionSort(values, begin, end, less)
+            else:
+                _unguardedInsertionSort(values, begin, end, less)
+            return
+
+        # put the pivot at 'begin'
+        half = size // 2
+
+        if size > _NINTHER_THRESHOLD:
+            _sort3(values, begin, begin + half, end - 1, less)
+            _sort3(values, begin + 1, begin + (half - 1), end - 2, less)
+            _sort3(values, begin + 2, begin + (half + 1), end - 3, less)
+            _sort3(values, begin + (half - 1), begin + half, begin + (half + 1), less)
+            _swap(values, begin, begin + half)
+        else:
+            _sort3(values, begin + half, begin, end - 1, less)
+
+        # if the pivot equals the element before us, everything equal to it goes
+        # on the left, and is already where it belongs.
+        if not leftmost and not less(values[begin - 1], values[begin]):
+            begin = _partitionLeft(values, begin, end, less) + 1
+            continue
+
+        pivotPos, alreadyPartitioned = _partitionRight(values, begin, end, less)
+
+        leftSize = pivotPos - begin
+        rightSize = end - (pivotPos + 1)
+
+        if leftSize < size // 8 or rightSize < size // 8:
+            badAllowed -= 1
+
+            if badAllowed == 0:
+                _heapSort(values, begin, end, less)
+                return
+
+            _breakPatterns(values, begin, pivotPos, less)
+            _breakPatterns(values, pivotPos + 1, end, less)
+        elif (
+            alreadyPartitioned
+            and _partialInsertionSort(values, begin, pivotPos, less)
+            and _partialInsertionSort(values, pivotPos + 1, end, less)
+        ):
+            return
+
+        # the balance check above keeps this recursion O(log n) deep
+        _pdqsortLoop(values, begin, pivotPos, badAllowed, leftmost, less)
+
+        begin = pivotPos + 1
+        leftmost = False
+
+
+def _pdqsort(values, begin, end, less):
+    """Sort values[begin:end] using the strict weak ordering 'less'."""
+    size = end - begin
+    log2 = 0
+
+    while size > 1:
+        size //= 2
+        log2 += 1
+
+    _pdqsortLoop(values, begin, end, log2 + 1, True, less)
+
+
+def _lsdRadixSort(keys: PointerTo(int), count: int):
+    """Sort the 'count' ints at 'keys' as if they were unsigned."""
+    # count how many keys have each value of each byte, all in one pass
+    histograms = ListOf(int)()
+    histograms.resize(8 * 256)
+
+    for i in range(count):
+        k = keys[i]
+
+        for byte in range(8):
+            histograms[byte * 256 + ((k >> (8 * byte)) & 255)] += 1
+
+    scratch = ListOf(int)()
+    scratch.reserve(count)
+
+    src = keys
+    dst = scratch.pointerUnsafe(0)
+    inScratch = False
+
+    for byte in range(8):
+        shift = 8 * byte
+        histogram = histograms.pointerUnsafe(byte * 256)
+
+        # nothing to do if every key has the same value here, which is true of
+        # the high bytes of timestamps and other clustered values.
+        if histogram[(src[0] >> shift) & 255] == count:
+            continue
+
+        total = 0
+        for digit in range(256):
+            digitCount = histogram[digit]
+            histogram[digit] = total
+            total += digitCount
+
+        for i in range(count):
+            k = src[i]
+            digit = (k >> shift) & 255
+            dst[histogram[digit]] = k
+            histogram[digit] += 1
+
+        src, dst = dst, src
+        inScratch = not inScratch
+
+    if inScratch:
+        for i in range(count):
+            keys[i] = src[i]
+
+
+def _radixSortInts(values):
+    keys = values.pointerUnsafe(0)
+
+    for i in range(len(values)):
+        keys[i] = keys[i] ^ _SIGN_BIT
+
+    _lsdRadixSort(keys, len(values))
+
+    for i in range(len(values)):
+        keys[i] = keys[i] ^ _SIGN_BIT
+
+
+def _radixSortFloats(values):
+    # order the bit patterns of the floats like the floats themselves
+    keys = values.pointerUnsafe(0).cast(int)
+
+    for i in range(len(values)):
+        if keys[i] < 0:
+            keys[i] = ~keys[i]
+        else:
+            keys[i] = keys[i] ^ _SIGN_BIT
+
+    _lsdRadixSort(keys, len(values))
+
+    for i in range(len(values)):
+        if keys[i] < 0:
+            keys[i] = keys[i] ^ _SIGN_BIT
+        else:
+            keys[i] = ~keys[i]
+
+
+def _stringBucket(s, depth):
+    """Strings that end before 'depth' go in bucket 0. Otherwise, it's the codepoint at 'depth', plus one."""
+    if len(s) <= depth:
+        return 0
 
-    ixPivot = start + (newRandomSeed) % (end - start + 1)
+    return s._codepointUnsafe(depth) + 1
 
-    i = _sortAroundPivot(values, start, end, ixPivot, less)
-    i_top = i
 
-    # if we have a block of equal values, make sure we don't accidentally have an
-    # n^2 problem with it
-    while i > start and values[i - 1] == values[i]:
-        i -= 1
+def _msdRadixSortStrings(values, begin, end, depth):
+    """Sort values[begin:end], a range of strings that all share their first 'depth' codepoints."""
+    while True:
+        if end - begin < _STRING_RADIX_SORT_THRESHOLD or depth > _MAX_STRING_RADIX_DEPTH:
+            _pdqsort(values, begin, end, lambda x, y: x < y)
+            return
 
-    while i_top < end and values[i_top] == values[i_top + 1]:
-        i_top += 1
+        counts = ListOf(int)()
+        counts.resize(257)
 
-    _quicksortBetween(values, start, i - 1, newRandomSeed, less)
-    _quicksortBetween(values, i_top + 1, end, newRandomSeed + 1, less)
+        for i in range(begin, end):
+            bucket = _stringBucket(values[i], depth)
+
+            if bucket > 256:
+                # a codepoint that doesn't fit in a byte. Since everything
+                # here shares a prefix, comparing whole strings works fine.
+                _pdqsort(values, begin, end, lambda x, y: x < y)
+                return
+
+            counts[bucket] += 1
+
+        if counts[_stringBucket(values[begin], depth)] == end - begin:
+            # they all have the same codepoint here, or all end here
+            if counts[0] == end - begin:
+                return
+
+            depth += 1
+            continue
+
+        starts = ListOf(int)()
+        starts.resize(257)
+
+        pos = begin
+        for bucket in range(257):
+            starts[bucket] = pos
+            pos += counts[bucket]
+
+        nexts = ListOf(int)(starts)
+
+        # move each element into its bucket in place ('American flag sort')
+        for bucket in range(257):
+            bucketEnd = starts[bucket] + counts[bucket]
+
+            while nexts[bucket] < bucketEnd:
+                s = values[nexts[bucket]]
+                target = _stringBucket(s, depth)
+
+                while target != bucket:
+                    displaced = values[nexts[target]]
+                    values[nexts[target]] = s
+                    nexts[target] += 1
+
+                    s = displaced
+                    target = _stringBucket(s, depth)
+
+                values[nexts[bucket]] = s
+                nexts[bucket] += 1
+
+        # bucket 0 is all equal strings
+        for bucket in range(1, 257):
+            if counts[bucket] > 1:
+                _msdRadixSortStrings(values, starts[bucket], starts[bucket] + counts[bucket], depth + 1)
+
+        return
 
 
 @Entrypoint
 def sort(values, key=None):
-    """Perform an in-place sort on 'values', which must be a mutable sequence."""
+    """Perform an in-place sort on 'values', which must be a mutable sequence. The sort is not stable."""
     if len(values) <= 1:
         return
 
+    if key is None and len(values) >= _RADIX_SORT_THRESHOLD:
+        if type(values) is ListOf(int):
+            _radixSortInts(values)
+            return
+
+        if type(values) is ListOf(float):
+            _radixSortFloats(values)
+            return
+
+        if type(values) is ListOf(str):
+            _msdRadixSortStrings(values, 0, len(values), 0)
+            return
+
     if key is None:
-        _quicksortBetween(values, 0, len(values) - 1, 1, lambda x, y: x < y)
+        _pdqsort(values, 0, len(values), lambda x, y: x < y)
     else:
-        _quicksortBetween(values, 0, len(values) - 1, 1, lambda x, y: key(x) < key(y))
+        _pdqsort(values, 0, len(values), lambda x, y: key(x) < key(y))
 
 
 @Entrypoint
@@ -82,6 +527,160 @@ def sorted(values, key=None):
     return valuesCopy
 
 
+@Entrypoint
+def sortIndices(values, key=None):
+    """Return a ListOf(int) of the indices of 'values', ordered so that the values they point to are sorted.
+
+    This sorts the indices rather than the values, so large elements never move.
+    Equal values keep their original order.
+    """
+    indices = ListOf(int)()
+    indices.reserve(len(values))
+
+    for i in range(len(values)):
+        indices.append(i)
+
+    if key is None:
+        _pdqsort(
+            indices, 0, len(indices),
+            lambda i, j: values[i] < values[j] or (not values[j] < values[i] and i < j)
+        )
+    else:
+        _pdqsort(
+            indices, 0, len(indices),
+            lambda i, j: key(values[i]) < key(values[j]) or (not key(values[j]) < key(values[i]) and i < j)
+        )
+
+    return indices
+
+
+def _coRank(src, outCount, aBegin, aEnd, bBegin, bEnd, less):
+    """How many of the first 'outCount' elements of the merge of two sorted runs come from the first one.
+
+    The merge takes from the first run (src[aBegin:aEnd]) whenever the two are equal.
+    """
+    lo = max(0, outCount - (bEnd - bBegin))
+    hi = min(outCount, aEnd - aBegin)
+
+    while lo < hi:
+        fromA = (lo + hi) // 2
+
+        if less(src[bBegin + (outCount - fromA) - 1], src[aBegin + fromA]):
+            hi = fromA
+        else:
+            lo = fromA + 1
+
+    return lo
+
+
+def _mergeInto(src, dst, aIx, aEnd, bIx, bEnd, outIx, outEnd, less):
+    while outIx < outEnd:
+        if bIx >= bEnd or (aIx < aEnd and not less(src[bIx], src[aIx])):
+            dst[outIx] = src[aIx]
+            aIx += 1
+        else:
+            dst[outIx] = src[bIx]
+            bIx += 1
+
+        outIx += 1
+
+
+def _mergeRound(pool, src, dst, runSize, pieceSize, less):
+    """Merge each pair of neighbouring sorted runs of 'src' into 'dst'.
+
+    Each merge is split into pieces of 'pieceSize' outputs, which run in parallel.
+    """
+    count = len(src)
+    piecesPerPair = (2 * runSize + pieceSize - 1) // pieceSize
+    pairCount = (count + 2 * runSize - 1) // (2 * runSize)
+
+    def mergePiece(pieceIx):
+        pairBegin = (pieceIx // piecesPerPair) * 2 * runSize
+        mid = min(count, pairBegin + runSize)
+        pairEnd = min(count, pairBegin + 2 * runSize)
+
+        outBegin = min(pairEnd, pairBegin + (pieceIx % piecesPerPair) * pieceSize)
+        outEnd = min(pairEnd, outBegin + pieceSize)
+
+        if outBegin >= outEnd:
+            return
+
+        fromA = _coRank(src, outBegin - pairBegin, pairBegin, mid, mid, pairEnd, less)
+
+        _mergeInto(
+            src, dst,
+            pairBegin + fromA, mid,
+            mid + (outBegin - pairBegin - fromA), pairEnd,
+            outBegin, outEnd,
+            less
+        )
+
+    pool.parallel_for(pairCount * piecesPerPair, mergePiece, 1)
+
+
+def _copyInParallel(pool, src, dst, pieceSize):
+    count = len(src)
+
+    def copyPiece(pieceIx):
+        for i in range(pieceIx * pieceSize, min(count, (pieceIx + 1) * pieceSize)):
+            dst[i] = src[i]
+
+    pool.parallel_for((count + pieceSize - 1) // pieceSize, copyPiece, 1)
+
+
+def _parallelSort(values, less):
+    count = len(values)
+
+    chunkCount = 1
+    while chunkCount * 2 <= _MAX_PARALLEL_SORT_CHUNKS and chunkCount * 2 * _MIN_PARALLEL_SORT_CHUNK <= count:
+        chunkCount *= 2
+
+    if chunkCount == 1:
+        _pdqsort(values, 0, count, less)
+        return
+
+    pool = ensureThreads()
+    chunkSize = (count + chunkCount - 1) // chunkCount
+
+    def sortChunk(chunkIx):
+        _pdqsort(values, chunkIx * chunkSize, min(count, (chunkIx + 1) * chunkSize), less)
+
+    pool.parallel_for(chunkCount, sortChunk, 1)
+
+    # merge pairs of runs back and forth between 'values' and a scratch copy
+    scratch = ListOf(type(values).ElementType)(values)
+    inScratch = False
+    runSize = chunkSize
+
+    while runSize < count:
+        if inScratch:
+            _mergeRound(pool, scratch, values, runSize, chunkSize, less)
+        else:
+            _mergeRound(pool, values, scratch, runSize, chunkSize, less)
+
+        inScratch = not inScratch
+        runSize *= 2
+
+    if inScratch:
+        _copyInParallel(pool, scratch, values, chunkSize)
+
+
+@Entrypoint
+def psort(values, key=None):
+    """Sort 'values', which must be a ListOf, in place using the pmap thread pool.
+
+    We sort chunks of the list in parallel and then merge them, splitting each merge
+    across the threads too. Small lists are just sorted. The sort is not stable.
+    """
+    if len(values) <= 1:
+        return
+
+    if key is None:
+        _parallelSort(values, lambda x, y: x < y)
+    else:
+        _parallelSort(values, lambda x, y: key(x) < key(y))
+
+
 def compare_values(x, y):
     if x < y:
         return -1
@@ -114,3 +713,108 @@ def searchSorted(item, sortedContainer):
             return mid
 
     return low
+
+
+# how many searches searchSortedMany runs side by side
+_SEARCH_BLOCK_SIZE = 16
+
+
+def _isSortedAscending(values):
+    for i in range(1, len(values)):
+        if values[i] < values[i - 1]:
+            return False
+
+    return True
+
+
+def _lowerBoundsGalloping(sortedContainer, queries, res):
+    """Fill 'res' with the lower bound of each of 'queries', which are sorted, in one pass."""
+    count = len(sortedContainer)
+    pos = 0
+
+    for q in queries:
+        # gallop forward from the last answer, then binary search what we jumped over
+        step = 1
+        lo = pos
+        hi = pos
+
+        while hi < count and sortedContainer[hi] < q:
+            lo = hi + 1
+            hi += step
+            step *= 2
+
+        hi = min(hi, count)
+
+        while lo < hi:
+            mid = (lo + hi) // 2
+
+            if sortedContainer[mid] < q:
+                lo = mid + 1
+            else:
+                hi = mid
+
+        pos = lo
+        res.append(pos)
+
+
+def _lowerBoundsInterleaved(sortedContainer, queries, res):
+    """Fill 'res' with the lower bound of each of 'queries', running blocks of searches in lockstep.
+
+    Each search is branchless, so it takes the same number of steps for every query,
+    and the searches in a block don't depend on each other. The CPU can have all of
+    their memory loads in flight at once, instead of waiting on one cache miss at a time.
+    """
+    count = len(sortedContainer)
+    values = sortedContainer.pointerUnsafe(0)
+
+    bases = ListOf(int)()
+    bases.resize(_SEARCH_BLOCK_SIZE)
+
+    blockStart = 0
+
+    while blockStart < len(queries):
+        blockSize = min(_SEARCH_BLOCK_SIZE, len(queries) - blockStart)
+
+        for j in range(blockSize):
+            bases[j] = 0
+
+        size = count
+
+        while size > 1:
+            half = size // 2
+
+            for j in range(blockSize):
+                b = bases[j]
+                bases[j] = b + half * (values[b + half] < queries[blockStart + j])
+
+            size -= half
+
+        for j in range(blockSize):
+            b = bases[j]
+            res.append(b + (1 if count > 0 and values[b] < queries[blockStart + j] else 0))
+
+        blockStart += blockSize
+
+
+@Entrypoint
+def searchSortedMany(sortedContainer, queries):
+    """Return a ListOf(int) with the lower bound of each of 'queries' in 'sortedContainer'.
+
+    The lower bound of q is the index of the first element that isn't less than q,
+    which is where q is (or would be inserted). Where 'sortedContainer' has no
+    duplicates, this agrees with 'searchSorted'.
+
+    Args:
+        sortedContainer - a sorted ListOf or TupleOf
+        queries - a ListOf or TupleOf of values to look up, in any order. If they're
+            sorted, we find all of them in a single pass over 'sortedContainer'.
+    """
+    res = ListOf(int)()
+    res.reserve(len(queries))
+
+    if _isSortedAscending(queries):
+        _lowerBoundsGalloping(sortedContainer, queries, res)
+    else:
+        _lowerBoundsInterleaved(sortedContainer, queries, res)
+
+    return res
@@ -117,3 +117,112 @@ class TestSorting(unittest.TestCase):
             sorting.sorted(x, key=lambda x: Tuple(int, int)((x % 10, x))),
             sorted(x, key=lambda x: (x % 10, x))
         )
+
+    def test_sort_patterns(self):
+        for length in [0, 1, 2, 23, 24, 25, 129, 1000, 10000]:
+            patterns = {
+                'random': numpy.random.uniform(size=length),
+                'sorted': range(length),
+                'reversed': range(length, 0, -1),
+                'allEqual': [0] * length,
+                'fewValues': numpy.random.choice(4, size=length),
+                'organPipe': list(range(length // 2)) + list(range(length - length // 2, 0, -1)),
+                'sawtooth': [i % 37 for i in range(length)],
+            }
+
+            for name, pattern in patterns.items():
+                x = ListOf(float)(pattern)
+                sorting.sort(x)
+
+                self.assertEqual(x, ListOf(float)(sorted(pattern)), (length, name))
+
+    def test_psort(self):
+        for length in [0, 1, 1000, 100000, 1000001]:
+            x = ListOf(float)(numpy.random.uniform(size=length))
+            expected = ListOf(float)(sorted(x))
+
+            sorting.psort(x)
+
+            self.assertEqual(x, expected)
+
+        x = ListOf(int)(numpy.random.choice(100, size=200000))
+        sorting.psort(x, key=lambda v: -v)
+
+        self.assertEqual(x, ListOf(int)(sorted(x, key=lambda v: -v)))
+
+    def test_sort_indices(self):
+        x = ListOf(int)(numpy.random.choice(100, size=10000))
+
+        self.assertEqual(sorting.sortIndices(x), sorted(range(len(x)), key=lambda i: (x[i], i)))
+        self.assertEqual(
+            sorting.sortIndices(x, key=lambda v: -v),
+            sorted(range(len(x)), key=lambda i: (-x[i], i))
+        )
+        self.assertEqual(sorting.sortIndices(ListOf(str)()), [])
+
+    def test_radix_sort_ints(self):
+        patterns = [
+            numpy.random.randint(-2 ** 63, 2 ** 63 - 1, size=10000, dtype='int64'),
+            1600000000000000000 + numpy.random.randint(0, 10 ** 9, size=10000),
+            numpy.random.randint(-5, 5, size=10000),
+            [2 ** 63 - 1, -2 ** 63, 0, -1, 1] * 100,
+        ]
+
+        for pattern in patterns:
+            x = ListOf(int)(pattern)
+            sorting.sort(x)
+
+            self.assertEqual(x, ListOf(int)(sorted(pattern)))
+
+    def test_radix_sort_floats(self):
+        x = ListOf(float)(numpy.random.uniform(-1e10, 1e10, size=10000))
+        x.extend([0.0, 1e-300, -1e-300, float('inf'), -float('inf'), 5e-324, -5e-324] * 50)
+
+        expected = sorted(x)
+        sorting.sort(x)
+
+        self.assertEqual(x, ListOf(float)(expected))
+
+    def test_radix_sort_strings(self):
+        words = ListOf(str)(
+            "".join(numpy.random.choice(list("abc"), size=numpy.random.randint(0, 12)))
+            for _ in range(10000)
+        )
+        words.extend("x" * 1000 + str(i) for i in range(300))
+        words.extend(["", "a", "ab"] * 100)
+
+        expected = sorted(words)
+        sorting.sort(words)
+
+        self.assertEqual(words, ListOf(str)(expected))
+
+        # codepoints that don't fit in a byte fall back to comparisons
+        words.extend(["abé", "ab一", "a\U0001f600"] * 100)
+
+        expected = sorted(words)
+        sorting.sort(words)
+
+        self.assertEqual(words, ListOf(str)(expected))
+
+    def test_search_sorted_many(self):
+        for length in [0, 1, 2, 17, 1000]:
+            values = ListOf(int)(sorted(numpy.random.choice(100, size=length)))
+
+            for queries in [
+                ListOf(int)(numpy.random.choice(110, size=500) - 5),
+                ListOf(int)(sorted(numpy.random.choice(110, size=500) - 5)),
+                ListOf(int)(),
+            ]:
+                self.assertEqual(
+                    sorting.searchSortedMany(values, queries),
+                    ListOf(int)(numpy.searchsorted(values, queries, side='left'))
+                )
+
+    def test_search_sorted_many_matches_search_sorted(self):
+        values = ListOf(float)(sorted(numpy.random.uniform(size=1000)))
+        queries = ListOf(float)(numpy.random.uniform(size=1000))
+
+        self.assertEqual(
+            sorting.searchSortedMany(values, queries),
+            [sorting.searchSorted(q, values) for q in queries]
+        )
@@ -0,0 +1,69 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python import Class, Member, Final, ListOf
+
+
+class StringBuilder(Class, Final):
+    """Accumulates string pieces and concatenates them once, at the end.
+
+    Usage:
+
+        sb = StringBuilder()
+        for row in rows:
+            sb.add(row.name)
+            sb.add(",")
+        result = sb.build()
+
+    Each '+' on a str allocates and copies a new string, so building up a
+    string with 's += piece' in a loop is quadratic. A StringBuilder just
+    holds on to its pieces, and 'build' joins them with a single allocation
+    at the widest codepoint width any piece needs (see StringType::join).
+
+    Works both in the interpreter and in compiled code.
+    """
+    pieces = Member(ListOf(str), nonempty=True)
+    pointcount = Member(int, nonempty=True)
+
+    def add(self, s: str) -> None:
+        self.pieces.append(s)
+        self.pointcount += len(s)
+
+    def addLine(self, s: str) -> None:
+        self.add(s)
+        self.add("\n")
+
+    def clear(self) -> None:
+        self.pieces.clear()
+        self.pointcount = 0
+
+    def build(self) -> str:
+        if len(self.pieces) == 1:
+            return self.pieces[0]
+
+        res = "".join(self.pieces)
+
+        # keep the joined string, so that building again (or adding more and
+        # then building) doesn't re-copy the pieces we already joined
+        self.pieces.clear()
+        if res:
+            self.pieces.append(res)
+
+        return res
+
+    def __len__(self) -> int:
+        return self.pointcount
+
+    def __str__(self) -> str:
+        return self.build()
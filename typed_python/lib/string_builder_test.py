@@ -0,0 +1,77 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import time
+
+from typed_python import Entrypoint
+from typed_python.lib.string_builder import StringBuilder
+
+
+def test_string_builder_interpreted():
+    sb = StringBuilder()
+
+    assert sb.build() == ""
+    assert len(sb) == 0
+
+    sb.add("abc")
+    sb.add("")
+    sb.add("é")
+    sb.addLine("\U0001f600")
+
+    assert len(sb) == 7
+    assert sb.build() == "abcé\U0001f600\n"
+    assert str(sb) == "abcé\U0001f600\n"
+
+    sb.add("x")
+    assert sb.build() == "abcé\U0001f600\nx"
+
+    sb.clear()
+    assert sb.build() == ""
+    assert len(sb) == 0
+
+
+def test_string_builder_compiled():
+    @Entrypoint
+    def buildWithBuilder(count: int) -> str:
+        sb = StringBuilder()
+        for i in range(count):
+            sb.add(str(i))
+            if i % 1000 == 999:
+                sb.add("ሴ")
+            sb.add(",")
+        return sb.build()
+
+    @Entrypoint
+    def buildWithConcatenation(count: int) -> str:
+        res = ""
+        for i in range(count):
+            res += str(i)
+            if i % 1000 == 999:
+                res += "ሴ"
+            res += ","
+        return res
+
+    assert buildWithBuilder(5000) == buildWithConcatenation(5000)
+
+    t0 = time.time()
+    buildWithBuilder(10000)
+    builderTime = time.time() - t0
+
+    t0 = time.time()
+    buildWithConcatenation(10000)
+    concatTime = time.time() - t0
+
+    print(f"builder: {builderTime}, concatenation: {concatTime}")
+
+    assert builderTime < concatTime
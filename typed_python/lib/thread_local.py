@@ -0,0 +1,110 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Typed per-thread variables.
+
+'threading.local' holds python objects, so compiled code can only reach it
+through the interpreter. 'ThreadLocal(T)' holds a T for each thread, and
+compiled code reaches the calling thread's T with one call into the runtime
+and a bounds check:
+
+    scratch = ThreadLocal(ListOf(float))()
+
+    @Entrypoint
+    def work(values: ListOf(float)):
+        buf = scratch.get()     # this thread's ListOf, shared by reference
+        buf.clear()
+        ...
+
+    calls = ThreadLocal(int)()
+
+    @Entrypoint
+    def countCall():
+        calls.pointer().set(calls.pointer().get() + 1)
+
+Each thread starts with a default-constructed T, made the first time it
+touches the variable. When the thread exits, its T is destroyed, so a T with
+a destructor (a Class with a __del__, say) gets a per-thread cleanup hook.
+
+A ThreadLocal is meant to be a module-level global: its slot in each thread's
+table is never released. A 'pointer()' is only valid on the thread that got
+it, until that thread exits.
+"""
+
+from typed_python import Class, Final, Member, TypeFunction, PointerTo, _types
+from typed_python.compiler.type_wrappers.compilable_builtin import CompilableBuiltin
+from typed_python.compiler.type_wrappers.runtime_functions import externalCallTarget
+import typed_python.compiler.native_ast as native_ast
+import typed_python.compiler
+
+
+_threadLocalSlot = externalCallTarget("tp_thread_local_slot", native_ast.UInt8Ptr, native_ast.Int64)
+
+
+typeWrapper = lambda t: typed_python.compiler.python_object_representation.typedPythonTypeToTypeWrapper(t)
+
+
+class ThreadLocalPointer(CompilableBuiltin):
+    """threadLocalPointer(T, slot) is a PointerTo(T) to the calling thread's T for 'slot'."""
+    def __eq__(self, other):
+        return isinstance(other, ThreadLocalPointer)
+
+    def __hash__(self):
+        return hash("ThreadLocalPointer")
+
+    def __call__(self, T, slot):
+        return _types.threadLocalSlotPointer(slot)
+
+    def convert_call(self, context, expr, args, kwargs):
+        if len(args) != 2 or kwargs or not args[0].isConstant:
+            context.pushException(TypeError, "threadLocalPointer takes a type and a slot")
+            return
+
+        T = args[0].constantValue
+
+        slot = args[1].toInt64()
+        if slot is None:
+            return None
+
+        return context.pushPod(
+            PointerTo(T),
+            _threadLocalSlot.call(slot.nonref_expr).cast(typeWrapper(T).getNativeLayoutType().pointer())
+        )
+
+
+threadLocalPointer = ThreadLocalPointer()
+
+
+@TypeFunction
+def ThreadLocal(T):
+    class ThreadLocal_(Class, Final, __name__=f"ThreadLocal({T.__name__})"):
+        ValueType = T
+
+        _slot = Member(int, nonempty=True)
+
+        def __init__(self):
+            self._slot = _types.allocateThreadLocalSlot(T)
+
+        def pointer(self) -> PointerTo(T):
+            """A pointer to the calling thread's T, valid until the thread exits."""
+            return threadLocalPointer(T, self._slot)
+
+        def get(self) -> T:
+            return threadLocalPointer(T, self._slot).get()
+
+        def set(self, value: T) -> None:
+            threadLocalPointer(T, self._slot).set(value)
+
+    return ThreadLocal_
@@ -0,0 +1,128 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import threading
+import time
+
+import pytest
+
+from typed_python import Class, Member, Entrypoint, ListOf, PointerTo, _types
+from typed_python.lib.thread_local import ThreadLocal
+
+
+counter = ThreadLocal(int)()
+scratch = ThreadLocal(ListOf(float))()
+
+
+@Entrypoint
+def bump(times: int) -> int:
+    for _ in range(times):
+        counter.set(counter.get() + 1)
+    return counter.get()
+
+
+@Entrypoint
+def appendTo(x: float) -> int:
+    buf = scratch.get()
+    buf.append(x)
+    return len(buf)
+
+
+def runOnThreads(f, count):
+    results = [None] * count
+
+    def run(i):
+        results[i] = f(i)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(count)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    return results
+
+
+def test_each_thread_has_its_own_value():
+    assert runOnThreads(lambda i: bump(1000 + i), 4) == [1000, 1001, 1002, 1003]
+
+    before = counter.get()
+    assert bump(5) == before + 5
+
+
+def test_interpreter_and_compiled_code_see_the_same_value():
+    def run(i):
+        counter.set(10 * i)
+        bump(1)
+        return counter.get(), counter.pointer().get()
+
+    assert runOnThreads(run, 3) == [(1, 1), (11, 11), (21, 21)]
+
+
+def test_values_are_shared_by_reference():
+    def run(i):
+        for k in range(i + 1):
+            appendTo(k)
+        return list(scratch.get())
+
+    assert runOnThreads(run, 3) == [[0.0], [0.0, 1.0], [0.0, 1.0, 2.0]]
+
+
+def test_pointer_in_compiled_code():
+    @Entrypoint
+    def pointer() -> PointerTo(int):
+        return counter.pointer()
+
+    def run(i):
+        pointer().set(i)
+        return counter.get()
+
+    assert runOnThreads(run, 3) == [0, 1, 2]
+
+
+class OnThreadExit(Class):
+    exits = Member(ListOf(int))
+    threadIx = Member(int)
+
+    def __del__(self):
+        self.exits.append(self.threadIx)
+
+
+def test_thread_exit_destroys_the_value():
+    exits = ListOf(int)()
+    hook = ThreadLocal(OnThreadExit)()
+
+    def run(i):
+        hook.set(OnThreadExit(exits=exits, threadIx=i))
+
+    runOnThreads(run, 3)
+
+    # 'join' returns before the thread's native thread-locals are destroyed
+    deadline = time.time() + 5.0
+    while len(exits) < 3 and time.time() < deadline:
+        time.sleep(0.01)
+
+    assert sorted(exits) == [0, 1, 2]
+
+
+def test_requires_default_constructible_types():
+    class NoDefault(Class):
+        def __init__(self, x):
+            pass
+
+    with pytest.raises(TypeError):
+        ThreadLocal(NoDefault)()
+
+    with pytest.raises(IndexError):
+        _types.threadLocalSlotPointer(-1)
@@ -0,0 +1,650 @@
+#   Copyright 2017-2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A pool of worker threads that balance work by stealing it from each other.
+
+Work comes in as a ParallelTask over a range of indices. Each worker owns a
+deque of (task, lo, hi) ranges. To run a range, a worker splits it in half,
+pushing the upper half onto the bottom of its own deque, until what's left is
+no bigger than the task's grain. It runs that piece, then pops the next range off
+the bottom of its own deque. A worker whose deque is empty steals from the top of
+somebody else's, which is where the oldest (and so the biggest) ranges are. Skewed
+per-item costs even out, because whoever finishes early steals the rest.
+
+Each deque has its own lock, so workers only contend when one of them is out of
+work, rather than on every item as with a single shared queue.
+
+The thread that submits a task works on it too, until there's nothing left to
+take. Threads outside the pool share one extra deque for this. A worker that
+submits a task (a parallel_for inside a parallel_for) uses its own deque, so
+nested calls can't deadlock.
+
+The pool also runs Futures: single calls that run in the background, and can
+depend on each other.
+
+    parsed = pool.submit(lambda: parse(text), ListOf(float))
+    total = parsed.then(lambda values: sum(values), float)
+    both = pool.whenAll(ListOf(Future(float))([total, otherTotal]))
+
+    both.result()   # a ListOf(float), once both totals are known
+
+A Future is a ParallelTask over a range of one index, so it's queued and
+stolen like any other work. It's queued once every Future it depends on has
+finished, by whichever thread finished the last of them, so a pipeline of
+stages runs without anybody waiting in between. 'result' blocks, running other
+queued work on the calling thread while it waits. Inside a task, prefer 'then'
+and 'whenAll' to 'result', since a worker blocked in 'result' is one fewer
+worker to run whatever it's waiting for.
+"""
+
+import threading
+from threading import Lock
+from typed_python import (
+    Class, Final, Member, ListOf, Dict, OneOf, Tuple, TypeFunction, NotCompiled, Entrypoint, Forward
+)
+from typed_python.typed_queue import TypedQueue
+
+
+_workerState = threading.local()
+
+_poolIds = [0]
+
+
+class ParallelTask(Class):
+    """Some work to do for each index in range(count).
+
+    Subclasses set their own members, call '_initialize', and override
+    'runRange'. Everything else is safe to call from any thread.
+    """
+    grain = Member(int)
+    _remaining = Member(int)
+    _lock = Member(Lock)
+    _finished = Member(TypedQueue(int))
+    _exceptionIndex = Member(int)
+    _exception = Member(object)
+
+    def _initialize(self, count: int, grain: int) -> None:
+        self.grain = max(1, grain)
+        self._remaining = count
+        self._lock = Lock()
+        self._finished = TypedQueue(int)()
+        self._exceptionIndex = -1
+        self._exception = None
+
+    def runRange(self, lo: int, hi: int) -> None:
+        """Do the work for the indices in [lo, hi). Report failures with 'recordException'."""
+        pass
+
+    def recordException(self, index: int, exception: object) -> None:
+        """Remember that 'index' raised 'exception', if it's the earliest index to have raised."""
+        with self._lock:
+            if self._exceptionIndex < 0 or index < self._exceptionIndex:
+                self._exceptionIndex = index
+                self._exception = exception
+
+    def exception(self) -> object:
+        """The exception raised by the earliest index that raised one, or None."""
+        with self._lock:
+            return self._exception
+
+    def markCompleted(self, count: int) -> None:
+        with self._lock:
+            self._remaining -= count
+
+            if self._remaining == 0:
+                self._finished.put(0)
+
+    def isFinished(self) -> bool:
+        with self._lock:
+            return self._remaining == 0
+
+    def waitUntilFinished(self) -> None:
+        """Block until every index has completed. Only one thread may wait on a task."""
+        self._finished.get()
+
+
+@TypeFunction
+def ForEachTask(FuncT):
+    class ForEachTask(ParallelTask, Final):
+        f = Member(FuncT)
+
+        def __init__(self, f, count, grain):
+            self.f = f
+            self._initialize(count, grain)
+
+        def runRange(self, lo: int, hi: int) -> None:
+            try:
+                for i in range(lo, hi):
+                    self.f(i)
+            except Exception as e:
+                self.recordException(i, e)
+
+    return ForEachTask
+
+
+@TypeFunction
+def ReduceTask(FuncT, CombineT, T):
+    class ReduceTask(ParallelTask, Final):
+        """Reduce each grain-aligned chunk of the range separately, then combine the chunks in order.
+
+        Because the chunks are combined left to right, 'combine' only needs to be associative.
+        """
+        f = Member(FuncT)
+        combine = Member(CombineT)
+        count = Member(int)
+        _partials = Member(Dict(int, T))
+
+        def __init__(self, f, combine, count, grain):
+            self.f = f
+            self.combine = combine
+            self.count = count
+            self._partials = Dict(int, T)()
+            self._initialize(count, grain)
+
+        def runRange(self, lo: int, hi: int) -> None:
+            i = lo
+
+            try:
+                partial = self.f(lo)
+
+                for i in range(lo + 1, hi):
+                    partial = self.combine(partial, self.f(i))
+
+                with self._lock:
+                    self._partials[lo // self.grain] = partial
+            except Exception as e:
+                self.recordException(i, e)
+
+        def result(self, initial: T) -> T:
+            res = initial
+
+            for chunkIx in range((self.count + self.grain - 1) // self.grain):
+                res = self.combine(res, self._partials[chunkIx])
+
+            return res
+
+    return ReduceTask
+
+
+WorkItem = Tuple(ParallelTask, int, int)
+
+
+class WorkDeque(Class, Final):
+    """The ranges of work queued up by one worker.
+
+    The owner pushes and pops at the bottom. Thieves take from the top.
+    """
+    # stolen items are replaced with None so we don't keep their tasks alive
+    _items = Member(ListOf(OneOf(None, WorkItem)))
+    _top = Member(int)
+    _lock = Member(Lock)
+
+    def __init__(self):
+        self._items = ListOf(OneOf(None, WorkItem))()
+        self._top = 0
+        self._lock = Lock()
+
+    @Entrypoint
+    def push(self, task: ParallelTask, lo: int, hi: int) -> None:
+        with self._lock:
+            self._items.append(WorkItem((task, lo, hi)))
+
+    @Entrypoint
+    def pop(self) -> OneOf(None, WorkItem):
+        """Take the newest range, or return None if we're empty."""
+        with self._lock:
+            if len(self._items) == self._top:
+                return None
+
+            res = self._items.pop()
+
+            if len(self._items) == self._top:
+                self._items.clear()
+                self._top = 0
+
+            return res
+
+    @Entrypoint
+    def steal(self) -> OneOf(None, WorkItem):
+        """Take the oldest range, or return None if we're empty."""
+        with self._lock:
+            if len(self._items) == self._top:
+                return None
+
+            res = self._items[self._top]
+            self._items[self._top] = None
+            self._top += 1
+
+            if len(self._items) == self._top:
+                self._items.clear()
+                self._top = 0
+
+            return res
+
+
+class ThreadPool(Class, Final):
+    """A fixed set of daemon threads that run ParallelTasks, stealing work from each other.
+
+    Usable from compiled code and from the interpreter:
+
+        pool = ThreadPool(8)
+
+        pool.parallel_for(len(x), lambda i: ...)
+        total = pool.parallel_reduce(len(x), lambda i: x[i], lambda a, b: a + b, 0.0)
+    """
+    threadCount = Member(int)
+    _id = Member(int)
+
+    # one deque per worker, and a last one shared by threads outside the pool
+    _deques = Member(ListOf(WorkDeque))
+
+    # workers that run out of work sleep on '_wakeups'. '_idleWorkers' counts them.
+    _lock = Member(Lock)
+    _idleWorkers = Member(int)
+    _wakeups = Member(TypedQueue(int))
+
+    def __init__(self, threadCount):
+        assert threadCount > 0
+
+        _poolIds[0] += 1
+
+        self.threadCount = threadCount
+        self._id = _poolIds[0]
+        self._deques = ListOf(WorkDeque)([WorkDeque() for _ in range(threadCount + 1)])
+        self._lock = Lock()
+        self._idleWorkers = 0
+        self._wakeups = TypedQueue(int)()
+
+        for workerIx in range(threadCount):
+            threading.Thread(target=_workerLoop, args=(self, workerIx), daemon=True).start()
+
+    @Entrypoint
+    def defaultGrain(self, count: int) -> int:
+        """A grain that gives each thread a few dozen pieces to share out."""
+        return max(1, count // ((self.threadCount + 1) * 32))
+
+    @Entrypoint
+    def parallel_for(self, count, f, grain=0):
+        """Call 'f(i)' for every i in range(count), in parallel.
+
+        Args:
+            count - the number of indices
+            f - a function of one integer
+            grain - the largest range of indices we run without splitting it
+                further. If 0, we pick one based on 'count' and the number of threads.
+
+        If any call raises, we raise the exception from the lowest index that did,
+        after every other index has been tried.
+        """
+        task = ForEachTask(type(f))(f, count, grain if grain > 0 else self.defaultGrain(count))
+
+        self.runTask(task, count)
+
+        exception = task.exception()
+
+        if exception is not None:
+            raise exception
+
+    @Entrypoint
+    def parallel_reduce(self, count, f, combine, initial, grain=0):
+        """Return 'initial' combined with 'f(i)' for every i in range(count), computed in parallel.
+
+        The result is the same as
+
+            res = initial
+            for i in range(count):
+                res = combine(res, f(i))
+
+        except that the calls to 'combine' are grouped differently, so 'combine'
+        must be associative. Partial results have the type of 'initial'.
+        """
+        task = ReduceTask(type(f), type(combine), type(initial))(
+            f, combine, count, grain if grain > 0 else self.defaultGrain(count)
+        )
+
+        self.runTask(task, count)
+
+        exception = task.exception()
+
+        if exception is not None:
+            raise exception
+
+        return task.result(initial)
+
+    @Entrypoint
+    def submit(self, f, OutT):
+        """Call 'f()' on the pool, returning a Future(OutT) for its result."""
+        res = CallTask(type(f), OutT)(self, f)
+        res._dependencyFinished()
+        return res
+
+    @Entrypoint
+    def whenAll(self, futures):
+        """Return a Future for a ListOf the results of a ListOf(Future(T)), once all of them finish.
+
+        If any of them raised, it raises the exception from the earliest one that did.
+        """
+        res = WhenAllTask(futures.ElementType.ValueType)(self, futures)
+
+        for future in futures:
+            future._addDependent(res)
+
+        res._dependencyFinished()
+        return res
+
+    @Entrypoint
+    def runTask(self, task: ParallelTask, count: int) -> None:
+        """Run 'task' over range(count), returning once every index has completed.
+
+        Exceptions are left in the task for the caller to deal with.
+        """
+        if count <= 0:
+            return
+
+        self.submitTask(task, count)
+        self.workUntilFinished(task)
+
+    @Entrypoint
+    def submitTask(self, task: ParallelTask, count: int) -> None:
+        """Queue 'task' over range(count), and return without waiting for it."""
+        self._deques[self._callerDequeIndex()].push(task, 0, count)
+        self._wakeIdleWorker()
+
+    @Entrypoint
+    def workUntilFinished(self, task: ParallelTask) -> None:
+        """Run queued work on this thread until 'task' finishes."""
+        dequeIx = self._callerDequeIndex()
+
+        while not task.isFinished():
+            item = self._findWork(dequeIx)
+
+            if item is None:
+                # whatever is left of 'task' is running on other threads
+                task.waitUntilFinished()
+                return
+
+            self._runItem(dequeIx, item[0], item[1], item[2])
+
+    @Entrypoint
+    def _callerDequeIndex(self) -> int:
+        dequeIx = _workerIndex(self._id)
+
+        if dequeIx < 0:
+            return self.threadCount
+
+        return dequeIx
+
+    @Entrypoint
+    def _runItem(self, dequeIx: int, task: ParallelTask, lo: int, hi: int) -> None:
+        while hi - lo > task.grain:
+            # split on a multiple of the grain, so every piece we run is grain-aligned
+            chunks = (hi - lo + task.grain - 1) // task.grain
+            mid = lo + (chunks // 2) * task.grain
+
+            self._deques[dequeIx].push(task, mid, hi)
+            self._wakeIdleWorker()
+
+            hi = mid
+
+        task.runRange(lo, hi)
+        task.markCompleted(hi - lo)
+
+    @Entrypoint
+    def _findWork(self, dequeIx: int) -> OneOf(None, WorkItem):
+        item = self._deques[dequeIx].pop()
+
+        if item is not None:
+            return item
+
+        for i in range(1, len(self._deques)):
+            item = self._deques[(dequeIx + i) % len(self._deques)].steal()
+
+            if item is not None:
+                return item
+
+        return None
+
+    @Entrypoint
+    def _wakeIdleWorker(self) -> None:
+        with self._lock:
+            if self._idleWorkers > 0:
+                self._idleWorkers -= 1
+                self._wakeups.put(0)
+
+    @Entrypoint
+    def _waitForWork(self) -> None:
+        with self._lock:
+            self._idleWorkers += 1
+
+        self._wakeups.get()
+
+    @Entrypoint
+    def _workUntilIdle(self, workerIx: int) -> None:
+        while True:
+            item = self._findWork(workerIx)
+
+            if item is None:
+                return
+
+            self._runItem(workerIx, item[0], item[1], item[2])
+
+
+@NotCompiled
+def _setWorkerIndex(poolId: int, workerIx: int) -> None:
+    _workerState.poolId = poolId
+    _workerState.workerIx = workerIx
+
+
+@NotCompiled
+def _workerIndex(poolId: int) -> int:
+    """The index of the current thread in the pool with id 'poolId', or -1 if it isn't one of its workers."""
+    if getattr(_workerState, 'poolId', None) == poolId:
+        return _workerState.workerIx
+
+    return -1
+
+
+@Entrypoint
+def _workerLoop(pool: ThreadPool, workerIx: int):
+    _setWorkerIndex(pool._id, workerIx)
+
+    while True:
+        pool._waitForWork()
+        pool._workUntilIdle(workerIx)
+
+
+FutureBase = Forward("FutureBase")
+
+
+@FutureBase.define
+class FutureBase(ParallelTask):
+    """The untyped part of a Future: when it runs, and who's waiting on it.
+
+    A Future runs once '_blockedOn' reaches zero. It starts at one more than
+    the number of Futures it depends on, and whoever creates it releases that
+    extra one (with '_dependencyFinished') once it's registered with all of
+    them, so it can't run before then.
+    """
+    _pool = Member(ThreadPool)
+    _blockedOn = Member(int)
+    _done = Member(bool)
+
+    # Futures that depend on us, and that we notify when we finish
+    _dependents = Member(ListOf(FutureBase))
+
+    # how many threads are blocked in 'waitUntilFinished'. Each gets one item from '_finished'.
+    _waiters = Member(int)
+
+    def _initializeFuture(self, pool: ThreadPool, dependencyCount: int) -> None:
+        self._initialize(1, 1)
+        self._pool = pool
+        self._blockedOn = dependencyCount + 1
+        self._done = False
+        self._dependents = ListOf(FutureBase)()
+        self._waiters = 0
+
+    def done(self) -> bool:
+        """Has this finished, either with a result or an exception?"""
+        with self._lock:
+            return self._done
+
+    def wait(self) -> None:
+        """Block until this finishes, running other queued work in the meantime."""
+        self._pool.workUntilFinished(self)
+
+    def _addDependent(self, dependent: FutureBase) -> None:
+        with self._lock:
+            if not self._done:
+                self._dependents.append(dependent)
+                return
+
+        dependent._dependencyFinished()
+
+    def _dependencyFinished(self) -> None:
+        with self._lock:
+            self._blockedOn -= 1
+            ready = self._blockedOn == 0
+
+        if ready:
+            self._pool.submitTask(self, 1)
+
+    def markCompleted(self, count: int) -> None:
+        with self._lock:
+            self._remaining -= count
+            self._done = True
+
+            dependents = self._dependents
+            self._dependents = ListOf(FutureBase)()
+
+            for _ in range(self._waiters):
+                self._finished.put(0)
+            self._waiters = 0
+
+        for dependent in dependents:
+            dependent._dependencyFinished()
+
+    def waitUntilFinished(self) -> None:
+        with self._lock:
+            if self._done:
+                return
+            self._waiters += 1
+
+        self._finished.get()
+
+
+@TypeFunction
+def Future(T):
+    class Future_(FutureBase, __name__=f"Future({T.__name__})"):
+        """A T that's being computed on a ThreadPool."""
+        ValueType = T
+
+        # empty until we've finished without raising
+        _value = Member(ListOf(T), nonempty=True)
+
+        def result(self) -> T:
+            """Wait for the value, raising the exception it raised if it did."""
+            self.wait()
+
+            exception = self.exception()
+
+            if exception is not None:
+                raise exception
+
+            return self._value[0]
+
+        def then(self, f, OutT):
+            """Return a Future(OutT) for 'f' of our result, which runs once we've finished.
+
+            If we raise, it raises the same exception without calling 'f'.
+            """
+            res = ThenTask(type(f), T, OutT)(self._pool, self, f)
+            self._addDependent(res)
+            res._dependencyFinished()
+            return res
+
+        def _setResult(self, value: T) -> None:
+            self._value.append(value)
+
+    return Future_
+
+
+@TypeFunction
+def CallTask(FuncT, T):
+    class CallTask(Future(T), Final):
+        f = Member(FuncT)
+
+        def __init__(self, pool, f):
+            self.f = f
+            self._initializeFuture(pool, 0)
+
+        def runRange(self, lo: int, hi: int) -> None:
+            try:
+                self._setResult(self.f())
+            except Exception as e:
+                self.recordException(0, e)
+
+    return CallTask
+
+
+@TypeFunction
+def ThenTask(FuncT, InT, T):
+    class ThenTask(Future(T), Final):
+        f = Member(FuncT)
+        source = Member(Future(InT))
+
+        def __init__(self, pool, source, f):
+            self.f = f
+            self.source = source
+            self._initializeFuture(pool, 1)
+
+        def runRange(self, lo: int, hi: int) -> None:
+            exception = self.source.exception()
+
+            if exception is not None:
+                self.recordException(0, exception)
+                return
+
+            try:
+                self._setResult(self.f(self.source._value[0]))
+            except Exception as e:
+                self.recordException(0, e)
+
+    return ThenTask
+
+
+@TypeFunction
+def WhenAllTask(T):
+    class WhenAllTask(Future(ListOf(T)), Final):
+        sources = Member(ListOf(Future(T)))
+
+        def __init__(self, pool, sources):
+            self.sources = sources
+            self._initializeFuture(pool, len(sources))
+
+        def runRange(self, lo: int, hi: int) -> None:
+            values = ListOf(T)()
+
+            for source in self.sources:
+                exception = source.exception()
+
+                if exception is not None:
+                    self.recordException(0, exception)
+                    return
+
+                values.append(source._value[0])
+
+            self._setResult(values)
+
+    return WhenAllTask
@@ -0,0 +1,198 @@
+#   Copyright 2017-2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import ListOf, Entrypoint
+from typed_python.lib.thread_pool import ThreadPool, Future
+
+pool = ThreadPool(4)
+
+
+def test_parallel_for_visits_every_index_once():
+    counts = ListOf(int)()
+    counts.resize(10000)
+
+    def visit(i):
+        counts[i] += 1
+
+    pool.parallel_for(len(counts), visit)
+
+    assert counts == [1] * len(counts)
+
+
+def test_parallel_for_with_explicit_grain():
+    for count in [0, 1, 7, 100, 1001]:
+        for grain in [1, 3, 64, 5000]:
+            counts = ListOf(int)()
+            counts.resize(count)
+
+            def visit(i):
+                counts[i] += 1
+
+            pool.parallel_for(count, visit, grain)
+
+            assert counts == [1] * count, (count, grain)
+
+
+def test_parallel_for_raises_earliest_exception():
+    def sometimesThrows(i):
+        if i % 1000 == 937:
+            raise ZeroDivisionError(f"index {i}")
+
+    with pytest.raises(ZeroDivisionError, match="index 937$"):
+        pool.parallel_for(10000, sometimesThrows, 10)
+
+
+def test_parallel_reduce():
+    values = ListOf(float)([i * 0.25 for i in range(100000)])
+
+    def at(i):
+        return values[i]
+
+    def add(x, y):
+        return x + y
+
+    assert pool.parallel_reduce(len(values), at, add, 0.0) == sum(values)
+    assert pool.parallel_reduce(0, at, add, 3.0) == 3.0
+
+
+def test_parallel_reduce_combines_in_order():
+    def digit(i):
+        return str(i % 10)
+
+    def concat(x, y):
+        return x + y
+
+    expected = "".join(str(i % 10) for i in range(1000))
+
+    assert pool.parallel_reduce(1000, digit, concat, "", 7) == expected
+
+
+def test_nested_parallel_for():
+    counts = ListOf(int)()
+    counts.resize(100 * 100)
+
+    def inner(i):
+        def visit(j):
+            counts[i * 100 + j] += 1
+
+        pool.parallel_for(100, visit, 1)
+
+    pool.parallel_for(100, inner, 1)
+
+    assert counts == [1] * len(counts)
+
+
+def test_parallel_for_from_compiled_code():
+    @Entrypoint
+    def squares(p: ThreadPool, n: int):
+        res = ListOf(int)()
+        res.resize(n)
+
+        def square(i):
+            res[i] = i * i
+
+        p.parallel_for(n, square)
+
+        return res
+
+    assert squares(pool, 1000) == [i * i for i in range(1000)]
+
+
+def test_skewed_work_is_balanced():
+    # the first few items cost far more than the rest. With fixed chunks,
+    # whoever gets the expensive chunk does all the work.
+    def cost(i):
+        res = 0
+        for j in range(100000 if i < 4 else 10):
+            res += j
+        return res
+
+    def add(x, y):
+        return x + y
+
+    assert pool.parallel_reduce(10000, cost, add, 0) == sum(cost(i) for i in range(10000))
+
+
+def slowSum(n):
+    res = 0
+    for i in range(n):
+        res += i
+    return res
+
+
+def sumUpTo(n):
+    return lambda: slowSum(n)
+
+
+def test_submit_and_result():
+    futures = [pool.submit(sumUpTo(n), int) for n in range(100)]
+
+    assert [f.result() for f in futures] == [slowSum(n) for n in range(100)]
+    assert all(f.done() for f in futures)
+
+
+def test_futures_from_compiled_code():
+    @Entrypoint
+    def pipeline(p: ThreadPool, n: int):
+        futures = ListOf(Future(int))()
+
+        for i in range(n):
+            futures.append(p.submit(sumUpTo(i), int).then(lambda x: x + 1, int))
+
+        return p.whenAll(futures).result()
+
+    assert pipeline(pool, 100) == [slowSum(i) + 1 for i in range(100)]
+
+
+def test_then_chains():
+    future = pool.submit(lambda: "a", str)
+
+    for _ in range(10):
+        future = future.then(lambda s: s + "b", str)
+
+    assert future.result() == "a" + "b" * 10
+
+    # 'then' on a future that already finished still runs
+    assert future.then(len, int).result() == 11
+
+
+def test_exceptions_propagate():
+    def fails():
+        raise ZeroDivisionError("no")
+
+    failed = pool.submit(fails, int)
+    following = failed.then(lambda x: x + 1, int)
+    ok = pool.submit(lambda: 1, int)
+
+    with pytest.raises(ZeroDivisionError):
+        following.result()
+
+    with pytest.raises(ZeroDivisionError):
+        pool.whenAll(ListOf(Future(int))([ok, failed])).result()
+
+    assert ok.result() == 1
+
+
+def test_when_all_of_nothing():
+    assert pool.whenAll(ListOf(Future(float))()).result() == []
+
+
+def test_many_threads_wait_on_one_future():
+    gate = pool.submit(lambda: sum(range(100000)), int)
+
+    waiters = pool.parallel_reduce(64, lambda i: gate.result(), lambda x, y: x + y, 0, 1)
+
+    assert waiters == 64 * sum(range(100000))
@@ -13,7 +13,8 @@
 #   limitations under the License.
 
 
-from typed_python import Class, Final, Member, Held
+from typed_python import Class, Final, Member, Held, ListOf, Entrypoint
+from typed_python.lib.sorting import sort, searchSorted, searchSortedMany
 from typed_python.lib.datetime.date_parser import DateParser
 from typed_python.lib.datetime.date_formatter import DateFormatter
 from typed_python.lib.datetime.date_time import UTC, NYC, Timezone
@@ -135,3 +136,171 @@ class Timestamp(Class, Final):
 
         """
         return timezone.datetime(self.ts).date.quarterOfYear()
+
+
+class TimestampColumn(Class, Final):
+    """A column of unix timestamps, stored contiguously as a ListOf(float).
+
+    A ListOf(Timestamp) holds an object per element. This holds just the numbers,
+    so the operations on the whole column below are tight compiled loops. The
+    numbers themselves are in 'ts', which can go straight to anything that takes
+    a ListOf(float), like the functions in typed_python.lib.sorting.
+    """
+
+    ts = Member(ListOf(float))
+
+    @staticmethod
+    def parse(date_strs: ListOf(str)):
+        """Parse a column of date strings, as Timestamp.parse would parse each of them."""
+        return TimestampColumn(ts=DateParser.parseMany(date_strs))
+
+    def __len__(self) -> int:
+        return len(self.ts)
+
+    def __getitem__(self, i: int) -> Timestamp:
+        return Timestamp(ts=self.ts[i])
+
+    def append(self, timestamp: Timestamp) -> None:
+        self.ts.append(timestamp.ts)
+
+    @Entrypoint
+    def __add__(self, seconds: float):
+        """A column with every timestamp moved 'seconds' later."""
+        res = ListOf(float)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            res.append(ts + seconds)
+
+        return TimestampColumn(ts=res)
+
+    @Entrypoint
+    def __sub__(self, other) -> ListOf(float):
+        """The number of seconds from each of 'other's timestamps to ours.
+
+        Parameters
+        ----------
+        other : TimestampColumn
+            A column of the same length.
+        """
+        assert len(other.ts) == len(self.ts)
+
+        res = ListOf(float)()
+        res.reserve(len(self.ts))
+
+        for i in range(len(self.ts)):
+            res.append(self.ts[i] - other.ts[i])
+
+        return res
+
+    @Entrypoint
+    def isBefore(self, timestamp: Timestamp) -> ListOf(bool):
+        """For each timestamp, whether it's strictly before 'timestamp'."""
+        res = ListOf(bool)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            res.append(ts < timestamp.ts)
+
+        return res
+
+    @Entrypoint
+    def isAfter(self, timestamp: Timestamp) -> ListOf(bool):
+        """For each timestamp, whether it's strictly after 'timestamp'."""
+        res = ListOf(bool)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            res.append(ts > timestamp.ts)
+
+        return res
+
+    @Entrypoint
+    def isBetween(self, start: Timestamp, end: Timestamp) -> ListOf(bool):
+        """For each timestamp, whether it's at or after 'start' and before 'end'."""
+        res = ListOf(bool)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            res.append(start.ts <= ts < end.ts)
+
+        return res
+
+    @Entrypoint
+    def floor(self, interval: float, timezone: Timezone = UTC):
+        """Round each timestamp down to a multiple of 'interval' seconds, counted
+        from midnight on 1970-01-01 in 'timezone'.
+
+        With a timezone that observes daylight savings, intervals are measured on
+        the clocks as they read at each timestamp, so flooring to a day gives local
+        midnight. Right after a transition, that midnight used the other offset and
+        the result is an hour off.
+
+        Parameters
+        ----------
+        interval : float
+            The interval in seconds, e.g. 60 for minutes or 86400 for days.
+        timezone : Timezone
+            The timezone whose clocks the intervals are aligned to.
+        """
+        assert interval > 0
+
+        res = ListOf(float)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            offset = timezone.utcOffsetHours(ts) * 3600
+            res.append(((ts + offset) // interval) * interval - offset)
+
+        return TimestampColumn(ts=res)
+
+    @Entrypoint
+    def ceil(self, interval: float, timezone: Timezone = UTC):
+        """Round each timestamp up to a multiple of 'interval' seconds, aligned as in 'floor'."""
+        assert interval > 0
+
+        res = ListOf(float)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            offset = timezone.utcOffsetHours(ts) * 3600
+            res.append(-((-(ts + offset)) // interval) * interval - offset)
+
+        return TimestampColumn(ts=res)
+
+    @Entrypoint
+    def format(self, timezone: Timezone = UTC, format: str = "%Y-%m-%d %H:%M:%S") -> ListOf(str):
+        """Format every timestamp, as Timestamp.format would.
+
+        Parameters
+        ----------
+        timezone : Timezone
+            The timezone in which to compute formatted string of the UTC timestamp.
+        format : str
+            The format for the string.
+        """
+        res = ListOf(str)()
+        res.reserve(len(self.ts))
+
+        for ts in self.ts:
+            res.append(DateFormatter.format(ts, timezone, format))
+
+        return res
+
+    def sort(self) -> None:
+        """Sort the column in place, earliest first."""
+        sort(self.ts)
+
+    def searchSorted(self, timestamp: Timestamp) -> int:
+        """Where 'timestamp' is, or would be inserted, in this column, which must be sorted."""
+        return searchSorted(timestamp.ts, self.ts)
+
+    def searchSortedMany(self, timestamps) -> ListOf(int):
+        """The lower bound in this column, which must be sorted, of each of 'timestamps'.
+
+        Parameters
+        ----------
+        timestamps : TimestampColumn
+            The timestamps to look up, in any order.
+        """
+        return searchSortedMany(self.ts, timestamps.ts)
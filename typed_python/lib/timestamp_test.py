@@ -18,7 +18,8 @@ import unittest
 
 from typed_python.compiler.runtime import Entrypoint, PrintNewFunctionVisitor
 
-from typed_python.lib.timestamp import Timestamp
+from typed_python.lib.timestamp import Timestamp, TimestampColumn
+from typed_python.lib.datetime.date_time import NYC
 from datetime import datetime, timezone
 from typed_python import ListOf
 
@@ -394,3 +395,46 @@ class TestTimestamp(unittest.TestCase):
             + ")"
         )
         # assert speedup > 7 and speedup < 8
+
+
+class TestTimestampColumn(unittest.TestCase):
+    def test_basics(self):
+        column = TimestampColumn(ts=[30.0, 10.0, 20.0])
+        column.append(Timestamp.make(5.0))
+
+        assert len(column) == 4
+        assert column[1] == Timestamp.make(10.0)
+        assert (column + 1.5).ts == [31.5, 11.5, 21.5, 6.5]
+        assert (column + 2.0) - column == [2.0] * 4
+
+        assert column.isBefore(Timestamp.make(20.0)) == [False, True, False, True]
+        assert column.isAfter(Timestamp.make(20.0)) == [True, False, False, False]
+        assert column.isBetween(Timestamp.make(10.0), Timestamp.make(30.0)) == [False, True, True, False]
+
+    def test_parse_and_format(self):
+        strings = ListOf(str)(["2022-10-22 06:39:00", "1997-01-02 00:00:00"])
+        column = TimestampColumn.parse(strings)
+
+        assert column.ts == [Timestamp.parse(s).ts for s in strings]
+        assert column.format() == strings
+        assert column.format(NYC, "%Y-%m-%d") == [column[i].format(NYC, "%Y-%m-%d") for i in range(2)]
+
+    def test_floor_and_ceil(self):
+        column = TimestampColumn.parse(ListOf(str)(["2022-10-22 06:39:17", "2022-10-22 06:40:00"]))
+
+        assert column.floor(60).format() == ["2022-10-22 06:39:00", "2022-10-22 06:40:00"]
+        assert column.ceil(60).format() == ["2022-10-22 06:40:00", "2022-10-22 06:40:00"]
+        assert column.floor(86400).format() == ["2022-10-22 00:00:00"] * 2
+
+        # a day in New York starts at 04:00 UTC during daylight savings
+        assert column.floor(86400, NYC).format() == ["2022-10-22 04:00:00"] * 2
+        assert column.ceil(86400, NYC).format(NYC) == ["2022-10-23 00:00:00"] * 2
+
+    def test_sorting_and_searching(self):
+        column = TimestampColumn(ts=[30.0, 10.0, 20.0])
+        column.sort()
+
+        assert column.ts == [10.0, 20.0, 30.0]
+        assert column.searchSorted(Timestamp.make(20.0)) == 1
+        assert column.searchSorted(Timestamp.make(25.0)) == 2
+        assert column.searchSortedMany(TimestampColumn(ts=[35.0, 0.0, 10.0])) == [3, 0, 0]
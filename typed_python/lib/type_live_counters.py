@@ -0,0 +1,74 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Exact counts of the live ListOf, TupleOf, Dict and Set instances of each type.
+
+Start the process with TP_TYPE_LIVE_COUNTERS=1 in the environment, and then
+
+    liveCountsByType()     # {ListOf(float): (instances, bytes), ...}
+    prometheusMetrics()    # the same, in Prometheus' text exposition format
+
+'bytes' is what the instances hold directly: their headers, element storage
+and hashtables, but not what their elements point to. A ListOf(str) counts
+the space for the string pointers, and the strings aren't counted at all.
+
+Counting happens as instances are created, grown and destroyed, in the
+interpreter and in compiled code, so it can't be switched on part way
+through a process. Compiled code built with the counters on is cached
+separately from code built without them. Unlike the estimates from
+'allocation_sampling', these numbers are exact, but they only cover these
+four kinds of type.
+"""
+
+from typed_python._types import typeLiveCountersEnabled, typeLiveCounters
+
+
+def liveCountsByType():
+    """Return a dict from each type we've seen an instance of to (liveInstances, liveBytes)."""
+    return {T: (instances, bytes) for T, instances, bytes in typeLiveCounters()}
+
+
+def _escapeLabel(value):
+    return value.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n")
+
+
+def prometheusMetrics(prefix="typed_python"):
+    """Return the live counts as Prometheus gauges, in the text exposition format.
+
+    We emit '<prefix>_live_instances' and '<prefix>_live_bytes', each labelled
+    with the type's name. Returns an empty string if the counters are off.
+    """
+    if not typeLiveCountersEnabled():
+        return ""
+
+    counts = sorted(
+        (T.__name__, instances, bytes) for T, (instances, bytes) in liveCountsByType().items()
+    )
+
+    lines = []
+
+    for metric, help, column in [
+        ("live_instances", "Live instances of each typed_python type.", 1),
+        ("live_bytes", "Bytes held directly by the live instances of each typed_python type.", 2),
+    ]:
+        name = prefix + "_" + metric
+
+        lines.append(f"# HELP {name} {help}")
+        lines.append(f"# TYPE {name} gauge")
+
+        for row in counts:
+            lines.append(f'{name}{{type="{_escapeLabel(row[0])}"}} {row[column]}')
+
+    return "\n".join(lines) + "\n"
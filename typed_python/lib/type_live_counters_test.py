@@ -0,0 +1,86 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from typed_python._types import typeLiveCountersEnabled
+from typed_python.lib.type_live_counters import prometheusMetrics
+from typed_python.test_util import evaluateExprInFreshProcess
+
+
+COUNTED_MODULE = """
+from typed_python import ListOf, TupleOf, Dict, Set, Entrypoint
+from typed_python.lib.type_live_counters import liveCountsByType, prometheusMetrics
+
+T = ListOf(TupleOf(int))
+D = Dict(int, str)
+S = Set(float)
+
+@Entrypoint
+def makeCompiled(count: int):
+    res = T()
+    d = D()
+    s = S()
+
+    for i in range(count):
+        res.append(TupleOf(int)([i]))
+        d[i] = str(i)
+        s.add(float(i))
+
+    return res, d, s
+
+def counts():
+    return {t.__name__: liveCountsByType().get(t, (0, 0)) for t in [T, TupleOf(int), D, S]}
+
+def countsAround():
+    before = counts()
+
+    interpreted = [T([TupleOf(int)([i]) for i in range(10)]) for _ in range(3)]
+    interpretedDicts = [D({i: str(i) for i in range(100)}) for _ in range(4)]
+    compiled = makeCompiled(1000)
+
+    during = counts()
+
+    interpreted = interpretedDicts = compiled = None
+
+    return before, during, counts(), 'typed_python_live_bytes{type="Dict(int, str)"}' in prometheusMetrics()
+"""
+
+
+def test_type_live_counters_are_off_by_default():
+    if not typeLiveCountersEnabled():
+        assert prometheusMetrics() == ""
+
+
+def test_type_live_counters_track_instances(monkeypatch):
+    monkeypatch.setenv("TP_TYPE_LIVE_COUNTERS", "1")
+
+    before, during, after, exported = evaluateExprInFreshProcess(
+        {'x.py': COUNTED_MODULE}, 'x.countsAround()'
+    )
+
+    assert exported
+
+    def delta(counts, name):
+        return counts[name][0] - before[name][0], counts[name][1] - before[name][1]
+
+    assert delta(during, "ListOf(TupleOf(int))")[0] == 4
+    assert delta(during, "TupleOf(int)")[0] == 1030
+    assert delta(during, "Dict(int, str)")[0] == 5
+    assert delta(during, "Set(float)")[0] == 1
+
+    # 1000 floats and 1100 (int, str) pairs at the very least
+    assert delta(during, "Set(float)")[1] >= 8000
+    assert delta(during, "Dict(int, str)")[1] >= 1100 * 16
+
+    for name in before:
+        assert delta(after, name) == (0, 0), name
@@ -0,0 +1,317 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Bounded least-recently-used caches that compiled code can use.
+
+'functools.lru_cache' only works in the interpreter. 'typedCache' memoizes a
+function whose arguments and result are annotated, keyed on the Tuple of its
+arguments:
+
+    @typedCache(maxsize=10000)
+    def price(strike: float, expiry: int) -> float:
+        ...
+
+    price(100.0, 30)         # computes it
+    price(100.0, 30)         # returns the cached value
+    price.cacheInfo()        # CacheInfo(hits=1, misses=1, maxSize=10000, size=1)
+    price.cacheClear()
+
+The result is callable from compiled code as well as the interpreter. Under it
+is an 'LruCache(K, V)', which is usable on its own:
+
+    cache = LruCache(str, float)(maxSize=1000)
+    cache.getOrCompute(name, lambda: slowLookup(name))
+
+Each shard keeps its entries in a Dict from key to slot, and the slots in a
+doubly linked list, most recently used first, threaded through ListOf(int)
+'prev' and 'next' arrays. A hit moves the slot to the front. Inserting into a
+full shard reuses the slot at the back. Each shard has its own Mutex, so
+several threads can use a cache at once; with more than one shard they only
+contend when their keys land in the same shard. A shard holds its share of
+'maxSize', so with several shards eviction is only approximately LRU.
+
+Values are computed without holding the lock, so two threads that miss on the
+same key at once both compute it. Exceptions aren't cached.
+"""
+
+from typed_python import Class, Final, Member, TypeFunction, ListOf, Dict, Tuple, NamedTuple, Entrypoint, Function
+from typed_python.sync import Mutex
+
+
+CacheInfo = NamedTuple(hits=int, misses=int, maxSize=int, size=int)
+
+
+@TypeFunction
+def LruShard(K, V):
+    class LruShard_(Class, Final, __name__=f"LruShard({K.__name__}, {V.__name__})"):
+        capacity = Member(int, nonempty=True)
+        hits = Member(int, nonempty=True)
+        misses = Member(int, nonempty=True)
+
+        _slots = Member(Dict(K, int), nonempty=True)
+        _keys = Member(ListOf(K), nonempty=True)
+        _values = Member(ListOf(V), nonempty=True)
+
+        # the slots from most to least recently used. -1 ends the list at either end.
+        _prev = Member(ListOf(int), nonempty=True)
+        _next = Member(ListOf(int), nonempty=True)
+        _head = Member(int, nonempty=True)
+        _tail = Member(int, nonempty=True)
+
+        def __init__(self, capacity):
+            self.capacity = capacity
+            self._head = -1
+            self._tail = -1
+
+        def find(self, key: K) -> int:
+            """The slot holding 'key', which becomes the most recently used, or -1."""
+            slot = self._slots.get(key, -1)
+
+            if slot < 0:
+                self.misses += 1
+                return -1
+
+            self.hits += 1
+
+            if slot != self._head:
+                self._unlink(slot)
+                self._pushFront(slot)
+
+            return slot
+
+        def insert(self, key: K, value: V) -> None:
+            slot = self._slots.get(key, -1)
+
+            if slot >= 0:
+                # somebody else computed it while we were
+                self._values[slot] = value
+                self._unlink(slot)
+            elif len(self._keys) < self.capacity:
+                slot = len(self._keys)
+
+                self._keys.append(key)
+                self._values.append(value)
+                self._prev.append(-1)
+                self._next.append(-1)
+                self._slots[key] = slot
+            else:
+                slot = self._tail
+                self._unlink(slot)
+
+                del self._slots[self._keys[slot]]
+
+                self._keys[slot] = key
+                self._values[slot] = value
+                self._slots[key] = slot
+
+            self._pushFront(slot)
+
+        def clear(self) -> None:
+            self._slots.clear()
+            self._keys.clear()
+            self._values.clear()
+            self._prev.clear()
+            self._next.clear()
+            self._head = -1
+            self._tail = -1
+            self.hits = 0
+            self.misses = 0
+
+        def _unlink(self, slot: int) -> None:
+            before = self._prev[slot]
+            after = self._next[slot]
+
+            if before >= 0:
+                self._next[before] = after
+            else:
+                self._head = after
+
+            if after >= 0:
+                self._prev[after] = before
+            else:
+                self._tail = before
+
+        def _pushFront(self, slot: int) -> None:
+            self._prev[slot] = -1
+            self._next[slot] = self._head
+
+            if self._head >= 0:
+                self._prev[self._head] = slot
+            else:
+                self._tail = slot
+
+            self._head = slot
+
+    return LruShard_
+
+
+@TypeFunction
+def LruCache(K, V):
+    class LruCache_(Class, Final, __name__=f"LruCache({K.__name__}, {V.__name__})"):
+        KeyType = K
+        ValueType = V
+
+        maxSize = Member(int, nonempty=True)
+
+        _shards = Member(ListOf(LruShard(K, V)), nonempty=True)
+        _locks = Member(ListOf(Mutex), nonempty=True)
+        _mask = Member(int, nonempty=True)
+
+        def __init__(self, maxSize, shardCount=1):
+            """Create an empty cache of at most 'maxSize' entries, split into 'shardCount' shards.
+
+            We round 'shardCount' up to a power of two.
+            """
+            assert maxSize > 0, "An LruCache needs a positive maxSize"
+
+            count = 1
+            while count < shardCount:
+                count *= 2
+
+            assert count <= 2048, "Can't have more than 2048 shards"
+
+            self.maxSize = maxSize
+            self._mask = count - 1
+
+            for _ in range(count):
+                self._shards.append(LruShard(K, V)((maxSize + count - 1) // count))
+                self._locks.append(Mutex())
+
+        @Entrypoint
+        def _shardFor(self, k: K) -> int:
+            # Dict uses the low bits of the hash, and small ints hash to themselves,
+            # so we mix the hash and take high bits
+            return ((hash(k) * 0x4F1BBCDCBFA53E0B) >> 40) & self._mask
+
+        @Entrypoint
+        def getOrCompute(self, k: K, f) -> V:
+            """Return the cached value for 'k', or else 'f()', which we cache."""
+            s = self._shardFor(k)
+            shard = self._shards[s]
+
+            with self._locks[s]:
+                slot = shard.find(k)
+
+                if slot >= 0:
+                    return shard._values[slot]
+
+            value = f()
+
+            with self._locks[s]:
+                shard.insert(k, value)
+
+            return value
+
+        @Entrypoint
+        def __contains__(self, k: K) -> bool:
+            s = self._shardFor(k)
+
+            with self._locks[s]:
+                return k in self._shards[s]._slots
+
+        @Entrypoint
+        def __len__(self) -> int:
+            res = 0
+
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    res += len(self._shards[i]._keys)
+
+            return res
+
+        @Entrypoint
+        def cacheInfo(self) -> CacheInfo:
+            hits = 0
+            misses = 0
+            size = 0
+
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    hits += self._shards[i].hits
+                    misses += self._shards[i].misses
+                    size += len(self._shards[i]._keys)
+
+            return CacheInfo(hits=hits, misses=misses, maxSize=self.maxSize, size=size)
+
+        @Entrypoint
+        def clear(self) -> None:
+            """Drop every entry, and reset the hit and miss counts."""
+            for i in range(len(self._shards)):
+                with self._locks[i]:
+                    self._shards[i].clear()
+
+    return LruCache_
+
+
+@TypeFunction
+def CachedFunction(FuncT, K, V):
+    class CachedFunction_(Class, Final, __name__=f"CachedFunction({FuncT.__name__})"):
+        f = Member(FuncT)
+        cache = Member(LruCache(K, V), nonempty=True)
+
+        def __init__(self, f, maxSize, shardCount):
+            self.f = f
+            self.cache = LruCache(K, V)(maxSize, shardCount)
+
+        @Entrypoint
+        def __call__(self, *args) -> V:
+            key = K(args)
+
+            return self.cache.getOrCompute(key, lambda: self.f(*key))
+
+        def cacheInfo(self) -> CacheInfo:
+            return self.cache.cacheInfo()
+
+        def cacheClear(self) -> None:
+            self.cache.clear()
+
+    return CachedFunction_
+
+
+def typedCache(maxsize=128, shards=1):
+    """Memoize a function with typed arguments and result in an LruCache of 'maxsize' entries.
+
+    Args:
+        maxsize - the most results we keep
+        shards - how many independently locked pieces to split the cache into.
+            Use more than one for caches that many threads hit at once.
+
+    Every argument, and the result, must be annotated with a type. Arguments
+    are converted to those types before we look them up, so f(1) and f(1.0)
+    share an entry if the argument is a float.
+    """
+    def decorate(f):
+        func = Function(f)
+
+        if len(func.overloads) != 1:
+            raise TypeError("typedCache can't memoize a function with several overloads")
+
+        overload = func.overloads[0]
+
+        for arg in overload.args:
+            if arg.isStarArg or arg.isKwarg:
+                raise TypeError(f"typedCache can't memoize {f.__name__}, since it takes *args or **kwargs")
+
+            if arg.typeFilter is None:
+                raise TypeError(f"typedCache needs a type for argument '{arg.name}' of {f.__name__}")
+
+        if overload.returnType is None:
+            raise TypeError(f"typedCache needs a return type for {f.__name__}")
+
+        K = Tuple(*[arg.typeFilter for arg in overload.args])
+
+        return CachedFunction(type(func), K, overload.returnType)(func, maxsize, shards)
+
+    return decorate
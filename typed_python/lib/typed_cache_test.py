@@ -0,0 +1,159 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import threading
+
+import pytest
+
+from typed_python import Entrypoint, ListOf
+from typed_python.lib.typed_cache import typedCache, LruCache, CacheInfo
+
+
+calls = ListOf(int)()
+
+
+@typedCache(maxsize=3)
+def square(x: int) -> int:
+    calls.append(x)
+    return x * x
+
+
+def test_typed_cache_memoizes():
+    square.cacheClear()
+    calls.clear()
+
+    assert square(2) == 4
+    assert square(2) == 4
+    assert square(3) == 9
+
+    assert calls == [2, 3]
+    assert square.cacheInfo() == CacheInfo(hits=1, misses=2, maxSize=3, size=2)
+
+
+def test_typed_cache_evicts_least_recently_used():
+    square.cacheClear()
+    calls.clear()
+
+    for x in [1, 2, 3, 1, 4, 1, 2]:
+        square(x)
+
+    # 4 evicted 2, the least recently used. Then 2 evicted 3.
+    assert calls == [1, 2, 3, 4, 2]
+    assert square.cacheInfo().size == 3
+
+
+def test_typed_cache_from_compiled_code():
+    square.cacheClear()
+    calls.clear()
+
+    @Entrypoint
+    def sumOfSquares(n: int) -> int:
+        res = 0
+        for i in range(n):
+            res += square(i % 3)
+        return res
+
+    assert sumOfSquares(100) == sum((i % 3) ** 2 for i in range(100))
+    assert sorted(calls) == [0, 1, 2]
+
+
+def test_typed_cache_converts_arguments():
+    @typedCache()
+    def half(x: float, label: str) -> str:
+        return f"{label}={x / 2}"
+
+    assert half(3, "a") == "a=1.5"
+    assert half(3.0, "a") == "a=1.5"
+    assert half.cacheInfo().hits == 1
+
+
+def test_typed_cache_needs_annotations():
+    with pytest.raises(TypeError):
+        @typedCache()
+        def untyped(x) -> int:
+            return x
+
+    with pytest.raises(TypeError):
+        @typedCache()
+        def noReturnType(x: int):
+            return x
+
+
+def test_exceptions_arent_cached():
+    attempts = ListOf(int)()
+
+    @typedCache()
+    def flaky(x: int) -> int:
+        attempts.append(x)
+        if len(attempts) == 1:
+            raise ValueError("first try")
+        return x
+
+    with pytest.raises(ValueError):
+        flaky(1)
+
+    assert flaky(1) == 1
+    assert flaky(1) == 1
+    assert len(attempts) == 2
+
+
+def test_lru_cache_directly():
+    cache = LruCache(str, int)(maxSize=2)
+
+    assert cache.getOrCompute("a", lambda: 1) == 1
+    assert cache.getOrCompute("a", lambda: 2) == 1
+    assert cache.getOrCompute("b", lambda: 3) == 3
+    assert cache.getOrCompute("c", lambda: 4) == 4
+
+    assert "a" not in cache
+    assert "b" in cache and "c" in cache
+    assert len(cache) == 2
+
+    cache.clear()
+
+    assert len(cache) == 0
+    assert cache.cacheInfo() == CacheInfo(hits=0, misses=0, maxSize=2, size=0)
+
+
+def test_sharded_cache_from_many_threads():
+    cache = LruCache(int, int)(maxSize=1000, shardCount=8)
+
+    assert len(cache._shards) == 8
+
+    @Entrypoint
+    def work(c: LruCache(int, int), seed: int) -> int:
+        res = 0
+        for i in range(10000):
+            k = (i * 7 + seed) % 500
+            res += c.getOrCompute(k, lambda: k * 2)
+        return res
+
+    results = [None] * 4
+
+    def run(ix):
+        results[ix] = work(cache, ix)
+
+    threads = [threading.Thread(target=run, args=(ix,)) for ix in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    for ix in range(4):
+        assert results[ix] == sum(((i * 7 + ix) % 500) * 2 for i in range(10000))
+
+    info = cache.cacheInfo()
+
+    assert info.hits + info.misses == 40000
+    assert info.size == 500
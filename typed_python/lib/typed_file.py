@@ -0,0 +1,187 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Files that compiled code can read and write without the GIL.
+
+    with TypedFile(path, "wb") as f:
+        f.writeSerialized(ListOf(Trade), trades)
+
+    with TypedFile(path, "rb") as f:
+        trades = f.readSerialized(ListOf(Trade))
+
+A TypedFile is a file descriptor. 'readInto' reads straight into a
+ListOf(UInt8) and 'writeFrom' writes straight out of one (or out of bytes),
+releasing the GIL for the system call, in compiled code and in the
+interpreter alike. Bytes are immutable, so reads go into a ListOf(UInt8),
+which 'toBytes' turns into bytes if you need them.
+
+'writeSerialized' writes what 'serialize' would, but streams it: a writer
+thread writes each block of the serialized data as it fills, so we never
+hold more than 'maxPendingBytes' of it, rather than all of it and then a
+second copy in a bytes object. 'readSerialized' reads the rest of the file
+into one buffer and deserializes straight out of it.
+
+Failures raise OSError, as python's own files do.
+"""
+
+import os
+
+from typed_python import Class, Member, Final, ListOf, UInt8, NotCompiled
+from typed_python._types import fileRead, fileWrite, serializeToFile, deserializeBuffer
+
+_MODES = {
+    "rb": os.O_RDONLY,
+    "wb": os.O_WRONLY | os.O_CREAT | os.O_TRUNC,
+    "ab": os.O_WRONLY | os.O_CREAT | os.O_APPEND,
+    "r+b": os.O_RDWR,
+    "w+b": os.O_RDWR | os.O_CREAT | os.O_TRUNC,
+}
+
+
+@NotCompiled
+def _open(path: str, mode: str) -> int:
+    if mode not in _MODES:
+        raise ValueError(f"TypedFile mode must be one of {sorted(_MODES)}, not {mode!r}")
+
+    return os.open(path, _MODES[mode] | getattr(os, "O_BINARY", 0), 0o666)
+
+
+@NotCompiled
+def _close(fd: int) -> None:
+    os.close(fd)
+
+
+@NotCompiled
+def _raiseOSError(errno: int) -> None:
+    raise OSError(errno, os.strerror(errno))
+
+
+@NotCompiled
+def _serializeToFile(T, value, fd: int, serializationContext, maxPendingBytes: int) -> int:
+    return serializeToFile(T, value, fd, serializationContext, maxPendingBytes)
+
+
+class TypedFile(Class, Final):
+    """A file opened in binary mode that compiled code can read and write.
+
+    'mode' is one of "rb", "wb", "ab", "r+b" or "w+b", as for 'open'.
+    """
+    # -1 once we're closed
+    fd = Member(int, nonempty=True)
+
+    def __init__(self, path: str, mode: str = "rb"):
+        self.fd = _open(path, mode)
+
+    def _checkOpen(self) -> None:
+        if self.fd < 0:
+            raise ValueError("I/O operation on closed TypedFile")
+
+    def readInto(self, buf: ListOf(UInt8)) -> int:
+        """Fill 'buf' from the file, and return how many bytes we read.
+
+        That's len(buf) unless we hit the end of the file first.
+        """
+        self._checkOpen()
+
+        total = 0
+
+        while total < len(buf):
+            res = fileRead(self.fd, int(buf.pointerUnsafe(total)), len(buf) - total)
+
+            if res < 0:
+                _raiseOSError(-res)
+
+            if res == 0:
+                return total
+
+            total += res
+
+        return total
+
+    def read(self, count: int = -1) -> ListOf(UInt8):
+        """Read 'count' bytes (fewer at the end of the file), or the rest of the file if it's -1."""
+        self._checkOpen()
+
+        if count >= 0:
+            res = ListOf(UInt8)()
+            res.resize(count)
+            res.resize(self.readInto(res))
+            return res
+
+        res = ListOf(UInt8)()
+        res.resize(1024 * 1024)
+        total = 0
+
+        while True:
+            got = fileRead(self.fd, int(res.pointerUnsafe(total)), len(res) - total)
+
+            if got < 0:
+                _raiseOSError(-got)
+
+            if got == 0:
+                res.resize(total)
+                return res
+
+            total += got
+
+            if total == len(res):
+                res.resize(total * 2)
+
+    def writeFrom(self, buf: ListOf(UInt8)) -> None:
+        """Write all of 'buf' to the file."""
+        self._checkOpen()
+
+        if len(buf):
+            res = fileWrite(self.fd, int(buf.pointerUnsafe(0)), len(buf))
+
+            if res < 0:
+                _raiseOSError(-res)
+
+    def writeFrom(self, data: bytes) -> None:  # noqa: F811
+        """Write all of 'data' to the file."""
+        self._checkOpen()
+
+        res = fileWrite(self.fd, data)
+
+        if res < 0:
+            _raiseOSError(-res)
+
+    def writeSerialized(self, T, value, serializationContext=None, maxPendingBytes=64 * 1024 * 1024) -> int:
+        """Write 'serialize(T, value, serializationContext)' to the file, as we serialize it.
+
+        Returns how many bytes we wrote.
+        """
+        self._checkOpen()
+
+        return _serializeToFile(T, value, self.fd, serializationContext, maxPendingBytes)
+
+    def readSerialized(self, T, serializationContext=None):
+        """Deserialize a T from the rest of the file."""
+        data = self.read()
+
+        return deserializeBuffer(T, int(data.pointerUnsafe(0)), len(data), serializationContext)
+
+    def close(self) -> None:
+        if self.fd >= 0:
+            fd = self.fd
+            self.fd = -1
+            _close(fd)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, excType, excValue, traceback) -> bool:
+        self.close()
+        return False
@@ -0,0 +1,209 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import errno
+import os
+import threading
+
+import pytest
+
+from typed_python import (
+    Entrypoint, ListOf, UInt8, NamedTuple, SerializationContext, serialize, deserialize
+)
+from typed_python._types import fileRead, fileWrite
+from typed_python.lib.typed_file import TypedFile
+
+
+Trade = NamedTuple(id=int, price=float, symbol=str)
+
+
+def test_write_and_read_back(tmp_path):
+    path = str(tmp_path / "data")
+
+    with TypedFile(path, "wb") as f:
+        f.writeFrom(ListOf(UInt8)([1, 2, 3]))
+        f.writeFrom(b"\x04\x05")
+
+    assert open(path, "rb").read() == b"\x01\x02\x03\x04\x05"
+
+    with TypedFile(path, "rb") as f:
+        buf = ListOf(UInt8)()
+        buf.resize(2)
+
+        assert f.readInto(buf) == 2
+        assert buf == [1, 2]
+
+        assert f.read(2) == [3, 4]
+        assert f.read() == [5]
+        assert f.read() == []
+
+        buf.resize(10)
+        assert f.readInto(buf) == 0
+
+
+def test_compiled_reads_and_writes(tmp_path):
+    path = str(tmp_path / "data")
+
+    @Entrypoint
+    def writeSquares(path: str, count: int) -> None:
+        f = TypedFile(path, "wb")
+        buf = ListOf(UInt8)()
+
+        for i in range(count):
+            buf.append(UInt8(i * i))
+
+        f.writeFrom(buf)
+        f.writeFrom(b"end")
+        f.close()
+
+    @Entrypoint
+    def sumOfFile(path: str, chunk: int) -> int:
+        f = TypedFile(path, "rb")
+        buf = ListOf(UInt8)()
+        buf.resize(chunk)
+        res = 0
+
+        while True:
+            got = f.readInto(buf)
+
+            for i in range(got):
+                res += buf[i]
+
+            if got < chunk:
+                f.close()
+                return res
+
+    writeSquares(path, 1000)
+
+    expected = bytes(UInt8(i * i) for i in range(1000)) + b"end"
+    assert open(path, "rb").read() == expected
+
+    for chunk in [1, 7, 4096]:
+        assert sumOfFile(path, chunk) == sum(expected)
+
+
+def test_append_mode(tmp_path):
+    path = str(tmp_path / "data")
+
+    for piece in [b"one", b"two"]:
+        with TypedFile(path, "ab") as f:
+            f.writeFrom(piece)
+
+    assert open(path, "rb").read() == b"onetwo"
+
+
+def test_errors_raise_oserror(tmp_path):
+    with pytest.raises(FileNotFoundError):
+        TypedFile(str(tmp_path / "missing"), "rb")
+
+    with pytest.raises(ValueError):
+        TypedFile(str(tmp_path / "data"), "w")
+
+    f = TypedFile(str(tmp_path / "data"), "wb")
+
+    # reading a file we only opened for writing
+    with pytest.raises(OSError):
+        f.read(10)
+
+    f.close()
+
+    with pytest.raises(ValueError):
+        f.writeFrom(b"closed")
+
+
+def test_low_level_functions_return_negative_errno(tmp_path):
+    r, w = os.pipe()
+
+    try:
+        assert fileWrite(w, b"hello") == 5
+        assert fileWrite(w, memoryview(b"xx world")[2:]) == 6
+
+        buf = ListOf(UInt8)()
+        buf.resize(20)
+        assert fileRead(r, int(buf.pointerUnsafe(0)), 20) == 11
+        assert bytes(buf[:11]) == b"hello world"
+    finally:
+        os.close(r)
+        os.close(w)
+
+    # 'r' is closed now
+    assert fileRead(r, int(buf.pointerUnsafe(0)), 20) == -errno.EBADF
+
+
+def test_read_releases_the_gil(tmp_path):
+    r, w = os.pipe()
+
+    @Entrypoint
+    def readOne(fd: int) -> int:
+        buf = ListOf(UInt8)()
+        buf.resize(1)
+        fileRead(fd, int(buf.pointerUnsafe(0)), 1)
+        return buf[0]
+
+    res = []
+    thread = threading.Thread(target=lambda: res.append(readOne(r)))
+    thread.start()
+
+    # the reader blocks in 'read' until we write, which we couldn't do if it held the GIL
+    os.write(w, b"\x2a")
+    thread.join()
+
+    os.close(r)
+    os.close(w)
+
+    assert res == [42]
+
+
+def test_write_serialized_matches_serialize(tmp_path):
+    path = str(tmp_path / "data")
+
+    trades = ListOf(Trade)([Trade(id=i, price=i * 0.5, symbol="s" + str(i % 100)) for i in range(300000)])
+
+    for context in [
+        SerializationContext(),
+        SerializationContext().withoutCompression(),
+        SerializationContext().withCompression(),
+        SerializationContext().withCompression().withoutCompressUsingThreads(),
+    ]:
+        with TypedFile(path, "wb") as f:
+            written = f.writeSerialized(ListOf(Trade), trades, context)
+
+        assert written == os.path.getsize(path)
+
+        data = open(path, "rb").read()
+
+        assert deserialize(ListOf(Trade), data, context) == trades
+        assert data == serialize(ListOf(Trade), trades, context)
+
+        with TypedFile(path, "rb") as f:
+            assert f.readSerialized(ListOf(Trade), context) == trades
+
+
+def test_write_serialized_with_little_pending_memory(tmp_path):
+    path = str(tmp_path / "data")
+
+    values = ListOf(str)([str(i) * 10 for i in range(200000)])
+
+    with TypedFile(path, "wb") as f:
+        # the writer holds no more than a block at a time
+        f.writeSerialized(ListOf(str), values, maxPendingBytes=1)
+
+    with TypedFile(path, "rb") as f:
+        assert f.readSerialized(ListOf(str)) == values
+
+
+def test_write_serialized_raises_when_writes_fail(tmp_path):
+    with TypedFile(str(tmp_path / "data"), "rb") as f:
+        with pytest.raises(OSError):
+            f.writeSerialized(ListOf(int), ListOf(int)(range(1000000)))
@@ -0,0 +1,149 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+numpy ufuncs built from compiled functions.
+
+    def logistic(x: float) -> float:
+        return 1.0 / (1.0 + math.exp(-x))
+
+    logisticUfunc = ufunc(logistic, [float], float)
+
+    logisticUfunc(numpy.linspace(-5, 5, 1000000))
+
+The result is a real numpy.ufunc, so numpy broadcasts its arguments, casts
+them to the types you gave, and handles strides, 'out=' and 'where=', and
+'reduce' and 'accumulate' for two-input functions, exactly as it does for
+its own ufuncs. Calling a compiled function on each element from python
+instead goes through the interpreter's function dispatch once per element.
+
+We compile a loop that reads each element, calls 'f', and writes the result,
+so 'f' is inlined into it, and numpy calls it once per run of elements. The
+loop runs without the GIL. An 'outputType' of Tuple(...) makes a ufunc with
+one output per element of the tuple.
+
+Inputs and outputs must be bool, int, float, or one of the sized ints or
+Float32. If 'f' raises, the ufunc stops and the exception surfaces when it
+returns (numpy may wrap it in a SystemError, with the exception as its cause).
+"""
+
+import numpy
+
+from typed_python import Entrypoint  # noqa: F401
+from typed_python import (
+    PointerTo, Int8, Int16, Int32, UInt8, UInt16, UInt32, UInt64, Float32
+)
+from typed_python._types import makeUfunc
+from typed_python.compiler.runtime import Runtime
+from typed_python.macro import ConcreteMacro
+
+
+_NUMPY_NAMES = {
+    bool: "bool",
+    Int8: "int8",
+    Int16: "int16",
+    Int32: "int32",
+    int: "int64",
+    UInt8: "uint8",
+    UInt16: "uint16",
+    UInt32: "uint32",
+    UInt64: "uint64",
+    Float32: "float32",
+    float: "float64",
+}
+
+
+def _numpyTypeNum(T):
+    if T not in _NUMPY_NAMES:
+        raise TypeError(f"ufuncs can only take and return {sorted(str(x) for x in _NUMPY_NAMES)}, not {T}")
+
+    return numpy.dtype(_NUMPY_NAMES[T]).num
+
+
+def _loopSource(f, inputTypes, outputTypes, outputIsTuple):
+    """The source of the inner loop for 'f', as 'numpy' calls it."""
+    nin = len(inputTypes)
+    types = list(inputTypes) + list(outputTypes)
+
+    def element(i):
+        return f"(p{i} + k * s{i}).cast(T{i})"
+
+    output = []
+    output.append("@Entrypoint")
+    output.append("def loop(args: PointerTo(PointerTo(UInt8)), count: int, steps: PointerTo(int)) -> None:")
+
+    for i in range(len(types)):
+        output.append(f"    p{i} = args[{i}]")
+        output.append(f"    s{i} = steps[{i}]")
+
+    output.append("    for k in range(count):")
+
+    call = "f(" + ", ".join(element(i) + ".get()" for i in range(nin)) + ")"
+
+    if outputIsTuple:
+        output.append(f"        res = {call}")
+
+        for j in range(len(outputTypes)):
+            output.append(f"        {element(nin + j)}.set(res[{j}])")
+    else:
+        output.append(f"        {element(nin)}.set({call})")
+
+    output.append("return loop")
+
+    return {
+        "sourceText": output,
+        "locals": dict(f=f, **{f"T{i}": T for i, T in enumerate(types)}),
+    }
+
+
+_makeLoop = ConcreteMacro(_loopSource)
+
+
+def ufunc(f, inputTypes, outputType, name=None, doc=None):
+    """Make a numpy.ufunc that calls the compiled 'f' on each element.
+
+    Args:
+        f - a function (or typed Function) we can compile for arguments of 'inputTypes'.
+        inputTypes - a list with the type of each argument of 'f'.
+        outputType - the type 'f' returns, or a Tuple of them to make a ufunc with
+            several outputs.
+        name, doc - the ufunc's name and docstring. By default, those of 'f'.
+
+    Returns:
+        a numpy.ufunc with len(inputTypes) inputs.
+    """
+    inputTypes = list(inputTypes)
+
+    outputIsTuple = getattr(outputType, "__typed_python_category__", None) == "Tuple"
+    outputTypes = list(outputType.ElementTypes) if outputIsTuple else [outputType]
+
+    if not inputTypes or not outputTypes:
+        raise TypeError("ufuncs need at least one input and one output")
+
+    typeNums = [_numpyTypeNum(T) for T in inputTypes + outputTypes]
+
+    loop = _makeLoop(f, inputTypes, outputTypes, outputIsTuple)
+
+    address = Runtime.singleton().compiledEntrypointAddress(
+        loop, [PointerTo(PointerTo(UInt8)), int, PointerTo(int)]
+    )
+
+    if name is None:
+        name = getattr(f, "__name__", "ufunc")
+
+    if doc is None:
+        doc = getattr(f, "__doc__", None) or ""
+
+    return makeUfunc(name, doc, len(inputTypes), len(outputTypes), typeNums, address)
+
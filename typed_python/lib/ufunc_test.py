@@ -0,0 +1,162 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import math
+import threading
+import time
+
+import numpy
+import pytest
+
+from typed_python import ufunc, Entrypoint, Tuple, Float32, Int32, ListOf
+
+
+def logistic(x: float) -> float:
+    """The logistic function."""
+    return 1.0 / (1.0 + math.exp(-x))
+
+
+def test_ufunc_matches_the_function():
+    u = ufunc(logistic, [float], float)
+
+    assert isinstance(u, numpy.ufunc)
+    assert u.__name__ == "logistic"
+    assert u.nin == 1 and u.nout == 1
+
+    x = numpy.linspace(-5, 5, 1001)
+
+    assert numpy.allclose(u(x), 1.0 / (1.0 + numpy.exp(-x)))
+    assert u(0.0) == 0.5
+
+
+def test_ufunc_broadcasts_and_follows_strides():
+    u = ufunc(lambda x, y: x * 10 + y, [int, int], int, name="combine")
+
+    x = numpy.arange(12).reshape(3, 4)
+    y = numpy.arange(4)
+
+    assert (u(x, y) == x * 10 + y).all()
+    assert (u(x.T, numpy.arange(3)) == x.T * 10 + numpy.arange(3)).all()
+    assert (u(x[:, ::2], y[::2]) == x[:, ::2] * 10 + y[::2]).all()
+    assert (u(x[::-1], 5) == x[::-1] * 10 + 5).all()
+
+    out = numpy.zeros((3, 4), dtype="int64")
+    u(x, y, out=out)
+    assert (out == x * 10 + y).all()
+
+
+def test_ufunc_reduce_and_accumulate():
+    u = ufunc(lambda x, y: max(x, y), [float, float], float, name="maximum")
+
+    x = numpy.array([3.0, 1.0, 4.0, 1.0, 5.0, 9.0, 2.0])
+
+    assert u.reduce(x) == 9.0
+    assert (u.accumulate(x) == numpy.maximum.accumulate(x)).all()
+
+
+def test_ufunc_casts_inputs():
+    u = ufunc(lambda x: x + 1, [float], float, name="inc")
+
+    assert (u(numpy.arange(5, dtype="int32")) == numpy.arange(5) + 1.0).all()
+    assert u(numpy.arange(5, dtype="int32")).dtype == numpy.float64
+
+
+def test_ufunc_sized_types():
+    u = ufunc(lambda x, y: x * y, [Float32, Int32], Float32, name="scale")
+
+    res = u(numpy.ones(4, dtype="float32"), numpy.arange(4, dtype="int32"))
+
+    assert res.dtype == numpy.float32
+    assert (res == numpy.arange(4)).all()
+
+    b = ufunc(lambda x: x > 2, [int], bool, name="big")
+
+    assert (b(numpy.arange(5)) == (numpy.arange(5) > 2)).all()
+
+
+def test_ufunc_several_outputs():
+    u = ufunc(lambda x, y: (x // y, x % y), [int, int], Tuple(int, int), name="divmod_")
+
+    q, r = u(numpy.arange(10), 3)
+
+    assert (q == numpy.arange(10) // 3).all()
+    assert (r == numpy.arange(10) % 3).all()
+
+
+def test_ufunc_of_entrypoint_with_a_closure():
+    offset = 100
+
+    @Entrypoint
+    def shift(x: int) -> int:
+        return x + offset
+
+    u = ufunc(shift, [int], int)
+
+    assert (u(numpy.arange(3)) == [100, 101, 102]).all()
+
+
+def test_ufunc_calls_functions_that_use_typed_objects():
+    lookup = ListOf(float)([0.5, 1.5, 2.5])
+
+    u = ufunc(lambda i: lookup[i], [int], float, name="lookup")
+
+    assert (u(numpy.array([2, 0, 1])) == [2.5, 0.5, 1.5]).all()
+
+
+def test_ufunc_raises():
+    u = ufunc(lambda x, y: x // y, [int, int], int, name="floordiv")
+
+    with pytest.raises(Exception) as info:
+        u(numpy.arange(10), numpy.array([1, 1, 1, 0, 1, 1, 1, 1, 1, 1]))
+
+    assert isinstance(info.value, ZeroDivisionError) or isinstance(info.value.__cause__, ZeroDivisionError)
+
+    # and the ufunc still works afterwards
+    assert (u(numpy.arange(10), 2) == numpy.arange(10) // 2).all()
+
+
+def test_ufunc_rejects_unsupported_types():
+    with pytest.raises(TypeError):
+        ufunc(lambda x: x, [str], str)
+
+    with pytest.raises(TypeError):
+        ufunc(lambda x: x, [], float)
+
+
+def spin(x: float) -> float:
+    for _ in range(1000):
+        x = math.sin(x)
+    return x
+
+
+def test_ufunc_releases_the_gil():
+    u = ufunc(spin, [float], float)
+
+    x = numpy.linspace(0, 1, 20000)
+    u(x)
+
+    def runInThreads(count):
+        threads = [threading.Thread(target=u, args=(x,)) for _ in range(count)]
+
+        t0 = time.time()
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        return time.time() - t0
+
+    ratios = sorted(runInThreads(2) / runInThreads(1) for _ in range(5))
+
+    # two calls at once should take about as long as one
+    assert ratios[2] < 1.5, ratios
@@ -0,0 +1,295 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Read-only views of part of a ListOf or a str, without copying it.
+
+'lst[a:b]' and 's[a:b]' allocate and copy. A 'ListView(T)' or 'StrView' is a
+NamedTuple holding a reference to the whole ListOf or str along with 'start'
+and 'stop', so in compiled code making one only bumps a refcount:
+
+    @Entrypoint
+    def countFields(line: str) -> int:
+        rest = StrView.of(line)
+        count = 0
+
+        while True:
+            comma = rest.find(",")
+            if comma < 0:
+                return count + 1
+
+            count += 1
+            rest = rest.slice(comma + 1)
+
+Views support len, indexing, iteration, 'find' / 'index', 'slice' and
+comparison with other views or with the owning type. 'toList' and 'toStr'
+copy the viewed part out when you need to keep it.
+
+Views compare by content, but don't hash by it: Dict and Set hash a NamedTuple
+by its fields, which would disagree with '=='. Convert them with 'toList' or
+'toStr' before using them as keys.
+
+A view keeps its whole source alive. Since a ListOf can be resized, a
+ListView made from one that later shrinks sees an IndexError, rather than
+stale data, when it's indexed past the new end.
+"""
+
+from typed_python import NamedTuple, ListOf, OneOf, TypeFunction, Entrypoint
+
+
+def _clampSliceBound(ix, length):
+    if ix < 0:
+        ix += length
+        if ix < 0:
+            return 0
+
+    if ix > length:
+        return length
+
+    return ix
+
+
+def _compareOrders(lenLeft, lenRight):
+    if lenLeft < lenRight:
+        return -1
+    if lenLeft > lenRight:
+        return 1
+    return 0
+
+
+@Entrypoint
+def _compareSequences(left, leftStart: int, leftStop: int, right, rightStart: int, rightStop: int) -> int:
+    """Compare left[leftStart:leftStop] to right[rightStart:rightStop] like a list would.
+
+    Returns -1, 0 or 1.
+    """
+    count = min(leftStop - leftStart, rightStop - rightStart)
+
+    for i in range(count):
+        x = left[leftStart + i]
+        y = right[rightStart + i]
+
+        if x != y:
+            return -1 if x < y else 1
+
+    return _compareOrders(leftStop - leftStart, rightStop - rightStart)
+
+
+@Entrypoint
+def _compareStrs(left: str, leftStart: int, leftStop: int, right: str, rightStart: int, rightStop: int) -> int:
+    """Compare left[leftStart:leftStop] to right[rightStart:rightStop] by codepoint.
+
+    Returns -1, 0 or 1.
+    """
+    if leftStop > len(left) or rightStop > len(right):
+        raise IndexError("StrView is out of range of its source")
+
+    count = min(leftStop - leftStart, rightStop - rightStart)
+
+    for i in range(count):
+        x = left._codepointUnsafe(leftStart + i)
+        y = right._codepointUnsafe(rightStart + i)
+
+        if x != y:
+            return -1 if x < y else 1
+
+    return _compareOrders(leftStop - leftStart, rightStop - rightStart)
+
+
+@TypeFunction
+def ListView(T):
+    """A read-only view of source[start:stop], for a ListOf(T) 'source'."""
+
+    class ListView_(NamedTuple(source=ListOf(T), start=int, stop=int)):
+        @staticmethod
+        def of(source: ListOf(T), start: int = 0, stop: OneOf(None, int) = None):
+            """Return a view of source[start:stop], with the same bounds as that slice."""
+            if stop is None:
+                stop = len(source)
+
+            start = _clampSliceBound(start, len(source))
+            stop = _clampSliceBound(stop, len(source))
+
+            return ListView_(source=source, start=start, stop=max(start, stop))
+
+        def __len__(self):
+            return self.stop - self.start
+
+        def __getitem__(self, i: int):
+            if i < 0:
+                i += self.stop - self.start
+
+            if i < 0 or i >= self.stop - self.start:
+                raise IndexError("ListView index out of range")
+
+            return self.source[self.start + i]
+
+        def __typed_python_int_iter_size__(self):
+            return self.stop - self.start
+
+        def __typed_python_int_iter_value__(self, i):
+            return self.source[self.start + i]
+
+        def __iter__(self):
+            return iter(self.toList())
+
+        def slice(self, start: int = 0, stop: OneOf(None, int) = None):
+            """Return a view of self[start:stop], which shares our source."""
+            length = self.stop - self.start
+
+            if stop is None:
+                stop = length
+
+            start = _clampSliceBound(start, length)
+            stop = _clampSliceBound(stop, length)
+
+            return ListView_(source=self.source, start=self.start + start, stop=self.start + max(start, stop))
+
+        def index(self, value) -> int:
+            """Return the position of the first element equal to 'value', or raise ValueError."""
+            for i in range(self.start, self.stop):
+                if self.source[i] == value:
+                    return i - self.start
+
+            raise ValueError("value is not in the ListView")
+
+        def toList(self) -> ListOf(T):
+            return self.source[self.start:self.stop]
+
+        def _compareTo(self, other) -> int:
+            if isinstance(other, ListView_):
+                return _compareSequences(self.source, self.start, self.stop, other.source, other.start, other.stop)
+
+            return _compareSequences(self.source, self.start, self.stop, other, 0, len(other))
+
+        def __eq__(self, other):
+            return len(self) == len(other) and self._compareTo(other) == 0
+
+        def __ne__(self, other):
+            return not (self == other)
+
+        def __lt__(self, other):
+            return self._compareTo(other) < 0
+
+        def __le__(self, other):
+            return self._compareTo(other) <= 0
+
+        def __gt__(self, other):
+            return self._compareTo(other) > 0
+
+        def __ge__(self, other):
+            return self._compareTo(other) >= 0
+
+        def __repr__(self):
+            return f"ListView({self.toList()!r})"
+
+    return ListView_
+
+
+class StrView(NamedTuple(source=str, start=int, stop=int)):
+    """A read-only view of source[start:stop], for a str 'source'."""
+
+    @staticmethod
+    def of(source: str, start: int = 0, stop: OneOf(None, int) = None):
+        """Return a view of source[start:stop], with the same bounds as that slice."""
+        if stop is None:
+            stop = len(source)
+
+        start = _clampSliceBound(start, len(source))
+        stop = _clampSliceBound(stop, len(source))
+
+        return StrView(source=source, start=start, stop=max(start, stop))
+
+    def __len__(self):
+        return self.stop - self.start
+
+    def __getitem__(self, i: int) -> str:
+        if i < 0:
+            i += self.stop - self.start
+
+        if i < 0 or i >= self.stop - self.start:
+            raise IndexError("StrView index out of range")
+
+        return self.source[self.start + i]
+
+    def __typed_python_int_iter_size__(self):
+        return self.stop - self.start
+
+    def __typed_python_int_iter_value__(self, i):
+        return self.source[self.start + i]
+
+    def __iter__(self):
+        return iter(self.toStr())
+
+    def slice(self, start: int = 0, stop: OneOf(None, int) = None):
+        """Return a view of self[start:stop], which shares our source."""
+        length = self.stop - self.start
+
+        if stop is None:
+            stop = length
+
+        start = _clampSliceBound(start, length)
+        stop = _clampSliceBound(stop, length)
+
+        return StrView(source=self.source, start=self.start + start, stop=self.start + max(start, stop))
+
+    def find(self, sub: str, start: int = 0) -> int:
+        """Return the position of the first 'sub' at or after 'start', or -1."""
+        start = _clampSliceBound(start, self.stop - self.start)
+
+        res = self.source.find(sub, self.start + start, self.stop)
+
+        if res < 0:
+            return -1
+
+        return res - self.start
+
+    def startswith(self, prefix: str) -> bool:
+        if len(prefix) > self.stop - self.start:
+            return False
+
+        return _compareStrs(self.source, self.start, self.start + len(prefix), prefix, 0, len(prefix)) == 0
+
+    def toStr(self) -> str:
+        return self.source[self.start:self.stop]
+
+    def _compareTo(self, other) -> int:
+        if isinstance(other, StrView):
+            return _compareStrs(self.source, self.start, self.stop, other.source, other.start, other.stop)
+
+        return _compareStrs(self.source, self.start, self.stop, other, 0, len(other))
+
+    def __eq__(self, other):
+        return len(self) == len(other) and self._compareTo(other) == 0
+
+    def __ne__(self, other):
+        return not (self == other)
+
+    def __lt__(self, other):
+        return self._compareTo(other) < 0
+
+    def __le__(self, other):
+        return self._compareTo(other) <= 0
+
+    def __gt__(self, other):
+        return self._compareTo(other) > 0
+
+    def __ge__(self, other):
+        return self._compareTo(other) >= 0
+
+    def __str__(self):
+        return self.toStr()
+
+    def __repr__(self):
+        return f"StrView({self.toStr()!r})"
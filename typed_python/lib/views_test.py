@@ -0,0 +1,159 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import Entrypoint, ListOf
+from typed_python.lib.views import ListView, StrView
+
+
+IntView = ListView(int)
+
+
+def test_list_view_matches_slicing():
+    lst = ListOf(int)(range(10))
+
+    for start in range(-12, 12, 3):
+        for stop in [None, -12, -3, 0, 4, 9, 12]:
+            view = IntView.of(lst, start, stop)
+
+            assert view.toList() == lst[start:stop]
+            assert len(view) == len(lst[start:stop])
+            assert list(view) == list(lst[start:stop])
+
+    view = IntView.of(lst, 2, 8)
+
+    assert view[0] == 2 and view[-1] == 7
+    assert view.slice(1, -1).toList() == [3, 4, 5, 6]
+    assert view.index(5) == 3
+
+    with pytest.raises(IndexError):
+        view[6]
+
+    with pytest.raises(ValueError):
+        view.index(9)
+
+
+def test_list_view_comparison():
+    lst = ListOf(int)([1, 2, 3, 1, 2, 4])
+
+    assert IntView.of(lst, 0, 2) == IntView.of(lst, 3, 5)
+    assert IntView.of(lst, 0, 3) < IntView.of(lst, 3, 6)
+    assert IntView.of(lst, 0, 2) < IntView.of(lst, 0, 3)
+    assert IntView.of(lst, 0, 3) == ListOf(int)([1, 2, 3])
+    assert IntView.of(lst, 0, 3) != ListOf(int)([1, 2])
+
+
+def test_list_view_compiled():
+    @Entrypoint
+    def windowSums(lst: ListOf(int), width: int) -> ListOf(int):
+        res = ListOf(int)()
+
+        for i in range(len(lst) - width + 1):
+            window = IntView.of(lst, i, i + width)
+
+            total = 0
+            for x in window:
+                total += x
+
+            res.append(total)
+
+        return res
+
+    lst = ListOf(int)(range(20))
+
+    assert windowSums(lst, 3) == [sum(lst[i:i + 3]) for i in range(18)]
+
+    @Entrypoint
+    def firstAndLast(lst: ListOf(int)):
+        view = IntView.of(lst, 1, -1)
+        return (len(view), view[0], view[-1])
+
+    assert firstAndLast(lst) == (18, 1, 18)
+
+    @Entrypoint
+    def viewsEqual(lst: ListOf(int), a: int, b: int, width: int) -> bool:
+        return IntView.of(lst, a, a + width) == IntView.of(lst, b, b + width)
+
+    assert viewsEqual(ListOf(int)([1, 2, 1, 2]), 0, 2, 2)
+    assert not viewsEqual(ListOf(int)([1, 2, 1, 3]), 0, 2, 2)
+
+
+def test_str_view_matches_slicing():
+    s = "hello, wörld, 🌍!"
+
+    for start in range(-20, 20, 3):
+        for stop in [None, -20, -3, 0, 4, 15, 20]:
+            view = StrView.of(s, start, stop)
+
+            assert view.toStr() == s[start:stop]
+            assert str(view) == s[start:stop]
+            assert len(view) == len(s[start:stop])
+            assert list(view) == list(s[start:stop])
+
+    view = StrView.of(s, 7)
+
+    assert view[0] == "w" and view[-1] == "!"
+    assert view.find(",") == 5
+    assert view.find("x") == -1
+    assert view.find("ö", 2) == -1
+    assert view.startswith("wör")
+    assert not view.startswith("wörld!")
+    assert view.slice(0, 5) == "wörld"
+    assert view.slice(0, 5) < "wörle"
+    assert view.slice(0, 5) > "wör"
+
+
+def test_str_view_compiled():
+    @Entrypoint
+    def splitFields(line: str) -> ListOf(str):
+        res = ListOf(str)()
+        rest = StrView.of(line)
+
+        while True:
+            comma = rest.find(",")
+
+            if comma < 0:
+                res.append(rest.toStr())
+                return res
+
+            res.append(rest.slice(0, comma).toStr())
+            rest = rest.slice(comma + 1)
+
+    assert splitFields("a,bb,,ccc") == ["a", "bb", "", "ccc"]
+    assert splitFields("") == [""]
+
+    @Entrypoint
+    def countMatching(line: str, word: str) -> int:
+        res = 0
+        view = StrView.of(line)
+
+        for i in range(len(line) - len(word) + 1):
+            if view.slice(i, i + len(word)) == word:
+                res += 1
+
+        return res
+
+    assert countMatching("abcabcab", "ab") == 3
+
+    @Entrypoint
+    def codepoints(s: str) -> ListOf(str):
+        res = ListOf(str)()
+
+        for c in StrView.of(s, 1, -1):
+            res.append(c)
+
+        return res
+
+    assert codepoints("[xyz]") == ["x", "y", "z"]
@@ -0,0 +1,326 @@
+#   Copyright 2017-2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A bounded multi-producer, multi-consumer queue that doesn't take a lock.
+
+This is Dmitry Vyukov's ring buffer. Every cell in the ring has a sequence
+number saying which lap of the ring it's ready for. A producer claims position
+'pos' by compare-exchanging the enqueue counter from 'pos' to 'pos + 1', but only
+once it has seen that the cell's sequence number is 'pos', meaning the consumer
+from the previous lap is done with it. It then writes the value and sets the
+sequence number to 'pos + 1', which tells the consumer of 'pos' that the value
+is there. Consumers do the same thing with the dequeue counter, and hand the
+cell back by setting its sequence number to 'pos + capacity'.
+
+putMany and getMany claim a run of consecutive cells with a single
+compare-exchange, so batches cost one contended operation rather than one each.
+
+A thread that can't make progress (the queue is full, or empty) spins for a
+while and then parks on a TypedQueue until the other side wakes it. Pass
+'spinCount=-1' to spin forever, which is faster if you have cores to spare.
+
+The atomic operations are only available in compiled code, so every public
+method is an Entrypoint. From the interpreter, call them like any other method.
+"""
+
+from typed_python import Class, Final, Member, TypeFunction, ListOf, OneOf, Tuple, Entrypoint
+from typed_python.typed_queue import TypedQueue
+
+
+# indices into '_counters'. They're a cache line apart so producers and consumers
+# don't fight over the same line.
+_ENQUEUE = 0
+_DEQUEUE = 8
+_WAITING_GETTERS = 16
+_WAITING_PUTTERS = 24
+_COUNTER_SLOTS = 32
+
+
+@TypeFunction
+def LockFreeQueue(T):
+    """Create a bounded lock-free queue with elements of type T."""
+    class LockFreeQueue(Class, Final):
+        capacity = Member(int)
+        spinCount = Member(int)
+        _mask = Member(int)
+        _sequences = Member(ListOf(int))
+
+        # reserved but never resized: we construct and destroy values in place
+        _slots = Member(ListOf(T))
+        _counters = Member(ListOf(int))
+
+        # parked threads wait on these. '_counters' holds how many are waiting on each.
+        _getterWakeups = Member(TypedQueue(int))
+        _putterWakeups = Member(TypedQueue(int))
+
+        def __init__(self, capacity=1024, spinCount=1000):
+            """Create a queue holding at least 'capacity' elements.
+
+            Args:
+                capacity - the minimum number of elements the queue can hold.
+                    We round it up to a power of two.
+                spinCount - how many times a blocked 'get' or 'put' retries before
+                    parking its thread. If negative, never park.
+            """
+            assert capacity > 0
+
+            size = 1
+            while size < capacity:
+                size *= 2
+
+            self.capacity = size
+            self.spinCount = spinCount
+            self._mask = size - 1
+            self._sequences = ListOf(int)(list(range(size)))
+            self._slots = ListOf(T)()
+            self._slots.reserve(size)
+            self._counters = ListOf(int)()
+            self._counters.resize(_COUNTER_SLOTS)
+            self._getterWakeups = TypedQueue(int)()
+            self._putterWakeups = TypedQueue(int)()
+
+        def __del__(self):
+            # nobody else can be using us, so everything claimed has been published
+            pos = self._counters[_DEQUEUE]
+
+            while pos < self._counters[_ENQUEUE]:
+                self._slots.pointerUnsafe(pos & self._mask).destroy()
+                pos += 1
+
+        @Entrypoint
+        def tryPut(self, element: T) -> bool:
+            """Add 'element' to the queue and return True, or return False if the queue is full."""
+            pos, count = self._claim(_ENQUEUE, 0, 1)
+
+            if not count:
+                return False
+
+            self._place(pos, element)
+            self._wake(_WAITING_GETTERS, self._getterWakeups, 1)
+
+            return True
+
+        @Entrypoint
+        def put(self, element: T) -> None:
+            """Add 'element' to the queue, waiting for room if it's full."""
+            spins = 0
+
+            while True:
+                pos, count = self._claim(_ENQUEUE, 0, 1)
+
+                if count:
+                    self._place(pos, element)
+                    self._wake(_WAITING_GETTERS, self._getterWakeups, 1)
+                    return
+
+                spins = self._wait(spins, _ENQUEUE, 0, _WAITING_PUTTERS, self._putterWakeups)
+
+        @Entrypoint
+        def putMany(self, elements: ListOf(T)) -> None:
+            """Add all of 'elements' to the queue in order, waiting for room as needed."""
+            start = 0
+            spins = 0
+
+            while start < len(elements):
+                pos, count = self._claim(_ENQUEUE, 0, len(elements) - start)
+
+                if count:
+                    for i in range(count):
+                        self._place(pos + i, elements[start + i])
+
+                    self._wake(_WAITING_GETTERS, self._getterWakeups, count)
+
+                    start += count
+                    spins = 0
+                else:
+                    spins = self._wait(spins, _ENQUEUE, 0, _WAITING_PUTTERS, self._putterWakeups)
+
+        @Entrypoint
+        def tryGet(self) -> OneOf(None, T):
+            """Return the oldest element in the queue, or None if it's empty."""
+            pos, count = self._claim(_DEQUEUE, 1, 1)
+
+            if not count:
+                return None
+
+            res = self._take(pos)
+            self._wake(_WAITING_PUTTERS, self._putterWakeups, 1)
+
+            return res
+
+        @Entrypoint
+        def get(self) -> T:
+            """Return the oldest element in the queue, waiting for one if it's empty."""
+            spins = 0
+
+            while True:
+                pos, count = self._claim(_DEQUEUE, 1, 1)
+
+                if count:
+                    res = self._take(pos)
+                    self._wake(_WAITING_PUTTERS, self._putterWakeups, 1)
+                    return res
+
+                spins = self._wait(spins, _DEQUEUE, 1, _WAITING_GETTERS, self._getterWakeups)
+
+        @Entrypoint
+        def getMany(self, minCount: int, maxCount: int) -> ListOf(T):
+            """Return up to 'maxCount' of the oldest elements, waiting until we have at least 'minCount'."""
+            res = ListOf(T)()
+            spins = 0
+
+            while len(res) < maxCount:
+                pos, count = self._claim(_DEQUEUE, 1, maxCount - len(res))
+
+                if count:
+                    for i in range(count):
+                        res.append(self._take(pos + i))
+
+                    self._wake(_WAITING_PUTTERS, self._putterWakeups, count)
+
+                    spins = 0
+                elif len(res) >= minCount:
+                    return res
+                else:
+                    spins = self._wait(spins, _DEQUEUE, 1, _WAITING_GETTERS, self._getterWakeups)
+
+            return res
+
+        @Entrypoint
+        def __len__(self) -> int:
+            """The number of elements in the queue. Only a snapshot if other threads are using it."""
+            dequeued = self._counters.pointerUnsafe(_DEQUEUE).atomicLoad()
+            enqueued = self._counters.pointerUnsafe(_ENQUEUE).atomicLoad()
+
+            return max(0, min(self.capacity, enqueued - dequeued))
+
+        def _claim(self, counterIx: int, readyOffset: int, maxCount: int) -> Tuple(int, int):
+            """Claim up to 'maxCount' consecutive positions from one of the counters.
+
+            The cell for position 'pos' is ready for us when its sequence number is
+            'pos + readyOffset'.
+
+            Returns:
+                (pos, count), where we own positions [pos, pos + count). 'count' is
+                zero if the first cell isn't ready, meaning the queue is full (for
+                producers) or empty (for consumers).
+            """
+            counter = self._counters.pointerUnsafe(counterIx)
+            pos = counter.atomicLoad()
+
+            while True:
+                count = 0
+                seq = 0
+
+                while count < maxCount:
+                    seq = self._sequences.pointerUnsafe((pos + count) & self._mask).atomicLoad()
+
+                    if seq != pos + count + readyOffset:
+                        break
+
+                    count += 1
+
+                if count:
+                    seen = counter.atomicCompareExchange(pos, pos + count)
+
+                    if seen == pos:
+                        return (pos, count)
+
+                    pos = seen
+                elif maxCount <= 0 or seq < pos + readyOffset:
+                    # the cell is still on the previous lap
+                    return (pos, 0)
+                else:
+                    # somebody claimed 'pos' before we could
+                    pos = counter.atomicLoad()
+
+        def _place(self, pos: int, element: T) -> None:
+            cell = pos & self._mask
+
+            self._slots.pointerUnsafe(cell).initialize(element)
+            self._sequences.pointerUnsafe(cell).atomicStore(pos + 1)
+
+        def _take(self, pos: int) -> T:
+            cell = pos & self._mask
+            slot = self._slots.pointerUnsafe(cell)
+
+            res = slot.get()
+            slot.destroy()
+
+            self._sequences.pointerUnsafe(cell).atomicStore(pos + self.capacity)
+
+            return res
+
+        def _isBlocked(self, counterIx: int, readyOffset: int) -> bool:
+            pos = self._counters.pointerUnsafe(counterIx).atomicLoad()
+
+            return self._sequences.pointerUnsafe(pos & self._mask).atomicLoad() < pos + readyOffset
+
+        def _wait(self, spins: int, counterIx: int, readyOffset: int, waitingIx: int, wakeups: TypedQueue(int)) -> int:
+            """Called when we couldn't claim anything. Returns the new spin count.
+
+            To park, we count ourselves in the waiting counter and then look at the
+            queue again. Whoever publishes a cell does the same thing the other way
+            around, and all of it is sequentially consistent, so either we see their
+            cell or they see us waiting and wake us up.
+            """
+            if self.spinCount < 0 or spins < self.spinCount:
+                return spins + 1
+
+            waiting = self._counters.pointerUnsafe(waitingIx)
+
+            n = waiting.atomicLoad()
+            while waiting.atomicCompareExchange(n, n + 1) != n:
+                n = waiting.atomicLoad()
+
+            if not self._isBlocked(counterIx, readyOffset):
+                # take ourselves back out of the count. If somebody already did
+                # that for us, they've sent us a wakeup we have to consume.
+                n = waiting.atomicLoad()
+
+                while True:
+                    if n == 0:
+                        wakeups.get()
+                        return 0
+
+                    seen = waiting.atomicCompareExchange(n, n - 1)
+
+                    if seen == n:
+                        return 0
+
+                    n = seen
+
+            wakeups.get()
+
+            return 0
+
+        def _wake(self, waitingIx: int, wakeups: TypedQueue(int), count: int) -> None:
+            """Wake up to 'count' threads parked on 'wakeups'."""
+            waiting = self._counters.pointerUnsafe(waitingIx)
+
+            n = waiting.atomicLoad()
+
+            while n > 0:
+                toWake = min(n, count)
+                seen = waiting.atomicCompareExchange(n, n - toWake)
+
+                if seen == n:
+                    for _ in range(toWake):
+                        wakeups.put(0)
+                    return
+
+                n = seen
+
+    return LockFreeQueue
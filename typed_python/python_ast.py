@@ -1449,21 +1449,13 @@ def evaluateFunctionDefWithLocalsInCells(pyAst, globals, locals, stripAnnotation
         else:
             bodyExpr = pyAst.elt
 
-        body = Statement.Expr(value=Expr.Yield(value=bodyExpr))
-
-        for comprehension in pyAst.generators:
-            for ifExpr in comprehension.ifs:
-                body = Statement.If(
-                    test=ifExpr,
-                    body=[body],
-                    orelse=[]
-                )
+        # we have to import this within the function to break the import cycle
+        from typed_python.compiler.comprehension_fusion import comprehensionLoops
 
-            body = Statement.For(
-                target=comprehension.target,
-                iter=comprehension.iter,
-                body=[body]
-            )
+        body = comprehensionLoops(
+            pyAst.generators,
+            [Statement.Expr(value=Expr.Yield(value=bodyExpr))]
+        )
 
         statements = [
             Statement.FunctionDef(
@@ -1472,7 +1464,7 @@ def evaluateFunctionDefWithLocalsInCells(pyAst, globals, locals, stripAnnotation
                     vararg=None,
                     kwarg=None
                 ),
-                body=[body],
+                body=body,
                 returns=None
             ),
             Statement.Return(value=Expr.Name(id="__typed_python_generator_builder__", ctx=ExprContext.Load()))
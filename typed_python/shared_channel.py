@@ -0,0 +1,499 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+A bounded multi-producer, multi-consumer channel between processes.
+
+TypedQueue and LockFreeQueue only work between threads, so handing typed data
+to a worker process has meant serializing it, writing it down a pipe, and
+deserializing it on the other side. A SharedChannel(T) keeps its whole ring in
+a MAP_SHARED mapping instead, and every process that maps it can put and get:
+
+    channel = SharedChannel(Trade)(capacity=4096)
+
+    ctx = multiprocessing.get_context("fork")
+    ctx.Process(target=lambda: consume(channel)).start()
+
+    channel.putMany(trades)
+
+The ring is LockFreeQueue's (Dmitry Vyukov's bounded queue), with the counters,
+sequence numbers and slots all in the shared mapping. How a value goes into
+its slot depends on T:
+
+    POD types (numbers, and Tuples and NamedTuples of them) are written into
+        the slot as they are, with no encoding.
+    Anything else is serialized into the slot, behind an 8 byte length. The
+        channel's 'slotBytes' bounds how big a serialized value can be, and
+        putting a bigger one raises a ValueError.
+
+A process that can't make progress spins for a while and then sleeps on a
+process-shared futex in the mapping, until a process on the other side wakes
+it. Pass 'spinCount=-1' to spin forever.
+
+By default the mapping is anonymous, so only processes forked after the channel
+was created can see it. Pass 'path' (say, somewhere in /dev/shm) to back it
+with a file instead, and call 'SharedChannel(T).attach(path)' from any other
+process to map the same channel. Nothing in the file records T itself, just
+its layout, so both sides have to agree on it.
+
+Like LockFreeQueue, every public method is an Entrypoint.
+"""
+
+import mmap
+import os
+
+from typed_python import (
+    Class, Final, Member, TypeFunction, ListOf, OneOf, Tuple, Entrypoint, PointerTo, UInt8, Int32
+)
+from typed_python._types import bufferAddress, bytecount, serialize, deserializeBuffer
+from typed_python.lib.compact_slab import _isRelocatablePod
+
+
+# "TPSC", read as a little-endian int
+_MAGIC = 0x43535054
+_VERSION = 1
+
+# byte offsets of the fields in the header. The header describes the channel, so
+# 'attach' can check that it matches.
+_MAGIC_AT = 0
+_VERSION_AT = 8
+_CAPACITY_AT = 16
+_SLOT_BYTES_AT = 24
+_INLINE_BYTES_AT = 32
+
+# the counters, a cache line apart so producers and consumers don't fight over
+# the same line. Each waiting count is followed by the Int32 that its waiters
+# sleep on.
+_ENQUEUE = 64
+_DEQUEUE = 128
+_WAITING_GETTERS = 192
+_WAITING_PUTTERS = 256
+_FUTEX_OFFSET = 8
+
+# the sequence numbers start here, followed by the slots
+_HEADER_BYTES = 320
+
+
+def _alignUp(x, alignment):
+    return (x + alignment - 1) // alignment * alignment
+
+
+def _slotsStart(capacity):
+    return _alignUp(_HEADER_BYTES + capacity * 8, 64)
+
+
+def _mapChannel(path, byteCount):
+    """Map a new channel of 'byteCount' bytes, or the existing one at 'path' if 'byteCount' is None.
+
+    Returns:
+        (view, base, size), where 'view' is a memoryview that keeps the mapping
+        alive and 'base' is a PointerTo(UInt8) to its first byte.
+    """
+    if path is None:
+        mapping = mmap.mmap(-1, byteCount, flags=mmap.MAP_SHARED)
+    else:
+        if byteCount is None:
+            fd = os.open(path, os.O_RDWR)
+        else:
+            fd = os.open(path, os.O_RDWR | os.O_CREAT | os.O_TRUNC, 0o600)
+            os.ftruncate(fd, byteCount)
+
+        try:
+            mapping = mmap.mmap(fd, 0, flags=mmap.MAP_SHARED)
+        finally:
+            os.close(fd)
+
+    view = memoryview(mapping)
+    address, size = bufferAddress(view)
+
+    # there's no conversion from an int to a pointer, so offset a null one
+    return view, PointerTo(UInt8)() + address, size
+
+
+@TypeFunction
+def _InPlaceSlots(T):
+    """Writes and reads POD values directly in their slots."""
+    class _InPlaceSlots_(Class, Final):
+        inlineBytes = bytecount(T)
+
+        @staticmethod
+        def slotBytes(requested: int) -> int:
+            return _alignUp(bytecount(T), 8)
+
+        @staticmethod
+        def encode(value: T, slotBytes: int) -> T:
+            return value
+
+        @staticmethod
+        def encodeMany(values: ListOf(T), slotBytes: int) -> ListOf(T):
+            return values
+
+        @staticmethod
+        def write(p: PointerTo(UInt8), value: T) -> None:
+            p.cast(T).set(value)
+
+        @staticmethod
+        def read(p: PointerTo(UInt8)) -> T:
+            return p.cast(T).get()
+
+    return _InPlaceSlots_
+
+
+@TypeFunction
+def _SerializedSlots(T):
+    """Serializes values into their slots, behind their length."""
+    typeName = T.__name__
+
+    class _SerializedSlots_(Class, Final):
+        # marks the layout as serialized in the channel's header
+        inlineBytes = -1
+
+        @staticmethod
+        def slotBytes(requested: int) -> int:
+            return _alignUp(max(requested, 16), 8)
+
+        @staticmethod
+        def encode(value: T, slotBytes: int) -> bytes:
+            data = serialize(T, value, None)
+
+            if len(data) > slotBytes - 8:
+                raise ValueError(
+                    f"A serialized {typeName} takes {len(data)} bytes, "
+                    f"but the channel's slots only hold {slotBytes - 8}"
+                )
+
+            return data
+
+        @staticmethod
+        def encodeMany(values: ListOf(T), slotBytes: int) -> ListOf(bytes):
+            res = ListOf(bytes)()
+            res.reserve(len(values))
+
+            for v in values:
+                res.append(_SerializedSlots_.encode(v, slotBytes))
+
+            return res
+
+        @staticmethod
+        def write(p: PointerTo(UInt8), data: bytes) -> None:
+            p.cast(int).set(len(data))
+            p += 8
+
+            for i in range(len(data)):
+                (p + i).set(UInt8(data[i]))
+
+        @staticmethod
+        def read(p: PointerTo(UInt8)) -> T:
+            return deserializeBuffer(T, int(p + 8), p.cast(int).get(), None)
+
+    return _SerializedSlots_
+
+
+@TypeFunction
+def SharedChannel(T):
+    """Create a bounded channel between processes with elements of type T."""
+    Slots = _InPlaceSlots(T) if _isRelocatablePod(T) else _SerializedSlots(T)
+
+    class SharedChannel(Class, Final):
+        capacity = Member(int)
+        slotBytes = Member(int)
+        spinCount = Member(int)
+        path = Member(OneOf(None, str))
+        _mask = Member(int)
+        _slotsStart = Member(int)
+
+        # holds the mapping open, and where it starts
+        _view = Member(object)
+        _base = Member(PointerTo(UInt8))
+
+        def __init__(self, capacity=1024, path=None, slotBytes=256, spinCount=1000, _attach=False):
+            """Create a channel holding at least 'capacity' elements.
+
+            Args:
+                capacity - the minimum number of elements the channel can hold.
+                    We round it up to a power of two.
+                path - if not None, the file to keep the channel in, so that
+                    other processes can 'attach' to it. We replace anything
+                    that's already there.
+                slotBytes - the most bytes a serialized element can take, if T
+                    isn't POD. Ignored otherwise.
+                spinCount - how many times a blocked 'get' or 'put' retries before
+                    the process sleeps. If negative, never sleep.
+            """
+            self.spinCount = spinCount
+            self.path = path
+
+            if _attach:
+                self._view, self._base, size = _mapChannel(path, None)
+
+                if size < _HEADER_BYTES or self._word(_MAGIC_AT).get() != _MAGIC:
+                    raise ValueError(f"{path} isn't a SharedChannel")
+
+                if self._word(_VERSION_AT).get() != _VERSION:
+                    raise ValueError(f"Can't read version {self._word(_VERSION_AT).get()} of the SharedChannel format")
+
+                if self._word(_INLINE_BYTES_AT).get() != Slots.inlineBytes:
+                    raise TypeError(f"The SharedChannel at {path} doesn't hold {T.__name__}")
+
+                self.capacity = self._word(_CAPACITY_AT).get()
+                self.slotBytes = self._word(_SLOT_BYTES_AT).get()
+                self._mask = self.capacity - 1
+                self._slotsStart = _slotsStart(self.capacity)
+
+                if size < self._slotsStart + self.capacity * self.slotBytes:
+                    raise ValueError(f"The SharedChannel at {path} is truncated")
+
+                return
+
+            assert capacity > 0
+
+            size = 1
+            while size < capacity:
+                size *= 2
+
+            self.capacity = size
+            self.slotBytes = Slots.slotBytes(slotBytes)
+            self._mask = size - 1
+            self._slotsStart = _slotsStart(size)
+
+            self._view, self._base, _ = _mapChannel(path, self._slotsStart + size * self.slotBytes)
+
+            for i in range(size):
+                self._sequence(i).set(i)
+
+            self._word(_VERSION_AT).set(_VERSION)
+            self._word(_CAPACITY_AT).set(self.capacity)
+            self._word(_SLOT_BYTES_AT).set(self.slotBytes)
+            self._word(_INLINE_BYTES_AT).set(Slots.inlineBytes)
+
+            # last, so nobody attaches to a half-written channel
+            self._word(_MAGIC_AT).set(_MAGIC)
+
+        @staticmethod
+        def attach(path, spinCount=1000):
+            """Map the channel another process created at 'path'."""
+            return SharedChannel(path=path, spinCount=spinCount, _attach=True)
+
+        @Entrypoint
+        def tryPut(self, element: T) -> bool:
+            """Add 'element' to the channel and return True, or return False if it's full."""
+            encoded = Slots.encode(element, self.slotBytes)
+
+            pos, count = self._claim(_ENQUEUE, 0, 1)
+
+            if not count:
+                return False
+
+            self._place(pos, encoded)
+            self._wake(_WAITING_GETTERS, 1)
+
+            return True
+
+        @Entrypoint
+        def put(self, element: T) -> None:
+            """Add 'element' to the channel, waiting for room if it's full."""
+            encoded = Slots.encode(element, self.slotBytes)
+            spins = 0
+
+            while True:
+                pos, count = self._claim(_ENQUEUE, 0, 1)
+
+                if count:
+                    self._place(pos, encoded)
+                    self._wake(_WAITING_GETTERS, 1)
+                    return
+
+                spins = self._wait(spins, _ENQUEUE, 0, _WAITING_PUTTERS)
+
+        @Entrypoint
+        def putMany(self, elements: ListOf(T)) -> None:
+            """Add all of 'elements' to the channel in order, waiting for room as needed."""
+            encoded = Slots.encodeMany(elements, self.slotBytes)
+            start = 0
+            spins = 0
+
+            while start < len(encoded):
+                pos, count = self._claim(_ENQUEUE, 0, len(encoded) - start)
+
+                if count:
+                    for i in range(count):
+                        self._place(pos + i, encoded[start + i])
+
+                    self._wake(_WAITING_GETTERS, count)
+
+                    start += count
+                    spins = 0
+                else:
+                    spins = self._wait(spins, _ENQUEUE, 0, _WAITING_PUTTERS)
+
+        @Entrypoint
+        def tryGet(self) -> OneOf(None, T):
+            """Return the oldest element in the channel, or None if it's empty."""
+            pos, count = self._claim(_DEQUEUE, 1, 1)
+
+            if not count:
+                return None
+
+            res = self._take(pos)
+            self._wake(_WAITING_PUTTERS, 1)
+
+            return res
+
+        @Entrypoint
+        def get(self) -> T:
+            """Return the oldest element in the channel, waiting for one if it's empty."""
+            spins = 0
+
+            while True:
+                pos, count = self._claim(_DEQUEUE, 1, 1)
+
+                if count:
+                    res = self._take(pos)
+                    self._wake(_WAITING_PUTTERS, 1)
+                    return res
+
+                spins = self._wait(spins, _DEQUEUE, 1, _WAITING_GETTERS)
+
+        @Entrypoint
+        def getMany(self, minCount: int, maxCount: int) -> ListOf(T):
+            """Return up to 'maxCount' of the oldest elements, waiting until we have at least 'minCount'."""
+            res = ListOf(T)()
+            spins = 0
+
+            while len(res) < maxCount:
+                pos, count = self._claim(_DEQUEUE, 1, maxCount - len(res))
+
+                if count:
+                    for i in range(count):
+                        res.append(self._take(pos + i))
+
+                    self._wake(_WAITING_PUTTERS, count)
+
+                    spins = 0
+                elif len(res) >= minCount:
+                    return res
+                else:
+                    spins = self._wait(spins, _DEQUEUE, 1, _WAITING_GETTERS)
+
+            return res
+
+        @Entrypoint
+        def __len__(self) -> int:
+            """The number of elements in the channel. Only a snapshot if other processes are using it."""
+            dequeued = self._word(_DEQUEUE).atomicLoad()
+            enqueued = self._word(_ENQUEUE).atomicLoad()
+
+            return max(0, min(self.capacity, enqueued - dequeued))
+
+        def _word(self, offset: int) -> PointerTo(int):
+            return (self._base + offset).cast(int)
+
+        def _sequence(self, cell: int) -> PointerTo(int):
+            return (self._base + _HEADER_BYTES + cell * 8).cast(int)
+
+        def _slot(self, cell: int) -> PointerTo(UInt8):
+            return self._base + self._slotsStart + cell * self.slotBytes
+
+        def _claim(self, counterOffset: int, readyOffset: int, maxCount: int) -> Tuple(int, int):
+            """Claim up to 'maxCount' consecutive positions from one of the counters.
+
+            Works exactly like LockFreeQueue._claim.
+
+            Returns:
+                (pos, count), where we own positions [pos, pos + count). 'count' is
+                zero if the channel is full (for producers) or empty (for consumers).
+            """
+            counter = self._word(counterOffset)
+            pos = counter.atomicLoad()
+
+            while True:
+                count = 0
+                seq = 0
+
+                while count < maxCount:
+                    seq = self._sequence((pos + count) & self._mask).atomicLoad()
+
+                    if seq != pos + count + readyOffset:
+                        break
+
+                    count += 1
+
+                if count:
+                    seen = counter.atomicCompareExchange(pos, pos + count)
+
+                    if seen == pos:
+                        return (pos, count)
+
+                    pos = seen
+                elif maxCount <= 0 or seq < pos + readyOffset:
+                    # the cell is still on the previous lap
+                    return (pos, 0)
+                else:
+                    # somebody claimed 'pos' before we could
+                    pos = counter.atomicLoad()
+
+        def _place(self, pos: int, encoded) -> None:
+            cell = pos & self._mask
+
+            Slots.write(self._slot(cell), encoded)
+            self._sequence(cell).atomicStore(pos + 1)
+
+        def _take(self, pos: int) -> T:
+            cell = pos & self._mask
+
+            res = Slots.read(self._slot(cell))
+            self._sequence(cell).atomicStore(pos + self.capacity)
+
+            return res
+
+        def _isBlocked(self, counterOffset: int, readyOffset: int) -> bool:
+            pos = self._word(counterOffset).atomicLoad()
+
+            return self._sequence(pos & self._mask).atomicLoad() < pos + readyOffset
+
+        def _wait(self, spins: int, counterOffset: int, readyOffset: int, waitingOffset: int) -> int:
+            """Called when we couldn't claim anything. Returns the new spin count.
+
+            To sleep, we count ourselves in the waiting counter, read the futex
+            word, and only then look at the channel again. Whoever publishes a
+            cell does the same thing the other way around, and all of it is
+            sequentially consistent, so either we see their cell, or they see us
+            waiting and bump the futex word after we read it, which means
+            'sharedFutexWait' won't sleep through it.
+            """
+            if self.spinCount < 0 or spins < self.spinCount:
+                return spins + 1
+
+            waiting = self._word(waitingOffset)
+            futex = (self._base + waitingOffset + _FUTEX_OFFSET).cast(Int32)
+
+            waiting.atomicFetchAdd(1)
+            epoch = futex.atomicLoad()
+
+            if self._isBlocked(counterOffset, readyOffset):
+                futex.sharedFutexWait(epoch)
+
+            waiting.atomicFetchAdd(-1)
+
+            return 0
+
+        def _wake(self, waitingOffset: int, count: int) -> None:
+            """Wake up to 'count' processes sleeping in '_wait' on 'waitingOffset'."""
+            if self._word(waitingOffset).atomicLoad() > 0:
+                futex = (self._base + waitingOffset + _FUTEX_OFFSET).cast(Int32)
+
+                futex.atomicFetchAdd(1)
+                futex.sharedFutexWake(count)
+
+    return SharedChannel
@@ -0,0 +1,343 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+"""
+Atomics and locks for compiled code that don't go through Python objects.
+
+A '_thread.LockType' works in compiled code, but it's a Python object that we
+reach into, and a thread blocked on it can't be interrupted. These are plain
+typed_python Classes, so they can be Class members, and their operations
+compile down to inline atomic instructions:
+
+    AtomicInt       load / store / fetchAdd / exchange / compareExchange
+    AtomicFloat     the same, on a float
+    SpinLock        a lock that never sleeps, for very short critical sections
+    Mutex           a lock that spins briefly and then sleeps on a futex
+    Condition       a condition variable over a Mutex
+    Semaphore       a counting semaphore
+
+The locks support 'with':
+
+    class Counter(Class, Final):
+        lock = Member(Mutex)
+        counts = Member(Dict(str, int))
+
+        @Entrypoint
+        def add(self, k: str) -> None:
+            with self.lock:
+                self.counts[k] = self.counts.get(k, 0) + 1
+
+Blocking releases the GIL. Every method is an Entrypoint, since atomic
+operations only exist in compiled code.
+
+On Linux, Mutex, Condition and Semaphore sleep on a futex. Elsewhere they
+poll, which works but wakes up slowly.
+"""
+
+from typed_python import Class, Final, Member, ListOf, Int32, Entrypoint
+
+import time
+
+
+# how many times Mutex.acquire retries before it sleeps
+MUTEX_SPIN_COUNT = 100
+
+
+def _timeoutToNanoseconds(timeout: float) -> int:
+    if timeout < 0:
+        return -1
+
+    return int(timeout * 1e9)
+
+
+class AtomicInt(Class, Final):
+    """An int that can be updated atomically from many threads."""
+
+    _cell = Member(ListOf(int), nonempty=True)
+
+    def __init__(self, value=0):
+        self._cell.resize(1)
+        self._cell[0] = value
+
+    @Entrypoint
+    def load(self) -> int:
+        return self._cell.pointerUnsafe(0).atomicLoad()
+
+    @Entrypoint
+    def store(self, value: int) -> None:
+        self._cell.pointerUnsafe(0).atomicStore(value)
+
+    @Entrypoint
+    def fetchAdd(self, delta: int) -> int:
+        """Add 'delta', returning the value from before."""
+        return self._cell.pointerUnsafe(0).atomicFetchAdd(delta)
+
+    @Entrypoint
+    def exchange(self, value: int) -> int:
+        """Store 'value', returning the value from before."""
+        return self._cell.pointerUnsafe(0).atomicExchange(value)
+
+    @Entrypoint
+    def compareExchange(self, expected: int, value: int) -> bool:
+        """Store 'value' if we hold 'expected'. Returns whether we did."""
+        return self._cell.pointerUnsafe(0).atomicCompareExchange(expected, value) == expected
+
+
+class AtomicFloat(Class, Final):
+    """A float that can be updated atomically from many threads."""
+
+    _cell = Member(ListOf(float), nonempty=True)
+
+    def __init__(self, value=0.0):
+        self._cell.resize(1)
+        self._cell[0] = value
+
+    @Entrypoint
+    def load(self) -> float:
+        return self._cell.pointerUnsafe(0).atomicLoad()
+
+    @Entrypoint
+    def store(self, value: float) -> None:
+        self._cell.pointerUnsafe(0).atomicStore(value)
+
+    @Entrypoint
+    def fetchAdd(self, delta: float) -> float:
+        """Add 'delta', returning the value from before."""
+        return self._cell.pointerUnsafe(0).atomicFetchAdd(delta)
+
+    @Entrypoint
+    def exchange(self, value: float) -> float:
+        """Store 'value', returning the value from before."""
+        return self._cell.pointerUnsafe(0).atomicExchange(value)
+
+    @Entrypoint
+    def compareExchange(self, expected: float, value: float) -> bool:
+        """Store 'value' if we hold 'expected'. Returns whether we did.
+
+        The exchange compares bits, but we report the result by comparing
+        floats, so this can't tell 0.0 from -0.0, and never succeeds on a nan.
+        """
+        return self._cell.pointerUnsafe(0).atomicCompareExchange(expected, value) == expected
+
+
+class SpinLock(Class, Final):
+    """A lock that busy-waits. Only use it to protect a handful of instructions."""
+
+    _cell = Member(ListOf(int), nonempty=True)
+
+    def __init__(self):
+        self._cell.resize(1)
+
+    @Entrypoint
+    def tryAcquire(self) -> bool:
+        return self._cell.pointerUnsafe(0).atomicCompareExchange(0, 1) == 0
+
+    @Entrypoint
+    def acquire(self) -> None:
+        p = self._cell.pointerUnsafe(0)
+
+        while p.atomicCompareExchange(0, 1) != 0:
+            # wait for it to look free before we try to write to it again
+            while p.atomicLoad() != 0:
+                pass
+
+    @Entrypoint
+    def release(self) -> None:
+        self._cell.pointerUnsafe(0).atomicStore(0)
+
+    @Entrypoint
+    def __enter__(self) -> None:
+        self.acquire()
+
+    @Entrypoint
+    def __exit__(self, excType, excValue, traceback) -> bool:
+        self.release()
+        return False
+
+
+class Mutex(Class, Final):
+    """A lock whose waiters sleep.
+
+    This is the three-state futex mutex from Drepper's "Futexes Are Tricky":
+    0 is unlocked, 1 is locked, and 2 is locked with (possibly) somebody
+    asleep, so an uncontended acquire and release never make a system call.
+    """
+
+    _cell = Member(ListOf(Int32), nonempty=True)
+
+    def __init__(self):
+        self._cell.resize(1)
+
+    @Entrypoint
+    def tryAcquire(self) -> bool:
+        return self._cell.pointerUnsafe(0).atomicCompareExchange(0, 1) == 0
+
+    @Entrypoint
+    def acquire(self) -> None:
+        p = self._cell.pointerUnsafe(0)
+
+        for _ in range(MUTEX_SPIN_COUNT):
+            if p.atomicCompareExchange(0, 1) == 0:
+                return
+
+        # from here on, whoever releases the lock has to wake somebody
+        while p.atomicExchange(2) != 0:
+            p.futexWait(2)
+
+    @Entrypoint
+    def release(self) -> None:
+        p = self._cell.pointerUnsafe(0)
+
+        if p.atomicFetchAdd(-1) != 1:
+            p.atomicStore(0)
+            p.futexWake(1)
+
+    @Entrypoint
+    def __enter__(self) -> None:
+        self.acquire()
+
+    @Entrypoint
+    def __exit__(self, excType, excValue, traceback) -> bool:
+        self.release()
+        return False
+
+
+class Condition(Class, Final):
+    """A condition variable. Waiters must hold 'mutex'."""
+
+    mutex = Member(Mutex)
+
+    # bumped by every notify, so a waiter can tell whether one happened
+    # between releasing the mutex and going to sleep
+    _sequence = Member(ListOf(Int32), nonempty=True)
+
+    def __init__(self):
+        self.mutex = Mutex()
+        self._sequence.resize(1)
+
+    def __init__(self, mutex: Mutex):  # noqa: F811
+        self.mutex = mutex
+        self._sequence.resize(1)
+
+    @Entrypoint
+    def wait(self, timeout: float = -1.0) -> bool:
+        """Release the mutex, wait for a notify, and reacquire the mutex.
+
+        Like any condition variable, this can return without a notify, so
+        callers should wait in a loop until what they're waiting for is true.
+
+        Args:
+            timeout - the most seconds to wait for, or negative to wait forever.
+
+        Returns:
+            False if we timed out.
+        """
+        p = self._sequence.pointerUnsafe(0)
+        sequence = p.atomicLoad()
+
+        self.mutex.release()
+        res = p.futexWait(sequence, _timeoutToNanoseconds(timeout))
+        self.mutex.acquire()
+
+        return res
+
+    @Entrypoint
+    def notify(self, count: int = 1) -> None:
+        """Wake up to 'count' waiters."""
+        p = self._sequence.pointerUnsafe(0)
+        p.atomicFetchAdd(1)
+        p.futexWake(count)
+
+    @Entrypoint
+    def notifyAll(self) -> None:
+        self.notify(1 << 30)
+
+    @Entrypoint
+    def __enter__(self) -> None:
+        self.mutex.acquire()
+
+    @Entrypoint
+    def __exit__(self, excType, excValue, traceback) -> bool:
+        self.mutex.release()
+        return False
+
+
+class Semaphore(Class, Final):
+    """A counting semaphore."""
+
+    _cell = Member(ListOf(Int32), nonempty=True)
+
+    def __init__(self, value=0):
+        assert value >= 0
+
+        self._cell.resize(1)
+        self._cell[0] = value
+
+    @Entrypoint
+    def value(self) -> int:
+        return self._cell.pointerUnsafe(0).atomicLoad()
+
+    @Entrypoint
+    def tryAcquire(self) -> bool:
+        p = self._cell.pointerUnsafe(0)
+        count = p.atomicLoad()
+
+        while count > 0:
+            seen = p.atomicCompareExchange(count, count - 1)
+
+            if seen == count:
+                return True
+
+            count = seen
+
+        return False
+
+    @Entrypoint
+    def acquire(self, timeout: float = -1.0) -> bool:
+        """Decrement the count, waiting for it to be positive.
+
+        Args:
+            timeout - the most seconds to wait for, or negative to wait forever.
+
+        Returns:
+            False if we timed out.
+        """
+        p = self._cell.pointerUnsafe(0)
+        deadline = time.time() + timeout
+
+        while not self.tryAcquire():
+            if timeout < 0:
+                p.futexWait(0)
+            else:
+                remaining = deadline - time.time()
+
+                if remaining <= 0 or not p.futexWait(0, _timeoutToNanoseconds(remaining)):
+                    return self.tryAcquire()
+
+        return True
+
+    @Entrypoint
+    def release(self, count: int = 1) -> None:
+        p = self._cell.pointerUnsafe(0)
+        p.atomicFetchAdd(count)
+        p.futexWake(count)
+
+    @Entrypoint
+    def __enter__(self) -> None:
+        self.acquire()
+
+    @Entrypoint
+    def __exit__(self, excType, excValue, traceback) -> bool:
+        self.release()
+        return False
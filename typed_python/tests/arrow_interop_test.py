@@ -0,0 +1,94 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import pytest
+
+from typed_python import (
+    ListOf, TupleOf, OneOf, NamedTuple, Dict, Int8, UInt16, Int32, Float32
+)
+
+
+Row = NamedTuple(x=int, name=str, score=OneOf(None, float))
+
+
+# our own export satisfies __arrow_c_array__, so we can round-trip without pyarrow
+@pytest.mark.parametrize('T, values', [
+    (int, [1, -2, 2 ** 62]),
+    (Int8, [1, -2, 127]),
+    (UInt16, [0, 65535]),
+    (Int32, [5, -5]),
+    (float, [1.5, -2.0, 1e300]),
+    (Float32, [1.5, -2.0]),
+    (bool, [True, False, True, True, False, False, True, False, True]),
+    (str, ["a", "hï", "", "🌍 world"]),
+    (bytes, [b"", b"a\x00b", b"xyz"]),
+    (OneOf(None, int), [None, 1, None, 3]),
+    (OneOf(None, str), ["a", None, ""]),
+    (OneOf(None, bool), [True, None, False]),
+    (Row, [Row(x=1, name="a", score=None), Row(x=2, name="", score=2.5)]),
+    (OneOf(None, Row), [None, Row(x=1, name="a", score=1.0), None]),
+])
+def test_arrow_round_trip(T, values):
+    for container in [ListOf(T), TupleOf(T)]:
+        assert container.fromArrow(container(values)) == container(values)
+        assert ListOf(T).fromArrow(container(values)) == ListOf(T)(values)
+        assert container.fromArrow(container()) == container()
+
+
+def test_arrow_import_type_mismatch():
+    with pytest.raises(Exception, match="format"):
+        ListOf(str).fromArrow(ListOf(int)([1, 2]))
+
+    with pytest.raises(Exception, match="format"):
+        ListOf(Int32).fromArrow(ListOf(int)([1, 2]))
+
+    with pytest.raises(Exception, match="no field 'y'"):
+        ListOf(NamedTuple(x=int, y=int)).fromArrow(ListOf(NamedTuple(x=int))([(1,)]))
+
+    with pytest.raises(Exception, match="OneOf"):
+        ListOf(int).fromArrow(ListOf(OneOf(None, int))([1, None]))
+
+
+def test_arrow_import_matches_fields_by_name():
+    Swapped = NamedTuple(score=OneOf(None, float), x=int)
+
+    assert ListOf(Swapped).fromArrow(ListOf(Row)([Row(x=3, name="a", score=1.0)])) == [Swapped(score=1.0, x=3)]
+
+
+def test_arrow_export_unsupported_type():
+    with pytest.raises(Exception, match="arrow"):
+        ListOf(Dict(int, int))().__arrow_c_array__()
+
+
+def test_arrow_export_with_pyarrow():
+    pyarrow = pytest.importorskip("pyarrow")
+
+    ints = ListOf(int)(range(1000))
+    arr = ints.toArrow()
+
+    assert arr.type == pyarrow.int64()
+    assert arr.to_pylist() == list(range(1000))
+
+    # ints are shared, not copied
+    ints[5] = -1
+    assert arr[5].as_py() == -1
+
+    assert ListOf(OneOf(None, str))(["a", None]).toArrow().to_pylist() == ["a", None]
+
+    rows = ListOf(Row)([Row(x=1, name="a", score=None)])
+    assert pyarrow.record_batch(rows).to_pylist() == [dict(x=1, name="a", score=None)]
+
+    assert ListOf(int).fromArrow(pyarrow.array([1, 2, 3]).slice(1)) == [2, 3]
+    assert ListOf(str).fromArrow(pyarrow.array(["a", "bb", "c"]).slice(1)) == ["bb", "c"]
+    assert ListOf(OneOf(None, int)).fromArrow(pyarrow.array([1, None, 3]).slice(1)) == [None, 3]
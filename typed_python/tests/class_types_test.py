@@ -193,6 +193,16 @@ class NativeClassTypesTests(unittest.TestCase):
         self.assertEqual(_types.bytecount(A), 8)
         self.assertTrue(A.y is int)
 
+        # held classes pack their members without padding, after one initialization
+        # bit per member
+        class B(Class, Final):
+            a = Member(bool)
+            b = Member(float)
+            c = Member(bool)
+            d = Member(int)
+
+        self.assertEqual(_types.bytecount(B.HeldClass), 1 + 18)
+
         a = A()
 
         with self.assertRaises(AttributeError):
@@ -1832,3 +1842,40 @@ class NativeClassTypesTests(unittest.TestCase):
 
         assert Entrypoint(f)() == [1]
         assert f() == Entrypoint(f)()
+
+    def test_default_construction_mixes_pod_and_refcounted_members(self):
+        class Inner(Class):
+            pass
+
+        class C(Class, Final):
+            a = Member(int, 7)
+            b = Member(ListOf(int))
+            c = Member(float)
+            d = Member(Inner)
+            e = Member(str, "hi")
+            f = Member(ListOf(int), nonempty=True)
+            g = Member(bool, True)
+
+        def check(c1, c2):
+            assert (c1.a, c1.c, c1.e, c1.g) == (7, 0.0, "hi", True)
+
+            # refcounted members get constructed for each instance, not shared
+            c1.b.append(1)
+            c1.f.append(2)
+            assert len(c2.b) == 0 and len(c2.f) == 0
+
+            # members without a default stay uninitialized
+            with self.assertRaises(AttributeError):
+                c1.d
+
+        check(C(), C())
+
+        @Entrypoint
+        def makeC() -> C:
+            return C()
+
+        check(makeC(), makeC())
+
+        c = C()
+        c.a = 10
+        assert C().a == 7
@@ -12,10 +12,10 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from typed_python import deepBytecount
+from typed_python import deepBytecount, clearDeepBytecountCache
 
 from typed_python import (
-    TupleOf, ListOf, Dict, Class, Member, NamedTuple, ConstDict
+    TupleOf, ListOf, Dict, Class, Member, NamedTuple, ConstDict, refcount
 )
 
 
@@ -75,3 +75,41 @@ def test_deep_bytecount_sees_into_ConstDict_objects():
 
 def test_deep_bytecount_of_empty_constDict():
     assert deepBytecount(ConstDict(int, int)()) == 0
+
+
+def test_deep_bytecount_cache_immutable_matches_uncached():
+    T = TupleOf(TupleOf(str))
+
+    shared = TupleOf(str)(["shared string " + str(i) for i in range(10)])
+
+    elts = ListOf(T)()
+    for i in range(100):
+        elts.append(T([shared, TupleOf(str)(["string number " + str(i) * 10])]))
+
+    x = NamedTuple(a=ListOf(T), b=ConstDict(str, T))(a=elts, b={"x": elts[0]})
+
+    clearDeepBytecountCache()
+
+    expected = deepBytecount(x)
+
+    # once to fill the cache, then again to read from it
+    assert deepBytecount(x, cacheImmutable=True) == expected
+    assert deepBytecount(x, cacheImmutable=True) == expected
+
+    elts.append(T([shared]))
+
+    assert deepBytecount(x, cacheImmutable=True) == deepBytecount(x)
+
+
+def test_deep_bytecount_cache_releases_dead_objects():
+    clearDeepBytecountCache()
+
+    t = TupleOf(TupleOf(int))([TupleOf(int)(range(100))])
+
+    deepBytecount(t, cacheImmutable=True)
+
+    assert refcount(t) == 2
+
+    assert clearDeepBytecountCache() == 1
+
+    assert refcount(t) == 1
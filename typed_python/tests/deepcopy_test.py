@@ -15,9 +15,12 @@
 from typed_python import (
     TupleOf, ListOf, Dict, Class, Member, NamedTuple, ConstDict, Tuple, Set,
     Alternative, Forward, OneOf, deepcopy, deepcopyContiguous, totalBytesAllocatedInSlabs,
-    deepBytecountAndSlabs, refcount, totalBytesAllocatedOnFreeStore
+    deepBytecountAndSlabs, refcount, totalBytesAllocatedOnFreeStore, freeze, Entrypoint
 )
 from typed_python.test_util import currentMemUsageMb
+import multiprocessing
+import typed_python._types as _types
+import threading
 import time
 import numpy
 
@@ -387,6 +390,30 @@ def test_bytes_on_free_store_basic():
     assert bytecount0 == totalBytesAllocatedOnFreeStore()
 
 
+def test_bytes_on_free_store_across_threads():
+    bytecount0 = totalBytesAllocatedOnFreeStore()
+
+    results = []
+
+    def allocate():
+        # lots of small allocations that land in the size-class caches
+        results.append(ListOf(str)([str(i) * (i % 40) for i in range(10000)]))
+
+    threads = [threading.Thread(target=allocate) for _ in range(4)]
+
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    assert totalBytesAllocatedOnFreeStore() > bytecount0
+
+    # release the allocations on a different thread than the one that made them
+    results.clear()
+
+    assert bytecount0 == totalBytesAllocatedOnFreeStore()
+
+
 def test_deepcopy_perf():
     x = ListOf(str)()
 
@@ -564,3 +591,113 @@ def test_deepcopy_class_with_custom_reduce_iterators():
 
     assert c2.items == ['1', '2']
     assert c2.kvs == {'a': 'b'}
+
+
+def test_deepcopy_contiguous_in_parallel():
+    initSlabBytes = totalBytesAllocatedInSlabs()
+
+    shared = ListOf(str)(["shared", "strings"])
+
+    lst = ListOf(Tuple(int, str, ListOf(str), Dict(int, str)))()
+
+    for i in range(10000):
+        lst.append((i, str(i) * 3, shared if i % 10 == 0 else ListOf(str)([str(i)]), {i: str(i)}))
+
+    lst2 = deepcopyContiguous(lst, threads=4)
+
+    assert lst2 == lst
+    assert len(deepBytecountAndSlabs(lst2)[1]) == 1
+
+    # substructure shared between elements is copied once, and stays shared
+    lst2[0][2].append("new")
+    assert lst2[10][2][-1] == "new"
+    assert shared[-1] == "strings"
+
+    lst2 = None
+
+    assert totalBytesAllocatedInSlabs() == initSlabBytes
+
+
+def test_deepcopy_contiguous_shared_with_forked_processes():
+    initSlabBytes = totalBytesAllocatedInSlabs()
+
+    lst = deepcopyContiguous(ListOf(ListOf(int))([list(range(1000))] * 10), shared=True)
+
+    slab = deepBytecountAndSlabs(lst)[1][0]
+    assert slab.isShared()
+
+    refcountBefore = refcount(lst[0])
+
+    ctx = multiprocessing.get_context("fork")
+    toChild, inChild = ctx.Pipe()
+
+    def worker():
+        held = lst[0]
+        inChild.send(sum(sum(x) for x in lst))
+        inChild.recv()
+        inChild.send(refcount(held) > 0)
+
+    proc = ctx.Process(target=worker)
+    proc.start()
+
+    try:
+        assert toChild.recv() == sum(range(1000)) * 10
+
+        # the child's reference to lst[0] is visible here, since the refcount lives
+        # in memory we share with it rather than in a copy-on-write page
+        assert refcount(lst[0]) == refcountBefore + 1
+
+        toChild.send(None)
+        assert toChild.recv()
+    finally:
+        proc.join()
+
+    assert refcount(lst[0]) == refcountBefore
+
+    slab = None
+    lst = None
+
+    assert totalBytesAllocatedInSlabs() == initSlabBytes
+
+
+
+def test_freeze_makes_graph_immortal():
+    _, immortalThreshold = _types.immortalRefcount()
+
+    table = deepcopyContiguous(
+        ConstDict(str, TupleOf(str))({str(i): TupleOf(str)([str(i) * 20] * 3) for i in range(100)})
+    )
+
+    # at least the ConstDict, its 100 keys, its 100 tuples, and their strings
+    assert freeze(table) >= 1 + 100 + 100 + 100
+
+    assert refcount(table) >= immortalThreshold
+    assert refcount(table["5"]) >= immortalThreshold
+
+    @Entrypoint
+    def totalLength(t: ConstDict(str, TupleOf(str))):
+        res = 0
+
+        for k in t:
+            for s in t[k]:
+                res += len(s)
+
+        return res
+
+    refcountBefore = refcount(table["5"])
+
+    assert totalLength(table) == sum(len(str(i)) * 20 * 3 for i in range(100))
+
+    # neither compiled code nor the interpreter touched the refcount
+    elt = table["5"]
+    assert refcount(table["5"]) == refcountBefore
+    elt = None  # noqa
+
+    # frozen data is never freed, so its slab stays around
+    slab = deepBytecountAndSlabs(table)[1][0]
+    slabBytes = totalBytesAllocatedInSlabs()
+    table = None
+
+    assert totalBytesAllocatedInSlabs() == slabBytes
+    assert slab.refcount() > 0
+
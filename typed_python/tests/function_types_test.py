@@ -108,3 +108,25 @@ class NativeFunctionTypesTests(unittest.TestCase):
         closure.x = 20
 
         assert fType(closure)() == 20
+
+    def test_overloads_are_built_on_first_access(self):
+        @Function
+        def f(x: int, y=2, *args, **kwargs) -> float:
+            return x
+
+        fType = type(f)
+
+        # until someone asks, the type holds a placeholder rather than the overloads
+        assert not isinstance(fType.__dict__['overloads'], tuple)
+
+        overloads = f.overloads
+
+        assert isinstance(fType.__dict__['overloads'], tuple)
+        assert fType.overloads is overloads
+
+        assert [a.name for a in overloads[0].args] == ['x', 'y', 'args', 'kwargs']
+        assert overloads[0].args[0].typeFilter is int
+        assert overloads[0].args[1].defaultValue == (2,)
+        assert overloads[0].args[2].isStarArg
+        assert overloads[0].args[3].isKwarg
+        assert overloads[0].returnType is float
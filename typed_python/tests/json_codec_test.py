@@ -0,0 +1,136 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import json
+import math
+
+import pytest
+
+from typed_python import (
+    jsonEncode, jsonDecode, ListOf, TupleOf, Tuple, NamedTuple, Dict, Set, OneOf,
+    Int8, UInt8, UInt64, Float32, Class, Member
+)
+
+
+Point = NamedTuple(x=float, y=float)
+Shape = NamedTuple(name=str, points=ListOf(Point), tags=Dict(str, int), parent=OneOf(None, str))
+
+
+@pytest.mark.parametrize('T, value', [
+    (None, None),
+    (bool, True),
+    (int, -(2 ** 63)),
+    (UInt64, 2 ** 64 - 1),
+    (Int8, -128),
+    (float, 0.1),
+    (float, -1e300),
+    (Float32, 1.5),
+    (str, ""),
+    (str, 'quote " backslash \\ newline \n tab \t bell \x07 é 中 🌍'),
+    (ListOf(int), [1, 2, 3]),
+    (TupleOf(str), ("a", "b")),
+    (Tuple(int, str, bool), (1, "x", False)),
+    (Set(int), {1, 5, 9}),
+    (Dict(str, ListOf(int)), {"a": [1], "b": []}),
+    (Dict(int, str), {1: "one", -2: "minus two"}),
+    (OneOf(None, int, str), "hi"),
+    (OneOf(None, int, str), None),
+    (OneOf(int, float), 1.5),
+    (Shape, Shape(name="tri", points=[Point(x=0, y=0), Point(x=1, y=2)], tags={"a": 1}, parent=None)),
+])
+def test_json_round_trip(T, value):
+    encoded = jsonEncode(T, value)
+
+    assert isinstance(encoded, bytes)
+    assert jsonDecode(T, encoded) == value
+    assert jsonDecode(T, encoded.decode("utf8")) == value
+
+
+def test_json_matches_stdlib():
+    shape = Shape(name="tri é", points=[Point(x=0, y=0.5)], tags={"a": 1, "b": 2}, parent="root")
+
+    assert json.loads(jsonEncode(Shape, shape)) == json.loads(json.dumps(
+        dict(name="tri é", points=[dict(x=0.0, y=0.5)], tags={"a": 1, "b": 2}, parent="root")
+    ))
+
+    doc = json.dumps(dict(name="x", points=[dict(y=1, x=2.5)], tags={}, parent=None, extra=[1, {"a": None}]))
+
+    assert jsonDecode(Shape, doc) == Shape(name="x", points=[Point(x=2.5, y=1)], parent=None)
+
+
+def test_json_decode_escapes():
+    assert jsonDecode(str, r'"é🌍\n\/\""') == 'é🌍\n/"'
+
+    # lone surrogates survive, as with python's json
+    assert jsonDecode(str, r'"\ud800"') == json.loads(r'"\ud800"')
+    assert json.loads(jsonEncode(str, "\ud800")) == "\ud800"
+
+
+def test_json_floats():
+    assert jsonEncode(float, 1.0) == b"1.0"
+    assert jsonEncode(ListOf(float), [math.inf, -math.inf]) == b"[Infinity,-Infinity]"
+    assert math.isnan(jsonDecode(float, "NaN"))
+    assert jsonDecode(float, "1e-5") == 1e-5
+    assert jsonDecode(float, "3") == 3.0
+    assert jsonDecode(float, str(2 ** 70)) == float(2 ** 70)
+
+
+def test_json_oneof_prefers_ints_for_integral_numbers():
+    T = OneOf(float, int)
+
+    assert type(jsonDecode(T, "3")) is int
+    assert type(jsonDecode(T, "3.0")) is float
+    assert type(jsonDecode(T, str(2 ** 70))) is float
+
+    assert jsonDecode(OneOf(ListOf(int), ListOf(str)), '["a"]') == ["a"]
+
+
+def test_json_decode_errors():
+    for T, doc in [
+        (int, "1.5"),
+        (UInt8, "256"),
+        (UInt8, "-1"),
+        (int, str(2 ** 63)),
+        (str, '"unterminated'),
+        (str, '"control \x01"'),
+        (ListOf(int), "[1, 2,]"),
+        (ListOf(int), "[1 2]"),
+        (Tuple(int, int), "[1]"),
+        (Tuple(int, int), "[1, 2, 3]"),
+        (int, "1 2"),
+        (int, "01"),
+        (bool, "True"),
+        (OneOf(None, int), '"x"'),
+        (NamedTuple(x=ListOf(int)), '{"x": [1, "a"]}'),
+    ]:
+        with pytest.raises(ValueError):
+            jsonDecode(T, doc)
+
+
+def test_json_unsupported_types():
+    class C(Class):
+        x = Member(int)
+
+    with pytest.raises(TypeError):
+        jsonEncode(C, C())
+
+    with pytest.raises(ValueError):
+        jsonDecode(C, "{}")
+
+
+def test_json_decode_large_list():
+    values = list(range(-50000, 50000))
+
+    assert jsonDecode(ListOf(int), json.dumps(values)) == values
+    assert jsonDecode(ListOf(str), json.dumps([str(v) for v in values])) == [str(v) for v in values]
@@ -0,0 +1,156 @@
+#   Copyright 2017-2020 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import threading
+import unittest
+
+from typed_python.lock_free_queue import LockFreeQueue
+from typed_python import ListOf, Entrypoint, PointerTo
+from typed_python._types import refcount
+
+
+class LockFreeQueueTests(unittest.TestCase):
+    def test_pointer_atomics(self):
+        @Entrypoint
+        def compareExchange(p: PointerTo(int), expected: int, val: int):
+            return p.atomicCompareExchange(expected, val)
+
+        @Entrypoint
+        def load(p: PointerTo(int)):
+            return p.atomicLoad()
+
+        @Entrypoint
+        def store(p: PointerTo(int), val: int):
+            p.atomicStore(val)
+
+        aList = ListOf(int)([10])
+        p = aList.pointerUnsafe(0)
+
+        self.assertEqual(compareExchange(p, 3, 4), 10)
+        self.assertEqual(aList[0], 10)
+        self.assertEqual(compareExchange(p, 10, 4), 10)
+        self.assertEqual(aList[0], 4)
+
+        store(p, 7)
+        self.assertEqual(load(p), 7)
+
+    def test_basic(self):
+        queue = LockFreeQueue(float)(4)
+
+        self.assertEqual(queue.capacity, 4)
+        self.assertEqual(queue.tryGet(), None)
+
+        for i in range(4):
+            self.assertTrue(queue.tryPut(i))
+
+        self.assertFalse(queue.tryPut(4.0))
+        self.assertEqual(len(queue), 4)
+
+        self.assertEqual(queue.get(), 0.0)
+        queue.put(4.0)
+
+        self.assertEqual(queue.getMany(0, 10), [1.0, 2.0, 3.0, 4.0])
+        self.assertEqual(queue.getMany(0, 10), [])
+        self.assertEqual(len(queue), 0)
+
+    def test_capacity_rounds_up(self):
+        self.assertEqual(LockFreeQueue(int)(5).capacity, 8)
+        self.assertEqual(LockFreeQueue(int)(1).capacity, 1)
+
+    def test_wraps_around_many_times(self):
+        queue = LockFreeQueue(int)(8)
+
+        for i in range(1000):
+            queue.putMany(ListOf(int)([i, i + 1, i + 2]))
+            self.assertEqual(queue.getMany(3, 3), [i, i + 1, i + 2])
+
+    def test_refcounts(self):
+        queue = LockFreeQueue(ListOf(int))(4)
+        aList = ListOf(int)()
+
+        queue.put(aList)
+        queue.put(aList)
+        self.assertEqual(refcount(aList), 3)
+
+        queue.get()
+        self.assertEqual(refcount(aList), 2)
+
+        queue = None
+        self.assertEqual(refcount(aList), 1)
+
+    def test_blocking_producers_and_consumers(self):
+        for spinCount in [-1, 0, 100]:
+            queue = LockFreeQueue(int)(16, spinCount)
+            producers = 4
+            perProducer = 20000
+            results = []
+
+            @Entrypoint
+            def produce(q: LockFreeQueue(int), base: int, count: int):
+                i = 0
+                while i < count:
+                    if (i // 3) % 2 == 0 and i + 3 <= count:
+                        q.putMany(ListOf(int)([base + i, base + i + 1, base + i + 2]))
+                        i += 3
+                    else:
+                        q.put(base + i)
+                        i += 1
+
+            @Entrypoint
+            def consume(q: LockFreeQueue(int), count: int) -> int:
+                total = 0
+                got = 0
+                while got < count:
+                    for x in q.getMany(1, min(7, count - got)):
+                        total += x
+                        got += 1
+                return total
+
+            perConsumer = perProducer * producers // 2
+
+            def runConsumer():
+                results.append(consume(queue, perConsumer))
+
+            threads = [
+                threading.Thread(target=produce, args=(queue, p * perProducer * 2, perProducer)) for p in range(producers)
+            ] + [threading.Thread(target=runConsumer) for _ in range(2)]
+
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+
+            expected = sum(p * perProducer * 2 + i for p in range(producers) for i in range(perProducer))
+
+            self.assertEqual(sum(results), expected, spinCount)
+            self.assertEqual(len(queue), 0)
+
+    def test_order_is_preserved_per_producer(self):
+        queue = LockFreeQueue(int)(4, 0)
+        received = ListOf(int)()
+
+        @Entrypoint
+        def consume(q: LockFreeQueue(int), count: int, out: ListOf(int)):
+            for _ in range(count):
+                out.append(q.get())
+
+        t = threading.Thread(target=consume, args=(queue, 10000, received))
+        t.start()
+
+        for i in range(100):
+            queue.putMany(ListOf(int)(range(i * 100, (i + 1) * 100)))
+
+        t.join()
+
+        self.assertEqual(received, list(range(10000)))
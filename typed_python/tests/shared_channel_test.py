@@ -0,0 +1,157 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import multiprocessing
+import os
+import tempfile
+
+import pytest
+
+from typed_python.shared_channel import SharedChannel
+from typed_python import ListOf, NamedTuple, Dict, Entrypoint
+
+
+Trade = NamedTuple(price=float, size=int)
+
+
+def test_put_and_get_in_one_process():
+    channel = SharedChannel(float)(4)
+
+    assert channel.capacity == 4
+    assert channel.tryGet() is None
+
+    for i in range(4):
+        assert channel.tryPut(i)
+
+    assert not channel.tryPut(4.0)
+    assert len(channel) == 4
+
+    assert channel.get() == 0.0
+    channel.put(4.0)
+
+    assert channel.getMany(0, 10) == [1.0, 2.0, 3.0, 4.0]
+    assert channel.getMany(0, 10) == []
+    assert len(channel) == 0
+
+
+def test_named_tuples_are_written_in_place():
+    channel = SharedChannel(Trade)(8)
+
+    assert channel.slotBytes == 16
+
+    channel.putMany(ListOf(Trade)([Trade(price=1.5, size=2), Trade(price=2.5, size=3)]))
+
+    assert channel.getMany(2, 2) == [Trade(price=1.5, size=2), Trade(price=2.5, size=3)]
+
+
+def test_non_pod_values_are_serialized():
+    channel = SharedChannel(Dict(str, int))(4, slotBytes=64)
+
+    channel.put({"a": 1, "b": 2})
+    assert channel.get() == {"a": 1, "b": 2}
+
+    with pytest.raises(ValueError):
+        channel.put({str(i): i for i in range(100)})
+
+    # a failed put doesn't use up a slot
+    assert len(channel) == 0
+    assert channel.tryGet() is None
+
+
+def test_wraps_around_many_times():
+    channel = SharedChannel(int)(8)
+
+    for i in range(1000):
+        channel.putMany(ListOf(int)([i, i + 1, i + 2]))
+        assert channel.getMany(3, 3) == [i, i + 1, i + 2]
+
+
+@Entrypoint
+def produce(channel: SharedChannel(int), base: int, count: int):
+    i = 0
+    while i < count:
+        if (i // 3) % 2 == 0 and i + 3 <= count:
+            channel.putMany(ListOf(int)([base + i, base + i + 1, base + i + 2]))
+            i += 3
+        else:
+            channel.put(base + i)
+            i += 1
+
+
+@Entrypoint
+def consume(channel: SharedChannel(int), count: int) -> int:
+    total = 0
+    got = 0
+    while got < count:
+        for x in channel.getMany(1, min(7, count - got)):
+            total += x
+            got += 1
+    return total
+
+
+def test_forked_producers_and_consumers():
+    ctx = multiprocessing.get_context("fork")
+
+    for spinCount in [-1, 0, 100]:
+        channel = SharedChannel(int)(16, spinCount=spinCount)
+        results = SharedChannel(int)(4)
+
+        producers = 3
+        perProducer = 20000
+        perConsumer = producers * perProducer // 2
+
+        def runConsumer():
+            results.put(consume(channel, perConsumer))
+
+        processes = [
+            ctx.Process(target=produce, args=(channel, p * perProducer, perProducer)) for p in range(producers)
+        ] + [ctx.Process(target=runConsumer) for _ in range(2)]
+
+        for p in processes:
+            p.start()
+        for p in processes:
+            p.join()
+            assert p.exitcode == 0
+
+        assert sum(results.getMany(2, 2)) == sum(range(producers * perProducer))
+        assert len(channel) == 0
+
+
+def putMessages(path, count):
+    channel = SharedChannel(str).attach(path)
+
+    for i in range(count):
+        channel.put(f"message {i}")
+
+
+def test_attach_by_path():
+    ctx = multiprocessing.get_context("spawn")
+
+    with tempfile.TemporaryDirectory() as tempDir:
+        path = os.path.join(tempDir, "channel")
+        channel = SharedChannel(str)(8, path=path)
+
+        proc = ctx.Process(target=putMessages, args=(path, 100))
+        proc.start()
+
+        assert [channel.get() for _ in range(100)] == [f"message {i}" for i in range(100)]
+
+        proc.join()
+        assert proc.exitcode == 0
+
+        with pytest.raises(TypeError):
+            SharedChannel(int).attach(path)
+
+        with pytest.raises(ValueError):
+            SharedChannel(str).attach(os.devnull)
@@ -0,0 +1,212 @@
+#   Copyright 2017-2023 typed_python Authors
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import threading
+import time
+import unittest
+
+from typed_python.sync import AtomicInt, AtomicFloat, SpinLock, Mutex, Condition, Semaphore
+from typed_python import Class, Final, Member, ListOf, Entrypoint, PointerTo
+
+
+def runThreads(count, f):
+    threads = [threading.Thread(target=f, args=(i,)) for i in range(count)]
+
+    for t in threads:
+        t.start()
+
+    for t in threads:
+        t.join()
+
+
+class Counter(Class, Final):
+    lock = Member(Mutex)
+    spinLock = Member(SpinLock)
+    count = Member(int)
+
+    def __init__(self):
+        self.lock = Mutex()
+        self.spinLock = SpinLock()
+
+    @Entrypoint
+    def addWithMutex(self, n: int) -> None:
+        for _ in range(n):
+            with self.lock:
+                self.count += 1
+
+    @Entrypoint
+    def addWithSpinLock(self, n: int) -> None:
+        for _ in range(n):
+            self.spinLock.acquire()
+            self.count += 1
+            self.spinLock.release()
+
+
+class SyncTests(unittest.TestCase):
+    def test_pointer_fetch_add_and_exchange(self):
+        @Entrypoint
+        def fetchAdd(p: PointerTo(float), x: float):
+            return p.atomicFetchAdd(x)
+
+        @Entrypoint
+        def exchange(p: PointerTo(float), x: float):
+            return p.atomicExchange(x)
+
+        @Entrypoint
+        def compareExchange(p: PointerTo(float), expected: float, x: float):
+            return p.atomicCompareExchange(expected, x)
+
+        aList = ListOf(float)([1.5])
+        p = aList.pointerUnsafe(0)
+
+        self.assertEqual(fetchAdd(p, 2.0), 1.5)
+        self.assertEqual(exchange(p, 7.0), 3.5)
+        self.assertEqual(compareExchange(p, 1.0, 2.0), 7.0)
+        self.assertEqual(compareExchange(p, 7.0, 2.0), 7.0)
+        self.assertEqual(aList[0], 2.0)
+
+    def test_atomic_int_and_float(self):
+        i = AtomicInt(5)
+
+        self.assertEqual(i.fetchAdd(3), 5)
+        self.assertEqual(i.exchange(1), 8)
+        self.assertFalse(i.compareExchange(0, 2))
+        self.assertTrue(i.compareExchange(1, 2))
+        self.assertEqual(i.load(), 2)
+
+        f = AtomicFloat(0.5)
+
+        self.assertEqual(f.fetchAdd(1.0), 0.5)
+        self.assertTrue(f.compareExchange(1.5, 3.0))
+        self.assertEqual(f.load(), 3.0)
+
+    def test_atomics_across_threads(self):
+        i = AtomicInt()
+        f = AtomicFloat()
+
+        @Entrypoint
+        def bump(i: AtomicInt, f: AtomicFloat, n: int) -> None:
+            for _ in range(n):
+                i.fetchAdd(1)
+                f.fetchAdd(0.5)
+
+        runThreads(4, lambda _: bump(i, f, 100000))
+
+        self.assertEqual(i.load(), 400000)
+        self.assertEqual(f.load(), 200000.0)
+
+    def test_locks_protect_counters(self):
+        c = Counter()
+
+        runThreads(4, lambda _: c.addWithMutex(100000))
+        self.assertEqual(c.count, 400000)
+
+        runThreads(4, lambda _: c.addWithSpinLock(100000))
+        self.assertEqual(c.count, 800000)
+
+    def test_mutex_try_acquire(self):
+        m = Mutex()
+
+        self.assertTrue(m.tryAcquire())
+        self.assertFalse(m.tryAcquire())
+        m.release()
+        self.assertTrue(m.tryAcquire())
+        m.release()
+
+    def test_blocked_mutex_releases_the_gil(self):
+        m = Mutex()
+        m.acquire()
+
+        acquired = []
+
+        def waiter(_):
+            m.acquire()
+            acquired.append(True)
+            m.release()
+
+        t = threading.Thread(target=waiter, args=(0,))
+        t.start()
+
+        # the interpreter keeps running while the other thread is blocked
+        time.sleep(0.1)
+        self.assertEqual(acquired, [])
+
+        m.release()
+        t.join()
+
+        self.assertEqual(acquired, [True])
+
+    def test_semaphore(self):
+        s = Semaphore(2)
+
+        self.assertTrue(s.acquire())
+        self.assertTrue(s.tryAcquire())
+        self.assertFalse(s.tryAcquire())
+
+        t0 = time.time()
+        self.assertFalse(s.acquire(0.05))
+        self.assertGreater(time.time() - t0, 0.04)
+
+        def releaser(_):
+            time.sleep(0.05)
+            s.release()
+
+        t = threading.Thread(target=releaser, args=(0,))
+        t.start()
+
+        self.assertTrue(s.acquire(5.0))
+        t.join()
+
+        self.assertEqual(s.value(), 0)
+
+    def test_condition_producer_consumer(self):
+        cond = Condition()
+        items = ListOf(int)()
+
+        @Entrypoint
+        def produce(cond: Condition, items: ListOf(int), n: int) -> None:
+            for i in range(n):
+                with cond:
+                    items.append(i)
+                    cond.notify()
+
+        @Entrypoint
+        def consume(cond: Condition, items: ListOf(int), n: int) -> int:
+            total = 0
+            seen = 0
+
+            with cond:
+                while seen < n:
+                    while not len(items):
+                        cond.wait()
+
+                    total += items.pop()
+                    seen += 1
+
+            return total
+
+        result = []
+
+        t = threading.Thread(target=lambda: result.append(consume(cond, items, 10000)))
+        t.start()
+
+        produce(cond, items, 10000)
+        t.join()
+
+        self.assertEqual(result, [sum(range(10000))])
+
+        with cond:
+            t0 = time.time()
+            cond.wait(0.05)
+            self.assertGreater(time.time() - t0, 0.04)
@@ -33,6 +33,7 @@ from typed_python._types import (
     typesAndObjectsVisibleToCompilerFrom,
     checkForHashInstability,
     resetCompilerVisibleObjectHashCache,
+    sha1Implementation,
     typeWalkRecord
 )
 
@@ -520,6 +521,18 @@ def test_hash_of_builtins():
     assert not Hash(identityHash(isinstance)).isPoison()
 
 
+def test_hardware_sha1_matches_portable_sha1(monkeypatch):
+    assert sha1Implementation() in ('x86-sha-ni', 'armv8-crypto', 'scalar')
+
+    # long enough to cover several 64-byte blocks and the padding block
+    expr = "identityHash('typed_python' * 37)"
+
+    monkeypatch.setenv("TP_SHA1_NO_HW", "1")
+
+    assert evaluateExprInFreshProcess({}, "typed_python._types.sha1Implementation()") == 'scalar'
+    assert evaluateExprInFreshProcess({}, expr) == identityHash('typed_python' * 37)
+
+
 def test_hash_of_classObj():
     class C(Class, Final):
         x = Member(int)
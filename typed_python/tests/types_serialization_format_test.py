@@ -18,7 +18,7 @@ import numpy
 from typed_python import (
     TupleOf, ListOf, OneOf, Dict,
     ConstDict, Alternative, Forward,
-    serialize, deserialize, validateSerializedObject, decodeSerializedObject
+    serialize, deserialize, deserializeUntrusted, validateSerializedObject, decodeSerializedObject
 )
 
 
@@ -456,3 +456,71 @@ class TypesSerializationWireFormatTest(unittest.TestCase):
             VARINT(0) + signedVarint(44) +
             END_COMPOUND()
         )
+
+    def test_deserialize_untrusted(self):
+        T = Dict(int, TupleOf(ListOf(int)))
+        value = T({1: [[1, 2], []], 2: []})
+
+        self.assertEqual(deserializeUntrusted(T, serialize(T, value)), value)
+
+        # more data than the one object
+        with self.assertRaisesRegex(TypeError, "past the end"):
+            deserializeUntrusted(T, serialize(T, value) + EMPTY(0))
+
+        # the Dict, the TupleOf and the ListOf nest three deep
+        with self.assertRaisesRegex(TypeError, "nest more than"):
+            deserializeUntrusted(T, serialize(T, value), maxDepth=2)
+
+        self.assertEqual(deserializeUntrusted(T, serialize(T, value), maxDepth=10), value)
+
+        # a tiny message claiming a huge list
+        hugeList = (
+            BEGIN_COMPOUND(0) +
+            VARINT(0) + unsignedVarint(0) +  # the ID
+            VARINT(0) + unsignedVarint(10 ** 12) +  # the size
+            END_COMPOUND()
+        )
+
+        with self.assertRaisesRegex(TypeError, "allocate more than"):
+            deserializeUntrusted(ListOf(int), hugeList)
+
+        with self.assertRaisesRegex(TypeError, "allocate more than"):
+            deserializeUntrusted(ListOf(int), serialize(ListOf(int), ListOf(int)(range(1000))), maxBytes=100)
+
+    def test_deserialize_untrusted_rejects_extra_entries(self):
+        T = Dict(int, int)
+
+        with self.assertRaisesRegex(TypeError, "more entries than its count"):
+            deserializeUntrusted(
+                T,
+                BEGIN_COMPOUND(0) +
+                VARINT(0) + unsignedVarint(0) +  # the ID
+                VARINT(0) + unsignedVarint(1) +  # the size
+                VARINT(0) + signedVarint(1) +
+                VARINT(0) + signedVarint(2) +
+                VARINT(0) + signedVarint(3) +
+                VARINT(0) + signedVarint(4) +
+                END_COMPOUND()
+            )
+
+    def test_deserialize_corrupt_recursive_list_frees_it_once(self):
+        L = Forward("L")
+        L = L.define(ListOf(OneOf(int, L)))
+
+        # the list refers to itself, and then runs out of data
+        data = BEGIN_COMPOUND(0) + (
+            VARINT(0) + unsignedVarint(0) +  # the ID
+            VARINT(0) + unsignedVarint(3) +  # the size
+            SINGLE(0) + VARINT(0) + signedVarint(10) +
+            SINGLE(0) + SINGLE(1) + (
+                VARINT(0) + unsignedVarint(0)
+            ) +
+            SINGLE(0) + VARINT(0)
+        )
+
+        for _ in range(100):
+            with self.assertRaises(TypeError):
+                deserializeUntrusted(L, data)
+
+            with self.assertRaises(TypeError):
+                deserialize(L, data)
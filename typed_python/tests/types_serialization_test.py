@@ -41,17 +41,19 @@ from typed_python.SerializationContext import createFunctionWithLocalsAndGlobals
 
 from typed_python import (
     TupleOf, ListOf, OneOf, Tuple, NamedTuple, Class,
-    Member, ConstDict, Alternative, serialize, deserialize,
+    Member, ConstDict, Alternative, serialize, serializeInto, deserialize,
     Dict, Set, SerializationContext, EmbeddedMessage,
-    serializeStream, deserializeStream, decodeSerializedObject,
+    serializeStream, deserializeStream, decodeSerializedObject, StreamingDeserializer, TypeSchemaCache,
     Forward, Final, Function, Entrypoint, TypeFunction, PointerTo,
-    SubclassOf, NotCompiled
+    SubclassOf, NotCompiled, totalBytesAllocatedInSlabs, totalBytesAllocatedOnFreeStore,
+    Int8, Int16, Int32, UInt8, UInt16, UInt32, UInt64, Float32
 )
 
 from typed_python._types import (
     refcount, isRecursive, identityHash, buildPyFunctionObject,
     setFunctionClosure, typesAreEquivalent, recursiveTypeGroupDeepRepr,
-    recursiveTypeGroupRepr
+    recursiveTypeGroupRepr, stringInternTableSize, clearStringInternTable,
+    serializeDelta, deserializeDelta, deserializeInto
 )
 
 module_level_testfun = dummy_test_module.testfunction
@@ -404,6 +406,77 @@ class TypesSerializationTest(unittest.TestCase):
         print("nocompress is ", nocompressTime, int(size3 / 1024 / 1024))
         print("speedup is ", normalTime / threadTime)
 
+    def test_deserialize_many_blocks_with_read_ahead(self):
+        # enough data for many compressed blocks, so the read-ahead pipeline
+        # fills up and drains
+        someStrings = ListOf(str)([str(i) * (i % 50) for i in range(200000)])
+
+        s1 = SerializationContext()
+        s2 = SerializationContext().withoutCompressUsingThreads()
+
+        for writer in [s1, s2]:
+            data = writer.serialize(someStrings)
+
+            for reader in [s1, s2]:
+                assert reader.deserialize(data) == someStrings
+
+        # a corrupt block deep in the stream surfaces on the reading thread
+        serDat = bytearray(s1.serialize(someStrings))
+        serDat[len(serDat) // 2] += 1
+
+        for reader in [s1, s2]:
+            with self.assertRaisesRegex(Exception, "LZ4|Corrupt"):
+                reader.deserialize(bytes(serDat))
+
+        # abandoning a stream part way leaves no work behind on the pool
+        with self.assertRaises(Exception):
+            s1.deserialize(s1.serialize(someStrings, ListOf(str)), ListOf(int))
+
+    def test_deserialize_pod_lists_into_slab(self):
+        someFloats = ListOf(float)(range(1000000))
+
+        s = SerializationContext().withSerializePodListsInline().withoutCompression()
+        data = s.serialize(someFloats)
+
+        slabBytes0 = totalBytesAllocatedInSlabs()
+        freeStoreBytes0 = totalBytesAllocatedOnFreeStore()
+
+        loaded = s.withDeserializeIntoSlab().deserialize(data)
+
+        assert loaded == someFloats
+        assert totalBytesAllocatedInSlabs() > slabBytes0
+        assert totalBytesAllocatedOnFreeStore() - freeStoreBytes0 < 1024 * 1024
+
+        # the list is still mutable: growing it moves its data out of the slab
+        loaded.append(-1.0)
+        assert loaded[-1] == -1.0 and loaded[999999] == 999999.0
+
+        loaded = None
+        assert totalBytesAllocatedInSlabs() == slabBytes0
+
+        # compressed data and any other kind of object work the same way
+        sc = SerializationContext().withDeserializeIntoSlab()
+        obj = Dict(str, ListOf(int))({str(i): ListOf(int)(range(i)) for i in range(100)})
+        assert sc.deserialize(sc.serialize(obj)) == obj
+        assert totalBytesAllocatedInSlabs() == slabBytes0
+
+    def test_varint_boundaries(self):
+        values = [0, 1, 63, 64, 127, 128, 2**14 - 1, 2**14, -1, -64, -65, 2**63 - 1, -2**63]
+        values += [sign * 2**k + d for k in range(7, 63, 7) for d in (-1, 0, 1) for sign in (1, -1)]
+
+        for v in values:
+            assert deserialize(int, serialize(int, v)) == v
+
+        # lists long enough that most varints are read with plenty of data
+        # behind them, and a few right at the end of the buffer
+        ints = ListOf(int)(values * 10)
+        assert deserialize(ListOf(int), serialize(ListOf(int), ints)) == ints
+
+        # a varint that never terminates is corrupt, not a very large number
+        header = serialize(int, 1)[:1]
+        with self.assertRaises(Exception):
+            deserialize(int, header + b"\xff" * 11 + b"\x01")
+
     def test_can_deserialize_pod_lists_with_any_context(self):
         someFloats = ListOf(float)(range(1000))
         someInts = ListOf(int)(range(1000))
@@ -414,6 +487,36 @@ class TypesSerializationTest(unittest.TestCase):
         assert s2.deserialize(s1.serialize(someFloats)) == someFloats
         assert s2.deserialize(s1.serialize(someInts)) == someInts
 
+    def test_deserialize_with_string_interning(self):
+        clearStringInternTable()
+
+        tags = ListOf(str)(["tag_%s" % (i % 10) for i in range(1000)])
+        keyed = Dict(str, int)({"key_%s" % i: i for i in range(100)})
+
+        context = SerializationContext().withStringInterning()
+
+        assert context.withStringInterning() is context
+        assert not SerializationContext().internStrings
+
+        tags2 = context.deserialize(context.serialize(tags), ListOf(str))
+        keyed2 = context.deserialize(context.serialize(keyed), Dict(str, int))
+
+        assert tags2 == tags
+        assert keyed2 == keyed
+        assert stringInternTableSize() == 110
+
+        # a second pass finds the same strings rather than adding new ones
+        assert context.deserialize(context.serialize(tags), ListOf(str)) == tags
+        assert stringInternTableSize() == 110
+
+        # without the flag we don't touch the table
+        assert SerializationContext().deserialize(SerializationContext().serialize(tags), ListOf(str)) == tags
+        assert stringInternTableSize() == 110
+
+        clearStringInternTable()
+        assert stringInternTableSize() == 0
+        assert tags2 == tags
+
     def test_serialize_core_python_objects(self):
         self.check_idempotence(0)
         self.check_idempotence(10)
@@ -520,6 +623,250 @@ class TypesSerializationTest(unittest.TestCase):
                 TupleOf(T)([T(x) for x in items])
             )
 
+    def test_serialize_into(self):
+        T = NamedTuple(x=int, s=str, l=ListOf(float))
+        value = T(x=10, s="hi", l=[1.0, 2.0])
+        expected = serialize(T, value)
+
+        # a bytearray grows to fit, and is reused as-is once it's big enough
+        buf = bytearray()
+        assert serializeInto(buf, T, value) == len(expected)
+        assert bytes(buf) == expected
+
+        buf = bytearray(b"x" * 1000)
+        assert serializeInto(buf, T, value) == len(expected)
+        assert bytes(buf[:len(expected)]) == expected
+        assert buf[len(expected):] == b"x" * (1000 - len(expected))
+
+        # any other writable buffer has to be large enough already
+        backing = bytearray(len(expected) + 10)
+        assert serializeInto(memoryview(backing)[5:], T, value) == len(expected)
+        assert bytes(backing[5:5 + len(expected)]) == expected
+
+        with self.assertRaisesRegex(ValueError, "needs"):
+            serializeInto(memoryview(bytearray(2)), T, value)
+
+        with self.assertRaises(BufferError):
+            serializeInto(b"read-only", T, value)
+
+        # it takes a context, and values that have to be converted to T
+        context = SerializationContext().withoutCompression()
+        buf = bytearray()
+        count = serializeInto(buf, ListOf(int), [1, 2, 3], context)
+        assert context.deserialize(bytes(buf[:count]), ListOf(int)) == [1, 2, 3]
+
+        for i in range(1000):
+            count = serializeInto(buf, int, i)
+            assert deserialize(int, bytes(buf[:count])) == i
+
+    def test_type_schema_cache(self):
+        NT = NamedTuple(x=int, y=str)
+
+        sender = SerializationContext().withoutCompression().withTypeSchemaCache(TypeSchemaCache())
+        receiver = SerializationContext().withoutCompression().withTypeSchemaCache(TypeSchemaCache())
+
+        assert receiver.acceptTypes(sender.announceTypes([NT, ListOf(NT), NT])) == [NT, ListOf(NT)]
+        assert len(sender.typeSchemaCache) == len(receiver.typeSchemaCache) == 2
+        assert receiver.typeSchemaCache.typeFor(1) is ListOf(NT)
+
+        value = ListOf(NT)([NT(x=1, y="hi")])
+
+        withIds = sender.serialize(value)
+        withoutIds = SerializationContext().withoutCompression().serialize(value)
+
+        assert len(withIds) < len(withoutIds)
+
+        assert type(receiver.deserialize(withIds)) is ListOf(NT)
+        assert receiver.deserialize(withIds) == value
+
+        # announcing known types again sends nothing new
+        receiver.acceptTypes(sender.announceTypes([NT]))
+        assert len(receiver.typeSchemaCache) == 2
+
+        # a handshake can't be applied twice, or out of order
+        handshake = sender.announceTypes([TupleOf(NT)])
+
+        receiver.acceptTypes(handshake)
+
+        with self.assertRaises(ValueError):
+            receiver.acceptTypes(handshake)
+
+        # and contexts without the cache can't read the ids
+        with self.assertRaisesRegex(Exception, "TypeSchemaCache"):
+            SerializationContext().deserialize(withIds)
+
+    def test_streaming_deserializer(self):
+        T = OneOf(None, float, str, int, ListOf(int))
+
+        shared = ListOf(int)(range(100))
+        items = [T(x) for x in ["hi", None, 10, shared, 1.5, shared, "x" * 10000]] * 20
+
+        for context in [None, SerializationContext().withoutCompression(), SerializationContext()]:
+            data = serializeStream(T, items, context)
+
+            for chunkSize in [1, 7, 1000, len(data)]:
+                stream = StreamingDeserializer(T, context)
+                result = []
+
+                for i in range(0, len(data), chunkSize):
+                    result.extend(stream.feed(data[i:i + chunkSize]))
+
+                assert result == items
+                assert stream.bytesBuffered() == 0
+
+        # a partial message stays buffered until the rest of it arrives
+        stream = StreamingDeserializer(str)
+        data = serialize(str, "hello") + serialize(str, "world")
+
+        assert stream.feed(data[:-2]) == ["hello"]
+        assert stream.bytesBuffered() > 0
+        assert stream.feed(memoryview(data)[-2:]) == ["world"]
+        assert stream.feed(b"") == []
+
+        # once a message is corrupt we can't find the next one
+        stream = StreamingDeserializer(TupleOf(int))
+        with self.assertRaises(Exception):
+            stream.feed(serialize(str, "not a tuple"))
+
+        with self.assertRaisesRegex(RuntimeError, "corrupt"):
+            stream.feed(serialize(TupleOf(int), (1, 2)))
+
+    def test_serialize_delta(self):
+        Position = NamedTuple(symbol=str, qty=int, price=float)
+        State = NamedTuple(
+            positions=ConstDict(str, Position),
+            history=TupleOf(float),
+            orders=ListOf(OneOf(None, int, str)),
+            note=str,
+        )
+
+        def position(i):
+            return Position(symbol="s" + str(i), qty=i, price=i * 0.5)
+
+        previous = State(
+            positions={"s" + str(i): position(i) for i in range(10000)},
+            history=TupleOf(float)(range(100000)),
+            orders=list(range(1000)),
+            note="start",
+        )
+
+        # change one position, add one and remove one, append to the orders, and
+        # keep the same history
+        positions = dict(previous.positions)
+        positions["s5"] = Position(symbol="s5", qty=6, price=1.0)
+        positions["new"] = position(-1)
+        del positions["s7"]
+
+        orders = ListOf(OneOf(None, int, str))(previous.orders)
+        orders[10] = "ten"
+        orders.append(None)
+
+        current = previous.replacing(positions=positions, orders=orders)
+
+        for context in [SerializationContext().withoutCompression(), SerializationContext()]:
+            delta = context.serializeDelta(previous, current, State)
+
+            assert len(delta) < len(context.serialize(current, State)) / 100
+
+            result = context.deserializeDelta(previous, delta, State)
+
+            assert result == current
+            assert type(result) is State
+
+            # unchanged immutable containers are shared with 'previous', not copied
+            assert refcount(result.history) > 1
+
+            assert context.deserializeDelta(current, context.serializeDelta(current, current, State), State) == current
+
+        # nothing changed at all
+        assert serializeDelta(State, current, current) == b"\x00"
+
+        # values that need converting, and types we write in full
+        T = Dict(str, ListOf(int))
+        delta = serializeDelta(T, {"a": [1]}, {"a": [1, 2], "b": []})
+        assert deserializeDelta(T, {"a": [1]}, delta) == T({"a": [1, 2], "b": []})
+
+        for T, a, b in [
+            (ListOf(str), ["a", "b", "c"], []),
+            (ListOf(str), [], ["a", "b"]),
+            (ListOf(str), ["a", "b"], ["a", "x", "b", "y"]),
+            (ConstDict(int, str), {1: "a", 2: "b", 3: "c"}, {0: "z", 2: "b", 3: "d", 4: "e"}),
+            (ConstDict(int, str), {1: "a"}, {}),
+            (OneOf(int, str), 1, "x"),
+            (OneOf(int, ListOf(int)), [1, 2], [1, 3]),
+            (Tuple(int, str), (1, "a"), (1, "b")),
+        ]:
+            assert deserializeDelta(T, a, serializeDelta(T, a, b)) == T(b), (T, a, b)
+
+        # applying a delta to the wrong value is an error, not garbage
+        delta = serializeDelta(ListOf(str), ["a", "b", "c"], ["a", "b", "c", "d"])
+
+        with self.assertRaisesRegex(Exception, "Corrupt delta"):
+            deserializeDelta(ListOf(str), [], delta)
+
+    def test_deserialize_into(self):
+        Message = NamedTuple(name=str, values=ListOf(int), tags=Set(str), extra=OneOf(None, bytes))
+        T = ListOf(Message)
+
+        def makeMessages(n, base):
+            return T([
+                Message(
+                    name=f"message {base + i}",
+                    values=list(range(base, base + i)),
+                    tags={str(base), str(i)},
+                    extra=b"x" * i if i % 2 else None
+                ) for i in range(n)
+            ])
+
+        existing = T()
+
+        for n, base in [(5, 0), (10, 100), (3, 1000), (10, 10000), (0, 0), (7, 5)]:
+            expected = makeMessages(n, base)
+            result = deserializeInto(T, serialize(T, expected), existing)
+
+            # we fill in the list we were given
+            assert result is existing
+            assert existing == expected
+
+        # once it's big enough, decoding a message of the same shape reuses the storage
+        first = makeMessages(10, 0)
+        deserializeInto(T, serialize(T, first), existing)
+        valuesAddress = existing[3].values.pointerUnsafe(0)
+        listAddress = existing.pointerUnsafe(0)
+
+        deserializeInto(T, serialize(T, makeMessages(10, 7)), existing)
+        assert existing == makeMessages(10, 7)
+        assert existing.pointerUnsafe(0) == listAddress
+        assert existing[3].values.pointerUnsafe(0) == valuesAddress
+
+        # but not storage something else can still see
+        held = existing[3].values
+        deserializeInto(T, serialize(T, makeMessages(10, 9)), existing)
+        assert held == list(range(7, 10))
+        assert existing[3].values == list(range(9, 12))
+
+        d = Dict(str, ListOf(str))({"a": ["x"]})
+        for value in [{"a": ["y", "z"], "b": []}, {}, {str(i): [str(i)] * i for i in range(100)}]:
+            assert deserializeInto(Dict(str, ListOf(str)), serialize(Dict(str, ListOf(str)), value), d) is d
+            assert d == value
+
+        # other types give back a new value
+        t = TupleOf(str)(["a", "b"])
+        assert deserializeInto(TupleOf(str), serialize(TupleOf(str), ("c",)), t) == ("c",)
+        assert t == ("a", "b")
+
+        # a list that appears twice in the message is still shared
+        inner = ListOf(int)([1, 2])
+        L = ListOf(ListOf(int))
+        existing = L([[5], [6]])
+        deserializeInto(L, serialize(L, L([inner, inner])), existing)
+        assert existing == [[1, 2], [1, 2]]
+        existing[0].append(3)
+        assert existing[1] == [1, 2, 3]
+
+        with self.assertRaises(Exception):
+            deserializeInto(T, serialize(T, makeMessages(10, 0))[:-5], existing)
+
     def test_serialize_recursive_object(self):
         class AnObject:
             def __init__(self, o):
@@ -1824,6 +2171,174 @@ class TypesSerializationTest(unittest.TestCase):
         with self.assertRaisesRegex(Exception, "blockChecksum"):
             sc.deserialize(bytes(serDat))
 
+    def test_compression_codecs(self):
+        data = ListOf(str)(["row %s of %s" % (i, i % 17) for i in range(100000)])
+
+        fast = SerializationContext().withCompression('lz4')
+        faster = SerializationContext().withCompression('lz4', level=20)
+        hc = SerializationContext().withCompression('lz4hc')
+        hcMax = SerializationContext().withCompression('lz4hc', level=12)
+        none = SerializationContext().withCompression('none')
+
+        assert not none.compressionEnabled
+        assert hc.withCompression() is hc
+        assert hc.withCompression('lz4hc', level=9) is hc
+
+        sizes = {}
+        for name, writer in [('fast', fast), ('faster', faster), ('hc', hc), ('hcMax', hcMax), ('none', none)]:
+            serialized = writer.serialize(data)
+            sizes[name] = len(serialized)
+
+            # compressed readers recognize every codec from the frame header
+            for reader in [fast, hc]:
+                if writer is not none:
+                    assert reader.deserialize(serialized) == data
+
+            assert writer.deserialize(serialized) == data
+
+        assert sizes['hc'] < sizes['fast'] < sizes['none']
+        assert sizes['fast'] <= sizes['faster']
+        assert sizes['hcMax'] <= sizes['hc']
+
+        with self.assertRaisesRegex(ValueError, "Unknown compression codec"):
+            SerializationContext().withCompression('zstd')
+
+        with self.assertRaisesRegex(ValueError, "lz4hc level"):
+            SerializationContext().withCompression('lz4hc', level=13)
+
+        with self.assertRaisesRegex(ValueError, "acceleration"):
+            SerializationContext().withCompression('lz4', level=0)
+
+    def test_serialize_every_leaf_field_kind(self):
+        NT = NamedTuple(
+            b=bool, i8=Int8, i16=Int16, i32=Int32, i64=int,
+            u8=UInt8, u16=UInt16, u32=UInt32, u64=UInt64,
+            f32=Float32, f64=float, s=str, by=bytes, other=ListOf(int)
+        )
+
+        extremes = NT(
+            b=True, i8=-128, i16=-32768, i32=-2**31, i64=-2**63,
+            u8=255, u16=65535, u32=2**32 - 1, u64=2**64 - 1,
+            f32=1.5, f64=-1e300, s="h\u00e9llo \U0001F600", by=b"\x00\xff", other=[1, 2]
+        )
+
+        for inst in [NT(), extremes]:
+            assert deserialize(NT, serialize(NT, inst)) == inst
+            assert deserialize(Tuple(NT, NT), serialize(Tuple(NT, NT), (inst, inst))) == (inst, inst)
+            assert deserialize(ListOf(NT), serialize(ListOf(NT), [inst, inst])) == [inst, inst]
+
+        # fields are matched up by position, so a reader with fewer fields
+        # drops the extras and a reader with more default-initializes them
+        Short = NamedTuple(b=bool, i8=Int8)
+        assert deserialize(Short, serialize(NT, extremes)) == Short(b=True, i8=-128)
+        assert deserialize(NT, serialize(Short, Short(b=True, i8=-128))) == NT(b=True, i8=-128)
+
+        class WithMembers(Class, Final):
+            x = Member(int)
+            s = Member(str)
+            f = Member(float)
+
+        c = WithMembers(x=3, s="hi", f=2.5)
+        c2 = deserialize(WithMembers, serialize(WithMembers, c))
+        assert (c2.x, c2.s, c2.f) == (3, "hi", 2.5)
+
+    def test_serialize_lists_columnar(self):
+        NT = NamedTuple(
+            b=bool, i8=Int8, u64=UInt64, i=int, f32=Float32, f=float, s=str, by=bytes
+        )
+
+        rows = ListOf(NT)(
+            NT(
+                b=i % 3 == 0, i8=i % 256 - 128, u64=2**64 - 1 - i, i=1000000 + i * 7,
+                f32=i / 4, f=i * 0.1, s="sym%s" % (i % 10), by=b"%d" % i
+            )
+            for i in range(10000)
+        )
+
+        plain = SerializationContext().withoutCompression()
+        columnar = plain.withColumnarLists()
+
+        assert columnar.withColumnarLists() is columnar
+        assert columnar.withoutCompressUsingThreads().serializeListsColumnar
+
+        columnarData = columnar.serialize(rows)
+
+        # sorted ints and repeated strings encode much smaller than row by row
+        assert len(columnarData) * 2 < len(plain.serialize(rows))
+
+        # any context can read it back
+        for reader in [plain, columnar, SerializationContext()]:
+            assert reader.deserialize(columnarData) == rows
+
+        assert columnar.deserialize(columnar.serialize(TupleOf(NT)(rows))) == TupleOf(NT)(rows)
+
+        # extremes, the empty list, a Tuple element and unique strings
+        extremes = ListOf(NT)([
+            NT(b=True, i8=-128, u64=2**64 - 1, i=-2**63, f32=-1.5, f=1e300, s="héllo \U0001F600", by=b"\x00\xff"),
+            NT(i8=127, i=2**63 - 1),
+            NT(),
+        ])
+        assert columnar.deserialize(columnar.serialize(extremes)) == extremes
+        assert columnar.deserialize(columnar.serialize(ListOf(NT)())) == ListOf(NT)()
+
+        T = Tuple(int, str)
+        unique = ListOf(T)((i, str(i)) for i in range(1000))
+        assert columnar.deserialize(columnar.serialize(unique)) == unique
+
+        Pair = Tuple(ListOf(NT), ListOf(NT))
+        assert columnar.deserialize(columnar.serialize(Pair((rows, rows)))) == (rows, rows)
+
+        assert columnar.withStringInterning().deserialize(columnarData) == rows
+
+        # elements holding anything else serialize row by row, as usual
+        Other = NamedTuple(x=int, y=ListOf(int))
+        others = ListOf(Other)([Other(x=1, y=[1, 2]), Other(x=2)])
+        assert plain.deserialize(columnar.serialize(others)) == others
+
+    def test_serialize_in_parallel(self):
+        NT = NamedTuple(i=int, f=float, s=str, t=TupleOf(int), o=OneOf(None, str))
+
+        rows = ListOf(NT)(
+            NT(i=i, f=i * 0.5, s="x" * (i % 50), t=range(i % 5), o=None if i % 2 else str(i))
+            for i in range(300000)
+        )
+        table = Dict(int, NT)((i, rows[i]) for i in range(0, len(rows), 3))
+        del table[3]
+
+        plain = SerializationContext().withoutCompression()
+        parallel = plain.withSerializeThreads(4)
+
+        assert parallel.withSerializeThreads(4) is parallel
+        assert parallel.withCompression().serializeThreadCount == 4
+
+        with self.assertRaises(ValueError):
+            plain.withSerializeThreads(0)
+
+        # the threads write exactly what one thread would have
+        for T, value in [
+            (ListOf(NT), rows),
+            (TupleOf(NT), TupleOf(NT)(rows)),
+            (Dict(int, NT), table),
+            (Tuple(ListOf(NT), ListOf(NT)), (rows, rows)),
+            (ListOf(TupleOf(NT)), [rows[:5000], rows[5000:10000]]),
+        ]:
+            data = parallel.serialize(value, T)
+
+            assert data == plain.serialize(value, T)
+            assert plain.deserialize(data, T) == value
+
+        # compressed blocks split differently, but read back the same
+        for context in [SerializationContext(), SerializationContext().withoutCompressUsingThreads()]:
+            assert context.deserialize(context.withSerializeThreads(4).serialize(rows)) == rows
+
+        # elements that can reach the memo serialize on one thread, so
+        # the same list appearing twice is still written once
+        shared = ListOf(int)(range(10))
+        lists = ListOf(ListOf(int))([shared] * 5000)
+        data = parallel.serialize(lists)
+        assert data == plain.serialize(lists)
+        assert len(data) < 5000 * 10
+
     def test_serialize_mutually_recursive_unnamed_forwards_tuples(self):
         X1 = Forward("X1")
         X2 = Forward("X2")
@@ -3061,3 +3576,48 @@ class TypesSerializationTest(unittest.TestCase):
         print(x)
         # TODO: make this True
         # assert x[0].f.__closure__[0].cell_contents is x
+
+    def test_serialization_context_caches_names(self):
+        context = SerializationContext().withoutCompression()
+
+        aFunction = dummy_test_module.testfunction
+
+        assert context.deserialize(context.serialize(aFunction)) is aFunction
+        assert len(context.nameCache) > 0
+
+        # the contexts 'with' methods make share the cache, along with the names
+        assert context.withoutLineInfoEncoded().nameCache is context.nameCache
+
+        # changing the names clears it, so the new name takes effect right away
+        context.addNamedObject("a_renamed_function", aFunction)
+
+        assert b"a_renamed_function" in context.serialize(aFunction)
+        assert context.deserialize(context.serialize(aFunction)) is aFunction
+
+        context.dropNamedObject("a_renamed_function")
+
+        assert b"a_renamed_function" not in context.serialize(aFunction)
+
+    def test_compressed_blocks_are_checked(self):
+        context = SerializationContext()
+        T = ListOf(int)
+
+        data = context.serialize(T(range(1000)), T)
+
+        # a single block: its length, and then an lz4 frame
+        frameSize = int.from_bytes(data[:4], "little")
+        assert len(data) == 4 + frameSize
+
+        assert context.deserialize(data, T) == T(range(1000))
+
+        corrupt = bytearray(data)
+        corrupt[len(data) // 2] ^= 1
+
+        with pytest.raises(TypeError):
+            context.deserialize(bytes(corrupt), T)
+
+        # a frame missing its end mark and content checksum, but none of its data
+        truncated = (frameSize - 8).to_bytes(4, "little") + data[4:-8]
+
+        with pytest.raises(TypeError, match="partway through"):
+            context.deserialize(truncated, T)
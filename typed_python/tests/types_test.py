@@ -31,7 +31,8 @@ from typed_python import (
     Float32, SubclassOf,
     TupleOf, ListOf, OneOf, Tuple, NamedTuple, Dict,
     ConstDict, Alternative, serialize, deserialize, Class,
-    TypeFilter, Function, Forward, Set, PointerTo, Entrypoint, Final
+    TypeFilter, Function, Forward, Set, PointerTo, Entrypoint, Final,
+    deepBytecount
 )
 from typed_python.type_promotion import (
     computeArithmeticBinaryResultType, floatness, bitness, isSignedInt
@@ -294,6 +295,12 @@ class TypesTests(unittest.TestCase):
         self.assertEqual(_types.bytecount(Int8), 1)
         self.assertEqual(_types.bytecount(int), 8)
 
+    def test_composite_types_are_packed(self):
+        # members are laid out back to back without alignment padding, so there's
+        # nothing to gain from reordering them
+        self.assertEqual(_types.bytecount(NamedTuple(a=bool, b=float, c=bool, d=int)), 18)
+        self.assertEqual(_types.bytecount(Tuple(Int8, int, Int16)), 11)
+
     def test_type_stringification(self):
         self.assertEqual(str(_types.Int8), "<class 'typed_python._types.Int8'>")
         self.assertEqual(str(Tuple(int)), "<class 'Tuple(int)'>")
@@ -514,6 +521,70 @@ class TypesTests(unittest.TestCase):
         l3.append(23)
         self.assertEqual(l3, [10, 2, 3, 11, 10, 2, 3, 11, 23])
 
+    def test_empty_list_defers_data_allocation(self):
+        l1 = ListOf(int)()
+
+        self.assertEqual(l1.reserved(), 0)
+        self.assertEqual(list(l1), [])
+
+        l1.append(1)
+        self.assertEqual(l1, [1])
+        self.assertGreaterEqual(l1.reserved(), 1)
+
+        l2 = ListOf(int)()
+        l2.reserve(5)
+        self.assertEqual(l2.reserved(), 5)
+
+        l3 = ListOf(str)()
+        l3.extend(["a", "b"])
+        self.assertEqual(l3, ["a", "b"])
+
+    def test_large_list_buffers_are_aligned(self):
+        @Entrypoint
+        def appendMany(aList: ListOf(float), count: int):
+            for i in range(count):
+                aList.append(i)
+
+        def address(aList):
+            return int(aList.pointerUnsafe(0))
+
+        aList = ListOf(float)()
+        aList.resize(1000, 1.5)
+
+        # growing from a small buffer into a large one, in compiled code and out
+        appendMany(aList, 500000)
+        self.assertEqual(address(aList) % 64, 0)
+
+        aList.resize(2000000)
+        self.assertEqual(address(aList) % 64, 0)
+        self.assertEqual(aList[999], 1.5)
+        self.assertEqual(aList[1000 + 499999], 499999)
+
+        self.assertFalse(_types.hugePages())
+        _types.setHugePages(True)
+        try:
+            self.assertEqual(address(ListOf(float)(range(1000000))) % 64, 0)
+        finally:
+            _types.setHugePages(False)
+
+        # and shrinking back down to a malloc'd one
+        aList.resize(10)
+        aList.reserve(10)
+        self.assertEqual(aList[9], 1.5)
+
+    def test_list_shrink_to_fit(self):
+        aList = ListOf(int)()
+
+        for i in range(2000):
+            aList.append(i)
+
+        self.assertGreater(aList.reserved(), 2000)
+
+        aList.shrinkToFit()
+
+        self.assertEqual(aList.reserved(), 2000)
+        self.assertEqual(aList[1999], 1999)
+
     def test_list_resize(self):
         l1 = ListOf(TupleOf(int))()
 
@@ -698,6 +769,41 @@ class TypesTests(unittest.TestCase):
         with self.assertRaises(TypeError):
             t((1.0, "2.0"))
 
+    def test_one_of_none_and_pointer_uses_null_niche(self):
+        for T in [ListOf(int), Dict(int, str), Set(int)]:
+            for O in [OneOf(None, T), OneOf(T, None)]:
+                self.assertEqual(_types.bytecount(O), 8)
+                self.assertIsNotNone(_types.oneof_null_niche_index(O))
+                self.assertEqual(O.Types[_types.oneof_null_niche_index(O)], T)
+
+        # these use nullptr for their empty values, so they keep their tag byte
+        for T in [TupleOf(int), ConstDict(int, int), str, bytes]:
+            self.assertEqual(_types.bytecount(OneOf(None, T)), 9)
+            self.assertIsNone(_types.oneof_null_niche_index(OneOf(None, T)))
+
+        self.assertIsNone(_types.oneof_null_niche_index(OneOf(None, int, ListOf(int))))
+
+        aList = ListOf(int)([1, 2])
+        refcount = _types.refcount(aList)
+
+        lst = ListOf(OneOf(None, ListOf(int)))([None, aList, None])
+
+        self.assertEqual(_types.bytecount(type(lst).ElementType), 8)
+        self.assertEqual(lst, [None, [1, 2], None])
+        self.assertEqual(_types.refcount(aList), refcount + 1)
+
+        lst[0] = aList
+        lst[1] = None
+
+        self.assertEqual(lst, [[1, 2], None, None])
+        self.assertEqual(_types.refcount(aList), refcount + 1)
+
+        self.assertEqual(deserialize(type(lst), serialize(type(lst), lst)), lst)
+
+        lst.clear()
+
+        self.assertEqual(_types.refcount(aList), refcount)
+
     def test_comparisons_in_one_of(self):
         t = OneOf(None, float)
 
@@ -857,6 +963,56 @@ class TypesTests(unittest.TestCase):
 
         self.assertEqual(len(a), 0)
 
+    def test_dict_sliding_window_reuses_slots(self):
+        d = Dict(int, int)()
+
+        for i in range(100):
+            d[i] = i
+
+        sizeAfterFill = deepBytecount(d)
+
+        for i in range(100, 10000):
+            d[i] = i
+            del d[i - 100]
+
+        self.assertEqual(len(d), 100)
+        self.assertEqual(list(d), list(range(9900, 10000)))
+        self.assertLessEqual(deepBytecount(d), sizeAfterFill * 2)
+
+    def test_dict_compact(self):
+        d = Dict(int, int)()
+
+        for i in range(10000):
+            d[i] = i
+
+        sizeWhenFull = deepBytecount(d)
+
+        for i in range(9990):
+            del d[i]
+
+        d.compact()
+
+        self.assertEqual(list(d.items()), [(i, i) for i in range(9990, 10000)])
+        self.assertLess(deepBytecount(d) * 50, sizeWhenFull)
+
+        d[0] = 1
+        self.assertEqual(d[0], 1)
+        self.assertEqual(len(d), 11)
+
+    def test_dict_from_columns(self):
+        T = Dict(int, str)
+
+        d = T.fromColumns(ListOf(int)(range(1000)), ListOf(str)([str(i) for i in range(1000)]))
+
+        self.assertEqual(d, {i: str(i) for i in range(1000)})
+        self.assertEqual(list(d), list(range(1000)))
+
+        # later duplicates win, just like building a dict
+        self.assertEqual(T.fromColumns([1, 2, 1], ["a", "b", "c"]), {1: "c", 2: "b"})
+
+        with self.assertRaisesRegex(ValueError, "2 keys but 1 values"):
+            T.fromColumns([1, 2], ["a"])
+
     def test_dict_clear_large(self):
         T = Dict(str, str)
 
@@ -1147,6 +1303,38 @@ class TypesTests(unittest.TestCase):
         self.assertEqual(_types.bytecount(alt.X), 1)
         self.assertEqual(_types.bytecount(alt.Y), 1)
 
+    def test_small_pod_alternatives_are_inline(self):
+        Result = Alternative("Result", Ok=dict(value=int), Err=dict(code=Int16, fatal=bool))
+
+        self.assertTrue(_types.alternative_is_inline(Result))
+        self.assertEqual(_types.bytecount(Result), 9)
+        self.assertEqual(_types.bytecount(Result.Err), 9)
+
+        ok = Result.Ok(value=10)
+        err = Result.Err(code=3, fatal=True)
+
+        self.assertEqual(ok.value, 10)
+        self.assertEqual((err.code, err.fatal), (3, True))
+        self.assertTrue(err.matches.Err)
+        self.assertEqual(_types.refcount(ok), 0)
+
+        self.assertEqual(ok, Result.Ok(value=10))
+        self.assertLess(ok, err)
+        self.assertLess(Result.Ok(value=1), Result.Ok(value=2))
+        self.assertEqual(hash(ok), hash(Result.Ok(value=10)))
+
+        lst = ListOf(Result)([ok, err, ok])
+        self.assertEqual(lst[1], err)
+        self.assertEqual(deserialize(Result, serialize(Result, err)), err)
+
+        # anything bigger than 15 bytes, or with refcounted data, lives on the heap
+        Big = Alternative("Big", X=dict(a=int, b=int))
+        WithStr = Alternative("WithStr", X=dict(a=str))
+
+        self.assertFalse(_types.alternative_is_inline(Big))
+        self.assertFalse(_types.alternative_is_inline(WithStr))
+        self.assertEqual(_types.bytecount(Big), 8)
+
     def test_alternatives_with_Bytes(self):
         alt = Alternative(
             "Alt",
@@ -1667,6 +1855,22 @@ class TypesTests(unittest.TestCase):
 
                     self.assertEqual(res, intDict(addResult))
 
+    def test_dictionary_addition_merges_interleaved_keys(self):
+        strDict = ConstDict(str, int)
+
+        left = strDict({str(i).zfill(5): i for i in range(0, 10000, 2)})
+        right = strDict({str(i).zfill(5): -i for i in range(0, 10000, 3)})
+
+        expected = {str(i).zfill(5): i for i in range(0, 10000, 2)}
+        expected.update({str(i).zfill(5): -i for i in range(0, 10000, 3)})
+
+        self.assertEqual(left + right, strDict(expected))
+        self.assertEqual(list(left + right), sorted(expected))
+
+        # duplicate and missing keys in the subtrahend are ignored
+        self.assertEqual(left - ["00000", "00000", "00001"], strDict({k: v for k, v in left.items() if k != "00000"}))
+        self.assertEqual(left - [], left)
+
     def test_serialization_primitives(self):
         def checkCanSerialize(x):
             self.assertEqual(x, deserialize(type(x), serialize(type(x), x)), x)
@@ -1988,6 +2192,144 @@ class TypesTests(unittest.TestCase):
         self.assertEqual(str(ListOf(float)([1, 2, 3, 4]).toArray().dtype), 'float64')
         self.assertEqual(str(ListOf(Float32)([1, 2, 3, 4]).toArray().dtype), 'float32')
 
+    def test_list_and_tuple_tolist(self):
+        for T, values in [
+            (int, [1, -2, 2 ** 62]),
+            (float, [1.5, -2.0, 1e300]),
+            (bool, [True, False, True]),
+            (str, ["a", "hï", "🌍", ""]),
+            (Int32, [1, -2, 3]),
+            (OneOf(None, int), [None, 1, None]),
+            (object, [None, "x", (1, 2)]),
+        ]:
+            for container in [ListOf(T), TupleOf(T)]:
+                res = container(values).tolist()
+
+                self.assertEqual(type(res), list)
+                self.assertEqual(res, list(container(values)))
+                self.assertEqual(container().tolist(), [])
+
+        self.assertEqual(ListOf(ListOf(int))([[1], [2, 3]]).tolist(), [ListOf(int)([1]), ListOf(int)([2, 3])])
+
+    def test_list_and_tuple_export_buffers_to_numpy(self):
+        for T, dtype in [
+            (ListOf(float), 'float64'),
+            (TupleOf(float), 'float64'),
+            (ListOf(Float32), 'float32'),
+            (ListOf(int), 'int64'),
+            (TupleOf(Int16), 'int16'),
+            (ListOf(UInt8), 'uint8'),
+            (ListOf(bool), 'bool'),
+        ]:
+            x = T([1, 0, 1, 1])
+            arr = numpy.asarray(x)
+
+            self.assertEqual(str(arr.dtype), dtype)
+            self.assertEqual(arr.tolist(), x.toArray().tolist())
+            self.assertEqual(memoryview(x).nbytes, len(x.toBytes()))
+
+            self.assertEqual(T.fromBuffer(arr), x)
+            self.assertEqual(T.fromBuffer(x), x)
+
+        self.assertEqual(numpy.asarray(ListOf(float)()).tolist(), [])
+        self.assertEqual(ListOf(float).fromBuffer(numpy.zeros(0)), [])
+
+        # the list's storage is shared with the array, and the array keeps it alive
+        aList = ListOf(float)([1, 2, 3])
+        arr = numpy.asarray(aList)
+        arr[1] = 20
+        self.assertEqual(aList[1], 20)
+
+        aTuple = TupleOf(int)([1, 2, 3])
+        tupArr = numpy.asarray(aTuple)
+        self.assertFalse(tupArr.flags.writeable)
+
+        aTupleRefcount = _types.refcount(aTuple)
+        del aTuple
+        self.assertEqual(tupArr.tolist(), [1, 2, 3])
+        self.assertGreater(aTupleRefcount, 1)
+
+        with self.assertRaises(TypeError):
+            memoryview(ListOf(str)(["hi"]))
+
+        # fromBuffer needs a contiguous buffer of the same kind of value
+        with self.assertRaises(TypeError):
+            ListOf(float).fromBuffer(numpy.zeros(4, 'int64'))
+
+        with self.assertRaises(TypeError):
+            ListOf(int).fromBuffer(numpy.zeros(4, 'uint64'))
+
+        with self.assertRaises(BufferError):
+            ListOf(float).fromBuffer(numpy.zeros(8)[::2])
+
+        with self.assertRaises(TypeError):
+            ListOf(str).fromBuffer(numpy.zeros(4))
+
+        self.assertEqual(ListOf(float)(numpy.array([1.0, 2.0, 3.0])[::2]), [1.0, 3.0])
+        self.assertEqual(ListOf(int)(numpy.array([True, False, True])), [1, 0, 1])
+
+    def test_list_and_dict_conversion_from_python_primitives(self):
+        self.assertEqual(ListOf(int)([1, 2, -3, True]), [1, 2, -3, 1])
+        self.assertEqual(TupleOf(int)((1, 2, 3)), (1, 2, 3))
+        self.assertEqual(ListOf(float)([1, 2.5, False]), [1.0, 2.5, 0.0])
+        self.assertEqual(ListOf(bool)([True, False]), [True, False])
+        self.assertEqual(ListOf(str)(["a", "\u00e9", "\U0001F600", ""]), ["a", "\u00e9", "\U0001F600", ""])
+
+        # ints too big for an int64 wrap, as they do one at a time
+        self.assertEqual(ListOf(int)([2**64 - 1, 1]), [-1, 1])
+
+        # anything else still goes through the general conversion
+        self.assertEqual(ListOf(int)([1, Int32(2), numpy.int64(3)]), [1, 2, 3])
+        self.assertEqual(ListOf(float)([1.5, numpy.float32(2.5)]), [1.5, 2.5])
+        self.assertEqual(ListOf(OneOf(None, int))([1, None]), [1, None])
+
+        with self.assertRaises(TypeError):
+            ListOf(int)([1, 2, "3"])
+
+        with self.assertRaises(TypeError):
+            ListOf(str)(["a", 1])
+
+        d = Dict(str, float)({"a": 1, "b": 2.5, "c": True})
+        self.assertEqual(d, {"a": 1.0, "b": 2.5, "c": 1.0})
+        self.assertEqual(list(d), ["a", "b", "c"])
+
+        self.assertEqual(Dict(int, str)({1: "a", 2: "b"}), {1: "a", 2: "b"})
+        self.assertEqual(Dict(str, int)({}), {})
+        self.assertEqual(Dict(str, int)({"a": Int16(3)}), {"a": 3})
+
+        with self.assertRaises(TypeError):
+            Dict(str, int)({"a": 1, "b": "2"})
+
+        with self.assertRaises(TypeError):
+            Dict(str, int)({"a": 1, 2: 2})
+
+    def test_extracted_wrappers_are_recycled(self):
+        aList = ListOf(TupleOf(int))([[1], [2, 3]])
+        aConstDict = ConstDict(str, TupleOf(int))({"a": [1], "b": [2]})
+
+        # each wrapper is released as soon as the expression is done with it,
+        # so the next one should come off the freelist without leaking or
+        # carrying any state over
+        for _ in range(1000):
+            self.assertEqual(aList[1], (2, 3))
+            self.assertEqual(list(aConstDict.items()), [("a", (1,)), ("b", (2,))])
+
+        # python subclasses of our types can't share their base's freelist
+        class NamedTupleSubclass(NamedTuple(x=int)):
+            def twiceX(self):
+                return self.x * 2
+
+        for _ in range(100):
+            self.assertEqual(NamedTupleSubclass(x=2).twiceX(), 4)
+            self.assertEqual(NamedTuple(x=int)(x=3).x, 3)
+
+        m0 = currentMemUsageMb()
+
+        for _ in range(100000):
+            aList[0]
+
+        self.assertLess(currentMemUsageMb() - m0, 1.0)
+
     def test_list_of_equality(self):
         x = ListOf(int)([1, 2, 3, 4])
         y = ListOf(int)([1, 2, 3, 5])
@@ -2530,6 +2872,25 @@ class TypesTests(unittest.TestCase):
         s2 = Set(int)([1])
         self.assertNotEqual(id(s2), id(s1))
 
+    def test_set_compact(self):
+        s = Set(int)(range(1000))
+
+        for i in range(995):
+            s.discard(i)
+
+        s.compact()
+
+        self.assertEqual(s, Set(int)(range(995, 1000)))
+
+        s.add(0)
+        self.assertIn(0, s)
+
+    def test_set_from_list(self):
+        s = Set(int).fromList(ListOf(int)([i % 100 for i in range(1000)]))
+
+        self.assertEqual(s, Set(int)(range(100)))
+        self.assertEqual(Set(str).fromList([]), Set(str)())
+
     def test_set_update(self):
         s1 = Set(int)([1, 2, 3])
 
@@ -20,6 +20,8 @@
 
 thread_local int64_t native_dispatch_disabled = 0;
 
+bool refcounts_are_thread_confined = false;
+
 bool unpackTupleToTypes(PyObject* tuple, std::vector<Type*>& out) {
     if (!PyTuple_Check(tuple)) {
         PyErr_SetString(PyExc_TypeError, "Argument to type tuple was not a tuple");
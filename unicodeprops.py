@@ -12,6 +12,33 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+"""Generate the unicode property tables that UnicodeProps.hpp includes.
+
+    python unicodeprops.py > typed_python/UnicodeProps_<version>.hpp
+
+writes the properties of every codepoint as the running interpreter sees them.
+Rather than one uint16_t per codepoint (2MB, most of it repeats), we write
+multi-stage tables like the ones CPython's unicodedata uses:
+
+    uprops_records  the distinct sets of flags, of which there are only a few dozen
+    uprops_index2   blocks of 2^UPROPS_SHIFT2 record numbers, one per codepoint.
+                    Identical blocks are only stored once.
+    uprops_index1   blocks of 2^UPROPS_SHIFT1 numbers of blocks in uprops_index2,
+                    again stored once each
+    uprops_index0   the block of uprops_index1 that each run of
+                    2^(UPROPS_SHIFT1 + UPROPS_SHIFT2) codepoints uses
+
+We pick the shifts that make the tables smallest, which leaves them under 20KB
+instead of 2MB, so they stay in cache. Codepoints below 256 get a table of their
+own, so Latin-1 text only ever touches 512 bytes, and codepoints from UPROPS_LIMIT
+up have no properties at all, so we don't store them.
+
+'--from-runlength HEADER' rebuilds the tables from a header in the older
+run-length format, for the python versions we no longer have an interpreter for.
+"""
+
+import argparse
+import re
 import sys
 
 Uprops_ALPHA = 0x01
@@ -24,30 +51,28 @@ Uprops_SPACE = 0x40
 Uprops_PRINTABLE = 0x80
 Uprops_TITLE = 0x100
 
-first = 0
-last = 0x10ffff
-print("#pragma once")
-print("")
-print("// Generated from:")
-print("/* ", sys.version, " */")
-print("")
-print("#define Uprops_ALPHA 0x{:04x}".format(Uprops_ALPHA))
-print("#define Uprops_LOWER 0x{:04x}".format(Uprops_LOWER))
-print("#define Uprops_UPPER 0x{:04x}".format(Uprops_UPPER))
-print("#define Uprops_DECIMAL 0x{:04x}".format(Uprops_DECIMAL))
-print("#define Uprops_DIGIT 0x{:04x}".format(Uprops_DIGIT))
-print("#define Uprops_NUMERIC 0x{:04x}".format(Uprops_NUMERIC))
-print("#define Uprops_SPACE 0x{:04x}".format(Uprops_SPACE))
-print("#define Uprops_PRINTABLE 0x{:04x}".format(Uprops_PRINTABLE))
-print("#define Uprops_TITLE 0x{:04x}".format(Uprops_TITLE))
-print("static uint16_t uprops_runlength[] = {")
-
-prev = None
-count = 0
-entries = 0
-sum = 0
-for i in range(first, last + 1):
-    c = chr(i)
+CODEPOINT_COUNT = 0x110000
+
+LICENSE = """\
+/******************************************************************************
+   Copyright 2017-2023 typed_python Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+******************************************************************************/
+"""
+
+
+def flagsOf(c):
     flags = Uprops_ALPHA if c.isalpha() else 0
     flags += Uprops_LOWER if c.islower() else 0
     flags += Uprops_UPPER if c.isupper() else 0
@@ -57,35 +82,135 @@ for i in range(first, last + 1):
     flags += Uprops_SPACE if c.isspace() else 0
     flags += Uprops_PRINTABLE if c.isprintable() else 0
     flags += Uprops_TITLE if c.istitle() and not c.isupper() else 0
-    if flags != prev:
-        if prev is not None:
-            print("0x{:x},{}, ".format(prev, count), end="")
-            sum += count
-            entries += 1
-            if entries % 16 == 0:
-                print()
-        prev = flags
-        count = 1
+    return flags
+
+
+def flagsFromInterpreter():
+    return [flagsOf(chr(i)) for i in range(CODEPOINT_COUNT)], sys.version
+
+
+def flagsFromRunLengthHeader(path):
+    with open(path) as f:
+        text = f.read()
+
+    version = re.search(r"// Generated from:\n/\*(.*?)\*/", text, re.DOTALL).group(1).strip()
+    runs = re.search(r"uprops_runlength\[\] = \{(.*?)\};", text, re.DOTALL).group(1)
+    numbers = [int(x, 0) for x in runs.replace(",", " ").split()]
+
+    flags = []
+    for value, count in zip(numbers[::2], numbers[1::2]):
+        flags.extend([value] * count)
+
+    assert len(flags) == CODEPOINT_COUNT, len(flags)
+
+    return flags, version
+
+
+def splitBins(values, shift):
+    """Split 'values' into blocks of 2**shift, storing each distinct block once.
+
+    Returns:
+        (index1, index2), where values[i] == index2[(index1[i >> shift] << shift) + (i & mask)]
+    """
+    blockSize = 1 << shift
+    blockIndex = {}
+    index1 = []
+    index2 = []
+
+    for start in range(0, len(values), blockSize):
+        block = tuple(values[start:start + blockSize])
+
+        if block not in blockIndex:
+            blockIndex[block] = len(blockIndex)
+            index2.extend(block)
+
+        index1.append(blockIndex[block])
+
+    return index1, index2
+
+
+def ctype(maxValue):
+    return "uint8_t" if maxValue < 256 else "uint16_t"
+
+
+def tableBytes(table):
+    return len(table) * (1 if max(table) < 256 else 2)
+
+
+def printTable(name, ctypeName, values):
+    print("static const {} {}[{}] = {{".format(ctypeName, name, len(values)))
+
+    for start in range(0, len(values), 16):
+        print("    " + ", ".join("0x{:x}".format(v) for v in values[start:start + 16]) + ",")
+
+    print("};")
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--from-runlength", metavar="HEADER", help="read the properties from an old run-length header")
+    args = parser.parse_args()
+
+    if args.from_runlength:
+        flags, version = flagsFromRunLengthHeader(args.from_runlength)
     else:
-        count += 1
-        if count == 0xFFFF:
-            print("0x{:x},{}, ".format(prev, count), end="")
-            sum += count
-            entries += 1
-            if entries % 16 == 0:
-                print()
-            count = 0
-print("0x{:x},{}\n}};\n".format(prev, count))
-sum += count
-entries += 1
-
-print("// check 0x{:x} == 0x{:x}\n".format(sum, last+1))
-
-print("static uint16_t uprops[0x{:x}];\n".format(last+1))
-
-print("void initialize_uprops(void) {")
-print("    uint16_t *cur = uprops;")
-print("    for (long k = 0; k < {}; k++)".format(entries))
-print("        for (long j = 0; j < uprops_runlength[k*2+1]; j++)")
-print("            *cur++ = uprops_runlength[k*2];")
-print("}")
+        flags, version = flagsFromInterpreter()
+
+    records = sorted(set(flags))
+    recordOf = {f: i for i, f in enumerate(records)}
+    assert len(records) < 256
+
+    limit = max(i for i in range(CODEPOINT_COUNT) if flags[i]) + 1
+    recordIndices = [recordOf[f] for f in flags[:limit]]
+
+    def tablesFor(shift2, shift1):
+        index1, index2 = splitBins(recordIndices, shift2)
+        index0, index1 = splitBins(index1, shift1)
+        return index0, index1, index2
+
+    shift2, shift1 = min(
+        ((s2, s1) for s2 in range(2, 10) for s1 in range(2, 10)),
+        key=lambda shifts: sum(tableBytes(t) for t in tablesFor(*shifts))
+    )
+    index0, index1, index2 = tablesFor(shift2, shift1)
+
+    for i in range(CODEPOINT_COUNT):
+        if i < limit:
+            block1 = index0[i >> (shift1 + shift2)]
+            block2 = index1[(block1 << shift1) + ((i >> shift2) & ((1 << shift1) - 1))]
+            looked = records[index2[(block2 << shift2) + (i & ((1 << shift2) - 1))]]
+        else:
+            looked = 0
+        assert looked == flags[i], hex(i)
+
+    print(LICENSE)
+    print("#pragma once")
+    print("")
+    print("// Generated by unicodeprops.py from:")
+    print("/* ", version, " */")
+    print("")
+    print("#define Uprops_ALPHA 0x{:04x}".format(Uprops_ALPHA))
+    print("#define Uprops_LOWER 0x{:04x}".format(Uprops_LOWER))
+    print("#define Uprops_UPPER 0x{:04x}".format(Uprops_UPPER))
+    print("#define Uprops_DECIMAL 0x{:04x}".format(Uprops_DECIMAL))
+    print("#define Uprops_DIGIT 0x{:04x}".format(Uprops_DIGIT))
+    print("#define Uprops_NUMERIC 0x{:04x}".format(Uprops_NUMERIC))
+    print("#define Uprops_SPACE 0x{:04x}".format(Uprops_SPACE))
+    print("#define Uprops_PRINTABLE 0x{:04x}".format(Uprops_PRINTABLE))
+    print("#define Uprops_TITLE 0x{:04x}".format(Uprops_TITLE))
+    print("")
+    print("#define UPROPS_SHIFT1 {}".format(shift1))
+    print("#define UPROPS_SHIFT2 {}".format(shift2))
+    print("#define UPROPS_LIMIT 0x{:x}".format(limit))
+    print("")
+
+    printTable("uprops_latin1", "uint16_t", flags[:256])
+    printTable("uprops_records", "uint16_t", records)
+    printTable("uprops_index0", ctype(max(index0)), index0)
+    printTable("uprops_index1", ctype(max(index1)), index1)
+    printTable("uprops_index2", ctype(max(index2)), index2)
+
+
+if __name__ == "__main__":
+    main()